@@ -0,0 +1,235 @@
+/*!
+ * \file stream_entities.c
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Example: stream the entities of a DXF file from a memory
+ * mapping with SAX style callbacks.
+ *
+ * The fastest way to look at every entity of a file is not
+ * \c dxf_file_read: it is a memory mapped input (see
+ * \c dxf_read_mmap_init) walked with streaming callbacks (see
+ * \c DxfReadHandlers), which parses into one reused scratch struct
+ * per entity type and allocates nothing per entity.\n
+ * This example counts the \c LINE, \c CIRCLE and \c LWPOLYLINE
+ * entities of a file and sums the line lengths, in O(1) memory, and
+ * reports the throughput, so it doubles as a smoke benchmark.\n
+ * Run it over the bundled sample drawing:
+ * <tt>./dxfstream qcad-example_R2000.dxf</tt>
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#include <math.h>
+#include <time.h>
+#include "src/file.h"
+#include "src/diag.h"
+
+
+/*!
+ * The sample drawing the example runs over when no file is named.
+ */
+#define EXAMPLE_FILE "qcad-example_R2000.dxf"
+
+
+/*!
+ * \brief The per-file tallies of one run.
+ */
+typedef struct
+example_counts
+{
+        long lines;
+                /*!< number of \c LINE entities seen. */
+        long circles;
+                /*!< number of \c CIRCLE entities seen. */
+        long lwpolylines;
+                /*!< number of \c LWPOLYLINE entities seen. */
+        long others;
+                /*!< number of entities of an unrecognized type;
+                 * recognized types without a callback are parsed and
+                 * skipped without notice. */
+        double line_length;
+                /*!< summed length of the \c LINE entities. */
+} ExampleCounts;
+
+
+/*!
+ * \brief Get a monotonic time stamp in seconds.
+ */
+static double
+example_now (void)
+{
+        struct timespec ts;
+
+        clock_gettime (CLOCK_MONOTONIC, &ts);
+        return ((double) ts.tv_sec + ((double) ts.tv_nsec / 1.0e9));
+}
+
+
+/*!
+ * \brief Invoked per parsed \c LINE; the struct is scratch, valid
+ * only for the duration of the call.
+ */
+static int
+example_line (DxfFile *fp, DxfLine *line, void *user_data)
+{
+        ExampleCounts *counts = (ExampleCounts *) user_data;
+
+        counts->lines++;
+        counts->line_length += sqrt
+                (((line->x1 - line->x0) * (line->x1 - line->x0))
+                + ((line->y1 - line->y0) * (line->y1 - line->y0))
+                + ((line->z1 - line->z0) * (line->z1 - line->z0)));
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Invoked per parsed \c CIRCLE.
+ */
+static int
+example_circle (DxfFile *fp, DxfCircle *circle, void *user_data)
+{
+        ((ExampleCounts *) user_data)->circles++;
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Invoked per parsed \c LWPOLYLINE.
+ */
+static int
+example_lwpolyline (DxfFile *fp, DxfLWPolyline *lwpolyline, void *user_data)
+{
+        ((ExampleCounts *) user_data)->lwpolylines++;
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Invoked per entity whose type name is not recognized by the
+ * reader, before the entity is skipped unparsed.
+ */
+static int
+example_unknown (DxfFile *fp, const char *entity_name, void *user_data)
+{
+        ((ExampleCounts *) user_data)->others++;
+        return (EXIT_SUCCESS);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+        char temp_string[DXF_MAX_STRING_LENGTH];
+        const char *filename;
+        DxfFile *fp;
+        DxfReadHandlers handlers;
+        DxfDiag *diag;
+        ExampleCounts counts;
+        double start;
+        double elapsed;
+        double megabytes;
+
+        filename = (argc > 1) ? argv[1] : EXAMPLE_FILE;
+        fp = dxf_read_init ((char *) filename);
+        if (fp == NULL)
+        {
+                return (1);
+        }
+        /* map the file; unmappable inputs (pipes, and gzip compressed
+         * files, which dxf_read_mmap_init refuses) simply keep
+         * reading through the block buffer. */
+        dxf_read_mmap_init (fp);
+        /* collect the per-record parser warnings in a bounded buffer
+         * instead of an stderr write per warning. */
+        diag = dxf_diag_new (0);
+        dxf_diag_attach (fp, diag);
+        memset (&counts, 0, sizeof (counts));
+        memset (&handlers, 0, sizeof (handlers));
+        handlers.user_data = &counts;
+        handlers.diag = diag;
+        handlers.line = example_line;
+        handlers.circle = example_circle;
+        handlers.lwpolyline = example_lwpolyline;
+        handlers.unknown = example_unknown;
+        fp->handlers = &handlers;
+        start = example_now ();
+        /* scan for the ENTITIES section; the other sections carry no
+         * entities and fall through the SECTION scan. */
+        for (;;)
+        {
+                if (dxf_read_line (temp_string, fp) < 1)
+                {
+                        break;
+                }
+                if (strcmp (temp_string, "SECTION") != 0)
+                {
+                        continue;
+                }
+                /* consume the "  2" group code and the section name. */
+                if (dxf_read_line (temp_string, fp) < 1)
+                {
+                        break;
+                }
+                if (strcmp (temp_string, "2") != 0)
+                {
+                        continue;
+                }
+                if (dxf_read_line (temp_string, fp) < 1)
+                {
+                        break;
+                }
+                if (strcmp (temp_string, "ENTITIES") == 0)
+                {
+                        if (dxf_entities_read (fp) != EXIT_SUCCESS)
+                        {
+                                fprintf (stderr, "%s: reading entities failed\n",
+                                        filename);
+                                dxf_diag_free (dxf_diag_detach (fp));
+                                dxf_read_close (fp);
+                                return (1);
+                        }
+                }
+        }
+        elapsed = example_now () - start;
+        megabytes = (double) fp->bytes_total / (1024.0 * 1024.0);
+        fprintf (stdout, "%s: %ld lines (summed length %.1f), %ld circles, "
+                "%ld lwpolylines, %ld unrecognized entities\n",
+                filename, counts.lines, counts.line_length, counts.circles,
+                counts.lwpolylines, counts.others);
+        fprintf (stdout, "streamed %.2f MB in %.3f s (%.1f MB/s), O(1) memory, "
+                "%lu parser warnings buffered\n",
+                megabytes, elapsed, megabytes / elapsed,
+                (unsigned long) diag->counts[DXF_DIAG_WARNING]);
+        dxf_diag_free (dxf_diag_detach (fp));
+        dxf_read_close (fp);
+        return (0);
+}
+
+
+/* EOF */
@@ -32,7 +32,11 @@
  */
 
 
+#include <pthread.h>
 #include "3dface.h"
+#include "diag.h"
+#include "allocator.h"
+#include "util.h"
 
 
 /*!
@@ -58,7 +62,7 @@ dxf_3dface_new ()
         size = sizeof (Dxf3dface);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((face = malloc (size)) == NULL)
+        if ((face = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a Dxf3dface struct.\n")),
@@ -99,6 +103,11 @@ dxf_3dface_init
 #ifdef DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static Dxf3dface template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         /* Do some basic checks. */
         if (face == NULL)
         {
@@ -114,31 +123,42 @@ dxf_3dface_init
                   __FUNCTION__);
                 return (NULL);
         }
-        face->id_code = 0;
-        face->linetype = strdup (DXF_DEFAULT_LINETYPE);
-        face->layer = strdup (DXF_DEFAULT_LAYER);
-        face->x0 = 0.0;
-        face->y0 = 0.0;
-        face->z0 = 0.0;
-        face->x1 = 0.0;
-        face->y1 = 0.0;
-        face->z1 = 0.0;
-        face->x2 = 0.0;
-        face->y2 = 0.0;
-        face->z2 = 0.0;
-        face->x3 = 0.0;
-        face->y3 = 0.0;
-        face->z3 = 0.0;
-        face->elevation = 0.0;
-        face->thickness = 0.0;
-        face->linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
-        face->visibility = DXF_DEFAULT_VISIBILITY;
-        face->color = DXF_COLOR_BYLAYER;
-        face->paperspace = DXF_MODELSPACE;
-        face->flag = 0;
-        face->dictionary_owner_soft = strdup ("");
-        face->dictionary_owner_hard = strdup ("");
-        face->next = NULL;
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.id_code = 0;
+                template.linetype = strdup (DXF_DEFAULT_LINETYPE);
+                template.layer = strdup (DXF_DEFAULT_LAYER);
+                template.x0 = 0.0;
+                template.y0 = 0.0;
+                template.z0 = 0.0;
+                template.x1 = 0.0;
+                template.y1 = 0.0;
+                template.z1 = 0.0;
+                template.x2 = 0.0;
+                template.y2 = 0.0;
+                template.z2 = 0.0;
+                template.x3 = 0.0;
+                template.y3 = 0.0;
+                template.z3 = 0.0;
+                template.elevation = 0.0;
+                template.thickness = 0.0;
+                template.linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
+                template.visibility = DXF_DEFAULT_VISIBILITY;
+                template.color = DXF_COLOR_BYLAYER;
+                template.paperspace = DXF_MODELSPACE;
+                template.flag = 0;
+                template.dictionary_owner_soft = strdup ("");
+                template.dictionary_owner_hard = strdup ("");
+                template.next = NULL;
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (face, &template, sizeof (Dxf3dface));
+        face->linetype = strdup (template.linetype);
+        face->layer = strdup (template.layer);
+        face->dictionary_owner_soft = strdup (template.dictionary_owner_soft);
+        face->dictionary_owner_hard = strdup (template.dictionary_owner_hard);
 #ifdef DEBUG
         DXF_DEBUG_END
 #endif
@@ -174,7 +194,7 @@ dxf_3dface_read
 #ifdef DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        char *temp_string = NULL;
+        char temp_string[DXF_MAX_STRING_LENGTH];
 
         /* Do some basic checks. */
         if (fp == NULL)
@@ -192,14 +212,13 @@ dxf_3dface_read
                 face = dxf_3dface_new ();
                 face = dxf_3dface_init (face);
         }
-        (fp->line_number)++;
-        fscanf (fp->fp, "%[^\n]", temp_string);
+        dxf_read_line (temp_string, fp);
         while (strcmp (temp_string, "0") != 0)
         {
                 if (ferror (fp->fp))
                 {
                         fprintf (stderr,
-                          (_("Error in %s () while reading from: %s in line: %d.\n")),
+                          (_("Error in %s () while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                         fclose (fp->fp);
                         return (NULL);
@@ -208,105 +227,94 @@ dxf_3dface_read
                 {
                         /* Now follows a string containing a sequential
                          * id number. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%x\n", &face->id_code);
+                                                dxf_read_scanf (fp, "%x\n", &face->id_code);
                 }
                 else if (strcmp (temp_string, "6") == 0)
                 {
                         /* Now follows a string containing a linetype
                          * name. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", face->linetype);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
+                        free (face->linetype);
+                        face->linetype = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "8") == 0)
                 {
                         /* Now follows a string containing a layer name. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", face->layer);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
+                        free (face->layer);
+                        face->layer = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "10") == 0)
                 {
                         /* Now follows a string containing the
                          * X-coordinate of the first point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &face->x0);
+                                                dxf_read_scanf (fp, "%lf\n", &face->x0);
                 }
                 else if (strcmp (temp_string, "20") == 0)
                 {
                         /* Now follows a string containing the
                          * Y-coordinate of the first point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &face->y0);
+                                                dxf_read_scanf (fp, "%lf\n", &face->y0);
                 }
                 else if (strcmp (temp_string, "30") == 0)
                 {
                         /* Now follows a string containing the
                          * Z-coordinate of first the point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &face->z0);
+                                                dxf_read_scanf (fp, "%lf\n", &face->z0);
                 }
                 else if (strcmp (temp_string, "11") == 0)
                 {
                         /* Now follows a string containing the
                          * X-coordinate of the second point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &face->x1);
+                                                dxf_read_scanf (fp, "%lf\n", &face->x1);
                 }
                 else if (strcmp (temp_string, "21") == 0)
                 {
                         /* Now follows a string containing the
                          * Y-coordinate of the second point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &face->y1);
+                                                dxf_read_scanf (fp, "%lf\n", &face->y1);
                 }
                 else if (strcmp (temp_string, "31") == 0)
                 {
                         /* Now follows a string containing the
                          * Z-coordinate of the second point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &face->z1);
+                                                dxf_read_scanf (fp, "%lf\n", &face->z1);
                 }
                 else if (strcmp (temp_string, "12") == 0)
                 {
                         /* Now follows a string containing the
                          * X-coordinate of the third point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &face->x2);
+                                                dxf_read_scanf (fp, "%lf\n", &face->x2);
                 }
                 else if (strcmp (temp_string, "22") == 0)
                 {
                         /* Now follows a string containing the
                          * Y-coordinate of the third point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &face->y2);
+                                                dxf_read_scanf (fp, "%lf\n", &face->y2);
                 }
                 else if (strcmp (temp_string, "32") == 0)
                 {
                         /* Now follows a string containing the
                          * Z-coordinate of the third point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &face->z2);
+                                                dxf_read_scanf (fp, "%lf\n", &face->z2);
                 }
                 else if (strcmp (temp_string, "13") == 0)
                 {
                         /* Now follows a string containing the
                          * X-coordinate of the fourth point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &face->x3);
+                                                dxf_read_scanf (fp, "%lf\n", &face->x3);
                 }
                 else if (strcmp (temp_string, "23") == 0)
                 {
                         /* Now follows a string containing the
                          * Y-coordinate of the fourth point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &face->y3);
+                                                dxf_read_scanf (fp, "%lf\n", &face->y3);
                 }
                 else if (strcmp (temp_string, "33") == 0)
                 {
                         /* Now follows a string containing the
                          * Z-coordinate of the fourth point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &face->z3);
+                                                dxf_read_scanf (fp, "%lf\n", &face->z3);
                 }
                 else if ((fp->acad_version_number <= AutoCAD_11)
                   && DXF_FLATLAND
@@ -315,56 +323,49 @@ dxf_3dface_read
                 {
                         /* Now follows a string containing the
                          * elevation. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &face->elevation);
+                                                dxf_read_scanf (fp, "%lf\n", &face->elevation);
                 }
                 else if (strcmp (temp_string, "39") == 0)
                 {
                         /* Now follows a string containing the
                          * thickness. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &face->thickness);
+                                                dxf_read_scanf (fp, "%lf\n", &face->thickness);
                 }
                 else if (strcmp (temp_string, "48") == 0)
                 {
                         /* Now follows a string containing the linetype
                          * scale. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &face->linetype_scale);
+                                                dxf_read_scanf (fp, "%lf\n", &face->linetype_scale);
                 }
                 else if (strcmp (temp_string, "60") == 0)
                 {
                         /* Now follows a string containing the
                          * visibility value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%hd\n", &face->visibility);
+                                                dxf_read_scanf (fp, "%hd\n", &face->visibility);
                 }
                 else if (strcmp (temp_string, "62") == 0)
                 {
                         /* Now follows a string containing the
                          * color value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &face->color);
+                                                dxf_read_scanf (fp, "%d\n", &face->color);
                 }
                 else if (strcmp (temp_string, "67") == 0)
                 {
                         /* Now follows a string containing the
                          * paperspace value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &face->paperspace);
+                                                dxf_read_scanf (fp, "%d\n", &face->paperspace);
                 }
                 else if ((fp->acad_version_number >= AutoCAD_13)
                         && (strcmp (temp_string, "100") == 0))
                 {
                         /* Now follows a string containing the
                          * subclass marker value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", temp_string);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
                         if ((strcmp (temp_string, "AcDbEntity") != 0)
                         && (strcmp (temp_string, "AcDbFace") != 0))
                         {
-                                fprintf (stderr,
-                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %d.\n")),
+                                dxf_diag_report (fp, DXF_DIAG_WARNING,
+                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                         }
                 }
@@ -372,36 +373,40 @@ dxf_3dface_read
                 {
                         /* Now follows a string containing the
                          * value of edge visibility flag. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &face->flag);
+                                                dxf_read_scanf (fp, "%d\n", &face->flag);
                 }
                 else if (strcmp (temp_string, "330") == 0)
                 {
                         /* Now follows a string containing Soft-pointer
                          * ID/handle to owner dictionary. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", face->dictionary_owner_soft);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
+                        free (face->dictionary_owner_soft);
+                        face->dictionary_owner_soft = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "360") == 0)
                 {
                         /* Now follows a string containing Hard owner
                          * ID/handle to owner dictionary. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", face->dictionary_owner_hard);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
+                        free (face->dictionary_owner_hard);
+                        face->dictionary_owner_hard = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "999") == 0)
                 {
                         /* Now follows a string containing a comment. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", temp_string);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
                         fprintf (stdout, (_("DXF comment: %s\n")), temp_string);
                 }
                 else
                 {
-                        fprintf (stderr,
-                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %d.\n")),
+                        dxf_diag_report (fp, DXF_DIAG_WARNING,
+                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                 }
+                if (dxf_read_line (temp_string, fp) != 1)
+                {
+                        break;
+                }
         }
         /* Handle omitted members and/or illegal values. */
         if (strcmp (face->linetype, "") == 0)
@@ -605,7 +610,7 @@ dxf_3dface_free
         free (face->layer);
         free (face->dictionary_owner_soft);
         free (face->dictionary_owner_hard);
-        free (face);
+        dxf_entity_dealloc (face, sizeof (*face));
         face = NULL;
 #ifdef DEBUG
         DXF_DEBUG_END
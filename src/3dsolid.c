@@ -41,7 +41,11 @@
  */
 
 
+#include <pthread.h>
 #include "3dsolid.h"
+#include "diag.h"
+#include "allocator.h"
+#include "util.h"
 
 
 /*!
@@ -67,7 +71,7 @@ dxf_3dsolid_new ()
         size = sizeof (Dxf3dsolid);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((solid = malloc (size)) == NULL)
+        if ((solid = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a Dxf3dsolid struct.\n")),
@@ -108,7 +112,10 @@ dxf_3dsolid_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        int i;
+        static Dxf3dsolid template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
 
         /* Do some basic checks. */
         if (solid == NULL)
@@ -125,26 +132,35 @@ dxf_3dsolid_init
                   __FUNCTION__);
                 return (NULL);
         }
-        solid->modeler_format_version_number = 0;
-        solid->id_code = 0;
-        solid->linetype = strdup (DXF_DEFAULT_LINETYPE);
-        solid->layer = strdup (DXF_DEFAULT_LAYER);
-        solid->elevation = 0.0;
-        solid->thickness = 0.0;
-        solid->linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
-        solid->visibility = DXF_DEFAULT_VISIBILITY;
-        solid->color = DXF_COLOR_BYLAYER;
-        solid->paperspace = DXF_MODELSPACE;
-        solid->modeler_format_version_number = 1;
-        solid->history = strdup ("");
-        for (i = 0; i < DXF_MAX_PARAM; i++)
-        {
-                solid->proprietary_data[i] = strdup ("");
-                solid->additional_proprietary_data[i] = strdup ("");
-        }
-        solid->dictionary_owner_soft = strdup ("");
-        solid->dictionary_owner_hard = strdup ("");
-        solid->next = NULL;
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.modeler_format_version_number = 0;
+                template.id_code = 0;
+                template.linetype = strdup (DXF_DEFAULT_LINETYPE);
+                template.layer = strdup (DXF_DEFAULT_LAYER);
+                template.elevation = 0.0;
+                template.thickness = 0.0;
+                template.linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
+                template.visibility = DXF_DEFAULT_VISIBILITY;
+                template.color = DXF_COLOR_BYLAYER;
+                template.paperspace = DXF_MODELSPACE;
+                template.modeler_format_version_number = 1;
+                template.history = strdup ("");
+                dxf_acis_data_init (&template.proprietary_data);
+                dxf_acis_data_init (&template.additional_proprietary_data);
+                template.dictionary_owner_soft = strdup ("");
+                template.dictionary_owner_hard = strdup ("");
+                template.next = NULL;
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (solid, &template, sizeof (Dxf3dsolid));
+        solid->linetype = strdup (template.linetype);
+        solid->layer = strdup (template.layer);
+        solid->history = strdup (template.history);
+        solid->dictionary_owner_soft = strdup (template.dictionary_owner_soft);
+        solid->dictionary_owner_hard = strdup (template.dictionary_owner_hard);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -181,9 +197,7 @@ dxf_3dsolid_read
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        char *temp_string = NULL;
-        int i;
-        int j;
+        char temp_string[DXF_MAX_STRING_LENGTH];
 
         /* Do some basic checks. */
         if (fp == NULL)
@@ -208,8 +222,10 @@ dxf_3dsolid_read
                 solid = dxf_3dsolid_new ();
                 solid = dxf_3dsolid_init (solid);
         }
-        i = 0;
-        j = 0;
+        /* discard stored lines but keep the blob of a recycled
+         * entity. */
+        dxf_acis_data_clear (&solid->proprietary_data);
+        dxf_acis_data_clear (&solid->additional_proprietary_data);
         (fp->line_number)++;
         fscanf (fp->fp, "%[^\n]", temp_string);
         while (strcmp (temp_string, "0") != 0)
@@ -217,26 +233,33 @@ dxf_3dsolid_read
                 if (ferror (fp->fp))
                 {
                         fprintf (stderr,
-                          (_("Error in %s () while reading from: %s in line: %d.\n")),
+                          (_("Error in %s () while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                         fclose (fp->fp);
                         return (NULL);
                 }
                 else if (strcmp (temp_string, "  1") == 0)
                 {
-                        /* Now follows a string containing proprietary
-                         * data. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", solid->proprietary_data[i]);
-                        i++;
+                        /* Now follows a line of proprietary data:
+                         * read it whole through the block reader and
+                         * append it to the blob. */
+                        if (dxf_read_line (temp_string, fp) != 1)
+                        {
+                                break;
+                        }
+                        dxf_acis_data_append (&solid->proprietary_data,
+                                temp_string);
                 }
                 else if (strcmp (temp_string, "  3") == 0)
                 {
-                        /* Now follows a string containing additional
-                         * proprietary data. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", solid->additional_proprietary_data[j]);
-                        j++;
+                        /* Now follows a line of additional proprietary
+                         * data. */
+                        if (dxf_read_line (temp_string, fp) != 1)
+                        {
+                                break;
+                        }
+                        dxf_acis_data_append (&solid->additional_proprietary_data,
+                                temp_string);
                 }
                 if (strcmp (temp_string, "5") == 0)
                 {
@@ -250,13 +273,17 @@ dxf_3dsolid_read
                         /* Now follows a string containing a linetype
                          * name. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", solid->linetype);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (solid->linetype);
+                        solid->linetype = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "8") == 0)
                 {
                         /* Now follows a string containing a layer name. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", solid->layer);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (solid->layer);
+                        solid->layer = strdup (temp_string);
                 }
                 else if ((fp->acad_version_number <= AutoCAD_11)
                   && DXF_FLATLAND
@@ -319,8 +346,8 @@ dxf_3dsolid_read
                         fscanf (fp->fp, "%s\n", temp_string);
                         if (strcmp (temp_string, "AcDbModelerGeometry") != 0)
                         {
-                                fprintf (stderr,
-                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %d.\n")),
+                                dxf_diag_report (fp, DXF_DIAG_WARNING,
+                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                         }
                 }
@@ -333,8 +360,8 @@ dxf_3dsolid_read
                         fscanf (fp->fp, "%s\n", temp_string);
                         if (strcmp (temp_string, "AcDb3dSolid") != 0)
                         {
-                                fprintf (stderr,
-                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %d.\n")),
+                                dxf_diag_report (fp, DXF_DIAG_WARNING,
+                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                         }
                 }
@@ -343,7 +370,9 @@ dxf_3dsolid_read
                         /* Now follows a string containing Soft-pointer
                          * ID/handle to owner dictionary. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", solid->dictionary_owner_soft);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (solid->dictionary_owner_soft);
+                        solid->dictionary_owner_soft = strdup (temp_string);
                 }
                 else if ((fp->acad_version_number >= AutoCAD_2008)
                         && (strcmp (temp_string, "350") == 0))
@@ -351,14 +380,18 @@ dxf_3dsolid_read
                         /* Now follows a string containing a handle to a
                          * history object. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", solid->history);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (solid->history);
+                        solid->history = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "360") == 0)
                 {
                         /* Now follows a string containing Hard owner
                          * ID/handle to owner dictionary. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", solid->dictionary_owner_hard);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (solid->dictionary_owner_hard);
+                        solid->dictionary_owner_hard = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "999") == 0)
                 {
@@ -369,8 +402,8 @@ dxf_3dsolid_read
                 }
                 else
                 {
-                        fprintf (stderr,
-                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %d.\n")),
+                        dxf_diag_report (fp, DXF_DIAG_WARNING,
+                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                 }
         }
@@ -416,7 +449,6 @@ dxf_3dsolid_write
         DXF_DEBUG_BEGIN
 #endif
         char *dxf_entity_name = strdup ("3DSOLID");
-        int i;
 
         /* Do some basic checks. */
         if (fp == NULL)
@@ -536,18 +568,8 @@ dxf_3dsolid_write
         {
                 fprintf (fp->fp, " 70\n%d\n", solid->modeler_format_version_number);
         }
-        i = 0;
-        while (strlen (solid->proprietary_data[i]) > 0)
-        {
-                fprintf (fp->fp, "  1\n%s\n", solid->proprietary_data[i]);
-                i++;
-        }
-        i = 0;
-        while (strlen (solid->additional_proprietary_data[i]) > 0)
-        {
-                fprintf (fp->fp, "  3\n%s\n", solid->additional_proprietary_data[i]);
-                i++;
-        }
+        dxf_acis_data_write (fp, 1, &solid->proprietary_data);
+        dxf_acis_data_write (fp, 3, &solid->additional_proprietary_data);
         if (fp->acad_version_number >= AutoCAD_2008)
         {
                 fprintf (fp->fp, "350\n%s\n", solid->history);
@@ -583,7 +605,6 @@ dxf_3dsolid_free
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        int i;
 
         /* Do some basic checks. */
         if (solid->next != NULL)
@@ -595,14 +616,11 @@ dxf_3dsolid_free
         }
         free (solid->linetype);
         free (solid->layer);
-        for (i = 0; i < DXF_MAX_PARAM; i++)
-        {
-                free (solid->proprietary_data[i]);
-                free (solid->additional_proprietary_data[i]);
-        }
+        dxf_acis_data_free_contents (&solid->proprietary_data);
+        dxf_acis_data_free_contents (&solid->additional_proprietary_data);
         free (solid->dictionary_owner_soft);
         free (solid->dictionary_owner_hard);
-        free (solid);
+        dxf_entity_dealloc (solid, sizeof (*solid));
         solid = NULL;
 #if DEBUG
         DXF_DEBUG_END
@@ -39,6 +39,7 @@
 
 
 #include "global.h"
+#include "acis.h"
 
 
 /*!
@@ -105,14 +106,14 @@ dxf_3dsolid
                 /*!< Hard owner ID/handle to owner dictionary (optional).\n
                  * Group code = 360. */
         /* Specific members for a DXF 3D solid. */
-        char *proprietary_data[DXF_MAX_PARAM];
+        DxfAcisData proprietary_data;
                 /*!< Proprietary data (multiple lines < 255 characters
-                 * each).\n
+                 * each), stored in one contiguous blob.\n
                  * Group code = 1. */
-        char *additional_proprietary_data[DXF_MAX_PARAM];
+        DxfAcisData additional_proprietary_data;
                 /*!< Additional lines of proprietary data if previous
                  * group 1 string is greater than 255 characters
-                 * (optional).\n
+                 * (optional), stored in one contiguous blob.\n
                  * Group code = 3. */
         int modeler_format_version_number;
                 /*!< Modeler format version number (currently = 1).\n
@@ -44,7 +44,11 @@
  */
 
 
+#include <pthread.h>
 #include "acad_proxy_entity.h"
+#include "diag.h"
+#include "allocator.h"
+#include "util.h"
 
 
 /*!
@@ -74,7 +78,7 @@ dxf_acad_proxy_entity_new ()
         size = sizeof (DxfAcadProxyEntity);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((acad_proxy_entity = malloc (size)) == NULL)
+        if ((acad_proxy_entity = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfAcadProxyEntity struct.\n")),
@@ -116,6 +120,11 @@ dxf_acad_proxy_entity_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfAcadProxyEntity template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         int i;
 
         /* Do some basic checks. */
@@ -133,23 +142,39 @@ dxf_acad_proxy_entity_init
                   __FUNCTION__);
                 return (NULL);
         }
-        acad_proxy_entity->id_code = 0;
-        acad_proxy_entity->linetype = strdup (DXF_DEFAULT_LINETYPE);
-        acad_proxy_entity->layer = strdup (DXF_DEFAULT_LAYER);
-        acad_proxy_entity->color = DXF_COLOR_BYLAYER;
-        acad_proxy_entity->linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
-        acad_proxy_entity->object_visability = 0;
-        acad_proxy_entity->original_custom_object_data_format = 1;
-        acad_proxy_entity->proxy_entity_class_id = DXF_DEFAULT_PROXY_ENTITY_ID;
-        acad_proxy_entity->application_entity_class_id = 0;
-        acad_proxy_entity->graphics_data_size = 0;
-        acad_proxy_entity->object_drawing_format = 0;
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.id_code = 0;
+                template.linetype = strdup (DXF_DEFAULT_LINETYPE);
+                template.layer = strdup (DXF_DEFAULT_LAYER);
+                template.color = DXF_COLOR_BYLAYER;
+                template.linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
+                template.object_visability = 0;
+                template.original_custom_object_data_format = 1;
+                template.proxy_entity_class_id = DXF_DEFAULT_PROXY_ENTITY_ID;
+                template.application_entity_class_id = 0;
+                template.graphics_data_size = 0;
+                template.object_drawing_format = 0;
+                dxf_binary_data_init (&template.binary_graphics_data);
+                for (i = 0; i < DXF_MAX_PARAM; i++)
+                {
+                        template.object_id[i] = strdup ("");
+                }
+                template.next = NULL;
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (acad_proxy_entity, &template, sizeof (DxfAcadProxyEntity));
         for (i = 0; i < DXF_MAX_PARAM; i++)
         {
-                acad_proxy_entity->binary_graphics_data[i] = strdup ("");
+                /* every instance owns its entries: the reader frees and
+                 * replaces them, so sharing the template strings would
+                 * free them twice. */
                 acad_proxy_entity->object_id[i] = strdup ("");
         }
-        acad_proxy_entity->next = NULL;
+        acad_proxy_entity->linetype = strdup (template.linetype);
+        acad_proxy_entity->layer = strdup (template.layer);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -188,8 +213,7 @@ dxf_acad_proxy_entity_read
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        char *temp_string = NULL;
-        int i;
+        char temp_string[DXF_MAX_STRING_LENGTH];
         int j;
 
         /* Do some basic checks. */
@@ -215,7 +239,9 @@ dxf_acad_proxy_entity_read
                 acad_proxy_entity = dxf_acad_proxy_entity_new ();
                 acad_proxy_entity = dxf_acad_proxy_entity_init (acad_proxy_entity);
         }
-        i = 0;
+        /* discard stored chunks but keep the buffer of a recycled
+         * entity. */
+        dxf_binary_data_clear (&acad_proxy_entity->binary_graphics_data);
         j = 0;
         (fp->line_number)++;
         fscanf (fp->fp, "%[^\n]", temp_string);
@@ -224,7 +250,7 @@ dxf_acad_proxy_entity_read
                 if (ferror (fp->fp))
                 {
                         fprintf (stderr,
-                          (_("Error in %s () while reading from: %s in line: %d.\n")),
+                          (_("Error in %s () while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                         fclose (fp->fp);
                         return (NULL);
@@ -241,14 +267,18 @@ dxf_acad_proxy_entity_read
                         /* Now follows a string containing the linetype
                          * name. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", acad_proxy_entity->linetype);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (acad_proxy_entity->linetype);
+                        acad_proxy_entity->linetype = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "8") == 0)
                 {
                         /* Now follows a string containing the layer
                          * name. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", acad_proxy_entity->layer);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (acad_proxy_entity->layer);
+                        acad_proxy_entity->layer = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "48") == 0)
                 {
@@ -281,7 +311,7 @@ dxf_acad_proxy_entity_read
                         if (acad_proxy_entity->original_custom_object_data_format != 1)
                         {
                                 fprintf (stderr,
-                                  (_("Error in %s () found a bad original custom object data format value in: %s in line: %d.\n")),
+                                  (_("Error in %s () found a bad original custom object data format value in: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                         }
                 }
@@ -294,7 +324,7 @@ dxf_acad_proxy_entity_read
                         if (acad_proxy_entity->proxy_entity_class_id != DXF_DEFAULT_PROXY_ENTITY_ID)
                         {
                                 fprintf (stderr,
-                                  (_("Warning in %s () found a bad proxy entity class ID in: %s in line: %d.\n")),
+                                  (_("Warning in %s () found a bad proxy entity class ID in: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                         }
                 }
@@ -307,7 +337,7 @@ dxf_acad_proxy_entity_read
                         if (acad_proxy_entity->application_entity_class_id < 500)
                         {
                                 fprintf (stderr,
-                                  (_("Warning in %s () found a bad value in application entity class ID in: %s in line: %d.\n")),
+                                  (_("Warning in %s () found a bad value in application entity class ID in: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                         }
                 }
@@ -344,18 +374,33 @@ dxf_acad_proxy_entity_read
                           && ((strcmp (temp_string, "AcDbZombieEntity") != 0))
                           && ((strcmp (temp_string, "AcDbProxyEntity") != 0)))
                         {
-                                fprintf (stderr,
-                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %d.\n")),
+                                dxf_diag_report (fp, DXF_DIAG_WARNING,
+                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                         }
                 }
                 else if (strcmp (temp_string, "310") == 0)
                 {
-                        /* Now follows a string containing binary
-                         * graphics data. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", acad_proxy_entity->binary_graphics_data[i]);
-                        i++;
+                        /* Now follows a batch of binary graphics data
+                         * chunk lines: decode them into the chunk
+                         * buffer in a tight loop. */
+                        while (strcmp (temp_string, "310") == 0)
+                        {
+                                if (dxf_read_line (temp_string, fp) != 1)
+                                {
+                                        break;
+                                }
+                                dxf_binary_data_append_hex
+                                        (&acad_proxy_entity->binary_graphics_data,
+                                        temp_string);
+                                if (dxf_read_line (temp_string, fp) != 1)
+                                {
+                                        break;
+                                }
+                        }
+                        /* the tag following the batch is already in
+                         * temp_string. */
+                        continue;
                 }
                 else if ((strcmp (temp_string, "330") == 0)
                   || (strcmp (temp_string, "340") == 0)
@@ -364,7 +409,9 @@ dxf_acad_proxy_entity_read
                 {
                         /* Now follows a string containing an object id. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", acad_proxy_entity->object_id[j]);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (acad_proxy_entity->object_id[j]);
+                        acad_proxy_entity->object_id[j] = strdup (temp_string);
                         j++;
                 }
                 else if (strcmp (temp_string, "999") == 0)
@@ -376,8 +423,8 @@ dxf_acad_proxy_entity_read
                 }
                 else
                 {
-                        fprintf (stderr,
-                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %d.\n")),
+                        dxf_diag_report (fp, DXF_DIAG_WARNING,
+                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                 }
         }
@@ -485,18 +532,9 @@ dxf_acad_proxy_entity_write
         fprintf (fp->fp, " 90\n%d\n", acad_proxy_entity->proxy_entity_class_id);
         fprintf (fp->fp, " 91\n%d\n", acad_proxy_entity->application_entity_class_id);
         fprintf (fp->fp, " 92\n%d\n", acad_proxy_entity->graphics_data_size);
-        i = 0;
-        while (strlen (acad_proxy_entity->binary_graphics_data[i]) > 0)
-        {
-                fprintf (fp->fp, "310\n%s\n", acad_proxy_entity->binary_graphics_data[i]);
-                i++;
-        }
+        dxf_binary_data_write (fp, 310,
+                &acad_proxy_entity->binary_graphics_data);
         fprintf (fp->fp, " 93\n%d\n", acad_proxy_entity->entity_data_size);
-        while (strlen (acad_proxy_entity->binary_graphics_data[i]) > 0)
-        {
-                fprintf (fp->fp, "310\n%s\n", acad_proxy_entity->binary_graphics_data[i]);
-                i++;
-        }
         i = 0;
         while (strlen (acad_proxy_entity->object_id[i]) > 0)
         {
@@ -555,12 +593,12 @@ dxf_acad_proxy_entity_free
         }
         free (acad_proxy_entity->linetype);
         free (acad_proxy_entity->layer);
+        dxf_binary_data_free_contents (&acad_proxy_entity->binary_graphics_data);
         for (i = 0; i < DXF_MAX_PARAM; i++)
         {
-                free (acad_proxy_entity->binary_graphics_data[i]);
                 free (acad_proxy_entity->object_id[i]);
         }
-        free (acad_proxy_entity);
+        dxf_entity_dealloc (acad_proxy_entity, sizeof (*acad_proxy_entity));
         acad_proxy_entity = NULL;
 #if DEBUG
         DXF_DEBUG_END
@@ -42,6 +42,7 @@
 
 
 #include "global.h"
+#include "binary_data.h"
 
 
 /*!
@@ -125,9 +126,10 @@ dxf_acad_proxy_entity
                  * High word is MaintenanceReleaseVersion.
                  * Added in AutoCAD release 2000.\n
                  * Group code = 95. */
-        char *binary_graphics_data[DXF_MAX_PARAM];
+        DxfBinaryData binary_graphics_data;
                 /*!< Binary graphics data (multiple entries can appear)
-                 * (optional).\n
+                 * (optional), decoded into one contiguous chunk
+                 * buffer.\n
                  * Group code = 310. */
         char *object_id[DXF_MAX_PARAM];
                 /*!< An object ID (multiple entries can appear).\n
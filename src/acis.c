@@ -0,0 +1,320 @@
+/*!
+ * \file acis.c
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Functions for ACIS proprietary data storage.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#include "acis.h"
+
+
+/*!
+ * The initial size, in bytes, of the proprietary data blob.
+ */
+#define DXF_ACIS_DATA_INITIAL_BLOB_SIZE 4096
+
+
+/*!
+ * The initial number of entries of the line offset array.
+ */
+#define DXF_ACIS_DATA_INITIAL_OFFSETS_SIZE 64
+
+
+/*!
+ * \brief Initialize the data fields of a \c DxfAcisData.
+ *
+ * \return a pointer to \c data, or \c NULL when a NULL pointer was
+ * passed.
+ */
+DxfAcisData *
+dxf_acis_data_init
+(
+        DxfAcisData *data
+                /*!< ACIS proprietary data. */
+)
+{
+        if (data == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        data->blob = NULL;
+        data->blob_size = 0;
+        data->blob_used = 0;
+        data->offsets = NULL;
+        data->offsets_size = 0;
+        data->number_of_lines = 0;
+        return (data);
+}
+
+
+/*!
+ * \brief Discard the stored lines of a \c DxfAcisData but keep the
+ * allocated storage, so a recycled entity reuses its blob.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when an error
+ * occurred.
+ */
+int
+dxf_acis_data_clear
+(
+        DxfAcisData *data
+                /*!< ACIS proprietary data. */
+)
+{
+        if (data == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        data->blob_used = 0;
+        data->number_of_lines = 0;
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Append a line of proprietary data to the blob of a
+ * \c DxfAcisData.
+ *
+ * The blob and the offset array grow by doubling, so appending the
+ * lines of an arbitrarily large solid stays amortized constant per
+ * line.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when an error
+ * occurred.
+ */
+int
+dxf_acis_data_append
+(
+        DxfAcisData *data,
+                /*!< ACIS proprietary data. */
+        const char *line
+                /*!< the line to append. */
+)
+{
+        char *blob;
+        size_t *offsets;
+        size_t blob_size;
+        size_t length;
+        int offsets_size;
+
+        if ((data == NULL) || (line == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        length = strlen (line) + 1;
+        if (data->blob_used + length > data->blob_size)
+        {
+                blob_size = (data->blob_size == 0)
+                        ? DXF_ACIS_DATA_INITIAL_BLOB_SIZE
+                        : (data->blob_size * 2);
+                while (blob_size < data->blob_used + length)
+                {
+                        blob_size *= 2;
+                }
+                blob = realloc (data->blob, blob_size);
+                if (blob == NULL)
+                {
+                        fprintf (stderr,
+                          (_("Error in %s () could not allocate memory.\n")),
+                          __FUNCTION__);
+                        return (EXIT_FAILURE);
+                }
+                data->blob = blob;
+                data->blob_size = blob_size;
+        }
+        if (data->number_of_lines >= data->offsets_size)
+        {
+                offsets_size = (data->offsets_size == 0)
+                        ? DXF_ACIS_DATA_INITIAL_OFFSETS_SIZE
+                        : (data->offsets_size * 2);
+                offsets = realloc (data->offsets,
+                        offsets_size * sizeof (size_t));
+                if (offsets == NULL)
+                {
+                        fprintf (stderr,
+                          (_("Error in %s () could not allocate memory.\n")),
+                          __FUNCTION__);
+                        return (EXIT_FAILURE);
+                }
+                data->offsets = offsets;
+                data->offsets_size = offsets_size;
+        }
+        data->offsets[data->number_of_lines] = data->blob_used;
+        memcpy (data->blob + data->blob_used, line, length);
+        data->blob_used += length;
+        data->number_of_lines++;
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Get a stored line of proprietary data from a \c DxfAcisData.
+ *
+ * \return a pointer into the blob, or \c NULL when the index is out of
+ * range.
+ */
+const char *
+dxf_acis_data_line
+(
+        DxfAcisData *data,
+                /*!< ACIS proprietary data. */
+        int index
+                /*!< index of the line, starting at 0. */
+)
+{
+        if (data == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        if ((index < 0) || (index >= data->number_of_lines))
+        {
+                return (NULL);
+        }
+        return (data->blob + data->offsets[index]);
+}
+
+
+/*!
+ * \brief Write all stored lines of a \c DxfAcisData as groups with the
+ * passed group code.
+ *
+ * All lines are batched into one output buffer with precomposed group
+ * code prefixes and emitted with a single \c fwrite call.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when an error
+ * occurred.
+ */
+int
+dxf_acis_data_write
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an output file (or device). */
+        int group_code,
+                /*!< DXF group code to write the lines with. */
+        DxfAcisData *data
+                /*!< ACIS proprietary data. */
+)
+{
+        char prefix[8];
+        const char *line;
+        char *buffer;
+        size_t size;
+        size_t used;
+        size_t length;
+        int i;
+
+        if ((fp == NULL) || (data == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (data->number_of_lines == 0)
+        {
+                return (EXIT_SUCCESS);
+        }
+        sprintf (prefix, "%3d\n", group_code);
+        /* every stored NUL becomes a newline, plus 4 prefix bytes per
+         * line. */
+        size = data->blob_used + ((size_t) data->number_of_lines * 4);
+        buffer = malloc (size);
+        if (buffer == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        used = 0;
+        for (i = 0; i < data->number_of_lines; i++)
+        {
+                line = data->blob + data->offsets[i];
+                length = strlen (line);
+                memcpy (buffer + used, prefix, 4);
+                used += 4;
+                memcpy (buffer + used, line, length);
+                used += length;
+                buffer[used] = '\n';
+                used++;
+        }
+        if (fwrite (buffer, 1, used, fp->fp) != used)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () while writing to: %s.\n")),
+                  __FUNCTION__, fp->filename);
+                free (buffer);
+                return (EXIT_FAILURE);
+        }
+        free (buffer);
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Free the allocated storage of a \c DxfAcisData.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when an error
+ * occurred.
+ */
+int
+dxf_acis_data_free_contents
+(
+        DxfAcisData *data
+                /*!< ACIS proprietary data. */
+)
+{
+        if (data == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        free (data->blob);
+        free (data->offsets);
+        return (dxf_acis_data_init (data) == NULL
+                ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+
+
+/* EOF */
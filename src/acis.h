@@ -0,0 +1,81 @@
+/*!
+ * \file acis.h
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Header for ACIS proprietary data storage.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#ifndef LIBDXF_SRC_ACIS_H
+#define LIBDXF_SRC_ACIS_H
+
+
+#include "global.h"
+
+
+/*!
+ * \brief DXF definition of ACIS proprietary data.
+ *
+ * The \c REGION, \c BODY and \c 3DSOLID entities carry their modeler
+ * geometry as lines of ACIS proprietary data.\n
+ * The lines are stored back to back in one contiguous, growable blob
+ * with an array of line offsets, instead of one heap allocation per
+ * line bounded by \c DXF_MAX_PARAM.
+ */
+typedef struct
+dxf_acis_data
+{
+        char *blob;
+                /*!< all lines of proprietary data stored back to back,
+                 * each NUL terminated. */
+        size_t blob_size;
+                /*!< allocated size of \c blob in bytes. */
+        size_t blob_used;
+                /*!< number of bytes used in \c blob. */
+        size_t *offsets;
+                /*!< offset of the start of each line in \c blob. */
+        int offsets_size;
+                /*!< number of allocated entries in \c offsets. */
+        int number_of_lines;
+                /*!< number of lines stored. */
+} DxfAcisData;
+
+
+DxfAcisData *dxf_acis_data_init (DxfAcisData *data);
+int dxf_acis_data_clear (DxfAcisData *data);
+int dxf_acis_data_append (DxfAcisData *data, const char *line);
+const char *dxf_acis_data_line (DxfAcisData *data, int index);
+int dxf_acis_data_write (DxfFile *fp, int group_code, DxfAcisData *data);
+int dxf_acis_data_free_contents (DxfAcisData *data);
+
+
+#endif /* LIBDXF_SRC_ACIS_H */
+
+
+/* EOF */
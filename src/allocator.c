@@ -0,0 +1,265 @@
+/*!
+ * \file allocator.c
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Functions for the size-classed recycling entity allocator.
+ *
+ * A long-running consumer parses, processes and frees drawings in a
+ * loop; with every entity struct coming from an individual \c malloc
+ * the allocator's fragmentation grows the resident set steadily.\n
+ * All entity modules share the same new/free pattern, so their structs
+ * are routed through this allocator instead: freed structs of a size
+ * class are kept on a free list and handed out again by the next
+ * \c dxf_*_new of a similar size, and \c dxf_allocator_trim returns
+ * everything cached to the system between jobs.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#include <pthread.h>
+#include "global.h"
+#include "allocator.h"
+#include "profile.h"
+
+
+/*!
+ * \brief A node of one size class free list, stored inside the freed
+ * struct itself.
+ */
+typedef struct
+dxf_free_node
+{
+        struct dxf_free_node *next;
+                /*!< pointer to the next freed struct of the same size
+                 * class, or \c NULL. */
+} DxfFreeNode;
+
+
+/*!
+ * The per-class free lists, shared by every thread: the parallel
+ * section and ENTITIES workers allocate and free entity structs
+ * concurrently, so every list and byte counter access runs under
+ * \c dxf_allocator_mutex.
+ */
+static DxfFreeNode *dxf_free_lists[DXF_ALLOCATOR_CLASSES];
+
+static pthread_mutex_t dxf_allocator_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/*!
+ * Bytes currently handed out to live entity structs.
+ */
+static size_t dxf_allocator_live_bytes;
+
+/*!
+ * Bytes currently retained on the free lists.
+ */
+static size_t dxf_allocator_cached_bytes;
+
+
+/*!
+ * \brief Map a request size to its size class.
+ *
+ * \return the class number, or \c -1 when the size is served by plain
+ * \c malloc.
+ */
+static int
+dxf_allocator_class
+(
+        size_t size
+                /*!< the requested size in bytes. */
+)
+{
+        if ((size < sizeof (DxfFreeNode))
+                || (size > (DXF_ALLOCATOR_CLASS_SIZE * DXF_ALLOCATOR_CLASSES)))
+        {
+                return (-1);
+        }
+        return (((int) size - 1) / DXF_ALLOCATOR_CLASS_SIZE);
+}
+
+
+/*!
+ * \brief Allocate memory for an entity struct, recycling a freed
+ * struct of the same size class when one is cached.
+ *
+ * The memory is not zeroed; callers keep their \c memset, exactly as
+ * with \c malloc.
+ *
+ * \return a pointer to the memory, or \c NULL when no memory was
+ * allocated.
+ */
+void *
+dxf_entity_alloc
+(
+        size_t size
+                /*!< the requested size in bytes. */
+)
+{
+        DxfFreeNode *node;
+        int class;
+
+        class = dxf_allocator_class (size);
+        if (class >= 0)
+        {
+                pthread_mutex_lock (&dxf_allocator_mutex);
+                if (dxf_free_lists[class] != NULL)
+                {
+                        node = dxf_free_lists[class];
+                        dxf_free_lists[class] = node->next;
+                        dxf_allocator_cached_bytes -=
+                                (size_t) (class + 1) * DXF_ALLOCATOR_CLASS_SIZE;
+                        dxf_allocator_live_bytes +=
+                                (size_t) (class + 1) * DXF_ALLOCATOR_CLASS_SIZE;
+                        pthread_mutex_unlock (&dxf_allocator_mutex);
+                        DXF_PROFILE_COUNT (free_list_hits);
+                        return (node);
+                }
+                pthread_mutex_unlock (&dxf_allocator_mutex);
+                /* Allocate the full class size so the block can serve
+                 * any request of this class when recycled. */
+                size = (class + 1) * DXF_ALLOCATOR_CLASS_SIZE;
+        }
+        node = malloc (size);
+        if (node != NULL)
+        {
+                pthread_mutex_lock (&dxf_allocator_mutex);
+                dxf_allocator_live_bytes += size;
+                pthread_mutex_unlock (&dxf_allocator_mutex);
+        }
+        DXF_PROFILE_COUNT (mallocs);
+        return (node);
+}
+
+
+/*!
+ * \brief Return an entity struct to its size class free list for
+ * recycling.
+ *
+ * \c size must be the size passed to \c dxf_entity_alloc; oversized
+ * blocks go back to the system immediately.
+ */
+void
+dxf_entity_dealloc
+(
+        void *ptr,
+                /*!< the struct to recycle. */
+        size_t size
+                /*!< the size passed when the struct was allocated. */
+)
+{
+        DxfFreeNode *node;
+        int class;
+
+        if (ptr == NULL)
+        {
+                return;
+        }
+        class = dxf_allocator_class (size);
+        if (class < 0)
+        {
+                pthread_mutex_lock (&dxf_allocator_mutex);
+                dxf_allocator_live_bytes -= size;
+                pthread_mutex_unlock (&dxf_allocator_mutex);
+                free (ptr);
+                return;
+        }
+        pthread_mutex_lock (&dxf_allocator_mutex);
+        dxf_allocator_live_bytes -=
+                (size_t) (class + 1) * DXF_ALLOCATOR_CLASS_SIZE;
+        dxf_allocator_cached_bytes +=
+                (size_t) (class + 1) * DXF_ALLOCATOR_CLASS_SIZE;
+        node = ptr;
+        node->next = dxf_free_lists[class];
+        dxf_free_lists[class] = node;
+        pthread_mutex_unlock (&dxf_allocator_mutex);
+}
+
+
+/*!
+ * \brief Return all cached structs to the system.
+ *
+ * Call between jobs to shrink the resident set of a long-running
+ * process.
+ */
+void
+dxf_allocator_trim ()
+{
+        DxfFreeNode *node;
+        DxfFreeNode *next;
+        int class;
+
+        pthread_mutex_lock (&dxf_allocator_mutex);
+        for (class = 0; class < DXF_ALLOCATOR_CLASSES; class++)
+        {
+                node = dxf_free_lists[class];
+                while (node != NULL)
+                {
+                        next = node->next;
+                        free (node);
+                        node = next;
+                }
+                dxf_free_lists[class] = NULL;
+        }
+        dxf_allocator_cached_bytes = 0;
+        pthread_mutex_unlock (&dxf_allocator_mutex);
+}
+
+
+/*!
+ * \brief Report the bytes held by the entity allocator.
+ *
+ * Entity structs — and the hatch boundary graph nodes, which are
+ * allocated through the same pool — count as live from
+ * \c dxf_entity_alloc until \c dxf_entity_dealloc, and as cached while
+ * they sit on a free list awaiting recycling.
+ */
+void
+dxf_allocator_stats
+(
+        size_t *live_bytes,
+                /*!< bytes handed out to live structs are returned
+                 * here. */
+        size_t *cached_bytes
+                /*!< bytes retained on the free lists are returned
+                 * here. */
+)
+{
+        pthread_mutex_lock (&dxf_allocator_mutex);
+        if (live_bytes != NULL)
+        {
+                *live_bytes = dxf_allocator_live_bytes;
+        }
+        if (cached_bytes != NULL)
+        {
+                *cached_bytes = dxf_allocator_cached_bytes;
+        }
+        pthread_mutex_unlock (&dxf_allocator_mutex);
+}
+
+
+/* EOF */
@@ -0,0 +1,79 @@
+/*!
+ * \file allocator.h
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Header for the size-classed recycling entity allocator.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#ifndef LIBDXF_SRC_ALLOCATOR_H
+#define LIBDXF_SRC_ALLOCATOR_H
+
+
+#include <stddef.h>
+
+
+/*!
+ * The granularity, in bytes, of one allocator size class.
+ */
+#define DXF_ALLOCATOR_CLASS_SIZE 64
+
+/*!
+ * The number of size classes; requests beyond
+ * \c DXF_ALLOCATOR_CLASS_SIZE * \c DXF_ALLOCATOR_CLASSES bytes go
+ * straight to \c malloc.
+ */
+#define DXF_ALLOCATOR_CLASSES 32
+
+
+void *
+dxf_entity_alloc
+(
+        size_t size
+);
+void
+dxf_entity_dealloc
+(
+        void *ptr,
+        size_t size
+);
+void
+dxf_allocator_trim ();
+void
+dxf_allocator_stats
+(
+        size_t *live_bytes,
+        size_t *cached_bytes
+);
+
+
+#endif /* LIBDXF_SRC_ALLOCATOR_H */
+
+
+/* EOF */
@@ -0,0 +1,150 @@
+/*!
+ * \file amalgamation.c
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Single translation unit ("amalgamated") build of libdxf.
+ *
+ * Compiling the whole library as one translation unit lets the compiler
+ * inline the tokenizer (\c dxf_read_line and friends) and the group code
+ * dispatch into every \c *_read and \c *_write function, which a shared
+ * library built from ~60 separate translation units can not do without
+ * link time optimization.\n
+ * It also reduces embedding libdxf in another program to compiling a
+ * single file.\n
+ * \n
+ * Build with <tt>./configure --enable-amalgamation</tt>, or compile this
+ * file directly:\n
+ * <tt>gcc -O2 -c src/amalgamation.c</tt>\n
+ * \n
+ * The include order below matches the \c libdxf_la_SOURCES list in
+ * \c Makefile.am; when a source file is added there it has to be added
+ * here as well.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#include "writer.c"
+#include "vport.c"
+#include "viewport.c"
+#include "view.c"
+#include "vertex.c"
+#include "util.c"
+#include "ucs.c"
+#include "transform.c"
+#include "trace.c"
+#include "thumbnail.c"
+#include "text.c"
+#include "tag_dictionary.c"
+#include "tables.c"
+#include "table.c"
+#include "symbol_table.c"
+#include "style.c"
+#include "spline.c"
+#include "soa.c"
+#include "solid.c"
+#include "sidecar.c"
+#include "shape.c"
+#include "seqend.c"
+#include "section.c"
+#include "rtree.c"
+#include "ring.c"
+#include "region.c"
+#include "recode.c"
+#include "ray.c"
+#include "quad_cloud.c"
+#include "profile.c"
+#include "polyline.c"
+#include "point_cloud.c"
+#include "point.c"
+#include "pipeline.c"
+#include "parser.c"
+#include "oleframe.c"
+#include "objects.c"
+#include "object.c"
+#include "mtext.c"
+#include "memstats.c"
+#include "lwpolyline.c"
+#include "ltype.c"
+#include "line.c"
+#include "lazy.c"
+#include "layer_registry.c"
+#include "layer_index.c"
+#include "layer.c"
+#include "insert.c"
+#include "image_cache.c"
+#include "image.c"
+#include "helix.c"
+#include "handle.c"
+#include "header.c"
+#include "hatch.c"
+#include "font_cache.c"
+#include "file.c"
+#include "field_generated.c"
+#include "field_codegen.c"
+#include "field.c"
+#include "feed.c"
+#include "extents.c"
+#include "entity_registry.c"
+#include "entity.c"
+#include "entities.c"
+#include "endtab.c"
+#include "endsec.c"
+#include "endblk.c"
+#include "ellipse.c"
+#include "drawing.c"
+#include "donut.c"
+#include "doc_cache.c"
+#include "dimstyle.c"
+#include "dimension.c"
+#include "diag.c"
+#include "dash_cache.c"
+#include "config.c"
+#include "compact.c"
+#include "comment.c"
+#include "color.c"
+#include "class.c"
+#include "circle.c"
+#include "chunk.c"
+#include "census.c"
+#include "block_record.c"
+#include "binary_data.c"
+#include "block.c"
+#include "body.c"
+#include "attrib.c"
+#include "attdef.c"
+#include "arena.c"
+#include "allocator.c"
+#include "arc.c"
+#include "appid.c"
+#include "acad_proxy_entity.c"
+#include "acis.c"
+#include "3dsolid.c"
+#include "3dface.c"
+
+
+/* EOF */
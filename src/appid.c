@@ -47,7 +47,10 @@
  */
 
 
+#include <pthread.h>
 #include "appid.h"
+#include "diag.h"
+#include "allocator.h"
 
 
 /*!
@@ -73,7 +76,7 @@ dxf_appid_new ()
         size = sizeof (DxfAppid);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((appid = malloc (size)) == NULL)
+        if ((appid = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfAppid struct.\n")),
@@ -114,6 +117,11 @@ dxf_appid_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfAppid template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         /* Do some basic checks. */
         if (appid == NULL)
         {
@@ -129,12 +137,22 @@ dxf_appid_init
                   __FUNCTION__);
                 return (NULL);
         }
-        appid->id_code = 0;
-        appid->application_name = strdup ("");
-        appid->flag = 0;
-        appid->dictionary_owner_soft = strdup ("");
-        appid->dictionary_owner_hard = strdup ("");
-        appid->next = NULL;
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.id_code = 0;
+                template.application_name = strdup ("");
+                template.flag = 0;
+                template.dictionary_owner_soft = strdup ("");
+                template.dictionary_owner_hard = strdup ("");
+                template.next = NULL;
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (appid, &template, sizeof (DxfAppid));
+        appid->application_name = strdup (template.application_name);
+        appid->dictionary_owner_soft = strdup (template.dictionary_owner_soft);
+        appid->dictionary_owner_hard = strdup (template.dictionary_owner_hard);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -172,7 +190,7 @@ dxf_appid_read
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        char *temp_string = NULL;
+        char temp_string[DXF_MAX_STRING_LENGTH];
 
         /* Do some basic checks. */
         if (fp == NULL)
@@ -197,7 +215,7 @@ dxf_appid_read
                 if (ferror (fp->fp))
                 {
                         fprintf (stderr,
-                          (_("Error in %s () while reading from: %s in line: %d.\n")),
+                          (_("Error in %s () while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                         fclose (fp->fp);
                         return (NULL);
@@ -214,7 +232,9 @@ dxf_appid_read
                         /* Now follows a string containing an application
                          * name. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", appid->application_name);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (appid->application_name);
+                        appid->application_name = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "70") == 0)
                 {
@@ -228,14 +248,18 @@ dxf_appid_read
                         /* Now follows a string containing Soft-pointer
                          * ID/handle to owner dictionary. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", appid->dictionary_owner_soft);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (appid->dictionary_owner_soft);
+                        appid->dictionary_owner_soft = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "360") == 0)
                 {
                         /* Now follows a string containing Hard owner
                          * ID/handle to owner dictionary. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", appid->dictionary_owner_hard);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (appid->dictionary_owner_hard);
+                        appid->dictionary_owner_hard = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "999") == 0)
                 {
@@ -246,8 +270,8 @@ dxf_appid_read
                 }
                 else
                 {
-                        fprintf (stderr,
-                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %d.\n")),
+                        dxf_diag_report (fp, DXF_DIAG_WARNING,
+                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                 }
         }
@@ -391,7 +415,7 @@ dxf_appid_free
         free (appid->application_name);
         free (appid->dictionary_owner_soft);
         free (appid->dictionary_owner_hard);
-        free (appid);
+        dxf_entity_dealloc (appid, sizeof (*appid));
         appid = NULL;
 #if DEBUG
         DXF_DEBUG_END
@@ -32,7 +32,13 @@
  */
 
 
+#include <math.h>
+
+#include <pthread.h>
 #include "arc.h"
+#include "diag.h"
+#include "allocator.h"
+#include "util.h"
 
 
 /*!
@@ -61,7 +67,7 @@ dxf_arc_new ()
         size = sizeof (DxfArc);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((arc = malloc (size)) == NULL)
+        if ((arc = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfArc struct.\n")),
@@ -102,6 +108,11 @@ dxf_arc_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfArc template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         /* Do some basic checks. */
         if (arc == NULL)
         {
@@ -117,27 +128,39 @@ dxf_arc_init
                   __FUNCTION__);
                 return (NULL);
         }
-        arc->id_code = 0;
-        arc->linetype = strdup (DXF_DEFAULT_LINETYPE);
-        arc->layer = strdup (DXF_DEFAULT_LAYER);
-        arc->x0 = 0.0;
-        arc->y0 = 0.0;
-        arc->z0 = 0.0;
-        arc->extr_x0 = 0.0;
-        arc->extr_y0 = 0.0;
-        arc->extr_z0 = 0.0;
-        arc->elevation = 0.0;
-        arc->thickness = 0.0;
-        arc->linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
-        arc->visibility = DXF_DEFAULT_VISIBILITY;
-        arc->radius = 0.0;
-        arc->start_angle = 0.0;
-        arc->end_angle = 0.0;
-        arc->color = DXF_COLOR_BYLAYER;
-        arc->paperspace = DXF_MODELSPACE;
-        arc->dictionary_owner_soft = strdup ("");
-        arc->dictionary_owner_hard = strdup ("");
-        arc->next = NULL;
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.id_code = 0;
+                template.linetype = strdup (DXF_DEFAULT_LINETYPE);
+                template.layer = strdup (DXF_DEFAULT_LAYER);
+                template.x0 = 0.0;
+                template.y0 = 0.0;
+                template.z0 = 0.0;
+                template.extr_x0 = 0.0;
+                template.extr_y0 = 0.0;
+                template.extr_z0 = 0.0;
+                template.elevation = 0.0;
+                template.thickness = 0.0;
+                template.linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
+                template.visibility = DXF_DEFAULT_VISIBILITY;
+                template.radius = 0.0;
+                template.start_angle = 0.0;
+                template.end_angle = 0.0;
+                template.color = DXF_COLOR_BYLAYER;
+                template.paperspace = DXF_MODELSPACE;
+                template.dictionary_owner_soft = strdup ("");
+                template.dictionary_owner_hard = strdup ("");
+                template.tessellation = NULL;
+                template.next = NULL;
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (arc, &template, sizeof (DxfArc));
+        arc->linetype = strdup (template.linetype);
+        arc->layer = strdup (template.layer);
+        arc->dictionary_owner_soft = strdup (template.dictionary_owner_soft);
+        arc->dictionary_owner_hard = strdup (template.dictionary_owner_hard);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -174,7 +197,7 @@ dxf_arc_read
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        char *temp_string = NULL;
+        char temp_string[DXF_MAX_STRING_LENGTH];
 
         /* Do some basic checks. */
         if (fp == NULL)
@@ -192,14 +215,13 @@ dxf_arc_read
                 arc = dxf_arc_new ();
                 arc = dxf_arc_init (arc);
         }
-        (fp->line_number)++;
-        fscanf (fp->fp, "%[^\n]", temp_string);
+        dxf_read_line (temp_string, fp);
         while (strcmp (temp_string, "0") != 0)
         {
                 if (ferror (fp->fp))
                 {
                         fprintf (stderr,
-                          (_("Error in %s () while reading from: %s in line: %d.\n")),
+                          (_("Error in %s () while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                         fclose (fp->fp);
                         return (NULL);
@@ -208,42 +230,40 @@ dxf_arc_read
                 {
                         /* Now follows a string containing a sequential
                          * id number. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%x\n", &arc->id_code);
+                                                dxf_read_scanf (fp, "%x\n", &arc->id_code);
                 }
                 else if (strcmp (temp_string, "6") == 0)
                 {
                         /* Now follows a string containing a linetype
                          * name. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", arc->linetype);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
+                        free (arc->linetype);
+                        arc->linetype = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "8") == 0)
                 {
                         /* Now follows a string containing a layer name. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", arc->layer);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
+                        free (arc->layer);
+                        arc->layer = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "10") == 0)
                 {
                         /* Now follows a string containing the
                          * X-coordinate of the center point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &arc->x0);
+                                                dxf_read_scanf (fp, "%lf\n", &arc->x0);
                 }
                 else if (strcmp (temp_string, "20") == 0)
                 {
                         /* Now follows a string containing the
                          * Y-coordinate of the center point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &arc->y0);
+                                                dxf_read_scanf (fp, "%lf\n", &arc->y0);
                 }
                 else if (strcmp (temp_string, "30") == 0)
                 {
                         /* Now follows a string containing the
                          * Z-coordinate of the center point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &arc->z0);
+                                                dxf_read_scanf (fp, "%lf\n", &arc->z0);
                 }
                 else if ((fp->acad_version_number <= AutoCAD_11)
                         && (strcmp (temp_string, "38") == 0)
@@ -251,77 +271,67 @@ dxf_arc_read
                 {
                         /* Now follows a string containing the
                          * elevation. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &arc->elevation);
+                                                dxf_read_scanf (fp, "%lf\n", &arc->elevation);
                 }
                 else if (strcmp (temp_string, "39") == 0)
                 {
                         /* Now follows a string containing the
                          * thickness. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &arc->thickness);
+                                                dxf_read_scanf (fp, "%lf\n", &arc->thickness);
                 }
                 else if (strcmp (temp_string, "40") == 0)
                 {
                         /* Now follows a string containing the
                          * radius. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &arc->radius);
+                                                dxf_read_scanf (fp, "%lf\n", &arc->radius);
                 }
                 else if (strcmp (temp_string, "48") == 0)
                 {
                         /* Now follows a string containing the linetype
                          * scale. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &arc->linetype_scale);
+                                                dxf_read_scanf (fp, "%lf\n", &arc->linetype_scale);
                 }
                 else if (strcmp (temp_string, "50") == 0)
                 {
                         /* Now follows a string containing the
                          * start angle. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &arc->start_angle);
+                                                dxf_read_scanf (fp, "%lf\n", &arc->start_angle);
                 }
                 else if (strcmp (temp_string, "51") == 0)
                 {
                         /* Now follows a string containing the
                          * end angle. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &arc->end_angle);
+                                                dxf_read_scanf (fp, "%lf\n", &arc->end_angle);
                 }
                 else if (strcmp (temp_string, "60") == 0)
                 {
                         /* Now follows a string containing the
                          * visibility value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%hd\n", &arc->visibility);
+                                                dxf_read_scanf (fp, "%hd\n", &arc->visibility);
                 }
                 else if (strcmp (temp_string, "62") == 0)
                 {
                         /* Now follows a string containing the
                          * color value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &arc->color);
+                                                dxf_read_scanf (fp, "%d\n", &arc->color);
                 }
                 else if (strcmp (temp_string, "67") == 0)
                 {
                         /* Now follows a string containing the
                          * paperspace value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &arc->paperspace);
+                                                dxf_read_scanf (fp, "%d\n", &arc->paperspace);
                 }
                 else if ((fp->acad_version_number >= AutoCAD_13)
                         && (strcmp (temp_string, "100") == 0))
                 {
                         /* Now follows a string containing the
                          * subclass marker value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", temp_string);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
                         if ((strcmp (temp_string, "AcDbEntity") != 0)
                         && ((strcmp (temp_string, "AcDbCircle") != 0)))
                         {
-                                fprintf (stderr,
-                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %d.\n")),
+                                dxf_diag_report (fp, DXF_DIAG_WARNING,
+                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                         }
                 }
@@ -329,50 +339,52 @@ dxf_arc_read
                 {
                         /* Now follows a string containing the
                          * X-value of the extrusion vector. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &arc->extr_x0);
+                                                dxf_read_scanf (fp, "%lf\n", &arc->extr_x0);
                 }
                 else if (strcmp (temp_string, "220") == 0)
                 {
                         /* Now follows a string containing the
                          * Y-value of the extrusion vector. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &arc->extr_y0);
+                                                dxf_read_scanf (fp, "%lf\n", &arc->extr_y0);
                 }
                 else if (strcmp (temp_string, "230") == 0)
                 {
                         /* Now follows a string containing the
                          * Z-value of the extrusion vector. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &arc->extr_z0);
+                                                dxf_read_scanf (fp, "%lf\n", &arc->extr_z0);
                 }
                 else if (strcmp (temp_string, "330") == 0)
                 {
                         /* Now follows a string containing Soft-pointer
                          * ID/handle to owner dictionary. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", arc->dictionary_owner_soft);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
+                        free (arc->dictionary_owner_soft);
+                        arc->dictionary_owner_soft = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "360") == 0)
                 {
                         /* Now follows a string containing Hard owner
                          * ID/handle to owner dictionary. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", arc->dictionary_owner_hard);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
+                        free (arc->dictionary_owner_hard);
+                        arc->dictionary_owner_hard = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "999") == 0)
                 {
                         /* Now follows a string containing a comment. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", temp_string);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
                         fprintf (stdout, "DXF comment: %s\n", temp_string);
                 }
                 else
                 {
-                        fprintf (stderr,
-                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %d.\n")),
+                        dxf_diag_report (fp, DXF_DIAG_WARNING,
+                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                 }
+                if (dxf_read_line (temp_string, fp) != 1)
+                {
+                        break;
+                }
         }
         /* Handle omitted members and/or illegal values. */
         if (strcmp (arc->linetype, "") == 0)
@@ -595,6 +607,202 @@ dxf_arc_write
 }
 
 
+/*!
+ * \brief Compute the number of segments needed to approximate a
+ * circular sweep within a chordal tolerance.
+ *
+ * \return the number of segments, at least \c 1.
+ */
+static int
+dxf_arc_tessellation_segments
+(
+        double radius,
+                /*!< the radius. */
+        double sweep,
+                /*!< the swept angle in radians. */
+        double tolerance
+                /*!< the maximum allowed chord deviation. */
+)
+{
+        double max_angle;
+        int segments;
+
+        if (tolerance > radius)
+        {
+                tolerance = radius;
+        }
+        max_angle = 2.0 * acos (1.0 - tolerance / radius);
+        segments = (int) ceil (sweep / max_angle);
+        if (segments < 1)
+        {
+                segments = 1;
+        }
+        return (segments);
+}
+
+
+/*!
+ * \brief Tessellate a DXF \c ARC entity into vertices within a
+ * chordal tolerance.
+ *
+ * The vertices are computed once per tolerance and cached on the
+ * entity, so repeated renders at the same zoom level reuse them
+ * instead of redoing the trigonometry; the cache is recomputed when
+ * the tolerance or the geometry changed and is released by
+ * \c dxf_arc_tessellation_invalidate or \c dxf_arc_free.\n
+ * The returned arrays are owned by the entity and hold \c *length
+ * vertices in the entity OCS plane, swept counterclockwise from
+ * \c start_angle to \c end_angle.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_arc_tessellate
+(
+        DxfArc *arc,
+                /*!< DXF arc entity. */
+        double tolerance,
+                /*!< the maximum allowed chord deviation. */
+        int *length,
+                /*!< returns the number of vertices. */
+        const double **x,
+                /*!< returns the X-values of the vertices. */
+        const double **y
+                /*!< returns the Y-values of the vertices. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        DxfTessellationCache *cache;
+        double sweep;
+        double angle;
+        int segments;
+        int i;
+
+        /* Do some basic checks. */
+        if ((arc == NULL) || (length == NULL) || (x == NULL)
+                || (y == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if ((tolerance <= 0.0) || (arc->radius <= 0.0))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () an invalid tolerance or radius was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        cache = arc->tessellation;
+        if ((cache != NULL)
+                && (cache->tolerance == tolerance)
+                && (cache->x0 == arc->x0)
+                && (cache->y0 == arc->y0)
+                && (cache->radius == arc->radius)
+                && (cache->start_angle == arc->start_angle)
+                && (cache->end_angle == arc->end_angle))
+        {
+                *length = cache->length;
+                *x = cache->x;
+                *y = cache->y;
+#if DEBUG
+                DXF_DEBUG_END
+#endif
+                return (EXIT_SUCCESS);
+        }
+        dxf_arc_tessellation_invalidate (arc);
+        sweep = arc->end_angle - arc->start_angle;
+        while (sweep <= 0.0)
+        {
+                sweep += 360.0;
+        }
+        sweep = sweep * M_PI / 180.0;
+        segments = dxf_arc_tessellation_segments (arc->radius, sweep,
+                tolerance);
+        cache = calloc (1, sizeof (DxfTessellationCache));
+        if (cache == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        cache->x = malloc ((segments + 1) * sizeof (double));
+        cache->y = malloc ((segments + 1) * sizeof (double));
+        if ((cache->x == NULL) || (cache->y == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                free (cache->x);
+                free (cache->y);
+                free (cache);
+                return (EXIT_FAILURE);
+        }
+        for (i = 0; i <= segments; i++)
+        {
+                angle = (arc->start_angle * M_PI / 180.0)
+                        + (sweep * i) / segments;
+                cache->x[i] = arc->x0 + arc->radius * cos (angle);
+                cache->y[i] = arc->y0 + arc->radius * sin (angle);
+        }
+        cache->tolerance = tolerance;
+        cache->x0 = arc->x0;
+        cache->y0 = arc->y0;
+        cache->radius = arc->radius;
+        cache->start_angle = arc->start_angle;
+        cache->end_angle = arc->end_angle;
+        cache->length = segments + 1;
+        arc->tessellation = cache;
+        *length = cache->length;
+        *x = cache->x;
+        *y = cache->y;
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Release the cached tessellation of a DXF \c ARC entity.
+ *
+ * To be called after modifying the geometry members of the entity;
+ * the next \c dxf_arc_tessellate call recomputes the vertices.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_arc_tessellation_invalidate
+(
+        DxfArc *arc
+                /*!< DXF arc entity. */
+)
+{
+        /* Do some basic checks. */
+        if (arc == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (arc->tessellation != NULL)
+        {
+                free (arc->tessellation->x);
+                free (arc->tessellation->y);
+                free (arc->tessellation);
+                arc->tessellation = NULL;
+        }
+        return (EXIT_SUCCESS);
+}
+
+
 /*!
  * \brief Free the allocated memory for a DXF \c ARC and all it's
  * data fields.
@@ -630,7 +838,8 @@ dxf_arc_free
         free (arc->layer);
         free (arc->dictionary_owner_soft);
         free (arc->dictionary_owner_hard);
-        free (arc);
+        dxf_arc_tessellation_invalidate (arc);
+        dxf_entity_dealloc (arc, sizeof (*arc));
         arc = NULL;
 #if DEBUG
         DXF_DEBUG_END
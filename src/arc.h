@@ -133,6 +133,9 @@ dxf_arc
         double end_angle;
                 /*!< End angle of the arc.\n
                  * Group code = 51. */
+        DxfTessellationCache *tessellation;
+                /*!< cached tessellation vertices (see
+                 * \c dxf_arc_tessellate), or \c NULL. */
         struct DxfArc *next;
                 /*!< Pointer to the next DxfArc.\n
                  * \c NULL in the last DxfArc. */
@@ -157,6 +160,18 @@ int dxf_arc_write
         DxfFile *fp,
         DxfArc *arc
 );
+int dxf_arc_tessellate
+(
+        DxfArc *arc,
+        double tolerance,
+        int *length,
+        const double **x,
+        const double **y
+);
+int dxf_arc_tessellation_invalidate
+(
+        DxfArc *arc
+);
 int dxf_arc_free (DxfArc *arc);
 
 
@@ -0,0 +1,421 @@
+/*!
+ * \file arena.c
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Functions for a bump allocating memory arena for entity graphs.
+ *
+ * Reading a large drawing used to cost an individual \c malloc per
+ * entity plus several \c strdup calls for the default strings, with
+ * poor locality in the resulting \c next pointer chains.\n
+ * With an arena attached to the \c DxfFile the whole entity graph comes
+ * out of a few large blocks and is freed in one call.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#include <unistd.h>
+#include "global.h"
+#include "arena.h"
+#include "profile.h"
+
+
+/*!
+ * The page placement policy of arenas created by \c dxf_arena_new,
+ * until overridden per arena with \c dxf_arena_set_placement.
+ */
+static int dxf_arena_default_placement = DXF_ARENA_PLACE_DEFAULT;
+
+
+/*!
+ * \brief Fault every page of a block payload in on the calling
+ * thread.
+ *
+ * On a NUMA system the kernel places a page on the memory node of
+ * the thread that first writes it; touching the pages right after
+ * \c malloc pins them to the node of the allocating worker instead
+ * of whichever thread writes first.
+ */
+static void
+dxf_arena_first_touch
+(
+        char *payload,
+                /*!< the block payload. */
+        size_t size
+                /*!< payload size in bytes. */
+)
+{
+        static long page_size = 0;
+        size_t offset;
+
+        if (page_size <= 0)
+        {
+                page_size = sysconf (_SC_PAGESIZE);
+                if (page_size <= 0)
+                {
+                        page_size = 4096;
+                }
+        }
+        for (offset = 0; offset < size; offset += (size_t) page_size)
+        {
+                payload[offset] = 0;
+        }
+}
+
+
+/*!
+ * \brief Allocate a new block for a \c DxfArena.
+ *
+ * \return a pointer to the new block, or \c NULL when no memory was
+ * allocated.
+ */
+static DxfArenaBlock *
+dxf_arena_block_new
+(
+        size_t size,
+                /*!< payload size of the block in bytes. */
+        int placement
+                /*!< the page placement policy, one of the
+                 * \c DXF_ARENA_PLACE_* values. */
+)
+{
+        DxfArenaBlock *block;
+
+        block = malloc (sizeof (DxfArenaBlock) + size);
+        if (block == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory for a DxfArenaBlock struct.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        block->next = NULL;
+        block->used = 0;
+        block->size = size;
+        if (placement == DXF_ARENA_PLACE_FIRST_TOUCH)
+        {
+                dxf_arena_first_touch ((char *) (block + 1), size);
+        }
+        return (block);
+}
+
+
+/*!
+ * \brief Allocate memory for a \c DxfArena and its first block.
+ *
+ * \return \c NULL when no memory was allocated, a pointer to the
+ * allocated memory when succesful.
+ */
+DxfArena *
+dxf_arena_new
+(
+        size_t block_size
+                /*!< payload size of the arena blocks in bytes, pass 0
+                 * for the default \c DXF_ARENA_BLOCK_SIZE. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        DxfArena *arena;
+
+        if (block_size == 0)
+        {
+                block_size = DXF_ARENA_BLOCK_SIZE;
+        }
+        arena = malloc (sizeof (DxfArena));
+        if (arena == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory for a DxfArena struct.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        arena->block_size = block_size;
+        arena->placement = dxf_arena_default_placement;
+        arena->block = dxf_arena_block_new (block_size, arena->placement);
+        if (arena->block == NULL)
+        {
+                free (arena);
+                return (NULL);
+        }
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (arena);
+}
+
+
+/*!
+ * \brief Set the page placement policy of a \c DxfArena.
+ *
+ * Applies to the blocks created after the call; a worker should set
+ * the policy right after \c dxf_arena_new, before filling the arena.
+ */
+void
+dxf_arena_set_placement
+(
+        DxfArena *arena,
+                /*!< DXF arena. */
+        int placement
+                /*!< the policy, one of the \c DXF_ARENA_PLACE_*
+                 * values. */
+)
+{
+        if (arena == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return;
+        }
+        arena->placement = placement;
+}
+
+
+/*!
+ * \brief Set the page placement policy of subsequently created
+ * arenas.
+ *
+ * The library creates arenas internally (document reads, caches);
+ * the process wide default is the only way to govern the placement
+ * of those.
+ */
+void
+dxf_arena_set_default_placement
+(
+        int placement
+                /*!< the policy, one of the \c DXF_ARENA_PLACE_*
+                 * values. */
+)
+{
+        dxf_arena_default_placement = placement;
+}
+
+
+/*!
+ * \brief Allocate \c size bytes from a \c DxfArena.
+ *
+ * Bumps the allocation pointer of the current block, starting a new
+ * block when the current one is full.\n
+ * The returned memory is zeroed and aligned for any object type;
+ * it stays valid until \c dxf_arena_reset or \c dxf_arena_free is
+ * called and cannot be freed individually.
+ *
+ * \return a pointer to the allocated memory, or \c NULL when no memory
+ * was allocated.
+ */
+void *
+dxf_arena_alloc
+(
+        DxfArena *arena,
+                /*!< DXF arena. */
+        size_t size
+                /*!< number of bytes to allocate. */
+)
+{
+        DxfArenaBlock *block;
+        void *result;
+
+        if (arena == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        /* keep every allocation aligned for any object type. */
+        size = (size + (sizeof (double) - 1)) & ~(sizeof (double) - 1);
+        block = arena->block;
+        if (block->used + size > block->size)
+        {
+                size_t block_size;
+
+                /* oversized requests get a block of their own. */
+                block_size = arena->block_size;
+                if (size > block_size)
+                {
+                        block_size = size;
+                }
+                block = dxf_arena_block_new (block_size, arena->placement);
+                if (block == NULL)
+                {
+                        return (NULL);
+                }
+                block->next = arena->block;
+                arena->block = block;
+        }
+        result = ((char *) (block + 1)) + block->used;
+        block->used += size;
+        memset (result, 0, size);
+        DXF_PROFILE_COUNT (arena_allocs);
+        return (result);
+}
+
+
+/*!
+ * \brief Duplicate a string into a \c DxfArena.
+ *
+ * \return a pointer to the copied string, or \c NULL when no memory
+ * was allocated.
+ */
+char *
+dxf_arena_strdup
+(
+        DxfArena *arena,
+                /*!< DXF arena. */
+        const char *string
+                /*!< the string to copy. */
+)
+{
+        char *result;
+        size_t length;
+
+        if (string == NULL)
+        {
+                return (NULL);
+        }
+        length = strlen (string) + 1;
+        DXF_PROFILE_COUNT (strdups);
+        DXF_PROFILE_COUNT_ADD (strdup_bytes, length);
+        result = dxf_arena_alloc (arena, length);
+        if (result != NULL)
+        {
+                memcpy (result, string, length);
+        }
+        return (result);
+}
+
+
+/*!
+ * \brief Release all but the first block of a \c DxfArena and mark the
+ * remaining block empty, so the arena can be reused for the next file
+ * without going back to \c malloc.
+ */
+void
+dxf_arena_reset
+(
+        DxfArena *arena
+                /*!< DXF arena. */
+)
+{
+        DxfArenaBlock *block;
+        DxfArenaBlock *next;
+
+        if (arena == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return;
+        }
+        block = arena->block;
+        while (block->next != NULL)
+        {
+                next = block->next;
+                free (block);
+                block = next;
+        }
+        block->used = 0;
+        arena->block = block;
+}
+
+
+/*!
+ * \brief Free a \c DxfArena, all its blocks and every entity and
+ * string allocated from it.
+ */
+void
+dxf_arena_free
+(
+        DxfArena *arena
+                /*!< DXF arena. */
+)
+{
+        DxfArenaBlock *block;
+        DxfArenaBlock *next;
+
+        if (arena == NULL)
+        {
+                return;
+        }
+        block = arena->block;
+        while (block != NULL)
+        {
+                next = block->next;
+                free (block);
+                block = next;
+        }
+        free (arena);
+}
+
+
+/*!
+ * \brief Report the bytes held by a \c DxfArena.
+ *
+ * Walks the block list, so the arena needs no counters on its hot
+ * allocation path.
+ */
+void
+dxf_arena_stats
+(
+        DxfArena *arena,
+                /*!< DXF arena. */
+        size_t *reserved_bytes,
+                /*!< bytes reserved from the system, block headers
+                 * included, are returned here. */
+        size_t *used_bytes
+                /*!< bytes handed out to entities and strings are
+                 * returned here. */
+)
+{
+        DxfArenaBlock *block;
+        size_t reserved;
+        size_t used;
+
+        reserved = 0;
+        used = 0;
+        if (arena != NULL)
+        {
+                for (block = arena->block; block != NULL; block = block->next)
+                {
+                        reserved += sizeof (DxfArenaBlock) + block->size;
+                        used += block->used;
+                }
+        }
+        if (reserved_bytes != NULL)
+        {
+                *reserved_bytes = reserved;
+        }
+        if (used_bytes != NULL)
+        {
+                *used_bytes = used;
+        }
+}
+
+
+/* EOF */
@@ -0,0 +1,114 @@
+/*!
+ * \file arena.h
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Header for a bump allocating memory arena for entity graphs.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#ifndef LIBDXF_SRC_ARENA_H
+#define LIBDXF_SRC_ARENA_H
+
+
+#include <stddef.h>
+
+
+/*!
+ * The default block size, in bytes, of a \c DxfArena.
+ */
+#define DXF_ARENA_BLOCK_SIZE 1048576
+
+/*!
+ * Let the kernel place arena pages wherever the first write faults
+ * them in (the historic behavior).
+ */
+#define DXF_ARENA_PLACE_DEFAULT 0
+
+/*!
+ * Fault every page of a fresh block in on the allocating thread, so
+ * on a NUMA system the pages land on the memory node of the worker
+ * that fills — and later consumes — the arena, instead of wherever a
+ * consumer thread first writes.
+ */
+#define DXF_ARENA_PLACE_FIRST_TOUCH 1
+
+
+/*!
+ * \brief One block of a \c DxfArena.
+ *
+ * The allocatable payload follows the struct in the same malloc'ed
+ * region.
+ */
+typedef struct
+dxf_arena_block
+{
+        struct dxf_arena_block *next;
+                /*!< pointer to the previously filled block, or \c NULL. */
+        size_t used;
+                /*!< number of payload bytes handed out. */
+        size_t size;
+                /*!< total payload size in bytes. */
+} DxfArenaBlock;
+
+
+/*!
+ * \brief DXF definition of a bump allocating memory arena.
+ *
+ * Entities and strings of an entire file are carved out of large
+ * blocks with a pointer bump instead of an individual \c malloc per
+ * entity, and are released in one \c dxf_arena_free call instead of a
+ * per-entity free walk.
+ */
+typedef struct
+dxf_arena
+{
+        DxfArenaBlock *block;
+                /*!< the block currently allocated from. */
+        size_t block_size;
+                /*!< payload size of newly created blocks. */
+        int placement;
+                /*!< the page placement policy of newly created
+                 * blocks, one of the \c DXF_ARENA_PLACE_* values. */
+} DxfArena;
+
+
+DxfArena *dxf_arena_new (size_t block_size);
+void dxf_arena_set_placement (DxfArena *arena, int placement);
+void dxf_arena_set_default_placement (int placement);
+void *dxf_arena_alloc (DxfArena *arena, size_t size);
+char *dxf_arena_strdup (DxfArena *arena, const char *string);
+void dxf_arena_reset (DxfArena *arena);
+void dxf_arena_free (DxfArena *arena);
+void dxf_arena_stats (DxfArena *arena, size_t *reserved_bytes, size_t *used_bytes);
+
+
+#endif /* LIBDXF_SRC_ARENA_H */
+
+
+/* EOF */
@@ -32,7 +32,10 @@
  */
 
 
+#include <pthread.h>
 #include "attdef.h"
+#include "diag.h"
+#include "allocator.h"
 
 
 /*!
@@ -58,7 +61,7 @@ dxf_attdef_new ()
         size = sizeof (DxfAttdef);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((attdef = malloc (size)) == NULL)
+        if ((attdef = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfAttdef struct.\n")),
@@ -98,6 +101,11 @@ dxf_attdef_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfAttdef template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         /* Do some basic checks. */
         if (attdef == NULL)
         {
@@ -113,39 +121,54 @@ dxf_attdef_init
                 __FUNCTION__);
               return (NULL);
         }
-        attdef->default_value = strdup ("");
-        attdef->tag_value = strdup ("");
-        attdef->prompt_value = strdup ("");
-        attdef->id_code = 0;
-        attdef->linetype = strdup (DXF_DEFAULT_LINETYPE);
-        attdef->text_style = strdup (DXF_DEFAULT_TEXTSTYLE);
-        attdef->layer = strdup (DXF_DEFAULT_LAYER);
-        attdef->x0 = 0.0;
-        attdef->y0 = 0.0;
-        attdef->z0 = 0.0;
-        attdef->x1 = 0.0;
-        attdef->y1 = 0.0;
-        attdef->z1 = 0.0;
-        attdef->height = 0.0;
-        attdef->rel_x_scale = 0.0;
-        attdef->rot_angle = 0.0;
-        attdef->obl_angle = 0.0;
-        attdef->thickness = 0.0;
-        attdef->linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
-        attdef->visibility = DXF_DEFAULT_VISIBILITY;
-        attdef->color = DXF_COLOR_BYLAYER;
-        attdef->paperspace = DXF_MODELSPACE;
-        attdef->attr_flags = 0;
-        attdef->text_flags = 0;
-        attdef->hor_align = 0;
-        attdef->field_length = 0;
-        attdef->vert_align = 0;
-        attdef->extr_x0 = 0.0;
-        attdef->extr_y0 = 0.0;
-        attdef->extr_z0 = 0.0;
-        attdef->dictionary_owner_soft = strdup ("");
-        attdef->dictionary_owner_hard = strdup ("");
-        attdef->next = NULL;
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.default_value = strdup ("");
+                template.tag_value = strdup ("");
+                template.prompt_value = strdup ("");
+                template.id_code = 0;
+                template.linetype = strdup (DXF_DEFAULT_LINETYPE);
+                template.text_style = strdup (DXF_DEFAULT_TEXTSTYLE);
+                template.layer = strdup (DXF_DEFAULT_LAYER);
+                template.x0 = 0.0;
+                template.y0 = 0.0;
+                template.z0 = 0.0;
+                template.x1 = 0.0;
+                template.y1 = 0.0;
+                template.z1 = 0.0;
+                template.height = 0.0;
+                template.rel_x_scale = 0.0;
+                template.rot_angle = 0.0;
+                template.obl_angle = 0.0;
+                template.thickness = 0.0;
+                template.linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
+                template.visibility = DXF_DEFAULT_VISIBILITY;
+                template.color = DXF_COLOR_BYLAYER;
+                template.paperspace = DXF_MODELSPACE;
+                template.attr_flags = 0;
+                template.text_flags = 0;
+                template.hor_align = 0;
+                template.field_length = 0;
+                template.vert_align = 0;
+                template.extr_x0 = 0.0;
+                template.extr_y0 = 0.0;
+                template.extr_z0 = 0.0;
+                template.dictionary_owner_soft = strdup ("");
+                template.dictionary_owner_hard = strdup ("");
+                template.next = NULL;
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (attdef, &template, sizeof (DxfAttdef));
+        attdef->default_value = strdup (template.default_value);
+        attdef->tag_value = strdup (template.tag_value);
+        attdef->prompt_value = strdup (template.prompt_value);
+        attdef->linetype = strdup (template.linetype);
+        attdef->text_style = strdup (template.text_style);
+        attdef->layer = strdup (template.layer);
+        attdef->dictionary_owner_soft = strdup (template.dictionary_owner_soft);
+        attdef->dictionary_owner_hard = strdup (template.dictionary_owner_hard);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -182,7 +205,7 @@ dxf_attdef_read
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        char *temp_string = NULL;
+        char temp_string[DXF_MAX_STRING_LENGTH];
 
         /* Do some basic checks. */
         if (fp == NULL)
@@ -207,7 +230,7 @@ dxf_attdef_read
                 if (ferror (fp->fp))
                 {
                         fprintf (stderr,
-                          (_("Error in %s () while reading from: %s in line: %d.\n")),
+                          (_("Error in %s () while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                         fclose (fp->fp);
                         return (NULL);
@@ -217,20 +240,26 @@ dxf_attdef_read
                         /* Now follows a string containing the attribute
                          * default value. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", attdef->default_value);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (attdef->default_value);
+                        attdef->default_value = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "2") == 0)
                 {
                         /* Now follows a string containing a tag value. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", attdef->tag_value);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (attdef->tag_value);
+                        attdef->tag_value = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "3") == 0)
                 {
                         /* Now follows a string containing a prompt
                          * value. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", attdef->prompt_value);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (attdef->prompt_value);
+                        attdef->prompt_value = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "5") == 0)
                 {
@@ -244,19 +273,25 @@ dxf_attdef_read
                         /* Now follows a string containing a linetype
                          * name. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", attdef->linetype);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (attdef->linetype);
+                        attdef->linetype = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "7") == 0)
                 {
                         /* Now follows a string containing a text style. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", attdef->text_style);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (attdef->text_style);
+                        attdef->text_style = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "8") == 0)
                 {
                         /* Now follows a string containing a layer name. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", attdef->layer);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (attdef->layer);
+                        attdef->layer = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "10") == 0)
                 {
@@ -424,8 +459,8 @@ dxf_attdef_read
                         && (strcmp (temp_string, "AcDbText") != 0)
                         && (strcmp (temp_string, "AcDbAttributeDefinition") != 0))
                         {
-                                fprintf (stderr,
-                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %d.\n")),
+                                dxf_diag_report (fp, DXF_DIAG_WARNING,
+                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                         }
                 }
@@ -455,14 +490,18 @@ dxf_attdef_read
                         /* Now follows a string containing Soft-pointer
                          * ID/handle to owner dictionary. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", attdef->dictionary_owner_soft);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (attdef->dictionary_owner_soft);
+                        attdef->dictionary_owner_soft = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "360") == 0)
                 {
                         /* Now follows a string containing Hard owner
                          * ID/handle to owner dictionary. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", attdef->dictionary_owner_hard);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (attdef->dictionary_owner_hard);
+                        attdef->dictionary_owner_hard = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "999") == 0)
                 {
@@ -473,8 +512,8 @@ dxf_attdef_read
                 }
                 else
                 {
-                        fprintf (stderr,
-                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %d.\n")),
+                        dxf_diag_report (fp, DXF_DIAG_WARNING,
+                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                 }
         }
@@ -769,7 +808,7 @@ dxf_attdef_free
         free (attdef->text_style);
         free (attdef->dictionary_owner_soft);
         free (attdef->dictionary_owner_hard);
-        free (attdef);
+        dxf_entity_dealloc (attdef, sizeof (*attdef));
         attdef = NULL;
 #if DEBUG
         DXF_DEBUG_END
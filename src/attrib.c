@@ -32,7 +32,10 @@
  */
 
 
+#include <pthread.h>
 #include "attrib.h"
+#include "diag.h"
+#include "allocator.h"
 
 
 /*!
@@ -58,7 +61,7 @@ dxf_attrib_new ()
         size = sizeof (DxfAttrib);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((attrib = malloc (size)) == NULL)
+        if ((attrib = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfAttrib struct.\n")),
@@ -98,6 +101,11 @@ dxf_attrib_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfAttrib template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         /* Do some basic checks. */
         if (attrib == NULL)
         {
@@ -113,40 +121,55 @@ dxf_attrib_init
                   __FUNCTION__);
                 return (NULL);
         }
-        attrib->value = strdup ("");
-        attrib->tag_value = strdup ("");
-        attrib->id_code = 0;
-        attrib->linetype = strdup (DXF_DEFAULT_LINETYPE);
-        attrib->text_style = strdup (DXF_DEFAULT_TEXTSTYLE);
-        attrib->layer = strdup (DXF_DEFAULT_LAYER);
-        attrib->x0 = 0.0;
-        attrib->y0 = 0.0;
-        attrib->z0 = 0.0;
-        attrib->x1 = 0.0;
-        attrib->y1 = 0.0;
-        attrib->z1 = 0.0;
-        attrib->height = 0.0;
-        attrib->rel_x_scale = 0.0;
-        attrib->rot_angle = 0.0;
-        attrib->obl_angle = 0.0;
-        attrib->elevation = 0.0;
-        attrib->thickness = 0.0;
-        attrib->linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
-        attrib->visibility = DXF_DEFAULT_VISIBILITY;
-        attrib->color = DXF_COLOR_BYLAYER;
-        attrib->paperspace = DXF_MODELSPACE;
-        attrib->attr_flags = 0;
-        attrib->text_flags = 0;
-        attrib->hor_align = 0;
-        attrib->field_length = 0;
-        attrib->vert_align = 0;
-        attrib->extr_x0 = 0.0;
-        attrib->extr_y0 = 0.0;
-        attrib->extr_z0 = 0.0;
-        attrib->dictionary_owner_soft = strdup("");
-        attrib->dictionary_owner_hard = strdup("");
-        attrib->line_weight = 0;
-        attrib->next = NULL;
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.value = strdup ("");
+                template.tag_value = strdup ("");
+                template.id_code = 0;
+                template.linetype = strdup (DXF_DEFAULT_LINETYPE);
+                template.text_style = strdup (DXF_DEFAULT_TEXTSTYLE);
+                template.layer = strdup (DXF_DEFAULT_LAYER);
+                template.x0 = 0.0;
+                template.y0 = 0.0;
+                template.z0 = 0.0;
+                template.x1 = 0.0;
+                template.y1 = 0.0;
+                template.z1 = 0.0;
+                template.height = 0.0;
+                template.rel_x_scale = 0.0;
+                template.rot_angle = 0.0;
+                template.obl_angle = 0.0;
+                template.elevation = 0.0;
+                template.thickness = 0.0;
+                template.linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
+                template.visibility = DXF_DEFAULT_VISIBILITY;
+                template.color = DXF_COLOR_BYLAYER;
+                template.paperspace = DXF_MODELSPACE;
+                template.attr_flags = 0;
+                template.text_flags = 0;
+                template.hor_align = 0;
+                template.field_length = 0;
+                template.vert_align = 0;
+                template.extr_x0 = 0.0;
+                template.extr_y0 = 0.0;
+                template.extr_z0 = 0.0;
+                template.dictionary_owner_soft = strdup("");
+                template.dictionary_owner_hard = strdup("");
+                template.line_weight = 0;
+                template.attdef = NULL;
+                template.next = NULL;
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (attrib, &template, sizeof (DxfAttrib));
+        attrib->value = strdup (template.value);
+        attrib->tag_value = strdup (template.tag_value);
+        attrib->linetype = strdup (template.linetype);
+        attrib->text_style = strdup (template.text_style);
+        attrib->layer = strdup (template.layer);
+        attrib->dictionary_owner_soft = strdup (template.dictionary_owner_soft);
+        attrib->dictionary_owner_hard = strdup (template.dictionary_owner_hard);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -183,7 +206,7 @@ dxf_attrib_read
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        char *temp_string = NULL;
+        char temp_string[DXF_MAX_STRING_LENGTH];
 
         /* Do some basic checks. */
         if (fp == NULL)
@@ -208,7 +231,7 @@ dxf_attrib_read
                 if (ferror (fp->fp))
                 {
                         fprintf (stderr,
-                          (_("Error in %s () while reading from: %s in line: %d.\n")),
+                          (_("Error in %s () while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                         fclose (fp->fp);
                         return (NULL);
@@ -218,13 +241,17 @@ dxf_attrib_read
                         /* Now follows a string containing the attribute
                          * value. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", attrib->value);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (attrib->value);
+                        attrib->value = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "2") == 0)
                 {
                         /* Now follows a string containing a tag value. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", attrib->tag_value);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (attrib->tag_value);
+                        attrib->tag_value = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "5") == 0)
                 {
@@ -238,19 +265,25 @@ dxf_attrib_read
                         /* Now follows a string containing a linetype
                          * name. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", attrib->linetype);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (attrib->linetype);
+                        attrib->linetype = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "7") == 0)
                 {
                         /* Now follows a string containing a text style. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", attrib->text_style);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (attrib->text_style);
+                        attrib->text_style = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "8") == 0)
                 {
                         /* Now follows a string containing a layer name. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", attrib->layer);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (attrib->layer);
+                        attrib->layer = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "10") == 0)
                 {
@@ -418,8 +451,8 @@ dxf_attrib_read
                         && (strcmp (temp_string, "AcDbText") != 0)
                         && (strcmp (temp_string, "AcDbAttribute") != 0))
                         {
-                                fprintf (stderr,
-                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %d.\n")),
+                                dxf_diag_report (fp, DXF_DIAG_WARNING,
+                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                         }
                 }
@@ -449,14 +482,18 @@ dxf_attrib_read
                         /* Now follows a string containing Soft-pointer
                          * ID/handle to owner dictionary. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", attrib->dictionary_owner_soft);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (attrib->dictionary_owner_soft);
+                        attrib->dictionary_owner_soft = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "360") == 0)
                 {
                         /* Now follows a string containing Hard owner
                          * ID/handle to owner dictionary. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", attrib->dictionary_owner_hard);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (attrib->dictionary_owner_hard);
+                        attrib->dictionary_owner_hard = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "999") == 0)
                 {
@@ -467,8 +504,8 @@ dxf_attrib_read
                 }
                 else
                 {
-                        fprintf (stderr,
-                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %d.\n")),
+                        dxf_diag_report (fp, DXF_DIAG_WARNING,
+                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                 }
         }
@@ -777,7 +814,7 @@ dxf_attrib_free
         free (attrib->text_style);
         free (attrib->dictionary_owner_soft);
         free (attrib->dictionary_owner_hard);
-        free (attrib);
+        dxf_entity_dealloc (attrib, sizeof (*attrib));
         attrib = NULL;
 #if DEBUG
         DXF_DEBUG_END
@@ -39,6 +39,9 @@
 #define LIBDXF_SRC_ATTRIB_H
 
 
+struct dxf_attdef;
+
+
 /*!
  * \brief DXF definition of an AutoCAD attribute entity (\c ATTRIB).
  *
@@ -221,6 +224,12 @@ dxf_attrib
                 /*!< Z-value of the extrusion vector.\n
                  * Defaults to 1.0 if omitted in the DXF file.\n
                  * Group code = 230. */
+        struct dxf_attdef *attdef;
+                /*!< Pointer to the defining \c ATTDEF entity, or
+                 * \c NULL when not resolved (see
+                 * \c dxf_tag_dictionary_resolve); the prompt and
+                 * style fields live on the definition instead of
+                 * being duplicated per instance. */
         struct DxfAttrib *next;
                 /*!< Pointer to the next DxfAttrib.\n
                  * \c NULL in the last DxfAttrib. */
@@ -0,0 +1,346 @@
+/*!
+ * \file binary_data.c
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Functions for chained binary chunk storage (group 310).
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#include "binary_data.h"
+#include "util.h"
+
+
+/*!
+ * The initial size, in bytes, of the chunk byte buffer.
+ */
+#define DXF_BINARY_DATA_INITIAL_BYTES_SIZE 4096
+
+
+/*!
+ * The initial number of entries of the chunk offset table.
+ */
+#define DXF_BINARY_DATA_INITIAL_OFFSETS_SIZE 64
+
+
+/*!
+ * \brief Initialize the data fields of a \c DxfBinaryData.
+ *
+ * \return a pointer to \c data, or \c NULL when a NULL pointer was
+ * passed.
+ */
+DxfBinaryData *
+dxf_binary_data_init
+(
+        DxfBinaryData *data
+                /*!< chained binary chunk storage. */
+)
+{
+        if (data == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        data->bytes = NULL;
+        data->bytes_size = 0;
+        data->bytes_used = 0;
+        data->offsets = NULL;
+        data->offsets_size = 0;
+        data->number_of_chunks = 0;
+        return (data);
+}
+
+
+/*!
+ * \brief Discard the stored chunks of a \c DxfBinaryData but keep the
+ * allocated storage, so a recycled entity reuses its buffer.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when an error
+ * occurred.
+ */
+int
+dxf_binary_data_clear
+(
+        DxfBinaryData *data
+                /*!< chained binary chunk storage. */
+)
+{
+        if (data == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        data->bytes_used = 0;
+        data->number_of_chunks = 0;
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Decode a hex chunk line and append the bytes as a new chunk
+ * to a \c DxfBinaryData.
+ *
+ * The byte buffer and the offset table grow by doubling, and decoding
+ * goes through the table driven hex codec, so appending the chunk
+ * chain of an arbitrarily large proxy entity stays amortized constant
+ * per chunk.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when an error
+ * occurred.
+ */
+int
+dxf_binary_data_append_hex
+(
+        DxfBinaryData *data,
+                /*!< chained binary chunk storage. */
+        const char *hex
+                /*!< the hex chunk line to decode and append. */
+)
+{
+        unsigned char *bytes;
+        size_t *offsets;
+        size_t bytes_size;
+        size_t needed;
+        int offsets_size;
+        int decoded;
+
+        if ((data == NULL) || (hex == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        needed = data->bytes_used + (strlen (hex) / 2);
+        if (needed > data->bytes_size)
+        {
+                bytes_size = (data->bytes_size == 0)
+                        ? DXF_BINARY_DATA_INITIAL_BYTES_SIZE
+                        : (data->bytes_size * 2);
+                while (bytes_size < needed)
+                {
+                        bytes_size *= 2;
+                }
+                bytes = realloc (data->bytes, bytes_size);
+                if (bytes == NULL)
+                {
+                        fprintf (stderr,
+                          (_("Error in %s () could not allocate memory.\n")),
+                          __FUNCTION__);
+                        return (EXIT_FAILURE);
+                }
+                data->bytes = bytes;
+                data->bytes_size = bytes_size;
+        }
+        if (data->number_of_chunks >= data->offsets_size)
+        {
+                offsets_size = (data->offsets_size == 0)
+                        ? DXF_BINARY_DATA_INITIAL_OFFSETS_SIZE
+                        : (data->offsets_size * 2);
+                offsets = realloc (data->offsets,
+                        offsets_size * sizeof (size_t));
+                if (offsets == NULL)
+                {
+                        fprintf (stderr,
+                          (_("Error in %s () could not allocate memory.\n")),
+                          __FUNCTION__);
+                        return (EXIT_FAILURE);
+                }
+                data->offsets = offsets;
+                data->offsets_size = offsets_size;
+        }
+        decoded = dxf_hex_decode (hex, data->bytes + data->bytes_used);
+        if (decoded < 0)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a malformed hex chunk was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        data->offsets[data->number_of_chunks] = data->bytes_used;
+        data->bytes_used += (size_t) decoded;
+        data->number_of_chunks++;
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Get a stored chunk of a \c DxfBinaryData.
+ *
+ * \return a pointer into the byte buffer, or \c NULL when the index is
+ * out of range; when \c length is not \c NULL it receives the chunk
+ * length in bytes.
+ */
+const unsigned char *
+dxf_binary_data_chunk
+(
+        DxfBinaryData *data,
+                /*!< chained binary chunk storage. */
+        int index,
+                /*!< index of the chunk, starting at 0. */
+        int *length
+                /*!< receives the chunk length in bytes, or \c NULL. */
+)
+{
+        size_t end;
+
+        if (data == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        if ((index < 0) || (index >= data->number_of_chunks))
+        {
+                return (NULL);
+        }
+        if (length != NULL)
+        {
+                end = (index + 1 < data->number_of_chunks)
+                        ? data->offsets[index + 1]
+                        : data->bytes_used;
+                *length = (int) (end - data->offsets[index]);
+        }
+        return (data->bytes + data->offsets[index]);
+}
+
+
+/*!
+ * \brief Write all stored chunks of a \c DxfBinaryData as hex lines
+ * with the passed group code.
+ *
+ * The chunks are re-encoded with the table driven hex codec into one
+ * output buffer, preserving the original chunk boundaries, and emitted
+ * with a single \c fwrite call.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when an error
+ * occurred.
+ */
+int
+dxf_binary_data_write
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an output file (or device). */
+        int group_code,
+                /*!< DXF group code to write the chunks with. */
+        DxfBinaryData *data
+                /*!< chained binary chunk storage. */
+)
+{
+        char prefix[8];
+        char *buffer;
+        size_t size;
+        size_t used;
+        size_t end;
+        size_t offset;
+        int i;
+
+        if ((fp == NULL) || (data == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (data->number_of_chunks == 0)
+        {
+                return (EXIT_SUCCESS);
+        }
+        sprintf (prefix, "%3d\n", group_code);
+        /* every stored byte becomes two hex digits, plus 4 prefix
+         * bytes and a newline per chunk. */
+        size = (data->bytes_used * 2)
+                + ((size_t) data->number_of_chunks * 5) + 1;
+        buffer = malloc (size);
+        if (buffer == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        used = 0;
+        for (i = 0; i < data->number_of_chunks; i++)
+        {
+                offset = data->offsets[i];
+                end = (i + 1 < data->number_of_chunks)
+                        ? data->offsets[i + 1]
+                        : data->bytes_used;
+                memcpy (buffer + used, prefix, 4);
+                used += 4;
+                used += dxf_hex_encode (buffer + used,
+                        data->bytes + offset, (int) (end - offset));
+                buffer[used] = '\n';
+                used++;
+        }
+        if (fwrite (buffer, 1, used, fp->fp) != used)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () while writing to: %s.\n")),
+                  __FUNCTION__, fp->filename);
+                free (buffer);
+                return (EXIT_FAILURE);
+        }
+        free (buffer);
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Free the allocated storage of a \c DxfBinaryData.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when an error
+ * occurred.
+ */
+int
+dxf_binary_data_free_contents
+(
+        DxfBinaryData *data
+                /*!< chained binary chunk storage. */
+)
+{
+        if (data == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        free (data->bytes);
+        free (data->offsets);
+        return (dxf_binary_data_init (data) == NULL
+                ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+
+
+/* EOF */
@@ -0,0 +1,79 @@
+/*!
+ * \file binary_data.h
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.
+ *
+ * \brief Header file for chained binary chunk storage (group 310).
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#ifndef LIBDXF_SRC_BINARY_DATA_H
+#define LIBDXF_SRC_BINARY_DATA_H
+
+
+#include "global.h"
+
+
+/*!
+ * \brief Storage for chained binary chunks (group 310 and the like).
+ *
+ * The chunks are decoded from their hex lines once on read and stored
+ * back to back in one contiguous byte buffer; a chunk offset table
+ * records where each chunk starts, so the original chunking survives a
+ * round trip while consumers can treat the buffer as one flat blob.
+ */
+typedef struct
+dxf_binary_data
+{
+        unsigned char *bytes;
+                /*!< the decoded chunk bytes, stored back to back. */
+        size_t bytes_size;
+                /*!< allocated size of \c bytes in bytes. */
+        size_t bytes_used;
+                /*!< number of bytes stored in \c bytes. */
+        size_t *offsets;
+                /*!< start offset of each chunk within \c bytes. */
+        int offsets_size;
+                /*!< allocated number of entries of \c offsets. */
+        int number_of_chunks;
+                /*!< number of chunks stored. */
+} DxfBinaryData;
+
+
+DxfBinaryData *dxf_binary_data_init (DxfBinaryData *data);
+int dxf_binary_data_clear (DxfBinaryData *data);
+int dxf_binary_data_append_hex (DxfBinaryData *data, const char *hex);
+const unsigned char *dxf_binary_data_chunk (DxfBinaryData *data, int index, int *length);
+int dxf_binary_data_write (DxfFile *fp, int group_code, DxfBinaryData *data);
+int dxf_binary_data_free_contents (DxfBinaryData *data);
+
+
+#endif /* LIBDXF_SRC_BINARY_DATA_H */
+
+
+/* EOF */
@@ -33,6 +33,8 @@
 
 
 #include "block.h"
+#include "diag.h"
+#include "allocator.h"
 
 
 /*!
@@ -59,7 +61,7 @@ dxf_block_new ()
         size = sizeof (DxfBlock);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((block = malloc (size)) == NULL)
+        if ((block = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfBlock struct.\n")),
@@ -194,7 +196,7 @@ dxf_block_read
                 if (ferror (fp->fp))
                 {
                         fprintf (stderr,
-                          (_("Error in %s () while reading from: %s in line: %d.\n")),
+                          (_("Error in %s () while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                         fclose (fp->fp);
                         return (NULL);
@@ -203,22 +205,30 @@ dxf_block_read
                 {
                         /* Now follows a string containing a external
                          * reference name. */
-                        fscanf (fp->fp, "%s\n", block->xref_name);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (block->xref_name);
+                        block->xref_name = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "2") == 0)
                 {
                         /* Now follows a string containing a block name. */
-                        fscanf (fp->fp, "%s\n", block->block_name);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (block->block_name);
+                        block->block_name = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "3") == 0)
                 {
                         /* Now follows a string containing a block name. */
-                        fscanf (fp->fp, "%s\n", block->block_name_additional);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (block->block_name_additional);
+                        block->block_name_additional = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "4") == 0)
                 {
                         /* Now follows a string containing a description. */
-                        fscanf (fp->fp, "%s\n", block->description);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (block->description);
+                        block->description = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "5") == 0)
                 {
@@ -229,7 +239,9 @@ dxf_block_read
                 else if (strcmp (temp_string, "8") == 0)
                 {
                         /* Now follows a string containing a layer name. */
-                        fscanf (fp->fp, "%s\n", block->layer);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (block->layer);
+                        block->layer = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "10") == 0)
                 {
@@ -275,8 +287,8 @@ dxf_block_read
                         if ((strcmp (temp_string, "AcDbEntity") != 0)
                         && ((strcmp (temp_string, "AcDbBlockBegin") != 0)))
                         {
-                                fprintf (stderr,
-                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %d.\n")),
+                                dxf_diag_report (fp, DXF_DIAG_WARNING,
+                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                         }
                 }
@@ -302,7 +314,9 @@ dxf_block_read
                 {
                         /* Now follows a string containing Soft-pointer
                          * ID/handle to owner object. */
-                        fscanf (fp->fp, "%s\n", block->dictionary_owner_soft);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (block->dictionary_owner_soft);
+                        block->dictionary_owner_soft = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "999") == 0)
                 {
@@ -312,8 +326,8 @@ dxf_block_read
                 }
                 else
                 {
-                        fprintf (stderr,
-                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %d.\n")),
+                        dxf_diag_report (fp, DXF_DIAG_WARNING,
+                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                 }
         }
@@ -333,7 +347,7 @@ dxf_block_read
         if (block->block_type == 0)
         {
                 fprintf (stderr,
-                  (_("Warning in %s () illegal block type value found while reading from: %s in line: %d.\n")),
+                  (_("Warning in %s () illegal block type value found while reading from: %s in line: %ld.\n")),
                   __FUNCTION__, fp->filename, fp->line_number);
                 fprintf (stderr,
                   (_("\tblock type value is reset to 1.\n")));
@@ -539,6 +553,68 @@ dxf_block_write_table
 }
 
 
+/*!
+ * \brief Build a hash map from block name to \c DxfBlock over a list
+ * of block definitions.
+ *
+ * Fastener heavy drawings reference a few dozen blocks from a hundred
+ * thousand \c INSERT entities; resolving each reference by walking the
+ * list makes explode and transform passes quadratic.  With the map a
+ * lookup costs constant time (see \c dxf_block_index_find).
+ *
+ * \return a pointer to the map, or \c NULL when errors occurred.\n
+ * The map references the blocks and their names in place, so it has to
+ * be freed (with \c dxf_symbol_table_free) before the list.
+ */
+DxfSymbolTable *
+dxf_block_index_build
+(
+        DxfBlock *blocks_list
+                /*!< pointer to a list of block definitions. */
+)
+{
+        DxfSymbolTable *index;
+
+        index = dxf_symbol_table_new ();
+        if (index == NULL)
+        {
+                return (NULL);
+        }
+        if (DXF_SYMBOL_TABLE_BUILD (index, blocks_list, DxfBlock, block_name) != EXIT_SUCCESS)
+        {
+                dxf_symbol_table_free (index);
+                return (NULL);
+        }
+        return (index);
+}
+
+
+/*!
+ * \brief Look up a block definition by name in a block index.
+ *
+ * \return a pointer to the block, or \c NULL when no block of that
+ * name is in the index.
+ */
+DxfBlock *
+dxf_block_index_find
+(
+        DxfSymbolTable *index,
+                /*!< the map built by \c dxf_block_index_build. */
+        const char *block_name
+                /*!< the block name to look up. */
+)
+{
+        if ((index == NULL) || (block_name == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        return ((DxfBlock *) dxf_symbol_table_find (index, block_name));
+}
+
+
 /*!
  * \brief Free the allocated memory for a DxfBlock (a \c BLOCK entity)
  * and all it's data fields.
@@ -576,7 +652,7 @@ dxf_block_free
         free (block->description);
         free (block->layer);
         free (block->dictionary_owner_soft);
-        free (block);
+        dxf_entity_dealloc (block, sizeof (*block));
         block = NULL;
 #if DEBUG
         DXF_DEBUG_END
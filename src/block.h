@@ -39,6 +39,7 @@
 #include "global.h"
 #include "util.h"
 #include "endblk.h"
+#include "symbol_table.h"
 
 
 /*!
@@ -165,6 +166,17 @@ int dxf_block_write_table
         DxfFile *fp,
         DxfBlock *blocks_list
 );
+DxfSymbolTable *
+dxf_block_index_build
+(
+        DxfBlock *blocks_list
+);
+DxfBlock *
+dxf_block_index_find
+(
+        DxfSymbolTable *index,
+        const char *block_name
+);
 int dxf_block_free
 (
         DxfBlock *block
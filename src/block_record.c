@@ -35,7 +35,10 @@
  */
 
 
+#include <pthread.h>
 #include "block_record.h"
+#include "diag.h"
+#include "allocator.h"
 
 
 /*!
@@ -61,7 +64,7 @@ dxf_block_record_new ()
         size = sizeof (DxfBlockRecord);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((block_record = malloc (size)) == NULL)
+        if ((block_record = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfBlockRecord struct.\n")),
@@ -102,6 +105,11 @@ dxf_block_record_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfBlockRecord template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         /* Do some basic checks. */
         if (block_record == NULL)
         {
@@ -117,12 +125,22 @@ dxf_block_record_init
                   __FUNCTION__);
                 return (NULL);
         }
-        block_record->id_code = 0;
-        block_record->block_name = strdup ("");
-        block_record->flag = 0;
-        block_record->dictionary_owner_soft = strdup ("");
-        block_record->dictionary_owner_hard = strdup ("");
-        block_record->next = NULL;
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.id_code = 0;
+                template.block_name = strdup ("");
+                template.flag = 0;
+                template.dictionary_owner_soft = strdup ("");
+                template.dictionary_owner_hard = strdup ("");
+                template.next = NULL;
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (block_record, &template, sizeof (DxfBlockRecord));
+        block_record->block_name = strdup (template.block_name);
+        block_record->dictionary_owner_soft = strdup (template.dictionary_owner_soft);
+        block_record->dictionary_owner_hard = strdup (template.dictionary_owner_hard);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -160,7 +178,7 @@ dxf_block_record_read
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        char *temp_string = NULL;
+        char temp_string[DXF_MAX_STRING_LENGTH];
 
         /* Do some basic checks. */
         if (fp == NULL)
@@ -185,7 +203,7 @@ dxf_block_record_read
                 if (ferror (fp->fp))
                 {
                         fprintf (stderr,
-                          (_("Error in %s () while reading from: %s in line: %d.\n")),
+                          (_("Error in %s () while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                         fclose (fp->fp);
                         return (NULL);
@@ -202,7 +220,9 @@ dxf_block_record_read
                         /* Now follows a string containing an application
                          * name. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", block_record->block_name);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (block_record->block_name);
+                        block_record->block_name = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "70") == 0)
                 {
@@ -216,14 +236,18 @@ dxf_block_record_read
                         /* Now follows a string containing Soft-pointer
                          * ID/handle to owner dictionary. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", block_record->dictionary_owner_soft);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (block_record->dictionary_owner_soft);
+                        block_record->dictionary_owner_soft = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "360") == 0)
                 {
                         /* Now follows a string containing Hard owner
                          * ID/handle to owner dictionary. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", block_record->dictionary_owner_hard);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (block_record->dictionary_owner_hard);
+                        block_record->dictionary_owner_hard = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "999") == 0)
                 {
@@ -234,8 +258,8 @@ dxf_block_record_read
                 }
                 else
                 {
-                        fprintf (stderr,
-                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %d.\n")),
+                        dxf_diag_report (fp, DXF_DIAG_WARNING,
+                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                 }
         }
@@ -377,7 +401,7 @@ dxf_block_record_free
         free (block_record->block_name);
         free (block_record->dictionary_owner_soft);
         free (block_record->dictionary_owner_hard);
-        free (block_record);
+        dxf_entity_dealloc (block_record, sizeof (*block_record));
         block_record = NULL;
 #if DEBUG
         DXF_DEBUG_END
@@ -34,7 +34,11 @@
  */
 
 
+#include <pthread.h>
 #include "body.h"
+#include "diag.h"
+#include "allocator.h"
+#include "util.h"
 
 
 /*!
@@ -60,7 +64,7 @@ dxf_body_new ()
         size = sizeof (DxfBody);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((body = malloc (size)) == NULL)
+        if ((body = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfBody struct.\n")),
@@ -101,7 +105,10 @@ dxf_body_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        int i;
+        static DxfBody template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
 
         /* Do some basic checks. */
         if (body == NULL)
@@ -118,25 +125,33 @@ dxf_body_init
                   __FUNCTION__);
                 return (NULL);
         }
-        body->modeler_format_version_number = 0;
-        body->id_code = 0;
-        body->linetype = strdup (DXF_DEFAULT_LINETYPE);
-        body->layer = strdup (DXF_DEFAULT_LAYER);
-        body->elevation = 0.0;
-        body->thickness = 0.0;
-        body->linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
-        body->visibility = DXF_DEFAULT_VISIBILITY;
-        body->color = DXF_COLOR_BYLAYER;
-        body->paperspace = DXF_MODELSPACE;
-        body->modeler_format_version_number = 1;
-        for (i = 0; i < DXF_MAX_PARAM; i++)
-        {
-                body->proprietary_data[i] = strdup ("");
-                body->additional_proprietary_data[i] = strdup ("");
-        }
-        body->dictionary_owner_soft = strdup ("");
-        body->dictionary_owner_hard = strdup ("");
-        body->next = NULL;
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.modeler_format_version_number = 0;
+                template.id_code = 0;
+                template.linetype = strdup (DXF_DEFAULT_LINETYPE);
+                template.layer = strdup (DXF_DEFAULT_LAYER);
+                template.elevation = 0.0;
+                template.thickness = 0.0;
+                template.linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
+                template.visibility = DXF_DEFAULT_VISIBILITY;
+                template.color = DXF_COLOR_BYLAYER;
+                template.paperspace = DXF_MODELSPACE;
+                template.modeler_format_version_number = 1;
+                dxf_acis_data_init (&template.proprietary_data);
+                dxf_acis_data_init (&template.additional_proprietary_data);
+                template.dictionary_owner_soft = strdup ("");
+                template.dictionary_owner_hard = strdup ("");
+                template.next = NULL;
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (body, &template, sizeof (DxfBody));
+        body->linetype = strdup (template.linetype);
+        body->layer = strdup (template.layer);
+        body->dictionary_owner_soft = strdup (template.dictionary_owner_soft);
+        body->dictionary_owner_hard = strdup (template.dictionary_owner_hard);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -173,9 +188,7 @@ dxf_body_read
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        char *temp_string = NULL;
-        int i;
-        int j;
+        char temp_string[DXF_MAX_STRING_LENGTH];
 
         /* Do some basic checks. */
         if (fp == NULL)
@@ -199,8 +212,10 @@ dxf_body_read
                   (_("Warning in %s () illegal DXF version for this entity.\n")),
                   __FUNCTION__);
         }
-        i = 0;
-        j = 0;
+        /* discard stored lines but keep the blob of a recycled
+         * entity. */
+        dxf_acis_data_clear (&body->proprietary_data);
+        dxf_acis_data_clear (&body->additional_proprietary_data);
         (fp->line_number)++;
         fscanf (fp->fp, "%[^\n]", temp_string);
         while (strcmp (temp_string, "0") != 0)
@@ -208,26 +223,33 @@ dxf_body_read
                 if (ferror (fp->fp))
                 {
                         fprintf (stderr,
-                          (_("Error in %s () while reading from: %s in line: %d.\n")),
+                          (_("Error in %s () while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                         fclose (fp->fp);
                         return (NULL);
                 }
                 else if (strcmp (temp_string, "  1") == 0)
                 {
-                        /* Now follows a string containing proprietary
-                         * data. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", body->proprietary_data[i]);
-                        i++;
+                        /* Now follows a line of proprietary data:
+                         * read it whole through the block reader and
+                         * append it to the blob. */
+                        if (dxf_read_line (temp_string, fp) != 1)
+                        {
+                                break;
+                        }
+                        dxf_acis_data_append (&body->proprietary_data,
+                                temp_string);
                 }
                 else if (strcmp (temp_string, "  3") == 0)
                 {
-                        /* Now follows a string containing additional
-                         * proprietary data. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", body->additional_proprietary_data[j]);
-                        j++;
+                        /* Now follows a line of additional proprietary
+                         * data. */
+                        if (dxf_read_line (temp_string, fp) != 1)
+                        {
+                                break;
+                        }
+                        dxf_acis_data_append (&body->additional_proprietary_data,
+                                temp_string);
                 }
                 if (strcmp (temp_string, "5") == 0)
                 {
@@ -241,13 +263,17 @@ dxf_body_read
                         /* Now follows a string containing a linetype
                          * name. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", body->linetype);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (body->linetype);
+                        body->linetype = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "8") == 0)
                 {
                         /* Now follows a string containing a layer name. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", body->layer);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (body->layer);
+                        body->layer = strdup (temp_string);
                 }
                 else if ((fp->acad_version_number <= AutoCAD_11)
                   && DXF_FLATLAND
@@ -296,7 +322,7 @@ dxf_body_read
                         fscanf (fp->fp, "%s\n", temp_string);
                         if (strcmp (temp_string, "AcDbModelerGeometry") != 0)
                         {
-                                fprintf (stderr, "Warning in dxf_body_read () found a bad subclass marker in: %s in line: %d.\n",
+                                fprintf (stderr, "Warning in dxf_body_read () found a bad subclass marker in: %s in line: %ld.\n",
                                         fp->filename, fp->line_number);
                         }
                 }
@@ -305,14 +331,18 @@ dxf_body_read
                         /* Now follows a string containing Soft-pointer
                          * ID/handle to owner dictionary. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", body->dictionary_owner_soft);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (body->dictionary_owner_soft);
+                        body->dictionary_owner_soft = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "360") == 0)
                 {
                         /* Now follows a string containing Hard owner
                          * ID/handle to owner dictionary. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", body->dictionary_owner_hard);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (body->dictionary_owner_hard);
+                        body->dictionary_owner_hard = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "999") == 0)
                 {
@@ -323,8 +353,8 @@ dxf_body_read
                 }
                 else
                 {
-                        fprintf (stderr,
-                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %d.\n")),
+                        dxf_diag_report (fp, DXF_DIAG_WARNING,
+                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                 }
         }
@@ -340,7 +370,7 @@ dxf_body_read
         if (body->modeler_format_version_number == 0)
         {
                 fprintf (stderr,
-                  (_("Warning: in %s () illegal modeler format version number found while reading from: %s in line: %d.\n")),
+                  (_("Warning: in %s () illegal modeler format version number found while reading from: %s in line: %ld.\n")),
                   __FUNCTION__, fp->filename, fp->line_number);
                 fprintf (stderr,
                   (_("\tmodeler format version number is reset to 1.\n")));
@@ -378,7 +408,6 @@ dxf_body_write
         DXF_DEBUG_BEGIN
 #endif
         char *dxf_entity_name = strdup ("BODY");
-        int i;
 
         /* Do some basic checks. */
         if (fp == NULL)
@@ -494,18 +523,8 @@ dxf_body_write
         {
                 fprintf (fp->fp, " 70\n%d\n", body->modeler_format_version_number);
         }
-        i = 0;
-        while (strlen (body->proprietary_data[i]) > 0)
-        {
-                fprintf (fp->fp, "  1\n%s\n", body->proprietary_data[i]);
-                i++;
-        }
-        i = 0;
-        while (strlen (body->additional_proprietary_data[i]) > 0)
-        {
-                fprintf (fp->fp, "  3\n%s\n", body->additional_proprietary_data[i]);
-                i++;
-        }
+        dxf_acis_data_write (fp, 1, &body->proprietary_data);
+        dxf_acis_data_write (fp, 3, &body->additional_proprietary_data);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -537,7 +556,6 @@ dxf_body_free
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        int i;
 
         /* Do some basic checks. */
         if (body->next != NULL)
@@ -549,14 +567,11 @@ dxf_body_free
         }
         free (body->linetype);
         free (body->layer);
-        for (i = 0; i < DXF_MAX_PARAM; i++)
-        {
-                free (body->proprietary_data[i]);
-                free (body->additional_proprietary_data[i]);
-        }
+        dxf_acis_data_free_contents (&body->proprietary_data);
+        dxf_acis_data_free_contents (&body->additional_proprietary_data);
         free (body->dictionary_owner_soft);
         free (body->dictionary_owner_hard);
-        free (body);
+        dxf_entity_dealloc (body, sizeof (*body));
         body = NULL;
 #if DEBUG
         DXF_DEBUG_END
@@ -37,6 +37,7 @@
 
 
 #include "global.h"
+#include "acis.h"
 
 
 /*!
@@ -99,15 +100,15 @@ dxf_body
                 /*!< group code = 360\n
                  * Hard owner ID/handle to owner dictionary (optional). */
         /* Specific members for a DXF body. */
-        char *proprietary_data[DXF_MAX_PARAM];
+        DxfAcisData proprietary_data;
                 /*!< group code = 1\n
                  * Proprietary data (multiple lines < 255 characters
-                 * each).*/
-        char *additional_proprietary_data[DXF_MAX_PARAM];
+                 * each), stored in one contiguous blob.*/
+        DxfAcisData additional_proprietary_data;
                 /*!< group code = 3\n
                  * Additional lines of proprietary data if previous
                  * group 1 string is greater than 255 characters
-                 * (optional).*/
+                 * (optional), stored in one contiguous blob.*/
         int modeler_format_version_number;
                 /*!< group code = 70\n
                  * Modeler format version number (currently = 1).\n */
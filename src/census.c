@@ -0,0 +1,609 @@
+/*!
+ * \file census.c
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Functions for the pre-scan entity census.
+ *
+ * The census is a fast first pass over a DXF file which counts the
+ * records per type and per section before any parsing happens.\n
+ * Only the "0" group code lines announcing a record and the section
+ * names need to be recognised, so the scan walks the raw bytes of the
+ * file line by line and never allocates per record; it runs near
+ * memory bandwidth.\n
+ * A parser armed with the counts can size its arenas, chunked
+ * containers and hash indexes exactly instead of growing them
+ * incrementally, and batch schedulers can route big files to big
+ * machines without opening them twice.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+#include "global.h"
+#include "census.h"
+#include "util.h"
+
+
+/*!
+ * \brief Count one record of a type within a section.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+static int
+dxf_census_bump
+(
+        DxfCensus *census,
+                /*!< the census to count into. */
+        const char *section_name,
+                /*!< the section holding the record. */
+        const char *record_name
+                /*!< the record type. */
+)
+{
+        char key[DXF_MAX_STRING_LENGTH * 2];
+        DxfCensusEntry *entries;
+        size_t capacity;
+        void *record;
+
+        sprintf (key, "%s\037%s", section_name, record_name);
+        record = dxf_symbol_table_find (census->index, key);
+        if (record != NULL)
+        {
+                /* positions are stored shifted by one, the symbol table
+                 * treats a stored null pointer as "not present". */
+                census->entries[(size_t) record - 1].count++;
+                return (EXIT_SUCCESS);
+        }
+        if (census->length == census->capacity)
+        {
+                capacity = (census->capacity == 0) ? 64 : (census->capacity * 2);
+                entries = realloc (census->entries,
+                        capacity * sizeof (DxfCensusEntry));
+                if (entries == NULL)
+                {
+                        fprintf (stderr,
+                          (_("Error in %s () could not allocate memory.\n")),
+                          __FUNCTION__);
+                        return (EXIT_FAILURE);
+                }
+                census->entries = entries;
+                census->capacity = capacity;
+        }
+        census->entries[census->length].section_name = dxf_string_intern (section_name);
+        census->entries[census->length].record_name = dxf_string_intern (record_name);
+        census->entries[census->length].count = 1;
+        if ((census->entries[census->length].section_name == NULL)
+          || (census->entries[census->length].record_name == NULL))
+        {
+                return (EXIT_FAILURE);
+        }
+        if (dxf_symbol_table_insert (census->index, key,
+                (void *) (census->length + 1)) != EXIT_SUCCESS)
+        {
+                return (EXIT_FAILURE);
+        }
+        census->length++;
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Inflate a gzip compressed DXF file into one buffer.
+ *
+ * \return a pointer to the inflated bytes, to be freed by the caller,
+ * or \c NULL when errors occurred.
+ */
+static char *
+dxf_census_inflate
+(
+        const char *filename,
+                /*!< filename of the gzip compressed DXF file. */
+        size_t *size
+                /*!< the inflated size in bytes is returned here. */
+)
+{
+        gzFile gzip;
+        char *buffer;
+        char *grown;
+        size_t capacity;
+        size_t length;
+        int bytes;
+
+        gzip = gzopen (filename, "rb");
+        if (gzip == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not open a zlib stream on: %s.\n")),
+                  __FUNCTION__, filename);
+                return (NULL);
+        }
+        capacity = 65536;
+        length = 0;
+        buffer = malloc (capacity);
+        if (buffer == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                gzclose (gzip);
+                return (NULL);
+        }
+        while ((bytes = gzread (gzip, buffer + length,
+                (unsigned) (capacity - length))) > 0)
+        {
+                length += (size_t) bytes;
+                if (length == capacity)
+                {
+                        capacity *= 2;
+                        grown = realloc (buffer, capacity);
+                        if (grown == NULL)
+                        {
+                                fprintf (stderr,
+                                  (_("Error in %s () could not allocate memory.\n")),
+                                  __FUNCTION__);
+                                free (buffer);
+                                gzclose (gzip);
+                                return (NULL);
+                        }
+                        buffer = grown;
+                }
+        }
+        if (bytes < 0)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () while reading from: %s.\n")),
+                  __FUNCTION__, filename);
+                free (buffer);
+                gzclose (gzip);
+                return (NULL);
+        }
+        gzclose (gzip);
+        *size = length;
+        return (buffer);
+}
+
+
+/*!
+ * \brief Take a census of the records of a DXF file by a byte level
+ * pre-scan.
+ *
+ * The scan only recognises the "0\n<NAME>" record boundaries and the
+ * section names; values, coordinates and the records themselves are
+ * not parsed.\n
+ * A gzip compressed file is inflated into one buffer first, so the
+ * census counts the records of the underlying drawing, not the opaque
+ * compressed bytes.
+ *
+ * \return a pointer to the census, to be freed with
+ * \c dxf_census_free, or \c NULL when errors occurred.
+ */
+DxfCensus *
+dxf_file_census
+(
+        char *filename
+                /*!< filename of the DXF file to scan. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        DxfCensus *census;
+        struct stat sb;
+        char name[DXF_MAX_STRING_LENGTH];
+        char section[DXF_MAX_STRING_LENGTH];
+        char *base;
+        char *inflated;
+        char *mapped = NULL;
+        const char *at;
+        const char *end;
+        const char *line;
+        const char *line_end;
+        size_t size;
+        size_t inflated_size;
+        size_t length;
+        int fd;
+        int expect_value = 0;
+        int tag_is_zero = 0;
+        int tag_is_two = 0;
+        int tag_is_310 = 0;
+        int tag_is_102 = 0;
+        int tag_is_text = 0;
+        int pending_section = 0;
+        int in_acis_record = 0;
+        size_t nesting = 0;
+
+        /* Do some basic checks. */
+        if (filename == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        fd = open (filename, O_RDONLY);
+        if (fd < 0)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not open file: %s for reading.\n")),
+                  __FUNCTION__, filename);
+                return (NULL);
+        }
+        if (fstat (fd, &sb) != 0)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not stat file: %s.\n")),
+                  __FUNCTION__, filename);
+                close (fd);
+                return (NULL);
+        }
+        size = (size_t) sb.st_size;
+        base = NULL;
+        if (size > 0)
+        {
+                mapped = mmap (NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (mapped != MAP_FAILED)
+                {
+#ifdef MADV_SEQUENTIAL
+                        madvise (mapped, size, MADV_SEQUENTIAL);
+#endif
+                        base = mapped;
+                }
+                else
+                {
+                        /* devices and filesystems without mmap: read
+                         * the file into one buffer instead. */
+                        mapped = NULL;
+                        base = malloc (size);
+                        if (base == NULL)
+                        {
+                                fprintf (stderr,
+                                  (_("Error in %s () could not allocate memory.\n")),
+                                  __FUNCTION__);
+                                close (fd);
+                                return (NULL);
+                        }
+                        if (read (fd, base, size) != (ssize_t) size)
+                        {
+                                fprintf (stderr,
+                                  (_("Error in %s () while reading from: %s.\n")),
+                                  __FUNCTION__, filename);
+                                free (base);
+                                close (fd);
+                                return (NULL);
+                        }
+                }
+        }
+        if ((size >= 2)
+          && (((unsigned char) base[0]) == 0x1f)
+          && (((unsigned char) base[1]) == 0x8b))
+        {
+                /* a gzip compressed file: the raw bytes are opaque to
+                 * the scan, so inflate the whole stream and scan the
+                 * inflated bytes instead. */
+                inflated = dxf_census_inflate (filename, &inflated_size);
+                if (inflated == NULL)
+                {
+                        if (mapped != NULL) munmap (mapped, size);
+                        else free (base);
+                        close (fd);
+                        return (NULL);
+                }
+                if (mapped != NULL) munmap (mapped, size);
+                else free (base);
+                mapped = NULL;
+                base = inflated;
+                size = inflated_size;
+        }
+        census = calloc (1, sizeof (DxfCensus));
+        if (census == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                if (mapped != NULL) munmap (mapped, size);
+                else free (base);
+                close (fd);
+                return (NULL);
+        }
+        census->index = dxf_symbol_table_new ();
+        if (census->index == NULL)
+        {
+                free (census);
+                if (mapped != NULL) munmap (mapped, size);
+                else free (base);
+                close (fd);
+                return (NULL);
+        }
+        section[0] = '\0';
+        at = base;
+        end = base + size;
+        while (at < end)
+        {
+                line = at;
+                line_end = memchr (at, '\n', (size_t) (end - at));
+                if (line_end == NULL)
+                {
+                        line_end = end;
+                        at = end;
+                }
+                else
+                {
+                        at = line_end + 1;
+                }
+                /* trim leading blanks and a trailing carriage return. */
+                while ((line < line_end)
+                  && ((*line == ' ') || (*line == '\t')))
+                {
+                        line++;
+                }
+                if ((line < line_end) && (line_end[-1] == '\r'))
+                {
+                        line_end--;
+                }
+                length = (size_t) (line_end - line);
+                if (!expect_value)
+                {
+                        tag_is_zero = ((length == 1) && (line[0] == '0'));
+                        tag_is_two = ((length == 1) && (line[0] == '2'));
+                        tag_is_text = ((length == 1)
+                          && ((line[0] == '1') || (line[0] == '3')));
+                        tag_is_310 = ((length == 3)
+                          && (memcmp (line, "310", 3) == 0));
+                        tag_is_102 = ((length == 3)
+                          && (memcmp (line, "102", 3) == 0));
+                        expect_value = 1;
+                        continue;
+                }
+                expect_value = 0;
+                if (tag_is_310 || (tag_is_text && in_acis_record))
+                {
+                        census->proprietary_bytes += length;
+                }
+                if (tag_is_102 && (length > 0))
+                {
+                        if (line[0] == '{')
+                        {
+                                nesting++;
+                                if (nesting > census->max_nesting)
+                                {
+                                        census->max_nesting = nesting;
+                                }
+                        }
+                        else if ((line[0] == '}') && (nesting > 0))
+                        {
+                                nesting--;
+                        }
+                }
+                if (tag_is_zero)
+                {
+                        if (length >= DXF_MAX_STRING_LENGTH)
+                        {
+                                length = DXF_MAX_STRING_LENGTH - 1;
+                        }
+                        memcpy (name, line, length);
+                        name[length] = '\0';
+                        in_acis_record = 0;
+                        if (strcmp (name, "SECTION") == 0)
+                        {
+                                census->total_sections++;
+                                pending_section = 1;
+                        }
+                        else if (strcmp (name, "ENDSEC") == 0)
+                        {
+                                section[0] = '\0';
+                                pending_section = 0;
+                        }
+                        else if (strcmp (name, "EOF") == 0)
+                        {
+                                /* end of file marker: not a record. */
+                        }
+                        else
+                        {
+                                census->total_records++;
+                                in_acis_record =
+                                  ((strcmp (name, "3DSOLID") == 0)
+                                  || (strcmp (name, "BODY") == 0)
+                                  || (strcmp (name, "REGION") == 0)
+                                  || (strcmp (name, "ACAD_PROXY_ENTITY") == 0));
+                                if (dxf_census_bump (census, section, name) != EXIT_SUCCESS)
+                                {
+                                        dxf_census_free (census);
+                                        census = NULL;
+                                        break;
+                                }
+                        }
+                }
+                else if (tag_is_two && pending_section)
+                {
+                        if (length >= DXF_MAX_STRING_LENGTH)
+                        {
+                                length = DXF_MAX_STRING_LENGTH - 1;
+                        }
+                        memcpy (section, line, length);
+                        section[length] = '\0';
+                        pending_section = 0;
+                }
+        }
+        if (mapped != NULL)
+        {
+                munmap (mapped, size);
+        }
+        else
+        {
+                free (base);
+        }
+        close (fd);
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (census);
+}
+
+
+/*!
+ * \brief Look up a count in a census.
+ *
+ * \return the number of records of the type in the section, summed
+ * over all sections when \c section_name is \c NULL, or \c 0 when the
+ * census holds none.
+ */
+size_t
+dxf_census_count
+(
+        DxfCensus *census,
+                /*!< the census to look up in. */
+        const char *section_name,
+                /*!< the section name, or \c NULL for the whole file. */
+        const char *record_name
+                /*!< the record type to count. */
+)
+{
+        char key[DXF_MAX_STRING_LENGTH * 2];
+        void *record;
+        size_t count;
+        size_t i;
+
+        if ((census == NULL) || (record_name == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (0);
+        }
+        if (section_name != NULL)
+        {
+                sprintf (key, "%s\037%s", section_name, record_name);
+                record = dxf_symbol_table_find (census->index, key);
+                if (record == NULL)
+                {
+                        return (0);
+                }
+                return (census->entries[(size_t) record - 1].count);
+        }
+        count = 0;
+        for (i = 0; i < census->length; i++)
+        {
+                if (strcmp (census->entries[i].record_name, record_name) == 0)
+                {
+                        count += census->entries[i].count;
+                }
+        }
+        return (count);
+}
+
+
+/*!
+ * \brief Check a census against admission limits.
+ *
+ * Every violated limit is reported on \c stderr, so an operator sees
+ * all the reasons a file was rejected at once.
+ *
+ * \return \c EXIT_SUCCESS when the census stays within every limit,
+ * or \c EXIT_FAILURE when a limit is exceeded or a \c NULL pointer
+ * was passed.
+ */
+int
+dxf_census_admit
+(
+        DxfCensus *census,
+                /*!< the census to check. */
+        const DxfReadLimits *limits
+                /*!< the limits to check against; a limit of \c 0 means
+                 * unlimited. */
+)
+{
+        int result;
+
+        if ((census == NULL) || (limits == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        result = EXIT_SUCCESS;
+        if ((limits->max_entities > 0)
+          && (census->total_records > limits->max_entities))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () the file holds %lu records, the limit is %lu.\n")),
+                  __FUNCTION__, (unsigned long) census->total_records,
+                  (unsigned long) limits->max_entities);
+                result = EXIT_FAILURE;
+        }
+        if ((limits->max_proprietary_bytes > 0)
+          && (census->proprietary_bytes > limits->max_proprietary_bytes))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () the file holds %lu proprietary data bytes, the limit is %lu.\n")),
+                  __FUNCTION__, (unsigned long) census->proprietary_bytes,
+                  (unsigned long) limits->max_proprietary_bytes);
+                result = EXIT_FAILURE;
+        }
+        if ((limits->max_nesting > 0)
+          && (census->max_nesting > limits->max_nesting))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () the file nests %lu levels deep, the limit is %lu.\n")),
+                  __FUNCTION__, (unsigned long) census->max_nesting,
+                  (unsigned long) limits->max_nesting);
+                result = EXIT_FAILURE;
+        }
+        return (result);
+}
+
+
+/*!
+ * \brief Free a census.
+ *
+ * The section and record names live in the shared string pool (see
+ * \c dxf_string_intern) and are not touched.
+ */
+void
+dxf_census_free
+(
+        DxfCensus *census
+                /*!< the census to free. */
+)
+{
+        if (census == NULL)
+        {
+                return;
+        }
+        free (census->entries);
+        dxf_symbol_table_free (census->index);
+        free (census);
+}
+
+
+/* EOF */
@@ -0,0 +1,147 @@
+/*!
+ * \file census.h
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Header for the pre-scan entity census.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#ifndef LIBDXF_SRC_CENSUS_H
+#define LIBDXF_SRC_CENSUS_H
+
+
+#include <stddef.h>
+#include "symbol_table.h"
+
+
+/*!
+ * \brief The count of one record type within one section.
+ */
+typedef struct
+dxf_census_entry
+{
+        char *section_name;
+                /*!< the section holding the records; the string lives
+                 * in the shared string pool (see \c dxf_string_intern).
+                 * An empty string for records outside any section. */
+        char *record_name;
+                /*!< the record type counted; interned like
+                 * \c section_name. */
+        size_t count;
+                /*!< number of records of this type in this section. */
+} DxfCensusEntry;
+
+
+/*!
+ * \brief A census of the records of a DXF file, by type and by
+ * section, taken by a byte level pre-scan without parsing.
+ *
+ * A parser can size arenas, chunked containers and hash indexes to the
+ * exact counts instead of growing them incrementally, and batch
+ * schedulers can route big files by \c total_records without opening
+ * them twice.
+ */
+typedef struct
+dxf_census
+{
+        DxfCensusEntry *entries;
+                /*!< the per section, per type counts. */
+        size_t length;
+                /*!< number of entries. */
+        size_t capacity;
+                /*!< number of allocated entries. */
+        size_t total_records;
+                /*!< number of records in the file, the \c SECTION,
+                 * \c ENDSEC and \c EOF markers not counted. */
+        size_t total_sections;
+                /*!< number of \c SECTION markers in the file. */
+        size_t proprietary_bytes;
+                /*!< bytes of proprietary data value lines: every
+                 * \c 310 binary chunk, and the \c 1 / \c 3 text lines
+                 * inside \c 3DSOLID, \c BODY, \c REGION and
+                 * \c ACAD_PROXY_ENTITY records. */
+        size_t max_nesting;
+                /*!< deepest nesting of \c 102 control string groups
+                 * ("{...}"). */
+        DxfSymbolTable *index;
+                /*!< hash map from "section\\037type" to entry
+                 * position. */
+} DxfCensus;
+
+
+/*!
+ * \brief Admission limits for a file, enforced from the census before
+ * parsing (see \c dxf_read_set_limits).
+ *
+ * A limit of \c 0 means unlimited.
+ */
+typedef struct
+dxf_read_limits
+{
+        size_t max_entities;
+                /*!< largest admitted number of records outside the
+                 * \c SECTION / \c ENDSEC / \c EOF markers. */
+        size_t max_proprietary_bytes;
+                /*!< largest admitted number of proprietary data
+                 * bytes. */
+        size_t max_nesting;
+                /*!< deepest admitted \c 102 control string
+                 * nesting. */
+} DxfReadLimits;
+
+
+DxfCensus *
+dxf_file_census
+(
+        char *filename
+);
+size_t
+dxf_census_count
+(
+        DxfCensus *census,
+        const char *section_name,
+        const char *record_name
+);
+int
+dxf_census_admit
+(
+        DxfCensus *census,
+        const DxfReadLimits *limits
+);
+void
+dxf_census_free
+(
+        DxfCensus *census
+);
+
+
+#endif /* LIBDXF_SRC_CENSUS_H */
+
+
+/* EOF */
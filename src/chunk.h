@@ -0,0 +1,126 @@
+/*!
+ * \file chunk.h
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Header for a chunked, contiguous container for entities.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#ifndef LIBDXF_SRC_CHUNK_H
+#define LIBDXF_SRC_CHUNK_H
+
+
+#include <stddef.h>
+
+
+/*!
+ * The payload size, in bytes, of one block of a \c DxfChunkList.
+ */
+#define DXF_CHUNK_BLOCK_SIZE 65536
+
+
+/*!
+ * \brief One block of a \c DxfChunkList.
+ *
+ * The entity slots follow the struct in the same malloc'ed region.
+ */
+typedef struct
+dxf_chunk_block
+{
+        struct dxf_chunk_block *next;
+                /*!< pointer to the next filled block, or \c NULL. */
+        size_t used;
+                /*!< number of entity slots handed out. */
+} DxfChunkBlock;
+
+
+/*!
+ * \brief A chunked, contiguous container for entities of one type.
+ *
+ * Entities of one type are stored back to back in blocks of
+ * \c DXF_CHUNK_BLOCK_SIZE bytes, so a traversal touches consecutive
+ * cache lines instead of chasing a pointer per entity across the
+ * heap.\n
+ * Every appended slot is still threaded through the entity's own
+ * \c next member, so existing code walking \c first / \c next chains
+ * works on a chunk list unchanged.
+ */
+typedef struct
+dxf_chunk_list
+{
+        size_t entity_size;
+                /*!< size of one entity struct, in bytes. */
+        size_t next_offset;
+                /*!< offset of the \c next pointer member within the
+                 * entity struct. */
+        size_t slots_per_block;
+                /*!< number of entity slots per block. */
+        size_t length;
+                /*!< total number of appended entities. */
+        DxfChunkBlock *first_block;
+                /*!< pointer to the first block, or \c NULL. */
+        DxfChunkBlock *last_block;
+                /*!< pointer to the block being filled, or \c NULL. */
+        void *first;
+                /*!< pointer to the first appended entity, or \c NULL. */
+        void *last;
+                /*!< pointer to the last appended entity, or \c NULL. */
+} DxfChunkList;
+
+
+/*!
+ * Construct a \c DxfChunkList for an entity type, deriving the slot
+ * size and the offset of its \c next member.
+ */
+#define DXF_CHUNK_LIST_NEW(type) \
+        dxf_chunk_list_new (sizeof (type), offsetof (type, next))
+
+
+DxfChunkList *
+dxf_chunk_list_new
+(
+        size_t entity_size,
+        size_t next_offset
+);
+void *
+dxf_chunk_list_append
+(
+        DxfChunkList *list
+);
+void
+dxf_chunk_list_free
+(
+        DxfChunkList *list
+);
+
+
+#endif /* LIBDXF_SRC_CHUNK_H */
+
+
+/* EOF */
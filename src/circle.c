@@ -32,7 +32,13 @@
  */
 
 
+#include <math.h>
+
+#include <pthread.h>
 #include "circle.h"
+#include "allocator.h"
+#include "field.h"
+#include "writer.h"
 
 
 /*!
@@ -56,7 +62,7 @@ dxf_circle_new ()
         size = sizeof (DxfCircle);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_circle = malloc (size)) == NULL)
+        if ((dxf_circle = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfCircle struct.\n")),
@@ -95,6 +101,11 @@ dxf_circle_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfCircle template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         /* Do some basic checks. */
         if (dxf_circle == NULL)
         {
@@ -110,25 +121,37 @@ dxf_circle_init
                 __FUNCTION__);
               return (NULL);
         }
-        dxf_circle->id_code = 0;
-        dxf_circle->linetype = strdup (DXF_DEFAULT_LINETYPE);
-        dxf_circle->layer = strdup (DXF_DEFAULT_LAYER);
-        dxf_circle->x0 = 0.0;
-        dxf_circle->y0 = 0.0;
-        dxf_circle->z0 = 0.0;
-        dxf_circle->extr_x0 = 0.0;
-        dxf_circle->extr_y0 = 0.0;
-        dxf_circle->extr_z0 = 0.0;
-        dxf_circle->elevation = 0.0;
-        dxf_circle->thickness = 0.0;
-        dxf_circle->linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
-        dxf_circle->visibility = DXF_DEFAULT_VISIBILITY;
-        dxf_circle->radius = 0.0;
-        dxf_circle->color = DXF_COLOR_BYLAYER;
-        dxf_circle->paperspace = DXF_MODELSPACE;
-        dxf_circle->dictionary_owner_soft = strdup ("");
-        dxf_circle->dictionary_owner_hard = strdup ("");
-        dxf_circle->next = NULL;
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.id_code = 0;
+                template.linetype = strdup (DXF_DEFAULT_LINETYPE);
+                template.layer = strdup (DXF_DEFAULT_LAYER);
+                template.x0 = 0.0;
+                template.y0 = 0.0;
+                template.z0 = 0.0;
+                template.extr_x0 = 0.0;
+                template.extr_y0 = 0.0;
+                template.extr_z0 = 0.0;
+                template.elevation = 0.0;
+                template.thickness = 0.0;
+                template.linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
+                template.visibility = DXF_DEFAULT_VISIBILITY;
+                template.radius = 0.0;
+                template.color = DXF_COLOR_BYLAYER;
+                template.paperspace = DXF_MODELSPACE;
+                template.dictionary_owner_soft = strdup ("");
+                template.dictionary_owner_hard = strdup ("");
+                template.tessellation = NULL;
+                template.next = NULL;
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (dxf_circle, &template, sizeof (DxfCircle));
+        dxf_circle->linetype = strdup (template.linetype);
+        dxf_circle->layer = strdup (template.layer);
+        dxf_circle->dictionary_owner_soft = strdup (template.dictionary_owner_soft);
+        dxf_circle->dictionary_owner_hard = strdup (template.dictionary_owner_hard);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -136,6 +159,69 @@ dxf_circle_init
 }
 
 
+/*!
+ * \brief Field table mapping group codes to \c DxfCircle members,
+ * sorted by group code.
+ */
+const DxfFieldSpec dxf_circle_field_table[] =
+{
+        {5, DXF_FIELD_TYPE_HEX, offsetof (DxfCircle, id_code), "id_code"},
+        {6, DXF_FIELD_TYPE_STRING, offsetof (DxfCircle, linetype), "linetype"},
+        {8, DXF_FIELD_TYPE_STRING, offsetof (DxfCircle, layer), "layer"},
+        {10, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfCircle, x0), "x0"},
+        {20, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfCircle, y0), "y0"},
+        {30, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfCircle, z0), "z0"},
+        {39, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfCircle, thickness), "thickness"},
+        {40, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfCircle, radius), "radius"},
+        {48, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfCircle, linetype_scale), "linetype_scale"},
+        {60, DXF_FIELD_TYPE_INT16, offsetof (DxfCircle, visibility), "visibility"},
+        {62, DXF_FIELD_TYPE_INT, offsetof (DxfCircle, color), "color"},
+        {67, DXF_FIELD_TYPE_INT, offsetof (DxfCircle, paperspace), "paperspace"},
+        {210, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfCircle, extr_x0), "extr_x0"},
+        {220, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfCircle, extr_y0), "extr_y0"},
+        {230, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfCircle, extr_z0), "extr_z0"},
+        {330, DXF_FIELD_TYPE_STRING, offsetof (DxfCircle, dictionary_owner_soft), "dictionary_owner_soft"},
+        {360, DXF_FIELD_TYPE_STRING, offsetof (DxfCircle, dictionary_owner_hard), "dictionary_owner_hard"}
+};
+
+
+/*!
+ * Number of entries in \c dxf_circle_field_table.
+ */
+const size_t dxf_circle_field_table_length =
+        DXF_FIELD_TABLE_LENGTH (dxf_circle_field_table);
+
+
+/*!
+ * \brief Handle the version dependent fields of a \c DxfCircle entity
+ * which cannot be table driven.
+ */
+static int
+dxf_circle_read_special
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an input file (or device). */
+        void *entity,
+                /*!< DXF circle entity. */
+        int group_code
+                /*!< group code read by the shared parse loop. */
+)
+{
+        DxfCircle *dxf_circle = (DxfCircle *) entity;
+
+        if ((group_code == 38)
+                && (fp->acad_version_number <= AutoCAD_11)
+                && (dxf_circle->z0 == 0.0))
+        {
+                /* Elevation is a pre AutoCAD R11 variable.\n
+                 * Now follows a string containing the elevation. */
+                                dxf_read_scanf (fp, "%lf\n", &dxf_circle->z0);
+                return (FOUND);
+        }
+        return (FAIL);
+}
+
+
 /*!
  * \brief Read data from a DXF file into a DXF \c CIRCLE entity.
  *
@@ -159,8 +245,6 @@ dxf_circle_read
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        char *temp_string = NULL;
-
         /* Do some basic checks. */
         if (fp == NULL)
         {
@@ -177,190 +261,72 @@ dxf_circle_read
                 dxf_circle = dxf_circle_new ();
                 dxf_circle = dxf_circle_init (dxf_circle);
         }
-        (fp->line_number)++;
-        fscanf (fp->fp, "%[^\n]", temp_string);
-        while (strcmp (temp_string, "0") != 0)
+        if (dxf_field_read_all (fp, dxf_circle, dxf_circle_field_table,
+                DXF_FIELD_TABLE_LENGTH (dxf_circle_field_table),
+                "AcDbEntity AcDbCircle", dxf_circle_read_special) != EXIT_SUCCESS)
         {
-                if (ferror (fp->fp))
-                {
-                        fprintf (stderr,
-                          (_("Error in %s () while reading from: %s in line: %d.\n")),
-                          __FUNCTION__, fp->filename, fp->line_number);
-                        fclose (fp->fp);
-                        return (NULL);
-                }
-                if (strcmp (temp_string, "5") == 0)
-                {
-                        /* Now follows a string containing a sequential
-                         * id number. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%x\n", &dxf_circle->id_code);
-                }
-                else if (strcmp (temp_string, "6") == 0)
-                {
-                        /* Now follows a string containing a linetype
-                         * name. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_circle->linetype);
-                }
-                else if (strcmp (temp_string, "8") == 0)
-                {
-                        /* Now follows a string containing a layer name. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_circle->layer);
-                }
-                else if (strcmp (temp_string, "10") == 0)
-                {
-                        /* Now follows a string containing the
-                         * X-coordinate of the center point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_circle->x0);
-                }
-                else if (strcmp (temp_string, "20") == 0)
-                {
-                        /* Now follows a string containing the
-                         * Y-coordinate of the center point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_circle->y0);
-                }
-                else if (strcmp (temp_string, "30") == 0)
-                {
-                        /* Now follows a string containing the
-                         * Z-coordinate of the center point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_circle->z0);
-                }
-                else if ((fp->acad_version_number <= AutoCAD_11)
-                        && (strcmp (temp_string, "38") == 0)
-                        && (dxf_circle->z0 = 0.0))
-                {
-                        /* Elevation is a pre AutoCAD R11 variable
-                         * so additional testing for the version should
-                         * probably be added.
-                         * Now follows a string containing the
-                         * elevation. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_circle->z0);
-                }
-                else if (strcmp (temp_string, "39") == 0)
-                {
-                        /* Now follows a string containing the
-                         * thickness. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_circle->thickness);
-                }
-                else if (strcmp (temp_string, "40") == 0)
-                {
-                        /* Now follows a string containing the
-                         * radius. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_circle->radius);
-                }
-                else if (strcmp (temp_string, "48") == 0)
-                {
-                        /* Now follows a string containing the linetype
-                         * scale. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_circle->linetype_scale);
-                }
-                else if (strcmp (temp_string, "60") == 0)
-                {
-                        /* Now follows a string containing the
-                         * visibility value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%hd\n", &dxf_circle->visibility);
-                }
-                else if (strcmp (temp_string, "62") == 0)
-                {
-                        /* Now follows a string containing the
-                         * color value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_circle->color);
-                }
-                else if (strcmp (temp_string, "67") == 0)
-                {
-                        /* Now follows a string containing the
-                         * paperspace value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_circle->paperspace);
-                }
-                else if ((fp->acad_version_number >= AutoCAD_13)
-                        && (strcmp (temp_string, "100") == 0))
-                {
-                        /* Now follows a string containing the
-                         * subclass marker value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", temp_string);
-                        if ((strcmp (temp_string, "AcDbEntity") != 0)
-                        && (strcmp (temp_string, "AcDbCircle") != 0))
-                        {
-                                fprintf (stderr,
-                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %d.\n")),
-                                  __FUNCTION__, fp->filename, fp->line_number);
-                        }
-                }
-                else if (strcmp (temp_string, "210") == 0)
-                {
-                        /* Now follows a string containing the
-                         * X-value of the extrusion vector. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_circle->extr_x0);
-                }
-                else if (strcmp (temp_string, "220") == 0)
-                {
-                        /* Now follows a string containing the
-                         * Y-value of the extrusion vector. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_circle->extr_y0);
-                }
-                else if (strcmp (temp_string, "230") == 0)
-                {
-                        /* Now follows a string containing the
-                         * Z-value of the extrusion vector. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_circle->extr_z0);
-                }
-                else if (strcmp (temp_string, "330") == 0)
-                {
-                        /* Now follows a string containing Soft-pointer
-                         * ID/handle to owner dictionary. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_circle->dictionary_owner_soft);
-                }
-                else if (strcmp (temp_string, "360") == 0)
-                {
-                        /* Now follows a string containing Hard owner
-                         * ID/handle to owner dictionary. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_circle->dictionary_owner_hard);
-                }
-                else if (strcmp (temp_string, "999") == 0)
+                return (NULL);
+        }
+        /* Handle omitted members and/or illegal values; trusted
+         * inputs are guaranteed complete and skip the repair. */
+        if (!fp->trusted)
+        {
+                if (strcmp (dxf_circle->linetype, "") == 0)
                 {
-                        /* Now follows a string containing a comment. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", temp_string);
-                        fprintf (stdout, "DXF comment: %s\n", temp_string);
+                        dxf_circle->linetype = strdup (DXF_DEFAULT_LINETYPE);
                 }
-                else
+                if (strcmp (dxf_circle->layer, "") == 0)
                 {
-                        fprintf (stderr,
-                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %d.\n")),
-                          __FUNCTION__, fp->filename, fp->line_number);
+                        dxf_circle->layer = strdup (DXF_DEFAULT_LAYER);
                 }
         }
-        /* Handle omitted members and/or illegal values. */
-        if (strcmp (dxf_circle->linetype, "") == 0)
-        {
-                dxf_circle->linetype = strdup (DXF_DEFAULT_LINETYPE);
-        }
-        if (strcmp (dxf_circle->layer, "") == 0)
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (dxf_circle);
+}
+
+
+/*!
+ * \brief Duplicate a DXF \c CIRCLE entity.
+ *
+ * Driven by the field table; without an arena the duplicate owns deep
+ * copies of its strings and is released with \c dxf_circle_free, with
+ * an arena the strings stay shared with the source and the duplicate
+ * is released with the arena (see \c dxf_field_dup).\n
+ * The duplicate is standalone: it is not linked behind the source and
+ * does not share its tessellation cache.
+ *
+ * \return a pointer to the duplicate, or \c NULL when errors occurred.
+ */
+DxfCircle *
+dxf_circle_dup
+(
+        DxfCircle *dxf_circle,
+                /*!< DXF circle entity to duplicate. */
+        struct dxf_arena *arena
+                /*!< the arena to allocate from, or \c NULL to allocate
+                 * with \c malloc. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        DxfCircle *copy;
+
+        copy = dxf_field_dup (dxf_circle, sizeof (DxfCircle),
+                dxf_circle_field_table,
+                DXF_FIELD_TABLE_LENGTH (dxf_circle_field_table), arena);
+        if (copy == NULL)
         {
-                dxf_circle->layer = strdup (DXF_DEFAULT_LAYER);
+                return (NULL);
         }
+        copy->tessellation = NULL;
+        copy->next = NULL;
 #if DEBUG
         DXF_DEBUG_END
 #endif
-        return (dxf_circle);
+        return (copy);
 }
 
 
@@ -423,11 +389,15 @@ dxf_circle_write
                   dxf_entity_name );
                 dxf_circle->layer = strdup (DXF_DEFAULT_LAYER);
         }
+        if (fp->write_version.acad_version_number != fp->acad_version_number)
+        {
+                dxf_write_version_init (fp);
+        }
         /* Start writing output. */
-        fprintf (fp->fp, "  0\n%s\n", dxf_entity_name);
+        dxf_write_group_string (fp, 0, dxf_entity_name);
         if (dxf_circle->id_code != -1)
         {
-                fprintf (fp->fp, "  5\n%x\n", dxf_circle->id_code);
+                dxf_write_group_hex (fp, 5, dxf_circle->id_code);
         }
         /*!
          * \todo for version R14.\n
@@ -440,70 +410,70 @@ dxf_circle_write
          * End of group, "}" (optional), with Group code 102.
          */
         if ((strcmp (dxf_circle->dictionary_owner_soft, "") != 0)
-          && (fp->acad_version_number >= AutoCAD_14))
+          && fp->write_version.since_r14)
         {
-                fprintf (fp->fp, "102\n{ACAD_REACTORS\n");
-                fprintf (fp->fp, "330\n%s\n", dxf_circle->dictionary_owner_soft);
-                fprintf (fp->fp, "102\n}\n");
+                dxf_write_group_string (fp, 102, "{ACAD_REACTORS");
+                dxf_write_group_string (fp, 330, dxf_circle->dictionary_owner_soft);
+                dxf_write_group_string (fp, 102, "}");
         }
         if ((strcmp (dxf_circle->dictionary_owner_hard, "") != 0)
-          && (fp->acad_version_number >= AutoCAD_14))
+          && fp->write_version.since_r14)
         {
-                fprintf (fp->fp, "102\n{ACAD_XDICTIONARY\n");
-                fprintf (fp->fp, "360\n%s\n", dxf_circle->dictionary_owner_hard);
-                fprintf (fp->fp, "102\n}\n");
+                dxf_write_group_string (fp, 102, "{ACAD_XDICTIONARY");
+                dxf_write_group_string (fp, 360, dxf_circle->dictionary_owner_hard);
+                dxf_write_group_string (fp, 102, "}");
         }
-        if (fp->acad_version_number >= AutoCAD_13)
+        if (fp->write_version.since_r13)
         {
-                fprintf (fp->fp, "100\nAcDbEntity\n");
+                dxf_write_group_string (fp, 100, "AcDbEntity");
         }
         if (dxf_circle->paperspace == DXF_PAPERSPACE)
         {
-                fprintf (fp->fp, " 67\n%d\n", DXF_PAPERSPACE);
+                dxf_write_group_int (fp, 67, DXF_PAPERSPACE);
         }
-        fprintf (fp->fp, "  8\n%s\n", dxf_circle->layer);
+        dxf_write_group_string (fp, 8, dxf_circle->layer);
         if (strcmp (dxf_circle->linetype, DXF_DEFAULT_LINETYPE) != 0)
         {
-                fprintf (fp->fp, "  6\n%s\n", dxf_circle->linetype);
+                dxf_write_group_string (fp, 6, dxf_circle->linetype);
         }
         if (dxf_circle->color != DXF_COLOR_BYLAYER)
         {
-                fprintf (fp->fp, " 62\n%d\n", dxf_circle->color);
+                dxf_write_group_int (fp, 62, dxf_circle->color);
         }
         if (dxf_circle->linetype_scale != 1.0)
         {
-                fprintf (fp->fp, " 48\n%f\n", dxf_circle->linetype_scale);
+                dxf_write_group_double (fp, 48, dxf_circle->linetype_scale);
         }
         if (dxf_circle->visibility != 0)
         {
-                fprintf (fp->fp, " 60\n%d\n", dxf_circle->visibility);
+                dxf_write_group_int (fp, 60, dxf_circle->visibility);
         }
-        if (fp->acad_version_number >= AutoCAD_13)
+        if (fp->write_version.since_r13)
         {
-                fprintf (fp->fp, "100\nAcDbCircle\n");
+                dxf_write_group_string (fp, 100, "AcDbCircle");
         }
-        if ((fp->acad_version_number <= AutoCAD_11)
+        if (fp->write_version.until_r11
           && DXF_FLATLAND
           && (dxf_circle->elevation != 0.0))
         {
-                fprintf (fp->fp, " 38\n%f\n", dxf_circle->elevation);
+                dxf_write_group_double (fp, 38, dxf_circle->elevation);
         }
         if (dxf_circle->thickness != 0.0)
         {
-                fprintf (fp->fp, " 39\n%f\n", dxf_circle->thickness);
+                dxf_write_group_double (fp, 39, dxf_circle->thickness);
         }
-        fprintf (fp->fp, " 10\n%f\n", dxf_circle->x0);
-        fprintf (fp->fp, " 20\n%f\n", dxf_circle->y0);
-        fprintf (fp->fp, " 30\n%f\n", dxf_circle->z0);
-        fprintf (fp->fp, " 40\n%f\n", dxf_circle->radius);
-        if ((fp->acad_version_number >= AutoCAD_12)
+        dxf_write_group_double (fp, 10, dxf_circle->x0);
+        dxf_write_group_double (fp, 20, dxf_circle->y0);
+        dxf_write_group_double (fp, 30, dxf_circle->z0);
+        dxf_write_group_double (fp, 40, dxf_circle->radius);
+        if (fp->write_version.since_r12
                 && (dxf_circle->extr_x0 != 0.0)
                 && (dxf_circle->extr_y0 != 0.0)
                 && (dxf_circle->extr_z0 != 1.0))
         {
-                fprintf (fp->fp, "210\n%f\n", dxf_circle->extr_x0);
-                fprintf (fp->fp, "220\n%f\n", dxf_circle->extr_y0);
-                fprintf (fp->fp, "230\n%f\n", dxf_circle->extr_z0);
+                dxf_write_group_double (fp, 210, dxf_circle->extr_x0);
+                dxf_write_group_double (fp, 220, dxf_circle->extr_y0);
+                dxf_write_group_double (fp, 230, dxf_circle->extr_z0);
         }
 #if DEBUG
         DXF_DEBUG_END
@@ -512,6 +482,198 @@ dxf_circle_write
 }
 
 
+/*!
+ * \brief Compute the number of segments needed to approximate a
+ * circular sweep within a chordal tolerance.
+ *
+ * \return the number of segments, at least \c 1.
+ */
+static int
+dxf_circle_tessellation_segments
+(
+        double radius,
+                /*!< the radius. */
+        double sweep,
+                /*!< the swept angle in radians. */
+        double tolerance
+                /*!< the maximum allowed chord deviation. */
+)
+{
+        double max_angle;
+        int segments;
+
+        if (tolerance > radius)
+        {
+                tolerance = radius;
+        }
+        max_angle = 2.0 * acos (1.0 - tolerance / radius);
+        segments = (int) ceil (sweep / max_angle);
+        if (segments < 1)
+        {
+                segments = 1;
+        }
+        return (segments);
+}
+
+
+/*!
+ * \brief Tessellate a DXF \c CIRCLE entity into vertices within a
+ * chordal tolerance.
+ *
+ * The vertices are computed once per tolerance and cached on the
+ * entity, so repeated renders at the same zoom level reuse them
+ * instead of redoing the trigonometry; the cache is recomputed when
+ * the tolerance or the geometry changed and is released by
+ * \c dxf_circle_tessellation_invalidate or \c dxf_circle_free.\n
+ * The returned arrays are owned by the entity and hold \c *length
+ * vertices in the entity OCS plane, with the last vertex repeating
+ * the first so the contour is closed exactly.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_circle_tessellate
+(
+        DxfCircle *dxf_circle,
+                /*!< DXF circle entity. */
+        double tolerance,
+                /*!< the maximum allowed chord deviation. */
+        int *length,
+                /*!< returns the number of vertices. */
+        const double **x,
+                /*!< returns the X-values of the vertices. */
+        const double **y
+                /*!< returns the Y-values of the vertices. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        DxfTessellationCache *cache;
+        double angle;
+        int segments;
+        int i;
+
+        /* Do some basic checks. */
+        if ((dxf_circle == NULL) || (length == NULL) || (x == NULL)
+                || (y == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if ((tolerance <= 0.0) || (dxf_circle->radius <= 0.0))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () an invalid tolerance or radius was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        cache = dxf_circle->tessellation;
+        if ((cache != NULL)
+                && (cache->tolerance == tolerance)
+                && (cache->x0 == dxf_circle->x0)
+                && (cache->y0 == dxf_circle->y0)
+                && (cache->radius == dxf_circle->radius))
+        {
+                *length = cache->length;
+                *x = cache->x;
+                *y = cache->y;
+#if DEBUG
+                DXF_DEBUG_END
+#endif
+                return (EXIT_SUCCESS);
+        }
+        dxf_circle_tessellation_invalidate (dxf_circle);
+        segments = dxf_circle_tessellation_segments (dxf_circle->radius,
+                2.0 * M_PI, tolerance);
+        if (segments < 8)
+        {
+                segments = 8;
+        }
+        cache = calloc (1, sizeof (DxfTessellationCache));
+        if (cache == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        cache->x = malloc ((segments + 1) * sizeof (double));
+        cache->y = malloc ((segments + 1) * sizeof (double));
+        if ((cache->x == NULL) || (cache->y == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                free (cache->x);
+                free (cache->y);
+                free (cache);
+                return (EXIT_FAILURE);
+        }
+        for (i = 0; i < segments; i++)
+        {
+                angle = (2.0 * M_PI * i) / segments;
+                cache->x[i] = dxf_circle->x0 + dxf_circle->radius * cos (angle);
+                cache->y[i] = dxf_circle->y0 + dxf_circle->radius * sin (angle);
+        }
+        cache->x[segments] = cache->x[0];
+        cache->y[segments] = cache->y[0];
+        cache->tolerance = tolerance;
+        cache->x0 = dxf_circle->x0;
+        cache->y0 = dxf_circle->y0;
+        cache->radius = dxf_circle->radius;
+        cache->start_angle = 0.0;
+        cache->end_angle = 360.0;
+        cache->length = segments + 1;
+        dxf_circle->tessellation = cache;
+        *length = cache->length;
+        *x = cache->x;
+        *y = cache->y;
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Release the cached tessellation of a DXF \c CIRCLE entity.
+ *
+ * To be called after modifying the geometry members of the entity;
+ * the next \c dxf_circle_tessellate call recomputes the vertices.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_circle_tessellation_invalidate
+(
+        DxfCircle *dxf_circle
+                /*!< DXF circle entity. */
+)
+{
+        /* Do some basic checks. */
+        if (dxf_circle == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (dxf_circle->tessellation != NULL)
+        {
+                free (dxf_circle->tessellation->x);
+                free (dxf_circle->tessellation->y);
+                free (dxf_circle->tessellation);
+                dxf_circle->tessellation = NULL;
+        }
+        return (EXIT_SUCCESS);
+}
+
+
 /*!
  * \brief Free the allocated memory for a DXF \c CIRCLE and all it's
  * data fields.
@@ -545,7 +707,8 @@ dxf_circle_free
         free (dxf_circle->layer);
         free (dxf_circle->dictionary_owner_soft);
         free (dxf_circle->dictionary_owner_hard);
-        free (dxf_circle);
+        dxf_circle_tessellation_invalidate (dxf_circle);
+        dxf_entity_dealloc (dxf_circle, sizeof (*dxf_circle));
         dxf_circle = NULL;
 #if DEBUG
         DXF_DEBUG_END
@@ -120,6 +120,9 @@ dxf_circle
                 /*!< Z-value of the extrusion vector.\n
                  * Defaults to 1.0 if ommitted in the DXF file.\n
                  * Group code = 230. */
+        DxfTessellationCache *tessellation;
+                /*!< cached tessellation vertices (see
+                 * \c dxf_circle_tessellate), or \c NULL. */
         struct DxfCircle *next;
                 /*!< pointer to the next DxfCircle.\n
                  * \c NULL in the last DxfCircle. */
@@ -137,11 +140,30 @@ dxf_circle_read
         DxfFile *fp,
         DxfCircle *dxf_circle
 );
+struct dxf_arena;
+DxfCircle *
+dxf_circle_dup
+(
+        DxfCircle *dxf_circle,
+        struct dxf_arena *arena
+);
 int dxf_circle_write
 (
         DxfFile *fp,
         DxfCircle *dxf_circle
 );
+int dxf_circle_tessellate
+(
+        DxfCircle *dxf_circle,
+        double tolerance,
+        int *length,
+        const double **x,
+        const double **y
+);
+int dxf_circle_tessellation_invalidate
+(
+        DxfCircle *dxf_circle
+);
 int dxf_circle_free
 (
         DxfCircle *dxf_circle
@@ -34,7 +34,11 @@
  */
 
 
+#include <pthread.h>
 #include "class.h"
+#include "diag.h"
+#include "allocator.h"
+#include "util.h"
 
 
 /*!
@@ -54,7 +58,7 @@ dxf_class_new ()
         size = sizeof (DxfClass);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_class = malloc (size)) == NULL)
+        if ((dxf_class = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfClass struct.\n")),
@@ -89,6 +93,11 @@ dxf_class_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfClass template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         /* Do some basic checks. */
         if (dxf_class == NULL)
         {
@@ -104,14 +113,25 @@ dxf_class_init
                 __FUNCTION__);
               return (NULL);
         }
-        dxf_class->record_type = strdup ("");
-        dxf_class->record_name = strdup ("");
-        dxf_class->class_name = strdup ("");
-        dxf_class->app_name = strdup ("");
-        dxf_class->proxy_cap_flag = 0;
-        dxf_class->was_a_proxy_flag = 0;
-        dxf_class->is_an_entity_flag = 0;
-        dxf_class->next = NULL;
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.record_type = strdup ("");
+                template.record_name = strdup ("");
+                template.class_name = strdup ("");
+                template.app_name = strdup ("");
+                template.proxy_cap_flag = 0;
+                template.was_a_proxy_flag = 0;
+                template.is_an_entity_flag = 0;
+                template.next = NULL;
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (dxf_class, &template, sizeof (DxfClass));
+        dxf_class->record_type = strdup (template.record_type);
+        dxf_class->record_name = strdup (template.record_name);
+        dxf_class->class_name = strdup (template.class_name);
+        dxf_class->app_name = strdup (template.app_name);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -142,7 +162,7 @@ dxf_class_read
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        char *temp_string = NULL;
+        char temp_string[DXF_MAX_STRING_LENGTH];
 
         /* Do some basic checks. */
         if (fp == NULL)
@@ -167,7 +187,7 @@ dxf_class_read
                 if (ferror (fp->fp))
                 {
                         fprintf (stderr,
-                          (_("Error in %s () while reading from: %s in line: %d.\n")),
+                          (_("Error in %s () while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                         fclose (fp->fp);
                         return (NULL);
@@ -182,28 +202,36 @@ dxf_class_read
                          * read. See the while condition above.
                          */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_class->record_type);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_class->record_type);
+                        dxf_class->record_type = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "1") == 0)
                 {
                         /* Now follows a string containing a record
                          * name. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_class->record_name);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_class->record_name);
+                        dxf_class->record_name = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "2") == 0)
                 {
                         /* Now follows a string containing a class name.
                          */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_class->class_name);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_class->class_name);
+                        dxf_class->class_name = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "3") == 0)
                 {
                         /* Now follows a string containing the
                          * application name. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_class->app_name);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_class->app_name);
+                        dxf_class->app_name = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "90") == 0)
                 {
@@ -235,8 +263,8 @@ dxf_class_read
                 }
                 else
                 {
-                        fprintf (stderr,
-                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %d.\n")),
+                        dxf_diag_report (fp, DXF_DIAG_WARNING,
+                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                 }
         }
@@ -244,7 +272,7 @@ dxf_class_read
         if (strcmp (dxf_class->record_type, "") == 0)
         {
                 fprintf (stderr,
-                  (_("Error in %s () empty record type string after reading from: %s before line: %d.\n")),
+                  (_("Error in %s () empty record type string after reading from: %s before line: %ld.\n")),
                   __FUNCTION__, fp->filename, fp->line_number);
                 return (NULL);
 
@@ -252,14 +280,14 @@ dxf_class_read
         if (strcmp (dxf_class->record_name, "") == 0)
         {
                 fprintf (stderr,
-                  (_("Error in %s () empty record name string after reading from: %s before line: %d.\n")),
+                  (_("Error in %s () empty record name string after reading from: %s before line: %ld.\n")),
                   __FUNCTION__, fp->filename, fp->line_number);
                 return (NULL);
         }
         if (strcmp (dxf_class->class_name, "") == 0)
         {
                 fprintf (stderr,
-                  (_("Error in %s () empty class name string after reading from: %s before line: %d.\n")),
+                  (_("Error in %s () empty class name string after reading from: %s before line: %ld.\n")),
                   __FUNCTION__, fp->filename, fp->line_number);
                 return (NULL);
         }
@@ -270,6 +298,339 @@ dxf_class_read
 }
 
 
+/*!
+ * \brief One entry of the \c CLASSES section cache: the raw section
+ * bytes it was parsed from and the shared parsed list.
+ *
+ * Across a corpus of files produced by the same authoring tool the
+ * \c CLASSES section is byte for byte identical, so the parsed list is
+ * kept keyed by a hash of the section bytes and shared between all
+ * files carrying the same section, instead of being parsed and
+ * allocated again for every file.
+ */
+typedef struct
+dxf_class_cache_entry
+{
+        unsigned int hash;
+                /*!< FNV-1a hash of the section bytes. */
+        char *text;
+                /*!< the section bytes, for an exact match on lookup. */
+        size_t length;
+                /*!< number of section bytes. */
+        DxfClass *classes;
+                /*!< the shared parsed list, owned by the cache. */
+        struct dxf_class_cache_entry *next;
+                /*!< pointer to the next entry, \c NULL in the last. */
+} DxfClassCacheEntry;
+
+
+/*!
+ * The \c CLASSES section cache; a handful of distinct sections cover
+ * whole corpora, so a linked list is searched.
+ */
+static DxfClassCacheEntry *dxf_class_cache = NULL;
+
+
+/*!
+ * \brief Parse the buffered bytes of a \c CLASSES section into a list
+ * of \c CLASS entities.
+ *
+ * \return a pointer to the first \c CLASS of the list, or \c NULL
+ * when the section contains none.
+ */
+static DxfClass *
+dxf_class_parse_text
+(
+        const char *text
+                /*!< the section bytes, one group code or value per
+                 * line. */
+)
+{
+        DxfClass *head = NULL;
+        DxfClass *tail = NULL;
+        DxfClass *dxf_class = NULL;
+        const char *at;
+        const char *end;
+        char code[DXF_MAX_STRING_LENGTH];
+        char value[DXF_MAX_STRING_LENGTH];
+        size_t length;
+
+        at = text;
+        while (*at != '\0')
+        {
+                /* Slice the group code line and its value line. */
+                end = strchr (at, '\n');
+                if (end == NULL)
+                {
+                        break;
+                }
+                length = (size_t) (end - at);
+                if (length >= DXF_MAX_STRING_LENGTH)
+                {
+                        length = DXF_MAX_STRING_LENGTH - 1;
+                }
+                memcpy (code, at, length);
+                code[length] = '\0';
+                at = end + 1;
+                end = strchr (at, '\n');
+                if (end == NULL)
+                {
+                        break;
+                }
+                length = (size_t) (end - at);
+                if (length >= DXF_MAX_STRING_LENGTH)
+                {
+                        length = DXF_MAX_STRING_LENGTH - 1;
+                }
+                memcpy (value, at, length);
+                value[length] = '\0';
+                at = end + 1;
+                if (strcmp (code, "0") == 0)
+                {
+                        dxf_class = dxf_class_new ();
+                        dxf_class = dxf_class_init (dxf_class);
+                        if (dxf_class == NULL)
+                        {
+                                return (head);
+                        }
+                        free (dxf_class->record_type);
+                        dxf_class->record_type = strdup (value);
+                        if (head == NULL)
+                        {
+                                head = dxf_class;
+                        }
+                        else
+                        {
+                                tail->next = (struct DxfClass *) dxf_class;
+                        }
+                        tail = dxf_class;
+                }
+                else if (dxf_class == NULL)
+                {
+                        /* value lines before the first record. */
+                }
+                else if (strcmp (code, "1") == 0)
+                {
+                        free (dxf_class->record_name);
+                        dxf_class->record_name = strdup (value);
+                }
+                else if (strcmp (code, "2") == 0)
+                {
+                        free (dxf_class->class_name);
+                        dxf_class->class_name = strdup (value);
+                }
+                else if (strcmp (code, "3") == 0)
+                {
+                        free (dxf_class->app_name);
+                        dxf_class->app_name = strdup (value);
+                }
+                else if (strcmp (code, "90") == 0)
+                {
+                        dxf_class->proxy_cap_flag = atoi (value);
+                }
+                else if (strcmp (code, "280") == 0)
+                {
+                        dxf_class->was_a_proxy_flag = atoi (value);
+                }
+                else if (strcmp (code, "281") == 0)
+                {
+                        dxf_class->is_an_entity_flag = atoi (value);
+                }
+        }
+        return (head);
+}
+
+
+/*!
+ * \brief Read a whole \c CLASSES section from a DXF file through the
+ * section cache.
+ *
+ * The last line read from file contained the string "CLASSES".\n
+ * The section bytes up to the \c ENDSEC marker are buffered and
+ * hashed; a section seen before yields the parsed list of a previous
+ * file without parsing or allocating anything, a new section is parsed
+ * once and remembered.
+ *
+ * \return a pointer to the first \c CLASS of the shared list, owned
+ * by the cache (see \c dxf_class_cache_free), or \c NULL when the
+ * section contains none or errors occurred.
+ */
+DxfClass *
+dxf_class_section_read
+(
+        DxfFile *fp
+                /*!< DXF file pointer to an input file (or device). */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        DxfClassCacheEntry *entry;
+        char *text;
+        char *grown;
+        char *line;
+        char *value;
+        size_t used = 0;
+        size_t size = 256;
+        size_t length;
+        size_t mark;
+        int ends_record;
+        unsigned int hash;
+
+        /* Do some basic checks. */
+        if (fp == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL file pointer was passed.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        text = malloc (size);
+        if (text == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        /* Buffer the section bytes, a group code and its value line per
+         * turn, until the ENDSEC marker.  The group code line is
+         * committed before its value line is read, because both point
+         * into the same line buffer of the file. */
+        for (;;)
+        {
+                line = dxf_read_line_grow (fp);
+                if (line == NULL)
+                {
+                        fprintf (stderr,
+                          (_("Error in %s () while reading from: %s in line: %ld.\n")),
+                          __FUNCTION__, fp->filename, fp->line_number);
+                        free (text);
+                        return (NULL);
+                }
+                ends_record = (strcmp (line, "0") == 0);
+                mark = used;
+                length = strlen (line) + 1;
+                while ((used + length + 1) > size)
+                {
+                        size *= 2;
+                        grown = realloc (text, size);
+                        if (grown == NULL)
+                        {
+                                fprintf (stderr,
+                                  (_("Error in %s () could not allocate memory.\n")),
+                                  __FUNCTION__);
+                                free (text);
+                                return (NULL);
+                        }
+                        text = grown;
+                }
+                used += sprintf (text + used, "%s\n", line);
+                value = dxf_read_value_line_grow (fp);
+                if (value == NULL)
+                {
+                        fprintf (stderr,
+                          (_("Error in %s () while reading from: %s in line: %ld.\n")),
+                          __FUNCTION__, fp->filename, fp->line_number);
+                        free (text);
+                        return (NULL);
+                }
+                if (ends_record && (strcmp (value, "ENDSEC") == 0))
+                {
+                        /* drop the buffered "0" of the marker. */
+                        used = mark;
+                        break;
+                }
+                length = strlen (value) + 1;
+                while ((used + length + 1) > size)
+                {
+                        size *= 2;
+                        grown = realloc (text, size);
+                        if (grown == NULL)
+                        {
+                                fprintf (stderr,
+                                  (_("Error in %s () could not allocate memory.\n")),
+                                  __FUNCTION__);
+                                free (text);
+                                return (NULL);
+                        }
+                        text = grown;
+                }
+                used += sprintf (text + used, "%s\n", value);
+        }
+        text[used] = '\0';
+        /* FNV-1a. */
+        hash = 2166136261u;
+        for (length = 0; length < used; length++)
+        {
+                hash ^= (unsigned char) text[length];
+                hash *= 16777619u;
+        }
+        for (entry = dxf_class_cache; entry != NULL; entry = entry->next)
+        {
+                if ((entry->hash == hash)
+                  && (entry->length == used)
+                  && (memcmp (entry->text, text, used) == 0))
+                {
+                        /* The same section was parsed before: share the
+                         * parsed representation. */
+                        free (text);
+#if DEBUG
+                        DXF_DEBUG_END
+#endif
+                        return (entry->classes);
+                }
+        }
+        entry = malloc (sizeof (DxfClassCacheEntry));
+        if (entry == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                free (text);
+                return (NULL);
+        }
+        entry->hash = hash;
+        entry->text = text;
+        entry->length = used;
+        entry->classes = dxf_class_parse_text (text);
+        entry->next = dxf_class_cache;
+        dxf_class_cache = entry;
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (entry->classes);
+}
+
+
+/*!
+ * \brief Free the \c CLASSES section cache and the parsed lists it
+ * owns.
+ */
+void
+dxf_class_cache_free ()
+{
+        DxfClassCacheEntry *entry;
+        DxfClassCacheEntry *next_entry;
+        DxfClass *dxf_class;
+        DxfClass *next_class;
+
+        for (entry = dxf_class_cache; entry != NULL; entry = next_entry)
+        {
+                next_entry = entry->next;
+                for (dxf_class = entry->classes; dxf_class != NULL; dxf_class = next_class)
+                {
+                        next_class = (DxfClass *) dxf_class->next;
+                        dxf_class->next = NULL;
+                        dxf_class_free (dxf_class);
+                }
+                free (entry->text);
+                free (entry);
+        }
+        dxf_class_cache = NULL;
+}
+
+
 /*!
  * \brief Write DXF output to a file for a DXF \c CLASS entity.
  */
@@ -412,7 +773,7 @@ dxf_class_free
         free (dxf_class->record_name);
         free (dxf_class->class_name);
         free (dxf_class->app_name);
-        free (dxf_class);
+        dxf_entity_dealloc (dxf_class, sizeof (*dxf_class));
         dxf_class = NULL;
 #if DEBUG
         DXF_DEBUG_END
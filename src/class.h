@@ -123,6 +123,11 @@ dxf_class_read
         DxfFile *fp,
         DxfClass *dxf_class
 );
+DxfClass *
+dxf_class_section_read
+(
+        DxfFile *fp
+);
 int
 dxf_class_write
 (
@@ -139,6 +144,8 @@ dxf_class_free
 (
         DxfClass *dxf_class
 );
+void
+dxf_class_cache_free ();
 
 
 #endif /* LIBDXF_SRC_CLASS_H */
@@ -32,6 +32,7 @@
 
 
 #include "color.h"
+#include "allocator.h"
 
 
 /*!
@@ -51,7 +52,7 @@ dxf_RGB_color_new ()
         size = sizeof (DxfRGBColor);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_RGB_color = malloc (size)) == NULL)
+        if ((dxf_RGB_color = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfRGBCcolor struct.\n")),
@@ -145,12 +146,282 @@ dxf_RGB_color_set
 }
 
 
+/*!
+ * The AutoCAD Color Index (ACI) palette.
+ *
+ * These colors are defined by red value, green value, blue value and
+ * contain no alpha value (see also http://www.isctex.com/acadcolors.php).\n
+ * Colors whose triplet appears in Wikipedia's List of colors carry
+ * that name, all others carry \c NULL.
+ */
+static const DxfRGBColor dxf_ACI_colors[DXF_COLOR_INDEX_MAX_NUMBER_OF_COLORS] =
+{
+        {0, 0, 0, 0, "Black"},
+        {255, 0, 0, 0, "Red"},
+        {255, 255, 0, 0, "Yellow"},
+        {0, 255, 0, 0, "Green (color wheel) (X11 green)"},
+        {0, 255, 255, 0, "Cyan"},
+        {0, 0, 255, 0, "Blue"},
+        {255, 0, 255, 0, "Magenta"},
+        {255, 255, 255, 0, "White"},
+        {128, 128, 128, 0, "Gray"},
+        {192, 192, 192, 0, "Silver"},
+        {255, 0, 0, 0, "Red"},
+        {255, 127, 127, 0, NULL},
+        {204, 0, 0, 0, NULL},
+        {204, 102, 102, 0, NULL},
+        {153, 0, 0, 0, NULL},
+        {153, 76, 76, 0, NULL},
+        {127, 0, 0, 0, NULL},
+        {127, 63, 63, 0, NULL},
+        {76, 0, 0, 0, NULL},
+        {76, 38, 38, 0, NULL},
+        {255, 63, 0, 0, NULL},
+        {255, 159, 127, 0, NULL},
+        {204, 51, 0, 0, NULL},
+        {204, 127, 102, 0, NULL},
+        {153, 38, 0, 0, NULL},
+        {153, 95, 76, 0, NULL},
+        {127, 31, 0, 0, NULL},
+        {127, 79, 63, 0, NULL},
+        {76, 19, 0, 0, NULL},
+        {76, 47, 38, 0, NULL},
+        {255, 127, 0, 0, "Orange (color wheel)"},
+        {255, 191, 127, 0, NULL},
+        {204, 102, 0, 0, NULL},
+        {204, 153, 102, 0, NULL},
+        {153, 76, 0, 0, NULL},
+        {153, 114, 76, 0, NULL},
+        {127, 63, 0, 0, NULL},
+        {127, 95, 63, 0, NULL},
+        {76, 38, 0, 0, NULL},
+        {76, 57, 38, 0, NULL},
+        {255, 191, 0, 0, "Amber"},
+        {255, 223, 127, 0, NULL},
+        {204, 153, 0, 0, NULL},
+        {204, 178, 102, 0, NULL},
+        {153, 114, 0, 0, NULL},
+        {153, 133, 76, 0, NULL},
+        {127, 95, 0, 0, NULL},
+        {127, 111, 63, 0, NULL},
+        {76, 57, 0, 0, NULL},
+        {76, 66, 38, 0, NULL},
+        {255, 255, 0, 0, "Yellow"},
+        {255, 255, 127, 0, NULL},
+        {204, 204, 0, 0, NULL},
+        {204, 204, 102, 0, NULL},
+        {153, 153, 0, 0, NULL},
+        {153, 153, 76, 0, NULL},
+        {127, 127, 0, 0, NULL},
+        {127, 127, 63, 0, NULL},
+        {76, 76, 0, 0, NULL},
+        {76, 76, 38, 0, NULL},
+        {191, 255, 0, 0, "Lime (color wheel)"},
+        {223, 255, 127, 0, NULL},
+        {153, 204, 0, 0, NULL},
+        {178, 204, 102, 0, NULL},
+        {114, 153, 0, 0, NULL},
+        {133, 153, 76, 0, NULL},
+        {95, 127, 0, 0, NULL},
+        {111, 127, 63, 0, NULL},
+        {57, 76, 0, 0, NULL},
+        {66, 76, 38, 0, NULL},
+        {127, 255, 0, 0, "Chartreuse (web)"},
+        {191, 255, 127, 0, NULL},
+        {102, 204, 0, 0, NULL},
+        {153, 204, 102, 0, NULL},
+        {76, 153, 0, 0, NULL},
+        {114, 153, 76, 0, NULL},
+        {63, 127, 0, 0, NULL},
+        {95, 127, 63, 0, NULL},
+        {38, 76, 0, 0, NULL},
+        {57, 76, 38, 0, NULL},
+        {63, 255, 0, 0, "Harlequin"},
+        {159, 255, 127, 0, NULL},
+        {51, 204, 0, 0, NULL},
+        {127, 204, 102, 0, NULL},
+        {38, 153, 0, 0, NULL},
+        {95, 153, 76, 0, NULL},
+        {31, 127, 0, 0, NULL},
+        {79, 127, 63, 0, NULL},
+        {19, 76, 0, 0, NULL},
+        {47, 76, 38, 0, NULL},
+        {0, 255, 0, 0, "Green (color wheel) (X11 green)"},
+        {127, 255, 127, 0, NULL},
+        {0, 204, 0, 0, NULL},
+        {102, 204, 102, 0, NULL},
+        {0, 153, 0, 0, NULL},
+        {76, 153, 76, 0, NULL},
+        {0, 127, 0, 0, NULL},
+        {63, 127, 63, 0, NULL},
+        {0, 76, 0, 0, NULL},
+        {38, 76, 38, 0, NULL},
+        {0, 255, 63, 0, NULL},
+        {127, 255, 159, 0, NULL},
+        {0, 204, 51, 0, NULL},
+        {102, 204, 127, 0, NULL},
+        {0, 153, 38, 0, NULL},
+        {76, 153, 95, 0, NULL},
+        {0, 127, 31, 0, NULL},
+        {63, 127, 79, 0, NULL},
+        {0, 76, 19, 0, NULL},
+        {38, 76, 47, 0, NULL},
+        {0, 255, 127, 0, "Spring green"},
+        {127, 255, 191, 0, NULL},
+        {0, 204, 102, 0, NULL},
+        {102, 204, 153, 0, NULL},
+        {0, 153, 76, 0, NULL},
+        {76, 153, 114, 0, NULL},
+        {0, 127, 63, 0, NULL},
+        {63, 127, 95, 0, NULL},
+        {0, 76, 38, 0, NULL},
+        {38, 76, 57, 0, NULL},
+        {0, 255, 191, 0, NULL},
+        {127, 255, 223, 0, NULL},
+        {0, 204, 153, 0, NULL},
+        {102, 204, 178, 0, NULL},
+        {0, 153, 114, 0, NULL},
+        {76, 153, 133, 0, NULL},
+        {0, 127, 95, 0, NULL},
+        {63, 127, 111, 0, NULL},
+        {0, 76, 57, 0, NULL},
+        {38, 76, 66, 0, NULL},
+        {0, 255, 255, 0, "Cyan"},
+        {127, 255, 255, 0, NULL},
+        {0, 204, 204, 0, "Robin egg blue"},
+        {102, 204, 204, 0, NULL},
+        {0, 153, 153, 0, NULL},
+        {76, 153, 153, 0, NULL},
+        {0, 127, 127, 0, NULL},
+        {63, 127, 127, 0, NULL},
+        {0, 76, 76, 0, NULL},
+        {38, 76, 76, 0, NULL},
+        {0, 191, 255, 0, NULL},
+        {127, 223, 255, 0, NULL},
+        {0, 153, 204, 0, NULL},
+        {102, 178, 204, 0, NULL},
+        {0, 114, 153, 0, NULL},
+        {76, 133, 153, 0, NULL},
+        {0, 95, 127, 0, NULL},
+        {63, 111, 127, 0, NULL},
+        {0, 57, 76, 0, NULL},
+        {38, 66, 76, 0, NULL},
+        {0, 127, 255, 0, "Azure (color wheel)"},
+        {127, 191, 255, 0, NULL},
+        {0, 102, 204, 0, NULL},
+        {102, 153, 204, 0, NULL},
+        {0, 76, 153, 0, NULL},
+        {76, 114, 153, 0, NULL},
+        {0, 63, 127, 0, NULL},
+        {63, 95, 127, 0, NULL},
+        {0, 38, 76, 0, NULL},
+        {38, 57, 76, 0, NULL},
+        {0, 63, 255, 0, NULL},
+        {127, 159, 255, 0, NULL},
+        {0, 51, 204, 0, NULL},
+        {102, 127, 204, 0, NULL},
+        {0, 38, 153, 0, NULL},
+        {76, 95, 153, 0, NULL},
+        {0, 31, 127, 0, NULL},
+        {63, 79, 127, 0, NULL},
+        {0, 19, 76, 0, NULL},
+        {38, 47, 76, 0, NULL},
+        {0, 0, 255, 0, "Blue"},
+        {170, 170, 255, 0, NULL},
+        {0, 0, 189, 0, NULL},
+        {126, 126, 189, 0, NULL},
+        {0, 0, 129, 0, NULL},
+        {86, 86, 129, 0, NULL},
+        {0, 0, 104, 0, NULL},
+        {69, 69, 104, 0, NULL},
+        {0, 0, 79, 0, NULL},
+        {53, 53, 79, 0, NULL},
+        {63, 0, 255, 0, NULL},
+        {191, 170, 255, 0, NULL},
+        {46, 0, 189, 0, NULL},
+        {141, 126, 189, 0, NULL},
+        {31, 0, 129, 0, NULL},
+        {96, 86, 129, 0, NULL},
+        {25, 0, 104, 0, NULL},
+        {78, 69, 104, 0, NULL},
+        {19, 0, 79, 0, NULL},
+        {59, 53, 79, 0, NULL},
+        {127, 0, 255, 0, NULL},
+        {212, 170, 255, 0, NULL},
+        {94, 0, 189, 0, NULL},
+        {157, 126, 189, 0, NULL},
+        {64, 0, 129, 0, NULL},
+        {107, 86, 129, 0, NULL},
+        {52, 0, 104, 0, NULL},
+        {86, 69, 104, 0, NULL},
+        {39, 0, 79, 0, NULL},
+        {66, 53, 79, 0, NULL},
+        {191, 0, 255, 0, "Electric purple"},
+        {234, 170, 255, 0, NULL},
+        {141, 0, 189, 0, NULL},
+        {173, 126, 189, 0, NULL},
+        {96, 0, 129, 0, NULL},
+        {118, 86, 129, 0, NULL},
+        {78, 0, 104, 0, NULL},
+        {95, 69, 104, 0, NULL},
+        {59, 0, 79, 0, NULL},
+        {73, 53, 79, 0, NULL},
+        {255, 0, 255, 0, "Magenta"},
+        {255, 170, 255, 0, NULL},
+        {189, 0, 189, 0, NULL},
+        {189, 126, 189, 0, NULL},
+        {129, 0, 129, 0, NULL},
+        {129, 86, 129, 0, NULL},
+        {104, 0, 104, 0, NULL},
+        {104, 69, 104, 0, NULL},
+        {79, 0, 79, 0, NULL},
+        {79, 53, 79, 0, NULL},
+        {255, 0, 191, 0, NULL},
+        {255, 170, 234, 0, NULL},
+        {189, 0, 141, 0, NULL},
+        {189, 126, 173, 0, NULL},
+        {129, 0, 96, 0, NULL},
+        {129, 86, 118, 0, NULL},
+        {104, 0, 78, 0, NULL},
+        {104, 69, 95, 0, NULL},
+        {79, 0, 59, 0, NULL},
+        {79, 53, 73, 0, NULL},
+        {255, 0, 127, 0, "Rose"},
+        {255, 170, 212, 0, NULL},
+        {189, 0, 94, 0, NULL},
+        {189, 126, 157, 0, NULL},
+        {129, 0, 64, 0, NULL},
+        {129, 86, 107, 0, NULL},
+        {104, 0, 52, 0, NULL},
+        {104, 69, 86, 0, NULL},
+        {79, 0, 39, 0, NULL},
+        {79, 53, 66, 0, NULL},
+        {255, 0, 63, 0, NULL},
+        {255, 170, 191, 0, NULL},
+        {189, 0, 46, 0, NULL},
+        {189, 126, 141, 0, NULL},
+        {129, 0, 31, 0, NULL},
+        {129, 86, 96, 0, NULL},
+        {104, 0, 25, 0, NULL},
+        {104, 69, 78, 0, NULL},
+        {79, 0, 19, 0, NULL},
+        {79, 53, 59, 0, NULL},
+        {51, 51, 51, 0, NULL},
+        {80, 80, 80, 0, NULL},
+        {105, 105, 105, 0, NULL},
+        {130, 130, 130, 0, NULL},
+        {190, 190, 190, 0, NULL},
+        {255, 255, 255, 0, "White"},
+};
+
+
 /*!
  * \brief Initialise an array of colors according to the AutoCAD Color
  * Index (ACI).
  *
- * These colors are defined by red value, green value, blue value and
- * contain no alpha value (see also http://www.isctex.com/acadcolors.php).
+ * The passed array is pointed at the compile time palette above, so no
+ * memory is allocated; the entries are static and must not be passed
+ * to \c dxf_RGB_color_free.
  */
 int
 dxf_ACI_init
@@ -161,277 +432,19 @@ dxf_ACI_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        size_t size;
+        int i;
 
-        size = sizeof (DxfRGBColor);
-        /* avoid malloc of 0 bytes */
-        if (size == 0) size = 1;
-        if ((dxf_ACI = malloc (size * DXF_COLOR_INDEX_MAX_NUMBER_OF_COLORS)) == NULL)
+        /* Do some basic checks. */
+        if (dxf_ACI == NULL)
         {
                 fprintf (stderr,
-                  (_("Error in %s () could not allocate memory for a DxfRGBCcolor array.\n")),
+                  (_("Error in %s () a NULL pointer was passed.\n")),
                   __FUNCTION__);
-                dxf_ACI = NULL;
                 return (EXIT_FAILURE);
         }
-        else
+        for (i = 0; i < DXF_COLOR_INDEX_MAX_NUMBER_OF_COLORS; i++)
         {
-                dxf_ACI[0] = dxf_RGB_color_set (0,0,0);
-                dxf_ACI[1] = dxf_RGB_color_set (255,0,0);
-                dxf_ACI[2] = dxf_RGB_color_set (255,255,0);
-                dxf_ACI[3] = dxf_RGB_color_set (0,255,0);
-                dxf_ACI[4] = dxf_RGB_color_set (0,255,255);
-                dxf_ACI[5] = dxf_RGB_color_set (0,0,255);
-                dxf_ACI[6] = dxf_RGB_color_set (255,0,255);
-                dxf_ACI[7] = dxf_RGB_color_set (255,255,255);
-                dxf_ACI[8] = dxf_RGB_color_set (128,128,128);
-                dxf_ACI[9] = dxf_RGB_color_set (192,192,192);
-                dxf_ACI[10] = dxf_RGB_color_set (255,0,0);
-                dxf_ACI[11] = dxf_RGB_color_set (255,127,127);
-                dxf_ACI[12] = dxf_RGB_color_set (204,0,0);
-                dxf_ACI[13] = dxf_RGB_color_set (204,102,102);
-                dxf_ACI[14] = dxf_RGB_color_set (153,0,0);
-                dxf_ACI[15] = dxf_RGB_color_set (153,76,76);
-                dxf_ACI[16] = dxf_RGB_color_set (127,0,0);
-                dxf_ACI[17] = dxf_RGB_color_set (127,63,63);
-                dxf_ACI[18] = dxf_RGB_color_set (76,0,0);
-                dxf_ACI[19] = dxf_RGB_color_set (76,38,38);
-                dxf_ACI[20] = dxf_RGB_color_set (255,63,0);
-                dxf_ACI[21] = dxf_RGB_color_set (255,159,127);
-                dxf_ACI[22] = dxf_RGB_color_set (204,51,0);
-                dxf_ACI[23] = dxf_RGB_color_set (204,127,102);
-                dxf_ACI[24] = dxf_RGB_color_set (153,38,0);
-                dxf_ACI[25] = dxf_RGB_color_set (153,95,76);
-                dxf_ACI[26] = dxf_RGB_color_set (127,31,0);
-                dxf_ACI[27] = dxf_RGB_color_set (127,79,63);
-                dxf_ACI[28] = dxf_RGB_color_set (76,19,0);
-                dxf_ACI[29] = dxf_RGB_color_set (76,47,38);
-                dxf_ACI[30] = dxf_RGB_color_set (255,127,0);
-                dxf_ACI[31] = dxf_RGB_color_set (255,191,127);
-                dxf_ACI[32] = dxf_RGB_color_set (204,102,0);
-                dxf_ACI[33] = dxf_RGB_color_set (204,153,102);
-                dxf_ACI[34] = dxf_RGB_color_set (153,76,0);
-                dxf_ACI[35] = dxf_RGB_color_set (153,114,76);
-                dxf_ACI[36] = dxf_RGB_color_set (127,63,0);
-                dxf_ACI[37] = dxf_RGB_color_set (127,95,63);
-                dxf_ACI[38] = dxf_RGB_color_set (76,38,0);
-                dxf_ACI[39] = dxf_RGB_color_set (76,57,38);
-                dxf_ACI[40] = dxf_RGB_color_set (255,191,0);
-                dxf_ACI[41] = dxf_RGB_color_set (255,223,127);
-                dxf_ACI[42] = dxf_RGB_color_set (204,153,0);
-                dxf_ACI[43] = dxf_RGB_color_set (204,178,102);
-                dxf_ACI[44] = dxf_RGB_color_set (153,114,0);
-                dxf_ACI[45] = dxf_RGB_color_set (153,133,76);
-                dxf_ACI[46] = dxf_RGB_color_set (127,95,0);
-                dxf_ACI[47] = dxf_RGB_color_set (127,111,63);
-                dxf_ACI[48] = dxf_RGB_color_set (76,57,0);
-                dxf_ACI[49] = dxf_RGB_color_set (76,66,38);
-                dxf_ACI[50] = dxf_RGB_color_set (255,255,0);
-                dxf_ACI[51] = dxf_RGB_color_set (255,255,127);
-                dxf_ACI[52] = dxf_RGB_color_set (204,204,0);
-                dxf_ACI[53] = dxf_RGB_color_set (204,204,102);
-                dxf_ACI[54] = dxf_RGB_color_set (153,153,0);
-                dxf_ACI[55] = dxf_RGB_color_set (153,153,76);
-                dxf_ACI[56] = dxf_RGB_color_set (127,127,0);
-                dxf_ACI[57] = dxf_RGB_color_set (127,127,63);
-                dxf_ACI[58] = dxf_RGB_color_set (76,76,0);
-                dxf_ACI[59] = dxf_RGB_color_set (76,76,38);
-                dxf_ACI[60] = dxf_RGB_color_set (191,255,0);
-                dxf_ACI[61] = dxf_RGB_color_set (223,255,127);
-                dxf_ACI[62] = dxf_RGB_color_set (153,204,0);
-                dxf_ACI[63] = dxf_RGB_color_set (178,204,102);
-                dxf_ACI[64] = dxf_RGB_color_set (114,153,0);
-                dxf_ACI[65] = dxf_RGB_color_set (133,153,76);
-                dxf_ACI[66] = dxf_RGB_color_set (95,127,0);
-                dxf_ACI[67] = dxf_RGB_color_set (111,127,63);
-                dxf_ACI[68] = dxf_RGB_color_set (57,76,0);
-                dxf_ACI[69] = dxf_RGB_color_set (66,76,38);
-                dxf_ACI[70] = dxf_RGB_color_set (127,255,0);
-                dxf_ACI[71] = dxf_RGB_color_set (191,255,127);
-                dxf_ACI[72] = dxf_RGB_color_set (102,204,0);
-                dxf_ACI[73] = dxf_RGB_color_set (153,204,102);
-                dxf_ACI[74] = dxf_RGB_color_set (76,153,0);
-                dxf_ACI[75] = dxf_RGB_color_set (114,153,76);
-                dxf_ACI[76] = dxf_RGB_color_set (63,127,0);
-                dxf_ACI[77] = dxf_RGB_color_set (95,127,63);
-                dxf_ACI[78] = dxf_RGB_color_set (38,76,0);
-                dxf_ACI[79] = dxf_RGB_color_set (57,76,38);
-                dxf_ACI[80] = dxf_RGB_color_set (63,255,0);
-                dxf_ACI[81] = dxf_RGB_color_set (159,255,127);
-                dxf_ACI[82] = dxf_RGB_color_set (51,204,0);
-                dxf_ACI[83] = dxf_RGB_color_set (127,204,102);
-                dxf_ACI[84] = dxf_RGB_color_set (38,153,0);
-                dxf_ACI[85] = dxf_RGB_color_set (95,153,76);
-                dxf_ACI[86] = dxf_RGB_color_set (31,127,0);
-                dxf_ACI[87] = dxf_RGB_color_set (79,127,63);
-                dxf_ACI[88] = dxf_RGB_color_set (19,76,0);
-                dxf_ACI[89] = dxf_RGB_color_set (47,76,38);
-                dxf_ACI[90] = dxf_RGB_color_set (0,255,0);
-                dxf_ACI[91] = dxf_RGB_color_set (127,255,127);
-                dxf_ACI[92] = dxf_RGB_color_set (0,204,0);
-                dxf_ACI[93] = dxf_RGB_color_set (102,204,102);
-                dxf_ACI[94] = dxf_RGB_color_set (0,153,0);
-                dxf_ACI[95] = dxf_RGB_color_set (76,153,76);
-                dxf_ACI[96] = dxf_RGB_color_set (0,127,0);
-                dxf_ACI[97] = dxf_RGB_color_set (63,127,63);
-                dxf_ACI[98] = dxf_RGB_color_set (0,76,0);
-                dxf_ACI[99] = dxf_RGB_color_set (38,76,38);
-                dxf_ACI[100] = dxf_RGB_color_set (0,255,63);
-                dxf_ACI[101] = dxf_RGB_color_set (127,255,159);
-                dxf_ACI[102] = dxf_RGB_color_set (0,204,51);
-                dxf_ACI[103] = dxf_RGB_color_set (102,204,127);
-                dxf_ACI[104] = dxf_RGB_color_set (0,153,38);
-                dxf_ACI[105] = dxf_RGB_color_set (76,153,95);
-                dxf_ACI[106] = dxf_RGB_color_set (0,127,31);
-                dxf_ACI[107] = dxf_RGB_color_set (63,127,79);
-                dxf_ACI[108] = dxf_RGB_color_set (0,76,19);
-                dxf_ACI[109] = dxf_RGB_color_set (38,76,47);
-                dxf_ACI[110] = dxf_RGB_color_set (0,255,127);
-                dxf_ACI[111] = dxf_RGB_color_set (127,255,191);
-                dxf_ACI[112] = dxf_RGB_color_set (0,204,102);
-                dxf_ACI[113] = dxf_RGB_color_set (102,204,153);
-                dxf_ACI[114] = dxf_RGB_color_set (0,153,76);
-                dxf_ACI[115] = dxf_RGB_color_set (76,153,114);
-                dxf_ACI[116] = dxf_RGB_color_set (0,127,63);
-                dxf_ACI[117] = dxf_RGB_color_set (63,127,95);
-                dxf_ACI[118] = dxf_RGB_color_set (0,76,38);
-                dxf_ACI[119] = dxf_RGB_color_set (38,76,57);
-                dxf_ACI[120] = dxf_RGB_color_set (0,255,191);
-                dxf_ACI[121] = dxf_RGB_color_set (127,255,223);
-                dxf_ACI[122] = dxf_RGB_color_set (0,204,153);
-                dxf_ACI[123] = dxf_RGB_color_set (102,204,178);
-                dxf_ACI[124] = dxf_RGB_color_set (0,153,114);
-                dxf_ACI[125] = dxf_RGB_color_set (76,153,133);
-                dxf_ACI[126] = dxf_RGB_color_set (0,127,95);
-                dxf_ACI[127] = dxf_RGB_color_set (63,127,111);
-                dxf_ACI[128] = dxf_RGB_color_set (0,76,57);
-                dxf_ACI[129] = dxf_RGB_color_set (38,76,66);
-                dxf_ACI[130] = dxf_RGB_color_set (0,255,255);
-                dxf_ACI[131] = dxf_RGB_color_set (127,255,255);
-                dxf_ACI[132] = dxf_RGB_color_set (0,204,204);
-                dxf_ACI[133] = dxf_RGB_color_set (102,204,204);
-                dxf_ACI[134] = dxf_RGB_color_set (0,153,153);
-                dxf_ACI[135] = dxf_RGB_color_set (76,153,153);
-                dxf_ACI[136] = dxf_RGB_color_set (0,127,127);
-                dxf_ACI[137] = dxf_RGB_color_set (63,127,127);
-                dxf_ACI[138] = dxf_RGB_color_set (0,76,76);
-                dxf_ACI[139] = dxf_RGB_color_set (38,76,76);
-                dxf_ACI[140] = dxf_RGB_color_set (0,191,255);
-                dxf_ACI[141] = dxf_RGB_color_set (127,223,255);
-                dxf_ACI[142] = dxf_RGB_color_set (0,153,204);
-                dxf_ACI[143] = dxf_RGB_color_set (102,178,204);
-                dxf_ACI[144] = dxf_RGB_color_set (0,114,153);
-                dxf_ACI[145] = dxf_RGB_color_set (76,133,153);
-                dxf_ACI[146] = dxf_RGB_color_set (0,95,127);
-                dxf_ACI[147] = dxf_RGB_color_set (63,111,127);
-                dxf_ACI[148] = dxf_RGB_color_set (0,57,76);
-                dxf_ACI[149] = dxf_RGB_color_set (38,66,76);
-                dxf_ACI[150] = dxf_RGB_color_set (0,127,255);
-                dxf_ACI[151] = dxf_RGB_color_set (127,191,255);
-                dxf_ACI[152] = dxf_RGB_color_set (0,102,204);
-                dxf_ACI[153] = dxf_RGB_color_set (102,153,204);
-                dxf_ACI[154] = dxf_RGB_color_set (0,76,153);
-                dxf_ACI[155] = dxf_RGB_color_set (76,114,153);
-                dxf_ACI[156] = dxf_RGB_color_set (0,63,127);
-                dxf_ACI[157] = dxf_RGB_color_set (63,95,127);
-                dxf_ACI[158] = dxf_RGB_color_set (0,38,76);
-                dxf_ACI[159] = dxf_RGB_color_set (38,57,76);
-                dxf_ACI[160] = dxf_RGB_color_set (0,63,255);
-                dxf_ACI[161] = dxf_RGB_color_set (127,159,255);
-                dxf_ACI[162] = dxf_RGB_color_set (0,51,204);
-                dxf_ACI[163] = dxf_RGB_color_set (102,127,204);
-                dxf_ACI[164] = dxf_RGB_color_set (0,38,153);
-                dxf_ACI[165] = dxf_RGB_color_set (76,95,153);
-                dxf_ACI[166] = dxf_RGB_color_set (0,31,127);
-                dxf_ACI[167] = dxf_RGB_color_set (63,79,127);
-                dxf_ACI[168] = dxf_RGB_color_set (0,19,76);
-                dxf_ACI[169] = dxf_RGB_color_set (38,47,76);
-                dxf_ACI[170] = dxf_RGB_color_set (0,0,255);
-                dxf_ACI[171] = dxf_RGB_color_set (170,170,255);
-                dxf_ACI[172] = dxf_RGB_color_set (0,0,189);
-                dxf_ACI[173] = dxf_RGB_color_set (126,126,189);
-                dxf_ACI[174] = dxf_RGB_color_set (0,0,129);
-                dxf_ACI[175] = dxf_RGB_color_set (86,86,129);
-                dxf_ACI[176] = dxf_RGB_color_set (0,0,104);
-                dxf_ACI[177] = dxf_RGB_color_set (69,69,104);
-                dxf_ACI[178] = dxf_RGB_color_set (0,0,79);
-                dxf_ACI[179] = dxf_RGB_color_set (53,53,79);
-                dxf_ACI[180] = dxf_RGB_color_set (63,0,255);
-                dxf_ACI[181] = dxf_RGB_color_set (191,170,255);
-                dxf_ACI[182] = dxf_RGB_color_set (46,0,189);
-                dxf_ACI[183] = dxf_RGB_color_set (141,126,189);
-                dxf_ACI[184] = dxf_RGB_color_set (31,0,129);
-                dxf_ACI[185] = dxf_RGB_color_set (96,86,129);
-                dxf_ACI[186] = dxf_RGB_color_set (25,0,104);
-                dxf_ACI[187] = dxf_RGB_color_set (78,69,104);
-                dxf_ACI[188] = dxf_RGB_color_set (19,0,79);
-                dxf_ACI[189] = dxf_RGB_color_set (59,53,79);
-                dxf_ACI[190] = dxf_RGB_color_set (127,0,255);
-                dxf_ACI[191] = dxf_RGB_color_set (212,170,255);
-                dxf_ACI[192] = dxf_RGB_color_set (94,0,189);
-                dxf_ACI[193] = dxf_RGB_color_set (157,126,189);
-                dxf_ACI[194] = dxf_RGB_color_set (64,0,129);
-                dxf_ACI[195] = dxf_RGB_color_set (107,86,129);
-                dxf_ACI[196] = dxf_RGB_color_set (52,0,104);
-                dxf_ACI[197] = dxf_RGB_color_set (86,69,104);
-                dxf_ACI[198] = dxf_RGB_color_set (39,0,79);
-                dxf_ACI[199] = dxf_RGB_color_set (66,53,79);
-                dxf_ACI[200] = dxf_RGB_color_set (191,0,255);
-                dxf_ACI[201] = dxf_RGB_color_set (234,170,255);
-                dxf_ACI[202] = dxf_RGB_color_set (141,0,189);
-                dxf_ACI[203] = dxf_RGB_color_set (173,126,189);
-                dxf_ACI[204] = dxf_RGB_color_set (96,0,129);
-                dxf_ACI[205] = dxf_RGB_color_set (118,86,129);
-                dxf_ACI[206] = dxf_RGB_color_set (78,0,104);
-                dxf_ACI[207] = dxf_RGB_color_set (95,69,104);
-                dxf_ACI[208] = dxf_RGB_color_set (59,0,79);
-                dxf_ACI[209] = dxf_RGB_color_set (73,53,79);
-                dxf_ACI[210] = dxf_RGB_color_set (255,0,255);
-                dxf_ACI[211] = dxf_RGB_color_set (255,170,255);
-                dxf_ACI[212] = dxf_RGB_color_set (189,0,189);
-                dxf_ACI[213] = dxf_RGB_color_set (189,126,189);
-                dxf_ACI[214] = dxf_RGB_color_set (129,0,129);
-                dxf_ACI[215] = dxf_RGB_color_set (129,86,129);
-                dxf_ACI[216] = dxf_RGB_color_set (104,0,104);
-                dxf_ACI[217] = dxf_RGB_color_set (104,69,104);
-                dxf_ACI[218] = dxf_RGB_color_set (79,0,79);
-                dxf_ACI[219] = dxf_RGB_color_set (79,53,79);
-                dxf_ACI[220] = dxf_RGB_color_set (255,0,191);
-                dxf_ACI[221] = dxf_RGB_color_set (255,170,234);
-                dxf_ACI[222] = dxf_RGB_color_set (189,0,141);
-                dxf_ACI[223] = dxf_RGB_color_set (189,126,173);
-                dxf_ACI[224] = dxf_RGB_color_set (129,0,96);
-                dxf_ACI[225] = dxf_RGB_color_set (129,86,118);
-                dxf_ACI[226] = dxf_RGB_color_set (104,0,78);
-                dxf_ACI[227] = dxf_RGB_color_set (104,69,95);
-                dxf_ACI[228] = dxf_RGB_color_set (79,0,59);
-                dxf_ACI[229] = dxf_RGB_color_set (79,53,73);
-                dxf_ACI[230] = dxf_RGB_color_set (255,0,127);
-                dxf_ACI[231] = dxf_RGB_color_set (255,170,212);
-                dxf_ACI[232] = dxf_RGB_color_set (189,0,94);
-                dxf_ACI[233] = dxf_RGB_color_set (189,126,157);
-                dxf_ACI[234] = dxf_RGB_color_set (129,0,64);
-                dxf_ACI[235] = dxf_RGB_color_set (129,86,107);
-                dxf_ACI[236] = dxf_RGB_color_set (104,0,52);
-                dxf_ACI[237] = dxf_RGB_color_set (104,69,86);
-                dxf_ACI[238] = dxf_RGB_color_set (79,0,39);
-                dxf_ACI[239] = dxf_RGB_color_set (79,53,66);
-                dxf_ACI[240] = dxf_RGB_color_set (255,0,63);
-                dxf_ACI[241] = dxf_RGB_color_set (255,170,191);
-                dxf_ACI[242] = dxf_RGB_color_set (189,0,46);
-                dxf_ACI[243] = dxf_RGB_color_set (189,126,141);
-                dxf_ACI[244] = dxf_RGB_color_set (129,0,31);
-                dxf_ACI[245] = dxf_RGB_color_set (129,86,96);
-                dxf_ACI[246] = dxf_RGB_color_set (104,0,25);
-                dxf_ACI[247] = dxf_RGB_color_set (104,69,78);
-                dxf_ACI[248] = dxf_RGB_color_set (79,0,19);
-                dxf_ACI[249] = dxf_RGB_color_set (79,53,59);
-                dxf_ACI[250] = dxf_RGB_color_set (51,51,51);
-                dxf_ACI[251] = dxf_RGB_color_set (80,80,80);
-                dxf_ACI[252] = dxf_RGB_color_set (105,105,105);
-                dxf_ACI[253] = dxf_RGB_color_set (130,130,130);
-                dxf_ACI[254] = dxf_RGB_color_set (190,190,190);
-                dxf_ACI[255] = dxf_RGB_color_set (255,255,255);
+                dxf_ACI[i] = (DxfRGBColor *) &dxf_ACI_colors[i];
         }
 #if DEBUG
         DXF_DEBUG_END
@@ -499,13 +512,379 @@ dxf_RGB_to_triplet
 }
 
 
+/*!
+ * \brief One entry of the color name table: a hexadecimal triplet and
+ * its name according to Wikipedia's List of colors.
+ */
+typedef struct
+dxf_RGB_color_name_entry
+{
+        int triplet;
+                /*!< the color as 0xRRGGBB. */
+        const char *name;
+                /*!< the color name. */
+} DxfRGBColorNameEntry;
+
+
+/*!
+ * The color name table; order is irrelevant, lookups go through the
+ * hash index below.
+ */
+static const DxfRGBColorNameEntry dxf_RGB_color_name_table[] =
+{
+        {0x000000, "Black"},
+        {0x000080, "Navy Blue"},
+        {0x00008B, "Dark blue"},
+        {0x0000CD, "Medium blue"},
+        {0x0000FF, "Blue"},
+        {0x002FA7, "International Klein Blue"},
+        {0x003153, "Prusian blue"},
+        {0x003399, "Smalt (Dark powder blue)"},
+        {0x00416A, "Indigo (dye)"},
+        {0x0047AB, "Cobalt"},
+        {0x004953, "Midnight Green (Eagle Green)"},
+        {0x006633, "MSU Green"},
+        {0x007BA7, "Cerulean"},
+        {0x007FFF, "Azure (color wheel)"},
+        {0x008000, "Office green"},
+        {0x008080, "Teal"},
+        {0x009000, "Islamic green"},
+        {0x0095B6, "Bondi blue"},
+        {0x009E60, "Shamrock green"},
+        {0x00A550, "Green (pigment)"},
+        {0x00A693, "Persian green"},
+        {0x00A86B, "Jade"},
+        {0x00B7EB, "Cyan (process)"},
+        {0x00CCCC, "Robin egg blue"},
+        {0x00CED1, "Dark turquoise"},
+        {0x00DDDD, "Blue-green"},
+        {0x00FA9A, "Medium spring green"},
+        {0x00FF00, "Green (color wheel) (X11 green)"},
+        {0x00FF7F, "Spring green"},
+        {0x00FFFF, "Cyan"},
+        {0x013220, "Dark green"},
+        {0x01796F, "Pine green"},
+        {0x0247FE, "Blue (RYB)"},
+        {0x03C03C, "Dark pastel green"},
+        {0x082567, "Sapphire"},
+        {0x08457E, "Dark cerulean"},
+        {0x08E8DE, "Bright turquoise"},
+        {0x0BDA51, "Malachite"},
+        {0x0F4D92, "Yale Blue"},
+        {0x1034A6, "Egyptian blue"},
+        {0x120A8F, "Ultramarine"},
+        {0x1560BD, "Denim"},
+        {0x177245, "Dark spring green"},
+        {0x191970, "Midnight Blue"},
+        {0x1C39BB, "Persian blue"},
+        {0x1E90FF, "Dodger blue"},
+        {0x21421E, "Myrtle"},
+        {0x228B22, "Forrest green"},
+        {0x2A52BE, "Cerulean blue"},
+        {0x2E8B57, "Sea green"},
+        {0x2F4F4F, "Dark slate gray"},
+        {0x30D5C8, "Turquoise"},
+        {0x32127A, "Persian indigo"},
+        {0x321414, "Seal brown"},
+        {0x32CD32, "Lime green"},
+        {0x333399, "Blue (pigment)"},
+        {0x3D2B1F, "Bistre"},
+        {0x3FFF00, "Harlequin"},
+        {0x40404F, "Payne's grey"},
+        {0x40826D, "Viridian"},
+        {0x4169E1, "Royal blue"},
+        {0x464646, "Charcoal"},
+        {0x465945, "Gray-asparagus"},
+        {0x4682B4, "Steel blue"},
+        {0x483C32, "Taupe"},
+        {0x4B0082, "Indigo (web)"},
+        {0x4B5320, "Aemy green"},
+        {0x4CBB17, "Kelly green"},
+        {0x4F7942, "Fern green"},
+        {0x50404D, "Purple Taupe"},
+        {0x50C878, "Emerald"},
+        {0x5218FA, "Han Purple"},
+        {0x560319, "Dark scarlet"},
+        {0x592720, "Caput mortuum"},
+        {0x5B92E5, "United Nations blue"},
+        {0x614051, "Eggplant"},
+        {0x6495ED, "Cornflower blue"},
+        {0x654321, "Dark brown"},
+        {0x6600FF, "Electric indigo"},
+        {0x66023C, "Tyrian Purple"},
+        {0x66B032, "Green (RYB)"},
+        {0x66FF00, "Bright green"},
+        {0x6B3FA0, "Royal purple"},
+        {0x6B8E23, "Olive Drab"},
+        {0x6D351A, "Auburn"},
+        {0x704214, "Sepia"},
+        {0x708090, "Slate grey"},
+        {0x734A12, "Raw umber"},
+        {0x738678, "Xanadu"},
+        {0x73C2FB, "Maya blue"},
+        {0x77DD77, "Pastel green"},
+        {0x78866B, "Camouflage green"},
+        {0x796878, "Old Lavender"},
+        {0x7B3F00, "Chocolate"},
+        {0x7BA05B, "Asparagus"},
+        {0x7CFC00, "Lawn green"},
+        {0x7DF9FF, "Electric blue"},
+        {0x7F007F, "Purple (HTML/CSS)"},
+        {0x7FFF00, "Chartreuse (web)"},
+        {0x7FFFD4, "Aquamarine"},
+        {0x800000, "Maroon (HTML/CSS)"},
+        {0x801818, "Falu red"},
+        {0x80461B, "Russet"},
+        {0x808000, "Olive"},
+        {0x808080, "Gray"},
+        {0x8601AF, "Violet (RYB)"},
+        {0x87CEEB, "Sky Blue"},
+        {0x8A2BE2, "Blue-violet"},
+        {0x8A3324, "Burnt umber"},
+        {0x8B008B, "Dark magenta"},
+        {0x8B00FF, "Violet"},
+        {0x8B8589, "Taupe gray"},
+        {0x900020, "Burgundy"},
+        {0x905D5D, "Rose Taupe"},
+        {0x915F6D, "Mauve Taupe"},
+        {0x918151, "Dark tan"},
+        {0x92000A, "Sangria"},
+        {0x9370DB, "Medium purple"},
+        {0x9400D3, "Dark violet"},
+        {0x960018, "Carmine"},
+        {0x964B00, "Brown"},
+        {0x967BB6, "Lavender purple"},
+        {0x986960, "Dark chestnut"},
+        {0x987654, "Pale brown"},
+        {0x98FF98, "Mint green"},
+        {0x9955BB, "Deep lilac"},
+        {0x996515, "Golden brown"},
+        {0x996666, "Copper rose"},
+        {0x9966CC, "Amethyst"},
+        {0x997A8D, "Mountbatten pink"},
+        {0x99BADD, "Carolina blue"},
+        {0x9AB973, "Olivine"},
+        {0x9ACD32, "Yellow-green"},
+        {0x9BDDFF, "Columbia blue"},
+        {0xA020F0, "Purple (X11)"},
+        {0xA0522D, "Sienna"},
+        {0xA7FC00, "Spring bud"},
+        {0xAA98A9, "Rose quartz"},
+        {0xAAF0D1, "Magic mint"},
+        {0xABCDEF, "Pale cornflower blue"},
+        {0xACE1AF, "Celadon"},
+        {0xADD8E6, "Light blue"},
+        {0xADDFAD, "Moss green"},
+        {0xADFF2F, "Green-yellow"},
+        {0xAE2029, "Upsdell red"},
+        {0xAF4035, "Pale carmine"},
+        {0xAFEEEE, "Pale blue"},
+        {0xB03060, "Maroon (X11)"},
+        {0xB22222, "Firebrick"},
+        {0xB57EDC, "Lavender (floral)"},
+        {0xB5A642, "Brass"},
+        {0xB7410E, "Rust"},
+        {0xB87333, "Copper"},
+        {0xB8860B, "Dark goldenrod"},
+        {0xB94E48, "Deep chestnut"},
+        {0xBC987E, "Pale taupe"},
+        {0xBDB76B, "Dark khaki"},
+        {0xBF00FF, "Electric purple"},
+        {0xBFFF00, "Lime (color wheel)"},
+        {0xC08081, "Old Rose"},
+        {0xC0C0C0, "Silver"},
+        {0xC154C1, "Deep fuchsia"},
+        {0xC2B280, "Ecru"},
+        {0xC3B091, "Khaki"},
+        {0xC41E3A, "Cardinal"},
+        {0xC4C3D0, "Lavender gray"},
+        {0xC5B358, "Vegas Gold"},
+        {0xC71585, "Red-violet"},
+        {0xC80815, "Venetian red"},
+        {0xC8A2C8, "Lilac"},
+        {0xC9A0DC, "Wisteria"},
+        {0xCA1F7B, "Magenta (dye)"},
+        {0xCC3333, "Persian red"},
+        {0xCC5500, "Burnt orange"},
+        {0xCC7722, "Ochre"},
+        {0xCC8899, "Puce"},
+        {0xCC99CC, "Medium lavender magenta"},
+        {0xCCCCFF, "Lavender blue"},
+        {0xCCFF00, "Electric lime"},
+        {0xCD00CC, "Deep magenta"},
+        {0xCD5700, "Tenné (Tawny)"},
+        {0xCD5B45, "Dark coral"},
+        {0xCD5C5C, "Chestnut"},
+        {0xCD7F32, "Bronze"},
+        {0xCFB53B, "Old Gold"},
+        {0xD0F0C0, "Tea green"},
+        {0xD1E231, "Pear"},
+        {0xD2691E, "Cinnamon"},
+        {0xD2B48C, "Tan"},
+        {0xD4AF37, "Gold (metallic)"},
+        {0xD70040, "Rich carmine"},
+        {0xD8BFD8, "Thistle"},
+        {0xD99058, "Persian orange"},
+        {0xDA3287, "Deep cerise"},
+        {0xDA70D6, "Orchid"},
+        {0xDAA520, "Goldenrod"},
+        {0xDB7093, "Pale red-violet"},
+        {0xDC143C, "Crimson"},
+        {0xDD00FF, "Psychedelic purple"},
+        {0xDDADAF, "Pale chestnut"},
+        {0xDE3163, "Cerise"},
+        {0xDE6FA1, "Thullian pink"},
+        {0xDF73FF, "Heliotrope"},
+        {0xDFFF00, "Chartreuse (traditional)"},
+        {0xE0115F, "Ruby"},
+        {0xE0B0FF, "Mauve"},
+        {0xE0FFFF, "Baby blue"},
+        {0xE2725B, "Terra cotta"},
+        {0xE30B5C, "Raspberry"},
+        {0xE3256B, "Razzmatazz"},
+        {0xE32636, "Rose Madder"},
+        {0xE34234, "Vermilion"},
+        {0xE49B0F, "Gamboge"},
+        {0xE52B50, "Amaranth"},
+        {0xE5E4E2, "Platinum"},
+        {0xE6E6FA, "Lavender (web)"},
+        {0xE75480, "Dark pink"},
+        {0xE97451, "Burnt sienna"},
+        {0xE9967A, "Dark salmon"},
+        {0xEB4C42, "Carmine Pink"},
+        {0xEC3B83, "Cerise Pink"},
+        {0xEC5800, "Persimmon"},
+        {0xED1C24, "Red (pigment)"},
+        {0xED9121, "Carrot orange"},
+        {0xEE82EE, "Lavender magenta"},
+        {0xEEDC82, "Flax"},
+        {0xEF3038, "Deep Carmine Pink"},
+        {0xF0DC82, "Buff"},
+        {0xF0E68C, "Khaki (X11) (Light khaki)"},
+        {0xF0F8FF, "Alice blue"},
+        {0xF0FFFF, "Azure (web)"},
+        {0xF19CBB, "Amaranth Pink"},
+        {0xF28500, "Tangerine"},
+        {0xF400A1, "Hollywood Cerise"},
+        {0xF4A460, "Sandy brown"},
+        {0xF4C2C2, "Tea rose (rose)"},
+        {0xF4C430, "Saffron"},
+        {0xF5DEB3, "Wheat"},
+        {0xF5F5DC, "Beige"},
+        {0xF64A8A, "French Rose"},
+        {0xF77FBE, "Persian pink"},
+        {0xF7E7CE, "Champagne"},
+        {0xF88379, "Coral pink"},
+        {0xF8F4FF, "Magnolia"},
+        {0xF984E5, "Pale magenta"},
+        {0xFADADD, "Pale pink"},
+        {0xFADFAD, "Peach-yellow"},
+        {0xFAF0E6, "Linen"},
+        {0xFB607F, "Brink pink"},
+        {0xFB9902, "Orange (RYB)"},
+        {0xFBA0E3, "Lavender rose"},
+        {0xFBAED2, "Lavender pink"},
+        {0xFBCEB1, "Apricot"},
+        {0xFBEC5D, "Corn"},
+        {0xFC0FC0, "Shocking pink"},
+        {0xFDE910, "Lemon"},
+        {0xFDF5E6, "Old Lace"},
+        {0xFE2712, "Red (RYB)"},
+        {0xFE28A2, "Persian rose"},
+        {0xFEFE33, "Yellow (RYB)"},
+        {0xFF0000, "Red"},
+        {0xFF007F, "Rose"},
+        {0xFF0090, "Magenta (process)"},
+        {0xFF00CC, "Hot Magenta"},
+        {0xFF00FF, "Magenta"},
+        {0xFF1493, "Deep pink"},
+        {0xFF2400, "Scarlet"},
+        {0xFF4040, "Coral red"},
+        {0xFF4500, "Orange-Red"},
+        {0xFF4F00, "International orange"},
+        {0xFF55A3, "Brilliant rose"},
+        {0xFF5A36, "Portland Orange"},
+        {0xFF6347, "Tomato"},
+        {0xFF6600, "Safety orange (blaze orange)"},
+        {0xFF66CC, "Rose pink"},
+        {0xFF69B4, "Hot Pink"},
+        {0xFF6FFF, "Ultra pink"},
+        {0xFF7518, "Pumpkin"},
+        {0xFF77FF, "Fuchsia Pink"},
+        {0xFF7F00, "Orange (color wheel)"},
+        {0xFF7F50, "Coral"},
+        {0xFF8C69, "Salmon"},
+        {0xFF91A4, "Salmon pink"},
+        {0xFF9966, "Pink-orange"},
+        {0xFFA000, "Orange Peel"},
+        {0xFFA500, "Orange (web)"},
+        {0xFFA6C9, "Carnation pink"},
+        {0xFFB6C1, "Light pink"},
+        {0xFFB7C5, "Cherry blossom pink"},
+        {0xFFBA00, "Selective yellow"},
+        {0xFFBF00, "Amber"},
+        {0xFFC0CB, "Pink"},
+        {0xFFCBA4, "Deep peach"},
+        {0xFFCC00, "Tangerine yellow"},
+        {0xFFCC99, "Peach-orange"},
+        {0xFFD1DC, "Pastel pink"},
+        {0xFFD700, "Gold (web) (Golden)"},
+        {0xFFD800, "School bus yellow"},
+        {0xFFDB58, "Mustard"},
+        {0xFFDEAD, "Navajo white"},
+        {0xFFDF00, "Golden yellow"},
+        {0xFFE4E1, "Misty rose"},
+        {0xFFE5B4, "Peach"},
+        {0xFFEF00, "Yellow (process)"},
+        {0xFFEFD5, "Papaya whip"},
+        {0xFFF0F5, "Lavender blush"},
+        {0xFFF5EE, "Seashell"},
+        {0xFFF8E7, "Cosmic latte"},
+        {0xFFFACD, "Lemon chifton"},
+        {0xFFFDD0, "Cream"},
+        {0xFFFF00, "Yellow"},
+        {0xFFFFF0, "Ivory"},
+        {0xFFFFFF, "White"},
+};
+
+#define DXF_RGB_COLOR_NAME_TABLE_LENGTH \
+        (sizeof (dxf_RGB_color_name_table) / sizeof (dxf_RGB_color_name_table[0]))
+
+/*!
+ * The hash index over \c dxf_RGB_color_name_table; sized to a power of
+ * two above twice the entry count so the Fibonacci hash probes at most
+ * a few slots.  Built once on first use.
+ */
+#define DXF_RGB_COLOR_NAME_HASH_SIZE 1024
+
+static short dxf_RGB_color_name_hash_index[DXF_RGB_COLOR_NAME_HASH_SIZE];
+static int dxf_RGB_color_name_hash_ready = 0;
+
+
+/*!
+ * \brief Hash a hexadecimal triplet (Fibonacci hash).
+ */
+static unsigned int
+dxf_RGB_color_name_hash
+(
+        int triplet
+                /*!< the color as 0xRRGGBB. */
+)
+{
+        return (((unsigned int) triplet * 2654435761u)
+          >> (32 - 10)) & (DXF_RGB_COLOR_NAME_HASH_SIZE - 1);
+}
+
+
 /*!
  * \brief Return the color name according to the Wikipedia List of 
  * Colors.
  *
  * These color names are defined by Wikipedia's
  * <a href="http://en.wikipedia.org/wiki/List_of_colors">
- * List of colors</a>.
+ * List of colors</a>.\n
+ * The lookup goes through a hash index over the color name table and
+ * runs in constant time.
  *
  * \return a pointer to the color name string, or \c NULL if unknown.
  */
@@ -522,1688 +901,40 @@ dxf_RGB_color_get_name
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        char *RGB_color_name;
+        unsigned int slot;
+        int i;
 
-        switch (RGB_color_hex_triplet)
+        if (!dxf_RGB_color_name_hash_ready)
         {
-                case 0xF0F8FF :
-                {
-                        RGB_color_name = strdup ("Alice blue");
-                        return (RGB_color_name);
-                }
-/*
-                case 0xE32636 :
-                {
-                        RGB_color_name = strdup ("Alizarin");
-                        return (RGB_color_name);
-                }
-*/
-                case 0xE52B50 :
-                {
-                        RGB_color_name = strdup ("Amaranth");
-                        return (RGB_color_name);
-                }
-                case 0xF19CBB :
-                {
-                        RGB_color_name = strdup ("Amaranth Pink");
-                        return (RGB_color_name);
-                }
-                case 0xFFBF00 :
-                {
-                        RGB_color_name = strdup ("Amber");
-                        return (RGB_color_name);
-                }
-                case 0x9966CC :
-                {
-                        RGB_color_name = strdup ("Amethyst");
-                        return (RGB_color_name);
-                }
-                case 0xFBCEB1 :
-                {
-                        RGB_color_name = strdup ("Apricot");
-                        return (RGB_color_name);
-                }
-/*
-                case 0x00FFFF :
-                {
-                        RGB_color_name = strdup ("Aqua");
-                        return (RGB_color_name);
-                }
-*/
-                case 0x7FFFD4 :
-                {
-                        RGB_color_name = strdup ("Aquamarine");
-                        return (RGB_color_name);
-                }
-                case 0x4B5320 :
-                {
-                        RGB_color_name = strdup ("Aemy green");
-                        return (RGB_color_name);
-                }
-                case 0x7BA05B :
-                {
-                        RGB_color_name = strdup ("Asparagus");
-                        return (RGB_color_name);
-                }
-/*
-                case 0xFF9966 :
-                {
-                        RGB_color_name = strdup ("Atomic tangerine");
-                        return (RGB_color_name);
-                }
-*/
-                case 0x6D351A :
-                {
-                        RGB_color_name = strdup ("Auburn");
-                        return (RGB_color_name);
-                }
-                case 0x007FFF :
-                {
-                        RGB_color_name = strdup ("Azure (color wheel)");
-                        return (RGB_color_name);
-                }
-                case 0xF0FFFF :
-                {
-                        RGB_color_name = strdup ("Azure (web)");
-                        return (RGB_color_name);
-                }
-                case 0xE0FFFF :
-                {
-                        RGB_color_name = strdup ("Baby blue");
-                        return (RGB_color_name);
-                }
-                case 0xF5F5DC :
-                {
-                        RGB_color_name = strdup ("Beige");
-                        return (RGB_color_name);
-                }
-                case 0x3D2B1F :
-                {
-                        RGB_color_name = strdup ("Bistre");
-                        return (RGB_color_name);
-                }
-                case 0x000000 :
-                {
-                        RGB_color_name = strdup ("Black");
-                        return (RGB_color_name);
-                }
-                case 0x0000FF :
-                {
-                        RGB_color_name = strdup ("Blue");
-                        return (RGB_color_name);
-                }
-                case 0x333399 :
-                {
-                        RGB_color_name = strdup ("Blue (pigment)");
-                        return (RGB_color_name);
-                }
-                case 0x0247FE :
-                {
-                        RGB_color_name = strdup ("Blue (RYB)");
-                        return (RGB_color_name);
-                }
-                case 0x00DDDD :
-                {
-                        RGB_color_name = strdup ("Blue-green");
-                        return (RGB_color_name);
-                }
-                case 0x8A2BE2 :
-                {
-                        RGB_color_name = strdup ("Blue-violet");
-                        return (RGB_color_name);
-                }
-                case 0x0095B6 :
-                {
-                        RGB_color_name = strdup ("Bondi blue");
-                        return (RGB_color_name);
-                }
-                case 0xB5A642 :
-                {
-                        RGB_color_name = strdup ("Brass");
-                        return (RGB_color_name);
-                }
-                case 0x66FF00 :
-                {
-                        RGB_color_name = strdup ("Bright green");
-                        return (RGB_color_name);
-                }
-/*
-                case 0xFF007F :
-                {
-                        RGB_color_name = strdup ("Bright pink");
-                        return (RGB_color_name);
-                }
-*/
-                case 0x08E8DE :
-                {
-                        RGB_color_name = strdup ("Bright turquoise");
-                        return (RGB_color_name);
-                }
-                case 0xFF55A3 :
-                {
-                        RGB_color_name = strdup ("Brilliant rose");
-                        return (RGB_color_name);
-                }
-                case 0xFB607F :
-                {
-                        RGB_color_name = strdup ("Brink pink");
-                        return (RGB_color_name);
-                }
-                case 0xCD7F32 :
-                {
-                        RGB_color_name = strdup ("Bronze");
-                        return (RGB_color_name);
-                }
-                case 0x964B00 :
-                {
-                        RGB_color_name = strdup ("Brown");
-                        return (RGB_color_name);
-                }
-                case 0xF0DC82 :
-                {
-                        RGB_color_name = strdup ("Buff");
-                        return (RGB_color_name);
-                }
-                case 0x900020 :
-                {
-                        RGB_color_name = strdup ("Burgundy");
-                        return (RGB_color_name);
-                }
-                case 0xCC5500 :
-                {
-                        RGB_color_name = strdup ("Burnt orange");
-                        return (RGB_color_name);
-                }
-                case 0xE97451 :
-                {
-                        RGB_color_name = strdup ("Burnt sienna");
-                        return (RGB_color_name);
-                }
-                case 0x8A3324 :
-                {
-                        RGB_color_name = strdup ("Burnt umber");
-                        return (RGB_color_name);
-                }
-                case 0x78866B :
-                {
-                        RGB_color_name = strdup ("Camouflage green");
-                        return (RGB_color_name);
-                }
-                case 0x592720 :
-                {
-                        RGB_color_name = strdup ("Caput mortuum");
-                        return (RGB_color_name);
-                }
-                case 0xC41E3A :
-                {
-                        RGB_color_name = strdup ("Cardinal");
-                        return (RGB_color_name);
-                }
-                case 0x960018 :
-                {
-                        RGB_color_name = strdup ("Carmine");
-                        return (RGB_color_name);
-                }
-                case 0xEB4C42 :
-                {
-                        RGB_color_name = strdup ("Carmine Pink");
-                        return (RGB_color_name);
-                }
-                case 0xFFA6C9 :
-                {
-                        RGB_color_name = strdup ("Carnation pink");
-                        return (RGB_color_name);
-                }
-                case 0x99BADD :
-                {
-                        RGB_color_name = strdup ("Carolina blue");
-                        return (RGB_color_name);
-                }
-                case 0xED9121 :
-                {
-                        RGB_color_name = strdup ("Carrot orange");
-                        return (RGB_color_name);
-                }
-                case 0xACE1AF :
-                {
-                        RGB_color_name = strdup ("Celadon");
-                        return (RGB_color_name);
-                }
-                case 0xDE3163 :
-                {
-                        RGB_color_name = strdup ("Cerise");
-                        return (RGB_color_name);
-                }
-                case 0xEC3B83 :
-                {
-                        RGB_color_name = strdup ("Cerise Pink");
-                        return (RGB_color_name);
-                }
-                case 0x007BA7 :
-                {
-                        RGB_color_name = strdup ("Cerulean");
-                        return (RGB_color_name);
-                }
-                case 0x2A52BE :
-                {
-                        RGB_color_name = strdup ("Cerulean blue");
-                        return (RGB_color_name);
-                }
-                case 0xF7E7CE :
-                {
-                        RGB_color_name = strdup ("Champagne");
-                        return (RGB_color_name);
-                }
-                case 0x464646 :
-                {
-                        RGB_color_name = strdup ("Charcoal");
-                        return (RGB_color_name);
-                }
-                case 0xDFFF00 :
-                {
-                        RGB_color_name = strdup ("Chartreuse (traditional)");
-                        return (RGB_color_name);
-                }
-                case 0x7FFF00 :
-                {
-                        RGB_color_name = strdup ("Chartreuse (web)");
-                        return (RGB_color_name);
-                }
-                case 0xFFB7C5 :
-                {
-                        RGB_color_name = strdup ("Cherry blossom pink");
-                        return (RGB_color_name);
-                }
-                case 0xCD5C5C :
-                {
-                        RGB_color_name = strdup ("Chestnut");
-                        return (RGB_color_name);
-                }
-                case 0x7B3F00 :
-                {
-                        RGB_color_name = strdup ("Chocolate");
-                        return (RGB_color_name);
-                }
-/*
-                case 0xE34234 :
-                {
-                        RGB_color_name = strdup ("Cinnabar");
-                        return (RGB_color_name);
-                }
-*/
-                case 0xD2691E :
-                {
-                        RGB_color_name = strdup ("Cinnamon");
-                        return (RGB_color_name);
-                }
-                case 0x0047AB :
-                {
-                        RGB_color_name = strdup ("Cobalt");
-                        return (RGB_color_name);
-                }
-                case 0x9BDDFF :
-                {
-                        RGB_color_name = strdup ("Columbia blue");
-                        return (RGB_color_name);
-                }
-                case 0xB87333 :
-                {
-                        RGB_color_name = strdup ("Copper");
-                        return (RGB_color_name);
-                }
-                case 0x996666 :
-                {
-                        RGB_color_name = strdup ("Copper rose");
-                        return (RGB_color_name);
-                }
-                case 0xFF7F50 :
-                {
-                        RGB_color_name = strdup ("Coral");
-                        return (RGB_color_name);
-                }
-                case 0xF88379 :
-                {
-                        RGB_color_name = strdup ("Coral pink");
-                        return (RGB_color_name);
-                }
-                case 0xFF4040 :
-                {
-                        RGB_color_name = strdup ("Coral red");
-                        return (RGB_color_name);
-                }
-                case 0xFBEC5D :
-                {
-                        RGB_color_name = strdup ("Corn");
-                        return (RGB_color_name);
-                }
-                case 0x6495ED :
-                {
-                        RGB_color_name = strdup ("Cornflower blue");
-                        return (RGB_color_name);
-                }
-                case 0xFFF8E7 :
-                {
-                        RGB_color_name = strdup ("Cosmic latte");
-                        return (RGB_color_name);
-                }
-                case 0xFFFDD0 :
-                {
-                        RGB_color_name = strdup ("Cream");
-                        return (RGB_color_name);
-                }
-                case 0xDC143C :
-                {
-                        RGB_color_name = strdup ("Crimson");
-                        return (RGB_color_name);
-                }
-                case 0x00FFFF :
-                {
-                        RGB_color_name = strdup ("Cyan");
-                        return (RGB_color_name);
-                }
-                case 0x00B7EB :
-                {
-                        RGB_color_name = strdup ("Cyan (process)");
-                        return (RGB_color_name);
-                }
-                case 0x00008B :
-                {
-                        RGB_color_name = strdup ("Dark blue");
-                        return (RGB_color_name);
-                }
-                case 0x654321 :
-                {
-                        RGB_color_name = strdup ("Dark brown");
-                        return (RGB_color_name);
-                }
-                case 0x08457E :
-                {
-                        RGB_color_name = strdup ("Dark cerulean");
-                        return (RGB_color_name);
-                }
-                case 0x986960 :
-                {
-                        RGB_color_name = strdup ("Dark chestnut");
-                        return (RGB_color_name);
-                }
-                case 0xCD5B45 :
-                {
-                        RGB_color_name = strdup ("Dark coral");
-                        return (RGB_color_name);
-                }
-                case 0xB8860B :
-                {
-                        RGB_color_name = strdup ("Dark goldenrod");
-                        return (RGB_color_name);
-                }
-                case 0x013220 :
-                {
-                        RGB_color_name = strdup ("Dark green");
-                        return (RGB_color_name);
-                }
-                case 0xBDB76B :
-                {
-                        RGB_color_name = strdup ("Dark khaki");
-                        return (RGB_color_name);
-                }
-                case 0x8B008B :
-                {
-                        RGB_color_name = strdup ("Dark magenta");
-                        return (RGB_color_name);
-                }
-                case 0x03C03C :
-                {
-                        RGB_color_name = strdup ("Dark pastel green");
-                        return (RGB_color_name);
-                }
-                case 0xE75480 :
-                {
-                        RGB_color_name = strdup ("Dark pink");
-                        return (RGB_color_name);
-                }
-                case 0x560319 :
-                {
-                        RGB_color_name = strdup ("Dark scarlet");
-                        return (RGB_color_name);
-                }
-                case 0xE9967A :
-                {
-                        RGB_color_name = strdup ("Dark salmon");
-                        return (RGB_color_name);
-                }
-                case 0x2F4F4F :
-                {
-                        RGB_color_name = strdup ("Dark slate gray");
-                        return (RGB_color_name);
-                }
-                case 0x177245 :
-                {
-                        RGB_color_name = strdup ("Dark spring green");
-                        return (RGB_color_name);
-                }
-                case 0x918151 :
-                {
-                        RGB_color_name = strdup ("Dark tan");
-                        return (RGB_color_name);
-                }
-                case 0x00CED1 :
-                {
-                        RGB_color_name = strdup ("Dark turquoise");
-                        return (RGB_color_name);
-                }
-                case 0x9400D3 :
-                {
-                        RGB_color_name = strdup ("Dark violet");
-                        return (RGB_color_name);
-                }
-                case 0xEF3038 :
-                {
-                        RGB_color_name = strdup ("Deep Carmine Pink");
-                        return (RGB_color_name);
-                }
-                case 0xDA3287 :
-                {
-                        RGB_color_name = strdup ("Deep cerise");
-                        return (RGB_color_name);
-                }
-                case 0xB94E48 :
-                {
-                        RGB_color_name = strdup ("Deep chestnut");
-                        return (RGB_color_name);
-                }
-                case 0xC154C1 :
-                {
-                        RGB_color_name = strdup ("Deep fuchsia");
-                        return (RGB_color_name);
-                }
-                case 0x9955BB :
-                {
-                        RGB_color_name = strdup ("Deep lilac");
-                        return (RGB_color_name);
-                }
-                case 0xCD00CC :
-                {
-                        RGB_color_name = strdup ("Deep magenta");
-                        return (RGB_color_name);
-                }
-                case 0xFFCBA4 :
-                {
-                        RGB_color_name = strdup ("Deep peach");
-                        return (RGB_color_name);
-                }
-                case 0xFF1493 :
-                {
-                        RGB_color_name = strdup ("Deep pink");
-                        return (RGB_color_name);
-                }
-                case 0x1560BD :
-                {
-                        RGB_color_name = strdup ("Denim");
-                        return (RGB_color_name);
-                }
-                case 0x1E90FF :
-                {
-                        RGB_color_name = strdup ("Dodger blue");
-                        return (RGB_color_name);
-                }
-                case 0xC2B280 :
-                {
-                        RGB_color_name = strdup ("Ecru");
-                        return (RGB_color_name);
-                }
-                case 0x1034A6 :
-                {
-                        RGB_color_name = strdup ("Egyptian blue");
-                        return (RGB_color_name);
-                }
-                case 0x7DF9FF :
-                {
-                        RGB_color_name = strdup ("Electric blue");
-                        return (RGB_color_name);
-                }
-/*
-                case 0x00FF00 :
-                {
-                        RGB_color_name = strdup ("Electric green (X11 green)");
-                        return (RGB_color_name);
-                }
-*/
-                case 0x6600FF :
-                {
-                        RGB_color_name = strdup ("Electric indigo");
-                        return (RGB_color_name);
-                }
-                case 0xCCFF00 :
-                {
-                        RGB_color_name = strdup ("Electric lime");
-                        return (RGB_color_name);
-                }
-                case 0xBF00FF :
-                {
-                        RGB_color_name = strdup ("Electric purple");
-                        return (RGB_color_name);
-                }
-                case 0x50C878 :
+                for (slot = 0; slot < DXF_RGB_COLOR_NAME_HASH_SIZE; slot++)
                 {
-                        RGB_color_name = strdup ("Emerald");
-                        return (RGB_color_name);
+                        dxf_RGB_color_name_hash_index[slot] = -1;
                 }
-                case 0x614051 :
+                for (i = 0; i < DXF_RGB_COLOR_NAME_TABLE_LENGTH; i++)
                 {
-                        RGB_color_name = strdup ("Eggplant");
-                        return (RGB_color_name);
+                        slot = dxf_RGB_color_name_hash (dxf_RGB_color_name_table[i].triplet);
+                        while (dxf_RGB_color_name_hash_index[slot] != -1)
+                        {
+                                slot = (slot + 1) & (DXF_RGB_COLOR_NAME_HASH_SIZE - 1);
+                        }
+                        dxf_RGB_color_name_hash_index[slot] = (short) i;
                 }
-                case 0x801818 :
-                {
-                        RGB_color_name = strdup ("Falu red");
-                        return (RGB_color_name);
-                }
-                case 0x4F7942 :
-                {
-                        RGB_color_name = strdup ("Fern green");
-                        return (RGB_color_name);
-                }
-                case 0xB22222 :
-                {
-                        RGB_color_name = strdup ("Firebrick");
-                        return (RGB_color_name);
-                }
-                case 0xEEDC82 :
-                {
-                        RGB_color_name = strdup ("Flax");
-                        return (RGB_color_name);
-                }
-                case 0x228B22 :
-                {
-                        RGB_color_name = strdup ("Forrest green");
-                        return (RGB_color_name);
-                }
-                case 0xF64A8A :
-                {
-                        RGB_color_name = strdup ("French Rose");
-                        return (RGB_color_name);
-                }
-/*
-                case 0xFF00FF :
-                {
-                        RGB_color_name = strdup ("Fuchsia");
-                        return (RGB_color_name);
-                }
-*/
-                case 0xFF77FF :
-                {
-                        RGB_color_name = strdup ("Fuchsia Pink");
-                        return (RGB_color_name);
-                }
-                case 0xE49B0F :
-                {
-                        RGB_color_name = strdup ("Gamboge");
-                        return (RGB_color_name);
-                }
-                case 0xD4AF37 :
-                {
-                        RGB_color_name = strdup ("Gold (metallic)");
-                        return (RGB_color_name);
-                }
-                case 0xFFD700 :
-                {
-                        RGB_color_name = strdup ("Gold (web) (Golden)");
-                        return (RGB_color_name);
-                }
-                case 0x996515 :
-                {
-                        RGB_color_name = strdup ("Golden brown");
-                        return (RGB_color_name);
-                }
-                case 0xFFDF00 :
-                {
-                        RGB_color_name = strdup ("Golden yellow");
-                        return (RGB_color_name);
-                }
-                case 0xDAA520 :
-                {
-                        RGB_color_name = strdup ("Goldenrod");
-                        return (RGB_color_name);
-                }
-                case 0x465945 :
-                {
-                        RGB_color_name = strdup ("Gray-asparagus");
-                        return (RGB_color_name);
-                }
-                case 0x00FF00 :
-                {
-                        RGB_color_name = strdup ("Green (color wheel) (X11 green)");
-                        return (RGB_color_name);
-                }
-/*
-                case 0x008000 :
-                {
-                        RGB_color_name = strdup ("Green (HTML/CSS green)");
-                        return (RGB_color_name);
-                }
-*/
-                case 0x00A550 :
-                {
-                        RGB_color_name = strdup ("Green (pigment)");
-                        return (RGB_color_name);
-                }
-                case 0x66B032 :
-                {
-                        RGB_color_name = strdup ("Green (RYB)");
-                        return (RGB_color_name);
-                }
-                case 0xADFF2F :
-                {
-                        RGB_color_name = strdup ("Green-yellow");
-                        return (RGB_color_name);
-                }
-                case 0x808080 :
-                {
-                        RGB_color_name = strdup ("Gray");
-                        return (RGB_color_name);
-                }
-                case 0x5218FA :
-                {
-                        RGB_color_name = strdup ("Han Purple");
-                        return (RGB_color_name);
-                }
-                case 0x3FFF00 :
-                {
-                        RGB_color_name = strdup ("Harlequin");
-                        return (RGB_color_name);
-                }
-                case 0xDF73FF :
-                {
-                        RGB_color_name = strdup ("Heliotrope");
-                        return (RGB_color_name);
-                }
-                case 0xF400A1 :
-                {
-                        RGB_color_name = strdup ("Hollywood Cerise");
-                        return (RGB_color_name);
-                }
-                case 0xFF00CC :
-                {
-                        RGB_color_name = strdup ("Hot Magenta");
-                        return (RGB_color_name);
-                }
-                case 0xFF69B4 :
-                {
-                        RGB_color_name = strdup ("Hot Pink");
-                        return (RGB_color_name);
-                }
-                case 0x00416A :
-                {
-                        RGB_color_name = strdup ("Indigo (dye)");
-                        return (RGB_color_name);
-                }
-                case 0x4B0082 :
-                {
-                        RGB_color_name = strdup ("Indigo (web)");
-                        return (RGB_color_name);
-                }
-                case 0x002FA7 :
-                {
-                        RGB_color_name = strdup ("International Klein Blue");
-                        return (RGB_color_name);
-                }
-                case 0xFF4F00 :
-                {
-                        RGB_color_name = strdup ("International orange");
-                        return (RGB_color_name);
-                }
-                case 0x009000 :
-                {
-                        RGB_color_name = strdup ("Islamic green");
-                        return (RGB_color_name);
-                }
-                case 0xFFFFF0 :
-                {
-                        RGB_color_name = strdup ("Ivory");
-                        return (RGB_color_name);
-                }
-                case 0x00A86B :
-                {
-                        RGB_color_name = strdup ("Jade");
-                        return (RGB_color_name);
-                }
-                case 0x4CBB17 :
-                {
-                        RGB_color_name = strdup ("Kelly green");
-                        return (RGB_color_name);
-                }
-                case 0xC3B091 :
-                {
-                        RGB_color_name = strdup ("Khaki");
-                        return (RGB_color_name);
-                }
-                case 0xF0E68C :
-                {
-                        RGB_color_name = strdup ("Khaki (X11) (Light khaki)");
-                        return (RGB_color_name);
-                }
-                case 0xB57EDC :
-                {
-                        RGB_color_name = strdup ("Lavender (floral)");
-                        return (RGB_color_name);
-                }
-                case 0xE6E6FA :
-                {
-                        RGB_color_name = strdup ("Lavender (web)");
-                        return (RGB_color_name);
-                }
-                case 0xCCCCFF :
-                {
-                        RGB_color_name = strdup ("Lavender blue");
-                        return (RGB_color_name);
-                }
-                case 0xFFF0F5 :
-                {
-                        RGB_color_name = strdup ("Lavender blush");
-                        return (RGB_color_name);
-                }
-                case 0xC4C3D0 :
-                {
-                        RGB_color_name = strdup ("Lavender gray");
-                        return (RGB_color_name);
-                }
-                case 0xEE82EE :
-                {
-                        RGB_color_name = strdup ("Lavender magenta");
-                        return (RGB_color_name);
-                }
-                case 0xFBAED2 :
-                {
-                        RGB_color_name = strdup ("Lavender pink");
-                        return (RGB_color_name);
-                }
-                case 0x967BB6 :
-                {
-                        RGB_color_name = strdup ("Lavender purple");
-                        return (RGB_color_name);
-                }
-                case 0xFBA0E3 :
-                {
-                        RGB_color_name = strdup ("Lavender rose");
-                        return (RGB_color_name);
-                }
-                case 0x7CFC00 :
-                {
-                        RGB_color_name = strdup ("Lawn green");
-                        return (RGB_color_name);
-                }
-                case 0xFDE910 :
-                {
-                        RGB_color_name = strdup ("Lemon");
-                        return (RGB_color_name);
-                }
-                case 0xFFFACD :
-                {
-                        RGB_color_name = strdup ("Lemon chifton");
-                        return (RGB_color_name);
-                }
-                case 0xADD8E6 :
-                {
-                        RGB_color_name = strdup ("Light blue");
-                        return (RGB_color_name);
-                }
-                case 0xFFB6C1 :
-                {
-                        RGB_color_name = strdup ("Light pink");
-                        return (RGB_color_name);
-                }
-                case 0xC8A2C8 :
-                {
-                        RGB_color_name = strdup ("Lilac");
-                        return (RGB_color_name);
-                }
-                case 0xBFFF00 :
-                {
-                        RGB_color_name = strdup ("Lime (color wheel)");
-                        return (RGB_color_name);
-                }
-/*
-                case 0x00FF00 :
-                {
-                        RGB_color_name = strdup ("Lime (web) (X11 green)");
-                        return (RGB_color_name);
-                }
-*/
-                case 0x32CD32 :
-                {
-                        RGB_color_name = strdup ("Lime green");
-                        return (RGB_color_name);
-                }
-                case 0xFAF0E6 :
-                {
-                        RGB_color_name = strdup ("Linen");
-                        return (RGB_color_name);
-                }
-                case 0xFF00FF :
-                {
-                        RGB_color_name = strdup ("Magenta");
-                        return (RGB_color_name);
-                }
-                case 0xCA1F7B :
-                {
-                        RGB_color_name = strdup ("Magenta (dye)");
-                        return (RGB_color_name);
-                }
-                case 0xFF0090 :
-                {
-                        RGB_color_name = strdup ("Magenta (process)");
-                        return (RGB_color_name);
-                }
-                case 0xAAF0D1 :
-                {
-                        RGB_color_name = strdup ("Magic mint");
-                        return (RGB_color_name);
-                }
-                case 0xF8F4FF :
-                {
-                        RGB_color_name = strdup ("Magnolia");
-                        return (RGB_color_name);
-                }
-                case 0x0BDA51 :
-                {
-                        RGB_color_name = strdup ("Malachite");
-                        return (RGB_color_name);
-                }
-                case 0x800000 :
-                {
-                        RGB_color_name = strdup ("Maroon (HTML/CSS)");
-                        return (RGB_color_name);
-                }
-                case 0xB03060 :
-                {
-                        RGB_color_name = strdup ("Maroon (X11)");
-                        return (RGB_color_name);
-                }
-                case 0x73C2FB :
-                {
-                        RGB_color_name = strdup ("Maya blue");
-                        return (RGB_color_name);
-                }
-                case 0xE0B0FF :
-                {
-                        RGB_color_name = strdup ("Mauve");
-                        return (RGB_color_name);
-                }
-                case 0x915F6D :
-                {
-                        RGB_color_name = strdup ("Mauve Taupe");
-                        return (RGB_color_name);
-                }
-                case 0x0000CD :
-                {
-                        RGB_color_name = strdup ("Medium blue");
-                        return (RGB_color_name);
-                }
-/*
-                case 0xAF4035 :
-                {
-                        RGB_color_name = strdup ("Medium carmine");
-                        return (RGB_color_name);
-                }
-*/
-                case 0xCC99CC :
-                {
-                        RGB_color_name = strdup ("Medium lavender magenta");
-                        return (RGB_color_name);
-                }
-                case 0x9370DB :
-                {
-                        RGB_color_name = strdup ("Medium purple");
-                        return (RGB_color_name);
-                }
-                case 0x00FA9A :
-                {
-                        RGB_color_name = strdup ("Medium spring green");
-                        return (RGB_color_name);
-                }
-                case 0x191970 :
-                {
-                        RGB_color_name = strdup ("Midnight Blue");
-                        return (RGB_color_name);
-                }
-                case 0x004953 :
-                {
-                        RGB_color_name = strdup ("Midnight Green (Eagle Green)");
-                        return (RGB_color_name);
-                }
-                case 0x98FF98 :
-                {
-                        RGB_color_name = strdup ("Mint green");
-                        return (RGB_color_name);
-                }
-                case 0xFFE4E1 :
-                {
-                        RGB_color_name = strdup ("Misty rose");
-                        return (RGB_color_name);
-                }
-                case 0xADDFAD :
-                {
-                        RGB_color_name = strdup ("Moss green");
-                        return (RGB_color_name);
-                }
-                case 0x997A8D :
-                {
-                        RGB_color_name = strdup ("Mountbatten pink");
-                        return (RGB_color_name);
-                }
-                case 0xFFDB58 :
-                {
-                        RGB_color_name = strdup ("Mustard");
-                        return (RGB_color_name);
-                }
-                case 0x21421E :
-                {
-                        RGB_color_name = strdup ("Myrtle");
-                        return (RGB_color_name);
-                }
-                case 0x006633 :
-                {
-                        RGB_color_name = strdup ("MSU Green");
-                        return (RGB_color_name);
-                }
-                case 0xFFDEAD :
-                {
-                        RGB_color_name = strdup ("Navajo white");
-                        return (RGB_color_name);
-                }
-                case 0x000080 :
-                {
-                        RGB_color_name = strdup ("Navy Blue");
-                        return (RGB_color_name);
-                }
-                case 0xCC7722 :
-                {
-                        RGB_color_name = strdup ("Ochre");
-                        return (RGB_color_name);
-                }
-                case 0x008000 :
-                {
-                        RGB_color_name = strdup ("Office green");
-                        return (RGB_color_name);
-                }
-                case 0xCFB53B :
-                {
-                        RGB_color_name = strdup ("Old Gold");
-                        return (RGB_color_name);
-                }
-                case 0xFDF5E6 :
-                {
-                        RGB_color_name = strdup ("Old Lace");
-                        return (RGB_color_name);
-                }
-                case 0x796878 :
-                {
-                        RGB_color_name = strdup ("Old Lavender");
-                        return (RGB_color_name);
-                }
-                case 0xC08081 :
-                {
-                        RGB_color_name = strdup ("Old Rose");
-                        return (RGB_color_name);
-                }
-                case 0x808000 :
-                {
-                        RGB_color_name = strdup ("Olive");
-                        return (RGB_color_name);
-                }
-                case 0x6B8E23 :
-                {
-                        RGB_color_name = strdup ("Olive Drab");
-                        return (RGB_color_name);
-                }
-                case 0x9AB973 :
-                {
-                        RGB_color_name = strdup ("Olivine");
-                        return (RGB_color_name);
-                }
-                case 0xFF7F00 :
-                {
-                        RGB_color_name = strdup ("Orange (color wheel)");
-                        return (RGB_color_name);
-                }
-                case 0xFB9902 :
-                {
-                        RGB_color_name = strdup ("Orange (RYB)");
-                        return (RGB_color_name);
-                }
-                case 0xFFA500 :
-                {
-                        RGB_color_name = strdup ("Orange (web)");
-                        return (RGB_color_name);
-                }
-                case 0xFFA000 :
-                {
-                        RGB_color_name = strdup ("Orange Peel");
-                        return (RGB_color_name);
-                }
-                case 0xFF4500 :
-                {
-                        RGB_color_name = strdup ("Orange-Red");
-                        return (RGB_color_name);
-                }
-                case 0xDA70D6 :
-                {
-                        RGB_color_name = strdup ("Orchid");
-                        return (RGB_color_name);
-                }
-                case 0xAFEEEE :
-                {
-                        RGB_color_name = strdup ("Pale blue");
-                        return (RGB_color_name);
-                }
-                case 0x987654 :
-                {
-                        RGB_color_name = strdup ("Pale brown");
-                        return (RGB_color_name);
-                }
-                case 0xAF4035 :
-                {
-                        RGB_color_name = strdup ("Pale carmine");
-                        return (RGB_color_name);
-                }
-                case 0xDDADAF :
-                {
-                        RGB_color_name = strdup ("Pale chestnut");
-                        return (RGB_color_name);
-                }
-                case 0xABCDEF :
-                {
-                        RGB_color_name = strdup ("Pale cornflower blue");
-                        return (RGB_color_name);
-                }
-                case 0xF984E5 :
-                {
-                        RGB_color_name = strdup ("Pale magenta");
-                        return (RGB_color_name);
-                }
-                case 0xFADADD :
-                {
-                        RGB_color_name = strdup ("Pale pink");
-                        return (RGB_color_name);
-                }
-                case 0xDB7093 :
-                {
-                        RGB_color_name = strdup ("Pale red-violet");
-                        return (RGB_color_name);
-                }
-                case 0xBC987E :
-                {
-                        RGB_color_name = strdup ("Pale taupe");
-                        return (RGB_color_name);
-                }
-                case 0xFFEFD5 :
-                {
-                        RGB_color_name = strdup ("Papaya whip");
-                        return (RGB_color_name);
-                }
-                case 0x77DD77 :
-                {
-                        RGB_color_name = strdup ("Pastel green");
-                        return (RGB_color_name);
-                }
-                case 0xFFD1DC :
-                {
-                        RGB_color_name = strdup ("Pastel pink");
-                        return (RGB_color_name);
-                }
-                case 0x40404F :
-                {
-                        RGB_color_name = strdup ("Payne's grey");
-                        return (RGB_color_name);
-                }
-                case 0xFFE5B4 :
-                {
-                        RGB_color_name = strdup ("Peach");
-                        return (RGB_color_name);
-                }
-                case 0xFFCC99 :
-                {
-                        RGB_color_name = strdup ("Peach-orange");
-                        return (RGB_color_name);
-                }
-                case 0xFADFAD :
-                {
-                        RGB_color_name = strdup ("Peach-yellow");
-                        return (RGB_color_name);
-                }
-                case 0xD1E231 :
-                {
-                        RGB_color_name = strdup ("Pear");
-                        return (RGB_color_name);
-                }
-/*
-                case 0xCCCCFF :
-                {
-                        RGB_color_name = strdup ("Periwinkle");
-                        return (RGB_color_name);
-                }
-*/
-                case 0x1C39BB :
-                {
-                        RGB_color_name = strdup ("Persian blue");
-                        return (RGB_color_name);
-                }
-                case 0x00A693 :
-                {
-                        RGB_color_name = strdup ("Persian green");
-                        return (RGB_color_name);
-                }
-                case 0x32127A :
-                {
-                        RGB_color_name = strdup ("Persian indigo");
-                        return (RGB_color_name);
-                }
-                case 0xD99058 :
-                {
-                        RGB_color_name = strdup ("Persian orange");
-                        return (RGB_color_name);
-                }
-                case 0xCC3333 :
-                {
-                        RGB_color_name = strdup ("Persian red");
-                        return (RGB_color_name);
-                }
-                case 0xF77FBE :
-                {
-                        RGB_color_name = strdup ("Persian pink");
-                        return (RGB_color_name);
-                }
-                case 0xFE28A2 :
-                {
-                        RGB_color_name = strdup ("Persian rose");
-                        return (RGB_color_name);
-                }
-                case 0xEC5800 :
-                {
-                        RGB_color_name = strdup ("Persimmon");
-                        return (RGB_color_name);
-                }
-                case 0x01796F :
-                {
-                        RGB_color_name = strdup ("Pine green");
-                        return (RGB_color_name);
-                }
-                case 0xFFC0CB :
-                {
-                        RGB_color_name = strdup ("Pink");
-                        return (RGB_color_name);
-                }
-                case 0xFF9966 :
-                {
-                        RGB_color_name = strdup ("Pink-orange");
-                        return (RGB_color_name);
-                }
-                case 0xE5E4E2 :
-                {
-                        RGB_color_name = strdup ("Platinum");
-                        return (RGB_color_name);
-                }
-/*
-                case 0xCC99CC :
-                {
-                        RGB_color_name = strdup ("Plum (web)");
-                        return (RGB_color_name);
-                }
-*/
-                case 0xFF5A36 :
-                {
-                        RGB_color_name = strdup ("Portland Orange");
-                        return (RGB_color_name);
-                }
-/*
-                case 0xB0E0E6 :
-                {
-                        RGB_color_name = strdup ("Powder blue (web)");
-                        return (RGB_color_name);
-                }
-*/
-                case 0xCC8899 :
-                {
-                        RGB_color_name = strdup ("Puce");
-                        return (RGB_color_name);
-                }
-                case 0x003153 :
-                {
-                        RGB_color_name = strdup ("Prusian blue");
-                        return (RGB_color_name);
-                }
-                case 0xDD00FF :
-                {
-                        RGB_color_name = strdup ("Psychedelic purple");
-                        return (RGB_color_name);
-                }
-                case 0xFF7518 :
-                {
-                        RGB_color_name = strdup ("Pumpkin");
-                        return (RGB_color_name);
-                }
-                case 0x7F007F :
-                {
-                        RGB_color_name = strdup ("Purple (HTML/CSS)");
-                        return (RGB_color_name);
-                }
-                case 0xA020F0 :
-                {
-                        RGB_color_name = strdup ("Purple (X11)");
-                        return (RGB_color_name);
-                }
-                case 0x50404D :
-                {
-                        RGB_color_name = strdup ("Purple Taupe");
-                        return (RGB_color_name);
-                }
-                case 0xE30B5C :
-                {
-                        RGB_color_name = strdup ("Raspberry");
-                        return (RGB_color_name);
-                }
-                case 0x734A12 :
-                {
-                        RGB_color_name = strdup ("Raw umber");
-                        return (RGB_color_name);
-                }
-                case 0xE3256B :
-                {
-                        RGB_color_name = strdup ("Razzmatazz");
-                        return (RGB_color_name);
-                }
-                case 0xFF0000 :
-                {
-                        RGB_color_name = strdup ("Red");
-                        return (RGB_color_name);
-                }
-                case 0xED1C24 :
-                {
-                        RGB_color_name = strdup ("Red (pigment)");
-                        return (RGB_color_name);
-                }
-                case 0xFE2712 :
-                {
-                        RGB_color_name = strdup ("Red (RYB)");
-                        return (RGB_color_name);
-                }
-                case 0xC71585 :
-                {
-                        RGB_color_name = strdup ("Red-violet");
-                        return (RGB_color_name);
-                }
-                case 0xD70040 :
-                {
-                        RGB_color_name = strdup ("Rich carmine");
-                        return (RGB_color_name);
-                }
-                case 0x00CCCC :
-                {
-                        RGB_color_name = strdup ("Robin egg blue");
-                        return (RGB_color_name);
-                }
-                case 0xFF007F :
-                {
-                        RGB_color_name = strdup ("Rose");
-                        return (RGB_color_name);
-                }
-                case 0xE32636 :
-                {
-                        RGB_color_name = strdup ("Rose Madder");
-                        return (RGB_color_name);
-                }
-                case 0xFF66CC :
-                {
-                        RGB_color_name = strdup ("Rose pink");
-                        return (RGB_color_name);
-                }
-                case 0xAA98A9 :
-                {
-                        RGB_color_name = strdup ("Rose quartz");
-                        return (RGB_color_name);
-                }
-                case 0x905D5D :
-                {
-                        RGB_color_name = strdup ("Rose Taupe");
-                        return (RGB_color_name);
-                }
-                case 0x4169E1 :
-                {
-                        RGB_color_name = strdup ("Royal blue");
-                        return (RGB_color_name);
-                }
-                case 0x6B3FA0 :
-                {
-                        RGB_color_name = strdup ("Royal purple");
-                        return (RGB_color_name);
-                }
-                case 0xE0115F :
-                {
-                        RGB_color_name = strdup ("Ruby");
-                        return (RGB_color_name);
-                }
-                case 0x80461B :
-                {
-                        RGB_color_name = strdup ("Russet");
-                        return (RGB_color_name);
-                }
-                case 0xB7410E :
-                {
-                        RGB_color_name = strdup ("Rust");
-                        return (RGB_color_name);
-                }
-                case 0xFF6600 :
-                {
-                        RGB_color_name = strdup ("Safety orange (blaze orange)");
-                        return (RGB_color_name);
-                }
-                case 0xF4C430 :
-                {
-                        RGB_color_name = strdup ("Saffron");
-                        return (RGB_color_name);
-                }
-                case 0xFF8C69 :
-                {
-                        RGB_color_name = strdup ("Salmon");
-                        return (RGB_color_name);
-                }
-                case 0xFF91A4 :
-                {
-                        RGB_color_name = strdup ("Salmon pink");
-                        return (RGB_color_name);
-                }
-                case 0xF4A460 :
-                {
-                        RGB_color_name = strdup ("Sandy brown");
-                        return (RGB_color_name);
-                }
-                case 0x92000A :
-                {
-                        RGB_color_name = strdup ("Sangria");
-                        return (RGB_color_name);
-                }
-                case 0x082567 :
-                {
-                        RGB_color_name = strdup ("Sapphire");
-                        return (RGB_color_name);
-                }
-                case 0xFF2400 :
-                {
-                        RGB_color_name = strdup ("Scarlet");
-                        return (RGB_color_name);
-                }
-                case 0xFFD800 :
-                {
-                        RGB_color_name = strdup ("School bus yellow");
-                        return (RGB_color_name);
-                }
-                case 0x2E8B57 :
-                {
-                        RGB_color_name = strdup ("Sea green");
-                        return (RGB_color_name);
-                }
-                case 0x321414 :
-                {
-                        RGB_color_name = strdup ("Seal brown");
-                        return (RGB_color_name);
-                }
-                case 0xFFF5EE :
-                {
-                        RGB_color_name = strdup ("Seashell");
-                        return (RGB_color_name);
-                }
-                case 0xFFBA00 :
-                {
-                        RGB_color_name = strdup ("Selective yellow");
-                        return (RGB_color_name);
-                }
-                case 0x704214 :
-                {
-                        RGB_color_name = strdup ("Sepia");
-                        return (RGB_color_name);
-                }
-                case 0x009E60 :
-                {
-                        RGB_color_name = strdup ("Shamrock green");
-                        return (RGB_color_name);
-                }
-                case 0xFC0FC0 :
-                {
-                        RGB_color_name = strdup ("Shocking pink");
-                        return (RGB_color_name);
-                }
-                case 0xA0522D :
-                {
-                        RGB_color_name = strdup ("Sienna");
-                        return (RGB_color_name);
-                }
-                case 0xC0C0C0 :
-                {
-                        RGB_color_name = strdup ("Silver");
-                        return (RGB_color_name);
-                }
-                case 0x87CEEB :
-                {
-                        RGB_color_name = strdup ("Sky Blue");
-                        return (RGB_color_name);
-                }
-                case 0x708090 :
-                {
-                        RGB_color_name = strdup ("Slate grey");
-                        return (RGB_color_name);
-                }
-                case 0x003399 :
-                {
-                        RGB_color_name = strdup ("Smalt (Dark powder blue)");
-                        return (RGB_color_name);
-                }
-                case 0xA7FC00 :
-                {
-                        RGB_color_name = strdup ("Spring bud");
-                        return (RGB_color_name);
-                }
-                case 0x00FF7F :
-                {
-                        RGB_color_name = strdup ("Spring green");
-                        return (RGB_color_name);
-                }
-                case 0x4682B4 :
-                {
-                        RGB_color_name = strdup ("Steel blue");
-                        return (RGB_color_name);
-                }
-                case 0xD2B48C :
-                {
-                        RGB_color_name = strdup ("Tan");
-                        return (RGB_color_name);
-                }
-                case 0xF28500 :
-                {
-                        RGB_color_name = strdup ("Tangerine");
-                        return (RGB_color_name);
-                }
-                case 0xFFCC00 :
-                {
-                        RGB_color_name = strdup ("Tangerine yellow");
-                        return (RGB_color_name);
-                }
-                case 0x483C32 :
-                {
-                        RGB_color_name = strdup ("Taupe");
-                        return (RGB_color_name);
-                }
-                case 0x8B8589 :
-                {
-                        RGB_color_name = strdup ("Taupe gray");
-                        return (RGB_color_name);
-                }
-                case 0xD0F0C0 :
-                {
-                        RGB_color_name = strdup ("Tea green");
-                        return (RGB_color_name);
-                }
-/*
-                case 0xF88379 :
-                {
-                        RGB_color_name = strdup ("Tea rose (orange)");
-                        return (RGB_color_name);
-                }
-*/
-                case 0xF4C2C2 :
-                {
-                        RGB_color_name = strdup ("Tea rose (rose)");
-                        return (RGB_color_name);
-                }
-                case 0x008080 :
-                {
-                        RGB_color_name = strdup ("Teal");
-                        return (RGB_color_name);
-                }
-                case 0xCD5700 :
-                {
-                        RGB_color_name = strdup ("Tenné (Tawny)");
-                        return (RGB_color_name);
-                }
-                case 0xE2725B :
-                {
-                        RGB_color_name = strdup ("Terra cotta");
-                        return (RGB_color_name);
-                }
-                case 0xD8BFD8 :
-                {
-                        RGB_color_name = strdup ("Thistle");
-                        return (RGB_color_name);
-                }
-                case 0xDE6FA1 :
-                {
-                        RGB_color_name = strdup ("Thullian pink");
-                        return (RGB_color_name);
-                }
-                case 0xFF6347 :
-                {
-                        RGB_color_name = strdup ("Tomato");
-                        return (RGB_color_name);
-                }
-                case 0x30D5C8 :
-                {
-                        RGB_color_name = strdup ("Turquoise");
-                        return (RGB_color_name);
-                }
-                case 0x66023C :
-                {
-                        RGB_color_name = strdup ("Tyrian Purple");
-                        return (RGB_color_name);
-                }
-                case 0x120A8F :
-                {
-                        RGB_color_name = strdup ("Ultramarine");
-                        return (RGB_color_name);
-                }
-                case 0xFF6FFF :
-                {
-                        RGB_color_name = strdup ("Ultra pink");
-                        return (RGB_color_name);
-                }
-                case 0x5B92E5 :
-                {
-                        RGB_color_name = strdup ("United Nations blue");
-                        return (RGB_color_name);
-                }
-                case 0xAE2029 :
-                {
-                        RGB_color_name = strdup ("Upsdell red");
-                        return (RGB_color_name);
-                }
-                case 0xC5B358 :
-                {
-                        RGB_color_name = strdup ("Vegas Gold");
-                        return (RGB_color_name);
-                }
-                case 0xC80815 :
-                {
-                        RGB_color_name = strdup ("Venetian red");
-                        return (RGB_color_name);
-                }
-                case 0xE34234 :
-                {
-                        RGB_color_name = strdup ("Vermilion");
-                        return (RGB_color_name);
-                }
-                case 0x8B00FF :
-                {
-                        RGB_color_name = strdup ("Violet");
-                        return (RGB_color_name);
-                }
-/*
-                case 0xEE82EE :
-                {
-                        RGB_color_name = strdup ("Violet (web)");
-                        return (RGB_color_name);
-                }
-*/
-                case 0x8601AF :
-                {
-                        RGB_color_name = strdup ("Violet (RYB)");
-                        return (RGB_color_name);
-                }
-                case 0x40826D :
-                {
-                        RGB_color_name = strdup ("Viridian");
-                        return (RGB_color_name);
-                }
-                case 0xF5DEB3 :
-                {
-                        RGB_color_name = strdup ("Wheat");
-                        return (RGB_color_name);
-                }
-                case 0xFFFFFF :
-                {
-                        RGB_color_name = strdup ("White");
-                        return (RGB_color_name);
-                }
-                case 0xC9A0DC :
-                {
-                        RGB_color_name = strdup ("Wisteria");
-                        return (RGB_color_name);
-                }
-                case 0x738678 :
-                {
-                        RGB_color_name = strdup ("Xanadu");
-                        return (RGB_color_name);
-                }
-                case 0x0F4D92 :
-                {
-                        RGB_color_name = strdup ("Yale Blue");
-                        return (RGB_color_name);
-                }
-                case 0xFFFF00 :
-                {
-                        RGB_color_name = strdup ("Yellow");
-                        return (RGB_color_name);
-                }
-                case 0xFFEF00 :
-                {
-                        RGB_color_name = strdup ("Yellow (process)");
-                        return (RGB_color_name);
-                }
-                case 0xFEFE33 :
-                {
-                        RGB_color_name = strdup ("Yellow (RYB)");
-                        return (RGB_color_name);
-                }
-                case 0x9ACD32 :
-                {
-                        RGB_color_name = strdup ("Yellow-green");
-                        return (RGB_color_name);
-                }
-                default:
+                dxf_RGB_color_name_hash_ready = 1;
+        }
+        slot = dxf_RGB_color_name_hash (RGB_color_hex_triplet);
+        while (dxf_RGB_color_name_hash_index[slot] != -1)
+        {
+                i = dxf_RGB_color_name_hash_index[slot];
+                if (dxf_RGB_color_name_table[i].triplet == RGB_color_hex_triplet)
                 {
-                        return (NULL);
+                        return (strdup (dxf_RGB_color_name_table[i].name));
                 }
+                slot = (slot + 1) & (DXF_RGB_COLOR_NAME_HASH_SIZE - 1);
         }
 #if DEBUG
         DXF_DEBUG_END
 #endif
+        return (NULL);
 }
 
 
@@ -2241,7 +972,7 @@ dxf_RGB_color_free
               return (EXIT_FAILURE);
         }
         free (dxf_RGB_color->name);
-        free (dxf_RGB_color);
+        dxf_entity_dealloc (dxf_RGB_color, sizeof (*dxf_RGB_color));
         dxf_RGB_color = NULL;
 #ifdef DEBUG
         DXF_DEBUG_END
@@ -31,7 +31,9 @@
  * <hr>
  */
 
+#include <pthread.h>
 #include "comment.h"
+#include "allocator.h"
 
 /*!
  * \brief Allocate memory for a DXF \c COMMENT.
@@ -50,7 +52,7 @@ dxf_comment_new ()
         size = sizeof (DxfComment);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_comment = malloc (size)) == NULL)
+        if ((dxf_comment = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfComment struct.\n")),
@@ -85,6 +87,11 @@ dxf_comment_init
 #ifdef DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfComment template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         /* Do some basic checks. */
         if (dxf_comment == NULL)
         {
@@ -100,9 +107,17 @@ dxf_comment_init
                   __FUNCTION__);
                 return (NULL);
         }
-        dxf_comment->id_code = 0;
-        dxf_comment->value = strdup ("");
-        dxf_comment->next = NULL;
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.id_code = 0;
+                template.value = strdup ("");
+                template.next = NULL;
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (dxf_comment, &template, sizeof (DxfComment));
+        dxf_comment->value = strdup (template.value);
 #ifdef DEBUG
         DXF_DEBUG_END
 #endif
@@ -174,7 +189,7 @@ dxf_comment_free
               return (EXIT_FAILURE);
         }
         free (dxf_comment->value);
-        free (dxf_comment);
+        dxf_entity_dealloc (dxf_comment, sizeof (*dxf_comment));
         dxf_comment = NULL;
 #ifdef DEBUG
         DXF_DEBUG_END
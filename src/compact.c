@@ -0,0 +1,587 @@
+/*!
+ * \file compact.c
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Compact entity storage with lazily allocated optional-field
+ * blocks.
+ *
+ * The full entity structs carry every rarely used member inline, which
+ * makes each entity well over a hundred bytes even when only the
+ * coordinates matter.\n
+ * The compact structs keep a hot core of coordinates, layer, handle
+ * and color, and allocate a shared \c DxfEntityExtra block only when
+ * an optional member actually holds a non-default value, so bulk
+ * storage of a large drawing shrinks to roughly the size of its
+ * geometry.\n
+ * The \c pack and \c unpack functions convert losslessly to and from
+ * the full structs, so all existing per-entity functions keep working
+ * on the unpacked form.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#include "compact.h"
+
+
+/*!
+ * \brief Test whether an optional string member holds its default.
+ */
+static int
+dxf_compact_string_is_default
+(
+        const char *string,
+                /*!< the member value, or \c NULL. */
+        const char *default_string
+                /*!< the documented default, or \c NULL when the
+                 * default is the empty string. */
+)
+{
+        if ((string == NULL) || (strcmp (string, "") == 0))
+        {
+                return (TRUE);
+        }
+        if ((default_string != NULL)
+                && (strcmp (string, default_string) == 0))
+        {
+                return (TRUE);
+        }
+        return (FALSE);
+}
+
+
+/*!
+ * \brief Pack the rarely used common members of an entity into a
+ * lazily allocated \c DxfEntityExtra block.
+ *
+ * When every member holds its default no block is allocated and
+ * \c *extra is set to \c NULL.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when no memory
+ * was allocated.
+ */
+static int
+dxf_compact_extra_pack
+(
+        DxfEntityExtra **extra,
+                /*!< where to store the allocated block, or \c NULL. */
+        const char *linetype,
+                /*!< the linetype of the entity. */
+        double elevation,
+                /*!< the elevation of the entity. */
+        double thickness,
+                /*!< the thickness of the entity. */
+        double linetype_scale,
+                /*!< the linetype scale of the entity. */
+        int16_t visibility,
+                /*!< the object visibility of the entity. */
+        int paperspace,
+                /*!< the \c PAPERSPACE or \c MODELSPACE flag. */
+        const char *dictionary_owner_soft,
+                /*!< the soft-pointer ID/handle to the owner dictionary. */
+        const char *dictionary_owner_hard,
+                /*!< the hard owner ID/handle to the owner dictionary. */
+        double extr_x0,
+                /*!< X-value of the extrusion direction. */
+        double extr_y0,
+                /*!< Y-value of the extrusion direction. */
+        double extr_z0
+                /*!< Z-value of the extrusion direction. */
+)
+{
+        *extra = NULL;
+        if (dxf_compact_string_is_default (linetype, DXF_DEFAULT_LINETYPE)
+                && (elevation == 0.0)
+                && (thickness == 0.0)
+                && (linetype_scale == DXF_DEFAULT_LINETYPE_SCALE)
+                && (visibility == DXF_DEFAULT_VISIBILITY)
+                && (paperspace == DXF_MODELSPACE)
+                && dxf_compact_string_is_default (dictionary_owner_soft, NULL)
+                && dxf_compact_string_is_default (dictionary_owner_hard, NULL)
+                && (extr_x0 == 0.0)
+                && (extr_y0 == 0.0)
+                && (extr_z0 == 0.0))
+        {
+                return (EXIT_SUCCESS);
+        }
+        *extra = calloc (1, sizeof (DxfEntityExtra));
+        if (*extra == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (!dxf_compact_string_is_default (linetype, DXF_DEFAULT_LINETYPE))
+        {
+                (*extra)->linetype = strdup (linetype);
+        }
+        (*extra)->elevation = elevation;
+        (*extra)->thickness = thickness;
+        (*extra)->linetype_scale = linetype_scale;
+        (*extra)->visibility = visibility;
+        (*extra)->paperspace = paperspace;
+        if (!dxf_compact_string_is_default (dictionary_owner_soft, NULL))
+        {
+                (*extra)->dictionary_owner_soft = strdup (dictionary_owner_soft);
+        }
+        if (!dxf_compact_string_is_default (dictionary_owner_hard, NULL))
+        {
+                (*extra)->dictionary_owner_hard = strdup (dictionary_owner_hard);
+        }
+        (*extra)->extr_x0 = extr_x0;
+        (*extra)->extr_y0 = extr_y0;
+        (*extra)->extr_z0 = extr_z0;
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Free a lazily allocated \c DxfEntityExtra block.
+ */
+static void
+dxf_compact_extra_free
+(
+        DxfEntityExtra *extra
+                /*!< the block to free, or \c NULL. */
+)
+{
+        if (extra == NULL)
+        {
+                return;
+        }
+        free (extra->linetype);
+        free (extra->dictionary_owner_soft);
+        free (extra->dictionary_owner_hard);
+        free (extra);
+}
+
+
+/*!
+ * \brief Pack a \c LINE entity into its compact form.
+ *
+ * The optional-field block is allocated only when an optional member
+ * holds a non-default value.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_compact_line_pack
+(
+        DxfCompactLine *compact,
+                /*!< the compact storage to fill in. */
+        DxfLine *line
+                /*!< the \c LINE entity to pack. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        /* Do some basic checks. */
+        if ((compact == NULL) || (line == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        compact->id_code = line->id_code;
+        compact->color = line->color;
+        compact->layer = strdup ((line->layer != NULL) ? line->layer : DXF_DEFAULT_LAYER);
+        compact->x0 = line->x0;
+        compact->y0 = line->y0;
+        compact->z0 = line->z0;
+        compact->x1 = line->x1;
+        compact->y1 = line->y1;
+        compact->z1 = line->z1;
+        if (dxf_compact_extra_pack (&compact->extra, line->linetype,
+                line->elevation, line->thickness, line->linetype_scale,
+                line->visibility, line->paperspace,
+                line->dictionary_owner_soft, line->dictionary_owner_hard,
+                line->extr_x0, line->extr_y0, line->extr_z0) != EXIT_SUCCESS)
+        {
+                return (EXIT_FAILURE);
+        }
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Unpack a compact \c LINE into a full \c DxfLine struct.
+ *
+ * Optional members absent from the compact form are restored to their
+ * defaults, so all existing \c DxfLine functions keep working on the
+ * result.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_compact_line_unpack
+(
+        DxfCompactLine *compact,
+                /*!< the compact storage to read from. */
+        DxfLine *line
+                /*!< the \c LINE entity to fill in. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        DxfEntityExtra *extra;
+
+        /* Do some basic checks. */
+        if ((compact == NULL) || (line == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        extra = compact->extra;
+        line->id_code = compact->id_code;
+        line->color = compact->color;
+        line->layer = strdup ((compact->layer != NULL) ? compact->layer : DXF_DEFAULT_LAYER);
+        line->x0 = compact->x0;
+        line->y0 = compact->y0;
+        line->z0 = compact->z0;
+        line->x1 = compact->x1;
+        line->y1 = compact->y1;
+        line->z1 = compact->z1;
+        line->linetype = strdup (((extra != NULL) && (extra->linetype != NULL)) ?
+                extra->linetype : DXF_DEFAULT_LINETYPE);
+        line->elevation = (extra != NULL) ? extra->elevation : 0.0;
+        line->thickness = (extra != NULL) ? extra->thickness : 0.0;
+        line->linetype_scale = (extra != NULL) ? extra->linetype_scale : DXF_DEFAULT_LINETYPE_SCALE;
+        line->visibility = (extra != NULL) ? extra->visibility : DXF_DEFAULT_VISIBILITY;
+        line->paperspace = (extra != NULL) ? extra->paperspace : DXF_MODELSPACE;
+        line->dictionary_owner_soft = strdup (((extra != NULL) && (extra->dictionary_owner_soft != NULL)) ?
+                extra->dictionary_owner_soft : "");
+        line->dictionary_owner_hard = strdup (((extra != NULL) && (extra->dictionary_owner_hard != NULL)) ?
+                extra->dictionary_owner_hard : "");
+        line->extr_x0 = (extra != NULL) ? extra->extr_x0 : 0.0;
+        line->extr_y0 = (extra != NULL) ? extra->extr_y0 : 0.0;
+        line->extr_z0 = (extra != NULL) ? extra->extr_z0 : 0.0;
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Free the members of a compact \c LINE.
+ */
+void
+dxf_compact_line_free
+(
+        DxfCompactLine *compact
+                /*!< the compact storage to free, or \c NULL. */
+)
+{
+        if (compact == NULL)
+        {
+                return;
+        }
+        free (compact->layer);
+        compact->layer = NULL;
+        dxf_compact_extra_free (compact->extra);
+        compact->extra = NULL;
+}
+
+
+/*!
+ * \brief Pack a \c CIRCLE entity into its compact form.
+ *
+ * The optional-field block is allocated only when an optional member
+ * holds a non-default value.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_compact_circle_pack
+(
+        DxfCompactCircle *compact,
+                /*!< the compact storage to fill in. */
+        DxfCircle *circle
+                /*!< the \c CIRCLE entity to pack. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        /* Do some basic checks. */
+        if ((compact == NULL) || (circle == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        compact->id_code = circle->id_code;
+        compact->color = circle->color;
+        compact->layer = strdup ((circle->layer != NULL) ? circle->layer : DXF_DEFAULT_LAYER);
+        compact->x0 = circle->x0;
+        compact->y0 = circle->y0;
+        compact->z0 = circle->z0;
+        compact->radius = circle->radius;
+        if (dxf_compact_extra_pack (&compact->extra, circle->linetype,
+                circle->elevation, circle->thickness, circle->linetype_scale,
+                circle->visibility, circle->paperspace,
+                circle->dictionary_owner_soft, circle->dictionary_owner_hard,
+                circle->extr_x0, circle->extr_y0, circle->extr_z0) != EXIT_SUCCESS)
+        {
+                return (EXIT_FAILURE);
+        }
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Unpack a compact \c CIRCLE into a full \c DxfCircle struct.
+ *
+ * Optional members absent from the compact form are restored to their
+ * defaults, so all existing \c DxfCircle functions keep working on the
+ * result.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_compact_circle_unpack
+(
+        DxfCompactCircle *compact,
+                /*!< the compact storage to read from. */
+        DxfCircle *circle
+                /*!< the \c CIRCLE entity to fill in. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        DxfEntityExtra *extra;
+
+        /* Do some basic checks. */
+        if ((compact == NULL) || (circle == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        extra = compact->extra;
+        circle->id_code = compact->id_code;
+        circle->color = compact->color;
+        circle->layer = strdup ((compact->layer != NULL) ? compact->layer : DXF_DEFAULT_LAYER);
+        circle->x0 = compact->x0;
+        circle->y0 = compact->y0;
+        circle->z0 = compact->z0;
+        circle->radius = compact->radius;
+        circle->linetype = strdup (((extra != NULL) && (extra->linetype != NULL)) ?
+                extra->linetype : DXF_DEFAULT_LINETYPE);
+        circle->elevation = (extra != NULL) ? extra->elevation : 0.0;
+        circle->thickness = (extra != NULL) ? extra->thickness : 0.0;
+        circle->linetype_scale = (extra != NULL) ? extra->linetype_scale : DXF_DEFAULT_LINETYPE_SCALE;
+        circle->visibility = (extra != NULL) ? extra->visibility : DXF_DEFAULT_VISIBILITY;
+        circle->paperspace = (extra != NULL) ? extra->paperspace : DXF_MODELSPACE;
+        circle->dictionary_owner_soft = strdup (((extra != NULL) && (extra->dictionary_owner_soft != NULL)) ?
+                extra->dictionary_owner_soft : "");
+        circle->dictionary_owner_hard = strdup (((extra != NULL) && (extra->dictionary_owner_hard != NULL)) ?
+                extra->dictionary_owner_hard : "");
+        circle->extr_x0 = (extra != NULL) ? extra->extr_x0 : 0.0;
+        circle->extr_y0 = (extra != NULL) ? extra->extr_y0 : 0.0;
+        circle->extr_z0 = (extra != NULL) ? extra->extr_z0 : 0.0;
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Free the members of a compact \c CIRCLE.
+ */
+void
+dxf_compact_circle_free
+(
+        DxfCompactCircle *compact
+                /*!< the compact storage to free, or \c NULL. */
+)
+{
+        if (compact == NULL)
+        {
+                return;
+        }
+        free (compact->layer);
+        compact->layer = NULL;
+        dxf_compact_extra_free (compact->extra);
+        compact->extra = NULL;
+}
+
+
+/*!
+ * \brief Pack a \c POINT entity into its compact form.
+ *
+ * The optional-field block is allocated only when an optional member
+ * holds a non-default value.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_compact_point_pack
+(
+        DxfCompactPoint *compact,
+                /*!< the compact storage to fill in. */
+        DxfPoint *point
+                /*!< the \c POINT entity to pack. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        /* Do some basic checks. */
+        if ((compact == NULL) || (point == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        compact->id_code = point->id_code;
+        compact->color = point->color;
+        compact->layer = strdup ((point->layer != NULL) ? point->layer : DXF_DEFAULT_LAYER);
+        compact->x0 = point->x0;
+        compact->y0 = point->y0;
+        compact->z0 = point->z0;
+        compact->angle_to_X = point->angle_to_X;
+        if (dxf_compact_extra_pack (&compact->extra, point->linetype,
+                point->elevation, point->thickness, point->linetype_scale,
+                point->visibility, point->paperspace,
+                point->dictionary_owner_soft, point->dictionary_owner_hard,
+                point->extr_x0, point->extr_y0, point->extr_z0) != EXIT_SUCCESS)
+        {
+                return (EXIT_FAILURE);
+        }
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Unpack a compact \c POINT into a full \c DxfPoint struct.
+ *
+ * Optional members absent from the compact form are restored to their
+ * defaults, so all existing \c DxfPoint functions keep working on the
+ * result.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_compact_point_unpack
+(
+        DxfCompactPoint *compact,
+                /*!< the compact storage to read from. */
+        DxfPoint *point
+                /*!< the \c POINT entity to fill in. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        DxfEntityExtra *extra;
+
+        /* Do some basic checks. */
+        if ((compact == NULL) || (point == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        extra = compact->extra;
+        point->id_code = compact->id_code;
+        point->color = compact->color;
+        point->layer = strdup ((compact->layer != NULL) ? compact->layer : DXF_DEFAULT_LAYER);
+        point->x0 = compact->x0;
+        point->y0 = compact->y0;
+        point->z0 = compact->z0;
+        point->angle_to_X = compact->angle_to_X;
+        point->linetype = strdup (((extra != NULL) && (extra->linetype != NULL)) ?
+                extra->linetype : DXF_DEFAULT_LINETYPE);
+        point->elevation = (extra != NULL) ? extra->elevation : 0.0;
+        point->thickness = (extra != NULL) ? extra->thickness : 0.0;
+        point->linetype_scale = (extra != NULL) ? extra->linetype_scale : DXF_DEFAULT_LINETYPE_SCALE;
+        point->visibility = (extra != NULL) ? extra->visibility : DXF_DEFAULT_VISIBILITY;
+        point->paperspace = (extra != NULL) ? extra->paperspace : DXF_MODELSPACE;
+        point->dictionary_owner_soft = strdup (((extra != NULL) && (extra->dictionary_owner_soft != NULL)) ?
+                extra->dictionary_owner_soft : "");
+        point->dictionary_owner_hard = strdup (((extra != NULL) && (extra->dictionary_owner_hard != NULL)) ?
+                extra->dictionary_owner_hard : "");
+        point->extr_x0 = (extra != NULL) ? extra->extr_x0 : 0.0;
+        point->extr_y0 = (extra != NULL) ? extra->extr_y0 : 0.0;
+        point->extr_z0 = (extra != NULL) ? extra->extr_z0 : 0.0;
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Free the members of a compact \c POINT.
+ */
+void
+dxf_compact_point_free
+(
+        DxfCompactPoint *compact
+                /*!< the compact storage to free, or \c NULL. */
+)
+{
+        if (compact == NULL)
+        {
+                return;
+        }
+        free (compact->layer);
+        compact->layer = NULL;
+        dxf_compact_extra_free (compact->extra);
+        compact->extra = NULL;
+}
+
+
+/* EOF */
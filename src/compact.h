@@ -0,0 +1,249 @@
+/*!
+ * \file compact.h
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Header for compact entity storage with lazily allocated
+ * optional-field blocks.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#ifndef LIBDXF_SRC_COMPACT_H
+#define LIBDXF_SRC_COMPACT_H
+
+
+#include "global.h"
+#include "line.h"
+#include "circle.h"
+#include "point.h"
+
+
+/*!
+ * \brief Lazily allocated block for the rarely used common entity
+ * members.
+ *
+ * The full entity structs (\c DxfLine and siblings) carry every
+ * optional member inline; the compact structs below keep only the hot
+ * core (coordinates, layer, handle, color) and point here when an
+ * optional member holds a non-default value.\n
+ * A \c NULL block, and \c NULL string members within an allocated
+ * block, stand for the documented defaults.
+ */
+typedef struct
+dxf_entity_extra
+{
+        char *linetype;
+                /*!< the linetype, or \c NULL for the default
+                 * \c BYLAYER.\n
+                 * Group code = 6. */
+        double elevation;
+                /*!< elevation in the local Z-direction.\n
+                 * Group code = 38. */
+        double thickness;
+                /*!< thickness in the local Z-direction.\n
+                 * Group code = 39. */
+        double linetype_scale;
+                /*!< linetype scale.\n
+                 * Group code = 48. */
+        int16_t visibility;
+                /*!< object visibility.\n
+                 * Group code = 60. */
+        int paperspace;
+                /*!< \c PAPERSPACE or \c MODELSPACE flag.\n
+                 * Group code = 67. */
+        char *dictionary_owner_soft;
+                /*!< soft-pointer ID/handle to owner dictionary, or
+                 * \c NULL when absent.\n
+                 * Group code = 330. */
+        char *dictionary_owner_hard;
+                /*!< hard owner ID/handle to owner dictionary, or
+                 * \c NULL when absent.\n
+                 * Group code = 360. */
+        double extr_x0;
+                /*!< X-value of the extrusion direction.\n
+                 * Group code = 210. */
+        double extr_y0;
+                /*!< Y-value of the extrusion direction.\n
+                 * Group code = 220. */
+        double extr_z0;
+                /*!< Z-value of the extrusion direction.\n
+                 * Group code = 230. */
+} DxfEntityExtra;
+
+
+/*!
+ * \brief Compact storage for a \c LINE entity.
+ */
+typedef struct
+dxf_compact_line
+{
+        int id_code;
+                /*!< identification number of the entity.\n
+                 * Group code = 5. */
+        int color;
+                /*!< color of the entity.\n
+                 * Group code = 62. */
+        char *layer;
+                /*!< layer on which the entity is drawn.\n
+                 * Group code = 8. */
+        double x0;
+                /*!< X-value of the start point. */
+        double y0;
+                /*!< Y-value of the start point. */
+        double z0;
+                /*!< Z-value of the start point. */
+        double x1;
+                /*!< X-value of the end point. */
+        double y1;
+                /*!< Y-value of the end point. */
+        double z1;
+                /*!< Z-value of the end point. */
+        DxfEntityExtra *extra;
+                /*!< optional members, or \c NULL when they all hold
+                 * their defaults. */
+} DxfCompactLine;
+
+
+/*!
+ * \brief Compact storage for a \c CIRCLE entity.
+ */
+typedef struct
+dxf_compact_circle
+{
+        int id_code;
+                /*!< identification number of the entity.\n
+                 * Group code = 5. */
+        int color;
+                /*!< color of the entity.\n
+                 * Group code = 62. */
+        char *layer;
+                /*!< layer on which the entity is drawn.\n
+                 * Group code = 8. */
+        double x0;
+                /*!< X-value of the base point. */
+        double y0;
+                /*!< Y-value of the base point. */
+        double z0;
+                /*!< Z-value of the base point. */
+        double radius;
+                /*!< the radius.\n
+                 * Group code = 40. */
+        DxfEntityExtra *extra;
+                /*!< optional members, or \c NULL when they all hold
+                 * their defaults. */
+} DxfCompactCircle;
+
+
+/*!
+ * \brief Compact storage for a \c POINT entity.
+ */
+typedef struct
+dxf_compact_point
+{
+        int id_code;
+                /*!< identification number of the entity.\n
+                 * Group code = 5. */
+        int color;
+                /*!< color of the entity.\n
+                 * Group code = 62. */
+        char *layer;
+                /*!< layer on which the entity is drawn.\n
+                 * Group code = 8. */
+        double x0;
+                /*!< X-value of the point. */
+        double y0;
+                /*!< Y-value of the point. */
+        double z0;
+                /*!< Z-value of the point. */
+        double angle_to_X;
+                /*!< angle of the X axis for the UCS in effect when the
+                 * point was drawn.\n
+                 * Group code = 50. */
+        DxfEntityExtra *extra;
+                /*!< optional members, or \c NULL when they all hold
+                 * their defaults. */
+} DxfCompactPoint;
+
+
+int
+dxf_compact_line_pack
+(
+        DxfCompactLine *compact,
+        DxfLine *line
+);
+int
+dxf_compact_line_unpack
+(
+        DxfCompactLine *compact,
+        DxfLine *line
+);
+void
+dxf_compact_line_free
+(
+        DxfCompactLine *compact
+);
+int
+dxf_compact_circle_pack
+(
+        DxfCompactCircle *compact,
+        DxfCircle *circle
+);
+int
+dxf_compact_circle_unpack
+(
+        DxfCompactCircle *compact,
+        DxfCircle *circle
+);
+void
+dxf_compact_circle_free
+(
+        DxfCompactCircle *compact
+);
+int
+dxf_compact_point_pack
+(
+        DxfCompactPoint *compact,
+        DxfPoint *point
+);
+int
+dxf_compact_point_unpack
+(
+        DxfCompactPoint *compact,
+        DxfPoint *point
+);
+void
+dxf_compact_point_free
+(
+        DxfCompactPoint *compact
+);
+
+
+#endif /* LIBDXF_SRC_COMPACT_H */
+
+
+/* EOF */
@@ -0,0 +1,173 @@
+/*!
+ * \file config.c
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.
+ *
+ * \brief Functions for the runtime configuration of limits and growth
+ * policies.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#include <string.h>
+#include "config.h"
+
+
+/*!
+ * The process wide default configuration, consulted by the paths that
+ * run without a document context (the shared line buffer, the growable
+ * containers).
+ */
+static DxfConfig dxf_config_default;
+
+
+static int dxf_config_default_ready = 0;
+
+
+/*!
+ * \brief Initialize a \c DxfConfig with the default limits and growth
+ * policy.
+ *
+ * The defaults reproduce the historic behavior: no admission limits,
+ * the default arena block size, the containers' own first capacities,
+ * and doubling growth.
+ */
+void
+dxf_config_init
+(
+        DxfConfig *config
+                /*!< the configuration to initialize. */
+)
+{
+        if (config == NULL)
+        {
+                return;
+        }
+        config->max_string_length = 0;
+        config->max_layers = 0;
+        config->arena_block_size = 0;
+        config->initial_capacity = 0;
+        config->growth_numerator = 2;
+        config->growth_denominator = 1;
+}
+
+
+/*!
+ * \brief Compute the next capacity of a growable container.
+ *
+ * For a \c capacity of \c 0 the configured initial capacity is
+ * returned; \c 0 tells the caller to use the container's own first
+ * capacity.\n
+ * Otherwise the capacity is scaled by the configured growth factor,
+ * never by less than one element, so growth terminates for any
+ * configured factor.
+ *
+ * \return the next capacity in elements.
+ */
+size_t
+dxf_config_grow
+(
+        const DxfConfig *config,
+                /*!< the configuration, or \c NULL for the process wide
+                 * default. */
+        size_t capacity
+                /*!< the current capacity in elements. */
+)
+{
+        size_t grown;
+
+        if (config == NULL)
+        {
+                config = dxf_config_get ();
+        }
+        if (capacity == 0)
+        {
+                return (config->initial_capacity);
+        }
+        if (config->growth_denominator == 0)
+        {
+                grown = capacity * 2;
+        }
+        else
+        {
+                grown = (capacity * config->growth_numerator)
+                        / config->growth_denominator;
+        }
+        if (grown <= capacity)
+        {
+                grown = capacity + 1;
+        }
+        return (grown);
+}
+
+
+/*!
+ * \brief Replace the process wide default configuration.
+ *
+ * Passing \c NULL restores the defaults of \c dxf_config_init().
+ */
+void
+dxf_config_set
+(
+        const DxfConfig *config
+                /*!< the configuration to copy, or \c NULL. */
+)
+{
+        if (config == NULL)
+        {
+                dxf_config_init (&dxf_config_default);
+        }
+        else
+        {
+                memcpy (&dxf_config_default, config, sizeof (DxfConfig));
+        }
+        dxf_config_default_ready = 1;
+}
+
+
+/*!
+ * \brief Get the process wide default configuration.
+ *
+ * \return a pointer to the default configuration; the caller must not
+ * free it.
+ */
+const DxfConfig *
+dxf_config_get
+(
+        void
+)
+{
+        if (!dxf_config_default_ready)
+        {
+                dxf_config_init (&dxf_config_default);
+                dxf_config_default_ready = 1;
+        }
+        return (&dxf_config_default);
+}
+
+
+/* EOF */
@@ -0,0 +1,112 @@
+/*!
+ * \file config.h
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Header for the runtime configuration of limits and growth
+ * policies.
+ *
+ * The compile time maxima of global.h (\c DXF_MAX_PARAM,
+ * \c DXF_MAX_STRING_LENGTH, ...) size one binary for one workload:
+ * they either truncate large files or oversize every allocation of
+ * small ones.\n
+ * A \c DxfConfig carries the equivalent limits at runtime, plus the
+ * growth policy of the growable containers; every document context
+ * holds one (see \c DxfDocument), and a process wide default governs
+ * the paths that run without a document.\n
+ * The fixed inline arrays of the legacy entity structs keep their
+ * compile time sizes; the configuration governs the dynamic paths
+ * (arena sizing, container growth, the unbounded line buffer, the
+ * layer registry).
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#ifndef LIBDXF_SRC_CONFIG_H
+#define LIBDXF_SRC_CONFIG_H
+
+
+#include <stddef.h>
+
+
+/*!
+ * \brief Runtime limits and growth policies.
+ *
+ * A limit of \c 0 means unlimited.
+ */
+typedef struct
+dxf_config
+{
+        size_t max_string_length;
+                /*!< largest admitted length of one value line in
+                 * bytes; longer lines fail the read instead of
+                 * growing the line buffer without bound. */
+        size_t max_layers;
+                /*!< largest admitted number of layers in a layer
+                 * registry. */
+        size_t arena_block_size;
+                /*!< bytes per arena block of a document arena; \c 0
+                 * selects the arena default. */
+        size_t initial_capacity;
+                /*!< first nonzero capacity of a growable container,
+                 * in elements. */
+        size_t growth_numerator;
+                /*!< numerator of the growth factor of the growable
+                 * containers. */
+        size_t growth_denominator;
+                /*!< denominator of the growth factor; the default
+                 * policy 2/1 doubles. */
+} DxfConfig;
+
+
+void
+dxf_config_init
+(
+        DxfConfig *config
+);
+size_t
+dxf_config_grow
+(
+        const DxfConfig *config,
+        size_t capacity
+);
+void
+dxf_config_set
+(
+        const DxfConfig *config
+);
+const DxfConfig *
+dxf_config_get
+(
+        void
+);
+
+
+#endif /* LIBDXF_SRC_CONFIG_H */
+
+
+/* EOF */
@@ -0,0 +1,301 @@
+/*!
+ * \file dash_cache.c
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Functions for the flyweight cache of \c LTYPE dash patterns.
+ *
+ * The cache is process wide, like the string intern pool and the
+ * \c CLASSES section cache: identical patterns repeat across every
+ * file of a batch, so the sharing deliberately spans documents.\n
+ * A pattern is keyed by an FNV-1a hash over its element count, total
+ * length and dash lengths; interned patterns are immutable and live
+ * until \c dxf_dash_cache_free.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#include "dash_cache.h"
+
+
+/*!
+ * Number of hash buckets of the dash cache; a handful of distinct
+ * patterns cover a typical batch, so the table stays small.
+ */
+#define DXF_DASH_CACHE_BUCKETS 64
+
+
+/*!
+ * The dash cache buckets.
+ */
+static DxfDashPattern *dxf_dash_cache[DXF_DASH_CACHE_BUCKETS];
+
+/*!
+ * Number of interned patterns.
+ */
+static size_t dxf_dash_cache_count = 0;
+
+
+/*!
+ * \brief Hash the content of a dash pattern.
+ *
+ * \return the bucket index of the pattern.
+ */
+static unsigned int
+dxf_dash_cache_hash
+(
+        double total_length,
+                /*!< the total pattern length. */
+        const double *lengths,
+                /*!< the dash lengths. */
+        int number_of_elements
+                /*!< number of dash lengths. */
+)
+{
+        const unsigned char *bytes;
+        unsigned int hash;
+        size_t size;
+        size_t i;
+
+        hash = 2166136261u;
+        bytes = (const unsigned char *) &total_length;
+        for (i = 0; i < sizeof (double); i++)
+        {
+                hash ^= bytes[i];
+                hash *= 16777619u;
+        }
+        bytes = (const unsigned char *) lengths;
+        size = (size_t) number_of_elements * sizeof (double);
+        for (i = 0; i < size; i++)
+        {
+                hash ^= bytes[i];
+                hash *= 16777619u;
+        }
+        hash ^= (unsigned int) number_of_elements;
+        hash *= 16777619u;
+        return (hash % DXF_DASH_CACHE_BUCKETS);
+}
+
+
+/*!
+ * \brief Intern a dash pattern in the flyweight cache.
+ *
+ * An equal pattern seen before yields the shared instance; equal
+ * patterns therefore compare equal by pointer.
+ *
+ * \return a pointer to the shared immutable pattern, or \c NULL when
+ * errors occurred.
+ */
+const DxfDashPattern *
+dxf_dash_pattern_intern
+(
+        double total_length,
+                /*!< the total pattern length (group code 40). */
+        const double *lengths,
+                /*!< the dash lengths (group code 49), at least
+                 * \c number_of_elements entries. */
+        int number_of_elements
+                /*!< number of dash lengths (group code 73). */
+)
+{
+        DxfDashPattern *pattern;
+        unsigned int bucket;
+
+        if ((lengths == NULL) && (number_of_elements > 0))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        if ((number_of_elements < 0)
+                || (number_of_elements > DXF_MAX_NUMBER_OF_DASH_LENGTH_ITEMS))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () an invalid number of elements was passed: %d.\n")),
+                  __FUNCTION__, number_of_elements);
+                return (NULL);
+        }
+        bucket = dxf_dash_cache_hash (total_length, lengths,
+                number_of_elements);
+        for (pattern = dxf_dash_cache[bucket]; pattern != NULL;
+                pattern = pattern->next)
+        {
+                if ((pattern->number_of_elements == number_of_elements)
+                        && (pattern->total_length == total_length)
+                        && (memcmp (pattern->lengths, lengths,
+                                (size_t) number_of_elements
+                                * sizeof (double)) == 0))
+                {
+                        pattern->shares++;
+                        return (pattern);
+                }
+        }
+        pattern = calloc (1, sizeof (DxfDashPattern));
+        if (pattern == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        pattern->total_length = total_length;
+        pattern->number_of_elements = number_of_elements;
+        if (number_of_elements > 0)
+        {
+                memcpy (pattern->lengths, lengths,
+                        (size_t) number_of_elements * sizeof (double));
+        }
+        pattern->shares = 1;
+        pattern->next = dxf_dash_cache[bucket];
+        dxf_dash_cache[bucket] = pattern;
+        dxf_dash_cache_count++;
+        return (pattern);
+}
+
+
+/*!
+ * \brief Intern the dash pattern of a \c LTYPE record and attach it.
+ *
+ * Batched read of the dash arrays: the element count, total length
+ * and dash lengths of the record are interned in one call and the
+ * shared pattern is stored in the record's \c pattern member.
+ *
+ * \return a pointer to the shared pattern, or \c NULL when errors
+ * occurred.
+ */
+const DxfDashPattern *
+dxf_ltype_dash_pattern
+(
+        DxfLType *dxf_ltype
+                /*!< DXF ltype entity. */
+)
+{
+        if (dxf_ltype == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        dxf_ltype->pattern = dxf_dash_pattern_intern (
+                dxf_ltype->total_pattern_length,
+                dxf_ltype->dash_length,
+                dxf_ltype->number_of_linetype_elements);
+        return (dxf_ltype->pattern);
+}
+
+
+/*!
+ * \brief Apply a shared dash pattern to a \c LTYPE record.
+ *
+ * Batched write of the dash arrays: the element count, total length
+ * and dash lengths of the record are set from the pattern in one
+ * call, and the pattern is attached.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_ltype_set_dash_pattern
+(
+        DxfLType *dxf_ltype,
+                /*!< DXF ltype entity. */
+        const DxfDashPattern *pattern
+                /*!< the shared pattern to apply. */
+)
+{
+        int i;
+
+        if ((dxf_ltype == NULL) || (pattern == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        dxf_ltype->total_pattern_length = pattern->total_length;
+        dxf_ltype->number_of_linetype_elements = pattern->number_of_elements;
+        memcpy (dxf_ltype->dash_length, pattern->lengths,
+                sizeof (dxf_ltype->dash_length));
+        for (i = pattern->number_of_elements;
+                i < DXF_MAX_NUMBER_OF_DASH_LENGTH_ITEMS; i++)
+        {
+                dxf_ltype->dash_length[i] = 0.0;
+        }
+        dxf_ltype->pattern = pattern;
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Report the number of interned dash patterns.
+ *
+ * \return the number of distinct patterns in the cache.
+ */
+size_t
+dxf_dash_cache_length
+(
+        void
+)
+{
+        return (dxf_dash_cache_count);
+}
+
+
+/*!
+ * \brief Free every interned dash pattern.
+ *
+ * The caller guarantees no record still dereferences an attached
+ * pattern; the \c pattern members of parsed records become dangling.
+ */
+void
+dxf_dash_cache_free
+(
+        void
+)
+{
+        DxfDashPattern *pattern;
+        DxfDashPattern *next;
+        size_t i;
+
+        for (i = 0; i < DXF_DASH_CACHE_BUCKETS; i++)
+        {
+                pattern = dxf_dash_cache[i];
+                while (pattern != NULL)
+                {
+                        next = pattern->next;
+                        free (pattern);
+                        pattern = next;
+                }
+                dxf_dash_cache[i] = NULL;
+        }
+        dxf_dash_cache_count = 0;
+}
+
+
+/* EOF */
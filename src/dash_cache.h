@@ -0,0 +1,109 @@
+/*!
+ * \file dash_cache.h
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Header for the flyweight cache of \c LTYPE dash patterns.
+ *
+ * Every \c DxfLType record carries its dash lengths in a fixed inline
+ * array, and identical linetype definitions (\c DASHED, \c CENTER,
+ * \c HIDDEN, ...) repeat across every file of a batch.\n
+ * The dash cache interns the numeric pattern — element count, total
+ * length and the dash lengths — keyed by content, so all records with
+ * an equal pattern share one immutable \c DxfDashPattern and equal
+ * patterns compare equal by pointer.\n
+ * Stroking loops walk the contiguous \c lengths array of the shared
+ * pattern instead of the record.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#ifndef LIBDXF_SRC_DASH_CACHE_H
+#define LIBDXF_SRC_DASH_CACHE_H
+
+
+#include "global.h"
+#include "ltype.h"
+
+
+/*!
+ * \brief One interned dash pattern: immutable and shared by every
+ * record carrying an equal pattern.
+ */
+typedef struct
+dxf_dash_pattern
+{
+        double total_length;
+                /*!< the total pattern length (group code 40). */
+        int number_of_elements;
+                /*!< number of valid entries in \c lengths (group
+                 * code 73). */
+        double lengths[DXF_MAX_NUMBER_OF_DASH_LENGTH_ITEMS];
+                /*!< the dash, dot and space lengths (group code 49),
+                 * contiguous for the stroking loops. */
+        size_t shares;
+                /*!< number of interns which returned this pattern;
+                 * diagnostic only. */
+        struct dxf_dash_pattern *next;
+                /*!< the next pattern in the same cache bucket. */
+} DxfDashPattern;
+
+
+const DxfDashPattern *
+dxf_dash_pattern_intern
+(
+        double total_length,
+        const double *lengths,
+        int number_of_elements
+);
+const DxfDashPattern *
+dxf_ltype_dash_pattern
+(
+        DxfLType *dxf_ltype
+);
+int
+dxf_ltype_set_dash_pattern
+(
+        DxfLType *dxf_ltype,
+        const DxfDashPattern *pattern
+);
+size_t
+dxf_dash_cache_length
+(
+        void
+);
+void
+dxf_dash_cache_free
+(
+        void
+);
+
+
+#endif /* LIBDXF_SRC_DASH_CACHE_H */
+
+
+/* EOF */
@@ -0,0 +1,284 @@
+/*!
+ * \file diag.c
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Functions for the deferred diagnostics buffer.
+ *
+ * The entity readers used to \c fprintf every per-record warning to
+ * \c stderr inline; on files with millions of suspect records the
+ * stream I/O dominated the parse time.\n
+ * \c dxf_diag_report is the single funnel those warnings go through
+ * now: with no buffer attached it writes to \c stderr exactly as
+ * before, with a buffer attached (see \c dxf_diag_attach) it counts
+ * the message per severity, retains the most recent ones in a
+ * bounded ring and optionally writes the first few through, so the
+ * hot path stays free of I/O and nothing is silently lost.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#include <stdarg.h>
+#include "diag.h"
+
+
+/*!
+ * \brief Allocate an empty diagnostics buffer.
+ *
+ * \return a pointer to the buffer, or \c NULL when errors occurred.
+ */
+DxfDiag *
+dxf_diag_new
+(
+        uint64_t passthrough_limit
+                /*!< number of messages still written to \c stderr as
+                 * they are reported, or \c 0 for none. */
+)
+{
+        DxfDiag *diag;
+
+        diag = malloc (sizeof (DxfDiag));
+        if (diag == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        memset (diag, 0, sizeof (DxfDiag));
+        pthread_mutex_init (&diag->mutex, NULL);
+        diag->passthrough_limit = passthrough_limit;
+        return (diag);
+}
+
+
+/*!
+ * \brief Free a diagnostics buffer.
+ */
+void
+dxf_diag_free
+(
+        DxfDiag *diag
+                /*!< the buffer to free. */
+)
+{
+        if (diag == NULL)
+        {
+                return;
+        }
+        pthread_mutex_destroy (&diag->mutex);
+        free (diag);
+}
+
+
+/*!
+ * \brief Attach a diagnostics buffer to a file being parsed.
+ *
+ * The buffer is owned by the caller and outlives the parse; detach
+ * it (or close the file) before freeing it.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_diag_attach
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an input file (or device). */
+        DxfDiag *diag
+                /*!< the buffer to collect diagnostics in. */
+)
+{
+        if (fp == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL file pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        fp->diag = diag;
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Detach the diagnostics buffer from a file.
+ *
+ * \return the detached buffer, or \c NULL when none was attached.
+ */
+DxfDiag *
+dxf_diag_detach
+(
+        DxfFile *fp
+                /*!< DXF file pointer to an input file (or device). */
+)
+{
+        DxfDiag *diag;
+
+        if (fp == NULL)
+        {
+                return (NULL);
+        }
+        diag = fp->diag;
+        fp->diag = NULL;
+        return (diag);
+}
+
+
+/*!
+ * \brief Report one parser diagnostic.
+ *
+ * With no buffer attached to \c fp the message goes to \c stderr,
+ * preserving the historic inline behaviour; with a buffer attached
+ * it is counted, retained in the ring (overwriting the oldest
+ * message when full) and written through to \c stderr only while the
+ * buffer's passthrough budget lasts.
+ */
+void
+dxf_diag_report
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an input file (or device). */
+        int severity,
+                /*!< severity (see \c enum \c dxf_diag_severity). */
+        const char *format,
+                /*!< printf style message format. */
+        ...
+)
+{
+        DxfDiag *diag;
+        DxfDiagMessage *message;
+        va_list ap;
+
+        diag = (fp != NULL) ? fp->diag : NULL;
+        if (diag == NULL)
+        {
+                va_start (ap, format);
+                vfprintf (stderr, format, ap);
+                va_end (ap);
+                return;
+        }
+        if ((severity < 0) || (severity >= DXF_DIAG_SEVERITIES))
+        {
+                severity = DXF_DIAG_ERROR;
+        }
+        pthread_mutex_lock (&diag->mutex);
+        diag->counts[severity]++;
+        if (diag->length == DXF_DIAG_CAPACITY)
+        {
+                message = &diag->messages[diag->head];
+                diag->head = (diag->head + 1) % DXF_DIAG_CAPACITY;
+                diag->dropped++;
+        }
+        else
+        {
+                message = &diag->messages[(diag->head + diag->length) % DXF_DIAG_CAPACITY];
+                diag->length++;
+        }
+        message->severity = severity;
+        message->line_number = (fp != NULL) ? fp->line_number : 0;
+        va_start (ap, format);
+        vsnprintf (message->text, DXF_DIAG_MESSAGE_SIZE, format, ap);
+        va_end (ap);
+        if (diag->passthrough_emitted < diag->passthrough_limit)
+        {
+                fputs (message->text, stderr);
+                diag->passthrough_emitted++;
+                if (diag->passthrough_emitted == diag->passthrough_limit)
+                {
+                        fprintf (stderr,
+                          (_("%s: further diagnostics are collected, not printed.\n")),
+                          (fp->filename != NULL) ? fp->filename : "");
+                }
+        }
+        pthread_mutex_unlock (&diag->mutex);
+}
+
+
+/*!
+ * \brief Get one retained message, oldest first.
+ *
+ * \return the i-th oldest retained message, or \c NULL when \c i is
+ * out of range.
+ */
+const DxfDiagMessage *
+dxf_diag_get
+(
+        const DxfDiag *diag,
+                /*!< the buffer to read. */
+        size_t i
+                /*!< index of the message, \c 0 for the oldest
+                 * retained one. */
+)
+{
+        if ((diag == NULL) || (i >= diag->length))
+        {
+                return (NULL);
+        }
+        return (&diag->messages[(diag->head + i) % DXF_DIAG_CAPACITY]);
+}
+
+
+/*!
+ * \brief Print a summary and the retained messages after parsing.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_diag_print
+(
+        const DxfDiag *diag,
+                /*!< the buffer to print. */
+        FILE *stream
+                /*!< the stream to print to. */
+)
+{
+        size_t i;
+
+        if ((diag == NULL) || (stream == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        fprintf (stream,
+          (_("%lu notes, %lu warnings, %lu errors; %lu messages dropped.\n")),
+          (unsigned long) diag->counts[DXF_DIAG_NOTE],
+          (unsigned long) diag->counts[DXF_DIAG_WARNING],
+          (unsigned long) diag->counts[DXF_DIAG_ERROR],
+          (unsigned long) diag->dropped);
+        for (i = 0; i < diag->length; i++)
+        {
+                fputs (dxf_diag_get (diag, i)->text, stream);
+        }
+        return (EXIT_SUCCESS);
+}
+
+
+/* EOF */
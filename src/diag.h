@@ -0,0 +1,139 @@
+/*!
+ * \file diag.h
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Header for the deferred diagnostics buffer.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#ifndef LIBDXF_SRC_DIAG_H
+#define LIBDXF_SRC_DIAG_H
+
+
+#include <pthread.h>
+#include "global.h"
+
+
+/*!
+ * \brief Number of messages the diagnostics ring retains.
+ *
+ * Older messages are overwritten (and counted as dropped) once the
+ * ring is full, so a file with millions of warnings costs a bounded
+ * amount of memory.
+ */
+#define DXF_DIAG_CAPACITY 256
+
+
+/*!
+ * \brief Size of one retained message text in bytes, terminating NUL
+ * included; longer messages are truncated.
+ */
+#define DXF_DIAG_MESSAGE_SIZE 160
+
+
+/*!
+ * \brief Severities of a diagnostic message.
+ */
+enum dxf_diag_severity
+{
+        DXF_DIAG_NOTE = 0,
+                /*!< informational, e.g. a 999 comment. */
+        DXF_DIAG_WARNING,
+                /*!< the parse continued past something suspect. */
+        DXF_DIAG_ERROR,
+                /*!< something was lost or given up on. */
+        DXF_DIAG_SEVERITIES
+                /*!< number of severities (array size, not a
+                 * severity). */
+};
+
+
+/*!
+ * \brief One retained diagnostic message.
+ */
+typedef struct
+dxf_diag_message
+{
+        int severity;
+                /*!< severity (see \c enum \c dxf_diag_severity). */
+        long line_number;
+                /*!< line of the input file the message refers to. */
+        char text[DXF_DIAG_MESSAGE_SIZE];
+                /*!< the formatted message. */
+} DxfDiagMessage;
+
+
+/*!
+ * \brief A bounded in-memory diagnostics buffer.
+ *
+ * Attached to a \c DxfFile (see \c dxf_diag_attach) it collects the
+ * per-record parser diagnostics that would otherwise go to \c stderr
+ * inline: on malformed-ish files with millions of warnings the
+ * stream I/O dominates the parse time, so messages land in this ring
+ * instead and are inspected after parsing.\n
+ * Reporting is serialized on an internal mutex, so one buffer may be
+ * shared by the workers of a parallel parse.
+ */
+typedef struct
+dxf_diag
+{
+        pthread_mutex_t mutex;
+                /*!< serializes concurrent reporters. */
+        DxfDiagMessage messages[DXF_DIAG_CAPACITY];
+                /*!< ring of the most recent messages. */
+        size_t head;
+                /*!< index of the oldest retained message. */
+        size_t length;
+                /*!< number of retained messages. */
+        uint64_t counts[DXF_DIAG_SEVERITIES];
+                /*!< number of messages reported per severity,
+                 * retained or not. */
+        uint64_t dropped;
+                /*!< number of messages overwritten in the ring. */
+        uint64_t passthrough_limit;
+                /*!< number of messages still written to \c stderr as
+                 * they are reported, or \c 0 for none. */
+        uint64_t passthrough_emitted;
+                /*!< number of messages written through so far. */
+} DxfDiag;
+
+
+DxfDiag *dxf_diag_new (uint64_t passthrough_limit);
+void dxf_diag_free (DxfDiag *diag);
+int dxf_diag_attach (DxfFile *fp, DxfDiag *diag);
+DxfDiag *dxf_diag_detach (DxfFile *fp);
+void dxf_diag_report (DxfFile *fp, int severity, const char *format, ...);
+const DxfDiagMessage *dxf_diag_get (const DxfDiag *diag, size_t i);
+int dxf_diag_print (const DxfDiag *diag, FILE *stream);
+
+
+#endif /* LIBDXF_SRC_DIAG_H */
+
+
+/* EOF */
@@ -32,7 +32,11 @@
  */
 
 
+#include <pthread.h>
 #include "dimension.h"
+#include "diag.h"
+#include "allocator.h"
+#include "field.h"
 
 
 /*!
@@ -60,7 +64,7 @@ dxf_dimension_new ()
         size = sizeof (DxfDimension);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_dimension = malloc (size)) == NULL)
+        if ((dxf_dimension = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfDimension struct.\n")),
@@ -101,6 +105,11 @@ dxf_dimension_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfDimension template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         /* Do some basic checks. */
         if (dxf_dimension == NULL)
         {
@@ -116,55 +125,69 @@ dxf_dimension_init
                 __FUNCTION__);
               return (NULL);
         }
-        dxf_dimension->id_code = 0;
-        dxf_dimension->linetype = strdup (DXF_DEFAULT_LINETYPE);
-        dxf_dimension->layer = strdup (DXF_DEFAULT_LAYER);
-        dxf_dimension->elevation = 0.0;
-        dxf_dimension->thickness = 0.0;
-        dxf_dimension->linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
-        dxf_dimension->visibility = DXF_DEFAULT_VISIBILITY;
-        dxf_dimension->color = DXF_COLOR_BYLAYER;
-        dxf_dimension->paperspace = DXF_PAPERSPACE;
-        dxf_dimension->dim_text = strdup ("");
-        dxf_dimension->dimblock_name = strdup ("");
-        dxf_dimension->dimstyle_name = strdup ("");
-        dxf_dimension->x0 = 0.0;
-        dxf_dimension->y0 = 0.0;
-        dxf_dimension->z0 = 0.0;
-        dxf_dimension->x1 = 0.0;
-        dxf_dimension->y1 = 0.0;
-        dxf_dimension->z1 = 0.0;
-        dxf_dimension->x2 = 0.0;
-        dxf_dimension->y2 = 0.0;
-        dxf_dimension->z2 = 0.0;
-        dxf_dimension->x3 = 0.0;
-        dxf_dimension->y3 = 0.0;
-        dxf_dimension->z3 = 0.0;
-        dxf_dimension->x4 = 0.0;
-        dxf_dimension->y4 = 0.0;
-        dxf_dimension->z4 = 0.0;
-        dxf_dimension->x5 = 0.0;
-        dxf_dimension->y5 = 0.0;
-        dxf_dimension->z5 = 0.0;
-        dxf_dimension->x6 = 0.0;
-        dxf_dimension->y6 = 0.0;
-        dxf_dimension->z6 = 0.0;
-        dxf_dimension->leader_length = 0.0;
-        dxf_dimension->text_line_spacing_factor = 0.0;
-        dxf_dimension->actual_measurement = 0.0;
-        dxf_dimension->angle = 0.0;
-        dxf_dimension->hor_dir = 0.0;
-        dxf_dimension->obl_angle = 0.0;
-        dxf_dimension->text_angle = 0.0;
-        dxf_dimension->flag = 0;
-        dxf_dimension->attachment_point = 0;
-        dxf_dimension->text_line_spacing = 0;
-        dxf_dimension->extr_x0 = 0.0;
-        dxf_dimension->extr_y0 = 0.0;
-        dxf_dimension->extr_z0 = 0.0;
-        dxf_dimension->dictionary_owner_soft = strdup ("");
-        dxf_dimension->dictionary_owner_hard = strdup ("");
-        dxf_dimension->next = NULL;
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.id_code = 0;
+                template.linetype = strdup (DXF_DEFAULT_LINETYPE);
+                template.layer = strdup (DXF_DEFAULT_LAYER);
+                template.elevation = 0.0;
+                template.thickness = 0.0;
+                template.linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
+                template.visibility = DXF_DEFAULT_VISIBILITY;
+                template.color = DXF_COLOR_BYLAYER;
+                template.paperspace = DXF_PAPERSPACE;
+                template.dim_text = strdup ("");
+                template.dimblock_name = strdup ("");
+                template.dimstyle_name = strdup ("");
+                template.x0 = 0.0;
+                template.y0 = 0.0;
+                template.z0 = 0.0;
+                template.x1 = 0.0;
+                template.y1 = 0.0;
+                template.z1 = 0.0;
+                template.x2 = 0.0;
+                template.y2 = 0.0;
+                template.z2 = 0.0;
+                template.x3 = 0.0;
+                template.y3 = 0.0;
+                template.z3 = 0.0;
+                template.x4 = 0.0;
+                template.y4 = 0.0;
+                template.z4 = 0.0;
+                template.x5 = 0.0;
+                template.y5 = 0.0;
+                template.z5 = 0.0;
+                template.x6 = 0.0;
+                template.y6 = 0.0;
+                template.z6 = 0.0;
+                template.leader_length = 0.0;
+                template.text_line_spacing_factor = 0.0;
+                template.actual_measurement = 0.0;
+                template.angle = 0.0;
+                template.hor_dir = 0.0;
+                template.obl_angle = 0.0;
+                template.text_angle = 0.0;
+                template.flag = 0;
+                template.attachment_point = 0;
+                template.text_line_spacing = 0;
+                template.extr_x0 = 0.0;
+                template.extr_y0 = 0.0;
+                template.extr_z0 = 0.0;
+                template.dictionary_owner_soft = strdup ("");
+                template.dictionary_owner_hard = strdup ("");
+                template.next = NULL;
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (dxf_dimension, &template, sizeof (DxfDimension));
+        dxf_dimension->linetype = strdup (template.linetype);
+        dxf_dimension->layer = strdup (template.layer);
+        dxf_dimension->dim_text = strdup (template.dim_text);
+        dxf_dimension->dimblock_name = strdup (template.dimblock_name);
+        dxf_dimension->dimstyle_name = strdup (template.dimstyle_name);
+        dxf_dimension->dictionary_owner_soft = strdup (template.dictionary_owner_soft);
+        dxf_dimension->dictionary_owner_hard = strdup (template.dictionary_owner_hard);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -172,6 +195,238 @@ dxf_dimension_init
 }
 
 
+/*!
+ * \brief Field table mapping the group codes common to all
+ * \c DIMENSION subtypes to \c DxfDimension members, sorted by group
+ * code.
+ */
+const DxfFieldSpec dxf_dimension_field_table[] =
+{
+        {1, DXF_FIELD_TYPE_STRING, offsetof (DxfDimension, dim_text), "dim_text"},
+        {2, DXF_FIELD_TYPE_STRING, offsetof (DxfDimension, dimblock_name), "dimblock_name"},
+        {3, DXF_FIELD_TYPE_STRING, offsetof (DxfDimension, dimstyle_name), "dimstyle_name"},
+        {5, DXF_FIELD_TYPE_HEX, offsetof (DxfDimension, id_code), "id_code"},
+        {6, DXF_FIELD_TYPE_STRING, offsetof (DxfDimension, linetype), "linetype"},
+        {8, DXF_FIELD_TYPE_STRING, offsetof (DxfDimension, layer), "layer"},
+        {10, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, x0), "x0"},
+        {11, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, x1), "x1"},
+        {12, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, x2), "x2"},
+        {20, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, y0), "y0"},
+        {21, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, y1), "y1"},
+        {22, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, y2), "y2"},
+        {30, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, z0), "z0"},
+        {31, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, z1), "z1"},
+        {32, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, z2), "z2"},
+        {39, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, thickness), "thickness"},
+        {41, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, text_line_spacing_factor), "text_line_spacing_factor"},
+        {42, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, actual_measurement), "actual_measurement"},
+        {48, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, linetype_scale), "linetype_scale"},
+        {51, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, hor_dir), "hor_dir"},
+        {53, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, text_angle), "text_angle"},
+        {60, DXF_FIELD_TYPE_INT16, offsetof (DxfDimension, visibility), "visibility"},
+        {62, DXF_FIELD_TYPE_INT, offsetof (DxfDimension, color), "color"},
+        {67, DXF_FIELD_TYPE_INT, offsetof (DxfDimension, paperspace), "paperspace"},
+        {70, DXF_FIELD_TYPE_INT, offsetof (DxfDimension, flag), "flag"},
+        {71, DXF_FIELD_TYPE_INT, offsetof (DxfDimension, attachment_point), "attachment_point"},
+        {72, DXF_FIELD_TYPE_INT, offsetof (DxfDimension, text_line_spacing), "text_line_spacing"},
+        {210, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, extr_x0), "extr_x0"},
+        {220, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, extr_y0), "extr_y0"},
+        {230, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, extr_z0), "extr_z0"},
+        {330, DXF_FIELD_TYPE_STRING, offsetof (DxfDimension, dictionary_owner_soft), "dictionary_owner_soft"},
+        {360, DXF_FIELD_TYPE_STRING, offsetof (DxfDimension, dictionary_owner_hard), "dictionary_owner_hard"}
+};
+
+
+/*!
+ * Number of entries in \c dxf_dimension_field_table.
+ */
+const size_t dxf_dimension_field_table_length =
+        DXF_FIELD_TABLE_LENGTH (dxf_dimension_field_table);
+
+
+/*!
+ * \brief Field table of the linear (rotated, horizontal and vertical)
+ * \c DIMENSION subtype, sorted by group code.
+ */
+static const DxfFieldSpec dxf_dimension_linear_table[] =
+{
+        {13, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, x3), "x3"},
+        {14, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, x4), "x4"},
+        {23, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, y3), "y3"},
+        {24, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, y4), "y4"},
+        {33, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, z3), "z3"},
+        {34, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, z4), "z4"},
+        {50, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, angle), "angle"},
+        {52, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, obl_angle), "obl_angle"}
+};
+
+
+/*!
+ * \brief Field table of the aligned \c DIMENSION subtype, sorted by
+ * group code.
+ */
+static const DxfFieldSpec dxf_dimension_aligned_table[] =
+{
+        {13, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, x3), "x3"},
+        {14, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, x4), "x4"},
+        {23, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, y3), "y3"},
+        {24, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, y4), "y4"},
+        {33, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, z3), "z3"},
+        {34, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, z4), "z4"}
+};
+
+
+/*!
+ * \brief Field table of the angular \c DIMENSION subtypes (two line
+ * and three point), sorted by group code.
+ */
+static const DxfFieldSpec dxf_dimension_angular_table[] =
+{
+        {13, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, x3), "x3"},
+        {14, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, x4), "x4"},
+        {15, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, x5), "x5"},
+        {16, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, x6), "x6"},
+        {23, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, y3), "y3"},
+        {24, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, y4), "y4"},
+        {25, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, y5), "y5"},
+        {26, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, y6), "y6"},
+        {33, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, z3), "z3"},
+        {34, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, z4), "z4"},
+        {35, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, z5), "z5"},
+        {36, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, z6), "z6"}
+};
+
+
+/*!
+ * \brief Field table of the radius and diameter \c DIMENSION
+ * subtypes, sorted by group code.
+ */
+static const DxfFieldSpec dxf_dimension_radial_table[] =
+{
+        {15, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, x5), "x5"},
+        {25, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, y5), "y5"},
+        {35, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, z5), "z5"},
+        {40, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, leader_length), "leader_length"}
+};
+
+
+/*!
+ * \brief Field table of the ordinate \c DIMENSION subtype, sorted by
+ * group code.
+ */
+static const DxfFieldSpec dxf_dimension_ordinate_table[] =
+{
+        {13, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, x3), "x3"},
+        {14, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, x4), "x4"},
+        {23, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, y3), "y3"},
+        {24, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, y4), "y4"},
+        {33, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, z3), "z3"},
+        {34, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, z4), "z4"},
+        {52, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, obl_angle), "obl_angle"}
+};
+
+
+/*!
+ * \brief Field table accepting every subtype specific group code;
+ * used while the subtype is not known yet and for unrecognized
+ * subtype values, so no definition point is dropped on malformed
+ * input.
+ */
+static const DxfFieldSpec dxf_dimension_any_table[] =
+{
+        {13, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, x3), "x3"},
+        {14, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, x4), "x4"},
+        {15, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, x5), "x5"},
+        {16, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, x6), "x6"},
+        {23, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, y3), "y3"},
+        {24, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, y4), "y4"},
+        {25, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, y5), "y5"},
+        {26, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, y6), "y6"},
+        {33, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, z3), "z3"},
+        {34, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, z4), "z4"},
+        {35, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, z5), "z5"},
+        {36, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, z6), "z6"},
+        {40, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, leader_length), "leader_length"},
+        {50, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, angle), "angle"},
+        {52, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimension, obl_angle), "obl_angle"}
+};
+
+
+/*!
+ * \brief Dispatch table from the dimension type (the low bits of the
+ * group 70 flag) to the field table of the subtype.
+ *
+ * The flag is stored in the common \c AcDbDimension block and so
+ * precedes the subtype specific groups in the record; entries 0
+ * through 6 follow the DXF dimension type values, entry 7 is unused
+ * by the specification and falls back to the accept-all table.
+ */
+static const struct
+{
+        const DxfFieldSpec *fields;
+                /*!< field table of the subtype, sorted by group code. */
+        size_t length;
+                /*!< number of entries in the field table. */
+} dxf_dimension_subtype_tables[] =
+{
+        {dxf_dimension_linear_table, DXF_FIELD_TABLE_LENGTH (dxf_dimension_linear_table)},
+        {dxf_dimension_aligned_table, DXF_FIELD_TABLE_LENGTH (dxf_dimension_aligned_table)},
+        {dxf_dimension_angular_table, DXF_FIELD_TABLE_LENGTH (dxf_dimension_angular_table)},
+        {dxf_dimension_radial_table, DXF_FIELD_TABLE_LENGTH (dxf_dimension_radial_table)},
+        {dxf_dimension_radial_table, DXF_FIELD_TABLE_LENGTH (dxf_dimension_radial_table)},
+        {dxf_dimension_angular_table, DXF_FIELD_TABLE_LENGTH (dxf_dimension_angular_table)},
+        {dxf_dimension_ordinate_table, DXF_FIELD_TABLE_LENGTH (dxf_dimension_ordinate_table)},
+        {dxf_dimension_any_table, DXF_FIELD_TABLE_LENGTH (dxf_dimension_any_table)}
+};
+
+
+/*!
+ * \brief Per-entity hook reading the subtype specific and version
+ * dependent fields of a \c DIMENSION for the shared parse loop.
+ *
+ * The subtype field table is selected from the dimension type bits of
+ * the group 70 flag, which the common table has already stored by the
+ * time a subtype group code arrives, so each subtype only pays for
+ * the group codes it actually defines.
+ *
+ * \return \c FOUND when the group code was consumed, or \c FAIL when
+ * it belongs to the common table.
+ */
+static int
+dxf_dimension_read_special
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an input file (or device). */
+        void *entity,
+                /*!< DXF \c DIMENSION entity. */
+        int group_code
+                /*!< group code read by the shared parse loop. */
+)
+{
+        DxfDimension *dxf_dimension = (DxfDimension *) entity;
+        const DxfFieldSpec *spec;
+        int subtype;
+
+        if ((group_code == 38)
+                && (fp->acad_version_number <= AutoCAD_11))
+        {
+                /* Now follows a string containing the elevation. */
+                dxf_read_scanf (fp, "%lf\n", &dxf_dimension->elevation);
+                return (FOUND);
+        }
+        subtype = dxf_dimension->flag & 7;
+        spec = dxf_field_find (dxf_dimension_subtype_tables[subtype].fields,
+                dxf_dimension_subtype_tables[subtype].length, group_code);
+        if (spec == NULL)
+        {
+                return (FAIL);
+        }
+        dxf_read_scanf (fp, "%lf\n",
+                (double *) (((char *) entity) + spec->offset));
+        return (FOUND);
+}
+
+
 /*!
  * \brief Read data from a DXF file into a DXF \c DIMENSION entity.
  *
@@ -179,6 +434,10 @@ dxf_dimension_init
  * Now follows some data for the \c DIMENSION, to be terminated with a
  * "  0" string announcing the following entity, or the end of the
  * \c ENTITY section marker \c ENDSEC. \n
+ * The group codes common to all dimension subtypes are read through
+ * the common field table; the subtype specific definition points are
+ * dispatched through the field table selected by the dimension type
+ * bits of the group 70 flag (see \c dxf_dimension_read_special).
  *
  * \return a pointer to \c dxf_dimension.
  *
@@ -199,8 +458,6 @@ dxf_dimension_read
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        char *temp_string = NULL;
-
         /* Do some basic checks. */
         if (fp == NULL)
         {
@@ -217,422 +474,75 @@ dxf_dimension_read
                 dxf_dimension = dxf_dimension_new ();
                 dxf_dimension = dxf_dimension_init (dxf_dimension);
         }
-        (fp->line_number)++;
-        fscanf (fp->fp, "%[^\n]", temp_string);
-        while (strcmp (temp_string, "0") != 0)
+        if (dxf_field_read_all (fp, dxf_dimension, dxf_dimension_field_table,
+                DXF_FIELD_TABLE_LENGTH (dxf_dimension_field_table),
+                "AcDbEntity AcDbDimension AcDbAlignedDimension "
+                "AcDbRotatedDimension AcDb3PointAngularDimension "
+                "AcDb2LineAngularDimension AcDbDiametricDimension "
+                "AcDbRadialDimension AcDbOrdinateDimension",
+                dxf_dimension_read_special) != EXIT_SUCCESS)
         {
-                if (ferror (fp->fp))
-                {
-                        fprintf (stderr,
-                          (_("Error in %s () while reading from: %s in line: %d.\n")),
-                          __FUNCTION__, fp->filename, fp->line_number);
-                        fclose (fp->fp);
-                        return (NULL);
-                }
-                if (strcmp (temp_string, "1") == 0)
-                {
-                        /* Now follows a string containing a dimension
-                         * text string. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_dimension->dim_text);
-                }
-                if (strcmp (temp_string, "2") == 0)
-                {
-                        /* Now follows a string containing a dimension
-                         * block name string. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_dimension->dimblock_name);
-                }
-                if (strcmp (temp_string, "3") == 0)
-                {
-                        /* Now follows a string containing a dimension
-                         * style name string. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_dimension->dimstyle_name);
-                }
-                if (strcmp (temp_string, "5") == 0)
-                {
-                        /* Now follows a string containing a sequential
-                         * id number. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%x\n", &dxf_dimension->id_code);
-                }
-                else if (strcmp (temp_string, "6") == 0)
-                {
-                        /* Now follows a string containing a linetype
-                         * name. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_dimension->linetype);
-                }
-                else if (strcmp (temp_string, "8") == 0)
-                {
-                        /* Now follows a string containing a layer name. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_dimension->layer);
-                }
-                else if (strcmp (temp_string, "10") == 0)
-                {
-                        /* Now follows a string containing the
-                         * X-value of the definition point for all
-                         * dimension types. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimension->x0);
-                }
-                else if (strcmp (temp_string, "20") == 0)
-                {
-                        /* Now follows a string containing the
-                         * Y-value of the definition point for all
-                         * dimension types. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimension->y0);
-                }
-                else if (strcmp (temp_string, "30") == 0)
-                {
-                        /* Now follows a string containing the
-                         * Z-value of the definition point for all
-                         * dimension types. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimension->z0);
-                }
-                else if (strcmp (temp_string, "11") == 0)
-                {
-                        /* Now follows a string containing the
-                         * X-value of the middle point of dimension text. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimension->x1);
-                }
-                else if (strcmp (temp_string, "21") == 0)
-                {
-                        /* Now follows a string containing the
-                         * Y-value of the middle point of dimension text. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimension->y1);
-                }
-                else if (strcmp (temp_string, "31") == 0)
-                {
-                        /* Now follows a string containing the
-                         * Z-value of the middle point of dimension text. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimension->z1);
-                }
-                else if (strcmp (temp_string, "12") == 0)
-                {
-                        /* Now follows a string containing the
-                         * X-value of the dimension block translation
-                         * vector. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimension->x2);
-                }
-                else if (strcmp (temp_string, "22") == 0)
-                {
-                        /* Now follows a string containing the
-                         * Y-value of the dimension block translation
-                         * vector. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimension->y2);
-                }
-                else if (strcmp (temp_string, "32") == 0)
-                {
-                        /* Now follows a string containing the
-                         * Z-value of the dimension block translation
-                         * vector. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimension->z2);
-                }
-                else if (strcmp (temp_string, "13") == 0)
-                {
-                        /* Now follows a string containing the
-                         * X-value of the definition point for linear and
-                         * angular dimensions. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimension->x3);
-                }
-                else if (strcmp (temp_string, "23") == 0)
-                {
-                        /* Now follows a string containing the
-                         * Y-value of the definition point for linear and
-                         * angular dimensions. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimension->y3);
-                }
-                else if (strcmp (temp_string, "33") == 0)
-                {
-                        /* Now follows a string containing the
-                         * Z-value of the definition point for linear and
-                         * angular dimensions. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimension->z3);
-                }
-                else if (strcmp (temp_string, "14") == 0)
-                {
-                        /* Now follows a string containing the
-                         * X-value of the definition point for linear and
-                         * angular dimensions. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimension->x4);
-                }
-                else if (strcmp (temp_string, "24") == 0)
-                {
-                        /* Now follows a string containing the
-                         * Y-value of the definition point for linear and
-                         * angular dimensions. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimension->y4);
-                }
-                else if (strcmp (temp_string, "34") == 0)
-                {
-                        /* Now follows a string containing the
-                         * Z-value of the definition point for linear and
-                         * angular dimensions. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimension->z4);
-                }
-                else if (strcmp (temp_string, "15") == 0)
-                {
-                        /* Now follows a string containing the
-                         * X-value of the definition point for diameter,
-                         * radius, and angular dimensions. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimension->x5);
-                }
-                else if (strcmp (temp_string, "25") == 0)
-                {
-                        /* Now follows a string containing the
-                         * Y-value of the definition point for diameter,
-                         * radius, and angular dimensions. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimension->y5);
-                }
-                else if (strcmp (temp_string, "35") == 0)
-                {
-                        /* Now follows a string containing the
-                         * Z-value of the definition point for diameter,
-                         * radius, and angular dimensions. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimension->z5);
-                }
-                else if (strcmp (temp_string, "16") == 0)
-                {
-                        /* Now follows a string containing the
-                         * X-value of the point defining dimension arc for
-                         * angular dimensions. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimension->x6);
-                }
-                else if (strcmp (temp_string, "26") == 0)
-                {
-                        /* Now follows a string containing the
-                         * Y-value of the point defining dimension arc for
-                         * angular dimensions. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimension->y6);
-                }
-                else if (strcmp (temp_string, "36") == 0)
-                {
-                        /* Now follows a string containing the
-                         * Z-value of the point defining dimension arc for
-                         * angular dimensions. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimension->z5);
-                }
-                else if ((fp->acad_version_number <= AutoCAD_11)
-                        && (strcmp (temp_string, "38") == 0)
-                        && (dxf_dimension->elevation = 0.0))
-                {
-                        /* Now follows a string containing the
-                         * elevation. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimension->elevation);
-                }
-                else if (strcmp (temp_string, "39") == 0)
-                {
-                        /* Now follows a string containing the
-                         * thickness. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimension->thickness);
-                }
-                else if (strcmp (temp_string, "40") == 0)
-                {
-                        /* Now follows a string containing the leader
-                         * length. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimension->leader_length);
-                }
-                else if (strcmp (temp_string, "41") == 0)
-                {
-                        /* Now follows a string containing the text line
-                         * spacing factor. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimension->text_line_spacing_factor);
-                }
-                else if (strcmp (temp_string, "42") == 0)
-                {
-                        /* Now follows a string containing the actual
-                         * measurement. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimension->actual_measurement);
-                }
-                else if (strcmp (temp_string, "48") == 0)
-                {
-                        /* Now follows a string containing the linetype
-                         * scale. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimension->linetype_scale);
-                }
-                else if (strcmp (temp_string, "50") == 0)
-                {
-                        /* Now follows a string containing the angle of
-                         * rotated, horizontal, or vertical linear
-                         * dimensions. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimension->angle);
-                }
-                else if (strcmp (temp_string, "51") == 0)
-                {
-                        /* Now follows a string containing the horizontal
-                         * direction. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimension->hor_dir);
-                }
-                else if (strcmp (temp_string, "52") == 0)
-                {
-                        /* Now follows a string containing the oblique
-                         * angle. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimension->obl_angle);
-                }
-                else if (strcmp (temp_string, "53") == 0)
-                {
-                        /* Now follows a string containing the text
-                         * angle. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimension->text_angle);
-                }
-                else if (strcmp (temp_string, "60") == 0)
-                {
-                        /* Now follows a string containing the
-                         * visibility value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%hd\n", &dxf_dimension->visibility);
-                }
-                else if (strcmp (temp_string, "62") == 0)
-                {
-                        /* Now follows a string containing the
-                         * color value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_dimension->color);
-                }
-                else if (strcmp (temp_string, "67") == 0)
-                {
-                        /* Now follows a string containing the
-                         * paperspace value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_dimension->paperspace);
-                }
-                else if (strcmp (temp_string, "70") == 0)
-                {
-                        /* Now follows a string containing a flag
-                         * value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_dimension->flag);
-                }
-                else if (strcmp (temp_string, "71") == 0)
-                {
-                        /* Now follows a string containing the attachment
-                         * point value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_dimension->attachment_point);
-                }
-                else if (strcmp (temp_string, "72") == 0)
-                {
-                        /* Now follows a string containing the text line
-                         * spacing value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_dimension->text_line_spacing);
-                }
-                else if ((fp->acad_version_number >= AutoCAD_13)
-                        && (strcmp (temp_string, "100") == 0))
-                {
-                        /* Now follows a string containing the
-                         * subclass marker value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", temp_string);
-                        if ((strcmp (temp_string, "AcDbEntity") != 0)
-                          && (strcmp (temp_string, "AcDbDimension") != 0)
-                          && (strcmp (temp_string, "AcDbAlignedDimension") != 0)
-                          && (strcmp (temp_string, "AcDbRotatedDimension") != 0)
-                          && (strcmp (temp_string, "AcDb3PointAngularDimension") != 0)
-                          && (strcmp (temp_string, "AcDbDiametricDimension") != 0)
-                          && (strcmp (temp_string, "AcDbRadialDimension") != 0)
-                          && (strcmp (temp_string, "AcDbOrdinateDimension") != 0))
-                        {
-                                fprintf (stderr,
-                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %d.\n")),
-                                  __FUNCTION__, fp->filename, fp->line_number);
-                        }
-                }
-                else if (strcmp (temp_string, "210") == 0)
-                {
-                        /* Now follows a string containing the
-                         * X-value of the extrusion vector. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimension->extr_x0);
-                }
-                else if (strcmp (temp_string, "220") == 0)
-                {
-                        /* Now follows a string containing the
-                         * Y-value of the extrusion vector. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimension->extr_y0);
-                }
-                else if (strcmp (temp_string, "230") == 0)
-                {
-                        /* Now follows a string containing the
-                         * Z-value of the extrusion vector. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimension->extr_z0);
-                }
-                else if (strcmp (temp_string, "330") == 0)
-                {
-                        /* Now follows a string containing Soft-pointer
-                         * ID/handle to owner dictionary. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_dimension->dictionary_owner_soft);
-                }
-                else if (strcmp (temp_string, "360") == 0)
-                {
-                        /* Now follows a string containing Hard owner
-                         * ID/handle to owner dictionary. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_dimension->dictionary_owner_hard);
-                }
-                else if (strcmp (temp_string, "999") == 0)
+                return (NULL);
+        }
+        /* Handle omitted members and/or illegal values; trusted
+         * inputs are guaranteed complete and skip the repair. */
+        if (!fp->trusted)
+        {
+                if (strcmp (dxf_dimension->linetype, "") == 0)
                 {
-                        /* Now follows a string containing a comment. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", temp_string);
-                        fprintf (stdout, "DXF comment: %s\n", temp_string);
+                        dxf_dimension->linetype = strdup (DXF_DEFAULT_LINETYPE);
                 }
-                else
+                if (strcmp (dxf_dimension->layer, "") == 0)
                 {
-                        fprintf (stderr,
-                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %d.\n")),
-                          __FUNCTION__, fp->filename, fp->line_number);
+                        dxf_dimension->layer = strdup (DXF_DEFAULT_LAYER);
                 }
         }
-        /* Handle omitted members and/or illegal values. */
-        if (strcmp (dxf_dimension->linetype, "") == 0)
-        {
-                dxf_dimension->linetype = strdup (DXF_DEFAULT_LINETYPE);
-        }
-        if (strcmp (dxf_dimension->layer, "") == 0)
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (dxf_dimension);
+}
+
+
+/*!
+ * \brief Duplicate a DXF \c DIMENSION entity.
+ *
+ * Driven by the common field table, which carries every string field
+ * of the struct; without an arena the duplicate owns deep copies of
+ * its strings and is released with \c dxf_dimension_free, with an
+ * arena the strings stay shared with the source and the duplicate is
+ * released with the arena (see \c dxf_field_dup).\n
+ * The duplicate is standalone: it is not linked behind the source.
+ *
+ * \return a pointer to the duplicate, or \c NULL when errors occurred.
+ */
+DxfDimension *
+dxf_dimension_dup
+(
+        DxfDimension *dxf_dimension,
+                /*!< DXF \c DIMENSION entity to duplicate. */
+        struct dxf_arena *arena
+                /*!< the arena to allocate from, or \c NULL to allocate
+                 * with \c malloc. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        DxfDimension *copy;
+
+        copy = dxf_field_dup (dxf_dimension, sizeof (DxfDimension),
+                dxf_dimension_field_table,
+                dxf_dimension_field_table_length, arena);
+        if (copy == NULL)
         {
-                dxf_dimension->layer = strdup (DXF_DEFAULT_LAYER);
+                return (NULL);
         }
+        copy->next = NULL;
 #if DEBUG
         DXF_DEBUG_END
 #endif
-        return (dxf_dimension);
+        return (copy);
 }
 
 
@@ -936,7 +846,7 @@ dxf_dimension_free
         free (dxf_dimension->dimstyle_name);
         free (dxf_dimension->dictionary_owner_soft);
         free (dxf_dimension->dictionary_owner_hard);
-        free (dxf_dimension);
+        dxf_entity_dealloc (dxf_dimension, sizeof (*dxf_dimension));
         dxf_dimension = NULL;
 #if DEBUG
         DXF_DEBUG_END
@@ -306,6 +306,13 @@ dxf_dimension_read
         DxfFile *fp,
         DxfDimension *dxf_dimension
 );
+struct dxf_arena;
+DxfDimension *
+dxf_dimension_dup
+(
+        DxfDimension *dxf_dimension,
+        struct dxf_arena *arena
+);
 int
 dxf_dimension_write
 (
@@ -32,7 +32,10 @@
  */
 
 
+#include <pthread.h>
 #include "dimstyle.h"
+#include "allocator.h"
+#include "field.h"
 
 
 /*!
@@ -58,7 +61,7 @@ dxf_dimstyle_new ()
         size = sizeof (DxfDimStyle);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_dimstyle = malloc (size)) == NULL)
+        if ((dxf_dimstyle = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfDimStyle struct.\n")),
@@ -97,6 +100,11 @@ dxf_dimstyle_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfDimStyle template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         /* Do some basic checks. */
         if (dxf_dimstyle == NULL)
         {
@@ -112,48 +120,61 @@ dxf_dimstyle_init
                 __FUNCTION__);
               return (NULL);
         }
-        dxf_dimstyle->dimstyle_name = strdup ("");
-        dxf_dimstyle->dimpost = strdup ("");
-        dxf_dimstyle->dimapost = strdup ("");
-        dxf_dimstyle->dimblk = strdup ("");
-        dxf_dimstyle->dimblk1 = strdup ("");
-        dxf_dimstyle->dimblk2 = strdup ("");
-        dxf_dimstyle->dimscale = 0.0;
-        dxf_dimstyle->dimasz = 0.0;
-        dxf_dimstyle->dimexo = 0.0;
-        dxf_dimstyle->dimdli = 0.0;
-        dxf_dimstyle->dimexe = 0.0;
-        dxf_dimstyle->dimrnd = 0.0;
-        dxf_dimstyle->dimdle = 0.0;
-        dxf_dimstyle->dimtp = 0.0;
-        dxf_dimstyle->dimtm = 0.0;
-        dxf_dimstyle->flag = 0;
-        dxf_dimstyle->dimtol = 0;
-        dxf_dimstyle->dimlim = 0;
-        dxf_dimstyle->dimtih = 0;
-        dxf_dimstyle->dimtoh = 0;
-        dxf_dimstyle->dimse1 = 0;
-        dxf_dimstyle->dimse2 = 0;
-        dxf_dimstyle->dimtad = 0;
-        dxf_dimstyle->dimzin = 0;
-        dxf_dimstyle->dimtxt = 0.0;
-        dxf_dimstyle->dimcen = 0.0;
-        dxf_dimstyle->dimtsz = 0.0;
-        dxf_dimstyle->dimaltf = 0.0;
-        dxf_dimstyle->dimlfac = 0.0;
-        dxf_dimstyle->dimtvp = 0.0;
-        dxf_dimstyle->dimtfac = 0.0;
-        dxf_dimstyle->dimgap = 0.0;
-        dxf_dimstyle->dimalt = 0;
-        dxf_dimstyle->dimaltd = 0;
-        dxf_dimstyle->dimtofl = 0;
-        dxf_dimstyle->dimsah = 0;
-        dxf_dimstyle->dimtix = 0;
-        dxf_dimstyle->dimsoxd = 0;
-        dxf_dimstyle->dimclrd = DXF_COLOR_BYLAYER;
-        dxf_dimstyle->dimclre = DXF_COLOR_BYLAYER;
-        dxf_dimstyle->dimclrt = DXF_COLOR_BYLAYER;
-        dxf_dimstyle->next = NULL;
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.dimstyle_name = strdup ("");
+                template.dimpost = strdup ("");
+                template.dimapost = strdup ("");
+                template.dimblk = strdup ("");
+                template.dimblk1 = strdup ("");
+                template.dimblk2 = strdup ("");
+                template.dimscale = 0.0;
+                template.dimasz = 0.0;
+                template.dimexo = 0.0;
+                template.dimdli = 0.0;
+                template.dimexe = 0.0;
+                template.dimrnd = 0.0;
+                template.dimdle = 0.0;
+                template.dimtp = 0.0;
+                template.dimtm = 0.0;
+                template.flag = 0;
+                template.dimtol = 0;
+                template.dimlim = 0;
+                template.dimtih = 0;
+                template.dimtoh = 0;
+                template.dimse1 = 0;
+                template.dimse2 = 0;
+                template.dimtad = 0;
+                template.dimzin = 0;
+                template.dimtxt = 0.0;
+                template.dimcen = 0.0;
+                template.dimtsz = 0.0;
+                template.dimaltf = 0.0;
+                template.dimlfac = 0.0;
+                template.dimtvp = 0.0;
+                template.dimtfac = 0.0;
+                template.dimgap = 0.0;
+                template.dimalt = 0;
+                template.dimaltd = 0;
+                template.dimtofl = 0;
+                template.dimsah = 0;
+                template.dimtix = 0;
+                template.dimsoxd = 0;
+                template.dimclrd = DXF_COLOR_BYLAYER;
+                template.dimclre = DXF_COLOR_BYLAYER;
+                template.dimclrt = DXF_COLOR_BYLAYER;
+                template.next = NULL;
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (dxf_dimstyle, &template, sizeof (DxfDimStyle));
+        dxf_dimstyle->dimstyle_name = strdup (template.dimstyle_name);
+        dxf_dimstyle->dimpost = strdup (template.dimpost);
+        dxf_dimstyle->dimapost = strdup (template.dimapost);
+        dxf_dimstyle->dimblk = strdup (template.dimblk);
+        dxf_dimstyle->dimblk1 = strdup (template.dimblk1);
+        dxf_dimstyle->dimblk2 = strdup (template.dimblk2);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -161,6 +182,212 @@ dxf_dimstyle_init
 }
 
 
+/*!
+ * \brief Field table mapping group codes to \c DxfDimStyle members,
+ * sorted by group code.
+ */
+static const DxfFieldSpec dxf_dimstyle_field_table[] =
+{
+        {2, DXF_FIELD_TYPE_STRING, offsetof (DxfDimStyle, dimstyle_name)},
+        {3, DXF_FIELD_TYPE_STRING, offsetof (DxfDimStyle, dimpost)},
+        {4, DXF_FIELD_TYPE_STRING, offsetof (DxfDimStyle, dimapost)},
+        {40, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimStyle, dimscale)},
+        {41, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimStyle, dimasz)},
+        {42, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimStyle, dimexo)},
+        {43, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimStyle, dimdli)},
+        {44, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimStyle, dimexe)},
+        {45, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimStyle, dimrnd)},
+        {46, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimStyle, dimdle)},
+        {47, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimStyle, dimtp)},
+        {48, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimStyle, dimtm)},
+        {70, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, flag)},
+        {71, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimtol)},
+        {72, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimlim)},
+        {73, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimtih)},
+        {74, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimtoh)},
+        {75, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimse1)},
+        {76, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimse2)},
+        {77, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimtad)},
+        {78, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimzin)},
+        {105, DXF_FIELD_TYPE_HEX, offsetof (DxfDimStyle, id_code)},
+        {140, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimStyle, dimtxt)},
+        {141, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimStyle, dimcen)},
+        {142, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimStyle, dimtsz)},
+        {143, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimStyle, dimaltf)},
+        {144, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimStyle, dimlfac)},
+        {145, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimStyle, dimtvp)},
+        {146, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimStyle, dimtfac)},
+        {147, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimStyle, dimgap)},
+        {170, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimalt)},
+        {171, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimaltd)},
+        {172, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimtofl)},
+        {173, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimsah)},
+        {174, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimtix)},
+        {175, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimsoxd)},
+        {176, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimclrd)},
+        {177, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimclre)},
+        {178, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimclrt)},
+        {270, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimunit)},
+        {271, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimdec)},
+        {272, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimtdec)},
+        {273, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimaltu)},
+        {274, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimalttd)},
+        {275, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimaunit)},
+        {280, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimjust)},
+        {281, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimsd1)},
+        {282, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimsd2)},
+        {283, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimtolj)},
+        {284, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimtzin)},
+        {285, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimaltz)},
+        {286, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimalttz)},
+        {287, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimfit)},
+        {288, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimupt)},
+        {340, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimtxsty)}
+};
+
+
+/*!
+ * \brief One entry of the \c DIMSTYLE write list: a field plus the
+ * range of AutoCAD versions carrying it.
+ */
+typedef struct
+dxf_dimstyle_write_spec
+{
+        int group_code;
+                /*!< DXF group code of the field. */
+        DxfFieldType type;
+                /*!< storage type of the struct member. */
+        size_t offset;
+                /*!< \c offsetof the member within \c DxfDimStyle. */
+        int min_version;
+                /*!< lowest AutoCAD version number emitting the field. */
+        int max_version;
+                /*!< highest AutoCAD version number emitting the field. */
+} DxfDimStyleWriteSpec;
+
+
+/*!
+ * \brief The \c DIMSTYLE write list, in record emission order.
+ *
+ * A \c DIMSTYLE record has a fixed shape, so the whole record can be
+ * formatted into a single buffer by one pass over this list and leave
+ * the library with one \c fwrite instead of some seventy \c fprintf
+ * calls.
+ */
+static const DxfDimStyleWriteSpec dxf_dimstyle_write_list[] =
+{
+        {2, DXF_FIELD_TYPE_STRING, offsetof (DxfDimStyle, dimstyle_name), 0, 9999},
+        {70, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, flag), 0, 9999},
+        {3, DXF_FIELD_TYPE_STRING, offsetof (DxfDimStyle, dimpost), 0, 9999},
+        {4, DXF_FIELD_TYPE_STRING, offsetof (DxfDimStyle, dimapost), 0, 9999},
+        {5, DXF_FIELD_TYPE_STRING, offsetof (DxfDimStyle, dimblk), 0, AutoCAD_14},
+        {6, DXF_FIELD_TYPE_STRING, offsetof (DxfDimStyle, dimblk1), 0, AutoCAD_14},
+        {7, DXF_FIELD_TYPE_STRING, offsetof (DxfDimStyle, dimblk2), 0, AutoCAD_14},
+        {40, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimStyle, dimscale), 0, 9999},
+        {41, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimStyle, dimasz), 0, 9999},
+        {42, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimStyle, dimexo), 0, 9999},
+        {43, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimStyle, dimdli), 0, 9999},
+        {44, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimStyle, dimexe), 0, 9999},
+        {45, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimStyle, dimrnd), 0, 9999},
+        {46, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimStyle, dimdle), 0, 9999},
+        {47, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimStyle, dimtp), 0, 9999},
+        {48, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimStyle, dimtm), 0, 9999},
+        {140, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimStyle, dimtxt), 0, 9999},
+        {141, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimStyle, dimcen), 0, 9999},
+        {142, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimStyle, dimtsz), 0, 9999},
+        {143, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimStyle, dimaltf), 0, 9999},
+        {144, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimStyle, dimlfac), 0, 9999},
+        {145, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimStyle, dimtvp), 0, 9999},
+        {146, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimStyle, dimtfac), 0, 9999},
+        {147, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfDimStyle, dimgap), 0, 9999},
+        {71, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimtol), 0, 9999},
+        {72, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimlim), 0, 9999},
+        {73, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimtih), 0, 9999},
+        {74, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimtoh), 0, 9999},
+        {75, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimse1), 0, 9999},
+        {76, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimse2), 0, 9999},
+        {77, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimtad), 0, 9999},
+        {78, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimzin), 0, 9999},
+        {170, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimalt), 0, 9999},
+        {171, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimaltd), 0, 9999},
+        {172, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimtofl), 0, 9999},
+        {173, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimsah), 0, 9999},
+        {174, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimtix), 0, 9999},
+        {175, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimsoxd), 0, 9999},
+        {176, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimclrd), 0, 9999},
+        {177, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimclre), 0, 9999},
+        {178, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimclrt), 0, 9999},
+        {270, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimunit), AutoCAD_13, AutoCAD_14},
+        {271, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimdec), AutoCAD_13, AutoCAD_14},
+        {272, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimtdec), AutoCAD_13, AutoCAD_14},
+        {273, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimaltu), AutoCAD_13, AutoCAD_14},
+        {274, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimalttd), AutoCAD_13, AutoCAD_14},
+        {340, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimtxsty), AutoCAD_13, AutoCAD_14},
+        {275, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimaunit), AutoCAD_13, AutoCAD_14},
+        {280, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimjust), AutoCAD_13, AutoCAD_14},
+        {281, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimsd1), AutoCAD_13, AutoCAD_14},
+        {282, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimsd2), AutoCAD_13, AutoCAD_14},
+        {283, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimtolj), AutoCAD_13, AutoCAD_14},
+        {284, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimtzin), AutoCAD_13, AutoCAD_14},
+        {285, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimaltz), AutoCAD_13, AutoCAD_14},
+        {286, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimalttz), AutoCAD_13, AutoCAD_14},
+        {287, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimfit), AutoCAD_13, AutoCAD_14},
+        {288, DXF_FIELD_TYPE_INT, offsetof (DxfDimStyle, dimupt), AutoCAD_13, AutoCAD_14}
+};
+
+
+/*!
+ * \brief Handle the version dependent arrow block name fields of a
+ * \c DIMSTYLE table record which cannot be table driven.
+ */
+static int
+dxf_dimstyle_read_special
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an input file (or device). */
+        void *entity,
+                /*!< DXF \c DIMSTYLE table record. */
+        int group_code
+                /*!< group code read by the shared parse loop. */
+)
+{
+        DxfDimStyle *dxf_dimstyle = (DxfDimStyle *) entity;
+        char **member;
+        char *value;
+
+        switch (group_code)
+        {
+                case 5:
+                        member = &dxf_dimstyle->dimblk;
+                        break;
+                case 6:
+                        member = &dxf_dimstyle->dimblk1;
+                        break;
+                case 7:
+                        member = &dxf_dimstyle->dimblk2;
+                        break;
+                default:
+                        return (FAIL);
+        }
+        /* Now follows a string containing an arrow block name. */
+        value = dxf_read_value_line_grow (fp);
+        if (value == NULL)
+        {
+                return (FAIL);
+        }
+        if (fp->acad_version_number < AutoCAD_2000)
+        {
+                free (*member);
+                *member = strdup (value);
+        }
+/*!
+ * \todo For AutoCAD versions >= 2000 the value of group codes 5, 6 and
+ * 7 has to be tested before overwriting the id_code.
+ */
+        return (FOUND);
+}
+
+
 /*!
  * \brief Write DXF output for a DXF \c DIMSTYLE table.
  *
@@ -184,6 +411,12 @@ dxf_dimstyle_write
         DXF_DEBUG_BEGIN
 #endif
         char *dxf_entity_name = strdup ("DIMSTYLE");
+        const DxfDimStyleWriteSpec *spec;
+        char *buffer;
+        char *at;
+        char *base;
+        size_t length;
+        size_t i;
 
         /* Do some basic checks. */
         if (fp == NULL)
@@ -244,91 +477,86 @@ dxf_dimstyle_write
         {
                 dxf_dimstyle->dimblk2 = strdup ("");
         }
-        /* Start writing output. */
-        fprintf (fp->fp, "  0\n%s\n", dxf_entity_name);
-        if (dxf_dimstyle->id_code != -1)
+        /* Start writing output: format the whole record into a single
+         * buffer and hand it to the stdio layer in one write. */
+        length = sizeof ("  0\nDIMSTYLE\n"
+                "105\n\n"
+                "100\nAcDbSymbolTableRecord\n"
+                "100\nAcDbDimStyleTableRecord\n"
+                "  0\nENDTAB\n") + 16;
+        for (i = 0; i < DXF_FIELD_TABLE_LENGTH (dxf_dimstyle_write_list); i++)
         {
-                fprintf (fp->fp, "105\n%x\n", dxf_dimstyle->id_code);
+                spec = &dxf_dimstyle_write_list[i];
+                if ((fp->acad_version_number < spec->min_version)
+                  || (fp->acad_version_number > spec->max_version))
+                {
+                        continue;
+                }
+                if (spec->type == DXF_FIELD_TYPE_STRING)
+                {
+                        length += strlen (*((char **) (((char *) dxf_dimstyle) + spec->offset))) + 8;
+                }
+                else
+                {
+                        /* wide enough for any %f or %d rendering. */
+                        length += 336;
+                }
         }
-        if (fp->acad_version_number >= AutoCAD_13)
+        buffer = malloc (length);
+        if (buffer == NULL)
         {
-                fprintf (fp->fp, "100\nAcDbSymbolTableRecord\n");
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                free (dxf_entity_name);
+                return (EXIT_FAILURE);
         }
-        if (fp->acad_version_number >= AutoCAD_13)
+        at = buffer;
+        at += sprintf (at, "  0\n%s\n", dxf_entity_name);
+        if (dxf_dimstyle->id_code != -1)
         {
-                fprintf (fp->fp, "100\nAcDbDimStyleTableRecord\n");
+                at += sprintf (at, "105\n%x\n", dxf_dimstyle->id_code);
         }
-        fprintf (fp->fp, "  2\n%s\n", dxf_dimstyle->dimstyle_name);
-        fprintf (fp->fp, " 70\n%d\n", dxf_dimstyle->flag);
-        fprintf (fp->fp, "  3\n%s\n", dxf_dimstyle->dimpost);
-        fprintf (fp->fp, "  4\n%s\n", dxf_dimstyle->dimapost);
-        if (fp->acad_version_number < AutoCAD_2000)
+        if (fp->acad_version_number >= AutoCAD_13)
         {
-                fprintf (fp->fp, "  5\n%s\n", dxf_dimstyle->dimblk);
+                at += sprintf (at, "100\nAcDbSymbolTableRecord\n");
         }
-        if (fp->acad_version_number < AutoCAD_2000)
+        if (fp->acad_version_number >= AutoCAD_13)
         {
-                fprintf (fp->fp, "  6\n%s\n", dxf_dimstyle->dimblk1);
+                at += sprintf (at, "100\nAcDbDimStyleTableRecord\n");
         }
-        if (fp->acad_version_number < AutoCAD_2000)
+        for (i = 0; i < DXF_FIELD_TABLE_LENGTH (dxf_dimstyle_write_list); i++)
         {
-                fprintf (fp->fp, "  7\n%s\n", dxf_dimstyle->dimblk2);
+                spec = &dxf_dimstyle_write_list[i];
+                if ((fp->acad_version_number < spec->min_version)
+                  || (fp->acad_version_number > spec->max_version))
+                {
+                        continue;
+                }
+                base = ((char *) dxf_dimstyle) + spec->offset;
+                switch (spec->type)
+                {
+                        case DXF_FIELD_TYPE_STRING:
+                                at += sprintf (at, "%3d\n%s\n",
+                                        spec->group_code, *((char **) base));
+                                break;
+                        case DXF_FIELD_TYPE_DOUBLE:
+                                at += sprintf (at, "%3d\n%f\n",
+                                        spec->group_code, *((double *) base));
+                                break;
+                        default:
+                                at += sprintf (at, "%3d\n%d\n",
+                                        spec->group_code, *((int *) base));
+                                break;
+                }
         }
-        fprintf (fp->fp, " 40\n%f\n", dxf_dimstyle->dimscale);
-        fprintf (fp->fp, " 41\n%f\n", dxf_dimstyle->dimasz);
-        fprintf (fp->fp, " 42\n%f\n", dxf_dimstyle->dimexo);
-        fprintf (fp->fp, " 43\n%f\n", dxf_dimstyle->dimdli);
-        fprintf (fp->fp, " 44\n%f\n", dxf_dimstyle->dimexe);
-        fprintf (fp->fp, " 45\n%f\n", dxf_dimstyle->dimrnd);
-        fprintf (fp->fp, " 46\n%f\n", dxf_dimstyle->dimdle);
-        fprintf (fp->fp, " 47\n%f\n", dxf_dimstyle->dimtp);
-        fprintf (fp->fp, " 48\n%f\n", dxf_dimstyle->dimtm);
-        fprintf (fp->fp, "140\n%f\n", dxf_dimstyle->dimtxt);
-        fprintf (fp->fp, "141\n%f\n", dxf_dimstyle->dimcen);
-        fprintf (fp->fp, "142\n%f\n", dxf_dimstyle->dimtsz);
-        fprintf (fp->fp, "143\n%f\n", dxf_dimstyle->dimaltf);
-        fprintf (fp->fp, "144\n%f\n", dxf_dimstyle->dimlfac);
-        fprintf (fp->fp, "145\n%f\n", dxf_dimstyle->dimtvp);
-        fprintf (fp->fp, "146\n%f\n", dxf_dimstyle->dimtfac);
-        fprintf (fp->fp, "147\n%f\n", dxf_dimstyle->dimgap);
-        fprintf (fp->fp, " 71\n%d\n", dxf_dimstyle->dimtol);
-        fprintf (fp->fp, " 72\n%d\n", dxf_dimstyle->dimlim);
-        fprintf (fp->fp, " 73\n%d\n", dxf_dimstyle->dimtih);
-        fprintf (fp->fp, " 74\n%d\n", dxf_dimstyle->dimtoh);
-        fprintf (fp->fp, " 75\n%d\n", dxf_dimstyle->dimse1);
-        fprintf (fp->fp, " 76\n%d\n", dxf_dimstyle->dimse2);
-        fprintf (fp->fp, " 77\n%d\n", dxf_dimstyle->dimtad);
-        fprintf (fp->fp, " 78\n%d\n", dxf_dimstyle->dimzin);
-        fprintf (fp->fp, "170\n%d\n", dxf_dimstyle->dimalt);
-        fprintf (fp->fp, "171\n%d\n", dxf_dimstyle->dimaltd);
-        fprintf (fp->fp, "172\n%d\n", dxf_dimstyle->dimtofl);
-        fprintf (fp->fp, "173\n%d\n", dxf_dimstyle->dimsah);
-        fprintf (fp->fp, "174\n%d\n", dxf_dimstyle->dimtix);
-        fprintf (fp->fp, "175\n%d\n", dxf_dimstyle->dimsoxd);
-        fprintf (fp->fp, "176\n%d\n", dxf_dimstyle->dimclrd);
-        fprintf (fp->fp, "177\n%d\n", dxf_dimstyle->dimclre);
-        fprintf (fp->fp, "178\n%d\n", dxf_dimstyle->dimclrt);
         if ((fp->acad_version_number >= AutoCAD_13)
           && (fp->acad_version_number < AutoCAD_2000))
         {
-                fprintf (fp->fp, "270\n%d\n", dxf_dimstyle->dimunit);
-                fprintf (fp->fp, "271\n%d\n", dxf_dimstyle->dimdec);
-                fprintf (fp->fp, "272\n%d\n", dxf_dimstyle->dimtdec);
-                fprintf (fp->fp, "273\n%d\n", dxf_dimstyle->dimaltu);
-                fprintf (fp->fp, "274\n%d\n", dxf_dimstyle->dimalttd);
-                fprintf (fp->fp, "340\n%d\n", dxf_dimstyle->dimtxsty);
-                fprintf (fp->fp, "275\n%d\n", dxf_dimstyle->dimaunit);
-                fprintf (fp->fp, "280\n%d\n", dxf_dimstyle->dimjust);
-                fprintf (fp->fp, "281\n%d\n", dxf_dimstyle->dimsd1);
-                fprintf (fp->fp, "282\n%d\n", dxf_dimstyle->dimsd2);
-                fprintf (fp->fp, "283\n%d\n", dxf_dimstyle->dimtolj);
-                fprintf (fp->fp, "284\n%d\n", dxf_dimstyle->dimtzin);
-                fprintf (fp->fp, "285\n%d\n", dxf_dimstyle->dimaltz);
-                fprintf (fp->fp, "286\n%d\n", dxf_dimstyle->dimalttz);
-                fprintf (fp->fp, "287\n%d\n", dxf_dimstyle->dimfit);
-                fprintf (fp->fp, "288\n%d\n", dxf_dimstyle->dimupt);
-                fprintf (fp->fp, "  0\nENDTAB\n");
+                at += sprintf (at, "  0\nENDTAB\n");
         }
+        fwrite (buffer, 1, (size_t) (at - buffer), fp->fp);
+        free (buffer);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -362,8 +590,6 @@ dxf_dimstyle_read
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        char *temp_string = NULL;
-
         /* Do some basic checks. */
         if (fp == NULL)
         {
@@ -380,477 +606,12 @@ dxf_dimstyle_read
                 dxf_dimstyle = dxf_dimstyle_new ();
                 dxf_dimstyle = dxf_dimstyle_init (dxf_dimstyle);
         }
-        (fp->line_number)++;
-        fscanf (fp->fp, "%[^\n]", temp_string);
-        while (strcmp (temp_string, "0") != 0)
+        if (dxf_field_read_all (fp, dxf_dimstyle, dxf_dimstyle_field_table,
+                DXF_FIELD_TABLE_LENGTH (dxf_dimstyle_field_table),
+                "AcDbSymbolTableRecord AcDbDimStyleTableRecord",
+                dxf_dimstyle_read_special) != EXIT_SUCCESS)
         {
-                if (ferror (fp->fp))
-                {
-                        fprintf (stderr,
-                          (_("Error in %s () while reading from: %s in line: %d.\n")),
-                          __FUNCTION__, fp->filename, fp->line_number);
-                        fclose (fp->fp);
-                        return (NULL);
-                }
-                if (strcmp (temp_string, "2") == 0)
-                {
-                        /* Now follows a string containing a dimension
-                         * style name. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_dimstyle->dimstyle_name);
-                }
-                else if (strcmp (temp_string, "3") == 0)
-                {
-                        /* Now follows a string containing a general
-                         * dimensioning suffix. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_dimstyle->dimpost);
-                }
-                else if (strcmp (temp_string, "4") == 0)
-                {
-                        /* Now follows a string containing an alternate
-                         * dimensioning suffix. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_dimstyle->dimapost);
-                }
-                else if ((fp->acad_version_number < AutoCAD_2000)
-                        && (strcmp (temp_string, "5") == 0))
-                {
-                        /* Now follows a string containing an arrow
-                         * block name. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_dimstyle->dimblk);
-                }
-                else if ((fp->acad_version_number < AutoCAD_2000)
-                        && (strcmp (temp_string, "6") == 0))
-                {
-                        /* Now follows a string containing a first arrow
-                         * block name. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_dimstyle->dimblk1);
-                }
-#if 0
-/*!
- * \todo For AutoCAD versions > 2000 the value of group code 6 has to be
- * tested before overwriting the id_code.
- */
-                else if ((fp->acad_version_number >= AutoCAD_2000)
-                        && (strcmp (temp_string, "6") == 0))
-                {
-                        /* Now follows a string containing a sequential
-                         * id number. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%x\n", &dxf_dimstyle->id_code);
-                }
-#endif
-                else if ((fp->acad_version_number < AutoCAD_2000)
-                        && (strcmp (temp_string, "7") == 0))
-                {
-                        /* Now follows a string containing a first arrow
-                         * block name. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_dimstyle->dimblk2);
-                }
-#if 0
-/*!
- * \todo For AutoCAD versions > 2000 the value of group code 7 has to be
- * tested before overwriting the id_code.
- */
-                else if ((fp->acad_version_number >= AutoCAD_2000)
-                        && (strcmp (temp_string, "7") == 0))
-                {
-                        /* Now follows a string containing a sequential
-                         * id number. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%x\n", &dxf_dimstyle->id_code);
-                }
-#endif
-                else if (strcmp (temp_string, "40") == 0)
-                {
-                        /* Now follows a string containing an overall
-                         * dimensioning scale factor. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimstyle->dimscale);
-                }
-                else if (strcmp (temp_string, "41") == 0)
-                {
-                        /* Now follows a string containing a
-                         * dimensioning arrow size. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimstyle->dimasz);
-                }
-                else if (strcmp (temp_string, "42") == 0)
-                {
-                        /* Now follows a string containing a
-                         * extension line offset. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimstyle->dimexo);
-                }
-                else if (strcmp (temp_string, "43") == 0)
-                {
-                        /* Now follows a string containing a
-                         * dimension line increment. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimstyle->dimdli);
-                }
-                else if (strcmp (temp_string, "44") == 0)
-                {
-                        /* Now follows a string containing a
-                         * extension line extension. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimstyle->dimexe);
-                }
-                else if (strcmp (temp_string, "45") == 0)
-                {
-                        /* Now follows a string containing a
-                         * rounding value for dimension distances. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimstyle->dimrnd);
-                }
-                else if (strcmp (temp_string, "46") == 0)
-                {
-                        /* Now follows a string containing a
-                         * dimension line extension. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimstyle->dimdle);
-                }
-                else if (strcmp (temp_string, "47") == 0)
-                {
-                        /* Now follows a string containing a
-                         * plus tolerance. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimstyle->dimtp);
-                }
-                else if (strcmp (temp_string, "48") == 0)
-                {
-                        /* Now follows a string containing a
-                         * minus tolerance. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimstyle->dimtm);
-                }
-                else if (strcmp (temp_string, "70") == 0)
-                {
-                        /* Now follows a string containing a flag. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_dimstyle->flag);
-                }
-                else if (strcmp (temp_string, "71") == 0)
-                {
-                        /* Now follows a string containing a dimension
-                         * tolerances flag. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_dimstyle->dimtol);
-                }
-                else if (strcmp (temp_string, "72") == 0)
-                {
-                        /* Now follows a string containing a dimension
-                         * limits flag. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_dimstyle->dimlim);
-                }
-                else if (strcmp (temp_string, "73") == 0)
-                {
-                        /* Now follows a string containing a dimension
-                         * text inside horizontal flag. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_dimstyle->dimtih);
-                }
-                else if (strcmp (temp_string, "74") == 0)
-                {
-                        /* Now follows a string containing a dimension
-                         * text outside horizontal flag. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_dimstyle->dimtoh);
-                }
-                else if (strcmp (temp_string, "75") == 0)
-                {
-                        /* Now follows a string containing a first
-                         * extension line suppression flag. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_dimstyle->dimse1);
-                }
-                else if (strcmp (temp_string, "76") == 0)
-                {
-                        /* Now follows a string containing a second
-                         * extension line suppression flag. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_dimstyle->dimse2);
-                }
-                else if (strcmp (temp_string, "77") == 0)
-                {
-                        /* Now follows a string containing a text above
-                         * dimension line flag. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_dimstyle->dimtad);
-                }
-                else if (strcmp (temp_string, "78") == 0)
-                {
-                        /* Now follows a string containing a zero
-                         * suppression for "feet & inch" dimensions
-                         * flag. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_dimstyle->dimzin);
-                }
-                else if ((fp->acad_version_number >= AutoCAD_13)
-                        && (strcmp (temp_string, "100") == 0))
-                {
-                        /* Now follows a string containing the
-                         * subclass marker value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", temp_string);
-                        if ((strcmp (temp_string, "AcDbSymbolTableRecord") != 0)
-                        && (strcmp (temp_string, "AcDbDimStyleTableRecord") != 0))
-                        {
-                                fprintf (stderr,
-                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %d.\n")),
-                                  __FUNCTION__, fp->filename, fp->line_number);
-                        }
-                }
-                else if (strcmp (temp_string, "105") == 0)
-                {
-                        /* Now follows a string containing a sequential
-                         * id number. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%x\n", &dxf_dimstyle->id_code);
-                }
-                else if (strcmp (temp_string, "140") == 0)
-                {
-                        /* Now follows a string containing a
-                         * dimensioning text height. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimstyle->dimtxt);
-                }
-                else if (strcmp (temp_string, "141") == 0)
-                {
-                        /* Now follows a string containing a size of
-                         * center mark/lines. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimstyle->dimcen);
-                }
-                else if (strcmp (temp_string, "142") == 0)
-                {
-                        /* Now follows a string containing a
-                         * dimensioning tick size: 0 = no ticks. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimstyle->dimtsz);
-                }
-                else if (strcmp (temp_string, "143") == 0)
-                {
-                        /* Now follows a string containing a
-                         * alternate unit scale factor. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimstyle->dimaltf);
-                }
-                else if (strcmp (temp_string, "144") == 0)
-                {
-                        /* Now follows a string containing a linear
-                         * measurements scale factor. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimstyle->dimlfac);
-                }
-                else if (strcmp (temp_string, "145") == 0)
-                {
-                        /* Now follows a string containing a text
-                         * vertical position. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimstyle->dimtvp);
-                }
-                else if (strcmp (temp_string, "146") == 0)
-                {
-                        /* Now follows a string containing a dimension
-                         * tolerance display scale factor. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimstyle->dimtfac);
-                }
-                else if (strcmp (temp_string, "147") == 0)
-                {
-                        /* Now follows a string containing a dimension
-                         * line gap. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_dimstyle->dimgap);
-                }
-                else if (strcmp (temp_string, "170") == 0)
-                {
-                        /* Now follows a string containing a alternate
-                         * unit dimensioning flag. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_dimstyle->dimalt);
-                }
-                else if (strcmp (temp_string, "171") == 0)
-                {
-                        /* Now follows a string containing a alternate
-                         * unit decimal places. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_dimstyle->dimaltd);
-                }
-                else if (strcmp (temp_string, "172") == 0)
-                {
-                        /* Now follows a string containing a text
-                         * outside extensions, force line extensions
-                         * between extensions flag. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_dimstyle->dimtofl);
-                }
-                else if (strcmp (temp_string, "173") == 0)
-                {
-                        /* Now follows a string containing a use
-                         * separate arrow blocks flag. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_dimstyle->dimsah);
-                }
-                else if (strcmp (temp_string, "174") == 0)
-                {
-                        /* Now follows a string containing a force text
-                         * inside extensions flag. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_dimstyle->dimtix);
-                }
-                else if (strcmp (temp_string, "175") == 0)
-                {
-                        /* Now follows a string containing a suppress
-                         * outside-extensions dimension lines flag. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_dimstyle->dimsoxd);
-                }
-                else if (strcmp (temp_string, "176") == 0)
-                {
-                        /* Now follows a string containing a dimension
-                         * line color value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_dimstyle->dimclrd);
-                }
-                else if (strcmp (temp_string, "177") == 0)
-                {
-                        /* Now follows a string containing a dimension
-                         * extension line color value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_dimstyle->dimclre);
-                }
-                else if (strcmp (temp_string, "178") == 0)
-                {
-                        /* Now follows a string containing a dimension
-                         * text color value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_dimstyle->dimclrt);
-                }
-                else if (strcmp (temp_string, "270") == 0)
-                {
-                        /* Now follows a string containing a units
-                         * format for all dimension style family members
-                         * except angular. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_dimstyle->dimunit);
-                }
-                else if (strcmp (temp_string, "271") == 0)
-                {
-                        /* Now follows a string containing a number of
-                         * decimal places for the tolerance values of
-                         * a primary units dimension. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_dimstyle->dimdec);
-                }
-                else if (strcmp (temp_string, "272") == 0)
-                {
-                        /* Now follows a string containing a number of
-                         * decimal places to display the tolerance
-                         * values. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_dimstyle->dimtdec);
-                }
-                else if (strcmp (temp_string, "273") == 0)
-                {
-                        /* Now follows a string containing a units
-                         * format for alternate units of all dimension
-                         * style family members except angular. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_dimstyle->dimaltu);
-                }
-                else if (strcmp (temp_string, "274") == 0)
-                {
-                        /* Now follows a string containing a number of
-                         * decimal places for tolerance values of an
-                         * alternate units dimension. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_dimstyle->dimalttd);
-                }
-                else if (strcmp (temp_string, "275") == 0)
-                {
-                        /* Now follows a string containing an angle
-                         * format for angular dimensions. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_dimstyle->dimaunit);
-                }
-                else if (strcmp (temp_string, "280") == 0)
-                {
-                        /* Now follows a string containing a horizontal
-                         * dimension text position. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_dimstyle->dimjust);
-                }
-                else if (strcmp (temp_string, "281") == 0)
-                {
-                        /* Now follows a string containing suppression
-                         * of first extension line. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_dimstyle->dimsd1);
-                }
-                else if (strcmp (temp_string, "282") == 0)
-                {
-                        /* Now follows a string containing suppression
-                         * of second extension line. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_dimstyle->dimsd2);
-                }
-                else if (strcmp (temp_string, "283") == 0)
-                {
-                        /* Now follows a string containing vertical
-                         * justification for tolerance values. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_dimstyle->dimtolj);
-                }
-                else if (strcmp (temp_string, "284") == 0)
-                {
-                        /* Now follows a string containing suppression
-                         * of zeros for tolerance values. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_dimstyle->dimtzin);
-                }
-                else if (strcmp (temp_string, "285") == 0)
-                {
-                        /* Now follows a string containing toggles
-                         * suppression of zeros for alternate unit
-                         * dimension values. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_dimstyle->dimaltz);
-                }
-                else if (strcmp (temp_string, "286") == 0)
-                {
-                        /* Now follows a string containing toggles
-                         * suppression of zeros for tolerance values. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_dimstyle->dimalttz);
-                }
-                else if (strcmp (temp_string, "287") == 0)
-                {
-                        /* Now follows a string containing placement of
-                         * text and arrowheads. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_dimstyle->dimfit);
-                }
-                else if (strcmp (temp_string, "288") == 0)
-                {
-                        /* Now follows a string containing cursor
-                         * functionality for user positioned text. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_dimstyle->dimupt);
-                }
-                else if (strcmp (temp_string, "340") == 0)
-                {
-                        /* Now follows a string containing dimension
-                         * text style. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_dimstyle->dimtxsty);
-                }
+                return (NULL);
         }
         /* Handle omitted members and/or illegal values. */
         if (strcmp (dxf_dimstyle->dimstyle_name, "") == 0)
@@ -901,7 +662,7 @@ dxf_dimstyle_free
         free (dxf_dimstyle->dimblk);
         free (dxf_dimstyle->dimblk1);
         free (dxf_dimstyle->dimblk2);
-        free (dxf_dimstyle);
+        dxf_entity_dealloc (dxf_dimstyle, sizeof (*dxf_dimstyle));
         dxf_dimstyle = NULL;
 #if DEBUG
         DXF_DEBUG_END
@@ -0,0 +1,522 @@
+/*!
+ * \file doc_cache.c
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Functions for the cache of parsed, frozen drawings.
+ *
+ * The cache pairs each distinct file content — keyed by an FNV-1a
+ * hash of the bytes, so renamed copies of one drawing share an entry —
+ * with a drawing built once by the application's loader callback into
+ * a dedicated arena.\n
+ * After the load the drawing is immutable, so threads share it
+ * without locking; the mutex only guards the entry list during
+ * lookup, insertion and eviction, never during reads of a cached
+ * drawing.\n
+ * The budget is charged in arena bytes (the dominant cost of a parsed
+ * drawing) and enforced by evicting the least recently acquired
+ * unreferenced entries.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "global.h"
+#include "doc_cache.h"
+
+
+/*!
+ * \brief Hash the content of a file.
+ *
+ * 64 bit FNV-1a over the file bytes, read through a private mapping
+ * so hashing a large drawing costs one sequential pass and no heap.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when the file
+ * could not be read.
+ */
+static int
+dxf_doc_cache_hash_file
+(
+        char *filename,
+                /*!< filename of the file to hash. */
+        uint64_t *hash,
+                /*!< receives the content hash. */
+        size_t *file_size
+                /*!< receives the file size. */
+)
+{
+        struct stat sb;
+        char *mapped;
+        uint64_t h;
+        size_t size;
+        size_t i;
+        int fd;
+
+        fd = open (filename, O_RDONLY);
+        if (fd < 0)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not open file: %s for reading.\n")),
+                  __FUNCTION__, filename);
+                return (EXIT_FAILURE);
+        }
+        if (fstat (fd, &sb) != 0)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not stat file: %s.\n")),
+                  __FUNCTION__, filename);
+                close (fd);
+                return (EXIT_FAILURE);
+        }
+        size = (size_t) sb.st_size;
+        h = 14695981039346656037ULL;
+        if (size > 0)
+        {
+                mapped = mmap (NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (mapped == MAP_FAILED)
+                {
+                        fprintf (stderr,
+                          (_("Error in %s () could not map file: %s.\n")),
+                          __FUNCTION__, filename);
+                        close (fd);
+                        return (EXIT_FAILURE);
+                }
+#ifdef MADV_SEQUENTIAL
+                madvise (mapped, size, MADV_SEQUENTIAL);
+#endif
+                for (i = 0; i < size; i++)
+                {
+                        h ^= (unsigned char) mapped[i];
+                        h *= 1099511628211ULL;
+                }
+                munmap (mapped, size);
+        }
+        close (fd);
+        *hash = h;
+        *file_size = size;
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Release the storage of one cache entry.
+ */
+static void
+dxf_doc_cache_entry_free
+(
+        DxfDocCacheEntry *entry
+                /*!< the entry to free. */
+)
+{
+        dxf_drawing_free (entry->drawing);
+        dxf_arena_free (entry->arena);
+        free (entry);
+}
+
+
+/*!
+ * \brief Evict unreferenced entries until the cache fits its budget.
+ *
+ * Called with the cache lock held.
+ */
+static void
+dxf_doc_cache_evict
+(
+        DxfDocCache *cache
+                /*!< the cache to trim. */
+)
+{
+        DxfDocCacheEntry *entry;
+        DxfDocCacheEntry **at;
+        DxfDocCacheEntry **victim;
+
+        if (cache->budget_bytes == 0)
+        {
+                return;
+        }
+        while (cache->total_bytes > cache->budget_bytes)
+        {
+                victim = NULL;
+                for (at = &cache->entries; *at != NULL; at = &(*at)->next)
+                {
+                        if ((*at)->references > 0)
+                        {
+                                continue;
+                        }
+                        if ((victim == NULL)
+                                || ((*at)->last_used < (*victim)->last_used))
+                        {
+                                victim = at;
+                        }
+                }
+                if (victim == NULL)
+                {
+                        /* every entry is still referenced; the cache
+                         * runs over budget until a release. */
+                        return;
+                }
+                entry = *victim;
+                *victim = entry->next;
+                cache->total_bytes -= entry->bytes;
+                cache->evictions++;
+                dxf_doc_cache_entry_free (entry);
+        }
+}
+
+
+/*!
+ * \brief Allocate and initialize a document cache.
+ *
+ * \return a pointer to the cache, or \c NULL when errors occurred.
+ */
+DxfDocCache *
+dxf_doc_cache_new
+(
+        size_t budget_bytes,
+                /*!< arena bytes the cache may hold before evicting;
+                 * \c 0 means unlimited. */
+        DxfDocCacheLoader loader,
+                /*!< builds the drawing of a file on a miss. */
+        void *user_data
+                /*!< opaque pointer passed to the loader. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        DxfDocCache *cache;
+
+        if (loader == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        cache = calloc (1, sizeof (DxfDocCache));
+        if (cache == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        cache->budget_bytes = budget_bytes;
+        cache->loader = loader;
+        cache->user_data = user_data;
+        pthread_mutex_init (&cache->lock, NULL);
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (cache);
+}
+
+
+/*!
+ * \brief Acquire the frozen drawing of a file.
+ *
+ * The file content is hashed; a hit returns the cached drawing, a
+ * miss runs the loader to build it into a fresh arena and caches the
+ * result.\n
+ * The returned drawing is immutable and shared: any number of threads
+ * read it concurrently, and it stays valid until the matching
+ * \c dxf_doc_cache_release, after which the cache may evict it.\n
+ * The cache lock is dropped while the loader runs, so a slow parse
+ * does not serialize hits on other drawings; two threads missing on
+ * the same content both parse, and the later insert wins.
+ *
+ * \return a pointer to the frozen drawing, or \c NULL when errors
+ * occurred.
+ */
+DxfDrawing *
+dxf_doc_cache_acquire
+(
+        DxfDocCache *cache,
+                /*!< the cache to acquire from. */
+        char *filename
+                /*!< filename of the DXF file. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        DxfDocCacheEntry *entry;
+        DxfDrawing *drawing;
+        DxfArena *arena;
+        uint64_t hash;
+        size_t file_size;
+        size_t reserved;
+        size_t used;
+
+        if ((cache == NULL) || (filename == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        if (dxf_doc_cache_hash_file (filename, &hash, &file_size)
+                != EXIT_SUCCESS)
+        {
+                return (NULL);
+        }
+        pthread_mutex_lock (&cache->lock);
+        for (entry = cache->entries; entry != NULL; entry = entry->next)
+        {
+                if ((entry->hash == hash) && (entry->file_size == file_size))
+                {
+                        entry->references++;
+                        entry->last_used = ++cache->tick;
+                        cache->hits++;
+                        pthread_mutex_unlock (&cache->lock);
+#if DEBUG
+                        DXF_DEBUG_END
+#endif
+                        return (entry->drawing);
+                }
+        }
+        cache->misses++;
+        pthread_mutex_unlock (&cache->lock);
+        /* load outside the lock. */
+        arena = dxf_arena_new (0);
+        if (arena == NULL)
+        {
+                return (NULL);
+        }
+        drawing = dxf_drawing_new ();
+        if (drawing == NULL)
+        {
+                dxf_arena_free (arena);
+                return (NULL);
+        }
+        if (cache->loader (filename, drawing, arena, cache->user_data)
+                != EXIT_SUCCESS)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not load file: %s.\n")),
+                  __FUNCTION__, filename);
+                dxf_drawing_free (drawing);
+                dxf_arena_free (arena);
+                return (NULL);
+        }
+        entry = calloc (1, sizeof (DxfDocCacheEntry));
+        if (entry == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                dxf_drawing_free (drawing);
+                dxf_arena_free (arena);
+                return (NULL);
+        }
+        dxf_arena_stats (arena, &reserved, &used);
+        entry->hash = hash;
+        entry->file_size = file_size;
+        entry->drawing = drawing;
+        entry->arena = arena;
+        entry->bytes = reserved;
+        entry->references = 1;
+        pthread_mutex_lock (&cache->lock);
+        entry->last_used = ++cache->tick;
+        entry->next = cache->entries;
+        cache->entries = entry;
+        cache->total_bytes += entry->bytes;
+        dxf_doc_cache_evict (cache);
+        pthread_mutex_unlock (&cache->lock);
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (drawing);
+}
+
+
+/*!
+ * \brief Release a drawing acquired from the cache.
+ *
+ * The drawing stays cached; it merely becomes evictable once no
+ * acquisition holds it and the cache runs over budget.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_doc_cache_release
+(
+        DxfDocCache *cache,
+                /*!< the cache the drawing was acquired from. */
+        DxfDrawing *drawing
+                /*!< the drawing to release. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        DxfDocCacheEntry *entry;
+
+        if ((cache == NULL) || (drawing == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        pthread_mutex_lock (&cache->lock);
+        for (entry = cache->entries; entry != NULL; entry = entry->next)
+        {
+                if (entry->drawing == drawing)
+                {
+                        if (entry->references > 0)
+                        {
+                                entry->references--;
+                        }
+                        dxf_doc_cache_evict (cache);
+                        pthread_mutex_unlock (&cache->lock);
+#if DEBUG
+                        DXF_DEBUG_END
+#endif
+                        return (EXIT_SUCCESS);
+                }
+        }
+        pthread_mutex_unlock (&cache->lock);
+        fprintf (stderr,
+          (_("Error in %s () the drawing is not cached.\n")),
+          __FUNCTION__);
+        return (EXIT_FAILURE);
+}
+
+
+/*!
+ * \brief Report the counters of a document cache.
+ *
+ * Any receiving pointer may be \c NULL to skip that counter.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_doc_cache_stats
+(
+        DxfDocCache *cache,
+                /*!< the cache to report on. */
+        size_t *entries,
+                /*!< receives the number of cached drawings. */
+        size_t *bytes,
+                /*!< receives the arena bytes held. */
+        size_t *hits,
+                /*!< receives the number of cache hits. */
+        size_t *misses,
+                /*!< receives the number of cache misses. */
+        size_t *evictions
+                /*!< receives the number of evictions. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        DxfDocCacheEntry *entry;
+        size_t count;
+
+        if (cache == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        pthread_mutex_lock (&cache->lock);
+        count = 0;
+        for (entry = cache->entries; entry != NULL; entry = entry->next)
+        {
+                count++;
+        }
+        if (entries != NULL)
+        {
+                *entries = count;
+        }
+        if (bytes != NULL)
+        {
+                *bytes = cache->total_bytes;
+        }
+        if (hits != NULL)
+        {
+                *hits = cache->hits;
+        }
+        if (misses != NULL)
+        {
+                *misses = cache->misses;
+        }
+        if (evictions != NULL)
+        {
+                *evictions = cache->evictions;
+        }
+        pthread_mutex_unlock (&cache->lock);
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Free a document cache and every cached drawing.
+ *
+ * The caller guarantees no thread still reads a cached drawing.
+ */
+void
+dxf_doc_cache_free
+(
+        DxfDocCache *cache
+                /*!< the cache to free. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        DxfDocCacheEntry *entry;
+        DxfDocCacheEntry *next;
+
+        if (cache == NULL)
+        {
+                return;
+        }
+        for (entry = cache->entries; entry != NULL; entry = next)
+        {
+                next = entry->next;
+                dxf_doc_cache_entry_free (entry);
+        }
+        pthread_mutex_destroy (&cache->lock);
+        free (cache);
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+}
+
+
+/* EOF */
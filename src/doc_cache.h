@@ -0,0 +1,173 @@
+/*!
+ * \file doc_cache.h
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Header for the cache of parsed, frozen drawings.
+ *
+ * A render farm parses the same drawing on many nodes and repeatedly
+ * on one node across requests.\n
+ * The document cache keeps parsed drawings frozen in arena blocks,
+ * keyed by a content hash of the file bytes, so the parse-once /
+ * render-many pattern pays one parse per distinct content.\n
+ * A cached drawing is immutable after the load step, so any number of
+ * threads read it concurrently without locking; only the cache lookup
+ * itself takes a mutex.\n
+ * Entries are evicted least-recently-used by arena bytes once the
+ * cache exceeds its budget; an entry a thread still holds is never
+ * evicted.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#ifndef LIBDXF_SRC_DOC_CACHE_H
+#define LIBDXF_SRC_DOC_CACHE_H
+
+
+#include <stdint.h>
+#include <pthread.h>
+#include "arena.h"
+#include "drawing.h"
+
+
+/*!
+ * \brief Loader callback building the frozen drawing of one file.
+ *
+ * The library has no single file-to-drawing parser; the application
+ * decides which entity types it materializes and how.\n
+ * The loader shall parse \c filename, allocate every entity from
+ * \c arena (the typed \c *_dup functions and \c dxf_arena_alloc both
+ * qualify) and append the entities to \c drawing.\n
+ * After the loader returns the drawing is frozen: neither the cache
+ * nor any consumer mutates it, which is what makes the lock-free
+ * sharing sound.
+ *
+ * \return \c EXIT_SUCCESS when the drawing was built, or
+ * \c EXIT_FAILURE to abort the load.
+ */
+typedef int (*DxfDocCacheLoader) (char *filename, DxfDrawing *drawing, DxfArena *arena, void *user_data);
+
+
+/*!
+ * \brief One entry of the document cache.
+ */
+typedef struct
+dxf_doc_cache_entry
+{
+        uint64_t hash;
+                /*!< FNV-1a hash of the file bytes. */
+        size_t file_size;
+                /*!< size of the hashed file, to cheapen collision
+                 * rejection. */
+        DxfDrawing *drawing;
+                /*!< the frozen drawing. */
+        DxfArena *arena;
+                /*!< the arena holding the entities of the drawing. */
+        size_t bytes;
+                /*!< arena bytes charged against the cache budget. */
+        size_t references;
+                /*!< number of acquisitions not yet released; an entry
+                 * with references is never evicted. */
+        uint64_t last_used;
+                /*!< cache tick of the most recent acquisition, for
+                 * the LRU eviction order. */
+        struct dxf_doc_cache_entry *next;
+                /*!< the next entry in the cache. */
+} DxfDocCacheEntry;
+
+
+/*!
+ * \brief A cache of parsed, frozen drawings.
+ */
+typedef struct
+dxf_doc_cache
+{
+        DxfDocCacheEntry *entries;
+                /*!< the cached drawings. */
+        DxfDocCacheLoader loader;
+                /*!< builds the drawing of a file on a miss. */
+        void *user_data;
+                /*!< opaque pointer passed to the loader. */
+        size_t budget_bytes;
+                /*!< arena bytes the cache may hold before evicting;
+                 * \c 0 means unlimited. */
+        size_t total_bytes;
+                /*!< arena bytes currently held. */
+        uint64_t tick;
+                /*!< acquisition counter driving the LRU order. */
+        size_t hits;
+                /*!< number of acquisitions served from the cache. */
+        size_t misses;
+                /*!< number of acquisitions that ran the loader. */
+        size_t evictions;
+                /*!< number of entries evicted over the budget. */
+        pthread_mutex_t lock;
+                /*!< guards the entry list and the counters; never
+                 * held while a cached drawing is read. */
+} DxfDocCache;
+
+
+DxfDocCache *
+dxf_doc_cache_new
+(
+        size_t budget_bytes,
+        DxfDocCacheLoader loader,
+        void *user_data
+);
+DxfDrawing *
+dxf_doc_cache_acquire
+(
+        DxfDocCache *cache,
+        char *filename
+);
+int
+dxf_doc_cache_release
+(
+        DxfDocCache *cache,
+        DxfDrawing *drawing
+);
+int
+dxf_doc_cache_stats
+(
+        DxfDocCache *cache,
+        size_t *entries,
+        size_t *bytes,
+        size_t *hits,
+        size_t *misses,
+        size_t *evictions
+);
+void
+dxf_doc_cache_free
+(
+        DxfDocCache *cache
+);
+
+
+#endif /* LIBDXF_SRC_DOC_CACHE_H */
+
+
+/* EOF */
@@ -38,7 +38,10 @@
  */
 
 
+#include <pthread.h>
 #include "donut.h"
+#include "allocator.h"
+#include "writer.h"
 
 
 /*!
@@ -61,7 +64,7 @@ dxf_donut_new ()
         size = sizeof (DxfDonut);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((donut = malloc (size)) == NULL)
+        if ((donut = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfDonut struct.\n")),
@@ -96,6 +99,11 @@ dxf_donut_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfDonut template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         /* Do some basic checks. */
         if (donut == NULL)
         {
@@ -112,24 +120,35 @@ dxf_donut_init
                 return (NULL);
         }
         /* Members common for all DXF drawable entities. */
-        donut->id_code = 0;
-        donut->linetype = strdup (DXF_DEFAULT_LINETYPE);
-        donut->layer = strdup (DXF_DEFAULT_LAYER);
-        donut->elevation = 0.0;
-        donut->thickness = 0.0;
-        donut->linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
-        donut->visibility = DXF_DEFAULT_VISIBILITY;
-        donut->color = DXF_COLOR_BYLAYER;
-        donut->paperspace = DXF_MODELSPACE;
-        donut->dictionary_owner_soft = strdup ("");
-        donut->dictionary_owner_hard = strdup ("");
-        /* Specific members for a libDXF donut. */
-        donut->x0 = 0.0;
-        donut->y0 = 0.0;
-        donut->z0 = 0.0;
-        donut->outside_diameter = 0.0;
-        donut->inside_diameter = 0.0;
-        donut->next = NULL;
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.id_code = 0;
+                template.linetype = strdup (DXF_DEFAULT_LINETYPE);
+                template.layer = strdup (DXF_DEFAULT_LAYER);
+                template.elevation = 0.0;
+                template.thickness = 0.0;
+                template.linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
+                template.visibility = DXF_DEFAULT_VISIBILITY;
+                template.color = DXF_COLOR_BYLAYER;
+                template.paperspace = DXF_MODELSPACE;
+                template.dictionary_owner_soft = strdup ("");
+                template.dictionary_owner_hard = strdup ("");
+                /* Specific members for a libDXF donut. */
+                template.x0 = 0.0;
+                template.y0 = 0.0;
+                template.z0 = 0.0;
+                template.outside_diameter = 0.0;
+                template.inside_diameter = 0.0;
+                template.next = NULL;
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (donut, &template, sizeof (DxfDonut));
+        donut->linetype = strdup (template.linetype);
+        donut->layer = strdup (template.layer);
+        donut->dictionary_owner_soft = strdup (template.dictionary_owner_soft);
+        donut->dictionary_owner_hard = strdup (template.dictionary_owner_hard);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -137,11 +156,167 @@ dxf_donut_init
 }
 
 
+/*!
+ * \brief Emit a single libDXF donut through the buffered writer.
+ *
+ * Writes the POLYLINE header, the two bulged vertices and the SEQEND
+ * marker straight from the donut members and stack scratch space,
+ * without synthesizing intermediate entity structs.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when an error
+ * occurred.
+ */
+static int
+dxf_donut_emit
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an output file (or device). */
+        DxfDonut *donut
+                /*!< Pointer to a donut struct. */
+)
+{
+        double width;
+        double center_offset;
+        double x0;
+        int id_code;
+        int i;
+
+        if (donut->outside_diameter > donut->inside_diameter)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () outside diameter is smaller than the inside diameter for the POLYLINE entity with id-code: %x\n")),
+                  __FUNCTION__, donut->id_code);
+                return (EXIT_FAILURE);
+        }
+        if (strcmp (donut->linetype, "") == 0)
+        {
+                fprintf (stderr,
+                  (_("Warning in %s () empty linetype string for the POLYLINE entity with id-code: %x\n")),
+                  __FUNCTION__, donut->id_code);
+                fprintf (stderr,
+                  (_("\tPOLYLINE entity is reset to default linetype")));
+                donut->linetype = strdup (DXF_DEFAULT_LINETYPE);
+        }
+        if (strcmp (donut->layer, "") == 0)
+        {
+                fprintf (stderr,
+                  (_("Warning in %s () empty layer string for the POLYLINE entity with id-code: %x\n")),
+                  __FUNCTION__, donut->id_code);
+                fprintf (stderr,
+                  (_("\tPOLYLINE entity is relocated to layer 0\n")));
+                donut->layer = strdup (DXF_DEFAULT_LAYER);
+        }
+        width = 0.25 * (donut->outside_diameter - donut->inside_diameter);
+        center_offset = 0.25 * (donut->outside_diameter + donut->inside_diameter);
+        /* Write the polyline header. */
+        id_code = fp->last_id_code;
+        id_code++;
+        fp->last_id_code = id_code;
+        dxf_write_group_string (fp, 0, "POLYLINE");
+        dxf_write_group_hex (fp, 5, id_code);
+        if (fp->acad_version_number >= AutoCAD_13)
+        {
+                dxf_write_group_string (fp, 100, "AcDbEntity");
+        }
+        if (donut->paperspace == DXF_PAPERSPACE)
+        {
+                dxf_write_group_int (fp, 67, DXF_PAPERSPACE);
+        }
+        dxf_write_group_string (fp, 8, donut->layer);
+        if (strcmp (donut->linetype, DXF_DEFAULT_LINETYPE) != 0)
+        {
+                dxf_write_group_string (fp, 6, donut->linetype);
+        }
+        if (donut->color != DXF_COLOR_BYLAYER)
+        {
+                dxf_write_group_int (fp, 62, donut->color);
+        }
+        if (fp->acad_version_number >= AutoCAD_13)
+        {
+                dxf_write_group_string (fp, 100, "AcDb2dPolyline");
+        }
+        dxf_write_group_int (fp, 66, 1);
+        dxf_write_group_double (fp, 10, donut->x0);
+        dxf_write_group_double (fp, 20, donut->y0);
+        dxf_write_group_double (fp, 30, donut->z0);
+        if (donut->thickness != 0.0)
+        {
+                dxf_write_group_double (fp, 39, donut->thickness);
+        }
+        dxf_write_group_int (fp, 70, 1);
+        if (width != 0.0)
+        {
+                dxf_write_group_double (fp, 40, width);
+                dxf_write_group_double (fp, 41, width);
+        }
+        dxf_write_group_int (fp, 71, 0);
+        dxf_write_group_int (fp, 72, 0);
+        dxf_write_group_int (fp, 73, 0);
+        dxf_write_group_int (fp, 74, 0);
+        dxf_write_group_int (fp, 75, 0);
+        /* Write the two bulged vertices spanning the donut. */
+        for (i = 0; i < 2; i++)
+        {
+                x0 = (i == 0) ? (donut->x0 - center_offset)
+                        : (donut->x0 + center_offset);
+                id_code = fp->last_id_code;
+                id_code++;
+                fp->last_id_code = id_code;
+                dxf_write_group_string (fp, 0, "VERTEX");
+                dxf_write_group_hex (fp, 5, id_code);
+                if (fp->acad_version_number >= AutoCAD_13)
+                {
+                        dxf_write_group_string (fp, 100, "AcDbEntity");
+                }
+                dxf_write_group_string (fp, 8, donut->layer);
+                if (strcmp (donut->linetype, DXF_DEFAULT_LINETYPE) != 0)
+                {
+                        dxf_write_group_string (fp, 6, donut->linetype);
+                }
+                if (donut->color != DXF_COLOR_BYLAYER)
+                {
+                        dxf_write_group_int (fp, 62, donut->color);
+                }
+                if (donut->thickness != 0.0)
+                {
+                        dxf_write_group_double (fp, 39, donut->thickness);
+                }
+                dxf_write_group_string (fp, 100, "AcDbVertex");
+                dxf_write_group_string (fp, 100, "AcDb2dVertex");
+                dxf_write_group_double (fp, 10, x0);
+                dxf_write_group_double (fp, 20, donut->y0);
+                dxf_write_group_double (fp, 30, donut->z0);
+                if (width != 0.0)
+                {
+                        dxf_write_group_double (fp, 40, width);
+                        dxf_write_group_double (fp, 41, width);
+                }
+                dxf_write_group_double (fp, 42, 1.0);
+                dxf_write_group_int (fp, 70, 0);
+        }
+        /* Write the end of sequence marker. */
+        id_code = fp->last_id_code;
+        id_code++;
+        fp->last_id_code = id_code;
+        dxf_write_group_string (fp, 0, "SEQEND");
+        dxf_write_group_hex (fp, 5, id_code);
+        if (fp->acad_version_number >= AutoCAD_13)
+        {
+                dxf_write_group_string (fp, 100, "AcDbEntity");
+        }
+        dxf_write_group_string (fp, 8, donut->layer);
+        return (EXIT_SUCCESS);
+}
+
+
 /*!
  * \brief Write DXF output to a file for a libDXF donut.
  *
  * A typical convenience function.\n
- * Draw a donut by means of two bulged vertices into a single polyline.
+ * Draw a donut by means of two bulged vertices into a single polyline.\n
+ * The polyline, vertices and sequence end marker are emitted directly
+ * through the buffered writer from stack scratch space; no intermediate
+ * entity structs are allocated.
  *
  * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when an error
  * occurred.
@@ -158,14 +333,7 @@ dxf_donut_write
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        DxfPolyline *polyline = NULL;
-        DxfVertex *vertex_1 = NULL;
-        DxfVertex *vertex_2 = NULL;
-        DxfSeqend *seqend = NULL;
-        char *dxf_entity_name = strdup ("POLYLINE");
-        double start_width;
-        double end_width;
-        int id_code = -1;
+        int result;
 
         /* Do some basic checks. */
         if (fp == NULL)
@@ -182,116 +350,89 @@ dxf_donut_write
                   __FUNCTION__);
                 return (EXIT_FAILURE);
         }
-        if (donut->outside_diameter > donut->inside_diameter)
+        result = dxf_donut_emit (fp, donut);
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (result);
+}
+
+
+/*!
+ * \brief Write DXF output to a file for an array of libDXF donuts.
+ *
+ * Attaches a buffered writer for the duration of the call when none is
+ * present, so the whole array is emitted in large chunks; an already
+ * attached writer is left in place and flushed before returning.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when an error
+ * occurred.
+ */
+int
+dxf_donut_write_batch
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an output file (or device). */
+        DxfDonut *donuts,
+                /*!< array of donuts. */
+        int number_donuts
+                /*!< number of entries in the array of donuts. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        int attached_here = FALSE;
+        int result;
+        int i;
+
+        /* Do some basic checks. */
+        if (fp == NULL)
         {
                 fprintf (stderr,
-                  (_("Error in %s () outside diameter is smaller than the inside diameter for the %s entity with id-code: %x\n")),
-                  __FUNCTION__, dxf_entity_name, id_code);
+                  (_("Error in %s () a NULL file pointer was passed.\n")),
+                  __FUNCTION__);
                 return (EXIT_FAILURE);
         }
-        start_width = 0.5 * (donut->outside_diameter - donut->inside_diameter);
-        end_width = 0.5 * (donut->outside_diameter - donut->inside_diameter);
-        if (strcmp (donut->linetype, "") == 0)
+        if ((donuts == NULL) && (number_donuts > 0))
         {
                 fprintf (stderr,
-                  (_("Warning in %s () empty linetype string for the %s entity with id-code: %x\n")),
-                  __FUNCTION__, dxf_entity_name, donut->id_code);
-                fprintf (stderr,
-                  (_("\t%s entity is reset to default linetype")),
-                  dxf_entity_name);
-                donut->linetype = strdup (DXF_DEFAULT_LINETYPE);
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
         }
-        if (strcmp (donut->layer, "") == 0)
+        if (fp->writer == NULL)
         {
-                fprintf (stderr,
-                  (_("Warning in %s () empty layer string for the %s entity with id-code: %x\n")),
-                  __FUNCTION__, dxf_entity_name, id_code);
-                fprintf (stderr,
-                  (_("\t%s entity is relocated to layer 0\n")),
-                  dxf_entity_name);
-                donut->layer = strdup (DXF_DEFAULT_LAYER);
+                if (dxf_writer_attach (fp, 0) != EXIT_SUCCESS)
+                {
+                        return (EXIT_FAILURE);
+                }
+                attached_here = TRUE;
+        }
+        result = EXIT_SUCCESS;
+        for (i = 0; i < number_donuts; i++)
+        {
+                if (dxf_donut_emit (fp, &donuts[i]) != EXIT_SUCCESS)
+                {
+                        result = EXIT_FAILURE;
+                        break;
+                }
+        }
+        if (attached_here)
+        {
+                if (dxf_writer_detach (fp) != EXIT_SUCCESS)
+                {
+                        result = EXIT_FAILURE;
+                }
+        }
+        else if (dxf_writer_flush (fp) != EXIT_SUCCESS)
+        {
+                result = EXIT_FAILURE;
         }
-        /* Create and write a polyline primitive. */
-        dxf_polyline_new (polyline);
-        polyline = dxf_polyline_init (polyline);
-        id_code = fp->last_id_code;
-        id_code++;
-        polyline->id_code = id_code;
-        polyline->linetype = donut->linetype;
-        polyline->layer = donut->layer;
-        polyline->x0 = donut->x0;
-        polyline->y0 = donut->y0;
-        polyline->z0 = donut->z0;
-        polyline->thickness = donut->thickness;
-        polyline->start_width = 0.5 * start_width;
-        polyline->end_width = 0.5 * end_width;
-        polyline->color = donut->color;
-        polyline->vertices_follow = 1;
-        polyline->paperspace = donut->paperspace;
-        polyline->flag = 1;
-        polyline->polygon_mesh_M_vertex_count = 0;
-        polyline->polygon_mesh_N_vertex_count = 0;
-        polyline->smooth_M_surface_density = 0;
-        polyline->smooth_N_surface_density = 0;
-        polyline->surface_type = 0;
-        dxf_polyline_write (fp, polyline);
-        /*! \todo Hook up this polyline to the list of polylines. */
-        /* Create and write the first vertex. */
-        vertex_1 = dxf_vertex_new ();
-        vertex_1 = dxf_vertex_init (vertex_1);
-        id_code = fp->last_id_code;
-        id_code++;
-        vertex_1->id_code = id_code;
-        vertex_1->layer = donut->layer;
-        vertex_1->linetype = donut->linetype;
-        vertex_1->x0 = donut->x0 - (0.25 * (donut->outside_diameter + donut->inside_diameter));
-        vertex_1->y0 = donut->y0;
-        vertex_1->z0 = donut->z0;
-        vertex_1->thickness = donut->thickness;
-        vertex_1->start_width = 0.5 * start_width;
-        vertex_1->end_width = 0.5 * end_width;
-        vertex_1->bulge = 1;
-        vertex_1->curve_fit_tangent_direction = 0.0;
-        vertex_1->color = donut->color;
-        vertex_1->paperspace = donut->paperspace;
-        vertex_1->flag = 0;
-        dxf_vertex_write (fp, vertex_1);
-        /*! \todo Hook up this vertex to the list of vertices. */
-        /* Create and write the second vertex. */
-        vertex_2 = dxf_vertex_new ();
-        vertex_2 = dxf_vertex_init (vertex_2);
-        id_code = fp->last_id_code;
-        id_code++;
-        vertex_2->id_code = id_code;
-        vertex_2->layer = donut->layer;
-        vertex_2->linetype = donut->linetype;
-        vertex_2->x0 = donut->x0 + (0.25 * (donut->outside_diameter + donut->inside_diameter));
-        vertex_2->y0 = donut->y0;
-        vertex_2->z0 = donut->z0;
-        vertex_2->thickness = donut->thickness;
-        vertex_2->start_width = 0.5 * start_width;
-        vertex_2->end_width = 0.5 * end_width;
-        vertex_2->bulge = 1;
-        vertex_2->curve_fit_tangent_direction = 0.0;
-        vertex_2->color = donut->color;
-        vertex_2->paperspace = donut->paperspace;
-        vertex_2->flag = 0;
-        dxf_vertex_write (fp, vertex_2);
-        /*! \todo Hook up this vertex to the list of vertices. */
-        /* Create and write the end of sequence marker. */
-        dxf_seqend_new (seqend);
-        seqend = dxf_seqend_init (seqend);
-        id_code = fp->last_id_code;
-        id_code++;
-        seqend->id_code = id_code;
-        seqend->layer = donut->layer;
-        seqend->linetype = donut->linetype;
-        dxf_seqend_write (fp, seqend);
-        /*! \todo Hook up this seqend to the list of seqends. */
 #if DEBUG
         DXF_DEBUG_END
 #endif
-        return (EXIT_SUCCESS);
+        return (result);
 }
 
 
@@ -324,7 +465,7 @@ dxf_donut_free
         free (donut->layer);
         free (donut->dictionary_owner_soft);
         free (donut->dictionary_owner_hard);
-        free (donut);
+        dxf_entity_dealloc (donut, sizeof (*donut));
         donut = NULL;
 #if DEBUG
         DXF_DEBUG_END
@@ -145,6 +145,13 @@ dxf_donut_write
         DxfDonut *donut
 );
 int
+dxf_donut_write_batch
+(
+        DxfFile *fp,
+        DxfDonut *donuts,
+        int number_donuts
+);
+int
 dxf_donut_free
 (
         DxfDonut *donut
@@ -0,0 +1,317 @@
+/*!
+ * \file drawing.c
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Functions for the tagged entity list and visitor traversal
+ * of a drawing.
+ *
+ * Whole-drawing algorithms — extents, transforms, statistics — used
+ * to make one pass per entity type because the parsed entities lived
+ * in separately typed lists.\n
+ * The drawing keeps every entity in one contiguous array of
+ * (type, pointer) pairs in file order, and \c dxf_drawing_visit
+ * replays it through a visitor at one indirect call per entity, so a
+ * single-pass algorithm touches the file once regardless of how many
+ * types it handles.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#include "drawing.h"
+#include "config.h"
+
+
+/*!
+ * \brief Allocate an empty drawing.
+ *
+ * \return a pointer to the drawing, or \c NULL when no memory was
+ * allocated.
+ */
+DxfDrawing *
+dxf_drawing_new ()
+{
+        DxfDrawing *drawing;
+
+        drawing = calloc (1, sizeof (DxfDrawing));
+        if (drawing == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+        }
+        return (drawing);
+}
+
+
+/*!
+ * \brief Append a tagged entity to a drawing.
+ *
+ * The drawing references the entity; ownership stays with the
+ * caller.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_drawing_append
+(
+        DxfDrawing *drawing,
+                /*!< the drawing to append to. */
+        DxfEntityType type,
+                /*!< the type of the entity. */
+        void *entity
+                /*!< the entity struct. */
+)
+{
+        if ((drawing == NULL) || (entity == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (drawing->length == drawing->capacity)
+        {
+                size_t new_capacity;
+                DxfTaggedEntity *new_entities;
+
+                new_capacity = dxf_config_grow (dxf_config_get (),
+                        drawing->capacity);
+                if (new_capacity == 0)
+                {
+                        new_capacity = 1024;
+                }
+                new_entities = realloc (drawing->entities,
+                        new_capacity * sizeof (DxfTaggedEntity));
+                if (new_entities == NULL)
+                {
+                        fprintf (stderr,
+                          (_("Error in %s () could not allocate memory.\n")),
+                          __FUNCTION__);
+                        return (EXIT_FAILURE);
+                }
+                drawing->entities = new_entities;
+                drawing->capacity = new_capacity;
+        }
+        drawing->entities[drawing->length].type = type;
+        drawing->entities[drawing->length].entity = entity;
+        drawing->length++;
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Traverse the entities of a drawing in file order through a
+ * visitor.
+ *
+ * Each entity costs one indirect call: its typed callback when set,
+ * the \c any fallback otherwise; entities with neither are skipped.\n
+ * A callback returning anything but \c EXIT_SUCCESS aborts the
+ * traversal and its value is returned.
+ *
+ * \return \c EXIT_SUCCESS when all entities were visited, the
+ * aborting callback's value otherwise, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_drawing_visit
+(
+        DxfDrawing *drawing,
+                /*!< the drawing to traverse. */
+        DxfEntityVisitor *visitor
+                /*!< the visitor callbacks. */
+)
+{
+        size_t i;
+        int result;
+
+        if ((drawing == NULL) || (visitor == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        for (i = 0; i < drawing->length; i++)
+        {
+                DxfTaggedEntity *tagged;
+
+                tagged = &drawing->entities[i];
+                result = EXIT_SUCCESS;
+                switch (tagged->type)
+                {
+                        case ARC:
+                        {
+                                if (visitor->arc != NULL)
+                                {
+                                        result = visitor->arc (tagged->entity, visitor->user_data);
+                                        break;
+                                }
+                                goto fallback;
+                        }
+                        case CIRCLE:
+                        {
+                                if (visitor->circle != NULL)
+                                {
+                                        result = visitor->circle (tagged->entity, visitor->user_data);
+                                        break;
+                                }
+                                goto fallback;
+                        }
+                        case ELLIPSE:
+                        {
+                                if (visitor->ellipse != NULL)
+                                {
+                                        result = visitor->ellipse (tagged->entity, visitor->user_data);
+                                        break;
+                                }
+                                goto fallback;
+                        }
+                        case FACE3D:
+                        {
+                                if (visitor->face != NULL)
+                                {
+                                        result = visitor->face (tagged->entity, visitor->user_data);
+                                        break;
+                                }
+                                goto fallback;
+                        }
+                        case INSERT:
+                        {
+                                if (visitor->insert != NULL)
+                                {
+                                        result = visitor->insert (tagged->entity, visitor->user_data);
+                                        break;
+                                }
+                                goto fallback;
+                        }
+                        case LINE:
+                        {
+                                if (visitor->line != NULL)
+                                {
+                                        result = visitor->line (tagged->entity, visitor->user_data);
+                                        break;
+                                }
+                                goto fallback;
+                        }
+                        case LWPOLYLINE:
+                        {
+                                if (visitor->lwpolyline != NULL)
+                                {
+                                        result = visitor->lwpolyline (tagged->entity, visitor->user_data);
+                                        break;
+                                }
+                                goto fallback;
+                        }
+                        case POINT:
+                        {
+                                if (visitor->point != NULL)
+                                {
+                                        result = visitor->point (tagged->entity, visitor->user_data);
+                                        break;
+                                }
+                                goto fallback;
+                        }
+                        case POLYLINE:
+                        {
+                                if (visitor->polyline != NULL)
+                                {
+                                        result = visitor->polyline (tagged->entity, visitor->user_data);
+                                        break;
+                                }
+                                goto fallback;
+                        }
+                        case SOLID:
+                        {
+                                if (visitor->solid != NULL)
+                                {
+                                        result = visitor->solid (tagged->entity, visitor->user_data);
+                                        break;
+                                }
+                                goto fallback;
+                        }
+                        case TEXT:
+                        {
+                                if (visitor->text != NULL)
+                                {
+                                        result = visitor->text (tagged->entity, visitor->user_data);
+                                        break;
+                                }
+                                goto fallback;
+                        }
+                        case VERTEX:
+                        {
+                                if (visitor->vertex != NULL)
+                                {
+                                        result = visitor->vertex (tagged->entity, visitor->user_data);
+                                        break;
+                                }
+                                goto fallback;
+                        }
+                        default:
+                        fallback:
+                        {
+                                if (visitor->any != NULL)
+                                {
+                                        result = visitor->any (tagged->type, tagged->entity, visitor->user_data);
+                                }
+                                break;
+                        }
+                }
+                if (result != EXIT_SUCCESS)
+                {
+                        return (result);
+                }
+        }
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Free a drawing.
+ *
+ * Only the tagged list is released; the referenced entities remain
+ * owned by the caller.
+ */
+void
+dxf_drawing_free
+(
+        DxfDrawing *drawing
+                /*!< the drawing to free, or \c NULL. */
+)
+{
+        if (drawing == NULL)
+        {
+                return;
+        }
+        free (drawing->entities);
+        free (drawing);
+}
+
+
+/* EOF */
@@ -0,0 +1,147 @@
+/*!
+ * \file drawing.h
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Header for the tagged entity list and visitor traversal of a
+ * drawing.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#ifndef LIBDXF_SRC_DRAWING_H
+#define LIBDXF_SRC_DRAWING_H
+
+
+#include "global.h"
+#include "entity.h"
+#include "entities.h"
+
+
+/*!
+ * \brief One entity of a drawing, tagged with its type.
+ *
+ * The tag ties the \c DxfEntityType enum to the entity structs, so
+ * heterogeneous passes walk one list in file order instead of one
+ * separately typed list per entity type.
+ */
+typedef struct
+dxf_tagged_entity
+{
+        DxfEntityType type;
+                /*!< the type of the entity. */
+        void *entity;
+                /*!< the entity struct; owned by the caller, the
+                 * drawing only references it. */
+} DxfTaggedEntity;
+
+
+/*!
+ * \brief A drawing: the entities of a file, in file order.
+ */
+typedef struct
+dxf_drawing
+{
+        DxfTaggedEntity *entities;
+                /*!< the tagged entities, in file order. */
+        size_t length;
+                /*!< number of entities in the drawing. */
+        size_t capacity;
+                /*!< number of allocated elements. */
+} DxfDrawing;
+
+
+/*!
+ * \brief Callbacks of a visitor traversal over a drawing.
+ *
+ * A typed callback receives the entities of its type; entities whose
+ * type has no typed callback fall through to \c any, and are skipped
+ * when that is \c NULL as well.\n
+ * A callback returning anything but \c EXIT_SUCCESS aborts the
+ * traversal.
+ */
+typedef struct
+dxf_entity_visitor
+{
+        void *user_data;
+                /*!< opaque pointer passed to every callback. */
+        int (*arc) (DxfArc *arc, void *user_data);
+                /*!< invoked for each \c ARC entity. */
+        int (*circle) (DxfCircle *circle, void *user_data);
+                /*!< invoked for each \c CIRCLE entity. */
+        int (*ellipse) (DxfEllipse *ellipse, void *user_data);
+                /*!< invoked for each \c ELLIPSE entity. */
+        int (*face) (Dxf3dface *face, void *user_data);
+                /*!< invoked for each \c 3DFACE entity. */
+        int (*insert) (DxfInsert *insert, void *user_data);
+                /*!< invoked for each \c INSERT entity. */
+        int (*line) (DxfLine *line, void *user_data);
+                /*!< invoked for each \c LINE entity. */
+        int (*lwpolyline) (DxfLWPolyline *lwpolyline, void *user_data);
+                /*!< invoked for each \c LWPOLYLINE entity. */
+        int (*point) (DxfPoint *point, void *user_data);
+                /*!< invoked for each \c POINT entity. */
+        int (*polyline) (DxfPolyline *polyline, void *user_data);
+                /*!< invoked for each \c POLYLINE entity. */
+        int (*solid) (DxfSolid *solid, void *user_data);
+                /*!< invoked for each \c SOLID entity. */
+        int (*text) (DxfText *text, void *user_data);
+                /*!< invoked for each \c TEXT entity. */
+        int (*vertex) (DxfVertex *vertex, void *user_data);
+                /*!< invoked for each \c VERTEX entity. */
+        int (*any) (DxfEntityType type, void *entity, void *user_data);
+                /*!< invoked for each entity without a typed
+                 * callback. */
+} DxfEntityVisitor;
+
+
+DxfDrawing *
+dxf_drawing_new ();
+int
+dxf_drawing_append
+(
+        DxfDrawing *drawing,
+        DxfEntityType type,
+        void *entity
+);
+int
+dxf_drawing_visit
+(
+        DxfDrawing *drawing,
+        DxfEntityVisitor *visitor
+);
+void
+dxf_drawing_free
+(
+        DxfDrawing *drawing
+);
+
+
+#endif /* LIBDXF_SRC_DRAWING_H */
+
+
+/* EOF */
@@ -32,7 +32,13 @@
  */
 
 
+#include <math.h>
+
+#include <pthread.h>
 #include "ellipse.h"
+#include "diag.h"
+#include "allocator.h"
+#include "util.h"
 
 
 /*!
@@ -55,7 +61,7 @@ dxf_ellipse_new ()
         size = sizeof (DxfEllipse);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_ellipse = malloc (size)) == NULL)
+        if ((dxf_ellipse = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfEllipse struct.\n")),
@@ -90,6 +96,11 @@ dxf_ellipse_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfEllipse template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         /* Do some basic checks. */
         if (dxf_ellipse == NULL)
         {
@@ -105,30 +116,41 @@ dxf_ellipse_init
                 __FUNCTION__);
               return (NULL);
         }
-        dxf_ellipse->id_code = 0;
-        dxf_ellipse->linetype = strdup (DXF_DEFAULT_LINETYPE);
-        dxf_ellipse->layer = strdup (DXF_DEFAULT_LAYER);
-        dxf_ellipse->x0 = 0.0;
-        dxf_ellipse->y0 = 0.0;
-        dxf_ellipse->z0 = 0.0;
-        dxf_ellipse->x1 = 0.0;
-        dxf_ellipse->y1 = 0.0;
-        dxf_ellipse->z1 = 0.0;
-        dxf_ellipse->extr_x0 = 0.0;
-        dxf_ellipse->extr_y0 = 0.0;
-        dxf_ellipse->extr_z0 = 0.0;
-        dxf_ellipse->elevation = 0.0;
-        dxf_ellipse->thickness = 0.0;
-        dxf_ellipse->linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
-        dxf_ellipse->visibility = DXF_DEFAULT_VISIBILITY;
-        dxf_ellipse->ratio = 0.0;
-        dxf_ellipse->start_angle = 0.0;
-        dxf_ellipse->end_angle = 0.0;
-        dxf_ellipse->color = DXF_COLOR_BYLAYER;
-        dxf_ellipse->paperspace = DXF_MODELSPACE;
-        dxf_ellipse->dictionary_owner_soft = strdup ("");
-        dxf_ellipse->dictionary_owner_hard = strdup ("");
-        dxf_ellipse->next = NULL;
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.id_code = 0;
+                template.linetype = strdup (DXF_DEFAULT_LINETYPE);
+                template.layer = strdup (DXF_DEFAULT_LAYER);
+                template.x0 = 0.0;
+                template.y0 = 0.0;
+                template.z0 = 0.0;
+                template.x1 = 0.0;
+                template.y1 = 0.0;
+                template.z1 = 0.0;
+                template.extr_x0 = 0.0;
+                template.extr_y0 = 0.0;
+                template.extr_z0 = 0.0;
+                template.elevation = 0.0;
+                template.thickness = 0.0;
+                template.linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
+                template.visibility = DXF_DEFAULT_VISIBILITY;
+                template.ratio = 0.0;
+                template.start_angle = 0.0;
+                template.end_angle = 0.0;
+                template.color = DXF_COLOR_BYLAYER;
+                template.paperspace = DXF_MODELSPACE;
+                template.dictionary_owner_soft = strdup ("");
+                template.dictionary_owner_hard = strdup ("");
+                template.next = NULL;
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (dxf_ellipse, &template, sizeof (DxfEllipse));
+        dxf_ellipse->linetype = strdup (template.linetype);
+        dxf_ellipse->layer = strdup (template.layer);
+        dxf_ellipse->dictionary_owner_soft = strdup (template.dictionary_owner_soft);
+        dxf_ellipse->dictionary_owner_hard = strdup (template.dictionary_owner_hard);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -159,7 +181,7 @@ dxf_ellipse_read
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        char *temp_string = NULL;
+        char temp_string[DXF_MAX_STRING_LENGTH];
 
         /* Do some basic checks. */
         if (fp == NULL)
@@ -177,14 +199,13 @@ dxf_ellipse_read
                 dxf_ellipse = dxf_ellipse_new ();
                 dxf_ellipse = dxf_ellipse_init (dxf_ellipse);
         }
-        (fp->line_number)++;
-        fscanf (fp->fp, "%[^\n]", temp_string);
+        dxf_read_line (temp_string, fp);
         while (strcmp (temp_string, "0") != 0)
         {
                 if (ferror (fp->fp))
                 {
                         fprintf (stderr,
-                          (_("Error in %s () while reading from: %s in line: %d.\n")),
+                          (_("Error in %s () while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                         fclose (fp->fp);
                         return (NULL);
@@ -193,63 +214,58 @@ dxf_ellipse_read
                 {
                         /* Now follows a string containing a sequential
                          * id number. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%x\n", &dxf_ellipse->id_code);
+                                                dxf_read_scanf (fp, "%x\n", &dxf_ellipse->id_code);
                 }
                 else if (strcmp (temp_string, "6") == 0)
                 {
                         /* Now follows a string containing a linetype
                          * name. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_ellipse->linetype);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
+                        free (dxf_ellipse->linetype);
+                        dxf_ellipse->linetype = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "8") == 0)
                 {
                         /* Now follows a string containing a layer name. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_ellipse->layer);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
+                        free (dxf_ellipse->layer);
+                        dxf_ellipse->layer = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "10") == 0)
                 {
                         /* Now follows a string containing the
                          * X-coordinate of the center point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_ellipse->x0);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_ellipse->x0);
                 }
                 else if (strcmp (temp_string, "20") == 0)
                 {
                         /* Now follows a string containing the
                          * Y-coordinate of the center point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_ellipse->y0);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_ellipse->y0);
                 }
                 else if (strcmp (temp_string, "30") == 0)
                 {
                         /* Now follows a string containing the
                          * Z-coordinate of the center point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_ellipse->z0);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_ellipse->z0);
                 }
                 else if (strcmp (temp_string, "11") == 0)
                 {
                         /* Now follows a string containing the
                          * X-coordinate of the center point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_ellipse->x1);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_ellipse->x1);
                 }
                 else if (strcmp (temp_string, "21") == 0)
                 {
                         /* Now follows a string containing the
                          * Y-coordinate of the center point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_ellipse->y1);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_ellipse->y1);
                 }
                 else if (strcmp (temp_string, "31") == 0)
                 {
                         /* Now follows a string containing the
                          * Z-coordinate of the center point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_ellipse->z1);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_ellipse->z1);
                 }
                 else if ((fp->acad_version_number <= AutoCAD_11)
                         && (strcmp (temp_string, "38") == 0)
@@ -260,64 +276,55 @@ dxf_ellipse_read
                          * probably be added.
                          * Now follows a string containing the
                          * elevation. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_ellipse->elevation);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_ellipse->elevation);
                 }
                 else if (strcmp (temp_string, "39") == 0)
                 {
                         /* Now follows a string containing the
                          * thickness. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_ellipse->thickness);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_ellipse->thickness);
                 }
                 else if (strcmp (temp_string, "40") == 0)
                 {
                         /* Now follows a string containing the
                          * radius. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_ellipse->ratio);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_ellipse->ratio);
                 }
                 else if (strcmp (temp_string, "41") == 0)
                 {
                         /* Now follows a string containing the
                          * start angle. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_ellipse->start_angle);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_ellipse->start_angle);
                 }
                 else if (strcmp (temp_string, "42") == 0)
                 {
                         /* Now follows a string containing the
                          * end angle. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_ellipse->end_angle);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_ellipse->end_angle);
                 }
                 else if (strcmp (temp_string, "48") == 0)
                 {
                         /* Now follows a string containing the linetype
                          * scale. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_ellipse->linetype_scale);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_ellipse->linetype_scale);
                 }
                 else if (strcmp (temp_string, "60") == 0)
                 {
                         /* Now follows a string containing the
                          * visibility value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%hd\n", &dxf_ellipse->visibility);
+                                                dxf_read_scanf (fp, "%hd\n", &dxf_ellipse->visibility);
                 }
                 else if (strcmp (temp_string, "62") == 0)
                 {
                         /* Now follows a string containing the
                          * color value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_ellipse->color);
+                                                dxf_read_scanf (fp, "%d\n", &dxf_ellipse->color);
                 }
                 else if (strcmp (temp_string, "67") == 0)
                 {
                         /* Now follows a string containing the
                          * paperspace value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_ellipse->paperspace);
+                                                dxf_read_scanf (fp, "%d\n", &dxf_ellipse->paperspace);
                 }
                 else if ((fp->acad_version_number >= AutoCAD_12)
                         && (strcmp (temp_string, "100") == 0))
@@ -327,13 +334,12 @@ dxf_ellipse_read
                          * version should probably be added here.
                          * Now follows a string containing the
                          * subclass marker value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", temp_string);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
                         if ((strcmp (temp_string, "AcDbEntity") != 0)
                         && ((strcmp (temp_string, "AcDbEllipse") != 0)))
                         {
-                                fprintf (stderr,
-                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %d.\n")),
+                                dxf_diag_report (fp, DXF_DIAG_WARNING,
+                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                         }
                 }
@@ -341,50 +347,52 @@ dxf_ellipse_read
                 {
                         /* Now follows a string containing the
                          * X-value of the extrusion vector. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_ellipse->extr_x0);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_ellipse->extr_x0);
                 }
                 else if (strcmp (temp_string, "220") == 0)
                 {
                         /* Now follows a string containing the
                          * Y-value of the extrusion vector. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_ellipse->extr_y0);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_ellipse->extr_y0);
                 }
                 else if (strcmp (temp_string, "230") == 0)
                 {
                         /* Now follows a string containing the
                          * Z-value of the extrusion vector. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_ellipse->extr_z0);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_ellipse->extr_z0);
                 }
                 else if (strcmp (temp_string, "330") == 0)
                 {
                         /* Now follows a string containing Soft-pointer
                          * ID/handle to owner dictionary. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_ellipse->dictionary_owner_soft);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
+                        free (dxf_ellipse->dictionary_owner_soft);
+                        dxf_ellipse->dictionary_owner_soft = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "360") == 0)
                 {
                         /* Now follows a string containing Hard owner
                          * ID/handle to owner dictionary. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_ellipse->dictionary_owner_hard);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
+                        free (dxf_ellipse->dictionary_owner_hard);
+                        dxf_ellipse->dictionary_owner_hard = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "999") == 0)
                 {
                         /* Now follows a string containing a comment. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", temp_string);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
                         fprintf (stdout, "DXF comment: %s\n", temp_string);
                 }
                 else
                 {
-                        fprintf (stderr,
-                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %d.\n")),
+                        dxf_diag_report (fp, DXF_DIAG_WARNING,
+                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                 }
+                if (dxf_read_line (temp_string, fp) != 1)
+                {
+                        break;
+                }
         }
         /* Handle omitted members and/or illegal values. */
         if (strcmp (dxf_ellipse->linetype, "") == 0)
@@ -563,6 +571,230 @@ dxf_ellipse_write
 }
 
 
+/*!
+ * Number of sample angles evaluated per batch by
+ * \c dxf_ellipse_tessellate; the batch loops run over fixed-size
+ * arrays so the compiler can vectorize the sin/cos sweeps and the
+ * axis combination.
+ */
+#define DXF_ELLIPSE_BATCH 8
+
+
+/*!
+ * \brief Compute the sweep of an ellipse in parameter space.
+ *
+ * \return the swept parameter range in radians, normalized into
+ * (0.0, 2 pi].
+ */
+static double
+dxf_ellipse_sweep
+(
+        DxfEllipse *dxf_ellipse
+                /*!< DXF ellipse entity. */
+)
+{
+        double sweep;
+
+        sweep = dxf_ellipse->end_angle - dxf_ellipse->start_angle;
+        while (sweep <= 0.0)
+        {
+                sweep += 2.0 * M_PI;
+        }
+        return (sweep);
+}
+
+
+/*!
+ * \brief Evaluate the parametric form of an ellipse for a batch of
+ * sample angles.
+ *
+ * The sin/cos sweeps and the axis combination each run as a separate
+ * loop over the batch so they vectorize.
+ */
+static void
+dxf_ellipse_evaluate_batch
+(
+        DxfEllipse *dxf_ellipse,
+                /*!< DXF ellipse entity. */
+        double *t,
+                /*!< the sample angles, in radians. */
+        int length,
+                /*!< number of sample angles, at most
+                 * \c DXF_ELLIPSE_BATCH. */
+        double *x,
+                /*!< returns the X-values of the sample points. */
+        double *y
+                /*!< returns the Y-values of the sample points. */
+)
+{
+        double c[DXF_ELLIPSE_BATCH];
+        double s[DXF_ELLIPSE_BATCH];
+        double minor_x;
+        double minor_y;
+        int i;
+
+        minor_x = -dxf_ellipse->y1 * dxf_ellipse->ratio;
+        minor_y = dxf_ellipse->x1 * dxf_ellipse->ratio;
+        for (i = 0; i < length; i++)
+        {
+                c[i] = cos (t[i]);
+        }
+        for (i = 0; i < length; i++)
+        {
+                s[i] = sin (t[i]);
+        }
+        for (i = 0; i < length; i++)
+        {
+                x[i] = dxf_ellipse->x0 + dxf_ellipse->x1 * c[i]
+                        + minor_x * s[i];
+                y[i] = dxf_ellipse->y0 + dxf_ellipse->y1 * c[i]
+                        + minor_y * s[i];
+        }
+}
+
+
+/*!
+ * \brief Choose the number of sample points needed to flatten a DXF
+ * \c ELLIPSE entity within a chordal tolerance.
+ *
+ * The chord deviation of a parameter step \c dt is bounded by
+ * <tt>a * dt^2 / 8</tt> with \c a the semi-major axis length, so the
+ * step adapts to the tolerance and degenerates to the exact circle
+ * bound when the axis ratio is \c 1.\n
+ * Pass the result as \c number_of_samples to
+ * \c dxf_ellipse_tessellate.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_ellipse_tessellation_size
+(
+        DxfEllipse *dxf_ellipse,
+                /*!< DXF ellipse entity. */
+        double tolerance,
+                /*!< the maximum allowed chord deviation. */
+        int *number_of_samples
+                /*!< returns the number of sample points. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        double major;
+        double step;
+        int segments;
+
+        /* Do some basic checks. */
+        if ((dxf_ellipse == NULL) || (number_of_samples == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        major = sqrt ((dxf_ellipse->x1 * dxf_ellipse->x1)
+                + (dxf_ellipse->y1 * dxf_ellipse->y1));
+        if ((tolerance <= 0.0) || (major <= 0.0))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () an invalid tolerance or major axis was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        step = sqrt (8.0 * tolerance / major);
+        segments = (int) ceil (dxf_ellipse_sweep (dxf_ellipse) / step);
+        if (segments < 8)
+        {
+                segments = 8;
+        }
+        *number_of_samples = segments + 1;
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Tessellate a DXF \c ELLIPSE entity into uniformly spaced
+ * sample points.
+ *
+ * The samples are spaced uniformly in parameter space from
+ * \c start_angle to \c end_angle and evaluated in batches of
+ * \c DXF_ELLIPSE_BATCH angles (see \c dxf_ellipse_evaluate_batch);
+ * choose \c number_of_samples with \c dxf_ellipse_tessellation_size
+ * to stay within a chordal tolerance.\n
+ * The caller provides the output arrays, each with room for
+ * \c number_of_samples values, in the entity OCS plane.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_ellipse_tessellate
+(
+        DxfEllipse *dxf_ellipse,
+                /*!< DXF ellipse entity. */
+        int number_of_samples,
+                /*!< number of sample points to generate, at least 2. */
+        double *x,
+                /*!< returns the X-values of the sample points. */
+        double *y
+                /*!< returns the Y-values of the sample points. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        double t[DXF_ELLIPSE_BATCH];
+        double sweep;
+        double step;
+        int sample;
+        int length;
+        int i;
+
+        /* Do some basic checks. */
+        if ((dxf_ellipse == NULL) || (x == NULL) || (y == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (number_of_samples < 2)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () invalid number of samples: %d.\n")),
+                  __FUNCTION__, number_of_samples);
+                return (EXIT_FAILURE);
+        }
+        sweep = dxf_ellipse_sweep (dxf_ellipse);
+        step = sweep / (number_of_samples - 1);
+        sample = 0;
+        while (sample < number_of_samples)
+        {
+                length = number_of_samples - sample;
+                if (length > DXF_ELLIPSE_BATCH)
+                {
+                        length = DXF_ELLIPSE_BATCH;
+                }
+                for (i = 0; i < length; i++)
+                {
+                        t[i] = dxf_ellipse->start_angle
+                                + step * (sample + i);
+                }
+                dxf_ellipse_evaluate_batch (dxf_ellipse, t, length,
+                        &x[sample], &y[sample]);
+                sample += length;
+        }
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (EXIT_SUCCESS);
+}
+
+
 /*!
  * \brief Free the allocated memory for a DXF \c ELLIPSE and all it's
  * data fields.
@@ -592,7 +824,7 @@ dxf_ellipse_free
         free (dxf_ellipse->layer);
         free (dxf_ellipse->dictionary_owner_soft);
         free (dxf_ellipse->dictionary_owner_hard);
-        free (dxf_ellipse);
+        dxf_entity_dealloc (dxf_ellipse, sizeof (*dxf_ellipse));
         dxf_ellipse = NULL;
 #if DEBUG
         DXF_DEBUG_END
@@ -158,6 +158,21 @@ dxf_ellipse_write
         DxfEllipse *dxf_ellipse
 );
 int
+dxf_ellipse_tessellation_size
+(
+        DxfEllipse *dxf_ellipse,
+        double tolerance,
+        int *number_of_samples
+);
+int
+dxf_ellipse_tessellate
+(
+        DxfEllipse *dxf_ellipse,
+        int number_of_samples,
+        double *x,
+        double *y
+);
+int
 dxf_ellipse_free
 (
         DxfEllipse *dxf_ellipse
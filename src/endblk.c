@@ -32,7 +32,10 @@
  */
 
 
+#include <pthread.h>
 #include "endblk.h"
+#include "diag.h"
+#include "allocator.h"
 
 
 /*!
@@ -57,7 +60,7 @@ dxf_endblk_new ()
         size = sizeof (DxfEndblk);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_endblk = malloc (size)) == NULL)
+        if ((dxf_endblk = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfEndblk struct.\n")),
@@ -96,6 +99,11 @@ dxf_endblk_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfEndblk template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         /* Do some basic checks. */
         if (dxf_endblk == NULL)
         {
@@ -111,9 +119,18 @@ dxf_endblk_init
                   __FUNCTION__);
                 return (NULL);
         }
-        dxf_endblk->id_code = 0;
-        dxf_endblk->layer = strdup (DXF_DEFAULT_LAYER);
-        dxf_endblk->dictionary_owner_soft = strdup ("");
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.id_code = 0;
+                template.layer = strdup (DXF_DEFAULT_LAYER);
+                template.dictionary_owner_soft = strdup ("");
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (dxf_endblk, &template, sizeof (DxfEndblk));
+        dxf_endblk->layer = strdup (template.layer);
+        dxf_endblk->dictionary_owner_soft = strdup (template.dictionary_owner_soft);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -177,7 +194,7 @@ dxf_endblk_read
                 if (ferror (fp->fp))
                 {
                         fprintf (stderr,
-                          (_("Error in %s () while reading from: %s in line: %d.\n")),
+                          (_("Error in %s () while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                         fclose (fp->fp);
                         return (NULL);
@@ -191,13 +208,17 @@ dxf_endblk_read
                 else if (strcmp (temp_string, "8") == 0)
                 {
                         /* Now follows a string containing a layer name. */
-                        fscanf (fp->fp, "%s\n", dxf_endblk->layer);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_endblk->layer);
+                        dxf_endblk->layer = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "330") == 0)
                 {
                         /* Now follows a string containing Soft-pointer
                          * ID/handle to owner object. */
-                        fscanf (fp->fp, "%s\n", dxf_endblk->dictionary_owner_soft);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_endblk->dictionary_owner_soft);
+                        dxf_endblk->dictionary_owner_soft = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "999") == 0)
                 {
@@ -207,8 +228,8 @@ dxf_endblk_read
                 }
                 else
                 {
-                        fprintf (stderr,
-                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %d.\n")),
+                        dxf_diag_report (fp, DXF_DIAG_WARNING,
+                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                 }
         }
@@ -309,7 +330,7 @@ dxf_endblk_free
 #endif
         free (dxf_endblk->layer);
         free (dxf_endblk->dictionary_owner_soft);
-        free (dxf_endblk);
+        dxf_entity_dealloc (dxf_endblk, sizeof (*dxf_endblk));
         dxf_endblk = NULL;
 #if DEBUG
         DXF_DEBUG_END
@@ -51,30 +51,902 @@
  */
 
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+        /*!< for \c pthread_setaffinity_np and \c CPU_SET. */
+#endif
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
 #include "entities.h"
+#include "entity.h"
+#include "entity_registry.h"
+#include "profile.h"
+#include "soa.h"
+#include "util.h"
+#include "writer.h"
+
+
+/*!
+ * \brief Copy one raw entity record from the input mapping to the
+ * pass-through output file.
+ *
+ * The record bytes from \c start up to (but excluding) \c end are
+ * written verbatim, preceded by the "  0" group code line the record
+ * scanner already consumed.\n
+ * Lines inside the range which were NUL terminated in place by the
+ * mapped line reader are restored to their original terminators first,
+ * so the copy is byte identical to the input.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+static int
+dxf_entities_copy_record
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an input file (or device). */
+        DxfFile *out,
+                /*!< DXF file pointer to the pass-through output file. */
+        size_t start,
+                /*!< offset of the first record byte in the mapping. */
+        size_t end
+                /*!< offset just past the last record byte. */
+)
+{
+        if (out->writer != NULL)
+        {
+                /* buffered output written so far has to land in the
+                 * file before the raw bytes. */
+                if (dxf_writer_flush (out) != EXIT_SUCCESS)
+                {
+                        return (EXIT_FAILURE);
+                }
+        }
+        if (fwrite ("  0\n", 1, 4, out->fp) != 4)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () while writing to: %s.\n")),
+                  __FUNCTION__, out->filename);
+                return (EXIT_FAILURE);
+        }
+        return (dxf_read_copy_raw (fp, out->fp, start, end));
+}
+
+
+/*!
+ * Serializer of one entity struct, as every \c *_write function.
+ */
+typedef int (*DxfEntityWriteFunction) (DxfFile *out, void *entity);
+
+
+/*!
+ * \brief Emit one parsed record in update mode.
+ *
+ * A record the callback marked with \c dxf_entity_touch () is
+ * reserialized from the modified scratch entity; an untouched record
+ * is copied through as raw bytes from the mapping.\n
+ * The pass-through writer is flushed behind a reserialized record, so
+ * buffered and raw output stay in order.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+static int
+dxf_entities_update_record
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an input file (or device). */
+        DxfEntityWriteFunction write,
+                /*!< the \c *_write function of the entity type. */
+        void *entity,
+                /*!< the parsed scratch entity. */
+        size_t record_start
+                /*!< offset of the first record byte in the mapping. */
+)
+{
+        DxfFile *out;
+
+        out = fp->handlers->passthrough;
+        if (!fp->entity_dirty)
+        {
+                return (dxf_entities_copy_record (fp, out, record_start,
+                        fp->mmap_pos - 4));
+        }
+        if (write (out, entity) != EXIT_SUCCESS)
+        {
+                return (EXIT_FAILURE);
+        }
+        if ((out->writer != NULL)
+                && (dxf_writer_flush (out) != EXIT_SUCCESS))
+        {
+                return (EXIT_FAILURE);
+        }
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Match a string against a pattern with \c * and \c ?
+ * wildcards.
+ *
+ * \return \c TRUE on a match.
+ */
+static int
+dxf_parse_filter_glob
+(
+        const char *pattern,
+                /*!< the pattern; \c * matches any run of characters,
+                 * \c ? any single one. */
+        const char *string
+                /*!< the string to match. */
+)
+{
+        const char *star_pattern;
+        const char *star_string;
+
+        star_pattern = NULL;
+        star_string = NULL;
+        while (*string != '\0')
+        {
+                if ((*pattern == '?') || (*pattern == *string))
+                {
+                        pattern++;
+                        string++;
+                }
+                else if (*pattern == '*')
+                {
+                        /* remember the star: on a later mismatch the
+                         * star swallows one more character. */
+                        star_pattern = pattern++;
+                        star_string = string;
+                }
+                else if (star_pattern != NULL)
+                {
+                        pattern = star_pattern + 1;
+                        string = ++star_string;
+                }
+                else
+                {
+                        return (FALSE);
+                }
+        }
+        while (*pattern == '*')
+        {
+                pattern++;
+        }
+        return (*pattern == '\0');
+}
 
 
 /*!
- * \brief Read and parse the \c ENTITIES table from a DXF file.
+ * \brief Whether a parse filter admits a section.
+ *
+ * \return \c TRUE when the section is to be parsed.
  */
 int
-dxf_entities_read_table
+dxf_parse_filter_section
 (
-        char *filename,
-                /*!< filename of input file (or device). */
-        FILE *fp,
-                /*!< filepointer to the input file (or device). */
-        int line_number,
-                /*!< current line number in the input file (or device). */
-        char *dxf_entities_list, 
-                /*!< pointer to a list of entities. */
-        int acad_version_number
+        const DxfParseFilter *filter,
+                /*!< the filter spec, or \c NULL to admit everything. */
+        const char *name
+                /*!< the section name, e.g. "ENTITIES". */
+)
+{
+        size_t i;
+
+        if ((filter == NULL) || (filter->sections == NULL)
+                || (filter->number_sections == 0))
+        {
+                return (TRUE);
+        }
+        for (i = 0; i < filter->number_sections; i++)
+        {
+                if (strcmp (filter->sections[i], name) == 0)
+                {
+                        return (TRUE);
+                }
+        }
+        return (FALSE);
+}
+
+
+/*!
+ * \brief Whether a parse filter admits an entity type.
+ *
+ * \return \c TRUE when entities of the type are to be parsed.
+ */
+int
+dxf_parse_filter_type
+(
+        const DxfParseFilter *filter,
+                /*!< the filter spec, or \c NULL to admit everything. */
+        const char *name
+                /*!< the entity type name, e.g. "LINE". */
+)
+{
+        size_t i;
+
+        if ((filter == NULL) || (filter->types == NULL)
+                || (filter->number_types == 0))
+        {
+                return (TRUE);
+        }
+        for (i = 0; i < filter->number_types; i++)
+        {
+                if (strcmp (filter->types[i], name) == 0)
+                {
+                        return (TRUE);
+                }
+        }
+        return (FALSE);
+}
+
+
+/*!
+ * \brief Whether a parse filter admits a layer.
+ *
+ * \return \c TRUE when entities on the layer are to be parsed.
+ */
+int
+dxf_parse_filter_layer
+(
+        const DxfParseFilter *filter,
+                /*!< the filter spec, or \c NULL to admit everything. */
+        const char *layer
+                /*!< the layer name, or \c NULL for the default
+                 * layer "0". */
+)
+{
+        if ((filter == NULL) || (filter->layer_pattern == NULL))
+        {
+                return (TRUE);
+        }
+        return (dxf_parse_filter_glob (filter->layer_pattern,
+                (layer == NULL) ? "0" : layer));
+}
+
+
+/*!
+ * \brief Skip one rejected entity record at byte level.
+ *
+ * The record is scanned to its boundary with the raw record scanner,
+ * never tokenized; with a pass-through output registered the
+ * untouched record bytes are copied through.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+static int
+dxf_entities_skip_record
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an input file (or device). */
+        size_t record_start
+                /*!< offset of the first record byte in the mapping. */
+)
+{
+        if (dxf_read_skip_entity (fp) != EXIT_SUCCESS)
+        {
+                return (EXIT_FAILURE);
+        }
+        if ((fp->handlers != NULL)
+                && (fp->handlers->passthrough != NULL)
+                && (fp->mmap_base != NULL))
+        {
+                /* hand the untouched record through as raw bytes,
+                 * excluding the "  0" of the following record the
+                 * scanner consumed. */
+                return (dxf_entities_copy_record (fp,
+                        fp->handlers->passthrough, record_start,
+                        fp->mmap_pos - 4));
+        }
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Read and parse a span of entity records.
+ *
+ * Implements \c dxf_entities_read; reads entities until the end of the
+ * section marker \c ENDSEC is encountered.\n
+ * In bounded mode the span is a chunk of the \c ENTITIES section cut
+ * at a record boundary (see \c dxf_entities_read_parallel): running
+ * out of input at a record boundary then is the regular end of the
+ * chunk, not an error.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+static int
+dxf_entities_read_span
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an input file (or device). */
+        int bounded
+                /*!< when \c TRUE, end of input at a record boundary
+                 * terminates the span silently instead of being
+                 * reported as a truncated section. */
 )
 {
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        /*! \todo Add code here. */
+        char temp_string[DXF_MAX_STRING_LENGTH];
+        char temp_layer[DXF_MAX_STRING_LENGTH];
+        DxfReadHandlers *handlers;
+        int update;
+        size_t record_start;
+        DxfEntityType entity_type;
+        DXF_PROFILE_DECL (profile_start);
+        Dxf3dface *scratch_face = NULL;
+        DxfArc *scratch_arc = NULL;
+        DxfCircle *scratch_circle = NULL;
+        DxfEllipse *scratch_ellipse = NULL;
+        DxfInsert *scratch_insert = NULL;
+        DxfLine *scratch_line = NULL;
+        DxfLWPolyline *scratch_lwpolyline = NULL;
+        DxfPoint *scratch_point = NULL;
+        DxfPolyline *scratch_polyline = NULL;
+        DxfSeqend *scratch_seqend = NULL;
+        DxfSolid *scratch_solid = NULL;
+        DxfText *scratch_text = NULL;
+        DxfVertex *scratch_vertex = NULL;
+
+        /* Do some basic checks. */
+        if (fp == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL file pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        handlers = fp->handlers;
+        update = ((handlers != NULL) && handlers->update
+                && (handlers->passthrough != NULL)
+                && (fp->mmap_base != NULL));
+        /* The first "  0" group code announcing an entity. */
+        if (dxf_read_line (temp_string, fp) < 1)
+        {
+                if (bounded)
+                {
+                        /* an empty chunk. */
+                        return (EXIT_SUCCESS);
+                }
+                fprintf (stderr,
+                  (_("Error in %s () while reading from: %s in line: %ld.\n")),
+                  __FUNCTION__, fp->filename, fp->line_number);
+                return (EXIT_FAILURE);
+        }
+        record_start = 0;
+        for (;;)
+        {
+                if (fp->mmap_base != NULL)
+                {
+                        /* the record bytes start at the entity name
+                         * line, right behind the consumed "  0". */
+                        record_start = fp->mmap_pos;
+                }
+                /* Now follows the entity name; the *_read functions
+                 * leave the "  0" group code of the following entity
+                 * already consumed. */
+                if (dxf_read_line (temp_string, fp) < 1)
+                {
+                        if (bounded)
+                        {
+                                /* the chunk ends right behind the
+                                 * "  0" the last record reader
+                                 * consumed. */
+                                break;
+                        }
+                        fprintf (stderr,
+                          (_("Error in %s () while reading from: %s in line: %ld.\n")),
+                          __FUNCTION__, fp->filename, fp->line_number);
+                        break;
+                }
+                if (strcmp (temp_string, "ENDSEC") == 0)
+                {
+                        break;
+                }
+                DXF_PROFILE_START (profile_start);
+                fp->entity_dirty = FALSE;
+                if ((handlers != NULL)
+                        && (handlers->filter != NULL)
+                        && (!handlers->filter (temp_string, handlers->user_data)))
+                {
+                        /* The consumer does not want this entity type:
+                         * scan to the next record boundary without
+                         * tokenizing the fields. */
+                        if (dxf_entities_skip_record (fp, record_start)
+                                != EXIT_SUCCESS)
+                        {
+                                break;
+                        }
+                        continue;
+                }
+                if ((fp->parse_filter != NULL)
+                        && (!dxf_parse_filter_type (fp->parse_filter,
+                                temp_string)))
+                {
+                        /* The filter spec rejects this entity type. */
+                        if (dxf_entities_skip_record (fp, record_start)
+                                != EXIT_SUCCESS)
+                        {
+                                break;
+                        }
+                        continue;
+                }
+                if ((fp->parse_filter != NULL)
+                        && (fp->parse_filter->layer_pattern != NULL)
+                        && (dxf_read_peek_layer (fp, temp_layer)
+                                == EXIT_SUCCESS)
+                        && (!dxf_parse_filter_layer (fp->parse_filter,
+                                temp_layer)))
+                {
+                        /* The record sits on a layer the filter spec
+                         * rejects: the layer was peeked from the
+                         * mapping bytes, nothing was tokenized. */
+                        if (dxf_entities_skip_record (fp, record_start)
+                                != EXIT_SUCCESS)
+                        {
+                                break;
+                        }
+                        continue;
+                }
+                entity_type = dxf_entity_type_lookup (temp_string);
+                if (entity_type == FACE3D)
+                {
+                        if (scratch_face == NULL)
+                        {
+                                scratch_face = dxf_3dface_new ();
+                                scratch_face = dxf_3dface_init (scratch_face);
+                        }
+                        if (dxf_3dface_read (fp, scratch_face) == NULL)
+                        {
+                                break;
+                        }
+                        if ((handlers != NULL)
+                                && (handlers->face != NULL)
+                                && (handlers->face (fp, scratch_face, handlers->user_data) != EXIT_SUCCESS))
+                        {
+                                break;
+                        }
+                        if (update
+                                && (dxf_entities_update_record (fp,
+                                        (DxfEntityWriteFunction) dxf_3dface_write,
+                                        scratch_face, record_start) != EXIT_SUCCESS))
+                        {
+                                break;
+                        }
+                }
+                else if (entity_type == ARC)
+                {
+                        if (scratch_arc == NULL)
+                        {
+                                scratch_arc = dxf_arc_new ();
+                                scratch_arc = dxf_arc_init (scratch_arc);
+                        }
+                        if (dxf_arc_read (fp, scratch_arc) == NULL)
+                        {
+                                break;
+                        }
+                        if ((handlers != NULL)
+                                && (handlers->arc != NULL)
+                                && (handlers->arc (fp, scratch_arc, handlers->user_data) != EXIT_SUCCESS))
+                        {
+                                break;
+                        }
+                        if (update
+                                && (dxf_entities_update_record (fp,
+                                        (DxfEntityWriteFunction) dxf_arc_write,
+                                        scratch_arc, record_start) != EXIT_SUCCESS))
+                        {
+                                break;
+                        }
+                }
+                else if (entity_type == CIRCLE)
+                {
+                        if (scratch_circle == NULL)
+                        {
+                                scratch_circle = dxf_circle_new ();
+                                scratch_circle = dxf_circle_init (scratch_circle);
+                        }
+                        if (dxf_circle_read (fp, scratch_circle) == NULL)
+                        {
+                                break;
+                        }
+                        if ((handlers != NULL)
+                                && (handlers->circle != NULL)
+                                && (handlers->circle (fp, scratch_circle, handlers->user_data) != EXIT_SUCCESS))
+                        {
+                                break;
+                        }
+                        if (update
+                                && (dxf_entities_update_record (fp,
+                                        (DxfEntityWriteFunction) dxf_circle_write,
+                                        scratch_circle, record_start) != EXIT_SUCCESS))
+                        {
+                                break;
+                        }
+                }
+                else if (entity_type == ELLIPSE)
+                {
+                        if (scratch_ellipse == NULL)
+                        {
+                                scratch_ellipse = dxf_ellipse_new ();
+                                scratch_ellipse = dxf_ellipse_init (scratch_ellipse);
+                        }
+                        if (dxf_ellipse_read (fp, scratch_ellipse) == NULL)
+                        {
+                                break;
+                        }
+                        if ((handlers != NULL)
+                                && (handlers->ellipse != NULL)
+                                && (handlers->ellipse (fp, scratch_ellipse, handlers->user_data) != EXIT_SUCCESS))
+                        {
+                                break;
+                        }
+                        if (update
+                                && (dxf_entities_update_record (fp,
+                                        (DxfEntityWriteFunction) dxf_ellipse_write,
+                                        scratch_ellipse, record_start) != EXIT_SUCCESS))
+                        {
+                                break;
+                        }
+                }
+                else if (entity_type == INSERT)
+                {
+                        if (scratch_insert == NULL)
+                        {
+                                scratch_insert = dxf_insert_new ();
+                                scratch_insert = dxf_insert_init (scratch_insert);
+                        }
+                        if (dxf_insert_read (fp, scratch_insert) == NULL)
+                        {
+                                break;
+                        }
+                        if ((handlers != NULL)
+                                && (handlers->insert != NULL)
+                                && (handlers->insert (fp, scratch_insert, handlers->user_data) != EXIT_SUCCESS))
+                        {
+                                break;
+                        }
+                        if (update
+                                && (dxf_entities_update_record (fp,
+                                        (DxfEntityWriteFunction) dxf_insert_write,
+                                        scratch_insert, record_start) != EXIT_SUCCESS))
+                        {
+                                break;
+                        }
+                }
+                else if (entity_type == LINE)
+                {
+                        if (scratch_line == NULL)
+                        {
+                                scratch_line = dxf_line_new ();
+                                scratch_line = dxf_line_init (scratch_line);
+                        }
+                        if (dxf_line_read (fp, scratch_line) == NULL)
+                        {
+                                break;
+                        }
+                        if ((handlers != NULL)
+                                && (handlers->line != NULL)
+                                && (handlers->line (fp, scratch_line, handlers->user_data) != EXIT_SUCCESS))
+                        {
+                                break;
+                        }
+                        if (update
+                                && (dxf_entities_update_record (fp,
+                                        (DxfEntityWriteFunction) dxf_line_write,
+                                        scratch_line, record_start) != EXIT_SUCCESS))
+                        {
+                                break;
+                        }
+                }
+                else if (entity_type == LWPOLYLINE)
+                {
+                        if (scratch_lwpolyline == NULL)
+                        {
+                                scratch_lwpolyline = dxf_lwpolyline_new ();
+                                scratch_lwpolyline = dxf_lwpolyline_init (scratch_lwpolyline);
+                        }
+                        if (dxf_lwpolyline_read (fp, scratch_lwpolyline) == NULL)
+                        {
+                                break;
+                        }
+                        if ((handlers != NULL)
+                                && (handlers->lwpolyline != NULL)
+                                && (handlers->lwpolyline (fp, scratch_lwpolyline, handlers->user_data) != EXIT_SUCCESS))
+                        {
+                                break;
+                        }
+                        if (update
+                                && (dxf_entities_update_record (fp,
+                                        (DxfEntityWriteFunction) dxf_lwpolyline_write,
+                                        scratch_lwpolyline, record_start) != EXIT_SUCCESS))
+                        {
+                                break;
+                        }
+                }
+                else if (entity_type == POINT)
+                {
+                        if (scratch_point == NULL)
+                        {
+                                scratch_point = dxf_point_new ();
+                                scratch_point = dxf_point_init (scratch_point);
+                        }
+                        if (dxf_point_read (fp, scratch_point) == NULL)
+                        {
+                                break;
+                        }
+                        if ((handlers != NULL)
+                                && (handlers->point != NULL)
+                                && (handlers->point (fp, scratch_point, handlers->user_data) != EXIT_SUCCESS))
+                        {
+                                break;
+                        }
+                        if (update
+                                && (dxf_entities_update_record (fp,
+                                        (DxfEntityWriteFunction) dxf_point_write,
+                                        scratch_point, record_start) != EXIT_SUCCESS))
+                        {
+                                break;
+                        }
+                }
+                else if (entity_type == POLYLINE)
+                {
+                        if (scratch_polyline == NULL)
+                        {
+                                scratch_polyline = dxf_polyline_new ();
+                                scratch_polyline = dxf_polyline_init (scratch_polyline);
+                        }
+                        if (dxf_polyline_read (fp, scratch_polyline) == NULL)
+                        {
+                                break;
+                        }
+                        if ((handlers != NULL)
+                                && (handlers->polyline != NULL)
+                                && (handlers->polyline (fp, scratch_polyline, handlers->user_data) != EXIT_SUCCESS))
+                        {
+                                break;
+                        }
+                        if (update
+                                && (dxf_entities_update_record (fp,
+                                        (DxfEntityWriteFunction) dxf_polyline_write,
+                                        scratch_polyline, record_start) != EXIT_SUCCESS))
+                        {
+                                break;
+                        }
+                }
+                else if (entity_type == SEQEND)
+                {
+                        if (scratch_seqend == NULL)
+                        {
+                                scratch_seqend = dxf_seqend_new ();
+                                scratch_seqend = dxf_seqend_init (scratch_seqend);
+                        }
+                        if (dxf_seqend_read (fp, scratch_seqend) == NULL)
+                        {
+                                break;
+                        }
+                        if ((handlers != NULL)
+                                && (handlers->seqend != NULL)
+                                && (handlers->seqend (fp, scratch_seqend, handlers->user_data) != EXIT_SUCCESS))
+                        {
+                                break;
+                        }
+                        if (update
+                                && (dxf_entities_update_record (fp,
+                                        (DxfEntityWriteFunction) dxf_seqend_write,
+                                        scratch_seqend, record_start) != EXIT_SUCCESS))
+                        {
+                                break;
+                        }
+                }
+                else if (entity_type == SOLID)
+                {
+                        if (scratch_solid == NULL)
+                        {
+                                scratch_solid = dxf_solid_new ();
+                                scratch_solid = dxf_solid_init (scratch_solid);
+                        }
+                        if (dxf_solid_read (fp, scratch_solid) == NULL)
+                        {
+                                break;
+                        }
+                        if ((handlers != NULL)
+                                && (handlers->solid != NULL)
+                                && (handlers->solid (fp, scratch_solid, handlers->user_data) != EXIT_SUCCESS))
+                        {
+                                break;
+                        }
+                        if (update
+                                && (dxf_entities_update_record (fp,
+                                        (DxfEntityWriteFunction) dxf_solid_write,
+                                        scratch_solid, record_start) != EXIT_SUCCESS))
+                        {
+                                break;
+                        }
+                }
+                else if (entity_type == TEXT)
+                {
+                        if (scratch_text == NULL)
+                        {
+                                scratch_text = dxf_text_new ();
+                                scratch_text = dxf_text_init (scratch_text);
+                        }
+                        if (dxf_text_read (fp, scratch_text) == NULL)
+                        {
+                                break;
+                        }
+                        if ((handlers != NULL)
+                                && (handlers->text != NULL)
+                                && (handlers->text (fp, scratch_text, handlers->user_data) != EXIT_SUCCESS))
+                        {
+                                break;
+                        }
+                        if (update
+                                && (dxf_entities_update_record (fp,
+                                        (DxfEntityWriteFunction) dxf_text_write,
+                                        scratch_text, record_start) != EXIT_SUCCESS))
+                        {
+                                break;
+                        }
+                }
+                else if (entity_type == VERTEX)
+                {
+                        if (scratch_vertex == NULL)
+                        {
+                                scratch_vertex = dxf_vertex_new ();
+                                scratch_vertex = dxf_vertex_init (scratch_vertex);
+                        }
+                        if (dxf_vertex_read (fp, scratch_vertex) == NULL)
+                        {
+                                break;
+                        }
+                        if ((handlers != NULL)
+                                && (handlers->vertex != NULL)
+                                && (handlers->vertex (fp, scratch_vertex, handlers->user_data) != EXIT_SUCCESS))
+                        {
+                                break;
+                        }
+                        if (update
+                                && (dxf_entities_update_record (fp,
+                                        (DxfEntityWriteFunction) dxf_vertex_write,
+                                        scratch_vertex, record_start) != EXIT_SUCCESS))
+                        {
+                                break;
+                        }
+                }
+                else
+                {
+                        DxfEntityRegistryEntry *registered;
+
+                        registered = NULL;
+                        if ((handlers != NULL)
+                                && (handlers->registry != NULL))
+                        {
+                                registered = dxf_entity_registry_find
+                                        (handlers->registry, temp_string);
+                        }
+                        if (registered != NULL)
+                        {
+                                registered->matches++;
+                        }
+                        if ((registered != NULL)
+                                && (registered->mode == DXF_ENTITY_REGISTRY_PARSE))
+                        {
+                                /* The callback consumes the fields and
+                                 * the trailing "  0" group code
+                                 * itself. */
+                                if (registered->parse (fp, temp_string,
+                                        registered->user_data) != EXIT_SUCCESS)
+                                {
+                                        break;
+                                }
+                        }
+                        else
+                        {
+                                if ((registered == NULL)
+                                        && (handlers != NULL)
+                                        && (handlers->unknown != NULL)
+                                        && (handlers->unknown (fp, temp_string, handlers->user_data) != EXIT_SUCCESS))
+                                {
+                                        break;
+                                }
+                                /* Skip to the "  0" group code of the next
+                                 * entity. */
+                                if (dxf_read_skip_entity (fp) != EXIT_SUCCESS)
+                                {
+                                        break;
+                                }
+                                if ((registered != NULL)
+                                        && (registered->mode == DXF_ENTITY_REGISTRY_CAPTURE)
+                                        && (fp->mmap_base != NULL))
+                                {
+                                        /* the line reader NUL
+                                         * terminated the entity name
+                                         * line in place; restore the
+                                         * range to the input bytes
+                                         * before handing it out. */
+                                        if (dxf_read_repair_raw (fp,
+                                                record_start,
+                                                fp->mmap_pos - 4) != EXIT_SUCCESS)
+                                        {
+                                                break;
+                                        }
+                                        if (registered->capture (fp, temp_string,
+                                                fp->mmap_base + record_start,
+                                                fp->mmap_pos - 4 - record_start,
+                                                registered->user_data) != EXIT_SUCCESS)
+                                        {
+                                                break;
+                                        }
+                                }
+                        }
+                        if (update
+                                && (dxf_entities_copy_record (fp,
+                                        handlers->passthrough, record_start,
+                                        fp->mmap_pos - 4) != EXIT_SUCCESS))
+                        {
+                                break;
+                        }
+                }
+                DXF_PROFILE_ENTITY (temp_string, profile_start);
+        }
+        if (scratch_face != NULL)
+        {
+                dxf_3dface_free (scratch_face);
+        }
+        if (scratch_arc != NULL)
+        {
+                dxf_arc_free (scratch_arc);
+        }
+        if (scratch_circle != NULL)
+        {
+                dxf_circle_free (scratch_circle);
+        }
+        if (scratch_ellipse != NULL)
+        {
+                dxf_ellipse_free (scratch_ellipse);
+        }
+        if (scratch_insert != NULL)
+        {
+                dxf_insert_free (scratch_insert);
+        }
+        if (scratch_line != NULL)
+        {
+                dxf_line_free (scratch_line);
+        }
+        if (scratch_lwpolyline != NULL)
+        {
+                dxf_lwpolyline_free (scratch_lwpolyline);
+        }
+        if (scratch_point != NULL)
+        {
+                dxf_point_free (scratch_point);
+        }
+        if (scratch_polyline != NULL)
+        {
+                dxf_polyline_free (scratch_polyline);
+        }
+        if (scratch_seqend != NULL)
+        {
+                dxf_seqend_free (scratch_seqend);
+        }
+        if (scratch_solid != NULL)
+        {
+                dxf_solid_free (scratch_solid);
+        }
+        if (scratch_text != NULL)
+        {
+                dxf_text_free (scratch_text);
+        }
+        if (scratch_vertex != NULL)
+        {
+                dxf_vertex_free (scratch_vertex);
+        }
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -82,6 +954,406 @@ dxf_entities_read_table
 }
 
 
+/*!
+ * \brief Read and parse the contents of the \c ENTITIES section.
+ *
+ * The last line read from file contained the string "ENTITIES".\n
+ * Reads entities until the end of the section marker \c ENDSEC is
+ * encountered.\n
+ * One scratch struct per entity type is allocated on first use and
+ * reused for every following occurrence of that type; after each
+ * parsed entity the matching streaming callback from \c fp->handlers
+ * is invoked (see \c DxfReadHandlers), so consumers can observe every
+ * entity while memory stays O(1) regardless of the file size.\n
+ * Entity types without a reader or callback are skipped.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_entities_read
+(
+        DxfFile *fp
+                /*!< DXF file pointer to an input file (or device). */
+)
+{
+        return (dxf_entities_read_span (fp, FALSE));
+}
+
+
+/*!
+ * The maximum number of chunks the \c ENTITIES section is split into
+ * by \c dxf_entities_read_parallel.
+ */
+#define DXF_ENTITIES_MAX_CHUNKS 64
+
+
+/*!
+ * \brief One chunk of the \c ENTITIES section handed to a worker
+ * thread by \c dxf_entities_read_parallel.
+ */
+typedef struct
+dxf_entities_chunk
+{
+        char *filename;
+                /*!< filename of the input file, opened and mapped
+                 * again by the worker. */
+        struct dxf_read_handlers *handlers;
+                /*!< streaming callbacks shared by all workers. */
+        size_t start;
+                /*!< offset of the first chunk byte: the "  0" group
+                 * code line of the first record in the chunk. */
+        size_t end;
+                /*!< offset just past the last chunk byte: right
+                 * behind the "  0" group code line of the record
+                 * following the chunk. */
+        long line_number;
+                /*!< line number of the first chunk line, so worker
+                 * diagnostics report file relative line numbers. */
+        int cpu;
+                /*!< the processor the worker is pinned to, or \c -1
+                 * to let the scheduler place it (see
+                 * \c dxf_entities_set_affinity). */
+        pthread_t thread;
+                /*!< the worker thread parsing this chunk. */
+        int result;
+                /*!< \c EXIT_SUCCESS or \c EXIT_FAILURE. */
+} DxfEntitiesChunk;
+
+
+/*!
+ * Whether \c dxf_entities_read_parallel pins its workers to
+ * processors (see \c dxf_entities_set_affinity).
+ */
+static int dxf_entities_affinity = FALSE;
+
+
+/*!
+ * \brief Enable or disable worker to processor pinning for
+ * \c dxf_entities_read_parallel.
+ *
+ * With pinning enabled each worker is bound to one processor before
+ * it parses, so on a NUMA system its scratch structs, its private
+ * file mapping and — with \c DXF_ARENA_PLACE_FIRST_TOUCH — the
+ * arenas its callbacks fill all stay on the memory node of that
+ * processor, instead of migrating with the thread.\n
+ * Off by default: pinning helps dedicated multi-socket parse servers
+ * and hurts oversubscribed ones.
+ */
+void
+dxf_entities_set_affinity
+(
+        int enable
+                /*!< \c TRUE to pin workers, \c FALSE to let the
+                 * scheduler place them. */
+)
+{
+        dxf_entities_affinity = enable;
+}
+
+
+/*!
+ * \brief Parse one chunk of the \c ENTITIES section in a worker
+ * thread.
+ *
+ * The worker opens its own private, copy on write mapping of the
+ * input file (see \c dxf_read_mmap_init), so the in place line
+ * termination of the mapped line reader never touches the pages of
+ * another worker, and keeps its own scratch structs.\n
+ * The mapping is truncated at the chunk end, which lies at a record
+ * boundary; running out of input there ends the chunk (see
+ * \c dxf_entities_read_span).
+ */
+static void *
+dxf_entities_read_chunk_main
+(
+        void *arg
+                /*!< the \c DxfEntitiesChunk to parse. */
+)
+{
+        DxfEntitiesChunk *chunk;
+        DxfFile *fp;
+
+        chunk = (DxfEntitiesChunk *) arg;
+        chunk->result = EXIT_FAILURE;
+#ifdef CPU_SETSIZE
+        if (chunk->cpu >= 0)
+        {
+                cpu_set_t cpus;
+
+                CPU_ZERO (&cpus);
+                CPU_SET (chunk->cpu, &cpus);
+                /* best effort: an offline processor just leaves the
+                 * worker unpinned. */
+                pthread_setaffinity_np (pthread_self (),
+                        sizeof (cpus), &cpus);
+        }
+#endif
+        fp = dxf_read_init (chunk->filename);
+        if (fp == NULL)
+        {
+                return (NULL);
+        }
+        if (dxf_read_mmap_init (fp) != EXIT_SUCCESS)
+        {
+                dxf_read_close (fp);
+                return (NULL);
+        }
+        fp->handlers = chunk->handlers;
+        if (chunk->handlers != NULL)
+        {
+                fp->diag = chunk->handlers->diag;
+                fp->trusted = chunk->handlers->trusted;
+        }
+        fp->mmap_pos = chunk->start;
+        fp->mmap_size = chunk->end;
+        fp->line_number = chunk->line_number;
+        chunk->result = dxf_entities_read_span (fp, TRUE);
+        dxf_read_close (fp);
+        return (NULL);
+}
+
+
+/*!
+ * \brief Read and parse the contents of the \c ENTITIES section with
+ * a pool of worker threads.
+ *
+ * Entity records are self delimiting at their "  0" group code lines,
+ * so the section is split at record boundaries into one chunk per
+ * worker and the chunks are parsed concurrently, each worker with its
+ * own private mapping, scratch structs and line reader state.\n
+ * The streaming callbacks (see \c DxfReadHandlers) are invoked from
+ * the worker threads: callbacks observe the records of one chunk in
+ * file order, but records of different chunks interleave, so
+ * callbacks have to be thread safe and consumers needing global order
+ * have to carry a sort key (a handle or \c fp->line_number) or read
+ * sequentially.\n
+ * Falls back to the sequential \c dxf_entities_read when the input is
+ * not read from a memory mapping, when a pass-through output is set
+ * (its single output file would interleave), or when only one worker
+ * is requested.
+ *
+ * \note a \c POLYLINE / \c VERTEX / \c SEQEND sequence may straddle a
+ * chunk boundary; every record still parses (each is self contained),
+ * but the callbacks of one sequence may come from two workers.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_entities_read_parallel
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an input file (or device). */
+        int workers
+                /*!< number of worker threads, or \c 0 for one per
+                 * available processor. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        DxfEntitiesChunk chunks[DXF_ENTITIES_MAX_CHUNKS];
+        char *base;
+        char *eol;
+        size_t pos;
+        size_t avail;
+        size_t span;
+        size_t target;
+        size_t section_end;
+        long line;
+        int count;
+        int found;
+        int result;
+        int i;
+
+        /* Do some basic checks. */
+        if (fp == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL file pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (workers <= 0)
+        {
+                workers = (int) sysconf (_SC_NPROCESSORS_ONLN);
+        }
+        if (workers > DXF_ENTITIES_MAX_CHUNKS)
+        {
+                workers = DXF_ENTITIES_MAX_CHUNKS;
+        }
+        if ((fp->mmap_base == NULL)
+                || (workers <= 1)
+                || ((fp->handlers != NULL)
+                        && (fp->handlers->passthrough != NULL)))
+        {
+                return (dxf_entities_read (fp));
+        }
+        /* Scan the section for record boundaries: "  0" group code
+         * lines.\n
+         * The boundary nearest each of the (workers - 1) equidistant
+         * split targets starts a chunk; the boundary in front of
+         * ENDSEC ends the section. */
+        base = fp->mmap_base;
+        avail = fp->mmap_size;
+        pos = fp->mmap_pos;
+        line = fp->line_number;
+        span = (avail - pos) / (size_t) workers;
+        if (span < 1)
+        {
+                span = 1;
+        }
+        chunks[0].start = pos;
+        chunks[0].line_number = line;
+        count = 1;
+        target = pos + span;
+        section_end = avail;
+        found = FALSE;
+        while ((pos + 4 <= avail)
+                && (memcmp (base + pos, "  0\n", 4) == 0))
+        {
+                if ((avail - (pos + 4) >= 6)
+                        && (memcmp (base + pos + 4, "ENDSEC", 6) == 0))
+                {
+                        section_end = pos;
+                        found = TRUE;
+                        break;
+                }
+                if ((pos > chunks[count - 1].start)
+                        && (pos >= target)
+                        && (count < workers))
+                {
+                        chunks[count].start = pos;
+                        chunks[count].line_number = line;
+                        count++;
+                        target = pos + span;
+                }
+                /* advance to the next record boundary. */
+                pos = pos + 4;
+                line = line + 1;
+                while ((eol = memchr (base + pos, '\n', avail - pos)) != NULL)
+                {
+                        line++;
+                        pos = (size_t) (eol - base) + 1;
+                        if ((avail - pos >= 4)
+                                && (memcmp (base + pos, "  0\n", 4) == 0))
+                        {
+                                break;
+                        }
+                }
+                if (eol == NULL)
+                {
+                        break;
+                }
+        }
+        if (!found)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () no ENDSEC found while reading from: %s.\n")),
+                  __FUNCTION__, fp->filename);
+                return (EXIT_FAILURE);
+        }
+        /* Each chunk runs up to and including the "  0" line starting
+         * the next chunk (or ENDSEC), because the record readers
+         * consume the "  0" of the following record. */
+        for (i = 0; i < count - 1; i++)
+        {
+                chunks[i].end = chunks[i + 1].start + 4;
+        }
+        chunks[count - 1].end = section_end + 4;
+        for (i = 0; i < count; i++)
+        {
+                chunks[i].filename = fp->filename;
+                chunks[i].handlers = fp->handlers;
+                chunks[i].result = EXIT_FAILURE;
+                chunks[i].cpu = dxf_entities_affinity ? i : -1;
+                if (pthread_create (&chunks[i].thread, NULL,
+                        dxf_entities_read_chunk_main, &chunks[i]) != 0)
+                {
+                        /* no thread: parse in this one. */
+                        dxf_entities_read_chunk_main (&chunks[i]);
+                        chunks[i].thread = pthread_self ();
+                }
+        }
+        result = EXIT_SUCCESS;
+        for (i = 0; i < count; i++)
+        {
+                if (!pthread_equal (chunks[i].thread, pthread_self ()))
+                {
+                        pthread_join (chunks[i].thread, NULL);
+                }
+                if (chunks[i].result != EXIT_SUCCESS)
+                {
+                        result = EXIT_FAILURE;
+                }
+        }
+        /* Leave the caller behind the consumed ENDSEC, as the
+         * sequential reader would. */
+        fp->mmap_pos = section_end + 4;
+        fp->line_number = line + 1;
+        if ((eol = memchr (base + fp->mmap_pos, '\n',
+                avail - fp->mmap_pos)) != NULL)
+        {
+                fp->mmap_pos = (size_t) (eol - base) + 1;
+                fp->line_number++;
+        }
+        fp->bytes_consumed = fp->mmap_pos;
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (result);
+}
+
+
+/*!
+ * \brief Read and parse the \c ENTITIES table from a DXF file with a
+ * parse-time filter.
+ *
+ * Runs the regular entity reader with \c filter installed: entity
+ * records the filter rejects by type or layer are skipped at byte
+ * level with the raw record scanner, never tokenized (see
+ * \c DxfParseFilter).\n
+ * A previously installed filter is restored on return.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_entities_read_table
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an input file (or device),
+                 * positioned behind the \c ENTITIES section name. */
+        const DxfParseFilter *filter
+                /*!< the filter spec, or \c NULL to parse every
+                 * entity. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        const struct dxf_parse_filter *previous;
+        int result;
+
+        if (fp == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL file pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        previous = fp->parse_filter;
+        fp->parse_filter = filter;
+        result = dxf_entities_read (fp);
+        fp->parse_filter = previous;
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (result);
+}
+
+
 /*!
  * \brief Write DXF output to a file for a DXF \c ENTITIES table.
  */
@@ -103,4 +1375,330 @@ dxf_entities_write_table
 }
 
 
+/*!
+ * \brief Write every \c LINE of a contiguous store with one setup.
+ *
+ * The non-coordinate groups come from the prototype; every decision
+ * \c dxf_line_write () makes per entity is hoisted out of the loop.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+static int
+dxf_entities_write_batch_lines
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an output file (or device). */
+        DxfSoaLines *lines,
+                /*!< the contiguous line store to serialize. */
+        DxfLine *prototype
+                /*!< supplies the non-coordinate groups of every
+                 * record. */
+)
+{
+        int write_subclass;
+        int write_paperspace;
+        int write_linetype;
+        int write_color;
+        int write_thickness;
+        int id_code;
+        size_t i;
+
+        write_subclass = fp->write_version.since_r13;
+        write_paperspace = (prototype->paperspace == DXF_PAPERSPACE);
+        write_linetype = (strcmp (prototype->linetype, DXF_DEFAULT_LINETYPE) != 0);
+        write_color = (prototype->color != DXF_COLOR_BYLAYER);
+        write_thickness = (prototype->thickness != 0.0);
+        id_code = prototype->id_code;
+        for (i = 0; i < lines->length; i++)
+        {
+                dxf_write_group_string (fp, 0, "LINE");
+                if (id_code != -1)
+                {
+                        dxf_write_group_hex (fp, 5, id_code++);
+                }
+                if (write_subclass)
+                {
+                        dxf_write_group_string (fp, 100, "AcDbEntity");
+                }
+                if (write_paperspace)
+                {
+                        dxf_write_group_int (fp, 67, DXF_PAPERSPACE);
+                }
+                dxf_write_group_string (fp, 8, prototype->layer);
+                if (write_linetype)
+                {
+                        dxf_write_group_string (fp, 6, prototype->linetype);
+                }
+                if (write_color)
+                {
+                        dxf_write_group_int (fp, 62, prototype->color);
+                }
+                if (write_subclass)
+                {
+                        dxf_write_group_string (fp, 100, "AcDbLine");
+                }
+                if (write_thickness)
+                {
+                        dxf_write_group_double (fp, 39, prototype->thickness);
+                }
+                dxf_write_group_double (fp, 10, lines->x0[i]);
+                dxf_write_group_double (fp, 20, lines->y0[i]);
+                dxf_write_group_double (fp, 30, lines->z0[i]);
+                dxf_write_group_double (fp, 11, lines->x1[i]);
+                dxf_write_group_double (fp, 21, lines->y1[i]);
+                dxf_write_group_double (fp, 31, lines->z1[i]);
+        }
+        if (id_code != -1)
+        {
+                fp->last_id_code = id_code - 1;
+        }
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Write every \c POINT of a contiguous store with one setup.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+static int
+dxf_entities_write_batch_points
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an output file (or device). */
+        DxfSoaPoints *points,
+                /*!< the contiguous point store to serialize. */
+        DxfPoint *prototype
+                /*!< supplies the non-coordinate groups of every
+                 * record. */
+)
+{
+        int write_subclass;
+        int write_paperspace;
+        int write_linetype;
+        int write_color;
+        int write_thickness;
+        int id_code;
+        size_t i;
+
+        write_subclass = fp->write_version.since_r13;
+        write_paperspace = (prototype->paperspace == DXF_PAPERSPACE);
+        write_linetype = (strcmp (prototype->linetype, DXF_DEFAULT_LINETYPE) != 0);
+        write_color = (prototype->color != DXF_COLOR_BYLAYER);
+        write_thickness = (prototype->thickness != 0.0);
+        id_code = prototype->id_code;
+        for (i = 0; i < points->length; i++)
+        {
+                dxf_write_group_string (fp, 0, "POINT");
+                if (id_code != -1)
+                {
+                        dxf_write_group_hex (fp, 5, id_code++);
+                }
+                if (write_subclass)
+                {
+                        dxf_write_group_string (fp, 100, "AcDbEntity");
+                }
+                if (write_paperspace)
+                {
+                        dxf_write_group_int (fp, 67, DXF_PAPERSPACE);
+                }
+                dxf_write_group_string (fp, 8, prototype->layer);
+                if (write_linetype)
+                {
+                        dxf_write_group_string (fp, 6, prototype->linetype);
+                }
+                if (write_color)
+                {
+                        dxf_write_group_int (fp, 62, prototype->color);
+                }
+                if (write_subclass)
+                {
+                        dxf_write_group_string (fp, 100, "AcDbPoint");
+                }
+                dxf_write_group_double (fp, 10, points->x0[i]);
+                dxf_write_group_double (fp, 20, points->y0[i]);
+                dxf_write_group_double (fp, 30, points->z0[i]);
+                if (write_thickness)
+                {
+                        dxf_write_group_double (fp, 39, prototype->thickness);
+                }
+                dxf_write_group_double (fp, 50, prototype->angle_to_X);
+        }
+        if (id_code != -1)
+        {
+                fp->last_id_code = id_code - 1;
+        }
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Write every \c 3DFACE of a contiguous store with one setup.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+static int
+dxf_entities_write_batch_faces
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an output file (or device). */
+        DxfSoaFaces *faces,
+                /*!< the contiguous face store to serialize. */
+        Dxf3dface *prototype
+                /*!< supplies the non-coordinate groups of every
+                 * record. */
+)
+{
+        int write_subclass;
+        int write_paperspace;
+        int write_linetype;
+        int write_color;
+        int id_code;
+        size_t i;
+
+        write_subclass = fp->write_version.since_r13;
+        write_paperspace = (prototype->paperspace == DXF_PAPERSPACE);
+        write_linetype = (strcmp (prototype->linetype, DXF_DEFAULT_LINETYPE) != 0);
+        write_color = (prototype->color != DXF_COLOR_BYLAYER);
+        id_code = prototype->id_code;
+        for (i = 0; i < faces->length; i++)
+        {
+                dxf_write_group_string (fp, 0, "3DFACE");
+                if (id_code != -1)
+                {
+                        dxf_write_group_hex (fp, 5, id_code++);
+                }
+                if (write_subclass)
+                {
+                        dxf_write_group_string (fp, 100, "AcDbEntity");
+                }
+                if (write_paperspace)
+                {
+                        dxf_write_group_int (fp, 67, DXF_PAPERSPACE);
+                }
+                dxf_write_group_string (fp, 8, prototype->layer);
+                if (write_linetype)
+                {
+                        dxf_write_group_string (fp, 6, prototype->linetype);
+                }
+                if (write_color)
+                {
+                        dxf_write_group_int (fp, 62, prototype->color);
+                }
+                if (write_subclass)
+                {
+                        dxf_write_group_string (fp, 100, "AcDbFace");
+                }
+                dxf_write_group_double (fp, 10, faces->x0[i]);
+                dxf_write_group_double (fp, 20, faces->y0[i]);
+                dxf_write_group_double (fp, 30, faces->z0[i]);
+                dxf_write_group_double (fp, 11, faces->x1[i]);
+                dxf_write_group_double (fp, 21, faces->y1[i]);
+                dxf_write_group_double (fp, 31, faces->z1[i]);
+                dxf_write_group_double (fp, 12, faces->x2[i]);
+                dxf_write_group_double (fp, 22, faces->y2[i]);
+                dxf_write_group_double (fp, 32, faces->z2[i]);
+                dxf_write_group_double (fp, 13, faces->x3[i]);
+                dxf_write_group_double (fp, 23, faces->y3[i]);
+                dxf_write_group_double (fp, 33, faces->z3[i]);
+                dxf_write_group_int (fp, 70, prototype->flag);
+        }
+        if (id_code != -1)
+        {
+                fp->last_id_code = id_code - 1;
+        }
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Serialize whole contiguous entity stores in one call.
+ *
+ * Bulk exporters hold their geometry in the structure of arrays
+ * stores (see soa.h); writing them through one \c dxf_line_write ()
+ * call per entity re-enters validation, version checks and setup for
+ * every record.\n
+ * Here the checks run once per store: the prototype entity supplies
+ * the shared non-coordinate groups (layer, linetype, color, ...),
+ * every per-record decision is hoisted out of the loop and the
+ * coordinates stream from the arrays.\n
+ * A prototype \c id_code of \c -1 omits the id group; any other
+ * value numbers the records consecutively from it and updates
+ * \c last_id_code.\n
+ * A \c NULL store is skipped; a non-NULL store with a \c NULL
+ * prototype is an error.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_entities_write_batch
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an output file (or device). */
+        struct dxf_soa_lines *lines,
+                /*!< contiguous \c LINE store to serialize, or \c NULL. */
+        DxfLine *line_prototype,
+                /*!< prototype for the \c LINE records. */
+        struct dxf_soa_points *points,
+                /*!< contiguous \c POINT store to serialize, or \c NULL. */
+        DxfPoint *point_prototype,
+                /*!< prototype for the \c POINT records. */
+        struct dxf_soa_faces *faces,
+                /*!< contiguous \c 3DFACE store to serialize, or \c NULL. */
+        Dxf3dface *face_prototype
+                /*!< prototype for the \c 3DFACE records. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        if (fp == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL file pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (((lines != NULL) && (line_prototype == NULL))
+                || ((points != NULL) && (point_prototype == NULL))
+                || ((faces != NULL) && (face_prototype == NULL)))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL prototype was passed for a non-NULL store.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (fp->write_version.acad_version_number != fp->acad_version_number)
+        {
+                dxf_write_version_init (fp);
+        }
+        if ((lines != NULL)
+                && (dxf_entities_write_batch_lines (fp, lines, line_prototype)
+                        != EXIT_SUCCESS))
+        {
+                return (EXIT_FAILURE);
+        }
+        if ((points != NULL)
+                && (dxf_entities_write_batch_points (fp, points, point_prototype)
+                        != EXIT_SUCCESS))
+        {
+                return (EXIT_FAILURE);
+        }
+        if ((faces != NULL)
+                && (dxf_entities_write_batch_faces (fp, faces, face_prototype)
+                        != EXIT_SUCCESS))
+        {
+                return (EXIT_FAILURE);
+        }
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (EXIT_SUCCESS);
+}
+
+
 /* EOF */
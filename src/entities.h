@@ -56,16 +56,203 @@
 
 
 #include "global.h"
+#include "3dface.h"
+#include "arc.h"
+#include "circle.h"
+#include "ellipse.h"
+#include "insert.h"
+#include "line.h"
+#include "lwpolyline.h"
+#include "point.h"
+#include "polyline.h"
+#include "seqend.h"
+#include "solid.h"
+#include "text.h"
+#include "vertex.h"
 
 
+/*!
+ * \brief Declarative parse-time filter.
+ *
+ * Restricts a parse to selected sections, entity types and layers —
+ * e.g. \c ENTITIES only, types \c LINE and \c LWPOLYLINE, layers
+ * matching \c "E-*".\n
+ * The filter is honored by the scanners: a rejected section is skipped
+ * to its \c ENDSEC at byte level, a rejected entity record is skipped
+ * with the raw record scanner (see \c dxf_read_skip_entity), and the
+ * layer of a candidate record is peeked from the mapping bytes before
+ * any field is tokenized — a query needing a small slice of a file
+ * pays a pattern scan instead of a full parse.\n
+ * Unset (NULL or zero) members filter nothing.
+ */
+typedef struct
+dxf_parse_filter
+{
+        const char *const *sections;
+                /*!< names of the sections to parse (e.g. "ENTITIES"),
+                 * or \c NULL to parse every section. */
+        size_t number_sections;
+                /*!< number of entries in \c sections. */
+        const char *const *types;
+                /*!< names of the entity types to parse (e.g. "LINE"),
+                 * or \c NULL to parse every type. */
+        size_t number_types;
+                /*!< number of entries in \c types. */
+        const char *layer_pattern;
+                /*!< pattern the group 8 layer of an entity has to
+                 * match, with \c * matching any run of characters and
+                 * \c ? any single one, or \c NULL to parse every
+                 * layer.\n
+                 * The layer is peeked from the record bytes, so this
+                 * member is honored on memory mapped inputs (see
+                 * \c dxf_read_mmap_init); on unmapped inputs every
+                 * layer is parsed. */
+} DxfParseFilter;
+
+
+/*!
+ * \brief Streaming callbacks for SAX style reading of the \c ENTITIES
+ * section.
+ *
+ * The parser keeps one scratch struct per entity type, reuses it for
+ * every occurrence and invokes the matching callback after each parsed
+ * entity, so memory stays O(1) regardless of the file size.\n
+ * The scratch struct and its strings are only valid for the duration
+ * of the callback; callbacks wanting to keep an entity have to copy
+ * it.\n
+ * A callback returns \c EXIT_SUCCESS to continue reading; any other
+ * value aborts the read, which allows early exits once a consumer has
+ * seen enough.\n
+ * Unset (NULL) callbacks simply skip the respective entity type.
+ */
+typedef struct
+dxf_read_handlers
+{
+        void *user_data;
+                /*!< passed through to every callback. */
+        int (*filter) (const char *entity_name, void *user_data);
+                /*!< invoked with the entity name before an entity is
+                 * parsed; return \c FALSE to skip the entity with the
+                 * raw record scanner without tokenizing its fields, or
+                 * \c TRUE to parse it.\n
+                 * \c NULL parses every entity type with a callback. */
+        const DxfParseFilter *parse_filter;
+                /*!< optional declarative filter (see
+                 * \c DxfParseFilter) restricting the parse by section,
+                 * entity type and layer; rejected records are skipped
+                 * at byte level, or \c NULL.\n
+                 * Owned by the caller. */
+        void (*progress) (uint64_t bytes_consumed, uint64_t bytes_total, void *user_data);
+                /*!< invoked about once per consumed megabyte with the
+                 * number of bytes consumed and the total file size
+                 * (see \c dxf_read_set_progress), so long parses of
+                 * very large files can be monitored, or \c NULL. */
+        DxfFile *passthrough;
+                /*!< when not \c NULL and the input is read from a
+                 * memory mapping (see \c dxf_read_mmap_init), entities
+                 * rejected by \c filter are not discarded but copied
+                 * verbatim, as raw bytes from the mapping, to this
+                 * output file.\n
+                 * Rewrite jobs touching few entities parse and
+                 * \c *_write only those and pass every other record
+                 * through without reserializing it. */
+        struct dxf_diag *diag;
+                /*!< optional deferred diagnostics buffer (see diag.h)
+                 * the per-record parser warnings are collected in
+                 * instead of being printed inline, or \c NULL.\n
+                 * Owned by the caller; inspected after the parse. */
+        struct dxf_entity_registry *registry;
+                /*!< optional registry of handlers for entity types
+                 * without a built-in reader (see entity_registry.h):
+                 * a registered name is parsed, skipped or raw-captured
+                 * as registered instead of reaching the \c unknown
+                 * handler, or \c NULL.\n
+                 * Owned by the caller. */
+        int trusted;
+                /*!< when nonzero, the input is trusted to be well
+                 * formed (see the \c trusted member of \c DxfFile):
+                 * per-field validation and default-repair are skipped
+                 * for throughput. */
+        int update;
+                /*!< when nonzero (with \c passthrough set and a
+                 * memory mapped input), every parsed entity is
+                 * re-emitted to the pass-through output: entities the
+                 * callback marked with \c dxf_entity_touch () are
+                 * reserialized with their \c *_write function, every
+                 * untouched record is copied through as raw bytes, so
+                 * an incremental rewrite only pays serialization for
+                 * what actually changed (see \c dxf_file_update). */
+        int (*arc) (DxfFile *fp, DxfArc *arc, void *user_data);
+                /*!< invoked after each parsed \c ARC entity. */
+        int (*circle) (DxfFile *fp, DxfCircle *circle, void *user_data);
+                /*!< invoked after each parsed \c CIRCLE entity. */
+        int (*ellipse) (DxfFile *fp, DxfEllipse *ellipse, void *user_data);
+                /*!< invoked after each parsed \c ELLIPSE entity. */
+        int (*face) (DxfFile *fp, Dxf3dface *face, void *user_data);
+                /*!< invoked after each parsed \c 3DFACE entity. */
+        int (*insert) (DxfFile *fp, DxfInsert *insert, void *user_data);
+                /*!< invoked after each parsed \c INSERT entity. */
+        int (*line) (DxfFile *fp, DxfLine *line, void *user_data);
+                /*!< invoked after each parsed \c LINE entity. */
+        int (*lwpolyline) (DxfFile *fp, DxfLWPolyline *lwpolyline, void *user_data);
+                /*!< invoked after each parsed \c LWPOLYLINE entity. */
+        int (*point) (DxfFile *fp, DxfPoint *point, void *user_data);
+                /*!< invoked after each parsed \c POINT entity. */
+        int (*polyline) (DxfFile *fp, DxfPolyline *polyline, void *user_data);
+                /*!< invoked after each parsed \c POLYLINE entity. */
+        int (*seqend) (DxfFile *fp, DxfSeqend *seqend, void *user_data);
+                /*!< invoked after each parsed \c SEQEND entity. */
+        int (*solid) (DxfFile *fp, DxfSolid *solid, void *user_data);
+                /*!< invoked after each parsed \c SOLID entity. */
+        int (*text) (DxfFile *fp, DxfText *text, void *user_data);
+                /*!< invoked after each parsed \c TEXT entity. */
+        int (*vertex) (DxfFile *fp, DxfVertex *vertex, void *user_data);
+                /*!< invoked after each parsed \c VERTEX entity. */
+        int (*unknown) (DxfFile *fp, const char *entity_name, void *user_data);
+                /*!< invoked for entity types without a specific
+                 * callback, before the entity is skipped. */
+} DxfReadHandlers;
+
+
+int
+dxf_entities_read
+(
+        DxfFile *fp
+);
+int
+dxf_entities_read_parallel
+(
+        DxfFile *fp,
+        int workers
+);
+void
+dxf_entities_set_affinity
+(
+        int enable
+);
+int
+dxf_parse_filter_section
+(
+        const DxfParseFilter *filter,
+        const char *name
+);
+int
+dxf_parse_filter_type
+(
+        const DxfParseFilter *filter,
+        const char *name
+);
+int
+dxf_parse_filter_layer
+(
+        const DxfParseFilter *filter,
+        const char *layer
+);
 int
 dxf_entities_read_table
 (
-       char *filename,
-       FILE *fp,
-       int line_number,
-       char *dxf_entities_list,
-       int acad_version_number
+        DxfFile *fp,
+        const DxfParseFilter *filter
 );
 int
 dxf_entities_write_table
@@ -73,6 +260,20 @@ dxf_entities_write_table
         char *dxf_entities_list,
         int acad_version_number
 );
+struct dxf_soa_lines;
+struct dxf_soa_points;
+struct dxf_soa_faces;
+int
+dxf_entities_write_batch
+(
+        DxfFile *fp,
+        struct dxf_soa_lines *lines,
+        DxfLine *line_prototype,
+        struct dxf_soa_points *points,
+        DxfPoint *point_prototype,
+        struct dxf_soa_faces *faces,
+        Dxf3dface *face_prototype
+);
 
 
 #endif /* LIBDXF_SRC_ENTITIES_H */
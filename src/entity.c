@@ -32,7 +32,152 @@
  */
 
 
+#include <pthread.h>
 #include "global.h"
+#include "entity.h"
+
+
+/*!
+ * The DXF names of the entity types.
+ */
+static const struct
+{
+        const char *name;
+        DxfEntityType type;
+} dxf_entity_type_name_table[] =
+{
+        {"3DFACE", FACE3D},
+        {"APPID", APPID},
+        {"ARC", ARC},
+        {"ATTDEF", ATTDEF},
+        {"ATTRIB", ATTRIB},
+        {"BLOCK", BLOCK},
+        {"CIRCLE", CIRCLE},
+        {"DIMENSION", DIMENSION},
+        {"DIMSTYLE", DIMSTYLE},
+        {"ELLIPSE", ELLIPSE},
+        {"INSERT", INSERT},
+        {"LAYER", LAYER},
+        {"LINE", LINE},
+        {"LTYPE", LTYPE},
+        {"LWPOLYLINE", LWPOLYLINE},
+        {"MTEXT", MTEXT},
+        {"POINT", POINT},
+        {"POLYLINE", POLYLINE},
+        {"SEQEND", SEQEND},
+        {"SHAPE", SHAPE},
+        {"SOLID", SOLID},
+        {"STYLE", STYLE},
+        {"TEXT", TEXT},
+        {"TRACE", TRACE},
+        {"UCS", UCS},
+        {"VERTEX", VERTEX},
+        {"VIEW", VIEW},
+        {"VPORT", VPORT},
+};
+
+#define DXF_ENTITY_TYPE_NAME_TABLE_LENGTH \
+        (sizeof (dxf_entity_type_name_table) / sizeof (dxf_entity_type_name_table[0]))
+
+/*!
+ * The hash index over \c dxf_entity_type_name_table; sized to a power
+ * of two above twice the entry count so the hash probes at most a few
+ * slots.  Built once on first use, under \c pthread_once so the
+ * parallel ENTITIES workers cannot race the build.
+ */
+#define DXF_ENTITY_TYPE_HASH_SIZE 64
+
+static short dxf_entity_type_hash_index[DXF_ENTITY_TYPE_HASH_SIZE];
+static pthread_once_t dxf_entity_type_hash_once = PTHREAD_ONCE_INIT;
+
+
+/*!
+ * \brief Hash an entity name (FNV-1a).
+ */
+static unsigned int
+dxf_entity_type_hash
+(
+        const char *name
+                /*!< the entity name. */
+)
+{
+        unsigned int hash;
+
+        hash = 2166136261u;
+        while (*name != '\0')
+        {
+                hash ^= (unsigned char) *name++;
+                hash *= 16777619u;
+        }
+        return (hash & (DXF_ENTITY_TYPE_HASH_SIZE - 1));
+}
+
+
+/*!
+ * \brief Build the hash index over the entity name table.
+ *
+ * Runs exactly once, via \c pthread_once.
+ */
+static void
+dxf_entity_type_hash_build (void)
+{
+        unsigned int slot;
+        int i;
+
+        for (slot = 0; slot < DXF_ENTITY_TYPE_HASH_SIZE; slot++)
+        {
+                dxf_entity_type_hash_index[slot] = -1;
+        }
+        for (i = 0; i < DXF_ENTITY_TYPE_NAME_TABLE_LENGTH; i++)
+        {
+                slot = dxf_entity_type_hash (dxf_entity_type_name_table[i].name);
+                while (dxf_entity_type_hash_index[slot] != -1)
+                {
+                        slot = (slot + 1) & (DXF_ENTITY_TYPE_HASH_SIZE - 1);
+                }
+                dxf_entity_type_hash_index[slot] = (short) i;
+        }
+}
+
+
+/*!
+ * \brief Resolve a DXF entity name to its \c DxfEntityType.
+ *
+ * The lookup goes through a hash index over the entity name table and
+ * runs in constant time; the per-record dispatch of
+ * \c dxf_entities_read goes through it instead of comparing against
+ * every known name.
+ *
+ * \return the entity type, or \c UNKNOWN_ENTITY when the name is not
+ * a known entity name.
+ */
+DxfEntityType
+dxf_entity_type_lookup
+(
+        const char *entity_name
+                /*!< the entity name as read from the DXF file. */
+)
+{
+        unsigned int slot;
+        int i;
+
+        if (entity_name == NULL)
+        {
+                return (UNKNOWN_ENTITY);
+        }
+        pthread_once (&dxf_entity_type_hash_once, dxf_entity_type_hash_build);
+        slot = dxf_entity_type_hash (entity_name);
+        while (dxf_entity_type_hash_index[slot] != -1)
+        {
+                i = dxf_entity_type_hash_index[slot];
+                if (strcmp (dxf_entity_type_name_table[i].name, entity_name) == 0)
+                {
+                        return (dxf_entity_type_name_table[i].type);
+                }
+                slot = (slot + 1) & (DXF_ENTITY_TYPE_HASH_SIZE - 1);
+        }
+        return (UNKNOWN_ENTITY);
+}
 
 
 /*!
@@ -71,4 +216,34 @@ dxf_entity_skip
 }
 
 
+/*!
+ * \brief Mark the entity a streaming callback was handed as modified.
+ *
+ * To be called from a callback after it changed the scratch entity;
+ * in update mode (see the \c update member of \c DxfReadHandlers)
+ * only touched entities are reserialized, every other record is
+ * copied through as raw bytes.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_entity_touch
+(
+        DxfFile *fp
+                /*!< DXF file pointer to an input file (or device). */
+)
+{
+        if (fp == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL file pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        fp->entity_dirty = TRUE;
+        return (EXIT_SUCCESS);
+}
+
+
 /* EOF */
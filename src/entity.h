@@ -36,6 +36,9 @@
 #define LIBDXF_SRC_ENTITY_H
 
 
+#include "global.h"
+
+
 /*!
  * \brief DXF entity types.
  */
@@ -64,15 +67,37 @@ dxf_entity_type
         TRACE,
         UCS,
         VIEW,
-        VPORT
+        VPORT,
+        /* Appended after the original table so existing stored values
+         * keep their meaning. */
+        DIMENSION,
+        ELLIPSE,
+        FACE3D,
+                /*!< a \c 3DFACE entity; the DXF name is no valid
+                 * identifier. */
+        LWPOLYLINE,
+        MTEXT,
+        SEQEND,
+        VERTEX
 } DxfEntityType;
 
 
+DxfEntityType
+dxf_entity_type_lookup
+(
+        const char *entity_name
+);
 int
 dxf_entity_skip
 (
         char *dxf_entity_name
 );
+struct dxf_file;
+int
+dxf_entity_touch
+(
+        struct dxf_file *fp
+);
 
 
 #endif /* LIBDXF_SRC_ENTITY_H */
@@ -0,0 +1,306 @@
+/*!
+ * \file entity_registry.c
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Functions for the registry of handlers for custom entity
+ * types.
+ *
+ * The entity dispatcher recognizes a fixed set of entity names and
+ * skips the rest, so vendor custom entities were lost on a
+ * read-and-rewrite pass.\n
+ * The registry maps an entity name to what its records deserve: a
+ * parse callback consuming the fields into a custom struct, a fast
+ * skip, or a raw capture handing the unparsed record bytes to the
+ * caller — for memory mapped input as a zero-copy range into the
+ * mapping, so unknown records round-trip at pass-through speed.\n
+ * The dispatcher consults the registry for every entity name it does
+ * not recognize itself (see \c dxf_entities_read).
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#include "entity_registry.h"
+#include "util.h"
+
+
+/*!
+ * \brief Allocate an empty entity registry.
+ *
+ * \return a pointer to the registry, or \c NULL when no memory was
+ * allocated.
+ */
+DxfEntityRegistry *
+dxf_entity_registry_new ()
+{
+        DxfEntityRegistry *registry;
+
+        registry = calloc (1, sizeof (DxfEntityRegistry));
+        if (registry == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        registry->index = dxf_symbol_table_new ();
+        if (registry->index == NULL)
+        {
+                free (registry);
+                return (NULL);
+        }
+        return (registry);
+}
+
+
+/*!
+ * \brief Register an entry under an entity name.
+ *
+ * A name can only be registered once; re-registering it is an error.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+static int
+dxf_entity_registry_add
+(
+        DxfEntityRegistry *registry,
+                /*!< the registry to add to. */
+        const char *name,
+                /*!< the entity name. */
+        DxfEntityRegistryMode mode,
+                /*!< what to do with records of this type. */
+        DxfEntityRegistryParser parse,
+                /*!< the parse callback, or \c NULL. */
+        DxfEntityRegistryCapture capture,
+                /*!< the capture callback, or \c NULL. */
+        void *user_data
+                /*!< passed through to the callback. */
+)
+{
+        DxfEntityRegistryEntry *entry;
+
+        if ((registry == NULL) || (name == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (dxf_symbol_table_find (registry->index, name) != NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () the entity name %s was already registered.\n")),
+                  __FUNCTION__, name);
+                return (EXIT_FAILURE);
+        }
+        entry = calloc (1, sizeof (DxfEntityRegistryEntry));
+        if (entry == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        entry->name = dxf_string_intern (name);
+        if (entry->name == NULL)
+        {
+                free (entry);
+                return (EXIT_FAILURE);
+        }
+        entry->mode = mode;
+        entry->parse = parse;
+        entry->capture = capture;
+        entry->user_data = user_data;
+        if (dxf_symbol_table_insert (registry->index, entry->name, entry) != EXIT_SUCCESS)
+        {
+                free (entry);
+                return (EXIT_FAILURE);
+        }
+        entry->next = registry->entries;
+        registry->entries = entry;
+        registry->length++;
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Register a parse callback for an entity name.
+ *
+ * Records of this type are handed to the callback with the reader
+ * positioned behind the entity name line; the callback consumes the
+ * fields and leaves the "  0" group code of the following record
+ * consumed, like the \c *_read functions do.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_entity_registry_add_parser
+(
+        DxfEntityRegistry *registry,
+                /*!< the registry to add to. */
+        const char *name,
+                /*!< the entity name. */
+        DxfEntityRegistryParser parse,
+                /*!< invoked for each record of this type. */
+        void *user_data
+                /*!< passed through to the callback. */
+)
+{
+        if (parse == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        return (dxf_entity_registry_add (registry, name,
+                DXF_ENTITY_REGISTRY_PARSE, parse, NULL, user_data));
+}
+
+
+/*!
+ * \brief Register an entity name for fast skipping.
+ *
+ * Records of this type are scanned to the next record boundary with
+ * the raw record scanner, without tokenizing the fields and without
+ * invoking the \c unknown handler.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_entity_registry_add_skip
+(
+        DxfEntityRegistry *registry,
+                /*!< the registry to add to. */
+        const char *name
+                /*!< the entity name. */
+)
+{
+        return (dxf_entity_registry_add (registry, name,
+                DXF_ENTITY_REGISTRY_SKIP, NULL, NULL, NULL));
+}
+
+
+/*!
+ * \brief Register a raw capture callback for an entity name.
+ *
+ * Records of this type are scanned as for skipping; for memory mapped
+ * input the callback then receives the raw record bytes as a
+ * zero-copy range into the mapping.\n
+ * For input which is not memory mapped no byte range exists and the
+ * record is skipped without invoking the callback.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_entity_registry_add_capture
+(
+        DxfEntityRegistry *registry,
+                /*!< the registry to add to. */
+        const char *name,
+                /*!< the entity name. */
+        DxfEntityRegistryCapture capture,
+                /*!< invoked with the raw bytes of each record of this
+                 * type. */
+        void *user_data
+                /*!< passed through to the callback. */
+)
+{
+        if (capture == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        return (dxf_entity_registry_add (registry, name,
+                DXF_ENTITY_REGISTRY_CAPTURE, NULL, capture, user_data));
+}
+
+
+/*!
+ * \brief Look an entity name up in a registry.
+ *
+ * \return the registered entry, or \c NULL when the name is not
+ * registered.
+ */
+DxfEntityRegistryEntry *
+dxf_entity_registry_find
+(
+        DxfEntityRegistry *registry,
+                /*!< the registry to search. */
+        const char *name
+                /*!< the entity name. */
+)
+{
+        if ((registry == NULL) || (name == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        return ((DxfEntityRegistryEntry *) dxf_symbol_table_find (registry->index, name));
+}
+
+
+/*!
+ * \brief Free an entity registry and its entries.
+ *
+ * The interned entity names stay in the interning pool.
+ */
+void
+dxf_entity_registry_free
+(
+        DxfEntityRegistry *registry
+                /*!< the registry to free, or \c NULL. */
+)
+{
+        DxfEntityRegistryEntry *entry;
+        DxfEntityRegistryEntry *next;
+
+        if (registry == NULL)
+        {
+                return;
+        }
+        entry = registry->entries;
+        while (entry != NULL)
+        {
+                next = entry->next;
+                free (entry);
+                entry = next;
+        }
+        dxf_symbol_table_free (registry->index);
+        free (registry);
+}
+
+
+/* EOF */
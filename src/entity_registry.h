@@ -0,0 +1,175 @@
+/*!
+ * \file entity_registry.h
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Header for the registry of handlers for custom entity types.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#ifndef LIBDXF_SRC_ENTITY_REGISTRY_H
+#define LIBDXF_SRC_ENTITY_REGISTRY_H
+
+
+#include "global.h"
+#include "symbol_table.h"
+
+
+/*!
+ * \brief What a registered handler does with the record of its entity
+ * type.
+ */
+typedef enum
+dxf_entity_registry_mode
+{
+        DXF_ENTITY_REGISTRY_PARSE = 0,
+                /*!< the \c parse callback consumes the fields of the
+                 * record itself, into a custom struct of the
+                 * caller. */
+        DXF_ENTITY_REGISTRY_SKIP,
+                /*!< the record is scanned to the next record boundary
+                 * without tokenizing the fields. */
+        DXF_ENTITY_REGISTRY_CAPTURE
+                /*!< the record is scanned as for skipping, and its raw
+                 * bytes are handed to the \c capture callback without
+                 * copying when the input is memory mapped. */
+} DxfEntityRegistryMode;
+
+
+/*!
+ * \brief Callback parsing a registered entity type.
+ *
+ * Invoked with the reader positioned behind the entity name line; the
+ * callback reads the fields of the record and, like the \c *_read
+ * functions, leaves the "  0" group code of the following record
+ * consumed.
+ */
+typedef int (*DxfEntityRegistryParser) (DxfFile *fp, const char *entity_name, void *user_data);
+
+
+/*!
+ * \brief Callback receiving the raw bytes of a registered entity
+ * type.
+ *
+ * The bytes start at the entity name line and end behind the last
+ * value line of the record, excluding the "  0" group code of the
+ * following record; they point into the memory mapping and stay valid
+ * for its lifetime.\n
+ * Prepending "  0\n" when writing them out reproduces the record
+ * verbatim (see \c dxf_entities_copy_record).
+ */
+typedef int (*DxfEntityRegistryCapture) (DxfFile *fp, const char *entity_name, const char *bytes, size_t size, void *user_data);
+
+
+/*!
+ * \brief One registered entity type.
+ */
+typedef struct
+dxf_entity_registry_entry
+{
+        char *name;
+                /*!< the entity name; interned, so entries of equal
+                 * names compare equal by pointer. */
+        DxfEntityRegistryMode mode;
+                /*!< what to do with records of this type. */
+        DxfEntityRegistryParser parse;
+                /*!< the parse callback, for
+                 * \c DXF_ENTITY_REGISTRY_PARSE entries; \c NULL
+                 * otherwise. */
+        DxfEntityRegistryCapture capture;
+                /*!< the capture callback, for
+                 * \c DXF_ENTITY_REGISTRY_CAPTURE entries; \c NULL
+                 * otherwise. */
+        void *user_data;
+                /*!< passed through to the callback. */
+        size_t matches;
+                /*!< number of records dispatched to this entry;
+                 * diagnostic only. */
+        struct dxf_entity_registry_entry *next;
+                /*!< the next entry of the registry. */
+} DxfEntityRegistryEntry;
+
+
+/*!
+ * \brief A registry of handlers for entity types without a built-in
+ * reader, keyed by entity name.
+ */
+typedef struct
+dxf_entity_registry
+{
+        DxfSymbolTable *index;
+                /*!< hash map from entity name to
+                 * \c DxfEntityRegistryEntry. */
+        DxfEntityRegistryEntry *entries;
+                /*!< the entries, most recently added first. */
+        size_t length;
+                /*!< number of entries in the registry. */
+} DxfEntityRegistry;
+
+
+DxfEntityRegistry *
+dxf_entity_registry_new ();
+int
+dxf_entity_registry_add_parser
+(
+        DxfEntityRegistry *registry,
+        const char *name,
+        DxfEntityRegistryParser parse,
+        void *user_data
+);
+int
+dxf_entity_registry_add_skip
+(
+        DxfEntityRegistry *registry,
+        const char *name
+);
+int
+dxf_entity_registry_add_capture
+(
+        DxfEntityRegistry *registry,
+        const char *name,
+        DxfEntityRegistryCapture capture,
+        void *user_data
+);
+DxfEntityRegistryEntry *
+dxf_entity_registry_find
+(
+        DxfEntityRegistry *registry,
+        const char *name
+);
+void
+dxf_entity_registry_free
+(
+        DxfEntityRegistry *registry
+);
+
+
+#endif /* LIBDXF_SRC_ENTITY_REGISTRY_H */
+
+
+/* EOF */
@@ -0,0 +1,590 @@
+/*!
+ * \file extents.c
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Functions for the drawing extents computation.
+ *
+ * Every plot and zoom-to-fit operation needs the drawing extents, and
+ * walking heap allocated entity structs per type in client code is
+ * the slowest possible way to get them.\n
+ * The kernels here reduce the packed structure-of-arrays coordinate
+ * stores (see soa.h) with tight min/max loops the compiler can
+ * vectorize, and \c dxf_drawing_extents runs the kernels over
+ * per-thread array slices with a partial box per thread, merged at
+ * the end, so large drawings reduce at memory bandwidth.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#include <pthread.h>
+#include <unistd.h>
+#include "extents.h"
+
+
+/*!
+ * Below this many stored entities \c dxf_drawing_extents reduces on
+ * the calling thread; spawning threads costs more than the loops.
+ */
+#define DXF_EXTENTS_PARALLEL_THRESHOLD 16384
+
+
+/*!
+ * \brief Initialize a bounding box to empty.
+ */
+void
+dxf_extents_init
+(
+        DxfExtents *extents
+                /*!< the bounding box to initialize. */
+)
+{
+        if (extents == NULL)
+        {
+                return;
+        }
+        extents->min_x = 0.0;
+        extents->min_y = 0.0;
+        extents->min_z = 0.0;
+        extents->max_x = 0.0;
+        extents->max_y = 0.0;
+        extents->max_z = 0.0;
+        extents->valid = FALSE;
+}
+
+
+/*!
+ * \brief Grow a bounding box by one coordinate.
+ */
+void
+dxf_extents_add
+(
+        DxfExtents *extents,
+                /*!< the bounding box to grow. */
+        double x,
+                /*!< the X-value. */
+        double y,
+                /*!< the Y-value. */
+        double z
+                /*!< the Z-value. */
+)
+{
+        if (extents == NULL)
+        {
+                return;
+        }
+        if (!extents->valid)
+        {
+                extents->min_x = x;
+                extents->min_y = y;
+                extents->min_z = z;
+                extents->max_x = x;
+                extents->max_y = y;
+                extents->max_z = z;
+                extents->valid = TRUE;
+                return;
+        }
+        extents->min_x = (x < extents->min_x) ? x : extents->min_x;
+        extents->min_y = (y < extents->min_y) ? y : extents->min_y;
+        extents->min_z = (z < extents->min_z) ? z : extents->min_z;
+        extents->max_x = (x > extents->max_x) ? x : extents->max_x;
+        extents->max_y = (y > extents->max_y) ? y : extents->max_y;
+        extents->max_z = (z > extents->max_z) ? z : extents->max_z;
+}
+
+
+/*!
+ * \brief Grow a bounding box by another bounding box.
+ */
+void
+dxf_extents_merge
+(
+        DxfExtents *extents,
+                /*!< the bounding box to grow. */
+        const DxfExtents *other
+                /*!< the bounding box to merge in. */
+)
+{
+        if ((extents == NULL) || (other == NULL) || (!other->valid))
+        {
+                return;
+        }
+        dxf_extents_add (extents, other->min_x, other->min_y, other->min_z);
+        dxf_extents_add (extents, other->max_x, other->max_y, other->max_z);
+}
+
+
+/*!
+ * \brief Reduce one packed coordinate array pair-free into running
+ * bounds.
+ *
+ * The central kernel: one pass over one \c double array, eight values
+ * per cache line, written so the compiler can vectorize it (see
+ * \c dxf_hatch_vertices_bbox for the same approach on hatch
+ * boundaries).
+ */
+static void
+dxf_extents_reduce_array
+(
+        const double *values,
+                /*!< the packed coordinate array. */
+        size_t start,
+                /*!< index of the first element to reduce. */
+        size_t length,
+                /*!< number of elements to reduce. */
+        double *lo,
+                /*!< running smallest value, updated. */
+        double *hi
+                /*!< running largest value, updated. */
+)
+{
+        double value_lo;
+        double value_hi;
+        size_t i;
+
+        value_lo = values[start];
+        value_hi = values[start];
+        for (i = start + 1; i < start + length; i++)
+        {
+                value_lo = (values[i] < value_lo) ? values[i] : value_lo;
+                value_hi = (values[i] > value_hi) ? values[i] : value_hi;
+        }
+        *lo = (value_lo < *lo) ? value_lo : *lo;
+        *hi = (value_hi > *hi) ? value_hi : *hi;
+}
+
+
+/*!
+ * \brief Reduce a set of packed coordinate arrays into a bounding
+ * box.
+ *
+ * Each triple of arrays holds the X, Y and Z values of one point per
+ * stored entity; \c NULL triples are skipped.
+ */
+static void
+dxf_extents_reduce_points
+(
+        const double **x,
+                /*!< the X-value arrays, \c NULL terminated. */
+        const double **y,
+                /*!< the Y-value arrays, parallel to \c x. */
+        const double **z,
+                /*!< the Z-value arrays, parallel to \c x. */
+        size_t start,
+                /*!< index of the first element to reduce. */
+        size_t length,
+                /*!< number of elements to reduce. */
+        DxfExtents *extents
+                /*!< the bounding box to grow. */
+)
+{
+        DxfExtents partial;
+        int i;
+
+        if (length < 1)
+        {
+                return;
+        }
+        partial.min_x = x[0][start];
+        partial.max_x = x[0][start];
+        partial.min_y = y[0][start];
+        partial.max_y = y[0][start];
+        partial.min_z = z[0][start];
+        partial.max_z = z[0][start];
+        partial.valid = TRUE;
+        for (i = 0; x[i] != NULL; i++)
+        {
+                dxf_extents_reduce_array (x[i], start, length,
+                        &partial.min_x, &partial.max_x);
+                dxf_extents_reduce_array (y[i], start, length,
+                        &partial.min_y, &partial.max_y);
+                dxf_extents_reduce_array (z[i], start, length,
+                        &partial.min_z, &partial.max_z);
+        }
+        dxf_extents_merge (extents, &partial);
+}
+
+
+/*!
+ * \brief Grow a bounding box by a slice of a \c LINE coordinate
+ * store.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_extents_soa_lines
+(
+        const DxfSoaLines *lines,
+                /*!< structure-of-arrays store of \c LINE coordinates. */
+        size_t start,
+                /*!< index of the first stored line of the slice. */
+        size_t length,
+                /*!< number of stored lines in the slice. */
+        DxfExtents *extents
+                /*!< the bounding box to grow. */
+)
+{
+        const double *x[3];
+        const double *y[3];
+        const double *z[3];
+
+        if ((lines == NULL) || (extents == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (start + length > lines->length)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () the slice exceeds the store.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        x[0] = lines->x0;
+        y[0] = lines->y0;
+        z[0] = lines->z0;
+        x[1] = lines->x1;
+        y[1] = lines->y1;
+        z[1] = lines->z1;
+        x[2] = NULL;
+        y[2] = NULL;
+        z[2] = NULL;
+        dxf_extents_reduce_points (x, y, z, start, length, extents);
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Grow a bounding box by a slice of a \c POINT coordinate
+ * store.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_extents_soa_points
+(
+        const DxfSoaPoints *points,
+                /*!< structure-of-arrays store of \c POINT coordinates. */
+        size_t start,
+                /*!< index of the first stored point of the slice. */
+        size_t length,
+                /*!< number of stored points in the slice. */
+        DxfExtents *extents
+                /*!< the bounding box to grow. */
+)
+{
+        const double *x[2];
+        const double *y[2];
+        const double *z[2];
+
+        if ((points == NULL) || (extents == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (start + length > points->length)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () the slice exceeds the store.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        x[0] = points->x0;
+        y[0] = points->y0;
+        z[0] = points->z0;
+        x[1] = NULL;
+        y[1] = NULL;
+        z[1] = NULL;
+        dxf_extents_reduce_points (x, y, z, start, length, extents);
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Grow a bounding box by a slice of a \c 3DFACE coordinate
+ * store.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_extents_soa_faces
+(
+        const DxfSoaFaces *faces,
+                /*!< structure-of-arrays store of \c 3DFACE coordinates. */
+        size_t start,
+                /*!< index of the first stored face of the slice. */
+        size_t length,
+                /*!< number of stored faces in the slice. */
+        DxfExtents *extents
+                /*!< the bounding box to grow. */
+)
+{
+        const double *x[5];
+        const double *y[5];
+        const double *z[5];
+
+        if ((faces == NULL) || (extents == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (start + length > faces->length)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () the slice exceeds the store.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        x[0] = faces->x0;
+        y[0] = faces->y0;
+        z[0] = faces->z0;
+        x[1] = faces->x1;
+        y[1] = faces->y1;
+        z[1] = faces->z1;
+        x[2] = faces->x2;
+        y[2] = faces->y2;
+        z[2] = faces->z2;
+        x[3] = faces->x3;
+        y[3] = faces->y3;
+        z[3] = faces->z3;
+        x[4] = NULL;
+        y[4] = NULL;
+        z[4] = NULL;
+        dxf_extents_reduce_points (x, y, z, start, length, extents);
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief One worker of \c dxf_drawing_extents: a slice of each store
+ * and a partial bounding box.
+ */
+typedef struct
+dxf_extents_worker
+{
+        const DxfSoaLines *lines;
+                /*!< store of \c LINE coordinates, or \c NULL. */
+        const DxfSoaPoints *points;
+                /*!< store of \c POINT coordinates, or \c NULL. */
+        const DxfSoaFaces *faces;
+                /*!< store of \c 3DFACE coordinates, or \c NULL. */
+        size_t lines_start;
+                /*!< first stored line of this worker's slice. */
+        size_t lines_length;
+                /*!< number of stored lines in this worker's slice. */
+        size_t points_start;
+                /*!< first stored point of this worker's slice. */
+        size_t points_length;
+                /*!< number of stored points in this worker's slice. */
+        size_t faces_start;
+                /*!< first stored face of this worker's slice. */
+        size_t faces_length;
+                /*!< number of stored faces in this worker's slice. */
+        DxfExtents partial;
+                /*!< this worker's partial bounding box. */
+        pthread_t thread;
+                /*!< the worker thread. */
+} DxfExtentsWorker;
+
+
+/*!
+ * \brief Reduce one worker's slices into its partial bounding box.
+ */
+static void *
+dxf_extents_worker_main
+(
+        void *arg
+                /*!< the \c DxfExtentsWorker to run. */
+)
+{
+        DxfExtentsWorker *worker;
+
+        worker = (DxfExtentsWorker *) arg;
+        dxf_extents_init (&worker->partial);
+        if ((worker->lines != NULL) && (worker->lines_length > 0))
+        {
+                dxf_extents_soa_lines (worker->lines, worker->lines_start,
+                        worker->lines_length, &worker->partial);
+        }
+        if ((worker->points != NULL) && (worker->points_length > 0))
+        {
+                dxf_extents_soa_points (worker->points, worker->points_start,
+                        worker->points_length, &worker->partial);
+        }
+        if ((worker->faces != NULL) && (worker->faces_length > 0))
+        {
+                dxf_extents_soa_faces (worker->faces, worker->faces_start,
+                        worker->faces_length, &worker->partial);
+        }
+        return (NULL);
+}
+
+
+/*!
+ * \brief Compute the extents of a drawing over its coordinate stores.
+ *
+ * Splits each store into one contiguous slice per worker, reduces the
+ * slices concurrently into per-thread partial boxes and merges the
+ * partials, so no thread ever writes a shared accumulator inside the
+ * hot loops.\n
+ * Small drawings (see \c DXF_EXTENTS_PARALLEL_THRESHOLD) reduce on
+ * the calling thread.\n
+ * Any of the stores may be \c NULL; an empty drawing yields a box
+ * with \c valid still \c FALSE.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_drawing_extents
+(
+        const DxfSoaLines *lines,
+                /*!< store of \c LINE coordinates, or \c NULL. */
+        const DxfSoaPoints *points,
+                /*!< store of \c POINT coordinates, or \c NULL. */
+        const DxfSoaFaces *faces,
+                /*!< store of \c 3DFACE coordinates, or \c NULL. */
+        int workers,
+                /*!< number of worker threads, or \c 0 for one per
+                 * available processor. */
+        DxfExtents *extents
+                /*!< returns the drawing extents. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        DxfExtentsWorker *pool;
+        size_t lines_length;
+        size_t points_length;
+        size_t faces_length;
+        size_t total;
+        int count;
+        int i;
+
+        /* Do some basic checks. */
+        if (extents == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        dxf_extents_init (extents);
+        lines_length = (lines != NULL) ? lines->length : 0;
+        points_length = (points != NULL) ? points->length : 0;
+        faces_length = (faces != NULL) ? faces->length : 0;
+        total = lines_length + points_length + faces_length;
+        if (total == 0)
+        {
+                return (EXIT_SUCCESS);
+        }
+        if (workers <= 0)
+        {
+                workers = (int) sysconf (_SC_NPROCESSORS_ONLN);
+        }
+        if (workers < 1)
+        {
+                workers = 1;
+        }
+        if ((workers == 1) || (total < DXF_EXTENTS_PARALLEL_THRESHOLD))
+        {
+                if (lines_length > 0)
+                {
+                        dxf_extents_soa_lines (lines, 0, lines_length, extents);
+                }
+                if (points_length > 0)
+                {
+                        dxf_extents_soa_points (points, 0, points_length, extents);
+                }
+                if (faces_length > 0)
+                {
+                        dxf_extents_soa_faces (faces, 0, faces_length, extents);
+                }
+                return (EXIT_SUCCESS);
+        }
+        pool = malloc ((size_t) workers * sizeof (DxfExtentsWorker));
+        if (pool == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        for (i = 0; i < workers; i++)
+        {
+                pool[i].lines = lines;
+                pool[i].points = points;
+                pool[i].faces = faces;
+                pool[i].lines_start = lines_length * (size_t) i / (size_t) workers;
+                pool[i].lines_length = lines_length * (size_t) (i + 1) / (size_t) workers
+                        - pool[i].lines_start;
+                pool[i].points_start = points_length * (size_t) i / (size_t) workers;
+                pool[i].points_length = points_length * (size_t) (i + 1) / (size_t) workers
+                        - pool[i].points_start;
+                pool[i].faces_start = faces_length * (size_t) i / (size_t) workers;
+                pool[i].faces_length = faces_length * (size_t) (i + 1) / (size_t) workers
+                        - pool[i].faces_start;
+        }
+        count = 0;
+        for (i = 0; i < workers; i++)
+        {
+                if (pthread_create (&pool[i].thread, NULL,
+                        dxf_extents_worker_main, &pool[i]) != 0)
+                {
+                        /* no thread: reduce in this one. */
+                        dxf_extents_worker_main (&pool[i]);
+                        pool[i].thread = pthread_self ();
+                }
+                count++;
+        }
+        for (i = 0; i < count; i++)
+        {
+                if (!pthread_equal (pool[i].thread, pthread_self ()))
+                {
+                        pthread_join (pool[i].thread, NULL);
+                }
+                dxf_extents_merge (extents, &pool[i].partial);
+        }
+        free (pool);
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (EXIT_SUCCESS);
+}
+
+
+/* EOF */
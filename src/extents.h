@@ -0,0 +1,82 @@
+/*!
+ * \file extents.h
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Header for the drawing extents computation.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#ifndef LIBDXF_SRC_EXTENTS_H
+#define LIBDXF_SRC_EXTENTS_H
+
+
+#include "global.h"
+#include "soa.h"
+
+
+/*!
+ * \brief An axis aligned bounding box over entity coordinates.
+ *
+ * The box is the running min/max over every coordinate added to it;
+ * \c valid stays \c FALSE until the first coordinate lands, so an
+ * empty drawing is distinguishable from one spanning zero area.
+ */
+typedef struct
+dxf_extents
+{
+        double min_x;
+                /*!< smallest X-value seen. */
+        double min_y;
+                /*!< smallest Y-value seen. */
+        double min_z;
+                /*!< smallest Z-value seen. */
+        double max_x;
+                /*!< largest X-value seen. */
+        double max_y;
+                /*!< largest Y-value seen. */
+        double max_z;
+                /*!< largest Z-value seen. */
+        int valid;
+                /*!< \c FALSE until a coordinate was added. */
+} DxfExtents;
+
+
+void dxf_extents_init (DxfExtents *extents);
+void dxf_extents_add (DxfExtents *extents, double x, double y, double z);
+void dxf_extents_merge (DxfExtents *extents, const DxfExtents *other);
+int dxf_extents_soa_lines (const DxfSoaLines *lines, size_t start, size_t length, DxfExtents *extents);
+int dxf_extents_soa_points (const DxfSoaPoints *points, size_t start, size_t length, DxfExtents *extents);
+int dxf_extents_soa_faces (const DxfSoaFaces *faces, size_t start, size_t length, DxfExtents *extents);
+int dxf_drawing_extents (const DxfSoaLines *lines, const DxfSoaPoints *points, const DxfSoaFaces *faces, int workers, DxfExtents *extents);
+
+
+#endif /* LIBDXF_SRC_EXTENTS_H */
+
+
+/* EOF */
@@ -0,0 +1,364 @@
+/*!
+ * \file feed.c
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Functions for the resumable push parser over chunked input.
+ *
+ * Ingestion over HTTP receives a DXF body in chunks, and the
+ * file-based readers forced the caller to buffer the complete body
+ * before the first record could be parsed.\n
+ * The feed inverts the control flow: the network loop pushes byte
+ * buffers as they arrive and pulls complete (group code, value)
+ * records back out; a record spanning a chunk boundary stays buffered
+ * until its bytes are in, everything before it is consumed and
+ * reclaimed, so parsing overlaps the transfer and time-to-first-entity
+ * drops from end-of-download to first-chunk.\n
+ * Records come out as \c DxfParserRecord, typed exactly as by the
+ * file-based pull parser (see \c dxf_parser_next).
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#include "feed.h"
+#include "util.h"
+
+
+/*!
+ * \brief Allocate an empty feed.
+ *
+ * \return a pointer to the feed, or \c NULL when no memory was
+ * allocated.
+ */
+DxfFeed *
+dxf_feed_new ()
+{
+        DxfFeed *feed;
+
+        feed = calloc (1, sizeof (DxfFeed));
+        if (feed == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+        }
+        return (feed);
+}
+
+
+/*!
+ * \brief Push a buffer of input bytes into a feed.
+ *
+ * The consumed prefix of the internal buffer is reclaimed first, so
+ * only the incomplete trailing record is retained between chunks.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_feed_push
+(
+        DxfFeed *feed,
+                /*!< the feed to push into. */
+        const char *data,
+                /*!< the arrived bytes. */
+        size_t size
+                /*!< number of arrived bytes. */
+)
+{
+        if ((feed == NULL) || ((data == NULL) && (size > 0)))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (feed->finished)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () the feed was already finished.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (feed->pos > 0)
+        {
+                memmove (feed->buffer, feed->buffer + feed->pos,
+                        feed->length - feed->pos);
+                feed->length -= feed->pos;
+                feed->base_offset += feed->pos;
+                feed->pos = 0;
+        }
+        if ((feed->length + size) > feed->capacity)
+        {
+                size_t new_capacity;
+                char *new_buffer;
+
+                new_capacity = (feed->capacity == 0) ? 4096 : feed->capacity;
+                while (new_capacity < (feed->length + size))
+                {
+                        new_capacity *= 2;
+                }
+                new_buffer = realloc (feed->buffer, new_capacity);
+                if (new_buffer == NULL)
+                {
+                        fprintf (stderr,
+                          (_("Error in %s () could not allocate memory.\n")),
+                          __FUNCTION__);
+                        return (EXIT_FAILURE);
+                }
+                feed->buffer = new_buffer;
+                feed->capacity = new_capacity;
+        }
+        memcpy (feed->buffer + feed->length, data, size);
+        feed->length += size;
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Mark the end of the input stream.
+ *
+ * After finishing, no more bytes may be pushed and a trailing line
+ * without a newline counts as complete, so the last record of a body
+ * which does not end in a newline still comes out.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_feed_finish
+(
+        DxfFeed *feed
+                /*!< the feed to finish. */
+)
+{
+        if (feed == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        feed->finished = TRUE;
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Locate the next line in the feed buffer without consuming
+ * it.
+ *
+ * \return \c TRUE when a complete line starts at \c from, with
+ * \c *start / \c *end delimiting its content and \c *next the first
+ * position after its terminator; \c FALSE when the bytes of the line
+ * have not fully arrived.
+ */
+static int
+dxf_feed_peek_line
+(
+        DxfFeed *feed,
+                /*!< the feed to peek into. */
+        size_t from,
+                /*!< position to scan from. */
+        size_t *start,
+                /*!< receives the position of the line content. */
+        size_t *end,
+                /*!< receives the position after the line content,
+                 * before the terminator. */
+        size_t *next
+                /*!< receives the position after the terminator. */
+)
+{
+        size_t at;
+
+        at = from;
+        while ((at < feed->length) && (feed->buffer[at] != '\n'))
+        {
+                at++;
+        }
+        if (at == feed->length)
+        {
+                if (!feed->finished || (from == feed->length))
+                {
+                        return (FALSE);
+                }
+                /* finished: the trailing unterminated line is
+                 * complete. */
+                *next = at;
+        }
+        else
+        {
+                *next = at + 1;
+        }
+        *start = from;
+        while ((*start < at)
+                && ((feed->buffer[*start] == ' ')
+                || (feed->buffer[*start] == '\t')))
+        {
+                (*start)++;
+        }
+        *end = at;
+        while ((*end > *start) && (feed->buffer[*end - 1] == '\r'))
+        {
+                (*end)--;
+        }
+        return (TRUE);
+}
+
+
+/*!
+ * \brief Pull the next complete group code record from a feed.
+ *
+ * The value string points into the feed's buffer and stays valid
+ * until the next push or pull; nothing is allocated per record.
+ *
+ * \return \c FOUND when a record was produced, \c SUCCESS when the
+ * record's bytes have not fully arrived yet (push more input), or
+ * \c FAIL at the end of the finished stream or when errors occurred.
+ */
+int
+dxf_feed_next
+(
+        DxfFeed *feed,
+                /*!< the feed to pull from. */
+        DxfParserRecord *record
+                /*!< receives the pulled record. */
+)
+{
+        size_t code_start;
+        size_t code_end;
+        size_t value_start;
+        size_t value_end;
+        size_t after;
+        uint64_t offset;
+
+        if ((feed == NULL) || (record == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (FAIL);
+        }
+        /* the group code line; blank lines between records are
+         * noise. */
+        for (;;)
+        {
+                if (!dxf_feed_peek_line (feed, feed->pos, &code_start,
+                        &code_end, &after))
+                {
+                        return (feed->finished ? FAIL : SUCCESS);
+                }
+                if (code_start != code_end)
+                {
+                        break;
+                }
+                feed->pos = after;
+                feed->line_number++;
+        }
+        offset = feed->base_offset + feed->pos;
+        /* the value line; blank means an empty string value and is
+         * kept. */
+        if (!dxf_feed_peek_line (feed, after, &value_start, &value_end,
+                &after))
+        {
+                return (feed->finished ? FAIL : SUCCESS);
+        }
+        if (value_end == feed->capacity)
+        {
+                /* trailing unterminated line of a finished stream: make
+                 * room for its terminator. */
+                char *new_buffer;
+
+                new_buffer = realloc (feed->buffer, feed->capacity + 1);
+                if (new_buffer == NULL)
+                {
+                        fprintf (stderr,
+                          (_("Error in %s () could not allocate memory.\n")),
+                          __FUNCTION__);
+                        return (FAIL);
+                }
+                feed->buffer = new_buffer;
+                feed->capacity++;
+        }
+        feed->buffer[code_end] = '\0';
+        feed->buffer[value_end] = '\0';
+        feed->pos = after;
+        feed->line_number += 2;
+        record->group_code = (int) dxf_parse_long (feed->buffer + code_start);
+        record->offset = offset;
+        record->line_number = feed->line_number - 1;
+        record->string_value = feed->buffer + value_start;
+        record->type = dxf_parser_value_type (record->group_code);
+        record->double_value = 0.0;
+        record->int_value = 0;
+        switch (record->type)
+        {
+                case DXF_FIELD_TYPE_DOUBLE:
+                {
+                        record->double_value = dxf_parse_double (record->string_value);
+                        break;
+                }
+                case DXF_FIELD_TYPE_INT:
+                case DXF_FIELD_TYPE_INT16:
+                {
+                        record->int_value = (int) dxf_parse_long (record->string_value);
+                        break;
+                }
+                case DXF_FIELD_TYPE_HEX:
+                {
+                        record->int_value = (int) strtol (record->string_value, NULL, 16);
+                        break;
+                }
+                default:
+                {
+                        break;
+                }
+        }
+        return (FOUND);
+}
+
+
+/*!
+ * \brief Free a feed.
+ */
+void
+dxf_feed_free
+(
+        DxfFeed *feed
+                /*!< the feed to free, or \c NULL. */
+)
+{
+        if (feed == NULL)
+        {
+                return;
+        }
+        free (feed->buffer);
+        free (feed);
+}
+
+
+/* EOF */
@@ -0,0 +1,105 @@
+/*!
+ * \file feed.h
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Header for the resumable push parser over chunked input.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#ifndef LIBDXF_SRC_FEED_H
+#define LIBDXF_SRC_FEED_H
+
+
+#include "global.h"
+#include "parser.h"
+
+
+/*!
+ * \brief A resumable parser fed with byte buffers as they arrive.
+ *
+ * Network ingestion receives a file in chunks; the feed buffers only
+ * the bytes of the incomplete trailing record, hands out every
+ * complete (group code, value) record as soon as its bytes are in,
+ * and reports wanting-more in between, so parsing overlaps the
+ * transfer instead of waiting for the end of the download.
+ */
+typedef struct
+dxf_feed
+{
+        char *buffer;
+                /*!< unconsumed input bytes. */
+        size_t length;
+                /*!< number of valid bytes in \c buffer. */
+        size_t capacity;
+                /*!< allocated size of \c buffer in bytes. */
+        size_t pos;
+                /*!< parse position within \c buffer. */
+        uint64_t base_offset;
+                /*!< byte offset of \c buffer[0] within the overall
+                 * stream. */
+        long line_number;
+                /*!< lines consumed from the stream so far. */
+        int finished;
+                /*!< \c TRUE after \c dxf_feed_finish: no more input
+                 * arrives and a trailing unterminated line counts as
+                 * complete. */
+} DxfFeed;
+
+
+DxfFeed *
+dxf_feed_new ();
+int
+dxf_feed_push
+(
+        DxfFeed *feed,
+        const char *data,
+        size_t size
+);
+int
+dxf_feed_finish
+(
+        DxfFeed *feed
+);
+int
+dxf_feed_next
+(
+        DxfFeed *feed,
+        DxfParserRecord *record
+);
+void
+dxf_feed_free
+(
+        DxfFeed *feed
+);
+
+
+#endif /* LIBDXF_SRC_FEED_H */
+
+
+/* EOF */
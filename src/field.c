@@ -0,0 +1,1207 @@
+/*!
+ * \file field.c
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Functions for the declarative field table parser framework.
+ *
+ * Every \c *_read function used to be a hand-rolled copy of the same
+ * strcmp loop.\n
+ * Here one shared, tuned parse loop consumes a per-entity static table
+ * which maps group codes to struct members, so a single hot loop serves
+ * every entity type instead of fifty cold copies.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#include "field.h"
+#include "arena.h"
+#include "field_generated.h"
+#include "diag.h"
+#include "profile.h"
+#include "util.h"
+
+
+/*!
+ * \brief Find the field spec for a group code in a field table.
+ *
+ * The table is sorted by ascending group code, so a binary search keeps
+ * the lookup O(log n) regardless of how many fields an entity has.
+ *
+ * \return a pointer to the matching spec, or \c NULL when the group
+ * code is not in the table.
+ */
+const DxfFieldSpec *
+dxf_field_find
+(
+        const DxfFieldSpec *table,
+                /*!< field table of the entity, sorted by group code. */
+        size_t length,
+                /*!< number of entries in the field table. */
+        int group_code
+                /*!< group code to look up. */
+)
+{
+        size_t low;
+        size_t high;
+        size_t mid;
+
+        low = 0;
+        high = length;
+        while (low < high)
+        {
+                mid = low + ((high - low) / 2);
+                if (table[mid].group_code < group_code)
+                {
+                        low = mid + 1;
+                }
+                else
+                {
+                        high = mid;
+                }
+        }
+        if ((low < length) && (table[low].group_code == group_code))
+        {
+                return (&table[low]);
+        }
+        return (NULL);
+}
+
+
+/*!
+ * \brief Convert a value string and store it into the entity member
+ * described by a field spec.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_field_apply
+(
+        DxfFile *fp,
+                /*!< DXF file pointer, consulted for an attached arena
+                 * when storing string members. */
+        const DxfFieldSpec *spec,
+                /*!< field spec describing the member. */
+        void *entity,
+                /*!< the entity struct to store into. */
+        const char *value
+                /*!< the value line as read from the file. */
+)
+{
+        char *member;
+
+        if ((spec == NULL) || (entity == NULL) || (value == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        member = ((char *) entity) + spec->offset;
+        switch (spec->type)
+        {
+                case DXF_FIELD_TYPE_DOUBLE:
+                {
+                        *((double *) member) = dxf_parse_double (value);
+                        break;
+                }
+                case DXF_FIELD_TYPE_INT:
+                {
+                        *((int *) member) = (int) dxf_parse_long (value);
+                        break;
+                }
+                case DXF_FIELD_TYPE_INT16:
+                {
+                        *((int16_t *) member) = (int16_t) dxf_parse_long (value);
+                        break;
+                }
+                case DXF_FIELD_TYPE_HEX:
+                {
+                        *((int *) member) = (int) strtol (value, NULL, 16);
+                        break;
+                }
+                case DXF_FIELD_TYPE_STRING:
+                {
+                        char **string_member;
+
+                        string_member = (char **) member;
+                        if ((fp != NULL) && (fp->intern_strings))
+                        {
+                                /* layer and linetype names repeat
+                                 * across entities: share one copy. */
+                                *string_member = dxf_string_intern (value);
+                        }
+                        else if ((fp != NULL) && (fp->arena != NULL))
+                        {
+                                /* the previous value is either arena
+                                 * allocated as well, or released with
+                                 * the rest of the graph. */
+                                *string_member = dxf_arena_strdup (fp->arena, value);
+                        }
+                        else
+                        {
+                                free (*string_member);
+                                DXF_PROFILE_COUNT (strdups);
+                                DXF_PROFILE_COUNT_ADD (strdup_bytes, strlen (value) + 1);
+                                *string_member = strdup (value);
+                        }
+                        break;
+                }
+                default:
+                {
+                        fprintf (stderr,
+                          (_("Error in %s () an unknown field type was passed.\n")),
+                          __FUNCTION__);
+                        return (EXIT_FAILURE);
+                }
+        }
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * Number of distinct field tables the group code histograms can
+ * hold.
+ */
+#define DXF_FIELD_STATS_TABLES 8
+
+/*!
+ * Highest group code the histograms record; DXF group codes do not
+ * exceed 1071.
+ */
+#define DXF_FIELD_STATS_MAX_CODE 1071
+
+
+/*!
+ * \brief Group code histogram of one field table.
+ */
+typedef struct
+dxf_field_stats_row
+{
+        const DxfFieldSpec *table;
+                /*!< the field table the row belongs to, or \c NULL
+                 * when the row is unused. */
+        unsigned long records;
+                /*!< number of entity records read through the
+                 * table. */
+        unsigned long counts[DXF_FIELD_STATS_MAX_CODE + 1];
+                /*!< occurrences per group code. */
+} DxfFieldStatsRow;
+
+
+/*!
+ * Group code instrumentation on/off toggle; off costs one predictable
+ * branch per record in the dispatch loops, so the counters can ship
+ * in regular builds and be switched on for a profiling run.
+ */
+static int dxf_field_stats_enabled = FALSE;
+
+
+static DxfFieldStatsRow dxf_field_stats[DXF_FIELD_STATS_TABLES];
+
+
+/*!
+ * \brief Claim the histogram counters of a field table for one
+ * record.
+ *
+ * Called once per entity record by the dispatch loops; counts the
+ * record and hands the per-code counters out.\n
+ * The counters are plain increments: profile on a single threaded
+ * run, or accept approximate figures.
+ *
+ * \return the counters of the table, or \c NULL when the
+ * instrumentation is off or the rows ran out.
+ */
+static unsigned long *
+dxf_field_stats_counts
+(
+        const DxfFieldSpec *table
+                /*!< the field table a record is read through. */
+)
+{
+        size_t i;
+
+        if (!dxf_field_stats_enabled)
+        {
+                return (NULL);
+        }
+        for (i = 0; i < DXF_FIELD_STATS_TABLES; i++)
+        {
+                if (dxf_field_stats[i].table == table)
+                {
+                        dxf_field_stats[i].records++;
+                        return (dxf_field_stats[i].counts);
+                }
+                if (dxf_field_stats[i].table == NULL)
+                {
+                        dxf_field_stats[i].table = table;
+                        dxf_field_stats[i].records++;
+                        return (dxf_field_stats[i].counts);
+                }
+        }
+        return (NULL);
+}
+
+
+/*!
+ * \brief Switch the group code instrumentation on or off.
+ *
+ * While enabled the dispatch loops record a group code frequency
+ * histogram per field table; \c dxf_field_stats_report() emits the
+ * figures in the profile format \c dxf_field_codegen_load_profile()
+ * reads back, so the generated appliers can be re-emitted with the
+ * measured corpus order (see field_codegen.c).
+ */
+void
+dxf_field_stats_enable
+(
+        int enabled
+                /*!< \c TRUE to record histograms, \c FALSE to stop. */
+)
+{
+        dxf_field_stats_enabled = enabled;
+}
+
+
+/*!
+ * \brief Reset the recorded group code histograms.
+ */
+void
+dxf_field_stats_reset ()
+{
+        memset (dxf_field_stats, 0, sizeof (dxf_field_stats));
+}
+
+
+/*!
+ * \brief Validation-free specialization of the shared parse loop for
+ * trusted inputs.
+ *
+ * Files from known, machine driven writers are guaranteed well
+ * formed, so this twin of \c dxf_field_read_all drops everything the
+ * generic loop spends on defending against hand edited files: no
+ * per-field NULL checks, no subclass marker verification, no
+ * unknown-tag diagnostics and no comment flushing — group codes
+ * outside the table are skipped without a second look.\n
+ * Selected once per record by the \c trusted flag of the file (see
+ * \c DxfFile), never per field.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+static int
+dxf_field_read_all_trusted
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an input file (or device). */
+        void *entity,
+                /*!< the entity struct to read into. */
+        const DxfFieldSpec *table,
+                /*!< field table of the entity, sorted by group code. */
+        size_t length,
+                /*!< number of entries in the field table. */
+        DxfFieldSpecialHandler special
+                /*!< per-entity hook for version dependent fields, or
+                 * \c NULL when the table covers everything. */
+)
+{
+        char *line;
+        char *value;
+        char *member;
+        const DxfFieldSpec *spec;
+        DxfFieldGeneratedApplier applier;
+        unsigned long *stats;
+        int group_code;
+
+        applier = dxf_field_generated_for (table);
+        stats = dxf_field_stats_counts (table);
+        for (;;)
+        {
+                line = dxf_read_line_grow (fp);
+                if (line == NULL)
+                {
+                        /* even trusted files can be truncated. */
+                        return (EXIT_FAILURE);
+                }
+                if (strcmp (line, "0") == 0)
+                {
+                        break;
+                }
+                group_code = dxf_read_group_code (line);
+                if ((stats != NULL) && (group_code >= 0)
+                        && (group_code <= DXF_FIELD_STATS_MAX_CODE))
+                {
+                        stats[group_code]++;
+                }
+                if ((special != NULL)
+                        && (special (fp, entity, group_code) == FOUND))
+                {
+                        continue;
+                }
+                if ((applier != NULL)
+                        && (applier (fp, entity, group_code) == FOUND))
+                {
+                        /* the generated specialization consumed the
+                         * field (see field_generated.h). */
+                        continue;
+                }
+                value = dxf_read_value_line_grow (fp);
+                if (value == NULL)
+                {
+                        return (EXIT_FAILURE);
+                }
+                spec = dxf_field_find (table, length, group_code);
+                if (spec == NULL)
+                {
+                        /* subclass markers, comments and codes the
+                         * entity does not store: skipped, not
+                         * diagnosed. */
+                        continue;
+                }
+                member = ((char *) entity) + spec->offset;
+                switch (spec->type)
+                {
+                        case DXF_FIELD_TYPE_DOUBLE:
+                        {
+                                *((double *) member) = strtod (value, NULL);
+                                break;
+                        }
+                        case DXF_FIELD_TYPE_INT:
+                        {
+                                *((int *) member) = (int) strtol (value, NULL, 10);
+                                break;
+                        }
+                        case DXF_FIELD_TYPE_INT16:
+                        {
+                                *((int16_t *) member) = (int16_t) strtol (value, NULL, 10);
+                                break;
+                        }
+                        case DXF_FIELD_TYPE_HEX:
+                        {
+                                *((int *) member) = (int) strtol (value, NULL, 16);
+                                break;
+                        }
+                        default: /* DXF_FIELD_TYPE_STRING */
+                        {
+                                char **string_member;
+
+                                string_member = (char **) member;
+                                if (fp->intern_strings)
+                                {
+                                        *string_member = dxf_string_intern (value);
+                                }
+                                else if (fp->arena != NULL)
+                                {
+                                        *string_member = dxf_arena_strdup (fp->arena, value);
+                                }
+                                else
+                                {
+                                        free (*string_member);
+                                        DXF_PROFILE_COUNT (strdups);
+                                        DXF_PROFILE_COUNT_ADD (strdup_bytes, strlen (value) + 1);
+                                        *string_member = strdup (value);
+                                }
+                                break;
+                        }
+                }
+        }
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Shared parse loop reading all fields of an entity through its
+ * field table.
+ *
+ * The last line read from file contained the entity name.\n
+ * Reads group code / value pairs and stores them into \c entity until
+ * a "0" group code announces the next entity, or the end of the
+ * section marker \c ENDSEC.\n
+ * Subclass markers (group code 100) are checked against the blank
+ * separated names in \c subclass_markers, comments (group code 999)
+ * are flushed to stdout, and \c special is given the first shot at
+ * every group code for fields which cannot be table driven.\n
+ * Files marked trusted (see the \c trusted member of \c DxfFile) are
+ * parsed by the validation-free twin \c dxf_field_read_all_trusted
+ * instead.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_field_read_all
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an input file (or device). */
+        void *entity,
+                /*!< the entity struct to read into. */
+        const DxfFieldSpec *table,
+                /*!< field table of the entity, sorted by group code. */
+        size_t length,
+                /*!< number of entries in the field table. */
+        const char *subclass_markers,
+                /*!< blank separated list of valid subclass marker
+                 * names, or \c NULL to skip the check. */
+        DxfFieldSpecialHandler special
+                /*!< per-entity hook for version dependent fields, or
+                 * \c NULL when the table covers everything. */
+)
+{
+        char *line;
+        char *value;
+        const DxfFieldSpec *spec;
+        DxfFieldGeneratedApplier applier;
+        unsigned long *stats;
+        int group_code;
+
+        if ((fp == NULL) || (entity == NULL) || (table == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (fp->trusted)
+        {
+                return (dxf_field_read_all_trusted (fp, entity, table,
+                        length, special));
+        }
+        applier = dxf_field_generated_for (table);
+        stats = dxf_field_stats_counts (table);
+        for (;;)
+        {
+                line = dxf_read_line_grow (fp);
+                if (line == NULL)
+                {
+                        fprintf (stderr,
+                          (_("Error in %s () while reading from: %s in line: %ld.\n")),
+                          __FUNCTION__, fp->filename, fp->line_number);
+                        return (EXIT_FAILURE);
+                }
+                if (strcmp (line, "0") == 0)
+                {
+                        break;
+                }
+                group_code = dxf_read_group_code (line);
+                if ((stats != NULL) && (group_code >= 0)
+                        && (group_code <= DXF_FIELD_STATS_MAX_CODE))
+                {
+                        stats[group_code]++;
+                }
+                if ((special != NULL)
+                        && (special (fp, entity, group_code) == FOUND))
+                {
+                        continue;
+                }
+                if ((applier != NULL)
+                        && (applier (fp, entity, group_code) == FOUND))
+                {
+                        /* the generated specialization consumed the
+                         * field (see field_generated.h). */
+                        continue;
+                }
+                spec = dxf_field_find (table, length, group_code);
+                if (spec != NULL)
+                {
+                        /* The value is referenced in place and only
+                         * copied when dxf_field_apply commits it; a
+                         * blank line is a valid empty string value. */
+                        value = dxf_read_value_line_grow (fp);
+                        if (value == NULL)
+                        {
+                                fprintf (stderr,
+                                  (_("Error in %s () while reading from: %s in line: %ld.\n")),
+                                  __FUNCTION__, fp->filename, fp->line_number);
+                                return (EXIT_FAILURE);
+                        }
+                        dxf_field_apply (fp, spec, entity, value);
+                        continue;
+                }
+                if (group_code == 100)
+                {
+                        /* Now follows a string containing the subclass
+                         * marker value. */
+                        value = dxf_read_value_line_grow (fp);
+                        if ((subclass_markers != NULL)
+                                && (value != NULL)
+                                && (strstr (subclass_markers, value) == NULL))
+                        {
+                                dxf_diag_report (fp, DXF_DIAG_WARNING,
+                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %ld.\n")),
+                                  __FUNCTION__, fp->filename, fp->line_number);
+                        }
+                }
+                else if (group_code == 999)
+                {
+                        /* Now follows a string containing a comment. */
+                        value = dxf_read_value_line_grow (fp);
+                        if (value != NULL)
+                        {
+                                fprintf (stdout, "DXF comment: %s\n", value);
+                        }
+                }
+                else
+                {
+                        dxf_diag_report (fp, DXF_DIAG_WARNING,
+                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %ld.\n")),
+                          __FUNCTION__, fp->filename, fp->line_number);
+                }
+        }
+        return (EXIT_SUCCESS);
+}
+
+
+/* The tables live with their entity (circle.c, line.c); sizes are
+ * exported alongside because the array lengths are not visible
+ * through an extern declaration. */
+extern const DxfFieldSpec dxf_circle_field_table[];
+extern const size_t dxf_circle_field_table_length;
+extern const DxfFieldSpec dxf_dimension_field_table[];
+extern const size_t dxf_dimension_field_table_length;
+extern const DxfFieldSpec dxf_line_field_table[];
+extern const size_t dxf_line_field_table_length;
+
+
+/*!
+ * \brief Registry of the per-entity field tables, sorted by entity
+ * type name.
+ */
+static DxfFieldTable dxf_field_tables[] =
+{
+        {"CIRCLE", dxf_circle_field_table, 0},
+        {"DIMENSION", dxf_dimension_field_table, 0},
+        {"LINE", dxf_line_field_table, 0}
+};
+
+
+/*!
+ * \brief Fill the registry lengths in on first use.
+ *
+ * The exported length constants are no constant expressions, so they
+ * cannot appear in the static initializer above.
+ */
+static void
+dxf_field_tables_init ()
+{
+        if (dxf_field_tables[0].length == 0)
+        {
+                dxf_field_tables[0].length = dxf_circle_field_table_length;
+                dxf_field_tables[1].length = dxf_dimension_field_table_length;
+                dxf_field_tables[2].length = dxf_line_field_table_length;
+        }
+}
+
+
+/*!
+ * \brief Look the reflection metadata of an entity type up by name.
+ *
+ * \return the field table of the entity type, or \c NULL when the
+ * type has no table (yet).
+ */
+const DxfFieldTable *
+dxf_field_table_get
+(
+        const char *entity_name
+                /*!< the DXF entity type name, e.g. "CIRCLE". */
+)
+{
+        size_t i;
+
+        if (entity_name == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        dxf_field_tables_init ();
+        for (i = 0; i < DXF_FIELD_TABLE_LENGTH (dxf_field_tables); i++)
+        {
+                if (strcmp (dxf_field_tables[i].entity_name, entity_name) == 0)
+                {
+                        return (&dxf_field_tables[i]);
+                }
+        }
+        return (NULL);
+}
+
+
+/*!
+ * \brief Get all registered field tables.
+ *
+ * \return a pointer to the registry, sorted by entity type name.
+ */
+const DxfFieldTable *
+dxf_field_table_list
+(
+        size_t *number_tables
+                /*!< receives the number of registered tables. */
+)
+{
+        dxf_field_tables_init ();
+        if (number_tables != NULL)
+        {
+                *number_tables = DXF_FIELD_TABLE_LENGTH (dxf_field_tables);
+        }
+        return (dxf_field_tables);
+}
+
+
+/*!
+ * \brief Name a field table by searching the registry.
+ *
+ * \return the entity type name of the table, or \c NULL when the
+ * table is not registered.
+ */
+static const char *
+dxf_field_stats_name
+(
+        const DxfFieldSpec *table
+                /*!< the field table to name. */
+)
+{
+        size_t i;
+
+        dxf_field_tables_init ();
+        for (i = 0; i < DXF_FIELD_TABLE_LENGTH (dxf_field_tables); i++)
+        {
+                if (dxf_field_tables[i].fields == table)
+                {
+                        return (dxf_field_tables[i].entity_name);
+                }
+        }
+        return (NULL);
+}
+
+
+/*!
+ * \brief Report the recorded group code histograms, hot first.
+ *
+ * Emits one \c "entity <name> <records>" line per field table,
+ * hottest entity type first, each followed by its \c "code <code>
+ * <count>" lines in descending count order — the profile format
+ * \c dxf_field_codegen_load_profile() reads to re-emit the generated
+ * appliers in measured corpus order.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_field_stats_report
+(
+        FILE *out
+                /*!< the stream to report to. */
+)
+{
+        const DxfFieldStatsRow *order[DXF_FIELD_STATS_TABLES];
+        const char *name;
+        size_t number_rows;
+        size_t i;
+        size_t j;
+        int code;
+
+        if (out == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        number_rows = 0;
+        for (i = 0; i < DXF_FIELD_STATS_TABLES; i++)
+        {
+                if (dxf_field_stats[i].table == NULL)
+                {
+                        continue;
+                }
+                order[number_rows] = &dxf_field_stats[i];
+                j = number_rows;
+                while ((j > 0)
+                        && (order[j - 1]->records < order[j]->records))
+                {
+                        const DxfFieldStatsRow *swap;
+
+                        swap = order[j - 1];
+                        order[j - 1] = order[j];
+                        order[j] = swap;
+                        j--;
+                }
+                number_rows++;
+        }
+        for (i = 0; i < number_rows; i++)
+        {
+                unsigned long counts[DXF_FIELD_STATS_MAX_CODE + 1];
+
+                name = dxf_field_stats_name (order[i]->table);
+                if (name == NULL)
+                {
+                        continue;
+                }
+                fprintf (out, "entity %s %lu\n", name, order[i]->records);
+                memcpy (counts, order[i]->counts, sizeof (counts));
+                for (;;)
+                {
+                        unsigned long best;
+
+                        /* selection over the sparse histogram: few
+                         * distinct codes occur, the array is mostly
+                         * zero. */
+                        best = 0;
+                        code = -1;
+                        for (j = 0; j <= DXF_FIELD_STATS_MAX_CODE; j++)
+                        {
+                                if (counts[j] > best)
+                                {
+                                        best = counts[j];
+                                        code = (int) j;
+                                }
+                        }
+                        if (code < 0)
+                        {
+                                break;
+                        }
+                        fprintf (out, "code %d %lu\n", code, best);
+                        counts[code] = 0;
+                }
+        }
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Scan the input for a set of group codes, skipping everything
+ * else at the tokenizer level.
+ *
+ * Column extractors wanting, say, group 10/20 of every entity do not
+ * have to materialize entities: every group whose code is in the set
+ * is handed to the visitor as its raw value string together with the
+ * name of the entity record it occurred in; all other fields are
+ * consumed without further processing.\n
+ * The scan runs from the current position to the end of the input; a
+ * visitor returning anything but \c EXIT_SUCCESS stops it early.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_field_extract
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an input file (or device). */
+        const int *group_codes,
+                /*!< the group codes to extract. */
+        size_t number_codes,
+                /*!< number of group codes in \c group_codes. */
+        int (*visit) (const char *entity_name, int group_code, const char *value, void *user_data),
+                /*!< invoked with every matching group. */
+        void *user_data
+                /*!< passed through to \c visit. */
+)
+{
+        char entity_name[DXF_MAX_STRING_LENGTH];
+        char *line;
+        char *value;
+        int group_code;
+        size_t i;
+
+        if ((fp == NULL) || (group_codes == NULL) || (visit == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        entity_name[0] = '\0';
+        for (;;)
+        {
+                line = dxf_read_line_grow (fp);
+                if (line == NULL)
+                {
+                        break;
+                }
+                group_code = atoi (line);
+                value = dxf_read_value_line_grow (fp);
+                if (value == NULL)
+                {
+                        break;
+                }
+                if (group_code == 0)
+                {
+                        strncpy (entity_name, value,
+                                DXF_MAX_STRING_LENGTH - 1);
+                        entity_name[DXF_MAX_STRING_LENGTH - 1] = '\0';
+                        continue;
+                }
+                for (i = 0; i < number_codes; i++)
+                {
+                        if (group_codes[i] != group_code)
+                        {
+                                continue;
+                        }
+                        if (visit (entity_name, group_code, value,
+                                user_data) != EXIT_SUCCESS)
+                        {
+                                return (EXIT_SUCCESS);
+                        }
+                        break;
+                }
+        }
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Duplicate an entity struct, driven by its field table.
+ *
+ * The struct is copied bitwise and every string field of the table is
+ * then deep copied, so the duplicate owns its strings and the
+ * type-specific \c *_free function applies to it.\n
+ * With an arena the struct is bump allocated instead and the strings
+ * stay shared with the source in copy-on-write fashion: a caller
+ * changing a string field assigns a fresh pointer and never frees the
+ * shared one, and the duplicates are released with the arena (see
+ * \c dxf_arena_free), not with the \c *_free function; replication
+ * loops producing hundreds of copies stay off \c malloc entirely.\n
+ * Fields outside the table — linkage pointers, substructures — are
+ * copied bitwise and are the caller's business; the typed \c *_dup
+ * wrappers take care of them.
+ *
+ * \return a pointer to the duplicate, or \c NULL when errors occurred.
+ */
+void *
+dxf_field_dup
+(
+        const void *entity,
+                /*!< the entity struct to duplicate. */
+        size_t size,
+                /*!< size of the entity struct in bytes. */
+        const DxfFieldSpec *table,
+                /*!< the field table of the entity type. */
+        size_t length,
+                /*!< number of entries in \c table. */
+        struct dxf_arena *arena
+                /*!< the arena to allocate from, or \c NULL to allocate
+                 * with \c malloc. */
+)
+{
+        void *copy;
+        size_t i;
+
+        if ((entity == NULL) || (table == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        copy = (arena != NULL) ? dxf_arena_alloc (arena, size) : malloc (size);
+        if (copy == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        memcpy (copy, entity, size);
+        if (arena != NULL)
+        {
+                /* the string fields stay shared with the source. */
+                return (copy);
+        }
+        for (i = 0; i < length; i++)
+        {
+                char **slot;
+
+                if (table[i].type != DXF_FIELD_TYPE_STRING)
+                {
+                        continue;
+                }
+                slot = (char **) ((char *) copy + table[i].offset);
+                if (*slot == NULL)
+                {
+                        continue;
+                }
+                *slot = strdup (*slot);
+                if (*slot == NULL)
+                {
+                        fprintf (stderr,
+                          (_("Error in %s () could not allocate memory.\n")),
+                          __FUNCTION__);
+                        return (NULL);
+                }
+        }
+        return (copy);
+}
+
+
+/*!
+ * \brief Locate the string field of a group code in an entity.
+ *
+ * \return the field slot, or \c NULL when errors occurred.
+ */
+static char **
+dxf_field_string_slot
+(
+        void *entity,
+                /*!< the entity struct. */
+        const DxfFieldSpec *table,
+                /*!< the field table of the entity type. */
+        size_t length,
+                /*!< number of entries in \c table. */
+        int group_code
+                /*!< the group code of the field. */
+)
+{
+        const DxfFieldSpec *spec;
+
+        if ((entity == NULL) || (table == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        spec = dxf_field_find (table, length, group_code);
+        if ((spec == NULL) || (spec->type != DXF_FIELD_TYPE_STRING))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () group code %d is no string field.\n")),
+                  __FUNCTION__, group_code);
+                return (NULL);
+        }
+        return ((char **) ((char *) entity + spec->offset));
+}
+
+
+/*!
+ * \brief Set a string field of an entity to a copy of a value.
+ *
+ * The field is located by its group code in the field table; the
+ * previous value is freed and replaced with a \c strdup of \c value.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_field_set_string
+(
+        void *entity,
+                /*!< the entity struct. */
+        const DxfFieldSpec *table,
+                /*!< the field table of the entity type. */
+        size_t length,
+                /*!< number of entries in \c table. */
+        int group_code,
+                /*!< the group code of the field. */
+        const char *value
+                /*!< the value to copy into the field. */
+)
+{
+        char *copy;
+
+        if (value == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        copy = strdup (value);
+        if (copy == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (dxf_field_take_string (entity, table, length, group_code,
+                copy) != EXIT_SUCCESS)
+        {
+                free (copy);
+                return (EXIT_FAILURE);
+        }
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Set a string field of an entity, taking ownership of the
+ * value.
+ *
+ * The transfer variant of \c dxf_field_set_string: the caller hands
+ * over a heap allocated buffer it no longer needs, the previous value
+ * is freed and the buffer is assigned without being copied.\n
+ * Bulk construction building millions of entities programmatically
+ * avoids a redundant \c strdup per string field this way.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_field_take_string
+(
+        void *entity,
+                /*!< the entity struct. */
+        const DxfFieldSpec *table,
+                /*!< the field table of the entity type. */
+        size_t length,
+                /*!< number of entries in \c table. */
+        int group_code,
+                /*!< the group code of the field. */
+        char *value
+                /*!< the heap allocated value to hand over; owned by
+                 * the entity afterwards. */
+)
+{
+        char **slot;
+
+        if (value == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        slot = dxf_field_string_slot (entity, table, length, group_code);
+        if (slot == NULL)
+        {
+                return (EXIT_FAILURE);
+        }
+        free (*slot);
+        *slot = value;
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Mix a run of bytes into a FNV-1a hash.
+ */
+static unsigned int
+dxf_field_hash_bytes
+(
+        unsigned int hash,
+                /*!< the running hash. */
+        const void *bytes,
+                /*!< the bytes to mix in. */
+        size_t length
+                /*!< number of bytes. */
+)
+{
+        const unsigned char *p;
+        size_t i;
+
+        p = (const unsigned char *) bytes;
+        for (i = 0; i < length; i++)
+        {
+                hash ^= p[i];
+                hash *= 16777619u;
+        }
+        return (hash);
+}
+
+
+/*!
+ * \brief Compute the canonical content hash of an entity over its
+ * field table.
+ *
+ * The hash covers the field values in table (group code) order
+ * straight from the struct members, at memory speed and without
+ * serializing the entity to text.\n
+ * Identity fields are skipped — the handle (hex id code) and the
+ * owner handles (group codes 330 and 360) — so two entities with the
+ * same geometry hash alike across revisions regardless of where they
+ * sit in the file.
+ *
+ * \return the content hash.
+ */
+unsigned int
+dxf_field_hash
+(
+        const void *entity,
+                /*!< the entity struct. */
+        const DxfFieldSpec *table,
+                /*!< the field table of the entity type. */
+        size_t length
+                /*!< number of entries in \c table. */
+)
+{
+        unsigned int hash;
+        const char *member;
+        const char *string;
+        size_t i;
+
+        hash = 2166136261u;
+        if ((entity == NULL) || (table == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (hash);
+        }
+        for (i = 0; i < length; i++)
+        {
+                if ((table[i].type == DXF_FIELD_TYPE_HEX)
+                        || (table[i].group_code == 330)
+                        || (table[i].group_code == 360))
+                {
+                        /* handles and owners identify, they are not
+                         * content. */
+                        continue;
+                }
+                member = ((const char *) entity) + table[i].offset;
+                switch (table[i].type)
+                {
+                        case DXF_FIELD_TYPE_DOUBLE:
+                                hash = dxf_field_hash_bytes (hash, member,
+                                        sizeof (double));
+                                break;
+                        case DXF_FIELD_TYPE_INT:
+                                hash = dxf_field_hash_bytes (hash, member,
+                                        sizeof (int));
+                                break;
+                        case DXF_FIELD_TYPE_INT16:
+                                hash = dxf_field_hash_bytes (hash, member,
+                                        sizeof (int16_t));
+                                break;
+                        case DXF_FIELD_TYPE_STRING:
+                                string = *((char * const *) member);
+                                if (string != NULL)
+                                {
+                                        hash = dxf_field_hash_bytes (hash,
+                                                string, strlen (string) + 1);
+                                }
+                                break;
+                        default:
+                                break;
+                }
+        }
+        return (hash);
+}
+
+
+/* EOF */
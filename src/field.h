@@ -0,0 +1,143 @@
+/*!
+ * \file field.h
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Header for the declarative field table parser framework.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#ifndef LIBDXF_SRC_FIELD_H
+#define LIBDXF_SRC_FIELD_H
+
+
+#include <stddef.h>
+#include "global.h"
+#include "util.h"
+
+
+/*!
+ * \brief Storage type of an entity struct member described by a
+ * \c DxfFieldSpec.
+ */
+typedef enum
+dxf_field_type
+{
+        DXF_FIELD_TYPE_DOUBLE,
+                /*!< a \c double member. */
+        DXF_FIELD_TYPE_INT,
+                /*!< an \c int member. */
+        DXF_FIELD_TYPE_INT16,
+                /*!< an \c int16_t member. */
+        DXF_FIELD_TYPE_HEX,
+                /*!< an \c int member holding a hexadecimal id code. */
+        DXF_FIELD_TYPE_STRING
+                /*!< a \c char* member, replaced by an allocated copy of
+                 * the value. */
+} DxfFieldType;
+
+
+/*!
+ * \brief One group code to struct member mapping of an entity field
+ * table.
+ *
+ * Entities describe their fields in a static array of these, sorted by
+ * ascending group code, and the shared parse loop in
+ * \c dxf_field_read_all consumes it.
+ */
+typedef struct
+dxf_field_spec
+{
+        int group_code;
+                /*!< DXF group code of the field. */
+        DxfFieldType type;
+                /*!< storage type of the struct member. */
+        size_t offset;
+                /*!< \c offsetof the member within the entity struct. */
+        const char *name;
+                /*!< name of the struct member, for generic tooling
+                 * (see \c dxf_field_table_get). */
+} DxfFieldSpec;
+
+
+/*!
+ * \brief Reflection metadata of one entity type.
+ *
+ * Generic tooling (converters, differs, column extractors) looks an
+ * entity type up by name and operates over its field table without
+ * per-type code.
+ */
+typedef struct
+dxf_field_table
+{
+        const char *entity_name;
+                /*!< the DXF entity type name, e.g. "CIRCLE". */
+        const DxfFieldSpec *fields;
+                /*!< the field table, sorted by ascending group code. */
+        size_t length;
+                /*!< number of entries in \c fields. */
+} DxfFieldTable;
+
+
+/*!
+ * \brief Per-entity hook for fields which need more than a plain
+ * group code to member mapping (version dependent or stateful fields).
+ *
+ * The handler shall consume the value line(s) of the group code itself
+ * and return \c FOUND when it handled the code, or \c FAIL to let the
+ * generic loop continue with the field table.
+ */
+typedef int (*DxfFieldSpecialHandler) (DxfFile *fp, void *entity, int group_code);
+
+
+/*!
+ * \brief Number of entries in a static field table.
+ */
+#define DXF_FIELD_TABLE_LENGTH(table) (sizeof (table) / sizeof ((table)[0]))
+
+
+const DxfFieldSpec *dxf_field_find (const DxfFieldSpec *table, size_t length, int group_code);
+int dxf_field_apply (DxfFile *fp, const DxfFieldSpec *spec, void *entity, const char *value);
+int dxf_field_read_all (DxfFile *fp, void *entity, const DxfFieldSpec *table, size_t length, const char *subclass_markers, DxfFieldSpecialHandler special);
+const DxfFieldTable *dxf_field_table_get (const char *entity_name);
+const DxfFieldTable *dxf_field_table_list (size_t *number_tables);
+int dxf_field_extract (DxfFile *fp, const int *group_codes, size_t number_codes, int (*visit) (const char *entity_name, int group_code, const char *value, void *user_data), void *user_data);
+struct dxf_arena;
+void *dxf_field_dup (const void *entity, size_t size, const DxfFieldSpec *table, size_t length, struct dxf_arena *arena);
+int dxf_field_set_string (void *entity, const DxfFieldSpec *table, size_t length, int group_code, const char *value);
+int dxf_field_take_string (void *entity, const DxfFieldSpec *table, size_t length, int group_code, char *value);
+unsigned int dxf_field_hash (const void *entity, const DxfFieldSpec *table, size_t length);
+void dxf_field_stats_enable (int enabled);
+void dxf_field_stats_reset ();
+int dxf_field_stats_report (FILE *out);
+
+
+#endif /* LIBDXF_SRC_FIELD_H */
+
+
+/* EOF */
@@ -0,0 +1,699 @@
+/*!
+ * \file field_codegen.c
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Generator emitting specialized field appliers from the field
+ * tables.
+ *
+ * The generic parse loop interprets a field table per group code:
+ * binary search for the spec, then a switch on the storage type.\n
+ * For the handful of entity types making up nearly all bytes of big
+ * files that indirection is worth removing: the generator walks the
+ * registered field tables (see \c dxf_field_table_list) and emits one
+ * fully unrolled applier function per table — the group code
+ * comparisons ordered by empirical frequency of the codes in typical
+ * drawings, every store with its offset and conversion inlined — into
+ * \c field_generated.c.\n
+ * The output is checked in and rebuilt with the \c field-generated
+ * make target after a table changes; the interpreted loop stays the
+ * fallback for every table without a generated applier.\n
+ * The built-in frequency list can be replaced by a measured corpus
+ * profile (see \c dxf_field_stats_report in field.c and
+ * \c dxf_field_codegen_load_profile below): the comparisons then
+ * follow the recorded per-type group code order and the appliers of
+ * the hottest entity types are emitted first, keeping them contiguous
+ * in the text section.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#include <ctype.h>
+#include "field_codegen.h"
+#include "field.h"
+
+
+/*!
+ * Group codes ordered by their empirical frequency in typical
+ * drawings: coordinates dominate, then the common bulge/rotation and
+ * layout groups, then the per-entity housekeeping.
+ */
+static const int dxf_field_codegen_frequency[] =
+{
+        10, 20, 30, 11, 21, 31, 12, 22, 32, 13, 23, 33,
+        40, 41, 42, 50, 51, 52, 53, 8, 62, 6, 70, 71, 72,
+        39, 48, 60, 67, 5, 38, 330, 360
+};
+
+#define DXF_FIELD_CODEGEN_FREQUENCY_LENGTH \
+        (sizeof (dxf_field_codegen_frequency) / sizeof (dxf_field_codegen_frequency[0]))
+
+
+/*!
+ * Number of registered field tables the generator can emit.
+ */
+#define DXF_FIELD_CODEGEN_MAX_TABLES 32
+
+/*!
+ * Number of entity types a loaded corpus profile can hold.
+ */
+#define DXF_FIELD_CODEGEN_MAX_PROFILE 8
+
+/*!
+ * Number of group codes per entity type a loaded corpus profile can
+ * hold.
+ */
+#define DXF_FIELD_CODEGEN_MAX_CODES 64
+
+
+/*!
+ * \brief Measured figures of one entity type, as recorded by
+ * \c dxf_field_stats_report().
+ */
+typedef struct
+dxf_field_codegen_profile_row
+{
+        char entity_name[24];
+                /*!< the DXF entity type name. */
+        unsigned long records;
+                /*!< number of records of the type in the corpus. */
+        int codes[DXF_FIELD_CODEGEN_MAX_CODES];
+                /*!< the group codes of the type, hottest first. */
+        size_t number_codes;
+                /*!< number of used entries in \c codes. */
+} DxfFieldCodegenProfileRow;
+
+
+static DxfFieldCodegenProfileRow dxf_field_codegen_profile[DXF_FIELD_CODEGEN_MAX_PROFILE];
+
+
+static size_t dxf_field_codegen_profile_length = 0;
+
+
+/*!
+ * \brief Look the profile row of an entity type up.
+ *
+ * \return the row, or \c NULL when no profile was loaded or the type
+ * was not profiled.
+ */
+static const DxfFieldCodegenProfileRow *
+dxf_field_codegen_profile_row
+(
+        const char *entity_name
+                /*!< the DXF entity type name. */
+)
+{
+        size_t i;
+
+        for (i = 0; i < dxf_field_codegen_profile_length; i++)
+        {
+                if (strcmp (dxf_field_codegen_profile[i].entity_name, entity_name) == 0)
+                {
+                        return (&dxf_field_codegen_profile[i]);
+                }
+        }
+        return (NULL);
+}
+
+
+/*!
+ * \brief Load a corpus profile as written by
+ * \c dxf_field_stats_report().
+ *
+ * A loaded profile replaces the built-in frequency list: the emitted
+ * group code comparisons follow the measured per-type order and the
+ * appliers of the hottest entity types are emitted first, so they
+ * end up contiguous in the text section.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_field_codegen_load_profile
+(
+        FILE *in
+                /*!< the stream to read the profile from. */
+)
+{
+        char keyword[8];
+        char name[24];
+        unsigned long count;
+        int code;
+        DxfFieldCodegenProfileRow *row;
+
+        if (in == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        row = NULL;
+        while (fscanf (in, "%7s", keyword) == 1)
+        {
+                if (strcmp (keyword, "entity") == 0)
+                {
+                        if (fscanf (in, "%23s %lu", name, &count) != 2)
+                        {
+                                fprintf (stderr,
+                                  (_("Error in %s () a malformed profile was passed.\n")),
+                                  __FUNCTION__);
+                                return (EXIT_FAILURE);
+                        }
+                        if (dxf_field_codegen_profile_length == DXF_FIELD_CODEGEN_MAX_PROFILE)
+                        {
+                                /* cold types beyond the capacity fall
+                                 * back to the built-in order. */
+                                row = NULL;
+                                continue;
+                        }
+                        row = &dxf_field_codegen_profile[dxf_field_codegen_profile_length];
+                        dxf_field_codegen_profile_length++;
+                        strcpy (row->entity_name, name);
+                        row->records = count;
+                        row->number_codes = 0;
+                }
+                else if (strcmp (keyword, "code") == 0)
+                {
+                        if (fscanf (in, "%d %lu", &code, &count) != 2)
+                        {
+                                fprintf (stderr,
+                                  (_("Error in %s () a malformed profile was passed.\n")),
+                                  __FUNCTION__);
+                                return (EXIT_FAILURE);
+                        }
+                        if ((row != NULL)
+                                && (row->number_codes < DXF_FIELD_CODEGEN_MAX_CODES))
+                        {
+                                row->codes[row->number_codes] = code;
+                                row->number_codes++;
+                        }
+                }
+                else
+                {
+                        fprintf (stderr,
+                          (_("Error in %s () a malformed profile was passed.\n")),
+                          __FUNCTION__);
+                        return (EXIT_FAILURE);
+                }
+        }
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Frequency rank of a group code; unranked codes sort behind
+ * the ranked ones in group code order.
+ *
+ * With a profile row the measured order of the entity type ranks
+ * first and the built-in list only breaks ties among codes the
+ * corpus never showed.
+ */
+static int
+dxf_field_codegen_rank
+(
+        const DxfFieldCodegenProfileRow *profile,
+                /*!< the profile row of the entity type, or \c NULL to
+                 * rank by the built-in list alone. */
+        int group_code
+                /*!< the group code to rank. */
+)
+{
+        size_t i;
+
+        if (profile != NULL)
+        {
+                for (i = 0; i < profile->number_codes; i++)
+                {
+                        if (profile->codes[i] == group_code)
+                        {
+                                return ((int) i);
+                        }
+                }
+                return (DXF_FIELD_CODEGEN_MAX_CODES
+                        + dxf_field_codegen_rank (NULL, group_code));
+        }
+        for (i = 0; i < DXF_FIELD_CODEGEN_FREQUENCY_LENGTH; i++)
+        {
+                if (dxf_field_codegen_frequency[i] == group_code)
+                {
+                        return ((int) i);
+                }
+        }
+        return ((int) DXF_FIELD_CODEGEN_FREQUENCY_LENGTH + group_code);
+}
+
+
+/*!
+ * \brief Emit the store statement of one field spec.
+ */
+static void
+dxf_field_codegen_emit_store
+(
+        FILE *out,
+                /*!< the stream to emit to. */
+        const char *type_name,
+                /*!< the C type name of the entity struct. */
+        const DxfFieldSpec *spec
+                /*!< the field spec to store. */
+)
+{
+        switch (spec->type)
+        {
+                case DXF_FIELD_TYPE_DOUBLE:
+                {
+                        fprintf (out,
+                          "                *((double *) ((char *) entity + offsetof (%s, %s))) = dxf_parse_double (value);\n",
+                          type_name, spec->name);
+                        break;
+                }
+                case DXF_FIELD_TYPE_INT:
+                {
+                        fprintf (out,
+                          "                *((int *) ((char *) entity + offsetof (%s, %s))) = (int) dxf_parse_long (value);\n",
+                          type_name, spec->name);
+                        break;
+                }
+                case DXF_FIELD_TYPE_INT16:
+                {
+                        fprintf (out,
+                          "                *((int16_t *) ((char *) entity + offsetof (%s, %s))) = (int16_t) dxf_parse_long (value);\n",
+                          type_name, spec->name);
+                        break;
+                }
+                case DXF_FIELD_TYPE_HEX:
+                {
+                        fprintf (out,
+                          "                *((int *) ((char *) entity + offsetof (%s, %s))) = (int) strtol (value, NULL, 16);\n",
+                          type_name, spec->name);
+                        break;
+                }
+                default: /* DXF_FIELD_TYPE_STRING */
+                {
+                        fprintf (out,
+                          "                dxf_field_generated_store_string (fp, (char **) ((char *) entity + offsetof (%s, %s)), value);\n",
+                          type_name, spec->name);
+                        break;
+                }
+        }
+}
+
+
+/*!
+ * \brief Emit the applier function of one field table.
+ */
+static void
+dxf_field_codegen_emit_applier
+(
+        FILE *out,
+                /*!< the stream to emit to. */
+        const DxfFieldTable *table,
+                /*!< the field table to specialize. */
+        const char *lower_name,
+                /*!< the entity name in lower case. */
+        const char *type_name
+                /*!< the C type name of the entity struct. */
+)
+{
+        const DxfFieldCodegenProfileRow *profile;
+        const DxfFieldSpec *order[64];
+        size_t i;
+        size_t j;
+
+        /* sort the specs by frequency rank. */
+        profile = dxf_field_codegen_profile_row (table->entity_name);
+        for (i = 0; (i < table->length) && (i < 64); i++)
+        {
+                order[i] = &table->fields[i];
+        }
+        for (i = 1; (i < table->length) && (i < 64); i++)
+        {
+                const DxfFieldSpec *spec;
+
+                spec = order[i];
+                j = i;
+                while ((j > 0) && (dxf_field_codegen_rank (profile, order[j - 1]->group_code)
+                        > dxf_field_codegen_rank (profile, spec->group_code)))
+                {
+                        order[j] = order[j - 1];
+                        j--;
+                }
+                order[j] = spec;
+        }
+        fprintf (out,
+          "/*!\n"
+          " * \\brief Generated applier for the \\c %s field table.\n"
+          " */\n"
+          "int\n"
+          "dxf_field_apply_%s_generated\n"
+          "(\n"
+          "        DxfFile *fp,\n"
+          "        void *entity,\n"
+          "        int group_code\n"
+          ")\n"
+          "{\n"
+          "        const char *value;\n"
+          "\n"
+          "        switch (group_code)\n"
+          "        {\n",
+          table->entity_name, lower_name);
+        for (i = 0; (i < table->length) && (i < 64); i++)
+        {
+                fprintf (out, "                case %d:\n",
+                        table->fields[i].group_code);
+        }
+        fprintf (out,
+          "                {\n"
+          "                        break;\n"
+          "                }\n"
+          "                default:\n"
+          "                {\n"
+          "                        return (FAIL);\n"
+          "                }\n"
+          "        }\n"
+          "        value = dxf_read_value_line_grow (fp);\n"
+          "        if (value == NULL)\n"
+          "        {\n"
+          "                return (FAIL);\n"
+          "        }\n");
+        for (i = 0; (i < table->length) && (i < 64); i++)
+        {
+                fprintf (out, "        %s (group_code == %d)\n        {\n",
+                        (i == 0) ? "if" : "else if",
+                        order[i]->group_code);
+                dxf_field_codegen_emit_store (out, type_name, order[i]);
+                fprintf (out, "        }\n");
+        }
+        fprintf (out,
+          "        return (FOUND);\n"
+          "}\n"
+          "\n"
+          "\n");
+}
+
+
+/*!
+ * \brief Emit \c field_generated.c from the registered field tables.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_field_codegen_emit
+(
+        FILE *out
+                /*!< the stream to emit to. */
+)
+{
+        const DxfFieldTable *tables;
+        const DxfFieldTable *ordered[DXF_FIELD_CODEGEN_MAX_TABLES];
+        size_t number_tables;
+        size_t i;
+        size_t j;
+
+        if (out == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        tables = dxf_field_table_list (&number_tables);
+        if (tables == NULL)
+        {
+                return (EXIT_FAILURE);
+        }
+        if (number_tables > DXF_FIELD_CODEGEN_MAX_TABLES)
+        {
+                number_tables = DXF_FIELD_CODEGEN_MAX_TABLES;
+        }
+        /* hottest entity types first, so their appliers end up
+         * contiguous; unprofiled tables keep the registry order
+         * behind the profiled ones. */
+        for (i = 0; i < number_tables; i++)
+        {
+                const DxfFieldTable *table;
+
+                table = &tables[i];
+                j = i;
+                while (j > 0)
+                {
+                        const DxfFieldCodegenProfileRow *previous;
+                        const DxfFieldCodegenProfileRow *row;
+                        unsigned long previous_records;
+                        unsigned long records;
+
+                        previous = dxf_field_codegen_profile_row (ordered[j - 1]->entity_name);
+                        row = dxf_field_codegen_profile_row (table->entity_name);
+                        previous_records = (previous != NULL) ? previous->records : 0;
+                        records = (row != NULL) ? row->records : 0;
+                        if (previous_records >= records)
+                        {
+                                break;
+                        }
+                        ordered[j] = ordered[j - 1];
+                        j--;
+                }
+                ordered[j] = table;
+        }
+        fprintf (out,
+          "/*!\n"
+          " * \\file field_generated.c\n"
+          " *\n"
+          " * \\brief Specialized field appliers, generated from the field\n"
+          " * tables.\n"
+          " *\n"
+          " * Generated by \\c dxf_field_codegen_emit (see field_codegen.c);\n"
+          " * regenerate with the \\c field-generated make target after a\n"
+          " * field table changes.  Do not edit.\n"
+          " */\n"
+          "\n"
+          "\n"
+          "#include <stddef.h>\n"
+          "#include \"field_generated.h\"\n");
+        for (i = 0; i < number_tables; i++)
+        {
+                char lower_name[64];
+
+                for (j = 0; (ordered[i]->entity_name[j] != '\0') && (j < 63); j++)
+                {
+                        lower_name[j] = (char) tolower ((unsigned char) ordered[i]->entity_name[j]);
+                }
+                lower_name[j] = '\0';
+                fprintf (out, "#include \"%s.h\"\n", lower_name);
+        }
+        fprintf (out,
+          "#include \"arena.h\"\n"
+          "#include \"util.h\"\n"
+          "\n"
+          "\n"
+          "/*!\n"
+          " * \\brief Store a string value into a field slot, honouring the\n"
+          " * interning and arena modes of the file.\n"
+          " */\n"
+          "static void\n"
+          "dxf_field_generated_store_string\n"
+          "(\n"
+          "        DxfFile *fp,\n"
+          "        char **slot,\n"
+          "        const char *value\n"
+          ")\n"
+          "{\n"
+          "        if (fp->intern_strings)\n"
+          "        {\n"
+          "                *slot = dxf_string_intern (value);\n"
+          "        }\n"
+          "        else if (fp->arena != NULL)\n"
+          "        {\n"
+          "                *slot = dxf_arena_strdup (fp->arena, value);\n"
+          "        }\n"
+          "        else\n"
+          "        {\n"
+          "                free (*slot);\n"
+          "                *slot = strdup (value);\n"
+          "        }\n"
+          "}\n"
+          "\n"
+          "\n");
+        for (i = 0; i < number_tables; i++)
+        {
+                char lower_name[64];
+                char type_name[68];
+
+                for (j = 0; (ordered[i]->entity_name[j] != '\0') && (j < 63); j++)
+                {
+                        lower_name[j] = (char) tolower ((unsigned char) ordered[i]->entity_name[j]);
+                }
+                lower_name[j] = '\0';
+                strcpy (type_name, "Dxf");
+                type_name[3] = (char) toupper ((unsigned char) lower_name[0]);
+                strcpy (type_name + 4, lower_name + 1);
+                dxf_field_codegen_emit_applier (out, ordered[i], lower_name,
+                        type_name);
+        }
+        for (i = 0; i < number_tables; i++)
+        {
+                char lower_name[64];
+
+                for (j = 0; (ordered[i]->entity_name[j] != '\0') && (j < 63); j++)
+                {
+                        lower_name[j] = (char) tolower ((unsigned char) ordered[i]->entity_name[j]);
+                }
+                lower_name[j] = '\0';
+                fprintf (out,
+                  "extern const DxfFieldSpec dxf_%s_field_table[];\n",
+                  lower_name);
+        }
+        fprintf (out,
+          "\n"
+          "\n"
+          "/*!\n"
+          " * The generated appliers, keyed by entity name and field table.\n"
+          " */\n"
+          "static const struct\n"
+          "{\n"
+          "        const char *entity_name;\n"
+          "        const DxfFieldSpec *fields;\n"
+          "        DxfFieldGeneratedApplier apply;\n"
+          "} dxf_field_generated_entries[] =\n"
+          "{\n");
+        for (i = 0; i < number_tables; i++)
+        {
+                char lower_name[64];
+
+                for (j = 0; (ordered[i]->entity_name[j] != '\0') && (j < 63); j++)
+                {
+                        lower_name[j] = (char) tolower ((unsigned char) ordered[i]->entity_name[j]);
+                }
+                lower_name[j] = '\0';
+                fprintf (out,
+                  "        {\"%s\", dxf_%s_field_table, dxf_field_apply_%s_generated},\n",
+                  ordered[i]->entity_name, lower_name, lower_name);
+        }
+        fprintf (out,
+          "};\n"
+          "\n"
+          "#define DXF_FIELD_GENERATED_LENGTH \\\n"
+          "        (sizeof (dxf_field_generated_entries) / sizeof (dxf_field_generated_entries[0]))\n"
+          "\n"
+          "\n"
+          "/*!\n"
+          " * \\brief Look the generated applier of an entity name up.\n"
+          " *\n"
+          " * \\return the applier, or \\c NULL when no applier was generated\n"
+          " * for the name.\n"
+          " */\n"
+          "DxfFieldGeneratedApplier\n"
+          "dxf_field_generated_find\n"
+          "(\n"
+          "        const char *entity_name\n"
+          ")\n"
+          "{\n"
+          "        size_t i;\n"
+          "\n"
+          "        for (i = 0; i < DXF_FIELD_GENERATED_LENGTH; i++)\n"
+          "        {\n"
+          "                if (strcmp (dxf_field_generated_entries[i].entity_name, entity_name) == 0)\n"
+          "                {\n"
+          "                        return (dxf_field_generated_entries[i].apply);\n"
+          "                }\n"
+          "        }\n"
+          "        return (NULL);\n"
+          "}\n"
+          "\n"
+          "\n"
+          "/*!\n"
+          " * \\brief Look the generated applier of a field table up.\n"
+          " *\n"
+          " * \\return the applier, or \\c NULL when no applier was generated\n"
+          " * for the table.\n"
+          " */\n"
+          "DxfFieldGeneratedApplier\n"
+          "dxf_field_generated_for\n"
+          "(\n"
+          "        const DxfFieldSpec *table\n"
+          ")\n"
+          "{\n"
+          "        size_t i;\n"
+          "\n"
+          "        for (i = 0; i < DXF_FIELD_GENERATED_LENGTH; i++)\n"
+          "        {\n"
+          "                if (dxf_field_generated_entries[i].fields == table)\n"
+          "                {\n"
+          "                        return (dxf_field_generated_entries[i].apply);\n"
+          "                }\n"
+          "        }\n"
+          "        return (NULL);\n"
+          "}\n"
+          "\n"
+          "\n"
+          "/* EOF */\n");
+        return (EXIT_SUCCESS);
+}
+
+
+#ifdef DXF_FIELD_CODEGEN_MAIN
+/*!
+ * \brief Driver for the \c field-generated make target.
+ *
+ * An optional argument names a corpus profile written by
+ * \c dxf_field_stats_report(); without one the built-in frequency
+ * list orders the emitted comparisons.
+ */
+int
+main
+(
+        int argc,
+        char *argv[]
+)
+{
+        if (argc > 1)
+        {
+                FILE *in;
+
+                in = fopen (argv[1], "r");
+                if (in == NULL)
+                {
+                        fprintf (stderr,
+                          (_("Error in %s () could not open file: %s.\n")),
+                          __FUNCTION__, argv[1]);
+                        return (1);
+                }
+                if (dxf_field_codegen_load_profile (in) == EXIT_FAILURE)
+                {
+                        fclose (in);
+                        return (1);
+                }
+                fclose (in);
+        }
+        return ((dxf_field_codegen_emit (stdout) == EXIT_SUCCESS)
+                ? 0 : 1);
+}
+#endif /* DXF_FIELD_CODEGEN_MAIN */
+
+
+/* EOF */
@@ -0,0 +1,560 @@
+/*!
+ * \file field_generated.c
+ *
+ * \brief Specialized field appliers, generated from the field
+ * tables.
+ *
+ * Generated by \c dxf_field_codegen_emit (see field_codegen.c);
+ * regenerate with the \c field-generated make target after a
+ * field table changes.  Do not edit.
+ */
+
+
+#include <stddef.h>
+#include "field_generated.h"
+#include "circle.h"
+#include "dimension.h"
+#include "line.h"
+#include "arena.h"
+#include "util.h"
+
+
+/*!
+ * \brief Store a string value into a field slot, honouring the
+ * interning and arena modes of the file.
+ */
+static void
+dxf_field_generated_store_string
+(
+        DxfFile *fp,
+        char **slot,
+        const char *value
+)
+{
+        if (fp->intern_strings)
+        {
+                *slot = dxf_string_intern (value);
+        }
+        else if (fp->arena != NULL)
+        {
+                *slot = dxf_arena_strdup (fp->arena, value);
+        }
+        else
+        {
+                free (*slot);
+                *slot = strdup (value);
+        }
+}
+
+
+/*!
+ * \brief Generated applier for the \c CIRCLE field table.
+ */
+int
+dxf_field_apply_circle_generated
+(
+        DxfFile *fp,
+        void *entity,
+        int group_code
+)
+{
+        const char *value;
+
+        switch (group_code)
+        {
+                case 5:
+                case 6:
+                case 8:
+                case 10:
+                case 20:
+                case 30:
+                case 39:
+                case 40:
+                case 48:
+                case 60:
+                case 62:
+                case 67:
+                case 210:
+                case 220:
+                case 230:
+                case 330:
+                case 360:
+                {
+                        break;
+                }
+                default:
+                {
+                        return (FAIL);
+                }
+        }
+        value = dxf_read_value_line_grow (fp);
+        if (value == NULL)
+        {
+                return (FAIL);
+        }
+        if (group_code == 10)
+        {
+                *((double *) ((char *) entity + offsetof (DxfCircle, x0))) = dxf_parse_double (value);
+        }
+        else if (group_code == 20)
+        {
+                *((double *) ((char *) entity + offsetof (DxfCircle, y0))) = dxf_parse_double (value);
+        }
+        else if (group_code == 30)
+        {
+                *((double *) ((char *) entity + offsetof (DxfCircle, z0))) = dxf_parse_double (value);
+        }
+        else if (group_code == 40)
+        {
+                *((double *) ((char *) entity + offsetof (DxfCircle, radius))) = dxf_parse_double (value);
+        }
+        else if (group_code == 8)
+        {
+                dxf_field_generated_store_string (fp, (char **) ((char *) entity + offsetof (DxfCircle, layer)), value);
+        }
+        else if (group_code == 62)
+        {
+                *((int *) ((char *) entity + offsetof (DxfCircle, color))) = (int) dxf_parse_long (value);
+        }
+        else if (group_code == 6)
+        {
+                dxf_field_generated_store_string (fp, (char **) ((char *) entity + offsetof (DxfCircle, linetype)), value);
+        }
+        else if (group_code == 39)
+        {
+                *((double *) ((char *) entity + offsetof (DxfCircle, thickness))) = dxf_parse_double (value);
+        }
+        else if (group_code == 48)
+        {
+                *((double *) ((char *) entity + offsetof (DxfCircle, linetype_scale))) = dxf_parse_double (value);
+        }
+        else if (group_code == 60)
+        {
+                *((int16_t *) ((char *) entity + offsetof (DxfCircle, visibility))) = (int16_t) dxf_parse_long (value);
+        }
+        else if (group_code == 67)
+        {
+                *((int *) ((char *) entity + offsetof (DxfCircle, paperspace))) = (int) dxf_parse_long (value);
+        }
+        else if (group_code == 5)
+        {
+                *((int *) ((char *) entity + offsetof (DxfCircle, id_code))) = (int) strtol (value, NULL, 16);
+        }
+        else if (group_code == 330)
+        {
+                dxf_field_generated_store_string (fp, (char **) ((char *) entity + offsetof (DxfCircle, dictionary_owner_soft)), value);
+        }
+        else if (group_code == 360)
+        {
+                dxf_field_generated_store_string (fp, (char **) ((char *) entity + offsetof (DxfCircle, dictionary_owner_hard)), value);
+        }
+        else if (group_code == 210)
+        {
+                *((double *) ((char *) entity + offsetof (DxfCircle, extr_x0))) = dxf_parse_double (value);
+        }
+        else if (group_code == 220)
+        {
+                *((double *) ((char *) entity + offsetof (DxfCircle, extr_y0))) = dxf_parse_double (value);
+        }
+        else if (group_code == 230)
+        {
+                *((double *) ((char *) entity + offsetof (DxfCircle, extr_z0))) = dxf_parse_double (value);
+        }
+        return (FOUND);
+}
+
+
+/*!
+ * \brief Generated applier for the \c DIMENSION field table.
+ */
+int
+dxf_field_apply_dimension_generated
+(
+        DxfFile *fp,
+        void *entity,
+        int group_code
+)
+{
+        const char *value;
+
+        switch (group_code)
+        {
+                case 1:
+                case 2:
+                case 3:
+                case 5:
+                case 6:
+                case 8:
+                case 10:
+                case 11:
+                case 12:
+                case 20:
+                case 21:
+                case 22:
+                case 30:
+                case 31:
+                case 32:
+                case 39:
+                case 41:
+                case 42:
+                case 48:
+                case 51:
+                case 53:
+                case 60:
+                case 62:
+                case 67:
+                case 70:
+                case 71:
+                case 72:
+                case 210:
+                case 220:
+                case 230:
+                case 330:
+                case 360:
+                {
+                        break;
+                }
+                default:
+                {
+                        return (FAIL);
+                }
+        }
+        value = dxf_read_value_line_grow (fp);
+        if (value == NULL)
+        {
+                return (FAIL);
+        }
+        if (group_code == 10)
+        {
+                *((double *) ((char *) entity + offsetof (DxfDimension, x0))) = dxf_parse_double (value);
+        }
+        else if (group_code == 20)
+        {
+                *((double *) ((char *) entity + offsetof (DxfDimension, y0))) = dxf_parse_double (value);
+        }
+        else if (group_code == 30)
+        {
+                *((double *) ((char *) entity + offsetof (DxfDimension, z0))) = dxf_parse_double (value);
+        }
+        else if (group_code == 11)
+        {
+                *((double *) ((char *) entity + offsetof (DxfDimension, x1))) = dxf_parse_double (value);
+        }
+        else if (group_code == 21)
+        {
+                *((double *) ((char *) entity + offsetof (DxfDimension, y1))) = dxf_parse_double (value);
+        }
+        else if (group_code == 31)
+        {
+                *((double *) ((char *) entity + offsetof (DxfDimension, z1))) = dxf_parse_double (value);
+        }
+        else if (group_code == 12)
+        {
+                *((double *) ((char *) entity + offsetof (DxfDimension, x2))) = dxf_parse_double (value);
+        }
+        else if (group_code == 22)
+        {
+                *((double *) ((char *) entity + offsetof (DxfDimension, y2))) = dxf_parse_double (value);
+        }
+        else if (group_code == 32)
+        {
+                *((double *) ((char *) entity + offsetof (DxfDimension, z2))) = dxf_parse_double (value);
+        }
+        else if (group_code == 41)
+        {
+                *((double *) ((char *) entity + offsetof (DxfDimension, text_line_spacing_factor))) = dxf_parse_double (value);
+        }
+        else if (group_code == 42)
+        {
+                *((double *) ((char *) entity + offsetof (DxfDimension, actual_measurement))) = dxf_parse_double (value);
+        }
+        else if (group_code == 51)
+        {
+                *((double *) ((char *) entity + offsetof (DxfDimension, hor_dir))) = dxf_parse_double (value);
+        }
+        else if (group_code == 53)
+        {
+                *((double *) ((char *) entity + offsetof (DxfDimension, text_angle))) = dxf_parse_double (value);
+        }
+        else if (group_code == 8)
+        {
+                dxf_field_generated_store_string (fp, (char **) ((char *) entity + offsetof (DxfDimension, layer)), value);
+        }
+        else if (group_code == 62)
+        {
+                *((int *) ((char *) entity + offsetof (DxfDimension, color))) = (int) dxf_parse_long (value);
+        }
+        else if (group_code == 6)
+        {
+                dxf_field_generated_store_string (fp, (char **) ((char *) entity + offsetof (DxfDimension, linetype)), value);
+        }
+        else if (group_code == 70)
+        {
+                *((int *) ((char *) entity + offsetof (DxfDimension, flag))) = (int) dxf_parse_long (value);
+        }
+        else if (group_code == 71)
+        {
+                *((int *) ((char *) entity + offsetof (DxfDimension, attachment_point))) = (int) dxf_parse_long (value);
+        }
+        else if (group_code == 72)
+        {
+                *((int *) ((char *) entity + offsetof (DxfDimension, text_line_spacing))) = (int) dxf_parse_long (value);
+        }
+        else if (group_code == 39)
+        {
+                *((double *) ((char *) entity + offsetof (DxfDimension, thickness))) = dxf_parse_double (value);
+        }
+        else if (group_code == 48)
+        {
+                *((double *) ((char *) entity + offsetof (DxfDimension, linetype_scale))) = dxf_parse_double (value);
+        }
+        else if (group_code == 60)
+        {
+                *((int16_t *) ((char *) entity + offsetof (DxfDimension, visibility))) = (int16_t) dxf_parse_long (value);
+        }
+        else if (group_code == 67)
+        {
+                *((int *) ((char *) entity + offsetof (DxfDimension, paperspace))) = (int) dxf_parse_long (value);
+        }
+        else if (group_code == 5)
+        {
+                *((int *) ((char *) entity + offsetof (DxfDimension, id_code))) = (int) strtol (value, NULL, 16);
+        }
+        else if (group_code == 330)
+        {
+                dxf_field_generated_store_string (fp, (char **) ((char *) entity + offsetof (DxfDimension, dictionary_owner_soft)), value);
+        }
+        else if (group_code == 360)
+        {
+                dxf_field_generated_store_string (fp, (char **) ((char *) entity + offsetof (DxfDimension, dictionary_owner_hard)), value);
+        }
+        else if (group_code == 1)
+        {
+                dxf_field_generated_store_string (fp, (char **) ((char *) entity + offsetof (DxfDimension, dim_text)), value);
+        }
+        else if (group_code == 2)
+        {
+                dxf_field_generated_store_string (fp, (char **) ((char *) entity + offsetof (DxfDimension, dimblock_name)), value);
+        }
+        else if (group_code == 3)
+        {
+                dxf_field_generated_store_string (fp, (char **) ((char *) entity + offsetof (DxfDimension, dimstyle_name)), value);
+        }
+        else if (group_code == 210)
+        {
+                *((double *) ((char *) entity + offsetof (DxfDimension, extr_x0))) = dxf_parse_double (value);
+        }
+        else if (group_code == 220)
+        {
+                *((double *) ((char *) entity + offsetof (DxfDimension, extr_y0))) = dxf_parse_double (value);
+        }
+        else if (group_code == 230)
+        {
+                *((double *) ((char *) entity + offsetof (DxfDimension, extr_z0))) = dxf_parse_double (value);
+        }
+        return (FOUND);
+}
+
+
+/*!
+ * \brief Generated applier for the \c LINE field table.
+ */
+int
+dxf_field_apply_line_generated
+(
+        DxfFile *fp,
+        void *entity,
+        int group_code
+)
+{
+        const char *value;
+
+        switch (group_code)
+        {
+                case 5:
+                case 6:
+                case 8:
+                case 10:
+                case 11:
+                case 20:
+                case 21:
+                case 30:
+                case 31:
+                case 39:
+                case 48:
+                case 60:
+                case 62:
+                case 67:
+                case 210:
+                case 220:
+                case 230:
+                case 330:
+                case 360:
+                {
+                        break;
+                }
+                default:
+                {
+                        return (FAIL);
+                }
+        }
+        value = dxf_read_value_line_grow (fp);
+        if (value == NULL)
+        {
+                return (FAIL);
+        }
+        if (group_code == 10)
+        {
+                *((double *) ((char *) entity + offsetof (DxfLine, x0))) = dxf_parse_double (value);
+        }
+        else if (group_code == 20)
+        {
+                *((double *) ((char *) entity + offsetof (DxfLine, y0))) = dxf_parse_double (value);
+        }
+        else if (group_code == 30)
+        {
+                *((double *) ((char *) entity + offsetof (DxfLine, z0))) = dxf_parse_double (value);
+        }
+        else if (group_code == 11)
+        {
+                *((double *) ((char *) entity + offsetof (DxfLine, x1))) = dxf_parse_double (value);
+        }
+        else if (group_code == 21)
+        {
+                *((double *) ((char *) entity + offsetof (DxfLine, y1))) = dxf_parse_double (value);
+        }
+        else if (group_code == 31)
+        {
+                *((double *) ((char *) entity + offsetof (DxfLine, z1))) = dxf_parse_double (value);
+        }
+        else if (group_code == 8)
+        {
+                dxf_field_generated_store_string (fp, (char **) ((char *) entity + offsetof (DxfLine, layer)), value);
+        }
+        else if (group_code == 62)
+        {
+                *((int *) ((char *) entity + offsetof (DxfLine, color))) = (int) dxf_parse_long (value);
+        }
+        else if (group_code == 6)
+        {
+                dxf_field_generated_store_string (fp, (char **) ((char *) entity + offsetof (DxfLine, linetype)), value);
+        }
+        else if (group_code == 39)
+        {
+                *((double *) ((char *) entity + offsetof (DxfLine, thickness))) = dxf_parse_double (value);
+        }
+        else if (group_code == 48)
+        {
+                *((double *) ((char *) entity + offsetof (DxfLine, linetype_scale))) = dxf_parse_double (value);
+        }
+        else if (group_code == 60)
+        {
+                *((int16_t *) ((char *) entity + offsetof (DxfLine, visibility))) = (int16_t) dxf_parse_long (value);
+        }
+        else if (group_code == 67)
+        {
+                *((int *) ((char *) entity + offsetof (DxfLine, paperspace))) = (int) dxf_parse_long (value);
+        }
+        else if (group_code == 5)
+        {
+                *((int *) ((char *) entity + offsetof (DxfLine, id_code))) = (int) strtol (value, NULL, 16);
+        }
+        else if (group_code == 330)
+        {
+                dxf_field_generated_store_string (fp, (char **) ((char *) entity + offsetof (DxfLine, dictionary_owner_soft)), value);
+        }
+        else if (group_code == 360)
+        {
+                dxf_field_generated_store_string (fp, (char **) ((char *) entity + offsetof (DxfLine, dictionary_owner_hard)), value);
+        }
+        else if (group_code == 210)
+        {
+                *((double *) ((char *) entity + offsetof (DxfLine, extr_x0))) = dxf_parse_double (value);
+        }
+        else if (group_code == 220)
+        {
+                *((double *) ((char *) entity + offsetof (DxfLine, extr_y0))) = dxf_parse_double (value);
+        }
+        else if (group_code == 230)
+        {
+                *((double *) ((char *) entity + offsetof (DxfLine, extr_z0))) = dxf_parse_double (value);
+        }
+        return (FOUND);
+}
+
+
+extern const DxfFieldSpec dxf_circle_field_table[];
+extern const DxfFieldSpec dxf_dimension_field_table[];
+extern const DxfFieldSpec dxf_line_field_table[];
+
+
+/*!
+ * The generated appliers, keyed by entity name and field table.
+ */
+static const struct
+{
+        const char *entity_name;
+        const DxfFieldSpec *fields;
+        DxfFieldGeneratedApplier apply;
+} dxf_field_generated_entries[] =
+{
+        {"CIRCLE", dxf_circle_field_table, dxf_field_apply_circle_generated},
+        {"DIMENSION", dxf_dimension_field_table, dxf_field_apply_dimension_generated},
+        {"LINE", dxf_line_field_table, dxf_field_apply_line_generated},
+};
+
+#define DXF_FIELD_GENERATED_LENGTH \
+        (sizeof (dxf_field_generated_entries) / sizeof (dxf_field_generated_entries[0]))
+
+
+/*!
+ * \brief Look the generated applier of an entity name up.
+ *
+ * \return the applier, or \c NULL when no applier was generated
+ * for the name.
+ */
+DxfFieldGeneratedApplier
+dxf_field_generated_find
+(
+        const char *entity_name
+)
+{
+        size_t i;
+
+        for (i = 0; i < DXF_FIELD_GENERATED_LENGTH; i++)
+        {
+                if (strcmp (dxf_field_generated_entries[i].entity_name, entity_name) == 0)
+                {
+                        return (dxf_field_generated_entries[i].apply);
+                }
+        }
+        return (NULL);
+}
+
+
+/*!
+ * \brief Look the generated applier of a field table up.
+ *
+ * \return the applier, or \c NULL when no applier was generated
+ * for the table.
+ */
+DxfFieldGeneratedApplier
+dxf_field_generated_for
+(
+        const DxfFieldSpec *table
+)
+{
+        size_t i;
+
+        for (i = 0; i < DXF_FIELD_GENERATED_LENGTH; i++)
+        {
+                if (dxf_field_generated_entries[i].fields == table)
+                {
+                        return (dxf_field_generated_entries[i].apply);
+                }
+        }
+        return (NULL);
+}
+
+
+/* EOF */
@@ -0,0 +1,94 @@
+/*!
+ * \file field_generated.h
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Header for the generated specialized field appliers.
+ *
+ * The implementation in \c field_generated.c is emitted from the
+ * field tables by \c dxf_field_codegen_emit (see field_codegen.c);
+ * this header is maintained by hand.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#ifndef LIBDXF_SRC_FIELD_GENERATED_H
+#define LIBDXF_SRC_FIELD_GENERATED_H
+
+
+#include "global.h"
+#include "field.h"
+
+
+/*!
+ * \brief A generated specialized applier of one entity type.
+ *
+ * Contracts like the special handler of \c dxf_field_read_all: the
+ * applier consumes the value line of the group code itself and
+ * returns \c FOUND when it handled the code, or \c FAIL when the code
+ * is not in its table and nothing was consumed.
+ */
+typedef int (*DxfFieldGeneratedApplier) (DxfFile *fp, void *entity, int group_code);
+
+
+DxfFieldGeneratedApplier
+dxf_field_generated_find
+(
+        const char *entity_name
+);
+DxfFieldGeneratedApplier
+dxf_field_generated_for
+(
+        const DxfFieldSpec *table
+);
+int
+dxf_field_apply_circle_generated
+(
+        DxfFile *fp,
+        void *entity,
+        int group_code
+);
+int
+dxf_field_apply_dimension_generated
+(
+        DxfFile *fp,
+        void *entity,
+        int group_code
+);
+int
+dxf_field_apply_line_generated
+(
+        DxfFile *fp,
+        void *entity,
+        int group_code
+);
+
+
+#endif /* LIBDXF_SRC_FIELD_GENERATED_H */
+
+
+/* EOF */
@@ -32,37 +32,3344 @@
  */
 
 
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "file.h"
+#include "census.h"
+#include "diag.h"
+#include "objects.h"
+#include "ring.h"
 
 
-char *dxf_entities_list;
-char *dxf_objects_list;
-char *dxf_blocks_list;
-DxfThumbnail *dxf_thumbnail;
+/*!
+ * \brief Allocate an empty \c DxfDocument parse context.
+ *
+ * \return a pointer to the document, or \c NULL when no memory was
+ * allocated.
+ */
+DxfDocument *
+dxf_document_new ()
+{
+        DxfDocument *document;
+
+        document = calloc (1, sizeof (DxfDocument));
+        if (document == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        memcpy (&document->config, dxf_config_get (), sizeof (DxfConfig));
+        return (document);
+}
+
+
+/*!
+ * \brief Free a \c DxfDocument parse context and the sections it
+ * holds.
+ */
+void
+dxf_document_free
+(
+        DxfDocument *document
+                /*!< the document to free. */
+)
+{
+        if (document == NULL)
+        {
+                return;
+        }
+        if (document->thumbnail != NULL)
+        {
+                dxf_thumbnail_free (document->thumbnail);
+        }
+        free (document->entities_list);
+        free (document->objects_list);
+        free (document->blocks_list);
+        if (document->objects != NULL)
+        {
+                dxf_objects_free (document->objects);
+        }
+        if (document->drawing != NULL)
+        {
+                dxf_drawing_free (document->drawing);
+        }
+        if (document->arena != NULL)
+        {
+                dxf_arena_free (document->arena);
+        }
+        if (document->share_base != NULL)
+        {
+                munmap (document->share_base, document->share_size);
+        }
+        free (document);
+}
+
+
+/*!
+ * \brief Append a group 999 comment to a \c DxfDocument.
+ *
+ * The comment struct and string are allocated from the document arena
+ * (created on first use), so capturing costs a bump allocation per
+ * comment instead of terminal I/O in the read loop.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when no memory
+ * was allocated.
+ */
+static int
+dxf_document_capture_comment
+(
+        DxfDocument *document,
+                /*!< the document capturing the comment. */
+        const char *value
+                /*!< the comment text. */
+)
+{
+        DxfComment *comment;
+
+        if (document->arena == NULL)
+        {
+                document->arena = dxf_arena_new (document->config.arena_block_size);
+                if (document->arena == NULL)
+                {
+                        return (EXIT_FAILURE);
+                }
+        }
+        comment = dxf_arena_alloc (document->arena, sizeof (DxfComment));
+        if (comment == NULL)
+        {
+                return (EXIT_FAILURE);
+        }
+        comment->id_code = 0;
+        comment->value = dxf_arena_strdup (document->arena, value);
+        comment->next = NULL;
+        if (comment->value == NULL)
+        {
+                return (EXIT_FAILURE);
+        }
+        if (document->comments_last != NULL)
+        {
+                document->comments_last->next = (struct DxfComment *) comment;
+        }
+        else
+        {
+                document->comments = comment;
+        }
+        document->comments_last = comment;
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Get the captured group 999 comments of a \c DxfDocument.
+ *
+ * The comments are in file order; walk them through their \c next
+ * pointers.\n
+ * They are owned by the document: do not pass them to
+ * \c dxf_comment_free.
+ *
+ * \return the first comment, or \c NULL when the file carried none.
+ */
+DxfComment *
+dxf_document_comments
+(
+        DxfDocument *document
+                /*!< the document holding the comments. */
+)
+{
+        if (document == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        return (document->comments);
+}
+
+
+/*!
+ * \brief Count the captured group 999 comments of a \c DxfDocument.
+ *
+ * \return the number of comments.
+ */
+size_t
+dxf_document_comment_count
+(
+        DxfDocument *document
+                /*!< the document holding the comments. */
+)
+{
+        DxfComment *comment;
+        size_t count;
+
+        if (document == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (0);
+        }
+        count = 0;
+        for (comment = document->comments; comment != NULL;
+                comment = (DxfComment *) comment->next)
+        {
+                count++;
+        }
+        return (count);
+}
+
+
+/*!
+ * A member offset marking "no such member" in a
+ * \c DxfDocumentRetainSpec.
+ */
+#define DXF_DOCUMENT_NO_MEMBER ((size_t) -1)
+
+
+/*!
+ * \brief Where the owned pointers live in one retained entity type.
+ *
+ * \c dxf_document_read deep copies every streamed scratch entity into
+ * the document arena; the spec tells the generic copy which members
+ * are strings to duplicate and which linkage or cache pointers to
+ * clear so the retained entity never references parser scratch
+ * state.
+ */
+typedef struct
+dxf_document_retain_spec
+{
+        DxfEntityType type;
+                /*!< the entity type the spec describes. */
+        size_t size;
+                /*!< \c sizeof the entity struct. */
+        const size_t *strings;
+                /*!< offsets of the owned string members. */
+        size_t number_strings;
+                /*!< number of entries in \c strings. */
+        size_t next_offset;
+                /*!< offset of the \c next linkage pointer, or
+                 * \c DXF_DOCUMENT_NO_MEMBER for types without one. */
+        size_t clear_offset;
+                /*!< offset of one more pointer member to clear
+                 * (tessellation cache, vertex chain), or
+                 * \c DXF_DOCUMENT_NO_MEMBER. */
+} DxfDocumentRetainSpec;
+
+
+/*!
+ * The string members every drawable entity struct carries.
+ */
+#define DXF_DOCUMENT_COMMON_STRINGS(type) \
+        offsetof (type, linetype), \
+        offsetof (type, layer), \
+        offsetof (type, dictionary_owner_soft), \
+        offsetof (type, dictionary_owner_hard)
+
+
+static const size_t dxf_document_arc_strings[] =
+        { DXF_DOCUMENT_COMMON_STRINGS (DxfArc) };
+static const size_t dxf_document_circle_strings[] =
+        { DXF_DOCUMENT_COMMON_STRINGS (DxfCircle) };
+static const size_t dxf_document_ellipse_strings[] =
+        { DXF_DOCUMENT_COMMON_STRINGS (DxfEllipse) };
+static const size_t dxf_document_face_strings[] =
+        { DXF_DOCUMENT_COMMON_STRINGS (Dxf3dface) };
+static const size_t dxf_document_insert_strings[] =
+        { DXF_DOCUMENT_COMMON_STRINGS (DxfInsert),
+          offsetof (DxfInsert, block_name) };
+static const size_t dxf_document_line_strings[] =
+        { DXF_DOCUMENT_COMMON_STRINGS (DxfLine) };
+static const size_t dxf_document_lwpolyline_strings[] =
+        { DXF_DOCUMENT_COMMON_STRINGS (DxfLWPolyline) };
+static const size_t dxf_document_point_strings[] =
+        { DXF_DOCUMENT_COMMON_STRINGS (DxfPoint) };
+static const size_t dxf_document_polyline_strings[] =
+        { DXF_DOCUMENT_COMMON_STRINGS (DxfPolyline) };
+static const size_t dxf_document_seqend_strings[] =
+        { DXF_DOCUMENT_COMMON_STRINGS (DxfSeqend),
+          offsetof (DxfSeqend, app_name) };
+static const size_t dxf_document_solid_strings[] =
+        { DXF_DOCUMENT_COMMON_STRINGS (DxfSolid) };
+static const size_t dxf_document_text_strings[] =
+        { DXF_DOCUMENT_COMMON_STRINGS (DxfText),
+          offsetof (DxfText, text_value),
+          offsetof (DxfText, text_style) };
+static const size_t dxf_document_vertex_strings[] =
+        { DXF_DOCUMENT_COMMON_STRINGS (DxfVertex) };
+
+
+/*!
+ * The retain specs of the streamed entity types.
+ */
+static const DxfDocumentRetainSpec dxf_document_retain_specs[] =
+{
+        { ARC, sizeof (DxfArc), dxf_document_arc_strings, 4,
+          offsetof (DxfArc, next), offsetof (DxfArc, tessellation) },
+        { CIRCLE, sizeof (DxfCircle), dxf_document_circle_strings, 4,
+          offsetof (DxfCircle, next), offsetof (DxfCircle, tessellation) },
+        { ELLIPSE, sizeof (DxfEllipse), dxf_document_ellipse_strings, 4,
+          offsetof (DxfEllipse, next), DXF_DOCUMENT_NO_MEMBER },
+        { FACE3D, sizeof (Dxf3dface), dxf_document_face_strings, 4,
+          offsetof (Dxf3dface, next), DXF_DOCUMENT_NO_MEMBER },
+        { INSERT, sizeof (DxfInsert), dxf_document_insert_strings, 5,
+          offsetof (DxfInsert, next), DXF_DOCUMENT_NO_MEMBER },
+        { LINE, sizeof (DxfLine), dxf_document_line_strings, 4,
+          offsetof (DxfLine, next), DXF_DOCUMENT_NO_MEMBER },
+        { LWPOLYLINE, sizeof (DxfLWPolyline), dxf_document_lwpolyline_strings, 4,
+          offsetof (DxfLWPolyline, next), DXF_DOCUMENT_NO_MEMBER },
+        { POINT, sizeof (DxfPoint), dxf_document_point_strings, 4,
+          offsetof (DxfPoint, next), DXF_DOCUMENT_NO_MEMBER },
+        { POLYLINE, sizeof (DxfPolyline), dxf_document_polyline_strings, 4,
+          offsetof (DxfPolyline, next), offsetof (DxfPolyline, vertices) },
+        { SEQEND, sizeof (DxfSeqend), dxf_document_seqend_strings, 5,
+          DXF_DOCUMENT_NO_MEMBER, DXF_DOCUMENT_NO_MEMBER },
+        { SOLID, sizeof (DxfSolid), dxf_document_solid_strings, 4,
+          offsetof (DxfSolid, next), DXF_DOCUMENT_NO_MEMBER },
+        { TEXT, sizeof (DxfText), dxf_document_text_strings, 6,
+          offsetof (DxfText, next), DXF_DOCUMENT_NO_MEMBER },
+        { VERTEX, sizeof (DxfVertex), dxf_document_vertex_strings, 4,
+          offsetof (DxfVertex, next), DXF_DOCUMENT_NO_MEMBER },
+};
+
+
+/*!
+ * \brief Look the retain spec of an entity type up.
+ *
+ * \return the spec, or \c NULL for types without one.
+ */
+static const DxfDocumentRetainSpec *
+dxf_document_spec_get
+(
+        DxfEntityType type
+                /*!< the entity type to look up. */
+)
+{
+        size_t number_specs;
+        size_t i;
+
+        number_specs = sizeof (dxf_document_retain_specs)
+                / sizeof (dxf_document_retain_specs[0]);
+        for (i = 0; i < number_specs; i++)
+        {
+                if (dxf_document_retain_specs[i].type == type)
+                {
+                        return (&dxf_document_retain_specs[i]);
+                }
+        }
+        return (NULL);
+}
+
+
+/*!
+ * \brief Deep copy a scratch entity into the document.
+ *
+ * The struct is copied bitwise into the arena, the owned strings are
+ * arena-duplicated (the scratch strings are reused by the parser for
+ * the next entity), the linkage and cache pointers are cleared, and
+ * the copy is appended to the document drawing.
+ *
+ * \return \c EXIT_SUCCESS to continue the read, or \c EXIT_FAILURE
+ * to abort it.
+ */
+static int
+dxf_document_retain
+(
+        DxfDocument *document,
+                /*!< the document to retain the entity in. */
+        DxfEntityType type,
+                /*!< the type of the entity. */
+        void *entity
+                /*!< the scratch entity to copy. */
+)
+{
+        const DxfDocumentRetainSpec *spec;
+        DxfLWPolyline *lwpolyline;
+        void *copy;
+        char **string;
+        size_t i;
+
+        if (document->retain_skip > 0)
+        {
+                /* replaying the already checkpointed prefix of the
+                 * file (see dxf_parse_resume). */
+                document->retain_skip--;
+                return (EXIT_SUCCESS);
+        }
+        spec = dxf_document_spec_get (type);
+        if (spec == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () no retain spec for entity type %d.\n")),
+                  __FUNCTION__, (int) type);
+                return (EXIT_FAILURE);
+        }
+        /* the id code is the first member of every retained entity
+         * struct; track the handle ceiling for O(1) allocation of
+         * fresh handles (see dxf_document_next_handle). */
+        if (*(const int *) entity > document->handle_ceiling)
+        {
+                document->handle_ceiling = *(const int *) entity;
+        }
+        copy = dxf_arena_alloc (document->arena, spec->size);
+        if (copy == NULL)
+        {
+                return (EXIT_FAILURE);
+        }
+        memcpy (copy, entity, spec->size);
+        for (i = 0; i < spec->number_strings; i++)
+        {
+                string = (char **) ((char *) copy + spec->strings[i]);
+                if (*string != NULL)
+                {
+                        *string = dxf_arena_strdup (document->arena, *string);
+                        if (*string == NULL)
+                        {
+                                return (EXIT_FAILURE);
+                        }
+                }
+        }
+        if (spec->next_offset != DXF_DOCUMENT_NO_MEMBER)
+        {
+                *(void **) ((char *) copy + spec->next_offset) = NULL;
+        }
+        if (spec->clear_offset != DXF_DOCUMENT_NO_MEMBER)
+        {
+                *(void **) ((char *) copy + spec->clear_offset) = NULL;
+        }
+        if (type == LWPOLYLINE)
+        {
+                /* the vertex array is owned storage as well. */
+                lwpolyline = (DxfLWPolyline *) copy;
+                if ((lwpolyline->vertices != NULL)
+                        && (lwpolyline->number_vertices > 0))
+                {
+                        copy = dxf_arena_alloc (document->arena,
+                                (size_t) lwpolyline->number_vertices
+                                * sizeof (DxfLWPolylineVertex));
+                        if (copy == NULL)
+                        {
+                                return (EXIT_FAILURE);
+                        }
+                        memcpy (copy, lwpolyline->vertices,
+                                (size_t) lwpolyline->number_vertices
+                                * sizeof (DxfLWPolylineVertex));
+                        lwpolyline->vertices_size = lwpolyline->number_vertices;
+                        lwpolyline->vertices = copy;
+                        copy = lwpolyline;
+                }
+                else
+                {
+                        lwpolyline->vertices = NULL;
+                        lwpolyline->vertices_size = 0;
+                }
+        }
+        return (dxf_drawing_append (document->drawing, type, copy));
+}
+
+
+/*!
+ * Generates the typed streaming callback handing one entity type to
+ * \c dxf_document_retain.
+ */
+#define DXF_DOCUMENT_RETAIN_HANDLER(function, type_tag, entity_type) \
+static int \
+function \
+( \
+        DxfFile *fp, \
+        entity_type *entity, \
+        void *user_data \
+) \
+{ \
+        (void) fp; \
+        return (dxf_document_retain ((DxfDocument *) user_data, \
+                type_tag, entity)); \
+}
+
+DXF_DOCUMENT_RETAIN_HANDLER (dxf_document_retain_arc, ARC, DxfArc)
+DXF_DOCUMENT_RETAIN_HANDLER (dxf_document_retain_circle, CIRCLE, DxfCircle)
+DXF_DOCUMENT_RETAIN_HANDLER (dxf_document_retain_ellipse, ELLIPSE, DxfEllipse)
+DXF_DOCUMENT_RETAIN_HANDLER (dxf_document_retain_face, FACE3D, Dxf3dface)
+DXF_DOCUMENT_RETAIN_HANDLER (dxf_document_retain_insert, INSERT, DxfInsert)
+DXF_DOCUMENT_RETAIN_HANDLER (dxf_document_retain_line, LINE, DxfLine)
+DXF_DOCUMENT_RETAIN_HANDLER (dxf_document_retain_lwpolyline, LWPOLYLINE, DxfLWPolyline)
+DXF_DOCUMENT_RETAIN_HANDLER (dxf_document_retain_point, POINT, DxfPoint)
+DXF_DOCUMENT_RETAIN_HANDLER (dxf_document_retain_polyline, POLYLINE, DxfPolyline)
+DXF_DOCUMENT_RETAIN_HANDLER (dxf_document_retain_seqend, SEQEND, DxfSeqend)
+DXF_DOCUMENT_RETAIN_HANDLER (dxf_document_retain_solid, SOLID, DxfSolid)
+DXF_DOCUMENT_RETAIN_HANDLER (dxf_document_retain_text, TEXT, DxfText)
+DXF_DOCUMENT_RETAIN_HANDLER (dxf_document_retain_vertex, VERTEX, DxfVertex)
+
+
+/*!
+ * \brief Parse a DXF file into an existing document.
+ *
+ * Creates the arena and drawing of the document when missing, wires
+ * the retain handlers and runs the streaming reader over the file.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when the
+ * file could not be read.
+ */
+static int
+dxf_document_read_into
+(
+        DxfDocument *document,
+                /*!< the document to parse into. */
+        char *filename
+                /*!< filename of input file (or device). */
+)
+{
+        DxfReadHandlers handlers;
+        FILE *probe;
+
+        /* the historic reader reports end of file as a failure, so
+         * probe readability separately to tell a missing file from a
+         * completed parse. */
+        probe = fopen (filename, "r");
+        if (probe == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not open file: %s for reading.\n")),
+                  __FUNCTION__, filename);
+                return (EXIT_FAILURE);
+        }
+        fclose (probe);
+        if (document->arena == NULL)
+        {
+                document->arena = dxf_arena_new (document->config.arena_block_size);
+                if (document->arena == NULL)
+                {
+                        return (EXIT_FAILURE);
+                }
+        }
+        if (document->drawing == NULL)
+        {
+                document->drawing = dxf_drawing_new ();
+                if (document->drawing == NULL)
+                {
+                        return (EXIT_FAILURE);
+                }
+        }
+        memset (&handlers, 0, sizeof (handlers));
+        handlers.user_data = document;
+        handlers.arc = dxf_document_retain_arc;
+        handlers.circle = dxf_document_retain_circle;
+        handlers.ellipse = dxf_document_retain_ellipse;
+        handlers.face = dxf_document_retain_face;
+        handlers.insert = dxf_document_retain_insert;
+        handlers.line = dxf_document_retain_line;
+        handlers.lwpolyline = dxf_document_retain_lwpolyline;
+        handlers.point = dxf_document_retain_point;
+        handlers.polyline = dxf_document_retain_polyline;
+        handlers.seqend = dxf_document_retain_seqend;
+        handlers.solid = dxf_document_retain_solid;
+        handlers.text = dxf_document_retain_text;
+        handlers.vertex = dxf_document_retain_vertex;
+        /* the return is the historic end-of-file "failure"; the
+         * sections already landed in the document. */
+        dxf_file_read_document (filename, document, &handlers);
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Read a DXF file into an owning document.
+ *
+ * One call parses the file and returns a document owning every
+ * section the reader understands: the header variables, the classes,
+ * the thumbnail and — unlike the streaming reads, which hand each
+ * entity to a callback and reuse the scratch struct — the entities
+ * themselves, deep copied in file order into the document arena and
+ * reachable through \c document->drawing.\n
+ * A single owning root is what the whole-document operations (freeze,
+ * cache, visit, rewrite) build on.
+ *
+ * \return a pointer to the document, to be freed with
+ * \c dxf_document_free, or \c NULL when the file could not be read.
+ */
+DxfDocument *
+dxf_document_read
+(
+        char *filename
+                /*!< filename of input file (or device). */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        DxfDocument *document;
+
+        if (filename == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        document = dxf_document_new ();
+        if (document == NULL)
+        {
+                return (NULL);
+        }
+        if (dxf_document_read_into (document, filename) != EXIT_SUCCESS)
+        {
+                dxf_document_free (document);
+                return (NULL);
+        }
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (document);
+}
+
+
+/*!
+ * \brief Write an owning document to a DXF file.
+ *
+ * The counterpart of \c dxf_document_read: one call writes the header
+ * section (when the document holds parsed header variables) and every
+ * retained entity, in file order, bracketed as an \c ENTITIES section
+ * and terminated with \c EOF.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_document_write
+(
+        DxfDocument *document,
+                /*!< the document to write. */
+        char *filename,
+                /*!< filename of the output file (or device). */
+        int acad_version_number
+                /*!< AutoCAD version number to write for. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        DxfFile *fp;
+        DxfTaggedEntity *tagged;
+        size_t i;
+        int result;
+
+        if ((document == NULL) || (filename == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        fp = malloc (sizeof (DxfFile));
+        if (fp == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory for a DxfFile struct.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        memset (fp, 0, sizeof (DxfFile));
+        fp->fp = fopen (filename, "w");
+        if (fp->fp == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not open file: %s for writing.\n")),
+                  __FUNCTION__, filename);
+                free (fp);
+                return (EXIT_FAILURE);
+        }
+        fp->filename = strdup (filename);
+        fp->acad_version_number = acad_version_number;
+        fp->write_version.acad_version_number = -1;
+        fp->last_id_code = -1;
+        if (document->header.AcadVer != NULL)
+        {
+                dxf_write_header (fp, document->header);
+        }
+        /* no buffered writer: part of the entity writers emit
+         * straight to the stream, so everything goes direct to keep
+         * the record order. */
+        dxf_write_group_string (fp, 0, "SECTION");
+        dxf_write_group_string (fp, 2, "ENTITIES");
+        result = EXIT_SUCCESS;
+        if (document->drawing != NULL)
+        {
+                for (i = 0; i < document->drawing->length; i++)
+                {
+                        tagged = &document->drawing->entities[i];
+                        switch (tagged->type)
+                        {
+                                case ARC:
+                                        dxf_arc_write (fp, (DxfArc *) tagged->entity);
+                                        break;
+                                case CIRCLE:
+                                        dxf_circle_write (fp, (DxfCircle *) tagged->entity);
+                                        break;
+                                case ELLIPSE:
+                                        dxf_ellipse_write (fp, (DxfEllipse *) tagged->entity);
+                                        break;
+                                case FACE3D:
+                                        dxf_3dface_write (fp, (Dxf3dface *) tagged->entity);
+                                        break;
+                                case INSERT:
+                                        dxf_insert_write (fp, (DxfInsert *) tagged->entity);
+                                        break;
+                                case LINE:
+                                        dxf_line_write (fp, (DxfLine *) tagged->entity);
+                                        break;
+                                case LWPOLYLINE:
+                                        dxf_lwpolyline_write (fp, (DxfLWPolyline *) tagged->entity);
+                                        break;
+                                case POINT:
+                                        dxf_point_write (fp, (DxfPoint *) tagged->entity);
+                                        break;
+                                case POLYLINE:
+                                        dxf_polyline_write (fp, (DxfPolyline *) tagged->entity);
+                                        break;
+                                case SEQEND:
+                                        dxf_seqend_write (fp, (DxfSeqend *) tagged->entity);
+                                        break;
+                                case SOLID:
+                                        dxf_solid_write (fp, (DxfSolid *) tagged->entity);
+                                        break;
+                                case TEXT:
+                                        dxf_text_write (fp, (DxfText *) tagged->entity);
+                                        break;
+                                case VERTEX:
+                                        dxf_vertex_write (fp, (DxfVertex *) tagged->entity);
+                                        break;
+                                default:
+                                        fprintf (stderr,
+                                          (_("Warning in %s () entity type %d has no writer and was skipped.\n")),
+                                          __FUNCTION__, (int) tagged->type);
+                                        break;
+                        }
+                }
+        }
+        dxf_write_group_string (fp, 0, "ENDSEC");
+        if (document->objects != NULL)
+        {
+                if (dxf_objects_write (fp, document->objects) != EXIT_SUCCESS)
+                {
+                        result = EXIT_FAILURE;
+                }
+        }
+        dxf_file_write_eof (fp);
+        if (fclose (fp->fp) != 0)
+        {
+                result = EXIT_FAILURE;
+        }
+        free (fp->filename);
+        free (fp);
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (result);
+}
+
+
+/*!
+ * The magic bytes announcing a shared document segment.
+ */
+#define DXF_DOCUMENT_SHARE_MAGIC "DXFSHM1"
+
+/*!
+ * Alignment of the entity structs within a shared segment.
+ */
+#define DXF_DOCUMENT_SHARE_ALIGN 16
+
+
+/*!
+ * \brief Header of a shared document segment.
+ *
+ * The segment is only ever mapped on the host that produced it, so
+ * the layout can use the native sizes and needs no byte order
+ * handling.
+ */
+typedef struct
+dxf_document_share_header
+{
+        char magic[8];
+                /*!< \c DXF_DOCUMENT_SHARE_MAGIC. */
+        size_t total_size;
+                /*!< size of the whole segment in bytes, for
+                 * validation against the mapped size. */
+        size_t number_entities;
+                /*!< number of entity records following the header. */
+} DxfDocumentShareHeader;
+
+
+/*!
+ * \brief One entity record of a shared document segment.
+ */
+typedef struct
+dxf_document_share_record
+{
+        int type;
+                /*!< the \c DxfEntityType of the entity. */
+        size_t offset;
+                /*!< offset of the entity struct within the segment. */
+} DxfDocumentShareRecord;
+
+
+/*!
+ * \brief Round a segment offset up to the entity struct alignment.
+ */
+static size_t
+dxf_document_share_align
+(
+        size_t offset
+                /*!< the offset to round up. */
+)
+{
+        return ((offset + (DXF_DOCUMENT_SHARE_ALIGN - 1))
+                & ~((size_t) DXF_DOCUMENT_SHARE_ALIGN - 1));
+}
+
+
+/*!
+ * \brief Compute the segment size of the relocatable layout of a
+ * document drawing.
+ *
+ * \return the size in bytes, or \c 0 when the drawing holds a type
+ * without a retain spec.
+ */
+static size_t
+dxf_document_segment_size
+(
+        DxfDocument *document
+                /*!< the document to lay out. */
+)
+{
+        const DxfDocumentRetainSpec *spec;
+        DxfLWPolyline *lwpolyline;
+        char *entity;
+        char **slot;
+        size_t size;
+        size_t i;
+        size_t j;
+
+        /* The header, the records, then per entity the aligned
+         * struct, its strings and its owned arrays. */
+        size = sizeof (DxfDocumentShareHeader)
+                + document->drawing->length * sizeof (DxfDocumentShareRecord);
+        for (i = 0; i < document->drawing->length; i++)
+        {
+                spec = dxf_document_spec_get (document->drawing->entities[i].type);
+                if (spec == NULL)
+                {
+                        fprintf (stderr,
+                          (_("Error in %s () no retain spec for entity type %d.\n")),
+                          __FUNCTION__, (int) document->drawing->entities[i].type);
+                        return (0);
+                }
+                size = dxf_document_share_align (size) + spec->size;
+                entity = (char *) document->drawing->entities[i].entity;
+                for (j = 0; j < spec->number_strings; j++)
+                {
+                        slot = (char **) (entity + spec->strings[j]);
+                        if (*slot != NULL)
+                        {
+                                size += strlen (*slot) + 1;
+                        }
+                }
+                if (document->drawing->entities[i].type == LWPOLYLINE)
+                {
+                        lwpolyline = (DxfLWPolyline *) entity;
+                        if ((lwpolyline->vertices != NULL)
+                                && (lwpolyline->number_vertices > 0))
+                        {
+                                size = dxf_document_share_align (size)
+                                        + (size_t) lwpolyline->number_vertices
+                                        * sizeof (DxfLWPolylineVertex);
+                        }
+                }
+        }
+        return (size);
+}
+
+
+/*!
+ * \brief Fill a segment with the relocatable layout of a document
+ * drawing.
+ *
+ * Every entity struct is copied into the segment with its strings
+ * behind it, and the string members hold segment offsets instead of
+ * pointers, so the segment is valid at whatever address a consumer
+ * maps it.\n
+ * \c base must hold \c dxf_document_segment_size() bytes.
+ */
+static void
+dxf_document_segment_fill
+(
+        DxfDocument *document,
+                /*!< the document to lay out. */
+        char *base,
+                /*!< the segment to fill. */
+        size_t size
+                /*!< size of the segment in bytes. */
+)
+{
+        DxfDocumentShareHeader *header;
+        DxfDocumentShareRecord *records;
+        const DxfDocumentRetainSpec *spec;
+        DxfLWPolyline *lwpolyline;
+        char *copy;
+        char **slot;
+        size_t cursor;
+        size_t length;
+        size_t i;
+        size_t j;
+
+        header = (DxfDocumentShareHeader *) base;
+        memcpy (header->magic, DXF_DOCUMENT_SHARE_MAGIC,
+                sizeof (header->magic));
+        header->total_size = size;
+        header->number_entities = document->drawing->length;
+        records = (DxfDocumentShareRecord *)
+                (base + sizeof (DxfDocumentShareHeader));
+        cursor = sizeof (DxfDocumentShareHeader)
+                + document->drawing->length * sizeof (DxfDocumentShareRecord);
+        for (i = 0; i < document->drawing->length; i++)
+        {
+                spec = dxf_document_spec_get (document->drawing->entities[i].type);
+                cursor = dxf_document_share_align (cursor);
+                records[i].type = (int) document->drawing->entities[i].type;
+                records[i].offset = cursor;
+                copy = base + cursor;
+                memcpy (copy, document->drawing->entities[i].entity,
+                        spec->size);
+                cursor += spec->size;
+                if (spec->next_offset != DXF_DOCUMENT_NO_MEMBER)
+                {
+                        *(void **) (copy + spec->next_offset) = NULL;
+                }
+                if (spec->clear_offset != DXF_DOCUMENT_NO_MEMBER)
+                {
+                        *(void **) (copy + spec->clear_offset) = NULL;
+                }
+                for (j = 0; j < spec->number_strings; j++)
+                {
+                        slot = (char **) (copy + spec->strings[j]);
+                        if (*slot != NULL)
+                        {
+                                length = strlen (*slot) + 1;
+                                memcpy (base + cursor, *slot, length);
+                                *slot = (char *) (uintptr_t) cursor;
+                                cursor += length;
+                        }
+                }
+                if (document->drawing->entities[i].type == LWPOLYLINE)
+                {
+                        lwpolyline = (DxfLWPolyline *) copy;
+                        if ((lwpolyline->vertices != NULL)
+                                && (lwpolyline->number_vertices > 0))
+                        {
+                                cursor = dxf_document_share_align (cursor);
+                                length = (size_t) lwpolyline->number_vertices
+                                        * sizeof (DxfLWPolylineVertex);
+                                memcpy (base + cursor, lwpolyline->vertices,
+                                        length);
+                                lwpolyline->vertices =
+                                        (DxfLWPolylineVertex *) (uintptr_t) cursor;
+                                cursor += length;
+                        }
+                        else
+                        {
+                                lwpolyline->vertices = NULL;
+                        }
+                }
+        }
+}
+
+
+/*!
+ * \brief Rebuild the drawing of a document from a mapped segment.
+ *
+ * Resolves the offset based members of every entity to pointers into
+ * the mapping and appends the entities to the document drawing in
+ * segment order.\n
+ * The mapping stays owned by the caller.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when the
+ * segment is invalid.
+ */
+static int
+dxf_document_segment_restore
+(
+        DxfDocument *document,
+                /*!< the document to rebuild into; must hold a
+                 * drawing. */
+        char *base,
+                /*!< the mapped segment. */
+        size_t size
+                /*!< size of the mapping in bytes. */
+)
+{
+        DxfDocumentShareHeader *header;
+        DxfDocumentShareRecord *records;
+        const DxfDocumentRetainSpec *spec;
+        DxfLWPolyline *lwpolyline;
+        char *entity;
+        char **slot;
+        size_t i;
+        size_t j;
+
+        header = (DxfDocumentShareHeader *) base;
+        if ((size < sizeof (DxfDocumentShareHeader))
+                || (memcmp (header->magic, DXF_DOCUMENT_SHARE_MAGIC,
+                        sizeof (header->magic)) != 0)
+                || (header->total_size != size))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () an invalid segment was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        records = (DxfDocumentShareRecord *)
+                (base + sizeof (DxfDocumentShareHeader));
+        for (i = 0; i < header->number_entities; i++)
+        {
+                spec = dxf_document_spec_get ((DxfEntityType) records[i].type);
+                if ((spec == NULL)
+                        || (records[i].offset + spec->size > size))
+                {
+                        fprintf (stderr,
+                          (_("Error in %s () an invalid segment was passed.\n")),
+                          __FUNCTION__);
+                        return (EXIT_FAILURE);
+                }
+                entity = base + records[i].offset;
+                if (*(int *) entity > document->handle_ceiling)
+                {
+                        document->handle_ceiling = *(int *) entity;
+                }
+                for (j = 0; j < spec->number_strings; j++)
+                {
+                        slot = (char **) (entity + spec->strings[j]);
+                        if (*slot != NULL)
+                        {
+                                *slot = base + (uintptr_t) *slot;
+                        }
+                }
+                if ((DxfEntityType) records[i].type == LWPOLYLINE)
+                {
+                        lwpolyline = (DxfLWPolyline *) entity;
+                        if (lwpolyline->vertices != NULL)
+                        {
+                                lwpolyline->vertices = (DxfLWPolylineVertex *)
+                                        (base + (uintptr_t) lwpolyline->vertices);
+                        }
+                }
+                if (dxf_drawing_append (document->drawing,
+                        (DxfEntityType) records[i].type,
+                        entity) != EXIT_SUCCESS)
+                {
+                        return (EXIT_FAILURE);
+                }
+        }
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Place the retained entities of a document in a shared memory
+ * segment.
+ *
+ * The entity graph is laid out relocatable (see
+ * \c dxf_document_segment_fill), so the segment is valid at whatever
+ * address a consumer maps it.\n
+ * Separate consumer processes attach the segment with
+ * \c dxf_document_attach() and read the same parse, so a file is
+ * parsed once per host instead of once per process.\n
+ * The segment persists under \c name until the creator removes it
+ * with \c shm_unlink().
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_document_share
+(
+        DxfDocument *document,
+                /*!< the document to share; must hold a drawing (see
+                 * \c dxf_document_read). */
+        const char *name
+                /*!< name of the shared memory segment, as for
+                 * \c shm_open(): a slash followed by non-slash
+                 * characters, e.g. "/drawing". */
+)
+{
+        char *base;
+        size_t size;
+        int fd;
+
+        if ((document == NULL) || (name == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (document->drawing == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () the document holds no drawing.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        size = dxf_document_segment_size (document);
+        if (size == 0)
+        {
+                return (EXIT_FAILURE);
+        }
+        fd = shm_open (name, O_CREAT | O_RDWR | O_TRUNC, 0600);
+        if (fd < 0)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not create shared memory segment: %s.\n")),
+                  __FUNCTION__, name);
+                return (EXIT_FAILURE);
+        }
+        if (ftruncate (fd, (off_t) size) != 0)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not size shared memory segment: %s.\n")),
+                  __FUNCTION__, name);
+                close (fd);
+                shm_unlink (name);
+                return (EXIT_FAILURE);
+        }
+        base = mmap (NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close (fd);
+        if (base == MAP_FAILED)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not map shared memory segment: %s.\n")),
+                  __FUNCTION__, name);
+                shm_unlink (name);
+                return (EXIT_FAILURE);
+        }
+        dxf_document_segment_fill (document, base, size);
+        munmap (base, size);
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Attach a shared document segment produced by
+ * \c dxf_document_share().
+ *
+ * The segment is mapped copy-on-write: resolving the offset based
+ * members to pointers touches only the pages holding the entity
+ * structs, the string and vertex payload stays a single read-only
+ * copy shared by every consumer on the host.\n
+ * The returned document owns the mapping and the drawing index; the
+ * entities live in the segment and must not be modified or freed.
+ *
+ * \return a pointer to the attached document, or \c NULL when errors
+ * occurred.
+ */
+DxfDocument *
+dxf_document_attach
+(
+        const char *name
+                /*!< name of the shared memory segment, as passed to
+                 * \c dxf_document_share(). */
+)
+{
+        DxfDocument *document;
+        struct stat status;
+        char *base;
+        size_t size;
+        int fd;
+
+        if (name == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        fd = shm_open (name, O_RDONLY, 0);
+        if (fd < 0)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not open shared memory segment: %s.\n")),
+                  __FUNCTION__, name);
+                return (NULL);
+        }
+        if ((fstat (fd, &status) != 0)
+                || ((size_t) status.st_size < sizeof (DxfDocumentShareHeader)))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () invalid shared memory segment: %s.\n")),
+                  __FUNCTION__, name);
+                close (fd);
+                return (NULL);
+        }
+        size = (size_t) status.st_size;
+        base = mmap (NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        close (fd);
+        if (base == MAP_FAILED)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not map shared memory segment: %s.\n")),
+                  __FUNCTION__, name);
+                return (NULL);
+        }
+        document = dxf_document_new ();
+        if (document == NULL)
+        {
+                munmap (base, size);
+                return (NULL);
+        }
+        document->share_base = base;
+        document->share_size = size;
+        document->drawing = dxf_drawing_new ();
+        if (document->drawing == NULL)
+        {
+                dxf_document_free (document);
+                return (NULL);
+        }
+        if (dxf_document_segment_restore (document, base, size)
+                != EXIT_SUCCESS)
+        {
+                dxf_document_free (document);
+                return (NULL);
+        }
+        return (document);
+}
+
+
+/*!
+ * \brief Checkpoint the parse state of a document to disk.
+ *
+ * Writes the entities retained so far in the relocatable segment
+ * layout (see \c dxf_document_segment_fill) to \c path, so a parse
+ * interrupted by preemption can be resumed with
+ * \c dxf_parse_resume() — on the same host or another one.\n
+ * The drawing is consistent between any two retained entities, so a
+ * preemption notice handler can checkpoint at any point of the
+ * parse.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_parse_checkpoint
+(
+        DxfDocument *document,
+                /*!< the document holding the partial parse. */
+        const char *path
+                /*!< filename of the checkpoint file. */
+)
+{
+        FILE *fp;
+        char *buffer;
+        size_t size;
+        size_t written;
+
+        if ((document == NULL) || (path == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (document->drawing == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () the document holds no drawing.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        size = dxf_document_segment_size (document);
+        if (size == 0)
+        {
+                return (EXIT_FAILURE);
+        }
+        buffer = malloc (size);
+        if (buffer == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        dxf_document_segment_fill (document, buffer, size);
+        fp = fopen (path, "wb");
+        if (fp == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not open file: %s for writing.\n")),
+                  __FUNCTION__, path);
+                free (buffer);
+                return (EXIT_FAILURE);
+        }
+        written = fwrite (buffer, 1, size, fp);
+        free (buffer);
+        if ((fclose (fp) != 0) || (written != size))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not write to file: %s.\n")),
+                  __FUNCTION__, path);
+                return (EXIT_FAILURE);
+        }
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Resume a checkpointed parse.
+ *
+ * Restores the entities of the checkpoint at \c path without
+ * re-parsing them, then runs the reader over \c filename with the
+ * restored prefix skipped: the replay scans the already checkpointed
+ * part of the file but performs none of the deep copies, so the lost
+ * work is bounded by a scan instead of the full parse.\n
+ * The checkpoint segment is relocatable, so the resume can happen on
+ * another host sharing the input file.
+ *
+ * \return a pointer to the resumed document, to be freed with
+ * \c dxf_document_free, or \c NULL when errors occurred.
+ */
+DxfDocument *
+dxf_parse_resume
+(
+        const char *path,
+                /*!< filename of the checkpoint file. */
+        char *filename
+                /*!< filename of the DXF input file the checkpoint was
+                 * taken from. */
+)
+{
+        DxfDocument *document;
+        struct stat status;
+        char *base;
+        size_t size;
+        int fd;
+
+        if ((path == NULL) || (filename == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        fd = open (path, O_RDONLY);
+        if (fd < 0)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not open file: %s for reading.\n")),
+                  __FUNCTION__, path);
+                return (NULL);
+        }
+        if ((fstat (fd, &status) != 0)
+                || ((size_t) status.st_size < sizeof (DxfDocumentShareHeader)))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () invalid checkpoint file: %s.\n")),
+                  __FUNCTION__, path);
+                close (fd);
+                return (NULL);
+        }
+        size = (size_t) status.st_size;
+        base = mmap (NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        close (fd);
+        if (base == MAP_FAILED)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not map checkpoint file: %s.\n")),
+                  __FUNCTION__, path);
+                return (NULL);
+        }
+        document = dxf_document_new ();
+        if (document == NULL)
+        {
+                munmap (base, size);
+                return (NULL);
+        }
+        document->share_base = base;
+        document->share_size = size;
+        document->drawing = dxf_drawing_new ();
+        if (document->drawing == NULL)
+        {
+                dxf_document_free (document);
+                return (NULL);
+        }
+        if (dxf_document_segment_restore (document, base, size)
+                != EXIT_SUCCESS)
+        {
+                dxf_document_free (document);
+                return (NULL);
+        }
+        document->retain_skip = document->drawing->length;
+        if (dxf_document_read_into (document, filename) != EXIT_SUCCESS)
+        {
+                dxf_document_free (document);
+                return (NULL);
+        }
+        return (document);
+}
+
+
+/*!
+ * \brief Copy an entity into a scratch buffer with its identity and
+ * pointer members masked out.
+ *
+ * The id code, the owned string pointers, the linkage and cache
+ * pointers and the LWPOLYLINE vertex array pointer are cleared in the
+ * copy, so hashing or comparing the scratch bytes sees only the value
+ * members — two entities with the same geometry mask to the same
+ * bytes regardless of their handles or where their strings happen to
+ * live.
+ */
+static void
+dxf_document_entity_mask
+(
+        const DxfDocumentRetainSpec *spec,
+                /*!< the retain spec of the entity type. */
+        const void *entity,
+                /*!< the entity to mask. */
+        char *scratch
+                /*!< scratch buffer of at least \c spec->size bytes. */
+)
+{
+        size_t i;
+
+        memcpy (scratch, entity, spec->size);
+        /* the id code is the first member of every retained entity
+         * struct. */
+        memset (scratch, 0, sizeof (int));
+        for (i = 0; i < spec->number_strings; i++)
+        {
+                *(char **) (scratch + spec->strings[i]) = NULL;
+        }
+        if (spec->next_offset != DXF_DOCUMENT_NO_MEMBER)
+        {
+                *(void **) (scratch + spec->next_offset) = NULL;
+        }
+        if (spec->clear_offset != DXF_DOCUMENT_NO_MEMBER)
+        {
+                *(void **) (scratch + spec->clear_offset) = NULL;
+        }
+        if (spec->type == LWPOLYLINE)
+        {
+                *(void **) (scratch + offsetof (DxfLWPolyline, vertices)) = NULL;
+        }
+}
+
+
+/*!
+ * \brief Mix a run of bytes into a FNV-1a hash.
+ */
+static unsigned int
+dxf_document_hash_bytes
+(
+        unsigned int hash,
+                /*!< the running hash. */
+        const void *bytes,
+                /*!< the bytes to mix in. */
+        size_t length
+                /*!< number of bytes. */
+)
+{
+        const unsigned char *p;
+        size_t i;
+
+        p = (const unsigned char *) bytes;
+        for (i = 0; i < length; i++)
+        {
+                hash ^= p[i];
+                hash *= 16777619u;
+        }
+        return (hash);
+}
+
+
+/*!
+ * \brief Compute the content hash of a retained entity.
+ *
+ * Hashes the masked struct bytes straight from the contiguous entity
+ * storage, then the content strings (linetype, layer and the type
+ * specific strings; the owner handles are identity, not content) and
+ * the LWPOLYLINE vertex payload.
+ *
+ * \return the content hash.
+ */
+static unsigned int
+dxf_document_entity_hash
+(
+        const DxfDocumentRetainSpec *spec,
+                /*!< the retain spec of the entity type. */
+        const void *entity,
+                /*!< the entity to hash. */
+        char *scratch
+                /*!< scratch buffer of at least \c spec->size bytes. */
+)
+{
+        const DxfLWPolyline *lwpolyline;
+        const char *string;
+        unsigned int hash;
+        size_t i;
+
+        dxf_document_entity_mask (spec, entity, scratch);
+        hash = 2166136261u;
+        hash = dxf_document_hash_bytes (hash, scratch, spec->size);
+        for (i = 0; i < spec->number_strings; i++)
+        {
+                if ((i == 2) || (i == 3))
+                {
+                        /* dictionary_owner_soft / dictionary_owner_hard. */
+                        continue;
+                }
+                string = *(char * const *) ((const char *) entity
+                        + spec->strings[i]);
+                if (string == NULL)
+                {
+                        string = "";
+                }
+                hash = dxf_document_hash_bytes (hash, string,
+                        strlen (string) + 1);
+        }
+        if (spec->type == LWPOLYLINE)
+        {
+                lwpolyline = (const DxfLWPolyline *) entity;
+                if ((lwpolyline->vertices != NULL)
+                        && (lwpolyline->number_vertices > 0))
+                {
+                        hash = dxf_document_hash_bytes (hash,
+                                lwpolyline->vertices,
+                                (size_t) lwpolyline->number_vertices
+                                * sizeof (DxfLWPolylineVertex));
+                }
+        }
+        return (hash);
+}
+
+
+/*!
+ * \brief Compare two retained entities of the same type by content.
+ *
+ * \return nonzero when the entities carry the same content.
+ */
+static int
+dxf_document_entity_equal
+(
+        const DxfDocumentRetainSpec *spec,
+                /*!< the retain spec of the entity type. */
+        const void *a,
+                /*!< the first entity. */
+        const void *b,
+                /*!< the second entity. */
+        char *scratch_a,
+                /*!< scratch buffer of at least \c spec->size bytes. */
+        char *scratch_b
+                /*!< another scratch buffer of the same size. */
+)
+{
+        const DxfLWPolyline *lwpolyline_a;
+        const DxfLWPolyline *lwpolyline_b;
+        const char *string_a;
+        const char *string_b;
+        size_t i;
+
+        dxf_document_entity_mask (spec, a, scratch_a);
+        dxf_document_entity_mask (spec, b, scratch_b);
+        if (memcmp (scratch_a, scratch_b, spec->size) != 0)
+        {
+                return (0);
+        }
+        for (i = 0; i < spec->number_strings; i++)
+        {
+                if ((i == 2) || (i == 3))
+                {
+                        continue;
+                }
+                string_a = *(char * const *) ((const char *) a
+                        + spec->strings[i]);
+                string_b = *(char * const *) ((const char *) b
+                        + spec->strings[i]);
+                if (strcmp ((string_a == NULL) ? "" : string_a,
+                        (string_b == NULL) ? "" : string_b) != 0)
+                {
+                        return (0);
+                }
+        }
+        if (spec->type == LWPOLYLINE)
+        {
+                lwpolyline_a = (const DxfLWPolyline *) a;
+                lwpolyline_b = (const DxfLWPolyline *) b;
+                if (lwpolyline_a->number_vertices > 0)
+                {
+                        if (memcmp (lwpolyline_a->vertices,
+                                lwpolyline_b->vertices,
+                                (size_t) lwpolyline_a->number_vertices
+                                * sizeof (DxfLWPolylineVertex)) != 0)
+                        {
+                                return (0);
+                        }
+                }
+        }
+        return (1);
+}
+
+
+/*!
+ * A slot of the deduplication hash table: the content hash and the
+ * drawing index of the first entity carrying it, plus one.
+ */
+typedef struct
+dxf_document_dedup_slot
+{
+        unsigned int hash;
+        size_t index_plus_one;
+} DxfDocumentDedupSlot;
+
+
+/*!
+ * \brief Merge identical entities of a document into shared storage.
+ *
+ * Scans the retained drawing and points every entity whose content
+ * (geometry, linetype, layer and type specific strings — not its
+ * handle or owner handles) duplicates an earlier one at the earlier
+ * entity's struct, so revisions of a drawing that repeat the same
+ * geometry cost one copy of it.\n
+ * Hashing runs over the contiguous entity structs at memory speed;
+ * nothing is re-serialized to text.\n
+ * After the merge, duplicate drawing slots alias one struct: treat
+ * the entities as read only, or an in place edit (a transform, say)
+ * applies once per alias.
+ *
+ * \return the number of entities merged away, or \c 0 when there were
+ * none or errors occurred.
+ */
+size_t
+dxf_document_dedup
+(
+        DxfDocument *document
+                /*!< the document to deduplicate; must hold a drawing
+                 * (see \c dxf_document_read). */
+)
+{
+        const DxfDocumentRetainSpec *spec;
+        DxfDocumentDedupSlot *slots;
+        DxfTaggedEntity *entities;
+        char *scratch_a;
+        char *scratch_b;
+        size_t number_slots;
+        size_t max_size;
+        size_t number_specs;
+        size_t merged;
+        size_t slot;
+        size_t first;
+        size_t i;
+        unsigned int hash;
+
+        if (document == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (0);
+        }
+        if ((document->drawing == NULL) || (document->drawing->length < 2))
+        {
+                return (0);
+        }
+        number_slots = 1;
+        while (number_slots < (document->drawing->length * 2))
+        {
+                number_slots *= 2;
+        }
+        slots = calloc (number_slots, sizeof (DxfDocumentDedupSlot));
+        max_size = 0;
+        number_specs = sizeof (dxf_document_retain_specs)
+                / sizeof (dxf_document_retain_specs[0]);
+        for (i = 0; i < number_specs; i++)
+        {
+                if (dxf_document_retain_specs[i].size > max_size)
+                {
+                        max_size = dxf_document_retain_specs[i].size;
+                }
+        }
+        scratch_a = malloc (max_size);
+        scratch_b = malloc (max_size);
+        if ((slots == NULL) || (scratch_a == NULL) || (scratch_b == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                free (slots);
+                free (scratch_a);
+                free (scratch_b);
+                return (0);
+        }
+        merged = 0;
+        entities = document->drawing->entities;
+        for (i = 0; i < document->drawing->length; i++)
+        {
+                spec = dxf_document_spec_get (entities[i].type);
+                if (spec == NULL)
+                {
+                        continue;
+                }
+                hash = dxf_document_entity_hash (spec, entities[i].entity,
+                        scratch_a);
+                slot = hash & (number_slots - 1);
+                while (slots[slot].index_plus_one != 0)
+                {
+                        first = slots[slot].index_plus_one - 1;
+                        if ((slots[slot].hash == hash)
+                                && (entities[first].type == entities[i].type)
+                                && dxf_document_entity_equal (spec,
+                                        entities[first].entity,
+                                        entities[i].entity,
+                                        scratch_a, scratch_b))
+                        {
+                                entities[i].entity = entities[first].entity;
+                                merged++;
+                                break;
+                        }
+                        slot = (slot + 1) & (number_slots - 1);
+                }
+                if (slots[slot].index_plus_one == 0)
+                {
+                        slots[slot].hash = hash;
+                        slots[slot].index_plus_one = i + 1;
+                }
+        }
+        free (slots);
+        free (scratch_a);
+        free (scratch_b);
+        return (merged);
+}
+
+
+/*!
+ * \brief Allocate one fresh, unique entity handle.
+ *
+ * Bumps the handle ceiling of the document and returns the new value
+ * — O(1), no scan over the existing handles.\n
+ * The bump is atomic, so concurrent synthesizer threads can draw
+ * handles from the same document without a lock; a thread emitting
+ * many entities should grab a contiguous block with
+ * \c dxf_document_reserve_handles() instead of contending here per
+ * entity.
+ *
+ * \return the allocated handle, or \c -1 when errors occurred.
+ */
+int
+dxf_document_next_handle
+(
+        DxfDocument *document
+                /*!< the document owning the handle namespace. */
+)
+{
+        if (document == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (-1);
+        }
+        return ((int) __atomic_add_fetch (&document->handle_ceiling, 1,
+                __ATOMIC_RELAXED));
+}
+
+
+/*!
+ * \brief Reserve a contiguous block of fresh entity handles.
+ *
+ * Bumps the handle ceiling by \c count in one atomic step and returns
+ * the first handle of the block, so a parallel generator reserves the
+ * handles of a whole batch up front and assigns them lock free —
+ * handle assignment stops being a serialization point.
+ *
+ * \return the first handle of the reserved block
+ * (first .. first + count - 1), or \c -1 when errors occurred.
+ */
+int
+dxf_document_reserve_handles
+(
+        DxfDocument *document,
+                /*!< the document owning the handle namespace. */
+        int count
+                /*!< number of handles to reserve; positive. */
+)
+{
+        if (document == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (-1);
+        }
+        if (count <= 0)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () an invalid count was passed.\n")),
+                  __FUNCTION__);
+                return (-1);
+        }
+        return ((int) __atomic_fetch_add (&document->handle_ceiling, count,
+                __ATOMIC_RELAXED) + 1);
+}
+
+
+/*!
+ * The admission limits enforced before parsing, when configured.
+ */
+static DxfReadLimits dxf_file_limits;
+
+/*!
+ * Whether \c dxf_read_set_limits has configured limits.
+ */
+static int dxf_file_limits_set = 0;
+
+
+/*!
+ * \brief Configure admission limits enforced before parsing.
+ *
+ * When limits are set, every subsequent \c dxf_file_read (and its
+ * streaming, document and parallel variants) first takes a byte level
+ * census of the file (see \c dxf_file_census) and rejects it when a
+ * limit is exceeded, before any entity is allocated — so a hostile or
+ * broken upload fails in the pre-scan instead of committing the
+ * process to parsing it.
+ */
+void
+dxf_read_set_limits
+(
+        const DxfReadLimits *limits
+                /*!< the limits to enforce, or \c NULL to lift them. */
+)
+{
+        if (limits == NULL)
+        {
+                dxf_file_limits_set = 0;
+                return;
+        }
+        dxf_file_limits = *limits;
+        dxf_file_limits_set = 1;
+}
+
+
+/*!
+ * \brief Check a file against the configured admission limits.
+ *
+ * \return \c EXIT_SUCCESS when no limits are configured or the file
+ * stays within them, or \c EXIT_FAILURE when the file is rejected.
+ */
+static int
+dxf_file_admit
+(
+        char *filename
+                /*!< filename of the file to check. */
+)
+{
+        DxfCensus *census;
+        int result;
+
+        if (!dxf_file_limits_set)
+        {
+                return (EXIT_SUCCESS);
+        }
+        census = dxf_file_census (filename);
+        if (census == NULL)
+        {
+                return (EXIT_FAILURE);
+        }
+        result = dxf_census_admit (census, &dxf_file_limits);
+        dxf_census_free (census);
+        return (result);
+}
+
+
+/*!
+ * \brief Function opens and reads a DXF file.
+ *
+ * After opening the DXF file with the name \c filename the file is read
+ * line by line until a line containing the \c SECTION keyword is
+ * encountered.\n
+ * At this point a function which reads the \c SECTION until the
+ * \c ENDSEC keyword is encountered and the invoked fuction returns here.
+ */
+int
+dxf_file_read
+(
+        char *filename
+                /*!< filename of input file (or device). */
+)
+{
+        return (dxf_file_read_stream (filename, NULL));
+}
+
+
+/*!
+ * \brief Position a freshly opened file behind the name of one
+ * section.
+ *
+ * Scans the \c SECTION markers of the file and skips every section
+ * ahead of the wanted one to its \c ENDSEC with the raw section
+ * scanner (see \c dxf_read_skip_section), so reaching the wanted
+ * section costs a byte scan instead of parsing the sections in front
+ * of it.
+ *
+ * \return \c EXIT_SUCCESS with the read position behind the section
+ * name, or \c EXIT_FAILURE when the file holds no such section.
+ */
+static int
+dxf_file_seek_section
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an input file (or device). */
+        const char *name
+                /*!< the section name to position behind, e.g.
+                 * "HEADER". */
+)
+{
+        char temp_string[DXF_MAX_STRING_LENGTH];
+
+        while (dxf_read_line (temp_string, fp) >= 1)
+        {
+                if (strcmp (temp_string, "SECTION") != 0)
+                {
+                        continue;
+                }
+                /* consume the "  2" group code and the section name. */
+                if (dxf_read_line (temp_string, fp) < 1)
+                {
+                        break;
+                }
+                if (strcmp (temp_string, "2") != 0)
+                {
+                        continue;
+                }
+                if (dxf_read_line (temp_string, fp) < 1)
+                {
+                        break;
+                }
+                if (strcmp (temp_string, name) == 0)
+                {
+                        return (EXIT_SUCCESS);
+                }
+                if (dxf_read_skip_section (fp) != EXIT_SUCCESS)
+                {
+                        break;
+                }
+        }
+        return (EXIT_FAILURE);
+}
+
+
+/*!
+ * \brief Read only the \c HEADER section of a DXF file.
+ *
+ * Jumps to the \c HEADER section, parses the header variables into
+ * \c header and stops — the sections behind it are never read, so a
+ * listing page wanting the extents of many files pays a section seek
+ * per file instead of a full parse.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_file_read_header_only
+(
+        char *filename,
+                /*!< filename of input file (or device). */
+        DxfHeader *header
+                /*!< receives the parsed header variables. */
+)
+{
+        DxfFile *fp;
+        int result;
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        if (header == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        fp = dxf_read_init (filename);
+        if (fp == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL file pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (dxf_file_seek_section (fp, "HEADER") != EXIT_SUCCESS)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () no HEADER section was found in: %s.\n")),
+                  __FUNCTION__, filename);
+                dxf_read_close (fp);
+                return (EXIT_FAILURE);
+        }
+        result = dxf_read_header (fp, *header);
+        dxf_read_close (fp);
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return ((result == TRUE) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+
+/*!
+ * \brief Read only the \c THUMBNAILIMAGE section of a DXF file.
+ *
+ * Jumps to the \c THUMBNAILIMAGE section, parses the preview image
+ * and stops — the dominating \c ENTITIES section is never read, so a
+ * gallery rendering previews for a directory of files extracts the
+ * few KB of image data from each at section seek cost.
+ *
+ * \return a pointer to the thumbnail, to be freed with
+ * \c dxf_thumbnail_free, or \c NULL when the file holds none or
+ * errors occurred.
+ */
+DxfThumbnail *
+dxf_file_read_thumbnail
+(
+        char *filename
+                /*!< filename of input file (or device). */
+)
+{
+        char temp_string[DXF_MAX_STRING_LENGTH];
+        DxfThumbnail *thumbnail;
+        DxfFile *fp;
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        fp = dxf_read_init (filename);
+        if (fp == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL file pointer was passed.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        if (dxf_file_seek_section (fp, "THUMBNAILIMAGE") != EXIT_SUCCESS)
+        {
+                /* a file without a preview is not an error. */
+                dxf_read_close (fp);
+                return (NULL);
+        }
+        /* consume the "  0" group code and the THUMBNAILIMAGE entity
+         * marker. */
+        if ((dxf_read_line (temp_string, fp) < 1)
+                || (strcmp (temp_string, "0") != 0)
+                || (dxf_read_line (temp_string, fp) < 1)
+                || (strcmp (temp_string, "THUMBNAILIMAGE") != 0))
+        {
+                fprintf (stderr,
+                  (_("Warning in %s () unexpected string encountered while reading line %ld from: %s.\n")),
+                  __FUNCTION__, fp->line_number, fp->filename);
+                dxf_read_close (fp);
+                return (NULL);
+        }
+        /* the section only exists since R2000; the version check of
+         * the reader has nothing else to go by in a targeted read. */
+        fp->acad_version_number = AutoCAD_2000;
+        thumbnail = dxf_thumbnail_new ();
+        thumbnail = dxf_thumbnail_init (thumbnail);
+        if (dxf_thumbnail_read (fp, thumbnail) == NULL)
+        {
+                dxf_thumbnail_free (thumbnail);
+                dxf_read_close (fp);
+                return (NULL);
+        }
+        dxf_read_close (fp);
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (thumbnail);
+}
+
+
+/*!
+ * \brief Function opens and reads a DXF file in streaming mode.
+ *
+ * Reads the file like \c dxf_file_read, but invokes the registered
+ * per-entity-type callbacks after each parsed entity (see
+ * \c DxfReadHandlers in entities.h) instead of keeping the entities,
+ * so files larger than RAM can be processed with O(1) memory.
+ */
+int
+dxf_file_read_stream
+(
+        char *filename,
+                /*!< filename of input file (or device). */
+        DxfReadHandlers *handlers
+                /*!< streaming callbacks, or \c NULL to read without
+                 * observing entities. */
+)
+{
+        return (dxf_file_read_document (filename, NULL, handlers));
+}
+
+
+/*!
+ * \brief Function opens and reads a DXF file into a document context.
+ *
+ * All non-entity parse state (header variables, thumbnail) lands in
+ * the caller-owned \c document instead of any file-scope state, so
+ * any number of files can be parsed concurrently, one context each.
+ */
+int
+dxf_file_read_document
+(
+        char *filename,
+                /*!< filename of input file (or device). */
+        DxfDocument *document,
+                /*!< per-parse document context, or \c NULL to discard
+                 * the non-entity sections. */
+        DxfReadHandlers *handlers
+                /*!< streaming callbacks, or \c NULL to read without
+                 * observing entities. */
+)
+{
+        char temp_string[DXF_MAX_STRING_LENGTH];
+        DxfFile *fp;
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        if (dxf_file_admit (filename) != EXIT_SUCCESS)
+        {
+                return (EXIT_FAILURE);
+        }
+        /* open the file */
+        fp = dxf_read_init (filename);
+        if (fp == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL file pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        fp->document = document;
+        fp->handlers = handlers;
+        if (handlers != NULL)
+        {
+                fp->diag = handlers->diag;
+                fp->trusted = handlers->trusted;
+                fp->parse_filter = handlers->parse_filter;
+        }
+        if ((handlers != NULL) && (handlers->progress != NULL))
+        {
+                dxf_read_set_progress (fp, handlers->progress,
+                        handlers->user_data);
+        }
+        while (fp)
+        {
+                if (dxf_read_line (temp_string, fp) < 1)
+                {
+                        /* the logical end of the stream; testing
+                         * feof () on the underlying FILE never fires
+                         * for gzip input, which reads through
+                         * gzread (). */
+                        break;
+                }
+                if (strcmp (temp_string, "999") == 0)
+                {
+                        /* Some apps put meta data regarding the correct
+                         * loading of libraries in front of dxf data
+                         * (sections, tables, entities etc.).\n
+                         * Capture the comments in the document instead
+                         * of flushing them to stdout mid-parse: some
+                         * sources emit hundreds of thousands of 999
+                         * lines and unbatched pipe I/O dominated the
+                         * read loop. */
+                        dxf_read_line (temp_string, fp);
+                        if (fp->document != NULL)
+                        {
+                                if (dxf_document_capture_comment (fp->document,
+                                        temp_string) != EXIT_SUCCESS)
+                                {
+                                        fprintf (stderr,
+                                          (_("Error in %s () could not allocate memory.\n")),
+                                          __FUNCTION__);
+                                        dxf_read_close (fp);
+                                        return (EXIT_FAILURE);
+                                }
+                        }
+                        else if (fp->diag != NULL)
+                        {
+                                dxf_diag_report (fp, DXF_DIAG_NOTE,
+                                  "DXF comment: %s\n", temp_string);
+                        }
+                }
+                else if (strcmp (temp_string, "0") == 0)
+                {
+                /* Now follows some meaningfull dxf data. */
+                        while (dxf_read_line (temp_string, fp) == 1)
+                        {
+                                if (strcmp (temp_string, "SECTION") == 0)
+                                {
+                                         /* We have found the beginning of a
+                                          * SECTION. */
+                                        dxf_section_read (fp);
+                                }
+                                else
+                                {
+                                         /* We were expecting a dxf SECTION and
+                                          * got something else. */
+                                        fprintf (stderr,
+                                          (_("Warning: in line %ld \"SECTION\" was expected, \"%s\" was found.\n")),
+                                          fp->line_number, temp_string);
+                                }
+                        }
+                }
+                else
+                {
+                        fprintf (stderr,
+                          (_("Warning: unexpected string encountered while reading line %ld from: %s.\n")),
+                          fp->line_number , fp->filename);
+                        return (EXIT_FAILURE);
+                }
+        }
+        if (fp->progress != NULL)
+        {
+                /* a final invocation, so monitors see the parse
+                 * complete. */
+                fp->progress (fp->bytes_consumed, fp->bytes_total,
+                        fp->progress_user_data);
+        }
+        dxf_read_close (fp);
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * The largest number of sections \c dxf_file_read_parallel parses; a
+ * well formed drawing holds at most eight.
+ */
+#define DXF_PARALLEL_MAX_SECTIONS 16
+
+
+/*!
+ * \brief One section parsed by its own thread.
+ */
+typedef struct
+dxf_parallel_section
+{
+        char name[DXF_MAX_STRING_LENGTH];
+                /*!< the section name. */
+        size_t offset;
+                /*!< byte offset just behind the \c SECTION marker
+                 * line. */
+        char *filename;
+                /*!< filename of the input file. */
+        DxfDocument *document;
+                /*!< per-parse document context, or \c NULL. */
+        DxfReadHandlers *handlers;
+                /*!< streaming callbacks, or \c NULL. */
+        pthread_t thread;
+                /*!< the thread parsing this section. */
+        int result;
+                /*!< \c EXIT_SUCCESS or \c EXIT_FAILURE. */
+} DxfParallelSection;
+
+
+/*!
+ * \brief Parse one section on its own thread.
+ *
+ * Opens an independent memory mapping of the file, positions it behind
+ * the \c SECTION marker of the assigned section and dispatches on the
+ * section name the way \c dxf_section_read does.
+ */
+static void *
+dxf_file_read_section_worker
+(
+        void *arg
+                /*!< the \c DxfParallelSection to parse. */
+)
+{
+        char temp_string[DXF_MAX_STRING_LENGTH];
+        DxfParallelSection *section;
+        DxfHeader header;
+        DxfFile *fp;
+
+        section = (DxfParallelSection *) arg;
+        section->result = EXIT_FAILURE;
+        fp = dxf_read_init (section->filename);
+        if (fp == NULL)
+        {
+                return (NULL);
+        }
+        if (dxf_read_mmap_init (fp) != EXIT_SUCCESS)
+        {
+                dxf_read_close (fp);
+                return (NULL);
+        }
+        fp->mmap_pos = section->offset;
+        fp->document = section->document;
+        fp->handlers = section->handlers;
+        if (section->handlers != NULL)
+        {
+                fp->diag = section->handlers->diag;
+                fp->trusted = section->handlers->trusted;
+                fp->parse_filter = section->handlers->parse_filter;
+        }
+        /* consume the "  2" group code and the section name. */
+        if ((dxf_read_line (temp_string, fp) != 1)
+                || (strcmp (temp_string, "2") != 0)
+                || (dxf_read_line (temp_string, fp) != 1))
+        {
+                fprintf (stderr,
+                  (_("Warning in %s () unexpected string encountered while reading line %ld from: %s.\n")),
+                  __FUNCTION__, fp->line_number, fp->filename);
+                dxf_read_close (fp);
+                return (NULL);
+        }
+        section->result = EXIT_SUCCESS;
+        if (!dxf_parse_filter_section (fp->parse_filter, section->name))
+        {
+                /* the filter spec rejects this section: leave it
+                 * unread. */
+                dxf_read_close (fp);
+                return (NULL);
+        }
+        if (strcmp (section->name, "HEADER") == 0)
+        {
+                if (fp->document != NULL)
+                {
+                        dxf_read_header (fp, fp->document->header);
+                }
+                else
+                {
+                        dxf_read_header (fp, header);
+                }
+        }
+        else if (strcmp (section->name, "CLASSES") == 0)
+        {
+                if (fp->document != NULL)
+                {
+                        fp->document->classes_list = dxf_class_section_read (fp);
+                }
+                else
+                {
+                        dxf_class_section_read (fp);
+                }
+        }
+        else if (strcmp (section->name, "ENTITIES") == 0)
+        {
+                section->result = dxf_entities_read (fp);
+        }
+        /* TABLES, BLOCKS, OBJECTS and THUMBNAILIMAGE have no parser
+         * yet (see dxf_section_read) and are left unread. */
+        dxf_read_close (fp);
+        return (NULL);
+}
+
+
+/*!
+ * \brief Function opens and reads a DXF file with one thread per
+ * section.
+ *
+ * A cheap byte level pre-scan over a memory mapping locates the
+ * \c SECTION markers; every located section is then parsed by its own
+ * thread into the caller-owned \c document through an independent
+ * mapping, so the smaller sections are parsed entirely in the shadow of
+ * the dominating \c ENTITIES section instead of before it.\n
+ * With streaming callbacks registered, the callbacks of different
+ * sections run concurrently and have to be thread safe; callbacks of
+ * one section are still invoked in file order.\n
+ * Files that cannot be memory mapped (pipes, devices) fall back to the
+ * sequential \c dxf_file_read_document.
+ */
+int
+dxf_file_read_parallel
+(
+        char *filename,
+                /*!< filename of input file (or device). */
+        DxfDocument *document,
+                /*!< per-parse document context, or \c NULL to discard
+                 * the non-entity sections. */
+        DxfReadHandlers *handlers
+                /*!< streaming callbacks, or \c NULL to read without
+                 * observing entities. */
+)
+{
+        char temp_string[DXF_MAX_STRING_LENGTH];
+        DxfParallelSection sections[DXF_PARALLEL_MAX_SECTIONS];
+        DxfFile *fp;
+        int count;
+        int zero;
+        int result;
+        int i;
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        if (dxf_file_admit (filename) != EXIT_SUCCESS)
+        {
+                return (EXIT_FAILURE);
+        }
+        fp = dxf_read_init (filename);
+        if (fp == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL file pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (dxf_read_mmap_init (fp) != EXIT_SUCCESS)
+        {
+                /* not mappable: parse sequentially. */
+                dxf_read_close (fp);
+                return (dxf_file_read_document (filename, document, handlers));
+        }
+        /* the pre-scan: slice lines off the mapping and note the byte
+         * offset and name behind every SECTION marker. */
+        count = 0;
+        zero = FALSE;
+        while (dxf_read_line (temp_string, fp) == 1)
+        {
+                if (zero && (strcmp (temp_string, "SECTION") == 0)
+                        && (count < DXF_PARALLEL_MAX_SECTIONS))
+                {
+                        sections[count].offset = fp->mmap_pos;
+                        if ((dxf_read_line (temp_string, fp) != 1)
+                                || (dxf_read_line (temp_string, fp) != 1))
+                        {
+                                break;
+                        }
+                        strcpy (sections[count].name, temp_string);
+                        sections[count].filename = filename;
+                        sections[count].document = document;
+                        sections[count].handlers = handlers;
+                        count++;
+                        zero = FALSE;
+                        continue;
+                }
+                zero = (strcmp (temp_string, "0") == 0);
+        }
+        dxf_read_close (fp);
+        if (count == 0)
+        {
+                fprintf (stderr,
+                  (_("Warning in %s () no SECTION was found in: %s.\n")),
+                  __FUNCTION__, filename);
+                return (EXIT_FAILURE);
+        }
+        for (i = 0; i < count; i++)
+        {
+                if (pthread_create (&sections[i].thread, NULL,
+                        dxf_file_read_section_worker, &sections[i]) != 0)
+                {
+                        /* no thread: parse in this one. */
+                        dxf_file_read_section_worker (&sections[i]);
+                        sections[i].thread = pthread_self ();
+                }
+        }
+        result = EXIT_SUCCESS;
+        for (i = 0; i < count; i++)
+        {
+                if (!pthread_equal (sections[i].thread, pthread_self ()))
+                {
+                        pthread_join (sections[i].thread, NULL);
+                }
+                if (sections[i].result != EXIT_SUCCESS)
+                {
+                        result = EXIT_FAILURE;
+                }
+        }
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (result);
+}
+
+
+/*!
+ * The entity type tags of the slots handed from the parsing thread to
+ * the consuming thread by \c dxf_file_read_stream_async.
+ */
+enum dxf_slot_type
+{
+        DXF_SLOT_3DFACE,
+        DXF_SLOT_ARC,
+        DXF_SLOT_CIRCLE,
+        DXF_SLOT_ELLIPSE,
+        DXF_SLOT_INSERT,
+        DXF_SLOT_LINE,
+        DXF_SLOT_LWPOLYLINE,
+        DXF_SLOT_POINT,
+        DXF_SLOT_POLYLINE,
+        DXF_SLOT_SEQEND,
+        DXF_SLOT_SOLID,
+        DXF_SLOT_TEXT,
+        DXF_SLOT_VERTEX
+};
+
+
+/*!
+ * \brief One parsed entity in flight between the parsing thread and
+ * the consuming thread.
+ *
+ * The entity is a struct copy of the parser's scratch struct with the
+ * pointer members duplicated on push (the string members, and the
+ * vertex array of a \c LWPOLYLINE), because the scratch and its
+ * strings are reused for the next record of the type while the slot
+ * may still sit in the ring; the copies are freed after the consumer
+ * callback ran.
+ */
+typedef struct
+dxf_entity_slot
+{
+        int type;
+                /*!< the \c dxf_slot_type tag of \c entity. */
+        union
+        {
+                Dxf3dface face;
+                DxfArc arc;
+                DxfCircle circle;
+                DxfEllipse ellipse;
+                DxfInsert insert;
+                DxfLine line;
+                DxfLWPolyline lwpolyline;
+                DxfPoint point;
+                DxfPolyline polyline;
+                DxfSeqend seqend;
+                DxfSolid solid;
+                DxfText text;
+                DxfVertex vertex;
+        } entity;
+                /*!< the parsed entity. */
+} DxfEntitySlot;
+
+
+/*!
+ * \brief The state shared between the parsing thread and the
+ * consuming thread of \c dxf_file_read_stream_async.
+ */
+typedef struct
+dxf_async_stream
+{
+        char *filename;
+                /*!< filename of the input file. */
+        DxfReadHandlers *handlers;
+                /*!< the consumer's streaming callbacks. */
+        DxfRing *ring;
+                /*!< the handoff ring of \c DxfEntitySlot. */
+        int abort;
+                /*!< set by the consuming thread when a callback asked
+                 * to stop; the parsing thread polls it. */
+        int result;
+                /*!< the parse result. */
+} DxfAsyncStream;
+
+
+/*!
+ * Terminator of the per-type string member offset tables.
+ */
+#define DXF_ASYNC_STRINGS_END ((size_t) -1)
+
+
+static const size_t dxf_file_async_strings_face[] =
+{
+        offsetof (Dxf3dface, linetype),
+        offsetof (Dxf3dface, layer),
+        offsetof (Dxf3dface, dictionary_owner_soft),
+        offsetof (Dxf3dface, dictionary_owner_hard),
+        DXF_ASYNC_STRINGS_END
+};
+static const size_t dxf_file_async_strings_arc[] =
+{
+        offsetof (DxfArc, linetype),
+        offsetof (DxfArc, layer),
+        offsetof (DxfArc, dictionary_owner_soft),
+        offsetof (DxfArc, dictionary_owner_hard),
+        DXF_ASYNC_STRINGS_END
+};
+static const size_t dxf_file_async_strings_circle[] =
+{
+        offsetof (DxfCircle, linetype),
+        offsetof (DxfCircle, layer),
+        offsetof (DxfCircle, dictionary_owner_soft),
+        offsetof (DxfCircle, dictionary_owner_hard),
+        DXF_ASYNC_STRINGS_END
+};
+static const size_t dxf_file_async_strings_ellipse[] =
+{
+        offsetof (DxfEllipse, linetype),
+        offsetof (DxfEllipse, layer),
+        offsetof (DxfEllipse, dictionary_owner_soft),
+        offsetof (DxfEllipse, dictionary_owner_hard),
+        DXF_ASYNC_STRINGS_END
+};
+static const size_t dxf_file_async_strings_insert[] =
+{
+        offsetof (DxfInsert, linetype),
+        offsetof (DxfInsert, layer),
+        offsetof (DxfInsert, dictionary_owner_soft),
+        offsetof (DxfInsert, dictionary_owner_hard),
+        offsetof (DxfInsert, block_name),
+        DXF_ASYNC_STRINGS_END
+};
+static const size_t dxf_file_async_strings_line[] =
+{
+        offsetof (DxfLine, linetype),
+        offsetof (DxfLine, layer),
+        offsetof (DxfLine, dictionary_owner_soft),
+        offsetof (DxfLine, dictionary_owner_hard),
+        DXF_ASYNC_STRINGS_END
+};
+static const size_t dxf_file_async_strings_lwpolyline[] =
+{
+        offsetof (DxfLWPolyline, linetype),
+        offsetof (DxfLWPolyline, layer),
+        offsetof (DxfLWPolyline, dictionary_owner_soft),
+        offsetof (DxfLWPolyline, dictionary_owner_hard),
+        DXF_ASYNC_STRINGS_END
+};
+static const size_t dxf_file_async_strings_point[] =
+{
+        offsetof (DxfPoint, linetype),
+        offsetof (DxfPoint, layer),
+        offsetof (DxfPoint, dictionary_owner_soft),
+        offsetof (DxfPoint, dictionary_owner_hard),
+        DXF_ASYNC_STRINGS_END
+};
+static const size_t dxf_file_async_strings_polyline[] =
+{
+        offsetof (DxfPolyline, linetype),
+        offsetof (DxfPolyline, layer),
+        offsetof (DxfPolyline, dictionary_owner_soft),
+        offsetof (DxfPolyline, dictionary_owner_hard),
+        DXF_ASYNC_STRINGS_END
+};
+static const size_t dxf_file_async_strings_seqend[] =
+{
+        offsetof (DxfSeqend, app_name),
+        offsetof (DxfSeqend, linetype),
+        offsetof (DxfSeqend, layer),
+        offsetof (DxfSeqend, dictionary_owner_soft),
+        offsetof (DxfSeqend, dictionary_owner_hard),
+        DXF_ASYNC_STRINGS_END
+};
+static const size_t dxf_file_async_strings_solid[] =
+{
+        offsetof (DxfSolid, linetype),
+        offsetof (DxfSolid, layer),
+        offsetof (DxfSolid, dictionary_owner_soft),
+        offsetof (DxfSolid, dictionary_owner_hard),
+        DXF_ASYNC_STRINGS_END
+};
+static const size_t dxf_file_async_strings_text[] =
+{
+        offsetof (DxfText, linetype),
+        offsetof (DxfText, layer),
+        offsetof (DxfText, dictionary_owner_soft),
+        offsetof (DxfText, dictionary_owner_hard),
+        offsetof (DxfText, text_value),
+        offsetof (DxfText, text_style),
+        DXF_ASYNC_STRINGS_END
+};
+static const size_t dxf_file_async_strings_vertex[] =
+{
+        offsetof (DxfVertex, linetype),
+        offsetof (DxfVertex, layer),
+        offsetof (DxfVertex, dictionary_owner_soft),
+        offsetof (DxfVertex, dictionary_owner_hard),
+        DXF_ASYNC_STRINGS_END
+};
+
+
+/*!
+ * The string member offsets of each slot entity, indexed by the
+ * \c dxf_slot_type tag.
+ */
+static const size_t *dxf_file_async_strings[] =
+{
+        dxf_file_async_strings_face,
+        dxf_file_async_strings_arc,
+        dxf_file_async_strings_circle,
+        dxf_file_async_strings_ellipse,
+        dxf_file_async_strings_insert,
+        dxf_file_async_strings_line,
+        dxf_file_async_strings_lwpolyline,
+        dxf_file_async_strings_point,
+        dxf_file_async_strings_polyline,
+        dxf_file_async_strings_seqend,
+        dxf_file_async_strings_solid,
+        dxf_file_async_strings_text,
+        dxf_file_async_strings_vertex
+};
+
+
+/*!
+ * \brief Duplicate the string members of a slot entity.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred; already duplicated members are freed again, so the slot
+ * is not half owned.
+ */
+static int
+dxf_file_async_strings_dup
+(
+        void *entity,
+                /*!< the slot entity, a shallow copy of the scratch. */
+        const size_t *offsets
+                /*!< the string member offsets of the entity type. */
+)
+{
+        char **member;
+        int i;
+        int j;
+
+        for (i = 0; offsets[i] != DXF_ASYNC_STRINGS_END; i++)
+        {
+                member = (char **) ((char *) entity + offsets[i]);
+                if (*member == NULL)
+                {
+                        continue;
+                }
+                *member = strdup (*member);
+                if (*member == NULL)
+                {
+                        fprintf (stderr,
+                          (_("Error in %s () could not allocate memory.\n")),
+                          __FUNCTION__);
+                        for (j = 0; j < i; j++)
+                        {
+                                member = (char **) ((char *) entity + offsets[j]);
+                                free (*member);
+                        }
+                        return (EXIT_FAILURE);
+                }
+        }
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Free the duplicated pointer members of a slot.
+ */
+static void
+dxf_file_async_slot_free
+(
+        DxfEntitySlot *slot
+                /*!< the slot whose copies to free. */
+)
+{
+        const size_t *offsets;
+        char **member;
+        int i;
+
+        offsets = dxf_file_async_strings[slot->type];
+        for (i = 0; offsets[i] != DXF_ASYNC_STRINGS_END; i++)
+        {
+                member = (char **) ((char *) &slot->entity + offsets[i]);
+                free (*member);
+        }
+        if (slot->type == DXF_SLOT_LWPOLYLINE)
+        {
+                free (slot->entity.lwpolyline.vertices);
+        }
+}
+
+
+/*!
+ * \brief Push one parsed entity slot to the consuming thread.
+ *
+ * Duplicates the pointer members of the slot first (see
+ * \c DxfEntitySlot).
+ *
+ * \return \c EXIT_SUCCESS, or \c EXIT_FAILURE when the consumer asked
+ * to stop, which aborts the parse.
+ */
+static int
+dxf_file_async_push
+(
+        DxfAsyncStream *stream,
+                /*!< the shared stream state. */
+        DxfEntitySlot *slot
+                /*!< the filled slot. */
+)
+{
+        if (__atomic_load_n (&stream->abort, __ATOMIC_ACQUIRE))
+        {
+                return (EXIT_FAILURE);
+        }
+        if (dxf_file_async_strings_dup (&slot->entity,
+                dxf_file_async_strings[slot->type]) != EXIT_SUCCESS)
+        {
+                return (EXIT_FAILURE);
+        }
+        if (slot->type == DXF_SLOT_LWPOLYLINE)
+        {
+                DxfLWPolyline *lwpolyline;
+
+                lwpolyline = &slot->entity.lwpolyline;
+                if (lwpolyline->number_vertices > 0)
+                {
+                        DxfLWPolylineVertex *vertices;
+
+                        vertices = malloc (
+                                (size_t) lwpolyline->number_vertices
+                                * sizeof (DxfLWPolylineVertex));
+                        if (vertices == NULL)
+                        {
+                                fprintf (stderr,
+                                  (_("Error in %s () could not allocate memory.\n")),
+                                  __FUNCTION__);
+                                lwpolyline->vertices = NULL;
+                                dxf_file_async_slot_free (slot);
+                                return (EXIT_FAILURE);
+                        }
+                        memcpy (vertices, lwpolyline->vertices,
+                                (size_t) lwpolyline->number_vertices
+                                * sizeof (DxfLWPolylineVertex));
+                        lwpolyline->vertices = vertices;
+                        lwpolyline->vertices_size =
+                                lwpolyline->number_vertices;
+                }
+                else
+                {
+                        lwpolyline->vertices = NULL;
+                        lwpolyline->vertices_size = 0;
+                }
+        }
+        dxf_ring_push_wait (stream->ring, slot);
+        return (EXIT_SUCCESS);
+}
+
+
+static int
+dxf_file_async_filter (const char *entity_name, void *user_data)
+{
+        DxfAsyncStream *stream;
+
+        stream = (DxfAsyncStream *) user_data;
+        return (stream->handlers->filter (entity_name,
+                stream->handlers->user_data));
+}
+
+
+static void
+dxf_file_async_progress (uint64_t bytes_consumed, uint64_t bytes_total, void *user_data)
+{
+        DxfAsyncStream *stream;
+
+        stream = (DxfAsyncStream *) user_data;
+        stream->handlers->progress (bytes_consumed, bytes_total,
+                stream->handlers->user_data);
+}
+
+
+static int
+dxf_file_async_unknown (DxfFile *fp, const char *entity_name, void *user_data)
+{
+        DxfAsyncStream *stream;
+
+        stream = (DxfAsyncStream *) user_data;
+        return (stream->handlers->unknown (fp, entity_name,
+                stream->handlers->user_data));
+}
+
+
+static int
+dxf_file_async_face (DxfFile *fp, Dxf3dface *face, void *user_data)
+{
+        DxfEntitySlot slot;
+
+        slot.type = DXF_SLOT_3DFACE;
+        slot.entity.face = *face;
+        return (dxf_file_async_push ((DxfAsyncStream *) user_data, &slot));
+}
+
+
+static int
+dxf_file_async_arc (DxfFile *fp, DxfArc *arc, void *user_data)
+{
+        DxfEntitySlot slot;
+
+        slot.type = DXF_SLOT_ARC;
+        slot.entity.arc = *arc;
+        return (dxf_file_async_push ((DxfAsyncStream *) user_data, &slot));
+}
+
+
+static int
+dxf_file_async_circle (DxfFile *fp, DxfCircle *circle, void *user_data)
+{
+        DxfEntitySlot slot;
+
+        slot.type = DXF_SLOT_CIRCLE;
+        slot.entity.circle = *circle;
+        return (dxf_file_async_push ((DxfAsyncStream *) user_data, &slot));
+}
+
+
+static int
+dxf_file_async_ellipse (DxfFile *fp, DxfEllipse *ellipse, void *user_data)
+{
+        DxfEntitySlot slot;
+
+        slot.type = DXF_SLOT_ELLIPSE;
+        slot.entity.ellipse = *ellipse;
+        return (dxf_file_async_push ((DxfAsyncStream *) user_data, &slot));
+}
+
+
+static int
+dxf_file_async_insert (DxfFile *fp, DxfInsert *insert, void *user_data)
+{
+        DxfEntitySlot slot;
+
+        slot.type = DXF_SLOT_INSERT;
+        slot.entity.insert = *insert;
+        return (dxf_file_async_push ((DxfAsyncStream *) user_data, &slot));
+}
+
+
+static int
+dxf_file_async_line (DxfFile *fp, DxfLine *line, void *user_data)
+{
+        DxfEntitySlot slot;
+
+        slot.type = DXF_SLOT_LINE;
+        slot.entity.line = *line;
+        return (dxf_file_async_push ((DxfAsyncStream *) user_data, &slot));
+}
+
+
+static int
+dxf_file_async_lwpolyline (DxfFile *fp, DxfLWPolyline *lwpolyline, void *user_data)
+{
+        DxfEntitySlot slot;
+
+        slot.type = DXF_SLOT_LWPOLYLINE;
+        slot.entity.lwpolyline = *lwpolyline;
+        return (dxf_file_async_push ((DxfAsyncStream *) user_data, &slot));
+}
+
+
+static int
+dxf_file_async_point (DxfFile *fp, DxfPoint *point, void *user_data)
+{
+        DxfEntitySlot slot;
+
+        slot.type = DXF_SLOT_POINT;
+        slot.entity.point = *point;
+        return (dxf_file_async_push ((DxfAsyncStream *) user_data, &slot));
+}
+
+
+static int
+dxf_file_async_polyline (DxfFile *fp, DxfPolyline *polyline, void *user_data)
+{
+        DxfEntitySlot slot;
+
+        slot.type = DXF_SLOT_POLYLINE;
+        slot.entity.polyline = *polyline;
+        return (dxf_file_async_push ((DxfAsyncStream *) user_data, &slot));
+}
+
+
+static int
+dxf_file_async_seqend (DxfFile *fp, DxfSeqend *seqend, void *user_data)
+{
+        DxfEntitySlot slot;
+
+        slot.type = DXF_SLOT_SEQEND;
+        slot.entity.seqend = *seqend;
+        return (dxf_file_async_push ((DxfAsyncStream *) user_data, &slot));
+}
+
+
+static int
+dxf_file_async_solid (DxfFile *fp, DxfSolid *solid, void *user_data)
+{
+        DxfEntitySlot slot;
+
+        slot.type = DXF_SLOT_SOLID;
+        slot.entity.solid = *solid;
+        return (dxf_file_async_push ((DxfAsyncStream *) user_data, &slot));
+}
+
+
+static int
+dxf_file_async_text (DxfFile *fp, DxfText *text, void *user_data)
+{
+        DxfEntitySlot slot;
+
+        slot.type = DXF_SLOT_TEXT;
+        slot.entity.text = *text;
+        return (dxf_file_async_push ((DxfAsyncStream *) user_data, &slot));
+}
+
+
+static int
+dxf_file_async_vertex (DxfFile *fp, DxfVertex *vertex, void *user_data)
+{
+        DxfEntitySlot slot;
+
+        slot.type = DXF_SLOT_VERTEX;
+        slot.entity.vertex = *vertex;
+        return (dxf_file_async_push ((DxfAsyncStream *) user_data, &slot));
+}
+
+
+/*!
+ * \brief Main loop of the parsing thread of
+ * \c dxf_file_read_stream_async.
+ *
+ * Parses with wrapped callbacks pushing slots into the handoff ring
+ * (see \c dxf_file_async_push).\n
+ * The ring is closed when the parse ends, which releases the waiting
+ * consumer.
+ */
+static void *
+dxf_file_read_stream_async_main
+(
+        void *arg
+                /*!< the \c DxfAsyncStream to parse for. */
+)
+{
+        char temp_string[DXF_MAX_STRING_LENGTH];
+        DxfAsyncStream *stream;
+        DxfReadHandlers handlers;
+        DxfFile *fp;
+
+        stream = (DxfAsyncStream *) arg;
+        stream->result = EXIT_FAILURE;
+        memset (&handlers, 0, sizeof (handlers));
+        handlers.user_data = stream;
+        handlers.diag = stream->handlers->diag;
+        handlers.trusted = stream->handlers->trusted;
+        /* filter, progress and unknown run on this thread, forwarded
+         * with the consumer's own user data. */
+        if (stream->handlers->filter != NULL)
+        {
+                handlers.filter = dxf_file_async_filter;
+        }
+        if (stream->handlers->progress != NULL)
+        {
+                handlers.progress = dxf_file_async_progress;
+        }
+        if (stream->handlers->unknown != NULL)
+        {
+                handlers.unknown = dxf_file_async_unknown;
+        }
+        if (stream->handlers->face != NULL)
+        {
+                handlers.face = dxf_file_async_face;
+        }
+        if (stream->handlers->arc != NULL)
+        {
+                handlers.arc = dxf_file_async_arc;
+        }
+        if (stream->handlers->circle != NULL)
+        {
+                handlers.circle = dxf_file_async_circle;
+        }
+        if (stream->handlers->ellipse != NULL)
+        {
+                handlers.ellipse = dxf_file_async_ellipse;
+        }
+        if (stream->handlers->insert != NULL)
+        {
+                handlers.insert = dxf_file_async_insert;
+        }
+        if (stream->handlers->line != NULL)
+        {
+                handlers.line = dxf_file_async_line;
+        }
+        if (stream->handlers->lwpolyline != NULL)
+        {
+                handlers.lwpolyline = dxf_file_async_lwpolyline;
+        }
+        if (stream->handlers->point != NULL)
+        {
+                handlers.point = dxf_file_async_point;
+        }
+        if (stream->handlers->polyline != NULL)
+        {
+                handlers.polyline = dxf_file_async_polyline;
+        }
+        if (stream->handlers->seqend != NULL)
+        {
+                handlers.seqend = dxf_file_async_seqend;
+        }
+        if (stream->handlers->solid != NULL)
+        {
+                handlers.solid = dxf_file_async_solid;
+        }
+        if (stream->handlers->text != NULL)
+        {
+                handlers.text = dxf_file_async_text;
+        }
+        if (stream->handlers->vertex != NULL)
+        {
+                handlers.vertex = dxf_file_async_vertex;
+        }
+        fp = dxf_read_init (stream->filename);
+        if (fp == NULL)
+        {
+                dxf_ring_close (stream->ring);
+                return (NULL);
+        }
+        dxf_read_mmap_init (fp);
+        fp->handlers = &handlers;
+        fp->diag = handlers.diag;
+        fp->trusted = handlers.trusted;
+        stream->result = EXIT_SUCCESS;
+        for (;;)
+        {
+                if (dxf_read_line (temp_string, fp) < 1)
+                {
+                        break;
+                }
+                if (strcmp (temp_string, "SECTION") != 0)
+                {
+                        continue;
+                }
+                /* consume the "  2" group code and the section name. */
+                if (dxf_read_line (temp_string, fp) < 1)
+                {
+                        break;
+                }
+                if (strcmp (temp_string, "2") != 0)
+                {
+                        continue;
+                }
+                if (dxf_read_line (temp_string, fp) < 1)
+                {
+                        break;
+                }
+                if (strcmp (temp_string, "ENTITIES") == 0)
+                {
+                        if (dxf_entities_read (fp) != EXIT_SUCCESS)
+                        {
+                                stream->result = EXIT_FAILURE;
+                        }
+                }
+                /* other sections carry no entities and fall through
+                 * the SECTION scan. */
+        }
+        dxf_read_close (fp);
+        dxf_ring_close (stream->ring);
+        return (NULL);
+}
 
 
 /*!
- * \brief Function opens and reads a DXF file.
- * 
- * After opening the DXF file with the name \c filename the file is read
- * line by line until a line containing the \c SECTION keyword is
- * encountered.\n
- * At this point a function which reads the \c SECTION until the
- * \c ENDSEC keyword is encountered and the invoked fuction returns here.
+ * \brief Read a DXF file with the parse and the callbacks on two
+ * threads.
+ *
+ * A background thread parses the \c ENTITIES section while the
+ * calling thread runs the entity callbacks, so nontrivial per-entity
+ * consumer work overlaps the parse; the two threads meet only at a
+ * lock-free handoff ring (see ring.h) of parsed entity slots.\n
+ * Callbacks receive a \c NULL \c DxfFile pointer (the parser's handle
+ * belongs to the other thread) and an entity copy that is valid for
+ * the duration of the callback; the
+ * \c filter, \c progress and \c unknown callbacks keep running on the
+ * parsing thread.\n
+ * For consumers doing only trivial per-entity work the sequential
+ * \c dxf_file_read_stream avoids the copy per entity.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
  */
 int
-dxf_file_read
+dxf_file_read_stream_async
 (
-        char *filename
+        char *filename,
+                /*!< filename of input file (or device). */
+        DxfReadHandlers *handlers
+                /*!< streaming callbacks (see \c DxfReadHandlers). */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        DxfAsyncStream stream;
+        DxfEntitySlot slot;
+        pthread_t parser;
+        int status;
+
+        /* Do some basic checks. */
+        if (filename == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (handlers == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (handlers->passthrough != NULL)
+        {
+                /* pass-through writes from another thread would race
+                 * the output: read sequentially instead. */
+                return (dxf_file_read_stream (filename, handlers));
+        }
+        stream.filename = filename;
+        stream.handlers = handlers;
+        stream.abort = FALSE;
+        stream.result = EXIT_FAILURE;
+        stream.ring = dxf_ring_new (0, sizeof (DxfEntitySlot));
+        if (stream.ring == NULL)
+        {
+                return (EXIT_FAILURE);
+        }
+        if (pthread_create (&parser, NULL,
+                dxf_file_read_stream_async_main, &stream) != 0)
+        {
+                /* no thread: read sequentially. */
+                dxf_ring_free (stream.ring);
+                return (dxf_file_read_stream (filename, handlers));
+        }
+        while (dxf_ring_pop_wait (stream.ring, &slot))
+        {
+                status = EXIT_SUCCESS;
+                switch (slot.type)
+                {
+                        case DXF_SLOT_3DFACE:
+                                status = handlers->face (NULL,
+                                        &slot.entity.face, handlers->user_data);
+                                break;
+                        case DXF_SLOT_ARC:
+                                status = handlers->arc (NULL,
+                                        &slot.entity.arc, handlers->user_data);
+                                break;
+                        case DXF_SLOT_CIRCLE:
+                                status = handlers->circle (NULL,
+                                        &slot.entity.circle, handlers->user_data);
+                                break;
+                        case DXF_SLOT_ELLIPSE:
+                                status = handlers->ellipse (NULL,
+                                        &slot.entity.ellipse, handlers->user_data);
+                                break;
+                        case DXF_SLOT_INSERT:
+                                status = handlers->insert (NULL,
+                                        &slot.entity.insert, handlers->user_data);
+                                break;
+                        case DXF_SLOT_LINE:
+                                status = handlers->line (NULL,
+                                        &slot.entity.line, handlers->user_data);
+                                break;
+                        case DXF_SLOT_LWPOLYLINE:
+                                status = handlers->lwpolyline (NULL,
+                                        &slot.entity.lwpolyline, handlers->user_data);
+                                break;
+                        case DXF_SLOT_POINT:
+                                status = handlers->point (NULL,
+                                        &slot.entity.point, handlers->user_data);
+                                break;
+                        case DXF_SLOT_POLYLINE:
+                                status = handlers->polyline (NULL,
+                                        &slot.entity.polyline, handlers->user_data);
+                                break;
+                        case DXF_SLOT_SEQEND:
+                                status = handlers->seqend (NULL,
+                                        &slot.entity.seqend, handlers->user_data);
+                                break;
+                        case DXF_SLOT_SOLID:
+                                status = handlers->solid (NULL,
+                                        &slot.entity.solid, handlers->user_data);
+                                break;
+                        case DXF_SLOT_TEXT:
+                                status = handlers->text (NULL,
+                                        &slot.entity.text, handlers->user_data);
+                                break;
+                        case DXF_SLOT_VERTEX:
+                                status = handlers->vertex (NULL,
+                                        &slot.entity.vertex, handlers->user_data);
+                                break;
+                }
+                dxf_file_async_slot_free (&slot);
+                if ((status != EXIT_SUCCESS)
+                        && (!__atomic_load_n (&stream.abort, __ATOMIC_ACQUIRE)))
+                {
+                        /* stop the parser; keep draining so a full
+                         * ring never blocks it forever. */
+                        __atomic_store_n (&stream.abort, TRUE,
+                                __ATOMIC_RELEASE);
+                }
+        }
+        pthread_join (parser, NULL);
+        dxf_ring_free (stream.ring);
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (stream.result);
+}
+
+
+/*!
+ * \brief Incrementally rewrite a DXF file with per-entity dirty
+ * tracking.
+ *
+ * The input is memory mapped and streamed to the output file: every
+ * byte outside the \c ENTITIES section is copied verbatim, entities a
+ * callback marked with \c dxf_entity_touch () are reserialized from
+ * the modified scratch struct, and every untouched record is copied
+ * through as raw bytes.\n
+ * A job touching a handful of entities in a very large file thus pays
+ * serialization only for what changed, instead of reserializing the
+ * whole drawing.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_file_update
+(
+        char *filename,
                 /*!< filename of input file (or device). */
+        char *output_filename,
+                /*!< filename of the rewritten output file. */
+        DxfReadHandlers *handlers,
+                /*!< streaming callbacks; a callback modifying the
+                 * scratch entity it was handed marks it with
+                 * \c dxf_entity_touch (). */
+        int acad_version_number
+                /*!< AutoCAD version number reserialized records are
+                 * written for. */
 )
 {
         char temp_string[DXF_MAX_STRING_LENGTH];
         DxfFile *fp;
+        DxfFile *out;
+        size_t copied_upto;
+        size_t zero_start;
+        size_t line_start;
+        int found_entities;
+        int result;
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        /* open the file */
+        if ((filename == NULL) || (output_filename == NULL)
+                || (handlers == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
         fp = dxf_read_init (filename);
         if (fp == NULL)
         {
@@ -71,53 +3378,129 @@ dxf_file_read
                   __FUNCTION__);
                 return (EXIT_FAILURE);
         }
-        while (fp)
+        if ((dxf_read_mmap_init (fp) != EXIT_SUCCESS)
+                || (fp->mmap_base == NULL))
         {
-                dxf_read_line (temp_string, fp);
-                if (strcmp (temp_string, "999") == 0)
+                fprintf (stderr,
+                  (_("Error in %s () could not memory map: %s.\n")),
+                  __FUNCTION__, filename);
+                dxf_read_close (fp);
+                return (EXIT_FAILURE);
+        }
+        out = malloc (sizeof (DxfFile));
+        if (out == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory for a DxfFile struct.\n")),
+                  __FUNCTION__);
+                dxf_read_close (fp);
+                return (EXIT_FAILURE);
+        }
+        memset (out, 0, sizeof (DxfFile));
+        out->fp = fopen (output_filename, "w");
+        if (out->fp == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not open file: %s for writing.\n")),
+                  __FUNCTION__, output_filename);
+                free (out);
+                dxf_read_close (fp);
+                return (EXIT_FAILURE);
+        }
+        out->filename = output_filename;
+        out->acad_version_number = acad_version_number;
+        out->write_version.acad_version_number = -1;
+        out->last_id_code = -1;
+        handlers->passthrough = out;
+        handlers->update = TRUE;
+        fp->handlers = handlers;
+        fp->diag = handlers->diag;
+        fp->trusted = handlers->trusted;
+        fp->parse_filter = handlers->parse_filter;
+        result = EXIT_SUCCESS;
+        copied_upto = 0;
+        found_entities = FALSE;
+        /* scan for the ENTITIES section; everything in front of it is
+         * copied verbatim. */
+        for (;;)
+        {
+                line_start = fp->mmap_pos;
+                if (dxf_read_line (temp_string, fp) == EOF)
                 {
-                        /* Flush dxf comments to stdout as some apps put meta
-                         * data regarding the correct loading of libraries in
-                         * front of dxf data (sections, tables, entities etc.
-                         */
-                        dxf_read_line (temp_string, fp);
-                        fprintf (stdout, "DXF comment: %s\n", temp_string);
+                        break;
                 }
-                else if (strcmp (temp_string, "0") == 0)
+                if (strcmp (temp_string, "0") != 0)
                 {
-                /* Now follows some meaningfull dxf data. */
-                        while (!feof (fp->fp))
-                        {
-                                dxf_read_line (temp_string, fp);
-                                if (strcmp (temp_string, "SECTION") == 0)
-                                {
-                                         /* We have found the beginning of a
-                                          * SECTION. */
-                                        dxf_section_read (fp);
-                                }
-                                else
-                                {
-                                         /* We were expecting a dxf SECTION and
-                                          * got something else. */
-                                        fprintf (stderr,
-                                          (_("Warning: in line %d \"SECTION\" was expected, \"%s\" was found.\n")),
-                                          fp->line_number, temp_string);
-                                }
-                        }
+                        continue;
                 }
-                else
+                zero_start = line_start;
+                if (dxf_read_line (temp_string, fp) == EOF)
                 {
-                        fprintf (stderr,
-                          (_("Warning: unexpected string encountered while reading line %d from: %s.\n")),
-                          fp->line_number , fp->filename);
-                        return (EXIT_FAILURE);
+                        break;
+                }
+                if (strcmp (temp_string, "SECTION") != 0)
+                {
+                        continue;
+                }
+                if (dxf_read_line (temp_string, fp) == EOF)
+                {
+                        break;
+                }
+                if (strcmp (temp_string, "2") != 0)
+                {
+                        continue;
+                }
+                if (dxf_read_line (temp_string, fp) == EOF)
+                {
+                        break;
+                }
+                if (strcmp (temp_string, "ENTITIES") != 0)
+                {
+                        continue;
+                }
+                found_entities = TRUE;
+                if (dxf_read_copy_raw (fp, out->fp, copied_upto, zero_start)
+                        != EXIT_SUCCESS)
+                {
+                        result = EXIT_FAILURE;
+                        break;
+                }
+                fprintf (out->fp, "  0\nSECTION\n  2\nENTITIES\n");
+                if (dxf_entities_read (fp) != EXIT_SUCCESS)
+                {
+                        result = EXIT_FAILURE;
+                        break;
+                }
+                /* the entities loop consumed through the ENDSEC value
+                 * line; re-emit the marker and copy the remainder of
+                 * the file verbatim. */
+                fprintf (out->fp, "  0\nENDSEC\n");
+                copied_upto = fp->mmap_pos;
+                break;
+        }
+        if (result == EXIT_SUCCESS)
+        {
+                if (!found_entities)
+                {
+                        /* no ENTITIES section: the whole file is
+                         * copied verbatim. */
+                        copied_upto = 0;
+                }
+                if (dxf_read_copy_raw (fp, out->fp, copied_upto,
+                        fp->mmap_size) != EXIT_SUCCESS)
+                {
+                        result = EXIT_FAILURE;
                 }
         }
+        handlers->passthrough = NULL;
+        handlers->update = FALSE;
+        fclose (out->fp);
+        free (out);
         dxf_read_close (fp);
 #if DEBUG
         DXF_DEBUG_END
 #endif
-        return (EXIT_SUCCESS);
+        return (result);
 }
 
 
@@ -140,11 +3523,6 @@ dxf_file_write
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        extern char *dxf_entities_list;
-        extern char *dxf_objects_list;
-//        DxfBlock *dxf_blocks_list;
-        extern DxfThumbnail *dxf_thumbnail;
-
         /* Do some basic checks. */
         if (fp == NULL)
         {
@@ -169,6 +3547,176 @@ dxf_file_write
 }
 
 
+/*!
+ * \brief Open a file for append-mode streaming of entities.
+ *
+ * Producers generating entities continuously (plotter feeds, long
+ * running exports) do not have to buffer a whole drawing: the
+ * \c ENTITIES section is opened here, entities are appended
+ * incrementally with their \c *_write functions, periodic
+ * \c dxf_file_append_sync () calls make the output durable, and
+ * \c dxf_file_append_close () finalizes the \c ENDSEC / \c EOF
+ * bracketing.\n
+ * Memory stays bounded by the writer buffer regardless of how long
+ * the stream runs.
+ *
+ * \return a \c DxfFile to append entities to, or \c NULL when errors
+ * occurred.
+ */
+DxfFile *
+dxf_file_append_open
+(
+        char *filename,
+                /*!< filename of the output file (or device). */
+        int acad_version_number
+                /*!< AutoCAD version number the entities are written
+                 * for. */
+)
+{
+        DxfFile *fp;
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        if (filename == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        fp = malloc (sizeof (DxfFile));
+        if (fp == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory for a DxfFile struct.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        memset (fp, 0, sizeof (DxfFile));
+        fp->fp = fopen (filename, "w");
+        if (fp->fp == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not open file: %s for writing.\n")),
+                  __FUNCTION__, filename);
+                free (fp);
+                return (NULL);
+        }
+        fp->filename = strdup (filename);
+        fp->acad_version_number = acad_version_number;
+        fp->write_version.acad_version_number = -1;
+        fp->last_id_code = -1;
+        if (dxf_writer_attach (fp, 0) != EXIT_SUCCESS)
+        {
+                fclose (fp->fp);
+                free (fp->filename);
+                free (fp);
+                return (NULL);
+        }
+        dxf_write_group_string (fp, 0, "SECTION");
+        dxf_write_group_string (fp, 2, "ENTITIES");
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (fp);
+}
+
+
+/*!
+ * \brief Make the entities appended so far durable.
+ *
+ * The writer buffer is flushed and the file is fsynced, so everything
+ * appended before the call survives a crash of the producer or the
+ * machine; the stream remains open for further entities.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_file_append_sync
+(
+        DxfFile *fp
+                /*!< file pointer to output file (or device). */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        if (fp == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL file pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (dxf_writer_flush (fp) != EXIT_SUCCESS)
+        {
+                return (EXIT_FAILURE);
+        }
+        if (fflush (fp->fp) != 0)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () while writing to: %s.\n")),
+                  __FUNCTION__, fp->filename);
+                return (EXIT_FAILURE);
+        }
+        if (fsync (fileno (fp->fp)) != 0)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not sync: %s.\n")),
+                  __FUNCTION__, fp->filename);
+                return (EXIT_FAILURE);
+        }
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Finalize and close an append-mode entity stream.
+ *
+ * The \c ENDSEC / \c EOF bracketing is written, buffered output is
+ * flushed and the file is closed; the \c DxfFile is released.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_file_append_close
+(
+        DxfFile *fp
+                /*!< file pointer to output file (or device). */
+)
+{
+        int result;
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        if (fp == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL file pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        dxf_write_group_string (fp, 0, "ENDSEC");
+        dxf_file_write_eof (fp);
+        result = dxf_writer_detach (fp);
+        if (fclose (fp->fp) != 0)
+        {
+                result = EXIT_FAILURE;
+        }
+        free (fp->filename);
+        free (fp);
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (result);
+}
+
+
 /*!
  * \brief Write DXF output for an End Of File marker.
  */
@@ -191,7 +3739,7 @@ dxf_file_write_eof
                 return (EXIT_FAILURE);
         }
         /* Start writing output. */
-        fprintf (fp->fp, "  0\nEOF\n");
+        dxf_write_group_string (fp, 0, "EOF");
 #if DEBUG
         DXF_DEBUG_END
 #endif
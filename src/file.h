@@ -37,7 +37,12 @@
 
 
 #include <stdio.h>
+#include "arena.h"
 #include "block.h"
+#include "census.h"
+#include "comment.h"
+#include "config.h"
+#include "drawing.h"
 #include "global.h"
 #include "class.h"
 #include "entities.h"
@@ -47,14 +52,141 @@
 #include "table.h"
 #include "thumbnail.h"
 #include "util.h"
+#include "writer.h"
 
 
+/*!
+ * \brief Per-parse document context.
+ *
+ * Holds everything a parse produces besides entities, so no state
+ * lives in file-scope globals and any number of files can be parsed
+ * concurrently, each with its own \c DxfDocument.
+ */
+typedef struct
+dxf_document
+{
+        DxfConfig config;
+                /*!< the runtime limits and growth policies of this
+                 * document (see config.h); seeded from the process
+                 * wide default by \c dxf_document_new, so set the
+                 * default with \c dxf_config_set() before
+                 * \c dxf_document_read() to size a parse. */
+        DxfHeader header;
+                /*!< the parsed \c HEADER section variables. */
+        DxfThumbnail *thumbnail;
+                /*!< the parsed \c THUMBNAILIMAGE section, or
+                 * \c NULL. */
+        DxfClass *classes_list;
+                /*!< the parsed \c CLASSES section: a list shared with
+                 * every document carrying the same section bytes and
+                 * owned by the section cache (see
+                 * \c dxf_class_section_read), so it is not freed with
+                 * the document. */
+        char *entities_list;
+                /*!< the parsed \c ENTITIES section. */
+        char *objects_list;
+                /*!< the parsed \c OBJECTS section. */
+        struct dxf_objects *objects;
+                /*!< the typed \c OBJECTS section storage (see
+                 * objects.h), or \c NULL; owned by the document. */
+        char *blocks_list;
+                /*!< the parsed \c BLOCKS section. */
+        DxfDrawing *drawing;
+                /*!< the retained entities of the \c ENTITIES section,
+                 * in file order, or \c NULL when the document was not
+                 * produced by \c dxf_document_read.\n
+                 * The entities live in \c arena and are freed with
+                 * the document. */
+        DxfArena *arena;
+                /*!< the arena holding the retained entities and their
+                 * strings, or \c NULL. */
+        DxfComment *comments;
+                /*!< the group 999 comments encountered before the
+                 * sections, in file order, or \c NULL when there were
+                 * none.\n
+                 * The comment structs and strings live in \c arena and
+                 * are freed with the document; do not pass them to
+                 * \c dxf_comment_free. */
+        DxfComment *comments_last;
+                /*!< the last comment of \c comments, for appending in
+                 * file order. */
+        int handle_ceiling;
+                /*!< the highest group 5 handle (\c id_code) among the
+                 * retained entities, maintained during the parse and
+                 * on checkpoint or segment restore; \c 0 when no
+                 * handle was seen.\n
+                 * \c dxf_document_next_handle() allocates past it in
+                 * O(1) instead of scanning the drawing for the
+                 * maximum. */
+        size_t retain_skip;
+                /*!< number of entities the retain handlers skip
+                 * before copying again; set by \c dxf_parse_resume()
+                 * to replay the already checkpointed prefix of a file
+                 * without re-retaining it. */
+        void *share_base;
+                /*!< the mapped shared memory segment of a document
+                 * produced by \c dxf_document_attach, or \c NULL; the
+                 * entities of \c drawing live in the segment and are
+                 * unmapped with the document. */
+        size_t share_size;
+                /*!< size of the mapped segment in bytes. */
+} DxfDocument;
+
+
+DxfDocument *
+dxf_document_new ();
+void
+dxf_document_free (DxfDocument *document);
+DxfDocument *
+dxf_document_read (char *filename);
+int
+dxf_document_write (DxfDocument *document, char *filename, int acad_version_number);
+DxfComment *
+dxf_document_comments (DxfDocument *document);
+size_t
+dxf_document_comment_count (DxfDocument *document);
+int
+dxf_document_share (DxfDocument *document, const char *name);
+DxfDocument *
+dxf_document_attach (const char *name);
+size_t
+dxf_document_dedup (DxfDocument *document);
+int
+dxf_document_next_handle (DxfDocument *document);
+int
+dxf_document_reserve_handles (DxfDocument *document, int count);
+int
+dxf_parse_checkpoint (DxfDocument *document, const char *path);
+DxfDocument *
+dxf_parse_resume (const char *path, char *filename);
+void
+dxf_read_set_limits (const DxfReadLimits *limits);
 int
 dxf_file_read (char *filename);
 int
+dxf_file_read_header_only (char *filename, DxfHeader *header);
+DxfThumbnail *
+dxf_file_read_thumbnail (char *filename);
+int
+dxf_file_read_stream (char *filename, DxfReadHandlers *handlers);
+int
+dxf_file_read_stream_async (char *filename, DxfReadHandlers *handlers);
+int
+dxf_file_read_document (char *filename, DxfDocument *document, DxfReadHandlers *handlers);
+int
+dxf_file_read_parallel (char *filename, DxfDocument *document, DxfReadHandlers *handlers);
+int
+dxf_file_update (char *filename, char *output_filename, DxfReadHandlers *handlers, int acad_version_number);
+int
 dxf_file_write (DxfFile *fp, DxfHeader dxf_header, DxfClass dxf_classes_list, DxfTable dxf_tables_list);
 int
 dxf_file_write_eof (DxfFile *fp);
+DxfFile *
+dxf_file_append_open (char *filename, int acad_version_number);
+int
+dxf_file_append_sync (DxfFile *fp);
+int
+dxf_file_append_close (DxfFile *fp);
 
 
 #endif /* LIBDXF_SRC_FILE_H */
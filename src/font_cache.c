@@ -0,0 +1,218 @@
+/*!
+ * \file font_cache.c
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Functions for the document-level font resolution cache of
+ * \c STYLE records.
+ *
+ * Fit-to-frame text measurement hits style lookups millions of times
+ * per drawing, and each lookup used to stat and load the SHX or TTF
+ * file the style references all over again.\n
+ * The cache resolves a style once: the first lookup interns the style
+ * name, loads the referenced font files through the shared raster
+ * cache (see \c dxf_image_cache_map) and pins the outcome — including
+ * a missing font, so absent files are not re-stated per string —
+ * and every later lookup is one hash probe.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#include "font_cache.h"
+#include "util.h"
+
+
+/*!
+ * \brief Allocate an empty font cache.
+ *
+ * \return a pointer to the cache, or \c NULL when no memory was
+ * allocated.
+ */
+DxfFontCache *
+dxf_font_cache_new ()
+{
+        DxfFontCache *cache;
+
+        cache = calloc (1, sizeof (DxfFontCache));
+        if (cache == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        cache->index = dxf_symbol_table_new ();
+        if (cache->index == NULL)
+        {
+                free (cache);
+                return (NULL);
+        }
+        cache->files = dxf_image_cache_new ();
+        if (cache->files == NULL)
+        {
+                dxf_symbol_table_free (cache->index);
+                free (cache);
+                return (NULL);
+        }
+        return (cache);
+}
+
+
+/*!
+ * \brief Resolve a \c STYLE record through the font cache, loading
+ * its font files on first use.
+ *
+ * The first lookup of a style name loads the primary and big font
+ * files through the shared file cache; a font which cannot be
+ * resolved leaves its mapping \c NULL in the entry, and the failure
+ * is remembered so later lookups do not retry the filesystem.
+ *
+ * \return the cache entry of the style, or \c NULL when errors
+ * occurred.
+ */
+DxfFontCacheEntry *
+dxf_font_cache_resolve
+(
+        DxfFontCache *cache,
+                /*!< the cache to resolve through. */
+        DxfStyle *style
+                /*!< the \c STYLE record to resolve. */
+)
+{
+        DxfFontCacheEntry *entry;
+
+        if ((cache == NULL) || (style == NULL)
+                || (style->style_name == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        entry = dxf_font_cache_find (cache, style->style_name);
+        if (entry != NULL)
+        {
+                entry->lookups++;
+                return (entry);
+        }
+        entry = calloc (1, sizeof (DxfFontCacheEntry));
+        if (entry == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        entry->style_name = dxf_string_intern (style->style_name);
+        entry->style = style;
+        if ((style->primary_font_filename != NULL)
+                && (strcmp (style->primary_font_filename, "") != 0))
+        {
+                entry->font = dxf_image_cache_map (cache->files,
+                        style->primary_font_filename);
+        }
+        if ((style->big_font_filename != NULL)
+                && (strcmp (style->big_font_filename, "") != 0))
+        {
+                entry->big_font = dxf_image_cache_map (cache->files,
+                        style->big_font_filename);
+        }
+        entry->lookups = 1;
+        if (dxf_symbol_table_insert (cache->index, entry->style_name, entry)
+                != EXIT_SUCCESS)
+        {
+                free (entry);
+                return (NULL);
+        }
+        entry->next = cache->entries;
+        cache->entries = entry;
+        cache->length++;
+        return (entry);
+}
+
+
+/*!
+ * \brief Look up the cache entry of a style name without resolving
+ * it.
+ *
+ * \return the entry, or \c NULL when the style has not been resolved
+ * yet.
+ */
+DxfFontCacheEntry *
+dxf_font_cache_find
+(
+        DxfFontCache *cache,
+                /*!< the cache to search. */
+        const char *style_name
+                /*!< the style name to look up. */
+)
+{
+        if ((cache == NULL) || (style_name == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        return ((DxfFontCacheEntry *) dxf_symbol_table_find (cache->index,
+                style_name));
+}
+
+
+/*!
+ * \brief Free a font cache, unmapping every loaded font file.
+ *
+ * The interned style names stay in the shared string pool (released
+ * by \c dxf_string_intern_free) and the referenced \c STYLE records
+ * remain owned by the caller.
+ */
+void
+dxf_font_cache_free
+(
+        DxfFontCache *cache
+                /*!< the cache to free, or \c NULL. */
+)
+{
+        DxfFontCacheEntry *entry;
+        DxfFontCacheEntry *next;
+
+        if (cache == NULL)
+        {
+                return;
+        }
+        for (entry = cache->entries; entry != NULL; entry = next)
+        {
+                next = entry->next;
+                free (entry);
+        }
+        dxf_image_cache_free (cache->files);
+        dxf_symbol_table_free (cache->index);
+        free (cache);
+}
+
+
+/* EOF */
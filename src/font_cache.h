@@ -0,0 +1,122 @@
+/*!
+ * \file font_cache.h
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Header for the document-level font resolution cache of
+ * \c STYLE records.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#ifndef LIBDXF_SRC_FONT_CACHE_H
+#define LIBDXF_SRC_FONT_CACHE_H
+
+
+#include "global.h"
+#include "symbol_table.h"
+#include "image_cache.h"
+#include "style.h"
+
+
+/*!
+ * \brief One resolved text style in the font cache.
+ *
+ * Text-extent passes look a style up once per measured string; the
+ * entry pins the outcome of the filesystem resolution — the shared
+ * mapping of the font file, or the fact that it is missing — so a
+ * repeated lookup costs one hash probe and never re-stats the font.
+ */
+typedef struct
+dxf_font_cache_entry
+{
+        char *style_name;
+                /*!< the style name; interned, so entries of equal
+                 * names compare equal by pointer. */
+        DxfStyle *style;
+                /*!< the resolved \c STYLE record, or \c NULL. */
+        DxfImageCacheEntry *font;
+                /*!< the shared mapping of the primary font file, or
+                 * \c NULL when the file could not be resolved; styles
+                 * naming the same font file share one mapping. */
+        DxfImageCacheEntry *big_font;
+                /*!< the shared mapping of the big font file, or
+                 * \c NULL when the style names none or it could not
+                 * be resolved. */
+        size_t lookups;
+                /*!< number of lookups which returned this entry;
+                 * diagnostic only. */
+        struct dxf_font_cache_entry *next;
+                /*!< the next entry of the cache. */
+} DxfFontCacheEntry;
+
+
+/*!
+ * \brief A cache over the text styles of a document, keyed by style
+ * name, with the referenced font files loaded lazily.
+ */
+typedef struct
+dxf_font_cache
+{
+        DxfSymbolTable *index;
+                /*!< hash map from style name to
+                 * \c DxfFontCacheEntry. */
+        DxfImageCache *files;
+                /*!< filename-keyed cache of the loaded font files,
+                 * shared between styles. */
+        DxfFontCacheEntry *entries;
+                /*!< the entries, most recently added first. */
+        size_t length;
+                /*!< number of entries in the cache. */
+} DxfFontCache;
+
+
+DxfFontCache *
+dxf_font_cache_new ();
+DxfFontCacheEntry *
+dxf_font_cache_resolve
+(
+        DxfFontCache *cache,
+        DxfStyle *style
+);
+DxfFontCacheEntry *
+dxf_font_cache_find
+(
+        DxfFontCache *cache,
+        const char *style_name
+);
+void
+dxf_font_cache_free
+(
+        DxfFontCache *cache
+);
+
+
+#endif /* LIBDXF_SRC_FONT_CACHE_H */
+
+
+/* EOF */
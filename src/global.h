@@ -170,6 +170,66 @@
           __FILE__, __LINE__, __FUNCTION__);
 
 
+/*!
+ * \brief Per-file cache of the write-path version predicates.
+ *
+ * The entity writers decide per optional field whether the target
+ * \c acad_version_number carries it; the answers only change when
+ * the version does, so they are hoisted here once (see
+ * \c dxf_write_version_init) and the writers test the cached flags.
+ */
+typedef struct
+dxf_write_version
+{
+    int acad_version_number;
+        /*!< the version the predicates were computed for; the writers
+         * refresh the cache when it no longer matches the file. */
+    int until_r11;
+        /*!< nonzero for AutoCAD release 11 and earlier. */
+    int since_r12;
+        /*!< nonzero for AutoCAD release 12 and later. */
+    int since_r13;
+        /*!< nonzero for AutoCAD release 13 and later. */
+    int since_r14;
+        /*!< nonzero for AutoCAD release 14 and later. */
+} DxfWriteVersion;
+
+
+/*!
+ * \brief Cached tessellation of an analytic curve entity.
+ *
+ * Stores the vertices of the most recent tessellation of a \c CIRCLE
+ * or \c ARC together with the tolerance and the geometry they were
+ * computed for, so repeated renders at the same zoom level reuse the
+ * vertices instead of redoing the trigonometry (see
+ * \c dxf_circle_tessellate and \c dxf_arc_tessellate).
+ */
+typedef struct
+dxf_tessellation_cache
+{
+    double tolerance;
+        /*!< the chordal tolerance the vertices were computed for. */
+    double x0;
+        /*!< X-value of the center the vertices were computed for. */
+    double y0;
+        /*!< Y-value of the center the vertices were computed for. */
+    double radius;
+        /*!< the radius the vertices were computed for. */
+    double start_angle;
+        /*!< the start angle the vertices were computed for, in
+         * degrees; \c 0.0 for a full circle. */
+    double end_angle;
+        /*!< the end angle the vertices were computed for, in degrees;
+         * \c 360.0 for a full circle. */
+    int length;
+        /*!< number of cached vertices. */
+    double *x;
+        /*!< X-values of the vertices, in the entity OCS plane. */
+    double *y;
+        /*!< Y-values of the vertices, in the entity OCS plane. */
+} DxfTessellationCache;
+
+
 /*!
  * \brief DXF definition of a DXF file.
  */
@@ -180,8 +240,117 @@ dxf_file
         /*!< File handle. */
     char *filename;
         /*!< Dxf filename. */
-    int line_number;
-        /*!< Last line read. */
+    long line_number;
+        /*!< Last line read.\n
+         * 64 bit on LP64 platforms, so line counts survive files
+         * beyond 2^31 lines. */
+    uint64_t bytes_consumed;
+        /*!< Number of bytes consumed from the file so far; for
+         * compressed files the compressed offset, so it compares
+         * against \c bytes_total. */
+    uint64_t bytes_total;
+        /*!< Size of the file in bytes, or \c 0 when unknown (pipes and
+         * devices). */
+    void (*progress) (uint64_t bytes_consumed, uint64_t bytes_total, void *user_data);
+        /*!< Progress callback (see \c dxf_read_set_progress) invoked
+         * while reading, or \c NULL. */
+    void *progress_user_data;
+        /*!< passed through to \c progress. */
+    uint64_t progress_next;
+        /*!< Byte offset at which \c progress fires next. */
+    char *read_buffer;
+        /*!< Block read buffer, or \c NULL when reading unbuffered
+         * through stdio. */
+    size_t read_buffer_size;
+        /*!< Allocated size of \c read_buffer in bytes. */
+    size_t read_buffer_pos;
+        /*!< Read position within \c read_buffer. */
+    size_t read_buffer_avail;
+        /*!< Number of valid bytes in \c read_buffer. */
+    char *line_buffer;
+        /*!< Growable line buffer owned by the reader (see
+         * \c dxf_read_line_grow), or \c NULL until the first use. */
+    size_t line_buffer_size;
+        /*!< Allocated size of \c line_buffer in bytes. */
+    char *mmap_base;
+        /*!< Start of the memory mapped file contents, or \c NULL when
+         * not reading from a memory mapping. */
+    size_t mmap_size;
+        /*!< Length of the memory mapping in bytes. */
+    size_t mmap_pos;
+        /*!< Read position within the memory mapping. */
+    int binary;
+        /*!< Nonzero when the file is a binary DXF file (autodetected by
+         * \c dxf_read_init from the sentinel); lines handed out by
+         * \c dxf_read_line and friends are synthesized from the binary
+         * groups. */
+    int binary_code_size;
+        /*!< Size in bytes of a group code in a binary DXF file: 1 for
+         * R12 and earlier files (with the 255 escape for extended
+         * codes), 2 for R13 and later files. */
+    int binary_pending_code;
+        /*!< Group code whose value line is handed out by the next read,
+         * or \c -1 when the next line is a group code line. */
+    void *gzip;
+        /*!< zlib stream handle (a \c gzFile) when the file is gzip
+         * compressed (autodetected by \c dxf_read_init from the magic
+         * bytes), or \c NULL; the block buffer is refilled from the
+         * inflated stream, so decompression overlaps parsing. */
+    struct dxf_read_prefetch *prefetch;
+        /*!< background read ahead thread state (see
+         * \c dxf_read_prefetch_init), or \c NULL; blocks are read (and
+         * inflated) ahead of the parser, so the file reads overlap
+         * parsing. */
+    struct dxf_arena *arena;
+        /*!< Optional bump allocating arena (see arena.h) entities and
+         * strings are allocated from while reading, or \c NULL to use
+         * plain \c malloc / \c strdup.\n
+         * The arena is owned by the caller and is not released by
+         * \c dxf_read_close. */
+    int trusted;
+        /*!< When nonzero, the input is trusted to be well formed
+         * (machine generated by a known writer): the field parser
+         * runs its validation-free specialization and the readers
+         * skip default-repair of omitted members, trading checks for
+         * throughput.\n
+         * Never enable this for files of unknown origin. */
+    int intern_strings;
+        /*!< When nonzero, string values read from the file are interned
+         * in the shared string pool (see \c dxf_string_intern) instead
+         * of being duplicated per entity. */
+    struct dxf_document *document;
+        /*!< Per-parse document context (see file.h) receiving the
+         * non-entity sections, or \c NULL.\n
+         * Owned by the caller; not released by \c dxf_read_close. */
+    struct dxf_read_handlers *handlers;
+        /*!< Optional streaming callbacks (see entities.h) invoked per
+         * parsed entity instead of materializing the file, or \c NULL. */
+    struct dxf_diag *diag;
+        /*!< Optional deferred diagnostics buffer (see diag.h) the
+         * per-record parser warnings are collected in instead of
+         * being printed inline, or \c NULL to print to \c stderr.\n
+         * Owned by the caller; not released by \c dxf_read_close. */
+    const struct dxf_parse_filter *parse_filter;
+        /*!< Optional declarative parse-time filter (see entities.h)
+         * restricting the parse to selected sections, entity types
+         * and layers; filtered-out records are skipped at byte level
+         * by the record scanner, or \c NULL to parse everything.\n
+         * Owned by the caller; not released by \c dxf_read_close. */
+    int entity_dirty;
+        /*!< Set by \c dxf_entity_touch () when a streaming callback
+         * modified the scratch entity it was handed; cleared before
+         * every callback.\n
+         * In update mode (see the \c update member of
+         * \c DxfReadHandlers) a dirty entity is reserialized, an
+         * untouched one is copied through as raw bytes. */
+    struct dxf_writer *writer;
+        /*!< Optional buffered output writer (see writer.h) the
+         * dxf_write_group_* functions collect output in, or \c NULL to
+         * write straight through stdio. */
+    DxfWriteVersion write_version;
+        /*!< Cached write-path version predicates (see
+         * \c dxf_write_version_init); refreshed by the entity writers
+         * when \c acad_version_number no longer matches. */
     int last_id_code;
         /*!< Last id code written to, or read from, file. */
     int acad_version_number;
@@ -339,6 +508,12 @@ dxf_file
 #  define DXF_MAX_STRING_LENGTH 2049
 #endif
 
+/*!
+ * The default block size, in bytes, for the buffered block reader in a
+ * \c DxfFile.
+ */
+#define DXF_READ_BUFFER_SIZE 262144
+
 /*!
  * The maximum number of colors in a \c DxfColorIndex.
  */
@@ -448,11 +623,6 @@ dxf_file
  */
 #define DXF_DEFAULT_TEXTSTYLE "STANDARD"
 
-/*!
- * \brief The maximum number of layers in a dxf drawing file.
- */
-#define DXF_MAX_LAYERS 2048
-
 /*!
  * \brief Application name.\n
  * This field will always be the string "ACAD".
@@ -0,0 +1,285 @@
+/*!
+ * \file handle.c
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Functions for a handle (\c id_code) hash index for entity
+ * lookup.
+ *
+ * Entities carry their handle in \c id_code (group code 5), but
+ * resolving a handle reference used to mean walking every entity
+ * chain, so jobs resolving many owner or dictionary handles degraded
+ * to O(n^2).\n
+ * An index built while parsing (for instance from the streaming read
+ * callbacks) turns each lookup into a single hash probe.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#include "global.h"
+#include "handle.h"
+
+
+/*!
+ * \brief Hash a handle value into a bucket number.
+ */
+static size_t
+dxf_handle_hash
+(
+        int id_code,
+                /*!< the entity handle. */
+        size_t bucket_count
+                /*!< number of buckets; a power of two. */
+)
+{
+        /* Fibonacci hashing; handles are often sequential and a plain
+         * modulo would fill one bucket run after another. */
+        return (((unsigned int) id_code * 2654435761u)
+                & (bucket_count - 1));
+}
+
+
+/*!
+ * \brief Allocate an empty \c DxfHandleIndex.
+ *
+ * \return a pointer to the index, or \c NULL when no memory was
+ * allocated.
+ */
+DxfHandleIndex *
+dxf_handle_index_new ()
+{
+        DxfHandleIndex *index;
+
+        index = malloc (sizeof (DxfHandleIndex));
+        if (index == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        index->bucket_count = DXF_HANDLE_INDEX_BUCKETS;
+        index->length = 0;
+        index->buckets = calloc (index->bucket_count,
+                sizeof (DxfHandleEntry *));
+        if (index->buckets == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                free (index);
+                return (NULL);
+        }
+        return (index);
+}
+
+
+/*!
+ * \brief Double the bucket array of a \c DxfHandleIndex and rehash all
+ * entries.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when no memory
+ * was allocated (the index stays usable at its old size).
+ */
+static int
+dxf_handle_index_grow
+(
+        DxfHandleIndex *index
+                /*!< the index to grow. */
+)
+{
+        DxfHandleEntry **buckets;
+        DxfHandleEntry *entry;
+        DxfHandleEntry *next;
+        size_t bucket_count;
+        size_t bucket;
+        size_t i;
+
+        bucket_count = index->bucket_count * 2;
+        buckets = calloc (bucket_count, sizeof (DxfHandleEntry *));
+        if (buckets == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        for (i = 0; i < index->bucket_count; i++)
+        {
+                entry = index->buckets[i];
+                while (entry != NULL)
+                {
+                        next = entry->next;
+                        bucket = dxf_handle_hash (entry->id_code, bucket_count);
+                        entry->next = buckets[bucket];
+                        buckets[bucket] = entry;
+                        entry = next;
+                }
+        }
+        free (index->buckets);
+        index->buckets = buckets;
+        index->bucket_count = bucket_count;
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Insert an entity under its handle into a \c DxfHandleIndex.
+ *
+ * An existing entry for the same handle is updated to point at the new
+ * entity.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_handle_index_insert
+(
+        DxfHandleIndex *index,
+                /*!< the index to insert into. */
+        int id_code,
+                /*!< the entity handle (group code 5). */
+        void *entity
+                /*!< the entity to index. */
+)
+{
+        DxfHandleEntry *entry;
+        size_t bucket;
+
+        if ((index == NULL) || (entity == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        bucket = dxf_handle_hash (id_code, index->bucket_count);
+        for (entry = index->buckets[bucket]; entry != NULL; entry = entry->next)
+        {
+                if (entry->id_code == id_code)
+                {
+                        entry->entity = entity;
+                        return (EXIT_SUCCESS);
+                }
+        }
+        if (index->length >= index->bucket_count)
+        {
+                if (dxf_handle_index_grow (index) == EXIT_SUCCESS)
+                {
+                        bucket = dxf_handle_hash (id_code, index->bucket_count);
+                }
+        }
+        entry = malloc (sizeof (DxfHandleEntry));
+        if (entry == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        entry->id_code = id_code;
+        entry->entity = entity;
+        entry->next = index->buckets[bucket];
+        index->buckets[bucket] = entry;
+        index->length++;
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Look up an entity by its handle in a \c DxfHandleIndex.
+ *
+ * \return a pointer to the indexed entity, or \c NULL when the handle
+ * is not in the index.
+ */
+void *
+dxf_handle_index_find
+(
+        DxfHandleIndex *index,
+                /*!< the index to search. */
+        int id_code
+                /*!< the entity handle (group code 5). */
+)
+{
+        DxfHandleEntry *entry;
+        size_t bucket;
+
+        if (index == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        bucket = dxf_handle_hash (id_code, index->bucket_count);
+        for (entry = index->buckets[bucket]; entry != NULL; entry = entry->next)
+        {
+                if (entry->id_code == id_code)
+                {
+                        return (entry->entity);
+                }
+        }
+        return (NULL);
+}
+
+
+/*!
+ * \brief Free a \c DxfHandleIndex and all its entries.
+ *
+ * The indexed entities themselves are not touched.
+ */
+void
+dxf_handle_index_free
+(
+        DxfHandleIndex *index
+                /*!< the index to free. */
+)
+{
+        DxfHandleEntry *entry;
+        DxfHandleEntry *next;
+        size_t i;
+
+        if (index == NULL)
+        {
+                return;
+        }
+        for (i = 0; i < index->bucket_count; i++)
+        {
+                entry = index->buckets[i];
+                while (entry != NULL)
+                {
+                        next = entry->next;
+                        free (entry);
+                        entry = next;
+                }
+        }
+        free (index->buckets);
+        free (index);
+}
+
+
+/* EOF */
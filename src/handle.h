@@ -0,0 +1,110 @@
+/*!
+ * \file handle.h
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Header for a handle (\c id_code) hash index for entity
+ * lookup.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#ifndef LIBDXF_SRC_HANDLE_H
+#define LIBDXF_SRC_HANDLE_H
+
+
+#include <stddef.h>
+
+
+/*!
+ * The initial number of buckets of a \c DxfHandleIndex; always kept a
+ * power of two.
+ */
+#define DXF_HANDLE_INDEX_BUCKETS 4096
+
+
+/*!
+ * \brief One entry of a \c DxfHandleIndex.
+ */
+typedef struct
+dxf_handle_entry
+{
+        int id_code;
+                /*!< the entity handle (group code 5). */
+        void *entity;
+                /*!< the indexed entity. */
+        struct dxf_handle_entry *next;
+                /*!< pointer to the next entry in the same bucket, or
+                 * \c NULL. */
+} DxfHandleEntry;
+
+
+/*!
+ * \brief A hash index from entity handles (\c id_code) to entities.
+ *
+ * Resolving a handle reference used to walk every entity list, which
+ * made owner and dictionary resolution O(n^2) over a whole drawing.\n
+ * The index answers lookups in O(1) and rehashes itself as it grows.
+ */
+typedef struct
+dxf_handle_index
+{
+        size_t bucket_count;
+                /*!< number of buckets; a power of two. */
+        size_t length;
+                /*!< number of indexed entities. */
+        DxfHandleEntry **buckets;
+                /*!< the bucket array. */
+} DxfHandleIndex;
+
+
+DxfHandleIndex *
+dxf_handle_index_new ();
+int
+dxf_handle_index_insert
+(
+        DxfHandleIndex *index,
+        int id_code,
+        void *entity
+);
+void *
+dxf_handle_index_find
+(
+        DxfHandleIndex *index,
+        int id_code
+);
+void
+dxf_handle_index_free
+(
+        DxfHandleIndex *index
+);
+
+
+#endif /* LIBDXF_SRC_HANDLE_H */
+
+
+/* EOF */
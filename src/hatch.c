@@ -36,7 +36,18 @@
  */
 
 
+#include <pthread.h>
 #include "hatch.h"
+#include "allocator.h"
+#include "writer.h"
+
+
+/*!
+ * The block size, in bytes, of a hatch boundary pool; sized so the
+ * 50k+ vertex boundary graphs of flooring and landscape drawings live
+ * in a few contiguous blocks.
+ */
+#define DXF_HATCH_POOL_BLOCK_SIZE 65536
 
 
 /*!
@@ -56,7 +67,7 @@ dxf_hatch_new ()
         size = sizeof (DxfHatch);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_hatch = malloc (size)) == NULL)
+        if ((dxf_hatch = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfHatch struct.\n")),
@@ -91,7 +102,7 @@ dxf_hatch_pattern_new ()
         size = sizeof (DxfHatchPattern);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_hatch_pattern = malloc (size)) == NULL)
+        if ((dxf_hatch_pattern = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfHatchPatternSeedpoint struct.\n")),
@@ -126,7 +137,7 @@ dxf_hatch_pattern_def_line_new ()
         size = sizeof (DxfHatchPatternDefLine);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_hatch_pattern_def_line = malloc (size)) == NULL)
+        if ((dxf_hatch_pattern_def_line = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfHatchPatternDefLine struct.\n")),
@@ -161,7 +172,7 @@ dxf_hatch_pattern_seedpoint_new ()
         size = sizeof (DxfHatchPatternSeedPoint);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_hatch_pattern_seedpoint = malloc (size)) == NULL)
+        if ((dxf_hatch_pattern_seedpoint = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfHatchPatternSeedpoint struct.\n")),
@@ -196,7 +207,7 @@ dxf_hatch_boundary_path_new ()
         size = sizeof (DxfHatchBoundaryPath);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_hatch_boundary_path = malloc (size)) == NULL)
+        if ((dxf_hatch_boundary_path = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfHatchBoundaryPath struct.\n")),
@@ -231,7 +242,7 @@ dxf_hatch_boundary_path_polyline_new ()
         size = sizeof (DxfHatchBoundaryPathPolyline);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_hatch_boundary_path_polyline = malloc (size)) == NULL)
+        if ((dxf_hatch_boundary_path_polyline = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfHatchBoundaryPathPolyline struct.\n")),
@@ -267,7 +278,7 @@ dxf_hatch_boundary_path_polyline_vertex_new ()
         size = sizeof (DxfHatchBoundaryPathPolylineVertex);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_hatch_boundary_path_polyline_vertex = malloc (size)) == NULL)
+        if ((dxf_hatch_boundary_path_polyline_vertex = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfHatchBoundaryPathPolylineVertex struct.\n")),
@@ -302,7 +313,7 @@ dxf_hatch_boundary_path_edge_new ()
         size = sizeof (DxfHatchBoundaryPathEdge);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_hatch_boundary_path_edge = malloc (size)) == NULL)
+        if ((dxf_hatch_boundary_path_edge = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfHatchBoundaryPathEdge struct.\n")),
@@ -337,7 +348,7 @@ dxf_hatch_boundary_path_edge_arc_new ()
         size = sizeof (DxfHatchBoundaryPathEdgeArc);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_hatch_boundary_path_edge_arc = malloc (size)) == NULL)
+        if ((dxf_hatch_boundary_path_edge_arc = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfHatchBoundaryPathEdgeArc struct.\n")),
@@ -372,7 +383,7 @@ dxf_hatch_boundary_path_edge_ellipse_new ()
         size = sizeof (DxfHatchBoundaryPathEdgeEllipse);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_hatch_boundary_path_edge_ellipse = malloc (size)) == NULL)
+        if ((dxf_hatch_boundary_path_edge_ellipse = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfHatchBoundaryPathEdgeEllipse struct.\n")),
@@ -407,7 +418,7 @@ dxf_hatch_boundary_path_edge_line_new ()
         size = sizeof (DxfHatchBoundaryPathEdgeLine);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_hatch_boundary_path_edge_line = malloc (size)) == NULL)
+        if ((dxf_hatch_boundary_path_edge_line = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfHatchBoundaryPathEdgeLine struct.\n")),
@@ -442,7 +453,7 @@ dxf_hatch_boundary_path_edge_spline_new ()
         size = sizeof (DxfHatchBoundaryPathEdgeSpline);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_hatch_boundary_path_edge_spline = malloc (size)) == NULL)
+        if ((dxf_hatch_boundary_path_edge_spline = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfHatchBoundaryPathEdgeSpline struct.\n")),
@@ -478,7 +489,7 @@ dxf_hatch_boundary_path_edge_spline_control_point_new ()
         size = sizeof (DxfHatchBoundaryPathEdgeSplineCp);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_hatch_boundary_path_edge_spline_cp = malloc (size)) == NULL)
+        if ((dxf_hatch_boundary_path_edge_spline_cp = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfHatchBoundaryPathEdgeSplineCp struct.\n")),
@@ -496,6 +507,411 @@ dxf_hatch_boundary_path_edge_spline_control_point_new ()
 }
 
 
+/*!
+ * \brief Allocate memory for a node of the boundary path graph of a
+ * DXF \c HATCH from the boundary pool of the hatch.
+ *
+ * Fill the memory contents with zeros.\n
+ * The pool is created on the first allocation and keeps the entire
+ * boundary graph of the hatch in a few contiguous blocks, so building
+ * a 50k+ vertex boundary costs a handful of \c malloc calls instead
+ * of one per node, and \c dxf_hatch_free releases the whole graph in
+ * one call.\n
+ * Memory from the pool shall not be passed to \c free or to the per
+ * node free functions.
+ *
+ * \return a pointer to the allocated memory, or \c NULL when no
+ * memory was allocated.
+ */
+void *
+dxf_hatch_pool_alloc
+(
+        DxfHatch *dxf_hatch,
+                /*!< DXF \c HATCH entity owning the boundary pool. */
+        size_t size
+                /*!< number of bytes to allocate. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        void *result;
+
+        /* Do some basic checks. */
+        if (dxf_hatch == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        if (dxf_hatch->boundary_pool == NULL)
+        {
+                dxf_hatch->boundary_pool = dxf_arena_new (DXF_HATCH_POOL_BLOCK_SIZE);
+                if (dxf_hatch->boundary_pool == NULL)
+                {
+                        return (NULL);
+                }
+        }
+        result = dxf_arena_alloc (dxf_hatch->boundary_pool, size);
+        if (result != NULL)
+        {
+                memset (result, 0, size);
+        }
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (result);
+}
+
+
+/*!
+ * \brief Allocate memory for a DXF \c HATCH boundary path from the
+ * boundary pool of the hatch.
+ *
+ * Like \c dxf_hatch_boundary_path_new, but the memory lives in the
+ * boundary pool (see \c dxf_hatch_pool_alloc) and is released with
+ * the hatch instead of per node.
+ */
+DxfHatchBoundaryPath *
+dxf_hatch_boundary_path_pool_new
+(
+        DxfHatch *dxf_hatch
+                /*!< DXF \c HATCH entity owning the boundary pool. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        DxfHatchBoundaryPath *result;
+
+        result = (DxfHatchBoundaryPath *) dxf_hatch_pool_alloc (dxf_hatch,
+                sizeof (DxfHatchBoundaryPath));
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (result);
+}
+
+
+/*!
+ * \brief Allocate memory for a DXF \c HATCH boundary path polyline from the
+ * boundary pool of the hatch.
+ *
+ * Like \c dxf_hatch_boundary_path_polyline_new, but the memory lives in the
+ * boundary pool (see \c dxf_hatch_pool_alloc) and is released with
+ * the hatch instead of per node.
+ */
+DxfHatchBoundaryPathPolyline *
+dxf_hatch_boundary_path_polyline_pool_new
+(
+        DxfHatch *dxf_hatch
+                /*!< DXF \c HATCH entity owning the boundary pool. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        DxfHatchBoundaryPathPolyline *result;
+
+        result = (DxfHatchBoundaryPathPolyline *) dxf_hatch_pool_alloc (dxf_hatch,
+                sizeof (DxfHatchBoundaryPathPolyline));
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (result);
+}
+
+
+/*!
+ * \brief Allocate memory for a DXF \c HATCH boundary path polyline vertex from the
+ * boundary pool of the hatch.
+ *
+ * Like \c dxf_hatch_boundary_path_polyline_vertex_new, but the memory lives in the
+ * boundary pool (see \c dxf_hatch_pool_alloc) and is released with
+ * the hatch instead of per node.
+ */
+DxfHatchBoundaryPathPolylineVertex *
+dxf_hatch_boundary_path_polyline_vertex_pool_new
+(
+        DxfHatch *dxf_hatch
+                /*!< DXF \c HATCH entity owning the boundary pool. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        DxfHatchBoundaryPathPolylineVertex *result;
+
+        result = (DxfHatchBoundaryPathPolylineVertex *) dxf_hatch_pool_alloc (dxf_hatch,
+                sizeof (DxfHatchBoundaryPathPolylineVertex));
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (result);
+}
+
+
+/*!
+ * \brief Allocate memory for a DXF \c HATCH boundary path edge from the
+ * boundary pool of the hatch.
+ *
+ * Like \c dxf_hatch_boundary_path_edge_new, but the memory lives in the
+ * boundary pool (see \c dxf_hatch_pool_alloc) and is released with
+ * the hatch instead of per node.
+ */
+DxfHatchBoundaryPathEdge *
+dxf_hatch_boundary_path_edge_pool_new
+(
+        DxfHatch *dxf_hatch
+                /*!< DXF \c HATCH entity owning the boundary pool. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        DxfHatchBoundaryPathEdge *result;
+
+        result = (DxfHatchBoundaryPathEdge *) dxf_hatch_pool_alloc (dxf_hatch,
+                sizeof (DxfHatchBoundaryPathEdge));
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (result);
+}
+
+
+/*!
+ * \brief Append an edge to the ordered \c edges array of a DXF
+ * \c HATCH boundary path.
+ *
+ * The array keeps the edges in the order they are appended, the order
+ * the DXF file defines them in.\n
+ * It is grown by doubling; when \c dxf_hatch is not \c NULL the array
+ * lives in the boundary pool of the hatch (see
+ * \c dxf_hatch_pool_alloc) and an outgrown array is simply abandoned
+ * in the pool, otherwise \c realloc is used and the array is to be
+ * released by \c dxf_hatch_boundary_path_free.\n
+ * A boundary path shall use the same hatch (or \c NULL) for every
+ * append.
+ *
+ * \return a pointer to the appended edge, zeroed except for its
+ * \c type, or \c NULL when errors occurred.
+ */
+DxfHatchBoundaryPathEdge *
+dxf_hatch_boundary_path_edge_append
+(
+        DxfHatch *dxf_hatch,
+                /*!< DXF \c HATCH entity owning the boundary pool, or
+                 * \c NULL to grow the array on the heap. */
+        DxfHatchBoundaryPath *dxf_hatch_boundary_path,
+                /*!< DXF hatch boundary path entity to append to. */
+        DxfHatchBoundaryPathEdgeType edge_type
+                /*!< type of the appended edge. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        DxfHatchBoundaryPathEdge *edges;
+        DxfHatchBoundaryPathEdge *edge;
+        int edges_size;
+
+        if (dxf_hatch_boundary_path == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        if (dxf_hatch_boundary_path->number_of_edges
+          == dxf_hatch_boundary_path->edges_size)
+        {
+                edges_size = (dxf_hatch_boundary_path->edges_size == 0) ? 8
+                        : (dxf_hatch_boundary_path->edges_size * 2);
+                if (dxf_hatch != NULL)
+                {
+                        edges = (DxfHatchBoundaryPathEdge *) dxf_hatch_pool_alloc
+                                (dxf_hatch, edges_size * sizeof (DxfHatchBoundaryPathEdge));
+                        if ((edges != NULL)
+                          && (dxf_hatch_boundary_path->number_of_edges > 0))
+                        {
+                                memcpy (edges, dxf_hatch_boundary_path->edges,
+                                        dxf_hatch_boundary_path->number_of_edges
+                                        * sizeof (DxfHatchBoundaryPathEdge));
+                        }
+                }
+                else
+                {
+                        edges = realloc (dxf_hatch_boundary_path->edges,
+                                edges_size * sizeof (DxfHatchBoundaryPathEdge));
+                }
+                if (edges == NULL)
+                {
+                        fprintf (stderr,
+                          (_("Error in %s () could not allocate memory.\n")),
+                          __FUNCTION__);
+                        return (NULL);
+                }
+                dxf_hatch_boundary_path->edges = edges;
+                dxf_hatch_boundary_path->edges_size = edges_size;
+        }
+        edge = &dxf_hatch_boundary_path->edges[dxf_hatch_boundary_path->number_of_edges];
+        memset (edge, 0, sizeof (DxfHatchBoundaryPathEdge));
+        edge->type = edge_type;
+        dxf_hatch_boundary_path->number_of_edges++;
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (edge);
+}
+
+
+/*!
+ * \brief Allocate memory for a DXF \c HATCH boundary path edge arc from the
+ * boundary pool of the hatch.
+ *
+ * Like \c dxf_hatch_boundary_path_edge_arc_new, but the memory lives in the
+ * boundary pool (see \c dxf_hatch_pool_alloc) and is released with
+ * the hatch instead of per node.
+ */
+DxfHatchBoundaryPathEdgeArc *
+dxf_hatch_boundary_path_edge_arc_pool_new
+(
+        DxfHatch *dxf_hatch
+                /*!< DXF \c HATCH entity owning the boundary pool. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        DxfHatchBoundaryPathEdgeArc *result;
+
+        result = (DxfHatchBoundaryPathEdgeArc *) dxf_hatch_pool_alloc (dxf_hatch,
+                sizeof (DxfHatchBoundaryPathEdgeArc));
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (result);
+}
+
+
+/*!
+ * \brief Allocate memory for a DXF \c HATCH boundary path edge ellipse from the
+ * boundary pool of the hatch.
+ *
+ * Like \c dxf_hatch_boundary_path_edge_ellipse_new, but the memory lives in the
+ * boundary pool (see \c dxf_hatch_pool_alloc) and is released with
+ * the hatch instead of per node.
+ */
+DxfHatchBoundaryPathEdgeEllipse *
+dxf_hatch_boundary_path_edge_ellipse_pool_new
+(
+        DxfHatch *dxf_hatch
+                /*!< DXF \c HATCH entity owning the boundary pool. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        DxfHatchBoundaryPathEdgeEllipse *result;
+
+        result = (DxfHatchBoundaryPathEdgeEllipse *) dxf_hatch_pool_alloc (dxf_hatch,
+                sizeof (DxfHatchBoundaryPathEdgeEllipse));
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (result);
+}
+
+
+/*!
+ * \brief Allocate memory for a DXF \c HATCH boundary path edge line from the
+ * boundary pool of the hatch.
+ *
+ * Like \c dxf_hatch_boundary_path_edge_line_new, but the memory lives in the
+ * boundary pool (see \c dxf_hatch_pool_alloc) and is released with
+ * the hatch instead of per node.
+ */
+DxfHatchBoundaryPathEdgeLine *
+dxf_hatch_boundary_path_edge_line_pool_new
+(
+        DxfHatch *dxf_hatch
+                /*!< DXF \c HATCH entity owning the boundary pool. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        DxfHatchBoundaryPathEdgeLine *result;
+
+        result = (DxfHatchBoundaryPathEdgeLine *) dxf_hatch_pool_alloc (dxf_hatch,
+                sizeof (DxfHatchBoundaryPathEdgeLine));
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (result);
+}
+
+
+/*!
+ * \brief Allocate memory for a DXF \c HATCH boundary path edge spline from the
+ * boundary pool of the hatch.
+ *
+ * Like \c dxf_hatch_boundary_path_edge_spline_new, but the memory lives in the
+ * boundary pool (see \c dxf_hatch_pool_alloc) and is released with
+ * the hatch instead of per node.
+ */
+DxfHatchBoundaryPathEdgeSpline *
+dxf_hatch_boundary_path_edge_spline_pool_new
+(
+        DxfHatch *dxf_hatch
+                /*!< DXF \c HATCH entity owning the boundary pool. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        DxfHatchBoundaryPathEdgeSpline *result;
+
+        result = (DxfHatchBoundaryPathEdgeSpline *) dxf_hatch_pool_alloc (dxf_hatch,
+                sizeof (DxfHatchBoundaryPathEdgeSpline));
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (result);
+}
+
+
+/*!
+ * \brief Allocate memory for a DXF \c HATCH boundary path edge spline control point from the
+ * boundary pool of the hatch.
+ *
+ * Like \c dxf_hatch_boundary_path_edge_spline_control_point_new, but the memory lives in the
+ * boundary pool (see \c dxf_hatch_pool_alloc) and is released with
+ * the hatch instead of per node.
+ */
+DxfHatchBoundaryPathEdgeSplineCp *
+dxf_hatch_boundary_path_edge_spline_control_point_pool_new
+(
+        DxfHatch *dxf_hatch
+                /*!< DXF \c HATCH entity owning the boundary pool. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        DxfHatchBoundaryPathEdgeSplineCp *result;
+
+        result = (DxfHatchBoundaryPathEdgeSplineCp *) dxf_hatch_pool_alloc (dxf_hatch,
+                sizeof (DxfHatchBoundaryPathEdgeSplineCp));
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (result);
+}
+
+
 /*!
  * \brief Allocate memory and initialize data fields in a DXF \c HATCH
  * entity.
@@ -513,6 +929,11 @@ dxf_hatch_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfHatch template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         int i;
 
         /* Do some basic checks. */
@@ -530,41 +951,60 @@ dxf_hatch_init
                   __FUNCTION__);
                 return (NULL);
         }
-        dxf_hatch->id_code = 0;
-        dxf_hatch->linetype = strdup (DXF_DEFAULT_LINETYPE);
-        dxf_hatch->layer = strdup (DXF_DEFAULT_LAYER);
-        dxf_hatch->x0 = 0.0;
-        dxf_hatch->y0 = 0.0;
-        dxf_hatch->z0 = 0.0;
-        dxf_hatch->extr_x0 = 0.0;
-        dxf_hatch->extr_y0 = 0.0;
-        dxf_hatch->extr_z0 = 0.0;
-        dxf_hatch->thickness = 0.0;
-        dxf_hatch->pattern_scale = 1.0;
-        dxf_hatch->pixel_size = 1.0;
-        dxf_hatch->pattern_angle = 0.0;
-        dxf_hatch->linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
-        dxf_hatch->visibility = DXF_DEFAULT_VISIBILITY;
-        dxf_hatch->color = DXF_COLOR_BYLAYER;
-        dxf_hatch->paperspace = DXF_MODELSPACE;
-        dxf_hatch->solid_fill = 0;
-        dxf_hatch->associative = 1;
-        dxf_hatch->hatch_style = 0;
-        dxf_hatch->hatch_pattern_type = 0;
-        dxf_hatch->pattern_double = 0;
-        dxf_hatch->number_of_pattern_def_lines = 0;
-        dxf_hatch->def_lines = NULL;
-        dxf_hatch->number_of_boundary_paths = 0;
-        dxf_hatch->paths = NULL;
-        dxf_hatch->number_of_seed_points = 0;
-        dxf_hatch->seed_points = NULL;
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.id_code = 0;
+                template.linetype = strdup (DXF_DEFAULT_LINETYPE);
+                template.layer = strdup (DXF_DEFAULT_LAYER);
+                template.x0 = 0.0;
+                template.y0 = 0.0;
+                template.z0 = 0.0;
+                template.extr_x0 = 0.0;
+                template.extr_y0 = 0.0;
+                template.extr_z0 = 0.0;
+                template.thickness = 0.0;
+                template.pattern_scale = 1.0;
+                template.pixel_size = 1.0;
+                template.pattern_angle = 0.0;
+                template.linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
+                template.visibility = DXF_DEFAULT_VISIBILITY;
+                template.color = DXF_COLOR_BYLAYER;
+                template.paperspace = DXF_MODELSPACE;
+                template.solid_fill = 0;
+                template.associative = 1;
+                template.hatch_style = 0;
+                template.hatch_pattern_type = 0;
+                template.pattern_double = 0;
+                template.number_of_pattern_def_lines = 0;
+                template.def_lines = NULL;
+                template.number_of_boundary_paths = 0;
+                template.paths = NULL;
+                template.number_of_seed_points = 0;
+                template.seed_points = NULL;
+                for (i = 0; i < DXF_MAX_PARAM; i++)
+                {
+                        template.binary_graphics_data[i] = strdup ("");
+                }
+                template.dictionary_owner_soft = strdup ("");
+                template.dictionary_owner_hard = strdup ("");
+                template.next = NULL;
+                template.boundary_pool = NULL;
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (dxf_hatch, &template, sizeof (DxfHatch));
         for (i = 0; i < DXF_MAX_PARAM; i++)
         {
+                /* every instance owns its entries: the reader frees and
+                 * replaces them, so sharing the template strings would
+                 * free them twice. */
                 dxf_hatch->binary_graphics_data[i] = strdup ("");
         }
-        dxf_hatch->dictionary_owner_soft = strdup ("");
-        dxf_hatch->dictionary_owner_hard = strdup ("");
-        dxf_hatch->next = NULL;
+        dxf_hatch->linetype = strdup (template.linetype);
+        dxf_hatch->layer = strdup (template.layer);
+        dxf_hatch->dictionary_owner_soft = strdup (template.dictionary_owner_soft);
+        dxf_hatch->dictionary_owner_hard = strdup (template.dictionary_owner_hard);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -589,6 +1029,11 @@ dxf_hatch_pattern_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfHatchPattern template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         dxf_hatch_pattern = dxf_hatch_pattern_new ();
         if (dxf_hatch_pattern == NULL)
         {
@@ -597,15 +1042,22 @@ dxf_hatch_pattern_init
                   __FUNCTION__);
                 return (NULL);
         }
-        dxf_hatch_pattern->id_code = 0;
-        dxf_hatch_pattern->def_lines = 0;
-        dxf_hatch_pattern->lines = NULL;
-/*! \todo correction in:
-        dxf_hatch_pattern->length = 0.0;
-*/
-        dxf_hatch_pattern->number_of_seed_points = 0;
-        dxf_hatch_pattern->seed_points = NULL;
-        dxf_hatch_pattern->next = NULL;
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.id_code = 0;
+                template.def_lines = 0;
+                template.lines = NULL;
+        /*! \todo correction in:
+                template.length = 0.0;
+        */
+                template.number_of_seed_points = 0;
+                template.seed_points = NULL;
+                template.next = NULL;
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (dxf_hatch_pattern, &template, sizeof (DxfHatchPattern));
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -630,6 +1082,11 @@ dxf_hatch_pattern_def_line_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfHatchPatternDefLine template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         int i;
 
         dxf_hatch_pattern_def_line = dxf_hatch_pattern_def_line_new ();
@@ -640,18 +1097,25 @@ dxf_hatch_pattern_def_line_init
                   __FUNCTION__);
                 return (NULL);
         }
-        dxf_hatch_pattern_def_line->id_code = 0;
-        dxf_hatch_pattern_def_line->angle = 0.0;
-        dxf_hatch_pattern_def_line->x0 = 0.0;
-        dxf_hatch_pattern_def_line->y0 = 0.0;
-        dxf_hatch_pattern_def_line->x1 = 0.0;
-        dxf_hatch_pattern_def_line->y1 = 0.0;
-        dxf_hatch_pattern_def_line->dash_items = DXF_MAX_HATCH_PATTERN_DEF_LINE_DASH_ITEMS;
-        for (i = 0; i >= DXF_MAX_HATCH_PATTERN_DEF_LINE_DASH_ITEMS; i++)
-        {
-                dxf_hatch_pattern_def_line->dash_length[i] = 0.0;
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.id_code = 0;
+                template.angle = 0.0;
+                template.x0 = 0.0;
+                template.y0 = 0.0;
+                template.x1 = 0.0;
+                template.y1 = 0.0;
+                template.dash_items = DXF_MAX_HATCH_PATTERN_DEF_LINE_DASH_ITEMS;
+                for (i = 0; i >= DXF_MAX_HATCH_PATTERN_DEF_LINE_DASH_ITEMS; i++)
+                {
+                        template.dash_length[i] = 0.0;
+                }
+                template.next = NULL;
+                template_ready = 1;
         }
-        dxf_hatch_pattern_def_line->next = NULL;
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (dxf_hatch_pattern_def_line, &template, sizeof (DxfHatchPatternDefLine));
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -676,6 +1140,11 @@ dxf_hatch_pattern_seedpoint_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfHatchPatternSeedPoint template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         dxf_hatch_pattern_seedpoint = dxf_hatch_pattern_seedpoint_new ();
         if (dxf_hatch_pattern_seedpoint == NULL)
         {
@@ -684,10 +1153,17 @@ dxf_hatch_pattern_seedpoint_init
                   __FUNCTION__);
                 return (NULL);
         }
-        dxf_hatch_pattern_seedpoint->id_code = 0;
-        dxf_hatch_pattern_seedpoint->x0 = 0.0;
-        dxf_hatch_pattern_seedpoint->y0 = 0.0;
-        dxf_hatch_pattern_seedpoint->next = NULL;
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.id_code = 0;
+                template.x0 = 0.0;
+                template.y0 = 0.0;
+                template.next = NULL;
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (dxf_hatch_pattern_seedpoint, &template, sizeof (DxfHatchPatternSeedPoint));
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -712,6 +1188,11 @@ dxf_hatch_boundary_path_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfHatchBoundaryPath template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         dxf_hatch_boundary_path = dxf_hatch_boundary_path_new ();
         if (dxf_hatch_boundary_path == NULL)
         {
@@ -720,10 +1201,19 @@ dxf_hatch_boundary_path_init
                   __FUNCTION__);
                 return (NULL);
         }
-        dxf_hatch_boundary_path->id_code = 0;
-        dxf_hatch_boundary_path->edges = NULL;
-        dxf_hatch_boundary_path->polylines = NULL;
-        dxf_hatch_boundary_path->next = NULL;
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.id_code = 0;
+                template.edges = NULL;
+                template.number_of_edges = 0;
+                template.edges_size = 0;
+                template.polylines = NULL;
+                template.next = NULL;
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (dxf_hatch_boundary_path, &template, sizeof (DxfHatchBoundaryPath));
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -748,6 +1238,11 @@ dxf_hatch_boundary_path_polyline_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfHatchBoundaryPathPolyline template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         dxf_hatch_boundary_path_polyline = dxf_hatch_boundary_path_polyline_new ();
         if (dxf_hatch_boundary_path_polyline == NULL)
         {
@@ -756,13 +1251,20 @@ dxf_hatch_boundary_path_polyline_init
                   __FUNCTION__);
                 return (NULL);
         }
-        dxf_hatch_boundary_path_polyline->id_code = 0;
-        dxf_hatch_boundary_path_polyline->bulge = 0.0;
-        dxf_hatch_boundary_path_polyline->has_bulge = 0;
-        dxf_hatch_boundary_path_polyline->is_closed = 0;
-        dxf_hatch_boundary_path_polyline->number_of_vertices = 0;
-        dxf_hatch_boundary_path_polyline->vertices = NULL;
-        dxf_hatch_boundary_path_polyline->next = NULL;
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.id_code = 0;
+                template.bulge = 0.0;
+                template.has_bulge = 0;
+                template.is_closed = 0;
+                template.number_of_vertices = 0;
+                template.vertices = NULL;
+                template.next = NULL;
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (dxf_hatch_boundary_path_polyline, &template, sizeof (DxfHatchBoundaryPathPolyline));
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -787,6 +1289,11 @@ dxf_hatch_boundary_path_polyline_vertex_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfHatchBoundaryPathPolylineVertex template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         dxf_hatch_boundary_path_polyline_vertex = dxf_hatch_boundary_path_polyline_vertex_new ();
         if (dxf_hatch_boundary_path_polyline_vertex == NULL)
         {
@@ -795,10 +1302,17 @@ dxf_hatch_boundary_path_polyline_vertex_init
                   __FUNCTION__);
                 return (NULL);
         }
-        dxf_hatch_boundary_path_polyline_vertex->id_code = 0;
-        dxf_hatch_boundary_path_polyline_vertex->x0 = 0.0;
-        dxf_hatch_boundary_path_polyline_vertex->y0 = 0.0;
-        dxf_hatch_boundary_path_polyline_vertex->next = NULL;
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.id_code = 0;
+                template.x0 = 0.0;
+                template.y0 = 0.0;
+                template.next = NULL;
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (dxf_hatch_boundary_path_polyline_vertex, &template, sizeof (DxfHatchBoundaryPathPolylineVertex));
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -823,6 +1337,11 @@ dxf_hatch_boundary_path_edge_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfHatchBoundaryPathEdge template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         dxf_hatch_boundary_path_edge = dxf_hatch_boundary_path_edge_new ();
         if (dxf_hatch_boundary_path_edge == NULL)
         {
@@ -831,12 +1350,15 @@ dxf_hatch_boundary_path_edge_init
                   __FUNCTION__);
                 return (NULL);
         }
-        dxf_hatch_boundary_path_edge->id_code = 0;
-        dxf_hatch_boundary_path_edge->arcs = NULL;
-        dxf_hatch_boundary_path_edge->ellipses = NULL;
-        dxf_hatch_boundary_path_edge->lines = NULL;
-        dxf_hatch_boundary_path_edge->splines = NULL;
-        dxf_hatch_boundary_path_edge->next = NULL;
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.id_code = 0;
+                template.type = 0;
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (dxf_hatch_boundary_path_edge, &template, sizeof (DxfHatchBoundaryPathEdge));
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -861,6 +1383,11 @@ dxf_hatch_boundary_path_edge_arc_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfHatchBoundaryPathEdgeArc template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         dxf_hatch_boundary_path_edge_arc = dxf_hatch_boundary_path_edge_arc_new ();
         if (dxf_hatch_boundary_path_edge_arc == NULL)
         {
@@ -869,14 +1396,21 @@ dxf_hatch_boundary_path_edge_arc_init
                   __FUNCTION__);
                 return (NULL);
         }
-        dxf_hatch_boundary_path_edge_arc->id_code = 0;
-        dxf_hatch_boundary_path_edge_arc->x0 = 0.0;
-        dxf_hatch_boundary_path_edge_arc->y0 = 0.0;
-        dxf_hatch_boundary_path_edge_arc->radius = 0.0;
-        dxf_hatch_boundary_path_edge_arc->start_angle = 0.0;
-        dxf_hatch_boundary_path_edge_arc->end_angle = 0.0;
-        dxf_hatch_boundary_path_edge_arc->is_ccw = 0;
-        dxf_hatch_boundary_path_edge_arc->next = NULL;
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.id_code = 0;
+                template.x0 = 0.0;
+                template.y0 = 0.0;
+                template.radius = 0.0;
+                template.start_angle = 0.0;
+                template.end_angle = 0.0;
+                template.is_ccw = 0;
+                template.next = NULL;
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (dxf_hatch_boundary_path_edge_arc, &template, sizeof (DxfHatchBoundaryPathEdgeArc));
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -901,6 +1435,11 @@ dxf_hatch_boundary_path_edge_ellipse_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfHatchBoundaryPathEdgeEllipse template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         dxf_hatch_boundary_path_edge_ellipse = dxf_hatch_boundary_path_edge_ellipse_new ();
         if (dxf_hatch_boundary_path_edge_ellipse == NULL)
         {
@@ -909,16 +1448,23 @@ dxf_hatch_boundary_path_edge_ellipse_init
                   __FUNCTION__);
                 return (NULL);
         }
-        dxf_hatch_boundary_path_edge_ellipse->id_code = 0;
-        dxf_hatch_boundary_path_edge_ellipse->x0 = 0.0;
-        dxf_hatch_boundary_path_edge_ellipse->y0 = 0.0;
-        dxf_hatch_boundary_path_edge_ellipse->x1 = 0.0;
-        dxf_hatch_boundary_path_edge_ellipse->y1 = 0.0;
-        dxf_hatch_boundary_path_edge_ellipse->minor_axis = 0.0;
-        dxf_hatch_boundary_path_edge_ellipse->start_angle = 0.0;
-        dxf_hatch_boundary_path_edge_ellipse->end_angle = 0.0;
-        dxf_hatch_boundary_path_edge_ellipse->is_ccw = 0;
-        dxf_hatch_boundary_path_edge_ellipse->next = NULL;
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.id_code = 0;
+                template.x0 = 0.0;
+                template.y0 = 0.0;
+                template.x1 = 0.0;
+                template.y1 = 0.0;
+                template.minor_axis = 0.0;
+                template.start_angle = 0.0;
+                template.end_angle = 0.0;
+                template.is_ccw = 0;
+                template.next = NULL;
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (dxf_hatch_boundary_path_edge_ellipse, &template, sizeof (DxfHatchBoundaryPathEdgeEllipse));
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -943,6 +1489,11 @@ dxf_hatch_boundary_path_edge_line_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfHatchBoundaryPathEdgeLine template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         dxf_hatch_boundary_path_edge_line = dxf_hatch_boundary_path_edge_line_new ();
         if (dxf_hatch_boundary_path_edge_line == NULL)
         {
@@ -951,12 +1502,19 @@ dxf_hatch_boundary_path_edge_line_init
                   __FUNCTION__);
                 return (NULL);
         }
-        dxf_hatch_boundary_path_edge_line->id_code = 0;
-        dxf_hatch_boundary_path_edge_line->x0 = 0.0;
-        dxf_hatch_boundary_path_edge_line->y0 = 0.0;
-        dxf_hatch_boundary_path_edge_line->x1 = 0.0;
-        dxf_hatch_boundary_path_edge_line->y1 = 0.0;
-        dxf_hatch_boundary_path_edge_line->next = NULL;
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.id_code = 0;
+                template.x0 = 0.0;
+                template.y0 = 0.0;
+                template.x1 = 0.0;
+                template.y1 = 0.0;
+                template.next = NULL;
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (dxf_hatch_boundary_path_edge_line, &template, sizeof (DxfHatchBoundaryPathEdgeLine));
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -981,6 +1539,11 @@ dxf_hatch_boundary_path_edge_spline_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfHatchBoundaryPathEdgeSpline template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         int i;
 
         dxf_hatch_boundary_path_edge_spline = dxf_hatch_boundary_path_edge_spline_new ();
@@ -991,18 +1554,25 @@ dxf_hatch_boundary_path_edge_spline_init
                   __FUNCTION__);
                 return (NULL);
         }
-        dxf_hatch_boundary_path_edge_spline->id_code = 0;
-        dxf_hatch_boundary_path_edge_spline->degree = 0;
-        dxf_hatch_boundary_path_edge_spline->rational = 0;
-        dxf_hatch_boundary_path_edge_spline->periodic = 0;
-        dxf_hatch_boundary_path_edge_spline->number_of_knots = 0;
-        for (i = 0; i >= DXF_MAX_HATCH_BOUNDARY_PATH_EDGE_SPLINE_KNOTS; i++)
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
         {
-                dxf_hatch_boundary_path_edge_spline->knots[i] = 0.0;
+                template.id_code = 0;
+                template.degree = 0;
+                template.rational = 0;
+                template.periodic = 0;
+                template.number_of_knots = 0;
+                for (i = 0; i >= DXF_MAX_HATCH_BOUNDARY_PATH_EDGE_SPLINE_KNOTS; i++)
+                {
+                        template.knots[i] = 0.0;
+                }
+                template.number_of_control_points = 0;
+                template.control_points = NULL;
+                template.next = NULL;
+                template_ready = 1;
         }
-        dxf_hatch_boundary_path_edge_spline->number_of_control_points = 0;
-        dxf_hatch_boundary_path_edge_spline->control_points = NULL;
-        dxf_hatch_boundary_path_edge_spline->next = NULL;
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (dxf_hatch_boundary_path_edge_spline, &template, sizeof (DxfHatchBoundaryPathEdgeSpline));
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -1027,6 +1597,11 @@ dxf_hatch_boundary_path_edge_spline_control_point_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfHatchBoundaryPathEdgeSplineCp template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         dxf_hatch_boundary_path_edge_spline_cp = dxf_hatch_boundary_path_edge_spline_control_point_new ();
         if (dxf_hatch_boundary_path_edge_spline_cp == NULL)
         {
@@ -1035,11 +1610,18 @@ dxf_hatch_boundary_path_edge_spline_control_point_init
                   __FUNCTION__);
                 return (NULL);
         }
-        dxf_hatch_boundary_path_edge_spline_cp->id_code = 0;
-        dxf_hatch_boundary_path_edge_spline_cp->x0 = 0.0;
-        dxf_hatch_boundary_path_edge_spline_cp->y0 = 0.0;
-        dxf_hatch_boundary_path_edge_spline_cp->weight = 0.0;
-        dxf_hatch_boundary_path_edge_spline_cp->next = NULL;
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.id_code = 0;
+                template.x0 = 0.0;
+                template.y0 = 0.0;
+                template.weight = 0.0;
+                template.next = NULL;
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (dxf_hatch_boundary_path_edge_spline_cp, &template, sizeof (DxfHatchBoundaryPathEdgeSplineCp));
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -2368,10 +2950,10 @@ dxf_hatch_write
                 dxf_hatch->linetype = strdup (DXF_DEFAULT_LINETYPE);
         }
         /* Start writing output. */
-        fprintf (fp->fp, "  0\n%s\n", dxf_entity_name);
+        dxf_write_group_string (fp, 0, dxf_entity_name);
         if (dxf_hatch->id_code != -1)
         {
-                fprintf (fp->fp, "  5\n%x\n", dxf_hatch->id_code);
+                dxf_write_group_hex (fp, 5, dxf_hatch->id_code);
         }
         /*!
          * \todo for version R14.\n
@@ -2386,86 +2968,86 @@ dxf_hatch_write
         if ((strcmp (dxf_hatch->dictionary_owner_soft, "") != 0)
           && (fp->acad_version_number >= AutoCAD_14))
         {
-                fprintf (fp->fp, "102\n{ACAD_REACTORS\n");
-                fprintf (fp->fp, "330\n%s\n", dxf_hatch->dictionary_owner_soft);
-                fprintf (fp->fp, "102\n}\n");
+                dxf_write_group_string (fp, 102, "{ACAD_REACTORS");
+                dxf_write_group_string (fp, 330, dxf_hatch->dictionary_owner_soft);
+                dxf_write_group_string (fp, 102, "}");
         }
         if ((strcmp (dxf_hatch->dictionary_owner_hard, "") != 0)
           && (fp->acad_version_number >= AutoCAD_14))
         {
-                fprintf (fp->fp, "102\n{ACAD_XDICTIONARY\n");
-                fprintf (fp->fp, "360\n%s\n", dxf_hatch->dictionary_owner_hard);
-                fprintf (fp->fp, "102\n}\n");
+                dxf_write_group_string (fp, 102, "{ACAD_XDICTIONARY");
+                dxf_write_group_string (fp, 360, dxf_hatch->dictionary_owner_hard);
+                dxf_write_group_string (fp, 102, "}");
         }
         if (fp->acad_version_number >= AutoCAD_13)
         {
-                fprintf (fp->fp, "100\nAcDbEntity\n");
+                dxf_write_group_string (fp, 100, "AcDbEntity");
         }
         if (dxf_hatch->paperspace == DXF_PAPERSPACE)
         {
-                fprintf (fp->fp, " 67\n%d\n", DXF_PAPERSPACE);
+                dxf_write_group_int (fp, 67, DXF_PAPERSPACE);
         }
-        fprintf (fp->fp, "  8\n%s\n", dxf_hatch->layer);
+        dxf_write_group_string (fp, 8, dxf_hatch->layer);
         if (strcmp (dxf_hatch->linetype, DXF_DEFAULT_LINETYPE) != 0)
         {
-                fprintf (fp->fp, "  6\n%s\n", dxf_hatch->linetype);
+                dxf_write_group_string (fp, 6, dxf_hatch->linetype);
         }
         if ((fp->acad_version_number <= AutoCAD_11)
           && DXF_FLATLAND
           && (dxf_hatch->elevation != 0.0))
         {
-                fprintf (fp->fp, " 38\n%f\n", dxf_hatch->elevation);
+                dxf_write_group_double (fp, 38, dxf_hatch->elevation);
         }
         if (dxf_hatch->thickness != 0.0)
         {
-                fprintf (fp->fp, " 39\n%f\n", dxf_hatch->thickness);
+                dxf_write_group_double (fp, 39, dxf_hatch->thickness);
         }
         if (dxf_hatch->color != DXF_COLOR_BYLAYER)
         {
-                fprintf (fp->fp, " 62\n%d\n", dxf_hatch->color);
+                dxf_write_group_int (fp, 62, dxf_hatch->color);
         }
         if (dxf_hatch->linetype_scale != 1.0)
         {
-                fprintf (fp->fp, " 48\n%f\n", dxf_hatch->linetype_scale);
+                dxf_write_group_double (fp, 48, dxf_hatch->linetype_scale);
         }
         if (dxf_hatch->visibility != 0)
         {
-                fprintf (fp->fp, " 60\n%d\n", dxf_hatch->visibility);
+                dxf_write_group_int (fp, 60, dxf_hatch->visibility);
         }
         if (dxf_hatch->number_of_image_bytes > 0)
         {
-                fprintf (fp->fp, " 92\n%d\n", dxf_hatch->number_of_image_bytes);
+                dxf_write_group_int (fp, 92, dxf_hatch->number_of_image_bytes);
         }
         i = 0;
         while (strlen (dxf_hatch->binary_graphics_data[i]) > 0)
         {
-                fprintf (fp->fp, "310\n%s\n", dxf_hatch->binary_graphics_data[i]);
+                dxf_write_group_string (fp, 310, dxf_hatch->binary_graphics_data[i]);
                 i++;
         }
-        fprintf (fp->fp, "100\nAcDbHatch\n");
-        fprintf (fp->fp, " 10\n%f\n", dxf_hatch->x0);
-        fprintf (fp->fp, " 20\n%f\n", dxf_hatch->y0);
-        fprintf (fp->fp, " 30\n%f\n", dxf_hatch->z0);
-        fprintf (fp->fp, "210\n%f\n", dxf_hatch->extr_x0);
-        fprintf (fp->fp, "220\n%f\n", dxf_hatch->extr_y0);
-        fprintf (fp->fp, "230\n%f\n", dxf_hatch->extr_z0);
-        fprintf (fp->fp, "  2\n%s\n", dxf_hatch->pattern_name);
-        fprintf (fp->fp, " 70\n%d\n", dxf_hatch->solid_fill);
-        fprintf (fp->fp, " 71\n%d\n", dxf_hatch->associative);
-        fprintf (fp->fp, " 91\n%d\n", dxf_hatch->number_of_boundary_paths);
+        dxf_write_group_string (fp, 100, "AcDbHatch");
+        dxf_write_group_double (fp, 10, dxf_hatch->x0);
+        dxf_write_group_double (fp, 20, dxf_hatch->y0);
+        dxf_write_group_double (fp, 30, dxf_hatch->z0);
+        dxf_write_group_double (fp, 210, dxf_hatch->extr_x0);
+        dxf_write_group_double (fp, 220, dxf_hatch->extr_y0);
+        dxf_write_group_double (fp, 230, dxf_hatch->extr_z0);
+        dxf_write_group_string (fp, 2, dxf_hatch->pattern_name);
+        dxf_write_group_int (fp, 70, dxf_hatch->solid_fill);
+        dxf_write_group_int (fp, 71, dxf_hatch->associative);
+        dxf_write_group_int (fp, 91, dxf_hatch->number_of_boundary_paths);
         dxf_hatch_boundary_path_write (fp, (DxfHatchBoundaryPath *) dxf_hatch->paths);
-        fprintf (fp->fp, " 75\n%d\n", dxf_hatch->hatch_style);
-        fprintf (fp->fp, " 76\n%d\n", dxf_hatch->hatch_pattern_type);
+        dxf_write_group_int (fp, 75, dxf_hatch->hatch_style);
+        dxf_write_group_int (fp, 76, dxf_hatch->hatch_pattern_type);
         if (!dxf_hatch->solid_fill)
         {
-                fprintf (fp->fp, " 52\n%f\n", dxf_hatch->pattern_angle);
-                fprintf (fp->fp, " 41\n%f\n", dxf_hatch->pattern_scale);
-                fprintf (fp->fp, " 77\n%d\n", dxf_hatch->pattern_double);
+                dxf_write_group_double (fp, 52, dxf_hatch->pattern_angle);
+                dxf_write_group_double (fp, 41, dxf_hatch->pattern_scale);
+                dxf_write_group_int (fp, 77, dxf_hatch->pattern_double);
         }
-        fprintf (fp->fp, " 78\n%d\n", dxf_hatch->number_of_pattern_def_lines);
+        dxf_write_group_int (fp, 78, dxf_hatch->number_of_pattern_def_lines);
         /*! \todo Add code to write hatch pattern definition line data. */
-        fprintf (fp->fp, " 47\n%f\n", dxf_hatch->pixel_size);
-        fprintf (fp->fp, " 98\n%d\n", dxf_hatch->number_of_seed_points);
+        dxf_write_group_double (fp, 47, dxf_hatch->pixel_size);
+        dxf_write_group_int (fp, 98, dxf_hatch->number_of_seed_points);
         /*! \todo Add code to write hatch pattern seed points. */
 #if DEBUG
         DXF_DEBUG_END
@@ -2511,18 +3093,18 @@ dxf_hatch_pattern_def_line_write
                 return (EXIT_FAILURE);
         }
         /* Start writing output. */
-        fprintf (fp->fp, " 53\n%f\n", dxf_hatch_pattern_def_line->angle);
-        fprintf (fp->fp, " 43\n%f\n", dxf_hatch_pattern_def_line->x0);
-        fprintf (fp->fp, " 44\n%f\n", dxf_hatch_pattern_def_line->y0);
-        fprintf (fp->fp, " 45\n%f\n", dxf_hatch_pattern_def_line->x1);
-        fprintf (fp->fp, " 46\n%f\n", dxf_hatch_pattern_def_line->y1);
-        fprintf (fp->fp, " 79\n%d\n", dxf_hatch_pattern_def_line->dash_items);
+        dxf_write_group_double (fp, 53, dxf_hatch_pattern_def_line->angle);
+        dxf_write_group_double (fp, 43, dxf_hatch_pattern_def_line->x0);
+        dxf_write_group_double (fp, 44, dxf_hatch_pattern_def_line->y0);
+        dxf_write_group_double (fp, 45, dxf_hatch_pattern_def_line->x1);
+        dxf_write_group_double (fp, 46, dxf_hatch_pattern_def_line->y1);
+        dxf_write_group_int (fp, 79, dxf_hatch_pattern_def_line->dash_items);
         if (dxf_hatch_pattern_def_line->dash_items > 0)
         {
                 /* Draw hatch pattern definition line dash items. */
                 for (i = 1; i < dxf_hatch_pattern_def_line->dash_items; i++)
                 {
-                        fprintf (fp->fp, " 49\n%f\n", dxf_hatch_pattern_def_line->dash_length[i]);
+                        dxf_write_group_double (fp, 49, dxf_hatch_pattern_def_line->dash_length[i]);
                 }
         }
         else
@@ -2573,8 +3155,8 @@ dxf_hatch_pattern_seedpoint_write
                 return (EXIT_FAILURE);
         }
         /* Start writing output. */
-        fprintf (fp->fp, " 10\n%f\n", dxf_hatch_pattern_seedpoint->x0);
-        fprintf (fp->fp, " 20\n%f\n", dxf_hatch_pattern_seedpoint->y0);
+        dxf_write_group_double (fp, 10, dxf_hatch_pattern_seedpoint->x0);
+        dxf_write_group_double (fp, 20, dxf_hatch_pattern_seedpoint->y0);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -2617,48 +3199,38 @@ dxf_hatch_boundary_path_write
                 return (EXIT_FAILURE);
         }
         /* Start writing output. */
-        for (;;)
+        while (dxf_hatch_boundary_path != NULL)
         {
-                if (dxf_hatch_boundary_path->next == NULL)
+                /* Test for edge type or polylines type. */
+                if (dxf_hatch_boundary_path->edges != NULL)
                 {
-                        fprintf (stderr,
-                          (_("Information from %s () last boundary path encountered.\n")),
-                          __FUNCTION__);
-                        break;
+                        /* Write edges data. */
                 }
-                else
+                else if (dxf_hatch_boundary_path->polylines != NULL)
                 {
-                        /* Test for edge type or polylines type. */
-                        if (dxf_hatch_boundary_path->edges != NULL)
+                        iter = (DxfHatchBoundaryPathPolyline *) dxf_hatch_boundary_path->polylines;
+                        for (;;)
                         {
-                                /* Write edges data. */
-                        }
-                        else if (dxf_hatch_boundary_path->polylines != NULL)
-                        {
-                                iter = dxf_hatch_boundary_path_polyline_new ();
-                                iter = (DxfHatchBoundaryPathPolyline *) dxf_hatch_boundary_path->polylines;
-                                for (;;)
+                                dxf_hatch_boundary_path_polyline_write
+                                (
+                                        fp,
+                                        iter
+                                );
+                                iter = (DxfHatchBoundaryPathPolyline *) iter->next;
+                                if (iter == NULL)
                                 {
-                                        dxf_hatch_boundary_path_polyline_write
-                                        (
-                                                fp,
-                                                iter
-                                        );
-                                        iter = (DxfHatchBoundaryPathPolyline *) iter->next;
-                                        if (iter == NULL)
-                                        {
-                                                break;
-                                        }
+                                        break;
                                 }
                         }
-                        else
-                        {
-                                fprintf (stderr,
-                                  (_("Error in %s () unknown boundary path type encountered.\n")),
-                                  __FUNCTION__);
-                                return (EXIT_FAILURE);
-                        }
                 }
+                else
+                {
+                        fprintf (stderr,
+                          (_("Error in %s () unknown boundary path type encountered.\n")),
+                          __FUNCTION__);
+                        return (EXIT_FAILURE);
+                }
+                dxf_hatch_boundary_path = (DxfHatchBoundaryPath *) dxf_hatch_boundary_path->next;
         }
 #if DEBUG
         DXF_DEBUG_END
@@ -2745,8 +3317,8 @@ dxf_hatch_boundary_path_polyline_vertex_write
                   __FUNCTION__);
                 return (EXIT_FAILURE);
         }
-        fprintf (fp->fp, " 10\n%f\n", dxf_hatch_boundary_path_polyline_vertex->x0);
-        fprintf (fp->fp, " 20\n%f\n", dxf_hatch_boundary_path_polyline_vertex->y0);
+        dxf_write_group_double (fp, 10, dxf_hatch_boundary_path_polyline_vertex->x0);
+        dxf_write_group_double (fp, 20, dxf_hatch_boundary_path_polyline_vertex->y0);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -2966,6 +3538,314 @@ dxf_hatch_boundary_path_polyline_point_inside_polyline
 }
 
 
+/*!
+ * \brief Compute the bounding box of contiguous vertex coordinate
+ * arrays.
+ *
+ * The loop only touches the two packed \c double arrays, eight values
+ * per cache line, and is written so the compiler can vectorize it (see
+ * \c soa.c for the same approach on entity coordinates).
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when an error
+ * occurred.
+ */
+int
+dxf_hatch_vertices_bbox
+(
+        const double *x,
+                /*!< array of X-values. */
+        const double *y,
+                /*!< array of Y-values. */
+        size_t length,
+                /*!< number of vertices in the arrays. */
+        double *min_x,
+                /*!< returns the smallest X-value. */
+        double *min_y,
+                /*!< returns the smallest Y-value. */
+        double *max_x,
+                /*!< returns the largest X-value. */
+        double *max_y
+                /*!< returns the largest Y-value. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        double x_lo;
+        double x_hi;
+        double y_lo;
+        double y_hi;
+        size_t i;
+
+        if ((x == NULL) || (y == NULL) || (min_x == NULL) || (min_y == NULL)
+          || (max_x == NULL) || (max_y == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (length == 0)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () no vertices were passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        x_lo = x[0];
+        x_hi = x[0];
+        y_lo = y[0];
+        y_hi = y[0];
+        for (i = 1; i < length; i++)
+        {
+                x_lo = (x[i] < x_lo) ? x[i] : x_lo;
+                x_hi = (x[i] > x_hi) ? x[i] : x_hi;
+                y_lo = (y[i] < y_lo) ? y[i] : y_lo;
+                y_hi = (y[i] > y_hi) ? y[i] : y_hi;
+        }
+        *min_x = x_lo;
+        *min_y = y_lo;
+        *max_x = x_hi;
+        *max_y = y_hi;
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Apply an affine transformation in place to contiguous vertex
+ * coordinate arrays.
+ *
+ * Each vertex becomes\n
+ * <tt>x' = xx * x + xy * y + dx</tt>\n
+ * <tt>y' = yx * x + yy * y + dy</tt>\n
+ * in one vectorizable sweep over the packed arrays.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when an error
+ * occurred.
+ */
+int
+dxf_hatch_vertices_transform
+(
+        double *x,
+                /*!< array of X-values, transformed in place. */
+        double *y,
+                /*!< array of Y-values, transformed in place. */
+        size_t length,
+                /*!< number of vertices in the arrays. */
+        double xx,
+                /*!< matrix element: X-contribution to the new X-value. */
+        double xy,
+                /*!< matrix element: Y-contribution to the new X-value. */
+        double yx,
+                /*!< matrix element: X-contribution to the new Y-value. */
+        double yy,
+                /*!< matrix element: Y-contribution to the new Y-value. */
+        double dx,
+                /*!< translation of the X-values. */
+        double dy
+                /*!< translation of the Y-values. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        double x_old;
+        size_t i;
+
+        if ((x == NULL) || (y == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        for (i = 0; i < length; i++)
+        {
+                x_old = x[i];
+                x[i] = xx * x_old + xy * y[i] + dx;
+                y[i] = yx * x_old + yy * y[i] + dy;
+        }
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Compute the bounding box of a hatch boundary path polyline.
+ *
+ * The vertices are gathered from the linked list into packed
+ * coordinate arrays chunk by chunk and handed to
+ * \c dxf_hatch_vertices_bbox, so the numeric work runs over contiguous
+ * memory even though the vertices themselves are list nodes.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when an error
+ * occurred.
+ */
+int
+dxf_hatch_boundary_path_polyline_bbox
+(
+        DxfHatchBoundaryPathPolyline *dxf_hatch_boundary_path_polyline,
+                /*!< DXF hatch boundary path polyline entity. */
+        double *min_x,
+                /*!< returns the smallest X-value. */
+        double *min_y,
+                /*!< returns the smallest Y-value. */
+        double *max_x,
+                /*!< returns the largest X-value. */
+        double *max_y
+                /*!< returns the largest Y-value. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        double x[256];
+        double y[256];
+        double chunk_min_x;
+        double chunk_min_y;
+        double chunk_max_x;
+        double chunk_max_y;
+        DxfHatchBoundaryPathPolylineVertex *iter;
+        size_t length;
+        int first = 1;
+
+        if (dxf_hatch_boundary_path_polyline == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () invalid pointer to polyline (NULL).\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (dxf_hatch_boundary_path_polyline->vertices == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () polyline contains no vertices.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        iter = (DxfHatchBoundaryPathPolylineVertex *) dxf_hatch_boundary_path_polyline->vertices;
+        while (iter != NULL)
+        {
+                length = 0;
+                while ((iter != NULL) && (length < 256))
+                {
+                        x[length] = iter->x0;
+                        y[length] = iter->y0;
+                        length++;
+                        iter = (DxfHatchBoundaryPathPolylineVertex *) iter->next;
+                }
+                if (dxf_hatch_vertices_bbox (x, y, length, &chunk_min_x,
+                        &chunk_min_y, &chunk_max_x, &chunk_max_y) != EXIT_SUCCESS)
+                {
+                        return (EXIT_FAILURE);
+                }
+                if (first)
+                {
+                        *min_x = chunk_min_x;
+                        *min_y = chunk_min_y;
+                        *max_x = chunk_max_x;
+                        *max_y = chunk_max_y;
+                        first = 0;
+                }
+                else
+                {
+                        if (chunk_min_x < *min_x) *min_x = chunk_min_x;
+                        if (chunk_min_y < *min_y) *min_y = chunk_min_y;
+                        if (chunk_max_x > *max_x) *max_x = chunk_max_x;
+                        if (chunk_max_y > *max_y) *max_y = chunk_max_y;
+                }
+        }
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Apply an affine transformation in place to all vertices of a
+ * hatch boundary path polyline.
+ *
+ * The vertices are gathered chunk by chunk into packed coordinate
+ * arrays, transformed with \c dxf_hatch_vertices_transform and
+ * scattered back, so the arithmetic runs over contiguous memory.\n
+ * See \c dxf_hatch_vertices_transform for the matrix layout.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when an error
+ * occurred.
+ */
+int
+dxf_hatch_boundary_path_polyline_transform
+(
+        DxfHatchBoundaryPathPolyline *dxf_hatch_boundary_path_polyline,
+                /*!< DXF hatch boundary path polyline entity. */
+        double xx,
+                /*!< matrix element: X-contribution to the new X-value. */
+        double xy,
+                /*!< matrix element: Y-contribution to the new X-value. */
+        double yx,
+                /*!< matrix element: X-contribution to the new Y-value. */
+        double yy,
+                /*!< matrix element: Y-contribution to the new Y-value. */
+        double dx,
+                /*!< translation of the X-values. */
+        double dy
+                /*!< translation of the Y-values. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        double x[256];
+        double y[256];
+        DxfHatchBoundaryPathPolylineVertex *chunk_start;
+        DxfHatchBoundaryPathPolylineVertex *iter;
+        size_t length;
+        size_t i;
+
+        if (dxf_hatch_boundary_path_polyline == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () invalid pointer to polyline (NULL).\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        iter = (DxfHatchBoundaryPathPolylineVertex *) dxf_hatch_boundary_path_polyline->vertices;
+        while (iter != NULL)
+        {
+                chunk_start = iter;
+                length = 0;
+                while ((iter != NULL) && (length < 256))
+                {
+                        x[length] = iter->x0;
+                        y[length] = iter->y0;
+                        length++;
+                        iter = (DxfHatchBoundaryPathPolylineVertex *) iter->next;
+                }
+                if (dxf_hatch_vertices_transform (x, y, length, xx, xy, yx,
+                        yy, dx, dy) != EXIT_SUCCESS)
+                {
+                        return (EXIT_FAILURE);
+                }
+                for (i = 0; i < length; i++)
+                {
+                        chunk_start->x0 = x[i];
+                        chunk_start->y0 = y[i];
+                        chunk_start = (DxfHatchBoundaryPathPolylineVertex *) chunk_start->next;
+                }
+        }
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (EXIT_SUCCESS);
+}
+
+
 /*!
  * \brief Write DXF output to a file for a hatch boundary path polyline.
  *
@@ -3001,9 +3881,9 @@ dxf_hatch_boundary_path_polyline_write
                   __FUNCTION__);
                 return (EXIT_FAILURE);
         }
-        fprintf (fp->fp, " 72\n%d\n", dxf_hatch_boundary_path_polyline->has_bulge);
-        fprintf (fp->fp, " 73\n%d\n", dxf_hatch_boundary_path_polyline->is_closed);
-        fprintf (fp->fp, " 93\n%d\n", dxf_hatch_boundary_path_polyline->number_of_vertices);
+        dxf_write_group_int (fp, 72, dxf_hatch_boundary_path_polyline->has_bulge);
+        dxf_write_group_int (fp, 73, dxf_hatch_boundary_path_polyline->is_closed);
+        dxf_write_group_int (fp, 93, dxf_hatch_boundary_path_polyline->number_of_vertices);
         /* draw hatch boundary vertices. */
         iter = dxf_hatch_boundary_path_polyline_vertex_new ();
         iter = (DxfHatchBoundaryPathPolylineVertex *) dxf_hatch_boundary_path_polyline->vertices;
@@ -3031,7 +3911,7 @@ dxf_hatch_boundary_path_polyline_write
         }
         if (dxf_hatch_boundary_path_polyline->bulge != 0.0)
         {
-                fprintf (fp->fp, " 42\n%f\n", dxf_hatch_boundary_path_polyline->bulge);
+                dxf_write_group_double (fp, 42, dxf_hatch_boundary_path_polyline->bulge);
         }
 #if DEBUG
         DXF_DEBUG_END
@@ -3071,7 +3951,12 @@ dxf_hatch_free
         free (dxf_hatch->linetype);
         free (dxf_hatch->layer);
         free (dxf_hatch->def_lines);
-        free (dxf_hatch->paths);
+        if (dxf_hatch->boundary_pool == NULL)
+        {
+                /* a pooled boundary graph is released with the pool
+                 * below and shall not be freed per node. */
+                free (dxf_hatch->paths);
+        }
         free (dxf_hatch->seed_points);
         for (i = 0; i < DXF_MAX_PARAM; i++)
         {
@@ -3079,7 +3964,8 @@ dxf_hatch_free
         }
         free (dxf_hatch->dictionary_owner_soft);
         free (dxf_hatch->dictionary_owner_hard);
-        free (dxf_hatch);
+        dxf_arena_free (dxf_hatch->boundary_pool);
+        dxf_entity_dealloc (dxf_hatch, sizeof (*dxf_hatch));
         dxf_hatch = NULL;
 #if DEBUG
         DXF_DEBUG_END
@@ -3115,7 +4001,7 @@ dxf_hatch_pattern_free
         }
         free (dxf_hatch_pattern->lines);
         free (dxf_hatch_pattern->seed_points);
-        free (dxf_hatch_pattern);
+        dxf_entity_dealloc (dxf_hatch_pattern, sizeof (*dxf_hatch_pattern));
         dxf_hatch_pattern = NULL;
 #if DEBUG
         DXF_DEBUG_END
@@ -3149,7 +4035,7 @@ dxf_hatch_pattern_def_line_free
                   __FUNCTION__);
                 return (EXIT_FAILURE);
         }
-        free (dxf_hatch_pattern_def_line);
+        dxf_entity_dealloc (dxf_hatch_pattern_def_line, sizeof (*dxf_hatch_pattern_def_line));
         dxf_hatch_pattern_def_line = NULL;
 #if DEBUG
         DXF_DEBUG_END
@@ -3183,7 +4069,7 @@ dxf_hatch_pattern_seedpoint_free
                   __FUNCTION__);
                 return (EXIT_FAILURE);
         }
-        free (dxf_hatch_pattern_seedpoint);
+        dxf_entity_dealloc (dxf_hatch_pattern_seedpoint, sizeof (*dxf_hatch_pattern_seedpoint));
         dxf_hatch_pattern_seedpoint = NULL;
 #if DEBUG
         DXF_DEBUG_END
@@ -3219,7 +4105,7 @@ dxf_hatch_boundary_path_free
         }
         free (dxf_hatch_boundary_path->edges);
         free (dxf_hatch_boundary_path->polylines);
-        free (dxf_hatch_boundary_path);
+        dxf_entity_dealloc (dxf_hatch_boundary_path, sizeof (*dxf_hatch_boundary_path));
         dxf_hatch_boundary_path = NULL;
 #if DEBUG
         DXF_DEBUG_END
@@ -3254,7 +4140,7 @@ dxf_hatch_boundary_path_polyline_free
                 return (EXIT_FAILURE);
         }
         free (dxf_hatch_boundary_path_polyline->vertices);
-        free (dxf_hatch_boundary_path_polyline);
+        dxf_entity_dealloc (dxf_hatch_boundary_path_polyline, sizeof (*dxf_hatch_boundary_path_polyline));
         dxf_hatch_boundary_path_polyline = NULL;
 #if DEBUG
         DXF_DEBUG_END
@@ -3288,7 +4174,7 @@ dxf_hatch_boundary_path_polyline_vertex_free
                   __FUNCTION__);
                 return (EXIT_FAILURE);
         }
-        free (dxf_hatch_boundary_path_polyline_vertex);
+        dxf_entity_dealloc (dxf_hatch_boundary_path_polyline_vertex, sizeof (*dxf_hatch_boundary_path_polyline_vertex));
         dxf_hatch_boundary_path_polyline_vertex = NULL;
 #if DEBUG
         DXF_DEBUG_END
@@ -3315,18 +4201,7 @@ dxf_hatch_boundary_path_edge_free
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        if (dxf_hatch_boundary_path_edge->next != NULL)
-        {
-                fprintf (stderr,
-                  (_("Error in %s () pointer to next DxfHatchBoundaryPathEdge was not NULL.\n")),
-                  __FUNCTION__);
-                return (EXIT_FAILURE);
-        }
-        free (dxf_hatch_boundary_path_edge->arcs);
-        free (dxf_hatch_boundary_path_edge->ellipses);
-        free (dxf_hatch_boundary_path_edge->lines);
-        free (dxf_hatch_boundary_path_edge->splines);
-        free (dxf_hatch_boundary_path_edge);
+        dxf_entity_dealloc (dxf_hatch_boundary_path_edge, sizeof (*dxf_hatch_boundary_path_edge));
         dxf_hatch_boundary_path_edge = NULL;
 #if DEBUG
         DXF_DEBUG_END
@@ -3360,7 +4235,7 @@ dxf_hatch_boundary_path_edge_arc_free
                   __FUNCTION__);
                 return (EXIT_FAILURE);
         }
-        free (dxf_hatch_boundary_path_edge_arc);
+        dxf_entity_dealloc (dxf_hatch_boundary_path_edge_arc, sizeof (*dxf_hatch_boundary_path_edge_arc));
         dxf_hatch_boundary_path_edge_arc = NULL;
 #if DEBUG
         DXF_DEBUG_END
@@ -3394,7 +4269,7 @@ dxf_hatch_boundary_path_edge_ellipse_free
                   __FUNCTION__);
                 return (EXIT_FAILURE);
         }
-        free (dxf_hatch_boundary_path_edge_ellipse);
+        dxf_entity_dealloc (dxf_hatch_boundary_path_edge_ellipse, sizeof (*dxf_hatch_boundary_path_edge_ellipse));
         dxf_hatch_boundary_path_edge_ellipse = NULL;
 #if DEBUG
         DXF_DEBUG_END
@@ -3428,7 +4303,7 @@ dxf_hatch_boundary_path_edge_line_free
                   __FUNCTION__);
                 return (EXIT_FAILURE);
         }
-        free (dxf_hatch_boundary_path_edge_line);
+        dxf_entity_dealloc (dxf_hatch_boundary_path_edge_line, sizeof (*dxf_hatch_boundary_path_edge_line));
         dxf_hatch_boundary_path_edge_line = NULL;
 #if DEBUG
         DXF_DEBUG_END
@@ -3463,7 +4338,7 @@ dxf_hatch_boundary_path_edge_spline_free
                 return (EXIT_FAILURE);
         }
         free (dxf_hatch_boundary_path_edge_spline->control_points);
-        free (dxf_hatch_boundary_path_edge_spline);
+        dxf_entity_dealloc (dxf_hatch_boundary_path_edge_spline, sizeof (*dxf_hatch_boundary_path_edge_spline));
         dxf_hatch_boundary_path_edge_spline = NULL;
 #if DEBUG
         DXF_DEBUG_END
@@ -3497,7 +4372,7 @@ dxf_hatch_boundary_path_edge_spline_control_point_free
                   __FUNCTION__);
                 return (EXIT_FAILURE);
         }
-        free (dxf_hatch_boundary_path_edge_spline_cp);
+        dxf_entity_dealloc (dxf_hatch_boundary_path_edge_spline_cp, sizeof (*dxf_hatch_boundary_path_edge_spline_cp));
         dxf_hatch_boundary_path_edge_spline_cp = NULL;
 #if DEBUG
         DXF_DEBUG_END
@@ -43,6 +43,7 @@
 #include <math.h>
 
 #include "global.h"
+#include "arena.h"
 #include "point.h"
 
 
@@ -200,8 +201,35 @@ dxf_hatch_boundary_path_edge_spline
 
 
 /*!
- * \brief DXF definition of an AutoCAD hatch boundary path edge
- * (composite of arcs, ellipses, lines or splines).
+ * \brief Type tag of a DXF hatch boundary path edge.
+ *
+ * The values match the edge type data of group code 72 in a non
+ * polyline boundary path.
+ */
+typedef enum
+dxf_hatch_boundary_path_edge_type
+{
+        DXF_HATCH_BOUNDARY_PATH_EDGE_LINE = 1,
+                /*!< the edge is a \c DxfHatchBoundaryPathEdgeLine. */
+        DXF_HATCH_BOUNDARY_PATH_EDGE_ARC = 2,
+                /*!< the edge is a \c DxfHatchBoundaryPathEdgeArc. */
+        DXF_HATCH_BOUNDARY_PATH_EDGE_ELLIPSE = 3,
+                /*!< the edge is a \c DxfHatchBoundaryPathEdgeEllipse. */
+        DXF_HATCH_BOUNDARY_PATH_EDGE_SPLINE = 4
+                /*!< the edge is a \c DxfHatchBoundaryPathEdgeSpline. */
+} DxfHatchBoundaryPathEdgeType;
+
+
+/*!
+ * \brief DXF definition of an AutoCAD hatch boundary path edge: an
+ * arc, an ellipse, a line or a spline, tagged by \c type.
+ *
+ * Edges live in the ordered \c edges array of their
+ * \c DxfHatchBoundaryPath in the order the DXF file defines them.\n
+ * The former per type linked lists lost that ordering and forced four
+ * traversals per path; one contiguous array keeps the edges in
+ * definition order and makes offset and area computations a linear
+ * sweep.
  */
 typedef struct
 dxf_hatch_boundary_path_edge
@@ -210,25 +238,25 @@ dxf_hatch_boundary_path_edge
                 /*!< group code = 5.\n
                  * Treat the boundary path edge as if it were a single
                  * (composite) entity. */
-        struct DxfHatchBoundaryPathEdgeArc *arcs;
-                /*!< pointer to the first DxfHatchBoundaryPathEdgeArc.\n
-                 * \c NULL if there is no DxfHatchBoundaryPathEdgeArc in
-                 * the DxfHatchBoundaryPathEdge. */
-        struct DxfHatchBoundaryPathEdgeEllipse *ellipses;
-                /*!< pointer to the first DxfHatchBoundaryPathEdgeEllipse.\n
-                 * \c NULL if there is no DxfHatchBoundaryPathEdgeEllipse
-                 * in the DxfHatchBoundaryPathEdge. */
-        struct DxfHatchBoundaryPathEdgeLine * lines;
-                /*!< pointer to the first DxfHatchBoundaryPathEdgeLine.\n
-                 * \c NULL if there is no DxfHatchBoundaryPathEdgeLine
-                 * in the DxfHatchBoundaryPathEdge. */
-        struct DxfHatchBoundaryPathEdgeSpline *splines;
-                /*!< pointer to the first DxfHatchBoundaryPathEdgeSpline.\n
-                 * \c NULL if there is no DxfHatchBoundaryPathEdgeSpline
-                 * in the DxfHatchBoundaryPathEdge. */
-        struct DxfHatchBoundaryPathEdge *next;
-                /*!< pointer to the next DxfHatchBoundaryPathEdge.\n
-                 * \c NULL if the last DxfHatchBoundaryPathEdge. */
+        DxfHatchBoundaryPathEdgeType type;
+                /*!< group code = 72\n
+                 * selects which member of \c edge holds the data. */
+        union
+        {
+                DxfHatchBoundaryPathEdgeArc arc;
+                        /*!< the arc data, when \c type is
+                         * \c DXF_HATCH_BOUNDARY_PATH_EDGE_ARC. */
+                DxfHatchBoundaryPathEdgeEllipse ellipse;
+                        /*!< the ellipse data, when \c type is
+                         * \c DXF_HATCH_BOUNDARY_PATH_EDGE_ELLIPSE. */
+                DxfHatchBoundaryPathEdgeLine line;
+                        /*!< the line data, when \c type is
+                         * \c DXF_HATCH_BOUNDARY_PATH_EDGE_LINE. */
+                DxfHatchBoundaryPathEdgeSpline spline;
+                        /*!< the spline data, when \c type is
+                         * \c DXF_HATCH_BOUNDARY_PATH_EDGE_SPLINE. */
+        } edge;
+                /*!< the edge data, selected by \c type. */
 } DxfHatchBoundaryPathEdge;
 
 
@@ -293,10 +321,18 @@ dxf_hatch_boundary_path
                 /*!< group code = 5.\n
                  * Treat the boundary path as if it were a single
                  * (composite) entity. */
-        struct DxfHatchBoundaryPathEdge *edges;
-                /*!< pointer to the first DxfHatchBoundaryPathEdge.\n
+        DxfHatchBoundaryPathEdge *edges;
+                /*!< ordered array of the edges of the boundary path,
+                 * in the order the DXF file defines them (see
+                 * \c dxf_hatch_boundary_path_edge_append).\n
                  * \c NULL if there is no DxfHatchBoundaryPathEdge in
                  * the DxfHatchBoundaryPath. */
+        int number_of_edges;
+                /*!< group code = 93\n
+                 * number of edges in the \c edges array. */
+        int edges_size;
+                /*!< number of allocated entries in the \c edges
+                 * array. */
         struct DxfHatchBoundaryPathPolyline *polylines;
                 /*!< pointer to the first DxfHatchBoundaryPathPolyline.\n
                  * \c NULL if there is no DxfHatchBoundaryPathPolyline
@@ -530,11 +566,76 @@ dxf_hatch
         struct DxfHatch *next;
                 /*!< pointer to the next DxfHatch.\n
                  * \c NULL if the last DxfHatch. */
+        DxfArena *boundary_pool;
+                /*!< pool holding the boundary path graph of the hatch
+                 * (see \c dxf_hatch_pool_alloc), or \c NULL until the
+                 * first pooled allocation.\n
+                 * Released in one call by \c dxf_hatch_free; nodes
+                 * living in the pool shall not be passed to the per
+                 * node free functions. */
 } DxfHatch;
 
 
 DxfHatch *
 dxf_hatch_new ();
+void *
+dxf_hatch_pool_alloc
+(
+        DxfHatch *dxf_hatch,
+        size_t size
+);
+DxfHatchBoundaryPath *
+dxf_hatch_boundary_path_pool_new
+(
+        DxfHatch *dxf_hatch
+);
+DxfHatchBoundaryPathPolyline *
+dxf_hatch_boundary_path_polyline_pool_new
+(
+        DxfHatch *dxf_hatch
+);
+DxfHatchBoundaryPathPolylineVertex *
+dxf_hatch_boundary_path_polyline_vertex_pool_new
+(
+        DxfHatch *dxf_hatch
+);
+DxfHatchBoundaryPathEdge *
+dxf_hatch_boundary_path_edge_pool_new
+(
+        DxfHatch *dxf_hatch
+);
+DxfHatchBoundaryPathEdge *
+dxf_hatch_boundary_path_edge_append
+(
+        DxfHatch *dxf_hatch,
+        DxfHatchBoundaryPath *dxf_hatch_boundary_path,
+        DxfHatchBoundaryPathEdgeType edge_type
+);
+DxfHatchBoundaryPathEdgeArc *
+dxf_hatch_boundary_path_edge_arc_pool_new
+(
+        DxfHatch *dxf_hatch
+);
+DxfHatchBoundaryPathEdgeEllipse *
+dxf_hatch_boundary_path_edge_ellipse_pool_new
+(
+        DxfHatch *dxf_hatch
+);
+DxfHatchBoundaryPathEdgeLine *
+dxf_hatch_boundary_path_edge_line_pool_new
+(
+        DxfHatch *dxf_hatch
+);
+DxfHatchBoundaryPathEdgeSpline *
+dxf_hatch_boundary_path_edge_spline_pool_new
+(
+        DxfHatch *dxf_hatch
+);
+DxfHatchBoundaryPathEdgeSplineCp *
+dxf_hatch_boundary_path_edge_spline_control_point_pool_new
+(
+        DxfHatch *dxf_hatch
+);
 DxfHatchPattern *
 dxf_hatch_pattern_new ();
 DxfHatchPatternDefLine *
@@ -750,6 +851,50 @@ dxf_hatch_boundary_path_polyline_point_inside_polyline
         DxfPoint *dxf_point
 );
 int
+dxf_hatch_vertices_bbox
+(
+        const double *x,
+        const double *y,
+        size_t length,
+        double *min_x,
+        double *min_y,
+        double *max_x,
+        double *max_y
+);
+int
+dxf_hatch_vertices_transform
+(
+        double *x,
+        double *y,
+        size_t length,
+        double xx,
+        double xy,
+        double yx,
+        double yy,
+        double dx,
+        double dy
+);
+int
+dxf_hatch_boundary_path_polyline_bbox
+(
+        DxfHatchBoundaryPathPolyline *dxf_hatch_boundary_path_polyline,
+        double *min_x,
+        double *min_y,
+        double *max_x,
+        double *max_y
+);
+int
+dxf_hatch_boundary_path_polyline_transform
+(
+        DxfHatchBoundaryPathPolyline *dxf_hatch_boundary_path_polyline,
+        double xx,
+        double xy,
+        double yx,
+        double yy,
+        double dx,
+        double dy
+);
+int
 dxf_hatch_boundary_path_polyline_write
 (
         DxfFile *fp,
@@ -30,6 +30,7 @@
  */
 
 #include <stdarg.h>
+#include <stddef.h>
 #include <time.h>
 #include "global.h"
 #include "file.h"
@@ -806,8 +807,901 @@ dxf_write_header_metric_new
 }
 
 
+/*!
+ * \brief The value type of a header variable.
+ */
+enum dxf_header_var_type
+{
+        DXF_HEADER_VAR_INT,
+        DXF_HEADER_VAR_STRING,
+        DXF_HEADER_VAR_DOUBLE
+};
+
+
+/*!
+ * \brief One entry of the header write table: the preformatted group
+ * codes for a variable, where its components live in a \c DxfHeader
+ * and for which versions it is emitted.
+ */
+typedef struct
+dxf_header_write_spec
+{
+        const char *format;
+                /*!< the complete format string for the variable,
+                 * group codes included. */
+        int type;
+                /*!< the value type, from \c dxf_header_var_type. */
+        int quant;
+                /*!< number of components (2 or 3 for point types). */
+        size_t offset[3];
+                /*!< offsets of the components within \c DxfHeader. */
+        int min_version;
+                /*!< lowest AutoCAD version carrying the variable. */
+        int max_version;
+                /*!< highest AutoCAD version carrying the variable. */
+} DxfHeaderWriteSpec;
+
+
+/*!
+ * The header write table, in emission order.
+ */
+static const DxfHeaderWriteSpec dxf_header_write_table[] =
+{
+        {"  9\n$ACADVER\n  1\n%s\n",
+                DXF_HEADER_VAR_STRING, 1,
+                {offsetof (DxfHeader, AcadVer)}, 0, 9999},
+        {"  9\n$ACADMAINTVER\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, AcadMaintVer)}, 1014, 9999},
+        {"  9\n$DWGCODEPAGE\n  3\n%s\n",
+                DXF_HEADER_VAR_STRING, 1,
+                {offsetof (DxfHeader, DWGCodePage)}, 1012, 9999},
+        {"  9\n$INSBASE\n 10\n%f\n 20\n%f\n 30\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 3,
+                {offsetof (DxfHeader, InsBase.x0),
+                 offsetof (DxfHeader, InsBase.y0),
+                 offsetof (DxfHeader, InsBase.z0)}, 0, 9999},
+        {"  9\n$EXTMIN\n 10\n%f\n 20\n%f\n 30\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 3,
+                {offsetof (DxfHeader, ExtMin.x0),
+                 offsetof (DxfHeader, ExtMin.y0),
+                 offsetof (DxfHeader, ExtMin.z0)}, 0, 9999},
+        {"  9\n$EXTMAX\n 10\n%f\n 20\n%f\n 30\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 3,
+                {offsetof (DxfHeader, ExtMax.x0),
+                 offsetof (DxfHeader, ExtMax.y0),
+                 offsetof (DxfHeader, ExtMax.z0)}, 0, 9999},
+        {"  9\n$LIMMIN\n 10\n%f\n 20\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 2,
+                {offsetof (DxfHeader, LimMin.x0),
+                 offsetof (DxfHeader, LimMin.y0)}, 0, 9999},
+        {"  9\n$LIMMAX\n 10\n%f\n 20\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 2,
+                {offsetof (DxfHeader, LimMax.x0),
+                 offsetof (DxfHeader, LimMax.y0)}, 0, 9999},
+        {"  9\n$ORTHOMODE\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, OrthoMode)}, 0, 9999},
+        {"  9\n$REGENMODE\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, RegenMode)}, 0, 9999},
+        {"  9\n$FILLMODE\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, FillMode)}, 0, 9999},
+        {"  9\n$QTEXTMODE\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, QTextMode)}, 0, 9999},
+        {"  9\n$MIRRTEXT\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, MirrText)}, 0, 9999},
+        {"  9\n$DRAGMODE\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DragMode)}, 0, 1015},
+        {"  9\n$LTSCALE\n 40\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, LTScale)}, 0, 9999},
+        {"  9\n$OSMODE\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, OSMode)}, 0, 1014},
+        {"  9\n$ATTMODE\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, AttMode)}, 0, 9999},
+        {"  9\n$TEXTSIZE\n 40\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, TextSize)}, 0, 9999},
+        {"  9\n$TRACEWID\n 40\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, TraceWid)}, 0, 9999},
+        {"  9\n$TEXTSTYLE\n  7\n%s\n",
+                DXF_HEADER_VAR_STRING, 1,
+                {offsetof (DxfHeader, TextStyle)}, 0, 9999},
+        {"  9\n$CLAYER\n  8\n%s\n",
+                DXF_HEADER_VAR_STRING, 1,
+                {offsetof (DxfHeader, CLayer)}, 0, 9999},
+        {"  9\n$CELTYPE\n  6\n%s\n",
+                DXF_HEADER_VAR_STRING, 1,
+                {offsetof (DxfHeader, CELType)}, 0, 9999},
+        {"  9\n$CECOLOR\n 62\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, CEColor)}, 0, 9999},
+        {"  9\n$CELTSCALE\n 40\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, CELTScale)}, 1012, 9999},
+        {"  9\n$DELOBJ\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DelObj)}, 1012, 1014},
+        {"  9\n$DISPSILH\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DispSilH)}, 0, 1012},
+        {"  9\n$DIMSCALE\n 40\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, DimSCALE)}, 0, 9999},
+        {"  9\n$DIMASZ\n 40\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, DimASZ)}, 0, 9999},
+        {"  9\n$DIMEXO\n 40\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, DimEXO)}, 0, 9999},
+        {"  9\n$DIMDLI\n 40\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, DimDLI)}, 0, 9999},
+        {"  9\n$DIMRND\n 40\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, DimRND)}, 0, 9999},
+        {"  9\n$DIMDLE\n 40\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, DimDLE)}, 0, 9999},
+        {"  9\n$DIMEXE\n 40\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, DimEXE)}, 0, 9999},
+        {"  9\n$DIMTP\n 40\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, DimTP)}, 0, 9999},
+        {"  9\n$DIMTM\n 40\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, DimTM)}, 0, 9999},
+        {"  9\n$DIMTXT\n 40\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, DimTXT)}, 0, 9999},
+        {"  9\n$DIMCEN\n 40\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, DimCEN)}, 0, 9999},
+        {"  9\n$DIMTSZ\n 40\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, DimTSZ)}, 0, 9999},
+        {"  9\n$DIMTOL\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DimTOL)}, 0, 9999},
+        {"  9\n$DIMLIM\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DimLIM)}, 0, 9999},
+        {"  9\n$DIMTIH\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DimTIH)}, 0, 9999},
+        {"  9\n$DIMTOH\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DimTOH)}, 0, 9999},
+        {"  9\n$DIMSE1\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DimSE1)}, 0, 9999},
+        {"  9\n$DIMSE2\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DimSE2)}, 0, 9999},
+        {"  9\n$DIMTAD\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DimTAD)}, 0, 9999},
+        {"  9\n$DIMZIN\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DimZIN)}, 0, 9999},
+        {"  9\n$DIMBLK\n  1\n%s\n",
+                DXF_HEADER_VAR_STRING, 1,
+                {offsetof (DxfHeader, DimBLK)}, 0, 9999},
+        {"  9\n$DIMASO\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DimASO)}, 0, 9999},
+        {"  9\n$DIMSHO\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DimSHO)}, 0, 9999},
+        {"  9\n$DIMPOST\n  1\n%s\n",
+                DXF_HEADER_VAR_STRING, 1,
+                {offsetof (DxfHeader, DimPOST)}, 0, 9999},
+        {"  9\n$DIMAPOST\n  1\n%s\n",
+                DXF_HEADER_VAR_STRING, 1,
+                {offsetof (DxfHeader, DimAPOST)}, 0, 9999},
+        {"  9\n$DIMALT\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DimALT)}, 0, 9999},
+        {"  9\n$DIMALTD\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DimALTD)}, 0, 9999},
+        {"  9\n$DIMALTF\n 40\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, DimALTF)}, 0, 9999},
+        {"  9\n$DIMLFAC\n 40\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, DimLFAC)}, 0, 9999},
+        {"  9\n$DIMTOFL\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DimTOFL)}, 0, 9999},
+        {"  9\n$DIMTVP\n 40\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, DimTVP)}, 0, 9999},
+        {"  9\n$DIMTIX\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DimTIX)}, 0, 9999},
+        {"  9\n$DIMSOXD\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DimSOXD)}, 0, 9999},
+        {"  9\n$DIMSAH\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DimSAH)}, 0, 9999},
+        {"  9\n$DIMBLK1\n  1\n%s\n",
+                DXF_HEADER_VAR_STRING, 1,
+                {offsetof (DxfHeader, DimBLK1)}, 0, 9999},
+        {"  9\n$DIMBLK2\n  1\n%s\n",
+                DXF_HEADER_VAR_STRING, 1,
+                {offsetof (DxfHeader, DimBLK2)}, 0, 9999},
+        {"  9\n$DIMSTYLE\n  2\n%s\n",
+                DXF_HEADER_VAR_STRING, 1,
+                {offsetof (DxfHeader, DimSTYLE)}, 0, 9999},
+        {"  9\n$DIMCLRD\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DimCLRD)}, 0, 9999},
+        {"  9\n$DIMCLRE\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DimCLRE)}, 0, 9999},
+        {"  9\n$DIMCLRT\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DimCLRT)}, 0, 9999},
+        {"  9\n$DIMTFAC\n 40\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, DimTFAC)}, 0, 9999},
+        {"  9\n$DIMGAP\n 40\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, DimGAP)}, 0, 9999},
+        {"  9\n$DIMJUST\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DimJUST)}, 1012, 9999},
+        {"  9\n$DIMSD1\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DimSD1)}, 1012, 9999},
+        {"  9\n$DIMSD2\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DimSD2)}, 1012, 9999},
+        {"  9\n$DIMTOLJ\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DimTOLJ)}, 1012, 9999},
+        {"  9\n$DIMTZIN\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DimTZIN)}, 1012, 9999},
+        {"  9\n$DIMALTZ\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DimALTZ)}, 1012, 9999},
+        {"  9\n$DIMALTTZ\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DimALTTZ)}, 1012, 9999},
+        {"  9\n$DIMFIT\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DimFIT)}, 1012, 1014},
+        {"  9\n$DIMUPT\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DimUPT)}, 1012, 9999},
+        {"  9\n$DIMUNIT\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DimUNIT)}, 1012, 1014},
+        {"  9\n$DIMDEC\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DimDEC)}, 1012, 9999},
+        {"  9\n$DIMTDEC\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DimTDEC)}, 1012, 9999},
+        {"  9\n$DIMALTU\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DimALTU)}, 1012, 9999},
+        {"  9\n$DIMALTTD\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DimALTTD)}, 1012, 9999},
+        {"  9\n$DIMTXSTY\n  7\n%s\n",
+                DXF_HEADER_VAR_STRING, 1,
+                {offsetof (DxfHeader, DimTXSTY)}, 1012, 9999},
+        {"  9\n$DIMAUNIT\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DimAUNIT)}, 1012, 9999},
+        {"  9\n$DIMADEC\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DimADEC)}, 1015, 9999},
+        {"  9\n$DIMALTRND\n 40\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, DimALTRND)}, 1015, 9999},
+        {"  9\n$DIMAZIN\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DimAZIN)}, 1015, 9999},
+        {"  9\n$DIMDSEP\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DimDSEP)}, 1015, 9999},
+        {"  9\n$DIMATFIT\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DimATFIT)}, 1015, 9999},
+        {"  9\n$DIMFRAC\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DimFRAC)}, 1015, 9999},
+        {"  9\n$DIMLDRBLK\n  1\n%s\n",
+                DXF_HEADER_VAR_STRING, 1,
+                {offsetof (DxfHeader, DimLDRBLK)}, 1015, 9999},
+        {"  9\n$DIMLUNIT\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DimLUNIT)}, 1015, 9999},
+        {"  9\n$DIMLWD\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DimLWD)}, 1015, 9999},
+        {"  9\n$DIMLWE\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DimLWE)}, 1015, 9999},
+        {"  9\n$DIMTMOVE\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DimTMOVE)}, 1015, 9999},
+        {"  9\n$LUNITS\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, LUnits)}, 0, 9999},
+        {"  9\n$LUPREC\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, LUPrec)}, 0, 9999},
+        {"  9\n$SKETCHINC\n 40\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, Sketchinc)}, 0, 9999},
+        {"  9\n$FILLETRAD\n 40\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, FilletRad)}, 0, 9999},
+        {"  9\n$AUNITS\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, AUnits)}, 0, 9999},
+        {"  9\n$AUPREC\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, AUPrec)}, 0, 9999},
+        {"  9\n$MENU\n  1\n%s\n",
+                DXF_HEADER_VAR_STRING, 1,
+                {offsetof (DxfHeader, Menu)}, 0, 9999},
+        {"  9\n$ELEVATION\n 40\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, Elevation)}, 0, 9999},
+        {"  9\n$PELEVATION\n 40\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, PElevation)}, 0, 9999},
+        {"  9\n$THICKNESS\n 40\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, Thickness)}, 0, 9999},
+        {"  9\n$LIMCHECK\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, LimCheck)}, 0, 9999},
+        {"  9\n$BLIPMODE\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, BlipMode)}, 0, 1014},
+        {"  9\n$CHAMFERA\n 40\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, ChamferA)}, 0, 9999},
+        {"  9\n$CHAMFERB\n 40\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, ChamferB)}, 0, 9999},
+        {"  9\n$CHAMFERC\n 40\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, ChamferC)}, 1012, 9999},
+        {"  9\n$CHAMFERD\n 40\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, ChamferD)}, 1012, 9999},
+        {"  9\n$SKPOLY\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, SKPoly)}, 0, 9999},
+        {"  9\n$TDCREATE\n 40\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, TDCreate)}, 0, 9999},
+        {"  9\n$TDUCREATE\n 40\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, TDUCreate)}, 1015, 9999},
+        {"  9\n$TDUPDATE\n 40\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, TDUpdate)}, 0, 9999},
+        {"  9\n$TDUUPDATE\n 40\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, TDUUpdate)}, 1015, 9999},
+        {"  9\n$TDINDWG\n 40\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, TDInDWG)}, 0, 9999},
+        {"  9\n$TDUSRTIMER\n 40\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, TDUSRTimer)}, 0, 9999},
+        {"  9\n$USRTIMER\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, USRTimer)}, 0, 9999},
+        {"  9\n$ANGBASE\n 50\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, AngBase)}, 0, 9999},
+        {"  9\n$ANGDIR\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, AngDir)}, 0, 9999},
+        {"  9\n$PDMODE\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, PDMode)}, 0, 9999},
+        {"  9\n$PDSIZE\n 40\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, PDSize)}, 0, 9999},
+        {"  9\n$PLINEWID\n 40\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, PLineWid)}, 0, 9999},
+        {"  9\n$COORDS\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, Coords)}, 0, 1014},
+        {"  9\n$SPLFRAME\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, SPLFrame)}, 0, 9999},
+        {"  9\n$SPLINETYPE\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, SPLineType)}, 0, 9999},
+        {"  9\n$ATTDIA\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, AttDia)}, 0, 1014},
+        {"  9\n$ATTREQ\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, AttReq)}, 0, 1014},
+        {"  9\n$HANDLING\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, Handling)}, 0, 1014},
+        {"  9\n$SPLINESEGS\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, SPLineSegs)}, 0, 9999},
+        {"  9\n$HANDSEED\n  5\n%s\n",
+                DXF_HEADER_VAR_STRING, 1,
+                {offsetof (DxfHeader, HandSeed)}, 0, 9999},
+        {"  9\n$SURFTAB1\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, SurfTab1)}, 0, 9999},
+        {"  9\n$SURFTAB2\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, SurfTab2)}, 0, 9999},
+        {"  9\n$SURFTYPE\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, SurfType)}, 0, 9999},
+        {"  9\n$SURFU\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, SurfU)}, 0, 9999},
+        {"  9\n$SURFV\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, SurfV)}, 0, 9999},
+        {"  9\n$UCSBASE\n  2\n%s\n",
+                DXF_HEADER_VAR_STRING, 1,
+                {offsetof (DxfHeader, UCSBase)}, 1015, 9999},
+        {"  9\n$UCSNAME\n  2\n%s\n",
+                DXF_HEADER_VAR_STRING, 1,
+                {offsetof (DxfHeader, UCSName)}, 0, 9999},
+        {"  9\n$UCSORG\n 10\n%f\n 20\n%f\n 30\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 3,
+                {offsetof (DxfHeader, UCSOrg.x0),
+                 offsetof (DxfHeader, UCSOrg.y0),
+                 offsetof (DxfHeader, UCSOrg.z0)}, 0, 9999},
+        {"  9\n$UCSXDIR\n 10\n%f\n 20\n%f\n 30\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 3,
+                {offsetof (DxfHeader, UCSXDir.x0),
+                 offsetof (DxfHeader, UCSXDir.y0),
+                 offsetof (DxfHeader, UCSXDir.z0)}, 0, 9999},
+        {"  9\n$UCSYDIR\n 10\n%f\n 20\n%f\n 30\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 3,
+                {offsetof (DxfHeader, UCSYDir.x0),
+                 offsetof (DxfHeader, UCSYDir.y0),
+                 offsetof (DxfHeader, UCSYDir.z0)}, 0, 9999},
+        {"  9\n$UCSORTHOREF\n  2\n%s\n",
+                DXF_HEADER_VAR_STRING, 1,
+                {offsetof (DxfHeader, UCSOrthoRef)}, 1015, 9999},
+        {"  9\n$UCSORTHOVIEW\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, UCSOrthoView)}, 1015, 9999},
+        {"  9\n$UCSORGTOP\n 10\n%f\n 20\n%f\n 30\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 3,
+                {offsetof (DxfHeader, UCSOrgTop.x0),
+                 offsetof (DxfHeader, UCSOrgTop.y0),
+                 offsetof (DxfHeader, UCSOrgTop.z0)}, 1015, 9999},
+        {"  9\n$UCSORGBOTTOM\n 10\n%f\n 20\n%f\n 30\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 3,
+                {offsetof (DxfHeader, UCSOrgBottom.x0),
+                 offsetof (DxfHeader, UCSOrgBottom.y0),
+                 offsetof (DxfHeader, UCSOrgBottom.z0)}, 1015, 9999},
+        {"  9\n$UCSORGLEFT\n 10\n%f\n 20\n%f\n 30\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 3,
+                {offsetof (DxfHeader, UCSOrgLeft.x0),
+                 offsetof (DxfHeader, UCSOrgLeft.y0),
+                 offsetof (DxfHeader, UCSOrgLeft.z0)}, 1015, 9999},
+        {"  9\n$UCSORGRIGHT\n 10\n%f\n 20\n%f\n 30\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 3,
+                {offsetof (DxfHeader, UCSOrgRight.x0),
+                 offsetof (DxfHeader, UCSOrgRight.y0),
+                 offsetof (DxfHeader, UCSOrgRight.z0)}, 1015, 9999},
+        {"  9\n$UCSORGFRONT\n 10\n%f\n 20\n%f\n 30\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 3,
+                {offsetof (DxfHeader, UCSOrgFront.x0),
+                 offsetof (DxfHeader, UCSOrgFront.y0),
+                 offsetof (DxfHeader, UCSOrgFront.z0)}, 1015, 9999},
+        {"  9\n$UCSORGBACK\n 10\n%f\n 20\n%f\n 30\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 3,
+                {offsetof (DxfHeader, UCSOrgBack.x0),
+                 offsetof (DxfHeader, UCSOrgBack.y0),
+                 offsetof (DxfHeader, UCSOrgBack.z0)}, 1015, 9999},
+        {"  9\n$PUCSBASE\n  2\n%s\n",
+                DXF_HEADER_VAR_STRING, 1,
+                {offsetof (DxfHeader, PUCSBase)}, 1015, 9999},
+        {"  9\n$PUCSNAME\n  2\n%s\n",
+                DXF_HEADER_VAR_STRING, 1,
+                {offsetof (DxfHeader, PUCSName)}, 0, 9999},
+        {"  9\n$PUCSORG\n 10\n%f\n 20\n%f\n 30\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 3,
+                {offsetof (DxfHeader, PUCSOrg.x0),
+                 offsetof (DxfHeader, PUCSOrg.y0),
+                 offsetof (DxfHeader, PUCSOrg.z0)}, 0, 9999},
+        {"  9\n$PUCSXDIR\n 10\n%f\n 20\n%f\n 30\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 3,
+                {offsetof (DxfHeader, PUCSXDir.x0),
+                 offsetof (DxfHeader, PUCSXDir.y0),
+                 offsetof (DxfHeader, PUCSXDir.z0)}, 0, 9999},
+        {"  9\n$PUCSYDIR\n 10\n%f\n 20\n%f\n 30\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 3,
+                {offsetof (DxfHeader, PUCSYDir.x0),
+                 offsetof (DxfHeader, PUCSYDir.y0),
+                 offsetof (DxfHeader, PUCSYDir.z0)}, 0, 9999},
+        {"  9\n$PUCSORTHOREF\n  2\n%s\n",
+                DXF_HEADER_VAR_STRING, 1,
+                {offsetof (DxfHeader, PUCSOrthoRef)}, 1015, 9999},
+        {"  9\n$PUCSORTHOVIEW\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, PUCSOrthoView)}, 1015, 9999},
+        {"  9\n$PUCSORGTOP\n 10\n%f\n 20\n%f\n 30\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 3,
+                {offsetof (DxfHeader, PUCSOrgTop.x0),
+                 offsetof (DxfHeader, PUCSOrgTop.y0),
+                 offsetof (DxfHeader, PUCSOrgTop.z0)}, 1015, 9999},
+        {"  9\n$PUCSORGBOTTOM\n 10\n%f\n 20\n%f\n 30\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 3,
+                {offsetof (DxfHeader, PUCSOrgBottom.x0),
+                 offsetof (DxfHeader, PUCSOrgBottom.y0),
+                 offsetof (DxfHeader, PUCSOrgBottom.z0)}, 1015, 9999},
+        {"  9\n$PUCSORGLEFT\n 10\n%f\n 20\n%f\n 30\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 3,
+                {offsetof (DxfHeader, PUCSOrgLeft.x0),
+                 offsetof (DxfHeader, PUCSOrgLeft.y0),
+                 offsetof (DxfHeader, PUCSOrgLeft.z0)}, 1015, 9999},
+        {"  9\n$PUCSORGRIGHT\n 10\n%f\n 20\n%f\n 30\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 3,
+                {offsetof (DxfHeader, PUCSOrgRight.x0),
+                 offsetof (DxfHeader, PUCSOrgRight.y0),
+                 offsetof (DxfHeader, PUCSOrgRight.z0)}, 1015, 9999},
+        {"  9\n$PUCSORGFRONT\n 10\n%f\n 20\n%f\n 30\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 3,
+                {offsetof (DxfHeader, PUCSOrgFront.x0),
+                 offsetof (DxfHeader, PUCSOrgFront.y0),
+                 offsetof (DxfHeader, PUCSOrgFront.z0)}, 1015, 9999},
+        {"  9\n$PUCSORGBACK\n 10\n%f\n 20\n%f\n 30\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 3,
+                {offsetof (DxfHeader, PUCSOrgBack.x0),
+                 offsetof (DxfHeader, PUCSOrgBack.y0),
+                 offsetof (DxfHeader, PUCSOrgBack.z0)}, 1015, 9999},
+        {"  9\n$USERI1\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, UserI1)}, 0, 9999},
+        {"  9\n$USERI2\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, UserI2)}, 0, 9999},
+        {"  9\n$USERI3\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, UserI3)}, 0, 9999},
+        {"  9\n$USERI4\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, UserI4)}, 0, 9999},
+        {"  9\n$USERI5\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, UserI5)}, 0, 9999},
+        {"  9\n$USERR1\n 40\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, UserR1)}, 0, 9999},
+        {"  9\n$USERR2\n 40\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, UserR2)}, 0, 9999},
+        {"  9\n$USERR3\n 40\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, UserR3)}, 0, 9999},
+        {"  9\n$USERR4\n 40\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, UserR4)}, 0, 9999},
+        {"  9\n$USERR5\n 40\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, UserR5)}, 0, 9999},
+        {"  9\n$WORLDVIEW\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, WorldView)}, 0, 9999},
+        {"  9\n$SHADEDGE\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, ShadEdge)}, 0, 9999},
+        {"  9\n$SHADEDIF\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, ShadeDif)}, 0, 9999},
+        {"  9\n$TILEMODE\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, TileMode)}, 0, 9999},
+        {"  9\n$MAXACTVP\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, MaxActVP)}, 0, 9999},
+        {"  9\n$PINSBASE\n 10\n%f\n 20\n%f\n 30\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 3,
+                {offsetof (DxfHeader, PInsBase.x0),
+                 offsetof (DxfHeader, PInsBase.y0),
+                 offsetof (DxfHeader, PInsBase.z0)}, 0, 9999},
+        {"  9\n$PLIMCHECK\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, PLimCheck)}, 0, 9999},
+        {"  9\n$PEXTMIN\n 10\n%f\n 20\n%f\n 30\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 3,
+                {offsetof (DxfHeader, PExtMin.x0),
+                 offsetof (DxfHeader, PExtMin.y0),
+                 offsetof (DxfHeader, PExtMin.z0)}, 0, 9999},
+        {"  9\n$PEXTMAX\n 10\n%f\n 20\n%f\n 30\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 3,
+                {offsetof (DxfHeader, PExtMax.x0),
+                 offsetof (DxfHeader, PExtMax.y0),
+                 offsetof (DxfHeader, PExtMax.z0)}, 0, 9999},
+        {"  9\n$PLIMMIN\n 10\n%f\n 20\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 2,
+                {offsetof (DxfHeader, PLimMin.x0),
+                 offsetof (DxfHeader, PLimMin.y0)}, 0, 9999},
+        {"  9\n$PLIMMAX\n 10\n%f\n 20\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 2,
+                {offsetof (DxfHeader, PLimMax.x0),
+                 offsetof (DxfHeader, PLimMax.y0)}, 0, 9999},
+        {"  9\n$UNITMODE\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, UnitMode)}, 0, 9999},
+        {"  9\n$VISRETAIN\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, VisRetain)}, 0, 9999},
+        {"  9\n$PLINEGEN\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, PLineGen)}, 0, 9999},
+        {"  9\n$PSLTSCALE\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, PSLTScale)}, 0, 9999},
+        {"  9\n$TREEDEPTH\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, TreeDepth)}, 1012, 9999},
+        {"  9\n$PICKSTYLE\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, PickStyle)}, 1012, 1014},
+        {"  9\n$CMLSTYLE\n  2\n%s\n",
+                DXF_HEADER_VAR_STRING, 1,
+                {offsetof (DxfHeader, CMLStyle)}, 1012, 9999},
+        {"  9\n$CMLJUST\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, CMLJust)}, 1012, 9999},
+        {"  9\n$CMLSCALE\n 40\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, CMLScale)}, 1012, 9999},
+        {"  9\n$PROXYGRAPHICS\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, ProxyGraphics)}, 1014, 9999},
+        {"  9\n$MEASUREMENT\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, Measurement)}, 1014, 9999},
+        {"  9\n$SAVEIMAGES\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, SaveImages)}, 1012, 1012},
+        {"  9\n$CELWEIGHT\n370\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, CELWeight)}, 1015, 9999},
+        {"  9\n$ENDCAPS\n280\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, EndCaps)}, 1015, 9999},
+        {"  9\n$JOINSTYLE\n280\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, JoinStyle)}, 1015, 9999},
+        {"  9\n$LWDISPLAY\n290\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, LWDisplay)}, 1015, 9999},
+        {"  9\n$INSUNITS\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, InsUnits)}, 1015, 9999},
+        {"  9\n$HYPERLINKBASE\n  1\n%s\n",
+                DXF_HEADER_VAR_STRING, 1,
+                {offsetof (DxfHeader, HyperLinkBase)}, 1015, 9999},
+        {"  9\n$STYLESHEET\n  1\n%s\n",
+                DXF_HEADER_VAR_STRING, 1,
+                {offsetof (DxfHeader, StyleSheet)}, 1015, 9999},
+        {"  9\n$XEDIT\n290\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, XEdit)}, 1015, 9999},
+        {"  9\n$CEPSNTYPE\n380\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, CEPSNType)}, 1015, 9999},
+        {"  9\n$PSTYLEMODE\n290\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, PStyleMode)}, 1015, 9999},
+        {"  9\n$FINGERPRINTGUID\n  2\n%s\n",
+                DXF_HEADER_VAR_STRING, 1,
+                {offsetof (DxfHeader, FingerPrintGUID)}, 1015, 9999},
+        {"  9\n$VERSIONGUID\n  2\n%s\n",
+                DXF_HEADER_VAR_STRING, 1,
+                {offsetof (DxfHeader, VersionGUID)}, 1015, 9999},
+        {"  9\n$EXTNAMES\n290\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, ExtNames)}, 1015, 9999},
+        {"  9\n$PSVPSCALE\n 40\n%f\n",
+                DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, PSVPScale)}, 1015, 9999},
+        {"  9\n$OLESTARTUP\n290\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, OLEStartUp)}, 1015, 9999},
+        {"  9\n$SORTENTS\n280\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, SortEnts)}, 1018, 9999},
+        {"  9\n$INDEXCTL\n280\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, IndexCtl)}, 1018, 9999},
+        {"  9\n$HIDETEXT\n280\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, HideText)}, 1018, 9999},
+        {"  9\n$XCLIPFRAME\n290\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, XClipFrame)}, 1018, 9999},
+        {"  9\n$HALOGAP\n280\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, HaloGap)}, 1018, 9999},
+        {"  9\n$OBSCOLOR\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, ObsColor)}, 1018, 9999},
+        {"  9\n$OBSLTYPE\n280\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, ObsLType)}, 1018, 9999},
+        {"  9\n$INTERSECTIONDISPLAY\n280\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, InterSectionDisplay)}, 1018, 9999},
+        {"  9\n$INTERSECTIONCOLOR\n 70\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, InterSectionColor)}, 1018, 9999},
+        {"  9\n$DIMASSOC\n280\n%i\n",
+                DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DimASSOC)}, 1018, 9999},
+        {"  9\n$PROJECTNAME\n  1\n%s\n",
+                DXF_HEADER_VAR_STRING, 1,
+                {offsetof (DxfHeader, ProjectName)}, 1018, 9999},
+};
+
+#define DXF_HEADER_WRITE_TABLE_LENGTH \
+        (sizeof (dxf_header_write_table) / sizeof (dxf_header_write_table[0]))
+
+/*!
+ * The variable list precompiled for one AutoCAD version; rebuilt only
+ * when a header for a different version is written, so the version
+ * checks run once per version instead of once per variable.
+ */
+static const DxfHeaderWriteSpec *dxf_header_write_list[DXF_HEADER_WRITE_TABLE_LENGTH];
+static int dxf_header_write_list_length = 0;
+static int dxf_header_write_list_version = -1;
+
+
+/*!
+ * \brief Select the precompiled variable list for an AutoCAD version.
+ */
+static void
+dxf_header_write_select
+(
+        int acad_version_number
+                /*!< AutoCAD version number. */
+)
+{
+        int i;
+
+        if (acad_version_number == dxf_header_write_list_version)
+        {
+                return;
+        }
+        dxf_header_write_list_length = 0;
+        for (i = 0; i < DXF_HEADER_WRITE_TABLE_LENGTH; i++)
+        {
+                if ((acad_version_number >= dxf_header_write_table[i].min_version)
+                  && (acad_version_number <= dxf_header_write_table[i].max_version))
+                {
+                        dxf_header_write_list[dxf_header_write_list_length] = &dxf_header_write_table[i];
+                        dxf_header_write_list_length++;
+                }
+        }
+        dxf_header_write_list_version = acad_version_number;
+}
+
+
+/*!
+ * \brief Look the AutoCAD version range of a header variable up in
+ * the header write table.
+ *
+ * Generic tooling (the streaming re-encoder in recode.c) uses the
+ * range to decide whether a target version carries a variable at all.
+ *
+ * \return \c FOUND when the variable is in the table (and the range
+ * is stored), or \c FAIL when it is unknown.
+ */
+int
+dxf_header_variable_version_range
+(
+        const char *name,
+                /*!< the variable name including the leading \c '$',
+                 * e.g. \c "$ACADVER". */
+        int *min_version,
+                /*!< receives the lowest AutoCAD version carrying the
+                 * variable. */
+        int *max_version
+                /*!< receives the highest AutoCAD version carrying the
+                 * variable. */
+)
+{
+        const char *format_name;
+        size_t length;
+        size_t i;
+
+        if ((name == NULL) || (min_version == NULL) || (max_version == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (FAIL);
+        }
+        length = strlen (name);
+        for (i = 0; i < DXF_HEADER_WRITE_TABLE_LENGTH; i++)
+        {
+                /* the formats all start with the "  9\n" group code
+                 * line followed by the variable name line. */
+                format_name = dxf_header_write_table[i].format + 4;
+                if ((strncmp (format_name, name, length) == 0)
+                  && (format_name[length] == '\n'))
+                {
+                        *min_version = dxf_header_write_table[i].min_version;
+                        *max_version = dxf_header_write_table[i].max_version;
+                        return (FOUND);
+                }
+        }
+        return (FAIL);
+}
+
+
+/*!
+ * \brief The \c $ACADVER string of an AutoCAD version number.
+ *
+ * \return the version string, or \c NULL for an unknown version.
+ */
+const char *
+dxf_header_acad_version_string
+(
+        int acad_version_number
+                /*!< AutoCAD version number. */
+)
+{
+        return (acad_version_string (acad_version_number));
+}
+
+
+/*!
+ * \brief The AutoCAD version number of an \c $ACADVER string.
+ *
+ * \return the version number, or \c 0 for an unknown string.
+ */
+int
+dxf_header_acad_version_number
+(
+        const char *version_string
+                /*!< the version string, e.g. \c "AC1015". */
+)
+{
+        return (acad_version_from_string (version_string));
+}
+
+
 /*!
  * \brief Write DXF output to a file for a dxf header.
+ *
+ * The variable list is precompiled per AutoCAD version on entry and
+ * the complete \c SECTION is formatted into one buffer and written
+ * with a single \c fwrite, instead of re-checking the version and
+ * calling \c fprintf once per variable.
  */
 int
 dxf_write_header
@@ -821,236 +1715,108 @@ dxf_write_header
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        char *dxf_entity_name = strdup ("HEADER");
+        const DxfHeaderWriteSpec *spec;
+        const char *base;
+        const char *string;
+        char *buffer;
+        char *grown;
+        size_t size;
+        size_t used;
+        size_t needed;
+        int i;
 
-        dxf_section_write (fp, dxf_entity_name);
-        fprintf (fp->fp, "  9\n$ACADVER\n  1\n%s\n", dxf_header.AcadVer);
-        if (fp->acad_version_number >= AC1014) fprintf (fp->fp, "  9\n$ACADMAINTVER\n 70\n%i\n", dxf_header.AcadMaintVer);
-        if (fp->acad_version_number >= AC1012) fprintf (fp->fp, "  9\n$DWGCODEPAGE\n  3\n%s\n", dxf_header.DWGCodePage);
-        fprintf (fp->fp, "  9\n$INSBASE\n 10\n%f\n 20\n%f\n 30\n%f\n", dxf_header.InsBase.x0, dxf_header.InsBase.y0, dxf_header.InsBase.z0);
-        fprintf (fp->fp, "  9\n$EXTMIN\n 10\n%f\n 20\n%f\n 30\n%f\n", dxf_header.ExtMin.x0, dxf_header.ExtMin.y0, dxf_header.ExtMin.z0);
-        fprintf (fp->fp, "  9\n$EXTMAX\n 10\n%f\n 20\n%f\n 30\n%f\n", dxf_header.ExtMax.x0, dxf_header.ExtMax.y0, dxf_header.ExtMax.z0);
-        fprintf (fp->fp, "  9\n$LIMMIN\n 10\n%f\n 20\n%f\n", dxf_header.LimMin.x0, dxf_header.LimMin.y0);
-        fprintf (fp->fp, "  9\n$LIMMAX\n 10\n%f\n 20\n%f\n", dxf_header.LimMax.x0, dxf_header.LimMax.y0);
-        fprintf (fp->fp, "  9\n$ORTHOMODE\n 70\n%i\n", dxf_header.OrthoMode);
-        fprintf (fp->fp, "  9\n$REGENMODE\n 70\n%i\n", dxf_header.RegenMode);
-        fprintf (fp->fp, "  9\n$FILLMODE\n 70\n%i\n", dxf_header.FillMode);
-        fprintf (fp->fp, "  9\n$QTEXTMODE\n 70\n%i\n", dxf_header.QTextMode);
-        fprintf (fp->fp, "  9\n$MIRRTEXT\n 70\n%i\n", dxf_header.MirrText);
-        if (fp->acad_version_number <= AC1015) fprintf (fp->fp, "  9\n$DRAGMODE\n 70\n%i\n", dxf_header.DragMode);
-        fprintf (fp->fp, "  9\n$LTSCALE\n 40\n%f\n", dxf_header.LTScale);
-        if (fp->acad_version_number <= AC1014) fprintf (fp->fp, "  9\n$OSMODE\n 70\n%i\n", dxf_header.OSMode);
-        fprintf (fp->fp, "  9\n$ATTMODE\n 70\n%i\n", dxf_header.AttMode);
-        fprintf (fp->fp, "  9\n$TEXTSIZE\n 40\n%f\n", dxf_header.TextSize);
-        fprintf (fp->fp, "  9\n$TRACEWID\n 40\n%f\n", dxf_header.TraceWid);
-        fprintf (fp->fp, "  9\n$TEXTSTYLE\n  7\n%s\n", dxf_header.TextStyle);
-        fprintf (fp->fp, "  9\n$CLAYER\n  8\n%s\n", dxf_header.CLayer);
-        fprintf (fp->fp, "  9\n$CELTYPE\n  6\n%s\n", dxf_header.CELType);
-        fprintf (fp->fp, "  9\n$CECOLOR\n 62\n%i\n", dxf_header.CEColor);
-        if (fp->acad_version_number >= AC1012) fprintf (fp->fp, "  9\n$CELTSCALE\n 40\n%f\n", dxf_header.CELTScale);
-        if ((fp->acad_version_number == AC1012)
-          || (fp->acad_version_number == AC1014)) fprintf (fp->fp, "  9\n$DELOBJ\n 70\n%i\n", dxf_header.DelObj);
-        if (fp->acad_version_number <= AC1012) fprintf (fp->fp, "  9\n$DISPSILH\n 70\n%i\n", dxf_header.DispSilH);
-        fprintf (fp->fp, "  9\n$DIMSCALE\n 40\n%f\n", dxf_header.DimSCALE);
-        fprintf (fp->fp, "  9\n$DIMASZ\n 40\n%f\n", dxf_header.DimASZ);
-        fprintf (fp->fp, "  9\n$DIMEXO\n 40\n%f\n", dxf_header.DimEXO);
-        fprintf (fp->fp, "  9\n$DIMDLI\n 40\n%f\n", dxf_header.DimDLI);
-        fprintf (fp->fp, "  9\n$DIMRND\n 40\n%f\n", dxf_header.DimRND);
-        fprintf (fp->fp, "  9\n$DIMDLE\n 40\n%f\n", dxf_header.DimDLE);
-        fprintf (fp->fp, "  9\n$DIMEXE\n 40\n%f\n", dxf_header.DimEXE);
-        fprintf (fp->fp, "  9\n$DIMTP\n 40\n%f\n", dxf_header.DimTP);
-        fprintf (fp->fp, "  9\n$DIMTM\n 40\n%f\n", dxf_header.DimTM);
-        fprintf (fp->fp, "  9\n$DIMTXT\n 40\n%f\n", dxf_header.DimTXT);
-        fprintf (fp->fp, "  9\n$DIMCEN\n 40\n%f\n", dxf_header.DimCEN);
-        fprintf (fp->fp, "  9\n$DIMTSZ\n 40\n%f\n", dxf_header.DimTSZ);
-        fprintf (fp->fp, "  9\n$DIMTOL\n 70\n%i\n", dxf_header.DimTOL);
-        fprintf (fp->fp, "  9\n$DIMLIM\n 70\n%i\n", dxf_header.DimLIM);
-        fprintf (fp->fp, "  9\n$DIMTIH\n 70\n%i\n", dxf_header.DimTIH);
-        fprintf (fp->fp, "  9\n$DIMTOH\n 70\n%i\n", dxf_header.DimTOH);
-        fprintf (fp->fp, "  9\n$DIMSE1\n 70\n%i\n", dxf_header.DimSE1);
-        fprintf (fp->fp, "  9\n$DIMSE2\n 70\n%i\n", dxf_header.DimSE2);
-        fprintf (fp->fp, "  9\n$DIMTAD\n 70\n%i\n", dxf_header.DimTAD);
-        fprintf (fp->fp, "  9\n$DIMZIN\n 70\n%i\n", dxf_header.DimZIN);
-        fprintf (fp->fp, "  9\n$DIMBLK\n  1\n%s\n", dxf_header.DimBLK);
-        fprintf (fp->fp, "  9\n$DIMASO\n 70\n%i\n", dxf_header.DimASO);
-        fprintf (fp->fp, "  9\n$DIMSHO\n 70\n%i\n", dxf_header.DimSHO);
-        fprintf (fp->fp, "  9\n$DIMPOST\n  1\n%s\n", dxf_header.DimPOST);
-        fprintf (fp->fp, "  9\n$DIMAPOST\n  1\n%s\n", dxf_header.DimAPOST);
-        fprintf (fp->fp, "  9\n$DIMALT\n 70\n%i\n", dxf_header.DimALT);
-        fprintf (fp->fp, "  9\n$DIMALTD\n 70\n%i\n", dxf_header.DimALTD);
-        fprintf (fp->fp, "  9\n$DIMALTF\n 40\n%f\n", dxf_header.DimALTF);
-        fprintf (fp->fp, "  9\n$DIMLFAC\n 40\n%f\n", dxf_header.DimLFAC);
-        fprintf (fp->fp, "  9\n$DIMTOFL\n 70\n%i\n", dxf_header.DimTOFL);
-        fprintf (fp->fp, "  9\n$DIMTVP\n 40\n%f\n", dxf_header.DimTVP);
-        fprintf (fp->fp, "  9\n$DIMTIX\n 70\n%i\n", dxf_header.DimTIX);
-        fprintf (fp->fp, "  9\n$DIMSOXD\n 70\n%i\n", dxf_header.DimSOXD);
-        fprintf (fp->fp, "  9\n$DIMSAH\n 70\n%i\n", dxf_header.DimSAH);
-        fprintf (fp->fp, "  9\n$DIMBLK1\n  1\n%s\n", dxf_header.DimBLK1);
-        fprintf (fp->fp, "  9\n$DIMBLK2\n  1\n%s\n", dxf_header.DimBLK2);
-        fprintf (fp->fp, "  9\n$DIMSTYLE\n  2\n%s\n", dxf_header.DimSTYLE);
-        fprintf (fp->fp, "  9\n$DIMCLRD\n 70\n%i\n", dxf_header.DimCLRD);
-        fprintf (fp->fp, "  9\n$DIMCLRE\n 70\n%i\n", dxf_header.DimCLRE);
-        fprintf (fp->fp, "  9\n$DIMCLRT\n 70\n%i\n", dxf_header.DimCLRT);
-        fprintf (fp->fp, "  9\n$DIMTFAC\n 40\n%f\n", dxf_header.DimTFAC);
-        fprintf (fp->fp, "  9\n$DIMGAP\n 40\n%f\n", dxf_header.DimGAP);
-        if (fp->acad_version_number >= AC1012) fprintf (fp->fp, "  9\n$DIMJUST\n 70\n%i\n", dxf_header.DimJUST);
-        if (fp->acad_version_number >= AC1012) fprintf (fp->fp, "  9\n$DIMSD1\n 70\n%i\n", dxf_header.DimSD1);
-        if (fp->acad_version_number >= AC1012) fprintf (fp->fp, "  9\n$DIMSD2\n 70\n%i\n", dxf_header.DimSD2);
-        if (fp->acad_version_number >= AC1012) fprintf (fp->fp, "  9\n$DIMTOLJ\n 70\n%i\n", dxf_header.DimTOLJ);
-        if (fp->acad_version_number >= AC1012) fprintf (fp->fp, "  9\n$DIMTZIN\n 70\n%i\n", dxf_header.DimTZIN);
-        if (fp->acad_version_number >= AC1012) fprintf (fp->fp, "  9\n$DIMALTZ\n 70\n%i\n", dxf_header.DimALTZ);
-        if (fp->acad_version_number >= AC1012) fprintf (fp->fp, "  9\n$DIMALTTZ\n 70\n%i\n", dxf_header.DimALTTZ);
-        if ((fp->acad_version_number == AC1012)
-          || (fp->acad_version_number == AC1014)) fprintf (fp->fp, "  9\n$DIMFIT\n 70\n%i\n", dxf_header.DimFIT);
-        if (fp->acad_version_number >= AC1012) fprintf (fp->fp, "  9\n$DIMUPT\n 70\n%i\n", dxf_header.DimUPT);
-        if ((fp->acad_version_number == AC1012) ||
-          (fp->acad_version_number == AC1014)) fprintf (fp->fp, "  9\n$DIMUNIT\n 70\n%i\n", dxf_header.DimUNIT);
-        if (fp->acad_version_number >= AC1012) fprintf (fp->fp, "  9\n$DIMDEC\n 70\n%i\n", dxf_header.DimDEC);
-        if (fp->acad_version_number >= AC1012) fprintf (fp->fp, "  9\n$DIMTDEC\n 70\n%i\n", dxf_header.DimTDEC);
-        if (fp->acad_version_number >= AC1012) fprintf (fp->fp, "  9\n$DIMALTU\n 70\n%i\n", dxf_header.DimALTU);
-        if (fp->acad_version_number >= AC1012) fprintf (fp->fp, "  9\n$DIMALTTD\n 70\n%i\n", dxf_header.DimALTTD);
-        if (fp->acad_version_number >= AC1012) fprintf (fp->fp, "  9\n$DIMTXSTY\n  7\n%s\n", dxf_header.DimTXSTY);
-        if (fp->acad_version_number >= AC1012) fprintf (fp->fp, "  9\n$DIMAUNIT\n 70\n%i\n", dxf_header.DimAUNIT);
-        if (fp->acad_version_number >= AC1015) fprintf (fp->fp, "  9\n$DIMADEC\n 70\n%i\n", dxf_header.DimADEC);
-        if (fp->acad_version_number >= AC1015) fprintf (fp->fp, "  9\n$DIMALTRND\n 40\n%f\n", dxf_header.DimALTRND);
-        if (fp->acad_version_number >= AC1015) fprintf (fp->fp, "  9\n$DIMAZIN\n 70\n%i\n", dxf_header.DimAZIN);
-        if (fp->acad_version_number >= AC1015) fprintf (fp->fp, "  9\n$DIMDSEP\n 70\n%i\n", dxf_header.DimDSEP);
-        if (fp->acad_version_number >= AC1015) fprintf (fp->fp, "  9\n$DIMATFIT\n 70\n%i\n", dxf_header.DimATFIT);
-        if (fp->acad_version_number >= AC1015) fprintf (fp->fp, "  9\n$DIMFRAC\n 70\n%i\n", dxf_header.DimFRAC);
-        if (fp->acad_version_number >= AC1015) fprintf (fp->fp, "  9\n$DIMLDRBLK\n  1\n%s\n", dxf_header.DimLDRBLK);
-        if (fp->acad_version_number >= AC1015) fprintf (fp->fp, "  9\n$DIMLUNIT\n 70\n%i\n", dxf_header.DimLUNIT);
-        if (fp->acad_version_number >= AC1015) fprintf (fp->fp, "  9\n$DIMLWD\n 70\n%i\n", dxf_header.DimLWD);
-        if (fp->acad_version_number >= AC1015) fprintf (fp->fp, "  9\n$DIMLWE\n 70\n%i\n", dxf_header.DimLWE);
-        if (fp->acad_version_number >= AC1015) fprintf (fp->fp, "  9\n$DIMTMOVE\n 70\n%i\n", dxf_header.DimTMOVE);
-        fprintf (fp->fp, "  9\n$LUNITS\n 70\n%i\n", dxf_header.LUnits);
-        fprintf (fp->fp, "  9\n$LUPREC\n 70\n%i\n", dxf_header.LUPrec);
-        fprintf (fp->fp, "  9\n$SKETCHINC\n 40\n%f\n", dxf_header.Sketchinc);
-        fprintf (fp->fp, "  9\n$FILLETRAD\n 40\n%f\n", dxf_header.FilletRad);
-        fprintf (fp->fp, "  9\n$AUNITS\n 70\n%i\n", dxf_header.AUnits);
-        fprintf (fp->fp, "  9\n$AUPREC\n 70\n%i\n", dxf_header.AUPrec);
-        fprintf (fp->fp, "  9\n$MENU\n  1\n%s\n", dxf_header.Menu);
-        fprintf (fp->fp, "  9\n$ELEVATION\n 40\n%f\n", dxf_header.Elevation);
-        fprintf (fp->fp, "  9\n$PELEVATION\n 40\n%f\n", dxf_header.PElevation);
-        fprintf (fp->fp, "  9\n$THICKNESS\n 40\n%f\n", dxf_header.Thickness);
-        fprintf (fp->fp, "  9\n$LIMCHECK\n 70\n%i\n", dxf_header.LimCheck);
-        if (fp->acad_version_number <= AC1014) fprintf (fp->fp, "  9\n$BLIPMODE\n 70\n%i\n", dxf_header.BlipMode);
-        fprintf (fp->fp, "  9\n$CHAMFERA\n 40\n%f\n", dxf_header.ChamferA);
-        fprintf (fp->fp, "  9\n$CHAMFERB\n 40\n%f\n", dxf_header.ChamferB);
-        if (fp->acad_version_number >= AC1012) fprintf (fp->fp, "  9\n$CHAMFERC\n 40\n%f\n", dxf_header.ChamferC);
-        if (fp->acad_version_number >= AC1012) fprintf (fp->fp, "  9\n$CHAMFERD\n 40\n%f\n", dxf_header.ChamferD);
-        fprintf (fp->fp, "  9\n$SKPOLY\n 70\n%i\n", dxf_header.SKPoly);
-        fprintf (fp->fp, "  9\n$TDCREATE\n 40\n%f\n", dxf_header.TDCreate);
-        if (fp->acad_version_number >= AC1015) fprintf (fp->fp, "  9\n$TDUCREATE\n 40\n%f\n", dxf_header.TDUCreate);
-        fprintf (fp->fp, "  9\n$TDUPDATE\n 40\n%f\n", dxf_header.TDUpdate);
-        if (fp->acad_version_number >= AC1015) fprintf (fp->fp, "  9\n$TDUUPDATE\n 40\n%f\n", dxf_header.TDUUpdate);
-        fprintf (fp->fp, "  9\n$TDINDWG\n 40\n%f\n", dxf_header.TDInDWG);
-        fprintf (fp->fp, "  9\n$TDUSRTIMER\n 40\n%f\n", dxf_header.TDUSRTimer);
-        fprintf (fp->fp, "  9\n$USRTIMER\n 70\n%i\n", dxf_header.USRTimer);
-        fprintf (fp->fp, "  9\n$ANGBASE\n 50\n%f\n", dxf_header.AngBase);
-        fprintf (fp->fp, "  9\n$ANGDIR\n 70\n%i\n", dxf_header.AngDir);
-        fprintf (fp->fp, "  9\n$PDMODE\n 70\n%i\n", dxf_header.PDMode);
-        fprintf (fp->fp, "  9\n$PDSIZE\n 40\n%f\n", dxf_header.PDSize);
-        fprintf (fp->fp, "  9\n$PLINEWID\n 40\n%f\n", dxf_header.PLineWid);
-        if (fp->acad_version_number <= AC1014) fprintf (fp->fp, "  9\n$COORDS\n 70\n%i\n", dxf_header.Coords);
-        fprintf (fp->fp, "  9\n$SPLFRAME\n 70\n%i\n", dxf_header.SPLFrame);
-        fprintf (fp->fp, "  9\n$SPLINETYPE\n 70\n%i\n", dxf_header.SPLineType);
-        if (fp->acad_version_number <= AC1014) fprintf (fp->fp, "  9\n$ATTDIA\n 70\n%i\n", dxf_header.AttDia);
-        if (fp->acad_version_number <= AC1014) fprintf (fp->fp, "  9\n$ATTREQ\n 70\n%i\n", dxf_header.AttReq);
-        if (fp->acad_version_number <= AC1014) fprintf (fp->fp, "  9\n$HANDLING\n 70\n%i\n", dxf_header.Handling);
-        fprintf (fp->fp, "  9\n$SPLINESEGS\n 70\n%i\n", dxf_header.SPLineSegs);
-        fprintf (fp->fp, "  9\n$HANDSEED\n  5\n%s\n", dxf_header.HandSeed);
-        fprintf (fp->fp, "  9\n$SURFTAB1\n 70\n%i\n", dxf_header.SurfTab1);
-        fprintf (fp->fp, "  9\n$SURFTAB2\n 70\n%i\n", dxf_header.SurfTab2);
-        fprintf (fp->fp, "  9\n$SURFTYPE\n 70\n%i\n", dxf_header.SurfType);
-        fprintf (fp->fp, "  9\n$SURFU\n 70\n%i\n", dxf_header.SurfU);
-        fprintf (fp->fp, "  9\n$SURFV\n 70\n%i\n", dxf_header.SurfV);
-        if (fp->acad_version_number >= AC1015) fprintf (fp->fp, "  9\n$UCSBASE\n  2\n%s\n", dxf_header.UCSBase);
-        fprintf (fp->fp, "  9\n$UCSNAME\n  2\n%s\n", dxf_header.UCSName);
-        fprintf (fp->fp, "  9\n$UCSORG\n 10\n%f\n 20\n%f\n 30\n%f\n", dxf_header.UCSOrg.x0, dxf_header.UCSOrg.y0, dxf_header.UCSOrg.z0);
-        fprintf (fp->fp, "  9\n$UCSXDIR\n 10\n%f\n 20\n%f\n 30\n%f\n", dxf_header.UCSXDir.x0, dxf_header.UCSXDir.y0, dxf_header.UCSXDir.z0);
-        fprintf (fp->fp, "  9\n$UCSYDIR\n 10\n%f\n 20\n%f\n 30\n%f\n", dxf_header.UCSYDir.x0, dxf_header.UCSYDir.y0, dxf_header.UCSYDir.z0);
-        if (fp->acad_version_number >= AC1015) fprintf (fp->fp, "  9\n$UCSORTHOREF\n  2\n%s\n", dxf_header.UCSOrthoRef);
-        if (fp->acad_version_number >= AC1015) fprintf (fp->fp, "  9\n$UCSORTHOVIEW\n 70\n%i\n", dxf_header.UCSOrthoView);
-        if (fp->acad_version_number >= AC1015) fprintf (fp->fp, "  9\n$UCSORGTOP\n 10\n%f\n 20\n%f\n 30\n%f\n", dxf_header.UCSOrgTop.x0, dxf_header.UCSOrgTop.y0, dxf_header.UCSOrgTop.z0);
-        if (fp->acad_version_number >= AC1015) fprintf (fp->fp, "  9\n$UCSORGBOTTOM\n 10\n%f\n 20\n%f\n 30\n%f\n", dxf_header.UCSOrgBottom.x0, dxf_header.UCSOrgBottom.y0, dxf_header.UCSOrgBottom.z0);
-        if (fp->acad_version_number >= AC1015) fprintf (fp->fp, "  9\n$UCSORGLEFT\n 10\n%f\n 20\n%f\n 30\n%f\n", dxf_header.UCSOrgLeft.x0, dxf_header.UCSOrgLeft.y0, dxf_header.UCSOrgLeft.z0);
-        if (fp->acad_version_number >= AC1015) fprintf (fp->fp, "  9\n$UCSORGRIGHT\n 10\n%f\n 20\n%f\n 30\n%f\n", dxf_header.UCSOrgRight.x0, dxf_header.UCSOrgRight.y0, dxf_header.UCSOrgRight.z0);
-        if (fp->acad_version_number >= AC1015) fprintf (fp->fp, "  9\n$UCSORGFRONT\n 10\n%f\n 20\n%f\n 30\n%f\n", dxf_header.UCSOrgFront.x0, dxf_header.UCSOrgFront.y0, dxf_header.UCSOrgFront.z0);
-        if (fp->acad_version_number >= AC1015) fprintf (fp->fp, "  9\n$UCSORGBACK\n 10\n%f\n 20\n%f\n 30\n%f\n", dxf_header.UCSOrgBack.x0, dxf_header.UCSOrgBack.y0, dxf_header.UCSOrgBack.z0);
-        if (fp->acad_version_number >= AC1015) fprintf (fp->fp, "  9\n$PUCSBASE\n  2\n%s\n", dxf_header.PUCSBase);
-        fprintf (fp->fp, "  9\n$PUCSNAME\n  2\n%s\n", dxf_header.PUCSName);
-        fprintf (fp->fp, "  9\n$PUCSORG\n 10\n%f\n 20\n%f\n 30\n%f\n", dxf_header.PUCSOrg.x0, dxf_header.PUCSOrg.y0, dxf_header.PUCSOrg.z0);
-        fprintf (fp->fp, "  9\n$PUCSXDIR\n 10\n%f\n 20\n%f\n 30\n%f\n", dxf_header.PUCSXDir.x0, dxf_header.PUCSXDir.y0, dxf_header.PUCSXDir.z0);
-        fprintf (fp->fp, "  9\n$PUCSYDIR\n 10\n%f\n 20\n%f\n 30\n%f\n", dxf_header.PUCSYDir.x0, dxf_header.PUCSYDir.y0, dxf_header.PUCSYDir.z0);
-        if (fp->acad_version_number >= AC1015) fprintf (fp->fp, "  9\n$PUCSORTHOREF\n  2\n%s\n", dxf_header.PUCSOrthoRef);
-        if (fp->acad_version_number >= AC1015) fprintf (fp->fp, "  9\n$PUCSORTHOVIEW\n 70\n%i\n", dxf_header.PUCSOrthoView);
-        if (fp->acad_version_number >= AC1015) fprintf (fp->fp, "  9\n$PUCSORGTOP\n 10\n%f\n 20\n%f\n 30\n%f\n", dxf_header.PUCSOrgTop.x0, dxf_header.PUCSOrgTop.y0, dxf_header.PUCSOrgTop.z0);
-        if (fp->acad_version_number >= AC1015) fprintf (fp->fp, "  9\n$PUCSORGBOTTOM\n 10\n%f\n 20\n%f\n 30\n%f\n", dxf_header.PUCSOrgBottom.x0, dxf_header.PUCSOrgBottom.y0, dxf_header.PUCSOrgBottom.z0);
-        if (fp->acad_version_number >= AC1015) fprintf (fp->fp, "  9\n$PUCSORGLEFT\n 10\n%f\n 20\n%f\n 30\n%f\n", dxf_header.PUCSOrgLeft.x0, dxf_header.PUCSOrgLeft.y0, dxf_header.PUCSOrgLeft.z0);
-        if (fp->acad_version_number >= AC1015) fprintf (fp->fp, "  9\n$PUCSORGRIGHT\n 10\n%f\n 20\n%f\n 30\n%f\n", dxf_header.PUCSOrgRight.x0, dxf_header.PUCSOrgRight.y0, dxf_header.PUCSOrgRight.z0);
-        if (fp->acad_version_number >= AC1015) fprintf (fp->fp, "  9\n$PUCSORGFRONT\n 10\n%f\n 20\n%f\n 30\n%f\n", dxf_header.PUCSOrgFront.x0, dxf_header.PUCSOrgFront.y0, dxf_header.PUCSOrgFront.z0);
-        if (fp->acad_version_number >= AC1015) fprintf (fp->fp, "  9\n$PUCSORGBACK\n 10\n%f\n 20\n%f\n 30\n%f\n", dxf_header.PUCSOrgBack.x0, dxf_header.PUCSOrgBack.y0, dxf_header.PUCSOrgBack.z0);
-        fprintf (fp->fp, "  9\n$USERI1\n 70\n%i\n", dxf_header.UserI1);
-        fprintf (fp->fp, "  9\n$USERI2\n 70\n%i\n", dxf_header.UserI2);
-        fprintf (fp->fp, "  9\n$USERI3\n 70\n%i\n", dxf_header.UserI3);
-        fprintf (fp->fp, "  9\n$USERI4\n 70\n%i\n", dxf_header.UserI4);
-        fprintf (fp->fp, "  9\n$USERI5\n 70\n%i\n", dxf_header.UserI5);
-        fprintf (fp->fp, "  9\n$USERR1\n 40\n%f\n", dxf_header.UserR1);
-        fprintf (fp->fp, "  9\n$USERR2\n 40\n%f\n", dxf_header.UserR2);
-        fprintf (fp->fp, "  9\n$USERR3\n 40\n%f\n", dxf_header.UserR3);
-        fprintf (fp->fp, "  9\n$USERR4\n 40\n%f\n", dxf_header.UserR4);
-        fprintf (fp->fp, "  9\n$USERR5\n 40\n%f\n", dxf_header.UserR5);
-        fprintf (fp->fp, "  9\n$WORLDVIEW\n 70\n%i\n", dxf_header.WorldView);
-        fprintf (fp->fp, "  9\n$SHADEDGE\n 70\n%i\n", dxf_header.ShadEdge);
-        fprintf (fp->fp, "  9\n$SHADEDIF\n 70\n%i\n", dxf_header.ShadeDif);
-        fprintf (fp->fp, "  9\n$TILEMODE\n 70\n%i\n", dxf_header.TileMode);
-        fprintf (fp->fp, "  9\n$MAXACTVP\n 70\n%i\n", dxf_header.MaxActVP);
-        fprintf (fp->fp, "  9\n$PINSBASE\n 10\n%f\n 20\n%f\n 30\n%f\n", dxf_header.PInsBase.x0, dxf_header.PInsBase.y0, dxf_header.PInsBase.z0);
-        fprintf (fp->fp, "  9\n$PLIMCHECK\n 70\n%i\n", dxf_header.PLimCheck);
-        fprintf (fp->fp, "  9\n$PEXTMIN\n 10\n%f\n 20\n%f\n 30\n%f\n", dxf_header.PExtMin.x0, dxf_header.PExtMin.y0, dxf_header.PExtMin.z0);
-        fprintf (fp->fp, "  9\n$PEXTMAX\n 10\n%f\n 20\n%f\n 30\n%f\n", dxf_header.PExtMax.x0, dxf_header.PExtMax.y0, dxf_header.PExtMax.z0);
-        fprintf (fp->fp, "  9\n$PLIMMIN\n 10\n%f\n 20\n%f\n", dxf_header.PLimMin.x0, dxf_header.PLimMin.y0);
-        fprintf (fp->fp, "  9\n$PLIMMAX\n 10\n%f\n 20\n%f\n", dxf_header.PLimMax.x0, dxf_header.PLimMax.y0);
-        fprintf (fp->fp, "  9\n$UNITMODE\n 70\n%i\n", dxf_header.UnitMode);
-        fprintf (fp->fp, "  9\n$VISRETAIN\n 70\n%i\n", dxf_header.VisRetain);
-        fprintf (fp->fp, "  9\n$PLINEGEN\n 70\n%i\n", dxf_header.PLineGen);
-        fprintf (fp->fp, "  9\n$PSLTSCALE\n 70\n%i\n", dxf_header.PSLTScale);
-        if (fp->acad_version_number >= AC1012) fprintf (fp->fp, "  9\n$TREEDEPTH\n 70\n%i\n", dxf_header.TreeDepth);
-        if ((fp->acad_version_number == AC1012)
-          || (fp->acad_version_number == AC1014)) fprintf (fp->fp, "  9\n$PICKSTYLE\n 70\n%i\n", dxf_header.PickStyle);
-        if (fp->acad_version_number >= AC1012) fprintf (fp->fp, "  9\n$CMLSTYLE\n  2\n%s\n", dxf_header.CMLStyle);
-        if (fp->acad_version_number >= AC1012) fprintf (fp->fp, "  9\n$CMLJUST\n 70\n%i\n", dxf_header.CMLJust);
-        if (fp->acad_version_number >= AC1012) fprintf (fp->fp, "  9\n$CMLSCALE\n 40\n%f\n", dxf_header.CMLScale);
-        if (fp->acad_version_number >= AC1014) fprintf (fp->fp, "  9\n$PROXYGRAPHICS\n 70\n%i\n", dxf_header.ProxyGraphics);
-        if (fp->acad_version_number >= AC1014) fprintf (fp->fp, "  9\n$MEASUREMENT\n 70\n%i\n", dxf_header.Measurement);
-        if (fp->acad_version_number == AC1012) fprintf (fp->fp, "  9\n$SAVEIMAGES\n 70\n%i\n", dxf_header.SaveImages);
-        if (fp->acad_version_number >= AC1015) fprintf (fp->fp, "  9\n$CELWEIGHT\n370\n%i\n", dxf_header.CELWeight);
-        if (fp->acad_version_number >= AC1015) fprintf (fp->fp, "  9\n$ENDCAPS\n280\n%i\n", dxf_header.EndCaps);
-        if (fp->acad_version_number >= AC1015) fprintf (fp->fp, "  9\n$JOINSTYLE\n280\n%i\n", dxf_header.JoinStyle);
-        if (fp->acad_version_number >= AC1015) fprintf (fp->fp, "  9\n$LWDISPLAY\n290\n%i\n", dxf_header.LWDisplay);
-        if (fp->acad_version_number >= AC1015) fprintf (fp->fp, "  9\n$INSUNITS\n 70\n%i\n", dxf_header.InsUnits);
-        if (fp->acad_version_number >= AC1015) fprintf (fp->fp, "  9\n$HYPERLINKBASE\n  1\n%s\n", dxf_header.HyperLinkBase);
-        if (fp->acad_version_number >= AC1015) fprintf (fp->fp, "  9\n$STYLESHEET\n  1\n%s\n", dxf_header.StyleSheet);
-        if (fp->acad_version_number >= AC1015) fprintf (fp->fp, "  9\n$XEDIT\n290\n%i\n", dxf_header.XEdit);
-        if (fp->acad_version_number >= AC1015) fprintf (fp->fp, "  9\n$CEPSNTYPE\n380\n%i\n", dxf_header.CEPSNType);
-        if (fp->acad_version_number >= AC1015) fprintf (fp->fp, "  9\n$PSTYLEMODE\n290\n%i\n", dxf_header.PStyleMode);
-        if (fp->acad_version_number >= AC1015) fprintf (fp->fp, "  9\n$FINGERPRINTGUID\n  2\n%s\n", dxf_header.FingerPrintGUID);
-        if (fp->acad_version_number >= AC1015) fprintf (fp->fp, "  9\n$VERSIONGUID\n  2\n%s\n", dxf_header.VersionGUID);
-        if (fp->acad_version_number >= AC1015) fprintf (fp->fp, "  9\n$EXTNAMES\n290\n%i\n", dxf_header.ExtNames);
-        if (fp->acad_version_number >= AC1015) fprintf (fp->fp, "  9\n$PSVPSCALE\n 40\n%f\n", dxf_header.PSVPScale);
-        if (fp->acad_version_number >= AC1015) fprintf (fp->fp, "  9\n$OLESTARTUP\n290\n%i\n", dxf_header.OLEStartUp);
-        if (fp->acad_version_number >= AC1018) fprintf (fp->fp, "  9\n$SORTENTS\n280\n%i\n", dxf_header.SortEnts);
-        if (fp->acad_version_number >= AC1018) fprintf (fp->fp, "  9\n$INDEXCTL\n280\n%i\n", dxf_header.IndexCtl);
-        if (fp->acad_version_number >= AC1018) fprintf (fp->fp, "  9\n$HIDETEXT\n280\n%i\n", dxf_header.HideText);
-        if (fp->acad_version_number >= AC1018) fprintf (fp->fp, "  9\n$XCLIPFRAME\n290\n%i\n", dxf_header.XClipFrame);
-        if (fp->acad_version_number >= AC1018) fprintf (fp->fp, "  9\n$HALOGAP\n280\n%i\n", dxf_header.HaloGap);
-        if (fp->acad_version_number >= AC1018) fprintf (fp->fp, "  9\n$OBSCOLOR\n 70\n%i\n", dxf_header.ObsColor);
-        if (fp->acad_version_number >= AC1018) fprintf (fp->fp, "  9\n$OBSLTYPE\n280\n%i\n", dxf_header.ObsLType);
-        if (fp->acad_version_number >= AC1018) fprintf (fp->fp, "  9\n$INTERSECTIONDISPLAY\n280\n%i\n", dxf_header.InterSectionDisplay);
-        if (fp->acad_version_number >= AC1018) fprintf (fp->fp, "  9\n$INTERSECTIONCOLOR\n 70\n%i\n", dxf_header.InterSectionColor);
-        if (fp->acad_version_number >= AC1018) fprintf (fp->fp, "  9\n$DIMASSOC\n280\n%i\n", dxf_header.DimASSOC);
-        if (fp->acad_version_number >= AC1018) fprintf (fp->fp, "  9\n$PROJECTNAME\n  1\n%s\n", dxf_header.ProjectName);
-        dxf_endsec_write (fp);
+        /* Do some basic checks. */
+        if (fp == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL file pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        dxf_header_write_select (fp->acad_version_number);
+        size = 8192;
+        buffer = malloc (size);
+        if (buffer == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        used = (size_t) sprintf (buffer, "  0\nSECTION\n  2\nHEADER\n");
+        base = (const char *) &dxf_header;
+        for (i = 0; i < dxf_header_write_list_length; i++)
+        {
+                spec = dxf_header_write_list[i];
+                needed = strlen (spec->format);
+                if (spec->type == DXF_HEADER_VAR_STRING)
+                {
+                        string = *((char * const *) (base + spec->offset[0]));
+                        needed += (string != NULL) ? strlen (string) : sizeof ("(null)");
+                }
+                else
+                {
+                        needed += (size_t) (32 * spec->quant);
+                }
+                if (used + needed + sizeof ("  0\nENDSEC\n") > size)
+                {
+                        while (used + needed + sizeof ("  0\nENDSEC\n") > size)
+                        {
+                                size *= 2;
+                        }
+                        grown = realloc (buffer, size);
+                        if (grown == NULL)
+                        {
+                                fprintf (stderr,
+                                  (_("Error in %s () could not allocate memory.\n")),
+                                  __FUNCTION__);
+                                free (buffer);
+                                return (EXIT_FAILURE);
+                        }
+                        buffer = grown;
+                }
+                switch (spec->type)
+                {
+                        case DXF_HEADER_VAR_INT:
+                                used += (size_t) sprintf (buffer + used, spec->format,
+                                  *((const int *) (base + spec->offset[0])));
+                                break;
+                        case DXF_HEADER_VAR_STRING:
+                                used += (size_t) sprintf (buffer + used, spec->format,
+                                  *((char * const *) (base + spec->offset[0])));
+                                break;
+                        case DXF_HEADER_VAR_DOUBLE:
+                                switch (spec->quant)
+                                {
+                                        case 1:
+                                                used += (size_t) sprintf (buffer + used, spec->format,
+                                                  *((const double *) (base + spec->offset[0])));
+                                                break;
+                                        case 2:
+                                                used += (size_t) sprintf (buffer + used, spec->format,
+                                                  *((const double *) (base + spec->offset[0])),
+                                                  *((const double *) (base + spec->offset[1])));
+                                                break;
+                                        default:
+                                                used += (size_t) sprintf (buffer + used, spec->format,
+                                                  *((const double *) (base + spec->offset[0])),
+                                                  *((const double *) (base + spec->offset[1])),
+                                                  *((const double *) (base + spec->offset[2])));
+                                                break;
+                                }
+                                break;
+                }
+        }
+        used += (size_t) sprintf (buffer + used, "  0\nENDSEC\n");
+        if (fwrite (buffer, 1, used, fp->fp) != used)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not write to: %s.\n")),
+                  __FUNCTION__, fp->filename);
+                free (buffer);
+                return (EXIT_FAILURE);
+        }
+        free (buffer);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -1093,95 +1859,219 @@ dxf_read_header_parse_string
         return ret;
 }
 
-static int
-dxf_read_header_parse_int
+/*!
+ * \brief One entry of the header variable table: where a variable
+ * lives in a \c DxfHeader and for which versions it is valid.
+ */
+typedef struct
+dxf_header_var_spec
+{
+        const char *name;
+                /*!< the variable name, including the leading '$'. */
+        int type;
+                /*!< the value type, from \c dxf_header_var_type. */
+        int quant;
+                /*!< number of components (2 or 3 for point types). */
+        size_t offset[3];
+                /*!< offsets of the components within \c DxfHeader. */
+        int min_version;
+                /*!< lowest AutoCAD version carrying the variable. */
+        int max_version;
+                /*!< highest AutoCAD version carrying the variable. */
+} DxfHeaderVarSpec;
+
+
+/*!
+ * The header variable table; order is irrelevant, lookups go through
+ * the hash index below.
+ */
+static const DxfHeaderVarSpec dxf_header_var_table[] =
+{
+        {"$ACADMAINTVER", DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, AcadMaintVer)}, 1015, 9999},
+        {"$DWGCODEPAGE", DXF_HEADER_VAR_STRING, 1,
+                {offsetof (DxfHeader, DWGCodePage)}, 1012, 9999},
+        {"$INSBASE", DXF_HEADER_VAR_DOUBLE, 3,
+                {offsetof (DxfHeader, InsBase.x0), offsetof (DxfHeader, InsBase.y0), offsetof (DxfHeader, InsBase.z0)}, 0, 9999},
+        {"$EXTMIN", DXF_HEADER_VAR_DOUBLE, 3,
+                {offsetof (DxfHeader, ExtMin.x0), offsetof (DxfHeader, ExtMin.y0), offsetof (DxfHeader, ExtMin.z0)}, 0, 9999},
+        {"$EXTMAX", DXF_HEADER_VAR_DOUBLE, 3,
+                {offsetof (DxfHeader, ExtMax.x0), offsetof (DxfHeader, ExtMax.y0), offsetof (DxfHeader, ExtMax.z0)}, 0, 9999},
+        {"$LIMMIN", DXF_HEADER_VAR_DOUBLE, 2,
+                {offsetof (DxfHeader, LimMin.x0), offsetof (DxfHeader, LimMin.y0)}, 0, 9999},
+        {"$LIMMAX", DXF_HEADER_VAR_DOUBLE, 2,
+                {offsetof (DxfHeader, LimMax.x0), offsetof (DxfHeader, LimMax.y0)}, 0, 9999},
+        {"$ORTHOMODE", DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, OrthoMode)}, 0, 9999},
+        {"$REGENMODE", DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, RegenMode)}, 0, 9999},
+        {"$FILLMODE", DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, FillMode)}, 0, 9999},
+        {"$QTEXTMODE", DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, QTextMode)}, 0, 9999},
+        {"$MIRRTEXT", DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, MirrText)}, 0, 9999},
+        {"$DRAGMODE", DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DragMode)}, 0, 1014},
+        {"$LTSCALE", DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, LTScale)}, 0, 9999},
+        {"$OSMODE", DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, OSMode)}, 0, 1014},
+        {"$ATTMODE", DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, AttMode)}, 0, 9999},
+        {"$TEXTSIZE", DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, TextSize)}, 0, 9999},
+        {"$TRACEWID", DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, TraceWid)}, 0, 9999},
+        {"$TEXTSTYLE", DXF_HEADER_VAR_STRING, 1,
+                {offsetof (DxfHeader, TextStyle)}, 0, 9999},
+        {"$CLAYER", DXF_HEADER_VAR_STRING, 1,
+                {offsetof (DxfHeader, CLayer)}, 0, 9999},
+        {"$CELTYPE", DXF_HEADER_VAR_STRING, 1,
+                {offsetof (DxfHeader, CELType)}, 0, 9999},
+        {"$CECOLOR", DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, CEColor)}, 0, 9999},
+        {"$CELTSCALE", DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, CELTScale)}, 1012, 9999},
+        {"$DELOBJ", DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DelObj)}, 1012, 1014},
+        {"$DISPSILH", DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DispSilH)}, 0, 1015},
+        {"$DIMSCALE", DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, DimSCALE)}, 0, 9999},
+        {"$DIMASZ", DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, DimASZ)}, 0, 9999},
+        {"$DIMEXO", DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, DimEXO)}, 0, 9999},
+        {"$DIMEXE", DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, DimEXE)}, 0, 9999},
+        {"$DIMTXT", DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, DimTXT)}, 0, 9999},
+        {"$DIMSTYLE", DXF_HEADER_VAR_STRING, 1,
+                {offsetof (DxfHeader, DimSTYLE)}, 0, 9999},
+        {"$DIMGAP", DXF_HEADER_VAR_DOUBLE, 1,
+                {offsetof (DxfHeader, DimGAP)}, 0, 9999},
+        {"$DIMAUNIT", DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DimAUNIT)}, 1012, 9999},
+        {"$DIMADEC", DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DimADEC)}, 1015, 9999},
+        {"$DIMLUNIT", DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, DimLUNIT)}, 1015, 9999},
+        {"$LUNITS", DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, LUnits)}, 0, 9999},
+        {"$LUPREC", DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, LUPrec)}, 0, 9999},
+        {"$AUNITS", DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, AUnits)}, 0, 9999},
+        {"$AUPREC", DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, AUPrec)}, 0, 9999},
+        {"$SPLINESEGS", DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, SPLineSegs)}, 0, 9999},
+        {"$HANDSEED", DXF_HEADER_VAR_STRING, 1,
+                {offsetof (DxfHeader, HandSeed)}, 0, 9999},
+        {"$PLIMMIN", DXF_HEADER_VAR_DOUBLE, 2,
+                {offsetof (DxfHeader, PLimMin.x0), offsetof (DxfHeader, PLimMin.y0)}, 0, 9999},
+        {"$PLIMMAX", DXF_HEADER_VAR_DOUBLE, 2,
+                {offsetof (DxfHeader, PLimMax.x0), offsetof (DxfHeader, PLimMax.y0)}, 0, 9999},
+        {"$INSUNITS", DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, InsUnits)}, 1015, 9999},
+        {"$GRIDUNIT", DXF_HEADER_VAR_DOUBLE, 2,
+                {offsetof (DxfHeader, GridUnit.x0), offsetof (DxfHeader, GridUnit.y0)}, 1009, 9999},
+        {"$GRIDMODE", DXF_HEADER_VAR_INT, 1,
+                {offsetof (DxfHeader, GridMode)}, 1009, 9999},
+};
+
+#define DXF_HEADER_VAR_TABLE_LENGTH \
+        (sizeof (dxf_header_var_table) / sizeof (dxf_header_var_table[0]))
+
+/*!
+ * The collision free hash index over \c dxf_header_var_table; sized
+ * four times the entry count so the FNV-1a hash probes at most a few
+ * slots.  Built once on first use.
+ */
+#define DXF_HEADER_VAR_HASH_SIZE 256
+
+static short dxf_header_var_hash_index[DXF_HEADER_VAR_HASH_SIZE];
+static int dxf_header_var_hash_ready = 0;
+
+
+/*!
+ * \brief Hash a header variable name (FNV-1a).
+ */
+static unsigned int
+dxf_header_var_hash
 (
-        DxfFile *fp,
-                /*!< DXF file handle of input file (or device). */
-        const char *temp_string,
-        const char *header_var,
-        int *value,
-        int version_expression
+        const char *name
+                /*!< the variable name, including the leading '$'. */
 )
 {
-#if DEBUG
-        DXF_DEBUG_BEGIN
-#endif
-        int f, tvar, n, ret = SUCCESS;
-        /* test for header_var and version number. -3 makes it version agnostic */
-        if (strcmp (temp_string, header_var) == 0  && version_expression)
+        unsigned int hash;
+        const unsigned char *c;
+
+        hash = 2166136261u;
+        for (c = (const unsigned char *) name; *c != '\0'; c++)
         {
-                f = dxf_read_scanf (fp, "%i\n%i\n", &n, &tvar);
-                if (f > 0 && dxf_read_is_int(n))
-                {
-                        *value = tvar;
-                        ret = FOUND;                                
-                }
-                else
-                        ret = FAIL;
+                hash = (hash ^ *c) * 16777619u;
         }
-        else
-                ret = SUCCESS;
-
-#if DEBUG
-        DXF_DEBUG_END
-#endif
-        return ret;
+        return (hash & (DXF_HEADER_VAR_HASH_SIZE - 1));
 }
 
-static int
-dxf_read_header_parse_n_double
+
+/*!
+ * \brief Look up a header variable by name in O(1).
+ *
+ * \return a pointer to the table entry, or \c NULL for an unknown
+ * variable.
+ */
+static const DxfHeaderVarSpec *
+dxf_header_var_find
 (
-        DxfFile *fp,
-                /*!< DXF file handle of input file (or device). */
-        const char *temp_string,
-        const char *header_var,
-        int version_expression,
-        int quant,
-        ...
+        const char *name
+                /*!< the variable name, including the leading '$'. */
 )
 {
-#if DEBUG
-        DXF_DEBUG_BEGIN
-#endif
-        int f, n, i, ret = SUCCESS;
-        double *dvar;
-        double tvar;
-        va_list dlist;
+        unsigned int slot;
+        size_t i;
 
-        /* test for header_var and version number. -3 makes it version agnostic */
-        if (strcmp (temp_string, header_var) == 0  && version_expression)
+        if (!dxf_header_var_hash_ready)
         {
-                ret = FOUND;
-                va_start (dlist, quant);
-                for (i = 1; i <= quant; i++)
+                /* Linear probing; the table is static so the build is
+                 * done exactly once. */
+                for (slot = 0; slot < DXF_HEADER_VAR_HASH_SIZE; slot++)
                 {
-                        dvar = va_arg(dlist, double *);
-                        /* prepare the string to read all vars */
-                        f = dxf_read_scanf (fp, "%d\n%'lf\n", &n, &tvar);
-                        if (f > 0 && dxf_read_is_double (n))
-                        {
-                                *dvar = tvar;
-                        }
-                        else
+                        dxf_header_var_hash_index[slot] = -1;
+                }
+                for (i = 0; i < DXF_HEADER_VAR_TABLE_LENGTH; i++)
+                {
+                        slot = dxf_header_var_hash (dxf_header_var_table[i].name);
+                        while (dxf_header_var_hash_index[slot] != -1)
                         {
-                                ret = FALSE;
-                                break;
+                                slot = (slot + 1) & (DXF_HEADER_VAR_HASH_SIZE - 1);
                         }
+                        dxf_header_var_hash_index[slot] = i;
                 }
-                va_end(dlist);
+                dxf_header_var_hash_ready = 1;
         }
-        else
-                ret = SUCCESS;
-
-#if DEBUG
-        DXF_DEBUG_END
-#endif
-        return ret;
+        slot = dxf_header_var_hash (name);
+        while (dxf_header_var_hash_index[slot] != -1)
+        {
+                i = dxf_header_var_hash_index[slot];
+                if (strcmp (dxf_header_var_table[i].name, name) == 0)
+                {
+                        return (&dxf_header_var_table[i]);
+                }
+                slot = (slot + 1) & (DXF_HEADER_VAR_HASH_SIZE - 1);
+        }
+        return (NULL);
 }
 
+
 /*!
  * \brief Parses the header from a DXF file, with no particulary order.
+ *
+ * One generic loop driven by the header variable table replaces the
+ * former ladder of 46 sequential strcmp calls, so each variable costs
+ * one hash lookup instead of scanning every name before it.
  */
 static int
 dxf_read_header_parser
@@ -1197,465 +2087,62 @@ dxf_read_header_parser
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        int ret;
-        /*!
-        * \todo: add some kind of control to what we have already read
-        * and check if we read all header data.
-        */
-        ret = dxf_read_header_parse_int (fp, temp_string, "$ACADMAINTVER",
-                                         &dxf_header.AcadMaintVer,
-                                         acad_version_number > AC1014);
-        dxf_return(ret);
-                
-        ret = dxf_read_header_parse_string (fp, temp_string, "$DWGCODEPAGE",
-                                            &dxf_header.DWGCodePage,
-                                            acad_version_number >= AC1012);
-        dxf_return(ret);
-        
-        ret = dxf_read_header_parse_n_double (fp, temp_string, "$INSBASE",
-                                              TRUE,
-                                              3,
-                                              &dxf_header.InsBase.x0,
-                                              &dxf_header.InsBase.y0,
-                                              &dxf_header.InsBase.z0);
-        dxf_return(ret);
-
-        ret = dxf_read_header_parse_n_double (fp, temp_string, "$EXTMIN",
-                                              TRUE,
-                                              3,
-                                              &dxf_header.ExtMin.x0,
-                                              &dxf_header.ExtMin.y0,
-                                              &dxf_header.ExtMin.z0);
-        dxf_return(ret);
-
-        ret = dxf_read_header_parse_n_double (fp, temp_string, "$EXTMAX",
-                                              TRUE,
-                                              3,
-                                              &dxf_header.ExtMax.x0,
-                                              &dxf_header.ExtMax.y0,
-                                              &dxf_header.ExtMax.z0);
-        dxf_return(ret);
-
-        ret = dxf_read_header_parse_n_double (fp, temp_string, "$LIMMIN",
-                                              TRUE,
-                                              2,
-                                              &dxf_header.LimMin.x0,
-                                              &dxf_header.LimMin.y0);
-        dxf_return(ret);
-
-        ret = dxf_read_header_parse_n_double (fp, temp_string, "$LIMMAX",
-                                              TRUE,
-                                              2,
-                                              &dxf_header.LimMax.x0,
-                                              &dxf_header.LimMax.y0);
-        dxf_return(ret);
-
-        ret = dxf_read_header_parse_int (fp, temp_string, "$ORTHOMODE",
-                                         &dxf_header.OrthoMode,
-                                         TRUE);
-        dxf_return(ret);
-
-        ret = dxf_read_header_parse_int (fp, temp_string, "$REGENMODE",
-                                         &dxf_header.RegenMode,
-                                         TRUE);
-        dxf_return(ret);
-
-        ret = dxf_read_header_parse_int (fp, temp_string, "$FILLMODE",
-                                         &dxf_header.FillMode,
-                                         TRUE);
-        dxf_return(ret);
-
-        ret = dxf_read_header_parse_int (fp, temp_string, "$QTEXTMODE",
-                                         &dxf_header.QTextMode,
-                                         TRUE);
-        dxf_return(ret);
-
-        ret = dxf_read_header_parse_int (fp, temp_string, "$MIRRTEXT",
-                                         &dxf_header.MirrText,
-                                         TRUE);
-        dxf_return(ret);
-
-        ret = dxf_read_header_parse_int (fp, temp_string, "$DRAGMODE",
-                                         &dxf_header.MirrText,
-                                         acad_version_number < AC1015);
-        dxf_return(ret);
-
-        ret = dxf_read_header_parse_n_double (fp, temp_string, "$LTSCALE",
-                                              TRUE,
-                                              1,
-                                              &dxf_header.LTScale);
-        dxf_return(ret);
-
-        ret = dxf_read_header_parse_int (fp, temp_string, "$OSMODE",
-                                         &dxf_header.OSMode,
-                                         acad_version_number <= AC1014);
-        dxf_return(ret);
-
-        ret = dxf_read_header_parse_int (fp, temp_string, "$ATTMODE",
-                                         &dxf_header.AttMode,
-                                         TRUE);
-        dxf_return(ret);
-    
-        ret = dxf_read_header_parse_n_double (fp, temp_string, "$TEXTSIZE",
-                                              TRUE,
-                                              1,
-                                              &dxf_header.TextSize);
-        dxf_return(ret);
-
-        ret = dxf_read_header_parse_n_double (fp, temp_string, "$TRACEWID",
-                                              TRUE,
-                                              1,
-                                              &dxf_header.TraceWid);
-        dxf_return(ret);
-
-        ret = dxf_read_header_parse_string (fp, temp_string, "$TEXTSTYLE",
-                                            &dxf_header.TextStyle,
-                                            TRUE);
-        dxf_return(ret);
-
-        ret = dxf_read_header_parse_string (fp, temp_string, "$CLAYER",
-                                            &dxf_header.CLayer,
-                                            TRUE);
-        dxf_return(ret);
-
-        ret = dxf_read_header_parse_string (fp, temp_string, "$CELTYPE",
-                                            &dxf_header.CELType,
-                                            TRUE);
-        dxf_return(ret);
-
-        ret = dxf_read_header_parse_int (fp, temp_string, "$CECOLOR",
-                                         &dxf_header.CEColor,
-                                         TRUE);
-        dxf_return(ret);
-
-        ret = dxf_read_header_parse_n_double (fp, temp_string, "$CELTSCALE",
-                                              acad_version_number >= AC1012,
-                                              1,
-                                              &dxf_header.CELTScale);
-        dxf_return(ret);
-
-        ret = dxf_read_header_parse_int (fp, temp_string, "$DELOBJ",
-                                         &dxf_header.DelObj,
-                                         (acad_version_number == AC1012)
-                                         || (acad_version_number == AC1014));
-        dxf_return(ret);
-
-        /*! \todo FIXME: changed from AC1012 to AC1015 */
-        ret = dxf_read_header_parse_int (fp, temp_string, "$DISPSILH",
-                                         &dxf_header.DispSilH,
-                                         acad_version_number <= AC1015);
-        dxf_return(ret);
-
-        ret = dxf_read_header_parse_n_double (fp, temp_string, "$DIMSCALE",
-                                              TRUE,
-                                              1,
-                                              &dxf_header.DimSCALE);
-        dxf_return(ret);
-
-        ret = dxf_read_header_parse_n_double (fp, temp_string, "$DIMASZ",
-                                              TRUE,
-                                              1,
-                                              &dxf_header.DimASZ);
-        dxf_return(ret);
-
-        ret = dxf_read_header_parse_n_double (fp, temp_string, "$DIMEXO",
-                                              TRUE,
-                                              1,
-                                              &dxf_header.DimEXO);
-        dxf_return(ret);
-
-        /*
-        fprintf (fp, "  9\n$DIMDLI\n 40\n%f\n", dxf_header.DimDLI);
-        fprintf (fp, "  9\n$DIMRND\n 40\n%f\n", dxf_header.DimRND);
-        fprintf (fp, "  9\n$DIMDLE\n 40\n%f\n", dxf_header.DimDLE);
-        */
-        ret = dxf_read_header_parse_n_double (fp, temp_string, "$DIMEXE",
-                                              TRUE,
-                                              1,
-                                              &dxf_header.DimEXE);
-        dxf_return(ret);
-        /*
-        fprintf (fp, "  9\n$DIMTP\n 40\n%f\n", dxf_header.DimTP);
-        fprintf (fp, "  9\n$DIMTM\n 40\n%f\n", dxf_header.DimTM);
-        */
-        ret = dxf_read_header_parse_n_double (fp, temp_string, "$DIMTXT",
-                                              TRUE,
-                                              1,
-                                              &dxf_header.DimTXT);
-        dxf_return(ret);
-        /*
-        fprintf (fp, "  9\n$DIMCEN\n 40\n%f\n", dxf_header.DimCEN);
-        fprintf (fp, "  9\n$DIMTSZ\n 40\n%f\n", dxf_header.DimTSZ);
-        fprintf (fp, "  9\n$DIMTOL\n 70\n%i\n", dxf_header.DimTOL);
-        fprintf (fp, "  9\n$DIMLIM\n 70\n%i\n", dxf_header.DimLIM);
-        fprintf (fp, "  9\n$DIMTIH\n 70\n%i\n", dxf_header.DimTIH);
-        fprintf (fp, "  9\n$DIMTOH\n 70\n%i\n", dxf_header.DimTOH);
-        fprintf (fp, "  9\n$DIMSE1\n 70\n%i\n", dxf_header.DimSE1);
-        fprintf (fp, "  9\n$DIMSE2\n 70\n%i\n", dxf_header.DimSE2);
-        fprintf (fp, "  9\n$DIMTAD\n 70\n%i\n", dxf_header.DimTAD);
-        fprintf (fp, "  9\n$DIMZIN\n 70\n%i\n", dxf_header.DimZIN);
-        fprintf (fp, "  9\n$DIMBLK\n  1\n%s\n", dxf_header.DimBLK);
-        fprintf (fp, "  9\n$DIMASO\n 70\n%i\n", dxf_header.DimASO);
-        fprintf (fp, "  9\n$DIMSHO\n 70\n%i\n", dxf_header.DimSHO);
-        fprintf (fp, "  9\n$DIMPOST\n  1\n%s\n", dxf_header.DimPOST);
-        fprintf (fp, "  9\n$DIMAPOST\n  1\n%s\n", dxf_header.DimAPOST);
-        fprintf (fp, "  9\n$DIMALT\n 70\n%i\n", dxf_header.DimALT);
-        fprintf (fp, "  9\n$DIMALTD\n 70\n%i\n", dxf_header.DimALTD);
-        fprintf (fp, "  9\n$DIMALTF\n 40\n%f\n", dxf_header.DimALTF);
-        fprintf (fp, "  9\n$DIMLFAC\n 40\n%f\n", dxf_header.DimLFAC);
-        fprintf (fp, "  9\n$DIMTOFL\n 70\n%i\n", dxf_header.DimTOFL);
-        fprintf (fp, "  9\n$DIMTVP\n 40\n%f\n", dxf_header.DimTVP);
-        fprintf (fp, "  9\n$DIMTIX\n 70\n%i\n", dxf_header.DimTIX);
-        fprintf (fp, "  9\n$DIMSOXD\n 70\n%i\n", dxf_header.DimSOXD);
-        fprintf (fp, "  9\n$DIMSAH\n 70\n%i\n", dxf_header.DimSAH);
-        fprintf (fp, "  9\n$DIMBLK1\n  1\n%s\n", dxf_header.DimBLK1);
-        fprintf (fp, "  9\n$DIMBLK2\n  1\n%s\n", dxf_header.DimBLK2);
-        */
-        ret = dxf_read_header_parse_string (fp, temp_string, "$DIMSTYLE",
-                                            &dxf_header.DimSTYLE,
-                                            TRUE);
-        dxf_return(ret);
-        /*
-        fprintf (fp, "  9\n$DIMCLRD\n 70\n%i\n", dxf_header.DimCLRD);
-        fprintf (fp, "  9\n$DIMCLRE\n 70\n%i\n", dxf_header.DimCLRE);
-        fprintf (fp, "  9\n$DIMCLRT\n 70\n%i\n", dxf_header.DimCLRT);
-        fprintf (fp, "  9\n$DIMTFAC\n 40\n%f\n", dxf_header.DimTFAC);
-        */
-        ret = dxf_read_header_parse_n_double (fp, temp_string, "$DIMGAP",
-                                              TRUE,
-                                              1,
-                                              &dxf_header.DimGAP);
-        dxf_return(ret);
-        /*
-        if (acad_version_number >= AC1012) fprintf (fp, "  9\n$DIMJUST\n 70\n%i\n", dxf_header.DimJUST);
-        if (acad_version_number >= AC1012) fprintf (fp, "  9\n$DIMSD1\n 70\n%i\n", dxf_header.DimSD1);
-        if (acad_version_number >= AC1012) fprintf (fp, "  9\n$DIMSD2\n 70\n%i\n", dxf_header.DimSD2);
-        if (acad_version_number >= AC1012) fprintf (fp, "  9\n$DIMTOLJ\n 70\n%i\n", dxf_header.DimTOLJ);
-        if (acad_version_number >= AC1012) fprintf (fp, "  9\n$DIMTZIN\n 70\n%i\n", dxf_header.DimTZIN);
-        if (acad_version_number >= AC1012) fprintf (fp, "  9\n$DIMALTZ\n 70\n%i\n", dxf_header.DimALTZ);
-        if (acad_version_number >= AC1012) fprintf (fp, "  9\n$DIMALTTZ\n 70\n%i\n", dxf_header.DimALTTZ);
-        if ((acad_version_number == AC1012) || (acad_version_number == AC1014)) fprintf (fp, "  9\n$DIMFIT\n 70\n%i\n", dxf_header.DimFIT);
-        if (acad_version_number >= AC1012) fprintf (fp, "  9\n$DIMUPT\n 70\n%i\n", dxf_header.DimUPT);
-        if ((acad_version_number == AC1012) || (acad_version_number == AC1014)) fprintf (fp, "  9\n$DIMUNIT\n 70\n%i\n", dxf_header.DimUNIT);
-        if (acad_version_number >= AC1012) fprintf (fp, "  9\n$DIMDEC\n 70\n%i\n", dxf_header.DimDEC);
-        if (acad_version_number >= AC1012) fprintf (fp, "  9\n$DIMTDEC\n 70\n%i\n", dxf_header.DimTDEC);
-        if (acad_version_number >= AC1012) fprintf (fp, "  9\n$DIMALTU\n 70\n%i\n", dxf_header.DimALTU);
-        if (acad_version_number >= AC1012) fprintf (fp, "  9\n$DIMALTTD\n 70\n%i\n", dxf_header.DimALTTD);
-        if (acad_version_number >= AC1012) fprintf (fp, "  9\n$DIMTXSTY\n  7\n%s\n", dxf_header.DimTXSTY);
-        */
-        ret = dxf_read_header_parse_int (fp, temp_string, "$DIMAUNIT",
-                                         &dxf_header.DimAUNIT,
-                                         acad_version_number >= AC1012);
-        dxf_return(ret);
-    
-        ret = dxf_read_header_parse_int (fp, temp_string, "$DIMADEC",
-                                         &dxf_header.DimADEC,
-                                         acad_version_number >= AC1015);
-        dxf_return(ret);
-        /*
-        if (acad_version_number >= AC1015) fprintf (fp, "  9\n$DIMALTRND\n 40\n%f\n", dxf_header.DimALTRND);
-        if (acad_version_number >= AC1015) fprintf (fp, "  9\n$DIMAZIN\n 70\n%i\n", dxf_header.DimAZIN);
-        if (acad_version_number >= AC1015) fprintf (fp, "  9\n$DIMDSEP\n 70\n%i\n", dxf_header.DimDSEP);
-        if (acad_version_number >= AC1015) fprintf (fp, "  9\n$DIMATFIT\n 70\n%i\n", dxf_header.DimATFIT);
-        if (acad_version_number >= AC1015) fprintf (fp, "  9\n$DIMFRAC\n 70\n%i\n", dxf_header.DimFRAC);
-        if (acad_version_number >= AC1015) fprintf (fp, "  9\n$DIMLDRBLK\n  1\n%s\n", dxf_header.DimLDRBLK);
-        */
-        ret = dxf_read_header_parse_int (fp, temp_string, "$DIMLUNIT",
-                                         &dxf_header.DimLUNIT,
-                                         acad_version_number >= AC1015);
-        dxf_return(ret);
-        /*
-        if (acad_version_number >= AC1015) fprintf (fp, "  9\n$DIMLWD\n 70\n%i\n", dxf_header.DimLWD);
-        if (acad_version_number >= AC1015) fprintf (fp, "  9\n$DIMLWE\n 70\n%i\n", dxf_header.DimLWE);
-        if (acad_version_number >= AC1015) fprintf (fp, "  9\n$DIMTMOVE\n 70\n%i\n", dxf_header.DimTMOVE);
-        */
-        ret = dxf_read_header_parse_int (fp, temp_string, "$LUNITS",
-                                         &dxf_header.LUnits,
-                                         TRUE);
-        dxf_return(ret);
-        
-        ret = dxf_read_header_parse_int (fp, temp_string, "$LUPREC",
-                                         &dxf_header.LUPrec,
-                                         TRUE);
-        dxf_return(ret);
-        /*
-        fprintf (fp, "  9\n$SKETCHINC\n 40\n%f\n", dxf_header.Sketchinc);
-        fprintf (fp, "  9\n$FILLETRAD\n 40\n%f\n", dxf_header.FilletRad);
-        */
-        ret = dxf_read_header_parse_int (fp, temp_string, "$AUNITS",
-                                         &dxf_header.AUnits,
-                                         TRUE);
-        dxf_return(ret);
-    
-        ret = dxf_read_header_parse_int (fp, temp_string, "$AUPREC",
-                                         &dxf_header.AUPrec,
-                                         TRUE);
-        dxf_return(ret);
-        /*
-        fprintf (fp, "  9\n$MENU\n  1\n%s\n", dxf_header.Menu);
-        fprintf (fp, "  9\n$ELEVATION\n 40\n%f\n", dxf_header.Elevation);
-        fprintf (fp, "  9\n$PELEVATION\n 40\n%f\n", dxf_header.PElevation);
-        fprintf (fp, "  9\n$THICKNESS\n 40\n%f\n", dxf_header.Thickness);
-        fprintf (fp, "  9\n$LIMCHECK\n 70\n%i\n", dxf_header.LimCheck);
-        if (acad_version_number <= AC1014) fprintf (fp, "  9\n$BLIPMODE\n 70\n%i\n", dxf_header.BlipMode);
-        fprintf (fp, "  9\n$CHAMFERA\n 40\n%f\n", dxf_header.ChamferA);
-        fprintf (fp, "  9\n$CHAMFERB\n 40\n%f\n", dxf_header.ChamferB);
-        if (acad_version_number >= AC1012) fprintf (fp, "  9\n$CHAMFERC\n 40\n%f\n", dxf_header.ChamferC);
-        if (acad_version_number >= AC1012) fprintf (fp, "  9\n$CHAMFERD\n 40\n%f\n", dxf_header.ChamferD);
-        fprintf (fp, "  9\n$SKPOLY\n 70\n%i\n", dxf_header.SKPoly);
-        fprintf (fp, "  9\n$TDCREATE\n 40\n%f\n", dxf_header.TDCreate);
-        if (acad_version_number >= AC1015) fprintf (fp, "  9\n$TDUCREATE\n 40\n%f\n", dxf_header.TDUCreate);
-        fprintf (fp, "  9\n$TDUPDATE\n 40\n%f\n", dxf_header.TDUpdate);
-        if (acad_version_number >= AC1015) fprintf (fp, "  9\n$TDUUPDATE\n 40\n%f\n", dxf_header.TDUUpdate);
-        fprintf (fp, "  9\n$TDINDWG\n 40\n%f\n", dxf_header.TDInDWG);
-        fprintf (fp, "  9\n$TDUSRTIMER\n 40\n%f\n", dxf_header.TDUSRTimer);
-        fprintf (fp, "  9\n$USRTIMER\n 70\n%i\n", dxf_header.USRTimer);
-        fprintf (fp, "  9\n$ANGBASE\n 50\n%f\n", dxf_header.AngBase);
-        fprintf (fp, "  9\n$ANGDIR\n 70\n%i\n", dxf_header.AngDir);
-        fprintf (fp, "  9\n$PDMODE\n 70\n%i\n", dxf_header.PDMode);
-        fprintf (fp, "  9\n$PDSIZE\n 40\n%f\n", dxf_header.PDSize);
-        fprintf (fp, "  9\n$PLINEWID\n 40\n%f\n", dxf_header.PLineWid);
-        if (acad_version_number <= AC1014) fprintf (fp, "  9\n$COORDS\n 70\n%i\n", dxf_header.Coords);
-        fprintf (fp, "  9\n$SPLFRAME\n 70\n%i\n", dxf_header.SPLFrame);
-        fprintf (fp, "  9\n$SPLINETYPE\n 70\n%i\n", dxf_header.SPLineType);
-        if (acad_version_number <= AC1014) fprintf (fp, "  9\n$ATTDIA\n 70\n%i\n", dxf_header.AttDia);
-        if (acad_version_number <= AC1014) fprintf (fp, "  9\n$ATTREQ\n 70\n%i\n", dxf_header.AttReq);
-        if (acad_version_number <= AC1014) fprintf (fp, "  9\n$HANDLING\n 70\n%i\n", dxf_header.Handling);
-        */
-        ret = dxf_read_header_parse_int (fp, temp_string, "$SPLINESEGS",
-                                         &dxf_header.SPLineSegs,
-                                         TRUE);
-        dxf_return(ret);
-        
-        ret = dxf_read_header_parse_string (fp, temp_string, "$HANDSEED",
-                                            &dxf_header.HandSeed,
-                                            TRUE);
-        dxf_return(ret);
-    /*
-        fprintf (fp, "  9\n$SURFTAB1\n 70\n%i\n", dxf_header.SurfTab1);
-        fprintf (fp, "  9\n$SURFTAB2\n 70\n%i\n", dxf_header.SurfTab2);
-        fprintf (fp, "  9\n$SURFTYPE\n 70\n%i\n", dxf_header.SurfType);
-        fprintf (fp, "  9\n$SURFU\n 70\n%i\n", dxf_header.SurfU);
-        fprintf (fp, "  9\n$SURFV\n 70\n%i\n", dxf_header.SurfV);
-        if (acad_version_number >= AC1015) fprintf (fp, "  9\n$UCSBASE\n  2\n%s\n", dxf_header.UCSBase);
-        fprintf (fp, "  9\n$UCSNAME\n  2\n%s\n", dxf_header.UCSName);
-        fprintf (fp, "  9\n$UCSORG\n 10\n%f\n 20\n%f\n 30\n%f\n", dxf_header.UCSOrg.x0, dxf_header.UCSOrg.y0, dxf_header.UCSOrg.z0);
-        fprintf (fp, "  9\n$UCSXDIR\n 10\n%f\n 20\n%f\n 30\n%f\n", dxf_header.UCSXDir.x0, dxf_header.UCSXDir.y0, dxf_header.UCSXDir.z0);
-        fprintf (fp, "  9\n$UCSYDIR\n 10\n%f\n 20\n%f\n 30\n%f\n", dxf_header.UCSYDir.x0, dxf_header.UCSYDir.y0, dxf_header.UCSYDir.z0);
-        if (acad_version_number >= AC1015) fprintf (fp, "  9\n$UCSORTHOREF\n  2\n%s\n", dxf_header.UCSOrthoRef);
-        if (acad_version_number >= AC1015) fprintf (fp, "  9\n$UCSORTHOVIEW\n 70\n%i\n", dxf_header.UCSOrthoView);
-        if (acad_version_number >= AC1015) fprintf (fp, "  9\n$UCSORGTOP\n 10\n%f\n 20\n%f\n 30\n%f\n", dxf_header.UCSOrgTop.x0, dxf_header.UCSOrgTop.y0, dxf_header.UCSOrgTop.z0);
-        if (acad_version_number >= AC1015) fprintf (fp, "  9\n$UCSORGBOTTOM\n 10\n%f\n 20\n%f\n 30\n%f\n", dxf_header.UCSOrgBottom.x0, dxf_header.UCSOrgBottom.y0, dxf_header.UCSOrgBottom.z0);
-        if (acad_version_number >= AC1015) fprintf (fp, "  9\n$UCSORGLEFT\n 10\n%f\n 20\n%f\n 30\n%f\n", dxf_header.UCSOrgLeft.x0, dxf_header.UCSOrgLeft.y0, dxf_header.UCSOrgLeft.z0);
-        if (acad_version_number >= AC1015) fprintf (fp, "  9\n$UCSORGRIGHT\n 10\n%f\n 20\n%f\n 30\n%f\n", dxf_header.UCSOrgRight.x0, dxf_header.UCSOrgRight.y0, dxf_header.UCSOrgRight.z0);
-        if (acad_version_number >= AC1015) fprintf (fp, "  9\n$UCSORGFRONT\n 10\n%f\n 20\n%f\n 30\n%f\n", dxf_header.UCSOrgFront.x0, dxf_header.UCSOrgFront.y0, dxf_header.UCSOrgFront.z0);
-        if (acad_version_number >= AC1015) fprintf (fp, "  9\n$UCSORGBACK\n 10\n%f\n 20\n%f\n 30\n%f\n", dxf_header.UCSOrgBack.x0, dxf_header.UCSOrgBack.y0, dxf_header.UCSOrgBack.z0);
-        if (acad_version_number >= AC1015) fprintf (fp, "  9\n$PUCSBASE\n  2\n%s\n", dxf_header.PUCSBase);
-        fprintf (fp, "  9\n$PUCSNAME\n  2\n%s\n", dxf_header.PUCSName);
-        fprintf (fp, "  9\n$PUCSORG\n 10\n%f\n 20\n%f\n 30\n%f\n", dxf_header.PUCSOrg.x0, dxf_header.PUCSOrg.y0, dxf_header.PUCSOrg.z0);
-        fprintf (fp, "  9\n$PUCSXDIR\n 10\n%f\n 20\n%f\n 30\n%f\n", dxf_header.PUCSXDir.x0, dxf_header.PUCSXDir.y0, dxf_header.PUCSXDir.z0);
-        fprintf (fp, "  9\n$PUCSYDIR\n 10\n%f\n 20\n%f\n 30\n%f\n", dxf_header.PUCSYDir.x0, dxf_header.PUCSYDir.y0, dxf_header.PUCSYDir.z0);
-        if (acad_version_number >= AC1015) fprintf (fp, "  9\n$PUCSORTHOREF\n  2\n%s\n", dxf_header.PUCSOrthoRef);
-        if (acad_version_number >= AC1015) fprintf (fp, "  9\n$PUCSORTHOVIEW\n 70\n%i\n", dxf_header.PUCSOrthoView);
-        if (acad_version_number >= AC1015) fprintf (fp, "  9\n$PUCSORGTOP\n 10\n%f\n 20\n%f\n 30\n%f\n", dxf_header.PUCSOrgTop.x0, dxf_header.PUCSOrgTop.y0, dxf_header.PUCSOrgTop.z0);
-        if (acad_version_number >= AC1015) fprintf (fp, "  9\n$PUCSORGBOTTOM\n 10\n%f\n 20\n%f\n 30\n%f\n", dxf_header.PUCSOrgBottom.x0, dxf_header.PUCSOrgBottom.y0, dxf_header.PUCSOrgBottom.z0);
-        if (acad_version_number >= AC1015) fprintf (fp, "  9\n$PUCSORGLEFT\n 10\n%f\n 20\n%f\n 30\n%f\n", dxf_header.PUCSOrgLeft.x0, dxf_header.PUCSOrgLeft.y0, dxf_header.PUCSOrgLeft.z0);
-        if (acad_version_number >= AC1015) fprintf (fp, "  9\n$PUCSORGRIGHT\n 10\n%f\n 20\n%f\n 30\n%f\n", dxf_header.PUCSOrgRight.x0, dxf_header.PUCSOrgRight.y0, dxf_header.PUCSOrgRight.z0);
-        if (acad_version_number >= AC1015) fprintf (fp, "  9\n$PUCSORGFRONT\n 10\n%f\n 20\n%f\n 30\n%f\n", dxf_header.PUCSOrgFront.x0, dxf_header.PUCSOrgFront.y0, dxf_header.PUCSOrgFront.z0);
-        if (acad_version_number >= AC1015) fprintf (fp, "  9\n$PUCSORGBACK\n 10\n%f\n 20\n%f\n 30\n%f\n", dxf_header.PUCSOrgBack.x0, dxf_header.PUCSOrgBack.y0, dxf_header.PUCSOrgBack.z0);
-        fprintf (fp, "  9\n$USERI1\n 70\n%i\n", dxf_header.UserI1);
-        fprintf (fp, "  9\n$USERI2\n 70\n%i\n", dxf_header.UserI2);
-        fprintf (fp, "  9\n$USERI3\n 70\n%i\n", dxf_header.UserI3);
-        fprintf (fp, "  9\n$USERI4\n 70\n%i\n", dxf_header.UserI4);
-        fprintf (fp, "  9\n$USERI5\n 70\n%i\n", dxf_header.UserI5);
-        fprintf (fp, "  9\n$USERR1\n 40\n%f\n", dxf_header.UserR1);
-        fprintf (fp, "  9\n$USERR2\n 40\n%f\n", dxf_header.UserR2);
-        fprintf (fp, "  9\n$USERR3\n 40\n%f\n", dxf_header.UserR3);
-        fprintf (fp, "  9\n$USERR4\n 40\n%f\n", dxf_header.UserR4);
-        fprintf (fp, "  9\n$USERR5\n 40\n%f\n", dxf_header.UserR5);
-        fprintf (fp, "  9\n$WORLDVIEW\n 70\n%i\n", dxf_header.WorldView);
-        fprintf (fp, "  9\n$SHADEDGE\n 70\n%i\n", dxf_header.ShadEdge);
-        fprintf (fp, "  9\n$SHADEDIF\n 70\n%i\n", dxf_header.ShadeDif);
-        fprintf (fp, "  9\n$TILEMODE\n 70\n%i\n", dxf_header.TileMode);
-        fprintf (fp, "  9\n$MAXACTVP\n 70\n%i\n", dxf_header.MaxActVP);
-        fprintf (fp, "  9\n$PINSBASE\n 10\n%f\n 20\n%f\n 30\n%f\n", dxf_header.PInsBase.x0, dxf_header.PInsBase.y0, dxf_header.PInsBase.z0);
-        fprintf (fp, "  9\n$PLIMCHECK\n 70\n%i\n", dxf_header.PLimCheck);
-        fprintf (fp, "  9\n$PEXTMIN\n 10\n%f\n 20\n%f\n 30\n%f\n", dxf_header.PExtMin.x0, dxf_header.PExtMin.y0, dxf_header.PExtMin.z0);
-        fprintf (fp, "  9\n$PEXTMAX\n 10\n%f\n 20\n%f\n 30\n%f\n", dxf_header.PExtMax.x0, dxf_header.PExtMax.y0, dxf_header.PExtMax.z0);
-        */
-        ret = dxf_read_header_parse_n_double (fp, temp_string, "$PLIMMIN",
-                                              TRUE,
-                                              2,
-                                              &dxf_header.PLimMin.x0,
-                                              dxf_header.PLimMin.y0);
-        dxf_return(ret);
-    
-        ret = dxf_read_header_parse_n_double (fp, temp_string, "$PLIMMAX",
-                                              TRUE,
-                                              2,
-                                              &dxf_header.PLimMax.x0,
-                                              dxf_header.PLimMax.y0);
-        dxf_return(ret);
-        /*
-        fprintf (fp, "  9\n$UNITMODE\n 70\n%i\n", dxf_header.UnitMode);
-        fprintf (fp, "  9\n$VISRETAIN\n 70\n%i\n", dxf_header.VisRetain);
-        fprintf (fp, "  9\n$PLINEGEN\n 70\n%i\n", dxf_header.PLineGen);
-        fprintf (fp, "  9\n$PSLTSCALE\n 70\n%i\n", dxf_header.PSLTScale);
-        if (acad_version_number >= AC1012) fprintf (fp, "  9\n$TREEDEPTH\n 70\n%i\n", dxf_header.TreeDepth);
-        if ((acad_version_number == AC1012) || (acad_version_number == AC1014)) fprintf (fp, "  9\n$PICKSTYLE\n 70\n%i\n", dxf_header.PickStyle);
-        if (acad_version_number >= AC1012) fprintf (fp, "  9\n$CMLSTYLE\n  2\n%s\n", dxf_header.CMLStyle);
-        if (acad_version_number >= AC1012) fprintf (fp, "  9\n$CMLJUST\n 70\n%i\n", dxf_header.CMLJust);
-        if (acad_version_number >= AC1012) fprintf (fp, "  9\n$CMLSCALE\n 40\n%f\n", dxf_header.CMLScale);
-        if (acad_version_number >= AC1014) fprintf (fp, "  9\n$PROXYGRAPHICS\n 70\n%i\n", dxf_header.ProxyGraphics);
-        if (acad_version_number >= AC1014) fprintf (fp, "  9\n$MEASUREMENT\n 70\n%i\n", dxf_header.Measurement);
-        if (acad_version_number == AC1012) fprintf (fp, "  9\n$SAVEIMAGES\n 70\n%i\n", dxf_header.SaveImages);
-        if (acad_version_number >= AC1015) fprintf (fp, "  9\n$CELWEIGHT\n370\n%i\n", dxf_header.CELWeight);
-        if (acad_version_number >= AC1015) fprintf (fp, "  9\n$ENDCAPS\n280\n%i\n", dxf_header.EndCaps);
-        if (acad_version_number >= AC1015) fprintf (fp, "  9\n$JOINSTYLE\n280\n%i\n", dxf_header.JoinStyle);
-        if (acad_version_number >= AC1015) fprintf (fp, "  9\n$LWDISPLAY\n290\n%i\n", dxf_header.LWDisplay);
-        */
-        ret = dxf_read_header_parse_int (fp, temp_string, "$INSUNITS",
-                                         &dxf_header.InsUnits,
-                                         acad_version_number >= AC1015);
-        dxf_return(ret);
-        /*
-        if (acad_version_number >= AC1015) fprintf (fp, "  9\n$HYPERLINKBASE\n  1\n%s\n", dxf_header.HyperLinkBase);
-        if (acad_version_number >= AC1015) fprintf (fp, "  9\n$STYLESHEET\n  1\n%s\n", dxf_header.StyleSheet);
-        if (acad_version_number >= AC1015) fprintf (fp, "  9\n$XEDIT\n290\n%i\n", dxf_header.XEdit);
-        if (acad_version_number >= AC1015) fprintf (fp, "  9\n$CEPSNTYPE\n380\n%i\n", dxf_header.CEPSNType);
-        if (acad_version_number >= AC1015) fprintf (fp, "  9\n$PSTYLEMODE\n290\n%i\n", dxf_header.PStyleMode);
-        if (acad_version_number >= AC1015) fprintf (fp, "  9\n$FINGERPRINTGUID\n  2\n%s\n", dxf_header.FingerPrintGUID);
-        if (acad_version_number >= AC1015) fprintf (fp, "  9\n$VERSIONGUID\n  2\n%s\n", dxf_header.VersionGUID);
-        if (acad_version_number >= AC1015) fprintf (fp, "  9\n$EXTNAMES\n290\n%i\n", dxf_header.ExtNames);
-        if (acad_version_number >= AC1015) fprintf (fp, "  9\n$PSVPSCALE\n 40\n%f\n", dxf_header.PSVPScale);
-        if (acad_version_number >= AC1015) fprintf (fp, "  9\n$OLESTARTUP\n290\n%i\n", dxf_header.OLEStartUp);
-        if (acad_version_number >= AC1018) fprintf (fp, "  9\n$SORTENTS\n280\n%i\n", dxf_header.SortEnts);
-        if (acad_version_number >= AC1018) fprintf (fp, "  9\n$INDEXCTL\n280\n%i\n", dxf_header.IndexCtl);
-        if (acad_version_number >= AC1018) fprintf (fp, "  9\n$HIDETEXT\n280\n%i\n", dxf_header.HideText);
-        if (acad_version_number >= AC1018) fprintf (fp, "  9\n$XCLIPFRAME\n290\n%i\n", dxf_header.XClipFrame);
-        if (acad_version_number >= AC1018) fprintf (fp, "  9\n$HALOGAP\n280\n%i\n", dxf_header.HaloGap);
-        if (acad_version_number >= AC1018) fprintf (fp, "  9\n$OBSCOLOR\n 70\n%i\n", dxf_header.ObsColor);
-        if (acad_version_number >= AC1018) fprintf (fp, "  9\n$OBSLTYPE\n280\n%i\n", dxf_header.ObsLType);
-        if (acad_version_number >= AC1018) fprintf (fp, "  9\n$INTERSECTIONDISPLAY\n280\n%i\n", dxf_header.InterSectionDisplay);
-        if (acad_version_number >= AC1018) fprintf (fp, "  9\n$INTERSECTIONCOLOR\n 70\n%i\n", dxf_header.InterSectionColor);
-        if (acad_version_number >= AC1018) fprintf (fp, "  9\n$DIMASSOC\n280\n%i\n", dxf_header.DimASSOC);
-        if (acad_version_number >= AC1018) fprintf (fp, "  9\n$PROJECTNAME\n  1\n%s\n", dxf_header.ProjectName);        
-*/
-        ret = dxf_read_header_parse_n_double (fp, temp_string, "$GRIDUNIT",
-                                              acad_version_number >= AC1009,
-                                              2,
-                                              &dxf_header.GridUnit.x0,
-                                              &dxf_header.GridUnit.y0);
-        dxf_return(ret);
+        const DxfHeaderVarSpec *spec;
+        char tstring[255];
+        double dvar;
+        int f, n, tvar, i;
 
-        ret = dxf_read_header_parse_int (fp, temp_string, "$GRIDMODE",
-                                         &dxf_header.GridMode,
-                                         acad_version_number >= AC1009);
-        dxf_return(ret);
+        spec = dxf_header_var_find (temp_string);
+        if ((spec == NULL)
+                || (acad_version_number < spec->min_version)
+                || (acad_version_number > spec->max_version))
+        {
+                /* Unknown variable, or not valid for this version. */
+                return FALSE;
+        }
+        switch (spec->type)
+        {
+                case DXF_HEADER_VAR_INT:
+                {
+                        f = dxf_read_scanf (fp, "%i\n%i\n", &n, &tvar);
+                        if ((f > 0) && dxf_read_is_int (n))
+                        {
+                                *((int *) (((char *) &dxf_header) + spec->offset[0])) = tvar;
+                                return FOUND;
+                        }
+                        return FAIL;
+                }
+                case DXF_HEADER_VAR_STRING:
+                {
+                        dxf_read_scanf (fp, "%i\n%s\n", &n, tstring);
+                        if (dxf_read_is_string (n))
+                        {
+                                *((char **) (((char *) &dxf_header) + spec->offset[0])) = strdup (tstring);
+                                return FOUND;
+                        }
+                        return FAIL;
+                }
+                case DXF_HEADER_VAR_DOUBLE:
+                {
+                        for (i = 0; i < spec->quant; i++)
+                        {
+                                f = dxf_read_scanf (fp, "%d\n%'lf\n", &n, &dvar);
+                                if ((f > 0) && dxf_read_is_double (n))
+                                {
+                                        *((double *) (((char *) &dxf_header) + spec->offset[i])) = dvar;
+                                }
+                                else
+                                {
+                                        return FAIL;
+                                }
+                        }
+                        return FOUND;
+                }
+        }
 #if DEBUG
         DXF_DEBUG_END
 #endif
-       return FALSE;
+        return FALSE;
 }
 
 /*!
@@ -1688,11 +2175,12 @@ dxf_read_header
         /* \FIXME: stores the autocad version as int */
         dxf_header._AcadVer = acad_version_number;
     
-        /* a loop to read all the header with no particulary order */
-        while (!feof(fp->fp))
+        /* a loop to read all the header with no particulary order;
+         * bail out when the reader runs dry (feof () on the underlying
+         * FILE never fires for gzip input, which reads through
+         * gzread ()) */
+        while (dxf_read_scanf (fp, "%i\n%s\n", &n, temp_string) == 2)
         {
-                /* reads the next header content */
-                dxf_read_scanf (fp, "%i\n%s\n", &n, temp_string);
                 /* if it is a valid line */
                 if (n == 9)
                 {
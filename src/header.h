@@ -331,6 +331,23 @@ dxf_write_header_metric_new
 (
         DxfFile *fp
 );
+int
+dxf_header_variable_version_range
+(
+        const char *name,
+        int *min_version,
+        int *max_version
+);
+const char *
+dxf_header_acad_version_string
+(
+        int acad_version_number
+);
+int
+dxf_header_acad_version_number
+(
+        const char *version_string
+);
 
 
 #endif /* LIBDXF_SRC_HEADER_H */
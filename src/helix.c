@@ -35,6 +35,8 @@
 
 
 #include "helix.h"
+#include "diag.h"
+#include "allocator.h"
 
 
 /*!
@@ -57,7 +59,7 @@ dxf_helix_new ()
         size = sizeof (DxfHelix);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_helix = malloc (size)) == NULL)
+        if ((dxf_helix = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfHelix struct.\n")),
@@ -148,6 +150,7 @@ dxf_helix_init
         dxf_helix->color_name = strdup ("");
         dxf_helix->transparency = 0;
         dxf_spline_init (&dxf_helix->spline);
+        dxf_helix->spline_valid = FALSE;
         dxf_helix->next = NULL;
 #if DEBUG
         DXF_DEBUG_END
@@ -156,6 +159,220 @@ dxf_helix_init
 }
 
 
+/*!
+ * \brief Invalidate the cached spline representation of a DXF \c HELIX.
+ *
+ * Has to be called after changing any of the helix parameters (base
+ * point, start point, axis vector, radius, number of turns, turn height
+ * or handedness), so the next \c dxf_helix_get_spline call recomputes
+ * the spline form.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when an error
+ * occurred.
+ */
+int
+dxf_helix_invalidate_spline
+(
+        DxfHelix *dxf_helix
+                /*!< DXF \c HELIX entity. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        if (dxf_helix == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        dxf_helix->spline_valid = FALSE;
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Get the spline representation of a DXF \c HELIX, deriving it
+ * lazily from the helix parameters.
+ *
+ * The spline form is computed once on first access and cached in the
+ * \c spline member; repeated calls return the cached geometry until
+ * \c dxf_helix_invalidate_spline is called.\n
+ * The helix is expanded into a clamped cubic spline whose control
+ * points sample the helix at 16 segments per turn, reusing the arrays
+ * already allocated in the cache.
+ *
+ * \return a pointer to the spline representation, or \c NULL when
+ * errors occurred.
+ */
+DxfSpline *
+dxf_helix_get_spline
+(
+        DxfHelix *dxf_helix
+                /*!< DXF \c HELIX entity. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        DxfSpline *spline;
+        double ax, ay, az;
+        double ux, uy, uz;
+        double vx, vy, vz;
+        double radius;
+        double turns;
+        double length;
+        double angle;
+        double height;
+        double t;
+        int number_of_control_points;
+        int number_of_knots;
+        int i;
+
+        if (dxf_helix == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        spline = &dxf_helix->spline;
+        if (dxf_helix->spline_valid)
+        {
+                return (spline);
+        }
+        /* Normalize the axis vector; default to the world Z-axis. */
+        ax = dxf_helix->x2;
+        ay = dxf_helix->y2;
+        az = dxf_helix->z2;
+        length = sqrt ((ax * ax) + (ay * ay) + (az * az));
+        if (length == 0.0)
+        {
+                ax = 0.0;
+                ay = 0.0;
+                az = 1.0;
+        }
+        else
+        {
+                ax /= length;
+                ay /= length;
+                az /= length;
+        }
+        /* The radial unit vector points from the axis base point to
+         * the start point, with the axial component projected out. */
+        ux = dxf_helix->x1 - dxf_helix->x0;
+        uy = dxf_helix->y1 - dxf_helix->y0;
+        uz = dxf_helix->z1 - dxf_helix->z0;
+        length = (ux * ax) + (uy * ay) + (uz * az);
+        ux -= length * ax;
+        uy -= length * ay;
+        uz -= length * az;
+        radius = sqrt ((ux * ux) + (uy * uy) + (uz * uz));
+        if (radius == 0.0)
+        {
+                /* degenerate start point on the axis: fall back to the
+                 * stored radius along an arbitrary perpendicular. */
+                radius = dxf_helix->radius;
+                if (fabs (az) < fabs (ax))
+                {
+                        ux = -ay;
+                        uy = ax;
+                        uz = 0.0;
+                }
+                else
+                {
+                        ux = 0.0;
+                        uy = -az;
+                        uz = ay;
+                }
+                length = sqrt ((ux * ux) + (uy * uy) + (uz * uz));
+                ux /= length;
+                uy /= length;
+                uz /= length;
+        }
+        else
+        {
+                ux /= radius;
+                uy /= radius;
+                uz /= radius;
+        }
+        /* The binormal completes the frame; a left handed helix turns
+         * against it. */
+        vx = (ay * uz) - (az * uy);
+        vy = (az * ux) - (ax * uz);
+        vz = (ax * uy) - (ay * ux);
+        if (dxf_helix->handedness == 0)
+        {
+                vx = -vx;
+                vy = -vy;
+                vz = -vz;
+        }
+        turns = dxf_helix->number_of_turns;
+        if (turns <= 0.0)
+        {
+                turns = 1.0;
+        }
+        number_of_control_points = (int) ceil (turns * 16.0) + 1;
+        number_of_knots = number_of_control_points + 4;
+        if (dxf_spline_reserve (spline, number_of_knots,
+                number_of_control_points, 0) != EXIT_SUCCESS)
+        {
+                return (NULL);
+        }
+        /* Sample the helix into the control point arrays. */
+        for (i = 0; i < number_of_control_points; i++)
+        {
+                t = (double) i / (double) (number_of_control_points - 1);
+                angle = t * turns * 2.0 * M_PI;
+                height = t * turns * dxf_helix->turn_height;
+                spline->x0[i] = dxf_helix->x0
+                        + (radius * cos (angle) * ux)
+                        + (radius * sin (angle) * vx)
+                        + (height * ax);
+                spline->y0[i] = dxf_helix->y0
+                        + (radius * cos (angle) * uy)
+                        + (radius * sin (angle) * vy)
+                        + (height * ay);
+                spline->z0[i] = dxf_helix->z0
+                        + (radius * cos (angle) * uz)
+                        + (radius * sin (angle) * vz)
+                        + (height * az);
+                spline->weight_value[i] = 1.0;
+        }
+        /* Clamped uniform knot vector for a cubic spline. */
+        for (i = 0; i < number_of_knots; i++)
+        {
+                if (i < 4)
+                {
+                        spline->knot_value[i] = 0.0;
+                }
+                else if (i >= number_of_knots - 4)
+                {
+                        spline->knot_value[i] = 1.0;
+                }
+                else
+                {
+                        spline->knot_value[i] = (double) (i - 3)
+                                / (double) (number_of_knots - 7);
+                }
+        }
+        spline->flag = 0;
+        spline->degree = 3;
+        spline->number_of_knots = number_of_knots;
+        spline->number_of_control_points = number_of_control_points;
+        spline->number_of_fit_points = 0;
+        dxf_helix->spline_valid = TRUE;
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (spline);
+}
+
+
 /*!
  * \brief Read data from a DXF file into a DXF \c HELIX entity.
  *
@@ -179,7 +396,7 @@ dxf_helix_read
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        char *temp_string = NULL;
+        char temp_string[DXF_MAX_STRING_LENGTH];
         int i;
         int i_x0;
         int i_y0;
@@ -214,7 +431,7 @@ dxf_helix_read
                 if (ferror (fp->fp))
                 {
                         fprintf (stderr,
-                          (_("Error in %s () while reading from: %s in line: %d.\n")),
+                          (_("Error in %s () while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                         fclose (fp->fp);
                         return (NULL);
@@ -231,13 +448,17 @@ dxf_helix_read
                         /* Now follows a string containing a linetype
                          * name. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_helix->linetype);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_helix->linetype);
+                        dxf_helix->linetype = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "8") == 0)
                 {
                         /* Now follows a string containing a layer name. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_helix->layer);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_helix->layer);
+                        dxf_helix->layer = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "10") == 0)
                 {
@@ -405,19 +626,24 @@ dxf_helix_read
                                                 /* Now follows a string containing a linetype
                                                  * name. */
                                                 (fp->line_number)++;
-                                                fscanf (fp->fp, "%s\n", dxf_helix->spline.linetype);
+                                                fscanf (fp->fp, "%s\n", temp_string);
+                                                free (dxf_helix->spline.linetype);
+                                                dxf_helix->spline.linetype = strdup (temp_string);
                                         }
                                         else if (strcmp (temp_string, "8") == 0)
                                         {
                                                 /* Now follows a string containing a layer name. */
                                                 (fp->line_number)++;
-                                                fscanf (fp->fp, "%s\n", dxf_helix->spline.layer);
+                                                fscanf (fp->fp, "%s\n", temp_string);
+                                                free (dxf_helix->spline.layer);
+                                                dxf_helix->spline.layer = strdup (temp_string);
                                         }
                                         else if (strcmp (temp_string, "10") == 0)
                                         {
                                                 /* Now follows a string containing the
                                                  * X-value of the control point coordinate
                                                  * (multiple entries). */
+                                                dxf_spline_reserve (&dxf_helix->spline, 0, i_x0 + 1, 0);
                                                 (fp->line_number)++;
                                                 fscanf (fp->fp, "%lf\n", &dxf_helix->spline.x0[i_x0]);
                                                 i_x0++;
@@ -427,6 +653,7 @@ dxf_helix_read
                                                 /* Now follows a string containing the
                                                  * Y-coordinate of control point coordinate
                                                  * (multiple entries). */
+                                                dxf_spline_reserve (&dxf_helix->spline, 0, i_y0 + 1, 0);
                                                 (fp->line_number)++;
                                                 fscanf (fp->fp, "%lf\n", &dxf_helix->spline.y0[i_y0]);
                                                 i_y0++;
@@ -436,6 +663,7 @@ dxf_helix_read
                                                 /* Now follows a string containing the
                                                  * Z-coordinate of the control point coordinate
                                                  * (multiple entries). */
+                                                dxf_spline_reserve (&dxf_helix->spline, 0, i_z0 + 1, 0);
                                                 (fp->line_number)++;
                                                 fscanf (fp->fp, "%lf\n", &dxf_helix->spline.z0[i_z0]);
                                                 i_z0++;
@@ -443,6 +671,7 @@ dxf_helix_read
                                         else if (strcmp (temp_string, "40") == 0)
                                         {
                                                 /* Now follows a knot value (one entry per knot, multiple entries). */
+                                                dxf_spline_reserve (&dxf_helix->spline, i_knot_value + 1, 0, 0);
                                                 (fp->line_number)++;
                                                 fscanf (fp->fp, "%lf\n", &dxf_helix->spline.knot_value[i_knot_value]);
                                                 i_knot_value++;
@@ -450,6 +679,7 @@ dxf_helix_read
                                         else if (strcmp (temp_string, "41") == 0)
                                         {
                                                 /* Now follows a weight value (one entry per knot, multiple entries). */
+                                                dxf_spline_reserve (&dxf_helix->spline, 0, i_weight_value + 1, 0);
                                                 (fp->line_number)++;
                                                 fscanf (fp->fp, "%lf\n", &dxf_helix->spline.weight_value[i_weight_value]);
                                                 i_weight_value++;
@@ -482,16 +712,22 @@ dxf_helix_read
                                         }
                                         else
                                         {
-                                                fprintf (stderr, "Warning: in dxf_spline_read () unknown string tag found while reading from: %s in line: %d.\n",
+                                                fprintf (stderr, "Warning: in dxf_spline_read () unknown string tag found while reading from: %s in line: %ld.\n",
                                                         fp->filename, fp->line_number);
                                         }
                                 }
+                                /* the spline data supplied by the file
+                                 * matches the helix parameters it was
+                                 * written with. */
+                                dxf_helix->spline.number_of_control_points = i_x0;
+                                dxf_helix->spline.number_of_knots = i_knot_value;
+                                dxf_helix->spline_valid = (i_x0 > 0);
                         }
                         else if ((strcmp (temp_string, "AcDbEntity") != 0)
                                 && ((strcmp (temp_string, "AcDbHelix") != 0)))
                         {
-                                fprintf (stderr,
-                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %d.\n")),
+                                dxf_diag_report (fp, DXF_DIAG_WARNING,
+                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                         }
                 }
@@ -528,7 +764,9 @@ dxf_helix_read
                         /* Now follows a string containing binary
                          * graphics data. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_helix->binary_graphics_data[i]);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_helix->binary_graphics_data[i]);
+                        dxf_helix->binary_graphics_data[i] = strdup (temp_string);
                         i++;
                 }
                 else if (strcmp (temp_string, "330") == 0)
@@ -536,21 +774,27 @@ dxf_helix_read
                         /* Now follows a string containing a
                          * soft-pointer ID/handle to owner dictionary. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_helix->dictionary_owner_soft);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_helix->dictionary_owner_soft);
+                        dxf_helix->dictionary_owner_soft = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "347") == 0)
                 {
                         /* Now follows a string containing a
                          * hard-pointer ID/handle to material object. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_helix->material);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_helix->material);
+                        dxf_helix->material = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "360") == 0)
                 {
                         /* Now follows a string containing a
                          * hard-pointer ID/handle to owner dictionary. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_helix->dictionary_owner_hard);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_helix->dictionary_owner_hard);
+                        dxf_helix->dictionary_owner_hard = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "370") == 0)
                 {
@@ -564,7 +808,9 @@ dxf_helix_read
                         /* Now follows a string containing a plot style
                          * name value. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_helix->plot_style_name);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_helix->plot_style_name);
+                        dxf_helix->plot_style_name = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "420") == 0)
                 {
@@ -577,7 +823,9 @@ dxf_helix_read
                         /* Now follows a string containing a color
                          * name value. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_helix->color_name);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_helix->color_name);
+                        dxf_helix->color_name = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "440") == 0)
                 {
@@ -595,8 +843,8 @@ dxf_helix_read
                 }
                 else
                 {
-                        fprintf (stderr,
-                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %d.\n")),
+                        dxf_diag_report (fp, DXF_DIAG_WARNING,
+                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                 }
         }
@@ -735,12 +983,11 @@ dxf_helix_write
         fprintf (fp->fp, "440\n%ld\n", dxf_helix->transparency);
         fprintf (fp->fp, "390\n%s\n", dxf_helix->plot_style_name);
         fprintf (fp->fp, "284\n%d\n", dxf_helix->shadow_mode);
-        /* Create a helix shaped spline and write to a DxfFile. */
-        /*! \todo Add code for creating a helix shaped spline. */
-        dxf_spline_init (&dxf_helix->spline);
-        dxf_helix->spline.flag = 0;
-        dxf_helix->spline.degree = 3;
-        /*! \todo Add code for writing a helix shaped spline to a DxfFile. */
+        /* Write the (cached) spline representation of the helix. */
+        if (dxf_helix_get_spline (dxf_helix) == NULL)
+        {
+                return (EXIT_FAILURE);
+        }
         fprintf (fp->fp, "100\nAcDbSpline\n");
         fprintf (fp->fp, " 70\n%d\n", dxf_helix->spline.flag);
         fprintf (fp->fp, " 71\n%d\n", dxf_helix->spline.degree);
@@ -841,7 +1088,7 @@ dxf_helix_free
         free (dxf_helix->dictionary_owner_soft);
         free (dxf_helix->plot_style_name);
         free (dxf_helix->color_name);
-        free (dxf_helix);
+        dxf_entity_dealloc (dxf_helix, sizeof (*dxf_helix));
         dxf_helix = NULL;
 #if DEBUG
         DXF_DEBUG_END
@@ -207,8 +207,17 @@ dxf_helix
                  * <li value = "1"> Right</li>
                  * </ol> */
         DxfSpline spline;
-                /*!< pointer to the first DxfSpline.\n
-                 * \c NULL if the last DxfSpline. */
+                /*!< cached spline representation of the helix.\n
+                 * Derived lazily from the helix parameters by
+                 * \c dxf_helix_get_spline, or filled from the
+                 * \c AcDbSpline subclass data when present in the DXF
+                 * file. */
+        int spline_valid;
+                /*!< nonzero when \c spline caches the geometry of the
+                 * current helix parameters.\n
+                 * Cleared by \c dxf_helix_invalidate_spline; callers
+                 * changing the helix parameters have to invalidate the
+                 * cache themselves. */
         struct DxfHelix *next;
                 /*!< pointer to the next DxfHelix.\n
                  * \c NULL in the last DxfHelix. */
@@ -222,6 +231,16 @@ dxf_helix_init
 (
         DxfHelix *dxf_helix
 );
+int
+dxf_helix_invalidate_spline
+(
+        DxfHelix *dxf_helix
+);
+DxfSpline *
+dxf_helix_get_spline
+(
+        DxfHelix *dxf_helix
+);
 DxfHelix *
 dxf_helix_read
 (
@@ -36,7 +36,10 @@
  */
 
 
+#include <pthread.h>
 #include "image.h"
+#include "diag.h"
+#include "allocator.h"
 
 
 /*!
@@ -61,7 +64,7 @@ dxf_image_new ()
         size = sizeof (DxfImage);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_image = malloc (size)) == NULL)
+        if ((dxf_image = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfImage struct.\n")),
@@ -98,6 +101,11 @@ dxf_image_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfImage template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         int i;
 
         /* Do some basic checks. */
@@ -115,44 +123,57 @@ dxf_image_init
                 __FUNCTION__);
               return (NULL);
         }
-        dxf_image->id_code = 0;
-        dxf_image->linetype = strdup (DXF_DEFAULT_LINETYPE);
-        dxf_image->layer = strdup (DXF_DEFAULT_LAYER);
-        dxf_image->elevation = 0.0;
-        dxf_image->thickness = 0.0;
-        dxf_image->linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
-        dxf_image->visibility = DXF_DEFAULT_VISIBILITY;
-        dxf_image->color = DXF_COLOR_BYLAYER;
-        dxf_image->paperspace = DXF_MODELSPACE;
-        dxf_image->dictionary_owner_soft = strdup ("");
-        dxf_image->dictionary_owner_hard = strdup ("");
-        dxf_image->x0 = 0.0;
-        dxf_image->y0 = 0.0;
-        dxf_image->z0 = 0.0;
-        dxf_image->x1 = 0.0;
-        dxf_image->y1 = 0.0;
-        dxf_image->z1 = 0.0;
-        dxf_image->x2 = 0.0;
-        dxf_image->y2 = 0.0;
-        dxf_image->z2 = 0.0;
-        dxf_image->x3 = 0.0;
-        dxf_image->y3 = 0.0;
-        for (i = 0; i < DXF_MAX_PARAM; i++)
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
         {
-                dxf_image->x4[i] = 0.0;
-                dxf_image->y4[i] = 0.0;
+                template.id_code = 0;
+                template.linetype = strdup (DXF_DEFAULT_LINETYPE);
+                template.layer = strdup (DXF_DEFAULT_LAYER);
+                template.elevation = 0.0;
+                template.thickness = 0.0;
+                template.linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
+                template.visibility = DXF_DEFAULT_VISIBILITY;
+                template.color = DXF_COLOR_BYLAYER;
+                template.paperspace = DXF_MODELSPACE;
+                template.dictionary_owner_soft = strdup ("");
+                template.dictionary_owner_hard = strdup ("");
+                template.x0 = 0.0;
+                template.y0 = 0.0;
+                template.z0 = 0.0;
+                template.x1 = 0.0;
+                template.y1 = 0.0;
+                template.z1 = 0.0;
+                template.x2 = 0.0;
+                template.y2 = 0.0;
+                template.z2 = 0.0;
+                template.x3 = 0.0;
+                template.y3 = 0.0;
+                for (i = 0; i < DXF_MAX_PARAM; i++)
+                {
+                        template.x4[i] = 0.0;
+                        template.y4[i] = 0.0;
+                }
+                template.image_display_properties = 0;
+                template.clipping_boundary_type = 0;
+                template.class_version = 0;
+                template.number_of_clip_boundary_vertices = 0;
+                template.clipping_state = 0;
+                template.brightness = 50;
+                template.contrast = 50;
+                template.fade = 50;
+                template.imagedef_object = strdup ("");
+                template.imagedef_reactor_object = strdup ("");
+                template.next = NULL;
+                template_ready = 1;
         }
-        dxf_image->image_display_properties = 0;
-        dxf_image->clipping_boundary_type = 0;
-        dxf_image->class_version = 0;
-        dxf_image->number_of_clip_boundary_vertices = 0;
-        dxf_image->clipping_state = 0;
-        dxf_image->brightness = 50;
-        dxf_image->contrast = 50;
-        dxf_image->fade = 50;
-        dxf_image->imagedef_object = strdup ("");
-        dxf_image->imagedef_reactor_object = strdup ("");
-        dxf_image->next = NULL;
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (dxf_image, &template, sizeof (DxfImage));
+        dxf_image->linetype = strdup (template.linetype);
+        dxf_image->layer = strdup (template.layer);
+        dxf_image->dictionary_owner_soft = strdup (template.dictionary_owner_soft);
+        dxf_image->dictionary_owner_hard = strdup (template.dictionary_owner_hard);
+        dxf_image->imagedef_object = strdup (template.imagedef_object);
+        dxf_image->imagedef_reactor_object = strdup (template.imagedef_reactor_object);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -185,7 +206,7 @@ dxf_image_read
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        char *temp_string = NULL;
+        char temp_string[DXF_MAX_STRING_LENGTH];
         int i;
         int j;
 
@@ -214,7 +235,7 @@ dxf_image_read
                 if (ferror (fp->fp))
                 {
                         fprintf (stderr,
-                          (_("Error in %s () while reading from: %s in line: %d.\n")),
+                          (_("Error in %s () while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                         fclose (fp->fp);
                         return (NULL);
@@ -231,13 +252,17 @@ dxf_image_read
                         /* Now follows a string containing a linetype
                          * name. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_image->linetype);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_image->linetype);
+                        dxf_image->linetype = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "8") == 0)
                 {
                         /* Now follows a string containing a layer name. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_image->layer);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_image->layer);
+                        dxf_image->layer = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "10") == 0)
                 {
@@ -414,8 +439,8 @@ dxf_image_read
                         if ((strcmp (temp_string, "AcDbEntity") != 0)
                         && ((strcmp (temp_string, "AcDbRasterImage") != 0)))
                         {
-                                fprintf (stderr,
-                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %d.\n")),
+                                dxf_diag_report (fp, DXF_DIAG_WARNING,
+                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                         }
                 }
@@ -452,21 +477,27 @@ dxf_image_read
                         /* Now follows a string containing Soft-pointer
                          * ID/handle to owner dictionary. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_image->dictionary_owner_soft);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_image->dictionary_owner_soft);
+                        dxf_image->dictionary_owner_soft = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "340") == 0)
                 {
                         /* Now follows a string containing a hard
                          * reference to imagedef object. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_image->imagedef_object);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_image->imagedef_object);
+                        dxf_image->imagedef_object = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "360") == 0)
                 {
                         /* Now follows a string containing a hard
                          * reference to imagedef_reactor object. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_image->imagedef_reactor_object);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_image->imagedef_reactor_object);
+                        dxf_image->imagedef_reactor_object = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "999") == 0)
                 {
@@ -477,8 +508,8 @@ dxf_image_read
                 }
                 else
                 {
-                        fprintf (stderr,
-                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %d.\n")),
+                        dxf_diag_report (fp, DXF_DIAG_WARNING,
+                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                 }
         }
@@ -698,7 +729,7 @@ dxf_image_free
         free (dxf_image->imagedef_reactor_object);
         free (dxf_image->dictionary_owner_soft);
         free (dxf_image->dictionary_owner_hard);
-        free (dxf_image);
+        dxf_entity_dealloc (dxf_image, sizeof (*dxf_image));
         dxf_image = NULL;
 #if DEBUG
         DXF_DEBUG_END
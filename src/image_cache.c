@@ -0,0 +1,300 @@
+/*!
+ * \file image_cache.c
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Functions for the shared raster cache of \c IMAGE underlays.
+ *
+ * Scanned plan overlays carry hundreds of \c IMAGE instances whose
+ * image definitions resolve to the same handful of raster files, and
+ * consumers used to re-open and re-read the raster once per
+ * instance.\n
+ * The cache memory-maps each referenced file on first lookup and
+ * returns the shared mapping on every later one, so a raster costs
+ * one open regardless of how many instances reference it; read-only
+ * mappings of the same file also share their pages between
+ * processes.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "image_cache.h"
+
+
+/*!
+ * \brief Allocate an empty raster cache.
+ *
+ * \return a pointer to the cache, or \c NULL when no memory was
+ * allocated.
+ */
+DxfImageCache *
+dxf_image_cache_new ()
+{
+        DxfImageCache *cache;
+
+        cache = calloc (1, sizeof (DxfImageCache));
+        if (cache == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        cache->index = dxf_symbol_table_new ();
+        if (cache->index == NULL)
+        {
+                free (cache);
+                return (NULL);
+        }
+        return (cache);
+}
+
+
+/*!
+ * \brief Load the contents of a raster file into a new cache entry.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+static int
+dxf_image_cache_load
+(
+        DxfImageCacheEntry *entry,
+                /*!< the entry to load into. */
+        const char *filename
+                /*!< the raster file to load. */
+)
+{
+        struct stat sb;
+        char *mapped;
+        size_t size;
+        int fd;
+
+        fd = open (filename, O_RDONLY);
+        if (fd < 0)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not open file: %s for reading.\n")),
+                  __FUNCTION__, filename);
+                return (EXIT_FAILURE);
+        }
+        if (fstat (fd, &sb) != 0)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not stat file: %s.\n")),
+                  __FUNCTION__, filename);
+                close (fd);
+                return (EXIT_FAILURE);
+        }
+        size = (size_t) sb.st_size;
+        entry->data = NULL;
+        entry->size = size;
+        entry->mapped = FALSE;
+        if (size > 0)
+        {
+                mapped = mmap (NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (mapped != MAP_FAILED)
+                {
+#ifdef MADV_RANDOM
+                        /* raster consumers seek to tiles, not through
+                         * the file front to back. */
+                        madvise (mapped, size, MADV_RANDOM);
+#endif
+                        entry->data = mapped;
+                        entry->mapped = TRUE;
+                }
+                else
+                {
+                        /* devices and filesystems without mmap: read
+                         * the file into one buffer instead. */
+                        entry->data = malloc (size);
+                        if (entry->data == NULL)
+                        {
+                                fprintf (stderr,
+                                  (_("Error in %s () could not allocate memory.\n")),
+                                  __FUNCTION__);
+                                close (fd);
+                                return (EXIT_FAILURE);
+                        }
+                        if (read (fd, entry->data, size) != (ssize_t) size)
+                        {
+                                fprintf (stderr,
+                                  (_("Error in %s () while reading from: %s.\n")),
+                                  __FUNCTION__, filename);
+                                free (entry->data);
+                                entry->data = NULL;
+                                close (fd);
+                                return (EXIT_FAILURE);
+                        }
+                }
+        }
+        close (fd);
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Resolve a raster file through the cache, mapping it on first
+ * use.
+ *
+ * The first lookup of a filename opens and memory-maps the file; every
+ * later lookup returns the existing entry without touching the
+ * filesystem.
+ *
+ * \return the cache entry holding the file contents, or \c NULL when
+ * errors occurred.
+ */
+DxfImageCacheEntry *
+dxf_image_cache_map
+(
+        DxfImageCache *cache,
+                /*!< the cache to resolve through. */
+        const char *filename
+                /*!< the raster file referenced by the image
+                 * definition. */
+)
+{
+        DxfImageCacheEntry *entry;
+
+        if ((cache == NULL) || (filename == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        entry = dxf_image_cache_find (cache, filename);
+        if (entry != NULL)
+        {
+                entry->references++;
+                return (entry);
+        }
+        entry = calloc (1, sizeof (DxfImageCacheEntry));
+        if (entry == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        if (dxf_image_cache_load (entry, filename) != EXIT_SUCCESS)
+        {
+                free (entry);
+                return (NULL);
+        }
+        entry->filename = strdup (filename);
+        entry->references = 1;
+        if (dxf_symbol_table_insert (cache->index, entry->filename, entry)
+                != EXIT_SUCCESS)
+        {
+                if (entry->mapped)
+                {
+                        munmap (entry->data, entry->size);
+                }
+                else
+                {
+                        free (entry->data);
+                }
+                free (entry->filename);
+                free (entry);
+                return (NULL);
+        }
+        entry->next = cache->entries;
+        cache->entries = entry;
+        cache->length++;
+        return (entry);
+}
+
+
+/*!
+ * \brief Look up the cache entry of a raster file without loading it.
+ *
+ * \return the entry, or \c NULL when the file has not been resolved
+ * yet.
+ */
+DxfImageCacheEntry *
+dxf_image_cache_find
+(
+        DxfImageCache *cache,
+                /*!< the cache to search. */
+        const char *filename
+                /*!< the raster file to look up. */
+)
+{
+        if ((cache == NULL) || (filename == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        return ((DxfImageCacheEntry *) dxf_symbol_table_find (cache->index,
+                filename));
+}
+
+
+/*!
+ * \brief Free a raster cache, unmapping every resolved file.
+ */
+void
+dxf_image_cache_free
+(
+        DxfImageCache *cache
+                /*!< the cache to free, or \c NULL. */
+)
+{
+        DxfImageCacheEntry *entry;
+        DxfImageCacheEntry *next;
+
+        if (cache == NULL)
+        {
+                return;
+        }
+        for (entry = cache->entries; entry != NULL; entry = next)
+        {
+                next = entry->next;
+                if (entry->mapped)
+                {
+                        munmap (entry->data, entry->size);
+                }
+                else
+                {
+                        free (entry->data);
+                }
+                free (entry->filename);
+                free (entry);
+        }
+        dxf_symbol_table_free (cache->index);
+        free (cache);
+}
+
+
+/* EOF */
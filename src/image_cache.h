@@ -0,0 +1,113 @@
+/*!
+ * \file image_cache.h
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Header for the shared raster cache of \c IMAGE underlays.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#ifndef LIBDXF_SRC_IMAGE_CACHE_H
+#define LIBDXF_SRC_IMAGE_CACHE_H
+
+
+#include "global.h"
+#include "symbol_table.h"
+
+
+/*!
+ * \brief One resolved raster file in the shared cache.
+ *
+ * Scanned plan overlays reference the same underlay from hundreds of
+ * \c IMAGE instances; the entry memory-maps the raster once and every
+ * instance shares the mapping instead of re-opening the file.
+ */
+typedef struct
+dxf_image_cache_entry
+{
+        char *filename;
+                /*!< the resolved raster file, as passed to
+                 * \c dxf_image_cache_map. */
+        char *data;
+                /*!< the file contents; memory-mapped read-only, or
+                 * heap allocated on filesystems without mmap. */
+        size_t size;
+                /*!< size of the file contents in bytes. */
+        int mapped;
+                /*!< \c TRUE when \c data is a memory mapping,
+                 * \c FALSE when it is a heap buffer. */
+        size_t references;
+                /*!< number of lookups which returned this entry;
+                 * diagnostic only, the entry lives until the cache is
+                 * freed. */
+        struct dxf_image_cache_entry *next;
+                /*!< the next entry of the cache. */
+} DxfImageCacheEntry;
+
+
+/*!
+ * \brief A cache over the raster files referenced by the \c IMAGE
+ * entities of a document, keyed by filename.
+ */
+typedef struct
+dxf_image_cache
+{
+        DxfSymbolTable *index;
+                /*!< hash map from filename to \c DxfImageCacheEntry. */
+        DxfImageCacheEntry *entries;
+                /*!< the entries, most recently added first. */
+        size_t length;
+                /*!< number of entries in the cache. */
+} DxfImageCache;
+
+
+DxfImageCache *
+dxf_image_cache_new ();
+DxfImageCacheEntry *
+dxf_image_cache_map
+(
+        DxfImageCache *cache,
+        const char *filename
+);
+DxfImageCacheEntry *
+dxf_image_cache_find
+(
+        DxfImageCache *cache,
+        const char *filename
+);
+void
+dxf_image_cache_free
+(
+        DxfImageCache *cache
+);
+
+
+#endif /* LIBDXF_SRC_IMAGE_CACHE_H */
+
+
+/* EOF */
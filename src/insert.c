@@ -36,7 +36,11 @@
  */
 
 
+#include <pthread.h>
 #include "insert.h"
+#include "diag.h"
+#include "allocator.h"
+#include "util.h"
 
 
 /*!
@@ -60,7 +64,7 @@ dxf_insert_new ()
         size = sizeof (DxfInsert);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_insert = malloc (size)) == NULL)
+        if ((dxf_insert = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfInsert struct.\n")),
@@ -98,6 +102,11 @@ dxf_insert_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfInsert template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         /* Do some basic checks. */
         if (dxf_insert == NULL)
         {
@@ -113,34 +122,47 @@ dxf_insert_init
                 __FUNCTION__);
               return (NULL);
         }
-        dxf_insert->block_name = strdup ("");
-        dxf_insert->id_code = 0;
-        dxf_insert->linetype = strdup (DXF_DEFAULT_LINETYPE);
-        dxf_insert->layer = strdup (DXF_DEFAULT_LAYER);
-        dxf_insert->x0 = 0.0;
-        dxf_insert->y0 = 0.0;
-        dxf_insert->z0 = 0.0;
-        dxf_insert->elevation = 0.0;
-        dxf_insert->thickness = 0.0;
-        dxf_insert->linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
-        dxf_insert->visibility = DXF_DEFAULT_VISIBILITY;
-        dxf_insert->rel_x_scale = 1.0;
-        dxf_insert->rel_y_scale = 1.0;
-        dxf_insert->rel_z_scale = 1.0;
-        dxf_insert->column_spacing = 0.0;
-        dxf_insert->row_spacing = 0.0;
-        dxf_insert->rot_angle = 0.0;
-        dxf_insert->color = DXF_COLOR_BYLAYER;
-        dxf_insert->paperspace = DXF_MODELSPACE;
-        dxf_insert->attributes_follow = 0;
-        dxf_insert->columns = 0;
-        dxf_insert->rows = 0;
-        dxf_insert->extr_x0 = 0.0;
-        dxf_insert->extr_y0 = 0.0;
-        dxf_insert->extr_z0 = 0.0;
-        dxf_insert->dictionary_owner_soft = strdup ("");
-        dxf_insert->dictionary_owner_hard = strdup ("");
-        dxf_insert->next = NULL;
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.block_name = strdup ("");
+                template.block_def = NULL;
+                template.id_code = 0;
+                template.linetype = strdup (DXF_DEFAULT_LINETYPE);
+                template.layer = strdup (DXF_DEFAULT_LAYER);
+                template.x0 = 0.0;
+                template.y0 = 0.0;
+                template.z0 = 0.0;
+                template.elevation = 0.0;
+                template.thickness = 0.0;
+                template.linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
+                template.visibility = DXF_DEFAULT_VISIBILITY;
+                template.rel_x_scale = 1.0;
+                template.rel_y_scale = 1.0;
+                template.rel_z_scale = 1.0;
+                template.column_spacing = 0.0;
+                template.row_spacing = 0.0;
+                template.rot_angle = 0.0;
+                template.color = DXF_COLOR_BYLAYER;
+                template.paperspace = DXF_MODELSPACE;
+                template.attributes_follow = 0;
+                template.columns = 0;
+                template.rows = 0;
+                template.extr_x0 = 0.0;
+                template.extr_y0 = 0.0;
+                template.extr_z0 = 0.0;
+                template.dictionary_owner_soft = strdup ("");
+                template.dictionary_owner_hard = strdup ("");
+                template.next = NULL;
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (dxf_insert, &template, sizeof (DxfInsert));
+        dxf_insert->block_name = strdup (template.block_name);
+        dxf_insert->linetype = strdup (template.linetype);
+        dxf_insert->layer = strdup (template.layer);
+        dxf_insert->dictionary_owner_soft = strdup (template.dictionary_owner_soft);
+        dxf_insert->dictionary_owner_hard = strdup (template.dictionary_owner_hard);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -175,7 +197,7 @@ dxf_insert_read
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        char *temp_string = NULL;
+        char temp_string[DXF_MAX_STRING_LENGTH];
 
         /* Do some basic checks. */
         if (fp == NULL)
@@ -193,14 +215,13 @@ dxf_insert_read
                 dxf_insert = dxf_insert_new ();
                 dxf_insert = dxf_insert_init (dxf_insert);
         }
-        (fp->line_number)++;
-        fscanf (fp->fp, "%[^\n]", temp_string);
+        dxf_read_line (temp_string, fp);
         while (strcmp (temp_string, "0") != 0)
         {
                 if (ferror (fp->fp))
                 {
                         fprintf (stderr,
-                          (_("Error in %s () while reading from: %s in line: %d.\n")),
+                          (_("Error in %s () while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                         fclose (fp->fp);
                         return (NULL);
@@ -209,49 +230,48 @@ dxf_insert_read
                 {
                         /* Now follows a string containing a block name
                          * value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_insert->block_name);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
+                        free (dxf_insert->block_name);
+                        dxf_insert->block_name = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "5") == 0)
                 {
                         /* Now follows a string containing a sequential
                          * id number. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%x\n", &dxf_insert->id_code);
+                                                dxf_read_scanf (fp, "%x\n", &dxf_insert->id_code);
                 }
                 else if (strcmp (temp_string, "6") == 0)
                 {
                         /* Now follows a string containing a linetype
                          * name. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_insert->linetype);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
+                        free (dxf_insert->linetype);
+                        dxf_insert->linetype = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "8") == 0)
                 {
                         /* Now follows a string containing a layer name. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_insert->layer);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
+                        free (dxf_insert->layer);
+                        dxf_insert->layer = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "10") == 0)
                 {
                         /* Now follows a string containing the
                          * X-coordinate of the center point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_insert->x0);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_insert->x0);
                 }
                 else if (strcmp (temp_string, "20") == 0)
                 {
                         /* Now follows a string containing the
                          * Y-coordinate of the center point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_insert->y0);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_insert->y0);
                 }
                 else if (strcmp (temp_string, "30") == 0)
                 {
                         /* Now follows a string containing the
                          * Z-coordinate of the center point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_insert->z0);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_insert->z0);
                 }
                 else if ((fp->acad_version_number <= AutoCAD_11)
                         && (strcmp (temp_string, "38") == 0)
@@ -259,85 +279,73 @@ dxf_insert_read
                 {
                         /* Now follows a string containing the
                          * elevation. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_insert->elevation);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_insert->elevation);
                 }
                 else if (strcmp (temp_string, "39") == 0)
                 {
                         /* Now follows a string containing the
                          * thickness. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_insert->thickness);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_insert->thickness);
                 }
                 else if (strcmp (temp_string, "41") == 0)
                 {
                         /* Now follows a string containing the
                          * relative X-scale. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_insert->rel_x_scale);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_insert->rel_x_scale);
                 }
                 else if (strcmp (temp_string, "42") == 0)
                 {
                         /* Now follows a string containing the
                          * relative Y-scale. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_insert->rel_y_scale);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_insert->rel_y_scale);
                 }
                 else if (strcmp (temp_string, "43") == 0)
                 {
                         /* Now follows a string containing the
                          * relative Z-scale. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_insert->rel_z_scale);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_insert->rel_z_scale);
                 }
                 else if (strcmp (temp_string, "44") == 0)
                 {
                         /* Now follows a string containing the
                          * column spacing. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_insert->column_spacing);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_insert->column_spacing);
                 }
                 else if (strcmp (temp_string, "45") == 0)
                 {
                         /* Now follows a string containing the
                          * row spacing. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_insert->row_spacing);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_insert->row_spacing);
                 }
                 else if (strcmp (temp_string, "48") == 0)
                 {
                         /* Now follows a string containing the linetype
                          * scale. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_insert->linetype_scale);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_insert->linetype_scale);
                 }
                 else if (strcmp (temp_string, "50") == 0)
                 {
                         /* Now follows a string containing the
                          * rotation angle. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_insert->rot_angle);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_insert->rot_angle);
                 }
                 else if (strcmp (temp_string, "60") == 0)
                 {
                         /* Now follows a string containing the
                          * visibility value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%hd\n", &dxf_insert->visibility);
+                                                dxf_read_scanf (fp, "%hd\n", &dxf_insert->visibility);
                 }
                 else if (strcmp (temp_string, "62") == 0)
                 {
                         /* Now follows a string containing the
                          * color value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_insert->color);
+                                                dxf_read_scanf (fp, "%d\n", &dxf_insert->color);
                 }
                 else if (strcmp (temp_string, "66") == 0)
                 {
                         /* Now follows a string containing the
                          * attributes follow flag. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_insert->attributes_follow);
+                                                dxf_read_scanf (fp, "%d\n", &dxf_insert->attributes_follow);
                         /*!
                          * \todo After a set attributes_follow flag is
                          * detected, parsing of following entities should
@@ -348,35 +356,31 @@ dxf_insert_read
                 {
                         /* Now follows a string containing the
                          * paperspace value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_insert->paperspace);
+                                                dxf_read_scanf (fp, "%d\n", &dxf_insert->paperspace);
                 }
                 else if (strcmp (temp_string, "70") == 0)
                 {
                         /* Now follows a string containing the
                          * number of columns. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_insert->columns);
+                                                dxf_read_scanf (fp, "%d\n", &dxf_insert->columns);
                 }
                 else if (strcmp (temp_string, "71") == 0)
                 {
                         /* Now follows a string containing the
                          * number of rows. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_insert->rows);
+                                                dxf_read_scanf (fp, "%d\n", &dxf_insert->rows);
                 }
                 else if ((fp->acad_version_number >= AutoCAD_13)
                         && (strcmp (temp_string, "100") == 0))
                 {
                         /* Now follows a string containing the
                          * subclass marker value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", temp_string);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
                         if ((strcmp (temp_string, "AcDbEntity") != 0)
                         && (strcmp (temp_string, "AcDbBlockReference") != 0))
                         {
-                                fprintf (stderr,
-                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %d.\n")),
+                                dxf_diag_report (fp, DXF_DIAG_WARNING,
+                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                         }
                 }
@@ -384,50 +388,52 @@ dxf_insert_read
                 {
                         /* Now follows a string containing the
                          * X-value of the extrusion vector. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_insert->extr_x0);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_insert->extr_x0);
                 }
                 else if (strcmp (temp_string, "220") == 0)
                 {
                         /* Now follows a string containing the
                          * Y-value of the extrusion vector. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_insert->extr_y0);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_insert->extr_y0);
                 }
                 else if (strcmp (temp_string, "230") == 0)
                 {
                         /* Now follows a string containing the
                          * Z-value of the extrusion vector. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_insert->extr_z0);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_insert->extr_z0);
                 }
                 else if (strcmp (temp_string, "330") == 0)
                 {
                         /* Now follows a string containing Soft-pointer
                          * ID/handle to owner dictionary. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_insert->dictionary_owner_soft);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
+                        free (dxf_insert->dictionary_owner_soft);
+                        dxf_insert->dictionary_owner_soft = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "360") == 0)
                 {
                         /* Now follows a string containing Hard owner
                          * ID/handle to owner dictionary. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_insert->dictionary_owner_hard);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
+                        free (dxf_insert->dictionary_owner_hard);
+                        dxf_insert->dictionary_owner_hard = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "999") == 0)
                 {
                         /* Now follows a string containing a comment. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", temp_string);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
                         fprintf (stdout, "DXF comment: %s\n", temp_string);
                 }
                 else
                 {
-                        fprintf (stderr,
-                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %d.\n")),
+                        dxf_diag_report (fp, DXF_DIAG_WARNING,
+                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                 }
+                if (dxf_read_line (temp_string, fp) != 1)
+                {
+                        break;
+                }
         }
         /* Handle omitted members and/or illegal values. */
         if (strcmp (dxf_insert->linetype, "") == 0)
@@ -681,6 +687,58 @@ dxf_insert_write
 }
 
 
+/*!
+ * \brief Resolve the block references of a list of \c INSERT entities
+ * in one pass.
+ *
+ * Stores the block definition each \c block_name references into the
+ * \c block_def member, through a constant time lookup in the map built
+ * by \c dxf_block_index_build; an \c INSERT referencing a name the
+ * index does not hold keeps a \c NULL \c block_def.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when an
+ * error occurred.
+ */
+int
+dxf_insert_resolve_blocks
+(
+        DxfInsert *inserts_list,
+                /*!< pointer to a list of \c INSERT entities. */
+        DxfSymbolTable *block_index
+                /*!< the map built by \c dxf_block_index_build. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        DxfInsert *dxf_insert;
+
+        /* Do some basic checks. */
+        if (block_index == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        for (dxf_insert = inserts_list; dxf_insert != NULL;
+                dxf_insert = (DxfInsert *) dxf_insert->next)
+        {
+                if (dxf_insert->block_name == NULL)
+                {
+                        dxf_insert->block_def = NULL;
+                        continue;
+                }
+                dxf_insert->block_def = (struct DxfBlock *)
+                        dxf_symbol_table_find (block_index, dxf_insert->block_name);
+        }
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (EXIT_SUCCESS);
+}
+
+
 /*!
  * \brief Free the allocated memory for a DXF \c INSERT and all it's
  * data fields.
@@ -715,7 +773,7 @@ dxf_insert_free
         free (dxf_insert->block_name);
         free (dxf_insert->dictionary_owner_soft);
         free (dxf_insert->dictionary_owner_hard);
-        free (dxf_insert);
+        dxf_entity_dealloc (dxf_insert, sizeof (*dxf_insert));
         dxf_insert = NULL;
 #if DEBUG
         DXF_DEBUG_END
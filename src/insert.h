@@ -41,6 +41,7 @@
 
 
 #include "global.h"
+#include "symbol_table.h"
 
 
 /*!
@@ -104,6 +105,13 @@ dxf_insert
         /* Specific members for a DXF insert. */
         char *block_name;
                 /*!< group code = 2. */
+        struct DxfBlock *block_def;
+                /*!< the block definition the \c block_name references,
+                 * resolved in one pass by
+                 * \c dxf_insert_resolve_blocks, or \c NULL until
+                 * resolved.\n
+                 * The definition is referenced in place and not
+                 * owned. */
         double x0;
                 /*!< group code = 10\n
                  * base point. */
@@ -182,6 +190,12 @@ dxf_insert_write
         DxfInsert *dxf_insert
 );
 int
+dxf_insert_resolve_blocks
+(
+        DxfInsert *inserts_list,
+        DxfSymbolTable *block_index
+);
+int
 dxf_insert_free
 (
         DxfInsert *dxf_insert
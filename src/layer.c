@@ -36,7 +36,10 @@
  */
 
 
+#include <pthread.h>
 #include "layer.h"
+#include "diag.h"
+#include "allocator.h"
 
 
 /*!
@@ -59,7 +62,7 @@ dxf_layer_new ()
         size = sizeof (DxfLayer);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_layer = malloc (size)) == NULL)
+        if ((dxf_layer = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfLayer struct.\n")),
@@ -94,6 +97,11 @@ dxf_layer_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfLayer template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         /* Do some basic checks. */
         if (dxf_layer == NULL)
         {
@@ -109,18 +117,31 @@ dxf_layer_init
                 __FUNCTION__);
               return (NULL);
         }
-        dxf_layer->id_code = 0;
-        dxf_layer->layer_name = strdup ("");
-        dxf_layer->linetype = strdup (DXF_DEFAULT_LINETYPE);
-        dxf_layer->color = DXF_COLOR_BYLAYER;
-        dxf_layer->flag = 0;
-        dxf_layer->plotting_flag = 0;
-        dxf_layer->dictionary_owner_soft = strdup ("");
-        dxf_layer->material = strdup ("");
-        dxf_layer->dictionary_owner_hard = strdup ("");
-        dxf_layer->lineweight = 0;
-        dxf_layer->plot_style_name = strdup ("");
-        dxf_layer->next = NULL;
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.id_code = 0;
+                template.layer_name = strdup ("");
+                template.linetype = strdup (DXF_DEFAULT_LINETYPE);
+                template.color = DXF_COLOR_BYLAYER;
+                template.flag = 0;
+                template.plotting_flag = 0;
+                template.dictionary_owner_soft = strdup ("");
+                template.material = strdup ("");
+                template.dictionary_owner_hard = strdup ("");
+                template.lineweight = 0;
+                template.plot_style_name = strdup ("");
+                template.next = NULL;
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (dxf_layer, &template, sizeof (DxfLayer));
+        dxf_layer->layer_name = strdup (template.layer_name);
+        dxf_layer->linetype = strdup (template.linetype);
+        dxf_layer->dictionary_owner_soft = strdup (template.dictionary_owner_soft);
+        dxf_layer->material = strdup (template.material);
+        dxf_layer->dictionary_owner_hard = strdup (template.dictionary_owner_hard);
+        dxf_layer->plot_style_name = strdup (template.plot_style_name);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -151,7 +172,7 @@ dxf_layer_read
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        char *temp_string = NULL;
+        char temp_string[DXF_MAX_STRING_LENGTH];
 
         /* Do some basic checks. */
         if (fp == NULL)
@@ -176,7 +197,7 @@ dxf_layer_read
                 if (ferror (fp->fp))
                 {
                         fprintf (stderr,
-                          (_("Error in %s () while reading from: %s in line: %d.\n")),
+                          (_("Error in %s () while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                         fclose (fp->fp);
                         return (NULL);
@@ -186,14 +207,18 @@ dxf_layer_read
                         /* Now follows a string containing the layer
                          * name. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_layer->layer_name);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_layer->layer_name);
+                        dxf_layer->layer_name = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "6") == 0)
                 {
                         /* Now follows a string containing the linetype
                          * name. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_layer->linetype);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_layer->linetype);
+                        dxf_layer->linetype = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "62") == 0)
                 {
@@ -219,8 +244,8 @@ dxf_layer_read
                         if ((strcmp (temp_string, "AcDbSymbolTable") != 0)
                         && ((strcmp (temp_string, "AcDbLayerTableRecord") != 0)))
                         {
-                                fprintf (stderr,
-                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %d.\n")),
+                                dxf_diag_report (fp, DXF_DIAG_WARNING,
+                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                         }
                 }
@@ -236,20 +261,26 @@ dxf_layer_read
                         /* Now follows a string containing Soft-pointer
                          * ID/handle to owner dictionary. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_layer->dictionary_owner_soft);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_layer->dictionary_owner_soft);
+                        dxf_layer->dictionary_owner_soft = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "347") == 0)
                 {
                         /* Now follows a string containing the material. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_layer->material);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_layer->material);
+                        dxf_layer->material = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "360") == 0)
                 {
                         /* Now follows a string containing Hard owner
                          * ID/handle to owner dictionary. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_layer->dictionary_owner_hard);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_layer->dictionary_owner_hard);
+                        dxf_layer->dictionary_owner_hard = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "370") == 0)
                 {
@@ -263,7 +294,9 @@ dxf_layer_read
                         /* Now follows a string containing the plot style
                          * name. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_layer->plot_style_name);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_layer->plot_style_name);
+                        dxf_layer->plot_style_name = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "999") == 0)
                 {
@@ -274,8 +307,8 @@ dxf_layer_read
                 }
                 else
                 {
-                        fprintf (stderr,
-                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %d.\n")),
+                        dxf_diag_report (fp, DXF_DIAG_WARNING,
+                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                 }
         }
@@ -283,7 +316,7 @@ dxf_layer_read
         if (strcmp (dxf_layer->layer_name, "") == 0)
         {
                 fprintf (stderr,
-                  (_("Error in %s () found a bad layer name in: %s in line: %d.\n")),
+                  (_("Error in %s () found a bad layer name in: %s in line: %ld.\n")),
                   __FUNCTION__, fp->filename, fp->line_number);
                 fprintf (stderr,
                   (_("\tskipping layer.\n")));
@@ -435,7 +468,7 @@ dxf_layer_free
         free (dxf_layer->material);
         free (dxf_layer->dictionary_owner_hard);
         free (dxf_layer->plot_style_name);
-        free (dxf_layer);
+        dxf_entity_dealloc (dxf_layer, sizeof (*dxf_layer));
         dxf_layer = NULL;
 #if DEBUG
         DXF_DEBUG_END
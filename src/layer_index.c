@@ -0,0 +1,242 @@
+/*!
+ * \file layer_index.c
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Functions for a layer-name secondary index over parsed
+ * entities.
+ *
+ * Extracting one layer from a large drawing used to require a full
+ * traversal of every entity chain, so splitting a file into its
+ * layers cost one complete scan per layer.\n
+ * An index maintained at parse time (for instance from the streaming
+ * read callbacks) buckets entities by layer name as they arrive, so
+ * the per-layer entity list is ready the moment parsing finishes.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#include "global.h"
+#include "layer_index.h"
+
+
+/*!
+ * \brief Hash a layer name into a bucket number (FNV-1a).
+ */
+static size_t
+dxf_layer_index_hash
+(
+        const char *layer
+                /*!< the layer name. */
+)
+{
+        unsigned int hash;
+        const unsigned char *c;
+
+        hash = 2166136261u;
+        for (c = (const unsigned char *) layer; *c != '\0'; c++)
+        {
+                hash = (hash ^ *c) * 16777619u;
+        }
+        return (hash & (DXF_LAYER_INDEX_BUCKETS - 1));
+}
+
+
+/*!
+ * \brief Allocate an empty \c DxfLayerIndex.
+ *
+ * \return a pointer to the index, or \c NULL when no memory was
+ * allocated.
+ */
+DxfLayerIndex *
+dxf_layer_index_new ()
+{
+        DxfLayerIndex *index;
+
+        index = calloc (1, sizeof (DxfLayerIndex));
+        if (index == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+        }
+        return (index);
+}
+
+
+/*!
+ * \brief Insert an entity under its layer name into a
+ * \c DxfLayerIndex.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_layer_index_insert
+(
+        DxfLayerIndex *index,
+                /*!< the index to insert into. */
+        const char *layer,
+                /*!< the layer name of the entity. */
+        void *entity
+                /*!< the entity to index. */
+)
+{
+        DxfLayerEntry *entry;
+        size_t bucket;
+        size_t capacity;
+        void **entities;
+
+        if ((index == NULL) || (layer == NULL) || (entity == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        bucket = dxf_layer_index_hash (layer);
+        for (entry = index->buckets[bucket]; entry != NULL; entry = entry->next)
+        {
+                if (strcmp (entry->name, layer) == 0)
+                {
+                        break;
+                }
+        }
+        if (entry == NULL)
+        {
+                entry = malloc (sizeof (DxfLayerEntry));
+                if (entry == NULL)
+                {
+                        fprintf (stderr,
+                          (_("Error in %s () could not allocate memory.\n")),
+                          __FUNCTION__);
+                        return (EXIT_FAILURE);
+                }
+                entry->name = strdup (layer);
+                entry->length = 0;
+                entry->capacity = 0;
+                entry->entities = NULL;
+                entry->next = index->buckets[bucket];
+                index->buckets[bucket] = entry;
+                index->length++;
+        }
+        if (entry->length == entry->capacity)
+        {
+                capacity = (entry->capacity == 0) ? 64 : (entry->capacity * 2);
+                entities = realloc (entry->entities,
+                        capacity * sizeof (void *));
+                if (entities == NULL)
+                {
+                        fprintf (stderr,
+                          (_("Error in %s () could not allocate memory.\n")),
+                          __FUNCTION__);
+                        return (EXIT_FAILURE);
+                }
+                entry->entities = entities;
+                entry->capacity = capacity;
+        }
+        entry->entities[entry->length] = entity;
+        entry->length++;
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Look up the entities on a layer in a \c DxfLayerIndex.
+ *
+ * \return a pointer to the layer's entry, whose \c entities array
+ * holds all entities on that layer in parse order, or \c NULL when no
+ * entity was indexed under that layer name.
+ */
+DxfLayerEntry *
+dxf_layer_index_find
+(
+        DxfLayerIndex *index,
+                /*!< the index to search. */
+        const char *layer
+                /*!< the layer name to look up. */
+)
+{
+        DxfLayerEntry *entry;
+
+        if ((index == NULL) || (layer == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        for (entry = index->buckets[dxf_layer_index_hash (layer)];
+                entry != NULL;
+                entry = entry->next)
+        {
+                if (strcmp (entry->name, layer) == 0)
+                {
+                        return (entry);
+                }
+        }
+        return (NULL);
+}
+
+
+/*!
+ * \brief Free a \c DxfLayerIndex and all its entries.
+ *
+ * The indexed entities themselves are not touched.
+ */
+void
+dxf_layer_index_free
+(
+        DxfLayerIndex *index
+                /*!< the index to free. */
+)
+{
+        DxfLayerEntry *entry;
+        DxfLayerEntry *next;
+        size_t i;
+
+        if (index == NULL)
+        {
+                return;
+        }
+        for (i = 0; i < DXF_LAYER_INDEX_BUCKETS; i++)
+        {
+                entry = index->buckets[i];
+                while (entry != NULL)
+                {
+                        next = entry->next;
+                        free (entry->name);
+                        free (entry->entities);
+                        free (entry);
+                        entry = next;
+                }
+        }
+        free (index);
+}
+
+
+/* EOF */
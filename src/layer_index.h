@@ -0,0 +1,111 @@
+/*!
+ * \file layer_index.h
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Header for a layer-name secondary index over parsed entities.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#ifndef LIBDXF_SRC_LAYER_INDEX_H
+#define LIBDXF_SRC_LAYER_INDEX_H
+
+
+#include <stddef.h>
+
+
+/*!
+ * The number of buckets of a \c DxfLayerIndex; drawings rarely have
+ * more than a few hundred layers.
+ */
+#define DXF_LAYER_INDEX_BUCKETS 256
+
+
+/*!
+ * \brief The entities on one layer.
+ *
+ * Entries double as hash bucket nodes and as the per-layer result
+ * list: \c entities is a contiguous array of \c length pointers, ready
+ * to hand out without a scan.
+ */
+typedef struct
+dxf_layer_entry
+{
+        char *name;
+                /*!< the layer name; owned by the entry. */
+        size_t length;
+                /*!< number of entities on this layer. */
+        size_t capacity;
+                /*!< number of allocated entity pointers. */
+        void **entities;
+                /*!< the entities on this layer, in parse order. */
+        struct dxf_layer_entry *next;
+                /*!< pointer to the next entry in the same bucket, or
+                 * \c NULL. */
+} DxfLayerEntry;
+
+
+/*!
+ * \brief A hash index from layer names to the entities on that layer.
+ */
+typedef struct
+dxf_layer_index
+{
+        size_t length;
+                /*!< number of distinct layers. */
+        DxfLayerEntry *buckets[DXF_LAYER_INDEX_BUCKETS];
+                /*!< the bucket array. */
+} DxfLayerIndex;
+
+
+DxfLayerIndex *
+dxf_layer_index_new ();
+int
+dxf_layer_index_insert
+(
+        DxfLayerIndex *index,
+        const char *layer,
+        void *entity
+);
+DxfLayerEntry *
+dxf_layer_index_find
+(
+        DxfLayerIndex *index,
+        const char *layer
+);
+void
+dxf_layer_index_free
+(
+        DxfLayerIndex *index
+);
+
+
+#endif /* LIBDXF_SRC_LAYER_INDEX_H */
+
+
+/* EOF */
@@ -0,0 +1,248 @@
+/*!
+ * \file layer_registry.c
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Functions for a growable registry of layer names.
+ *
+ * Code that collected layer names into arrays sized by
+ * \c DXF_MAX_LAYERS either truncated drawings with more layers or
+ * wasted the full bound on drawings with a handful.\n
+ * A \c DxfLayerRegistry grows with the file: a compact array of
+ * pointers to interned names (see \c dxf_string_intern) in insertion
+ * order, and a \c DxfSymbolTable keyed by name keeping inserts
+ * amortized constant time and free of duplicates.\n
+ * Interning matters for paper space heavy drawings, where hundreds of
+ * viewports each freeze largely the same layers: every name is stored
+ * once no matter how many registries reference it.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#include "global.h"
+#include "config.h"
+#include "layer_registry.h"
+#include "util.h"
+
+
+/*!
+ * \brief Allocate an empty \c DxfLayerRegistry.
+ *
+ * \return a pointer to the registry, or \c NULL when no memory was
+ * allocated.
+ */
+DxfLayerRegistry *
+dxf_layer_registry_new ()
+{
+        DxfLayerRegistry *registry;
+
+        registry = calloc (1, sizeof (DxfLayerRegistry));
+        if (registry == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        registry->index = dxf_symbol_table_new ();
+        if (registry->index == NULL)
+        {
+                free (registry);
+                return (NULL);
+        }
+        return (registry);
+}
+
+
+/*!
+ * \brief Add a layer name to a \c DxfLayerRegistry.
+ *
+ * A name already present in the registry is not stored again.
+ *
+ * \return the insertion position of the name, or \c -1 when errors
+ * occurred.
+ */
+int
+dxf_layer_registry_add
+(
+        DxfLayerRegistry *registry,
+                /*!< the registry to add to. */
+        const char *name
+                /*!< the layer name to add. */
+)
+{
+        char **names;
+        size_t capacity;
+        int position;
+
+        if ((registry == NULL) || (name == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (-1);
+        }
+        position = dxf_layer_registry_find (registry, name);
+        if (position >= 0)
+        {
+                return (position);
+        }
+        if ((dxf_config_get ()->max_layers != 0)
+                && (registry->length >= dxf_config_get ()->max_layers))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () the configured layer limit was reached.\n")),
+                  __FUNCTION__);
+                return (-1);
+        }
+        if (registry->length == registry->capacity)
+        {
+                capacity = dxf_config_grow (dxf_config_get (),
+                        registry->capacity);
+                if (capacity == 0)
+                {
+                        capacity = 64;
+                }
+                names = realloc (registry->names, capacity * sizeof (char *));
+                if (names == NULL)
+                {
+                        fprintf (stderr,
+                          (_("Error in %s () could not allocate memory.\n")),
+                          __FUNCTION__);
+                        return (-1);
+                }
+                registry->names = names;
+                registry->capacity = capacity;
+        }
+        registry->names[registry->length] = dxf_string_intern (name);
+        if (registry->names[registry->length] == NULL)
+        {
+                return (-1);
+        }
+        /* positions are stored shifted by one, the symbol table treats
+         * a stored null pointer as "not present". */
+        if (dxf_symbol_table_insert (registry->index,
+                name,
+                (void *) (registry->length + 1)) != EXIT_SUCCESS)
+        {
+                return (-1);
+        }
+        position = (int) registry->length;
+        registry->length++;
+        return (position);
+}
+
+
+/*!
+ * \brief Look up the insertion position of a layer name in a
+ * \c DxfLayerRegistry.
+ *
+ * \return the insertion position of the name, or \c -1 when the name
+ * is not in the registry.
+ */
+int
+dxf_layer_registry_find
+(
+        DxfLayerRegistry *registry,
+                /*!< the registry to search. */
+        const char *name
+                /*!< the layer name to look up. */
+)
+{
+        void *record;
+
+        if ((registry == NULL) || (name == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (-1);
+        }
+        record = dxf_symbol_table_find (registry->index, name);
+        if (record == NULL)
+        {
+                return (-1);
+        }
+        return ((int) ((size_t) record - 1));
+}
+
+
+/*!
+ * \brief Fetch a layer name by insertion position from a
+ * \c DxfLayerRegistry.
+ *
+ * \return a pointer to the name, valid as long as the registry lives,
+ * or \c NULL when the position is out of range.
+ */
+const char *
+dxf_layer_registry_get
+(
+        DxfLayerRegistry *registry,
+                /*!< the registry to fetch from. */
+        size_t position
+                /*!< the insertion position of the name. */
+)
+{
+        if (registry == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        if (position >= registry->length)
+        {
+                return (NULL);
+        }
+        return (registry->names[position]);
+}
+
+
+/*!
+ * \brief Free a \c DxfLayerRegistry.
+ *
+ * The names live in the shared string pool (see \c dxf_string_intern)
+ * and are not touched.
+ */
+void
+dxf_layer_registry_free
+(
+        DxfLayerRegistry *registry
+                /*!< the registry to free. */
+)
+{
+        if (registry == NULL)
+        {
+                return;
+        }
+        free (registry->names);
+        dxf_symbol_table_free (registry->index);
+        free (registry);
+}
+
+
+/* EOF */
@@ -0,0 +1,83 @@
+/*!
+ * \file layer_registry.h
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Header for a growable registry of layer names.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#ifndef LIBDXF_SRC_LAYER_REGISTRY_H
+#define LIBDXF_SRC_LAYER_REGISTRY_H
+
+
+#include <stddef.h>
+#include "symbol_table.h"
+
+
+/*!
+ * \brief A growable registry of layer names.
+ *
+ * Holds the names in insertion order in a contiguous array that grows
+ * with the file instead of being sized by a compile time bound, with a
+ * \c DxfSymbolTable alongside for duplicate detection, so an insert
+ * costs amortized constant time.
+ */
+typedef struct
+dxf_layer_registry
+{
+        char **names;
+                /*!< the layer names in insertion order; the strings
+                 * live in the shared string pool (see
+                 * \c dxf_string_intern), so every registry freezing
+                 * the same layers shares one copy of each name. */
+        size_t length;
+                /*!< number of names in the registry. */
+        size_t capacity;
+                /*!< number of allocated name slots. */
+        DxfSymbolTable *index;
+                /*!< hash map from name to insertion position. */
+} DxfLayerRegistry;
+
+
+DxfLayerRegistry *
+dxf_layer_registry_new ();
+int
+dxf_layer_registry_add (DxfLayerRegistry *registry, const char *name);
+int
+dxf_layer_registry_find (DxfLayerRegistry *registry, const char *name);
+const char *
+dxf_layer_registry_get (DxfLayerRegistry *registry, size_t position);
+void
+dxf_layer_registry_free (DxfLayerRegistry *registry);
+
+
+#endif /* LIBDXF_SRC_LAYER_REGISTRY_H */
+
+
+/* EOF */
@@ -0,0 +1,426 @@
+/*!
+ * \file lazy.c
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Functions for lazy entity materialization with offset
+ * records.
+ *
+ * Most pipelines touch only a small fraction of the entities in a
+ * drawing, yet a full parse builds (and allocates strings for) every
+ * single one.\n
+ * A lazy scan instead records a compact {type, offset, length, layer,
+ * handle} tuple per entity and defers building the wide entity struct
+ * until a record is first accessed, cutting both parse time and peak
+ * memory for selective jobs.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#include "lazy.h"
+#include "util.h"
+#include "entities.h"
+
+
+/*!
+ * \brief Append a fresh record to a \c DxfLazyTable.
+ *
+ * \return a pointer to the zeroed record, or \c NULL when no memory
+ * was allocated.
+ */
+static DxfLazyRecord *
+dxf_lazy_table_append
+(
+        DxfLazyTable *table
+                /*!< the table to append to. */
+)
+{
+        DxfLazyRecord *records;
+        size_t capacity;
+
+        if (table->length == table->capacity)
+        {
+                capacity = (table->capacity == 0) ? 1024 : (table->capacity * 2);
+                records = realloc (table->records,
+                        capacity * sizeof (DxfLazyRecord));
+                if (records == NULL)
+                {
+                        fprintf (stderr,
+                          (_("Error in %s () could not allocate memory.\n")),
+                          __FUNCTION__);
+                        return (NULL);
+                }
+                table->records = records;
+                table->capacity = capacity;
+        }
+        memset (&table->records[table->length], 0, sizeof (DxfLazyRecord));
+        return (&table->records[table->length++]);
+}
+
+
+/*!
+ * \brief Scan the \c ENTITIES section into a table of compact offset
+ * records.
+ *
+ * The last line read from file contained the string "ENTITIES".\n
+ * Instead of parsing every entity into its wide struct, only the type
+ * name, the file offset and length of the record, the layer name and
+ * the handle are captured; everything else is skipped over.\n
+ * Records are materialized individually, and only when accessed, with
+ * \c dxf_lazy_materialize.
+ *
+ * \note The scan seeks on the underlying \c FILE stream and therefore
+ * requires the plain stdio input mode; buffered and mapped input keep
+ * their own read position which \c ftell does not reflect.
+ *
+ * \return a pointer to the filled table, or \c NULL when errors
+ * occurred.
+ */
+DxfLazyTable *
+dxf_lazy_table_read
+(
+        DxfFile *fp
+                /*!< DXF file pointer to an input file (or device). */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        char temp_string[DXF_MAX_STRING_LENGTH];
+        char value_string[DXF_MAX_STRING_LENGTH];
+        DxfLazyTable *table;
+        DxfLazyRecord *record;
+        long position;
+
+        /* Do some basic checks. */
+        if (fp == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL file pointer was passed.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        if ((fp->read_buffer != NULL) || (fp->mmap_base != NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () requires the plain stdio input mode.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        table = calloc (1, sizeof (DxfLazyTable));
+        if (table == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        /* The first "  0" group code announcing an entity. */
+        if (dxf_read_line (temp_string, fp) < 1)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () while reading from: %s in line: %ld.\n")),
+                  __FUNCTION__, fp->filename, fp->line_number);
+                free (table);
+                return (NULL);
+        }
+        for (;;)
+        {
+                /* Now follows the entity name. */
+                if (dxf_read_line (temp_string, fp) < 1)
+                {
+                        break;
+                }
+                if (strcmp (temp_string, "ENDSEC") == 0)
+                {
+                        break;
+                }
+                record = dxf_lazy_table_append (table);
+                if (record == NULL)
+                {
+                        dxf_lazy_table_free (table);
+                        return (NULL);
+                }
+                strncpy (record->type, temp_string, DXF_LAZY_TYPE_LENGTH - 1);
+                record->offset = ftell (fp->fp);
+                record->line_number = fp->line_number;
+                /* Skim the group code / value pairs, capturing only
+                 * the handle and the layer name. */
+                for (;;)
+                {
+                        position = ftell (fp->fp);
+                        if (dxf_read_line (temp_string, fp) < 1)
+                        {
+                                record->length = position - record->offset;
+                                break;
+                        }
+                        if (strcmp (temp_string, "0") == 0)
+                        {
+                                record->length = position - record->offset;
+                                break;
+                        }
+                        if (dxf_read_line (value_string, fp) < 1)
+                        {
+                                record->length = ftell (fp->fp) - record->offset;
+                                break;
+                        }
+                        if (strcmp (temp_string, "5") == 0)
+                        {
+                                record->id_code = (int) strtol (value_string, NULL, 16);
+                        }
+                        else if (strcmp (temp_string, "8") == 0)
+                        {
+                                record->layer = strdup (value_string);
+                        }
+                }
+                if (temp_string[0] == '\0')
+                {
+                        /* End of file. */
+                        break;
+                }
+        }
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (table);
+}
+
+
+/*!
+ * \brief Materialize the full entity struct behind a lazy record.
+ *
+ * On the first access the file is repositioned to the record's offset
+ * and the regular \c *_read function builds the entity; subsequent
+ * accesses return the cached struct.\n
+ * The entity is owned by the table and released by
+ * \c dxf_lazy_table_free.
+ *
+ * \return a pointer to the entity struct (cast it according to the
+ * record's \c type), or \c NULL when errors occurred or the type has
+ * no reader.
+ */
+void *
+dxf_lazy_materialize
+(
+        DxfFile *fp,
+                /*!< DXF file pointer used for the lazy scan; must
+                 * still be open. */
+        DxfLazyTable *table,
+                /*!< the table holding the record. */
+        size_t index
+                /*!< index of the record to materialize. */
+)
+{
+        DxfLazyRecord *record;
+
+        if ((fp == NULL) || (table == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        if (index >= table->length)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () an out of range index was passed.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        record = &table->records[index];
+        if (record->entity != NULL)
+        {
+                return (record->entity);
+        }
+        if (fseek (fp->fp, record->offset, SEEK_SET) != 0)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () while seeking in: %s.\n")),
+                  __FUNCTION__, fp->filename);
+                return (NULL);
+        }
+        fp->line_number = record->line_number;
+        if (strcmp (record->type, "3DFACE") == 0)
+        {
+                record->entity = dxf_3dface_read (fp,
+                        dxf_3dface_init (dxf_3dface_new ()));
+        }
+        else if (strcmp (record->type, "ARC") == 0)
+        {
+                record->entity = dxf_arc_read (fp,
+                        dxf_arc_init (dxf_arc_new ()));
+        }
+        else if (strcmp (record->type, "CIRCLE") == 0)
+        {
+                record->entity = dxf_circle_read (fp,
+                        dxf_circle_init (dxf_circle_new ()));
+        }
+        else if (strcmp (record->type, "ELLIPSE") == 0)
+        {
+                record->entity = dxf_ellipse_read (fp,
+                        dxf_ellipse_init (dxf_ellipse_new ()));
+        }
+        else if (strcmp (record->type, "INSERT") == 0)
+        {
+                record->entity = dxf_insert_read (fp,
+                        dxf_insert_init (dxf_insert_new ()));
+        }
+        else if (strcmp (record->type, "LINE") == 0)
+        {
+                record->entity = dxf_line_read (fp,
+                        dxf_line_init (dxf_line_new ()));
+        }
+        else if (strcmp (record->type, "LWPOLYLINE") == 0)
+        {
+                record->entity = dxf_lwpolyline_read (fp,
+                        dxf_lwpolyline_init (dxf_lwpolyline_new ()));
+        }
+        else if (strcmp (record->type, "POINT") == 0)
+        {
+                record->entity = dxf_point_read (fp,
+                        dxf_point_init (dxf_point_new ()));
+        }
+        else if (strcmp (record->type, "POLYLINE") == 0)
+        {
+                record->entity = dxf_polyline_read (fp,
+                        dxf_polyline_init (dxf_polyline_new ()));
+        }
+        else if (strcmp (record->type, "SEQEND") == 0)
+        {
+                record->entity = dxf_seqend_read (fp,
+                        dxf_seqend_init (dxf_seqend_new ()));
+        }
+        else if (strcmp (record->type, "SOLID") == 0)
+        {
+                record->entity = dxf_solid_read (fp,
+                        dxf_solid_init (dxf_solid_new ()));
+        }
+        else if (strcmp (record->type, "TEXT") == 0)
+        {
+                record->entity = dxf_text_read (fp,
+                        dxf_text_init (dxf_text_new ()));
+        }
+        else if (strcmp (record->type, "VERTEX") == 0)
+        {
+                record->entity = dxf_vertex_read (fp,
+                        dxf_vertex_init (dxf_vertex_new ()));
+        }
+        else
+        {
+                fprintf (stderr,
+                  (_("Warning in %s () no reader for entity type %s.\n")),
+                  __FUNCTION__, record->type);
+        }
+        return (record->entity);
+}
+
+
+/*!
+ * \brief Free a \c DxfLazyTable, its records and any materialized
+ * entities.
+ */
+void
+dxf_lazy_table_free
+(
+        DxfLazyTable *table
+                /*!< the table to free. */
+)
+{
+        DxfLazyRecord *record;
+        size_t i;
+
+        if (table == NULL)
+        {
+                return;
+        }
+        for (i = 0; i < table->length; i++)
+        {
+                record = &table->records[i];
+                free (record->layer);
+                if (record->entity == NULL)
+                {
+                        continue;
+                }
+                if (strcmp (record->type, "3DFACE") == 0)
+                {
+                        dxf_3dface_free (record->entity);
+                }
+                else if (strcmp (record->type, "ARC") == 0)
+                {
+                        dxf_arc_free (record->entity);
+                }
+                else if (strcmp (record->type, "CIRCLE") == 0)
+                {
+                        dxf_circle_free (record->entity);
+                }
+                else if (strcmp (record->type, "ELLIPSE") == 0)
+                {
+                        dxf_ellipse_free (record->entity);
+                }
+                else if (strcmp (record->type, "INSERT") == 0)
+                {
+                        dxf_insert_free (record->entity);
+                }
+                else if (strcmp (record->type, "LINE") == 0)
+                {
+                        dxf_line_free (record->entity);
+                }
+                else if (strcmp (record->type, "LWPOLYLINE") == 0)
+                {
+                        dxf_lwpolyline_free (record->entity);
+                }
+                else if (strcmp (record->type, "POINT") == 0)
+                {
+                        dxf_point_free (record->entity);
+                }
+                else if (strcmp (record->type, "POLYLINE") == 0)
+                {
+                        dxf_polyline_free (record->entity);
+                }
+                else if (strcmp (record->type, "SEQEND") == 0)
+                {
+                        dxf_seqend_free (record->entity);
+                }
+                else if (strcmp (record->type, "SOLID") == 0)
+                {
+                        dxf_solid_free (record->entity);
+                }
+                else if (strcmp (record->type, "TEXT") == 0)
+                {
+                        dxf_text_free (record->entity);
+                }
+                else if (strcmp (record->type, "VERTEX") == 0)
+                {
+                        dxf_vertex_free (record->entity);
+                }
+        }
+        free (table->records);
+        free (table);
+}
+
+
+/* EOF */
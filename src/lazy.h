@@ -0,0 +1,116 @@
+/*!
+ * \file lazy.h
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Header for lazy entity materialization with offset records.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#ifndef LIBDXF_SRC_LAZY_H
+#define LIBDXF_SRC_LAZY_H
+
+
+#include "global.h"
+
+
+/*!
+ * The size of the entity type name field of a \c DxfLazyRecord.
+ */
+#define DXF_LAZY_TYPE_LENGTH 24
+
+
+/*!
+ * \brief A compact record of one entity seen during a lazy scan.
+ *
+ * Holds just enough to filter (type, layer, handle) and to come back
+ * for the rest (offset, length); the full entity struct is only built
+ * by \c dxf_lazy_materialize.
+ */
+typedef struct
+dxf_lazy_record
+{
+        char type[DXF_LAZY_TYPE_LENGTH];
+                /*!< the entity type name (e.g. "LINE"). */
+        long offset;
+                /*!< file offset of the first group code after the
+                 * entity name. */
+        long length;
+                /*!< number of bytes up to the next record boundary. */
+        long line_number;
+                /*!< line number of the entity name line. */
+        int id_code;
+                /*!< the entity handle (group code 5), or \c 0. */
+        char *layer;
+                /*!< the layer name (group code 8); owned by the
+                 * table. */
+        void *entity;
+                /*!< the materialized entity, or \c NULL while the
+                 * record has not been accessed. */
+} DxfLazyRecord;
+
+
+/*!
+ * \brief The compact entity records of one lazily scanned \c ENTITIES
+ * section.
+ */
+typedef struct
+dxf_lazy_table
+{
+        size_t length;
+                /*!< number of records. */
+        size_t capacity;
+                /*!< number of allocated records. */
+        DxfLazyRecord *records;
+                /*!< the record array, in file order. */
+} DxfLazyTable;
+
+
+DxfLazyTable *
+dxf_lazy_table_read
+(
+        DxfFile *fp
+);
+void *
+dxf_lazy_materialize
+(
+        DxfFile *fp,
+        DxfLazyTable *table,
+        size_t index
+);
+void
+dxf_lazy_table_free
+(
+        DxfLazyTable *table
+);
+
+
+#endif /* LIBDXF_SRC_LAZY_H */
+
+
+/* EOF */
@@ -32,7 +32,11 @@
  */
 
 
+#include <pthread.h>
 #include "line.h"
+#include "allocator.h"
+#include "field.h"
+#include "writer.h"
 
 
 /*!
@@ -61,7 +65,7 @@ dxf_line_new ()
         size = sizeof (DxfLine);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_line = malloc (size)) == NULL)
+        if ((dxf_line = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfLine struct.\n")),
@@ -101,6 +105,11 @@ dxf_line_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfLine template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         /* Do some basic checks. */
         if (dxf_line == NULL)
         {
@@ -116,27 +125,38 @@ dxf_line_init
                 __FUNCTION__);
               return (NULL);
         }
-        dxf_line->id_code = 0;
-        dxf_line->linetype = strdup (DXF_DEFAULT_LINETYPE);
-        dxf_line->layer = strdup (DXF_DEFAULT_LAYER);
-        dxf_line->x0 = 0.0;
-        dxf_line->y0 = 0.0;
-        dxf_line->z0 = 0.0;
-        dxf_line->x1 = 0.0;
-        dxf_line->y1 = 0.0;
-        dxf_line->z1 = 0.0;
-        dxf_line->extr_x0 = 0.0;
-        dxf_line->extr_y0 = 0.0;
-        dxf_line->extr_z0 = 0.0;
-        dxf_line->elevation = 0.0;
-        dxf_line->thickness = 0.0;
-        dxf_line->linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
-        dxf_line->visibility = DXF_DEFAULT_VISIBILITY;
-        dxf_line->color = DXF_COLOR_BYLAYER;
-        dxf_line->paperspace = DXF_MODELSPACE;
-        dxf_line->dictionary_owner_soft = strdup ("");
-        dxf_line->dictionary_owner_hard = strdup ("");
-        dxf_line->next = NULL;
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.id_code = 0;
+                template.linetype = strdup (DXF_DEFAULT_LINETYPE);
+                template.layer = strdup (DXF_DEFAULT_LAYER);
+                template.x0 = 0.0;
+                template.y0 = 0.0;
+                template.z0 = 0.0;
+                template.x1 = 0.0;
+                template.y1 = 0.0;
+                template.z1 = 0.0;
+                template.extr_x0 = 0.0;
+                template.extr_y0 = 0.0;
+                template.extr_z0 = 0.0;
+                template.elevation = 0.0;
+                template.thickness = 0.0;
+                template.linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
+                template.visibility = DXF_DEFAULT_VISIBILITY;
+                template.color = DXF_COLOR_BYLAYER;
+                template.paperspace = DXF_MODELSPACE;
+                template.dictionary_owner_soft = strdup ("");
+                template.dictionary_owner_hard = strdup ("");
+                template.next = NULL;
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (dxf_line, &template, sizeof (DxfLine));
+        dxf_line->linetype = strdup (template.linetype);
+        dxf_line->layer = strdup (template.layer);
+        dxf_line->dictionary_owner_soft = strdup (template.dictionary_owner_soft);
+        dxf_line->dictionary_owner_hard = strdup (template.dictionary_owner_hard);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -144,6 +164,70 @@ dxf_line_init
 }
 
 
+/*!
+ * \brief Field table mapping group codes to \c DxfLine members,
+ * sorted by group code.
+ */
+const DxfFieldSpec dxf_line_field_table[] =
+{
+        {5, DXF_FIELD_TYPE_HEX, offsetof (DxfLine, id_code), "id_code"},
+        {6, DXF_FIELD_TYPE_STRING, offsetof (DxfLine, linetype), "linetype"},
+        {8, DXF_FIELD_TYPE_STRING, offsetof (DxfLine, layer), "layer"},
+        {10, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfLine, x0), "x0"},
+        {11, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfLine, x1), "x1"},
+        {20, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfLine, y0), "y0"},
+        {21, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfLine, y1), "y1"},
+        {30, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfLine, z0), "z0"},
+        {31, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfLine, z1), "z1"},
+        {39, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfLine, thickness), "thickness"},
+        {48, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfLine, linetype_scale), "linetype_scale"},
+        {60, DXF_FIELD_TYPE_INT16, offsetof (DxfLine, visibility), "visibility"},
+        {62, DXF_FIELD_TYPE_INT, offsetof (DxfLine, color), "color"},
+        {67, DXF_FIELD_TYPE_INT, offsetof (DxfLine, paperspace), "paperspace"},
+        {210, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfLine, extr_x0), "extr_x0"},
+        {220, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfLine, extr_y0), "extr_y0"},
+        {230, DXF_FIELD_TYPE_DOUBLE, offsetof (DxfLine, extr_z0), "extr_z0"},
+        {330, DXF_FIELD_TYPE_STRING, offsetof (DxfLine, dictionary_owner_soft), "dictionary_owner_soft"},
+        {360, DXF_FIELD_TYPE_STRING, offsetof (DxfLine, dictionary_owner_hard), "dictionary_owner_hard"}
+};
+
+
+/*!
+ * Number of entries in \c dxf_line_field_table.
+ */
+const size_t dxf_line_field_table_length =
+        DXF_FIELD_TABLE_LENGTH (dxf_line_field_table);
+
+
+/*!
+ * \brief Handle the version dependent fields of a \c DxfLine entity
+ * which cannot be table driven.
+ */
+static int
+dxf_line_read_special
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an input file (or device). */
+        void *entity,
+                /*!< DXF line entity. */
+        int group_code
+                /*!< group code read by the shared parse loop. */
+)
+{
+        DxfLine *dxf_line = (DxfLine *) entity;
+
+        if ((group_code == 38)
+                && (fp->acad_version_number <= AutoCAD_11)
+                && (dxf_line->elevation != 0.0))
+        {
+                /* Now follows a string containing the elevation. */
+                                dxf_read_scanf (fp, "%lf\n", &dxf_line->elevation);
+                return (FOUND);
+        }
+        return (FAIL);
+}
+
+
 /*!
  * \brief Read data from a DXF file into an \c LINE entity.
  *
@@ -173,8 +257,6 @@ dxf_line_read
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        char *temp_string = NULL;
-
         /* Do some basic checks. */
         if (fp == NULL)
         {
@@ -191,201 +273,70 @@ dxf_line_read
                 dxf_line = dxf_line_new ();
                 dxf_line = dxf_line_init (dxf_line);
         }
-        (fp->line_number)++;
-        fscanf (fp->fp, "%[^\n]", temp_string);
-        while (strcmp (temp_string, "0") != 0)
+        if (dxf_field_read_all (fp, dxf_line, dxf_line_field_table,
+                DXF_FIELD_TABLE_LENGTH (dxf_line_field_table),
+                "AcDbEntity AcDbLine", dxf_line_read_special) != EXIT_SUCCESS)
         {
-                if (ferror (fp->fp))
-                {
-                        fprintf (stderr,
-                          (_("Error in %s () while reading from: %s in line: %d.\n")),
-                          __FUNCTION__, fp->filename, fp->line_number);
-                        fclose (fp->fp);
-                        return (NULL);
-                }
-                if (strcmp (temp_string, "5") == 0)
-                {
-                        /* Now follows a string containing a sequential
-                         * id number. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%x\n", &dxf_line->id_code);
-                }
-                else if (strcmp (temp_string, "6") == 0)
-                {
-                        /* Now follows a string containing a linetype
-                         * name. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_line->linetype);
-                }
-                else if (strcmp (temp_string, "8") == 0)
-                {
-                        /* Now follows a string containing a layer name. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_line->layer);
-                }
-                else if (strcmp (temp_string, "10") == 0)
-                {
-                        /* Now follows a string containing the
-                         * X-coordinate of the center point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_line->x0);
-                }
-                else if (strcmp (temp_string, "20") == 0)
-                {
-                        /* Now follows a string containing the
-                         * Y-coordinate of the center point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_line->y0);
-                }
-                else if (strcmp (temp_string, "30") == 0)
-                {
-                        /* Now follows a string containing the
-                         * Z-coordinate of the center point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_line->z0);
-                }
-                else if (strcmp (temp_string, "11") == 0)
-                {
-                        /* Now follows a string containing the
-                         * X-coordinate of the center point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_line->x1);
-                }
-                else if (strcmp (temp_string, "21") == 0)
-                {
-                        /* Now follows a string containing the
-                         * Y-coordinate of the center point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_line->y1);
-                }
-                else if (strcmp (temp_string, "31") == 0)
-                {
-                        /* Now follows a string containing the
-                         * Z-coordinate of the center point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_line->z1);
-                }
-                else if ((fp->acad_version_number <= AutoCAD_11)
-                        && (strcmp (temp_string, "38") == 0)
-                        && (dxf_line->elevation != 0.0))
-                {
-                        /* Now follows a string containing the
-                         * elevation. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_line->elevation);
-                }
-                else if (strcmp (temp_string, "39") == 0)
-                {
-                        /* Now follows a string containing the
-                         * thickness. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_line->thickness);
-                }
-                else if (strcmp (temp_string, "48") == 0)
-                {
-                        /* Now follows a string containing the linetype
-                         * scale. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_line->linetype_scale);
-                }
-                else if (strcmp (temp_string, "60") == 0)
-                {
-                        /* Now follows a string containing the
-                         * visibility value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%hd\n", &dxf_line->visibility);
-                }
-                else if (strcmp (temp_string, "62") == 0)
-                {
-                        /* Now follows a string containing the
-                         * color value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_line->color);
-                }
-                else if (strcmp (temp_string, "67") == 0)
-                {
-                        /* Now follows a string containing the
-                         * paperspace value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_line->paperspace);
-                }
-                else if ((fp->acad_version_number >= AutoCAD_13)
-                        && (strcmp (temp_string, "100") == 0))
-                {
-                        /* Now follows a string containing the
-                         * subclass marker value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", temp_string);
-                        if ((strcmp (temp_string, "AcDbEntity") != 0)
-                        && ((strcmp (temp_string, "AcDbLine") != 0)))
-                        {
-                                fprintf (stderr,
-                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %d.\n")),
-                                  __FUNCTION__, fp->filename, fp->line_number);
-                        }
-                }
-                else if (strcmp (temp_string, "210") == 0)
-                {
-                        /* Now follows a string containing the
-                         * X-value of the extrusion vector. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_line->extr_x0);
-                }
-                else if (strcmp (temp_string, "220") == 0)
-                {
-                        /* Now follows a string containing the
-                         * Y-value of the extrusion vector. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_line->extr_y0);
-                }
-                else if (strcmp (temp_string, "230") == 0)
-                {
-                        /* Now follows a string containing the
-                         * Z-value of the extrusion vector. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_line->extr_z0);
-                }
-                else if (strcmp (temp_string, "330") == 0)
-                {
-                        /* Now follows a string containing Soft-pointer
-                         * ID/handle to owner dictionary. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_line->dictionary_owner_soft);
-                }
-                else if (strcmp (temp_string, "360") == 0)
-                {
-                        /* Now follows a string containing Hard owner
-                         * ID/handle to owner dictionary. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_line->dictionary_owner_hard);
-                }
-                else if (strcmp (temp_string, "999") == 0)
+                return (NULL);
+        }
+        /* Handle omitted members and/or illegal values; trusted
+         * inputs are guaranteed complete and skip the repair. */
+        if (!fp->trusted)
+        {
+                if (strcmp (dxf_line->linetype, "") == 0)
                 {
-                        /* Now follows a string containing a comment. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", temp_string);
-                        fprintf (stdout, "DXF comment: %s\n", temp_string);
+                        dxf_line->linetype = strdup (DXF_DEFAULT_LINETYPE);
                 }
-                else
+                if (strcmp (dxf_line->layer, "") == 0)
                 {
-                        fprintf (stderr,
-                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %d.\n")),
-                          __FUNCTION__, fp->filename, fp->line_number);
+                        dxf_line->layer = strdup (DXF_DEFAULT_LAYER);
                 }
         }
-        /* Handle omitted members and/or illegal values. */
-        if (strcmp (dxf_line->linetype, "") == 0)
-        {
-                dxf_line->linetype = strdup (DXF_DEFAULT_LINETYPE);
-        }
-        if (strcmp (dxf_line->layer, "") == 0)
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (dxf_line);
+}
+
+
+/*!
+ * \brief Duplicate a DXF \c LINE entity.
+ *
+ * Driven by the field table; without an arena the duplicate owns deep
+ * copies of its strings and is released with \c dxf_line_free, with
+ * an arena the strings stay shared with the source and the duplicate
+ * is released with the arena (see \c dxf_field_dup).\n
+ * The duplicate is standalone: it is not linked behind the source.
+ *
+ * \return a pointer to the duplicate, or \c NULL when errors occurred.
+ */
+DxfLine *
+dxf_line_dup
+(
+        DxfLine *dxf_line,
+                /*!< DXF line entity to duplicate. */
+        struct dxf_arena *arena
+                /*!< the arena to allocate from, or \c NULL to allocate
+                 * with \c malloc. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        DxfLine *copy;
+
+        copy = dxf_field_dup (dxf_line, sizeof (DxfLine),
+                dxf_line_field_table,
+                DXF_FIELD_TABLE_LENGTH (dxf_line_field_table), arena);
+        if (copy == NULL)
         {
-                dxf_line->layer = strdup (DXF_DEFAULT_LAYER);
+                return (NULL);
         }
+        copy->next = NULL;
 #if DEBUG
         DXF_DEBUG_END
 #endif
-        return (dxf_line);
+        return (copy);
 }
 
 
@@ -450,11 +401,15 @@ dxf_line_write
                   dxf_entity_name);
                 dxf_line->layer = strdup (DXF_DEFAULT_LAYER);
         }
+        if (fp->write_version.acad_version_number != fp->acad_version_number)
+        {
+                dxf_write_version_init (fp);
+        }
         /* Start writing output. */
-        fprintf (fp->fp, "  0\n%s\n", dxf_entity_name);
+        dxf_write_group_string (fp, 0, dxf_entity_name);
         if (dxf_line->id_code != -1)
         {
-                fprintf (fp->fp, "  5\n%x\n", dxf_line->id_code);
+                dxf_write_group_hex (fp, 5, dxf_line->id_code);
         }
         /*!
          * \todo for version R14.\n
@@ -467,72 +422,72 @@ dxf_line_write
          * End of group, "}" (optional), with Group code 102.
          */
         if ((strcmp (dxf_line->dictionary_owner_soft, "") != 0)
-          && (fp->acad_version_number >= AutoCAD_14))
+          && fp->write_version.since_r14)
         {
-                fprintf (fp->fp, "102\n{ACAD_REACTORS\n");
-                fprintf (fp->fp, "330\n%s\n", dxf_line->dictionary_owner_soft);
-                fprintf (fp->fp, "102\n}\n");
+                dxf_write_group_string (fp, 102, "{ACAD_REACTORS");
+                dxf_write_group_string (fp, 330, dxf_line->dictionary_owner_soft);
+                dxf_write_group_string (fp, 102, "}");
         }
         if ((strcmp (dxf_line->dictionary_owner_hard, "") != 0)
-          && (fp->acad_version_number >= AutoCAD_14))
+          && fp->write_version.since_r14)
         {
-                fprintf (fp->fp, "102\n{ACAD_XDICTIONARY\n");
-                fprintf (fp->fp, "360\n%s\n", dxf_line->dictionary_owner_hard);
-                fprintf (fp->fp, "102\n}\n");
+                dxf_write_group_string (fp, 102, "{ACAD_XDICTIONARY");
+                dxf_write_group_string (fp, 360, dxf_line->dictionary_owner_hard);
+                dxf_write_group_string (fp, 102, "}");
         }
-        if (fp->acad_version_number >= AutoCAD_13)
+        if (fp->write_version.since_r13)
         {
-                fprintf (fp->fp, "100\nAcDbEntity\n");
+                dxf_write_group_string (fp, 100, "AcDbEntity");
         }
         if (dxf_line->paperspace == DXF_PAPERSPACE)
         {
-                fprintf (fp->fp, " 67\n%d\n", DXF_PAPERSPACE);
+                dxf_write_group_int (fp, 67, DXF_PAPERSPACE);
         }
-        fprintf (fp->fp, "  8\n%s\n", dxf_line->layer);
+        dxf_write_group_string (fp, 8, dxf_line->layer);
         if (strcmp (dxf_line->linetype, DXF_DEFAULT_LINETYPE) != 0)
         {
-                fprintf (fp->fp, "  6\n%s\n", dxf_line->linetype);
+                dxf_write_group_string (fp, 6, dxf_line->linetype);
         }
-        if ((fp->acad_version_number <= AutoCAD_11)
+        if (fp->write_version.until_r11
           && DXF_FLATLAND
           && (dxf_line->elevation != 0.0))
         {
-                fprintf (fp->fp, " 38\n%f\n", dxf_line->elevation);
+                dxf_write_group_double (fp, 38, dxf_line->elevation);
         }
         if (dxf_line->color != DXF_COLOR_BYLAYER)
         {
-                fprintf (fp->fp, " 62\n%d\n", dxf_line->color);
+                dxf_write_group_int (fp, 62, dxf_line->color);
         }
         if (dxf_line->linetype_scale != 1.0)
         {
-                fprintf (fp->fp, " 48\n%f\n", dxf_line->linetype_scale);
+                dxf_write_group_double (fp, 48, dxf_line->linetype_scale);
         }
         if (dxf_line->visibility != 0)
         {
-                fprintf (fp->fp, " 60\n%d\n", dxf_line->visibility);
+                dxf_write_group_int (fp, 60, dxf_line->visibility);
         }
-        if (fp->acad_version_number >= AutoCAD_13)
+        if (fp->write_version.since_r13)
         {
-                fprintf (fp->fp, "100\nAcDbLine\n");
+                dxf_write_group_string (fp, 100, "AcDbLine");
         }
         if (dxf_line->thickness != 0.0)
         {
-                fprintf (fp->fp, " 39\n%f\n", dxf_line->thickness);
+                dxf_write_group_double (fp, 39, dxf_line->thickness);
         }
-        fprintf (fp->fp, " 10\n%f\n", dxf_line->x0);
-        fprintf (fp->fp, " 20\n%f\n", dxf_line->y0);
-        fprintf (fp->fp, " 30\n%f\n", dxf_line->z0);
-        fprintf (fp->fp, " 11\n%f\n", dxf_line->x1);
-        fprintf (fp->fp, " 21\n%f\n", dxf_line->y1);
-        fprintf (fp->fp, " 31\n%f\n", dxf_line->z1);
-        if ((fp->acad_version_number >= AutoCAD_12)
+        dxf_write_group_double (fp, 10, dxf_line->x0);
+        dxf_write_group_double (fp, 20, dxf_line->y0);
+        dxf_write_group_double (fp, 30, dxf_line->z0);
+        dxf_write_group_double (fp, 11, dxf_line->x1);
+        dxf_write_group_double (fp, 21, dxf_line->y1);
+        dxf_write_group_double (fp, 31, dxf_line->z1);
+        if (fp->write_version.since_r12
                 && (dxf_line->extr_x0 != 0.0)
                 && (dxf_line->extr_y0 != 0.0)
                 && (dxf_line->extr_z0 != 1.0))
         {
-                fprintf (fp->fp, "210\n%f\n", dxf_line->extr_x0);
-                fprintf (fp->fp, "220\n%f\n", dxf_line->extr_y0);
-                fprintf (fp->fp, "230\n%f\n", dxf_line->extr_z0);
+                dxf_write_group_double (fp, 210, dxf_line->extr_x0);
+                dxf_write_group_double (fp, 220, dxf_line->extr_y0);
+                dxf_write_group_double (fp, 230, dxf_line->extr_z0);
         }
 #if DEBUG
         DXF_DEBUG_END
@@ -576,7 +531,7 @@ dxf_line_free
         free (dxf_line->layer);
         free (dxf_line->dictionary_owner_soft);
         free (dxf_line->dictionary_owner_hard);
-        free (dxf_line);
+        dxf_entity_dealloc (dxf_line, sizeof (*dxf_line));
         dxf_line = NULL;
 #if DEBUG
         DXF_DEBUG_END
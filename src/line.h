@@ -149,6 +149,13 @@ dxf_line_read
         DxfFile *fp,
         DxfLine *dxf_line
 );
+struct dxf_arena;
+DxfLine *
+dxf_line_dup
+(
+        DxfLine *dxf_line,
+        struct dxf_arena *arena
+);
 int
 dxf_line_write
 (
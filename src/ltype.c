@@ -32,7 +32,11 @@
  */
 
 
+#include <pthread.h>
 #include "ltype.h"
+#include "dash_cache.h"
+#include "diag.h"
+#include "allocator.h"
 
 
 /*!
@@ -58,7 +62,7 @@ dxf_ltype_new ()
         size = sizeof (DxfLType);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_ltype = malloc (size)) == NULL)
+        if ((dxf_ltype = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfArc struct.\n")),
@@ -99,6 +103,11 @@ dxf_ltype_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfLType template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         int i;
 
         /* Do some basic checks. */
@@ -116,27 +125,46 @@ dxf_ltype_init
                 __FUNCTION__);
               return (NULL);
         }
-        dxf_ltype->id_code = 0;
-        dxf_ltype->linetype_name = strdup ("");
-        dxf_ltype->description = strdup ("");
-        dxf_ltype->total_pattern_length = 0.0;
-        dxf_ltype->number_of_linetype_elements = 1;
-        for ((i = 0); (i < dxf_ltype->number_of_linetype_elements); i++)
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
         {
+                template.id_code = 0;
+                template.linetype_name = strdup ("");
+                template.description = strdup ("");
+                template.total_pattern_length = 0.0;
+                template.number_of_linetype_elements = 1;
+                for ((i = 0); (i < template.number_of_linetype_elements); i++)
+                {
+                        template.complex_text_string[i] = strdup ("");
+                        template.complex_x_offset[i] = 0.0;
+                        template.complex_y_offset[i] = 0.0;
+                        template.complex_scale[i] = 0.0;
+                        template.dash_length[i] = 0.0;
+                        template.complex_rotation[i] = 0.0;
+                        template.complex_element[i] = 1;
+                        template.complex_shape_number[i] = 0;
+                        template.complex_style_pointer[i] = strdup ("");
+                }
+                template.flag = 0;
+                template.alignment = 65;
+                template.dictionary_owner_soft = strdup ("");
+                template.dictionary_owner_hard = strdup ("");
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (dxf_ltype, &template, sizeof (DxfLType));
+        for ((i = 0); (i < template.number_of_linetype_elements); i++)
+        {
+                /* every instance owns its entries: the reader frees and
+                 * replaces them, so sharing the template strings would
+                 * leave dangling pointers in the template. */
                 dxf_ltype->complex_text_string[i] = strdup ("");
-                dxf_ltype->complex_x_offset[i] = 0.0;
-                dxf_ltype->complex_y_offset[i] = 0.0;
-                dxf_ltype->complex_scale[i] = 0.0;
-                dxf_ltype->dash_length[i] = 0.0;
-                dxf_ltype->complex_rotation[i] = 0.0;
-                dxf_ltype->complex_element[i] = 1;
-                dxf_ltype->complex_shape_number[i] = 0;
                 dxf_ltype->complex_style_pointer[i] = strdup ("");
         }
-        dxf_ltype->flag = 0;
-        dxf_ltype->alignment = 65;
-        dxf_ltype->dictionary_owner_soft = strdup ("");
-        dxf_ltype->dictionary_owner_hard = strdup ("");
+        dxf_ltype->linetype_name = strdup (template.linetype_name);
+        dxf_ltype->description = strdup (template.description);
+        dxf_ltype->dictionary_owner_soft = strdup (template.dictionary_owner_soft);
+        dxf_ltype->dictionary_owner_hard = strdup (template.dictionary_owner_hard);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -173,7 +201,7 @@ dxf_ltype_read
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        char *temp_string = NULL;
+        char temp_string[DXF_MAX_STRING_LENGTH];
         int element;
 
         /* Do some basic checks. */
@@ -200,7 +228,7 @@ dxf_ltype_read
                 if (ferror (fp->fp))
                 {
                         fprintf (stderr,
-                          (_("Error in %s () while reading from: %s in line: %d.\n")),
+                          (_("Error in %s () while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                         fclose (fp->fp);
                         return (NULL);
@@ -217,20 +245,26 @@ dxf_ltype_read
                         /* Now follows a string containing a linetype
                          * name. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_ltype->linetype_name);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_ltype->linetype_name);
+                        dxf_ltype->linetype_name = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "3") == 0)
                 {
                         /* Now follows a string containing a description. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_ltype->description);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_ltype->description);
+                        dxf_ltype->description = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "9") == 0)
                 {
                         /* Now follows a string containing a complex
                          * text string (multiple entries possible). */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_ltype->complex_text_string[element]);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_ltype->complex_text_string[element]);
+                        dxf_ltype->complex_text_string[element] = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "40") == 0)
                 {
@@ -322,21 +356,27 @@ dxf_ltype_read
                         /* Now follows a string containing Soft-pointer
                          * ID/handle to owner dictionary. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_ltype->dictionary_owner_soft);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_ltype->dictionary_owner_soft);
+                        dxf_ltype->dictionary_owner_soft = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "340") == 0)
                 {
                         /* Now follows a string containing a complex
                          * style pointer string (multiple entries possible). */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_ltype->complex_style_pointer[element]);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_ltype->complex_style_pointer[element]);
+                        dxf_ltype->complex_style_pointer[element] = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "360") == 0)
                 {
                         /* Now follows a string containing Hard owner
                          * ID/handle to owner dictionary. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_ltype->dictionary_owner_hard);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_ltype->dictionary_owner_hard);
+                        dxf_ltype->dictionary_owner_hard = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "999") == 0)
                 {
@@ -347,8 +387,8 @@ dxf_ltype_read
                 }
                 else
                 {
-                        fprintf (stderr,
-                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %d.\n")),
+                        dxf_diag_report (fp, DXF_DIAG_WARNING,
+                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                 }
         }
@@ -366,6 +406,9 @@ dxf_ltype_read
         {
                 dxf_ltype->alignment = 65;
         }
+        /* Share the dash pattern with every record carrying an equal
+         * pattern. */
+        dxf_ltype_dash_pattern (dxf_ltype);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -595,12 +638,14 @@ dxf_ltype_free
         free (dxf_ltype->description);
         for ((i = 0); (i <= dxf_ltype->number_of_linetype_elements); i++)
         {
+                free (dxf_ltype->complex_text_string[i]);
                 dxf_ltype->complex_text_string[i] = NULL;
+                free (dxf_ltype->complex_style_pointer[i]);
                 dxf_ltype->complex_style_pointer[i] = NULL;
         }
         free (dxf_ltype->dictionary_owner_soft);
         free (dxf_ltype->dictionary_owner_hard);
-        free (dxf_ltype);
+        dxf_entity_dealloc (dxf_ltype, sizeof (*dxf_ltype));
         dxf_ltype = NULL;
 #if DEBUG
         DXF_DEBUG_END
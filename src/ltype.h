@@ -39,6 +39,9 @@
 #include "global.h"
 
 
+struct dxf_dash_pattern;
+
+
 /*!
  * \brief DXF definition of an AutoCAD linetype.
  *
@@ -141,6 +144,10 @@ dxf_ltype
         char *dictionary_owner_hard;
                 /*!< Hard owner ID/handle to owner dictionary (optional).\n
                  * Group code = 360. */
+        const struct dxf_dash_pattern *pattern;
+                /*!< the shared interned dash pattern (see
+                 * dash_cache.h), or \c NULL when not interned.\n
+                 * Owned by the dash cache, not by the record. */
         struct DxfLType *next;
                 /*!< pointer to the next DxfLType.\n
                  * \c NULL in the last DxfLType. */
@@ -35,6 +35,10 @@
 
 
 #include "lwpolyline.h"
+#include "diag.h"
+#include "allocator.h"
+#include "util.h"
+#include "writer.h"
 
 
 /*!
@@ -54,7 +58,7 @@ dxf_lwpolyline_new ()
         size = sizeof (DxfLWPolyline);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_lwpolyline = malloc (size)) == NULL)
+        if ((dxf_lwpolyline = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfLWPolyline struct.\n")),
@@ -120,7 +124,8 @@ dxf_lwpolyline_init
         dxf_lwpolyline->extr_z0 = 0.0;
         dxf_lwpolyline->dictionary_owner_soft = strdup ("");
         dxf_lwpolyline->dictionary_owner_hard = strdup ("");
-        dxf_lwpolyline->vertices = (struct DxfVertex *) dxf_vertex_new ();
+        dxf_lwpolyline->vertices = NULL;
+        dxf_lwpolyline->vertices_size = 0;
         dxf_lwpolyline->next = NULL;
 #if DEBUG
         DXF_DEBUG_END
@@ -129,6 +134,73 @@ dxf_lwpolyline_init
 }
 
 
+/*!
+ * \brief Append a vertex to the contiguous vertex array of a DXF
+ * \c LWPOLYLINE entity.
+ *
+ * The array grows by doubling when no exact size is known; the reader
+ * sizes it exactly from group code 90 before the vertices follow.\n
+ * The new vertex starts with both widths at the constant width of the
+ * lwpolyline and a bulge of 0.
+ *
+ * \return a pointer to the appended vertex, or \c NULL when errors
+ * occurred.
+ */
+DxfLWPolylineVertex *
+dxf_lwpolyline_vertex_append
+(
+        DxfLWPolyline *dxf_lwpolyline
+                /*!< DXF light weight polyline entity. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        DxfLWPolylineVertex *vertices;
+        DxfLWPolylineVertex *vertex;
+        int vertices_size;
+
+        if (dxf_lwpolyline == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        if (dxf_lwpolyline->number_vertices >= dxf_lwpolyline->vertices_size)
+        {
+                vertices_size = (dxf_lwpolyline->vertices_size == 0) ? 8
+                        : (dxf_lwpolyline->vertices_size * 2);
+                if (vertices_size < dxf_lwpolyline->number_vertices + 1)
+                {
+                        vertices_size = dxf_lwpolyline->number_vertices + 1;
+                }
+                vertices = realloc (dxf_lwpolyline->vertices,
+                        vertices_size * sizeof (DxfLWPolylineVertex));
+                if (vertices == NULL)
+                {
+                        fprintf (stderr,
+                          (_("Error in %s () could not allocate memory.\n")),
+                          __FUNCTION__);
+                        return (NULL);
+                }
+                dxf_lwpolyline->vertices = vertices;
+                dxf_lwpolyline->vertices_size = vertices_size;
+        }
+        vertex = &dxf_lwpolyline->vertices[dxf_lwpolyline->number_vertices];
+        vertex->x0 = 0.0;
+        vertex->y0 = 0.0;
+        vertex->start_width = dxf_lwpolyline->constant_width;
+        vertex->end_width = dxf_lwpolyline->constant_width;
+        vertex->bulge = 0.0;
+        dxf_lwpolyline->number_vertices++;
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (vertex);
+}
+
+
 /*!
  * \brief Read data from a DXF file into an \c LWPOLYLINE entity.
  *
@@ -152,8 +224,10 @@ dxf_lwpolyline_read
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        char *temp_string = NULL;
-        DxfVertex *iter = NULL;
+        char temp_string[DXF_MAX_STRING_LENGTH];
+        DxfLWPolylineVertex *vertex = NULL;
+        DxfLWPolylineVertex *vertices;
+        int declared_vertices;
 
         /* Do some basic checks. */
         if (fp == NULL)
@@ -171,15 +245,16 @@ dxf_lwpolyline_read
                 dxf_lwpolyline = dxf_lwpolyline_new ();
                 dxf_lwpolyline = dxf_lwpolyline_init (dxf_lwpolyline);
         }
-        iter = (DxfVertex *) dxf_lwpolyline->vertices;
-        (fp->line_number)++;
-        fscanf (fp->fp, "%[^\n]", temp_string);
+        /* reset the vertex count but keep the allocated array, so a
+         * recycled scratch entity reuses its vertex storage. */
+        dxf_lwpolyline->number_vertices = 0;
+        dxf_read_line (temp_string, fp);
         while (strcmp (temp_string, "0") != 0)
         {
                 if (ferror (fp->fp))
                 {
                         fprintf (stderr,
-                          (_("Error in %s () while reading from: %s in line: %d.\n")),
+                          (_("Error in %s () while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                         fclose (fp->fp);
                         return (NULL);
@@ -188,35 +263,101 @@ dxf_lwpolyline_read
                 {
                         /* Now follows a string containing a sequential
                          * id number. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%x\n", &dxf_lwpolyline->id_code);
+                                                dxf_read_scanf (fp, "%x\n", &dxf_lwpolyline->id_code);
                 }
                 else if (strcmp (temp_string, "6") == 0)
                 {
                         /* Now follows a string containing a linetype
                          * name. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_lwpolyline->linetype);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
+                        free (dxf_lwpolyline->linetype);
+                        dxf_lwpolyline->linetype = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "8") == 0)
                 {
                         /* Now follows a string containing a layer name. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_lwpolyline->layer);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
+                        free (dxf_lwpolyline->layer);
+                        dxf_lwpolyline->layer = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "10") == 0)
                 {
-                        /* Now follows a string containing the
-                        * X-coordinate of a vertex. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &iter->x0);
+                        /* Now follow the vertices, usually an
+                         * uninterrupted run of 10/20 pairs with
+                         * optional 40/41/42 groups: read them in one
+                         * tight batch loop. */
+                        for (;;)
+                        {
+                                vertex = dxf_lwpolyline_vertex_append (dxf_lwpolyline);
+                                if (vertex == NULL)
+                                {
+                                        return (NULL);
+                                }
+                                                                dxf_read_scanf (fp, "%lf\n", &vertex->x0);
+                                if (dxf_read_line (temp_string, fp) != 1)
+                                {
+                                        strcpy (temp_string, "0");
+                                        break;
+                                }
+                                if (strcmp (temp_string, "20") == 0)
+                                {
+                                                                                dxf_read_scanf (fp, "%lf\n", &vertex->y0);
+                                        if (dxf_read_line (temp_string, fp) != 1)
+                                        {
+                                                strcpy (temp_string, "0");
+                                                break;
+                                        }
+                                }
+                                if (strcmp (temp_string, "40") == 0)
+                                {
+                                                                                dxf_read_scanf (fp, "%lf\n", &vertex->start_width);
+                                        if (dxf_read_line (temp_string, fp) != 1)
+                                        {
+                                                strcpy (temp_string, "0");
+                                                break;
+                                        }
+                                }
+                                if (strcmp (temp_string, "41") == 0)
+                                {
+                                                                                dxf_read_scanf (fp, "%lf\n", &vertex->end_width);
+                                        if (dxf_read_line (temp_string, fp) != 1)
+                                        {
+                                                strcpy (temp_string, "0");
+                                                break;
+                                        }
+                                }
+                                if (strcmp (temp_string, "42") == 0)
+                                {
+                                                                                dxf_read_scanf (fp, "%lf\n", &vertex->bulge);
+                                        if (dxf_read_line (temp_string, fp) != 1)
+                                        {
+                                                strcpy (temp_string, "0");
+                                                break;
+                                        }
+                                }
+                                if (strcmp (temp_string, "10") != 0)
+                                {
+                                        break;
+                                }
+                        }
+                        /* the tag following the batch is already in
+                         * temp_string. */
+                        continue;
                 }
                 else if (strcmp (temp_string, "20") == 0)
                 {
                         /* Now follows a string containing the
-                        * Y-coordinate of a vertex. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &iter->y0);
+                         * Y-coordinate of a vertex outside the usual
+                         * 10/20 pairing. */
+                        if (vertex == NULL)
+                        {
+                                vertex = dxf_lwpolyline_vertex_append (dxf_lwpolyline);
+                                if (vertex == NULL)
+                                {
+                                        return (NULL);
+                                }
+                        }
+                                                dxf_read_scanf (fp, "%lf\n", &vertex->y0);
                 }
                 else if ((fp->acad_version_number <= AutoCAD_11)
                         && (strcmp (temp_string, "38") == 0)
@@ -224,90 +365,112 @@ dxf_lwpolyline_read
                 {
                         /* Now follows a string containing the
                          * elevation. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_lwpolyline->elevation);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_lwpolyline->elevation);
                 }
                 else if (strcmp (temp_string, "39") == 0)
                 {
                         /* Now follows a string containing the
                          * thickness. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_lwpolyline->thickness);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_lwpolyline->thickness);
                 }
                 else if (strcmp (temp_string, "40") == 0)
                 {
                         /* Now follows a string containing the
                          * start width of the vertex. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &iter->start_width);
+                        if (vertex == NULL)
+                        {
+                                vertex = dxf_lwpolyline_vertex_append (dxf_lwpolyline);
+                                if (vertex == NULL)
+                                {
+                                        return (NULL);
+                                }
+                        }
+                                                dxf_read_scanf (fp, "%lf\n", &vertex->start_width);
                 }
                 else if (strcmp (temp_string, "41") == 0)
                 {
                         /* Now follows a string containing the
-                         * start width of the vertex. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &iter->end_width);
+                         * end width of the vertex. */
+                        if (vertex == NULL)
+                        {
+                                vertex = dxf_lwpolyline_vertex_append (dxf_lwpolyline);
+                                if (vertex == NULL)
+                                {
+                                        return (NULL);
+                                }
+                        }
+                                                dxf_read_scanf (fp, "%lf\n", &vertex->end_width);
                 }
                 else if (strcmp (temp_string, "42") == 0)
                 {
                         /* Now follows a string containing the bulge of
                          * the vertex. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &iter->bulge);
-                        /* The last member of the vertex is read.\n */
-                        /*! \todo The pointer administration needs to be checked for functionality. */
-                         /* Increment iter to next DxfVertex. */
-                        iter->next = (struct DxfVertex *) dxf_vertex_new ();
-                        iter = (DxfVertex *) iter->next;
+                        if (vertex == NULL)
+                        {
+                                vertex = dxf_lwpolyline_vertex_append (dxf_lwpolyline);
+                                if (vertex == NULL)
+                                {
+                                        return (NULL);
+                                }
+                        }
+                                                dxf_read_scanf (fp, "%lf\n", &vertex->bulge);
                 }
                 else if (strcmp (temp_string, "43") == 0)
                 {
                         /* Now follows a string containing the
                          * constant width. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_lwpolyline->constant_width);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_lwpolyline->constant_width);
                 }
                 else if (strcmp (temp_string, "48") == 0)
                 {
                         /* Now follows a string containing the linetype
                          * scale. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_lwpolyline->linetype_scale);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_lwpolyline->linetype_scale);
                 }
                 else if (strcmp (temp_string, "60") == 0)
                 {
                         /* Now follows a string containing the
                          * visibility value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%hd\n", &dxf_lwpolyline->visibility);
+                                                dxf_read_scanf (fp, "%hd\n", &dxf_lwpolyline->visibility);
                 }
                 else if (strcmp (temp_string, "62") == 0)
                 {
                         /* Now follows a string containing the
                          * color value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_lwpolyline->color);
+                                                dxf_read_scanf (fp, "%d\n", &dxf_lwpolyline->color);
                 }
                 else if (strcmp (temp_string, "67") == 0)
                 {
                         /* Now follows a string containing the
                          * paperspace value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_lwpolyline->paperspace);
+                                                dxf_read_scanf (fp, "%d\n", &dxf_lwpolyline->paperspace);
                 }
                 else if (strcmp (temp_string, "70") == 0)
                 {
                         /* Now follows a string containing the
                          * flag value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_lwpolyline->flag);
+                                                dxf_read_scanf (fp, "%d\n", &dxf_lwpolyline->flag);
                 }
                 else if (strcmp (temp_string, "90") == 0)
                 {
                         /* Now follows a string containing the number
-                         * of following vertices. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_lwpolyline->number_vertices);
+                         * of following vertices: size the vertex array
+                         * exactly so the batch loop never reallocates. */
+                                                dxf_read_scanf (fp, "%d\n", &declared_vertices);
+                        if (declared_vertices > dxf_lwpolyline->vertices_size)
+                        {
+                                vertices = realloc (dxf_lwpolyline->vertices,
+                                        declared_vertices * sizeof (DxfLWPolylineVertex));
+                                if (vertices == NULL)
+                                {
+                                        fprintf (stderr,
+                                          (_("Error in %s () could not allocate memory.\n")),
+                                          __FUNCTION__);
+                                        return (NULL);
+                                }
+                                dxf_lwpolyline->vertices = vertices;
+                                dxf_lwpolyline->vertices_size = declared_vertices;
+                        }
                 }
                 else if ((fp->acad_version_number >= AutoCAD_12)
                         && (strcmp (temp_string, "100") == 0))
@@ -317,62 +480,59 @@ dxf_lwpolyline_read
                          * version should probably be added here.
                          * Now follows a string containing the
                          * subclass marker value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", temp_string);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
                 }
                 else if (strcmp (temp_string, "210") == 0)
                 {
                         /* Now follows a string containing the
                          * X-value of the extrusion vector. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_lwpolyline->extr_x0);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_lwpolyline->extr_x0);
                 }
                 else if (strcmp (temp_string, "220") == 0)
                 {
                         /* Now follows a string containing the
                          * Y-value of the extrusion vector. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_lwpolyline->extr_y0);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_lwpolyline->extr_y0);
                 }
                 else if (strcmp (temp_string, "230") == 0)
                 {
                         /* Now follows a string containing the
                          * Z-value of the extrusion vector. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_lwpolyline->extr_z0);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_lwpolyline->extr_z0);
                 }
                 else if (strcmp (temp_string, "330") == 0)
                 {
                         /* Now follows a string containing Soft-pointer
                          * ID/handle to owner dictionary. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_lwpolyline->dictionary_owner_soft);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
+                        free (dxf_lwpolyline->dictionary_owner_soft);
+                        dxf_lwpolyline->dictionary_owner_soft = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "360") == 0)
                 {
                         /* Now follows a string containing Hard owner
                          * ID/handle to owner dictionary. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_lwpolyline->dictionary_owner_hard);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
+                        free (dxf_lwpolyline->dictionary_owner_hard);
+                        dxf_lwpolyline->dictionary_owner_hard = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "999") == 0)
                 {
                         /* Now follows a string containing a comment. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", temp_string);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
                         fprintf (stdout, "DXF comment: %s\n", temp_string);
                 }
                 else
                 {
-                        fprintf (stderr,
-                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %d.\n")),
+                        dxf_diag_report (fp, DXF_DIAG_WARNING,
+                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                 }
+                if (dxf_read_line (temp_string, fp) != 1)
+                {
+                        break;
+                }
         }
-        /*! \todo Free memory to the last (unused) vertex in the linked list. */
-
-        /* Set the pointer to the last (unused) vertex in the linked list to NULL. */
-        iter->next = NULL;
         /* Handle omitted members and/or illegal values. */
         if (strcmp (dxf_lwpolyline->linetype, "") == 0)
         {
@@ -410,7 +570,6 @@ dxf_lwpolyline_write
         DXF_DEBUG_BEGIN
 #endif
         char *dxf_entity_name = strdup ("LWPOLYLINE");
-        DxfVertex *iter = NULL;
 
         /* Do some basic checks. */
         if (fp == NULL)
@@ -447,11 +606,15 @@ dxf_lwpolyline_write
                   dxf_entity_name);
                 dxf_lwpolyline->layer = strdup (DXF_DEFAULT_LAYER);
         }
+        if (fp->write_version.acad_version_number != fp->acad_version_number)
+        {
+                dxf_write_version_init (fp);
+        }
         /* Start writing output. */
-        fprintf (fp->fp, "  0\n%s\n", dxf_entity_name);
+        dxf_write_group_string (fp, 0, dxf_entity_name);
         if (dxf_lwpolyline->id_code != -1)
         {
-                fprintf (fp->fp, "  5\n%x\n", dxf_lwpolyline->id_code);
+                dxf_write_group_hex (fp, 5, dxf_lwpolyline->id_code);
         }
         /*!
          * \todo for version R14.\n
@@ -464,80 +627,87 @@ dxf_lwpolyline_write
          * End of group, "}" (optional), with Group code 102.
          */
         if ((strcmp (dxf_lwpolyline->dictionary_owner_soft, "") != 0)
-          && (fp->acad_version_number >= AutoCAD_14))
+          && fp->write_version.since_r14)
         {
-                fprintf (fp->fp, "102\n{ACAD_REACTORS\n");
-                fprintf (fp->fp, "330\n%s\n", dxf_lwpolyline->dictionary_owner_soft);
-                fprintf (fp->fp, "102\n}\n");
+                dxf_write_group_string (fp, 102, "{ACAD_REACTORS");
+                dxf_write_group_string (fp, 330, dxf_lwpolyline->dictionary_owner_soft);
+                dxf_write_group_string (fp, 102, "}");
         }
         if ((strcmp (dxf_lwpolyline->dictionary_owner_hard, "") != 0)
-          && (fp->acad_version_number >= AutoCAD_14))
+          && fp->write_version.since_r14)
         {
-                fprintf (fp->fp, "102\n{ACAD_XDICTIONARY\n");
-                fprintf (fp->fp, "360\n%s\n", dxf_lwpolyline->dictionary_owner_hard);
-                fprintf (fp->fp, "102\n}\n");
+                dxf_write_group_string (fp, 102, "{ACAD_XDICTIONARY");
+                dxf_write_group_string (fp, 360, dxf_lwpolyline->dictionary_owner_hard);
+                dxf_write_group_string (fp, 102, "}");
         }
-        if (fp->acad_version_number >= AutoCAD_13)
+        if (fp->write_version.since_r13)
         {
-                fprintf (fp->fp, "100\nAcDbEntity\n");
+                dxf_write_group_string (fp, 100, "AcDbEntity");
         }
         if (dxf_lwpolyline->paperspace == DXF_PAPERSPACE)
         {
-                fprintf (fp->fp, " 67\n%d\n", DXF_PAPERSPACE);
+                dxf_write_group_int (fp, 67, DXF_PAPERSPACE);
         }
-        fprintf (fp->fp, "  8\n%s\n", dxf_lwpolyline->layer);
+        dxf_write_group_string (fp, 8, dxf_lwpolyline->layer);
         if (strcmp (dxf_lwpolyline->linetype, DXF_DEFAULT_LINETYPE) != 0)
         {
-                fprintf (fp->fp, "  6\n%s\n", dxf_lwpolyline->linetype);
+                dxf_write_group_string (fp, 6, dxf_lwpolyline->linetype);
         }
         if (dxf_lwpolyline->color != DXF_COLOR_BYLAYER)
         {
-                fprintf (fp->fp, " 62\n%d\n", dxf_lwpolyline->color);
+                dxf_write_group_int (fp, 62, dxf_lwpolyline->color);
         }
         if (dxf_lwpolyline->linetype_scale != 1.0)
         {
-                fprintf (fp->fp, " 48\n%f\n", dxf_lwpolyline->linetype_scale);
+                dxf_write_group_double (fp, 48, dxf_lwpolyline->linetype_scale);
         }
         if (dxf_lwpolyline->visibility != 0)
         {
-                fprintf (fp->fp, " 60\n%d\n", dxf_lwpolyline->visibility);
+                dxf_write_group_int (fp, 60, dxf_lwpolyline->visibility);
         }
-        if (fp->acad_version_number >= AutoCAD_13)
+        if (fp->write_version.since_r13)
         {
-                fprintf (fp->fp, "100\nAcDbPolyline\n");
+                dxf_write_group_string (fp, 100, "AcDbPolyline");
         }
-        fprintf (fp->fp, " 90\n%d\n", dxf_lwpolyline->number_vertices);
-        fprintf (fp->fp, " 70\n%d\n", dxf_lwpolyline->flag);
-        fprintf (fp->fp, " 43\n%f\n", dxf_lwpolyline->constant_width);
+        dxf_write_group_int (fp, 90, dxf_lwpolyline->number_vertices);
+        dxf_write_group_int (fp, 70, dxf_lwpolyline->flag);
+        dxf_write_group_double (fp, 43, dxf_lwpolyline->constant_width);
         if (dxf_lwpolyline->elevation != 0.0)
         {
-                fprintf (fp->fp, " 38\n%f\n", dxf_lwpolyline->elevation);
+                dxf_write_group_double (fp, 38, dxf_lwpolyline->elevation);
         }
         if (dxf_lwpolyline->thickness != 0.0)
         {
-                fprintf (fp->fp, " 39\n%f\n", dxf_lwpolyline->thickness);
+                dxf_write_group_double (fp, 39, dxf_lwpolyline->thickness);
         }
-        /* Start of writing (multiple) vertices. */
-        iter = (DxfVertex *) dxf_lwpolyline->vertices;
-        while (iter != NULL)
+        /* The vertex groups go through the dxf_write_group_* API like
+         * the fixed groups: the old fwrite batched fast path bypassed
+         * an attached buffered writer (see writer.h) and corrupted its
+         * output, and the writer buffers the groups just as well. */
+        if (dxf_lwpolyline->number_vertices > 0)
         {
-                fprintf (fp->fp, " 10\n%f\n", iter->x0);
-                fprintf (fp->fp, " 20\n%f\n", iter->y0);
-                if ((iter->start_width != dxf_lwpolyline->constant_width)
-                  || (iter->end_width != dxf_lwpolyline->constant_width))
+                DxfLWPolylineVertex *vertex;
+                int i;
+
+                for (i = 0; i < dxf_lwpolyline->number_vertices; i++)
                 {
-                        fprintf (fp->fp, " 40\n%f\n", iter->start_width);
-                        fprintf (fp->fp, " 41\n%f\n", iter->end_width);
+                        vertex = &dxf_lwpolyline->vertices[i];
+                        dxf_write_group_double (fp, 10, vertex->x0);
+                        dxf_write_group_double (fp, 20, vertex->y0);
+                        if ((vertex->start_width != dxf_lwpolyline->constant_width)
+                          || (vertex->end_width != dxf_lwpolyline->constant_width))
+                        {
+                                dxf_write_group_double (fp, 40, vertex->start_width);
+                                dxf_write_group_double (fp, 41, vertex->end_width);
+                        }
+                        dxf_write_group_double (fp, 42, vertex->bulge);
                 }
-                fprintf (fp->fp, " 42\n%f\n", iter->bulge);
-                iter = (DxfVertex *) iter->next;
         }
-        /* End of writing (multiple) vertices. */
-        if (fp->acad_version_number >= AutoCAD_12)
+        if (fp->write_version.since_r12)
         {
-                fprintf (fp->fp, "210\n%f\n", dxf_lwpolyline->extr_x0);
-                fprintf (fp->fp, "220\n%f\n", dxf_lwpolyline->extr_y0);
-                fprintf (fp->fp, "230\n%f\n", dxf_lwpolyline->extr_z0);
+                dxf_write_group_double (fp, 210, dxf_lwpolyline->extr_x0);
+                dxf_write_group_double (fp, 220, dxf_lwpolyline->extr_y0);
+                dxf_write_group_double (fp, 230, dxf_lwpolyline->extr_z0);
         }
 #if DEBUG
         DXF_DEBUG_END
@@ -573,7 +743,8 @@ dxf_lwpolyline_free
         }
         free (dxf_lwpolyline->linetype);
         free (dxf_lwpolyline->layer);
-        free (dxf_lwpolyline);
+        free (dxf_lwpolyline->vertices);
+        dxf_entity_dealloc (dxf_lwpolyline, sizeof (*dxf_lwpolyline));
         dxf_lwpolyline = NULL;
 #if DEBUG
         DXF_DEBUG_END
@@ -39,7 +39,39 @@
 
 
 #include "global.h"
-#include "vertex.h"
+
+
+/*!
+ * \brief Definition of a single vertex of a DXF light weight polyline
+ * entity.
+ *
+ * The vertices of a \c LWPOLYLINE live in one contiguous array of
+ * these records (see \c DxfLWPolyline), not in a linked list: group
+ * code 90 declares the vertex count up front, so the array is sized
+ * exactly and filled in file order.
+ */
+typedef struct
+dxf_lwpolyline_vertex
+{
+        double x0;
+                /*!< X-coordinate of the vertex.\n
+                 * Group code = 10. */
+        double y0;
+                /*!< Y-coordinate of the vertex.\n
+                 * Group code = 20. */
+        double start_width;
+                /*!< Start width of the segment leaving the vertex
+                 * (optional, defaults to the constant width).\n
+                 * Group code = 40. */
+        double end_width;
+                /*!< End width of the segment leaving the vertex
+                 * (optional, defaults to the constant width).\n
+                 * Group code = 41. */
+        double bulge;
+                /*!< Bulge of the segment leaving the vertex (optional,
+                 * default = 0).\n
+                 * Group code = 42. */
+} DxfLWPolylineVertex;
 
 
 /*!
@@ -131,11 +163,13 @@ dxf_lwpolyline
         double extr_z0;
                 /*!< DXF: Z value of extrusion direction (optional).\n
                  * Group code = 230. */
-        struct DxfVertex *vertices;
-                /*!< Pointer to the first DxfVertex of the lwpolyline.\n
-                 * \c NULL in the last DxfVertex.\n
-                 * \note Not all members of the DxfVertex struct are
-                 * used for lwpolylines. */
+        DxfLWPolylineVertex *vertices;
+                /*!< contiguous array of the vertices of the
+                 * lwpolyline, in file order, with \c number_vertices
+                 * valid entries.\n
+                 * \c NULL if there are no vertices. */
+        int vertices_size;
+                /*!< number of allocated entries in \c vertices. */
         struct DxfLWPolyline *next;
                 /*!< Pointer to the next DxfLWPolyline.\n
                  * \c NULL in the last DxfLWPolyline. */
@@ -149,6 +183,11 @@ dxf_lwpolyline_init
 (
         DxfLWPolyline *dxf_lwpolyline
 );
+DxfLWPolylineVertex *
+dxf_lwpolyline_vertex_append
+(
+        DxfLWPolyline *dxf_lwpolyline
+);
 DxfLWPolyline *
 dxf_lwpolyline_read
 (
@@ -0,0 +1,110 @@
+/*!
+ * \file memstats.c
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Functions for per-document memory usage accounting.
+ *
+ * A service that keeps many drawings in memory needs to know how many
+ * bytes a document actually holds: estimating from the file size is
+ * off by large factors between, say, a point cloud (small file, many
+ * structs) and a hatch heavy drawing (large file, deep boundary
+ * graphs).\n
+ * The allocation layers of the library already concentrate all entity
+ * and string memory — the size classed entity allocator, the string
+ * interning pool, the optional per-document arena and the read buffers
+ * of the file handle — so the figures are collected there and reported
+ * by category from one call.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#include "global.h"
+#include "memstats.h"
+#include "allocator.h"
+#include "arena.h"
+#include "util.h"
+
+
+/*!
+ * \brief Collect the memory held by the library for a document.
+ *
+ * The entity allocator and the string interning pool are shared by all
+ * documents of the process; their figures are reported as-is, so a
+ * caller enforcing a budget over a single document at a time sees the
+ * exact per-document bytes, while a caller holding several documents
+ * sees the combined footprint under those categories.\n
+ * The arena and read buffer figures are taken from \c fp and are
+ * per-document; pass a \c NULL \c fp for the process-wide categories
+ * only.
+ *
+ * \return \c EXIT_SUCCESS when done, and \c EXIT_FAILURE when
+ * \c stats was a \c NULL pointer.
+ */
+int
+dxf_document_memory_stats
+(
+        DxfFile *fp,
+                /*!< DXF file handle of the document, or \c NULL. */
+        DxfMemoryStats *stats
+                /*!< the figures are returned here. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        if (stats == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        memset (stats, 0, sizeof (DxfMemoryStats));
+        dxf_allocator_stats (&stats->entity_bytes,
+                &stats->entity_cached_bytes);
+        stats->string_bytes = dxf_string_intern_bytes ();
+        if (fp != NULL)
+        {
+                dxf_arena_stats (fp->arena, &stats->arena_reserved_bytes,
+                        &stats->arena_used_bytes);
+                stats->read_buffer_bytes = fp->read_buffer_size
+                        + fp->line_buffer_size;
+        }
+        stats->total_bytes = stats->entity_bytes
+                + stats->entity_cached_bytes
+                + stats->string_bytes
+                + stats->arena_reserved_bytes
+                + stats->read_buffer_bytes;
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (EXIT_SUCCESS);
+}
+
+
+/* EOF */
@@ -0,0 +1,88 @@
+/*!
+ * \file memstats.h
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Header for per-document memory usage accounting.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#ifndef LIBDXF_SRC_MEMSTATS_H
+#define LIBDXF_SRC_MEMSTATS_H
+
+
+#include <stddef.h>
+#include "global.h"
+
+
+/*!
+ * \brief Memory held by the library, in bytes, broken down by
+ * category.
+ */
+typedef struct
+dxf_memory_stats
+{
+        size_t entity_bytes;
+                /*!< bytes handed out to live entity structs — hatch
+                 * boundary graph nodes included — by the entity
+                 * allocator (see allocator.h). */
+        size_t entity_cached_bytes;
+                /*!< bytes retained on the entity allocator free lists
+                 * for recycling; returned to the system by
+                 * \c dxf_allocator_trim. */
+        size_t string_bytes;
+                /*!< bytes held by the string interning pool (see
+                 * \c dxf_string_intern). */
+        size_t arena_reserved_bytes;
+                /*!< bytes reserved from the system by the arena of the
+                 * document, block headers included; \c 0 when the
+                 * document reads without an arena. */
+        size_t arena_used_bytes;
+                /*!< arena bytes handed out to entities and strings. */
+        size_t read_buffer_bytes;
+                /*!< bytes held by the read buffers of the document
+                 * (the growable line buffer and the block read
+                 * buffer). */
+        size_t total_bytes;
+                /*!< the sum of all categories, the cached free list
+                 * bytes included. */
+} DxfMemoryStats;
+
+
+int
+dxf_document_memory_stats
+(
+        DxfFile *fp,
+        DxfMemoryStats *stats
+);
+
+
+#endif /* LIBDXF_SRC_MEMSTATS_H */
+
+
+/* EOF */
@@ -32,7 +32,10 @@
  */
 
 
+#include <pthread.h>
 #include "mtext.h"
+#include "diag.h"
+#include "allocator.h"
 
 
 /*!
@@ -55,7 +58,7 @@ dxf_mtext_new ()
         size = sizeof (DxfMtext);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_mtext = malloc (size)) == NULL)
+        if ((dxf_mtext = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfMtext struct.\n")),
@@ -92,6 +95,11 @@ dxf_mtext_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfMtext template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         int i;
 
         /* Do some basic checks. */
@@ -109,48 +117,69 @@ dxf_mtext_init
                 __FUNCTION__);
               return (NULL);
         }
-        dxf_mtext->id_code = 0;
-        dxf_mtext->text_value = strdup ("");
-        for (i = 1; i < DXF_MAX_PARAM; i++)
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
         {
+                template.id_code = 0;
+                template.text_value = strdup ("");
+                for (i = 1; i < DXF_MAX_PARAM; i++)
+                {
+                        template.text_additional_value[i] = strdup ("");
+                }
+                template.linetype = strdup (DXF_DEFAULT_LINETYPE);
+                template.text_style = strdup ("");
+                template.layer = strdup (DXF_DEFAULT_LAYER);
+                template.x0 = 0.0;
+                template.y0 = 0.0;
+                template.z0 = 0.0;
+                template.x1 = 0.0;
+                template.y1 = 0.0;
+                template.z1 = 0.0;
+                template.height = 0.0;
+                template.rectangle_width = 0.0;
+                template.horizontal_width = 0.0;
+                template.rectangle_height = 0.0;
+                template.spacing_factor = 0.0;
+                template.box_scale = 0.0;
+                template.column_width = 0.0;
+                template.column_gutter = 0.0;
+                template.column_heights = 0.0;
+                template.rot_angle = 0.0;
+                template.color = DXF_COLOR_BYLAYER;
+                template.background_color = 0;
+                template.paperspace = DXF_MODELSPACE;
+                template.attachment_point = 0;
+                template.drawing_direction = 0;
+                template.spacing_style = 0;
+                template.column_type = 0;
+                template.column_count = 0;
+                template.column_flow = 0;
+                template.column_autoheight = 0;
+                template.background_fill = 0;
+                template.extr_x0 = 0.0;
+                template.extr_y0 = 0.0;
+                template.extr_z0 = 0.0;
+                template.background_color_rgb = 0;
+                template.background_color_name = strdup ("");
+                template.background_transparency = 0;
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (dxf_mtext, &template, sizeof (DxfMtext));
+        for (i = 0; i < DXF_MAX_PARAM; i++)
+        {
+                /* every instance owns its entries: the per instance
+                 * free would free shared template strings twice. */
                 dxf_mtext->text_additional_value[i] = strdup ("");
         }
-        dxf_mtext->linetype = strdup (DXF_DEFAULT_LINETYPE);
-        dxf_mtext->text_style = strdup ("");
-        dxf_mtext->layer = strdup (DXF_DEFAULT_LAYER);
-        dxf_mtext->x0 = 0.0;
-        dxf_mtext->y0 = 0.0;
-        dxf_mtext->z0 = 0.0;
-        dxf_mtext->x1 = 0.0;
-        dxf_mtext->y1 = 0.0;
-        dxf_mtext->z1 = 0.0;
-        dxf_mtext->height = 0.0;
-        dxf_mtext->rectangle_width = 0.0;
-        dxf_mtext->horizontal_width = 0.0;
-        dxf_mtext->rectangle_height = 0.0;
-        dxf_mtext->spacing_factor = 0.0;
-        dxf_mtext->box_scale = 0.0;
-        dxf_mtext->column_width = 0.0;
-        dxf_mtext->column_gutter = 0.0;
-        dxf_mtext->column_heights = 0.0;
-        dxf_mtext->rot_angle = 0.0;
-        dxf_mtext->color = DXF_COLOR_BYLAYER;
-        dxf_mtext->background_color = 0;
-        dxf_mtext->paperspace = DXF_MODELSPACE;
-        dxf_mtext->attachment_point = 0;
-        dxf_mtext->drawing_direction = 0;
-        dxf_mtext->spacing_style = 0;
-        dxf_mtext->column_type = 0;
-        dxf_mtext->column_count = 0;
-        dxf_mtext->column_flow = 0;
-        dxf_mtext->column_autoheight = 0;
-        dxf_mtext->background_fill = 0;
-        dxf_mtext->extr_x0 = 0.0;
-        dxf_mtext->extr_y0 = 0.0;
-        dxf_mtext->extr_z0 = 0.0;
-        dxf_mtext->background_color_rgb = 0;
-        dxf_mtext->background_color_name = strdup ("");
-        dxf_mtext->background_transparency = 0;
+        dxf_mtext->text = NULL;
+        dxf_mtext->text_length = 0;
+        dxf_mtext->text_capacity = 0;
+        dxf_mtext->text_value = strdup (template.text_value);
+        dxf_mtext->linetype = strdup (template.linetype);
+        dxf_mtext->text_style = strdup (template.text_style);
+        dxf_mtext->layer = strdup (template.layer);
+        dxf_mtext->background_color_name = strdup (template.background_color_name);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -158,6 +187,94 @@ dxf_mtext_init
 }
 
 
+/*!
+ * \brief Append a chunk to the contiguous text buffer of a \c MTEXT
+ * entity.
+ *
+ * The buffer grows by doubling, so assembling a text from its group 3
+ * continuation chunks at read time is amortized linear; the assembled
+ * text stays contiguous and \c NUL terminated, and its length is kept
+ * for \c dxf_mtext_text_length.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when an error
+ * occurred.
+ */
+int
+dxf_mtext_text_append
+(
+        DxfMtext *dxf_mtext,
+                /*!< DXF mtext entity. */
+        const char *chunk
+                /*!< the text chunk to append. */
+)
+{
+        size_t chunk_length;
+        size_t new_capacity;
+        char *new_text;
+
+        /* Do some basic checks. */
+        if ((dxf_mtext == NULL) || (chunk == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        chunk_length = strlen (chunk);
+        if (dxf_mtext->text_length + chunk_length + 1 > dxf_mtext->text_capacity)
+        {
+                new_capacity = (dxf_mtext->text_capacity == 0) ?
+                        DXF_MTEXT_CHUNK_LENGTH + 1 : dxf_mtext->text_capacity;
+                while (dxf_mtext->text_length + chunk_length + 1 > new_capacity)
+                {
+                        new_capacity = new_capacity * 2;
+                }
+                new_text = realloc (dxf_mtext->text, new_capacity);
+                if (new_text == NULL)
+                {
+                        fprintf (stderr,
+                          (_("Error in %s () could not allocate memory.\n")),
+                          __FUNCTION__);
+                        return (EXIT_FAILURE);
+                }
+                dxf_mtext->text = new_text;
+                dxf_mtext->text_capacity = new_capacity;
+        }
+        memcpy (&dxf_mtext->text[dxf_mtext->text_length], chunk,
+                chunk_length + 1);
+        dxf_mtext->text_length += chunk_length;
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Get the length of the assembled text of a \c MTEXT entity.
+ *
+ * The length is maintained by \c dxf_mtext_text_append, so the query
+ * costs O(1) instead of a \c strlen pass over the text.
+ *
+ * \return the length in characters, or \c 0 when no text was
+ * assembled.
+ */
+size_t
+dxf_mtext_text_length
+(
+        DxfMtext *dxf_mtext
+                /*!< DXF mtext entity. */
+)
+{
+        /* Do some basic checks. */
+        if (dxf_mtext == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (0);
+        }
+        return (dxf_mtext->text_length);
+}
+
+
 /*!
  * \brief Read data from a DXF file into a \c MTEXT entity.
  *
@@ -185,7 +302,7 @@ dxf_mtext_read
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        char *temp_string = NULL;
+        char temp_string[DXF_MAX_STRING_LENGTH];
 
         /* Do some basic checks. */
         if (fp == NULL)
@@ -210,7 +327,7 @@ dxf_mtext_read
                 if (ferror (fp->fp))
                 {
                         fprintf (stderr,
-                          (_("Error in %s () while reading from: %s in line: %d.\n")),
+                          (_("Error in %s () while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                         fclose (fp->fp);
                         return (NULL);
@@ -219,16 +336,19 @@ dxf_mtext_read
                 {
                         /* Now follows a string containing a text value. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_mtext->text_value);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_mtext->text_value);
+                        dxf_mtext->text_value = strdup (temp_string);
+                        dxf_mtext_text_append (dxf_mtext, temp_string);
                 }
                 else if (strcmp (temp_string, "3") == 0)
                 {
-                        /* Now follows a string containing a text value. */
+                        /* Now follows a string containing a text
+                         * continuation chunk. */
                         (fp->line_number)++;
-                        //fscanf (fp->fp, "%s\n", dxf_mtext->text_additional_value[number_additional]);
-                        //number_additional++;
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        dxf_mtext_text_append (dxf_mtext, temp_string);
                 }
-                /*!< I'm not sure this number_additional is correct.*/
                 else if (strcmp (temp_string, "5") == 0)
                 {
                         /* Now follows a string containing a sequential
@@ -241,20 +361,26 @@ dxf_mtext_read
                         /* Now follows a string containing a linetype
                          * name. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_mtext->linetype);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_mtext->linetype);
+                        dxf_mtext->linetype = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "7") == 0)
                 {
                         /* Now follows a string containing a text style
                          * name. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_mtext->text_style);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_mtext->text_style);
+                        dxf_mtext->text_style = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "8") == 0)
                 {
                         /* Now follows a string containing a layer name. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_mtext->layer);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_mtext->layer);
+                        dxf_mtext->layer = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "10") == 0)
                 {
@@ -422,8 +548,8 @@ dxf_mtext_read
                         if ((strcmp (temp_string, "AcDbEntity") != 0)
                         && ((strcmp (temp_string, "AcDbMText") != 0)))
                         {
-                                fprintf (stderr,
-                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %d.\n")),
+                                dxf_diag_report (fp, DXF_DIAG_WARNING,
+                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                         }
                 }
@@ -458,8 +584,8 @@ dxf_mtext_read
 
                 else
                 {
-                        fprintf (stderr,
-                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %d.\n")),
+                        dxf_diag_report (fp, DXF_DIAG_WARNING,
+                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                 }
         }
@@ -611,12 +737,29 @@ dxf_mtext_write
         fprintf (fp->fp, " 41\n%f\n", dxf_mtext->rectangle_width);
         fprintf (fp->fp, " 71\n%d\n", dxf_mtext->attachment_point);
         fprintf (fp->fp, " 72\n%d\n", dxf_mtext->drawing_direction);
-        fprintf (fp->fp, "  1\n%s\n", dxf_mtext->text_value);
-        i = 0;
-        while (strlen (dxf_mtext->text_additional_value[i]) > 0)
+        if ((dxf_mtext->text != NULL) && (dxf_mtext->text_length > 0))
+        {
+                /* Re-chunk the assembled text: full 250-character
+                 * continuation chunks in group 3, the shorter
+                 * remainder in group 1. */
+                size_t offset = 0;
+                while (dxf_mtext->text_length - offset >= DXF_MTEXT_CHUNK_LENGTH)
+                {
+                        fprintf (fp->fp, "  3\n%.*s\n", DXF_MTEXT_CHUNK_LENGTH,
+                                &dxf_mtext->text[offset]);
+                        offset += DXF_MTEXT_CHUNK_LENGTH;
+                }
+                fprintf (fp->fp, "  1\n%s\n", &dxf_mtext->text[offset]);
+        }
+        else
         {
-                fprintf (fp->fp, "  3\n%s\n", dxf_mtext->text_additional_value[i]);
-                i++;
+                fprintf (fp->fp, "  1\n%s\n", dxf_mtext->text_value);
+                i = 0;
+                while (strlen (dxf_mtext->text_additional_value[i]) > 0)
+                {
+                        fprintf (fp->fp, "  3\n%s\n", dxf_mtext->text_additional_value[i]);
+                        i++;
+                }
         }
         fprintf (fp->fp, "  7\n%s\n", dxf_mtext->text_style);
 
@@ -674,6 +817,7 @@ dxf_mtext_free
         free (dxf_mtext->linetype);
         free (dxf_mtext->layer);
         free (dxf_mtext->text_value);
+        free (dxf_mtext->text);
         for (i = 0; i < DXF_MAX_PARAM; i++)
         {
                 free (dxf_mtext->text_additional_value[i]);
@@ -682,7 +826,7 @@ dxf_mtext_free
         free (dxf_mtext->dictionary_owner_soft);
         free (dxf_mtext->dictionary_owner_hard);
         free (dxf_mtext->background_color_name);
-        free (dxf_mtext);
+        dxf_entity_dealloc (dxf_mtext, sizeof (*dxf_mtext));
         dxf_mtext = NULL;
 #if DEBUG
         DXF_DEBUG_END
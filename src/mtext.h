@@ -39,6 +39,14 @@
 #include "global.h"
 
 
+/*!
+ * The maximum number of characters of an on-disk \c MTEXT chunk; a
+ * longer text string is divided over group 3 continuation chunks of
+ * this size followed by a shorter group 1.
+ */
+#define DXF_MTEXT_CHUNK_LENGTH 250
+
+
 typedef struct
 dxf_mtext
 {
@@ -99,6 +107,19 @@ dxf_mtext
                 /*!< Optional, only if the text string in group 1 is
                  * greater than 250 characters.\n
                  * Group code = 3. */
+        char *text;
+                /*!< The complete text string as one contiguous
+                 * buffer, assembled once at read time from the group
+                 * 3 continuation chunks and the trailing group 1 (see
+                 * \c dxf_mtext_text_append), or \c NULL; consumers
+                 * read it without re-concatenating the chunks, and
+                 * the writer re-emits the 250-character chunking from
+                 * it. */
+        size_t text_length;
+                /*!< length of \c text in characters, excluding the
+                 * terminating \c NUL (see \c dxf_mtext_text_length). */
+        size_t text_capacity;
+                /*!< allocated size of \c text in bytes. */
         char *text_style;
                 /*!< Text style.\n
                  * Optional, defaults to \c STANDARD.\n
@@ -284,6 +305,17 @@ dxf_mtext_free
         DxfMtext *dxf_mtext
 );
 int
+dxf_mtext_text_append
+(
+        DxfMtext *dxf_mtext,
+        const char *chunk
+);
+size_t
+dxf_mtext_text_length
+(
+        DxfMtext *dxf_mtext
+);
+int
 dxf_mtext_write
 (
         DxfFile *fp,
@@ -32,7 +32,9 @@
  */
 
 
+#include <pthread.h>
 #include "object.h"
+#include "allocator.h"
 
 
 /*!
@@ -52,7 +54,7 @@ dxf_object_new ()
         size = sizeof (DxfObject);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_object = malloc (size)) == NULL)
+        if ((dxf_object = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfObject struct.\n")),
@@ -87,6 +89,11 @@ dxf_object_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfObject template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         int i;
 
         /* Do some basic checks. */
@@ -104,12 +111,19 @@ dxf_object_init
                 __FUNCTION__);
               return (NULL);
         }
-        dxf_object->entity_type = UNKNOWN_ENTITY;
-        for (i = 0; i < DXF_MAX_PARAM; i++)
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
         {
-                /*! \todo Add code for initialising a DxfParam. */
+                template.entity_type = UNKNOWN_ENTITY;
+                for (i = 0; i < DXF_MAX_PARAM; i++)
+                {
+                        /*! \todo Add code for initialising a DxfParam. */
+                }
+                template.next = NULL;
+                template_ready = 1;
         }
-        dxf_object->next = NULL;
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (dxf_object, &template, sizeof (DxfObject));
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -166,7 +180,7 @@ dxf_object_free
                   __FUNCTION__);
                 return (EXIT_FAILURE);
         }
-        free (dxf_object);
+        dxf_entity_dealloc (dxf_object, sizeof (*dxf_object));
         dxf_object = NULL;
 #if DEBUG
         DXF_DEBUG_END
@@ -0,0 +1,504 @@
+/*!
+ * \file objects.c
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Functions for the typed storage of the \c OBJECTS section.
+ *
+ * Every object keeps its tags as one packed array in file order: the
+ * verbatim value line for the lossless round trip, plus the value
+ * parsed by the group code class for typed consumers.\n
+ * \c DICTIONARY objects index their name-to-handle entries in a hash
+ * map while parsing, so layout-state lookups cost O(1) instead of a
+ * scan.\n
+ * Serialization is batched: the whole section is composed into one
+ * buffer and written with a single call, the same way the header
+ * section is written.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#include "objects.h"
+#include "parser.h"
+
+
+/*!
+ * \brief Classify an object type name.
+ *
+ * \return the storage kind of the object.
+ */
+static DxfObjectsKind
+dxf_objects_classify
+(
+        const char *name
+                /*!< the object type name. */
+)
+{
+        if ((strcmp (name, "DICTIONARY") == 0)
+                || (strcmp (name, "ACDBDICTIONARYWDFLT") == 0))
+        {
+                return (DXF_OBJECTS_DICTIONARY);
+        }
+        if (strcmp (name, "XRECORD") == 0)
+        {
+                return (DXF_OBJECTS_XRECORD);
+        }
+        return (DXF_OBJECTS_RAW);
+}
+
+
+/*!
+ * \brief Start a new object in the section storage.
+ *
+ * \return a pointer to the object, or \c NULL when errors occurred.
+ */
+static DxfObjectsObject *
+dxf_objects_start
+(
+        DxfObjects *objects,
+                /*!< the section storage. */
+        const char *name
+                /*!< the object type name. */
+)
+{
+        DxfObjectsObject *grown;
+        DxfObjectsObject *object;
+
+        if (objects->length == objects->capacity)
+        {
+                objects->capacity = (objects->capacity == 0)
+                        ? 16 : (objects->capacity * 2);
+                grown = realloc (objects->objects,
+                        objects->capacity * sizeof (DxfObjectsObject));
+                if (grown == NULL)
+                {
+                        fprintf (stderr,
+                          (_("Error in %s () could not allocate memory.\n")),
+                          __FUNCTION__);
+                        return (NULL);
+                }
+                objects->objects = grown;
+        }
+        object = &objects->objects[objects->length];
+        memset (object, 0, sizeof (DxfObjectsObject));
+        object->name = strdup (name);
+        object->kind = dxf_objects_classify (name);
+        if (object->kind == DXF_OBJECTS_DICTIONARY)
+        {
+                object->entries = dxf_symbol_table_new ();
+        }
+        objects->length++;
+        return (object);
+}
+
+
+/*!
+ * \brief Append one tag to an object.
+ *
+ * \return a pointer to the tag, or \c NULL when errors occurred.
+ */
+static DxfObjectsTag *
+dxf_objects_append_tag
+(
+        DxfObjectsObject *object,
+                /*!< the object to append to. */
+        int group_code,
+                /*!< group code of the tag. */
+        const char *value
+                /*!< verbatim value line of the tag. */
+)
+{
+        DxfObjectsTag *grown;
+        DxfObjectsTag *tag;
+
+        if (object->length == object->capacity)
+        {
+                object->capacity = (object->capacity == 0)
+                        ? 8 : (object->capacity * 2);
+                grown = realloc (object->tags,
+                        object->capacity * sizeof (DxfObjectsTag));
+                if (grown == NULL)
+                {
+                        fprintf (stderr,
+                          (_("Error in %s () could not allocate memory.\n")),
+                          __FUNCTION__);
+                        return (NULL);
+                }
+                object->tags = grown;
+        }
+        tag = &object->tags[object->length];
+        tag->group_code = group_code;
+        tag->type = dxf_parser_value_type (group_code);
+        tag->double_value = 0.0;
+        tag->int_value = 0;
+        switch (tag->type)
+        {
+                case DXF_FIELD_TYPE_DOUBLE:
+                        tag->double_value = dxf_parse_double (value);
+                        break;
+                case DXF_FIELD_TYPE_INT:
+                case DXF_FIELD_TYPE_INT16:
+                        tag->int_value = dxf_parse_long (value);
+                        break;
+                case DXF_FIELD_TYPE_HEX:
+                        tag->int_value = strtol (value, NULL, 16);
+                        break;
+                default:
+                        break;
+        }
+        tag->string_value = strdup (value);
+        object->length++;
+        return (tag);
+}
+
+
+/*!
+ * \brief Read the \c OBJECTS section into typed storage.
+ *
+ * The file is positioned right behind the \c OBJECTS section name;
+ * reading consumes the section up to and including its \c ENDSEC.
+ *
+ * \return a pointer to the parsed section, to be freed with
+ * \c dxf_objects_free, or \c NULL when errors occurred.
+ */
+DxfObjects *
+dxf_objects_read
+(
+        DxfFile *fp
+                /*!< DXF file pointer to an input file (or device). */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        char code_string[DXF_MAX_STRING_LENGTH];
+        char value_string[DXF_MAX_STRING_LENGTH];
+        char entry_name[DXF_MAX_STRING_LENGTH];
+        DxfObjects *objects;
+        DxfObjectsObject *object;
+        DxfObjectsTag *tag;
+        int group_code;
+        int have_entry_name;
+
+        if (fp == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL file pointer was passed.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        objects = calloc (1, sizeof (DxfObjects));
+        if (objects == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        object = NULL;
+        have_entry_name = 0;
+        for (;;)
+        {
+                if (dxf_read_line (code_string, fp) < 1)
+                {
+                        fprintf (stderr,
+                          (_("Warning in %s () unexpected end of file while reading from: %s.\n")),
+                          __FUNCTION__, fp->filename);
+                        break;
+                }
+                if (dxf_read_line (value_string, fp) < 0)
+                {
+                        fprintf (stderr,
+                          (_("Warning in %s () unexpected end of file while reading from: %s.\n")),
+                          __FUNCTION__, fp->filename);
+                        break;
+                }
+                group_code = atoi (code_string);
+                if (group_code == 0)
+                {
+                        if (strcmp (value_string, "ENDSEC") == 0)
+                        {
+                                break;
+                        }
+                        object = dxf_objects_start (objects, value_string);
+                        if (object == NULL)
+                        {
+                                dxf_objects_free (objects);
+                                return (NULL);
+                        }
+                        have_entry_name = 0;
+                        continue;
+                }
+                if (object == NULL)
+                {
+                        fprintf (stderr,
+                          (_("Warning in %s () stray tag before the first object while reading line %ld from: %s.\n")),
+                          __FUNCTION__, fp->line_number, fp->filename);
+                        continue;
+                }
+                tag = dxf_objects_append_tag (object, group_code,
+                        value_string);
+                if (tag == NULL)
+                {
+                        dxf_objects_free (objects);
+                        return (NULL);
+                }
+                if (object->kind == DXF_OBJECTS_DICTIONARY)
+                {
+                        if (group_code == 3)
+                        {
+                                strcpy (entry_name, value_string);
+                                have_entry_name = 1;
+                        }
+                        else if (have_entry_name
+                                && ((group_code == 350)
+                                        || (group_code == 360)))
+                        {
+                                dxf_symbol_table_insert (object->entries,
+                                        entry_name, tag->string_value);
+                                have_entry_name = 0;
+                        }
+                }
+        }
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (objects);
+}
+
+
+/*!
+ * \brief Write an \c OBJECTS section, bracketing included.
+ *
+ * The whole section is composed into one buffer and written with a
+ * single call; the verbatim value lines make the round trip of
+ * carried-through objects lossless.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_objects_write
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an output file (or device). */
+        DxfObjects *objects
+                /*!< the parsed section to write. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        DxfObjectsObject *object;
+        DxfObjectsTag *tag;
+        char *buffer;
+        char *grown;
+        size_t size;
+        size_t used;
+        size_t needed;
+        size_t i;
+        size_t j;
+        int result;
+
+        if ((fp == NULL) || (objects == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        size = 8192;
+        buffer = malloc (size);
+        if (buffer == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        used = (size_t) sprintf (buffer, "  0\nSECTION\n  2\nOBJECTS\n");
+        for (i = 0; i < objects->length; i++)
+        {
+                object = &objects->objects[i];
+                needed = strlen (object->name) + 8;
+                for (j = 0; j < object->length; j++)
+                {
+                        needed += strlen (object->tags[j].string_value) + 8;
+                }
+                if (used + needed + sizeof ("  0\nENDSEC\n") > size)
+                {
+                        while (used + needed + sizeof ("  0\nENDSEC\n") > size)
+                        {
+                                size *= 2;
+                        }
+                        grown = realloc (buffer, size);
+                        if (grown == NULL)
+                        {
+                                fprintf (stderr,
+                                  (_("Error in %s () could not allocate memory.\n")),
+                                  __FUNCTION__);
+                                free (buffer);
+                                return (EXIT_FAILURE);
+                        }
+                        buffer = grown;
+                }
+                used += (size_t) sprintf (buffer + used, "  0\n%s\n",
+                        object->name);
+                for (j = 0; j < object->length; j++)
+                {
+                        tag = &object->tags[j];
+                        used += (size_t) sprintf (buffer + used, "%3d\n%s\n",
+                                tag->group_code, tag->string_value);
+                }
+        }
+        used += (size_t) sprintf (buffer + used, "  0\nENDSEC\n");
+        result = EXIT_SUCCESS;
+        if (fwrite (buffer, 1, used, fp->fp) != used)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not write to: %s.\n")),
+                  __FUNCTION__, fp->filename);
+                result = EXIT_FAILURE;
+        }
+        free (buffer);
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (result);
+}
+
+
+/*!
+ * \brief Find the n-th object of a type name.
+ *
+ * \return a pointer to the object, or \c NULL when there is no such
+ * occurrence.
+ */
+DxfObjectsObject *
+dxf_objects_find
+(
+        DxfObjects *objects,
+                /*!< the parsed section to search. */
+        const char *name,
+                /*!< the object type name, e.g. \c "DICTIONARY". */
+        size_t occurrence
+                /*!< which occurrence to return, counting from \c 0
+                 * in file order. */
+)
+{
+        size_t i;
+
+        if ((objects == NULL) || (name == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        for (i = 0; i < objects->length; i++)
+        {
+                if (strcmp (objects->objects[i].name, name) == 0)
+                {
+                        if (occurrence == 0)
+                        {
+                                return (&objects->objects[i]);
+                        }
+                        occurrence--;
+                }
+        }
+        return (NULL);
+}
+
+
+/*!
+ * \brief Look up the handle of a dictionary entry by name.
+ *
+ * \return the handle string of the entry, owned by the dictionary
+ * object, or \c NULL when the name has no entry.
+ */
+const char *
+dxf_objects_dictionary_find
+(
+        DxfObjectsObject *dictionary,
+                /*!< the dictionary object to search. */
+        const char *entry_name
+                /*!< the entry name (\c 3 group value). */
+)
+{
+        if ((dictionary == NULL) || (entry_name == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        if (dictionary->entries == NULL)
+        {
+                return (NULL);
+        }
+        return (dxf_symbol_table_find (dictionary->entries, entry_name));
+}
+
+
+/*!
+ * \brief Free a parsed \c OBJECTS section.
+ */
+void
+dxf_objects_free
+(
+        DxfObjects *objects
+                /*!< the parsed section to free. */
+)
+{
+        DxfObjectsObject *object;
+        size_t i;
+        size_t j;
+
+        if (objects == NULL)
+        {
+                return;
+        }
+        for (i = 0; i < objects->length; i++)
+        {
+                object = &objects->objects[i];
+                for (j = 0; j < object->length; j++)
+                {
+                        free (object->tags[j].string_value);
+                }
+                free (object->tags);
+                free (object->name);
+                if (object->entries != NULL)
+                {
+                        dxf_symbol_table_free (object->entries);
+                }
+        }
+        free (objects->objects);
+        free (objects);
+}
+
+
+/* EOF */
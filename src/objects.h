@@ -0,0 +1,172 @@
+/*!
+ * \file objects.h
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Header for the typed storage of the \c OBJECTS section.
+ *
+ * The \c OBJECTS section used to be skipped, so dictionaries and
+ * xrecords were lost on a round trip.\n
+ * This module parses the section into compact storage: every object
+ * keeps its tags as one packed typed array in file order, and
+ * \c DICTIONARY objects additionally index their entries in a hash
+ * map for O(1) name lookups.\n
+ * Consumers that only carry the section through pay one packed array
+ * per object and a verbatim batch reserialization.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#ifndef LIBDXF_SRC_OBJECTS_H
+#define LIBDXF_SRC_OBJECTS_H
+
+
+#include "global.h"
+#include "field.h"
+#include "symbol_table.h"
+#include "util.h"
+
+
+/*!
+ * \brief The storage kinds of a parsed object.
+ */
+typedef enum
+dxf_objects_kind
+{
+        DXF_OBJECTS_RAW,
+                /*!< an object type without typed storage; the tags
+                 * are carried through verbatim. */
+        DXF_OBJECTS_DICTIONARY,
+                /*!< a \c DICTIONARY (or \c ACDBDICTIONARYWDFLT)
+                 * object with indexed entries. */
+        DXF_OBJECTS_XRECORD
+                /*!< an \c XRECORD object; the tags after the
+                 * \c AcDbXrecord marker are its typed values. */
+} DxfObjectsKind;
+
+
+/*!
+ * \brief One tag of a parsed object: the group code, the verbatim
+ * value and the value parsed by the group code class.
+ */
+typedef struct
+dxf_objects_tag
+{
+        int group_code;
+                /*!< DXF group code of the tag. */
+        DxfFieldType type;
+                /*!< value class of the group code (see
+                 * \c dxf_parser_value_type). */
+        double double_value;
+                /*!< the parsed value for \c DXF_FIELD_TYPE_DOUBLE
+                 * tags, else \c 0.0. */
+        long int_value;
+                /*!< the parsed value for integer and hex tags, else
+                 * \c 0. */
+        char *string_value;
+                /*!< the verbatim value line; owned by the tag and
+                 * written back unchanged. */
+} DxfObjectsTag;
+
+
+/*!
+ * \brief One object of the \c OBJECTS section.
+ */
+typedef struct
+dxf_objects_object
+{
+        char *name;
+                /*!< the object type name of the \c 0 group, e.g.
+                 * \c "DICTIONARY". */
+        DxfObjectsKind kind;
+                /*!< the storage kind of the object. */
+        DxfObjectsTag *tags;
+                /*!< the tags of the object, packed in file order,
+                 * excluding the leading \c 0 group. */
+        size_t length;
+                /*!< number of tags. */
+        size_t capacity;
+                /*!< number of allocated tag slots. */
+        DxfSymbolTable *entries;
+                /*!< \c DXF_OBJECTS_DICTIONARY only: maps each entry
+                 * name (\c 3 group) to the handle string of its
+                 * \c 350 / \c 360 tag; the handles point into
+                 * \c tags, so the map owns no values.\n
+                 * \c NULL for the other kinds. */
+} DxfObjectsObject;
+
+
+/*!
+ * \brief The parsed \c OBJECTS section: the objects in file order.
+ */
+typedef struct
+dxf_objects
+{
+        DxfObjectsObject *objects;
+                /*!< the objects, in file order. */
+        size_t length;
+                /*!< number of objects. */
+        size_t capacity;
+                /*!< number of allocated object slots. */
+} DxfObjects;
+
+
+DxfObjects *
+dxf_objects_read
+(
+        DxfFile *fp
+);
+int
+dxf_objects_write
+(
+        DxfFile *fp,
+        DxfObjects *objects
+);
+DxfObjectsObject *
+dxf_objects_find
+(
+        DxfObjects *objects,
+        const char *name,
+        size_t occurrence
+);
+const char *
+dxf_objects_dictionary_find
+(
+        DxfObjectsObject *dictionary,
+        const char *entry_name
+);
+void
+dxf_objects_free
+(
+        DxfObjects *objects
+);
+
+
+#endif /* LIBDXF_SRC_OBJECTS_H */
+
+
+/* EOF */
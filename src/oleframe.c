@@ -32,7 +32,11 @@
  */
 
 
+#include <pthread.h>
 #include "oleframe.h"
+#include "diag.h"
+#include "allocator.h"
+#include "util.h"
 
 
 /*!
@@ -55,7 +59,7 @@ dxf_oleframe_new ()
         size = sizeof (DxfOleFrame);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_oleframe = malloc (size)) == NULL)
+        if ((dxf_oleframe = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfOleFrame struct.\n")),
@@ -93,6 +97,11 @@ dxf_oleframe_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfOleFrame template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         int i;
 
         /* Do some basic checks. */
@@ -110,24 +119,42 @@ dxf_oleframe_init
                 __FUNCTION__);
               return (NULL);
         }
-        dxf_oleframe->id_code = 0;
-        dxf_oleframe->linetype = strdup (DXF_DEFAULT_LINETYPE);
-        dxf_oleframe->layer = strdup (DXF_DEFAULT_LAYER);
-        dxf_oleframe->elevation = 0.0;
-        dxf_oleframe->thickness = 0.0;
-        dxf_oleframe->linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
-        dxf_oleframe->visibility = DXF_DEFAULT_VISIBILITY;
-        dxf_oleframe->color = DXF_COLOR_BYLAYER;
-        dxf_oleframe->paperspace = DXF_MODELSPACE;
-        dxf_oleframe->dictionary_owner_soft = strdup ("");
-        dxf_oleframe->dictionary_owner_hard = strdup ("");
-        dxf_oleframe->ole_version_number = 1;
-        dxf_oleframe->length = 0;
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.id_code = 0;
+                template.linetype = strdup (DXF_DEFAULT_LINETYPE);
+                template.layer = strdup (DXF_DEFAULT_LAYER);
+                template.elevation = 0.0;
+                template.thickness = 0.0;
+                template.linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
+                template.visibility = DXF_DEFAULT_VISIBILITY;
+                template.color = DXF_COLOR_BYLAYER;
+                template.paperspace = DXF_MODELSPACE;
+                template.dictionary_owner_soft = strdup ("");
+                template.dictionary_owner_hard = strdup ("");
+                template.ole_version_number = 1;
+                template.length = 0;
+                for (i = 0; i < DXF_MAX_PARAM; i++)
+                {
+                        template.binary_data[i] = strdup ("");
+                }
+                template.next = NULL;
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (dxf_oleframe, &template, sizeof (DxfOleFrame));
         for (i = 0; i < DXF_MAX_PARAM; i++)
         {
+                /* every instance owns its entries: the reader frees and
+                 * replaces them, so sharing the template strings would
+                 * free them twice and corrupt the template. */
                 dxf_oleframe->binary_data[i] = strdup ("");
         }
-        dxf_oleframe->next = NULL;
+        dxf_oleframe->linetype = strdup (template.linetype);
+        dxf_oleframe->layer = strdup (template.layer);
+        dxf_oleframe->dictionary_owner_soft = strdup (template.dictionary_owner_soft);
+        dxf_oleframe->dictionary_owner_hard = strdup (template.dictionary_owner_hard);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -161,7 +188,7 @@ dxf_oleframe_read
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        char *temp_string = NULL;
+        char temp_string[DXF_MAX_STRING_LENGTH];
         int i;
 
         /* Do some basic checks. */
@@ -188,7 +215,7 @@ dxf_oleframe_read
                 if (ferror (fp->fp))
                 {
                         fprintf (stderr,
-                          (_("Error in %s () while reading from: %s in line: %d.\n")),
+                          (_("Error in %s () while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                         fclose (fp->fp);
                         return (NULL);
@@ -202,7 +229,7 @@ dxf_oleframe_read
                         if (strcmp (temp_string, "OLE") != 0)
                         {
                                 fprintf (stderr,
-                                  (_("Error in %s () found a bad End of Ole data marker in: %s in line: %d.\n")),
+                                  (_("Error in %s () found a bad End of Ole data marker in: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                         }
                 }
@@ -218,13 +245,17 @@ dxf_oleframe_read
                         /* Now follows a string containing a linetype
                          * name. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_oleframe->linetype);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_oleframe->linetype);
+                        dxf_oleframe->linetype = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "8") == 0)
                 {
                         /* Now follows a string containing a layer name. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_oleframe->layer);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_oleframe->layer);
+                        dxf_oleframe->layer = strdup (temp_string);
                 }
                 else if ((fp->acad_version_number <= AutoCAD_11)
                         && (strcmp (temp_string, "38") == 0)
@@ -294,8 +325,8 @@ dxf_oleframe_read
                         if ((strcmp (temp_string, "AcDbEntity") != 0)
                         && ((strcmp (temp_string, "AcDbOleFrame") != 0)))
                         {
-                                fprintf (stderr,
-                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %d.\n")),
+                                dxf_diag_report (fp, DXF_DIAG_WARNING,
+                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                         }
                 }
@@ -303,7 +334,9 @@ dxf_oleframe_read
                 {
                         /* Now follows a string containing binary data. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_oleframe->binary_data[i]);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_oleframe->binary_data[i]);
+                        dxf_oleframe->binary_data[i] = strdup (temp_string);
                         i++;
                 }
                 else if (strcmp (temp_string, "330") == 0)
@@ -311,14 +344,18 @@ dxf_oleframe_read
                         /* Now follows a string containing Soft-pointer
                          * ID/handle to owner dictionary. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_oleframe->dictionary_owner_soft);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_oleframe->dictionary_owner_soft);
+                        dxf_oleframe->dictionary_owner_soft = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "360") == 0)
                 {
                         /* Now follows a string containing Hard owner
                          * ID/handle to owner dictionary. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_oleframe->dictionary_owner_hard);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_oleframe->dictionary_owner_hard);
+                        dxf_oleframe->dictionary_owner_hard = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "999") == 0)
                 {
@@ -329,8 +366,8 @@ dxf_oleframe_read
                 }
                 else
                 {
-                        fprintf (stderr,
-                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %d.\n")),
+                        dxf_diag_report (fp, DXF_DIAG_WARNING,
+                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                 }
         }
@@ -350,6 +387,89 @@ dxf_oleframe_read
 }
 
 
+/*!
+ * \brief Capture a DXF \c OLEFRAME entity as its raw source bytes.
+ *
+ * The group 310 binary data of an \c OLEFRAME is opaque payload we
+ * never interpret but must preserve; embedded-spreadsheet-laden
+ * drawings carry megabytes of it.\n
+ * Instead of decoding the record field by field, store the exact byte
+ * range of the record body, zero copy against the input memory
+ * mapping, and skip to the next record boundary with a plain byte
+ * scan.\n
+ * \c dxf_oleframe_write replays a captured record verbatim, so the
+ * payload round-trips without being re-encoded.
+ *
+ * The last line read from file contained the string "OLEFRAME".\n
+ * On return the "  0" group code of the following entity is consumed,
+ * as after \c dxf_oleframe_read.
+ *
+ * \warning The captured bytes are borrowed from the mapping: the
+ * entity must be written (or copied) before the input file is closed.
+ *
+ * \return a pointer to \c dxf_oleframe, or \c NULL when errors
+ * occurred or when no memory mapping is available; fall back to
+ * \c dxf_oleframe_read in the latter case.
+ *
+ * \version According to DXF R13.
+ * \version According to DXF R14.
+ */
+DxfOleFrame *
+dxf_oleframe_read_raw
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an input file (or device). */
+        DxfOleFrame *dxf_oleframe
+                /*!< DXF \c OLEFRAME entity. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        size_t start;
+
+        /* Do some basic checks. */
+        if (fp == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL file pointer was passed.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        if (fp->mmap_base == NULL)
+        {
+                /* reading unbuffered through stdio: no source bytes to
+                 * borrow. */
+                return (NULL);
+        }
+        if (dxf_oleframe == NULL)
+        {
+                fprintf (stderr,
+                  (_("Warning in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                dxf_oleframe = dxf_oleframe_new ();
+                dxf_oleframe = dxf_oleframe_init (dxf_oleframe);
+        }
+        /* The record body starts right behind the entity name line. */
+        start = fp->mmap_pos;
+        if (dxf_read_skip_entity (fp) != EXIT_SUCCESS)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () while reading from: %s in line: %ld.\n")),
+                  __FUNCTION__, fp->filename, fp->line_number);
+                return (NULL);
+        }
+        /* Exclude the "  0" group code of the following record the
+         * scanner consumed. */
+        dxf_oleframe->raw_data = fp->mmap_base + start;
+        dxf_oleframe->raw_length = fp->mmap_pos - 4 - start;
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (dxf_oleframe);
+}
+
+
 /*!
  * \brief Write DXF output to a file for a DXF \c OLEFRAME entity.
  *
@@ -396,6 +516,25 @@ dxf_oleframe_write
                   __FUNCTION__);
                 return (EXIT_FAILURE);
         }
+        if (dxf_oleframe->raw_data != NULL)
+        {
+                /* A raw-captured record (see dxf_oleframe_read_raw) is
+                 * replayed verbatim from the source bytes. */
+                fprintf (fp->fp, "  0\n%s\n", dxf_entity_name);
+                if (fwrite (dxf_oleframe->raw_data, 1,
+                        dxf_oleframe->raw_length, fp->fp)
+                        != dxf_oleframe->raw_length)
+                {
+                        fprintf (stderr,
+                          (_("Error in %s () while writing to: %s.\n")),
+                          __FUNCTION__, fp->filename);
+                        return (EXIT_FAILURE);
+                }
+#if DEBUG
+                DXF_DEBUG_END
+#endif
+                return (EXIT_SUCCESS);
+        }
         if (strcmp (dxf_oleframe->linetype, "") == 0)
         {
                 fprintf (stderr,
@@ -539,7 +678,7 @@ dxf_oleframe_free
         {
                 free (dxf_oleframe->binary_data[i]);
         }
-        free (dxf_oleframe);
+        dxf_entity_dealloc (dxf_oleframe, sizeof (*dxf_oleframe));
         dxf_oleframe = NULL;
 #if DEBUG
         DXF_DEBUG_END
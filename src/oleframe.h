@@ -105,6 +105,15 @@ dxf_oleframe
         char *binary_data[DXF_MAX_PARAM];
                 /*!< group code = 310\n
                  * Binary data (multiple lines).*/
+        const char *raw_data;
+                /*!< the exact source bytes of the record body, borrowed
+                 * from the input memory mapping (see
+                 * \c dxf_oleframe_read_raw), or \c NULL when the entity
+                 * was parsed field by field.\n
+                 * Valid only while the input mapping lives; not owned
+                 * by the entity. */
+        size_t raw_length;
+                /*!< length of \c raw_data in bytes. */
         struct DxfOleFrame *next;
                 /*!< pointer to the next DxfOleFrame.\n
                  * \c NULL in the last DxfOleFrame. */
@@ -124,6 +133,12 @@ dxf_oleframe_read
         DxfFile *fp,
         DxfOleFrame *dxf_oleframe
 );
+DxfOleFrame *
+dxf_oleframe_read_raw
+(
+        DxfFile *fp,
+        DxfOleFrame *dxf_oleframe
+);
 int
 dxf_oleframe_write
 (
@@ -0,0 +1,257 @@
+/*!
+ * \file parser.c
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Functions for the pull parser over DXF group code records.
+ *
+ * Format sniffing and repair tools need to walk a file record by
+ * record under their own control, which neither the all-or-nothing
+ * \c dxf_file_read model nor the streaming callbacks give them.\n
+ * The pull parser is the cheapest scanning primitive over the block
+ * reader: one call yields one (group code, typed value, byte offset)
+ * record, the value string points into the reader's line buffer, and
+ * nothing is allocated per call.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#include "parser.h"
+#include "util.h"
+
+
+/*!
+ * \brief Derive the value type of a group code from the ranges of the
+ * DXF specification.
+ *
+ * \return the \c DxfFieldType of values stored under the group code;
+ * unknown ranges default to \c DXF_FIELD_TYPE_STRING, which preserves
+ * the raw value line.
+ */
+DxfFieldType
+dxf_parser_value_type
+(
+        int group_code
+                /*!< the group code to classify. */
+)
+{
+        if ((group_code >= 10) && (group_code <= 59))
+        {
+                return (DXF_FIELD_TYPE_DOUBLE);
+        }
+        if ((group_code >= 60) && (group_code <= 79))
+        {
+                return (DXF_FIELD_TYPE_INT16);
+        }
+        if ((group_code >= 90) && (group_code <= 99))
+        {
+                return (DXF_FIELD_TYPE_INT);
+        }
+        if (group_code == 105)
+        {
+                return (DXF_FIELD_TYPE_HEX);
+        }
+        if ((group_code >= 110) && (group_code <= 149))
+        {
+                return (DXF_FIELD_TYPE_DOUBLE);
+        }
+        if ((group_code >= 160) && (group_code <= 169))
+        {
+                return (DXF_FIELD_TYPE_INT);
+        }
+        if ((group_code >= 170) && (group_code <= 179))
+        {
+                return (DXF_FIELD_TYPE_INT16);
+        }
+        if ((group_code >= 210) && (group_code <= 239))
+        {
+                return (DXF_FIELD_TYPE_DOUBLE);
+        }
+        if ((group_code >= 270) && (group_code <= 289))
+        {
+                return (DXF_FIELD_TYPE_INT16);
+        }
+        if ((group_code >= 290) && (group_code <= 299))
+        {
+                return (DXF_FIELD_TYPE_INT);
+        }
+        if ((group_code >= 320) && (group_code <= 329))
+        {
+                return (DXF_FIELD_TYPE_HEX);
+        }
+        if ((group_code >= 370) && (group_code <= 389))
+        {
+                return (DXF_FIELD_TYPE_INT16);
+        }
+        if ((group_code >= 400) && (group_code <= 409))
+        {
+                return (DXF_FIELD_TYPE_INT16);
+        }
+        if ((group_code >= 420) && (group_code <= 429))
+        {
+                return (DXF_FIELD_TYPE_INT);
+        }
+        if ((group_code >= 440) && (group_code <= 459))
+        {
+                return (DXF_FIELD_TYPE_INT);
+        }
+        if ((group_code >= 460) && (group_code <= 469))
+        {
+                return (DXF_FIELD_TYPE_DOUBLE);
+        }
+        if ((group_code >= 1010) && (group_code <= 1059))
+        {
+                return (DXF_FIELD_TYPE_DOUBLE);
+        }
+        if ((group_code >= 1060) && (group_code <= 1071))
+        {
+                return (DXF_FIELD_TYPE_INT);
+        }
+        return (DXF_FIELD_TYPE_STRING);
+}
+
+
+/*!
+ * \brief Best-effort byte offset of the next line handed out by the
+ * reader.
+ *
+ * Exact for memory mapped and block buffered input; for gzip
+ * compressed input the compressed offset of the containing block, and
+ * the stdio position for plain unbuffered reading.
+ *
+ * \return the byte offset.
+ */
+static uint64_t
+dxf_parser_offset
+(
+        DxfFile *fp
+                /*!< DXF file pointer to an input file (or device). */
+)
+{
+        if (fp->mmap_base != NULL)
+        {
+                return ((uint64_t) fp->mmap_pos);
+        }
+        if (fp->read_buffer != NULL)
+        {
+                return (fp->bytes_consumed
+                        - (uint64_t) (fp->read_buffer_avail - fp->read_buffer_pos));
+        }
+        if ((fp->fp != NULL) && (fp->gzip == NULL))
+        {
+                long position;
+
+                position = ftell (fp->fp);
+                if (position >= 0)
+                {
+                        return ((uint64_t) position);
+                }
+        }
+        return (fp->bytes_consumed);
+}
+
+
+/*!
+ * \brief Pull the next group code record from a DXF file.
+ *
+ * One call reads one group code line and its value line through the
+ * block reader, classifies the value by the group code range and
+ * parses it in place; \c record->string_value points into the
+ * reader's line buffer and stays valid until the next pull.\n
+ * No memory is allocated per call.
+ *
+ * \return \c FOUND when a record was produced, or \c FAIL at the end
+ * of the file or when errors occurred.
+ */
+int
+dxf_parser_next
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an input file (or device). */
+        DxfParserRecord *record
+                /*!< receives the pulled record. */
+)
+{
+        char *line;
+        uint64_t offset;
+
+        if ((fp == NULL) || (record == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (FAIL);
+        }
+        offset = dxf_parser_offset (fp);
+        line = dxf_read_line_grow (fp);
+        if (line == NULL)
+        {
+                return (FAIL);
+        }
+        record->group_code = (int) dxf_parse_long (line);
+        record->offset = offset;
+        record->line_number = fp->line_number;
+        line = dxf_read_value_line_grow (fp);
+        if (line == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a group code without a value was read in line: %ld.\n")),
+                  __FUNCTION__, fp->line_number);
+                return (FAIL);
+        }
+        record->string_value = line;
+        record->type = dxf_parser_value_type (record->group_code);
+        record->double_value = 0.0;
+        record->int_value = 0;
+        switch (record->type)
+        {
+                case DXF_FIELD_TYPE_DOUBLE:
+                {
+                        record->double_value = dxf_parse_double (line);
+                        break;
+                }
+                case DXF_FIELD_TYPE_INT:
+                case DXF_FIELD_TYPE_INT16:
+                {
+                        record->int_value = (int) dxf_parse_long (line);
+                        break;
+                }
+                case DXF_FIELD_TYPE_HEX:
+                {
+                        record->int_value = (int) strtol (line, NULL, 16);
+                        break;
+                }
+                default:
+                {
+                        break;
+                }
+        }
+        return (FOUND);
+}
+
+
+/* EOF */
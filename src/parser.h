@@ -0,0 +1,92 @@
+/*!
+ * \file parser.h
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Header for the pull parser over DXF group code records.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#ifndef LIBDXF_SRC_PARSER_H
+#define LIBDXF_SRC_PARSER_H
+
+
+#include "global.h"
+#include "field.h"
+
+
+/*!
+ * \brief One group code record pulled from a DXF file.
+ *
+ * The string value points into the line buffer of the reader and
+ * stays valid until the next pull; nothing is allocated per record.
+ */
+typedef struct
+dxf_parser_record
+{
+        int group_code;
+                /*!< the group code. */
+        DxfFieldType type;
+                /*!< the value type, derived from the group code range
+                 * of the DXF specification. */
+        double double_value;
+                /*!< the parsed value for \c DXF_FIELD_TYPE_DOUBLE
+                 * records; \c 0.0 otherwise. */
+        int int_value;
+                /*!< the parsed value for \c DXF_FIELD_TYPE_INT,
+                 * \c DXF_FIELD_TYPE_INT16 and \c DXF_FIELD_TYPE_HEX
+                 * records; \c 0 otherwise. */
+        char *string_value;
+                /*!< the raw value line, for every record type; valid
+                 * until the next pull. */
+        uint64_t offset;
+                /*!< byte offset of the group code line within the
+                 * file; for gzip compressed input the compressed
+                 * offset of the containing block. */
+        long line_number;
+                /*!< line number of the group code line. */
+} DxfParserRecord;
+
+
+int
+dxf_parser_next
+(
+        DxfFile *fp,
+        DxfParserRecord *record
+);
+DxfFieldType
+dxf_parser_value_type
+(
+        int group_code
+);
+
+
+#endif /* LIBDXF_SRC_PARSER_H */
+
+
+/* EOF */
@@ -0,0 +1,610 @@
+/*!
+ * \file pipeline.c
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Functions for the multi file conversion pipeline.
+ *
+ * Batch consumers converting directories with thousands of drawings
+ * all need the same scaffolding: a pool of worker threads running
+ * read, transform and write per file, with the number of files in
+ * flight bounded so the mappings and arenas of concurrently open
+ * drawings fit in memory.\n
+ * This module provides that scaffolding once, on top of the thread
+ * safe per-parse \c DxfDocument contexts (see file.h): callers
+ * describe the per file work with streaming callbacks and a transform
+ * callback (see \c DxfPipeline) and hand \c dxf_pipeline_run an array
+ * of jobs.\n
+ * Workers also share the process wide caches which are already
+ * concurrent: the interned string pool (see \c dxf_string_intern) and
+ * the \c CLASSES section cache (see \c dxf_class_section_read), so
+ * repeated strings and identical section bytes are stored once across
+ * all files.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "pipeline.h"
+#include "util.h"
+#include "writer.h"
+
+
+/*!
+ * \brief A double ended job queue owned by one pipeline worker.
+ *
+ * The owner pops jobs from the tail; idle workers steal from the
+ * head, so a thief takes the job its owner would reach last and the
+ * two ends rarely contend on the mutex.
+ */
+typedef struct
+dxf_pipeline_deque
+{
+        pthread_mutex_t mutex;
+                /*!< guards \c head and \c tail. */
+        DxfPipelineJob **jobs;
+                /*!< the queued jobs, oldest first. */
+        int head;
+                /*!< index of the oldest queued job. */
+        int tail;
+                /*!< index just past the newest queued job. */
+} DxfPipelineDeque;
+
+
+struct dxf_pipeline_state;
+
+
+/*!
+ * \brief One worker thread of a running pipeline.
+ */
+typedef struct
+dxf_pipeline_worker
+{
+        struct dxf_pipeline_state *state;
+                /*!< the shared pipeline run state. */
+        DxfPipelineDeque deque;
+                /*!< the jobs assigned to this worker, until stolen. */
+        pthread_t thread;
+                /*!< the worker thread. */
+        int index;
+                /*!< position in the worker array, where victim
+                 * selection starts. */
+} DxfPipelineWorker;
+
+
+/*!
+ * \brief The shared state of one \c dxf_pipeline_run invocation.
+ */
+typedef struct
+dxf_pipeline_state
+{
+        DxfPipeline *pipeline;
+                /*!< the pipeline description. */
+        DxfPipelineWorker *workers;
+                /*!< the worker pool. */
+        int worker_count;
+                /*!< number of workers in the pool. */
+        pthread_mutex_t admission_mutex;
+                /*!< guards \c bytes_in_flight. */
+        pthread_cond_t admission_cond;
+                /*!< signalled when a job finishes and releases its
+                 * admission bytes. */
+        uint64_t bytes_in_flight;
+                /*!< summed input sizes of the jobs being processed. */
+        uint64_t memory_limit;
+                /*!< the admission budget in bytes. */
+} DxfPipelineState;
+
+
+/*!
+ * \brief Open the output file of a pipeline job and attach a buffered
+ * writer.
+ *
+ * \return the opened \c DxfFile, or \c NULL when errors occurred.
+ */
+static DxfFile *
+dxf_pipeline_open_output
+(
+        const char *filename
+                /*!< filename of the output file. */
+)
+{
+        DxfFile *fp;
+
+        fp = malloc (sizeof (DxfFile));
+        if (fp == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        memset (fp, 0, sizeof (DxfFile));
+        fp->fp = fopen (filename, "w");
+        if (fp->fp == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not open file: %s for writing.\n")),
+                  __FUNCTION__, filename);
+                free (fp);
+                return (NULL);
+        }
+        fp->filename = strdup (filename);
+        fp->binary_pending_code = -1;
+        if (dxf_writer_attach (fp, 0) != EXIT_SUCCESS)
+        {
+                fclose (fp->fp);
+                free (fp->filename);
+                free (fp);
+                return (NULL);
+        }
+        return (fp);
+}
+
+
+/*!
+ * \brief Flush and close the output file of a pipeline job.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+static int
+dxf_pipeline_close_output
+(
+        DxfFile *fp
+                /*!< DXF file pointer to the output file. */
+)
+{
+        int result;
+
+        result = dxf_writer_detach (fp);
+        if (fclose (fp->fp) != 0)
+        {
+                result = EXIT_FAILURE;
+        }
+        free (fp->filename);
+        free (fp);
+        return (result);
+}
+
+
+/*!
+ * \brief Read one input file for a pipeline job.
+ *
+ * Mirrors \c dxf_file_read_document, but memory maps the input (see
+ * \c dxf_read_mmap_init) so the pass-through rewrite path (see
+ * \c DxfReadHandlers) works; unmappable inputs fall back to plain
+ * reads.\n
+ * Sections are dispatched directly, as in the per-section workers of
+ * \c dxf_file_read_parallel, because the \c feof terminated loop of
+ * \c dxf_section_read does not end on a memory mapping.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+static int
+dxf_pipeline_read
+(
+        DxfPipelineJob *job,
+                /*!< the job being processed. */
+        DxfReadHandlers *handlers
+                /*!< the per job streaming callbacks. */
+)
+{
+        char temp_string[DXF_MAX_STRING_LENGTH];
+        DxfFile *fp;
+        int result;
+
+        fp = dxf_read_init (job->input);
+        if (fp == NULL)
+        {
+                return (EXIT_FAILURE);
+        }
+        dxf_read_mmap_init (fp);
+        fp->document = job->document;
+        fp->handlers = handlers;
+        fp->diag = handlers->diag;
+        fp->trusted = handlers->trusted;
+        fp->parse_filter = handlers->parse_filter;
+        result = EXIT_SUCCESS;
+        for (;;)
+        {
+                if (dxf_read_line (temp_string, fp) < 1)
+                {
+                        break;
+                }
+                if (strcmp (temp_string, "SECTION") != 0)
+                {
+                        continue;
+                }
+                /* consume the "  2" group code and the section name. */
+                if (dxf_read_line (temp_string, fp) < 1)
+                {
+                        break;
+                }
+                if (strcmp (temp_string, "2") != 0)
+                {
+                        continue;
+                }
+                if (dxf_read_line (temp_string, fp) < 1)
+                {
+                        break;
+                }
+                if (!dxf_parse_filter_section (fp->parse_filter, temp_string))
+                {
+                        /* the filter spec rejects this section: skip
+                         * to its ENDSEC at byte level. */
+                        dxf_read_skip_section (fp);
+                        continue;
+                }
+                if (strcmp (temp_string, "HEADER") == 0)
+                {
+                        dxf_read_header (fp, fp->document->header);
+                }
+                else if (strcmp (temp_string, "CLASSES") == 0)
+                {
+                        fp->document->classes_list = dxf_class_section_read (fp);
+                }
+                else if (strcmp (temp_string, "ENTITIES") == 0)
+                {
+                        if (dxf_entities_read (fp) != EXIT_SUCCESS)
+                        {
+                                result = EXIT_FAILURE;
+                        }
+                }
+                /* TABLES, BLOCKS, OBJECTS and THUMBNAILIMAGE have no
+                 * parser yet (see dxf_section_read); their lines fall
+                 * through the SECTION scan above. */
+        }
+        dxf_read_close (fp);
+        return (result);
+}
+
+
+/*!
+ * \brief Run one pipeline job: read, transform, write.
+ */
+static void
+dxf_pipeline_run_job
+(
+        DxfPipelineState *state,
+                /*!< the shared pipeline run state. */
+        DxfPipelineJob *job
+                /*!< the job to run. */
+)
+{
+        DxfReadHandlers handlers;
+
+        job->result = EXIT_FAILURE;
+        job->document = dxf_document_new ();
+        if (job->document == NULL)
+        {
+                return;
+        }
+        handlers = state->pipeline->handlers;
+        handlers.user_data = job;
+        job->out = NULL;
+        if (job->output != NULL)
+        {
+                job->out = dxf_pipeline_open_output (job->output);
+                if (job->out == NULL)
+                {
+                        dxf_document_free (job->document);
+                        job->document = NULL;
+                        return;
+                }
+                handlers.passthrough = job->out;
+        }
+        job->result = dxf_pipeline_read (job, &handlers);
+        if ((job->result == EXIT_SUCCESS)
+                && (state->pipeline->transform != NULL)
+                && (state->pipeline->transform (job, state->pipeline->user_data) != EXIT_SUCCESS))
+        {
+                job->result = EXIT_FAILURE;
+        }
+        if (job->out != NULL)
+        {
+                if (job->result == EXIT_SUCCESS)
+                {
+                        dxf_file_write_eof (job->out);
+                }
+                if (dxf_pipeline_close_output (job->out) != EXIT_SUCCESS)
+                {
+                        job->result = EXIT_FAILURE;
+                }
+                job->out = NULL;
+        }
+        dxf_document_free (job->document);
+        job->document = NULL;
+}
+
+
+/*!
+ * \brief Take the next job for a worker.
+ *
+ * Pops from the tail of the worker's own deque first; when that is
+ * empty the other workers are tried in index order and a job is
+ * stolen from the head of the first non-empty deque.\n
+ * Jobs never enqueue further jobs, so an empty sweep over every deque
+ * means the run is complete for this worker.
+ *
+ * \return the job, or \c NULL when no work is left.
+ */
+static DxfPipelineJob *
+dxf_pipeline_take
+(
+        DxfPipelineWorker *worker
+                /*!< the worker asking for a job. */
+)
+{
+        DxfPipelineDeque *deque;
+        DxfPipelineJob *job;
+        int i;
+
+        job = NULL;
+        deque = &worker->deque;
+        pthread_mutex_lock (&deque->mutex);
+        if (deque->head < deque->tail)
+        {
+                deque->tail--;
+                job = deque->jobs[deque->tail];
+        }
+        pthread_mutex_unlock (&deque->mutex);
+        if (job != NULL)
+        {
+                return (job);
+        }
+        for (i = 1; i < worker->state->worker_count; i++)
+        {
+                deque = &worker->state->workers
+                        [(worker->index + i) % worker->state->worker_count].deque;
+                pthread_mutex_lock (&deque->mutex);
+                if (deque->head < deque->tail)
+                {
+                        job = deque->jobs[deque->head];
+                        deque->head++;
+                }
+                pthread_mutex_unlock (&deque->mutex);
+                if (job != NULL)
+                {
+                        return (job);
+                }
+        }
+        return (NULL);
+}
+
+
+/*!
+ * \brief Main loop of one pipeline worker thread.
+ *
+ * Takes jobs until none are left; before each job the worker waits
+ * until the job's input size fits the admission budget, so the total
+ * bytes held by concurrently open files stay bounded.\n
+ * A job larger than the whole budget is admitted once it is alone,
+ * so oversized files make progress instead of deadlocking.
+ */
+static void *
+dxf_pipeline_worker_main
+(
+        void *arg
+                /*!< the \c DxfPipelineWorker to run. */
+)
+{
+        DxfPipelineWorker *worker;
+        DxfPipelineState *state;
+        DxfPipelineJob *job;
+        struct stat sb;
+        uint64_t size;
+
+        worker = (DxfPipelineWorker *) arg;
+        state = worker->state;
+        while ((job = dxf_pipeline_take (worker)) != NULL)
+        {
+                size = 0;
+                if ((job->input != NULL) && (stat (job->input, &sb) == 0))
+                {
+                        size = (uint64_t) sb.st_size;
+                }
+                pthread_mutex_lock (&state->admission_mutex);
+                while ((state->bytes_in_flight > 0)
+                        && (state->bytes_in_flight + size > state->memory_limit))
+                {
+                        pthread_cond_wait (&state->admission_cond,
+                                &state->admission_mutex);
+                }
+                state->bytes_in_flight += size;
+                pthread_mutex_unlock (&state->admission_mutex);
+                dxf_pipeline_run_job (state, job);
+                pthread_mutex_lock (&state->admission_mutex);
+                state->bytes_in_flight -= size;
+                pthread_cond_broadcast (&state->admission_cond);
+                pthread_mutex_unlock (&state->admission_mutex);
+        }
+        return (NULL);
+}
+
+
+/*!
+ * \brief Run a batch of file conversion jobs through a pipeline.
+ *
+ * The jobs are dealt round robin onto one work stealing deque per
+ * worker; each worker drains its own deque and steals from the others
+ * when it runs dry, so a directory mixing small and very large
+ * drawings keeps every thread busy until the batch ends.\n
+ * Per job results land in \c job->result.
+ *
+ * \return \c EXIT_SUCCESS when every job succeeded, or
+ * \c EXIT_FAILURE when errors occurred.
+ */
+int
+dxf_pipeline_run
+(
+        DxfPipeline *pipeline,
+                /*!< the pipeline description. */
+        DxfPipelineJob *jobs,
+                /*!< the jobs to run. */
+        int count
+                /*!< number of jobs. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        DxfPipelineState state;
+        DxfPipelineWorker *worker;
+        int workers;
+        int result;
+        int i;
+
+        /* Do some basic checks. */
+        if (pipeline == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (jobs == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (count < 1)
+        {
+                return (EXIT_SUCCESS);
+        }
+        workers = pipeline->workers;
+        if (workers <= 0)
+        {
+                workers = (int) sysconf (_SC_NPROCESSORS_ONLN);
+        }
+        if (workers > count)
+        {
+                workers = count;
+        }
+        if (workers < 1)
+        {
+                workers = 1;
+        }
+        state.pipeline = pipeline;
+        state.worker_count = workers;
+        state.bytes_in_flight = 0;
+        state.memory_limit = pipeline->memory_limit;
+        if (state.memory_limit == 0)
+        {
+                state.memory_limit = DXF_PIPELINE_MEMORY_LIMIT;
+        }
+        pthread_mutex_init (&state.admission_mutex, NULL);
+        pthread_cond_init (&state.admission_cond, NULL);
+        state.workers = malloc ((size_t) workers * sizeof (DxfPipelineWorker));
+        if (state.workers == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                pthread_mutex_destroy (&state.admission_mutex);
+                pthread_cond_destroy (&state.admission_cond);
+                return (EXIT_FAILURE);
+        }
+        for (i = 0; i < workers; i++)
+        {
+                worker = &state.workers[i];
+                worker->state = &state;
+                worker->index = i;
+                pthread_mutex_init (&worker->deque.mutex, NULL);
+                worker->deque.jobs = malloc ((size_t) count
+                        * sizeof (DxfPipelineJob *));
+                worker->deque.head = 0;
+                worker->deque.tail = 0;
+                if (worker->deque.jobs == NULL)
+                {
+                        fprintf (stderr,
+                          (_("Error in %s () could not allocate memory.\n")),
+                          __FUNCTION__);
+                        while (i >= 0)
+                        {
+                                pthread_mutex_destroy (&state.workers[i].deque.mutex);
+                                free (state.workers[i].deque.jobs);
+                                i--;
+                        }
+                        free (state.workers);
+                        pthread_mutex_destroy (&state.admission_mutex);
+                        pthread_cond_destroy (&state.admission_cond);
+                        return (EXIT_FAILURE);
+                }
+        }
+        for (i = 0; i < count; i++)
+        {
+                jobs[i].document = NULL;
+                jobs[i].out = NULL;
+                jobs[i].result = EXIT_FAILURE;
+                worker = &state.workers[i % workers];
+                worker->deque.jobs[worker->deque.tail] = &jobs[i];
+                worker->deque.tail++;
+        }
+        for (i = 0; i < workers; i++)
+        {
+                if (pthread_create (&state.workers[i].thread, NULL,
+                        dxf_pipeline_worker_main, &state.workers[i]) != 0)
+                {
+                        /* no thread: run in this one. */
+                        dxf_pipeline_worker_main (&state.workers[i]);
+                        state.workers[i].thread = pthread_self ();
+                }
+        }
+        result = EXIT_SUCCESS;
+        for (i = 0; i < workers; i++)
+        {
+                if (!pthread_equal (state.workers[i].thread, pthread_self ()))
+                {
+                        pthread_join (state.workers[i].thread, NULL);
+                }
+                pthread_mutex_destroy (&state.workers[i].deque.mutex);
+                free (state.workers[i].deque.jobs);
+        }
+        for (i = 0; i < count; i++)
+        {
+                if (jobs[i].result != EXIT_SUCCESS)
+                {
+                        result = EXIT_FAILURE;
+                }
+        }
+        free (state.workers);
+        pthread_mutex_destroy (&state.admission_mutex);
+        pthread_cond_destroy (&state.admission_cond);
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (result);
+}
+
+
+/* EOF */
@@ -0,0 +1,126 @@
+/*!
+ * \file pipeline.h
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Header for the multi file conversion pipeline.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#ifndef LIBDXF_SRC_PIPELINE_H
+#define LIBDXF_SRC_PIPELINE_H
+
+
+#include "global.h"
+#include "entities.h"
+#include "file.h"
+
+
+/*!
+ * The default admission budget, in bytes, of a \c DxfPipeline: the
+ * summed input sizes of the files in flight stay below this bound.
+ */
+#define DXF_PIPELINE_MEMORY_LIMIT (256 * 1024 * 1024)
+
+
+/*!
+ * \brief One file conversion job of a \c DxfPipeline.
+ *
+ * Callers fill in \c input, \c output and \c user_data; the remaining
+ * members are owned by the pipeline while the job runs.
+ */
+typedef struct
+dxf_pipeline_job
+{
+        char *input;
+                /*!< filename of the input file. */
+        char *output;
+                /*!< filename of the output file, or \c NULL for a
+                 * read only job. */
+        void *user_data;
+                /*!< per job consumer data. */
+        DxfDocument *document;
+                /*!< the parsed document; valid during the streaming
+                 * callbacks and the transform callback, freed when
+                 * the job finishes. */
+        DxfFile *out;
+                /*!< the opened output file with a writer attached
+                 * (see \c dxf_writer_attach), or \c NULL; valid
+                 * during the streaming callbacks and the transform
+                 * callback. */
+        int result;
+                /*!< \c EXIT_SUCCESS or \c EXIT_FAILURE after the
+                 * pipeline ran. */
+} DxfPipelineJob;
+
+
+/*!
+ * \brief A multi file conversion pipeline.
+ *
+ * Runs read, transform and write per job across a pool of worker
+ * threads with work stealing (see \c dxf_pipeline_run).\n
+ * The streaming callbacks in \c handlers and the \c transform
+ * callback are invoked concurrently for different jobs, so shared
+ * consumer state has to be synchronised; per job state hangs off the
+ * \c DxfPipelineJob.
+ */
+typedef struct
+dxf_pipeline
+{
+        DxfReadHandlers handlers;
+                /*!< streaming callback template, copied for every
+                 * job; the copy receives the \c DxfPipelineJob as its
+                 * \c user_data and, for jobs with an output, the job
+                 * output as its \c passthrough, so records rejected
+                 * by \c filter stream to the output verbatim. */
+        int (*transform) (DxfPipelineJob *job, void *user_data);
+                /*!< invoked after a job parsed and before its output
+                 * is finished, so additional records can be written
+                 * to \c job->out, or \c NULL; any return value other
+                 * than \c EXIT_SUCCESS fails the job. */
+        void *user_data;
+                /*!< passed to \c transform. */
+        int workers;
+                /*!< number of worker threads, or \c 0 for one per
+                 * available processor. */
+        uint64_t memory_limit;
+                /*!< admission budget in bytes, or \c 0 for
+                 * \c DXF_PIPELINE_MEMORY_LIMIT; a job is only started
+                 * while the summed input sizes of the jobs in flight
+                 * fit the budget, which bounds the total bytes held
+                 * in mappings and arenas. */
+} DxfPipeline;
+
+
+int dxf_pipeline_run (DxfPipeline *pipeline, DxfPipelineJob *jobs, int count);
+
+
+#endif /* LIBDXF_SRC_PIPELINE_H */
+
+
+/* EOF */
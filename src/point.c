@@ -46,7 +46,12 @@
  */
 
 
+#include <pthread.h>
 #include "point.h"
+#include "diag.h"
+#include "allocator.h"
+#include "util.h"
+#include "writer.h"
 
 
 /*!
@@ -72,7 +77,7 @@ dxf_point_new ()
         size = sizeof (DxfPoint);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_point = malloc (size)) == NULL)
+        if ((dxf_point = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfPoint struct.\n")),
@@ -112,6 +117,11 @@ dxf_point_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfPoint template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         /* Do some basic checks. */
         if (dxf_point == NULL)
         {
@@ -127,25 +137,36 @@ dxf_point_init
                   __FUNCTION__);
                 return (NULL);
         }
-        dxf_point->id_code = 0;
-        dxf_point->linetype = strdup (DXF_DEFAULT_LINETYPE);
-        dxf_point->layer = strdup (DXF_DEFAULT_LAYER);
-        dxf_point->x0 = 0.0;
-        dxf_point->y0 = 0.0;
-        dxf_point->z0 = 0.0;
-        dxf_point->elevation = 0.0;
-        dxf_point->thickness = 0.0;
-        dxf_point->linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
-        dxf_point->angle_to_X = 0.0;
-        dxf_point->visibility = DXF_DEFAULT_VISIBILITY;
-        dxf_point->color = DXF_COLOR_BYLAYER;
-        dxf_point->paperspace = DXF_MODELSPACE;
-        dxf_point->extr_x0 = 0.0;
-        dxf_point->extr_y0 = 0.0;
-        dxf_point->extr_z0 = 0.0;
-        dxf_point->dictionary_owner_soft = strdup ("");
-        dxf_point->dictionary_owner_hard = strdup ("");
-        dxf_point->next = NULL;
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.id_code = 0;
+                template.linetype = strdup (DXF_DEFAULT_LINETYPE);
+                template.layer = strdup (DXF_DEFAULT_LAYER);
+                template.x0 = 0.0;
+                template.y0 = 0.0;
+                template.z0 = 0.0;
+                template.elevation = 0.0;
+                template.thickness = 0.0;
+                template.linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
+                template.angle_to_X = 0.0;
+                template.visibility = DXF_DEFAULT_VISIBILITY;
+                template.color = DXF_COLOR_BYLAYER;
+                template.paperspace = DXF_MODELSPACE;
+                template.extr_x0 = 0.0;
+                template.extr_y0 = 0.0;
+                template.extr_z0 = 0.0;
+                template.dictionary_owner_soft = strdup ("");
+                template.dictionary_owner_hard = strdup ("");
+                template.next = NULL;
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (dxf_point, &template, sizeof (DxfPoint));
+        dxf_point->linetype = strdup (template.linetype);
+        dxf_point->layer = strdup (template.layer);
+        dxf_point->dictionary_owner_soft = strdup (template.dictionary_owner_soft);
+        dxf_point->dictionary_owner_hard = strdup (template.dictionary_owner_hard);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -183,7 +204,7 @@ dxf_point_read
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        char *temp_string = NULL;
+        char temp_string[DXF_MAX_STRING_LENGTH];
 
         /* Do some basic checks. */
         if (fp == NULL)
@@ -201,14 +222,13 @@ dxf_point_read
                 dxf_point = dxf_point_new ();
                 dxf_point = dxf_point_init (dxf_point);
         }
-        (fp->line_number)++;
-        fscanf (fp->fp, "%[^\n]", temp_string);
+        dxf_read_line (temp_string, fp);
         while (strcmp (temp_string, "0") != 0)
         {
                 if (ferror (fp->fp))
                 {
                         fprintf (stderr,
-                          (_("Error in %s () while reading from: %s in line: %d.\n")),
+                          (_("Error in %s () while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                         fclose (fp->fp);
                         return (NULL);
@@ -217,42 +237,40 @@ dxf_point_read
                 {
                         /* Now follows a string containing a sequential
                          * id number. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%x\n", &dxf_point->id_code);
+                                                dxf_read_scanf (fp, "%x\n", &dxf_point->id_code);
                 }
                 else if (strcmp (temp_string, "6") == 0)
                 {
                         /* Now follows a string containing a linetype
                          * name. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_point->linetype);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
+                        free (dxf_point->linetype);
+                        dxf_point->linetype = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "8") == 0)
                 {
                         /* Now follows a string containing a layer name. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_point->layer);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
+                        free (dxf_point->layer);
+                        dxf_point->layer = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "10") == 0)
                 {
                         /* Now follows a string containing the
                          * X-coordinate of the center point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_point->x0);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_point->x0);
                 }
                 else if (strcmp (temp_string, "20") == 0)
                 {
                         /* Now follows a string containing the
                          * Y-coordinate of the center point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_point->y0);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_point->y0);
                 }
                 else if (strcmp (temp_string, "30") == 0)
                 {
                         /* Now follows a string containing the
                          * Z-coordinate of the center point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_point->z0);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_point->z0);
                 }
                 else if ((fp->acad_version_number <= AutoCAD_11)
                         && (strcmp (temp_string, "38") == 0)
@@ -260,63 +278,55 @@ dxf_point_read
                 {
                         /* Now follows a string containing the
                          * elevation. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_point->elevation);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_point->elevation);
                 }
                 else if (strcmp (temp_string, "39") == 0)
                 {
                         /* Now follows a string containing the
                          * thickness. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_point->thickness);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_point->thickness);
                 }
                 else if (strcmp (temp_string, "48") == 0)
                 {
                         /* Now follows a string containing the linetype
                          * scale. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_point->linetype_scale);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_point->linetype_scale);
                 }
                 else if (strcmp (temp_string, "50") == 0)
                 {
                         /* Now follows a string containing the
                          * start angle. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_point->angle_to_X);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_point->angle_to_X);
                 }
                 else if (strcmp (temp_string, "60") == 0)
                 {
                         /* Now follows a string containing the
                          * visibility value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%hd\n", &dxf_point->visibility);
+                                                dxf_read_scanf (fp, "%hd\n", &dxf_point->visibility);
                 }
                 else if (strcmp (temp_string, "62") == 0)
                 {
                         /* Now follows a string containing the
                          * color value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_point->color);
+                                                dxf_read_scanf (fp, "%d\n", &dxf_point->color);
                 }
                 else if (strcmp (temp_string, "67") == 0)
                 {
                         /* Now follows a string containing the
                          * paperspace value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_point->paperspace);
+                                                dxf_read_scanf (fp, "%d\n", &dxf_point->paperspace);
                 }
                 else if ((fp->acad_version_number >= AutoCAD_13)
                         && (strcmp (temp_string, "100") == 0))
                 {
                         /* Now follows a string containing the
                          * subclass marker value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", temp_string);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
                         if ((strcmp (temp_string, "AcDbEntity") != 0)
                         && ((strcmp (temp_string, "AcDbPoint") != 0)))
                         {
-                                fprintf (stderr,
-                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %d.\n")),
+                                dxf_diag_report (fp, DXF_DIAG_WARNING,
+                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                         }
                 }
@@ -324,50 +334,52 @@ dxf_point_read
                 {
                         /* Now follows a string containing the
                          * X-value of the extrusion vector. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_point->extr_x0);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_point->extr_x0);
                 }
                 else if (strcmp (temp_string, "220") == 0)
                 {
                         /* Now follows a string containing the
                          * Y-value of the extrusion vector. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_point->extr_y0);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_point->extr_y0);
                 }
                 else if (strcmp (temp_string, "230") == 0)
                 {
                         /* Now follows a string containing the
                          * Z-value of the extrusion vector. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_point->extr_z0);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_point->extr_z0);
                 }
                 else if (strcmp (temp_string, "330") == 0)
                 {
                         /* Now follows a string containing Soft-pointer
                          * ID/handle to owner dictionary. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_point->dictionary_owner_soft);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
+                        free (dxf_point->dictionary_owner_soft);
+                        dxf_point->dictionary_owner_soft = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "360") == 0)
                 {
                         /* Now follows a string containing Hard owner
                          * ID/handle to owner dictionary. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_point->dictionary_owner_hard);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
+                        free (dxf_point->dictionary_owner_hard);
+                        dxf_point->dictionary_owner_hard = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "999") == 0)
                 {
                         /* Now follows a string containing a comment. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", temp_string);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
                         fprintf (stdout, "DXF comment: %s\n", temp_string);
                 }
                 else
                 {
                         fprintf (stderr,
-                          (_("Warning: in %s () unknown string tag found while reading from: %s in line: %d.\n")),
+                          (_("Warning: in %s () unknown string tag found while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                 }
+                if (dxf_read_line (temp_string, fp) != 1)
+                {
+                        break;
+                }
         }
         /* Handle omitted members and/or illegal values. */
         if (strcmp (dxf_point->linetype, "") == 0)
@@ -447,11 +459,15 @@ dxf_point_write
                   dxf_entity_name);
                 dxf_point->layer = strdup (DXF_DEFAULT_LAYER);
         }
+        if (fp->write_version.acad_version_number != fp->acad_version_number)
+        {
+                dxf_write_version_init (fp);
+        }
         /* Start writing output. */
-        fprintf (fp->fp, "  0\n%s\n", dxf_entity_name);
+        dxf_write_group_string (fp, 0, dxf_entity_name);
         if (dxf_point->id_code != -1)
         {
-                fprintf (fp->fp, "  5\n%x\n", dxf_point->id_code);
+                dxf_write_group_hex (fp, 5, dxf_point->id_code);
         }
         /*!
          * \todo for version R14.\n
@@ -464,71 +480,71 @@ dxf_point_write
          * End of group, "}" (optional), with Group code 102.
          */
         if ((strcmp (dxf_point->dictionary_owner_soft, "") != 0)
-          && (fp->acad_version_number >= AutoCAD_14))
+          && fp->write_version.since_r14)
         {
-                fprintf (fp->fp, "102\n{ACAD_REACTORS\n");
-                fprintf (fp->fp, "330\n%s\n", dxf_point->dictionary_owner_soft);
-                fprintf (fp->fp, "102\n}\n");
+                dxf_write_group_string (fp, 102, "{ACAD_REACTORS");
+                dxf_write_group_string (fp, 330, dxf_point->dictionary_owner_soft);
+                dxf_write_group_string (fp, 102, "}");
         }
         if ((strcmp (dxf_point->dictionary_owner_hard, "") != 0)
-          && (fp->acad_version_number >= AutoCAD_14))
+          && fp->write_version.since_r14)
         {
-                fprintf (fp->fp, "102\n{ACAD_XDICTIONARY\n");
-                fprintf (fp->fp, "360\n%s\n", dxf_point->dictionary_owner_hard);
-                fprintf (fp->fp, "102\n}\n");
+                dxf_write_group_string (fp, 102, "{ACAD_XDICTIONARY");
+                dxf_write_group_string (fp, 360, dxf_point->dictionary_owner_hard);
+                dxf_write_group_string (fp, 102, "}");
         }
-        if (fp->acad_version_number >= AutoCAD_13)
+        if (fp->write_version.since_r13)
         {
-                fprintf (fp->fp, "100\nAcDbEntity\n");
+                dxf_write_group_string (fp, 100, "AcDbEntity");
         }
         if (dxf_point->paperspace == DXF_PAPERSPACE)
         {
-                fprintf (fp->fp, " 67\n%d\n", DXF_PAPERSPACE);
+                dxf_write_group_int (fp, 67, DXF_PAPERSPACE);
         }
-        fprintf (fp->fp, "  8\n%s\n", dxf_point->layer);
+        dxf_write_group_string (fp, 8, dxf_point->layer);
         if (strcmp (dxf_point->linetype, DXF_DEFAULT_LINETYPE) != 0)
         {
-                fprintf (fp->fp, "  6\n%s\n", dxf_point->linetype);
+                dxf_write_group_string (fp, 6, dxf_point->linetype);
         }
-        if ((fp->acad_version_number <= AutoCAD_11)
+        if (fp->write_version.until_r11
           && DXF_FLATLAND
           && (dxf_point->elevation != 0.0))
         {
-                fprintf (fp->fp, " 38\n%f\n", dxf_point->elevation);
+                dxf_write_group_double (fp, 38, dxf_point->elevation);
         }
         if (dxf_point->color != DXF_COLOR_BYLAYER)
         {
-                fprintf (fp->fp, " 62\n%d\n", dxf_point->color);
+                dxf_write_group_int (fp, 62, dxf_point->color);
         }
         if (dxf_point->linetype_scale != 1.0)
         {
-                fprintf (fp->fp, " 48\n%f\n", dxf_point->linetype_scale);
+                dxf_write_group_double (fp, 48, dxf_point->linetype_scale);
         }
         if (dxf_point->visibility != 0)
         {
-                fprintf (fp->fp, " 60\n%d\n", dxf_point->visibility);
+                dxf_write_group_int (fp, 60, dxf_point->visibility);
         }
-        if (fp->acad_version_number >= AutoCAD_13)
+        if (fp->write_version.since_r13)
         {
-                fprintf (fp->fp, "100\nAcDbPoint\n");
+                dxf_write_group_string (fp, 100, "AcDbPoint");
         }
-        fprintf (fp->fp, " 10\n%f\n", dxf_point->x0);
-        fprintf (fp->fp, " 20\n%f\n", dxf_point->y0);
-        fprintf (fp->fp, " 30\n%f\n", dxf_point->z0);
+        dxf_write_group_double (fp, 10, dxf_point->x0);
+        dxf_write_group_double (fp, 20, dxf_point->y0);
+        dxf_write_group_double (fp, 30, dxf_point->z0);
         if (dxf_point->thickness != 0.0)
         {
-                fprintf (fp->fp, " 39\n%f\n", dxf_point->thickness);
+                dxf_write_group_double (fp, 39, dxf_point->thickness);
         }
-        if ((fp->acad_version_number >= AutoCAD_12)
+        if (fp->write_version.since_r12
                 && (dxf_point->extr_x0 != 0.0)
                 && (dxf_point->extr_y0 != 0.0)
                 && (dxf_point->extr_z0 != 1.0))
         {
-                fprintf (fp->fp, "210\n%f\n", dxf_point->extr_x0);
-                fprintf (fp->fp, "220\n%f\n", dxf_point->extr_y0);
-                fprintf (fp->fp, "230\n%f\n", dxf_point->extr_z0);
+                dxf_write_group_double (fp, 210, dxf_point->extr_x0);
+                dxf_write_group_double (fp, 220, dxf_point->extr_y0);
+                dxf_write_group_double (fp, 230, dxf_point->extr_z0);
         }
-        fprintf (fp->fp, " 50\n%f\n", dxf_point->angle_to_X);
+        dxf_write_group_double (fp, 50, dxf_point->angle_to_X);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -571,7 +587,7 @@ dxf_point_free
         free (dxf_point->layer);
         free (dxf_point->dictionary_owner_soft);
         free (dxf_point->dictionary_owner_hard);
-        free (dxf_point);
+        dxf_entity_dealloc (dxf_point, sizeof (*dxf_point));
         dxf_point = NULL;
 #if DEBUG
         DXF_DEBUG_END
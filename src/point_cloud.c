@@ -0,0 +1,524 @@
+/*!
+ * \file point_cloud.c
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Functions for packed point cloud storage of bulk \c POINT
+ * entities.
+ *
+ * Survey imports are dominated by \c POINT entities which repeat the
+ * same layer, linetype and display settings for millions of
+ * consecutive points, yet each parsed struct used to carry its own
+ * copies of those members.\n
+ * The cloud groups consecutive metadata-sharing points into runs: one
+ * header entity holds the shared members and a packed array holds the
+ * x, y, z triples, so a point costs 24 bytes instead of a full struct
+ * with string copies.\n
+ * Writing replays a run through one precomputed record skeleton
+ * instead of re-checking the metadata per point.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#include "point_cloud.h"
+
+
+/*!
+ * \brief Compare two strings for equality, treating \c NULL as the
+ * empty string.
+ *
+ * \return \c TRUE when equal, \c FALSE otherwise.
+ */
+static int
+dxf_point_cloud_string_equal
+(
+        const char *a,
+                /*!< first string, or \c NULL. */
+        const char *b
+                /*!< second string, or \c NULL. */
+)
+{
+        if (a == NULL)
+        {
+                a = "";
+        }
+        if (b == NULL)
+        {
+                b = "";
+        }
+        return (strcmp (a, b) == 0);
+}
+
+
+/*!
+ * \brief Test whether a \c POINT entity shares its metadata with a
+ * run header.
+ *
+ * The \c id_code is deliberately not compared: per-point handles are
+ * not retained in cloud storage.
+ *
+ * \return \c TRUE when the point extends the run, \c FALSE otherwise.
+ */
+static int
+dxf_point_cloud_run_matches
+(
+        DxfPointCloudRun *run,
+                /*!< the run to test against. */
+        DxfPoint *point
+                /*!< the parsed \c POINT entity. */
+)
+{
+        return (dxf_point_cloud_string_equal (run->header.layer, point->layer)
+                && dxf_point_cloud_string_equal (run->header.linetype, point->linetype)
+                && dxf_point_cloud_string_equal (run->header.dictionary_owner_soft, point->dictionary_owner_soft)
+                && dxf_point_cloud_string_equal (run->header.dictionary_owner_hard, point->dictionary_owner_hard)
+                && (run->header.elevation == point->elevation)
+                && (run->header.thickness == point->thickness)
+                && (run->header.linetype_scale == point->linetype_scale)
+                && (run->header.visibility == point->visibility)
+                && (run->header.color == point->color)
+                && (run->header.paperspace == point->paperspace)
+                && (run->header.angle_to_X == point->angle_to_X)
+                && (run->header.extr_x0 == point->extr_x0)
+                && (run->header.extr_y0 == point->extr_y0)
+                && (run->header.extr_z0 == point->extr_z0));
+}
+
+
+/*!
+ * \brief Start a new run with the metadata of a \c POINT entity.
+ *
+ * \return a pointer to the run, or \c NULL when no memory was
+ * allocated.
+ */
+static DxfPointCloudRun *
+dxf_point_cloud_run_new
+(
+        DxfPoint *point
+                /*!< the parsed \c POINT entity. */
+)
+{
+        DxfPointCloudRun *run;
+
+        run = calloc (1, sizeof (DxfPointCloudRun));
+        if (run == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        memcpy (&run->header, point, sizeof (DxfPoint));
+        run->header.id_code = -1;
+        run->header.x0 = 0.0;
+        run->header.y0 = 0.0;
+        run->header.z0 = 0.0;
+        run->header.next = NULL;
+        run->header.layer = strdup ((point->layer != NULL) ? point->layer : "");
+        run->header.linetype = strdup ((point->linetype != NULL) ? point->linetype : "");
+        run->header.dictionary_owner_soft = strdup ((point->dictionary_owner_soft != NULL) ? point->dictionary_owner_soft : "");
+        run->header.dictionary_owner_hard = strdup ((point->dictionary_owner_hard != NULL) ? point->dictionary_owner_hard : "");
+        return (run);
+}
+
+
+/*!
+ * \brief Allocate an empty point cloud.
+ *
+ * \return a pointer to the cloud, or \c NULL when no memory was
+ * allocated.
+ */
+DxfPointCloud *
+dxf_point_cloud_new ()
+{
+        DxfPointCloud *cloud;
+
+        cloud = calloc (1, sizeof (DxfPointCloud));
+        if (cloud == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+        }
+        return (cloud);
+}
+
+
+/*!
+ * \brief Append a \c POINT entity to a point cloud.
+ *
+ * The point extends the current run when its metadata matches the run
+ * header; otherwise a new run is started, so files which interleave
+ * layers degrade gracefully into shorter runs instead of failing.
+
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_point_cloud_append
+(
+        DxfPointCloud *cloud,
+                /*!< the cloud to append to. */
+        DxfPoint *point
+                /*!< the parsed \c POINT entity. */
+)
+{
+        DxfPointCloudRun *run;
+
+        if ((cloud == NULL) || (point == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        run = cloud->tail;
+        if ((run == NULL) || (!dxf_point_cloud_run_matches (run, point)))
+        {
+                run = dxf_point_cloud_run_new (point);
+                if (run == NULL)
+                {
+                        return (EXIT_FAILURE);
+                }
+                if (cloud->tail == NULL)
+                {
+                        cloud->runs = run;
+                }
+                else
+                {
+                        cloud->tail->next = run;
+                }
+                cloud->tail = run;
+                cloud->number_runs++;
+        }
+        if (run->length == run->capacity)
+        {
+                size_t new_capacity;
+                double *new_xyz;
+
+                new_capacity = (run->capacity == 0) ? 1024 : (run->capacity * 2);
+                new_xyz = realloc (run->xyz, new_capacity * 3 * sizeof (double));
+                if (new_xyz == NULL)
+                {
+                        fprintf (stderr,
+                          (_("Error in %s () could not allocate memory.\n")),
+                          __FUNCTION__);
+                        return (EXIT_FAILURE);
+                }
+                run->xyz = new_xyz;
+                run->capacity = new_capacity;
+        }
+        run->xyz[(run->length * 3)] = point->x0;
+        run->xyz[(run->length * 3) + 1] = point->y0;
+        run->xyz[(run->length * 3) + 2] = point->z0;
+        run->length++;
+        cloud->length++;
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Rebuild a \c POINT entity from a point cloud.
+ *
+ * The coordinates come from the packed array of the run holding the
+ * indexed point and the remaining members are copied from the run
+ * header; string members are borrowed from the header and must not be
+ * freed by the caller.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_point_cloud_get
+(
+        DxfPointCloud *cloud,
+                /*!< the cloud to read from. */
+        size_t index,
+                /*!< index of the stored point, over all runs. */
+        DxfPoint *point
+                /*!< the \c POINT entity to fill in. */
+)
+{
+        DxfPointCloudRun *run;
+
+        if ((cloud == NULL) || (point == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (index >= cloud->length)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () an out of range index was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        run = cloud->runs;
+        while (index >= run->length)
+        {
+                index -= run->length;
+                run = run->next;
+        }
+        memcpy (point, &run->header, sizeof (DxfPoint));
+        point->x0 = run->xyz[(index * 3)];
+        point->y0 = run->xyz[(index * 3) + 1];
+        point->z0 = run->xyz[(index * 3) + 2];
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Write DXF output to fp for every point of a point cloud.
+ *
+ * The record skeleton — everything \c dxf_point_write derives from
+ * the metadata — is formatted once per run into a prelude before and
+ * a postlude after the coordinate groups, so the per-point loop only
+ * formats three doubles between two buffer writes.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_point_cloud_write
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an output file (or device). */
+        DxfPointCloud *cloud
+                /*!< the cloud to write. */
+)
+{
+        DxfPointCloudRun *run;
+
+        if ((fp == NULL) || (cloud == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        for (run = cloud->runs; run != NULL; run = run->next)
+        {
+                DxfPoint *header;
+                char *prelude;
+                char *postlude;
+                size_t size;
+                int offset;
+                size_t i;
+
+                header = &run->header;
+                size = 256
+                        + strlen (header->layer)
+                        + strlen (header->linetype)
+                        + strlen (header->dictionary_owner_soft)
+                        + strlen (header->dictionary_owner_hard);
+                prelude = malloc (size);
+                postlude = malloc (128);
+                if ((prelude == NULL) || (postlude == NULL))
+                {
+                        fprintf (stderr,
+                          (_("Error in %s () could not allocate memory.\n")),
+                          __FUNCTION__);
+                        free (prelude);
+                        free (postlude);
+                        return (EXIT_FAILURE);
+                }
+                offset = sprintf (prelude, "  0\nPOINT\n");
+                if ((strcmp (header->dictionary_owner_soft, "") != 0)
+                  && (fp->acad_version_number >= AutoCAD_14))
+                {
+                        offset += sprintf (prelude + offset,
+                                "102\n{ACAD_REACTORS\n330\n%s\n102\n}\n",
+                                header->dictionary_owner_soft);
+                }
+                if ((strcmp (header->dictionary_owner_hard, "") != 0)
+                  && (fp->acad_version_number >= AutoCAD_14))
+                {
+                        offset += sprintf (prelude + offset,
+                                "102\n{ACAD_XDICTIONARY\n360\n%s\n102\n}\n",
+                                header->dictionary_owner_hard);
+                }
+                if (fp->acad_version_number >= AutoCAD_13)
+                {
+                        offset += sprintf (prelude + offset, "100\nAcDbEntity\n");
+                }
+                if (header->paperspace == DXF_PAPERSPACE)
+                {
+                        offset += sprintf (prelude + offset, " 67\n%d\n",
+                                DXF_PAPERSPACE);
+                }
+                offset += sprintf (prelude + offset, "  8\n%s\n", header->layer);
+                if (strcmp (header->linetype, DXF_DEFAULT_LINETYPE) != 0)
+                {
+                        offset += sprintf (prelude + offset, "  6\n%s\n",
+                                header->linetype);
+                }
+                if ((fp->acad_version_number <= AutoCAD_11)
+                  && DXF_FLATLAND
+                  && (header->elevation != 0.0))
+                {
+                        offset += sprintf (prelude + offset, " 38\n%f\n",
+                                header->elevation);
+                }
+                if (header->color != DXF_COLOR_BYLAYER)
+                {
+                        offset += sprintf (prelude + offset, " 62\n%d\n",
+                                header->color);
+                }
+                if (header->linetype_scale != 1.0)
+                {
+                        offset += sprintf (prelude + offset, " 48\n%f\n",
+                                header->linetype_scale);
+                }
+                if (header->visibility != 0)
+                {
+                        offset += sprintf (prelude + offset, " 60\n%d\n",
+                                header->visibility);
+                }
+                if (fp->acad_version_number >= AutoCAD_13)
+                {
+                        sprintf (prelude + offset, "100\nAcDbPoint\n");
+                }
+                offset = 0;
+                if (header->thickness != 0.0)
+                {
+                        offset += sprintf (postlude + offset, " 39\n%f\n",
+                                header->thickness);
+                }
+                if ((fp->acad_version_number >= AutoCAD_12)
+                        && (header->extr_x0 != 0.0)
+                        && (header->extr_y0 != 0.0)
+                        && (header->extr_z0 != 1.0))
+                {
+                        offset += sprintf (postlude + offset,
+                                "210\n%f\n220\n%f\n230\n%f\n",
+                                header->extr_x0,
+                                header->extr_y0,
+                                header->extr_z0);
+                }
+                sprintf (postlude + offset, " 50\n%f\n", header->angle_to_X);
+                for (i = 0; i < run->length; i++)
+                {
+                        fputs (prelude, fp->fp);
+                        fprintf (fp->fp, " 10\n%f\n 20\n%f\n 30\n%f\n",
+                                run->xyz[(i * 3)],
+                                run->xyz[(i * 3) + 1],
+                                run->xyz[(i * 3) + 2]);
+                        fputs (postlude, fp->fp);
+                }
+                free (prelude);
+                free (postlude);
+        }
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Streaming callback storing a parsed \c POINT entity into the
+ * cloud.
+ */
+static int
+dxf_point_cloud_collect_point
+(
+        DxfFile *fp,
+        DxfPoint *point,
+        void *user_data
+)
+{
+        DxfPointCloud *cloud = user_data;
+
+        return (dxf_point_cloud_append (cloud, point));
+}
+
+
+/*!
+ * \brief Wire a point cloud into a set of streaming read handlers.
+ *
+ * Installs a callback which appends every parsed \c POINT entity into
+ * the cloud; the handlers struct is zeroed first, so combine with
+ * other callbacks by setting them afterwards.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_point_cloud_collector_init
+(
+        DxfPointCloud *cloud,
+                /*!< the cloud to collect into; must stay alive for the
+                 * duration of the read. */
+        DxfReadHandlers *handlers
+                /*!< the streaming read handlers to initialize. */
+)
+{
+        if ((cloud == NULL) || (handlers == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        memset (handlers, 0, sizeof (DxfReadHandlers));
+        handlers->user_data = cloud;
+        handlers->point = dxf_point_cloud_collect_point;
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Free a point cloud and all its runs.
+ */
+void
+dxf_point_cloud_free
+(
+        DxfPointCloud *cloud
+                /*!< the cloud to free. */
+)
+{
+        DxfPointCloudRun *run;
+        DxfPointCloudRun *next;
+
+        if (cloud == NULL)
+        {
+                return;
+        }
+        for (run = cloud->runs; run != NULL; run = next)
+        {
+                next = run->next;
+                free (run->header.layer);
+                free (run->header.linetype);
+                free (run->header.dictionary_owner_soft);
+                free (run->header.dictionary_owner_hard);
+                free (run->xyz);
+                free (run);
+        }
+        free (cloud);
+}
+
+
+/* EOF */
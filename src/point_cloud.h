@@ -0,0 +1,128 @@
+/*!
+ * \file point_cloud.h
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Header for packed point cloud storage of bulk \c POINT
+ * entities.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#ifndef LIBDXF_SRC_POINT_CLOUD_H
+#define LIBDXF_SRC_POINT_CLOUD_H
+
+
+#include "global.h"
+#include "point.h"
+#include "entities.h"
+
+
+/*!
+ * \brief One run of \c POINT entities sharing their metadata.
+ *
+ * Survey imports repeat the same layer, linetype and display settings
+ * across millions of consecutive points; a run stores that metadata
+ * once in a header entity and keeps only the coordinates per point, as
+ * packed x, y, z triples in one contiguous array (24 bytes per point
+ * instead of a full struct with its string members).
+ */
+typedef struct
+dxf_point_cloud_run
+{
+        DxfPoint header;
+                /*!< the shared metadata of the run; the coordinate
+                 * members are unused and the \c id_code is \c -1, as
+                 * per-point handles are not retained in cloud
+                 * storage. */
+        double *xyz;
+                /*!< the coordinates, packed as x, y, z triples. */
+        size_t length;
+                /*!< number of points in the run. */
+        size_t capacity;
+                /*!< number of points the coordinate array can hold. */
+        struct dxf_point_cloud_run *next;
+                /*!< the next run of the cloud. */
+} DxfPointCloudRun;
+
+
+/*!
+ * \brief A point cloud: runs of metadata-sharing \c POINT entities in
+ * file order.
+ */
+typedef struct
+dxf_point_cloud
+{
+        DxfPointCloudRun *runs;
+                /*!< the runs, in order of appending. */
+        DxfPointCloudRun *tail;
+                /*!< the run currently being extended. */
+        size_t length;
+                /*!< total number of points over all runs. */
+        size_t number_runs;
+                /*!< number of runs in the cloud. */
+} DxfPointCloud;
+
+
+DxfPointCloud *
+dxf_point_cloud_new ();
+int
+dxf_point_cloud_append
+(
+        DxfPointCloud *cloud,
+        DxfPoint *point
+);
+int
+dxf_point_cloud_get
+(
+        DxfPointCloud *cloud,
+        size_t index,
+        DxfPoint *point
+);
+int
+dxf_point_cloud_write
+(
+        DxfFile *fp,
+        DxfPointCloud *cloud
+);
+int
+dxf_point_cloud_collector_init
+(
+        DxfPointCloud *cloud,
+        DxfReadHandlers *handlers
+);
+void
+dxf_point_cloud_free
+(
+        DxfPointCloud *cloud
+);
+
+
+#endif /* LIBDXF_SRC_POINT_CLOUD_H */
+
+
+/* EOF */
@@ -32,7 +32,12 @@
  */
 
 
+#include <pthread.h>
 #include "polyline.h"
+#include "diag.h"
+#include "allocator.h"
+#include "util.h"
+#include "writer.h"
 
 
 /*!
@@ -58,7 +63,7 @@ dxf_polyline_new ()
         size = sizeof (DxfPolyline);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_polyline = malloc (size)) == NULL)
+        if ((dxf_polyline = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfArc struct.\n")),
@@ -98,6 +103,11 @@ dxf_polyline_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfPolyline template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         /* Do some basic checks. */
         if (dxf_polyline == NULL)
         {
@@ -113,33 +123,44 @@ dxf_polyline_init
                 __FUNCTION__);
               return (NULL);
         }
-        dxf_polyline->id_code = 0;
-        dxf_polyline->linetype = strdup (DXF_DEFAULT_LINETYPE);
-        dxf_polyline->layer = strdup (DXF_DEFAULT_LAYER);
-        dxf_polyline->x0 = 0.0;
-        dxf_polyline->y0 = 0.0;
-        dxf_polyline->z0 = 0.0;
-        dxf_polyline->elevation = 0.0;
-        dxf_polyline->thickness = 0.0;
-        dxf_polyline->linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
-        dxf_polyline->visibility = DXF_DEFAULT_VISIBILITY;
-        dxf_polyline->start_width = 0.0;
-        dxf_polyline->end_width = 0.0;
-        dxf_polyline->vertices_follow = 1;
-        dxf_polyline->color = DXF_COLOR_BYLAYER;
-        dxf_polyline->paperspace = DXF_MODELSPACE;
-        dxf_polyline->flag = 0;
-        dxf_polyline->polygon_mesh_M_vertex_count = 0;
-        dxf_polyline->polygon_mesh_N_vertex_count = 0;
-        dxf_polyline->smooth_M_surface_density = 0;
-        dxf_polyline->smooth_N_surface_density = 0;
-        dxf_polyline->surface_type = 0;
-        dxf_polyline->extr_x0 = 0.0;
-        dxf_polyline->extr_y0 = 0.0;
-        dxf_polyline->extr_z0 = 0.0;
-        dxf_polyline->dictionary_owner_soft = strdup ("");
-        dxf_polyline->dictionary_owner_hard = strdup ("");
-        dxf_polyline->next = NULL;
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.id_code = 0;
+                template.linetype = strdup (DXF_DEFAULT_LINETYPE);
+                template.layer = strdup (DXF_DEFAULT_LAYER);
+                template.x0 = 0.0;
+                template.y0 = 0.0;
+                template.z0 = 0.0;
+                template.elevation = 0.0;
+                template.thickness = 0.0;
+                template.linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
+                template.visibility = DXF_DEFAULT_VISIBILITY;
+                template.start_width = 0.0;
+                template.end_width = 0.0;
+                template.vertices_follow = 1;
+                template.color = DXF_COLOR_BYLAYER;
+                template.paperspace = DXF_MODELSPACE;
+                template.flag = 0;
+                template.polygon_mesh_M_vertex_count = 0;
+                template.polygon_mesh_N_vertex_count = 0;
+                template.smooth_M_surface_density = 0;
+                template.smooth_N_surface_density = 0;
+                template.surface_type = 0;
+                template.extr_x0 = 0.0;
+                template.extr_y0 = 0.0;
+                template.extr_z0 = 0.0;
+                template.dictionary_owner_soft = strdup ("");
+                template.dictionary_owner_hard = strdup ("");
+                template.next = NULL;
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (dxf_polyline, &template, sizeof (DxfPolyline));
+        dxf_polyline->linetype = strdup (template.linetype);
+        dxf_polyline->layer = strdup (template.layer);
+        dxf_polyline->dictionary_owner_soft = strdup (template.dictionary_owner_soft);
+        dxf_polyline->dictionary_owner_hard = strdup (template.dictionary_owner_hard);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -178,7 +199,7 @@ dxf_polyline_read
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        char *temp_string = NULL;
+        char temp_string[DXF_MAX_STRING_LENGTH];
 
         /* Do some basic checks. */
         if (fp == NULL)
@@ -196,14 +217,13 @@ dxf_polyline_read
                 dxf_polyline = dxf_polyline_new ();
                 dxf_polyline = dxf_polyline_init (dxf_polyline);
         }
-        (fp->line_number)++;
-        fscanf (fp->fp, "%[^\n]", temp_string);
+        dxf_read_line (temp_string, fp);
         while (strcmp (temp_string, "0") != 0)
         {
                 if (ferror (fp->fp))
                 {
                         fprintf (stderr,
-                          (_("Error in %s () while reading from: %s in line: %d.\n")),
+                          (_("Error in %s () while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                         fclose (fp->fp);
                         return (NULL);
@@ -212,42 +232,40 @@ dxf_polyline_read
                 {
                         /* Now follows a string containing a sequential
                          * id number. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%x\n", &dxf_polyline->id_code);
+                                                dxf_read_scanf (fp, "%x\n", &dxf_polyline->id_code);
                 }
                 else if (strcmp (temp_string, "6") == 0)
                 {
                         /* Now follows a string containing a linetype
                          * name. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_polyline->linetype);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
+                        free (dxf_polyline->linetype);
+                        dxf_polyline->linetype = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "8") == 0)
                 {
                         /* Now follows a string containing a layer name. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_polyline->layer);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
+                        free (dxf_polyline->layer);
+                        dxf_polyline->layer = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "10") == 0)
                 {
                         /* Now follows a string containing the
                          * X-coordinate of the primary point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_polyline->x0);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_polyline->x0);
                 }
                 else if (strcmp (temp_string, "20") == 0)
                 {
                         /* Now follows a string containing the
                          * Y-coordinate of the primary point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_polyline->y0);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_polyline->y0);
                 }
                 else if (strcmp (temp_string, "30") == 0)
                 {
                         /* Now follows a string containing the
                          * Z-coordinate of the primary point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_polyline->z0);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_polyline->z0);
                 }
                 else if ((fp->acad_version_number <= AutoCAD_11)
                         && (strcmp (temp_string, "38") == 0)
@@ -255,106 +273,91 @@ dxf_polyline_read
                 {
                         /* Now follows a string containing the
                          * elevation. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_polyline->elevation);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_polyline->elevation);
                 }
                 else if (strcmp (temp_string, "39") == 0)
                 {
                         /* Now follows a string containing the
                          * thickness. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_polyline->thickness);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_polyline->thickness);
                 }
                 else if (strcmp (temp_string, "40") == 0)
                 {
                         /* Now follows a string containing the
                          * starting width. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_polyline->start_width);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_polyline->start_width);
                 }
                 else if (strcmp (temp_string, "41") == 0)
                 {
                         /* Now follows a string containing the
                          * end width. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_polyline->end_width);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_polyline->end_width);
                 }
                 else if (strcmp (temp_string, "48") == 0)
                 {
                         /* Now follows a string containing the linetype
                          * scale. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_polyline->linetype_scale);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_polyline->linetype_scale);
                 }
                 else if (strcmp (temp_string, "60") == 0)
                 {
                         /* Now follows a string containing the
                          * visibility value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%hd\n", &dxf_polyline->visibility);
+                                                dxf_read_scanf (fp, "%hd\n", &dxf_polyline->visibility);
                 }
                 else if (strcmp (temp_string, "62") == 0)
                 {
                         /* Now follows a string containing the
                          * color value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_polyline->color);
+                                                dxf_read_scanf (fp, "%d\n", &dxf_polyline->color);
                 }
                 else if (strcmp (temp_string, "66") == 0)
                 {
                         /* Now follows a string containing the
                          * vertces follow flag. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_polyline->vertices_follow);
+                                                dxf_read_scanf (fp, "%d\n", &dxf_polyline->vertices_follow);
                 }
                 else if (strcmp (temp_string, "67") == 0)
                 {
                         /* Now follows a string containing the
                          * paperspace value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_polyline->paperspace);
+                                                dxf_read_scanf (fp, "%d\n", &dxf_polyline->paperspace);
                 }
                 else if (strcmp (temp_string, "70") == 0)
                 {
                         /* Now follows a string containing the
                          * flag value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_polyline->flag);
+                                                dxf_read_scanf (fp, "%d\n", &dxf_polyline->flag);
                 }
                 else if (strcmp (temp_string, "71") == 0)
                 {
                         /* Now follows a string containing the polygon
                          * mesh M vertex count value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_polyline->polygon_mesh_M_vertex_count);
+                                                dxf_read_scanf (fp, "%d\n", &dxf_polyline->polygon_mesh_M_vertex_count);
                 }
                 else if (strcmp (temp_string, "72") == 0)
                 {
                         /* Now follows a string containing the polygon
                          * mesh N vertex count value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_polyline->polygon_mesh_N_vertex_count);
+                                                dxf_read_scanf (fp, "%d\n", &dxf_polyline->polygon_mesh_N_vertex_count);
                 }
                 else if (strcmp (temp_string, "73") == 0)
                 {
                         /* Now follows a string containing the smooth M
                          * surface density value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_polyline->smooth_M_surface_density);
+                                                dxf_read_scanf (fp, "%d\n", &dxf_polyline->smooth_M_surface_density);
                 }
                 else if (strcmp (temp_string, "74") == 0)
                 {
                         /* Now follows a string containing the smooth N
                          * surface density value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_polyline->smooth_M_surface_density);
+                                                dxf_read_scanf (fp, "%d\n", &dxf_polyline->smooth_M_surface_density);
                 }
                 else if (strcmp (temp_string, "75") == 0)
                 {
                         /* Now follows a string containing the surface
                          * type value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_polyline->surface_type);
+                                                dxf_read_scanf (fp, "%d\n", &dxf_polyline->surface_type);
                 }
                 else if ((fp->acad_version_number >= AutoCAD_12)
                         && (strcmp (temp_string, "100") == 0))
@@ -364,57 +367,58 @@ dxf_polyline_read
                          * version should probably be added here.
                          * Now follows a string containing the
                          * subclass marker value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", temp_string);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
                 }
                 else if (strcmp (temp_string, "210") == 0)
                 {
                         /* Now follows a string containing the
                          * X-value of the extrusion vector. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_polyline->extr_x0);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_polyline->extr_x0);
                 }
                 else if (strcmp (temp_string, "220") == 0)
                 {
                         /* Now follows a string containing the
                          * Y-value of the extrusion vector. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_polyline->extr_y0);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_polyline->extr_y0);
                 }
                 else if (strcmp (temp_string, "230") == 0)
                 {
                         /* Now follows a string containing the
                          * Z-value of the extrusion vector. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_polyline->extr_z0);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_polyline->extr_z0);
                 }
                 else if (strcmp (temp_string, "330") == 0)
                 {
                         /* Now follows a string containing Soft-pointer
                          * ID/handle to owner dictionary. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_polyline->dictionary_owner_soft);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
+                        free (dxf_polyline->dictionary_owner_soft);
+                        dxf_polyline->dictionary_owner_soft = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "360") == 0)
                 {
                         /* Now follows a string containing Hard owner
                          * ID/handle to owner dictionary. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_polyline->dictionary_owner_hard);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
+                        free (dxf_polyline->dictionary_owner_hard);
+                        dxf_polyline->dictionary_owner_hard = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "999") == 0)
                 {
                         /* Now follows a string containing a comment. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", temp_string);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
                         fprintf (stdout, "DXF comment: %s\n", temp_string);
                 }
                 else
                 {
-                        fprintf (stderr,
-                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %d.\n")),
+                        dxf_diag_report (fp, DXF_DIAG_WARNING,
+                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                 }
+                if (dxf_read_line (temp_string, fp) != 1)
+                {
+                        break;
+                }
         }
         /* Handle omitted members and/or illegal values. */
         if (strcmp (dxf_polyline->linetype, "") == 0)
@@ -618,7 +622,6 @@ dxf_polyline_write
                 dxf_vertex_write (fp, iter);
                 iter = (DxfVertex *) iter->next;
         }
-        dxf_vertex_free (iter);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -626,6 +629,261 @@ dxf_polyline_write
 }
 
 
+/*!
+ * \brief Write a complete \c POLYLINE / \c VERTEX / \c SEQEND sequence
+ * for an array of vertex coordinates in one pipelined pass.
+ *
+ * Emits the polyline header, one \c VERTEX per entry of the coordinate
+ * arrays and the terminating \c SEQEND through the buffered writer,
+ * instead of issuing a \c dxf_vertex_write call with its own fprintf
+ * sequence per vertex.\n
+ * All vertices share the members of \c scratch_vertex (layer, linetype,
+ * color, widths, bulge and flag); only the coordinates vary, so the
+ * constant part of each \c VERTEX is precomposed once and reused for
+ * the whole array.\n
+ * When no buffered writer is attached to \c fp one is attached for the
+ * duration of the call; an already attached writer is left in place and
+ * flushed before returning.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when an error
+ * occurred.
+ *
+ * \version According to DXF R10.
+ * \version According to DXF R11.
+ * \version According to DXF R12.
+ * \version According to DXF R13.
+ * \version According to DXF R14.
+ */
+int
+dxf_polyline_write_stream
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an output file (or device). */
+        DxfPolyline *dxf_polyline,
+                /*!< DXF polyline entity supplying the header members. */
+        DxfVertex *scratch_vertex,
+                /*!< DXF vertex entity supplying the members shared by
+                 * all vertices. */
+        const double *x0,
+                /*!< array of X-coordinates of the vertices. */
+        const double *y0,
+                /*!< array of Y-coordinates of the vertices. */
+        const double *z0,
+                /*!< array of Z-coordinates of the vertices, or \c NULL
+                 * for all zero Z-coordinates. */
+        int number_vertices
+                /*!< number of entries in the coordinate arrays. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        char prefix[DXF_MAX_STRING_LENGTH];
+        char suffix[DXF_MAX_STRING_LENGTH];
+        int prefix_length;
+        int suffix_length;
+        int attached_here = FALSE;
+        int result;
+        int i;
+
+        /* Do some basic checks. */
+        if (fp == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL file pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if ((dxf_polyline == NULL) || (scratch_vertex == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if ((number_vertices > 0) && ((x0 == NULL) || (y0 == NULL)))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL coordinate array was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (strcmp (dxf_polyline->layer, "") == 0)
+        {
+                fprintf (stderr,
+                  (_("Warning in %s () empty layer string for the POLYLINE entity with id-code: %x\n")),
+                  __FUNCTION__, dxf_polyline->id_code);
+                fprintf (stderr,
+                  (_("\tPOLYLINE entity is relocated to layer 0\n")));
+                dxf_polyline->layer = strdup (DXF_DEFAULT_LAYER);
+        }
+        if (fp->writer == NULL)
+        {
+                if (dxf_writer_attach (fp, 0) != EXIT_SUCCESS)
+                {
+                        return (EXIT_FAILURE);
+                }
+                attached_here = TRUE;
+        }
+        /* Write the POLYLINE header. */
+        dxf_write_group_string (fp, 0, "POLYLINE");
+        if (dxf_polyline->id_code != -1)
+        {
+                dxf_write_group_hex (fp, 5, dxf_polyline->id_code);
+        }
+        if ((strcmp (dxf_polyline->dictionary_owner_soft, "") != 0)
+          && (fp->acad_version_number >= AutoCAD_14))
+        {
+                dxf_write_group_string (fp, 102, "{ACAD_REACTORS");
+                dxf_write_group_string (fp, 330, dxf_polyline->dictionary_owner_soft);
+                dxf_write_group_string (fp, 102, "}");
+        }
+        if ((strcmp (dxf_polyline->dictionary_owner_hard, "") != 0)
+          && (fp->acad_version_number >= AutoCAD_14))
+        {
+                dxf_write_group_string (fp, 102, "{ACAD_XDICTIONARY");
+                dxf_write_group_string (fp, 360, dxf_polyline->dictionary_owner_hard);
+                dxf_write_group_string (fp, 102, "}");
+        }
+        if (fp->acad_version_number >= AutoCAD_13)
+        {
+                dxf_write_group_string (fp, 100, "AcDbEntity");
+        }
+        if (dxf_polyline->paperspace == DXF_PAPERSPACE)
+        {
+                dxf_write_group_int (fp, 67, DXF_PAPERSPACE);
+        }
+        dxf_write_group_string (fp, 8, dxf_polyline->layer);
+        if (strcmp (dxf_polyline->linetype, DXF_DEFAULT_LINETYPE) != 0)
+        {
+                dxf_write_group_string (fp, 6, dxf_polyline->linetype);
+        }
+        if ((fp->acad_version_number <= AutoCAD_11)
+          && DXF_FLATLAND
+          && (dxf_polyline->elevation != 0.0))
+        {
+                dxf_write_group_double (fp, 38, dxf_polyline->elevation);
+        }
+        if (dxf_polyline->color != DXF_COLOR_BYLAYER)
+        {
+                dxf_write_group_int (fp, 62, dxf_polyline->color);
+        }
+        if (dxf_polyline->linetype_scale != 1.0)
+        {
+                dxf_write_group_double (fp, 48, dxf_polyline->linetype_scale);
+        }
+        if (dxf_polyline->visibility != 0)
+        {
+                dxf_write_group_int (fp, 60, dxf_polyline->visibility);
+        }
+        if (fp->acad_version_number >= AutoCAD_13)
+        {
+                dxf_write_group_string (fp, 100, "AcDb3dPolyline");
+        }
+        dxf_write_group_int (fp, 66, 1);
+        dxf_write_group_double (fp, 10, dxf_polyline->x0);
+        dxf_write_group_double (fp, 20, dxf_polyline->y0);
+        dxf_write_group_double (fp, 30, dxf_polyline->z0);
+        if (dxf_polyline->thickness != 0.0)
+        {
+                dxf_write_group_double (fp, 39, dxf_polyline->thickness);
+        }
+        dxf_write_group_int (fp, 70, dxf_polyline->flag);
+        if (dxf_polyline->start_width != 0.0)
+        {
+                dxf_write_group_double (fp, 40, dxf_polyline->start_width);
+        }
+        if (dxf_polyline->end_width != 0.0)
+        {
+                dxf_write_group_double (fp, 41, dxf_polyline->end_width);
+        }
+        dxf_write_group_int (fp, 71, dxf_polyline->polygon_mesh_M_vertex_count);
+        dxf_write_group_int (fp, 72, dxf_polyline->polygon_mesh_N_vertex_count);
+        dxf_write_group_int (fp, 73, dxf_polyline->smooth_M_surface_density);
+        dxf_write_group_int (fp, 74, dxf_polyline->smooth_N_surface_density);
+        dxf_write_group_int (fp, 75, dxf_polyline->surface_type);
+        if ((fp->acad_version_number >= AutoCAD_12)
+                && (dxf_polyline->extr_x0 != 0.0)
+                && (dxf_polyline->extr_y0 != 0.0)
+                && (dxf_polyline->extr_z0 != 1.0))
+        {
+                dxf_write_group_double (fp, 210, dxf_polyline->extr_x0);
+                dxf_write_group_double (fp, 220, dxf_polyline->extr_y0);
+                dxf_write_group_double (fp, 230, dxf_polyline->extr_z0);
+        }
+        /* Precompose the constant part preceding the coordinates of
+         * every VERTEX; dxf_write_string supplies the trailing
+         * newline. */
+        prefix_length = sprintf (prefix, "  0\nVERTEX");
+        if (fp->acad_version_number >= AutoCAD_13)
+        {
+                prefix_length += sprintf (prefix + prefix_length,
+                        "\n100\nAcDbEntity");
+        }
+        prefix_length += sprintf (prefix + prefix_length,
+                "\n  8\n%s", scratch_vertex->layer);
+        if (strcmp (scratch_vertex->linetype, DXF_DEFAULT_LINETYPE) != 0)
+        {
+                prefix_length += sprintf (prefix + prefix_length,
+                        "\n  6\n%s", scratch_vertex->linetype);
+        }
+        if (scratch_vertex->color != DXF_COLOR_BYLAYER)
+        {
+                prefix_length += sprintf (prefix + prefix_length,
+                        "\n 62\n%d", scratch_vertex->color);
+        }
+        sprintf (prefix + prefix_length,
+                "\n100\nAcDbVertex\n100\nAcDb3dPolylineVertex");
+        /* Precompose the constant part following the coordinates. */
+        suffix_length = 0;
+        if (scratch_vertex->start_width != 0.0)
+        {
+                suffix_length += sprintf (suffix + suffix_length,
+                        " 40\n%f\n", scratch_vertex->start_width);
+        }
+        if (scratch_vertex->end_width != 0.0)
+        {
+                suffix_length += sprintf (suffix + suffix_length,
+                        " 41\n%f\n", scratch_vertex->end_width);
+        }
+        if (scratch_vertex->bulge != 0.0)
+        {
+                suffix_length += sprintf (suffix + suffix_length,
+                        " 42\n%f\n", scratch_vertex->bulge);
+        }
+        suffix_length += sprintf (suffix + suffix_length,
+                " 70\n%d", scratch_vertex->flag);
+        /* Stream all vertices through the buffered writer. */
+        for (i = 0; i < number_vertices; i++)
+        {
+                dxf_write_string (fp, prefix);
+                dxf_write_group_double (fp, 10, x0[i]);
+                dxf_write_group_double (fp, 20, y0[i]);
+                dxf_write_group_double (fp, 30, (z0 != NULL) ? z0[i] : 0.0);
+                dxf_write_string (fp, suffix);
+        }
+        /* Write the terminating SEQEND. */
+        dxf_write_group_string (fp, 0, "SEQEND");
+        if (fp->acad_version_number >= AutoCAD_13)
+        {
+                dxf_write_group_string (fp, 100, "AcDbEntity");
+        }
+        dxf_write_group_string (fp, 8, dxf_polyline->layer);
+        if (attached_here)
+        {
+                result = dxf_writer_detach (fp);
+        }
+        else
+        {
+                result = dxf_writer_flush (fp);
+        }
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (result);
+}
+
+
 /*!
  * \brief Free the allocated memory for a DXF \c POLYLINE and all it's
  * data fields.
@@ -659,7 +917,7 @@ dxf_polyline_free
         }
         free (dxf_polyline->linetype);
         free (dxf_polyline->layer);
-        free (dxf_polyline);
+        dxf_entity_dealloc (dxf_polyline, sizeof (*dxf_polyline));
         dxf_polyline = NULL;
 #if DEBUG
         DXF_DEBUG_END
@@ -245,6 +245,17 @@ dxf_polyline_write
         DxfPolyline *dxf_polyline
 );
 int
+dxf_polyline_write_stream
+(
+        DxfFile *fp,
+        DxfPolyline *dxf_polyline,
+        DxfVertex *scratch_vertex,
+        const double *x0,
+        const double *y0,
+        const double *z0,
+        int number_vertices
+);
+int
 dxf_polyline_free
 (
         DxfPolyline *dxf_polyline
@@ -0,0 +1,281 @@
+/*!
+ * \file profile.c
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Functions for the parse timing instrumentation.
+ *
+ * Without external profilers there is no visibility into where parse
+ * time goes.\n
+ * Compiled with \c -DDXF_PROFILE=1 the readers record wall time and
+ * bytes per section and wall time and count per entity type into one
+ * process wide profile, cheap enough to stay enabled in telemetry
+ * builds; \c dxf_profile_dump_json hands the figures to fleet
+ * monitoring, which flags pathological customer files by their
+ * shape.\n
+ * The accumulation functions are always compiled so a library built
+ * either way keeps the same symbols; only the call sites in the hot
+ * loops are compiled out (see the \c DXF_PROFILE_* macros in
+ * profile.h).
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#include <pthread.h>
+#include <time.h>
+#include "profile.h"
+
+
+static DxfProfile dxf_profile_state;
+
+
+DxfProfileCounters dxf_profile_counter_state;
+
+
+static pthread_mutex_t dxf_profile_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+
+/*!
+ * \brief Read the monotonic clock.
+ *
+ * \return the current monotonic time in nanoseconds.
+ */
+uint64_t
+dxf_profile_now ()
+{
+        struct timespec ts;
+
+        clock_gettime (CLOCK_MONOTONIC, &ts);
+        return ((uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec);
+}
+
+
+/*!
+ * \brief Reset the process wide profile to empty.
+ */
+void
+dxf_profile_reset ()
+{
+        pthread_mutex_lock (&dxf_profile_mutex);
+        memset (&dxf_profile_state, 0, sizeof (DxfProfile));
+        memset (&dxf_profile_counter_state, 0, sizeof (DxfProfileCounters));
+        pthread_mutex_unlock (&dxf_profile_mutex);
+}
+
+
+/*!
+ * \brief Find or allocate the slot for a name in a slot array.
+ *
+ * Linear scan: the arrays hold a dozen or two distinct names and the
+ * accumulation sites fire once per section or record, not per field.
+ *
+ * \return a pointer to the slot, or \c NULL when the array is full.
+ */
+static DxfProfileSlot *
+dxf_profile_slot
+(
+        DxfProfileSlot *slots,
+                /*!< the slot array to search. */
+        size_t capacity,
+                /*!< capacity of the slot array. */
+        size_t *length,
+                /*!< number of used slots, updated on allocation. */
+        const char *name
+                /*!< the section or entity type name. */
+)
+{
+        size_t i;
+
+        for (i = 0; i < *length; i++)
+        {
+                if (strcmp (slots[i].name, name) == 0)
+                {
+                        return (&slots[i]);
+                }
+        }
+        if (*length == capacity)
+        {
+                return (NULL);
+        }
+        i = (*length)++;
+        strncpy (slots[i].name, name, DXF_PROFILE_NAME_SIZE - 1);
+        slots[i].name[DXF_PROFILE_NAME_SIZE - 1] = '\0';
+        return (&slots[i]);
+}
+
+
+/*!
+ * \brief Accumulate one parsed section into the profile.
+ */
+void
+dxf_profile_section_add
+(
+        const char *name,
+                /*!< the section name. */
+        uint64_t ns,
+                /*!< wall time spent parsing the section in
+                 * nanoseconds. */
+        uint64_t bytes
+                /*!< number of bytes the section consumed. */
+)
+{
+        DxfProfileSlot *slot;
+
+        if (name == NULL)
+        {
+                return;
+        }
+        pthread_mutex_lock (&dxf_profile_mutex);
+        slot = dxf_profile_slot (dxf_profile_state.sections,
+                DXF_PROFILE_MAX_SECTIONS,
+                &dxf_profile_state.number_sections, name);
+        if (slot != NULL)
+        {
+                slot->ns += ns;
+                slot->count++;
+                slot->bytes += bytes;
+        }
+        pthread_mutex_unlock (&dxf_profile_mutex);
+}
+
+
+/*!
+ * \brief Accumulate one parsed entity into the profile.
+ */
+void
+dxf_profile_entity_add
+(
+        const char *name,
+                /*!< the entity type name. */
+        uint64_t ns
+                /*!< wall time spent parsing the record in
+                 * nanoseconds. */
+)
+{
+        DxfProfileSlot *slot;
+
+        if (name == NULL)
+        {
+                return;
+        }
+        pthread_mutex_lock (&dxf_profile_mutex);
+        slot = dxf_profile_slot (dxf_profile_state.entities,
+                DXF_PROFILE_MAX_ENTITY_TYPES,
+                &dxf_profile_state.number_entity_types, name);
+        if (slot != NULL)
+        {
+                slot->ns += ns;
+                slot->count++;
+        }
+        pthread_mutex_unlock (&dxf_profile_mutex);
+}
+
+
+/*!
+ * \brief Get the process wide profile.
+ *
+ * \return a pointer to the profile; read it between parses, not
+ * while one is accumulating.
+ */
+const DxfProfile *
+dxf_profile_get ()
+{
+        return (&dxf_profile_state);
+}
+
+
+/*!
+ * \brief Get the process wide allocation and copy counters.
+ *
+ * \return a pointer to the counters; read them between parses, not
+ * while one is accumulating.
+ */
+const DxfProfileCounters *
+dxf_profile_counters ()
+{
+        return (&dxf_profile_counter_state);
+}
+
+
+/*!
+ * \brief Dump the profile as one JSON object.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_profile_dump_json
+(
+        FILE *stream
+                /*!< the stream to print to. */
+)
+{
+        const DxfProfileSlot *slot;
+        size_t i;
+
+        if (stream == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        pthread_mutex_lock (&dxf_profile_mutex);
+        fprintf (stream, "{\"sections\":[");
+        for (i = 0; i < dxf_profile_state.number_sections; i++)
+        {
+                slot = &dxf_profile_state.sections[i];
+                fprintf (stream,
+                  "%s{\"name\":\"%s\",\"ns\":%" PRIu64 ",\"count\":%" PRIu64 ",\"bytes\":%" PRIu64 "}",
+                  (i > 0) ? "," : "",
+                  slot->name, slot->ns, slot->count, slot->bytes);
+        }
+        fprintf (stream, "],\"entities\":[");
+        for (i = 0; i < dxf_profile_state.number_entity_types; i++)
+        {
+                slot = &dxf_profile_state.entities[i];
+                fprintf (stream,
+                  "%s{\"name\":\"%s\",\"ns\":%" PRIu64 ",\"count\":%" PRIu64 "}",
+                  (i > 0) ? "," : "",
+                  slot->name, slot->ns, slot->count);
+        }
+        fprintf (stream,
+          "],\"counters\":{\"mallocs\":%" PRIu64 ",\"free_list_hits\":%" PRIu64
+          ",\"strdups\":%" PRIu64 ",\"strdup_bytes\":%" PRIu64
+          ",\"arena_allocs\":%" PRIu64 ",\"read_bytes\":%" PRIu64 "}}\n",
+          dxf_profile_counter_state.mallocs,
+          dxf_profile_counter_state.free_list_hits,
+          dxf_profile_counter_state.strdups,
+          dxf_profile_counter_state.strdup_bytes,
+          dxf_profile_counter_state.arena_allocs,
+          dxf_profile_counter_state.read_bytes);
+        pthread_mutex_unlock (&dxf_profile_mutex);
+        return (EXIT_SUCCESS);
+}
+
+
+/* EOF */
@@ -0,0 +1,176 @@
+/*!
+ * \file profile.h
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Header for the parse timing instrumentation.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#ifndef LIBDXF_SRC_PROFILE_H
+#define LIBDXF_SRC_PROFILE_H
+
+
+#include "global.h"
+
+
+/*!
+ * Parse timing instrumentation on/off toggle.
+ *
+ * Compile with -DDXF_PROFILE=1 to record wall time and bytes per
+ * section and wall time and count per entity type while parsing; the
+ * default 0 compiles every instrumentation site out of the hot
+ * loops.
+ */
+#ifndef DXF_PROFILE
+#  define DXF_PROFILE 0
+#endif
+
+
+/*!
+ * Number of distinct section names the profile can hold.
+ */
+#define DXF_PROFILE_MAX_SECTIONS 16
+
+
+/*!
+ * Number of distinct entity type names the profile can hold.
+ */
+#define DXF_PROFILE_MAX_ENTITY_TYPES 32
+
+
+/*!
+ * Size of a recorded section or entity type name in bytes,
+ * terminating NUL included.
+ */
+#define DXF_PROFILE_NAME_SIZE 24
+
+
+/*!
+ * \brief Accumulated figures for one section or entity type.
+ */
+typedef struct
+dxf_profile_slot
+{
+        char name[DXF_PROFILE_NAME_SIZE];
+                /*!< the section or entity type name. */
+        uint64_t ns;
+                /*!< accumulated wall time in nanoseconds. */
+        uint64_t count;
+                /*!< number of occurrences. */
+        uint64_t bytes;
+                /*!< accumulated bytes consumed (sections only). */
+} DxfProfileSlot;
+
+
+/*!
+ * \brief Allocation and copy counters of the hot paths.
+ *
+ * Incremented with relaxed atomics at the central allocation tap
+ * points, so CI regression gates can assert figures of the form
+ * "parsing this example must not exceed N allocations".
+ */
+typedef struct
+dxf_profile_counters
+{
+        uint64_t mallocs;
+                /*!< allocations which went to the system allocator. */
+        uint64_t free_list_hits;
+                /*!< entity allocations served from the recycling
+                 * free lists (see allocator.h). */
+        uint64_t strdups;
+                /*!< string values duplicated while reading. */
+        uint64_t strdup_bytes;
+                /*!< bytes copied duplicating string values. */
+        uint64_t arena_allocs;
+                /*!< allocations served by a bump arena (see
+                 * arena.h). */
+        uint64_t read_bytes;
+                /*!< bytes copied from the input into the reader's
+                 * block buffer. */
+} DxfProfileCounters;
+
+
+/*!
+ * \brief The process wide parse profile.
+ *
+ * One profile for the process, so fleet telemetry can grab the
+ * figures after any number of parses without threading state through
+ * the readers; accumulation is serialized internally.
+ */
+typedef struct
+dxf_profile
+{
+        DxfProfileSlot sections[DXF_PROFILE_MAX_SECTIONS];
+                /*!< per-section figures. */
+        size_t number_sections;
+                /*!< number of used section slots. */
+        DxfProfileSlot entities[DXF_PROFILE_MAX_ENTITY_TYPES];
+                /*!< per-entity-type figures. */
+        size_t number_entity_types;
+                /*!< number of used entity type slots. */
+} DxfProfile;
+
+
+extern DxfProfileCounters dxf_profile_counter_state;
+
+
+uint64_t dxf_profile_now ();
+void dxf_profile_reset ();
+void dxf_profile_section_add (const char *name, uint64_t ns, uint64_t bytes);
+void dxf_profile_entity_add (const char *name, uint64_t ns);
+const DxfProfile *dxf_profile_get ();
+const DxfProfileCounters *dxf_profile_counters ();
+int dxf_profile_dump_json (FILE *stream);
+
+
+#if DXF_PROFILE
+#define DXF_PROFILE_DECL(t) uint64_t t = 0
+#define DXF_PROFILE_START(t) t = dxf_profile_now ()
+#define DXF_PROFILE_SECTION(name, t, bytes) \
+        dxf_profile_section_add (name, dxf_profile_now () - (t), bytes)
+#define DXF_PROFILE_ENTITY(name, t) \
+        dxf_profile_entity_add (name, dxf_profile_now () - (t))
+#define DXF_PROFILE_COUNT(member) \
+        __atomic_fetch_add (&dxf_profile_counter_state.member, 1, __ATOMIC_RELAXED)
+#define DXF_PROFILE_COUNT_ADD(member, n) \
+        __atomic_fetch_add (&dxf_profile_counter_state.member, (uint64_t) (n), __ATOMIC_RELAXED)
+#else
+#define DXF_PROFILE_DECL(t)
+#define DXF_PROFILE_START(t)
+#define DXF_PROFILE_SECTION(name, t, bytes)
+#define DXF_PROFILE_ENTITY(name, t)
+#define DXF_PROFILE_COUNT(member) ((void) 0)
+#define DXF_PROFILE_COUNT_ADD(member, n) ((void) 0)
+#endif
+
+
+#endif /* LIBDXF_SRC_PROFILE_H */
+
+
+/* EOF */
@@ -0,0 +1,624 @@
+/*!
+ * \file quad_cloud.c
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Functions for deduplicated bulk storage of \c SOLID and
+ * \c TRACE entities.
+ *
+ * Copper pour exports emit filled four-corner areas in runs of
+ * thousands which differ only in coordinates, yet each parsed struct
+ * used to carry its own copies of the layer and display metadata.\n
+ * The cloud groups consecutive metadata-sharing quads into runs: one
+ * header entity holds the shared members and the corners live in the
+ * structure-of-arrays container also used for \c 3DFACE batches (see
+ * \c DxfSoaFaces), which keeps numeric passes over the pours
+ * vectorizable.\n
+ * \c SOLID and \c TRACE carry identical members and write the same
+ * record apart from the entity name, so one cloud stores both; the
+ * batched writer replays a run through one precomputed record
+ * skeleton instead of re-checking the metadata per quad.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#include "quad_cloud.h"
+
+
+/*!
+ * \brief Compare two strings for equality, treating \c NULL as the
+ * empty string.
+ *
+ * \return \c TRUE when equal, \c FALSE otherwise.
+ */
+static int
+dxf_quad_cloud_string_equal
+(
+        const char *a,
+                /*!< first string, or \c NULL. */
+        const char *b
+                /*!< second string, or \c NULL. */
+)
+{
+        if (a == NULL)
+        {
+                a = "";
+        }
+        if (b == NULL)
+        {
+                b = "";
+        }
+        return (strcmp (a, b) == 0);
+}
+
+
+/*!
+ * \brief Test whether a quad shares its metadata with a run header.
+ *
+ * The \c id_code is deliberately not compared: per-quad handles are
+ * not retained in cloud storage.
+ *
+ * \return \c TRUE when the quad extends the run, \c FALSE otherwise.
+ */
+static int
+dxf_quad_cloud_run_matches
+(
+        DxfQuadCloudRun *run,
+                /*!< the run to test against. */
+        DxfSolid *solid,
+                /*!< the parsed entity. */
+        int trace
+                /*!< \c TRUE for a \c TRACE entity, \c FALSE for a
+                 * \c SOLID. */
+)
+{
+        return ((run->trace == trace)
+                && dxf_quad_cloud_string_equal (run->header.layer, solid->layer)
+                && dxf_quad_cloud_string_equal (run->header.linetype, solid->linetype)
+                && dxf_quad_cloud_string_equal (run->header.dictionary_owner_soft, solid->dictionary_owner_soft)
+                && dxf_quad_cloud_string_equal (run->header.dictionary_owner_hard, solid->dictionary_owner_hard)
+                && (run->header.elevation == solid->elevation)
+                && (run->header.thickness == solid->thickness)
+                && (run->header.linetype_scale == solid->linetype_scale)
+                && (run->header.visibility == solid->visibility)
+                && (run->header.color == solid->color)
+                && (run->header.paperspace == solid->paperspace)
+                && (run->header.extr_x0 == solid->extr_x0)
+                && (run->header.extr_y0 == solid->extr_y0)
+                && (run->header.extr_z0 == solid->extr_z0));
+}
+
+
+/*!
+ * \brief Start a new run with the metadata of a quad.
+ *
+ * \return a pointer to the run, or \c NULL when no memory was
+ * allocated.
+ */
+static DxfQuadCloudRun *
+dxf_quad_cloud_run_new
+(
+        DxfSolid *solid,
+                /*!< the parsed entity. */
+        int trace
+                /*!< \c TRUE for a \c TRACE entity, \c FALSE for a
+                 * \c SOLID. */
+)
+{
+        DxfQuadCloudRun *run;
+
+        run = calloc (1, sizeof (DxfQuadCloudRun));
+        if (run == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        run->corners = dxf_soa_faces_new ();
+        if (run->corners == NULL)
+        {
+                free (run);
+                return (NULL);
+        }
+        memcpy (&run->header, solid, sizeof (DxfSolid));
+        run->header.id_code = -1;
+        run->header.x0 = 0.0;
+        run->header.y0 = 0.0;
+        run->header.z0 = 0.0;
+        run->header.x1 = 0.0;
+        run->header.y1 = 0.0;
+        run->header.z1 = 0.0;
+        run->header.x2 = 0.0;
+        run->header.y2 = 0.0;
+        run->header.z2 = 0.0;
+        run->header.x3 = 0.0;
+        run->header.y3 = 0.0;
+        run->header.z3 = 0.0;
+        run->header.next = NULL;
+        run->header.layer = strdup ((solid->layer != NULL) ? solid->layer : "");
+        run->header.linetype = strdup ((solid->linetype != NULL) ? solid->linetype : "");
+        run->header.dictionary_owner_soft = strdup ((solid->dictionary_owner_soft != NULL) ? solid->dictionary_owner_soft : "");
+        run->header.dictionary_owner_hard = strdup ((solid->dictionary_owner_hard != NULL) ? solid->dictionary_owner_hard : "");
+        run->trace = trace;
+        return (run);
+}
+
+
+/*!
+ * \brief Append a quad to a quad cloud.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+static int
+dxf_quad_cloud_append
+(
+        DxfQuadCloud *cloud,
+                /*!< the cloud to append to. */
+        DxfSolid *solid,
+                /*!< the parsed entity. */
+        int trace
+                /*!< \c TRUE for a \c TRACE entity, \c FALSE for a
+                 * \c SOLID. */
+)
+{
+        DxfQuadCloudRun *run;
+        Dxf3dface corners;
+
+        if ((cloud == NULL) || (solid == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        run = cloud->tail;
+        if ((run == NULL) || (!dxf_quad_cloud_run_matches (run, solid, trace)))
+        {
+                run = dxf_quad_cloud_run_new (solid, trace);
+                if (run == NULL)
+                {
+                        return (EXIT_FAILURE);
+                }
+                if (cloud->tail == NULL)
+                {
+                        cloud->runs = run;
+                }
+                else
+                {
+                        cloud->tail->next = run;
+                }
+                cloud->tail = run;
+                cloud->number_runs++;
+        }
+        memset (&corners, 0, sizeof (corners));
+        corners.x0 = solid->x0;
+        corners.y0 = solid->y0;
+        corners.z0 = solid->z0;
+        corners.x1 = solid->x1;
+        corners.y1 = solid->y1;
+        corners.z1 = solid->z1;
+        corners.x2 = solid->x2;
+        corners.y2 = solid->y2;
+        corners.z2 = solid->z2;
+        corners.x3 = solid->x3;
+        corners.y3 = solid->y3;
+        corners.z3 = solid->z3;
+        if (dxf_soa_faces_append (run->corners, &corners) != EXIT_SUCCESS)
+        {
+                return (EXIT_FAILURE);
+        }
+        cloud->length++;
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Allocate an empty quad cloud.
+ *
+ * \return a pointer to the cloud, or \c NULL when no memory was
+ * allocated.
+ */
+DxfQuadCloud *
+dxf_quad_cloud_new ()
+{
+        DxfQuadCloud *cloud;
+
+        cloud = calloc (1, sizeof (DxfQuadCloud));
+        if (cloud == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+        }
+        return (cloud);
+}
+
+
+/*!
+ * \brief Append a \c SOLID entity to a quad cloud.
+ *
+ * The quad extends the current run when its metadata matches the run
+ * header; otherwise a new run is started, so files which interleave
+ * layers degrade gracefully into shorter runs instead of failing.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_quad_cloud_append_solid
+(
+        DxfQuadCloud *cloud,
+                /*!< the cloud to append to. */
+        DxfSolid *solid
+                /*!< the parsed \c SOLID entity. */
+)
+{
+        return (dxf_quad_cloud_append (cloud, solid, FALSE));
+}
+
+
+/*!
+ * \brief Append a \c TRACE entity to a quad cloud.
+ *
+ * \c TRACE carries the same members as \c SOLID, so the entity is
+ * stored through the shared run machinery with only the entity kind
+ * recorded per run.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_quad_cloud_append_trace
+(
+        DxfQuadCloud *cloud,
+                /*!< the cloud to append to. */
+        DxfTrace *trace
+                /*!< the parsed \c TRACE entity. */
+)
+{
+        return (dxf_quad_cloud_append (cloud, (DxfSolid *) trace, TRUE));
+}
+
+
+/*!
+ * \brief Rebuild a quad from a quad cloud.
+ *
+ * The corners come from the structure-of-arrays container of the run
+ * holding the indexed quad and the remaining members are copied from
+ * the run header; string members are borrowed from the header and
+ * must not be freed by the caller.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_quad_cloud_get
+(
+        DxfQuadCloud *cloud,
+                /*!< the cloud to read from. */
+        size_t index,
+                /*!< index of the stored quad, over all runs. */
+        DxfSolid *solid,
+                /*!< the entity to fill in; a \c DxfTrace may be passed
+                 * through a cast, the members are identical. */
+        int *trace
+                /*!< receives \c TRUE when the quad is a \c TRACE
+                 * entity, \c FALSE for a \c SOLID; may be \c NULL when
+                 * the kind is not of interest. */
+)
+{
+        DxfQuadCloudRun *run;
+        Dxf3dface corners;
+
+        if ((cloud == NULL) || (solid == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (index >= cloud->length)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () an out of range index was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        run = cloud->runs;
+        while (index >= run->corners->length)
+        {
+                index -= run->corners->length;
+                run = run->next;
+        }
+        if (dxf_soa_faces_get (run->corners, index, &corners) != EXIT_SUCCESS)
+        {
+                return (EXIT_FAILURE);
+        }
+        memcpy (solid, &run->header, sizeof (DxfSolid));
+        solid->x0 = corners.x0;
+        solid->y0 = corners.y0;
+        solid->z0 = corners.z0;
+        solid->x1 = corners.x1;
+        solid->y1 = corners.y1;
+        solid->z1 = corners.z1;
+        solid->x2 = corners.x2;
+        solid->y2 = corners.y2;
+        solid->z2 = corners.z2;
+        solid->x3 = corners.x3;
+        solid->y3 = corners.y3;
+        solid->z3 = corners.z3;
+        if (trace != NULL)
+        {
+                *trace = run->trace;
+        }
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Write DXF output to fp for every quad of a quad cloud.
+ *
+ * The record skeleton — everything \c dxf_solid_write and
+ * \c dxf_trace_write derive from the metadata — is formatted once per
+ * run into a prelude before and a postlude after the corner groups,
+ * so the per-quad loop only formats twelve doubles between two buffer
+ * writes.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_quad_cloud_write
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an output file (or device). */
+        DxfQuadCloud *cloud
+                /*!< the cloud to write. */
+)
+{
+        DxfQuadCloudRun *run;
+
+        if ((fp == NULL) || (cloud == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        for (run = cloud->runs; run != NULL; run = run->next)
+        {
+                DxfSolid *header;
+                DxfSoaFaces *corners;
+                char *prelude;
+                char *postlude;
+                size_t size;
+                int offset;
+                size_t i;
+
+                header = &run->header;
+                corners = run->corners;
+                size = 256
+                        + strlen (header->layer)
+                        + strlen (header->linetype)
+                        + strlen (header->dictionary_owner_soft)
+                        + strlen (header->dictionary_owner_hard);
+                prelude = malloc (size);
+                postlude = malloc (128);
+                if ((prelude == NULL) || (postlude == NULL))
+                {
+                        fprintf (stderr,
+                          (_("Error in %s () could not allocate memory.\n")),
+                          __FUNCTION__);
+                        free (prelude);
+                        free (postlude);
+                        return (EXIT_FAILURE);
+                }
+                offset = sprintf (prelude, "  0\n%s\n",
+                        run->trace ? "TRACE" : "SOLID");
+                if ((strcmp (header->dictionary_owner_soft, "") != 0)
+                  && (fp->acad_version_number >= AutoCAD_14))
+                {
+                        offset += sprintf (prelude + offset,
+                                "102\n{ACAD_REACTORS\n330\n%s\n102\n}\n",
+                                header->dictionary_owner_soft);
+                }
+                if ((strcmp (header->dictionary_owner_hard, "") != 0)
+                  && (fp->acad_version_number >= AutoCAD_14))
+                {
+                        offset += sprintf (prelude + offset,
+                                "102\n{ACAD_XDICTIONARY\n360\n%s\n102\n}\n",
+                                header->dictionary_owner_hard);
+                }
+                if (fp->acad_version_number >= AutoCAD_13)
+                {
+                        offset += sprintf (prelude + offset, "100\nAcDbEntity\n");
+                }
+                if (header->paperspace == DXF_PAPERSPACE)
+                {
+                        offset += sprintf (prelude + offset, " 67\n%d\n",
+                                DXF_PAPERSPACE);
+                }
+                offset += sprintf (prelude + offset, "  8\n%s\n", header->layer);
+                if (strcmp (header->linetype, DXF_DEFAULT_LINETYPE) != 0)
+                {
+                        offset += sprintf (prelude + offset, "  6\n%s\n",
+                                header->linetype);
+                }
+                if ((fp->acad_version_number <= AutoCAD_11)
+                  && DXF_FLATLAND
+                  && (header->elevation != 0.0))
+                {
+                        offset += sprintf (prelude + offset, " 38\n%f\n",
+                                header->elevation);
+                }
+                if (header->color != DXF_COLOR_BYLAYER)
+                {
+                        offset += sprintf (prelude + offset, " 62\n%d\n",
+                                header->color);
+                }
+                if (header->linetype_scale != 1.0)
+                {
+                        offset += sprintf (prelude + offset, " 48\n%f\n",
+                                header->linetype_scale);
+                }
+                if (header->visibility != 0)
+                {
+                        offset += sprintf (prelude + offset, " 60\n%d\n",
+                                header->visibility);
+                }
+                if (fp->acad_version_number >= AutoCAD_13)
+                {
+                        sprintf (prelude + offset, "100\nAcDbTrace\n");
+                }
+                offset = 0;
+                if (header->thickness != 0.0)
+                {
+                        offset += sprintf (postlude + offset, " 39\n%f\n",
+                                header->thickness);
+                }
+                if ((fp->acad_version_number >= AutoCAD_12)
+                        && (header->extr_x0 != 0.0)
+                        && (header->extr_y0 != 0.0)
+                        && (header->extr_z0 != 1.0))
+                {
+                        offset += sprintf (postlude + offset,
+                                "210\n%f\n220\n%f\n230\n%f\n",
+                                header->extr_x0,
+                                header->extr_y0,
+                                header->extr_z0);
+                }
+                postlude[offset] = '\0';
+                for (i = 0; i < corners->length; i++)
+                {
+                        fputs (prelude, fp->fp);
+                        fprintf (fp->fp,
+                                " 10\n%f\n 20\n%f\n 30\n%f\n"
+                                " 11\n%f\n 21\n%f\n 31\n%f\n"
+                                " 12\n%f\n 22\n%f\n 32\n%f\n"
+                                " 13\n%f\n 23\n%f\n 33\n%f\n",
+                                corners->x0[i], corners->y0[i], corners->z0[i],
+                                corners->x1[i], corners->y1[i], corners->z1[i],
+                                corners->x2[i], corners->y2[i], corners->z2[i],
+                                corners->x3[i], corners->y3[i], corners->z3[i]);
+                        fputs (postlude, fp->fp);
+                }
+                free (prelude);
+                free (postlude);
+        }
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Streaming callback storing a parsed \c SOLID entity into the
+ * cloud.
+ */
+static int
+dxf_quad_cloud_collect_solid
+(
+        DxfFile *fp,
+        DxfSolid *solid,
+        void *user_data
+)
+{
+        DxfQuadCloud *cloud = user_data;
+
+        return (dxf_quad_cloud_append_solid (cloud, solid));
+}
+
+
+/*!
+ * \brief Wire a quad cloud into a set of streaming read handlers.
+ *
+ * Installs a callback which appends every parsed \c SOLID entity into
+ * the cloud; the streaming reader carries no \c TRACE callback, so
+ * \c TRACE entities are appended by the caller through
+ * \c dxf_quad_cloud_append_trace.\n
+ * The handlers struct is zeroed first, so combine with other
+ * callbacks by setting them afterwards.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_quad_cloud_collector_init
+(
+        DxfQuadCloud *cloud,
+                /*!< the cloud to collect into; must stay alive for the
+                 * duration of the read. */
+        DxfReadHandlers *handlers
+                /*!< the streaming read handlers to initialize. */
+)
+{
+        if ((cloud == NULL) || (handlers == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        memset (handlers, 0, sizeof (DxfReadHandlers));
+        handlers->user_data = cloud;
+        handlers->solid = dxf_quad_cloud_collect_solid;
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Free a quad cloud and all its runs.
+ */
+void
+dxf_quad_cloud_free
+(
+        DxfQuadCloud *cloud
+                /*!< the cloud to free. */
+)
+{
+        DxfQuadCloudRun *run;
+        DxfQuadCloudRun *next;
+
+        if (cloud == NULL)
+        {
+                return;
+        }
+        for (run = cloud->runs; run != NULL; run = next)
+        {
+                next = run->next;
+                free (run->header.layer);
+                free (run->header.linetype);
+                free (run->header.dictionary_owner_soft);
+                free (run->header.dictionary_owner_hard);
+                dxf_soa_faces_free (run->corners);
+                free (run);
+        }
+        free (cloud);
+}
+
+
+/* EOF */
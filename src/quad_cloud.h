@@ -0,0 +1,141 @@
+/*!
+ * \file quad_cloud.h
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Header for deduplicated bulk storage of \c SOLID and
+ * \c TRACE entities.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#ifndef LIBDXF_SRC_QUAD_CLOUD_H
+#define LIBDXF_SRC_QUAD_CLOUD_H
+
+
+#include "global.h"
+#include "solid.h"
+#include "trace.h"
+#include "soa.h"
+#include "entities.h"
+
+
+/*!
+ * \brief One run of \c SOLID or \c TRACE entities sharing their
+ * metadata.
+ *
+ * Copper pour exports emit filled four-corner areas in runs of
+ * thousands which differ only in coordinates; a run stores the shared
+ * metadata once in a header entity and keeps the corners in the
+ * structure-of-arrays container also used for \c 3DFACE batches, so a
+ * quad costs twelve packed doubles instead of a full struct with
+ * string copies.
+ */
+typedef struct
+dxf_quad_cloud_run
+{
+        DxfSolid header;
+                /*!< the shared metadata of the run; the corner members
+                 * are unused and the \c id_code is \c -1, as per-quad
+                 * handles are not retained in cloud storage.\n
+                 * \c SOLID and \c TRACE carry identical members, so
+                 * one header type serves both. */
+        int trace;
+                /*!< \c TRUE when the run holds \c TRACE entities,
+                 * \c FALSE for \c SOLID. */
+        DxfSoaFaces *corners;
+                /*!< the corner coordinates, in parallel arrays (the
+                 * invisible edge flags of the container are unused
+                 * and stay 0). */
+        struct dxf_quad_cloud_run *next;
+                /*!< the next run of the cloud. */
+} DxfQuadCloudRun;
+
+
+/*!
+ * \brief A quad cloud: runs of metadata-sharing \c SOLID and \c TRACE
+ * entities in file order.
+ */
+typedef struct
+dxf_quad_cloud
+{
+        DxfQuadCloudRun *runs;
+                /*!< the runs, in order of appending. */
+        DxfQuadCloudRun *tail;
+                /*!< the run currently being extended. */
+        size_t length;
+                /*!< total number of quads over all runs. */
+        size_t number_runs;
+                /*!< number of runs in the cloud. */
+} DxfQuadCloud;
+
+
+DxfQuadCloud *
+dxf_quad_cloud_new ();
+int
+dxf_quad_cloud_append_solid
+(
+        DxfQuadCloud *cloud,
+        DxfSolid *solid
+);
+int
+dxf_quad_cloud_append_trace
+(
+        DxfQuadCloud *cloud,
+        DxfTrace *trace
+);
+int
+dxf_quad_cloud_get
+(
+        DxfQuadCloud *cloud,
+        size_t index,
+        DxfSolid *solid,
+        int *trace
+);
+int
+dxf_quad_cloud_write
+(
+        DxfFile *fp,
+        DxfQuadCloud *cloud
+);
+int
+dxf_quad_cloud_collector_init
+(
+        DxfQuadCloud *cloud,
+        DxfReadHandlers *handlers
+);
+void
+dxf_quad_cloud_free
+(
+        DxfQuadCloud *cloud
+);
+
+
+#endif /* LIBDXF_SRC_QUAD_CLOUD_H */
+
+
+/* EOF */
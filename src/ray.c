@@ -34,7 +34,10 @@
  */
 
 
+#include <pthread.h>
 #include "ray.h"
+#include "diag.h"
+#include "allocator.h"
 
 
 /*!
@@ -63,7 +66,7 @@ dxf_ray_new ()
         size = sizeof (DxfRay);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_ray = malloc (size)) == NULL)
+        if ((dxf_ray = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfRay struct.\n")),
@@ -103,6 +106,11 @@ dxf_ray_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfRay template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         /* Do some basic checks. */
         if (dxf_ray == NULL)
         {
@@ -118,24 +126,35 @@ dxf_ray_init
                 __FUNCTION__);
               return (NULL);
         }
-        dxf_ray->id_code = 0;
-        dxf_ray->linetype = strdup (DXF_DEFAULT_LINETYPE);
-        dxf_ray->layer = strdup (DXF_DEFAULT_LAYER);
-        dxf_ray->x0 = 0.0;
-        dxf_ray->y0 = 0.0;
-        dxf_ray->z0 = 0.0;
-        dxf_ray->x1 = 0.0;
-        dxf_ray->y1 = 0.0;
-        dxf_ray->z1 = 0.0;
-        dxf_ray->elevation = 0.0;
-        dxf_ray->thickness = 0.0;
-        dxf_ray->linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
-        dxf_ray->visibility = DXF_DEFAULT_VISIBILITY;
-        dxf_ray->color = DXF_COLOR_BYLAYER;
-        dxf_ray->paperspace = DXF_MODELSPACE;
-        dxf_ray->dictionary_owner_soft = strdup ("");
-        dxf_ray->dictionary_owner_hard = strdup ("");
-        dxf_ray->next = NULL;
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.id_code = 0;
+                template.linetype = strdup (DXF_DEFAULT_LINETYPE);
+                template.layer = strdup (DXF_DEFAULT_LAYER);
+                template.x0 = 0.0;
+                template.y0 = 0.0;
+                template.z0 = 0.0;
+                template.x1 = 0.0;
+                template.y1 = 0.0;
+                template.z1 = 0.0;
+                template.elevation = 0.0;
+                template.thickness = 0.0;
+                template.linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
+                template.visibility = DXF_DEFAULT_VISIBILITY;
+                template.color = DXF_COLOR_BYLAYER;
+                template.paperspace = DXF_MODELSPACE;
+                template.dictionary_owner_soft = strdup ("");
+                template.dictionary_owner_hard = strdup ("");
+                template.next = NULL;
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (dxf_ray, &template, sizeof (DxfRay));
+        dxf_ray->linetype = strdup (template.linetype);
+        dxf_ray->layer = strdup (template.layer);
+        dxf_ray->dictionary_owner_soft = strdup (template.dictionary_owner_soft);
+        dxf_ray->dictionary_owner_hard = strdup (template.dictionary_owner_hard);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -173,7 +192,7 @@ dxf_ray_read
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        char *temp_string = NULL;
+        char temp_string[DXF_MAX_STRING_LENGTH];
 
         /* Do some basic checks. */
         if (fp == NULL)
@@ -198,7 +217,7 @@ dxf_ray_read
                 if (ferror (fp->fp))
                 {
                         fprintf (stderr,
-                          (_("Error in %s () while reading from: %s in line: %d.\n")),
+                          (_("Error in %s () while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                         fclose (fp->fp);
                         return (NULL);
@@ -215,13 +234,17 @@ dxf_ray_read
                         /* Now follows a string containing a linetype
                          * name. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_ray->linetype);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_ray->linetype);
+                        dxf_ray->linetype = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "8") == 0)
                 {
                         /* Now follows a string containing a layer name. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_ray->layer);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_ray->layer);
+                        dxf_ray->layer = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "10") == 0)
                 {
@@ -320,7 +343,7 @@ dxf_ray_read
                         && ((strcmp (temp_string, "AcDbRay") != 0)))
                         {
                                 fprintf (stderr,
-                                  (_("Error in %s () found a bad subclass marker in: %s in line: %d.\n")),
+                                  (_("Error in %s () found a bad subclass marker in: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                         }
                 }
@@ -329,14 +352,18 @@ dxf_ray_read
                         /* Now follows a string containing Soft-pointer
                          * ID/handle to owner dictionary. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_ray->dictionary_owner_soft);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_ray->dictionary_owner_soft);
+                        dxf_ray->dictionary_owner_soft = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "360") == 0)
                 {
                         /* Now follows a string containing Hard owner
                          * ID/handle to owner dictionary. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_ray->dictionary_owner_hard);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_ray->dictionary_owner_hard);
+                        dxf_ray->dictionary_owner_hard = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "999") == 0)
                 {
@@ -347,8 +374,8 @@ dxf_ray_read
                 }
                 else
                 {
-                        fprintf (stderr,
-                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %d.\n")),
+                        dxf_diag_report (fp, DXF_DIAG_WARNING,
+                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                 }
         }
@@ -563,7 +590,7 @@ dxf_ray_free
         free (dxf_ray->layer);
         free (dxf_ray->dictionary_owner_soft);
         free (dxf_ray->dictionary_owner_hard);
-        free (dxf_ray);
+        dxf_entity_dealloc (dxf_ray, sizeof (*dxf_ray));
         dxf_ray = NULL;
 #if DEBUG
         DXF_DEBUG_END
@@ -0,0 +1,687 @@
+/*!
+ * \file recode.c
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Functions for the streaming DXF version re-encoder.
+ *
+ * Migrating a file to another DXF version through \c dxf_file_read
+ * and \c dxf_file_write materializes every entity just to change a
+ * handful of records, which makes a batch migration pay the full
+ * parse and the full document memory per file.\n
+ * The re-encoder instead maps records version-to-version on the fly:
+ * it pulls records through the pull parser (see parser.c), rewrites
+ * \c $ACADVER, drops header variables the target version does not
+ * carry (per the version ranges of the header write table, see
+ * \c dxf_header_variable_version_range), injects the \c AcDbEntity
+ * and per-type subclass markers an R13+ target expects, strips the
+ * markers and R13+ only group codes for an R12 target, and copies
+ * every other record through the buffered writer untouched.\n
+ * Memory use is O(1) in the file size and the common pass-through
+ * record costs one pull and one buffered append.\n
+ * Entity types a target version lacks (e.g. \c LWPOLYLINE in R12)
+ * are copied through unchanged, not rewritten to an older
+ * equivalent.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#include "recode.h"
+#include "header.h"
+#include "parser.h"
+#include "util.h"
+#include "writer.h"
+
+
+/*!
+ * \brief The subclass markers of one entity type, as injected for an
+ * R13+ target.
+ *
+ * The primary marker goes in front of the first entity specific
+ * record; entity types with a second marker name the group code it
+ * precedes (or \c 0 to follow the primary marker immediately).
+ */
+typedef struct
+dxf_recode_subclass
+{
+        const char *entity_name;
+                /*!< the DXF entity type name. */
+        const char *primary;
+                /*!< the subclass marker in front of the entity
+                 * specific records. */
+        int primary_code;
+                /*!< the group code the primary marker precedes, or
+                 * \c 0 to place it in front of the first record
+                 * beyond the common entity ones. */
+        const char *secondary;
+                /*!< the second subclass marker, or \c NULL. */
+        int secondary_code;
+                /*!< the group code the second marker precedes, or
+                 * \c 0 to emit it right after the primary one. */
+} DxfRecodeSubclass;
+
+
+/*!
+ * The subclass markers per entity type, matching what the entity
+ * writers emit; types not listed get only \c AcDbEntity.
+ */
+static const DxfRecodeSubclass dxf_recode_subclasses[] =
+{
+        {"3DFACE", "AcDbFace", 0, NULL, 0},
+        {"ARC", "AcDbCircle", 0, "AcDbArc", 50},
+        {"ATTDEF", "AcDbText", 0, "AcDbAttributeDefinition", 3},
+        {"ATTRIB", "AcDbText", 0, "AcDbAttribute", 2},
+        {"BLOCK", "AcDbBlockBegin", 0, NULL, 0},
+        {"CIRCLE", "AcDbCircle", 0, NULL, 0},
+        {"DIMENSION", "AcDbDimension", 0, NULL, 0},
+        {"ELLIPSE", "AcDbEllipse", 0, NULL, 0},
+        {"ENDBLK", "AcDbBlockEnd", 0, NULL, 0},
+        {"HATCH", "AcDbHatch", 0, NULL, 0},
+        {"INSERT", "AcDbBlockReference", 0, NULL, 0},
+        {"LINE", "AcDbLine", 0, NULL, 0},
+        {"LWPOLYLINE", "AcDbPolyline", 0, NULL, 0},
+        {"MTEXT", "AcDbMText", 0, NULL, 0},
+        {"POINT", "AcDbPoint", 0, NULL, 0},
+        {"POLYLINE", "AcDb2dPolyline", 0, NULL, 0},
+        {"RAY", "AcDbRay", 0, NULL, 0},
+        {"SHAPE", "AcDbShape", 0, NULL, 0},
+        {"SOLID", "AcDbTrace", 0, NULL, 0},
+        {"SPLINE", "AcDbSpline", 0, NULL, 0},
+        {"TEXT", "AcDbText", 0, NULL, 0},
+        {"TRACE", "AcDbTrace", 0, NULL, 0},
+        {"VERTEX", "AcDbVertex", 0, "AcDb2dVertex", 0},
+        {"VIEWPORT", "AcDbViewport", 0, NULL, 0},
+        {"XLINE", "AcDbXline", 0, NULL, 0},
+};
+
+
+/*!
+ * The subclass markers per symbol table record type of the \c TABLES
+ * section; the record markers go in front of the \c 2 name record,
+ * the \c AcDbSymbolTable marker of a \c TABLE head in front of its
+ * \c 70 maximum count record.
+ */
+static const DxfRecodeSubclass dxf_recode_table_subclasses[] =
+{
+        {"APPID", "AcDbSymbolTableRecord", 2, "AcDbRegAppTableRecord", 0},
+        {"BLOCK_RECORD", "AcDbSymbolTableRecord", 2, "AcDbBlockTableRecord", 0},
+        {"DIMSTYLE", "AcDbSymbolTableRecord", 2, "AcDbDimStyleTableRecord", 0},
+        {"LAYER", "AcDbSymbolTableRecord", 2, "AcDbLayerTableRecord", 0},
+        {"LTYPE", "AcDbSymbolTableRecord", 2, "AcDbLinetypeTableRecord", 0},
+        {"STYLE", "AcDbSymbolTableRecord", 2, "AcDbTextStyleTableRecord", 0},
+        {"TABLE", "AcDbSymbolTable", 70, NULL, 0},
+        {"UCS", "AcDbSymbolTableRecord", 2, "AcDbUCSTableRecord", 0},
+        {"VIEW", "AcDbSymbolTableRecord", 2, "AcDbViewTableRecord", 0},
+        {"VPORT", "AcDbSymbolTableRecord", 2, "AcDbViewportTableRecord", 0},
+};
+
+
+/*!
+ * \brief Look the subclass markers of an entity or table record type
+ * up.
+ *
+ * \return the markers, or \c NULL for an unlisted type.
+ */
+static const DxfRecodeSubclass *
+dxf_recode_subclass_get
+(
+        const DxfRecodeSubclass *table,
+                /*!< the marker table to search. */
+        size_t length,
+                /*!< number of entries in \c table. */
+        const char *entity_name
+                /*!< the DXF entity type name. */
+)
+{
+        size_t i;
+
+        for (i = 0; i < length; i++)
+        {
+                if (strcmp (table[i].entity_name, entity_name) == 0)
+                {
+                        return (&table[i]);
+                }
+        }
+        return (NULL);
+}
+
+
+/*!
+ * \brief Test whether a group code belongs to the common entity
+ * prelude, in front of the \c AcDbEntity marker of an R13+ file.
+ */
+static int
+dxf_recode_prelude_code
+(
+        int group_code
+                /*!< the group code to classify. */
+)
+{
+        return ((group_code == 5) || (group_code == 102)
+                || (group_code == 330) || (group_code == 360));
+}
+
+
+/*!
+ * \brief Test whether a group code belongs to the common entity
+ * records, in front of the per-type subclass marker of an R13+ file.
+ */
+static int
+dxf_recode_common_code
+(
+        int group_code
+                /*!< the group code to classify. */
+)
+{
+        return (dxf_recode_prelude_code (group_code)
+                || (group_code == 6) || (group_code == 8)
+                || (group_code == 48) || (group_code == 60)
+                || (group_code == 62) || (group_code == 67)
+                || (group_code == 370) || (group_code == 410)
+                || (group_code == 420) || (group_code == 430)
+                || (group_code == 440));
+}
+
+
+/*!
+ * \brief Test whether a group code exists before R13; records with
+ * later codes are dropped for an R12 target.
+ */
+static int
+dxf_recode_code_until_r12
+(
+        int group_code
+                /*!< the group code to classify. */
+)
+{
+        if (group_code == 100)
+        {
+                return (FALSE);
+        }
+        if ((group_code >= 330) && (group_code <= 369))
+        {
+                return (FALSE);
+        }
+        if ((group_code >= 370) && (group_code <= 399))
+        {
+                return (FALSE);
+        }
+        if ((group_code >= 420) && (group_code <= 449))
+        {
+                return (FALSE);
+        }
+        return (TRUE);
+}
+
+
+/*!
+ * \brief The per-entity injection state of one
+ * \c dxf_recode_stream invocation.
+ */
+typedef struct
+dxf_recode_state
+{
+        const DxfRecodeSubclass *subclass;
+                /*!< the markers of the current entity type, or
+                 * \c NULL. */
+        int need_entity_marker;
+                /*!< \c AcDbEntity still to inject for the current
+                 * entity. */
+        int need_primary;
+                /*!< the primary subclass marker still to inject. */
+        int need_secondary;
+                /*!< the second subclass marker still to inject. */
+} DxfRecodeState;
+
+
+/*!
+ * \brief Emit the subclass markers still pending for the current
+ * entity, in front of the record carrying \c group_code.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+static int
+dxf_recode_inject_markers
+(
+        DxfFile *out,
+                /*!< DXF file pointer to the output file. */
+        DxfRecodeState *state,
+                /*!< the per-entity injection state. */
+        int group_code
+                /*!< the group code of the record about to be
+                 * written; \c 0 flushes every pending marker. */
+)
+{
+        if (state->need_entity_marker
+                && ((group_code == 0)
+                        || (!dxf_recode_prelude_code (group_code))))
+        {
+                if (dxf_write_group_string (out, 100, "AcDbEntity") != EXIT_SUCCESS)
+                {
+                        return (EXIT_FAILURE);
+                }
+                state->need_entity_marker = FALSE;
+        }
+        if (state->need_primary
+                && ((group_code == 0)
+                        || ((state->subclass->primary_code != 0)
+                                ? (group_code == state->subclass->primary_code)
+                                : (!dxf_recode_common_code (group_code)))))
+        {
+                if (dxf_write_group_string (out, 100,
+                        state->subclass->primary) != EXIT_SUCCESS)
+                {
+                        return (EXIT_FAILURE);
+                }
+                state->need_primary = FALSE;
+                if (state->need_secondary
+                        && (state->subclass->secondary_code == 0))
+                {
+                        if (dxf_write_group_string (out, 100,
+                                state->subclass->secondary) != EXIT_SUCCESS)
+                        {
+                                return (EXIT_FAILURE);
+                        }
+                        state->need_secondary = FALSE;
+                }
+        }
+        if (state->need_secondary && (!state->need_primary)
+                && ((group_code == 0)
+                        || (group_code == state->subclass->secondary_code)))
+        {
+                if (dxf_write_group_string (out, 100,
+                        state->subclass->secondary) != EXIT_SUCCESS)
+                {
+                        return (EXIT_FAILURE);
+                }
+                state->need_secondary = FALSE;
+        }
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Re-encode a DXF stream to another version, record by record.
+ *
+ * Pulls records from \c fp and writes them to \c out for
+ * \c target_version: \c $ACADVER is rewritten, header variables
+ * outside their version range are dropped, subclass markers are
+ * injected for an R13+ target fed from an older file and stripped
+ * (along with the R13+ only group codes and the \c CLASSES and
+ * \c OBJECTS sections) for an R12 target fed from a newer file;
+ * everything else passes through byte for byte.\n
+ * The caller owns both files; a buffered writer should be attached
+ * to \c out (see \c dxf_writer_attach) and is not flushed here, so
+ * re-encoders can be chained.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_recode_stream
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to the input file (or device). */
+        DxfFile *out,
+                /*!< DXF file pointer to the output file (or device). */
+        int target_version
+                /*!< the AutoCAD version number to re-encode to. */
+)
+{
+        DxfParserRecord record;
+        DxfRecodeState state;
+        const char *target_string;
+        char section[16];
+        int source_version;
+        int upgrade;
+        int downgrade;
+        int min_version;
+        int max_version;
+        int pending_section;
+        int expect_section_name;
+        int skip_section;
+        int skip_variable;
+        int replace_acadver;
+        int in_braces;
+        int in_entities;
+        int in_tables;
+
+        if ((fp == NULL) || (out == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        target_string = dxf_header_acad_version_string (target_version);
+        if (target_string == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () an unknown target version was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        out->acad_version_number = target_version;
+        dxf_write_version_init (out);
+        source_version = fp->acad_version_number;
+        upgrade = ((source_version > 0) && (source_version < AutoCAD_13)
+                && (target_version >= AutoCAD_13));
+        downgrade = ((source_version >= AutoCAD_13)
+                && (target_version < AutoCAD_13));
+        section[0] = '\0';
+        memset (&state, 0, sizeof (state));
+        pending_section = FALSE;
+        expect_section_name = FALSE;
+        skip_section = FALSE;
+        skip_variable = FALSE;
+        replace_acadver = FALSE;
+        in_braces = FALSE;
+        in_entities = FALSE;
+        in_tables = FALSE;
+        while (dxf_parser_next (fp, &record) == FOUND)
+        {
+                if (skip_section)
+                {
+                        if ((record.group_code == 0)
+                                && (strcmp (record.string_value, "ENDSEC") == 0))
+                        {
+                                skip_section = FALSE;
+                                section[0] = '\0';
+                        }
+                        continue;
+                }
+                if (record.group_code == 0)
+                {
+                        skip_variable = FALSE;
+                        replace_acadver = FALSE;
+                        if ((in_entities || in_tables)
+                                && (dxf_recode_inject_markers (out, &state, 0)
+                                        != EXIT_SUCCESS))
+                        {
+                                return (EXIT_FAILURE);
+                        }
+                        memset (&state, 0, sizeof (state));
+                        if (strcmp (record.string_value, "SECTION") == 0)
+                        {
+                                /* held back until the section name
+                                 * decides whether the section is
+                                 * copied or dropped. */
+                                pending_section = TRUE;
+                                expect_section_name = TRUE;
+                                continue;
+                        }
+                        if (strcmp (record.string_value, "ENDSEC") == 0)
+                        {
+                                section[0] = '\0';
+                                in_entities = FALSE;
+                                in_tables = FALSE;
+                        }
+                        else if (in_entities && upgrade)
+                        {
+                                state.subclass = dxf_recode_subclass_get
+                                        (dxf_recode_subclasses,
+                                         sizeof (dxf_recode_subclasses)
+                                                / sizeof (dxf_recode_subclasses[0]),
+                                         record.string_value);
+                                state.need_entity_marker = TRUE;
+                                state.need_primary = (state.subclass != NULL);
+                                state.need_secondary = ((state.subclass != NULL)
+                                        && (state.subclass->secondary != NULL));
+                        }
+                        else if (in_tables && upgrade)
+                        {
+                                state.subclass = dxf_recode_subclass_get
+                                        (dxf_recode_table_subclasses,
+                                         sizeof (dxf_recode_table_subclasses)
+                                                / sizeof (dxf_recode_table_subclasses[0]),
+                                         record.string_value);
+                                state.need_primary = (state.subclass != NULL);
+                                state.need_secondary = ((state.subclass != NULL)
+                                        && (state.subclass->secondary != NULL));
+                        }
+                        if (dxf_write_group_string (out, 0, record.string_value)
+                                != EXIT_SUCCESS)
+                        {
+                                return (EXIT_FAILURE);
+                        }
+                        continue;
+                }
+                if (expect_section_name && (record.group_code == 2))
+                {
+                        expect_section_name = FALSE;
+                        pending_section = FALSE;
+                        strncpy (section, record.string_value,
+                                sizeof (section) - 1);
+                        section[sizeof (section) - 1] = '\0';
+                        in_entities = ((strcmp (section, "ENTITIES") == 0)
+                                || (strcmp (section, "BLOCKS") == 0));
+                        in_tables = (strcmp (section, "TABLES") == 0);
+                        if (downgrade
+                                && ((strcmp (section, "CLASSES") == 0)
+                                        || (strcmp (section, "OBJECTS") == 0)))
+                        {
+                                /* R12 has neither section. */
+                                skip_section = TRUE;
+                                continue;
+                        }
+                        if ((dxf_write_group_string (out, 0, "SECTION")
+                                        != EXIT_SUCCESS)
+                                || (dxf_write_group_string (out, 2, section)
+                                        != EXIT_SUCCESS))
+                        {
+                                return (EXIT_FAILURE);
+                        }
+                        continue;
+                }
+                if (pending_section)
+                {
+                        /* a SECTION without a name record; emit it
+                         * before the stray record. */
+                        pending_section = FALSE;
+                        expect_section_name = FALSE;
+                        if (dxf_write_group_string (out, 0, "SECTION")
+                                != EXIT_SUCCESS)
+                        {
+                                return (EXIT_FAILURE);
+                        }
+                }
+                if (strcmp (section, "HEADER") == 0)
+                {
+                        if (record.group_code == 9)
+                        {
+                                skip_variable = FALSE;
+                                replace_acadver = FALSE;
+                                if (strcmp (record.string_value, "$ACADVER") == 0)
+                                {
+                                        replace_acadver = TRUE;
+                                }
+                                else if ((dxf_header_variable_version_range
+                                                (record.string_value,
+                                                 &min_version, &max_version) == FOUND)
+                                        && ((target_version < min_version)
+                                                || (target_version > max_version)))
+                                {
+                                        skip_variable = TRUE;
+                                        continue;
+                                }
+                        }
+                        else if (skip_variable)
+                        {
+                                continue;
+                        }
+                        else if (replace_acadver && (record.group_code == 1))
+                        {
+                                if (source_version == 0)
+                                {
+                                        source_version = dxf_header_acad_version_number
+                                                (record.string_value);
+                                        fp->acad_version_number = source_version;
+                                        upgrade = ((source_version > 0)
+                                                && (source_version < AutoCAD_13)
+                                                && (target_version >= AutoCAD_13));
+                                        downgrade = ((source_version >= AutoCAD_13)
+                                                && (target_version < AutoCAD_13));
+                                }
+                                replace_acadver = FALSE;
+                                if (dxf_write_group_string (out, 1, target_string)
+                                        != EXIT_SUCCESS)
+                                {
+                                        return (EXIT_FAILURE);
+                                }
+                                continue;
+                        }
+                }
+                else if ((in_entities || in_tables) && downgrade)
+                {
+                        if (record.group_code == 102)
+                        {
+                                /* the {application ... } groups span
+                                 * records; drop the whole group. */
+                                in_braces = (record.string_value[0] == '{');
+                                continue;
+                        }
+                        if (in_braces)
+                        {
+                                continue;
+                        }
+                        if (!dxf_recode_code_until_r12 (record.group_code))
+                        {
+                                continue;
+                        }
+                }
+                else if ((in_entities || in_tables) && upgrade)
+                {
+                        if (record.group_code == 100)
+                        {
+                                /* the source carries its own markers
+                                 * after all. */
+                                state.need_entity_marker = FALSE;
+                                state.need_primary = FALSE;
+                                state.need_secondary = FALSE;
+                        }
+                        else if (dxf_recode_inject_markers (out, &state,
+                                record.group_code) != EXIT_SUCCESS)
+                        {
+                                return (EXIT_FAILURE);
+                        }
+                }
+                if (dxf_write_group_string (out, record.group_code,
+                        record.string_value) != EXIT_SUCCESS)
+                {
+                        return (EXIT_FAILURE);
+                }
+        }
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Re-encode a DXF file on disk to another version.
+ *
+ * Convenience wrapper around \c dxf_recode_stream: opens the input
+ * block buffered, attaches a buffered writer to the output and
+ * flushes it when the stream ends.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_recode_file
+(
+        const char *input_filename,
+                /*!< filename of the input file. */
+        const char *output_filename,
+                /*!< filename of the output file. */
+        int target_version
+                /*!< the AutoCAD version number to re-encode to. */
+)
+{
+        DxfFile *fp;
+        DxfFile *out;
+        int result;
+
+        if ((input_filename == NULL) || (output_filename == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        fp = dxf_read_init (input_filename);
+        if (fp == NULL)
+        {
+                return (EXIT_FAILURE);
+        }
+        dxf_read_buffer_init (fp, 0);
+        out = malloc (sizeof (DxfFile));
+        if (out == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                dxf_read_close (fp);
+                return (EXIT_FAILURE);
+        }
+        memset (out, 0, sizeof (DxfFile));
+        out->fp = fopen (output_filename, "w");
+        if (out->fp == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not open file: %s for writing.\n")),
+                  __FUNCTION__, output_filename);
+                free (out);
+                dxf_read_close (fp);
+                return (EXIT_FAILURE);
+        }
+        out->filename = strdup (output_filename);
+        out->binary_pending_code = -1;
+        if (dxf_writer_attach (out, 0) != EXIT_SUCCESS)
+        {
+                fclose (out->fp);
+                free (out->filename);
+                free (out);
+                dxf_read_close (fp);
+                return (EXIT_FAILURE);
+        }
+        result = dxf_recode_stream (fp, out, target_version);
+        if (dxf_writer_detach (out) != EXIT_SUCCESS)
+        {
+                result = EXIT_FAILURE;
+        }
+        if (fclose (out->fp) != 0)
+        {
+                result = EXIT_FAILURE;
+        }
+        free (out->filename);
+        free (out);
+        dxf_read_close (fp);
+        return (result);
+}
+
+
+/* EOF */
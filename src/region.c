@@ -32,7 +32,11 @@
  */
 
 
+#include <pthread.h>
 #include "region.h"
+#include "diag.h"
+#include "allocator.h"
+#include "util.h"
 
 
 /*!
@@ -55,7 +59,7 @@ dxf_region_new ()
         size = sizeof (DxfRegion);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_region = malloc (size)) == NULL)
+        if ((dxf_region = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfRegion struct.\n")),
@@ -93,7 +97,10 @@ dxf_region_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        int i;
+        static DxfRegion template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
 
         /* Do some basic checks. */
         if (dxf_region == NULL)
@@ -110,25 +117,33 @@ dxf_region_init
                 __FUNCTION__);
               return (NULL);
         }
-        dxf_region->modeler_format_version_number = 0;
-        dxf_region->id_code = 0;
-        dxf_region->linetype = strdup (DXF_DEFAULT_LINETYPE);
-        dxf_region->layer = strdup (DXF_DEFAULT_LAYER);
-        dxf_region->elevation = 0.0;
-        dxf_region->thickness = 0.0;
-        dxf_region->linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
-        dxf_region->visibility = DXF_DEFAULT_VISIBILITY;
-        dxf_region->color = DXF_COLOR_BYLAYER;
-        dxf_region->paperspace = DXF_MODELSPACE;
-        dxf_region->modeler_format_version_number = 1;
-        for (i = 0; i < DXF_MAX_PARAM; i++)
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
         {
-                dxf_region->proprietary_data[i] = strdup ("");
-                dxf_region->additional_proprietary_data[i] = strdup ("");
+                template.modeler_format_version_number = 0;
+                template.id_code = 0;
+                template.linetype = strdup (DXF_DEFAULT_LINETYPE);
+                template.layer = strdup (DXF_DEFAULT_LAYER);
+                template.elevation = 0.0;
+                template.thickness = 0.0;
+                template.linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
+                template.visibility = DXF_DEFAULT_VISIBILITY;
+                template.color = DXF_COLOR_BYLAYER;
+                template.paperspace = DXF_MODELSPACE;
+                template.modeler_format_version_number = 1;
+                dxf_acis_data_init (&template.proprietary_data);
+                dxf_acis_data_init (&template.additional_proprietary_data);
+                template.dictionary_owner_soft = strdup ("");
+                template.dictionary_owner_hard = strdup ("");
+                template.next = NULL;
+                template_ready = 1;
         }
-        dxf_region->dictionary_owner_soft = strdup ("");
-        dxf_region->dictionary_owner_hard = strdup ("");
-        dxf_region->next = NULL;
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (dxf_region, &template, sizeof (DxfRegion));
+        dxf_region->linetype = strdup (template.linetype);
+        dxf_region->layer = strdup (template.layer);
+        dxf_region->dictionary_owner_soft = strdup (template.dictionary_owner_soft);
+        dxf_region->dictionary_owner_hard = strdup (template.dictionary_owner_hard);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -163,12 +178,8 @@ dxf_region_read
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        char *temp_string = NULL;
-        int i;
-        int j;
+        char temp_string[DXF_MAX_STRING_LENGTH];
 
-        i = 0;
-        j = 0;
         /* Do some basic checks. */
         if (fp == NULL)
         {
@@ -185,6 +196,10 @@ dxf_region_read
                 dxf_region = dxf_region_new ();
                 dxf_region = dxf_region_init (dxf_region);
         }
+        /* discard stored lines but keep the blob of a recycled
+         * entity. */
+        dxf_acis_data_clear (&dxf_region->proprietary_data);
+        dxf_acis_data_clear (&dxf_region->additional_proprietary_data);
         (fp->line_number)++;
         fscanf (fp->fp, "%[^\n]", temp_string);
         while (strcmp (temp_string, "0") != 0)
@@ -192,26 +207,33 @@ dxf_region_read
                 if (ferror (fp->fp))
                 {
                         fprintf (stderr,
-                          (_("Error in %s () while reading from: %s in line: %d.\n")),
+                          (_("Error in %s () while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                         fclose (fp->fp);
                         return (NULL);
                 }
                 else if (strcmp (temp_string, "  1") == 0)
                 {
-                        /* Now follows a string containing proprietary
-                         * data. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_region->proprietary_data[i]);
-                        i++;
+                        /* Now follows a line of proprietary data:
+                         * read it whole through the block reader and
+                         * append it to the blob. */
+                        if (dxf_read_line (temp_string, fp) != 1)
+                        {
+                                break;
+                        }
+                        dxf_acis_data_append (&dxf_region->proprietary_data,
+                                temp_string);
                 }
                 else if (strcmp (temp_string, "  3") == 0)
                 {
-                        /* Now follows a string containing additional
-                         * proprietary data. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_region->additional_proprietary_data[j]);
-                        i++;
+                        /* Now follows a line of additional proprietary
+                         * data. */
+                        if (dxf_read_line (temp_string, fp) != 1)
+                        {
+                                break;
+                        }
+                        dxf_acis_data_append (&dxf_region->additional_proprietary_data,
+                                temp_string);
                 }
                 if (strcmp (temp_string, "5") == 0)
                 {
@@ -225,13 +247,17 @@ dxf_region_read
                         /* Now follows a string containing a linetype
                          * name. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_region->linetype);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_region->linetype);
+                        dxf_region->linetype = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "8") == 0)
                 {
                         /* Now follows a string containing a layer name. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_region->layer);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_region->layer);
+                        dxf_region->layer = strdup (temp_string);
                 }
                 else if ((fp->acad_version_number <= AutoCAD_11)
                         && (strcmp (temp_string, "38") == 0)
@@ -294,7 +320,7 @@ dxf_region_read
                         fscanf (fp->fp, "%s\n", temp_string);
                         if (strcmp (temp_string, "AcDbModelerGeometry") != 0)
                         {
-                                fprintf (stderr, "Error in dxf_region_read () found a bad subclass marker in: %s in line: %d.\n",
+                                fprintf (stderr, "Error in dxf_region_read () found a bad subclass marker in: %s in line: %ld.\n",
                                         fp->filename, fp->line_number);
                         }
                 }
@@ -303,14 +329,18 @@ dxf_region_read
                         /* Now follows a string containing Soft-pointer
                          * ID/handle to owner dictionary. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_region->dictionary_owner_soft);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_region->dictionary_owner_soft);
+                        dxf_region->dictionary_owner_soft = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "360") == 0)
                 {
                         /* Now follows a string containing Hard owner
                          * ID/handle to owner dictionary. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_region->dictionary_owner_hard);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_region->dictionary_owner_hard);
+                        dxf_region->dictionary_owner_hard = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "999") == 0)
                 {
@@ -321,8 +351,8 @@ dxf_region_read
                 }
                 else
                 {
-                        fprintf (stderr,
-                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %d.\n")),
+                        dxf_diag_report (fp, DXF_DIAG_WARNING,
+                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                 }
         }
@@ -364,7 +394,6 @@ dxf_region_write
         DXF_DEBUG_BEGIN
 #endif
         char *dxf_entity_name = strdup ("REGION");
-        int i;
 
         /* Do some basic checks. */
         if (fp == NULL)
@@ -474,18 +503,8 @@ dxf_region_write
         {
                 fprintf (fp->fp, " 70\n%d\n", dxf_region->modeler_format_version_number);
         }
-        i = 0;
-        while (strlen (dxf_region->proprietary_data[i]) > 0)
-        {
-                fprintf (fp->fp, "  1\n%s\n", dxf_region->proprietary_data[i]);
-                i++;
-        }
-        i = 0;
-        while (strlen (dxf_region->additional_proprietary_data[i]) > 0)
-        {
-                fprintf (fp->fp, "  3\n%s\n", dxf_region->additional_proprietary_data[i]);
-                i++;
-        }
+        dxf_acis_data_write (fp, 1, &dxf_region->proprietary_data);
+        dxf_acis_data_write (fp, 3, &dxf_region->additional_proprietary_data);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -514,8 +533,6 @@ dxf_region_free
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        int i;
-
         if (dxf_region->next != NULL)
         {
               fprintf (stderr,
@@ -525,14 +542,11 @@ dxf_region_free
         }
         free (dxf_region->linetype);
         free (dxf_region->layer);
-        for (i = 0; i < DXF_MAX_PARAM; i++)
-        {
-                free (dxf_region->proprietary_data[i]);
-                free (dxf_region->additional_proprietary_data[i]);
-        }
+        dxf_acis_data_free_contents (&dxf_region->proprietary_data);
+        dxf_acis_data_free_contents (&dxf_region->additional_proprietary_data);
         free (dxf_region->dictionary_owner_soft);
         free (dxf_region->dictionary_owner_hard);
-        free (dxf_region);
+        dxf_entity_dealloc (dxf_region, sizeof (*dxf_region));
         dxf_region = NULL;
 #if DEBUG
         DXF_DEBUG_END
@@ -0,0 +1,260 @@
+/*!
+ * \file ring.c
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Functions for the lock-free single-producer single-consumer
+ * ring.
+ *
+ * The ring hands fixed size slots from one thread to another without
+ * a mutex: the producer owns the tail index, the consumer owns the
+ * head index, and each publishes its progress with a release store
+ * the other side picks up with an acquire load.\n
+ * This is the handoff primitive between a parsing thread and a
+ * consuming thread (see \c dxf_file_read_stream_async), where a
+ * mutex per entity would cost more than the parse itself.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#include <sched.h>
+#include "ring.h"
+
+
+/*!
+ * \brief Allocate a ring.
+ *
+ * \return the ring, or \c NULL when errors occurred.
+ */
+DxfRing *
+dxf_ring_new
+(
+        int capacity,
+                /*!< number of slots, rounded up to the next power of
+                 * two; \c 0 for \c DXF_RING_CAPACITY. */
+        size_t slot_size
+                /*!< size of one slot in bytes. */
+)
+{
+        DxfRing *ring;
+        unsigned int size;
+
+        if (slot_size < 1)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () an invalid slot size was passed.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        if (capacity < 1)
+        {
+                capacity = DXF_RING_CAPACITY;
+        }
+        size = 2;
+        while (size < (unsigned int) capacity)
+        {
+                size = size * 2;
+        }
+        ring = malloc (sizeof (DxfRing));
+        if (ring == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        memset (ring, 0, sizeof (DxfRing));
+        ring->slots = malloc ((size_t) size * slot_size);
+        if (ring->slots == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                free (ring);
+                return (NULL);
+        }
+        ring->slot_size = slot_size;
+        ring->mask = size - 1;
+        return (ring);
+}
+
+
+/*!
+ * \brief Free a ring and its slot storage.
+ */
+void
+dxf_ring_free
+(
+        DxfRing *ring
+                /*!< the ring to free. */
+)
+{
+        if (ring == NULL)
+        {
+                return;
+        }
+        free (ring->slots);
+        free (ring);
+}
+
+
+/*!
+ * \brief Push one slot; producer side only.
+ *
+ * \return \c TRUE when the slot was pushed, or \c FALSE when the ring
+ * is full.
+ */
+int
+dxf_ring_push
+(
+        DxfRing *ring,
+                /*!< the ring to push onto. */
+        const void *slot
+                /*!< the slot contents, copied into the ring. */
+)
+{
+        unsigned int head;
+        unsigned int tail;
+
+        head = __atomic_load_n (&ring->head, __ATOMIC_ACQUIRE);
+        tail = ring->tail;
+        if (tail - head > ring->mask)
+        {
+                return (FALSE);
+        }
+        memcpy (ring->slots + (size_t) (tail & ring->mask) * ring->slot_size,
+                slot, ring->slot_size);
+        __atomic_store_n (&ring->tail, tail + 1, __ATOMIC_RELEASE);
+        return (TRUE);
+}
+
+
+/*!
+ * \brief Pop one slot; consumer side only.
+ *
+ * \return \c TRUE when a slot was popped, or \c FALSE when the ring
+ * is empty.
+ */
+int
+dxf_ring_pop
+(
+        DxfRing *ring,
+                /*!< the ring to pop from. */
+        void *slot
+                /*!< receives the slot contents. */
+)
+{
+        unsigned int head;
+        unsigned int tail;
+
+        tail = __atomic_load_n (&ring->tail, __ATOMIC_ACQUIRE);
+        head = ring->head;
+        if (head == tail)
+        {
+                return (FALSE);
+        }
+        memcpy (slot,
+                ring->slots + (size_t) (head & ring->mask) * ring->slot_size,
+                ring->slot_size);
+        __atomic_store_n (&ring->head, head + 1, __ATOMIC_RELEASE);
+        return (TRUE);
+}
+
+
+/*!
+ * \brief Push one slot, yielding while the ring is full.
+ *
+ * \return \c TRUE when the slot was pushed.
+ */
+int
+dxf_ring_push_wait
+(
+        DxfRing *ring,
+                /*!< the ring to push onto. */
+        const void *slot
+                /*!< the slot contents, copied into the ring. */
+)
+{
+        while (!dxf_ring_push (ring, slot))
+        {
+                sched_yield ();
+        }
+        return (TRUE);
+}
+
+
+/*!
+ * \brief Pop one slot, yielding while the ring is empty.
+ *
+ * \return \c TRUE when a slot was popped, or \c FALSE when the ring
+ * is empty and closed: the producer is done and no further slot will
+ * arrive.
+ */
+int
+dxf_ring_pop_wait
+(
+        DxfRing *ring,
+                /*!< the ring to pop from. */
+        void *slot
+                /*!< receives the slot contents. */
+)
+{
+        for (;;)
+        {
+                if (dxf_ring_pop (ring, slot))
+                {
+                        return (TRUE);
+                }
+                if (__atomic_load_n (&ring->closed, __ATOMIC_ACQUIRE))
+                {
+                        /* slots pushed before the close are still
+                         * there: one more look. */
+                        return (dxf_ring_pop (ring, slot));
+                }
+                sched_yield ();
+        }
+}
+
+
+/*!
+ * \brief Mark the ring closed; producer side only.
+ *
+ * Pops drain the remaining slots, then \c dxf_ring_pop_wait returns
+ * \c FALSE instead of waiting.
+ */
+void
+dxf_ring_close
+(
+        DxfRing *ring
+                /*!< the ring to close. */
+)
+{
+        __atomic_store_n (&ring->closed, 1, __ATOMIC_RELEASE);
+}
+
+
+/* EOF */
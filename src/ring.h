@@ -0,0 +1,99 @@
+/*!
+ * \file ring.h
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Header for the lock-free single-producer single-consumer
+ * ring.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#ifndef LIBDXF_SRC_RING_H
+#define LIBDXF_SRC_RING_H
+
+
+#include "global.h"
+
+
+/*!
+ * The default number of slots of a \c DxfRing.
+ */
+#define DXF_RING_CAPACITY 256
+
+
+/*!
+ * \brief A lock-free single-producer single-consumer ring of fixed
+ * size slots.
+ *
+ * One thread pushes, one thread pops; the two only synchronise
+ * through atomic loads and stores of the slot indices, so a full or
+ * empty ring is the only time either thread waits.\n
+ * Slot contents are copied in and out by value, so a pushed slot
+ * stays valid no matter what the producer does next.\n
+ * The indices live on separate cache lines to keep the producer and
+ * the consumer from bouncing the same line between cores.
+ */
+typedef struct
+dxf_ring
+{
+        char *slots;
+                /*!< the slot storage. */
+        size_t slot_size;
+                /*!< size of one slot in bytes. */
+        unsigned int mask;
+                /*!< capacity - 1; the capacity is a power of two, so
+                 * indices wrap with a mask instead of a division. */
+        int closed;
+                /*!< nonzero once the producer is done pushing (see
+                 * \c dxf_ring_close). */
+        char pad0[64];
+                /*!< keeps \c head on its own cache line. */
+        unsigned int head;
+                /*!< index of the next slot to pop; only the consumer
+                 * writes it. */
+        char pad1[64];
+                /*!< keeps \c tail on its own cache line. */
+        unsigned int tail;
+                /*!< index of the next slot to push; only the producer
+                 * writes it. */
+} DxfRing;
+
+
+DxfRing *dxf_ring_new (int capacity, size_t slot_size);
+void dxf_ring_free (DxfRing *ring);
+int dxf_ring_push (DxfRing *ring, const void *slot);
+int dxf_ring_pop (DxfRing *ring, void *slot);
+int dxf_ring_push_wait (DxfRing *ring, const void *slot);
+int dxf_ring_pop_wait (DxfRing *ring, void *slot);
+void dxf_ring_close (DxfRing *ring);
+
+
+#endif /* LIBDXF_SRC_RING_H */
+
+
+/* EOF */
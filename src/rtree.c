@@ -0,0 +1,551 @@
+/*!
+ * \file rtree.c
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Functions for a packed spatial R-tree over entity bounding
+ * boxes.
+ *
+ * Viewport extraction and clash detection ask the same question
+ * thousands of times per session: which entities intersect this
+ * rectangle?\n
+ * Scanning every entity per query is linear; this module bulk loads
+ * a packed R-tree once after the parse with the Sort-Tile-Recursive
+ * (STR) algorithm and answers rectangle queries in logarithmic time
+ * through \c dxf_drawing_query_rect.\n
+ * The tree is static: entries and nodes live in two flat arrays,
+ * children of a node are contiguous, and nothing is ever inserted or
+ * rebalanced, so there are no per-node allocations and queries touch
+ * memory sequentially.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#include <math.h>
+#include "rtree.h"
+
+
+/*!
+ * \brief Compare two entries by the X-value of their box center
+ * (\c qsort callback).
+ */
+static int
+dxf_rtree_compare_center_x
+(
+        const void *a,
+        const void *b
+)
+{
+        const DxfRtreeEntry *ea;
+        const DxfRtreeEntry *eb;
+        double ca;
+        double cb;
+
+        ea = (const DxfRtreeEntry *) a;
+        eb = (const DxfRtreeEntry *) b;
+        ca = ea->min_x + ea->max_x;
+        cb = eb->min_x + eb->max_x;
+        if (ca < cb) return (-1);
+        if (ca > cb) return (1);
+        return (0);
+}
+
+
+/*!
+ * \brief Compare two entries by the Y-value of their box center
+ * (\c qsort callback).
+ */
+static int
+dxf_rtree_compare_center_y
+(
+        const void *a,
+        const void *b
+)
+{
+        const DxfRtreeEntry *ea;
+        const DxfRtreeEntry *eb;
+        double ca;
+        double cb;
+
+        ea = (const DxfRtreeEntry *) a;
+        eb = (const DxfRtreeEntry *) b;
+        ca = ea->min_y + ea->max_y;
+        cb = eb->min_y + eb->max_y;
+        if (ca < cb) return (-1);
+        if (ca > cb) return (1);
+        return (0);
+}
+
+
+/*!
+ * \brief Bulk load a packed R-tree from entity bounding boxes.
+ *
+ * The entries are copied and tiled with Sort-Tile-Recursive: sorted
+ * by center X-value, cut into vertical slices, each slice sorted by
+ * center Y-value and packed \c DXF_RTREE_FANOUT entries per leaf, so
+ * leaves cover compact, nearly square regions.\n
+ * Upper levels simply group \c DXF_RTREE_FANOUT consecutive nodes,
+ * which preserves the tiling order.
+ *
+ * \return a pointer to the tree, or \c NULL when errors occurred.
+ */
+DxfRtree *
+dxf_rtree_build
+(
+        const DxfRtreeEntry *entries,
+                /*!< the entity bounding boxes to index. */
+        size_t length
+                /*!< number of entity bounding boxes. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        DxfRtree *rtree;
+        DxfRtreeNode *node;
+        size_t number_nodes;
+        size_t leaves;
+        size_t slices;
+        size_t slice_size;
+        size_t slice_start;
+        size_t slice_length;
+        size_t level_start;
+        size_t level_count;
+        size_t next_count;
+        size_t count;
+        size_t i;
+        size_t j;
+
+        /* Do some basic checks. */
+        if ((entries == NULL) && (length > 0))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        rtree = malloc (sizeof (DxfRtree));
+        if (rtree == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        memset (rtree, 0, sizeof (DxfRtree));
+        if (length == 0)
+        {
+                /* an empty tree: every query misses. */
+                return (rtree);
+        }
+        rtree->entries = malloc (length * sizeof (DxfRtreeEntry));
+        if (rtree->entries == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                free (rtree);
+                return (NULL);
+        }
+        memcpy (rtree->entries, entries, length * sizeof (DxfRtreeEntry));
+        rtree->length = length;
+        /* Tile the entries: sort by center X, cut into sqrt(leaves)
+         * vertical slices, sort each slice by center Y. */
+        leaves = (length + DXF_RTREE_FANOUT - 1) / DXF_RTREE_FANOUT;
+        slices = (size_t) ceil (sqrt ((double) leaves));
+        if (slices < 1)
+        {
+                slices = 1;
+        }
+        slice_size = ((leaves + slices - 1) / slices) * DXF_RTREE_FANOUT;
+        qsort (rtree->entries, length, sizeof (DxfRtreeEntry),
+                dxf_rtree_compare_center_x);
+        for (slice_start = 0; slice_start < length; slice_start += slice_size)
+        {
+                slice_length = length - slice_start;
+                if (slice_length > slice_size)
+                {
+                        slice_length = slice_size;
+                }
+                qsort (rtree->entries + slice_start, slice_length,
+                        sizeof (DxfRtreeEntry), dxf_rtree_compare_center_y);
+        }
+        /* Count the nodes of all levels before packing them. */
+        number_nodes = 0;
+        count = leaves;
+        while (count > 1)
+        {
+                number_nodes += count;
+                count = (count + DXF_RTREE_FANOUT - 1) / DXF_RTREE_FANOUT;
+        }
+        number_nodes += 1;
+        rtree->nodes = malloc (number_nodes * sizeof (DxfRtreeNode));
+        if (rtree->nodes == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                free (rtree->entries);
+                free (rtree);
+                return (NULL);
+        }
+        rtree->number_nodes = number_nodes;
+        /* Pack the leaves. */
+        for (i = 0; i < leaves; i++)
+        {
+                node = &rtree->nodes[i];
+                node->first = i * DXF_RTREE_FANOUT;
+                node->count = length - node->first;
+                if (node->count > DXF_RTREE_FANOUT)
+                {
+                        node->count = DXF_RTREE_FANOUT;
+                }
+                node->leaf = TRUE;
+                node->min_x = rtree->entries[node->first].min_x;
+                node->min_y = rtree->entries[node->first].min_y;
+                node->max_x = rtree->entries[node->first].max_x;
+                node->max_y = rtree->entries[node->first].max_y;
+                for (j = node->first + 1; j < node->first + node->count; j++)
+                {
+                        node->min_x = (rtree->entries[j].min_x < node->min_x) ? rtree->entries[j].min_x : node->min_x;
+                        node->min_y = (rtree->entries[j].min_y < node->min_y) ? rtree->entries[j].min_y : node->min_y;
+                        node->max_x = (rtree->entries[j].max_x > node->max_x) ? rtree->entries[j].max_x : node->max_x;
+                        node->max_y = (rtree->entries[j].max_y > node->max_y) ? rtree->entries[j].max_y : node->max_y;
+                }
+        }
+        /* Pack the upper levels bottom-up, grouping FANOUT
+         * consecutive nodes per parent; the root lands last. */
+        level_start = 0;
+        level_count = leaves;
+        while (level_count > 1)
+        {
+                next_count = (level_count + DXF_RTREE_FANOUT - 1) / DXF_RTREE_FANOUT;
+                for (i = 0; i < next_count; i++)
+                {
+                        node = &rtree->nodes[level_start + level_count + i];
+                        node->first = level_start + i * DXF_RTREE_FANOUT;
+                        node->count = level_start + level_count - node->first;
+                        if (node->count > DXF_RTREE_FANOUT)
+                        {
+                                node->count = DXF_RTREE_FANOUT;
+                        }
+                        node->leaf = FALSE;
+                        node->min_x = rtree->nodes[node->first].min_x;
+                        node->min_y = rtree->nodes[node->first].min_y;
+                        node->max_x = rtree->nodes[node->first].max_x;
+                        node->max_y = rtree->nodes[node->first].max_y;
+                        for (j = node->first + 1; j < node->first + node->count; j++)
+                        {
+                                node->min_x = (rtree->nodes[j].min_x < node->min_x) ? rtree->nodes[j].min_x : node->min_x;
+                                node->min_y = (rtree->nodes[j].min_y < node->min_y) ? rtree->nodes[j].min_y : node->min_y;
+                                node->max_x = (rtree->nodes[j].max_x > node->max_x) ? rtree->nodes[j].max_x : node->max_x;
+                                node->max_y = (rtree->nodes[j].max_y > node->max_y) ? rtree->nodes[j].max_y : node->max_y;
+                        }
+                }
+                level_start += level_count;
+                level_count = next_count;
+        }
+        rtree->root = level_start;
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (rtree);
+}
+
+
+/*!
+ * \brief Bulk load a packed R-tree over the structure-of-arrays
+ * coordinate stores.
+ *
+ * Builds one entry per stored \c LINE, \c POINT and \c 3DFACE from
+ * the XY extent of its coordinates; any of the stores may be
+ * \c NULL.\n
+ * Query hits identify the entity by store (\c type) and position in
+ * it (\c index).
+ *
+ * \return a pointer to the tree, or \c NULL when errors occurred.
+ */
+DxfRtree *
+dxf_rtree_build_soa
+(
+        const DxfSoaLines *lines,
+                /*!< store of \c LINE coordinates, or \c NULL. */
+        const DxfSoaPoints *points,
+                /*!< store of \c POINT coordinates, or \c NULL. */
+        const DxfSoaFaces *faces
+                /*!< store of \c 3DFACE coordinates, or \c NULL. */
+)
+{
+        DxfRtree *rtree;
+        DxfRtreeEntry *entries;
+        DxfRtreeEntry *entry;
+        size_t length;
+        size_t n;
+        size_t i;
+        size_t j;
+        double lo;
+        double hi;
+
+        length = 0;
+        if (lines != NULL)
+        {
+                length += lines->length;
+        }
+        if (points != NULL)
+        {
+                length += points->length;
+        }
+        if (faces != NULL)
+        {
+                length += faces->length;
+        }
+        if (length == 0)
+        {
+                return (dxf_rtree_build (NULL, 0));
+        }
+        entries = malloc (length * sizeof (DxfRtreeEntry));
+        if (entries == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        n = 0;
+        if (lines != NULL)
+        {
+                for (i = 0; i < lines->length; i++)
+                {
+                        entry = &entries[n++];
+                        entry->type = DXF_RTREE_LINE;
+                        entry->index = i;
+                        entry->min_x = (lines->x0[i] < lines->x1[i]) ? lines->x0[i] : lines->x1[i];
+                        entry->max_x = (lines->x0[i] > lines->x1[i]) ? lines->x0[i] : lines->x1[i];
+                        entry->min_y = (lines->y0[i] < lines->y1[i]) ? lines->y0[i] : lines->y1[i];
+                        entry->max_y = (lines->y0[i] > lines->y1[i]) ? lines->y0[i] : lines->y1[i];
+                }
+        }
+        if (points != NULL)
+        {
+                for (i = 0; i < points->length; i++)
+                {
+                        entry = &entries[n++];
+                        entry->type = DXF_RTREE_POINT;
+                        entry->index = i;
+                        entry->min_x = points->x0[i];
+                        entry->max_x = points->x0[i];
+                        entry->min_y = points->y0[i];
+                        entry->max_y = points->y0[i];
+                }
+        }
+        if (faces != NULL)
+        {
+                for (i = 0; i < faces->length; i++)
+                {
+                        const double *x[4];
+                        const double *y[4];
+
+                        x[0] = faces->x0;
+                        x[1] = faces->x1;
+                        x[2] = faces->x2;
+                        x[3] = faces->x3;
+                        y[0] = faces->y0;
+                        y[1] = faces->y1;
+                        y[2] = faces->y2;
+                        y[3] = faces->y3;
+                        entry = &entries[n++];
+                        entry->type = DXF_RTREE_FACE;
+                        entry->index = i;
+                        lo = x[0][i];
+                        hi = x[0][i];
+                        for (j = 1; j < 4; j++)
+                        {
+                                lo = (x[j][i] < lo) ? x[j][i] : lo;
+                                hi = (x[j][i] > hi) ? x[j][i] : hi;
+                        }
+                        entry->min_x = lo;
+                        entry->max_x = hi;
+                        lo = y[0][i];
+                        hi = y[0][i];
+                        for (j = 1; j < 4; j++)
+                        {
+                                lo = (y[j][i] < lo) ? y[j][i] : lo;
+                                hi = (y[j][i] > hi) ? y[j][i] : hi;
+                        }
+                        entry->min_y = lo;
+                        entry->max_y = hi;
+                }
+        }
+        rtree = dxf_rtree_build (entries, length);
+        free (entries);
+        return (rtree);
+}
+
+
+/*!
+ * \brief Free a packed R-tree.
+ */
+void
+dxf_rtree_free
+(
+        DxfRtree *rtree
+                /*!< the tree to free. */
+)
+{
+        if (rtree == NULL)
+        {
+                return;
+        }
+        free (rtree->entries);
+        free (rtree->nodes);
+        free (rtree);
+}
+
+
+/*!
+ * \brief Walk one subtree of a rectangle query.
+ *
+ * \return \c EXIT_SUCCESS to keep walking, or the first
+ * non \c EXIT_SUCCESS value returned by \c visit.
+ */
+static int
+dxf_rtree_query_node
+(
+        const DxfRtree *rtree,
+                /*!< the tree being queried. */
+        size_t index,
+                /*!< index of the node to walk. */
+        double min_x,
+                /*!< smallest X-value of the query rectangle. */
+        double min_y,
+                /*!< smallest Y-value of the query rectangle. */
+        double max_x,
+                /*!< largest X-value of the query rectangle. */
+        double max_y,
+                /*!< largest Y-value of the query rectangle. */
+        int (*visit) (const DxfRtreeEntry *entry, void *user_data),
+                /*!< called for every intersecting entity. */
+        void *user_data
+                /*!< passed through to \c visit. */
+)
+{
+        const DxfRtreeNode *node;
+        const DxfRtreeEntry *entry;
+        size_t i;
+        int result;
+
+        node = &rtree->nodes[index];
+        if ((node->min_x > max_x) || (node->max_x < min_x)
+          || (node->min_y > max_y) || (node->max_y < min_y))
+        {
+                return (EXIT_SUCCESS);
+        }
+        if (node->leaf)
+        {
+                for (i = node->first; i < node->first + node->count; i++)
+                {
+                        entry = &rtree->entries[i];
+                        if ((entry->min_x > max_x) || (entry->max_x < min_x)
+                          || (entry->min_y > max_y) || (entry->max_y < min_y))
+                        {
+                                continue;
+                        }
+                        result = visit (entry, user_data);
+                        if (result != EXIT_SUCCESS)
+                        {
+                                return (result);
+                        }
+                }
+                return (EXIT_SUCCESS);
+        }
+        for (i = node->first; i < node->first + node->count; i++)
+        {
+                result = dxf_rtree_query_node (rtree, i, min_x, min_y,
+                        max_x, max_y, visit, user_data);
+                if (result != EXIT_SUCCESS)
+                {
+                        return (result);
+                }
+        }
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Find all indexed entities intersecting a rectangle.
+ *
+ * Calls \c visit once for every entity whose bounding box intersects
+ * the query rectangle; a non \c EXIT_SUCCESS return from \c visit
+ * stops the walk early (an early stop is not an error).
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_drawing_query_rect
+(
+        const DxfRtree *rtree,
+                /*!< the tree to query. */
+        double min_x,
+                /*!< smallest X-value of the query rectangle. */
+        double min_y,
+                /*!< smallest Y-value of the query rectangle. */
+        double max_x,
+                /*!< largest X-value of the query rectangle. */
+        double max_y,
+                /*!< largest Y-value of the query rectangle. */
+        int (*visit) (const DxfRtreeEntry *entry, void *user_data),
+                /*!< called for every intersecting entity. */
+        void *user_data
+                /*!< passed through to \c visit. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        /* Do some basic checks. */
+        if ((rtree == NULL) || (visit == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (rtree->length == 0)
+        {
+                return (EXIT_SUCCESS);
+        }
+        dxf_rtree_query_node (rtree, rtree->root, min_x, min_y,
+                max_x, max_y, visit, user_data);
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (EXIT_SUCCESS);
+}
+
+
+/* EOF */
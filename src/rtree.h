@@ -0,0 +1,148 @@
+/*!
+ * \file rtree.h
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Header for a packed spatial R-tree over entity bounding
+ * boxes.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#ifndef LIBDXF_SRC_RTREE_H
+#define LIBDXF_SRC_RTREE_H
+
+
+#include "global.h"
+#include "soa.h"
+
+
+/*!
+ * \brief Fan-out of the packed R-tree.
+ *
+ * Every node except the last of a level holds this many children;
+ * 16 child boxes fit in four cache lines, a good balance between
+ * tree depth and per-node scan cost.
+ */
+#define DXF_RTREE_FANOUT 16
+
+
+/*!
+ * \brief Entity kinds an R-tree entry can refer to (see \c type in
+ * \c DxfRtreeEntry).
+ */
+enum dxf_rtree_entry_type
+{
+        DXF_RTREE_LINE = 0,
+                /*!< \c index refers into a \c DxfSoaLines store. */
+        DXF_RTREE_POINT,
+                /*!< \c index refers into a \c DxfSoaPoints store. */
+        DXF_RTREE_FACE
+                /*!< \c index refers into a \c DxfSoaFaces store. */
+};
+
+
+/*!
+ * \brief One indexed entity: its bounding box and where to find it.
+ */
+typedef struct
+dxf_rtree_entry
+{
+        double min_x;
+                /*!< smallest X-value of the entity. */
+        double min_y;
+                /*!< smallest Y-value of the entity. */
+        double max_x;
+                /*!< largest X-value of the entity. */
+        double max_y;
+                /*!< largest Y-value of the entity. */
+        int type;
+                /*!< entity kind (see \c enum \c dxf_rtree_entry_type). */
+        size_t index;
+                /*!< index of the entity in its store. */
+} DxfRtreeEntry;
+
+
+/*!
+ * \brief One node of the packed tree.
+ *
+ * Children of a node are contiguous, so a node needs only the index
+ * of its first child and a count: for a leaf they refer into the
+ * entry array, for an inner node into the node array.
+ */
+typedef struct
+dxf_rtree_node
+{
+        double min_x;
+                /*!< smallest X-value covered by this node. */
+        double min_y;
+                /*!< smallest Y-value covered by this node. */
+        double max_x;
+                /*!< largest X-value covered by this node. */
+        double max_y;
+                /*!< largest Y-value covered by this node. */
+        size_t first;
+                /*!< index of the first child. */
+        size_t count;
+                /*!< number of children. */
+        int leaf;
+                /*!< \c TRUE when the children are entries. */
+} DxfRtreeNode;
+
+
+/*!
+ * \brief A packed R-tree, bulk loaded once after the parse.
+ *
+ * Both arrays are laid out by Sort-Tile-Recursive order: entries
+ * tiled into leaves, levels packed bottom-up with the root last.
+ */
+typedef struct
+dxf_rtree
+{
+        DxfRtreeEntry *entries;
+                /*!< the indexed entities, in leaf order. */
+        size_t length;
+                /*!< number of indexed entities. */
+        DxfRtreeNode *nodes;
+                /*!< the packed nodes, leaves first, root last. */
+        size_t number_nodes;
+                /*!< number of packed nodes. */
+        size_t root;
+                /*!< index of the root node. */
+} DxfRtree;
+
+
+DxfRtree *dxf_rtree_build (const DxfRtreeEntry *entries, size_t length);
+DxfRtree *dxf_rtree_build_soa (const DxfSoaLines *lines, const DxfSoaPoints *points, const DxfSoaFaces *faces);
+void dxf_rtree_free (DxfRtree *rtree);
+int dxf_drawing_query_rect (const DxfRtree *rtree, double min_x, double min_y, double max_x, double max_y, int (*visit) (const DxfRtreeEntry *entry, void *user_data), void *user_data);
+
+
+#endif /* LIBDXF_SRC_RTREE_H */
+
+
+/* EOF */
@@ -33,6 +33,70 @@
 
 
 #include "section.h"
+#include "file.h"
+#include "objects.h"
+#include "profile.h"
+
+
+#if DXF_PROFILE
+/*!
+ * \brief Current byte offset of a file being parsed, for the per
+ * section byte figures of the profile.
+ */
+static uint64_t
+dxf_section_profile_offset
+(
+        DxfFile *fp
+                /*!< DXF file pointer to an input file (or device). */
+)
+{
+        if (fp->mmap_base != NULL)
+        {
+                return ((uint64_t) fp->mmap_pos);
+        }
+        if (fp->bytes_consumed > 0)
+        {
+                /* buffered and compressed reads track it directly. */
+                return (fp->bytes_consumed);
+        }
+        if (fp->fp != NULL)
+        {
+                return ((uint64_t) ftell (fp->fp));
+        }
+        return (0);
+}
+#endif
+
+
+/*!
+ * \brief Whether a string is one of the section names the dispatch in
+ * \c dxf_section_read recognizes.
+ *
+ * \return \c TRUE when the name is a known section name.
+ */
+static int
+dxf_section_name_known
+(
+        const char *name
+                /*!< the string to test. */
+)
+{
+        static const char *names[] =
+        {
+                "HEADER", "CLASSES", "TABLES", "BLOCKS",
+                "ENTITIES", "OBJECTS", "THUMBNAIL"
+        };
+        size_t i;
+
+        for (i = 0; i < sizeof (names) / sizeof (names[0]); i++)
+        {
+                if (strcmp (names[i], name) == 0)
+                {
+                        return (TRUE);
+                }
+        }
+        return (FALSE);
+}
 
 
 /*!
@@ -52,6 +116,10 @@ dxf_section_read
         DxfHeader dxf_header;
         DxfBlock dxf_block;
         char *dxf_entities_list = NULL;
+#if DXF_PROFILE
+        uint64_t profile_start;
+        uint64_t profile_bytes;
+#endif
 
         /* Do some basic checks. */
         if (fp == NULL)
@@ -64,18 +132,63 @@ dxf_section_read
         dxf_read_line (temp_string, fp);
         if (strcmp (temp_string, "2") == 0)
         {
-                while (!feof (fp->fp))
+                /* break on the logical end of the stream as reported
+                 * by the reader: feof () on the underlying FILE never
+                 * fires for gzip input, which reads through
+                 * gzread (). */
+                while (dxf_read_line (temp_string, fp) == 1)
                 {
-                        dxf_read_line (temp_string, fp);
+                        if ((fp->parse_filter != NULL)
+                                && dxf_section_name_known (temp_string)
+                                && (!dxf_parse_filter_section (fp->parse_filter,
+                                        temp_string)))
+                        {
+                                /* the filter spec rejects this section:
+                                 * skip to its ENDSEC at byte level. */
+                                dxf_read_skip_section (fp);
+                                continue;
+                        }
                         if (strcmp (temp_string, "HEADER") == 0)
                         {
                                 /* We have found the begin of the HEADER section. */
-                                dxf_read_header (fp, dxf_header);
+#if DXF_PROFILE
+                                profile_start = dxf_profile_now ();
+                                profile_bytes = dxf_section_profile_offset (fp);
+#endif
+                                if (fp->document != NULL)
+                                {
+                                        dxf_read_header (fp, fp->document->header);
+                                }
+                                else
+                                {
+                                        dxf_read_header (fp, dxf_header);
+                                }
+#if DXF_PROFILE
+                                dxf_profile_section_add ("HEADER",
+                                        dxf_profile_now () - profile_start,
+                                        dxf_section_profile_offset (fp) - profile_bytes);
+#endif
                         }
                         else if (strcmp (temp_string, "CLASSES") == 0)
                         {
                                 /* We have found the begin of the CLASSES sction. */
-                                /*! \todo Invoke a function for parsing the \c CLASSES section. */ 
+#if DXF_PROFILE
+                                profile_start = dxf_profile_now ();
+                                profile_bytes = dxf_section_profile_offset (fp);
+#endif
+                                if (fp->document != NULL)
+                                {
+                                        fp->document->classes_list = dxf_class_section_read (fp);
+                                }
+                                else
+                                {
+                                        dxf_class_section_read (fp);
+                                }
+#if DXF_PROFILE
+                                dxf_profile_section_add ("CLASSES",
+                                        dxf_profile_now () - profile_start,
+                                        dxf_section_profile_offset (fp) - profile_bytes);
+#endif
                         }
                         else if (strcmp (temp_string, "TABLES") == 0)
                         {
@@ -97,15 +210,39 @@ dxf_section_read
                         else if (strcmp (temp_string, "ENTITIES") == 0)
                         {
                                 /* We have found the begin of the ENTITIES sction. */
-                                dxf_entities_read_table (fp->filename,
-                                                   fp->fp,
-                                                   fp->line_number,
-                                                   dxf_entities_list,
-                                                   dxf_header._AcadVer);                        }
+#if DXF_PROFILE
+                                profile_start = dxf_profile_now ();
+                                profile_bytes = dxf_section_profile_offset (fp);
+#endif
+                                dxf_entities_read (fp);
+#if DXF_PROFILE
+                                dxf_profile_section_add ("ENTITIES",
+                                        dxf_profile_now () - profile_start,
+                                        dxf_section_profile_offset (fp) - profile_bytes);
+#endif
+                        }
                         else if (strcmp (temp_string, "OBJECTS") == 0)
                         {
                                 /* We have found the begin of the OBJECTS sction. */
-                                /*! \todo Invoke a function for parsing the \c OBJECTS section. */ 
+#if DXF_PROFILE
+                                profile_start = dxf_profile_now ();
+                                profile_bytes = dxf_section_profile_offset (fp);
+#endif
+                                if (fp->document != NULL)
+                                {
+                                        fp->document->objects = dxf_objects_read (fp);
+                                }
+                                else
+                                {
+                                        /* consume the section; nothing
+                                         * retains it. */
+                                        dxf_objects_free (dxf_objects_read (fp));
+                                }
+#if DXF_PROFILE
+                                dxf_profile_section_add ("OBJECTS",
+                                        dxf_profile_now () - profile_start,
+                                        dxf_section_profile_offset (fp) - profile_bytes);
+#endif
                         }
                         else if (strcmp (temp_string, "THUMBNAIL") == 0)
                         {
@@ -117,7 +254,7 @@ dxf_section_read
         else
         {
                 fprintf (stderr,
-                  (_("Warning in %s () unexpected string encountered while reading line %d from: %s.\n")),
+                  (_("Warning in %s () unexpected string encountered while reading line %ld from: %s.\n")),
                   __FUNCTION__, fp->line_number, fp->filename);
         }
 #if DEBUG
@@ -32,7 +32,11 @@
  */
 
 
+#include <pthread.h>
 #include "seqend.h"
+#include "diag.h"
+#include "allocator.h"
+#include "util.h"
 
 
 /*!
@@ -61,7 +65,7 @@ dxf_seqend_new ()
         size = sizeof (DxfSeqend);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_seqend = malloc (size)) == NULL)
+        if ((dxf_seqend = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfSeqend struct.\n")),
@@ -102,6 +106,11 @@ dxf_seqend_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfSeqend template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         /* Do some basic checks. */
         if (dxf_seqend == NULL)
         {
@@ -117,18 +126,30 @@ dxf_seqend_init
                 __FUNCTION__);
               return (NULL);
         }
-        dxf_seqend->app_name = strdup ("");
-        dxf_seqend->id_code = 0;
-        dxf_seqend->linetype = strdup (DXF_DEFAULT_LINETYPE);
-        dxf_seqend->layer = strdup (DXF_DEFAULT_LAYER);
-        dxf_seqend->elevation = 0.0;
-        dxf_seqend->thickness = 0.0;
-        dxf_seqend->linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
-        dxf_seqend->visibility = DXF_DEFAULT_VISIBILITY;
-        dxf_seqend->color = DXF_COLOR_BYLAYER;
-        dxf_seqend->paperspace = DXF_MODELSPACE;
-        dxf_seqend->dictionary_owner_soft = strdup ("");
-        dxf_seqend->dictionary_owner_hard = strdup ("");
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.app_name = strdup ("");
+                template.id_code = 0;
+                template.linetype = strdup (DXF_DEFAULT_LINETYPE);
+                template.layer = strdup (DXF_DEFAULT_LAYER);
+                template.elevation = 0.0;
+                template.thickness = 0.0;
+                template.linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
+                template.visibility = DXF_DEFAULT_VISIBILITY;
+                template.color = DXF_COLOR_BYLAYER;
+                template.paperspace = DXF_MODELSPACE;
+                template.dictionary_owner_soft = strdup ("");
+                template.dictionary_owner_hard = strdup ("");
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (dxf_seqend, &template, sizeof (DxfSeqend));
+        dxf_seqend->app_name = strdup (template.app_name);
+        dxf_seqend->linetype = strdup (template.linetype);
+        dxf_seqend->layer = strdup (template.layer);
+        dxf_seqend->dictionary_owner_soft = strdup (template.dictionary_owner_soft);
+        dxf_seqend->dictionary_owner_hard = strdup (template.dictionary_owner_hard);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -165,7 +186,7 @@ dxf_seqend_read
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        char *temp_string = NULL;
+        char temp_string[DXF_MAX_STRING_LENGTH];
 
         /* Do some basic checks. */
         if (fp == NULL)
@@ -183,14 +204,13 @@ dxf_seqend_read
                 dxf_seqend = dxf_seqend_new ();
                 dxf_seqend = dxf_seqend_init (dxf_seqend);
         }
-        (fp->line_number)++;
-        fscanf (fp->fp, "%[^\n]", temp_string);
+        dxf_read_line (temp_string, fp);
         while (strcmp (temp_string, "0") != 0)
         {
                 if (ferror (fp->fp))
                 {
                         fprintf (stderr,
-                          (_("Error in %s () while reading from: %s in line: %d.\n")),
+                          (_("Error in %s () while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                         fclose (fp->fp);
                         return (NULL);
@@ -199,21 +219,22 @@ dxf_seqend_read
                 {
                         /* Now follows a string containing a sequential
                          * id number. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%x\n", &dxf_seqend->id_code);
+                                                dxf_read_scanf (fp, "%x\n", &dxf_seqend->id_code);
                 }
                 else if (strcmp (temp_string, "6") == 0)
                 {
                         /* Now follows a string containing a linetype
                          * name. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_seqend->linetype);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
+                        free (dxf_seqend->linetype);
+                        dxf_seqend->linetype = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "8") == 0)
                 {
                         /* Now follows a string containing a layer name. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_seqend->layer);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
+                        free (dxf_seqend->layer);
+                        dxf_seqend->layer = strdup (temp_string);
                 }
                 else if ((fp->acad_version_number <= AutoCAD_11)
                         && (strcmp (temp_string, "38") == 0)
@@ -221,55 +242,48 @@ dxf_seqend_read
                 {
                         /* Now follows a string containing the
                          * elevation. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_seqend->elevation);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_seqend->elevation);
                 }
                 else if (strcmp (temp_string, "39") == 0)
                 {
                         /* Now follows a string containing the
                          * thickness. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_seqend->thickness);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_seqend->thickness);
                 }
                 else if (strcmp (temp_string, "48") == 0)
                 {
                         /* Now follows a string containing the linetype
                          * scale. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_seqend->linetype_scale);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_seqend->linetype_scale);
                 }
                 else if (strcmp (temp_string, "60") == 0)
                 {
                         /* Now follows a string containing the
                          * visibility value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%hd\n", &dxf_seqend->visibility);
+                                                dxf_read_scanf (fp, "%hd\n", &dxf_seqend->visibility);
                 }
                 else if (strcmp (temp_string, "62") == 0)
                 {
                         /* Now follows a string containing the
                          * color value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_seqend->color);
+                                                dxf_read_scanf (fp, "%d\n", &dxf_seqend->color);
                 }
                 else if (strcmp (temp_string, "67") == 0)
                 {
                         /* Now follows a string containing the
                          * paperspace value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_seqend->paperspace);
+                                                dxf_read_scanf (fp, "%d\n", &dxf_seqend->paperspace);
                 }
                 else if ((fp->acad_version_number >= AutoCAD_13)
                         && (strcmp (temp_string, "100") == 0))
                 {
                         /* Now follows a string containing the
                          * subclass marker value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", temp_string);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
                         if (strcmp (temp_string, "AcDbEntity") != 0)
                         {
-                                fprintf (stderr,
-                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %d.\n")),
+                                dxf_diag_report (fp, DXF_DIAG_WARNING,
+                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                         }
                 }
@@ -277,29 +291,34 @@ dxf_seqend_read
                 {
                         /* Now follows a string containing Soft-pointer
                          * ID/handle to owner dictionary. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_seqend->dictionary_owner_soft);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
+                        free (dxf_seqend->dictionary_owner_soft);
+                        dxf_seqend->dictionary_owner_soft = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "360") == 0)
                 {
                         /* Now follows a string containing Hard owner
                          * ID/handle to owner dictionary. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_seqend->dictionary_owner_hard);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
+                        free (dxf_seqend->dictionary_owner_hard);
+                        dxf_seqend->dictionary_owner_hard = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "999") == 0)
                 {
                         /* Now follows a string containing a comment. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", temp_string);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
                         fprintf (stdout, "DXF comment: %s\n", temp_string);
                 }
                 else
                 {
-                        fprintf (stderr,
-                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %d.\n")),
+                        dxf_diag_report (fp, DXF_DIAG_WARNING,
+                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                 }
+                if (dxf_read_line (temp_string, fp) != 1)
+                {
+                        break;
+                }
         }
         /* Handle omitted members and/or illegal values. */
         if (strcmp (dxf_seqend->linetype, "") == 0)
@@ -483,7 +502,7 @@ dxf_seqend_free
         free (dxf_seqend->layer);
         free (dxf_seqend->dictionary_owner_soft);
         free (dxf_seqend->dictionary_owner_hard);
-        free (dxf_seqend);
+        dxf_entity_dealloc (dxf_seqend, sizeof (*dxf_seqend));
         dxf_seqend = NULL;
 #if DEBUG
         DXF_DEBUG_END
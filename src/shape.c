@@ -32,7 +32,10 @@
  */
 
 
+#include <pthread.h>
 #include "shape.h"
+#include "diag.h"
+#include "allocator.h"
 
 
 /*!
@@ -61,7 +64,7 @@ dxf_shape_new ()
         size = sizeof (DxfShape);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_shape = malloc (size)) == NULL)
+        if ((dxf_shape = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfShape struct.\n")),
@@ -102,6 +105,11 @@ dxf_shape_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfShape template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         /* Do some basic checks. */
         if (dxf_shape == NULL)
         {
@@ -117,29 +125,41 @@ dxf_shape_init
                 __FUNCTION__);
               return (NULL);
         }
-        dxf_shape->id_code = 0;
-        dxf_shape->shape_name = strdup ("");
-        dxf_shape->linetype = strdup (DXF_DEFAULT_LINETYPE);
-        dxf_shape->layer = strdup (DXF_DEFAULT_LAYER);
-        dxf_shape->elevation = 0.0;
-        dxf_shape->thickness = 0.0;
-        dxf_shape->linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
-        dxf_shape->visibility = DXF_DEFAULT_VISIBILITY;
-        dxf_shape->color = DXF_COLOR_BYLAYER;
-        dxf_shape->paperspace = DXF_MODELSPACE;
-        dxf_shape->dictionary_owner_soft = strdup ("");
-        dxf_shape->dictionary_owner_hard = strdup ("");
-        dxf_shape->x0 = 0.0;
-        dxf_shape->y0 = 0.0;
-        dxf_shape->z0 = 0.0;
-        dxf_shape->extr_x0 = 0.0;
-        dxf_shape->extr_y0 = 0.0;
-        dxf_shape->extr_z0 = 0.0;
-        dxf_shape->size = 0.0;
-        dxf_shape->rel_x_scale = 0.0;
-        dxf_shape->rot_angle = 0.0;
-        dxf_shape->obl_angle = 0.0;
-        dxf_shape->next = NULL;
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.id_code = 0;
+                template.shape_name = strdup ("");
+                template.linetype = strdup (DXF_DEFAULT_LINETYPE);
+                template.layer = strdup (DXF_DEFAULT_LAYER);
+                template.elevation = 0.0;
+                template.thickness = 0.0;
+                template.linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
+                template.visibility = DXF_DEFAULT_VISIBILITY;
+                template.color = DXF_COLOR_BYLAYER;
+                template.paperspace = DXF_MODELSPACE;
+                template.dictionary_owner_soft = strdup ("");
+                template.dictionary_owner_hard = strdup ("");
+                template.x0 = 0.0;
+                template.y0 = 0.0;
+                template.z0 = 0.0;
+                template.extr_x0 = 0.0;
+                template.extr_y0 = 0.0;
+                template.extr_z0 = 0.0;
+                template.size = 0.0;
+                template.rel_x_scale = 0.0;
+                template.rot_angle = 0.0;
+                template.obl_angle = 0.0;
+                template.next = NULL;
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (dxf_shape, &template, sizeof (DxfShape));
+        dxf_shape->shape_name = strdup (template.shape_name);
+        dxf_shape->linetype = strdup (template.linetype);
+        dxf_shape->layer = strdup (template.layer);
+        dxf_shape->dictionary_owner_soft = strdup (template.dictionary_owner_soft);
+        dxf_shape->dictionary_owner_hard = strdup (template.dictionary_owner_hard);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -175,7 +195,7 @@ dxf_shape_read
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        char *temp_string = NULL;
+        char temp_string[DXF_MAX_STRING_LENGTH];
         char *dxf_entity_name = strdup ("SHAPE");
 
         /* Do some basic checks. */
@@ -201,7 +221,7 @@ dxf_shape_read
                 if (ferror (fp->fp))
                 {
                         fprintf (stderr,
-                          (_("Error in %s () while reading from: %s in line: %d.\n")),
+                          (_("Error in %s () while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                         fclose (fp->fp);
                         return (NULL);
@@ -211,7 +231,9 @@ dxf_shape_read
                         /* Now follows a string containing a shape
                          * name. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_shape->shape_name);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_shape->shape_name);
+                        dxf_shape->shape_name = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "5") == 0)
                 {
@@ -225,13 +247,17 @@ dxf_shape_read
                         /* Now follows a string containing a linetype
                          * name. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_shape->linetype);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_shape->linetype);
+                        dxf_shape->linetype = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "8") == 0)
                 {
                         /* Now follows a string containing a layer name. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_shape->layer);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_shape->layer);
+                        dxf_shape->layer = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "10") == 0)
                 {
@@ -336,8 +362,8 @@ dxf_shape_read
                         if ((strcmp (temp_string, "AcDbEntity") != 0)
                         && ((strcmp (temp_string, "AcDbShape") != 0)))
                         {
-                                fprintf (stderr,
-                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %d.\n")),
+                                dxf_diag_report (fp, DXF_DIAG_WARNING,
+                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                         }
                 }
@@ -367,14 +393,18 @@ dxf_shape_read
                         /* Now follows a string containing Soft-pointer
                          * ID/handle to owner dictionary. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_shape->dictionary_owner_soft);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_shape->dictionary_owner_soft);
+                        dxf_shape->dictionary_owner_soft = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "360") == 0)
                 {
                         /* Now follows a string containing Hard owner
                          * ID/handle to owner dictionary. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_shape->dictionary_owner_hard);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_shape->dictionary_owner_hard);
+                        dxf_shape->dictionary_owner_hard = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "999") == 0)
                 {
@@ -385,8 +415,8 @@ dxf_shape_read
                 }
                 else
                 {
-                        fprintf (stderr,
-                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %d.\n")),
+                        dxf_diag_report (fp, DXF_DIAG_WARNING,
+                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                 }
         }
@@ -632,7 +662,7 @@ dxf_shape_free
         free (dxf_shape->layer);
         free (dxf_shape->dictionary_owner_soft);
         free (dxf_shape->dictionary_owner_hard);
-        free (dxf_shape);
+        dxf_entity_dealloc (dxf_shape, sizeof (*dxf_shape));
         dxf_shape = NULL;
 #if DEBUG
         DXF_DEBUG_END
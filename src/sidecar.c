@@ -0,0 +1,352 @@
+/*!
+ * \file sidecar.c
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Functions for the sidecar offset-index file format
+ * (\c .dxfidx).
+ *
+ * Jobs running many extraction queries against the same drawing used
+ * to re-scan the whole text file for every query.\n
+ * A lazy scan's offset records can instead be written once to a small
+ * binary sidecar next to the drawing and loaded back in a single read,
+ * so later jobs seek straight to the entities they need.\n
+ * The sidecar is validated against the drawing's size and modification
+ * time and silently rejected when stale; it is a host-local cache and
+ * makes no attempt at a portable byte order.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#include <sys/stat.h>
+#include "sidecar.h"
+
+
+/*!
+ * The magic bytes opening a sidecar file.
+ */
+static const char dxf_sidecar_magic[8] = "DXFIDX\0";
+
+
+/*!
+ * \brief The on-disk header of a sidecar file.
+ */
+typedef struct
+dxf_sidecar_header
+{
+        char magic[8];
+                /*!< the magic bytes "DXFIDX". */
+        unsigned int version;
+                /*!< the format version, \c DXF_SIDECAR_VERSION. */
+        unsigned int reserved;
+                /*!< padding; written as zero. */
+        long long file_size;
+                /*!< size of the indexed drawing, in bytes. */
+        long long file_mtime;
+                /*!< modification time of the indexed drawing. */
+        long long record_count;
+                /*!< number of entity records that follow. */
+} DxfSidecarHeader;
+
+
+/*!
+ * \brief The on-disk form of one entity offset record.
+ */
+typedef struct
+dxf_sidecar_record
+{
+        long long offset;
+                /*!< file offset of the first group code after the
+                 * entity name. */
+        long long length;
+                /*!< number of bytes up to the next record boundary. */
+        long long line_number;
+                /*!< line number of the entity name line. */
+        int id_code;
+                /*!< the entity handle (group code 5), or \c 0. */
+        char type[DXF_LAZY_TYPE_LENGTH];
+                /*!< the entity type name. */
+        char layer[DXF_SIDECAR_LAYER_LENGTH];
+                /*!< the layer name, or "" when none was seen. */
+} DxfSidecarRecord;
+
+
+/*!
+ * \brief Compose the sidecar path for a drawing.
+ *
+ * \return a malloc'ed string "<filename>.dxfidx", or \c NULL when no
+ * memory was allocated.
+ */
+static char *
+dxf_sidecar_path
+(
+        const char *filename
+                /*!< filename of the drawing. */
+)
+{
+        char *path;
+
+        path = malloc (strlen (filename) + strlen (DXF_SIDECAR_SUFFIX) + 1);
+        if (path == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        strcpy (path, filename);
+        strcat (path, DXF_SIDECAR_SUFFIX);
+        return (path);
+}
+
+
+/*!
+ * \brief Write a lazy scan's offset records to the sidecar file of a
+ * drawing.
+ *
+ * The sidecar is stamped with the drawing's current size and
+ * modification time, so any later change to the drawing invalidates
+ * it.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_sidecar_write
+(
+        const char *filename,
+                /*!< filename of the indexed drawing; the sidecar is
+                 * written next to it. */
+        DxfLazyTable *table
+                /*!< the offset records from \c dxf_lazy_table_read. */
+)
+{
+        DxfSidecarHeader header;
+        DxfSidecarRecord record;
+        DxfLazyRecord *lazy;
+        struct stat file_stat;
+        char *path;
+        FILE *fp;
+        size_t i;
+
+        if ((filename == NULL) || (table == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (stat (filename, &file_stat) != 0)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not stat file: %s.\n")),
+                  __FUNCTION__, filename);
+                return (EXIT_FAILURE);
+        }
+        path = dxf_sidecar_path (filename);
+        if (path == NULL)
+        {
+                return (EXIT_FAILURE);
+        }
+        fp = fopen (path, "wb");
+        if (fp == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not open file: %s for writing.\n")),
+                  __FUNCTION__, path);
+                free (path);
+                return (EXIT_FAILURE);
+        }
+        memset (&header, 0, sizeof (header));
+        memcpy (header.magic, dxf_sidecar_magic, sizeof (header.magic));
+        header.version = DXF_SIDECAR_VERSION;
+        header.file_size = file_stat.st_size;
+        header.file_mtime = file_stat.st_mtime;
+        header.record_count = table->length;
+        if (fwrite (&header, sizeof (header), 1, fp) != 1)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () while writing to: %s.\n")),
+                  __FUNCTION__, path);
+                fclose (fp);
+                free (path);
+                return (EXIT_FAILURE);
+        }
+        for (i = 0; i < table->length; i++)
+        {
+                lazy = &table->records[i];
+                memset (&record, 0, sizeof (record));
+                record.offset = lazy->offset;
+                record.length = lazy->length;
+                record.line_number = lazy->line_number;
+                record.id_code = lazy->id_code;
+                strncpy (record.type, lazy->type,
+                        DXF_LAZY_TYPE_LENGTH - 1);
+                if (lazy->layer != NULL)
+                {
+                        strncpy (record.layer, lazy->layer,
+                                DXF_SIDECAR_LAYER_LENGTH - 1);
+                }
+                if (fwrite (&record, sizeof (record), 1, fp) != 1)
+                {
+                        fprintf (stderr,
+                          (_("Error in %s () while writing to: %s.\n")),
+                          __FUNCTION__, path);
+                        fclose (fp);
+                        free (path);
+                        return (EXIT_FAILURE);
+                }
+        }
+        fclose (fp);
+        free (path);
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Load the offset records for a drawing from its sidecar file.
+ *
+ * The sidecar is only accepted when its stamped size and modification
+ * time still match the drawing; a missing, stale or malformed sidecar
+ * returns \c NULL, in which case the caller falls back to
+ * \c dxf_lazy_table_read (and may rewrite the sidecar).
+ *
+ * \return a pointer to the loaded table, or \c NULL when no valid
+ * sidecar was found.
+ */
+DxfLazyTable *
+dxf_sidecar_read
+(
+        const char *filename
+                /*!< filename of the indexed drawing. */
+)
+{
+        DxfSidecarHeader header;
+        DxfSidecarRecord record;
+        DxfLazyTable *table;
+        DxfLazyRecord *lazy;
+        struct stat file_stat;
+        char *path;
+        FILE *fp;
+        long long i;
+
+        if (filename == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        if (stat (filename, &file_stat) != 0)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not stat file: %s.\n")),
+                  __FUNCTION__, filename);
+                return (NULL);
+        }
+        path = dxf_sidecar_path (filename);
+        if (path == NULL)
+        {
+                return (NULL);
+        }
+        fp = fopen (path, "rb");
+        if (fp == NULL)
+        {
+                /* No sidecar yet: not an error. */
+                free (path);
+                return (NULL);
+        }
+        if ((fread (&header, sizeof (header), 1, fp) != 1)
+                || (memcmp (header.magic, dxf_sidecar_magic,
+                        sizeof (header.magic)) != 0)
+                || (header.version != DXF_SIDECAR_VERSION)
+                || (header.file_size != (long long) file_stat.st_size)
+                || (header.file_mtime != (long long) file_stat.st_mtime)
+                || (header.record_count < 0))
+        {
+                /* Stale or malformed: fall back to a full scan. */
+                fclose (fp);
+                free (path);
+                return (NULL);
+        }
+        table = calloc (1, sizeof (DxfLazyTable));
+        if (table == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                fclose (fp);
+                free (path);
+                return (NULL);
+        }
+        if (header.record_count > 0)
+        {
+                table->records = calloc (header.record_count,
+                        sizeof (DxfLazyRecord));
+                if (table->records == NULL)
+                {
+                        fprintf (stderr,
+                          (_("Error in %s () could not allocate memory.\n")),
+                          __FUNCTION__);
+                        fclose (fp);
+                        free (path);
+                        free (table);
+                        return (NULL);
+                }
+                table->capacity = header.record_count;
+        }
+        for (i = 0; i < header.record_count; i++)
+        {
+                if (fread (&record, sizeof (record), 1, fp) != 1)
+                {
+                        /* Truncated: fall back to a full scan. */
+                        fclose (fp);
+                        free (path);
+                        dxf_lazy_table_free (table);
+                        return (NULL);
+                }
+                lazy = &table->records[i];
+                lazy->offset = record.offset;
+                lazy->length = record.length;
+                lazy->line_number = record.line_number;
+                lazy->id_code = record.id_code;
+                memcpy (lazy->type, record.type, DXF_LAZY_TYPE_LENGTH);
+                lazy->type[DXF_LAZY_TYPE_LENGTH - 1] = '\0';
+                if (record.layer[0] != '\0')
+                {
+                        record.layer[DXF_SIDECAR_LAYER_LENGTH - 1] = '\0';
+                        lazy->layer = strdup (record.layer);
+                }
+                table->length++;
+        }
+        fclose (fp);
+        free (path);
+        return (table);
+}
+
+
+/* EOF */
@@ -0,0 +1,77 @@
+/*!
+ * \file sidecar.h
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Header for the sidecar offset-index file format
+ * (\c .dxfidx).
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#ifndef LIBDXF_SRC_SIDECAR_H
+#define LIBDXF_SRC_SIDECAR_H
+
+
+#include "lazy.h"
+
+
+/*!
+ * The filename suffix of a sidecar offset-index file.
+ */
+#define DXF_SIDECAR_SUFFIX ".dxfidx"
+
+/*!
+ * The format version written into the sidecar header; bumped on
+ * layout changes so stale readers reject newer files.
+ */
+#define DXF_SIDECAR_VERSION 2
+
+/*!
+ * The size of the layer name field of an on-disk sidecar record;
+ * longer names fall back to a full scan.
+ */
+#define DXF_SIDECAR_LAYER_LENGTH 64
+
+
+int
+dxf_sidecar_write
+(
+        const char *filename,
+        DxfLazyTable *table
+);
+DxfLazyTable *
+dxf_sidecar_read
+(
+        const char *filename
+);
+
+
+#endif /* LIBDXF_SRC_SIDECAR_H */
+
+
+/* EOF */
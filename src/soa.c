@@ -0,0 +1,786 @@
+/*!
+ * \file soa.c
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Functions for structure-of-arrays coordinate storage of bulk
+ * geometry.
+ *
+ * Numeric passes (transforms, bounding boxes, clash detection) only
+ * touch the coordinate members of \c LINE, \c POINT and \c 3DFACE
+ * entities, yet used to drag the wide structs with all their string
+ * metadata through the cache.\n
+ * The stores in this file keep each coordinate in its own parallel
+ * \c double array, which packs eight values per cache line and lets
+ * the compiler vectorize loops over them; the full entity struct is
+ * only rebuilt on demand with the \c *_get accessors.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#include <math.h>
+
+#include "soa.h"
+
+
+/*!
+ * \brief Grow a set of parallel \c double arrays to a doubled
+ * capacity.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when no memory
+ * was allocated.
+ */
+static int
+dxf_soa_grow
+(
+        double **arrays[],
+                /*!< the parallel arrays, as pointers to their array
+                 * pointers. */
+        size_t count,
+                /*!< number of parallel arrays. */
+        size_t *capacity
+                /*!< current capacity, updated on success. */
+)
+{
+        size_t new_capacity;
+        double *new_array;
+        size_t i;
+
+        new_capacity = (*capacity == 0) ? 1024 : (*capacity * 2);
+        for (i = 0; i < count; i++)
+        {
+                new_array = realloc (*arrays[i], new_capacity * sizeof (double));
+                if (new_array == NULL)
+                {
+                        fprintf (stderr,
+                          (_("Error in %s () could not allocate memory.\n")),
+                          __FUNCTION__);
+                        return (EXIT_FAILURE);
+                }
+                *arrays[i] = new_array;
+        }
+        *capacity = new_capacity;
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Allocate an empty structure-of-arrays store for \c LINE
+ * coordinates.
+ *
+ * \return a pointer to the store, or \c NULL when no memory was
+ * allocated.
+ */
+DxfSoaLines *
+dxf_soa_lines_new ()
+{
+        DxfSoaLines *lines;
+
+        lines = calloc (1, sizeof (DxfSoaLines));
+        if (lines == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+        }
+        return (lines);
+}
+
+
+/*!
+ * \brief Append the coordinates of a \c LINE entity to a
+ * structure-of-arrays store.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_soa_lines_append
+(
+        DxfSoaLines *lines,
+                /*!< the store to append to. */
+        DxfLine *line
+                /*!< the parsed \c LINE entity. */
+)
+{
+        if ((lines == NULL) || (line == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (lines->length == lines->capacity)
+        {
+                double **arrays[] =
+                {
+                        &lines->x0, &lines->y0, &lines->z0,
+                        &lines->x1, &lines->y1, &lines->z1
+                };
+
+                if (dxf_soa_grow (arrays, 6, &lines->capacity) != EXIT_SUCCESS)
+                {
+                        return (EXIT_FAILURE);
+                }
+        }
+        lines->x0[lines->length] = line->x0;
+        lines->y0[lines->length] = line->y0;
+        lines->z0[lines->length] = line->z0;
+        lines->x1[lines->length] = line->x1;
+        lines->y1[lines->length] = line->y1;
+        lines->z1[lines->length] = line->z1;
+        lines->length++;
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Rebuild the coordinate members of a \c LINE entity from a
+ * structure-of-arrays store.
+ *
+ * Only the coordinates are filled in; \c line keeps its other members,
+ * so the metadata is not instantiated until the caller needs it.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_soa_lines_get
+(
+        DxfSoaLines *lines,
+                /*!< the store to read from. */
+        size_t index,
+                /*!< index of the stored line. */
+        DxfLine *line
+                /*!< the \c LINE entity to fill in. */
+)
+{
+        if ((lines == NULL) || (line == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (index >= lines->length)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () an out of range index was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        line->x0 = lines->x0[index];
+        line->y0 = lines->y0[index];
+        line->z0 = lines->z0[index];
+        line->x1 = lines->x1[index];
+        line->y1 = lines->y1[index];
+        line->z1 = lines->z1[index];
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Free a structure-of-arrays store for \c LINE coordinates.
+ */
+void
+dxf_soa_lines_free
+(
+        DxfSoaLines *lines
+                /*!< the store to free. */
+)
+{
+        if (lines == NULL)
+        {
+                return;
+        }
+        free (lines->x0);
+        free (lines->y0);
+        free (lines->z0);
+        free (lines->x1);
+        free (lines->y1);
+        free (lines->z1);
+        free (lines);
+}
+
+
+/*!
+ * \brief Allocate an empty structure-of-arrays store for \c POINT
+ * coordinates.
+ *
+ * \return a pointer to the store, or \c NULL when no memory was
+ * allocated.
+ */
+DxfSoaPoints *
+dxf_soa_points_new ()
+{
+        DxfSoaPoints *points;
+
+        points = calloc (1, sizeof (DxfSoaPoints));
+        if (points == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+        }
+        return (points);
+}
+
+
+/*!
+ * \brief Append the coordinates of a \c POINT entity to a
+ * structure-of-arrays store.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_soa_points_append
+(
+        DxfSoaPoints *points,
+                /*!< the store to append to. */
+        DxfPoint *point
+                /*!< the parsed \c POINT entity. */
+)
+{
+        if ((points == NULL) || (point == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (points->length == points->capacity)
+        {
+                double **arrays[] =
+                {
+                        &points->x0, &points->y0, &points->z0
+                };
+
+                if (dxf_soa_grow (arrays, 3, &points->capacity) != EXIT_SUCCESS)
+                {
+                        return (EXIT_FAILURE);
+                }
+        }
+        points->x0[points->length] = point->x0;
+        points->y0[points->length] = point->y0;
+        points->z0[points->length] = point->z0;
+        points->length++;
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Rebuild the coordinate members of a \c POINT entity from a
+ * structure-of-arrays store.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_soa_points_get
+(
+        DxfSoaPoints *points,
+                /*!< the store to read from. */
+        size_t index,
+                /*!< index of the stored point. */
+        DxfPoint *point
+                /*!< the \c POINT entity to fill in. */
+)
+{
+        if ((points == NULL) || (point == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (index >= points->length)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () an out of range index was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        point->x0 = points->x0[index];
+        point->y0 = points->y0[index];
+        point->z0 = points->z0[index];
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Free a structure-of-arrays store for \c POINT coordinates.
+ */
+void
+dxf_soa_points_free
+(
+        DxfSoaPoints *points
+                /*!< the store to free. */
+)
+{
+        if (points == NULL)
+        {
+                return;
+        }
+        free (points->x0);
+        free (points->y0);
+        free (points->z0);
+        free (points);
+}
+
+
+/*!
+ * \brief Allocate an empty structure-of-arrays store for \c 3DFACE
+ * corner coordinates.
+ *
+ * \return a pointer to the store, or \c NULL when no memory was
+ * allocated.
+ */
+DxfSoaFaces *
+dxf_soa_faces_new ()
+{
+        DxfSoaFaces *faces;
+
+        faces = calloc (1, sizeof (DxfSoaFaces));
+        if (faces == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+        }
+        return (faces);
+}
+
+
+/*!
+ * \brief Append the corner coordinates of a \c 3DFACE entity to a
+ * structure-of-arrays store.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_soa_faces_append
+(
+        DxfSoaFaces *faces,
+                /*!< the store to append to. */
+        Dxf3dface *face
+                /*!< the parsed \c 3DFACE entity. */
+)
+{
+        if ((faces == NULL) || (face == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (faces->length == faces->capacity)
+        {
+                double **arrays[] =
+                {
+                        &faces->x0, &faces->y0, &faces->z0,
+                        &faces->x1, &faces->y1, &faces->z1,
+                        &faces->x2, &faces->y2, &faces->z2,
+                        &faces->x3, &faces->y3, &faces->z3
+                };
+                int *new_flag;
+
+                if (dxf_soa_grow (arrays, 12, &faces->capacity) != EXIT_SUCCESS)
+                {
+                        return (EXIT_FAILURE);
+                }
+                new_flag = realloc (faces->flag, faces->capacity * sizeof (int));
+                if (new_flag == NULL)
+                {
+                        fprintf (stderr,
+                          (_("Error in %s () could not allocate memory.\n")),
+                          __FUNCTION__);
+                        return (EXIT_FAILURE);
+                }
+                faces->flag = new_flag;
+        }
+        faces->x0[faces->length] = face->x0;
+        faces->y0[faces->length] = face->y0;
+        faces->z0[faces->length] = face->z0;
+        faces->x1[faces->length] = face->x1;
+        faces->y1[faces->length] = face->y1;
+        faces->z1[faces->length] = face->z1;
+        faces->x2[faces->length] = face->x2;
+        faces->y2[faces->length] = face->y2;
+        faces->z2[faces->length] = face->z2;
+        faces->x3[faces->length] = face->x3;
+        faces->y3[faces->length] = face->y3;
+        faces->z3[faces->length] = face->z3;
+        faces->flag[faces->length] = face->flag;
+        faces->length++;
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Rebuild the corner coordinates of a \c 3DFACE entity from a
+ * structure-of-arrays store.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_soa_faces_get
+(
+        DxfSoaFaces *faces,
+                /*!< the store to read from. */
+        size_t index,
+                /*!< index of the stored face. */
+        Dxf3dface *face
+                /*!< the \c 3DFACE entity to fill in. */
+)
+{
+        if ((faces == NULL) || (face == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (index >= faces->length)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () an out of range index was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        face->x0 = faces->x0[index];
+        face->y0 = faces->y0[index];
+        face->z0 = faces->z0[index];
+        face->x1 = faces->x1[index];
+        face->y1 = faces->y1[index];
+        face->z1 = faces->z1[index];
+        face->x2 = faces->x2[index];
+        face->y2 = faces->y2[index];
+        face->z2 = faces->z2[index];
+        face->x3 = faces->x3[index];
+        face->y3 = faces->y3[index];
+        face->z3 = faces->z3[index];
+        face->flag = faces->flag[index];
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Compute the unit normal of every stored \c 3DFACE in one
+ * batch.
+ *
+ * The normal is the normalized cross product of the first and second
+ * edge of the face; because each coordinate lives in its own
+ * contiguous array the loop runs without pointer chasing and
+ * vectorizes.\n
+ * A face whose first three corners are collinear (or coincident) has
+ * no plane; its normal is stored as the zero vector.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_soa_faces_normals
+(
+        DxfSoaFaces *faces,
+                /*!< the store to read from. */
+        double *nx,
+                /*!< receives the X-values of the normals; at least
+                 * \c length elements. */
+        double *ny,
+                /*!< receives the Y-values of the normals; at least
+                 * \c length elements. */
+        double *nz
+                /*!< receives the Z-values of the normals; at least
+                 * \c length elements. */
+)
+{
+        size_t i;
+
+        if ((faces == NULL) || (nx == NULL) || (ny == NULL)
+                || (nz == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        for (i = 0; i < faces->length; i++)
+        {
+                double ux;
+                double uy;
+                double uz;
+                double vx;
+                double vy;
+                double vz;
+                double cx;
+                double cy;
+                double cz;
+                double norm;
+
+                ux = faces->x1[i] - faces->x0[i];
+                uy = faces->y1[i] - faces->y0[i];
+                uz = faces->z1[i] - faces->z0[i];
+                vx = faces->x2[i] - faces->x0[i];
+                vy = faces->y2[i] - faces->y0[i];
+                vz = faces->z2[i] - faces->z0[i];
+                cx = (uy * vz) - (uz * vy);
+                cy = (uz * vx) - (ux * vz);
+                cz = (ux * vy) - (uy * vx);
+                norm = sqrt ((cx * cx) + (cy * cy) + (cz * cz));
+                if (norm > 0.0)
+                {
+                        nx[i] = cx / norm;
+                        ny[i] = cy / norm;
+                        nz[i] = cz / norm;
+                }
+                else
+                {
+                        nx[i] = 0.0;
+                        ny[i] = 0.0;
+                        nz[i] = 0.0;
+                }
+        }
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Compute the drawn edges of every stored \c 3DFACE in one
+ * batch.
+ *
+ * For each face a four bit mask is stored: bit \c i (values 1, 2, 4
+ * and 8 as in the group 70 flag) is set when the edge from corner
+ * \c i to corner \c i + 1 is to be drawn, so it is clear when either
+ * the invisible edge flag of the face marks the edge, or the edge is
+ * degenerate (its corners coincide, as in the repeated fourth corner
+ * of a triangular face).
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_soa_faces_edge_visibility
+(
+        DxfSoaFaces *faces,
+                /*!< the store to read from. */
+        int *visible
+                /*!< receives the edge masks; at least \c length
+                 * elements. */
+)
+{
+        size_t i;
+
+        if ((faces == NULL) || (visible == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        for (i = 0; i < faces->length; i++)
+        {
+                int mask;
+
+                mask = (~faces->flag[i]) & 15;
+                if ((faces->x1[i] == faces->x0[i])
+                        && (faces->y1[i] == faces->y0[i])
+                        && (faces->z1[i] == faces->z0[i]))
+                {
+                        mask &= ~1;
+                }
+                if ((faces->x2[i] == faces->x1[i])
+                        && (faces->y2[i] == faces->y1[i])
+                        && (faces->z2[i] == faces->z1[i]))
+                {
+                        mask &= ~2;
+                }
+                if ((faces->x3[i] == faces->x2[i])
+                        && (faces->y3[i] == faces->y2[i])
+                        && (faces->z3[i] == faces->z2[i]))
+                {
+                        mask &= ~4;
+                }
+                if ((faces->x0[i] == faces->x3[i])
+                        && (faces->y0[i] == faces->y3[i])
+                        && (faces->z0[i] == faces->z3[i]))
+                {
+                        mask &= ~8;
+                }
+                visible[i] = mask;
+        }
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Free a structure-of-arrays store for \c 3DFACE corner
+ * coordinates.
+ */
+void
+dxf_soa_faces_free
+(
+        DxfSoaFaces *faces
+                /*!< the store to free. */
+)
+{
+        if (faces == NULL)
+        {
+                return;
+        }
+        free (faces->x0);
+        free (faces->y0);
+        free (faces->z0);
+        free (faces->x1);
+        free (faces->y1);
+        free (faces->z1);
+        free (faces->x2);
+        free (faces->y2);
+        free (faces->z2);
+        free (faces->x3);
+        free (faces->y3);
+        free (faces->z3);
+        free (faces->flag);
+        free (faces);
+}
+
+
+/*!
+ * \brief Streaming callback storing \c LINE coordinates into the
+ * collector's store.
+ */
+static int
+dxf_soa_collect_line
+(
+        DxfFile *fp,
+        DxfLine *line,
+        void *user_data
+)
+{
+        DxfSoaCollector *collector = user_data;
+
+        return (dxf_soa_lines_append (collector->lines, line));
+}
+
+
+/*!
+ * \brief Streaming callback storing \c POINT coordinates into the
+ * collector's store.
+ */
+static int
+dxf_soa_collect_point
+(
+        DxfFile *fp,
+        DxfPoint *point,
+        void *user_data
+)
+{
+        DxfSoaCollector *collector = user_data;
+
+        return (dxf_soa_points_append (collector->points, point));
+}
+
+
+/*!
+ * \brief Streaming callback storing \c 3DFACE corner coordinates into
+ * the collector's store.
+ */
+static int
+dxf_soa_collect_face
+(
+        DxfFile *fp,
+        Dxf3dface *face,
+        void *user_data
+)
+{
+        DxfSoaCollector *collector = user_data;
+
+        return (dxf_soa_faces_append (collector->faces, face));
+}
+
+
+/*!
+ * \brief Wire structure-of-arrays stores into a set of streaming read
+ * handlers.
+ *
+ * Installs callbacks which append the coordinates of every parsed
+ * \c LINE, \c POINT and \c 3DFACE entity into the passed stores;
+ * a \c NULL store leaves the respective callback unset, so that
+ * entity type is parsed but not collected.\n
+ * The handlers struct is zeroed first; combine with other callbacks by
+ * setting them afterwards.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_soa_collector_init
+(
+        DxfSoaCollector *collector,
+                /*!< the collector glueing stores to callbacks; must
+                 * stay alive for the duration of the read. */
+        DxfReadHandlers *handlers,
+                /*!< the streaming read handlers to initialize. */
+        DxfSoaLines *lines,
+                /*!< store for \c LINE coordinates, or \c NULL. */
+        DxfSoaPoints *points,
+                /*!< store for \c POINT coordinates, or \c NULL. */
+        DxfSoaFaces *faces
+                /*!< store for \c 3DFACE coordinates, or \c NULL. */
+)
+{
+        if ((collector == NULL) || (handlers == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        collector->lines = lines;
+        collector->points = points;
+        collector->faces = faces;
+        memset (handlers, 0, sizeof (DxfReadHandlers));
+        handlers->user_data = collector;
+        if (lines != NULL)
+        {
+                handlers->line = dxf_soa_collect_line;
+        }
+        if (points != NULL)
+        {
+                handlers->point = dxf_soa_collect_point;
+        }
+        if (faces != NULL)
+        {
+                handlers->face = dxf_soa_collect_face;
+        }
+        return (EXIT_SUCCESS);
+}
+
+
+/* EOF */
@@ -0,0 +1,237 @@
+/*!
+ * \file soa.h
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Header for structure-of-arrays coordinate storage of bulk
+ * geometry.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#ifndef LIBDXF_SRC_SOA_H
+#define LIBDXF_SRC_SOA_H
+
+
+#include "global.h"
+#include "entities.h"
+
+
+/*!
+ * \brief Structure-of-arrays storage for \c LINE coordinates.
+ *
+ * All arrays have \c length valid elements and grow together.
+ */
+typedef struct
+dxf_soa_lines
+{
+        size_t length;
+                /*!< number of stored lines. */
+        size_t capacity;
+                /*!< number of allocated elements per array. */
+        double *x0;
+                /*!< X-values of the start point. */
+        double *y0;
+                /*!< Y-values of the start point. */
+        double *z0;
+                /*!< Z-values of the start point. */
+        double *x1;
+                /*!< X-values of the end point. */
+        double *y1;
+                /*!< Y-values of the end point. */
+        double *z1;
+                /*!< Z-values of the end point. */
+} DxfSoaLines;
+
+
+/*!
+ * \brief Structure-of-arrays storage for \c POINT coordinates.
+ */
+typedef struct
+dxf_soa_points
+{
+        size_t length;
+                /*!< number of stored points. */
+        size_t capacity;
+                /*!< number of allocated elements per array. */
+        double *x0;
+                /*!< X-values. */
+        double *y0;
+                /*!< Y-values. */
+        double *z0;
+                /*!< Z-values. */
+} DxfSoaPoints;
+
+
+/*!
+ * \brief Structure-of-arrays storage for \c 3DFACE corner coordinates.
+ */
+typedef struct
+dxf_soa_faces
+{
+        size_t length;
+                /*!< number of stored faces. */
+        size_t capacity;
+                /*!< number of allocated elements per array. */
+        double *x0;
+                /*!< X-values of the first corner. */
+        double *y0;
+                /*!< Y-values of the first corner. */
+        double *z0;
+                /*!< Z-values of the first corner. */
+        double *x1;
+                /*!< X-values of the second corner. */
+        double *y1;
+                /*!< Y-values of the second corner. */
+        double *z1;
+                /*!< Z-values of the second corner. */
+        double *x2;
+                /*!< X-values of the third corner. */
+        double *y2;
+                /*!< Y-values of the third corner. */
+        double *z2;
+                /*!< Z-values of the third corner. */
+        double *x3;
+                /*!< X-values of the fourth corner. */
+        double *y3;
+                /*!< Y-values of the fourth corner. */
+        double *z3;
+                /*!< Z-values of the fourth corner. */
+        int *flag;
+                /*!< invisible edge flags (group code 70), see
+                 * \c Dxf3dface. */
+} DxfSoaFaces;
+
+
+/*!
+ * \brief Glue for populating structure-of-arrays stores from the
+ * streaming reader.
+ *
+ * Passed as \c user_data to the callbacks installed by
+ * \c dxf_soa_collector_init.
+ */
+typedef struct
+dxf_soa_collector
+{
+        DxfSoaLines *lines;
+                /*!< store for \c LINE coordinates, or \c NULL. */
+        DxfSoaPoints *points;
+                /*!< store for \c POINT coordinates, or \c NULL. */
+        DxfSoaFaces *faces;
+                /*!< store for \c 3DFACE coordinates, or \c NULL. */
+} DxfSoaCollector;
+
+
+DxfSoaLines *
+dxf_soa_lines_new ();
+int
+dxf_soa_lines_append
+(
+        DxfSoaLines *lines,
+        DxfLine *line
+);
+int
+dxf_soa_lines_get
+(
+        DxfSoaLines *lines,
+        size_t index,
+        DxfLine *line
+);
+void
+dxf_soa_lines_free
+(
+        DxfSoaLines *lines
+);
+DxfSoaPoints *
+dxf_soa_points_new ();
+int
+dxf_soa_points_append
+(
+        DxfSoaPoints *points,
+        DxfPoint *point
+);
+int
+dxf_soa_points_get
+(
+        DxfSoaPoints *points,
+        size_t index,
+        DxfPoint *point
+);
+void
+dxf_soa_points_free
+(
+        DxfSoaPoints *points
+);
+DxfSoaFaces *
+dxf_soa_faces_new ();
+int
+dxf_soa_faces_append
+(
+        DxfSoaFaces *faces,
+        Dxf3dface *face
+);
+int
+dxf_soa_faces_get
+(
+        DxfSoaFaces *faces,
+        size_t index,
+        Dxf3dface *face
+);
+int
+dxf_soa_faces_normals
+(
+        DxfSoaFaces *faces,
+        double *nx,
+        double *ny,
+        double *nz
+);
+int
+dxf_soa_faces_edge_visibility
+(
+        DxfSoaFaces *faces,
+        int *visible
+);
+void
+dxf_soa_faces_free
+(
+        DxfSoaFaces *faces
+);
+int
+dxf_soa_collector_init
+(
+        DxfSoaCollector *collector,
+        DxfReadHandlers *handlers,
+        DxfSoaLines *lines,
+        DxfSoaPoints *points,
+        DxfSoaFaces *faces
+);
+
+
+#endif /* LIBDXF_SRC_SOA_H */
+
+
+/* EOF */
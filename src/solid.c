@@ -39,7 +39,11 @@
  */
 
 
+#include <pthread.h>
 #include "solid.h"
+#include "diag.h"
+#include "allocator.h"
+#include "util.h"
 
 
 /*!
@@ -65,7 +69,7 @@ dxf_solid_new ()
         size = sizeof (DxfSolid);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_solid = malloc (size)) == NULL)
+        if ((dxf_solid = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfSolid struct.\n")),
@@ -105,6 +109,11 @@ dxf_solid_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfSolid template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         /* Do some basic checks. */
         if (dxf_solid == NULL)
         {
@@ -120,33 +129,44 @@ dxf_solid_init
                   __FUNCTION__);
                 return (NULL);
         }
-        dxf_solid->id_code = 0;
-        dxf_solid->linetype = strdup (DXF_DEFAULT_LINETYPE);
-        dxf_solid->layer = strdup (DXF_DEFAULT_LAYER);
-        dxf_solid->x0 = 0.0;
-        dxf_solid->y0 = 0.0;
-        dxf_solid->z0 = 0.0;
-        dxf_solid->x1 = 0.0;
-        dxf_solid->y1 = 0.0;
-        dxf_solid->z1 = 0.0;
-        dxf_solid->x2 = 0.0;
-        dxf_solid->y2 = 0.0;
-        dxf_solid->z2 = 0.0;
-        dxf_solid->x3 = 0.0;
-        dxf_solid->y3 = 0.0;
-        dxf_solid->z3 = 0.0;
-        dxf_solid->extr_x0 = 0.0;
-        dxf_solid->extr_y0 = 0.0;
-        dxf_solid->extr_z0 = 0.0;
-        dxf_solid->elevation = 0.0;
-        dxf_solid->thickness = 0.0;
-        dxf_solid->linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
-        dxf_solid->visibility = DXF_DEFAULT_VISIBILITY;
-        dxf_solid->color = DXF_COLOR_BYLAYER;
-        dxf_solid->paperspace = DXF_MODELSPACE;
-        dxf_solid->dictionary_owner_soft = strdup ("");
-        dxf_solid->dictionary_owner_hard = strdup ("");
-        dxf_solid->next = NULL;
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.id_code = 0;
+                template.linetype = strdup (DXF_DEFAULT_LINETYPE);
+                template.layer = strdup (DXF_DEFAULT_LAYER);
+                template.x0 = 0.0;
+                template.y0 = 0.0;
+                template.z0 = 0.0;
+                template.x1 = 0.0;
+                template.y1 = 0.0;
+                template.z1 = 0.0;
+                template.x2 = 0.0;
+                template.y2 = 0.0;
+                template.z2 = 0.0;
+                template.x3 = 0.0;
+                template.y3 = 0.0;
+                template.z3 = 0.0;
+                template.extr_x0 = 0.0;
+                template.extr_y0 = 0.0;
+                template.extr_z0 = 0.0;
+                template.elevation = 0.0;
+                template.thickness = 0.0;
+                template.linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
+                template.visibility = DXF_DEFAULT_VISIBILITY;
+                template.color = DXF_COLOR_BYLAYER;
+                template.paperspace = DXF_MODELSPACE;
+                template.dictionary_owner_soft = strdup ("");
+                template.dictionary_owner_hard = strdup ("");
+                template.next = NULL;
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (dxf_solid, &template, sizeof (DxfSolid));
+        dxf_solid->linetype = strdup (template.linetype);
+        dxf_solid->layer = strdup (template.layer);
+        dxf_solid->dictionary_owner_soft = strdup (template.dictionary_owner_soft);
+        dxf_solid->dictionary_owner_hard = strdup (template.dictionary_owner_hard);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -183,7 +203,7 @@ dxf_solid_read
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        char *temp_string = NULL;
+        char temp_string[DXF_MAX_STRING_LENGTH];
 
         /* Do some basic checks. */
         if (fp == NULL)
@@ -201,14 +221,13 @@ dxf_solid_read
                 dxf_solid = dxf_solid_new ();
                 dxf_solid = dxf_solid_init (dxf_solid);
         }
-        (fp->line_number)++;
-        fscanf (fp->fp, "%[^\n]", temp_string);
+        dxf_read_line (temp_string, fp);
         while (strcmp (temp_string, "0") != 0)
         {
                 if (ferror (fp->fp))
                 {
                         fprintf (stderr,
-                          (_("Error in %s () while reading from: %s in line: %d.\n")),
+                          (_("Error in %s () while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                         fclose (fp->fp);
                         return (NULL);
@@ -217,105 +236,94 @@ dxf_solid_read
                 {
                         /* Now follows a string containing a sequential
                          * id number. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%x\n", &dxf_solid->id_code);
+                                                dxf_read_scanf (fp, "%x\n", &dxf_solid->id_code);
                 }
                 else if (strcmp (temp_string, "6") == 0)
                 {
                         /* Now follows a string containing a linetype
                          * name. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_solid->linetype);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
+                        free (dxf_solid->linetype);
+                        dxf_solid->linetype = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "8") == 0)
                 {
                         /* Now follows a string containing a layer name. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_solid->layer);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
+                        free (dxf_solid->layer);
+                        dxf_solid->layer = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "10") == 0)
                 {
                         /* Now follows a string containing the
                          * X-coordinate of the point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_solid->x0);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_solid->x0);
                 }
                 else if (strcmp (temp_string, "20") == 0)
                 {
                         /* Now follows a string containing the
                          * Y-coordinate of the point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_solid->y0);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_solid->y0);
                 }
                 else if (strcmp (temp_string, "30") == 0)
                 {
                         /* Now follows a string containing the
                          * Z-coordinate of the point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_solid->z0);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_solid->z0);
                 }
                 else if (strcmp (temp_string, "11") == 0)
                 {
                         /* Now follows a string containing the
                          * X-coordinate of the point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_solid->x1);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_solid->x1);
                 }
                 else if (strcmp (temp_string, "21") == 0)
                 {
                         /* Now follows a string containing the
                          * Y-coordinate of the point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_solid->y1);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_solid->y1);
                 }
                 else if (strcmp (temp_string, "31") == 0)
                 {
                         /* Now follows a string containing the
                          * Z-coordinate of the point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_solid->z1);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_solid->z1);
                 }
                 else if (strcmp (temp_string, "12") == 0)
                 {
                         /* Now follows a string containing the
                          * X-coordinate of the point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_solid->x2);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_solid->x2);
                 }
                 else if (strcmp (temp_string, "22") == 0)
                 {
                         /* Now follows a string containing the
                          * Y-coordinate of the point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_solid->y2);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_solid->y2);
                 }
                 else if (strcmp (temp_string, "32") == 0)
                 {
                         /* Now follows a string containing the
                          * Z-coordinate of the point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_solid->z2);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_solid->z2);
                 }
                 else if (strcmp (temp_string, "13") == 0)
                 {
                         /* Now follows a string containing the
                          * X-coordinate of the point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_solid->x3);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_solid->x3);
                 }
                 else if (strcmp (temp_string, "23") == 0)
                 {
                         /* Now follows a string containing the
                          * Y-coordinate of the point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_solid->y3);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_solid->y3);
                 }
                 else if (strcmp (temp_string, "33") == 0)
                 {
                         /* Now follows a string containing the
                          * Z-coordinate of the point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_solid->z3);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_solid->z3);
                 }
                 else if ((fp->acad_version_number <= AutoCAD_11)
                         && (strcmp (temp_string, "38") == 0)
@@ -323,43 +331,37 @@ dxf_solid_read
                 {
                         /* Now follows a string containing the
                          * elevation. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_solid->elevation);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_solid->elevation);
                 }
                 else if (strcmp (temp_string, "39") == 0)
                 {
                         /* Now follows a string containing the
                          * thickness. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_solid->thickness);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_solid->thickness);
                 }
                 else if (strcmp (temp_string, "48") == 0)
                 {
                         /* Now follows a string containing the linetype
                          * scale. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_solid->linetype_scale);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_solid->linetype_scale);
                 }
                 else if (strcmp (temp_string, "60") == 0)
                 {
                         /* Now follows a string containing the
                          * visibility value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%hd\n", &dxf_solid->visibility);
+                                                dxf_read_scanf (fp, "%hd\n", &dxf_solid->visibility);
                 }
                 else if (strcmp (temp_string, "62") == 0)
                 {
                         /* Now follows a string containing the
                          * color value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_solid->color);
+                                                dxf_read_scanf (fp, "%d\n", &dxf_solid->color);
                 }
                 else if (strcmp (temp_string, "67") == 0)
                 {
                         /* Now follows a string containing the
                          * paperspace value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_solid->paperspace);
+                                                dxf_read_scanf (fp, "%d\n", &dxf_solid->paperspace);
                 }
                 else if ((fp->acad_version_number >= AutoCAD_12)
                         && (strcmp (temp_string, "100") == 0))
@@ -369,57 +371,58 @@ dxf_solid_read
                          * version should probably be added here.
                          * Now follows a string containing the
                          * subclass marker value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", temp_string);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
                 }
                 else if (strcmp (temp_string, "210") == 0)
                 {
                         /* Now follows a string containing the
                          * X-value of the extrusion vector. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_solid->extr_x0);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_solid->extr_x0);
                 }
                 else if (strcmp (temp_string, "220") == 0)
                 {
                         /* Now follows a string containing the
                          * Y-value of the extrusion vector. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_solid->extr_y0);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_solid->extr_y0);
                 }
                 else if (strcmp (temp_string, "230") == 0)
                 {
                         /* Now follows a string containing the
                          * Z-value of the extrusion vector. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_solid->extr_z0);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_solid->extr_z0);
                 }
                 else if (strcmp (temp_string, "330") == 0)
                 {
                         /* Now follows a string containing Soft-pointer
                          * ID/handle to owner dictionary. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_solid->dictionary_owner_soft);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
+                        free (dxf_solid->dictionary_owner_soft);
+                        dxf_solid->dictionary_owner_soft = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "360") == 0)
                 {
                         /* Now follows a string containing Hard owner
                          * ID/handle to owner dictionary. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_solid->dictionary_owner_hard);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
+                        free (dxf_solid->dictionary_owner_hard);
+                        dxf_solid->dictionary_owner_hard = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "999") == 0)
                 {
                         /* Now follows a string containing a comment. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", temp_string);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
                         fprintf (stdout, "DXF comment: %s\n", temp_string);
                 }
                 else
                 {
-                        fprintf (stderr,
-                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %d.\n")),
+                        dxf_diag_report (fp, DXF_DIAG_WARNING,
+                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                 }
+                if (dxf_read_line (temp_string, fp) != 1)
+                {
+                        break;
+                }
         }
         /* Handle omitted members and/or illegal values. */
         if (strcmp (dxf_solid->linetype, "") == 0)
@@ -630,7 +633,7 @@ dxf_solid_free
         free (dxf_solid->layer);
         free (dxf_solid->dictionary_owner_soft);
         free (dxf_solid->dictionary_owner_hard);
-        free (dxf_solid);
+        dxf_entity_dealloc (dxf_solid, sizeof (*dxf_solid));
         dxf_solid = NULL;
 #if DEBUG
         DXF_DEBUG_END
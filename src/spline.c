@@ -224,7 +224,23 @@
  */
 
 
+#include <pthread.h>
 #include "spline.h"
+#include "diag.h"
+#include "allocator.h"
+#include "util.h"
+
+
+/*!
+ * \brief The highest spline degree the evaluator supports.
+ */
+#define DXF_SPLINE_MAX_DEGREE 15
+
+/*!
+ * \brief Number of parameter values evaluated per basis computation in
+ * \c dxf_spline_tessellate.
+ */
+#define DXF_SPLINE_BATCH 64
 
 
 /*!
@@ -253,7 +269,7 @@ dxf_spline_new ()
         size = sizeof (DxfSpline);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_spline = malloc (size)) == NULL)
+        if ((dxf_spline = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfSpline struct.\n")),
@@ -294,6 +310,11 @@ dxf_spline_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfSpline template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         int i;
 
         /* Do some basic checks. */
@@ -311,55 +332,80 @@ dxf_spline_init
                   __FUNCTION__);
                 return (NULL);
         }
-        dxf_spline->id_code = 0;
-        dxf_spline->linetype = strdup (DXF_DEFAULT_LINETYPE);
-        dxf_spline->layer = strdup (DXF_DEFAULT_LAYER);
-        dxf_spline->elevation = 0.0;
-        dxf_spline->thickness = 0.0;
-        dxf_spline->linetype_scale = 1.0;
-        dxf_spline->visibility = 0;
-        dxf_spline->color = DXF_COLOR_BYLAYER;
-        dxf_spline->paperspace = DXF_MODELSPACE;
-        dxf_spline->graphics_data_size = 0;
-        dxf_spline->shadow_mode = 0;
-        dxf_spline->dictionary_owner_soft = strdup ("");
-        dxf_spline->material = strdup ("");
-        dxf_spline->dictionary_owner_hard = strdup ("");
-        dxf_spline->lineweight = 0;
-        dxf_spline->plot_style_name = strdup ("");
-        dxf_spline->color_value = 0;
-        dxf_spline->color_name = strdup ("");
-        dxf_spline->transparency = 0;
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.id_code = 0;
+                template.linetype = strdup (DXF_DEFAULT_LINETYPE);
+                template.layer = strdup (DXF_DEFAULT_LAYER);
+                template.elevation = 0.0;
+                template.thickness = 0.0;
+                template.linetype_scale = 1.0;
+                template.visibility = 0;
+                template.color = DXF_COLOR_BYLAYER;
+                template.paperspace = DXF_MODELSPACE;
+                template.graphics_data_size = 0;
+                template.shadow_mode = 0;
+                template.dictionary_owner_soft = strdup ("");
+                template.material = strdup ("");
+                template.dictionary_owner_hard = strdup ("");
+                template.lineweight = 0;
+                template.plot_style_name = strdup ("");
+                template.color_value = 0;
+                template.color_name = strdup ("");
+                template.transparency = 0;
+                for (i = 0; i < DXF_MAX_PARAM; i++)
+                {
+                        template.binary_graphics_data[i] = strdup ("");
+                }
+                template.x0 = NULL;
+                template.y0 = NULL;
+                template.z0 = NULL;
+                template.x1 = NULL;
+                template.y1 = NULL;
+                template.z1 = NULL;
+                template.knot_value = NULL;
+                template.weight_value = NULL;
+                template.x2 = 0.0;
+                template.y2 = 0.0;
+                template.z2 = 0.0;
+                template.x3 = 0.0;
+                template.y3 = 0.0;
+                template.z3 = 0.0;
+                template.extr_x0 = 0.0;
+                template.extr_y0 = 0.0;
+                template.extr_z0 = 0.0;
+                template.knot_tolerance = 0.0;
+                template.control_point_tolerance = 0.0;
+                template.fit_tolerance = 0.0;
+                template.flag = 0;
+                template.degree = 0;
+                template.number_of_knots = 0;
+                template.number_of_control_points = 0;
+                template.number_of_fit_points = 0;
+                template.knots_size = 0;
+                template.weights_size = 0;
+                template.control_points_size = 0;
+                template.fit_points_size = 0;
+                template.next = NULL;
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (dxf_spline, &template, sizeof (DxfSpline));
         for (i = 0; i < DXF_MAX_PARAM; i++)
         {
+                /* every instance owns its entries: the reader frees and
+                 * replaces them, so sharing the template strings would
+                 * free them twice. */
                 dxf_spline->binary_graphics_data[i] = strdup ("");
-                dxf_spline->x0[i] = 0.0;
-                dxf_spline->y0[i] = 0.0;
-                dxf_spline->z0[i] = 0.0;
-                dxf_spline->x1[i] = 0.0;
-                dxf_spline->y1[i] = 0.0;
-                dxf_spline->z1[i] = 0.0;
-                dxf_spline->knot_value[i] = 0.0;
-                dxf_spline->weight_value[i] = 0.0;
         }
-        dxf_spline->x2 = 0.0;
-        dxf_spline->y2 = 0.0;
-        dxf_spline->z2 = 0.0;
-        dxf_spline->x3 = 0.0;
-        dxf_spline->y3 = 0.0;
-        dxf_spline->z3 = 0.0;
-        dxf_spline->extr_x0 = 0.0;
-        dxf_spline->extr_y0 = 0.0;
-        dxf_spline->extr_z0 = 0.0;
-        dxf_spline->knot_tolerance = 0.0;
-        dxf_spline->control_point_tolerance = 0.0;
-        dxf_spline->fit_tolerance = 0.0;
-        dxf_spline->flag = 0;
-        dxf_spline->degree = 0;
-        dxf_spline->number_of_knots = 0;
-        dxf_spline->number_of_control_points = 0;
-        dxf_spline->number_of_fit_points = 0;
-        dxf_spline->next = NULL;
+        dxf_spline->linetype = strdup (template.linetype);
+        dxf_spline->layer = strdup (template.layer);
+        dxf_spline->dictionary_owner_soft = strdup (template.dictionary_owner_soft);
+        dxf_spline->material = strdup (template.material);
+        dxf_spline->dictionary_owner_hard = strdup (template.dictionary_owner_hard);
+        dxf_spline->plot_style_name = strdup (template.plot_style_name);
+        dxf_spline->color_name = strdup (template.color_name);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -367,6 +413,154 @@ dxf_spline_init
 }
 
 
+/*!
+ * \brief Grow a contiguous \c double array to hold at least \c needed
+ * entries.
+ *
+ * The array is grown by doubling (starting at 16 entries) so repeated
+ * single appends stay cheap; new entries are zeroed.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when an error
+ * occurred.
+ */
+static int
+dxf_spline_grow_array
+(
+        double **array,
+                /*!< the array to grow. */
+        int *size,
+                /*!< number of allocated entries, updated on growth. */
+        int needed
+                /*!< number of entries the array shall hold. */
+)
+{
+        double *values;
+        int new_size;
+
+        if (needed <= *size)
+        {
+                return (EXIT_SUCCESS);
+        }
+        new_size = (*size == 0) ? 16 : (*size * 2);
+        if (new_size < needed)
+        {
+                new_size = needed;
+        }
+        values = realloc (*array, new_size * sizeof (double));
+        if (values == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        memset (&values[*size], 0, (new_size - *size) * sizeof (double));
+        *array = values;
+        *size = new_size;
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Grow three parallel coordinate arrays sharing one capacity to
+ * hold at least \c needed entries each.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when an error
+ * occurred.
+ */
+static int
+dxf_spline_grow_point_arrays
+(
+        double **x,
+                /*!< the array of X-values to grow. */
+        double **y,
+                /*!< the array of Y-values to grow. */
+        double **z,
+                /*!< the array of Z-values to grow. */
+        int *size,
+                /*!< shared number of allocated entries per array,
+                 * updated on growth. */
+        int needed
+                /*!< number of entries each array shall hold. */
+)
+{
+        int x_size;
+        int y_size;
+        int z_size;
+
+        x_size = *size;
+        y_size = *size;
+        z_size = *size;
+        if ((dxf_spline_grow_array (x, &x_size, needed) != EXIT_SUCCESS)
+          || (dxf_spline_grow_array (y, &y_size, needed) != EXIT_SUCCESS)
+          || (dxf_spline_grow_array (z, &z_size, needed) != EXIT_SUCCESS))
+        {
+                return (EXIT_FAILURE);
+        }
+        /* the growth is deterministic: all three sizes are equal. */
+        *size = x_size;
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Reserve storage in a DXF \c SPLINE entity for a known number
+ * of knots, control points and fit points.
+ *
+ * The counts are the values of group codes 72, 73 and 74, which a DXF
+ * file declares before the values follow, so the arrays can be sized
+ * exactly once instead of growing while reading.\n
+ * Weights (group code 41) come one per control point and are reserved
+ * along with the control points.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when an error
+ * occurred.
+ */
+int
+dxf_spline_reserve
+(
+        DxfSpline *dxf_spline,
+                /*!< DXF spline entity. */
+        int number_of_knots,
+                /*!< number of knots to reserve for (group code 72). */
+        int number_of_control_points,
+                /*!< number of control points to reserve for (group
+                 * code 73). */
+        int number_of_fit_points
+                /*!< number of fit points to reserve for (group code
+                 * 74). */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        if (dxf_spline == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if ((dxf_spline_grow_array (&dxf_spline->knot_value,
+                &dxf_spline->knots_size, number_of_knots) != EXIT_SUCCESS)
+          || (dxf_spline_grow_array (&dxf_spline->weight_value,
+                &dxf_spline->weights_size, number_of_control_points) != EXIT_SUCCESS)
+          || (dxf_spline_grow_point_arrays (&dxf_spline->x0,
+                &dxf_spline->y0, &dxf_spline->z0,
+                &dxf_spline->control_points_size, number_of_control_points) != EXIT_SUCCESS)
+          || (dxf_spline_grow_point_arrays (&dxf_spline->x1,
+                &dxf_spline->y1, &dxf_spline->z1,
+                &dxf_spline->fit_points_size, number_of_fit_points) != EXIT_SUCCESS))
+        {
+                return (EXIT_FAILURE);
+        }
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (EXIT_SUCCESS);
+}
+
+
 /*!
  * \brief Read data from a DXF file into a DXF \c SPLINE entity.
  *
@@ -396,7 +590,7 @@ dxf_spline_read
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        char *temp_string = NULL;
+        char temp_string[DXF_MAX_STRING_LENGTH];
         int i_x0;
         int i_y0;
         int i_z0;
@@ -432,14 +626,13 @@ dxf_spline_read
         i_knot_value = 0;
         i_weight_value = 0;
         i_graphics_data_size = 0;
-        (fp->line_number)++;
-        fscanf (fp->fp, "%[^\n]", temp_string);
+        dxf_read_line (temp_string, fp);
         while (strcmp (temp_string, "0") != 0)
         {
                 if (ferror (fp->fp))
                 {
                         fprintf (stderr,
-                          (_("Error in %s () while reading from: %s in line: %d.\n")),
+                          (_("Error in %s () while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                         fclose (fp->fp);
                         return (NULL);
@@ -456,28 +649,83 @@ dxf_spline_read
                         /* Now follows a string containing a linetype
                          * name. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_spline->linetype);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_spline->linetype);
+                        dxf_spline->linetype = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "8") == 0)
                 {
                         /* Now follows a string containing a layer name. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_spline->layer);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_spline->layer);
+                        dxf_spline->layer = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "10") == 0)
                 {
-                        /* Now follows a string containing the
-                         * X-value of the control point coordinate
-                         * (multiple entries). */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_spline->x0[i_x0]);
-                        i_x0++;
+                        /* Now follow the control point coordinates,
+                         * usually an uninterrupted run of 10/20/30
+                         * groups: read them in one tight batch loop. */
+                        for (;;)
+                        {
+                                if (dxf_spline_grow_point_arrays (&dxf_spline->x0,
+                                        &dxf_spline->y0, &dxf_spline->z0,
+                                        &dxf_spline->control_points_size,
+                                        i_x0 + 1) != EXIT_SUCCESS)
+                                {
+                                        return (NULL);
+                                }
+                                (fp->line_number)++;
+                                fscanf (fp->fp, "%lf\n", &dxf_spline->x0[i_x0]);
+                                i_x0++;
+                                if (dxf_read_line (temp_string, fp) != 1)
+                                {
+                                        strcpy (temp_string, "0");
+                                        break;
+                                }
+                                if (strcmp (temp_string, "20") == 0)
+                                {
+                                        (fp->line_number)++;
+                                        fscanf (fp->fp, "%lf\n", &dxf_spline->y0[i_y0]);
+                                        i_y0++;
+                                        if (dxf_read_line (temp_string, fp) != 1)
+                                        {
+                                                strcpy (temp_string, "0");
+                                                break;
+                                        }
+                                }
+                                if (strcmp (temp_string, "30") == 0)
+                                {
+                                        (fp->line_number)++;
+                                        fscanf (fp->fp, "%lf\n", &dxf_spline->z0[i_z0]);
+                                        i_z0++;
+                                        if (dxf_read_line (temp_string, fp) != 1)
+                                        {
+                                                strcpy (temp_string, "0");
+                                                break;
+                                        }
+                                }
+                                if (strcmp (temp_string, "10") != 0)
+                                {
+                                        break;
+                                }
+                        }
+                        /* the tag following the batch is already in
+                         * temp_string. */
+                        continue;
                 }
                 else if (strcmp (temp_string, "20") == 0)
                 {
                         /* Now follows a string containing the
                          * Y-coordinate of control point coordinate
                          * (multiple entries). */
+                        if (dxf_spline_grow_point_arrays (&dxf_spline->x0,
+                                &dxf_spline->y0, &dxf_spline->z0,
+                                &dxf_spline->control_points_size,
+                                i_y0 + 1) != EXIT_SUCCESS)
+                        {
+                                return (NULL);
+                        }
                         (fp->line_number)++;
                         fscanf (fp->fp, "%lf\n", &dxf_spline->y0[i_y0]);
                         i_y0++;
@@ -487,24 +735,82 @@ dxf_spline_read
                         /* Now follows a string containing the
                          * Z-coordinate of the control point coordinate
                          * (multiple entries). */
+                        if (dxf_spline_grow_point_arrays (&dxf_spline->x0,
+                                &dxf_spline->y0, &dxf_spline->z0,
+                                &dxf_spline->control_points_size,
+                                i_z0 + 1) != EXIT_SUCCESS)
+                        {
+                                return (NULL);
+                        }
                         (fp->line_number)++;
                         fscanf (fp->fp, "%lf\n", &dxf_spline->z0[i_z0]);
                         i_z0++;
                 }
                 else if (strcmp (temp_string, "11") == 0)
                 {
-                        /* Now follows a string containing the
-                         * X-coordinate of the fit point coordinate
-                         * (multiple entries). */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_spline->x1[i_x1]);
-                        i_x1++;
+                        /* Now follow the fit point coordinates, usually
+                         * an uninterrupted run of 11/21/31 groups: read
+                         * them in one tight batch loop. */
+                        for (;;)
+                        {
+                                if (dxf_spline_grow_point_arrays (&dxf_spline->x1,
+                                        &dxf_spline->y1, &dxf_spline->z1,
+                                        &dxf_spline->fit_points_size,
+                                        i_x1 + 1) != EXIT_SUCCESS)
+                                {
+                                        return (NULL);
+                                }
+                                (fp->line_number)++;
+                                fscanf (fp->fp, "%lf\n", &dxf_spline->x1[i_x1]);
+                                i_x1++;
+                                if (dxf_read_line (temp_string, fp) != 1)
+                                {
+                                        strcpy (temp_string, "0");
+                                        break;
+                                }
+                                if (strcmp (temp_string, "21") == 0)
+                                {
+                                        (fp->line_number)++;
+                                        fscanf (fp->fp, "%lf\n", &dxf_spline->y1[i_y1]);
+                                        i_y1++;
+                                        if (dxf_read_line (temp_string, fp) != 1)
+                                        {
+                                                strcpy (temp_string, "0");
+                                                break;
+                                        }
+                                }
+                                if (strcmp (temp_string, "31") == 0)
+                                {
+                                        (fp->line_number)++;
+                                        fscanf (fp->fp, "%lf\n", &dxf_spline->z1[i_z1]);
+                                        i_z1++;
+                                        if (dxf_read_line (temp_string, fp) != 1)
+                                        {
+                                                strcpy (temp_string, "0");
+                                                break;
+                                        }
+                                }
+                                if (strcmp (temp_string, "11") != 0)
+                                {
+                                        break;
+                                }
+                        }
+                        /* the tag following the batch is already in
+                         * temp_string. */
+                        continue;
                 }
                 else if (strcmp (temp_string, "21") == 0)
                 {
                         /* Now follows a string containing the
                          * Y-coordinate of the fit point coordinate
                          * (multiple entries). */
+                        if (dxf_spline_grow_point_arrays (&dxf_spline->x1,
+                                &dxf_spline->y1, &dxf_spline->z1,
+                                &dxf_spline->fit_points_size,
+                                i_y1 + 1) != EXIT_SUCCESS)
+                        {
+                                return (NULL);
+                        }
                         (fp->line_number)++;
                         fscanf (fp->fp, "%lf\n", &dxf_spline->y1[i_y1]);
                         i_y1++;
@@ -514,6 +820,13 @@ dxf_spline_read
                         /* Now follows a string containing the
                          * Z-coordinate of the fit point coordinate
                          * (multiple entries). */
+                        if (dxf_spline_grow_point_arrays (&dxf_spline->x1,
+                                &dxf_spline->y1, &dxf_spline->z1,
+                                &dxf_spline->fit_points_size,
+                                i_z1 + 1) != EXIT_SUCCESS)
+                        {
+                                return (NULL);
+                        }
                         (fp->line_number)++;
                         fscanf (fp->fp, "%lf\n", &dxf_spline->z1[i_z1]);
                         i_z1++;
@@ -580,21 +893,66 @@ dxf_spline_read
                         /* Now follows a thickness value. */
                         (fp->line_number)++;
                         fscanf (fp->fp, "%lf\n", &dxf_spline->thickness);
-                        i_knot_value++;
                 }
                 else if (strcmp (temp_string, "40") == 0)
                 {
-                        /* Now follows a knot value (one entry per knot, multiple entries). */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_spline->knot_value[i_knot_value]);
-                        i_knot_value++;
+                        /* Now follow the knot values (one entry per
+                         * knot), an uninterrupted run of 40 groups:
+                         * read them in one tight batch loop. */
+                        for (;;)
+                        {
+                                if (dxf_spline_grow_array (&dxf_spline->knot_value,
+                                        &dxf_spline->knots_size,
+                                        i_knot_value + 1) != EXIT_SUCCESS)
+                                {
+                                        return (NULL);
+                                }
+                                (fp->line_number)++;
+                                fscanf (fp->fp, "%lf\n", &dxf_spline->knot_value[i_knot_value]);
+                                i_knot_value++;
+                                if (dxf_read_line (temp_string, fp) != 1)
+                                {
+                                        strcpy (temp_string, "0");
+                                        break;
+                                }
+                                if (strcmp (temp_string, "40") != 0)
+                                {
+                                        break;
+                                }
+                        }
+                        /* the tag following the batch is already in
+                         * temp_string. */
+                        continue;
                 }
                 else if (strcmp (temp_string, "41") == 0)
                 {
-                        /* Now follows a weight value (one entry per knot, multiple entries). */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_spline->weight_value[i_weight_value]);
-                        i_weight_value++;
+                        /* Now follow the weight values (one entry per
+                         * control point), an uninterrupted run of 41
+                         * groups: read them in one tight batch loop. */
+                        for (;;)
+                        {
+                                if (dxf_spline_grow_array (&dxf_spline->weight_value,
+                                        &dxf_spline->weights_size,
+                                        i_weight_value + 1) != EXIT_SUCCESS)
+                                {
+                                        return (NULL);
+                                }
+                                (fp->line_number)++;
+                                fscanf (fp->fp, "%lf\n", &dxf_spline->weight_value[i_weight_value]);
+                                i_weight_value++;
+                                if (dxf_read_line (temp_string, fp) != 1)
+                                {
+                                        strcpy (temp_string, "0");
+                                        break;
+                                }
+                                if (strcmp (temp_string, "41") != 0)
+                                {
+                                        break;
+                                }
+                        }
+                        /* the tag following the batch is already in
+                         * temp_string. */
+                        continue;
                 }
                 else if (strcmp (temp_string, "42") == 0)
                 {
@@ -619,7 +977,6 @@ dxf_spline_read
                         /* Now follows a linetype scale value. */
                         (fp->line_number)++;
                         fscanf (fp->fp, "%lf\n", &dxf_spline->linetype_scale);
-                        i_knot_value++;
                 }
                 else if (strcmp (temp_string, "60") == 0)
                 {
@@ -656,21 +1013,45 @@ dxf_spline_read
                 }
                 else if (strcmp (temp_string, "72") == 0)
                 {
-                        /* Now follows a number of knots value. */
+                        /* Now follows a number of knots value.\n
+                         * The counts of group codes 72, 73 and 74 are
+                         * declared before the values follow: size the
+                         * arrays exactly, up front. */
                         (fp->line_number)++;
                         fscanf (fp->fp, "%d\n", &dxf_spline->number_of_knots);
+                        if (dxf_spline_reserve (dxf_spline,
+                                dxf_spline->number_of_knots,
+                                dxf_spline->number_of_control_points,
+                                dxf_spline->number_of_fit_points) != EXIT_SUCCESS)
+                        {
+                                return (NULL);
+                        }
                 }
                 else if (strcmp (temp_string, "73") == 0)
                 {
                         /* Now follows a number of control points value. */
                         (fp->line_number)++;
                         fscanf (fp->fp, "%d\n", &dxf_spline->number_of_control_points);
+                        if (dxf_spline_reserve (dxf_spline,
+                                dxf_spline->number_of_knots,
+                                dxf_spline->number_of_control_points,
+                                dxf_spline->number_of_fit_points) != EXIT_SUCCESS)
+                        {
+                                return (NULL);
+                        }
                 }
                 else if (strcmp (temp_string, "74") == 0)
                 {
                         /* Now follows a number of fit points value. */
                         (fp->line_number)++;
                         fscanf (fp->fp, "%d\n", &dxf_spline->number_of_fit_points);
+                        if (dxf_spline_reserve (dxf_spline,
+                                dxf_spline->number_of_knots,
+                                dxf_spline->number_of_control_points,
+                                dxf_spline->number_of_fit_points) != EXIT_SUCCESS)
+                        {
+                                return (NULL);
+                        }
                 }
                 else if (strcmp (temp_string, "92") == 0)
                 {
@@ -691,7 +1072,9 @@ dxf_spline_read
                         /* Now follows a string containing binary
                          * graphics data. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_spline->binary_graphics_data[i_graphics_data_size]);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_spline->binary_graphics_data[i_graphics_data_size]);
+                        dxf_spline->binary_graphics_data[i_graphics_data_size] = strdup (temp_string);
                         i_graphics_data_size++;
                 }
                 else if (strcmp (temp_string, "330") == 0)
@@ -699,21 +1082,27 @@ dxf_spline_read
                         /* Now follows a string containing a
                          * soft-pointer ID/handle to owner dictionary. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_spline->dictionary_owner_soft);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_spline->dictionary_owner_soft);
+                        dxf_spline->dictionary_owner_soft = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "347") == 0)
                 {
                         /* Now follows a string containing a
                          * hard-pointer ID/handle to material object. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_spline->material);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_spline->material);
+                        dxf_spline->material = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "360") == 0)
                 {
                         /* Now follows a string containing a
                          * hard-pointer ID/handle to owner dictionary. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_spline->dictionary_owner_hard);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_spline->dictionary_owner_hard);
+                        dxf_spline->dictionary_owner_hard = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "370") == 0)
                 {
@@ -727,7 +1116,9 @@ dxf_spline_read
                         /* Now follows a string containing a plot style
                          * name value. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_spline->plot_style_name);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_spline->plot_style_name);
+                        dxf_spline->plot_style_name = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "420") == 0)
                 {
@@ -740,7 +1131,9 @@ dxf_spline_read
                         /* Now follows a string containing a color
                          * name value. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_spline->color_name);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_spline->color_name);
+                        dxf_spline->color_name = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "440") == 0)
                 {
@@ -758,10 +1151,14 @@ dxf_spline_read
                 }
                 else
                 {
-                        fprintf (stderr,
-                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %d.\n")),
+                        dxf_diag_report (fp, DXF_DIAG_WARNING,
+                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                 }
+                if (dxf_read_line (temp_string, fp) != 1)
+                {
+                        break;
+                }
         }
         /* Handle omitted members and/or illegal values. */
         if (strcmp (dxf_spline->linetype, "") == 0)
@@ -979,6 +1376,382 @@ dxf_spline_write
 }
 
 
+/*!
+ * \brief Find the knot span holding the parameter value \c t.
+ *
+ * \return the index \c k with
+ * <tt>knot_value[k] <= t < knot_value[k + 1]</tt>, clamped to the
+ * valid parameter range of the spline.
+ */
+static int
+dxf_spline_find_span
+(
+        DxfSpline *dxf_spline,
+                /*!< DXF spline entity. */
+        double t
+                /*!< the parameter value. */
+)
+{
+        int low;
+        int high;
+        int mid;
+
+        low = dxf_spline->degree;
+        high = dxf_spline->number_of_knots - dxf_spline->degree - 2;
+        if (t >= dxf_spline->knot_value[high + 1])
+        {
+                return (high);
+        }
+        if (t <= dxf_spline->knot_value[low])
+        {
+                return (low);
+        }
+        while (low < high)
+        {
+                mid = (low + high + 1) / 2;
+                if (dxf_spline->knot_value[mid] <= t)
+                {
+                        low = mid;
+                }
+                else
+                {
+                        high = mid - 1;
+                }
+        }
+        return (low);
+}
+
+
+/*!
+ * \brief Evaluate a batch of parameter values lying in one knot span.
+ *
+ * The Cox-de Boor basis functions of the span are computed level by
+ * level with the samples in the innermost loops, so one basis
+ * computation is amortized over the whole batch and the compiler can
+ * vectorize the sweeps over the packed sample arrays (see \c soa.c for
+ * the same approach on entity coordinates).
+ */
+static void
+dxf_spline_evaluate_batch
+(
+        DxfSpline *dxf_spline,
+                /*!< DXF spline entity. */
+        int span,
+                /*!< the knot span holding all parameter values of the
+                 * batch. */
+        const double *t,
+                /*!< the parameter values, all within the span. */
+        int length,
+                /*!< number of parameter values, at most
+                 * \c DXF_SPLINE_BATCH. */
+        double *x,
+                /*!< returns the X-values of the curve points. */
+        double *y,
+                /*!< returns the Y-values of the curve points. */
+        double *z
+                /*!< returns the Z-values of the curve points. */
+)
+{
+        double basis[(DXF_SPLINE_MAX_DEGREE + 1) * DXF_SPLINE_BATCH];
+        double left[(DXF_SPLINE_MAX_DEGREE + 1) * DXF_SPLINE_BATCH];
+        double right[(DXF_SPLINE_MAX_DEGREE + 1) * DXF_SPLINE_BATCH];
+        double saved[DXF_SPLINE_BATCH];
+        double temp;
+        double weight;
+        double sum_x;
+        double sum_y;
+        double sum_z;
+        double sum_w;
+        int degree;
+        int rational;
+        int i;
+        int j;
+        int r;
+        int s;
+
+        degree = dxf_spline->degree;
+        rational = ((dxf_spline->flag & 4) && (dxf_spline->weight_value != NULL));
+        for (s = 0; s < length; s++)
+        {
+                basis[s] = 1.0;
+        }
+        for (j = 1; j <= degree; j++)
+        {
+                for (s = 0; s < length; s++)
+                {
+                        left[j * DXF_SPLINE_BATCH + s] = t[s]
+                                - dxf_spline->knot_value[span + 1 - j];
+                        right[j * DXF_SPLINE_BATCH + s] =
+                                dxf_spline->knot_value[span + j] - t[s];
+                }
+                for (s = 0; s < length; s++)
+                {
+                        saved[s] = 0.0;
+                }
+                for (r = 0; r < j; r++)
+                {
+                        for (s = 0; s < length; s++)
+                        {
+                                temp = basis[r * DXF_SPLINE_BATCH + s]
+                                        / (right[(r + 1) * DXF_SPLINE_BATCH + s]
+                                        + left[(j - r) * DXF_SPLINE_BATCH + s]);
+                                basis[r * DXF_SPLINE_BATCH + s] = saved[s]
+                                        + right[(r + 1) * DXF_SPLINE_BATCH + s] * temp;
+                                saved[s] = left[(j - r) * DXF_SPLINE_BATCH + s] * temp;
+                        }
+                }
+                for (s = 0; s < length; s++)
+                {
+                        basis[j * DXF_SPLINE_BATCH + s] = saved[s];
+                }
+        }
+        for (s = 0; s < length; s++)
+        {
+                sum_x = 0.0;
+                sum_y = 0.0;
+                sum_z = 0.0;
+                sum_w = 0.0;
+                for (r = 0; r <= degree; r++)
+                {
+                        i = span - degree + r;
+                        weight = (rational) ? dxf_spline->weight_value[i] : 1.0;
+                        temp = basis[r * DXF_SPLINE_BATCH + s] * weight;
+                        sum_x += temp * dxf_spline->x0[i];
+                        sum_y += temp * dxf_spline->y0[i];
+                        sum_z += temp * dxf_spline->z0[i];
+                        sum_w += temp;
+                }
+                x[s] = sum_x / sum_w;
+                y[s] = sum_y / sum_w;
+                z[s] = sum_z / sum_w;
+        }
+}
+
+
+/*!
+ * \brief Check that a DXF \c SPLINE entity holds an evaluatable curve.
+ *
+ * \return \c EXIT_SUCCESS when the spline can be evaluated, or
+ * \c EXIT_FAILURE when errors occurred.
+ */
+static int
+dxf_spline_check_evaluatable
+(
+        DxfSpline *dxf_spline
+                /*!< DXF spline entity. */
+)
+{
+        if (dxf_spline == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if ((dxf_spline->degree < 1)
+          || (dxf_spline->degree > DXF_SPLINE_MAX_DEGREE))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () invalid spline degree: %d.\n")),
+                  __FUNCTION__, dxf_spline->degree);
+                return (EXIT_FAILURE);
+        }
+        if ((dxf_spline->knot_value == NULL)
+          || (dxf_spline->x0 == NULL)
+          || (dxf_spline->y0 == NULL)
+          || (dxf_spline->z0 == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () the spline holds no curve data.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (dxf_spline->number_of_knots
+          != dxf_spline->number_of_control_points + dxf_spline->degree + 1)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () inconsistent number of knots: %d for %d control points of degree %d.\n")),
+                  __FUNCTION__, dxf_spline->number_of_knots,
+                  dxf_spline->number_of_control_points, dxf_spline->degree);
+                return (EXIT_FAILURE);
+        }
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Evaluate a point on a DXF \c SPLINE entity with de Boor's
+ * algorithm.
+ *
+ * The evaluation works directly on the array backed knot, weight and
+ * control point storage of the spline; rational splines (bit 4 of
+ * \c flag) are evaluated in homogeneous coordinates.\n
+ * The parameter value is clamped to the valid knot range.\n
+ * For sampling many parameter values use \c dxf_spline_tessellate,
+ * which amortizes the basis computations over batches.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when an error
+ * occurred.
+ */
+int
+dxf_spline_evaluate
+(
+        DxfSpline *dxf_spline,
+                /*!< DXF spline entity. */
+        double t,
+                /*!< the parameter value to evaluate at. */
+        double *x,
+                /*!< returns the X-value of the curve point. */
+        double *y,
+                /*!< returns the Y-value of the curve point. */
+        double *z
+                /*!< returns the Z-value of the curve point. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        double t_min;
+        double t_max;
+
+        if (dxf_spline_check_evaluatable (dxf_spline) != EXIT_SUCCESS)
+        {
+                return (EXIT_FAILURE);
+        }
+        if ((x == NULL) || (y == NULL) || (z == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        t_min = dxf_spline->knot_value[dxf_spline->degree];
+        t_max = dxf_spline->knot_value[dxf_spline->number_of_knots
+                - dxf_spline->degree - 1];
+        if (t < t_min)
+        {
+                t = t_min;
+        }
+        if (t > t_max)
+        {
+                t = t_max;
+        }
+        dxf_spline_evaluate_batch (dxf_spline,
+                dxf_spline_find_span (dxf_spline, t), &t, 1, x, y, z);
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Tessellate a DXF \c SPLINE entity into uniformly spaced
+ * sample points.
+ *
+ * The samples are spaced uniformly in parameter space over the valid
+ * knot range and evaluated span by span: all samples falling in one
+ * knot span share one Cox-de Boor basis computation and are swept in
+ * vectorizable batches (see \c dxf_spline_evaluate_batch).\n
+ * The caller provides the output arrays, each with room for
+ * \c number_of_samples values.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when an error
+ * occurred.
+ */
+int
+dxf_spline_tessellate
+(
+        DxfSpline *dxf_spline,
+                /*!< DXF spline entity. */
+        int number_of_samples,
+                /*!< number of sample points to generate, at least 2. */
+        double *x,
+                /*!< returns the X-values of the sample points. */
+        double *y,
+                /*!< returns the Y-values of the sample points. */
+        double *z
+                /*!< returns the Z-values of the sample points. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        double t[DXF_SPLINE_BATCH];
+        double t_min;
+        double t_max;
+        double step;
+        double value;
+        int span;
+        int sample;
+        int length;
+        int done;
+
+        if (dxf_spline_check_evaluatable (dxf_spline) != EXIT_SUCCESS)
+        {
+                return (EXIT_FAILURE);
+        }
+        if ((x == NULL) || (y == NULL) || (z == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (number_of_samples < 2)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () invalid number of samples: %d.\n")),
+                  __FUNCTION__, number_of_samples);
+                return (EXIT_FAILURE);
+        }
+        t_min = dxf_spline->knot_value[dxf_spline->degree];
+        t_max = dxf_spline->knot_value[dxf_spline->number_of_knots
+                - dxf_spline->degree - 1];
+        step = (t_max - t_min) / (number_of_samples - 1);
+        sample = 0;
+        while (sample < number_of_samples)
+        {
+                /* batch all consecutive samples sharing the knot span
+                 * of the first pending sample. */
+                value = t_min + step * sample;
+                if (value > t_max)
+                {
+                        value = t_max;
+                }
+                span = dxf_spline_find_span (dxf_spline, value);
+                length = 0;
+                done = 0;
+                while ((sample + length < number_of_samples)
+                  && (length < DXF_SPLINE_BATCH)
+                  && (!done))
+                {
+                        value = t_min + step * (sample + length);
+                        if (value > t_max)
+                        {
+                                value = t_max;
+                        }
+                        if (dxf_spline_find_span (dxf_spline, value) != span)
+                        {
+                                done = 1;
+                        }
+                        else
+                        {
+                                t[length] = value;
+                                length++;
+                        }
+                }
+                dxf_spline_evaluate_batch (dxf_spline, span, t, length,
+                        &x[sample], &y[sample], &z[sample]);
+                sample += length;
+        }
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (EXIT_SUCCESS);
+}
+
+
 /*!
  * \brief Free the allocated memory for a DXF \c SPLINE and all it's
  * data fields.
@@ -1023,7 +1796,15 @@ dxf_spline_free
         {
                 free (dxf_spline->binary_graphics_data[i]);
         }
-        free (dxf_spline);
+        free (dxf_spline->x0);
+        free (dxf_spline->y0);
+        free (dxf_spline->z0);
+        free (dxf_spline->x1);
+        free (dxf_spline->y1);
+        free (dxf_spline->z1);
+        free (dxf_spline->knot_value);
+        free (dxf_spline->weight_value);
+        dxf_entity_dealloc (dxf_spline, sizeof (*dxf_spline));
         dxf_spline = NULL;
 #if DEBUG
         DXF_DEBUG_END
@@ -158,29 +158,35 @@ dxf_spline
                  * class-level transparency data.\n
                  * Group code = 440. */
         /* Specific members for a DXF spline. */
-        double x0[DXF_MAX_PARAM];
-                /*!< X-value of the control point coordinate
-                 * (multiple entries).\n
+        double *x0;
+                /*!< array of X-values of the control point coordinates
+                 * (one entry per control point), sized to
+                 * \c control_points_size.\n
                  * Group code = 10. */
-        double y0[DXF_MAX_PARAM];
-                /*!< Y-value of the control point coordinate
-                 * (multiple entries).\n
+        double *y0;
+                /*!< array of Y-values of the control point coordinates
+                 * (one entry per control point), sized to
+                 * \c control_points_size.\n
                  * Group code = 20. */
-        double z0[DXF_MAX_PARAM];
-                /*!< Z-value of the control point coordinate
-                 * (multiple entries).\n
+        double *z0;
+                /*!< array of Z-values of the control point coordinates
+                 * (one entry per control point), sized to
+                 * \c control_points_size.\n
                  * Group code = 30. */
-        double x1[DXF_MAX_PARAM];
-                /*!< X-value of the fit point coordinate
-                 * (multiple entries).\n
+        double *x1;
+                /*!< array of X-values of the fit point coordinates
+                 * (one entry per fit point), sized to
+                 * \c fit_points_size.\n
                  * Group code = 11. */
-        double y1[DXF_MAX_PARAM];
-                /*!< Y-value of the fit point coordinate
-                 * (multiple entries).\n
+        double *y1;
+                /*!< array of Y-values of the fit point coordinates
+                 * (one entry per fit point), sized to
+                 * \c fit_points_size.\n
                  * Group code = 21. */
-        double z1[DXF_MAX_PARAM];
-                /*!< Z-value of the fit point coordinate
-                 * (multiple entries).\n
+        double *z1;
+                /*!< array of Z-values of the fit point coordinates
+                 * (one entry per fit point), sized to
+                 * \c fit_points_size.\n
                  * Group code = 31. */
         double x2;
                 /*!< X-value of the start tangent,
@@ -206,11 +212,13 @@ dxf_spline
                 /*!< Z-value of the end tangent,
                  * may be omitted (in WCS).\n
                  * Group code = 33. */
-        double knot_value[DXF_MAX_PARAM];
-                /*!< Knot value (one entry per knot, multiple entries).\n
+        double *knot_value;
+                /*!< array of knot values (one entry per knot), sized
+                 * to \c knots_size.\n
                  * Group code = 40. */
-        double weight_value[DXF_MAX_PARAM];
-                /*!< Weight (if not 1); with multiple group pairs, they
+        double *weight_value;
+                /*!< array of weights (if not 1), sized to
+                 * \c weights_size; with multiple group pairs, they
                  * are present if all are not 1.\n
                  * Group code = 41. */
         double knot_tolerance;
@@ -244,6 +252,16 @@ dxf_spline
         int number_of_fit_points;
                 /*!< group code = 74\n
                  * Number of fit points (if any).*/
+        int knots_size;
+                /*!< number of allocated entries in \c knot_value. */
+        int weights_size;
+                /*!< number of allocated entries in \c weight_value. */
+        int control_points_size;
+                /*!< number of allocated entries in each of \c x0,
+                 * \c y0 and \c z0. */
+        int fit_points_size;
+                /*!< number of allocated entries in each of \c x1,
+                 * \c y1 and \c z1. */
         double extr_x0;
                 /*!< X-value of the extrusion vector.\n
                  * Defaults to 0.0 if omitted in the DXF file.\n
@@ -269,6 +287,14 @@ dxf_spline_init
 (
         DxfSpline *dxf_spline
 );
+int
+dxf_spline_reserve
+(
+        DxfSpline *dxf_spline,
+        int number_of_knots,
+        int number_of_control_points,
+        int number_of_fit_points
+);
 DxfSpline *
 dxf_spline_read
 (
@@ -276,6 +302,24 @@ dxf_spline_read
         DxfSpline *dxf_spline
 );
 int
+dxf_spline_evaluate
+(
+        DxfSpline *dxf_spline,
+        double t,
+        double *x,
+        double *y,
+        double *z
+);
+int
+dxf_spline_tessellate
+(
+        DxfSpline *dxf_spline,
+        int number_of_samples,
+        double *x,
+        double *y,
+        double *z
+);
+int
 dxf_spline_write
 (
         DxfFile *fp,
@@ -32,7 +32,10 @@
  */
 
 
+#include <pthread.h>
 #include "style.h"
+#include "diag.h"
+#include "allocator.h"
 
 
 /*!
@@ -61,7 +64,7 @@ dxf_style_new ()
         size = sizeof (DxfStyle);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_style = malloc (size)) == NULL)
+        if ((dxf_style = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfStyle struct.\n")),
@@ -102,6 +105,11 @@ dxf_style_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfStyle template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         /* Do some basic checks. */
         if (dxf_style == NULL)
         {
@@ -117,17 +125,27 @@ dxf_style_init
                 __FUNCTION__);
               return (NULL);
         }
-        dxf_style->id_code = 0;
-        dxf_style->style_name = strdup ("");
-        dxf_style->primary_font_filename = strdup ("");
-        dxf_style->big_font_filename = strdup ("");
-        dxf_style->height = 0.0;
-        dxf_style->width = 0.0;
-        dxf_style->last_height = 0.0;
-        dxf_style->oblique_angle = 0.0;
-        dxf_style->flag = 0;
-        dxf_style->text_generation_flag = 0;
-        dxf_style->next = NULL;
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.id_code = 0;
+                template.style_name = strdup ("");
+                template.primary_font_filename = strdup ("");
+                template.big_font_filename = strdup ("");
+                template.height = 0.0;
+                template.width = 0.0;
+                template.last_height = 0.0;
+                template.oblique_angle = 0.0;
+                template.flag = 0;
+                template.text_generation_flag = 0;
+                template.next = NULL;
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (dxf_style, &template, sizeof (DxfStyle));
+        dxf_style->style_name = strdup (template.style_name);
+        dxf_style->primary_font_filename = strdup (template.primary_font_filename);
+        dxf_style->big_font_filename = strdup (template.big_font_filename);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -164,7 +182,7 @@ dxf_style_read
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        char *temp_string = NULL;
+        char temp_string[DXF_MAX_STRING_LENGTH];
 
         /* Do some basic checks. */
         if (fp == NULL)
@@ -189,7 +207,7 @@ dxf_style_read
                 if (ferror (fp->fp))
                 {
                         fprintf (stderr,
-                          (_("Error in %s () while reading from: %s in line: %d.\n")),
+                          (_("Error in %s () while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                         fclose (fp->fp);
                         return (NULL);
@@ -205,21 +223,27 @@ dxf_style_read
                 {
                         /* Now follows a string containing a style name. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_style->style_name);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_style->style_name);
+                        dxf_style->style_name = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "3") == 0)
                 {
                         /* Now follows a string containing a primary
                          * font filename. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_style->primary_font_filename);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_style->primary_font_filename);
+                        dxf_style->primary_font_filename = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "4") == 0)
                 {
                         /* Now follows a string containing a big font
                          * filename. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_style->big_font_filename);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_style->big_font_filename);
+                        dxf_style->big_font_filename = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "40") == 0)
                 {
@@ -273,8 +297,8 @@ dxf_style_read
                         if ((strcmp (temp_string, "AcDbSymbolTableRecord") != 0)
                         && ((strcmp (temp_string, "AcDbTextStyleTableRecord") != 0)))
                         {
-                                fprintf (stderr,
-                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %d.\n")),
+                                dxf_diag_report (fp, DXF_DIAG_WARNING,
+                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                         }
                 }
@@ -283,14 +307,18 @@ dxf_style_read
                         /* Now follows a string containing Soft-pointer
                          * ID/handle to owner dictionary. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_style->dictionary_owner_soft);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_style->dictionary_owner_soft);
+                        dxf_style->dictionary_owner_soft = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "360") == 0)
                 {
                         /* Now follows a string containing Hard owner
                          * ID/handle to owner dictionary. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_style->dictionary_owner_hard);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_style->dictionary_owner_hard);
+                        dxf_style->dictionary_owner_hard = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "999") == 0)
                 {
@@ -301,8 +329,8 @@ dxf_style_read
                 }
                 else
                 {
-                        fprintf (stderr,
-                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %d.\n")),
+                        dxf_diag_report (fp, DXF_DIAG_WARNING,
+                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                 }
         }
@@ -311,7 +339,7 @@ dxf_style_read
         {
                 sprintf (dxf_style->style_name, "%i", dxf_style->id_code);
                 fprintf (stderr,
-                  (_("Warning in %s () illegal style name value found while reading from: %s in line: %d.\n")),
+                  (_("Warning in %s () illegal style name value found while reading from: %s in line: %ld.\n")),
                   __FUNCTION__, fp->filename, fp->line_number);
         }
         if ((strcmp (dxf_style->primary_font_filename, "") == 0)
@@ -319,7 +347,7 @@ dxf_style_read
         {
                 sprintf (dxf_style->primary_font_filename, "%i", dxf_style->id_code);
                 fprintf (stderr,
-                  (_("Warning in %s () illegal primary font filename value found while reading from: %s in line: %d.\n")),
+                  (_("Warning in %s () illegal primary font filename value found while reading from: %s in line: %ld.\n")),
                   __FUNCTION__, fp->filename, fp->line_number);
         }
 #if DEBUG
@@ -455,7 +483,7 @@ dxf_style_free
         free (dxf_style->style_name);
         free (dxf_style->primary_font_filename);
         free (dxf_style->big_font_filename);
-        free (dxf_style);
+        dxf_entity_dealloc (dxf_style, sizeof (*dxf_style));
         dxf_style = NULL;
 #if DEBUG
         DXF_DEBUG_END
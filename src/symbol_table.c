@@ -0,0 +1,279 @@
+/*!
+ * \file symbol_table.c
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Functions for a name-keyed hash map over symbol table
+ * records.
+ *
+ * The per-table modules (appid.c, layer.c, ltype.c, style.c, ...)
+ * chain their records in linked lists, so resolving an entity's layer
+ * or linetype record costs a linear scan of the list for every
+ * lookup.\n
+ * A \c DxfSymbolTable buckets the records of one table by name, so a
+ * resolution costs one hash plus a short chain walk regardless of the
+ * table size.\n
+ * The map stores records of any table type: entries keep a \c void
+ * pointer and do not own the record.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#include "global.h"
+#include "symbol_table.h"
+
+
+/*!
+ * \brief Hash a record name into a bucket number (FNV-1a).
+ */
+static size_t
+dxf_symbol_table_hash
+(
+        const char *name
+                /*!< the record name. */
+)
+{
+        unsigned int hash;
+        const unsigned char *c;
+
+        hash = 2166136261u;
+        for (c = (const unsigned char *) name; *c != '\0'; c++)
+        {
+                hash = (hash ^ *c) * 16777619u;
+        }
+        return (hash & (DXF_SYMBOL_TABLE_BUCKETS - 1));
+}
+
+
+/*!
+ * \brief Allocate an empty \c DxfSymbolTable.
+ *
+ * \return a pointer to the map, or \c NULL when no memory was
+ * allocated.
+ */
+DxfSymbolTable *
+dxf_symbol_table_new ()
+{
+        DxfSymbolTable *table;
+
+        table = calloc (1, sizeof (DxfSymbolTable));
+        if (table == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+        }
+        return (table);
+}
+
+
+/*!
+ * \brief Insert a table record under its name into a
+ * \c DxfSymbolTable.
+ *
+ * A record inserted under an already present name replaces the stored
+ * record, matching the "last definition wins" behaviour of repeated
+ * table entries in a DXF file.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_symbol_table_insert
+(
+        DxfSymbolTable *table,
+                /*!< the map to insert into. */
+        const char *name,
+                /*!< the record name. */
+        void *record
+                /*!< the table record to store. */
+)
+{
+        DxfSymbolEntry *entry;
+        size_t bucket;
+
+        if ((table == NULL) || (name == NULL) || (record == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        bucket = dxf_symbol_table_hash (name);
+        for (entry = table->buckets[bucket]; entry != NULL; entry = entry->next)
+        {
+                if (strcmp (entry->name, name) == 0)
+                {
+                        entry->record = record;
+                        return (EXIT_SUCCESS);
+                }
+        }
+        entry = malloc (sizeof (DxfSymbolEntry));
+        if (entry == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        entry->name = strdup (name);
+        entry->record = record;
+        entry->next = table->buckets[bucket];
+        table->buckets[bucket] = entry;
+        table->length++;
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Look up a table record by name in a \c DxfSymbolTable.
+ *
+ * \return a pointer to the stored record, or \c NULL when no record
+ * was inserted under that name.
+ */
+void *
+dxf_symbol_table_find
+(
+        DxfSymbolTable *table,
+                /*!< the map to search. */
+        const char *name
+                /*!< the record name to look up. */
+)
+{
+        DxfSymbolEntry *entry;
+
+        if ((table == NULL) || (name == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        for (entry = table->buckets[dxf_symbol_table_hash (name)];
+                entry != NULL;
+                entry = entry->next)
+        {
+                if (strcmp (entry->name, name) == 0)
+                {
+                        return (entry->record);
+                }
+        }
+        return (NULL);
+}
+
+
+/*!
+ * \brief Populate a \c DxfSymbolTable from a chain of table records.
+ *
+ * Walks the linked list starting at \c head and inserts every record
+ * under its name, where \c name_offset and \c next_offset locate the
+ * name member and the \c next pointer within the record struct (see
+ * the \c DXF_SYMBOL_TABLE_BUILD convenience macro in
+ * symbol_table.h).\n
+ * Records whose name member is \c NULL are skipped.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_symbol_table_build
+(
+        DxfSymbolTable *table,
+                /*!< the map to populate. */
+        void *head,
+                /*!< the first record of the chain, or \c NULL for an
+                 * empty chain. */
+        size_t name_offset,
+                /*!< offset of the name member within the record. */
+        size_t next_offset
+                /*!< offset of the \c next pointer within the record. */
+)
+{
+        char *name;
+        void *record;
+
+        if (table == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        for (record = head;
+                record != NULL;
+                record = *((void **) (((char *) record) + next_offset)))
+        {
+                name = *((char **) (((char *) record) + name_offset));
+                if (name == NULL)
+                {
+                        continue;
+                }
+                if (dxf_symbol_table_insert (table, name, record) != EXIT_SUCCESS)
+                {
+                        return (EXIT_FAILURE);
+                }
+        }
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Free a \c DxfSymbolTable and all its entries.
+ *
+ * The stored records themselves are not touched.
+ */
+void
+dxf_symbol_table_free
+(
+        DxfSymbolTable *table
+                /*!< the map to free. */
+)
+{
+        DxfSymbolEntry *entry;
+        DxfSymbolEntry *next;
+        size_t i;
+
+        if (table == NULL)
+        {
+                return;
+        }
+        for (i = 0; i < DXF_SYMBOL_TABLE_BUCKETS; i++)
+        {
+                entry = table->buckets[i];
+                while (entry != NULL)
+                {
+                        next = entry->next;
+                        free (entry->name);
+                        free (entry);
+                        entry = next;
+                }
+        }
+        free (table);
+}
+
+
+/* EOF */
@@ -0,0 +1,109 @@
+/*!
+ * \file symbol_table.h
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Header for a name-keyed hash map over symbol table records.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#ifndef LIBDXF_SRC_SYMBOL_TABLE_H
+#define LIBDXF_SRC_SYMBOL_TABLE_H
+
+
+#include <stddef.h>
+
+
+/*!
+ * The number of buckets of a \c DxfSymbolTable; drawings rarely have
+ * more than a few hundred records per table.
+ */
+#define DXF_SYMBOL_TABLE_BUCKETS 256
+
+
+/*!
+ * \brief One record of a \c DxfSymbolTable.
+ */
+typedef struct
+dxf_symbol_entry
+{
+        char *name;
+                /*!< the record name; owned by the entry. */
+        void *record;
+                /*!< the table record stored under the name; not owned
+                 * by the entry. */
+        struct dxf_symbol_entry *next;
+                /*!< the next entry in the same hash bucket. */
+} DxfSymbolEntry;
+
+
+/*!
+ * \brief A name-keyed hash map over the records of one \c TABLES
+ * section table (\c LAYER, \c LTYPE, \c STYLE, \c APPID, ...).
+ */
+typedef struct
+dxf_symbol_table
+{
+        DxfSymbolEntry *buckets[DXF_SYMBOL_TABLE_BUCKETS];
+                /*!< the hash buckets. */
+        size_t length;
+                /*!< number of records in the map. */
+} DxfSymbolTable;
+
+
+/*!
+ * \brief Populate a \c DxfSymbolTable from a chain of table records.
+ *
+ * Convenience wrapper around \c dxf_symbol_table_build deriving the
+ * member offsets from the record \c type and the name of its name
+ * member, for example:
+ * \code
+ *   DXF_SYMBOL_TABLE_BUILD (table, layers, DxfLayer, layer_name);
+ * \endcode
+ */
+#define DXF_SYMBOL_TABLE_BUILD(table, head, type, name_member) \
+        dxf_symbol_table_build ((table), (head), \
+                offsetof (type, name_member), offsetof (type, next))
+
+
+DxfSymbolTable *
+dxf_symbol_table_new ();
+int
+dxf_symbol_table_insert (DxfSymbolTable *table, const char *name, void *record);
+void *
+dxf_symbol_table_find (DxfSymbolTable *table, const char *name);
+int
+dxf_symbol_table_build (DxfSymbolTable *table, void *head, size_t name_offset, size_t next_offset);
+void
+dxf_symbol_table_free (DxfSymbolTable *table);
+
+
+#endif /* LIBDXF_SRC_SYMBOL_TABLE_H */
+
+
+/* EOF */
@@ -30,7 +30,10 @@
  */
 
 
+#include <pthread.h>
 #include "table.h"
+#include "diag.h"
+#include "allocator.h"
 
 
 /*!
@@ -59,7 +62,7 @@ dxf_table_new ()
         size = sizeof (DxfTable);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_table = malloc (size)) == NULL)
+        if ((dxf_table = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfTable struct.\n")),
@@ -100,6 +103,11 @@ dxf_table_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfTable template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         /* Do some basic checks. */
         if (dxf_table == NULL)
         {
@@ -115,9 +123,17 @@ dxf_table_init
                   __FUNCTION__);
                 return (NULL);
         }
-        dxf_table->table_name = strdup ("");
-        dxf_table->max_table_entries = 0;
-        dxf_table->next = NULL;
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.table_name = strdup ("");
+                template.max_table_entries = 0;
+                template.next = NULL;
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (dxf_table, &template, sizeof (DxfTable));
+        dxf_table->table_name = strdup (template.table_name);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -154,7 +170,7 @@ dxf_table_read
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        char *temp_string = NULL;
+        char temp_string[DXF_MAX_STRING_LENGTH];
 
         /* Do some basic checks. */
         if (fp == NULL)
@@ -179,7 +195,7 @@ dxf_table_read
                 if (ferror (fp->fp))
                 {
                         fprintf (stderr,
-                          (_("Error in %s () while reading from: %s in line: %d.\n")),
+                          (_("Error in %s () while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                         fclose (fp->fp);
                         return (NULL);
@@ -196,7 +212,9 @@ dxf_table_read
                         /* Now follows a string containing an application
                          * name. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_table->table_name);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_table->table_name);
+                        dxf_table->table_name = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "70") == 0)
                 {
@@ -214,8 +232,8 @@ dxf_table_read
                 }
                 else
                 {
-                        fprintf (stderr,
-                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %d.\n")),
+                        dxf_diag_report (fp, DXF_DIAG_WARNING,
+                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                 }
         }
@@ -324,7 +342,7 @@ dxf_table_free
               return (EXIT_FAILURE);
         }
         free (dxf_table->table_name);
-        free (dxf_table);
+        dxf_entity_dealloc (dxf_table, sizeof (*dxf_table));
         dxf_table = NULL;
 #if DEBUG
         DXF_DEBUG_END
@@ -32,8 +32,21 @@
  */
 
 
+#include <stddef.h>
+#include <pthread.h>
 #include "tables.h"
+#include "allocator.h"
 #include "section.h"
+#include "appid.h"
+#include "dimstyle.h"
+#include "endtab.h"
+#include "layer.h"
+#include "ltype.h"
+#include "style.h"
+#include "table.h"
+#include "ucs.h"
+#include "view.h"
+#include "vport.h"
 
 
 /*!
@@ -56,7 +69,7 @@ dxf_tables_new ()
         size = sizeof (DxfTables);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_tables = malloc (size)) == NULL)
+        if ((dxf_tables = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfTables struct.\n")),
@@ -91,6 +104,11 @@ dxf_tables_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfTables template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         /* Do some basic checks. */
         if (dxf_tables == NULL)
         {
@@ -106,15 +124,22 @@ dxf_tables_init
                   __FUNCTION__);
                 return (NULL);
         }
-        dxf_tables->appids = NULL;
-        //dxf_table->block_records = NULL;
-        dxf_tables->dimstyles = NULL;
-        dxf_tables->layers = NULL;
-        dxf_tables->ltypes = NULL;
-        dxf_tables->styles = NULL;
-        dxf_tables->ucss = NULL;
-        dxf_tables->views = NULL;
-        dxf_tables->vports = NULL;
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.appids = NULL;
+                //dxf_table->block_records = NULL;
+                template.dimstyles = NULL;
+                template.layers = NULL;
+                template.ltypes = NULL;
+                template.styles = NULL;
+                template.ucss = NULL;
+                template.views = NULL;
+                template.vports = NULL;
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (dxf_tables, &template, sizeof (DxfTables));
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -136,11 +161,112 @@ dxf_tables_write
         DxfTables *dxf_tables
                 /*!< DXF table section. */
 )
+{
+        return (dxf_tables_write_all (fp, dxf_tables));
+}
+
+
+/*!
+ * Serializer of one table record, as every table record \c *_write
+ * function.
+ */
+typedef int (*DxfTableRecordWriteFunction) (DxfFile *fp, void *record);
+
+
+/*!
+ * \brief Write one table of a \c TABLES section: the \c TABLE header,
+ * every record of the list, and the \c ENDTAB trailer.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when an error
+ * occurred.
+ */
+static int
+dxf_tables_write_table
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an output file (or device). */
+        const char *table_name,
+                /*!< the table name (group code 2), uppercase. */
+        void *records,
+                /*!< head of the record list, or \c NULL to skip the
+                 * table. */
+        size_t next_offset,
+                /*!< offset of the \c next member in one record. */
+        DxfTableRecordWriteFunction write,
+                /*!< the \c *_write function of the record type. */
+        int write_endtab
+                /*!< when \c FALSE the record writer emits \c ENDTAB
+                 * itself (the \c DIMSTYLE quirk for R13/R14). */
+)
+{
+        DxfTable table;
+        void *record;
+        int count;
+
+        if (records == NULL)
+        {
+                return (EXIT_SUCCESS);
+        }
+        count = 0;
+        for (record = records; record != NULL;
+                record = *((void **) (((char *) record) + next_offset)))
+        {
+                count++;
+        }
+        table.id_code = -1;
+        table.table_name = (char *) table_name;
+        table.max_table_entries = count;
+        table.next = NULL;
+        if (dxf_table_write (fp, &table) != EXIT_SUCCESS)
+        {
+                return (EXIT_FAILURE);
+        }
+        for (record = records; record != NULL;
+                record = *((void **) (((char *) record) + next_offset)))
+        {
+                if (write (fp, record) != EXIT_SUCCESS)
+                {
+                        return (EXIT_FAILURE);
+                }
+        }
+        if (write_endtab)
+        {
+                return (dxf_endtab_write (fp));
+        }
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Write a whole \c TABLES section in one pass.
+ *
+ * Serializes the section from the record lists of \c tables: the
+ * \c SECTION bracketing, per table the \c TABLE header with the entry
+ * count in group code 70, the records, and the \c ENDTAB trailer, then
+ * \c ENDSEC.\n
+ * The tables are written in the customary order, with \c LTYPE
+ * preceding \c LAYER as the format requires; empty lists are
+ * skipped.\n
+ * For many-small-files workloads the section is a fixed cost per
+ * file; assembling it in one call keeps that cost to the record
+ * serialization itself.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when an error
+ * occurred.
+ */
+int
+dxf_tables_write_all
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an output file (or device). */
+        DxfTables *tables
+                /*!< the record lists of the section. */
+)
 {
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        char *dxf_section_name = strdup ("TABLES");
+        int dimstyle_writes_endtab;
 
         /* Do some basic checks. */
         if (fp == NULL)
@@ -150,9 +276,81 @@ dxf_tables_write
                   __FUNCTION__);
                 return (EXIT_FAILURE);
         }
-        dxf_section_write (fp, dxf_section_name);
-        /*! \todo Add code here */
-        dxf_endsec_write (fp);
+        if (tables == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (dxf_section_write (fp, "TABLES") != EXIT_SUCCESS)
+        {
+                return (EXIT_FAILURE);
+        }
+        if (dxf_tables_write_table (fp, "VPORT", tables->vports,
+                offsetof (DxfVPort, next),
+                (DxfTableRecordWriteFunction) dxf_vport_write,
+                TRUE) != EXIT_SUCCESS)
+        {
+                return (EXIT_FAILURE);
+        }
+        if (dxf_tables_write_table (fp, "LTYPE", tables->ltypes,
+                offsetof (DxfLType, next),
+                (DxfTableRecordWriteFunction) dxf_ltype_write,
+                TRUE) != EXIT_SUCCESS)
+        {
+                return (EXIT_FAILURE);
+        }
+        if (dxf_tables_write_table (fp, "LAYER", tables->layers,
+                offsetof (DxfLayer, next),
+                (DxfTableRecordWriteFunction) dxf_layer_write,
+                TRUE) != EXIT_SUCCESS)
+        {
+                return (EXIT_FAILURE);
+        }
+        if (dxf_tables_write_table (fp, "STYLE", tables->styles,
+                offsetof (DxfStyle, next),
+                (DxfTableRecordWriteFunction) dxf_style_write,
+                TRUE) != EXIT_SUCCESS)
+        {
+                return (EXIT_FAILURE);
+        }
+        if (dxf_tables_write_table (fp, "VIEW", tables->views,
+                offsetof (DxfView, next),
+                (DxfTableRecordWriteFunction) dxf_view_write,
+                TRUE) != EXIT_SUCCESS)
+        {
+                return (EXIT_FAILURE);
+        }
+        if (dxf_tables_write_table (fp, "UCS", tables->ucss,
+                offsetof (DxfUcs, next),
+                (DxfTableRecordWriteFunction) dxf_ucs_write,
+                TRUE) != EXIT_SUCCESS)
+        {
+                return (EXIT_FAILURE);
+        }
+        if (dxf_tables_write_table (fp, "APPID", tables->appids,
+                offsetof (DxfAppid, next),
+                (DxfTableRecordWriteFunction) dxf_appid_write,
+                TRUE) != EXIT_SUCCESS)
+        {
+                return (EXIT_FAILURE);
+        }
+        /* dxf_dimstyle_write emits the ENDTAB itself for R13 and R14
+         * output. */
+        dimstyle_writes_endtab = ((fp->acad_version_number >= AutoCAD_13)
+                && (fp->acad_version_number < AutoCAD_2000));
+        if (dxf_tables_write_table (fp, "DIMSTYLE", tables->dimstyles,
+                offsetof (DxfDimStyle, next),
+                (DxfTableRecordWriteFunction) dxf_dimstyle_write,
+                !dimstyle_writes_endtab) != EXIT_SUCCESS)
+        {
+                return (EXIT_FAILURE);
+        }
+        if (dxf_endsec_write (fp) != EXIT_SUCCESS)
+        {
+                return (EXIT_FAILURE);
+        }
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -99,6 +99,12 @@ dxf_tables_write
         DxfTables *dxf_tables
 );
 int
+dxf_tables_write_all
+(
+        DxfFile *fp,
+        DxfTables *tables
+);
+int
 dxf_tables_free
 (
         DxfTables *dxf_tables
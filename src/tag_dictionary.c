@@ -0,0 +1,239 @@
+/*!
+ * \file tag_dictionary.c
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Shared attribute tag dictionary for \c ATTDEF / \c ATTRIB
+ * pairs.
+ *
+ * A title block repeats its attribute definitions identically across
+ * thousands of \c INSERT entities, and matching an \c ATTRIB to its
+ * definition by \c strcmp per attribute made extraction passes
+ * quadratic in practice.\n
+ * The dictionary interns the tag, prompt and style strings in the
+ * shared string pool (see \c dxf_string_intern) and indexes the
+ * definitions by tag in a \c DxfSymbolTable, so a lookup costs one
+ * hash probe and an \c ATTRIB can reference its defining \c ATTDEF
+ * directly (see \c dxf_tag_dictionary_resolve).
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#include "tag_dictionary.h"
+#include "util.h"
+
+
+/*!
+ * \brief Allocate an empty tag dictionary.
+ *
+ * \return a pointer to the dictionary, or \c NULL when no memory was
+ * allocated.
+ */
+DxfTagDictionary *
+dxf_tag_dictionary_new ()
+{
+        DxfTagDictionary *dictionary;
+
+        dictionary = calloc (1, sizeof (DxfTagDictionary));
+        if (dictionary == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        dictionary->index = dxf_symbol_table_new ();
+        if (dictionary->index == NULL)
+        {
+                free (dictionary);
+                return (NULL);
+        }
+        return (dictionary);
+}
+
+
+/*!
+ * \brief Add an \c ATTDEF entity to a tag dictionary.
+ *
+ * The tag, prompt and style strings of the definition are interned in
+ * the shared string pool; a definition with an already registered tag
+ * replaces the \c ATTDEF reference of the existing entry instead of
+ * creating a duplicate.
+ *
+ * \return the dictionary entry of the tag, or \c NULL when errors
+ * occurred.
+ */
+DxfTagEntry *
+dxf_tag_dictionary_add
+(
+        DxfTagDictionary *dictionary,
+                /*!< the dictionary to add to. */
+        DxfAttdef *attdef
+                /*!< the defining \c ATTDEF entity. */
+)
+{
+        DxfTagEntry *entry;
+
+        /* Do some basic checks. */
+        if ((dictionary == NULL) || (attdef == NULL)
+                || (attdef->tag_value == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        entry = dxf_tag_dictionary_find (dictionary, attdef->tag_value);
+        if (entry != NULL)
+        {
+                entry->attdef = attdef;
+                return (entry);
+        }
+        entry = calloc (1, sizeof (DxfTagEntry));
+        if (entry == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        entry->tag = dxf_string_intern (attdef->tag_value);
+        entry->prompt = dxf_string_intern (attdef->prompt_value);
+        entry->text_style = dxf_string_intern (attdef->text_style);
+        entry->attdef = attdef;
+        if (dxf_symbol_table_insert (dictionary->index, entry->tag, entry)
+                != EXIT_SUCCESS)
+        {
+                free (entry);
+                return (NULL);
+        }
+        entry->next = dictionary->entries;
+        dictionary->entries = entry;
+        dictionary->length++;
+        return (entry);
+}
+
+
+/*!
+ * \brief Look up the dictionary entry of a tag.
+ *
+ * \return the entry, or \c NULL when the tag is not registered.
+ */
+DxfTagEntry *
+dxf_tag_dictionary_find
+(
+        DxfTagDictionary *dictionary,
+                /*!< the dictionary to search. */
+        const char *tag
+                /*!< the attribute tag to look up. */
+)
+{
+        /* Do some basic checks. */
+        if ((dictionary == NULL) || (tag == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        return ((DxfTagEntry *) dxf_symbol_table_find (dictionary->index,
+                tag));
+}
+
+
+/*!
+ * \brief Resolve the defining \c ATTDEF of an \c ATTRIB entity.
+ *
+ * Looks the tag of the attribute up in the dictionary and stores the
+ * defining entity in the \c attdef member of the attribute, so later
+ * consumers follow the pointer instead of re-matching the tag.
+ *
+ * \return the defining \c ATTDEF, or \c NULL when the tag is not
+ * registered.
+ */
+DxfAttdef *
+dxf_tag_dictionary_resolve
+(
+        DxfTagDictionary *dictionary,
+                /*!< the dictionary to search. */
+        DxfAttrib *attrib
+                /*!< the \c ATTRIB entity to resolve. */
+)
+{
+        DxfTagEntry *entry;
+
+        /* Do some basic checks. */
+        if ((dictionary == NULL) || (attrib == NULL)
+                || (attrib->tag_value == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (NULL);
+        }
+        entry = dxf_tag_dictionary_find (dictionary, attrib->tag_value);
+        if (entry == NULL)
+        {
+                return (NULL);
+        }
+        attrib->attdef = entry->attdef;
+        return (entry->attdef);
+}
+
+
+/*!
+ * \brief Free a tag dictionary.
+ *
+ * The interned strings stay in the shared string pool (released by
+ * \c dxf_string_intern_free) and the referenced \c ATTDEF entities
+ * remain owned by the caller.
+ */
+void
+dxf_tag_dictionary_free
+(
+        DxfTagDictionary *dictionary
+                /*!< the dictionary to free, or \c NULL. */
+)
+{
+        DxfTagEntry *entry;
+        DxfTagEntry *next;
+
+        if (dictionary == NULL)
+        {
+                return;
+        }
+        for (entry = dictionary->entries; entry != NULL; entry = next)
+        {
+                next = entry->next;
+                free (entry);
+        }
+        dxf_symbol_table_free (dictionary->index);
+        free (dictionary);
+}
+
+
+/* EOF */
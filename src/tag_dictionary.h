@@ -0,0 +1,118 @@
+/*!
+ * \file tag_dictionary.h
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Header for the shared attribute tag dictionary.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#ifndef LIBDXF_SRC_TAG_DICTIONARY_H
+#define LIBDXF_SRC_TAG_DICTIONARY_H
+
+
+#include "symbol_table.h"
+#include "attdef.h"
+#include "attrib.h"
+
+
+/*!
+ * \brief One attribute definition in a shared tag dictionary.
+ *
+ * A title block repeats its attributes identically across thousands of
+ * \c INSERT entities; the dictionary keeps one entry per distinct tag,
+ * with the tag, prompt and style strings interned in the shared string
+ * pool (see \c dxf_string_intern), so the repeated instances reference
+ * one copy each instead of carrying duplicates.
+ */
+typedef struct
+dxf_tag_entry
+{
+        char *tag;
+                /*!< the attribute tag; interned, so entries of equal
+                 * tags compare equal by pointer. */
+        char *prompt;
+                /*!< the prompt text of the defining \c ATTDEF;
+                 * interned. */
+        char *text_style;
+                /*!< the text style of the defining \c ATTDEF;
+                 * interned. */
+        DxfAttdef *attdef;
+                /*!< the defining \c ATTDEF entity, or \c NULL. */
+        struct dxf_tag_entry *next;
+                /*!< the next entry of the dictionary. */
+} DxfTagEntry;
+
+
+/*!
+ * \brief A dictionary over the attribute definitions of a drawing,
+ * keyed by tag.
+ */
+typedef struct
+dxf_tag_dictionary
+{
+        DxfSymbolTable *index;
+                /*!< hash map from tag to \c DxfTagEntry. */
+        DxfTagEntry *entries;
+                /*!< the entries, most recently added first. */
+        size_t length;
+                /*!< number of entries in the dictionary. */
+} DxfTagDictionary;
+
+
+DxfTagDictionary *
+dxf_tag_dictionary_new ();
+DxfTagEntry *
+dxf_tag_dictionary_add
+(
+        DxfTagDictionary *dictionary,
+        DxfAttdef *attdef
+);
+DxfTagEntry *
+dxf_tag_dictionary_find
+(
+        DxfTagDictionary *dictionary,
+        const char *tag
+);
+DxfAttdef *
+dxf_tag_dictionary_resolve
+(
+        DxfTagDictionary *dictionary,
+        DxfAttrib *attrib
+);
+void
+dxf_tag_dictionary_free
+(
+        DxfTagDictionary *dictionary
+);
+
+
+#endif /* LIBDXF_SRC_TAG_DICTIONARY_H */
+
+
+/* EOF */
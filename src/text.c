@@ -32,7 +32,11 @@
  */
 
 
+#include <pthread.h>
 #include "text.h"
+#include "diag.h"
+#include "allocator.h"
+#include "util.h"
 
 
 /*!
@@ -58,7 +62,7 @@ dxf_text_new ()
         size = sizeof (DxfText);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_text = malloc (size)) == NULL)
+        if ((dxf_text = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfText struct.\n")),
@@ -98,6 +102,11 @@ dxf_text_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfText template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         /* Do some basic checks. */
         if (dxf_text == NULL)
         {
@@ -113,36 +122,49 @@ dxf_text_init
                 __FUNCTION__);
               return (NULL);
         }
-        dxf_text->id_code = 0;
-        dxf_text->text_value = strdup ("");
-        dxf_text->linetype = strdup (DXF_DEFAULT_LINETYPE);
-        dxf_text->text_style = strdup ("");
-        dxf_text->layer = strdup (DXF_DEFAULT_LAYER);
-        dxf_text->x0 = 0.0;
-        dxf_text->y0 = 0.0;
-        dxf_text->z0 = 0.0;
-        dxf_text->x1 = 0.0;
-        dxf_text->y1 = 0.0;
-        dxf_text->z1 = 0.0;
-        dxf_text->elevation = 0.0;
-        dxf_text->thickness = 0.0;
-        dxf_text->linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
-        dxf_text->height = 0.0;
-        dxf_text->rel_x_scale = 0.0;
-        dxf_text->rot_angle = 0.0;
-        dxf_text->obl_angle = 0.0;
-        dxf_text->visibility = DXF_DEFAULT_VISIBILITY;
-        dxf_text->color = DXF_COLOR_BYLAYER;
-        dxf_text->paperspace = DXF_MODELSPACE;
-        dxf_text->text_flags = 0;
-        dxf_text->hor_align = 0;
-        dxf_text->vert_align = 0;
-        dxf_text->extr_x0 = 0.0;
-        dxf_text->extr_y0 = 0.0;
-        dxf_text->extr_z0 = 0.0;
-        dxf_text->dictionary_owner_soft = strdup ("");
-        dxf_text->dictionary_owner_hard = strdup ("");
-        dxf_text->next = NULL;
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.id_code = 0;
+                template.text_value = strdup ("");
+                template.linetype = strdup (DXF_DEFAULT_LINETYPE);
+                template.text_style = strdup ("");
+                template.layer = strdup (DXF_DEFAULT_LAYER);
+                template.x0 = 0.0;
+                template.y0 = 0.0;
+                template.z0 = 0.0;
+                template.x1 = 0.0;
+                template.y1 = 0.0;
+                template.z1 = 0.0;
+                template.elevation = 0.0;
+                template.thickness = 0.0;
+                template.linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
+                template.height = 0.0;
+                template.rel_x_scale = 0.0;
+                template.rot_angle = 0.0;
+                template.obl_angle = 0.0;
+                template.visibility = DXF_DEFAULT_VISIBILITY;
+                template.color = DXF_COLOR_BYLAYER;
+                template.paperspace = DXF_MODELSPACE;
+                template.text_flags = 0;
+                template.hor_align = 0;
+                template.vert_align = 0;
+                template.extr_x0 = 0.0;
+                template.extr_y0 = 0.0;
+                template.extr_z0 = 0.0;
+                template.dictionary_owner_soft = strdup ("");
+                template.dictionary_owner_hard = strdup ("");
+                template.next = NULL;
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (dxf_text, &template, sizeof (DxfText));
+        dxf_text->text_value = strdup (template.text_value);
+        dxf_text->linetype = strdup (template.linetype);
+        dxf_text->text_style = strdup (template.text_style);
+        dxf_text->layer = strdup (template.layer);
+        dxf_text->dictionary_owner_soft = strdup (template.dictionary_owner_soft);
+        dxf_text->dictionary_owner_hard = strdup (template.dictionary_owner_hard);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -181,7 +203,7 @@ dxf_text_read
         DXF_DEBUG_BEGIN
 #endif
         char *dxf_entity_name = strdup ("TEXT");
-        char *temp_string = NULL;
+        char temp_string[DXF_MAX_STRING_LENGTH];
 
         /* Do some basic checks. */
         if (fp == NULL)
@@ -199,14 +221,13 @@ dxf_text_read
                 dxf_text = dxf_text_new ();
                 dxf_text = dxf_text_init (dxf_text);
         }
-        (fp->line_number)++;
-        fscanf (fp->fp, "%[^\n]", temp_string);
+        dxf_read_line (temp_string, fp);
         while (strcmp (temp_string, "0") != 0)
         {
                 if (ferror (fp->fp))
                 {
                         fprintf (stderr,
-                          (_("Error in %s () while reading from: %s in line: %d.\n")),
+                          (_("Error in %s () while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                         fclose (fp->fp);
                         return (NULL);
@@ -214,56 +235,56 @@ dxf_text_read
                 if (strcmp (temp_string, "1") == 0)
                 {
                         /* Now follows a string containing a text value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_text->text_value);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
+                        free (dxf_text->text_value);
+                        dxf_text->text_value = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "5") == 0)
                 {
                         /* Now follows a string containing a sequential
                          * id number. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%x\n", &dxf_text->id_code);
+                                                dxf_read_scanf (fp, "%x\n", &dxf_text->id_code);
                 }
                 else if (strcmp (temp_string, "6") == 0)
                 {
                         /* Now follows a string containing a linetype
                          * name. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_text->linetype);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
+                        free (dxf_text->linetype);
+                        dxf_text->linetype = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "7") == 0)
                 {
                         /* Now follows a string containing a text style
                          * name. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_text->text_style);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
+                        free (dxf_text->text_style);
+                        dxf_text->text_style = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "8") == 0)
                 {
                         /* Now follows a string containing a layer name. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_text->layer);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
+                        free (dxf_text->layer);
+                        dxf_text->layer = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "10") == 0)
                 {
                         /* Now follows a string containing the
                          * X-coordinate of the insertion point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_text->x0);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_text->x0);
                 }
                 else if (strcmp (temp_string, "20") == 0)
                 {
                         /* Now follows a string containing the
                          * Y-coordinate of the insertion point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_text->y0);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_text->y0);
                 }
                 else if (strcmp (temp_string, "30") == 0)
                 {
                         /* Now follows a string containing the
                          * Z-coordinate of the insertion point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_text->z0);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_text->z0);
                 }
                 else if ((fp->acad_version_number <= AutoCAD_11)
                         && (strcmp (temp_string, "38") == 0)
@@ -271,105 +292,91 @@ dxf_text_read
                 {
                         /* Now follows a string containing the
                          * elevation. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_text->elevation);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_text->elevation);
                 }
                 else if (strcmp (temp_string, "39") == 0)
                 {
                         /* Now follows a string containing the
                          * thickness. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_text->thickness);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_text->thickness);
                 }
                 else if (strcmp (temp_string, "40") == 0)
                 {
                         /* Now follows a string containing the
                          * height. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_text->height);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_text->height);
                 }
                 else if (strcmp (temp_string, "41") == 0)
                 {
                         /* Now follows a string containing the
                          * relative X-scale. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_text->rel_x_scale);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_text->rel_x_scale);
                 }
                 else if (strcmp (temp_string, "48") == 0)
                 {
                         /* Now follows a string containing the linetype
                          * scale. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_text->linetype_scale);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_text->linetype_scale);
                 }
                 else if (strcmp (temp_string, "50") == 0)
                 {
                         /* Now follows a string containing the
                          * rotation angle. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_text->rot_angle);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_text->rot_angle);
                 }
                 else if (strcmp (temp_string, "51") == 0)
                 {
                         /* Now follows a string containing the
                          * oblique angle. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_text->obl_angle);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_text->obl_angle);
                 }
                 else if (strcmp (temp_string, "60") == 0)
                 {
                         /* Now follows a string containing the
                          * visibility value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%hd\n", &dxf_text->visibility);
+                                                dxf_read_scanf (fp, "%hd\n", &dxf_text->visibility);
                 }
                 else if (strcmp (temp_string, "62") == 0)
                 {
                         /* Now follows a string containing the
                          * color value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_text->color);
+                                                dxf_read_scanf (fp, "%d\n", &dxf_text->color);
                 }
                 else if (strcmp (temp_string, "67") == 0)
                 {
                         /* Now follows a string containing the
                          * paperspace value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_text->paperspace);
+                                                dxf_read_scanf (fp, "%d\n", &dxf_text->paperspace);
                 }
                 else if (strcmp (temp_string, "71") == 0)
                 {
                         /* Now follows a string containing the
                          * text flags value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_text->text_flags);
+                                                dxf_read_scanf (fp, "%d\n", &dxf_text->text_flags);
                 }
                 else if (strcmp (temp_string, "72") == 0)
                 {
                         /* Now follows a string containing the
                          * horizontal alignment flag value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_text->hor_align);
+                                                dxf_read_scanf (fp, "%d\n", &dxf_text->hor_align);
                 }
                 else if (strcmp (temp_string, "73") == 0)
                 {
                         /* Now follows a string containing the
                          * vertical alignment flag value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_text->vert_align);
+                                                dxf_read_scanf (fp, "%d\n", &dxf_text->vert_align);
                 }
                 else if ((fp->acad_version_number >= AutoCAD_13)
                         && (strcmp (temp_string, "100") == 0))
                 {
                         /* Now follows a string containing the
                          * subclass marker value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", temp_string);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
                         if ((strcmp (temp_string, "AcDbEntity") != 0)
                         && ((strcmp (temp_string, "AcDbText") != 0)))
                         {
-                                fprintf (stderr,
-                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %d.\n")),
+                                dxf_diag_report (fp, DXF_DIAG_WARNING,
+                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                         }
                 }
@@ -377,50 +384,52 @@ dxf_text_read
                 {
                         /* Now follows a string containing the
                          * X-value of the extrusion vector. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_text->extr_x0);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_text->extr_x0);
                 }
                 else if (strcmp (temp_string, "220") == 0)
                 {
                         /* Now follows a string containing the
                          * Y-value of the extrusion vector. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_text->extr_y0);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_text->extr_y0);
                 }
                 else if (strcmp (temp_string, "230") == 0)
                 {
                         /* Now follows a string containing the
                          * Z-value of the extrusion vector. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_text->extr_z0);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_text->extr_z0);
                 }
                 else if (strcmp (temp_string, "330") == 0)
                 {
                         /* Now follows a string containing Soft-pointer
                          * ID/handle to owner dictionary. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_text->dictionary_owner_soft);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
+                        free (dxf_text->dictionary_owner_soft);
+                        dxf_text->dictionary_owner_soft = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "360") == 0)
                 {
                         /* Now follows a string containing Hard owner
                          * ID/handle to owner dictionary. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_text->dictionary_owner_hard);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
+                        free (dxf_text->dictionary_owner_hard);
+                        dxf_text->dictionary_owner_hard = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "999") == 0)
                 {
                         /* Now follows a string containing a comment. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", temp_string);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
                         fprintf (stdout, "DXF comment: %s\n", temp_string);
                 }
                 else
                 {
                         fprintf (stderr,
-                          (_("Warning: in %s () unknown string tag found while reading from: %s in line: %d.\n")),
+                          (_("Warning: in %s () unknown string tag found while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                 }
+                if (dxf_read_line (temp_string, fp) != 1)
+                {
+                        break;
+                }
         }
         /* Handle omitted members and/or illegal values. */
         if (strcmp (dxf_text->text_value, "") == 0)
@@ -698,7 +707,7 @@ dxf_text_free
         free (dxf_text->text_style);
         free (dxf_text->dictionary_owner_soft);
         free (dxf_text->dictionary_owner_hard);
-        free (dxf_text);
+        dxf_entity_dealloc (dxf_text, sizeof (*dxf_text));
         dxf_text = NULL;
 #if DEBUG
         DXF_DEBUG_END
@@ -32,7 +32,11 @@
  */
 
 
+#include <pthread.h>
 #include "thumbnail.h"
+#include "diag.h"
+#include "allocator.h"
+#include "util.h"
 
 
 /*!
@@ -69,7 +73,7 @@ dxf_thumbnail_new ()
         size = sizeof (DxfThumbnail);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_thumbnail = malloc (size)) == NULL)
+        if ((dxf_thumbnail = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfThumbnail struct.\n")),
@@ -118,7 +122,10 @@ dxf_thumbnail_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        int i;
+        static DxfThumbnail template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
 
         /* Do some basic checks. */
         if (dxf_thumbnail == NULL)
@@ -135,11 +142,17 @@ dxf_thumbnail_init
                   __FUNCTION__);
                 return (NULL);
         }
-        dxf_thumbnail->number_of_bytes = 0;
-        for (i = 0; i < DXF_MAX_PARAM; i++)
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
         {
-                dxf_thumbnail->preview_image_data[i] = strdup ("");
+                template.number_of_bytes = 0;
+                template.image_data = NULL;
+                template.image_data_size = 0;
+                template.image_data_length = 0;
+                template_ready = 1;
         }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (dxf_thumbnail, &template, sizeof (DxfThumbnail));
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -184,8 +197,10 @@ dxf_thumbnail_read
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        char *temp_string = NULL;
-        int i;
+        char temp_string[DXF_MAX_STRING_LENGTH];
+        unsigned char *grown;
+        size_t needed;
+        int decoded;
         int preview_data_length = 0;
 
         /* Do some basic checks. */
@@ -210,47 +225,108 @@ dxf_thumbnail_read
                   (_("Warning in %s () illegal DXF version for this entity.\n")),
                   __FUNCTION__);
         }
-        i = 0;
-        (fp->line_number)++;
-        fscanf (fp->fp, "%[^\n]", temp_string);
+        /* discard stored image bytes but keep the buffer of a recycled
+         * entity. */
+        dxf_thumbnail->image_data_length = 0;
+        if (dxf_read_line (temp_string, fp) != 1)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () while reading from: %s in line: %ld.\n")),
+                  __FUNCTION__, fp->filename, fp->line_number);
+                return (NULL);
+        }
         while (strcmp (temp_string, "0") != 0)
         {
-                if (ferror (fp->fp))
-                {
-                        fprintf (stderr,
-                          (_("Error in %s () while reading from: %s in line: %d.\n")),
-                          __FUNCTION__, fp->filename, fp->line_number);
-                        fclose (fp->fp);
-                        return (NULL);
-                }
-                else if (strcmp (temp_string, "90") == 0)
+                if (strcmp (temp_string, "90") == 0)
                 {
                         /* Now follows a string containing the
                          * number of bytes value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_thumbnail->number_of_bytes);
+                        if (dxf_read_line (temp_string, fp) != 1)
+                        {
+                                break;
+                        }
+                        dxf_thumbnail->number_of_bytes = atoi (temp_string);
                 }
                 else if (strcmp (temp_string, "310") == 0)
                 {
-                        /* Now follows a string containing additional
-                         * proprietary data. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_thumbnail->preview_image_data[i]);
-                        preview_data_length = preview_data_length + strlen (dxf_thumbnail->preview_image_data[i]);
-                        i++;
+                        /* Now follows a batch of hex chunk lines of
+                         * the preview image: decode them straight into
+                         * the binary buffer in a tight loop. */
+                        while (strcmp (temp_string, "310") == 0)
+                        {
+                                if (dxf_read_line (temp_string, fp) != 1)
+                                {
+                                        break;
+                                }
+                                needed = (size_t) dxf_thumbnail->image_data_length
+                                        + (strlen (temp_string) / 2);
+                                if (needed > dxf_thumbnail->image_data_size)
+                                {
+                                        if (dxf_thumbnail->image_data_size == 0)
+                                        {
+                                                dxf_thumbnail->image_data_size = 4096;
+                                        }
+                                        while (dxf_thumbnail->image_data_size < needed)
+                                        {
+                                                dxf_thumbnail->image_data_size *= 2;
+                                        }
+                                        grown = realloc (dxf_thumbnail->image_data,
+                                                dxf_thumbnail->image_data_size);
+                                        if (grown == NULL)
+                                        {
+                                                fprintf (stderr,
+                                                  (_("Error in %s () could not allocate memory.\n")),
+                                                  __FUNCTION__);
+                                                return (NULL);
+                                        }
+                                        dxf_thumbnail->image_data = grown;
+                                }
+                                decoded = dxf_hex_decode (temp_string,
+                                        dxf_thumbnail->image_data + dxf_thumbnail->image_data_length);
+                                if (decoded < 0)
+                                {
+                                        fprintf (stderr,
+                                          (_("Warning in %s () malformed hex chunk found while reading from: %s in line: %ld.\n")),
+                                          __FUNCTION__, fp->filename, fp->line_number);
+                                }
+                                else
+                                {
+                                        dxf_thumbnail->image_data_length += decoded;
+                                        preview_data_length = preview_data_length + strlen (temp_string);
+                                }
+                                if (dxf_read_line (temp_string, fp) != 1)
+                                {
+                                        break;
+                                }
+                        }
+                        /* the tag following the batch is already in
+                         * temp_string. */
+                        continue;
                 }
                 else if (strcmp (temp_string, "999") == 0)
                 {
                         /* Now follows a string containing a comment. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", temp_string);
+                        if (dxf_read_line (temp_string, fp) != 1)
+                        {
+                                break;
+                        }
                         fprintf (stdout, "DXF comment: %s\n", temp_string);
                 }
                 else
                 {
-                        fprintf (stderr,
-                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %d.\n")),
+                        dxf_diag_report (fp, DXF_DIAG_WARNING,
+                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
+                        /* consume the value of the unknown tag. */
+                        if (dxf_read_line (temp_string, fp) != 1)
+                        {
+                                break;
+                        }
+                }
+                /* the next tag. */
+                if (dxf_read_line (temp_string, fp) != 1)
+                {
+                        break;
                 }
         }
         /* Handle omitted members and/or illegal values. */
@@ -298,7 +374,10 @@ dxf_thumbnail_write
         DXF_DEBUG_BEGIN
 #endif
         char *dxf_entity_name = strdup ("THUMBNAILIMAGE");
-        int i;
+        char *buffer;
+        size_t used;
+        int offset;
+        int chunk;
 
         /* Do some basic checks. */
         if (fp == NULL)
@@ -332,12 +411,42 @@ dxf_thumbnail_write
         /* Start writing output. */
         fprintf (fp->fp, "  0\n%s\n", dxf_entity_name);
         fprintf (fp->fp, " 90\n%d\n", dxf_thumbnail->number_of_bytes);
-        i = 0;
-        while (strlen (dxf_thumbnail->preview_image_data[i]) > 0)
+        /* encode the image as chunk lines of at most 127 bytes (254
+         * hex characters), all batched into one buffer and emitted
+         * with a single fwrite call. */
+        buffer = malloc ((((size_t) dxf_thumbnail->image_data_length + 126) / 127)
+                * (4 + 254 + 1) + 1);
+        if (buffer == NULL)
         {
-                fprintf (fp->fp, "310\n%s\n", dxf_thumbnail->preview_image_data[i]);
-                i++;
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        used = 0;
+        for (offset = 0; offset < dxf_thumbnail->image_data_length; offset += chunk)
+        {
+                chunk = dxf_thumbnail->image_data_length - offset;
+                if (chunk > 127)
+                {
+                        chunk = 127;
+                }
+                memcpy (buffer + used, "310\n", 4);
+                used += 4;
+                used += dxf_hex_encode (buffer + used,
+                        dxf_thumbnail->image_data + offset, chunk);
+                buffer[used] = '\n';
+                used++;
+        }
+        if (fwrite (buffer, 1, used, fp->fp) != used)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () while writing to: %s.\n")),
+                  __FUNCTION__, fp->filename);
+                free (buffer);
+                return (EXIT_FAILURE);
         }
+        free (buffer);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -377,13 +486,8 @@ dxf_thumbnail_free
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        int i;
-
-        for (i = 0; i < DXF_MAX_PARAM; i++)
-        {
-                free (dxf_thumbnail->preview_image_data[i]);
-        }
-        free (dxf_thumbnail);
+        free (dxf_thumbnail->image_data);
+        dxf_entity_dealloc (dxf_thumbnail, sizeof (*dxf_thumbnail));
         dxf_thumbnail = NULL;
 #if DEBUG
         DXF_DEBUG_END
@@ -63,9 +63,14 @@ dxf_thumbnail
                 /*!< group code = 90\n
                  * The number of bytes in the image (and subsequent binary
                  * chunk records). */
-        char *preview_image_data[DXF_MAX_PARAM];
+        unsigned char *image_data;
                 /*!< group code = 310\n
-                 * multiple lines (256 characters maximum per line). */
+                 * the preview image, decoded from the hex chunk lines
+                 * into one contiguous binary buffer. */
+        size_t image_data_size;
+                /*!< allocated size of \c image_data in bytes. */
+        int image_data_length;
+                /*!< number of decoded image bytes in \c image_data. */
 } DxfThumbnail;
 
 
@@ -32,7 +32,10 @@
  */
 
 
+#include <pthread.h>
 #include "trace.h"
+#include "diag.h"
+#include "allocator.h"
 
 
 /*!
@@ -61,7 +64,7 @@ dxf_trace_new ()
         size = sizeof (DxfTrace);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_trace = malloc (size)) == NULL)
+        if ((dxf_trace = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfTrace struct.\n")),
@@ -102,6 +105,11 @@ dxf_trace_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfTrace template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         /* Do some basic checks. */
         if (dxf_trace == NULL)
         {
@@ -117,33 +125,44 @@ dxf_trace_init
                   __FUNCTION__);
                 return (NULL);
         }
-        dxf_trace->id_code = 0;
-        dxf_trace->linetype = strdup (DXF_DEFAULT_LINETYPE);
-        dxf_trace->layer = strdup (DXF_DEFAULT_LAYER);
-        dxf_trace->x0 = 0.0;
-        dxf_trace->y0 = 0.0;
-        dxf_trace->z0 = 0.0;
-        dxf_trace->x1 = 0.0;
-        dxf_trace->y1 = 0.0;
-        dxf_trace->z1 = 0.0;
-        dxf_trace->x2 = 0.0;
-        dxf_trace->y2 = 0.0;
-        dxf_trace->z2 = 0.0;
-        dxf_trace->x3 = 0.0;
-        dxf_trace->y3 = 0.0;
-        dxf_trace->z3 = 0.0;
-        dxf_trace->elevation = 0.0;
-        dxf_trace->thickness = 0.0;
-        dxf_trace->linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
-        dxf_trace->visibility = DXF_DEFAULT_VISIBILITY;
-        dxf_trace->color = DXF_COLOR_BYLAYER;
-        dxf_trace->paperspace = DXF_MODELSPACE;
-        dxf_trace->extr_x0 = 0.0;
-        dxf_trace->extr_y0 = 0.0;
-        dxf_trace->extr_z0 = 0.0;
-        dxf_trace->dictionary_owner_soft = strdup ("");
-        dxf_trace->dictionary_owner_hard = strdup ("");
-        dxf_trace->next = NULL;
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.id_code = 0;
+                template.linetype = strdup (DXF_DEFAULT_LINETYPE);
+                template.layer = strdup (DXF_DEFAULT_LAYER);
+                template.x0 = 0.0;
+                template.y0 = 0.0;
+                template.z0 = 0.0;
+                template.x1 = 0.0;
+                template.y1 = 0.0;
+                template.z1 = 0.0;
+                template.x2 = 0.0;
+                template.y2 = 0.0;
+                template.z2 = 0.0;
+                template.x3 = 0.0;
+                template.y3 = 0.0;
+                template.z3 = 0.0;
+                template.elevation = 0.0;
+                template.thickness = 0.0;
+                template.linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
+                template.visibility = DXF_DEFAULT_VISIBILITY;
+                template.color = DXF_COLOR_BYLAYER;
+                template.paperspace = DXF_MODELSPACE;
+                template.extr_x0 = 0.0;
+                template.extr_y0 = 0.0;
+                template.extr_z0 = 0.0;
+                template.dictionary_owner_soft = strdup ("");
+                template.dictionary_owner_hard = strdup ("");
+                template.next = NULL;
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (dxf_trace, &template, sizeof (DxfTrace));
+        dxf_trace->linetype = strdup (template.linetype);
+        dxf_trace->layer = strdup (template.layer);
+        dxf_trace->dictionary_owner_soft = strdup (template.dictionary_owner_soft);
+        dxf_trace->dictionary_owner_hard = strdup (template.dictionary_owner_hard);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -178,7 +197,7 @@ dxf_trace_read
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        char *temp_string = NULL;
+        char temp_string[DXF_MAX_STRING_LENGTH];
 
         /* Do some basic checks. */
         if (fp == NULL)
@@ -203,7 +222,7 @@ dxf_trace_read
                 if (ferror (fp->fp))
                 {
                         fprintf (stderr,
-                          (_("Error in %s () while reading from: %s in line: %d.\n")),
+                          (_("Error in %s () while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                         fclose (fp->fp);
                         return (NULL);
@@ -220,13 +239,17 @@ dxf_trace_read
                         /* Now follows a string containing a linetype
                          * name. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_trace->linetype);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_trace->linetype);
+                        dxf_trace->linetype = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "8") == 0)
                 {
                         /* Now follows a string containing a layer name. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_trace->layer);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_trace->layer);
+                        dxf_trace->layer = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "10") == 0)
                 {
@@ -366,8 +389,8 @@ dxf_trace_read
                         if ((strcmp (temp_string, "AcDbEntity") != 0)
                         && ((strcmp (temp_string, "AcDbTrace") != 0)))
                         {
-                                fprintf (stderr,
-                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %d.\n")),
+                                dxf_diag_report (fp, DXF_DIAG_WARNING,
+                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                         }
                 }
@@ -397,14 +420,18 @@ dxf_trace_read
                         /* Now follows a string containing Soft-pointer
                          * ID/handle to owner dictionary. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_trace->dictionary_owner_soft);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_trace->dictionary_owner_soft);
+                        dxf_trace->dictionary_owner_soft = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "360") == 0)
                 {
                         /* Now follows a string containing Hard owner
                          * ID/handle to owner dictionary. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_trace->dictionary_owner_hard);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_trace->dictionary_owner_hard);
+                        dxf_trace->dictionary_owner_hard = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "999") == 0)
                 {
@@ -415,8 +442,8 @@ dxf_trace_read
                 }
                 else
                 {
-                        fprintf (stderr,
-                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %d.\n")),
+                        dxf_diag_report (fp, DXF_DIAG_WARNING,
+                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                 }
         }
@@ -629,7 +656,7 @@ dxf_trace_free
         free (dxf_trace->layer);
         free (dxf_trace->dictionary_owner_soft);
         free (dxf_trace->dictionary_owner_hard);
-        free (dxf_trace);
+        dxf_entity_dealloc (dxf_trace, sizeof (*dxf_trace));
         dxf_trace = NULL;
 #if DEBUG
         DXF_DEBUG_END
@@ -0,0 +1,701 @@
+/*!
+ * \file transform.c
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.
+ *
+ * \brief Functions for bulk affine transforms over entity containers.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#include <math.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "transform.h"
+#include "3dface.h"
+#include "arc.h"
+#include "circle.h"
+#include "ellipse.h"
+#include "insert.h"
+#include "line.h"
+#include "lwpolyline.h"
+#include "point.h"
+#include "polyline.h"
+#include "solid.h"
+#include "text.h"
+#include "vertex.h"
+
+
+/*!
+ * Entity count below which \c dxf_drawing_transform sweeps on the
+ * calling thread.
+ */
+#define DXF_TRANSFORM_PARALLEL_THRESHOLD 16384
+
+
+/*!
+ * \brief Initialize a \c DxfTransform to the identity.
+ */
+void
+dxf_transform_init
+(
+        DxfTransform *transform
+                /*!< the transform to initialize. */
+)
+{
+        int row;
+        int column;
+
+        if (transform == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return;
+        }
+        for (row = 0; row < 3; row++)
+        {
+                for (column = 0; column < 4; column++)
+                {
+                        transform->m[row][column] = (row == column) ? 1.0 : 0.0;
+                }
+        }
+}
+
+
+/*!
+ * \brief Build the similarity transform of the normalization and
+ * placement steps: uniform scale, rotation about Z, translation.
+ */
+void
+dxf_transform_similarity
+(
+        DxfTransform *transform,
+                /*!< the transform to build. */
+        double scale,
+                /*!< the uniform scale factor. */
+        double rotation,
+                /*!< the rotation about the Z axis in degrees. */
+        double x,
+                /*!< the X translation. */
+        double y,
+                /*!< the Y translation. */
+        double z
+                /*!< the Z translation. */
+)
+{
+        double radians;
+        double c;
+        double s;
+
+        if (transform == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return;
+        }
+        radians = rotation * M_PI / 180.0;
+        c = cos (radians);
+        s = sin (radians);
+        transform->m[0][0] = scale * c;
+        transform->m[0][1] = scale * -s;
+        transform->m[0][2] = 0.0;
+        transform->m[0][3] = x;
+        transform->m[1][0] = scale * s;
+        transform->m[1][1] = scale * c;
+        transform->m[1][2] = 0.0;
+        transform->m[1][3] = y;
+        transform->m[2][0] = 0.0;
+        transform->m[2][1] = 0.0;
+        transform->m[2][2] = scale;
+        transform->m[2][3] = z;
+}
+
+
+/*!
+ * \brief Transform one point in place.
+ */
+static void
+dxf_transform_point3
+(
+        const DxfTransform *t,
+                /*!< the transform. */
+        double *x,
+                /*!< the X coordinate. */
+        double *y,
+                /*!< the Y coordinate. */
+        double *z
+                /*!< the Z coordinate. */
+)
+{
+        double px;
+        double py;
+        double pz;
+
+        px = *x;
+        py = *y;
+        pz = *z;
+        *x = t->m[0][0] * px + t->m[0][1] * py + t->m[0][2] * pz + t->m[0][3];
+        *y = t->m[1][0] * px + t->m[1][1] * py + t->m[1][2] * pz + t->m[1][3];
+        *z = t->m[2][0] * px + t->m[2][1] * py + t->m[2][2] * pz + t->m[2][3];
+}
+
+
+/*!
+ * \brief The uniform scale factor of a transform, from the image of
+ * the X unit vector.
+ *
+ * Exact for similarity transforms; the parameter space kernels use
+ * it for radii, widths and heights.
+ */
+static double
+dxf_transform_scale
+(
+        const DxfTransform *t
+                /*!< the transform. */
+)
+{
+        return (sqrt (t->m[0][0] * t->m[0][0] + t->m[1][0] * t->m[1][0]));
+}
+
+
+/*!
+ * \brief The rotation about Z of a transform in degrees, from the
+ * image of the X unit vector.
+ */
+static double
+dxf_transform_rotation
+(
+        const DxfTransform *t
+                /*!< the transform. */
+)
+{
+        return (atan2 (t->m[1][0], t->m[0][0]) * 180.0 / M_PI);
+}
+
+
+/*!
+ * \brief Transform a slice of a \c LINE coordinate store.
+ *
+ * One plain loop per coordinate array: no type dispatch, no pointer
+ * chasing, each loop vectorizable over the contiguous doubles.
+ */
+static void
+dxf_transform_soa_lines_slice
+(
+        const DxfTransform *t,
+                /*!< the transform. */
+        DxfSoaLines *lines,
+                /*!< store of \c LINE coordinates. */
+        size_t start,
+                /*!< first stored line of the slice. */
+        size_t length
+                /*!< number of stored lines in the slice. */
+)
+{
+        size_t i;
+
+        for (i = start; i < start + length; i++)
+        {
+                dxf_transform_point3 (t, &lines->x0[i], &lines->y0[i],
+                        &lines->z0[i]);
+                dxf_transform_point3 (t, &lines->x1[i], &lines->y1[i],
+                        &lines->z1[i]);
+        }
+}
+
+
+/*!
+ * \brief Transform a slice of a \c POINT coordinate store.
+ */
+static void
+dxf_transform_soa_points_slice
+(
+        const DxfTransform *t,
+                /*!< the transform. */
+        DxfSoaPoints *points,
+                /*!< store of \c POINT coordinates. */
+        size_t start,
+                /*!< first stored point of the slice. */
+        size_t length
+                /*!< number of stored points in the slice. */
+)
+{
+        size_t i;
+
+        for (i = start; i < start + length; i++)
+        {
+                dxf_transform_point3 (t, &points->x0[i], &points->y0[i],
+                        &points->z0[i]);
+        }
+}
+
+
+/*!
+ * \brief Transform a slice of a \c 3DFACE coordinate store.
+ */
+static void
+dxf_transform_soa_faces_slice
+(
+        const DxfTransform *t,
+                /*!< the transform. */
+        DxfSoaFaces *faces,
+                /*!< store of \c 3DFACE coordinates. */
+        size_t start,
+                /*!< first stored face of the slice. */
+        size_t length
+                /*!< number of stored faces in the slice. */
+)
+{
+        size_t i;
+
+        for (i = start; i < start + length; i++)
+        {
+                dxf_transform_point3 (t, &faces->x0[i], &faces->y0[i],
+                        &faces->z0[i]);
+                dxf_transform_point3 (t, &faces->x1[i], &faces->y1[i],
+                        &faces->z1[i]);
+                dxf_transform_point3 (t, &faces->x2[i], &faces->y2[i],
+                        &faces->z2[i]);
+                dxf_transform_point3 (t, &faces->x3[i], &faces->y3[i],
+                        &faces->z3[i]);
+        }
+}
+
+
+/*!
+ * \brief Transform a \c LINE coordinate store in place.
+ */
+void
+dxf_transform_soa_lines
+(
+        const DxfTransform *transform,
+                /*!< the transform. */
+        DxfSoaLines *lines
+                /*!< store of \c LINE coordinates. */
+)
+{
+        if ((transform == NULL) || (lines == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return;
+        }
+        dxf_transform_soa_lines_slice (transform, lines, 0, lines->length);
+}
+
+
+/*!
+ * \brief Transform a \c POINT coordinate store in place.
+ */
+void
+dxf_transform_soa_points
+(
+        const DxfTransform *transform,
+                /*!< the transform. */
+        DxfSoaPoints *points
+                /*!< store of \c POINT coordinates. */
+)
+{
+        if ((transform == NULL) || (points == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return;
+        }
+        dxf_transform_soa_points_slice (transform, points, 0, points->length);
+}
+
+
+/*!
+ * \brief Transform a \c 3DFACE coordinate store in place.
+ */
+void
+dxf_transform_soa_faces
+(
+        const DxfTransform *transform,
+                /*!< the transform. */
+        DxfSoaFaces *faces
+                /*!< store of \c 3DFACE coordinates. */
+)
+{
+        if ((transform == NULL) || (faces == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return;
+        }
+        dxf_transform_soa_faces_slice (transform, faces, 0, faces->length);
+}
+
+
+/*!
+ * \brief Transform one retained entity in place.
+ *
+ * Point carrying members go through the full affine map; radii,
+ * widths, heights and angles update in parameter space with the
+ * uniform scale and rotation of the transform.
+ */
+static void
+dxf_transform_entity
+(
+        const DxfTransform *t,
+                /*!< the transform. */
+        DxfEntityType type,
+                /*!< the type of the entity. */
+        void *entity
+                /*!< the entity struct. */
+)
+{
+        double scale;
+        double rotation;
+        int i;
+
+        switch (type)
+        {
+                case ARC:
+                {
+                        DxfArc *arc = entity;
+
+                        dxf_transform_point3 (t, &arc->x0, &arc->y0,
+                                &arc->z0);
+                        arc->radius *= dxf_transform_scale (t);
+                        rotation = dxf_transform_rotation (t);
+                        arc->start_angle += rotation;
+                        arc->end_angle += rotation;
+                        break;
+                }
+                case CIRCLE:
+                {
+                        DxfCircle *circle = entity;
+
+                        dxf_transform_point3 (t, &circle->x0, &circle->y0,
+                                &circle->z0);
+                        circle->radius *= dxf_transform_scale (t);
+                        break;
+                }
+                case ELLIPSE:
+                {
+                        DxfEllipse *ellipse = entity;
+                        double px;
+                        double py;
+                        double pz;
+
+                        dxf_transform_point3 (t, &ellipse->x0, &ellipse->y0,
+                                &ellipse->z0);
+                        /* the major axis endpoint is relative to the
+                         * center: linear part only. */
+                        px = ellipse->x1;
+                        py = ellipse->y1;
+                        pz = ellipse->z1;
+                        ellipse->x1 = t->m[0][0] * px + t->m[0][1] * py
+                                + t->m[0][2] * pz;
+                        ellipse->y1 = t->m[1][0] * px + t->m[1][1] * py
+                                + t->m[1][2] * pz;
+                        ellipse->z1 = t->m[2][0] * px + t->m[2][1] * py
+                                + t->m[2][2] * pz;
+                        /* ratio and parameter range are invariant
+                         * under a similarity. */
+                        break;
+                }
+                case FACE3D:
+                {
+                        Dxf3dface *face = entity;
+
+                        dxf_transform_point3 (t, &face->x0, &face->y0,
+                                &face->z0);
+                        dxf_transform_point3 (t, &face->x1, &face->y1,
+                                &face->z1);
+                        dxf_transform_point3 (t, &face->x2, &face->y2,
+                                &face->z2);
+                        dxf_transform_point3 (t, &face->x3, &face->y3,
+                                &face->z3);
+                        break;
+                }
+                case INSERT:
+                {
+                        DxfInsert *insert = entity;
+
+                        dxf_transform_point3 (t, &insert->x0, &insert->y0,
+                                &insert->z0);
+                        scale = dxf_transform_scale (t);
+                        insert->rel_x_scale *= scale;
+                        insert->rel_y_scale *= scale;
+                        insert->rel_z_scale *= scale;
+                        insert->rot_angle += dxf_transform_rotation (t);
+                        break;
+                }
+                case LINE:
+                {
+                        DxfLine *line = entity;
+
+                        dxf_transform_point3 (t, &line->x0, &line->y0,
+                                &line->z0);
+                        dxf_transform_point3 (t, &line->x1, &line->y1,
+                                &line->z1);
+                        break;
+                }
+                case LWPOLYLINE:
+                {
+                        DxfLWPolyline *lwpolyline = entity;
+                        double z = 0.0;
+
+                        scale = dxf_transform_scale (t);
+                        for (i = 0; i < lwpolyline->number_vertices; i++)
+                        {
+                                DxfLWPolylineVertex *vertex;
+
+                                vertex = &lwpolyline->vertices[i];
+                                z = lwpolyline->elevation;
+                                dxf_transform_point3 (t, &vertex->x0,
+                                        &vertex->y0, &z);
+                                vertex->start_width *= scale;
+                                vertex->end_width *= scale;
+                                /* the bulge is an angle ratio:
+                                 * invariant under a similarity. */
+                        }
+                        lwpolyline->constant_width *= scale;
+                        if (lwpolyline->number_vertices > 0)
+                        {
+                                lwpolyline->elevation = z;
+                        }
+                        break;
+                }
+                case POINT:
+                {
+                        DxfPoint *point = entity;
+
+                        dxf_transform_point3 (t, &point->x0, &point->y0,
+                                &point->z0);
+                        break;
+                }
+                case POLYLINE:
+                {
+                        DxfPolyline *polyline = entity;
+
+                        dxf_transform_point3 (t, &polyline->x0,
+                                &polyline->y0, &polyline->z0);
+                        break;
+                }
+                case SOLID:
+                {
+                        DxfSolid *solid = entity;
+
+                        dxf_transform_point3 (t, &solid->x0, &solid->y0,
+                                &solid->z0);
+                        dxf_transform_point3 (t, &solid->x1, &solid->y1,
+                                &solid->z1);
+                        dxf_transform_point3 (t, &solid->x2, &solid->y2,
+                                &solid->z2);
+                        dxf_transform_point3 (t, &solid->x3, &solid->y3,
+                                &solid->z3);
+                        break;
+                }
+                case TEXT:
+                {
+                        DxfText *text = entity;
+
+                        dxf_transform_point3 (t, &text->x0, &text->y0,
+                                &text->z0);
+                        dxf_transform_point3 (t, &text->x1, &text->y1,
+                                &text->z1);
+                        text->height *= dxf_transform_scale (t);
+                        text->rot_angle += dxf_transform_rotation (t);
+                        break;
+                }
+                case VERTEX:
+                {
+                        DxfVertex *vertex = entity;
+
+                        dxf_transform_point3 (t, &vertex->x0, &vertex->y0,
+                                &vertex->z0);
+                        break;
+                }
+                default:
+                {
+                        /* no coordinates to transform. */
+                        break;
+                }
+        }
+}
+
+
+/*!
+ * \brief One worker of \c dxf_drawing_transform: a contiguous slice
+ * of the drawing.
+ */
+typedef struct
+dxf_transform_worker
+{
+        const DxfTransform *transform;
+                /*!< the transform. */
+        DxfDrawing *drawing;
+                /*!< the drawing being transformed. */
+        size_t start;
+                /*!< first entity of this worker's slice. */
+        size_t length;
+                /*!< number of entities in this worker's slice. */
+        pthread_t thread;
+                /*!< the worker thread. */
+} DxfTransformWorker;
+
+
+/*!
+ * \brief Transform one worker's slice of the drawing.
+ */
+static void *
+dxf_transform_worker_main
+(
+        void *arg
+                /*!< the \c DxfTransformWorker to run. */
+)
+{
+        DxfTransformWorker *worker;
+        size_t i;
+
+        worker = (DxfTransformWorker *) arg;
+        for (i = worker->start; i < worker->start + worker->length; i++)
+        {
+                dxf_transform_entity (worker->transform,
+                        worker->drawing->entities[i].type,
+                        worker->drawing->entities[i].entity);
+        }
+        return (NULL);
+}
+
+
+/*!
+ * \brief Apply an affine transform to every retained entity of a
+ * drawing.
+ *
+ * The drawing is split into one contiguous slice per worker and the
+ * slices are swept concurrently; entities are disjoint, so the
+ * workers share nothing but the read-only transform.\n
+ * Small drawings (see \c DXF_TRANSFORM_PARALLEL_THRESHOLD) sweep on
+ * the calling thread.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_drawing_transform
+(
+        DxfDrawing *drawing,
+                /*!< the drawing to transform. */
+        const DxfTransform *transform,
+                /*!< the transform to apply. */
+        int workers
+                /*!< number of worker threads, or \c 0 for one per
+                 * available processor. */
+)
+{
+#if DEBUG
+        DXF_DEBUG_BEGIN
+#endif
+        DxfTransformWorker *pool;
+        int count;
+        int i;
+
+        /* Do some basic checks. */
+        if ((drawing == NULL) || (transform == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (drawing->length == 0)
+        {
+                return (EXIT_SUCCESS);
+        }
+        if (workers <= 0)
+        {
+                workers = (int) sysconf (_SC_NPROCESSORS_ONLN);
+        }
+        if (workers < 1)
+        {
+                workers = 1;
+        }
+        if ((workers == 1)
+                || (drawing->length < DXF_TRANSFORM_PARALLEL_THRESHOLD))
+        {
+                for (i = 0; (size_t) i < drawing->length; i++)
+                {
+                        dxf_transform_entity (transform,
+                                drawing->entities[i].type,
+                                drawing->entities[i].entity);
+                }
+                return (EXIT_SUCCESS);
+        }
+        pool = malloc ((size_t) workers * sizeof (DxfTransformWorker));
+        if (pool == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        for (i = 0; i < workers; i++)
+        {
+                pool[i].transform = transform;
+                pool[i].drawing = drawing;
+                pool[i].start = drawing->length * (size_t) i / (size_t) workers;
+                pool[i].length = drawing->length * (size_t) (i + 1) / (size_t) workers
+                        - pool[i].start;
+        }
+        count = 0;
+        for (i = 0; i < workers; i++)
+        {
+                if (pthread_create (&pool[i].thread, NULL,
+                        dxf_transform_worker_main, &pool[i]) != 0)
+                {
+                        /* no thread: sweep in this one. */
+                        dxf_transform_worker_main (&pool[i]);
+                        pool[i].thread = pthread_self ();
+                }
+                count++;
+        }
+        for (i = 0; i < count; i++)
+        {
+                if (!pthread_equal (pool[i].thread, pthread_self ()))
+                {
+                        pthread_join (pool[i].thread, NULL);
+                }
+        }
+        free (pool);
+#if DEBUG
+        DXF_DEBUG_END
+#endif
+        return (EXIT_SUCCESS);
+}
+
+
+/* EOF */
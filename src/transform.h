@@ -0,0 +1,120 @@
+/*!
+ * \file transform.h
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Header for bulk affine transforms over entity containers.
+ *
+ * Unit normalization and sheet placement apply the same affine
+ * transform to every coordinate of a drawing; doing that through
+ * per-entity, per-field updates costs a function call and a type
+ * dispatch per coordinate.\n
+ * This module applies one transform to a whole container in a single
+ * pass: tight per-type kernels over the structure-of-arrays
+ * coordinate stores (see soa.h), and a chunk parallel sweep over the
+ * retained entities of a drawing with one kernel per entity type.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#ifndef LIBDXF_SRC_TRANSFORM_H
+#define LIBDXF_SRC_TRANSFORM_H
+
+
+#include "global.h"
+#include "drawing.h"
+#include "soa.h"
+
+
+/*!
+ * \brief An affine transform over drawing coordinates.
+ *
+ * Row major 3 x 4: a point transforms as\n
+ * <tt>x' = m[0][0] x + m[0][1] y + m[0][2] z + m[0][3]</tt>\n
+ * and alike for \c y' and \c z'.\n
+ * The curve carrying entities (\c ARC, \c CIRCLE, \c ELLIPSE) and
+ * the scalar distances (radii, widths, text height) are updated in
+ * parameter space, which is exact for similarity transforms (uniform
+ * scale, rotation about Z, translation — the normalization and
+ * placement cases); a non-uniform or shearing transform would change
+ * the curve class of those entities and is applied to their defining
+ * points only.
+ */
+typedef struct
+dxf_transform
+{
+        double m[3][4];
+                /*!< the matrix coefficients. */
+} DxfTransform;
+
+
+void
+dxf_transform_init
+(
+        DxfTransform *transform
+);
+void
+dxf_transform_similarity
+(
+        DxfTransform *transform,
+        double scale,
+        double rotation,
+        double x,
+        double y,
+        double z
+);
+void
+dxf_transform_soa_lines
+(
+        const DxfTransform *transform,
+        DxfSoaLines *lines
+);
+void
+dxf_transform_soa_points
+(
+        const DxfTransform *transform,
+        DxfSoaPoints *points
+);
+void
+dxf_transform_soa_faces
+(
+        const DxfTransform *transform,
+        DxfSoaFaces *faces
+);
+int
+dxf_drawing_transform
+(
+        DxfDrawing *drawing,
+        const DxfTransform *transform,
+        int workers
+);
+
+
+#endif /* LIBDXF_SRC_TRANSFORM_H */
+
+
+/* EOF */
@@ -32,7 +32,10 @@
  */
 
 
+#include <pthread.h>
 #include "ucs.h"
+#include "diag.h"
+#include "allocator.h"
 
 
 /*!
@@ -61,7 +64,7 @@ dxf_ucs_new ()
         size = sizeof (DxfUcs);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_ucs = malloc (size)) == NULL)
+        if ((dxf_ucs = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfUcs struct.\n")),
@@ -102,6 +105,11 @@ dxf_ucs_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfUcs template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         /* Do some basic checks. */
         if (dxf_ucs == NULL)
         {
@@ -117,21 +125,31 @@ dxf_ucs_init
                   __FUNCTION__);
                 return (NULL);
         }
-        dxf_ucs->id_code = 0;
-        dxf_ucs->UCS_name = strdup ("");
-        dxf_ucs->x_origin = 0.0;
-        dxf_ucs->y_origin = 0.0;
-        dxf_ucs->z_origin = 0.0;
-        dxf_ucs->x_X_dir = 0.0;
-        dxf_ucs->y_X_dir = 0.0;
-        dxf_ucs->z_X_dir = 0.0;
-        dxf_ucs->x_Y_dir = 0.0;
-        dxf_ucs->y_Y_dir = 0.0;
-        dxf_ucs->z_Y_dir = 0.0;
-        dxf_ucs->flag = 0;
-        dxf_ucs->dictionary_owner_soft = strdup ("");
-        dxf_ucs->dictionary_owner_hard = strdup ("");
-        dxf_ucs->next = NULL;
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.id_code = 0;
+                template.UCS_name = strdup ("");
+                template.x_origin = 0.0;
+                template.y_origin = 0.0;
+                template.z_origin = 0.0;
+                template.x_X_dir = 0.0;
+                template.y_X_dir = 0.0;
+                template.z_X_dir = 0.0;
+                template.x_Y_dir = 0.0;
+                template.y_Y_dir = 0.0;
+                template.z_Y_dir = 0.0;
+                template.flag = 0;
+                template.dictionary_owner_soft = strdup ("");
+                template.dictionary_owner_hard = strdup ("");
+                template.next = NULL;
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (dxf_ucs, &template, sizeof (DxfUcs));
+        dxf_ucs->UCS_name = strdup (template.UCS_name);
+        dxf_ucs->dictionary_owner_soft = strdup (template.dictionary_owner_soft);
+        dxf_ucs->dictionary_owner_hard = strdup (template.dictionary_owner_hard);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -168,7 +186,7 @@ dxf_ucs_read
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        char *temp_string = NULL;
+        char temp_string[DXF_MAX_STRING_LENGTH];
 
         /* Do some basic checks. */
         if (fp == NULL)
@@ -193,7 +211,7 @@ dxf_ucs_read
                 if (ferror (fp->fp))
                 {
                         fprintf (stderr,
-                          (_("Error in %s () while reading from: %s in line: %d.\n")),
+                          (_("Error in %s () while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                         fclose (fp->fp);
                         return (NULL);
@@ -210,7 +228,9 @@ dxf_ucs_read
                         /* Now follows a string containing an UCS
                          * name. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_ucs->UCS_name);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_ucs->UCS_name);
+                        dxf_ucs->UCS_name = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "10") == 0)
                 {
@@ -298,8 +318,8 @@ dxf_ucs_read
                         if ((strcmp (temp_string, "AcDbSymbolTableRecord") != 0)
                         && ((strcmp (temp_string, "AcDbUCSTableRecord") != 0)))
                         {
-                                fprintf (stderr,
-                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %d.\n")),
+                                dxf_diag_report (fp, DXF_DIAG_WARNING,
+                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                         }
                 }
@@ -308,14 +328,18 @@ dxf_ucs_read
                         /* Now follows a string containing Soft-pointer
                          * ID/handle to owner dictionary. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_ucs->dictionary_owner_soft);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_ucs->dictionary_owner_soft);
+                        dxf_ucs->dictionary_owner_soft = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "360") == 0)
                 {
                         /* Now follows a string containing Hard owner
                          * ID/handle to owner dictionary. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_ucs->dictionary_owner_hard);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_ucs->dictionary_owner_hard);
+                        dxf_ucs->dictionary_owner_hard = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "999") == 0)
                 {
@@ -326,8 +350,8 @@ dxf_ucs_read
                 }
                 else
                 {
-                        fprintf (stderr,
-                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %d.\n")),
+                        dxf_diag_report (fp, DXF_DIAG_WARNING,
+                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                 }
         }
@@ -477,7 +501,7 @@ dxf_ucs_free
         free (dxf_ucs->UCS_name);
         free (dxf_ucs->dictionary_owner_soft);
         free (dxf_ucs->dictionary_owner_hard);
-        free (dxf_ucs);
+        dxf_entity_dealloc (dxf_ucs, sizeof (*dxf_ucs));
         dxf_ucs = NULL;
 #if DEBUG
         DXF_DEBUG_END
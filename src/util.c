@@ -33,7 +33,14 @@
 
 
 #include <stdarg.h>
+#include <pthread.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <zlib.h>
 #include "util.h"
+#include "config.h"
+#include "profile.h"
+#include "writer.h"
 
 
 int
@@ -65,58 +72,2270 @@ dxf_read_is_string (int type)
                 return FALSE;
 }
 
+/*!
+ * Exact powers of ten up to the range a 53 bit mantissa times a power
+ * of ten stays exactly representable in.
+ */
+static const double dxf_parse_powers_of_ten[23] =
+{
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+        1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20,
+        1e21, 1e22
+};
+
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define DXF_PARSE_SWAR 1
+#endif
+
+#ifdef DXF_PARSE_SWAR
+/*!
+ * \brief Test whether eight loaded bytes are all decimal digits
+ * (SWAR).
+ */
+static int
+dxf_parse_swar_is_digits
+(
+        uint64_t chunk
+                /*!< eight input bytes, first byte lowest. */
+)
+{
+        return (((chunk & UINT64_C (0xf0f0f0f0f0f0f0f0))
+                        == UINT64_C (0x3030303030303030))
+                && (((chunk + UINT64_C (0x0606060606060606))
+                        & UINT64_C (0xf0f0f0f0f0f0f0f0))
+                        == UINT64_C (0x3030303030303030)));
+}
+
+
+/*!
+ * \brief Convert eight digit bytes to their value (SWAR).
+ *
+ * Three multiplies merge neighbouring digits into pairs, the pairs
+ * into quads and the quads into the eight digit value, instead of
+ * eight multiply-add steps.
+ */
+static uint32_t
+dxf_parse_swar_value
+(
+        uint64_t chunk
+                /*!< eight digit bytes, first digit lowest. */
+)
+{
+        chunk -= UINT64_C (0x3030303030303030);
+        chunk = (chunk * 10) + (chunk >> 8);
+        chunk = ((chunk & UINT64_C (0x000000ff000000ff))
+                        * (UINT64_C (100) + (UINT64_C (1000000) << 32))
+                + (((chunk >> 16) & UINT64_C (0x000000ff000000ff))
+                        * (UINT64_C (1) + (UINT64_C (10000) << 32)))) >> 32;
+        return ((uint32_t) chunk);
+}
+
+
+/*!
+ * \brief Consume a run of digits eight at a time (SWAR).
+ *
+ * The DXF coordinate profile is a fixed decimal with 6 to 15
+ * significant digits, so most values contain at least one full eight
+ * digit chunk.\n
+ * A chunk is only loaded when it does not cross a page boundary, so
+ * the eight byte read cannot fault even right before the terminator
+ * of a memory mapped line; a chunk containing the terminator or any
+ * non-digit fails the digit test and is left to the byte-wise loop.
+ */
+static void
+dxf_parse_swar_digits
+(
+        const char **s,
+                /*!< position within the value line; advanced past the
+                 * consumed chunks. */
+        uint64_t *mantissa,
+                /*!< the mantissa accumulator. */
+        int *digits
+                /*!< the consumed digit count. */
+)
+{
+        uint64_t chunk;
+
+        for (;;)
+        {
+                if ((*digits + 8 > 19)
+                        || ((((uintptr_t) *s) & 4095) > (4096 - 8)))
+                {
+                        return;
+                }
+                memcpy (&chunk, *s, 8);
+                if (!dxf_parse_swar_is_digits (chunk))
+                {
+                        return;
+                }
+                *mantissa = *mantissa * UINT64_C (100000000)
+                        + dxf_parse_swar_value (chunk);
+                *digits += 8;
+                *s += 8;
+        }
+}
+#endif /* DXF_PARSE_SWAR */
+
+
+/*!
+ * \brief Parse a decimal floating point value line.
+ *
+ * The tuned fast path for the values DXF files actually contain:
+ * digits accumulate in an integer — eight at a time with SWAR chunk
+ * handling on little-endian targets — and one exact power-of-ten
+ * multiply produces the correctly rounded result, without locale
+ * lookups or the errno dance of \c strtod.\n
+ * Values outside the exactly representable range, and any unusual
+ * spelling, fall back to \c strtod and parse identically.
+ *
+ * \return the parsed value.
+ */
+double
+dxf_parse_double
+(
+        const char *string
+                /*!< the value line to parse. */
+)
+{
+        const char *s;
+        uint64_t mantissa;
+        int digits;
+        int fraction;
+        int exponent;
+        int negative;
+
+        s = string;
+        while ((*s == ' ') || (*s == '\t'))
+        {
+                s++;
+        }
+        negative = (*s == '-');
+        if ((*s == '-') || (*s == '+'))
+        {
+                s++;
+        }
+        mantissa = 0;
+        digits = 0;
+        fraction = 0;
+        exponent = 0;
+#ifdef DXF_PARSE_SWAR
+        dxf_parse_swar_digits (&s, &mantissa, &digits);
+#endif
+        while ((*s >= '0') && (*s <= '9'))
+        {
+                if (digits >= 19)
+                {
+                        /* the mantissa no longer fits an integer. */
+                        return (strtod (string, NULL));
+                }
+                mantissa = mantissa * 10 + (uint64_t) (*s - '0');
+                digits++;
+                s++;
+        }
+        if (*s == '.')
+        {
+                s++;
+#ifdef DXF_PARSE_SWAR
+                fraction = digits;
+                dxf_parse_swar_digits (&s, &mantissa, &digits);
+                fraction = digits - fraction;
+#endif
+                while ((*s >= '0') && (*s <= '9'))
+                {
+                        if (digits >= 19)
+                        {
+                                return (strtod (string, NULL));
+                        }
+                        mantissa = mantissa * 10 + (uint64_t) (*s - '0');
+                        digits++;
+                        fraction++;
+                        s++;
+                }
+        }
+        if (digits == 0)
+        {
+                return (strtod (string, NULL));
+        }
+        if ((*s == 'e') || (*s == 'E'))
+        {
+                int exponent_negative;
+                int value;
+
+                s++;
+                exponent_negative = (*s == '-');
+                if ((*s == '-') || (*s == '+'))
+                {
+                        s++;
+                }
+                if ((*s < '0') || (*s > '9'))
+                {
+                        return (strtod (string, NULL));
+                }
+                value = 0;
+                while ((*s >= '0') && (*s <= '9') && (value < 10000))
+                {
+                        value = value * 10 + (*s - '0');
+                        s++;
+                }
+                exponent = exponent_negative ? -value : value;
+        }
+        while ((*s == ' ') || (*s == '\t') || (*s == '\r'))
+        {
+                s++;
+        }
+        if (*s != '\0')
+        {
+                return (strtod (string, NULL));
+        }
+        exponent -= fraction;
+        if ((mantissa > (UINT64_C (1) << 53))
+                || (exponent < -22) || (exponent > 22))
+        {
+                /* not exactly representable: one rounding per scale
+                 * step would accumulate error. */
+                return (strtod (string, NULL));
+        }
+        if (exponent >= 0)
+        {
+                return (negative
+                        ? -((double) mantissa * dxf_parse_powers_of_ten[exponent])
+                        : ((double) mantissa * dxf_parse_powers_of_ten[exponent]));
+        }
+        return (negative
+                ? -((double) mantissa / dxf_parse_powers_of_ten[-exponent])
+                : ((double) mantissa / dxf_parse_powers_of_ten[-exponent]));
+}
+
+
+/*!
+ * \brief Parse a decimal integer value line.
+ *
+ * The tuned fast path next to \c dxf_parse_double; out-of-range
+ * values and unusual spellings fall back to \c strtol and parse
+ * identically.
+ *
+ * \return the parsed value.
+ */
+long
+dxf_parse_long
+(
+        const char *string
+                /*!< the value line to parse. */
+)
+{
+        const char *s;
+        unsigned long value;
+        int digits;
+        int negative;
+
+        s = string;
+        while ((*s == ' ') || (*s == '\t'))
+        {
+                s++;
+        }
+        negative = (*s == '-');
+        if ((*s == '-') || (*s == '+'))
+        {
+                s++;
+        }
+        value = 0;
+        digits = 0;
+        while ((*s >= '0') && (*s <= '9'))
+        {
+                if (digits >= 18)
+                {
+                        /* near the range limit: let strtol clamp. */
+                        return (strtol (string, NULL, 10));
+                }
+                value = value * 10 + (unsigned long) (*s - '0');
+                digits++;
+                s++;
+        }
+        if (digits == 0)
+        {
+                return (strtol (string, NULL, 10));
+        }
+        while ((*s == ' ') || (*s == '\t') || (*s == '\r'))
+        {
+                s++;
+        }
+        if (*s != '\0')
+        {
+                return (strtol (string, NULL, 10));
+        }
+        return (negative ? -((long) value) : ((long) value));
+}
+
+
+static unsigned char dxf_hex_decode_table[256];
+static uint16_t dxf_hex_encode_table[256];
+static int dxf_hex_tables_ready = FALSE;
+
+
+/*!
+ * \brief Build the hex codec lookup tables.
+ */
+static void
+dxf_hex_tables_init ()
+{
+        static const char hex_digits[] = "0123456789ABCDEF";
+        uint16_t pair;
+        int i;
+
+        memset (dxf_hex_decode_table, 0xff, sizeof (dxf_hex_decode_table));
+        for (i = 0; i < 10; i++)
+        {
+                dxf_hex_decode_table['0' + i] = (unsigned char) i;
+        }
+        for (i = 0; i < 6; i++)
+        {
+                dxf_hex_decode_table['A' + i] = (unsigned char) (10 + i);
+                dxf_hex_decode_table['a' + i] = (unsigned char) (10 + i);
+        }
+        for (i = 0; i < 256; i++)
+        {
+                /* both digits of a byte in one 16 bit store, in memory
+                 * order. */
+                pair = (uint16_t) hex_digits[i & 0xf];
+                pair = (uint16_t) ((pair << 8) | (uint16_t) hex_digits[i >> 4]);
+                memcpy (&dxf_hex_encode_table[i], &pair, 2);
+        }
+        dxf_hex_tables_ready = TRUE;
+}
+
+
+/*!
+ * \brief Decode a hex string, as stored in group 310 binary chunk
+ * lines, into bytes.
+ *
+ * Both nibbles are translated through a 256 entry lookup table, so
+ * decoding costs two loads and a shift per byte instead of a branchy
+ * character classification.
+ *
+ * \return the number of decoded bytes, or \c -1 when \c hex has an odd
+ * length or contains a character which is not a hex digit.
+ */
+int
+dxf_hex_decode
+(
+        const char *hex,
+                /*!< the hex string to decode. */
+        unsigned char *bytes
+                /*!< destination buffer, at least half the string length
+                 * in size. */
+)
+{
+        unsigned char high;
+        unsigned char low;
+        int count;
+
+        if (!dxf_hex_tables_ready)
+        {
+                dxf_hex_tables_init ();
+        }
+        count = 0;
+        while (hex[0] != '\0')
+        {
+                high = dxf_hex_decode_table[(unsigned char) hex[0]];
+                if (hex[1] == '\0')
+                {
+                        return (-1);
+                }
+                low = dxf_hex_decode_table[(unsigned char) hex[1]];
+                if ((high | low) > 0xf)
+                {
+                        return (-1);
+                }
+                bytes[count++] = (unsigned char) ((high << 4) | low);
+                hex += 2;
+        }
+        return (count);
+}
+
+
+/*!
+ * \brief Encode bytes as the uppercase hex string of a group 310
+ * binary chunk line.
+ *
+ * Each byte is translated to both its digits with a single 16 bit
+ * table store.
+ *
+ * \return the number of characters written, excluding the terminating
+ * NUL.
+ */
+int
+dxf_hex_encode
+(
+        char *hex,
+                /*!< destination buffer, at least twice \c count plus
+                 * one byte in size; NUL terminated on return. */
+        const unsigned char *bytes,
+                /*!< the bytes to encode. */
+        int count
+                /*!< number of bytes to encode. */
+)
+{
+        int i;
+
+        if (!dxf_hex_tables_ready)
+        {
+                dxf_hex_tables_init ();
+        }
+        for (i = 0; i < count; i++)
+        {
+                memcpy (hex + (i * 2), &dxf_hex_encode_table[bytes[i]], 2);
+        }
+        hex[count * 2] = '\0';
+        return (count * 2);
+}
+
+
+/*!
+ * \brief One entry of the string interning pool.
+ */
+typedef struct
+dxf_intern_entry
+{
+        struct dxf_intern_entry *next;
+                /*!< pointer to the next entry in the same bucket. */
+        char string[1];
+                /*!< the interned string, allocated inline. */
+} DxfInternEntry;
+
+
+/*!
+ * The number of buckets in the string interning pool.
+ */
+#define DXF_INTERN_BUCKETS 4096
+
+
+static DxfInternEntry *dxf_intern_pool[DXF_INTERN_BUCKETS];
+
+/*!
+ * Bytes currently held by the string interning pool, entry headers
+ * included.
+ */
+static size_t dxf_intern_pool_bytes;
+
+
+/*!
+ * \brief Intern a string in the shared pool.
+ *
+ * Identical strings (layer names, linetype names, default strings)
+ * repeat across millions of entities; the pool stores every distinct
+ * string once and hands out a shared pointer, so equal strings compare
+ * equal by pointer and duplicate allocations are eliminated.\n
+ * Interned strings live until \c dxf_string_intern_free is called and
+ * shall never be passed to \c free, so interning is meant for batch
+ * reads where entities are not individually freed (such as arena
+ * backed reads, see \c dxf_read_set_arena).
+ *
+ * \return the shared copy of \c string, or \c NULL when no memory was
+ * allocated.
+ */
+char *
+dxf_string_intern
+(
+        const char *string
+                /*!< the string to intern. */
+)
+{
+        DxfInternEntry *entry;
+        uint32_t hash;
+        const char *s;
+        size_t length;
+
+        if (string == NULL)
+        {
+                return (NULL);
+        }
+        /* FNV-1a. */
+        hash = 2166136261u;
+        for (s = string; *s != '\0'; s++)
+        {
+                hash ^= (uint32_t) (unsigned char) *s;
+                hash *= 16777619u;
+        }
+        hash &= (DXF_INTERN_BUCKETS - 1);
+        for (entry = dxf_intern_pool[hash]; entry != NULL; entry = entry->next)
+        {
+                if (strcmp (entry->string, string) == 0)
+                {
+                        return (entry->string);
+                }
+        }
+        length = strlen (string);
+        entry = malloc (sizeof (DxfInternEntry) + length);
+        if (entry == NULL)
+        {
+                fprintf (stderr, "Error: could not allocate memory for an interned string.\n");
+                return (NULL);
+        }
+        memcpy (entry->string, string, length + 1);
+        entry->next = dxf_intern_pool[hash];
+        dxf_intern_pool[hash] = entry;
+        dxf_intern_pool_bytes += sizeof (DxfInternEntry) + length;
+        return (entry->string);
+}
+
+
+/*!
+ * \brief Release the string interning pool and every interned string.
+ */
+void
+dxf_string_intern_free ()
+{
+        DxfInternEntry *entry;
+        DxfInternEntry *next;
+        int i;
+
+        for (i = 0; i < DXF_INTERN_BUCKETS; i++)
+        {
+                entry = dxf_intern_pool[i];
+                while (entry != NULL)
+                {
+                        next = entry->next;
+                        free (entry);
+                        entry = next;
+                }
+                dxf_intern_pool[i] = NULL;
+        }
+        dxf_intern_pool_bytes = 0;
+}
+
+
+/*!
+ * \brief Report the bytes held by the string interning pool.
+ *
+ * \return the pool size in bytes, entry headers included.
+ */
+size_t
+dxf_string_intern_bytes ()
+{
+        return (dxf_intern_pool_bytes);
+}
+
+
+/*!
+ * \brief Parse a group code string into an integer.
+ *
+ * Parses the digits directly instead of going through a locale aware
+ * \c atoi / \c strtol call, as this runs once for every group code in
+ * the file.\n
+ * Leading blanks, as written by AutoCAD for right justified group
+ * codes, are skipped.
+ *
+ * \return the group code, or \c -9999 when \c temp_string does not
+ * start with a (possibly negative) number, so malformed tags fall
+ * through to the default branch of the callers dispatch switch.
+ */
+int
+dxf_read_group_code
+(
+        const char *temp_string
+                /*!< the group code line as read from the file. */
+)
+{
+        int code;
+        int sign;
+
+        code = 0;
+        sign = 1;
+        while ((*temp_string == ' ') || (*temp_string == '\t'))
+        {
+                temp_string++;
+        }
+        if (*temp_string == '-')
+        {
+                sign = -1;
+                temp_string++;
+        }
+        if ((*temp_string < '0') || (*temp_string > '9'))
+        {
+                return (-9999);
+        }
+        while ((*temp_string >= '0') && (*temp_string <= '9'))
+        {
+                code = (code * 10) + (*temp_string - '0');
+                temp_string++;
+        }
+        return (sign * code);
+}
+
+
+/*!
+ * The sentinel at the start of a binary DXF file.
+ */
+#define DXF_BINARY_SENTINEL "AutoCAD Binary DXF\r\n\032\0"
+
+
+/*!
+ * The length of the binary DXF sentinel in bytes, including the
+ * trailing NUL.
+ */
+#define DXF_BINARY_SENTINEL_LENGTH 22
+
+
+/*!
+ * \brief Read one byte of a \c DxfFile, inflating when the file is gzip
+ * compressed.
+ *
+ * \return the byte, or \c EOF on end of file.
+ */
+static int
+dxf_read_byte
+(
+        DxfFile *fp
+                /*!< DXF file pointer to an input file (or device). */
+)
+{
+        int byte;
+
+        if (fp->gzip != NULL)
+        {
+                return (gzgetc ((gzFile) fp->gzip));
+        }
+        byte = getc (fp->fp);
+        if (byte != EOF)
+        {
+                fp->bytes_consumed++;
+        }
+        return (byte);
+}
+
+
+/*!
+ * \brief Read a run of bytes of a \c DxfFile, inflating when the file
+ * is gzip compressed.
+ *
+ * \return the number of bytes read.
+ */
+static size_t
+dxf_read_bytes
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an input file (or device). */
+        void *buffer,
+                /*!< buffer receiving the bytes. */
+        size_t length
+                /*!< number of bytes to read. */
+)
+{
+        int nread;
+
+        if (fp->gzip != NULL)
+        {
+                nread = gzread ((gzFile) fp->gzip, buffer, (unsigned) length);
+                /* progress is tracked as the compressed offset, so it
+                 * compares against the file size. */
+                fp->bytes_consumed = (uint64_t) gzoffset ((gzFile) fp->gzip);
+                return ((nread < 0) ? 0 : (size_t) nread);
+        }
+        length = fread (buffer, 1, length, fp->fp);
+        fp->bytes_consumed += length;
+        DXF_PROFILE_COUNT_ADD (read_bytes, length);
+        return (length);
+}
+
+
+/*!
+ * \brief Rewind a \c DxfFile to its first byte, rewinding the zlib
+ * stream when the file is gzip compressed.
+ */
+static void
+dxf_read_rewind_bytes
+(
+        DxfFile *fp
+                /*!< DXF file pointer to an input file (or device). */
+)
+{
+        if (fp->gzip != NULL)
+        {
+                gzrewind ((gzFile) fp->gzip);
+                return;
+        }
+        rewind (fp->fp);
+        fp->bytes_consumed = 0;
+}
+
+
+/*!
+ * The number of consumed bytes between two progress callback
+ * invocations.
+ */
+#define DXF_READ_PROGRESS_GRANULARITY (1024 * 1024)
+
+
+/*!
+ * \brief Invoke the progress callback of a \c DxfFile when enough bytes
+ * were consumed since the last invocation.
+ */
+static void
+dxf_read_progress
+(
+        DxfFile *fp
+                /*!< DXF file pointer to an input file (or device). */
+)
+{
+        if ((fp->progress == NULL)
+                || (fp->bytes_consumed < fp->progress_next))
+        {
+                return;
+        }
+        fp->progress_next = fp->bytes_consumed
+                + DXF_READ_PROGRESS_GRANULARITY;
+        fp->progress (fp->bytes_consumed, fp->bytes_total,
+                fp->progress_user_data);
+}
+
+
+/*!
+ * \brief Detect whether a freshly opened \c DxfFile is gzip compressed.
+ *
+ * Gzip streams start with the two magic bytes 0x1f 0x8b; when they are
+ * found a zlib stream is opened on the file and block buffered reading
+ * is enabled, with the buffer refilled from the inflated stream.\n
+ * Decompression is thus pipelined with the block reader: no temporary
+ * file is written and no separate decompression pass runs ahead of the
+ * parse.\n
+ * When the magic bytes are not found the file position is rewound, so
+ * an uncompressed file passes through unread.
+ */
+static void
+dxf_read_detect_gzip
+(
+        DxfFile *fp
+                /*!< DXF file pointer to an input file (or device). */
+)
+{
+        unsigned char magic[2];
+        gzFile gz;
+
+        if (fread (magic, 1, 2, fp->fp) != 2)
+        {
+                rewind (fp->fp);
+                return;
+        }
+        rewind (fp->fp);
+        if ((magic[0] != 0x1f) || (magic[1] != 0x8b))
+        {
+                return;
+        }
+        gz = gzopen (fp->filename, "rb");
+        if (gz == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not open a zlib stream on: %s.\n")),
+                  __FUNCTION__, fp->filename);
+                return;
+        }
+        fp->gzip = gz;
+        dxf_read_buffer_init (fp, 0);
+}
+
+
+/*!
+ * \brief Detect whether a freshly opened \c DxfFile is a binary DXF
+ * file.
+ *
+ * Binary DXF files start with a 22 byte sentinel; when it is found the
+ * file is switched to binary reading and the group code size is
+ * determined from the bytes of the first group: R12 and earlier files
+ * store group codes in one byte (group 0 is followed directly by the
+ * section name), R13 and later files in two little endian bytes.\n
+ * When the sentinel is not found the file position is rewound, so an
+ * ASCII file passes through unread.\n
+ * A gzip compressed file is inspected through its inflated stream, so a
+ * compressed binary file is detected as well.
+ */
+static void
+dxf_read_detect_binary
+(
+        DxfFile *fp
+                /*!< DXF file pointer to an input file (or device). */
+)
+{
+        char sentinel[DXF_BINARY_SENTINEL_LENGTH];
+        int second;
+
+        if (dxf_read_bytes (fp, sentinel, DXF_BINARY_SENTINEL_LENGTH)
+                != DXF_BINARY_SENTINEL_LENGTH)
+        {
+                dxf_read_rewind_bytes (fp);
+                return;
+        }
+        if (memcmp (sentinel, DXF_BINARY_SENTINEL,
+                DXF_BINARY_SENTINEL_LENGTH) != 0)
+        {
+                dxf_read_rewind_bytes (fp);
+                return;
+        }
+        fp->binary = TRUE;
+        /* The first group of any DXF file is "0\nSECTION": with one
+         * byte codes the second byte is the 'S' of the section name,
+         * with two byte codes it is the high byte of group code 0. */
+        dxf_read_byte (fp);
+        second = dxf_read_byte (fp);
+        fp->binary_code_size = (second == 0) ? 2 : 1;
+        if (fp->gzip != NULL)
+        {
+                gzrewind ((gzFile) fp->gzip);
+                gzseek ((gzFile) fp->gzip, DXF_BINARY_SENTINEL_LENGTH,
+                        SEEK_SET);
+        }
+        else
+        {
+                fseek (fp->fp, DXF_BINARY_SENTINEL_LENGTH, SEEK_SET);
+        }
+}
+
+
+/*!
+ * \brief Read the next group code from a binary DXF file.
+ *
+ * \return the group code, or \c -1 on end of file.
+ */
+static int
+dxf_read_binary_code
+(
+        DxfFile *fp
+                /*!< DXF file pointer to an input file (or device). */
+)
+{
+        int low;
+        int high;
+
+        low = dxf_read_byte (fp);
+        if (low == EOF)
+        {
+                return (-1);
+        }
+        if (fp->binary_code_size == 2)
+        {
+                high = dxf_read_byte (fp);
+                if (high == EOF)
+                {
+                        return (-1);
+                }
+                return (low | (high << 8));
+        }
+        if (low == 255)
+        {
+                /* Escape for extended (two byte) group codes in one
+                 * byte coded files. */
+                low = dxf_read_byte (fp);
+                high = dxf_read_byte (fp);
+                if ((low == EOF) || (high == EOF))
+                {
+                        return (-1);
+                }
+                return (low | (high << 8));
+        }
+        return (low);
+}
+
+
+/*!
+ * \brief Make sure the line buffer of a \c DxfFile holds at least
+ * \c size bytes.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when no memory
+ * was allocated or the configured line length limit was exceeded (see
+ * \c DxfConfig).
+ */
+static int
+dxf_read_line_buffer_reserve
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an input file (or device). */
+        size_t size
+                /*!< required size in bytes. */
+)
+{
+        char *grown;
+        size_t grown_size;
+        size_t limit;
+
+        if (fp->line_buffer_size >= size)
+        {
+                return (EXIT_SUCCESS);
+        }
+        limit = dxf_config_get ()->max_string_length;
+        if ((limit != 0) && (size > limit))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () the configured line length limit was exceeded.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        grown_size = (fp->line_buffer_size == 0) ? 256 : fp->line_buffer_size;
+        while (grown_size < size)
+        {
+                grown_size *= 2;
+        }
+        grown = realloc (fp->line_buffer, grown_size);
+        if (grown == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        fp->line_buffer = grown;
+        fp->line_buffer_size = grown_size;
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Hand out the next line of a binary DXF file as text.
+ *
+ * Group code and value lines are synthesized alternately from the
+ * binary groups, formatted exactly as their ASCII counterparts, so the
+ * entity readers dispatch on the same strings for both file flavours
+ * and no separate binary dispatch tables are needed.\n
+ * The value is decoded by the group code range: strings are stored NUL
+ * terminated, doubles as 8 IEEE bytes, integers as 1, 2, 4 or 8 little
+ * endian bytes and group 310 ... 319 chunks as a length byte followed
+ * by raw bytes (re-encoded as the hex string the ASCII format uses).\n
+ * The returned pointer references the line buffer of the \c DxfFile and
+ * stays valid until the next call.
+ *
+ * \return a pointer to the line, or \c NULL on end of file.
+ */
+static char *
+dxf_read_binary_getline
+(
+        DxfFile *fp
+                /*!< DXF file pointer to an input file (or device). */
+)
+{
+        unsigned char bytes[8];
+        double double_value;
+        long long_value;
+        size_t used;
+        int code;
+        int byte;
+        int count;
+        int i;
+
+        if (fp->binary_pending_code < 0)
+        {
+                code = dxf_read_binary_code (fp);
+                if (code < 0)
+                {
+                        return (NULL);
+                }
+                if (dxf_read_line_buffer_reserve (fp, 8) == EXIT_FAILURE)
+                {
+                        return (NULL);
+                }
+                sprintf (fp->line_buffer, "%3d", code);
+                fp->binary_pending_code = code;
+                fp->line_number++;
+                return (fp->line_buffer);
+        }
+        code = fp->binary_pending_code;
+        fp->binary_pending_code = -1;
+        fp->line_number++;
+        if (((code >= 10) && (code <= 59))
+                || ((code >= 110) && (code <= 149))
+                || ((code >= 210) && (code <= 239))
+                || ((code >= 460) && (code <= 469))
+                || ((code >= 1010) && (code <= 1059)))
+        {
+                /* 8 byte IEEE double. */
+                if (dxf_read_bytes (fp, bytes, 8) != 8)
+                {
+                        return (NULL);
+                }
+                memcpy (&double_value, bytes, 8);
+                if (dxf_read_line_buffer_reserve (fp, 336) == EXIT_FAILURE)
+                {
+                        return (NULL);
+                }
+                dxf_ftoa (double_value, fp->line_buffer);
+                return (fp->line_buffer);
+        }
+        if (((code >= 60) && (code <= 79))
+                || ((code >= 170) && (code <= 179))
+                || ((code >= 270) && (code <= 279))
+                || ((code >= 400) && (code <= 409))
+                || ((code >= 1060) && (code <= 1070)))
+        {
+                /* 2 byte little endian integer. */
+                if (dxf_read_bytes (fp, bytes, 2) != 2)
+                {
+                        return (NULL);
+                }
+                long_value = (long) (int16_t) (bytes[0] | (bytes[1] << 8));
+        }
+        else if (((code >= 90) && (code <= 99))
+                || ((code >= 420) && (code <= 429))
+                || ((code >= 440) && (code <= 449))
+                || (code == 1071))
+        {
+                /* 4 byte little endian integer. */
+                if (dxf_read_bytes (fp, bytes, 4) != 4)
+                {
+                        return (NULL);
+                }
+                long_value = (long) (int32_t) ((uint32_t) bytes[0]
+                        | ((uint32_t) bytes[1] << 8)
+                        | ((uint32_t) bytes[2] << 16)
+                        | ((uint32_t) bytes[3] << 24));
+        }
+        else if (((code >= 160) && (code <= 169))
+                || ((code >= 450) && (code <= 459)))
+        {
+                /* 8 byte little endian integer. */
+                if (dxf_read_bytes (fp, bytes, 8) != 8)
+                {
+                        return (NULL);
+                }
+                long_value = 0;
+                for (i = 7; i >= 0; i--)
+                {
+                        long_value = (long_value << 8) | bytes[i];
+                }
+        }
+        else if (((code >= 280) && (code <= 299))
+                || ((code >= 370) && (code <= 389)))
+        {
+                /* 1 byte integer. */
+                byte = dxf_read_byte (fp);
+                if (byte == EOF)
+                {
+                        return (NULL);
+                }
+                long_value = byte;
+        }
+        else if ((code >= 310) && (code <= 319))
+        {
+                /* Binary chunk: a length byte followed by raw bytes,
+                 * re-encoded as the hex string of the ASCII format. */
+                count = dxf_read_byte (fp);
+                if (count == EOF)
+                {
+                        return (NULL);
+                }
+                if (dxf_read_line_buffer_reserve (fp, (size_t) (count * 2) + 1)
+                        == EXIT_FAILURE)
+                {
+                        return (NULL);
+                }
+                for (i = 0; i < count; i++)
+                {
+                        byte = dxf_read_byte (fp);
+                        if (byte == EOF)
+                        {
+                                return (NULL);
+                        }
+                        sprintf (fp->line_buffer + (i * 2), "%02X", byte);
+                }
+                fp->line_buffer[count * 2] = '\0';
+                return (fp->line_buffer);
+        }
+        else
+        {
+                /* NUL terminated string. */
+                used = 0;
+                for (;;)
+                {
+                        byte = dxf_read_byte (fp);
+                        if (byte == EOF)
+                        {
+                                return (NULL);
+                        }
+                        if (dxf_read_line_buffer_reserve (fp, used + 1)
+                                == EXIT_FAILURE)
+                        {
+                                return (NULL);
+                        }
+                        fp->line_buffer[used] = (char) byte;
+                        if (byte == 0)
+                        {
+                                break;
+                        }
+                        used++;
+                }
+                return (fp->line_buffer);
+        }
+        if (dxf_read_line_buffer_reserve (fp, 24) == EXIT_FAILURE)
+        {
+                return (NULL);
+        }
+        sprintf (fp->line_buffer, "%ld", long_value);
+        return (fp->line_buffer);
+}
+
+
+/*!
+ * The default number of blocks the read ahead thread keeps decoded
+ * ahead of the parser.
+ */
+#define DXF_READ_PREFETCH_RING_SIZE 4
+
+
+/*!
+ * The size, in bytes, of the window the read ahead thread advises ahead
+ * of the parse position of a memory mapped file.
+ */
+#define DXF_READ_PREFETCH_WINDOW (4 * 1024 * 1024)
+
+
+/*!
+ * \brief State of the background read ahead thread of a \c DxfFile.
+ *
+ * For block buffered reading the thread keeps a ring of blocks read
+ * (and inflated) ahead of the parser; for memory mapped reading it
+ * advises the kernel to page in a window ahead of the parse position.
+ */
+typedef struct
+dxf_read_prefetch
+{
+        pthread_t thread;
+                /*!< the background read ahead thread. */
+        pthread_mutex_t mutex;
+                /*!< protects the ring fields below. */
+        pthread_cond_t filled;
+                /*!< signalled when a block was added to the ring or the
+                 * end of the file was reached. */
+        pthread_cond_t drained;
+                /*!< signalled when a block was consumed from the ring. */
+        char **blocks;
+                /*!< the ring of block buffers. */
+        size_t *lengths;
+                /*!< number of bytes stored in each ring block. */
+        int ring_size;
+                /*!< number of blocks in the ring. */
+        int head;
+                /*!< index of the oldest filled block. */
+        int tail;
+                /*!< index of the next block to fill. */
+        int count;
+                /*!< number of filled blocks in the ring. */
+        size_t consumed;
+                /*!< number of bytes already consumed from the head
+                 * block. */
+        int eof;
+                /*!< nonzero when the thread reached the end of the
+                 * file. */
+        int shutdown;
+                /*!< nonzero when the thread shall exit. */
+} DxfReadPrefetch;
+
+
 /*!
  * \brief Opens a DxfFile, does error checking and resets the line number
  * counter.
- * 
+ *
  * Reset the line counting to 0.
- * 
+ *
+ * The first bytes of the file are inspected for the gzip magic bytes:
+ * when found, a zlib stream is opened and block buffered reading is
+ * enabled, so \c dxf_read_line, \c dxf_read_scanf and
+ * \c dxf_read_getline hand out lines from the inflated stream and
+ * decompression overlaps parsing without a temporary file.\n
+ * The (possibly inflated) stream is then inspected for the binary DXF
+ * sentinel: when found, the file is read as binary DXF and the same
+ * functions hand out lines synthesized from the binary groups.\n
+ * As with buffered and memory mapped reading, callers which mix these
+ * with raw \c fscanf calls on the \c FILE pointer shall not rely on
+ * compressed or binary files, as the raw calls would read the stored
+ * bytes directly.
+ */
+DxfFile *
+dxf_read_init (const char *filename)
+{
+        DxfFile * dxf_file = NULL;
+        struct stat sb;
+        FILE *fp;
+        if (!filename)
+        {
+                fprintf (stderr, "Error: filename is not initialised (NULL pointer).\n");
+                return (NULL);
+        }
+        if (strcmp (filename, "") == 0)
+        {
+                fprintf (stderr, "Error: filename contains an empty string.\n");
+                return (NULL);
+        }
+        fp = fopen (filename, "r");
+        if (!fp)
+        {
+                fprintf (stderr, "Error: could not open file: %s for reading (NULL pointer).\n",
+                        filename);
+                return (NULL);
+        }
+        dxf_file = malloc (sizeof(DxfFile));
+        dxf_file->fp = fp;
+        dxf_file->filename = strdup(filename);
+        dxf_file->line_number = 0;
+        dxf_file->bytes_consumed = 0;
+        dxf_file->bytes_total = 0;
+        if (fstat (fileno (fp), &sb) == 0)
+        {
+                dxf_file->bytes_total = (uint64_t) sb.st_size;
+        }
+        dxf_file->progress = NULL;
+        dxf_file->progress_user_data = NULL;
+        dxf_file->progress_next = 0;
+        dxf_file->binary = FALSE;
+        dxf_file->binary_code_size = 0;
+        dxf_file->binary_pending_code = -1;
+        dxf_file->gzip = NULL;
+        dxf_file->prefetch = NULL;
+        dxf_file->read_buffer = NULL;
+        dxf_file->read_buffer_size = 0;
+        dxf_file->read_buffer_pos = 0;
+        dxf_file->read_buffer_avail = 0;
+        dxf_file->line_buffer = NULL;
+        dxf_file->line_buffer_size = 0;
+        dxf_file->mmap_base = NULL;
+        dxf_file->mmap_size = 0;
+        dxf_file->mmap_pos = 0;
+        dxf_file->arena = NULL;
+        dxf_file->trusted = FALSE;
+        dxf_file->intern_strings = FALSE;
+        dxf_file->document = NULL;
+        dxf_file->handlers = NULL;
+        dxf_file->diag = NULL;
+        dxf_file->parse_filter = NULL;
+        dxf_file->writer = NULL;
+        dxf_file->write_version.acad_version_number = -1;
+        dxf_file->entity_dirty = FALSE;
+        dxf_read_detect_gzip (dxf_file);
+        dxf_read_detect_binary (dxf_file);
+        /*! \todo FIXME: dxf header and blocks need initialized ?
+        dxf_header_init (dxf_file->dxf_header);
+        dxf_block_init (dxf_file->dxf_block);
+        */
+        return dxf_file;
+}
+
+
+void
+dxf_read_close (DxfFile *dxf_file)
+{
+        /*! \todo FIXME: how to free other sub structures */
+        if (dxf_file != NULL)
+        {
+                if (dxf_file->prefetch != NULL)
+                {
+                        DxfReadPrefetch *prefetch;
+                        int i;
+
+                        prefetch = dxf_file->prefetch;
+                        pthread_mutex_lock (&prefetch->mutex);
+                        prefetch->shutdown = TRUE;
+                        pthread_cond_broadcast (&prefetch->drained);
+                        pthread_mutex_unlock (&prefetch->mutex);
+                        pthread_join (prefetch->thread, NULL);
+                        pthread_mutex_destroy (&prefetch->mutex);
+                        pthread_cond_destroy (&prefetch->filled);
+                        pthread_cond_destroy (&prefetch->drained);
+                        if (prefetch->blocks != NULL)
+                        {
+                                for (i = 0; i < prefetch->ring_size; i++)
+                                {
+                                        free (prefetch->blocks[i]);
+                                }
+                                free (prefetch->blocks);
+                        }
+                        free (prefetch->lengths);
+                        free (prefetch);
+                        dxf_file->prefetch = NULL;
+                }
+                if (dxf_file->gzip != NULL)
+                {
+                        gzclose ((gzFile) dxf_file->gzip);
+                }
+                fclose (dxf_file->fp);
+                free (dxf_file->filename);
+                free (dxf_file->read_buffer);
+                free (dxf_file->line_buffer);
+                if (dxf_file->mmap_base != NULL)
+                {
+                        munmap (dxf_file->mmap_base, dxf_file->mmap_size);
+                }
+                free (dxf_file);
+                dxf_file = NULL;
+        }
+}
+
+
+/*!
+ * \brief Attach a bump allocating arena to a \c DxfFile.
+ *
+ * With an arena attached, entities and strings created while reading
+ * the file are carved out of the arena blocks instead of being
+ * individually malloc'ed, and are all released in one
+ * \c dxf_arena_free call by the caller.\n
+ * The arena stays owned by the caller: \c dxf_read_close does not
+ * release it, so the parsed entity graph outlives the \c DxfFile.
+ */
+void
+dxf_read_set_arena
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an input file (or device). */
+        DxfArena *arena
+                /*!< DXF arena, or \c NULL to return to plain malloc. */
+)
+{
+        if (fp == NULL)
+        {
+                fprintf (stderr, "Error: file pointer is not initialised (NULL pointer).\n");
+                return;
+        }
+        fp->arena = arena;
+}
+
+
+/*!
+ * \brief Register a progress callback on a \c DxfFile.
+ *
+ * The callback is invoked about once per consumed megabyte with the
+ * number of bytes consumed so far and the total file size (0 when the
+ * size is unknown, as for pipes), so long running parses of very large
+ * files can be monitored and scheduled instead of looking hung.\n
+ * For compressed files the consumed count is the compressed offset, so
+ * it stays comparable to the total.
+ */
+void
+dxf_read_set_progress
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an input file (or device). */
+        void (*progress) (uint64_t bytes_consumed, uint64_t bytes_total, void *user_data),
+                /*!< the progress callback, or \c NULL to unregister. */
+        void *user_data
+                /*!< passed through to the callback. */
+)
+{
+        if (fp == NULL)
+        {
+                fprintf (stderr, "Error: file pointer is not initialised (NULL pointer).\n");
+                return;
+        }
+        fp->progress = progress;
+        fp->progress_user_data = user_data;
+        fp->progress_next = 0;
+}
+
+
+/*!
+ * \brief Switch a \c DxfFile to buffered block reading.
+ *
+ * The file is read in blocks of \c block_size bytes and lines are
+ * handed out as slices from the block buffer with a \c memchr based
+ * scanner, instead of issuing a \c fscanf call per line.\n
+ * Buffered reading only affects \c dxf_read_line and \c dxf_read_scanf;
+ * callers which mix these with raw \c fscanf calls on the \c FILE
+ * pointer shall not enable buffering, as the raw calls would miss the
+ * bytes already read into the block buffer.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_read_buffer_init
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an input file (or device). */
+        size_t block_size
+                /*!< block size in bytes, pass 0 for the default
+                 * \c DXF_READ_BUFFER_SIZE. */
+)
+{
+        if (fp == NULL)
+        {
+                fprintf (stderr, "Error: file pointer is not initialised (NULL pointer).\n");
+                return (EXIT_FAILURE);
+        }
+        if (block_size == 0)
+        {
+                block_size = DXF_READ_BUFFER_SIZE;
+        }
+        fp->read_buffer = malloc (block_size + 1);
+        if (fp->read_buffer == NULL)
+        {
+                fprintf (stderr, "Error: could not allocate a read buffer of %lu bytes.\n",
+                        (unsigned long) block_size);
+                return (EXIT_FAILURE);
+        }
+        fp->read_buffer_size = block_size;
+        fp->read_buffer_pos = 0;
+        fp->read_buffer_avail = 0;
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Switch a \c DxfFile to memory mapped, zero copy reading.
+ *
+ * Maps the whole file into memory with a private, sequentially advised
+ * mapping and hands out group codes and values as pointers into the
+ * mapped region, so entity readers can parse values in place without
+ * any intermediate copies.\n
+ * The mapping is private and writable so lines can be NUL-terminated
+ * in place; the file on disk is never modified.\n
+ * As with \c dxf_read_buffer_init, only \c dxf_read_line,
+ * \c dxf_read_scanf and \c dxf_read_getline honour the mapping, so
+ * callers which mix these with raw \c fscanf calls shall not enable
+ * this mode.\n
+ * Gzip compressed input is refused (a mapping would serve the raw
+ * compressed bytes); such files keep reading through the gzip aware
+ * block reader.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_read_mmap_init
+(
+        DxfFile *fp
+                /*!< DXF file pointer to an input file (or device). */
+)
+{
+        struct stat sb;
+        void *base;
+
+        if (fp == NULL)
+        {
+                fprintf (stderr, "Error: file pointer is not initialised (NULL pointer).\n");
+                return (EXIT_FAILURE);
+        }
+        if (fp->gzip != NULL)
+        {
+                /* a mapping would serve the raw compressed bytes;
+                 * gzip input has to keep reading through gzread (). */
+                fprintf (stderr, "Error: cannot map gzip compressed file: %s into memory.\n",
+                        fp->filename);
+                return (EXIT_FAILURE);
+        }
+        if (fstat (fileno (fp->fp), &sb) != 0)
+        {
+                fprintf (stderr, "Error: could not stat file: %s.\n",
+                        fp->filename);
+                return (EXIT_FAILURE);
+        }
+        if (sb.st_size == 0)
+        {
+                fprintf (stderr, "Error: file: %s is empty.\n",
+                        fp->filename);
+                return (EXIT_FAILURE);
+        }
+        base = mmap (NULL, (size_t) sb.st_size, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE, fileno (fp->fp), 0);
+        if (base == MAP_FAILED)
+        {
+                fprintf (stderr, "Error: could not map file: %s into memory.\n",
+                        fp->filename);
+                return (EXIT_FAILURE);
+        }
+#ifdef MADV_SEQUENTIAL
+        madvise (base, (size_t) sb.st_size, MADV_SEQUENTIAL);
+#endif
+        fp->mmap_base = (char *) base;
+        fp->mmap_size = (size_t) sb.st_size;
+        fp->mmap_pos = 0;
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Restore the line terminators of a raw byte range of the
+ * memory mapping.
+ *
+ * Lines already handed out by the line reader were NUL terminated in
+ * place in the mapping: a NUL overwrote either the newline or the
+ * carriage return before it.\n
+ * After restoring, the range holds the input bytes verbatim.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_read_repair_raw
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an input file (or device). */
+        size_t start,
+                /*!< offset of the first byte in the mapping. */
+        size_t end
+                /*!< offset just past the last byte. */
+)
+{
+        char *p;
+
+        if ((fp == NULL) || (fp->mmap_base == NULL)
+                || (end > fp->mmap_size) || (start > end))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        p = fp->mmap_base + start;
+        while ((p = memchr (p, '\0', end - (size_t) (p - fp->mmap_base))) != NULL)
+        {
+                *p = ((p + 1 < fp->mmap_base + end) && (p[1] == '\n')) ? '\r' : '\n';
+                p++;
+        }
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Copy a raw byte range of the memory mapping to a file.
+ *
+ * Lines already handed out by the line reader were NUL terminated in
+ * place in the mapping; the terminators are restored before the bytes
+ * are written, so pass-through output stays byte identical to the
+ * input.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_read_copy_raw
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an input file (or device). */
+        FILE *out,
+                /*!< the stream to copy to. */
+        size_t start,
+                /*!< offset of the first byte in the mapping. */
+        size_t end
+                /*!< offset just past the last byte. */
+)
+{
+        if (out == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (dxf_read_repair_raw (fp, start, end) != EXIT_SUCCESS)
+        {
+                return (EXIT_FAILURE);
+        }
+        if (fwrite (fp->mmap_base + start, 1, end - start, out)
+                != (end - start))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () while writing.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Main loop of the read ahead thread for block buffered reading.
+ *
+ * Reads (and inflates) blocks into the ring until it is full, the end
+ * of the file is reached or shutdown is requested; the parser consumes
+ * the blocks through \c dxf_read_fill_buffer.
+ */
+static void *
+dxf_read_prefetch_main
+(
+        void *arg
+                /*!< the \c DxfFile the thread reads ahead for. */
+)
+{
+        DxfFile *fp;
+        DxfReadPrefetch *prefetch;
+        size_t nread;
+        int slot;
+
+        fp = (DxfFile *) arg;
+        prefetch = fp->prefetch;
+        for (;;)
+        {
+                pthread_mutex_lock (&prefetch->mutex);
+                while ((prefetch->count == prefetch->ring_size)
+                        && (!prefetch->shutdown))
+                {
+                        pthread_cond_wait (&prefetch->drained, &prefetch->mutex);
+                }
+                if (prefetch->shutdown)
+                {
+                        pthread_mutex_unlock (&prefetch->mutex);
+                        break;
+                }
+                slot = prefetch->tail;
+                pthread_mutex_unlock (&prefetch->mutex);
+                nread = dxf_read_bytes (fp, prefetch->blocks[slot],
+                        fp->read_buffer_size);
+                pthread_mutex_lock (&prefetch->mutex);
+                if (nread == 0)
+                {
+                        prefetch->eof = TRUE;
+                        pthread_cond_signal (&prefetch->filled);
+                        pthread_mutex_unlock (&prefetch->mutex);
+                        break;
+                }
+                prefetch->lengths[slot] = nread;
+                prefetch->tail = (prefetch->tail + 1) % prefetch->ring_size;
+                prefetch->count++;
+                pthread_cond_signal (&prefetch->filled);
+                pthread_mutex_unlock (&prefetch->mutex);
+        }
+        return (NULL);
+}
+
+
+/*!
+ * \brief Main loop of the read ahead thread for memory mapped reading.
+ *
+ * Advises the kernel to page in a sliding window ahead of the parse
+ * position, so the page faults taken by the parser hit already resident
+ * pages.
+ */
+static void *
+dxf_read_prefetch_mmap_main
+(
+        void *arg
+                /*!< the \c DxfFile the thread reads ahead for. */
+)
+{
+        DxfFile *fp;
+        DxfReadPrefetch *prefetch;
+        struct timespec pause;
+        size_t advised;
+        size_t target;
+
+        fp = (DxfFile *) arg;
+        prefetch = fp->prefetch;
+        pause.tv_sec = 0;
+        pause.tv_nsec = 1000000;
+        advised = 0;
+        while (!prefetch->shutdown)
+        {
+                target = fp->mmap_pos + DXF_READ_PREFETCH_WINDOW;
+                if (target > fp->mmap_size)
+                {
+                        target = fp->mmap_size;
+                }
+                if (target > advised)
+                {
+#ifdef MADV_WILLNEED
+                        madvise (fp->mmap_base + advised, target - advised,
+                                MADV_WILLNEED);
+#endif
+                        advised = target;
+                }
+                if (advised >= fp->mmap_size)
+                {
+                        break;
+                }
+                nanosleep (&pause, NULL);
+        }
+        return (NULL);
+}
+
+
+/*!
+ * \brief Consume prefetched bytes from the ring of a \c DxfFile.
+ *
+ * Blocks only when the ring is empty, which means the parser outruns
+ * the file.
+ *
+ * \return the number of bytes copied to \c dest, 0 on end of file.
  */
-DxfFile *
-dxf_read_init (const char *filename)
+static size_t
+dxf_read_prefetch_take
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an input file (or device). */
+        char *dest,
+                /*!< buffer receiving the bytes. */
+        size_t space
+                /*!< free space in \c dest in bytes. */
+)
 {
-        DxfFile * dxf_file = NULL;
-        FILE *fp;
-        if (!filename)
+        DxfReadPrefetch *prefetch;
+        size_t remaining;
+        size_t take;
+
+        prefetch = fp->prefetch;
+        take = 0;
+        pthread_mutex_lock (&prefetch->mutex);
+        while ((prefetch->count == 0) && (!prefetch->eof))
         {
-                fprintf (stderr, "Error: filename is not initialised (NULL pointer).\n");
-                return (NULL);
+                pthread_cond_wait (&prefetch->filled, &prefetch->mutex);
         }
-        if (strcmp (filename, "") == 0)
+        if (prefetch->count > 0)
         {
-                fprintf (stderr, "Error: filename contains an empty string.\n");
-                return (NULL);
+                remaining = prefetch->lengths[prefetch->head]
+                        - prefetch->consumed;
+                take = (space < remaining) ? space : remaining;
+                memcpy (dest, prefetch->blocks[prefetch->head]
+                        + prefetch->consumed, take);
+                prefetch->consumed += take;
+                if (prefetch->consumed == prefetch->lengths[prefetch->head])
+                {
+                        prefetch->consumed = 0;
+                        prefetch->head = (prefetch->head + 1)
+                                % prefetch->ring_size;
+                        prefetch->count--;
+                        pthread_cond_signal (&prefetch->drained);
+                }
         }
-        fp = fopen (filename, "r");
-        if (!fp)
+        pthread_mutex_unlock (&prefetch->mutex);
+        return (take);
+}
+
+
+/*!
+ * \brief Start a background read ahead thread on a \c DxfFile.
+ *
+ * Mirrors the background output thread of the writer on the input side:
+ * for block buffered reading (enabled here when not yet active) the
+ * thread keeps \c ring_size blocks read, and for compressed files
+ * inflated, ahead of the parser, so the file reads overlap parsing
+ * instead of stalling it; for memory mapped reading the thread advises
+ * the kernel to page in a window ahead of the parse position.\n
+ * The thread is joined by \c dxf_read_close.\n
+ * Binary DXF files read through their own byte reader and do not
+ * combine with read ahead.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_read_prefetch_init
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an input file (or device). */
+        int ring_size
+                /*!< number of blocks to keep ahead, pass 0 for the
+                 * default \c DXF_READ_PREFETCH_RING_SIZE. */
+)
+{
+        DxfReadPrefetch *prefetch;
+        void *(*main_loop) (void *);
+        int i;
+
+        if (fp == NULL)
         {
-                fprintf (stderr, "Error: could not open file: %s for reading (NULL pointer).\n",
-                        filename);
-                return (NULL);
+                fprintf (stderr, "Error: file pointer is not initialised (NULL pointer).\n");
+                return (EXIT_FAILURE);
         }
-        dxf_file = malloc (sizeof(DxfFile));
-        dxf_file->fp = fp;
-        dxf_file->filename = strdup(filename);
-        dxf_file->line_number = 0;
-        /*! \todo FIXME: dxf header and blocks need initialized ?
-        dxf_header_init (dxf_file->dxf_header);
-        dxf_block_init (dxf_file->dxf_block);
-        */
-        return dxf_file;
+        if (fp->prefetch != NULL)
+        {
+                return (EXIT_SUCCESS);
+        }
+        if (fp->binary)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () binary DXF files do not combine with read ahead.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (ring_size <= 0)
+        {
+                ring_size = DXF_READ_PREFETCH_RING_SIZE;
+        }
+        if ((fp->mmap_base == NULL) && (fp->read_buffer == NULL))
+        {
+                if (dxf_read_buffer_init (fp, 0) != EXIT_SUCCESS)
+                {
+                        return (EXIT_FAILURE);
+                }
+        }
+        prefetch = malloc (sizeof (DxfReadPrefetch));
+        if (prefetch == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        prefetch->blocks = NULL;
+        prefetch->lengths = NULL;
+        prefetch->ring_size = ring_size;
+        prefetch->head = 0;
+        prefetch->tail = 0;
+        prefetch->count = 0;
+        prefetch->consumed = 0;
+        prefetch->eof = FALSE;
+        prefetch->shutdown = FALSE;
+        if (fp->mmap_base != NULL)
+        {
+                main_loop = dxf_read_prefetch_mmap_main;
+        }
+        else
+        {
+                main_loop = dxf_read_prefetch_main;
+                prefetch->blocks = malloc (ring_size * sizeof (char *));
+                prefetch->lengths = malloc (ring_size * sizeof (size_t));
+                if ((prefetch->blocks == NULL) || (prefetch->lengths == NULL))
+                {
+                        fprintf (stderr,
+                          (_("Error in %s () could not allocate memory.\n")),
+                          __FUNCTION__);
+                        free (prefetch->blocks);
+                        free (prefetch->lengths);
+                        free (prefetch);
+                        return (EXIT_FAILURE);
+                }
+                for (i = 0; i < ring_size; i++)
+                {
+                        prefetch->blocks[i] = malloc (fp->read_buffer_size);
+                        if (prefetch->blocks[i] == NULL)
+                        {
+                                fprintf (stderr,
+                                  (_("Error in %s () could not allocate memory for a ring block.\n")),
+                                  __FUNCTION__);
+                                while (--i >= 0)
+                                {
+                                        free (prefetch->blocks[i]);
+                                }
+                                free (prefetch->blocks);
+                                free (prefetch->lengths);
+                                free (prefetch);
+                                return (EXIT_FAILURE);
+                        }
+                }
+        }
+        pthread_mutex_init (&prefetch->mutex, NULL);
+        pthread_cond_init (&prefetch->filled, NULL);
+        pthread_cond_init (&prefetch->drained, NULL);
+        fp->prefetch = prefetch;
+        if (pthread_create (&prefetch->thread, NULL, main_loop, fp) != 0)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not start the read ahead thread.\n")),
+                  __FUNCTION__);
+                fp->prefetch = NULL;
+                pthread_mutex_destroy (&prefetch->mutex);
+                pthread_cond_destroy (&prefetch->filled);
+                pthread_cond_destroy (&prefetch->drained);
+                if (prefetch->blocks != NULL)
+                {
+                        for (i = 0; i < ring_size; i++)
+                        {
+                                free (prefetch->blocks[i]);
+                        }
+                        free (prefetch->blocks);
+                }
+                free (prefetch->lengths);
+                free (prefetch);
+                return (EXIT_FAILURE);
+        }
+        return (EXIT_SUCCESS);
 }
 
 
-void
-dxf_read_close (DxfFile *dxf_file)
+/*!
+ * \brief Refill the block buffer of a \c DxfFile.
+ *
+ * Moves the unread tail of the buffer to the front and reads the next
+ * block from the file behind it.
+ *
+ * \return the number of bytes added to the buffer, 0 on end of file.
+ */
+static size_t
+dxf_read_fill_buffer
+(
+        DxfFile *fp
+                /*!< DXF file pointer to an input file (or device). */
+)
 {
-        /*! \todo FIXME: how to free other sub structures */
-        if (dxf_file != NULL)
+        size_t tail;
+        size_t nread;
+
+        tail = fp->read_buffer_avail - fp->read_buffer_pos;
+        if (tail > 0)
         {
-                fclose (dxf_file->fp);
-                free (dxf_file->filename);
-                free (dxf_file);
-                dxf_file = NULL;
+                memmove (fp->read_buffer, fp->read_buffer + fp->read_buffer_pos, tail);
+        }
+        fp->read_buffer_pos = 0;
+        fp->read_buffer_avail = tail;
+        if (fp->prefetch != NULL)
+        {
+                nread = dxf_read_prefetch_take (fp, fp->read_buffer + tail,
+                        fp->read_buffer_size - tail);
+        }
+        else
+        {
+                nread = dxf_read_bytes (fp, fp->read_buffer + tail,
+                        fp->read_buffer_size - tail);
+        }
+        fp->read_buffer_avail += nread;
+        dxf_read_progress (fp);
+        return (nread);
+}
+
+
+/*!
+ * \brief Skip the remainder of the current entity without tokenizing
+ * its fields.
+ *
+ * Searches forward for the next record boundary, a newline followed by
+ * a "  0" group code line, directly in the block buffer or memory
+ * mapping, so unwanted entities (large 3DSOLID blobs and the like) cost
+ * a byte scan instead of a full parse.\n
+ * On return the "  0" group code line is consumed, as if the entity
+ * had been read by one of the \c *_read functions; the next line in
+ * the file is the name of the following entity (or \c ENDSEC).\n
+ * Falls back to a line based loop when reading unbuffered through
+ * stdio.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE on end of
+ * file.
+ */
+int
+dxf_read_skip_entity
+(
+        DxfFile *fp
+                /*!< DXF file pointer to an input file (or device). */
+)
+{
+        char temp_string[DXF_MAX_STRING_LENGTH];
+        char *base;
+        char *eol;
+        size_t pos;
+        size_t avail;
+
+        if (fp == NULL)
+        {
+                fprintf (stderr, "Error: file pointer is not initialised (NULL pointer).\n");
+                return (EXIT_FAILURE);
+        }
+        if (fp->mmap_base != NULL)
+        {
+                base = fp->mmap_base;
+                pos = fp->mmap_pos;
+                avail = fp->mmap_size;
+                while ((eol = memchr (base + pos, '\n', avail - pos)) != NULL)
+                {
+                        fp->line_number++;
+                        pos = (size_t) (eol - base) + 1;
+                        if ((avail - pos >= 4)
+                                && (memcmp (base + pos, "  0\n", 4) == 0))
+                        {
+                                fp->line_number++;
+                                fp->mmap_pos = pos + 4;
+                                return (EXIT_SUCCESS);
+                        }
+                }
+                fp->mmap_pos = avail;
+                return (EXIT_FAILURE);
+        }
+        if (fp->read_buffer != NULL)
+        {
+                for (;;)
+                {
+                        base = fp->read_buffer;
+                        pos = fp->read_buffer_pos;
+                        avail = fp->read_buffer_avail;
+                        while ((eol = memchr (base + pos, '\n', avail - pos)) != NULL)
+                        {
+                                pos = (size_t) (eol - base) + 1;
+                                if (avail - pos < 4)
+                                {
+                                        /* the "  0" line may straddle
+                                         * the block boundary: refill
+                                         * before deciding. */
+                                        break;
+                                }
+                                fp->line_number++;
+                                if (memcmp (base + pos, "  0\n", 4) == 0)
+                                {
+                                        fp->line_number++;
+                                        fp->read_buffer_pos = pos + 4;
+                                        return (EXIT_SUCCESS);
+                                }
+                                fp->read_buffer_pos = pos;
+                        }
+                        if (dxf_read_fill_buffer (fp) == 0)
+                        {
+                                fp->read_buffer_pos = fp->read_buffer_avail;
+                                return (EXIT_FAILURE);
+                        }
+                }
+        }
+        /* Unbuffered: consume lines until the next "0" group code. */
+        do
+        {
+                if (dxf_read_line (temp_string, fp) < 1)
+                {
+                        return (EXIT_FAILURE);
+                }
+        }
+        while (strcmp (temp_string, "0") != 0);
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Skip the remainder of the current section without tokenizing
+ * its records.
+ *
+ * Searches forward for the \c ENDSEC marker directly in the memory
+ * mapping, so a section a parse filter rejects wholesale (see
+ * \c DxfParseFilter) costs a byte scan instead of a record loop.\n
+ * On return the \c ENDSEC line is consumed; the next line in the file
+ * is the "  0" group code ahead of the following \c SECTION (or
+ * \c EOF) marker.\n
+ * Falls back to a line based loop when the input is not mapped.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE on end of
+ * file.
+ */
+int
+dxf_read_skip_section
+(
+        DxfFile *fp
+                /*!< DXF file pointer to an input file (or device). */
+)
+{
+        char temp_string[DXF_MAX_STRING_LENGTH];
+        char *base;
+        char *eol;
+        size_t pos;
+        size_t avail;
+        size_t length;
+
+        if (fp == NULL)
+        {
+                fprintf (stderr, "Error: file pointer is not initialised (NULL pointer).\n");
+                return (EXIT_FAILURE);
+        }
+        if (fp->mmap_base != NULL)
+        {
+                base = fp->mmap_base;
+                pos = fp->mmap_pos;
+                avail = fp->mmap_size;
+                while ((pos < avail)
+                        && ((eol = memchr (base + pos, '\n', avail - pos)) != NULL))
+                {
+                        fp->line_number++;
+                        length = (size_t) (eol - (base + pos));
+                        if ((length > 0) && (base[pos + length - 1] == '\r'))
+                        {
+                                length--;
+                        }
+                        if ((length == 6)
+                                && (memcmp (base + pos, "ENDSEC", 6) == 0))
+                        {
+                                fp->mmap_pos = (size_t) (eol - base) + 1;
+                                return (EXIT_SUCCESS);
+                        }
+                        pos = (size_t) (eol - base) + 1;
+                }
+                fp->mmap_pos = avail;
+                return (EXIT_FAILURE);
+        }
+        /* Buffered or unbuffered: consume lines until ENDSEC. */
+        for (;;)
+        {
+                if (dxf_read_line (temp_string, fp) < 1)
+                {
+                        return (EXIT_FAILURE);
+                }
+                if (strcmp (temp_string, "ENDSEC") == 0)
+                {
+                        return (EXIT_SUCCESS);
+                }
+        }
+}
+
+
+/*!
+ * \brief Peek the group 8 layer of the current entity record without
+ * consuming it.
+ *
+ * Scans the code/value line pairs of the record directly in the
+ * memory mapping, up to the "  0" group code ending the record, and
+ * copies the value of the first group 8 into \c layer — no field is
+ * tokenized and the read position does not move, so a parse filter
+ * (see \c DxfParseFilter) can test the layer before deciding whether
+ * the record is parsed or skipped.
+ *
+ * \return \c EXIT_SUCCESS with \c layer filled when the record carries
+ * a group 8, or \c EXIT_FAILURE when it does not or the input is not
+ * mapped.
+ */
+int
+dxf_read_peek_layer
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an input file (or device). */
+        char *layer
+                /*!< receives the layer name; at least
+                 * \c DXF_MAX_STRING_LENGTH bytes. */
+)
+{
+        char *base;
+        char *line;
+        char *eol;
+        size_t pos;
+        size_t avail;
+        size_t length;
+        int is_code;
+        int want_value;
+
+        if ((fp == NULL) || (layer == NULL))
+        {
+                fprintf (stderr, "Error: file pointer is not initialised (NULL pointer).\n");
+                return (EXIT_FAILURE);
+        }
+        if (fp->mmap_base == NULL)
+        {
+                return (EXIT_FAILURE);
+        }
+        base = fp->mmap_base;
+        pos = fp->mmap_pos;
+        avail = fp->mmap_size;
+        is_code = TRUE;
+        want_value = FALSE;
+        while ((pos < avail)
+                && ((eol = memchr (base + pos, '\n', avail - pos)) != NULL))
+        {
+                line = base + pos;
+                length = (size_t) (eol - line);
+                if ((length > 0) && (line[length - 1] == '\r'))
+                {
+                        length--;
+                }
+                if (is_code)
+                {
+                        /* trim the leading blanks of the group code. */
+                        while ((length > 0)
+                                && ((*line == ' ') || (*line == '\t')))
+                        {
+                                line++;
+                                length--;
+                        }
+                        if ((length == 1) && (*line == '0'))
+                        {
+                                /* the record boundary: no group 8. */
+                                return (EXIT_FAILURE);
+                        }
+                        want_value = ((length == 1) && (*line == '8'));
+                }
+                else if (want_value)
+                {
+                        if (length >= DXF_MAX_STRING_LENGTH)
+                        {
+                                length = DXF_MAX_STRING_LENGTH - 1;
+                        }
+                        memcpy (layer, line, length);
+                        layer[length] = '\0';
+                        return (EXIT_SUCCESS);
+                }
+                is_code = !is_code;
+                pos = (size_t) (eol - base) + 1;
         }
+        return (EXIT_FAILURE);
+}
+
+
+/*!
+ * \brief Read the next line from the block buffer of a \c DxfFile.
+ *
+ * Scans for the next newline with \c memchr, NUL-terminates the line
+ * in place (stripping a trailing carriage return) and returns a
+ * pointer to the slice inside the block buffer.\n
+ * The slice stays valid until the next call for this \c DxfFile.
+ *
+ * \return a pointer to the line, or \c NULL on end of file.
+ */
+char *
+dxf_read_getline
+(
+        DxfFile *fp
+                /*!< DXF file pointer to an input file (or device). */
+)
+{
+        char *line;
+        char *eol;
+        size_t tail;
+
+        if (fp->binary)
+        {
+                return (dxf_read_binary_getline (fp));
+        }
+        if (fp->mmap_base != NULL)
+        {
+                if (fp->mmap_pos >= fp->mmap_size)
+                {
+                        return (NULL);
+                }
+                line = fp->mmap_base + fp->mmap_pos;
+                tail = fp->mmap_size - fp->mmap_pos;
+                eol = memchr (line, '\n', tail);
+                if (eol != NULL)
+                {
+                        fp->mmap_pos += (size_t) (eol - line) + 1;
+                }
+                else
+                {
+                        /* Unterminated last line: the private mapping
+                         * is rounded up to a whole page, so unless the
+                         * file size is an exact multiple of the page
+                         * size the terminating NUL can be written just
+                         * past the file contents. */
+                        eol = line + tail;
+                        fp->mmap_pos = fp->mmap_size;
+                        if ((fp->mmap_size % (size_t) sysconf (_SC_PAGESIZE)) == 0)
+                        {
+                                /* No room for the NUL: sacrifice the
+                                 * last byte of the unterminated line. */
+                                eol--;
+                        }
+                }
+                if ((eol > line) && (*(eol - 1) == '\r'))
+                {
+                        eol--;
+                }
+                *eol = '\0';
+                fp->line_number++;
+                fp->bytes_consumed = fp->mmap_pos;
+                dxf_read_progress (fp);
+                return (line);
+        }
+        for (;;)
+        {
+                line = fp->read_buffer + fp->read_buffer_pos;
+                tail = fp->read_buffer_avail - fp->read_buffer_pos;
+                eol = memchr (line, '\n', tail);
+                if (eol != NULL)
+                {
+                        fp->read_buffer_pos += (size_t) (eol - line) + 1;
+                        break;
+                }
+                if (dxf_read_fill_buffer (fp) == 0)
+                {
+                        /* End of file: hand out a remaining unterminated
+                         * line, if any. */
+                        if (fp->read_buffer_avail == 0)
+                        {
+                                return (NULL);
+                        }
+                        line = fp->read_buffer;
+                        eol = line + fp->read_buffer_avail;
+                        fp->read_buffer_pos = fp->read_buffer_avail;
+                        break;
+                }
+        }
+        if ((eol > line) && (*(eol - 1) == '\r'))
+        {
+                eol--;
+        }
+        *eol = '\0';
+        fp->line_number++;
+        return (line);
 }
 
 
@@ -129,59 +2348,326 @@ dxf_read_close (DxfFile *dxf_file)
 int
 dxf_read_line (char * temp_string, DxfFile *fp)
 {
-        int ret;
+        char *line;
+        char *start;
+        size_t length;
 
-        ret = fscanf (fp->fp, "%[^\n]\n", temp_string);
-        if (ferror (fp->fp))
+        /* The historic fscanf ("%[^\n]\n") implementation silently
+         * swallowed blank lines and leading blanks with the trailing
+         * "\n" whitespace directive; keep those semantics in all three
+         * input modes so group codes always compare without padding. */
+        for (;;)
         {
-                fprintf (stderr, "Error: while reading from: %s in line: %d.\n",
-                        fp->filename, fp->line_number);
-                return (EXIT_FAILURE);
+                if (fp->binary || (fp->read_buffer != NULL)
+                        || (fp->mmap_base != NULL))
+                {
+                        line = dxf_read_getline (fp);
+                        if (line == NULL)
+                        {
+                                temp_string[0] = '\0';
+                                return (EOF);
+                        }
+                }
+                else
+                {
+                        if (fgets (temp_string, DXF_MAX_STRING_LENGTH, fp->fp) == NULL)
+                        {
+                                if (ferror (fp->fp))
+                                {
+                                        fprintf (stderr, "Error: while reading from: %s in line: %ld.\n",
+                                                fp->filename, fp->line_number);
+                                }
+                                temp_string[0] = '\0';
+                                return (EOF);
+                        }
+                        fp->line_number++;
+                        if (fp->progress != NULL)
+                        {
+                                fp->bytes_consumed = (uint64_t) ftell (fp->fp);
+                                dxf_read_progress (fp);
+                        }
+                        length = strlen (temp_string);
+                        while ((length > 0)
+                                && ((temp_string[length - 1] == '\n')
+                                || (temp_string[length - 1] == '\r')))
+                        {
+                                temp_string[--length] = '\0';
+                        }
+                        line = temp_string;
+                }
+                start = line;
+                while ((*start == ' ') || (*start == '\t'))
+                {
+                        start++;
+                }
+                if (*start == '\0')
+                {
+                        /* blank line: read on. */
+                        continue;
+                }
+                if (start != temp_string)
+                {
+                        length = strlen (start);
+                        if (length >= DXF_MAX_STRING_LENGTH)
+                        {
+                                length = DXF_MAX_STRING_LENGTH - 1;
+                        }
+                        memmove (temp_string, start, length);
+                        temp_string[length] = '\0';
+                }
+                return (1);
         }
-        if (ret)
+}
+
+/*!
+ * \brief Reads a line of any length from a file.
+ *
+ * Like \c dxf_read_line, but without the \c DXF_MAX_STRING_LENGTH
+ * bound: long lines (MTEXT contents, proprietary data) land in a
+ * growable buffer owned by the \c DxfFile, so there is no per-call
+ * stack array and no truncation.\n
+ * The returned pointer stays valid until the next read from \c fp;
+ * consumers reference the value in place and only copy when they
+ * commit it.\n
+ * Leading blanks are trimmed, and the line may come out empty: the
+ * blank line skipping of \c dxf_read_line lives in the public wrappers
+ * below, because a blank line is noise between group codes but a valid
+ * value of an empty string field.
+ *
+ * \return a pointer to the line, or \c NULL at end of file.
+ */
+static char *
+dxf_read_line_grow_raw (DxfFile *fp)
+{
+        char *line;
+        char *grown;
+        size_t used;
+
         {
-                fp->line_number++;
+                if (fp->binary || (fp->read_buffer != NULL)
+                        || (fp->mmap_base != NULL))
+                {
+                        /* Block reads already slice lines in place
+                         * without a length cap. */
+                        line = dxf_read_getline (fp);
+                        if (line == NULL)
+                        {
+                                return (NULL);
+                        }
+                }
+                else
+                {
+                        if (fp->line_buffer == NULL)
+                        {
+                                fp->line_buffer_size = 256;
+                                fp->line_buffer = malloc (fp->line_buffer_size);
+                                if (fp->line_buffer == NULL)
+                                {
+                                        fprintf (stderr,
+                                          (_("Error in %s () could not allocate memory.\n")),
+                                          __FUNCTION__);
+                                        return (NULL);
+                                }
+                        }
+                        used = 0;
+                        for (;;)
+                        {
+                                if (fgets (fp->line_buffer + used,
+                                        fp->line_buffer_size - used, fp->fp) == NULL)
+                                {
+                                        if (used == 0)
+                                        {
+                                                return (NULL);
+                                        }
+                                        break;
+                                }
+                                used += strlen (fp->line_buffer + used);
+                                if ((used > 0)
+                                        && (fp->line_buffer[used - 1] == '\n'))
+                                {
+                                        break;
+                                }
+                                if (used < (fp->line_buffer_size - 1))
+                                {
+                                        /* Short final line without a
+                                         * newline. */
+                                        break;
+                                }
+                                grown = realloc (fp->line_buffer,
+                                        fp->line_buffer_size * 2);
+                                if (grown == NULL)
+                                {
+                                        fprintf (stderr,
+                                          (_("Error in %s () could not allocate memory.\n")),
+                                          __FUNCTION__);
+                                        return (NULL);
+                                }
+                                fp->line_buffer = grown;
+                                fp->line_buffer_size *= 2;
+                        }
+                        fp->line_number++;
+                        while ((used > 0)
+                                && ((fp->line_buffer[used - 1] == '\n')
+                                || (fp->line_buffer[used - 1] == '\r')))
+                        {
+                                fp->line_buffer[--used] = '\0';
+                        }
+                        line = fp->line_buffer;
+                }
+                while ((*line == ' ') || (*line == '\t'))
+                {
+                        line++;
+                }
+                return (line);
+        }
+}
+
+
+/*!
+ * \brief Reads a line of any length from a file.
+ *
+ * Like \c dxf_read_line, but without the \c DXF_MAX_STRING_LENGTH
+ * bound.\n
+ * Blank lines are skipped and leading blanks are trimmed, matching
+ * \c dxf_read_line.
+ *
+ * \return a pointer to the line, or \c NULL at end of file.
+ */
+char *
+dxf_read_line_grow (DxfFile *fp)
+{
+        char *line;
+
+        for (;;)
+        {
+                line = dxf_read_line_grow_raw (fp);
+                if ((line == NULL) || (*line != '\0'))
+                {
+                        return (line);
+                }
+                /* blank line: read on. */
         }
-        return ret;
 }
 
+
+/*!
+ * \brief Reads the value line of a group code from a file.
+ *
+ * Like \c dxf_read_line_grow, but a blank line is returned as an empty
+ * string instead of being skipped: string valued group codes store
+ * whatever follows them, and an empty value written as a blank line
+ * must not make the parser eat the next group code as the value.
+ *
+ * \return a pointer to the line, or \c NULL at end of file.
+ */
+char *
+dxf_read_value_line_grow (DxfFile *fp)
+{
+        return (dxf_read_line_grow_raw (fp));
+}
+
+
 /*!
  * \brief Uses of fscanf with other features.
- * 
- * Uses fscanf for file parsing, but also tracks the lines it reads;
- * 
+ *
+ * Uses fscanf for file parsing, but also tracks the lines it reads.\n
+ * The template is matched against lines assembled into a bounded
+ * buffer in every input mode — never against the raw stream — so an
+ * adversarial value longer than \c DXF_MAX_STRING_LENGTH cannot run
+ * an unbounded \c %s conversion past a caller's fixed buffer: the
+ * oversized line is swallowed and the conversion comes back short,
+ * exactly as the buffered and memory mapped modes always behaved.
  */
 int
 dxf_read_scanf (DxfFile *fp, const char *template, ...)
 {
+        char assembled[DXF_MAX_STRING_LENGTH];
+        char stream_line[DXF_MAX_STRING_LENGTH];
+        char *line;
+        const char *search_result;
+        size_t used;
+        size_t length;
+        int buffered;
+        int lines;
         int ret;
-        char * search_result;
         va_list lst;
+
         va_start (lst, template);
-        ret = vfscanf (fp->fp, template, lst);
-        if (ferror (fp->fp))
+        buffered = (fp->binary || (fp->read_buffer != NULL)
+                || (fp->mmap_base != NULL));
+        /* Pull one line per "\n" in the template (at least one) and
+         * match the template against the assembled lines. */
+        lines = 0;
+        search_result = template;
+        while ((search_result = strstr (search_result, "\n")) != NULL)
         {
-                fprintf (stderr, "Error: while reading from: %s in line: %d.\n",
-                        fp->filename, fp->line_number);
-                return (EXIT_FAILURE);
+                lines++;
+                search_result++;
         }
-        va_end (lst);
-        if (ret)
+        if (lines == 0)
+        {
+                lines = 1;
+        }
+        used = 0;
+        while (lines-- > 0)
         {
-                /*
-                 * we have to find each \n from the template to know how many lines will we read;
-                 */
-                search_result = (char *) template;
-                while (TRUE)
+                if (buffered)
+                {
+                        line = dxf_read_getline (fp);
+                        if (line == NULL)
+                        {
+                                break;
+                        }
+                }
+                else
                 {
-                        search_result = strstr (search_result, "\n");
-                        if (search_result == NULL)
+                        if (fgets (stream_line, sizeof (stream_line),
+                                fp->fp) == NULL)
+                        {
+                                if (ferror (fp->fp))
+                                {
+                                        fprintf (stderr, "Error: while reading from: %s in line: %ld.\n",
+                                                fp->filename, fp->line_number);
+                                }
                                 break;
+                        }
+                        length = strlen (stream_line);
+                        if ((length > 0)
+                                && (stream_line[length - 1] != '\n'))
+                        {
+                                /* a line longer than any valid field:
+                                 * swallow the rest, so the next read
+                                 * starts on a line boundary. */
+                                int c;
+
+                                do
+                                {
+                                        c = fgetc (fp->fp);
+                                }
+                                while ((c != '\n') && (c != EOF));
+                        }
+                        while ((length > 0)
+                                && ((stream_line[length - 1] == '\n')
+                                || (stream_line[length - 1] == '\r')))
+                        {
+                                stream_line[--length] = '\0';
+                        }
                         fp->line_number++;
-                        *++search_result;
+                        line = stream_line;
+                }
+                length = strlen (line);
+                if (used + length + 2 > sizeof (assembled))
+                {
+                        break;
                 }
+                memcpy (assembled + used, line, length);
+                used += length;
+                assembled[used++] = '\n';
         }
-        return ret;
+        assembled[used] = '\0';
+        ret = vsscanf (assembled, template, lst);
+        va_end (lst);
+        return (ret);
 }
 
 
@@ -36,6 +36,7 @@
 #define LIBDXF_SRC_UTIL_H
 
 #include "global.h"
+#include "arena.h"
 #include "file.h"
 
 
@@ -59,8 +60,29 @@ enum return_state { FAIL = 0, SUCCESS, FOUND };
 int dxf_read_is_double (int type);
 int dxf_read_is_int (int type);
 int dxf_read_is_string (int type);
+double dxf_parse_double (const char *string);
+long dxf_parse_long (const char *string);
+int dxf_read_group_code (const char *temp_string);
+int dxf_hex_decode (const char *hex, unsigned char *bytes);
+int dxf_hex_encode (char *hex, const unsigned char *bytes, int count);
 int dxf_read_line (char * temp_string, DxfFile *fp);
+char *dxf_read_line_grow (DxfFile *fp);
+char *dxf_read_value_line_grow (DxfFile *fp);
 int dxf_read_scanf (DxfFile *fp, const char *template, ...);
+int dxf_read_buffer_init (DxfFile *fp, size_t block_size);
+int dxf_read_prefetch_init (DxfFile *fp, int ring_size);
+void dxf_read_set_progress (DxfFile *fp, void (*progress) (uint64_t bytes_consumed, uint64_t bytes_total, void *user_data), void *user_data);
+int dxf_read_mmap_init (DxfFile *fp);
+int dxf_read_copy_raw (DxfFile *fp, FILE *out, size_t start, size_t end);
+int dxf_read_repair_raw (DxfFile *fp, size_t start, size_t end);
+void dxf_read_set_arena (DxfFile *fp, DxfArena *arena);
+char *dxf_string_intern (const char *string);
+void dxf_string_intern_free (void);
+size_t dxf_string_intern_bytes (void);
+char *dxf_read_getline (DxfFile *fp);
+int dxf_read_skip_entity (DxfFile *fp);
+int dxf_read_skip_section (DxfFile *fp);
+int dxf_read_peek_layer (DxfFile *fp, char *layer);
 DxfFile *dxf_read_init (const char *filename);
 void dxf_read_close (DxfFile *dxf_file);
 
@@ -32,7 +32,11 @@
  */
 
 
+#include <pthread.h>
 #include "vertex.h"
+#include "diag.h"
+#include "allocator.h"
+#include "util.h"
 
 
 /*!
@@ -58,7 +62,7 @@ dxf_vertex_new ()
         size = sizeof (DxfVertex);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_vertex = malloc (size)) == NULL)
+        if ((dxf_vertex = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfVertex struct.\n")),
@@ -98,6 +102,11 @@ dxf_vertex_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfVertex template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         /* Do some basic checks. */
         if (dxf_vertex == NULL)
         {
@@ -113,26 +122,37 @@ dxf_vertex_init
                 __FUNCTION__);
               return (NULL);
         }
-        dxf_vertex->id_code = 0;
-        dxf_vertex->linetype = strdup (DXF_DEFAULT_LINETYPE);
-        dxf_vertex->layer = strdup (DXF_DEFAULT_LAYER);
-        dxf_vertex->x0 = 0.0;
-        dxf_vertex->y0 = 0.0;
-        dxf_vertex->z0 = 0.0;
-        dxf_vertex->elevation = 0.0;
-        dxf_vertex->thickness = 0.0;
-        dxf_vertex->start_width = 0.0;
-        dxf_vertex->end_width = 0.0;
-        dxf_vertex->bulge = 0.0;
-        dxf_vertex->curve_fit_tangent_direction = 0.0;
-        dxf_vertex->linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
-        dxf_vertex->visibility = DXF_DEFAULT_VISIBILITY;
-        dxf_vertex->color = DXF_COLOR_BYLAYER;
-        dxf_vertex->paperspace = DXF_MODELSPACE;
-        dxf_vertex->flag = 0;
-        dxf_vertex->dictionary_owner_soft = strdup ("");
-        dxf_vertex->dictionary_owner_hard = strdup ("");
-        dxf_vertex->next = NULL;
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.id_code = 0;
+                template.linetype = strdup (DXF_DEFAULT_LINETYPE);
+                template.layer = strdup (DXF_DEFAULT_LAYER);
+                template.x0 = 0.0;
+                template.y0 = 0.0;
+                template.z0 = 0.0;
+                template.elevation = 0.0;
+                template.thickness = 0.0;
+                template.start_width = 0.0;
+                template.end_width = 0.0;
+                template.bulge = 0.0;
+                template.curve_fit_tangent_direction = 0.0;
+                template.linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
+                template.visibility = DXF_DEFAULT_VISIBILITY;
+                template.color = DXF_COLOR_BYLAYER;
+                template.paperspace = DXF_MODELSPACE;
+                template.flag = 0;
+                template.dictionary_owner_soft = strdup ("");
+                template.dictionary_owner_hard = strdup ("");
+                template.next = NULL;
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (dxf_vertex, &template, sizeof (DxfVertex));
+        dxf_vertex->linetype = strdup (template.linetype);
+        dxf_vertex->layer = strdup (template.layer);
+        dxf_vertex->dictionary_owner_soft = strdup (template.dictionary_owner_soft);
+        dxf_vertex->dictionary_owner_hard = strdup (template.dictionary_owner_hard);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -169,7 +189,7 @@ dxf_vertex_read
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        char *temp_string = NULL;
+        char temp_string[DXF_MAX_STRING_LENGTH];
 
         /* Do some basic checks. */
         if (fp == NULL)
@@ -187,14 +207,13 @@ dxf_vertex_read
                 dxf_vertex = dxf_vertex_new ();
                 dxf_vertex = dxf_vertex_init (dxf_vertex);
         }
-        (fp->line_number)++;
-        fscanf (fp->fp, "%[^\n]", temp_string);
+        dxf_read_line (temp_string, fp);
         while (strcmp (temp_string, "0") != 0)
         {
                 if (ferror (fp->fp))
                 {
                         fprintf (stderr,
-                          (_("Error in %s () while reading from: %s in line: %d.\n")),
+                          (_("Error in %s () while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                         fclose (fp->fp);
                         return (NULL);
@@ -203,42 +222,40 @@ dxf_vertex_read
                 {
                         /* Now follows a string containing a sequential
                          * id number. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%x\n", &dxf_vertex->id_code);
+                                                dxf_read_scanf (fp, "%x\n", &dxf_vertex->id_code);
                 }
                 else if (strcmp (temp_string, "6") == 0)
                 {
                         /* Now follows a string containing a linetype
                          * name. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_vertex->linetype);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
+                        free (dxf_vertex->linetype);
+                        dxf_vertex->linetype = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "8") == 0)
                 {
                         /* Now follows a string containing a layer name. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_vertex->layer);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
+                        free (dxf_vertex->layer);
+                        dxf_vertex->layer = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "10") == 0)
                 {
                         /* Now follows a string containing the
                          * X-coordinate of the point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_vertex->x0);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_vertex->x0);
                 }
                 else if (strcmp (temp_string, "20") == 0)
                 {
                         /* Now follows a string containing the
                          * Y-coordinate of the point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_vertex->y0);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_vertex->y0);
                 }
                 else if (strcmp (temp_string, "30") == 0)
                 {
                         /* Now follows a string containing the
                          * Z-coordinate of the point. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_vertex->z0);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_vertex->z0);
                 }
                 else if ((fp->acad_version_number <= AutoCAD_11)
                         && (strcmp (temp_string, "38") == 0)
@@ -246,121 +263,105 @@ dxf_vertex_read
                 {
                         /* Now follows a string containing the
                          * elevation. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_vertex->elevation);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_vertex->elevation);
                 }
                 else if (strcmp (temp_string, "39") == 0)
                 {
                         /* Now follows a string containing the
                          * thickness. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_vertex->thickness);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_vertex->thickness);
                 }
                 else if (strcmp (temp_string, "40") == 0)
                 {
                         /* Now follows a string containing the
                          * start width. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_vertex->start_width);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_vertex->start_width);
                 }
                 else if (strcmp (temp_string, "41") == 0)
                 {
                         /* Now follows a string containing the
                          * end width. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_vertex->end_width);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_vertex->end_width);
                 }
                 else if (strcmp (temp_string, "42") == 0)
                 {
                         /* Now follows a string containing the
                          * bulge. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_vertex->bulge);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_vertex->bulge);
                 }
                 else if (strcmp (temp_string, "48") == 0)
                 {
                         /* Now follows a string containing the linetype
                          * scale. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_vertex->linetype_scale);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_vertex->linetype_scale);
                 }
                 else if (strcmp (temp_string, "50") == 0)
                 {
                         /* Now follows a string containing the
                          * curve fitting tangent. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%lf\n", &dxf_vertex->curve_fit_tangent_direction);
+                                                dxf_read_scanf (fp, "%lf\n", &dxf_vertex->curve_fit_tangent_direction);
                 }
                 else if (strcmp (temp_string, "60") == 0)
                 {
                         /* Now follows a string containing the
                          * visibility value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%hd\n", &dxf_vertex->visibility);
+                                                dxf_read_scanf (fp, "%hd\n", &dxf_vertex->visibility);
                 }
                 else if (strcmp (temp_string, "62") == 0)
                 {
                         /* Now follows a string containing the
                          * color value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_vertex->color);
+                                                dxf_read_scanf (fp, "%d\n", &dxf_vertex->color);
                 }
                 else if (strcmp (temp_string, "67") == 0)
                 {
                         /* Now follows a string containing the
                          * paperspace value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_vertex->paperspace);
+                                                dxf_read_scanf (fp, "%d\n", &dxf_vertex->paperspace);
                 }
                 else if (strcmp (temp_string, "70") == 0)
                 {
                         /* Now follows a string containing the flag
                          * value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_vertex->flag);
+                                                dxf_read_scanf (fp, "%d\n", &dxf_vertex->flag);
                 }
                 else if (strcmp (temp_string, "71") == 0)
                 {
                         /* Now follows a string containing the Polyface
                          * mesh vertex index value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_vertex->polyface_mesh_vertex_index_1);
+                                                dxf_read_scanf (fp, "%d\n", &dxf_vertex->polyface_mesh_vertex_index_1);
                 }
                 else if (strcmp (temp_string, "72") == 0)
                 {
                         /* Now follows a string containing the Polyface
                          * mesh vertex index value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_vertex->polyface_mesh_vertex_index_2);
+                                                dxf_read_scanf (fp, "%d\n", &dxf_vertex->polyface_mesh_vertex_index_2);
                 }
                 else if (strcmp (temp_string, "73") == 0)
                 {
                         /* Now follows a string containing the Polyface
                          * mesh vertex index value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_vertex->polyface_mesh_vertex_index_3);
+                                                dxf_read_scanf (fp, "%d\n", &dxf_vertex->polyface_mesh_vertex_index_3);
                 }
                 else if (strcmp (temp_string, "74") == 0)
                 {
                         /* Now follows a string containing the Polyface
                          * mesh vertex index value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%d\n", &dxf_vertex->polyface_mesh_vertex_index_4);
+                                                dxf_read_scanf (fp, "%d\n", &dxf_vertex->polyface_mesh_vertex_index_4);
                 }
                 else if ((fp->acad_version_number >= AutoCAD_13)
                         && (strcmp (temp_string, "100") == 0))
                 {
                         /* Now follows a string containing the
                          * subclass marker value. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", temp_string);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
                         if ((strcmp (temp_string, "AcDbEntity") != 0)
                         && (strcmp (temp_string, "AcDbVertex") != 0)
                         && (strcmp (temp_string, "AcDb2dVertex") != 0)
                         && (strcmp (temp_string, "AcDb3dPolylineVertex") != 0))
                         {
-                                fprintf (stderr,
-                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %d.\n")),
+                                dxf_diag_report (fp, DXF_DIAG_WARNING,
+                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                         }
                 }
@@ -368,29 +369,34 @@ dxf_vertex_read
                 {
                         /* Now follows a string containing Soft-pointer
                          * ID/handle to owner dictionary. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_vertex->dictionary_owner_soft);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
+                        free (dxf_vertex->dictionary_owner_soft);
+                        dxf_vertex->dictionary_owner_soft = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "360") == 0)
                 {
                         /* Now follows a string containing Hard owner
                          * ID/handle to owner dictionary. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_vertex->dictionary_owner_hard);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
+                        free (dxf_vertex->dictionary_owner_hard);
+                        dxf_vertex->dictionary_owner_hard = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "999") == 0)
                 {
                         /* Now follows a string containing a comment. */
-                        (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", temp_string);
+                                                dxf_read_scanf (fp, "%s\n", temp_string);
                         fprintf (stdout, "DXF comment: %s\n", temp_string);
                 }
                 else
                 {
-                        fprintf (stderr,
-                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %d.\n")),
+                        dxf_diag_report (fp, DXF_DIAG_WARNING,
+                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                 }
+                if (dxf_read_line (temp_string, fp) != 1)
+                {
+                        break;
+                }
         }
         /* Handle omitted members and/or illegal values. */
         if (strcmp (dxf_vertex->linetype, "") == 0)
@@ -618,7 +624,7 @@ dxf_vertex_free
         free (dxf_vertex->layer);
         free (dxf_vertex->dictionary_owner_soft);
         free (dxf_vertex->dictionary_owner_hard);
-        free (dxf_vertex);
+        dxf_entity_dealloc (dxf_vertex, sizeof (*dxf_vertex));
         dxf_vertex = NULL;
 #if DEBUG
         DXF_DEBUG_END
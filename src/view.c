@@ -32,7 +32,10 @@
  */
 
 
+#include <pthread.h>
 #include "view.h"
+#include "diag.h"
+#include "allocator.h"
 
 
 /*!
@@ -61,7 +64,7 @@ dxf_view_new ()
         size = sizeof (DxfView);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_view = malloc (size)) == NULL)
+        if ((dxf_view = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfView struct.\n")),
@@ -102,6 +105,11 @@ dxf_view_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfView template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         /* Do some basic checks. */
         if (dxf_view == NULL)
         {
@@ -117,27 +125,37 @@ dxf_view_init
                   __FUNCTION__);
                 return (NULL);
         }
-        dxf_view->id_code = 0;
-        dxf_view->view_name = strdup ("");
-        dxf_view->x_view = 0.0;
-        dxf_view->y_view = 0.0;
-        dxf_view->x_direction = 0.0;
-        dxf_view->y_direction = 0.0;
-        dxf_view->z_direction = 0.0;
-        dxf_view->x_target = 0.0;
-        dxf_view->y_target = 0.0;
-        dxf_view->z_target = 0.0;
-        dxf_view->view_height = 0.0;
-        dxf_view->view_width = 0.0;
-        dxf_view->lens_length = 0.0;
-        dxf_view->front_plane_offset = 0.0;
-        dxf_view->back_plane_offset = 0.0;
-        dxf_view->view_twist_angle = 0.0;
-        dxf_view->flag = 0;
-        dxf_view->view_mode = 0;
-        dxf_view->dictionary_owner_soft = strdup ("");
-        dxf_view->dictionary_owner_hard = strdup ("");
-        dxf_view->next = NULL;
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.id_code = 0;
+                template.view_name = strdup ("");
+                template.x_view = 0.0;
+                template.y_view = 0.0;
+                template.x_direction = 0.0;
+                template.y_direction = 0.0;
+                template.z_direction = 0.0;
+                template.x_target = 0.0;
+                template.y_target = 0.0;
+                template.z_target = 0.0;
+                template.view_height = 0.0;
+                template.view_width = 0.0;
+                template.lens_length = 0.0;
+                template.front_plane_offset = 0.0;
+                template.back_plane_offset = 0.0;
+                template.view_twist_angle = 0.0;
+                template.flag = 0;
+                template.view_mode = 0;
+                template.dictionary_owner_soft = strdup ("");
+                template.dictionary_owner_hard = strdup ("");
+                template.next = NULL;
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (dxf_view, &template, sizeof (DxfView));
+        dxf_view->view_name = strdup (template.view_name);
+        dxf_view->dictionary_owner_soft = strdup (template.dictionary_owner_soft);
+        dxf_view->dictionary_owner_hard = strdup (template.dictionary_owner_hard);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -174,7 +192,7 @@ dxf_view_read
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        char *temp_string = NULL;
+        char temp_string[DXF_MAX_STRING_LENGTH];
 
         /* Do some basic checks. */
         if (fp == NULL)
@@ -199,7 +217,7 @@ dxf_view_read
                 if (ferror (fp->fp))
                 {
                         fprintf (stderr,
-                          (_("Error in %s () while reading from: %s in line: %d.\n")),
+                          (_("Error in %s () while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                         fclose (fp->fp);
                         return (NULL);
@@ -216,7 +234,9 @@ dxf_view_read
                         /* Now follows a string containing a view
                          * name. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_view->view_name);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_view->view_name);
+                        dxf_view->view_name = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "10") == 0)
                 {
@@ -343,8 +363,8 @@ dxf_view_read
                         if ((strcmp (temp_string, "AcDbSymbolTableRecord") != 0)
                         && ((strcmp (temp_string, "AcDbViewTableRecord") != 0)))
                         {
-                                fprintf (stderr,
-                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %d.\n")),
+                                dxf_diag_report (fp, DXF_DIAG_WARNING,
+                                  (_("Warning in %s () found a bad subclass marker in: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                         }
                 }
@@ -353,14 +373,18 @@ dxf_view_read
                         /* Now follows a string containing Soft-pointer
                          * ID/handle to owner dictionary. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_view->dictionary_owner_soft);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_view->dictionary_owner_soft);
+                        dxf_view->dictionary_owner_soft = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "360") == 0)
                 {
                         /* Now follows a string containing Hard owner
                          * ID/handle to owner dictionary. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_view->dictionary_owner_hard);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_view->dictionary_owner_hard);
+                        dxf_view->dictionary_owner_hard = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "999") == 0)
                 {
@@ -371,8 +395,8 @@ dxf_view_read
                 }
                 else
                 {
-                        fprintf (stderr,
-                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %d.\n")),
+                        dxf_diag_report (fp, DXF_DIAG_WARNING,
+                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                 }
         }
@@ -528,7 +552,7 @@ dxf_view_free
         free (dxf_view->view_name);
         free (dxf_view->dictionary_owner_soft);
         free (dxf_view->dictionary_owner_hard);
-        free (dxf_view);
+        dxf_entity_dealloc (dxf_view, sizeof (*dxf_view));
         dxf_view = NULL;
 #if DEBUG
         DXF_DEBUG_END
@@ -32,7 +32,11 @@
  */
 
 
+#include <pthread.h>
 #include "viewport.h"
+#include "diag.h"
+#include "allocator.h"
+#include "writer.h"
 
 
 /*!
@@ -58,7 +62,7 @@ dxf_viewport_new ()
         size = sizeof (DxfViewport);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_viewport = malloc (size)) == NULL)
+        if ((dxf_viewport = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfViewport struct.\n")),
@@ -99,7 +103,10 @@ dxf_viewport_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        int i;
+        static DxfViewport template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
 
         /* Do some basic checks. */
         if (dxf_viewport == NULL)
@@ -116,72 +123,80 @@ dxf_viewport_init
                   __FUNCTION__);
                 return (NULL);
         }
-        dxf_viewport->id_code = 0;
-        dxf_viewport->linetype = strdup (DXF_DEFAULT_LINETYPE);
-        dxf_viewport->layer = strdup (DXF_DEFAULT_LAYER);
-        dxf_viewport->x0 = 0.0;
-        dxf_viewport->y0 = 0.0;
-        dxf_viewport->z0 = 0.0;
-        dxf_viewport->elevation = 0.0;
-        dxf_viewport->thickness = 0.0;
-        dxf_viewport->linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
-        dxf_viewport->visibility = DXF_DEFAULT_VISIBILITY;
-        dxf_viewport->width = 0.0;
-        dxf_viewport->height = 0.0;
-        dxf_viewport->status = 0;
-        dxf_viewport->id = 1; /* Always 1. */
-        dxf_viewport->color = DXF_COLOR_BYLAYER;
-        dxf_viewport->paperspace = DXF_PAPERSPACE; /* Always on PAPERSPACE. */
-        dxf_viewport->app_name = strdup ("ACAD"); /* Always "ACAD". */
-        dxf_viewport->viewport_data = strdup ("MVIEW"); /* Always "MVIEW". */
-        dxf_viewport->window_descriptor_begin = strdup ("{"); /* Always "{". */
-        dxf_viewport->extended_entity_data_version = 16;
-        dxf_viewport->x_target = 0.0;
-        dxf_viewport->y_target = 0.0;
-        dxf_viewport->z_target = 0.0;
-        dxf_viewport->x_direction = 0.0;
-        dxf_viewport->y_direction = 0.0;
-        dxf_viewport->z_direction = 0.0;
-        dxf_viewport->view_twist_angle = 0.0;
-        dxf_viewport->view_height = 0.0;
-        dxf_viewport->x_center = 0.0;
-        dxf_viewport->y_center = 0.0;
-        dxf_viewport->perspective_lens_length = 0.0;
-        dxf_viewport->front_plane_offset = 0.0;
-        dxf_viewport->back_plane_offset = 0.0;
-        dxf_viewport->view_mode = 0;
-        dxf_viewport->circle_zoom_percent = 0;
-        dxf_viewport->fast_zoom_setting = 0;
-        dxf_viewport->UCSICON_setting = 0;
-        dxf_viewport->snap_on = 0;
-        dxf_viewport->grid_on = 0;
-        dxf_viewport->snap_style = 0;
-        dxf_viewport->snap_isopair = 0;
-        dxf_viewport->snap_rotation_angle = 0.0;
-        dxf_viewport->x_snap_base = 0.0;
-        dxf_viewport->y_snap_base = 0.0;
-        dxf_viewport->x_snap_spacing = 0.0;
-        dxf_viewport->y_snap_spacing = 0.0;
-        dxf_viewport->x_grid_spacing = 0.0;
-        dxf_viewport->y_grid_spacing = 0.0;
-        dxf_viewport->plot_flag = 0;
-        dxf_viewport->frozen_layer_list_begin = strdup ("{"); /* Always "{". */
-        /*! \todo Implement the number of layers in a more efficient way.
-         * A lot of memory is consumed by reserving for DXF_MAX_LAYERS
-         * instead of the actual existing number of layers.
-         * Maybe this can be solved by dynamically allocating a
-         * reasonable number of layers during compile time, and
-         * (re-allocating) shrinking when the actual number of layers is
-         * known during run time. */
-        for (i = 0; i < DXF_MAX_LAYERS; i++)
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
         {
-                dxf_viewport->frozen_layers[i] = strdup ("");
+                template.id_code = 0;
+                template.linetype = strdup (DXF_DEFAULT_LINETYPE);
+                template.layer = strdup (DXF_DEFAULT_LAYER);
+                template.x0 = 0.0;
+                template.y0 = 0.0;
+                template.z0 = 0.0;
+                template.elevation = 0.0;
+                template.thickness = 0.0;
+                template.linetype_scale = DXF_DEFAULT_LINETYPE_SCALE;
+                template.visibility = DXF_DEFAULT_VISIBILITY;
+                template.width = 0.0;
+                template.height = 0.0;
+                template.status = 0;
+                template.id = 1; /* Always 1. */
+                template.color = DXF_COLOR_BYLAYER;
+                template.paperspace = DXF_PAPERSPACE; /* Always on PAPERSPACE. */
+                template.app_name = strdup ("ACAD"); /* Always "ACAD". */
+                template.viewport_data = strdup ("MVIEW"); /* Always "MVIEW". */
+                template.window_descriptor_begin = strdup ("{"); /* Always "{". */
+                template.extended_entity_data_version = 16;
+                template.x_target = 0.0;
+                template.y_target = 0.0;
+                template.z_target = 0.0;
+                template.x_direction = 0.0;
+                template.y_direction = 0.0;
+                template.z_direction = 0.0;
+                template.view_twist_angle = 0.0;
+                template.view_height = 0.0;
+                template.x_center = 0.0;
+                template.y_center = 0.0;
+                template.perspective_lens_length = 0.0;
+                template.front_plane_offset = 0.0;
+                template.back_plane_offset = 0.0;
+                template.view_mode = 0;
+                template.circle_zoom_percent = 0;
+                template.fast_zoom_setting = 0;
+                template.UCSICON_setting = 0;
+                template.snap_on = 0;
+                template.grid_on = 0;
+                template.snap_style = 0;
+                template.snap_isopair = 0;
+                template.snap_rotation_angle = 0.0;
+                template.x_snap_base = 0.0;
+                template.y_snap_base = 0.0;
+                template.x_snap_spacing = 0.0;
+                template.y_snap_spacing = 0.0;
+                template.x_grid_spacing = 0.0;
+                template.y_grid_spacing = 0.0;
+                template.plot_flag = 0;
+                template.frozen_layer_list_begin = strdup ("{"); /* Always "{". */
+                template.frozen_layers = NULL;
+                template.frozen_layer_list_end = strdup ("}"); /* Always "}". */
+                template.window_descriptor_end = strdup ("}"); /* Always "}". */
+                template.dictionary_owner_soft = strdup ("");
+                template.dictionary_owner_hard = strdup ("");
+                template.next = NULL;
+                template_ready = 1;
         }
-        dxf_viewport->frozen_layer_list_end = strdup ("}"); /* Always "}". */
-        dxf_viewport->window_descriptor_end = strdup ("}"); /* Always "}". */
-        dxf_viewport->dictionary_owner_soft = strdup ("");
-        dxf_viewport->dictionary_owner_hard = strdup ("");
-        dxf_viewport->next = NULL;
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (dxf_viewport, &template, sizeof (DxfViewport));
+        dxf_viewport->frozen_layers = dxf_layer_registry_new ();
+        dxf_viewport->linetype = strdup (template.linetype);
+        dxf_viewport->layer = strdup (template.layer);
+        dxf_viewport->app_name = strdup (template.app_name);
+        dxf_viewport->viewport_data = strdup (template.viewport_data);
+        dxf_viewport->window_descriptor_begin = strdup (template.window_descriptor_begin);
+        dxf_viewport->frozen_layer_list_begin = strdup (template.frozen_layer_list_begin);
+        dxf_viewport->frozen_layer_list_end = strdup (template.frozen_layer_list_end);
+        dxf_viewport->window_descriptor_end = strdup (template.window_descriptor_end);
+        dxf_viewport->dictionary_owner_soft = strdup (template.dictionary_owner_soft);
+        dxf_viewport->dictionary_owner_hard = strdup (template.dictionary_owner_hard);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -219,7 +234,7 @@ dxf_viewport_read
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        char *temp_string = NULL;
+        char temp_string[DXF_MAX_STRING_LENGTH];
 
         /* Do some basic checks. */
         if (fp == NULL)
@@ -244,7 +259,7 @@ dxf_viewport_read
                 if (ferror (fp->fp))
                 {
                         fprintf (stderr,
-                          (_("Error in %s () while reading from: %s in line: %d.\n")),
+                          (_("Error in %s () while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                         fclose (fp->fp);
                         return (NULL);
@@ -261,13 +276,17 @@ dxf_viewport_read
                         /* Now follows a string containing a linetype
                          * name. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_viewport->linetype);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_viewport->linetype);
+                        dxf_viewport->linetype = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "8") == 0)
                 {
                         /* Now follows a string containing a layer name. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_viewport->layer);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_viewport->layer);
+                        dxf_viewport->layer = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "10") == 0)
                 {
@@ -378,11 +397,13 @@ dxf_viewport_read
                         /* Now follows a string containing the appname,
                          * always "ACAD". */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_viewport->app_name);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_viewport->app_name);
+                        dxf_viewport->app_name = strdup (temp_string);
                         if (strcmp (dxf_viewport->app_name, "ACAD") == 1)
                         {
                                 fprintf (stderr,
-                                  (_("Error in %s () while reading from: %s in line: %d.\n")),
+                                  (_("Error in %s () while reading from: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                                 fprintf (stderr,
                                   (_("\tunexpected content in string followed after group code 1001.\n")));
@@ -394,7 +415,7 @@ dxf_viewport_read
                         if (strcmp (temp_string, "1000") == 1)
                         {
                                 fprintf (stderr,
-                                  (_("Error in %s () while reading from: %s in line: %d.\n")),
+                                  (_("Error in %s () while reading from: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                                 fprintf (stderr,
                                   (_("\tunexpected content in string sequence found.\n")));
@@ -403,11 +424,13 @@ dxf_viewport_read
                         /* Now follows a string containing the viewport
                          * data, always "MVIEW". */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_viewport->viewport_data);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_viewport->viewport_data);
+                        dxf_viewport->viewport_data = strdup (temp_string);
                         if (strcmp (dxf_viewport->viewport_data, "MVIEW") == 1)
                         {
                                 fprintf (stderr,
-                                  (_("Error in %s () while reading from: %s in line: %d.\n")),
+                                  (_("Error in %s () while reading from: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                                 fprintf (stderr,
                                   (_("\tunexpected content in string.\n")));
@@ -419,7 +442,7 @@ dxf_viewport_read
                         if (strcmp (temp_string, "1002") == 1)
                         {
                                 fprintf (stderr,
-                                  (_("Error in %s () while reading from: %s in line: %d.\n")),
+                                  (_("Error in %s () while reading from: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                                 fprintf (stderr,
                                   (_("\tunexpected content in string sequence found.\n")));
@@ -428,11 +451,13 @@ dxf_viewport_read
                         /* Now follows a string containing the window
                          * begin descriptor, always "{". */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_viewport->window_descriptor_begin);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_viewport->window_descriptor_begin);
+                        dxf_viewport->window_descriptor_begin = strdup (temp_string);
                         if (strcmp (dxf_viewport->window_descriptor_begin, "{") == 1)
                         {
                                 fprintf (stderr,
-                                  (_("Error in %s () while reading from: %s in line: %d.\n")),
+                                  (_("Error in %s () while reading from: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                                 fprintf (stderr, "    unexpected content in string.\n");
                                 return (NULL);
@@ -443,7 +468,7 @@ dxf_viewport_read
                         if (strcmp (temp_string, "1070") == 1)
                         {
                                 fprintf (stderr,
-                                  (_("Error in %s () while reading from: %s in line: %d.\n")),
+                                  (_("Error in %s () while reading from: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                                 fprintf (stderr,
                                   (_("\tunexpected content in string sequence found.\n")));
@@ -459,7 +484,7 @@ dxf_viewport_read
                         if (strcmp (temp_string, "1010") == 1)
                         {
                                 fprintf (stderr,
-                                  (_("Error in %s () while reading from: %s in line: %d.\n")),
+                                  (_("Error in %s () while reading from: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                                 fprintf (stderr,
                                   (_("\tunexpected content in string sequence found.\n")));
@@ -474,7 +499,7 @@ dxf_viewport_read
                         if (strcmp (temp_string, "1020") == 1)
                         {
                                 fprintf (stderr,
-                                  (_("Error in %s () while reading from: %s in line: %d.\n")),
+                                  (_("Error in %s () while reading from: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                                 fprintf (stderr,
                                   (_("\tunexpected content in string sequence found.\n")));
@@ -489,7 +514,7 @@ dxf_viewport_read
                         if (strcmp (temp_string, "1030") == 1)
                         {
                                 fprintf (stderr,
-                                  (_("Error in %s () while reading from: %s in line: %d.\n")),
+                                  (_("Error in %s () while reading from: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                                 fprintf (stderr,
                                   (_("\tunexpected content in string sequence found.\n")));
@@ -504,7 +529,7 @@ dxf_viewport_read
                         if (strcmp (temp_string, "1010") == 1)
                         {
                                 fprintf (stderr,
-                                  (_("Error in %s () while reading from: %s in line: %d.\n")),
+                                  (_("Error in %s () while reading from: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                                 fprintf (stderr,
                                   (_("\tunexpected content in string sequence found.\n")));
@@ -519,7 +544,7 @@ dxf_viewport_read
                         if (strcmp (temp_string, "1020") == 1)
                         {
                                 fprintf (stderr,
-                                  (_("Error in %s () while reading from: %s in line: %d.\n")),
+                                  (_("Error in %s () while reading from: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                                 fprintf (stderr,
                                   (_("\tunexpected content in string sequence found.\n")));
@@ -534,7 +559,7 @@ dxf_viewport_read
                         if (strcmp (temp_string, "1030") == 1)
                         {
                                 fprintf (stderr,
-                                  (_("Error in %s () while reading from: %s in line: %d.\n")),
+                                  (_("Error in %s () while reading from: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                                 fprintf (stderr,
                                   (_("\tunexpected content in string sequence found.\n")));
@@ -549,7 +574,7 @@ dxf_viewport_read
                         if (strcmp (temp_string, "1040") == 1)
                         {
                                 fprintf (stderr,
-                                  (_("Error in %s () while reading from: %s in line: %d.\n")),
+                                  (_("Error in %s () while reading from: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                                 fprintf (stderr,
                                   (_("\tunexpected content in string sequence found.\n")));
@@ -565,7 +590,7 @@ dxf_viewport_read
                         if (strcmp (temp_string, "1040") == 1)
                         {
                                 fprintf (stderr,
-                                  (_("Error in %s () while reading from: %s in line: %d.\n")),
+                                  (_("Error in %s () while reading from: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                                 fprintf (stderr,
                                   (_("\tunexpected content in string sequence found.\n")));
@@ -581,7 +606,7 @@ dxf_viewport_read
                         if (strcmp (temp_string, "1040") == 1)
                         {
                                 fprintf (stderr,
-                                  (_("Error in %s () while reading from: %s in line: %d.\n")),
+                                  (_("Error in %s () while reading from: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                                 fprintf (stderr,
                                   (_("\tunexpected content in string sequence found.\n")));
@@ -597,7 +622,7 @@ dxf_viewport_read
                         if (strcmp (temp_string, "1040") == 1)
                         {
                                 fprintf (stderr,
-                                  (_("Error in %s () while reading from: %s in line: %d.\n")),
+                                  (_("Error in %s () while reading from: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                                 fprintf (stderr,
                                   (_("\tunexpected content in string sequence found.\n")));
@@ -613,7 +638,7 @@ dxf_viewport_read
                         if (strcmp (temp_string, "1040") == 1)
                         {
                                 fprintf (stderr,
-                                  (_("Error in %s () while reading from: %s in line: %d.\n")),
+                                  (_("Error in %s () while reading from: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                                 fprintf (stderr,
                                   (_("\tunexpected content in string sequence found.\n")));
@@ -629,7 +654,7 @@ dxf_viewport_read
                         if (strcmp (temp_string, "1040") == 1)
                         {
                                 fprintf (stderr,
-                                  (_("Error in %s () while reading from: %s in line: %d.\n")),
+                                  (_("Error in %s () while reading from: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                                 fprintf (stderr,
                                   (_("\tunexpected content in string sequence found.\n")));
@@ -645,7 +670,7 @@ dxf_viewport_read
                         if (strcmp (temp_string, "1040") == 1)
                         {
                                 fprintf (stderr,
-                                  (_("Error in %s () while reading from: %s in line: %d.\n")),
+                                  (_("Error in %s () while reading from: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                                 fprintf (stderr,
                                   (_("\tunexpected content in string sequence found.\n")));
@@ -661,7 +686,7 @@ dxf_viewport_read
                         if (strcmp (temp_string, "1070") == 1)
                         {
                                 fprintf (stderr,
-                                  (_("Error in %s () while reading from: %s in line: %d.\n")),
+                                  (_("Error in %s () while reading from: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                                 fprintf (stderr,
                                   (_("\tunexpected content in string sequence found.\n")));
@@ -676,7 +701,7 @@ dxf_viewport_read
                         if (strcmp (temp_string, "1070") == 1)
                         {
                                 fprintf (stderr,
-                                  (_("Error in %s () while reading from: %s in line: %d.\n")),
+                                  (_("Error in %s () while reading from: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                                 fprintf (stderr,
                                   (_("\tunexpected content in string sequence found.\n")));
@@ -692,7 +717,7 @@ dxf_viewport_read
                         if (strcmp (temp_string, "1070") == 1)
                         {
                                 fprintf (stderr,
-                                  (_("Error in %s () while reading from: %s in line: %d.\n")),
+                                  (_("Error in %s () while reading from: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                                 fprintf (stderr,
                                   (_("\tunexpected content in string sequence found.\n")));
@@ -708,7 +733,7 @@ dxf_viewport_read
                         if (strcmp (temp_string, "1070") == 1)
                         {
                                 fprintf (stderr,
-                                  (_("Error in %s () while reading from: %s in line: %d.\n")),
+                                  (_("Error in %s () while reading from: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                                 fprintf (stderr,
                                   (_("\tunexpected content in string sequence found.\n")));
@@ -724,7 +749,7 @@ dxf_viewport_read
                         if (strcmp (temp_string, "1070") == 1)
                         {
                                 fprintf (stderr,
-                                  (_("Error in %s () while reading from: %s in line: %d.\n")),
+                                  (_("Error in %s () while reading from: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                                 fprintf (stderr,
                                   (_("\tunexpected content in string sequence found.\n")));
@@ -740,7 +765,7 @@ dxf_viewport_read
                         if (strcmp (temp_string, "1070") == 1)
                         {
                                 fprintf (stderr,
-                                  (_("Error in %s () while reading from: %s in line: %d.\n")),
+                                  (_("Error in %s () while reading from: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                                 fprintf (stderr,
                                   (_("\tunexpected content in string sequence found.\n")));
@@ -756,7 +781,7 @@ dxf_viewport_read
                         if (strcmp (temp_string, "1070") == 1)
                         {
                                 fprintf (stderr,
-                                  (_("Error in %s () while reading from: %s in line: %d.\n")),
+                                  (_("Error in %s () while reading from: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                                 fprintf (stderr,
                                   (_("\tunexpected content in string sequence found.\n")));
@@ -772,7 +797,7 @@ dxf_viewport_read
                         if (strcmp (temp_string, "1070") == 1)
                         {
                                 fprintf (stderr,
-                                  (_("Error in %s () while reading from: %s in line: %d.\n")),
+                                  (_("Error in %s () while reading from: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                                 fprintf (stderr,
                                   (_("\tunexpected content in string sequence found.\n")));
@@ -788,7 +813,7 @@ dxf_viewport_read
                         if (strcmp (temp_string, "1040") == 1)
                         {
                                 fprintf (stderr,
-                                  (_("Error in %s () while reading from: %s in line: %d.\n")),
+                                  (_("Error in %s () while reading from: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                                 fprintf (stderr,
                                   (_("\tunexpected content in string sequence found.\n")));
@@ -804,7 +829,7 @@ dxf_viewport_read
                         if (strcmp (temp_string, "1040") == 1)
                         {
                                 fprintf (stderr,
-                                  (_("Error in %s () while reading from: %s in line: %d.\n")),
+                                  (_("Error in %s () while reading from: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                                 fprintf (stderr,
                                   (_("\tunexpected content in string sequence found.\n")));
@@ -820,7 +845,7 @@ dxf_viewport_read
                         if (strcmp (temp_string, "1040") == 1)
                         {
                                 fprintf (stderr,
-                                  (_("Error in %s () while reading from: %s in line: %d.\n")),
+                                  (_("Error in %s () while reading from: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                                 fprintf (stderr,
                                   (_("\tunexpected content in string sequence found.\n")));
@@ -836,7 +861,7 @@ dxf_viewport_read
                         if (strcmp (temp_string, "1040") == 1)
                         {
                                 fprintf (stderr,
-                                  (_("Error in %s () while reading from: %s in line: %d.\n")),
+                                  (_("Error in %s () while reading from: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                                 fprintf (stderr,
                                   (_("\tunexpected content in string sequence found.\n")));
@@ -852,7 +877,7 @@ dxf_viewport_read
                         if (strcmp (temp_string, "1040") == 1)
                         {
                                 fprintf (stderr,
-                                  (_("Error in %s () while reading from: %s in line: %d.\n")),
+                                  (_("Error in %s () while reading from: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                                 fprintf (stderr,
                                   (_("\tunexpected content in string sequence found.\n")));
@@ -868,7 +893,7 @@ dxf_viewport_read
                         if (strcmp (temp_string, "1070") == 1)
                         {
                                 fprintf (stderr,
-                                  (_("Error in %s () while reading from: %s in line: %d.\n")),
+                                  (_("Error in %s () while reading from: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                                 fprintf (stderr,
                                   (_("\tunexpected content in string sequence found.\n")));
@@ -883,7 +908,7 @@ dxf_viewport_read
                         if (strcmp (temp_string, "1002") == 1)
                         {
                                 fprintf (stderr,
-                                  (_("Error in %s () while reading from: %s in line: %d.\n")),
+                                  (_("Error in %s () while reading from: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                                 fprintf (stderr,
                                   (_("\tunexpected content in string sequence found.\n")));
@@ -892,11 +917,13 @@ dxf_viewport_read
                         /* Now follows a string containing the frozen
                          * layer list begin descriptor, always "{". */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_viewport->frozen_layer_list_begin);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_viewport->frozen_layer_list_begin);
+                        dxf_viewport->frozen_layer_list_begin = strdup (temp_string);
                         if (strcmp (dxf_viewport->frozen_layer_list_begin, "{") == 1)
                         {
                                 fprintf (stderr,
-                                  (_("Error in %s () while reading from: %s in line: %d.\n")),
+                                  (_("Error in %s () while reading from: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                                 fprintf (stderr,
                                   (_("\tunexpected content in string.\n")));
@@ -910,27 +937,28 @@ dxf_viewport_read
                         {
                                 /* Start a loop reading all frozen layer
                                  * names and bail out when a group code
-                                 * with a value of "1002" is encountered
-                                 * or DXF_MAX_LAYERS is reached.*/
-                                int j = 0;
+                                 * with a value of "1002" is
+                                 * encountered. */
                                 do
                                 {
                                         (fp->line_number)++;
-                                        fscanf (fp->fp, "%s\n", dxf_viewport->frozen_layers[j]);
-                                        j++;
+                                        fscanf (fp->fp, "%s\n", temp_string);
+                                        if (dxf_layer_registry_add (dxf_viewport->frozen_layers, temp_string) < 0)
+                                        {
+                                                return (NULL);
+                                        }
                                         /* Now follows a string containing a group code. */
                                         (fp->line_number)++;
                                         fscanf (fp->fp, "%s\n", temp_string);
                                 }
-                                while ((strcmp (temp_string, "1003") == 0)
-                                        || (j < DXF_MAX_LAYERS));
+                                while (strcmp (temp_string, "1003") == 0);
                         }
                         else
                         {
                                 /* Either we found an empty list or we
                                  * have found an exception. */
                                 fprintf (stderr,
-                                  (_("Error in %s () while reading from: %s in line: %d.\n")),
+                                  (_("Error in %s () while reading from: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                                 fprintf (stderr,
                                   (_("\tunexpected end of frozen layer list found.\n")));
@@ -941,7 +969,7 @@ dxf_viewport_read
                         if (strcmp (temp_string, "1002") == 1)
                         {
                                 fprintf (stderr,
-                                  (_("Error in %s () while reading from: %s in line: %d.\n")),
+                                  (_("Error in %s () while reading from: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                                 fprintf (stderr,
                                   (_("\tunexpected content in string sequence found.\n")));
@@ -950,11 +978,13 @@ dxf_viewport_read
                         /* Now follows a string containing the frozen
                          * layer list end descriptor, always "}". */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_viewport->frozen_layer_list_end);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_viewport->frozen_layer_list_end);
+                        dxf_viewport->frozen_layer_list_end = strdup (temp_string);
                         if (strcmp (dxf_viewport->frozen_layer_list_end, "}") == 1)
                         {
                                 fprintf (stderr,
-                                  (_("Error in %s () while reading from: %s in line: %d.\n")),
+                                  (_("Error in %s () while reading from: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                                 fprintf (stderr,
                                   (_("\tunexpected content in string.\n")));
@@ -966,7 +996,7 @@ dxf_viewport_read
                         if (strcmp (temp_string, "1002") == 1)
                         {
                                 fprintf (stderr,
-                                  (_("Error in %s () while reading from: %s in line: %d.\n")),
+                                  (_("Error in %s () while reading from: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                                 fprintf (stderr,
                                   (_("\tunexpected content in string sequence found.\n")));
@@ -975,11 +1005,13 @@ dxf_viewport_read
                         /* Now follows a string containing the window
                          * end descriptor, always "}". */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_viewport->window_descriptor_end);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_viewport->window_descriptor_end);
+                        dxf_viewport->window_descriptor_end = strdup (temp_string);
                         if (strcmp (dxf_viewport->window_descriptor_end, "}") == 1)
                         {
                                 fprintf (stderr,
-                                  (_("Error in %s () while reading from: %s in line: %d.\n")),
+                                  (_("Error in %s () while reading from: %s in line: %ld.\n")),
                                   __FUNCTION__, fp->filename, fp->line_number);
                                 fprintf (stderr,
                                   (_("\tunexpected content in string.\n")));
@@ -989,8 +1021,8 @@ dxf_viewport_read
                 /* End of sequential ordered data fields. */
                 else 
                 {
-                        fprintf (stderr,
-                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %d.\n")),
+                        dxf_diag_report (fp, DXF_DIAG_WARNING,
+                          (_("Warning in %s () unknown string tag found while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                 }
         }
@@ -1072,10 +1104,10 @@ dxf_viewport_write
                 dxf_viewport->layer = strdup (DXF_DEFAULT_LAYER);
         }
         /* Start writing output. */
-        fprintf (fp->fp, "  0\n%s\n", dxf_entity_name);
+        dxf_write_group_string (fp, 0, dxf_entity_name);
         if (dxf_viewport->id_code != -1)
         {
-                fprintf (fp->fp, "  5\n%x\n", dxf_viewport->id_code);
+                dxf_write_group_hex (fp, 5, dxf_viewport->id_code);
         }
         /*!
          * \todo for version R14.\n
@@ -1090,108 +1122,112 @@ dxf_viewport_write
         if ((strcmp (dxf_viewport->dictionary_owner_soft, "") != 0)
           && (fp->acad_version_number >= AutoCAD_14))
         {
-                fprintf (fp->fp, "102\n{ACAD_REACTORS\n");
-                fprintf (fp->fp, "330\n%s\n", dxf_viewport->dictionary_owner_soft);
-                fprintf (fp->fp, "102\n}\n");
+                dxf_write_group_string (fp, 102, "{ACAD_REACTORS");
+                dxf_write_group_string (fp, 330, dxf_viewport->dictionary_owner_soft);
+                dxf_write_group_string (fp, 102, "}");
         }
         if ((strcmp (dxf_viewport->dictionary_owner_hard, "") != 0)
           && (fp->acad_version_number >= AutoCAD_14))
         {
-                fprintf (fp->fp, "102\n{ACAD_XDICTIONARY\n");
-                fprintf (fp->fp, "360\n%s\n", dxf_viewport->dictionary_owner_hard);
-                fprintf (fp->fp, "102\n}\n");
+                dxf_write_group_string (fp, 102, "{ACAD_XDICTIONARY");
+                dxf_write_group_string (fp, 360, dxf_viewport->dictionary_owner_hard);
+                dxf_write_group_string (fp, 102, "}");
         }
         if (fp->acad_version_number >= AutoCAD_13)
         {
-                fprintf (fp->fp, "100\nAcDbEntity\n");
+                dxf_write_group_string (fp, 100, "AcDbEntity");
         }
         if (dxf_viewport->paperspace == DXF_PAPERSPACE)
         {
-                fprintf (fp->fp, " 67\n%d\n", DXF_PAPERSPACE);
+                dxf_write_group_int (fp, 67, DXF_PAPERSPACE);
         }
-        fprintf (fp->fp, "  8\n%s\n", dxf_viewport->layer);
+        dxf_write_group_string (fp, 8, dxf_viewport->layer);
         if (strcmp (dxf_viewport->linetype, DXF_DEFAULT_LINETYPE) != 0)
         {
-                fprintf (fp->fp, "  6\n%s\n", dxf_viewport->linetype);
+                dxf_write_group_string (fp, 6, dxf_viewport->linetype);
         }
         if ((fp->acad_version_number <= AutoCAD_11)
           && DXF_FLATLAND
           && (dxf_viewport->elevation != 0.0))
         {
-                fprintf (fp->fp, " 38\n%f\n", dxf_viewport->elevation);
+                dxf_write_group_double (fp, 38, dxf_viewport->elevation);
         }
         if (dxf_viewport->color != DXF_COLOR_BYLAYER)
         {
-                fprintf (fp->fp, " 62\n%d\n", dxf_viewport->color);
+                dxf_write_group_int (fp, 62, dxf_viewport->color);
         }
         if (dxf_viewport->linetype_scale != 1.0)
         {
-                fprintf (fp->fp, " 48\n%f\n", dxf_viewport->linetype_scale);
+                dxf_write_group_double (fp, 48, dxf_viewport->linetype_scale);
         }
         if (dxf_viewport->visibility != 0)
         {
-                fprintf (fp->fp, " 60\n%d\n", dxf_viewport->visibility);
+                dxf_write_group_int (fp, 60, dxf_viewport->visibility);
         }
         if (fp->acad_version_number >= AutoCAD_13)
         {
-                fprintf (fp->fp, "100\nAcDbViewport\n");
+                dxf_write_group_string (fp, 100, "AcDbViewport");
         }
         if (dxf_viewport->thickness != 0.0)
         {
-                fprintf (fp->fp, " 39\n%f\n", dxf_viewport->thickness);
+                dxf_write_group_double (fp, 39, dxf_viewport->thickness);
         }
-        fprintf (fp->fp, " 10\n%f\n", dxf_viewport->x0);
-        fprintf (fp->fp, " 20\n%f\n", dxf_viewport->y0);
-        fprintf (fp->fp, " 30\n%f\n", dxf_viewport->z0);
-        fprintf (fp->fp, " 40\n%f\n", dxf_viewport->width);
-        fprintf (fp->fp, " 41\n%f\n", dxf_viewport->height);
-        fprintf (fp->fp, " 68\n%d\n", dxf_viewport->status);
-        fprintf (fp->fp, " 69\n%d\n", dxf_viewport->id);
-        fprintf (fp->fp, "1001\n%s\n", DXF_VIEWPORT_APP_NAME);
-        fprintf (fp->fp, "1000\n%s\n", DXF_VIEWPORT_DATA);
-        fprintf (fp->fp, "1002\n%s\n", DXF_VIEWPORT_WINDOW_BEGIN);
-        fprintf (fp->fp, "1070\n%d\n", dxf_viewport->extended_entity_data_version);
-        fprintf (fp->fp, "1010\n%f\n", dxf_viewport->x_target);
-        fprintf (fp->fp, "1020\n%f\n", dxf_viewport->y_target);
-        fprintf (fp->fp, "1030\n%f\n", dxf_viewport->z_target);
-        fprintf (fp->fp, "1010\n%f\n", dxf_viewport->x_direction);
-        fprintf (fp->fp, "1020\n%f\n", dxf_viewport->y_direction);
-        fprintf (fp->fp, "1030\n%f\n", dxf_viewport->z_direction);
-        fprintf (fp->fp, "1040\n%f\n", dxf_viewport->view_twist_angle);
-        fprintf (fp->fp, "1040\n%f\n", dxf_viewport->view_height);
-        fprintf (fp->fp, "1040\n%f\n", dxf_viewport->x_center);
-        fprintf (fp->fp, "1040\n%f\n", dxf_viewport->y_center);
-        fprintf (fp->fp, "1040\n%f\n", dxf_viewport->perspective_lens_length);
-        fprintf (fp->fp, "1040\n%f\n", dxf_viewport->front_plane_offset);
-        fprintf (fp->fp, "1040\n%f\n", dxf_viewport->back_plane_offset);
-        fprintf (fp->fp, "1070\n%d\n", dxf_viewport->view_mode);
-        fprintf (fp->fp, "1070\n%d\n", dxf_viewport->circle_zoom_percent);
-        fprintf (fp->fp, "1070\n%d\n", dxf_viewport->fast_zoom_setting);
-        fprintf (fp->fp, "1070\n%d\n", dxf_viewport->UCSICON_setting);
-        fprintf (fp->fp, "1070\n%d\n", dxf_viewport->snap_on);
-        fprintf (fp->fp, "1070\n%d\n", dxf_viewport->grid_on);
-        fprintf (fp->fp, "1070\n%d\n", dxf_viewport->snap_style);
-        fprintf (fp->fp, "1070\n%d\n", dxf_viewport->snap_isopair);
-        fprintf (fp->fp, "1040\n%f\n", dxf_viewport->snap_rotation_angle);
-        fprintf (fp->fp, "1040\n%f\n", dxf_viewport->x_snap_base);
-        fprintf (fp->fp, "1040\n%f\n", dxf_viewport->y_snap_base);
-        fprintf (fp->fp, "1040\n%f\n", dxf_viewport->x_snap_spacing);
-        fprintf (fp->fp, "1040\n%f\n", dxf_viewport->y_snap_spacing);
-        fprintf (fp->fp, "1040\n%f\n", dxf_viewport->x_grid_spacing);
-        fprintf (fp->fp, "1040\n%f\n", dxf_viewport->y_grid_spacing);
-        fprintf (fp->fp, "1070\n%d\n", dxf_viewport->plot_flag);
-        fprintf (fp->fp, "1002\n%s\n", DXF_VIEWPORT_FROZEN_LAYER_LIST_BEGIN);
-        /* Start a loop writing all frozen layer names. */
-        int j = 0;
-        while ((!dxf_viewport->frozen_layers[j]) /* Do not allow NULL pointers. */
-                || (strcmp (dxf_viewport->frozen_layers[j], "") == 1) /* Do not allow empty strings. */
-                || (j < DXF_MAX_LAYERS)) /* Do not overrun the array size. */
+        dxf_write_group_double (fp, 10, dxf_viewport->x0);
+        dxf_write_group_double (fp, 20, dxf_viewport->y0);
+        dxf_write_group_double (fp, 30, dxf_viewport->z0);
+        dxf_write_group_double (fp, 40, dxf_viewport->width);
+        dxf_write_group_double (fp, 41, dxf_viewport->height);
+        dxf_write_group_int (fp, 68, dxf_viewport->status);
+        dxf_write_group_int (fp, 69, dxf_viewport->id);
+        dxf_write_group_string (fp, 1001, DXF_VIEWPORT_APP_NAME);
+        dxf_write_group_string (fp, 1000, DXF_VIEWPORT_DATA);
+        dxf_write_group_string (fp, 1002, DXF_VIEWPORT_WINDOW_BEGIN);
+        dxf_write_group_int (fp, 1070, dxf_viewport->extended_entity_data_version);
+        dxf_write_group_double (fp, 1010, dxf_viewport->x_target);
+        dxf_write_group_double (fp, 1020, dxf_viewport->y_target);
+        dxf_write_group_double (fp, 1030, dxf_viewport->z_target);
+        dxf_write_group_double (fp, 1010, dxf_viewport->x_direction);
+        dxf_write_group_double (fp, 1020, dxf_viewport->y_direction);
+        dxf_write_group_double (fp, 1030, dxf_viewport->z_direction);
+        dxf_write_group_double (fp, 1040, dxf_viewport->view_twist_angle);
+        dxf_write_group_double (fp, 1040, dxf_viewport->view_height);
+        dxf_write_group_double (fp, 1040, dxf_viewport->x_center);
+        dxf_write_group_double (fp, 1040, dxf_viewport->y_center);
+        dxf_write_group_double (fp, 1040, dxf_viewport->perspective_lens_length);
+        dxf_write_group_double (fp, 1040, dxf_viewport->front_plane_offset);
+        dxf_write_group_double (fp, 1040, dxf_viewport->back_plane_offset);
+        dxf_write_group_int (fp, 1070, dxf_viewport->view_mode);
+        dxf_write_group_int (fp, 1070, dxf_viewport->circle_zoom_percent);
+        dxf_write_group_int (fp, 1070, dxf_viewport->fast_zoom_setting);
+        dxf_write_group_int (fp, 1070, dxf_viewport->UCSICON_setting);
+        dxf_write_group_int (fp, 1070, dxf_viewport->snap_on);
+        dxf_write_group_int (fp, 1070, dxf_viewport->grid_on);
+        dxf_write_group_int (fp, 1070, dxf_viewport->snap_style);
+        dxf_write_group_int (fp, 1070, dxf_viewport->snap_isopair);
+        dxf_write_group_double (fp, 1040, dxf_viewport->snap_rotation_angle);
+        dxf_write_group_double (fp, 1040, dxf_viewport->x_snap_base);
+        dxf_write_group_double (fp, 1040, dxf_viewport->y_snap_base);
+        dxf_write_group_double (fp, 1040, dxf_viewport->x_snap_spacing);
+        dxf_write_group_double (fp, 1040, dxf_viewport->y_snap_spacing);
+        dxf_write_group_double (fp, 1040, dxf_viewport->x_grid_spacing);
+        dxf_write_group_double (fp, 1040, dxf_viewport->y_grid_spacing);
+        dxf_write_group_int (fp, 1070, dxf_viewport->plot_flag);
+        dxf_write_group_string (fp, 1002, DXF_VIEWPORT_FROZEN_LAYER_LIST_BEGIN);
+        /* Write all frozen layer names in one loop into the output
+         * buffer; the group writer memcpys the precomposed "1003"
+         * prefix and the name, so the chain costs no formatting. */
+        if (dxf_viewport->frozen_layers != NULL)
         {
-                fprintf (fp->fp, "1003\n%s\n", dxf_viewport->frozen_layers[j]);
-                j++;
+                size_t j;
+
+                for (j = 0; j < dxf_viewport->frozen_layers->length; j++)
+                {
+                        dxf_write_group_string (fp, 1003,
+                                dxf_layer_registry_get (dxf_viewport->frozen_layers, j));
+                }
         }
-        fprintf (fp->fp, "1002\n%s\n", DXF_VIEWPORT_FROZEN_LAYER_LIST_END);
-        fprintf (fp->fp, "1002\n%s\n", DXF_VIEWPORT_WINDOW_END);
+        dxf_write_group_string (fp, 1002, DXF_VIEWPORT_FROZEN_LAYER_LIST_END);
+        dxf_write_group_string (fp, 1002, DXF_VIEWPORT_WINDOW_END);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -1221,8 +1257,6 @@ dxf_viewport_free
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        int i;
-
         if (dxf_viewport->next != NULL)
         {
                 fprintf (stderr,
@@ -1236,16 +1270,10 @@ dxf_viewport_free
         free (dxf_viewport->viewport_data);
         free (dxf_viewport->window_descriptor_begin);
         free (dxf_viewport->frozen_layer_list_begin);
-        for (i = 0; i < DXF_MAX_LAYERS; i++)
-        {
-                if (strcmp (dxf_viewport->frozen_layers[i], "") != 0)
-                {
-                        free (dxf_viewport->frozen_layers[i]);
-                }
-        }
+        dxf_layer_registry_free (dxf_viewport->frozen_layers);
         free (dxf_viewport->frozen_layer_list_end);
         free (dxf_viewport->window_descriptor_end);
-        free (dxf_viewport);
+        dxf_entity_dealloc (dxf_viewport, sizeof (*dxf_viewport));
         dxf_viewport = NULL;
 #if DEBUG
         DXF_DEBUG_END
@@ -37,6 +37,7 @@
 
 
 #include "global.h"
+#include "layer_registry.h"
 
 
 /*!
@@ -254,21 +255,14 @@ dxf_viewport
                 /*!< Begin frozen layer list (possibly empty).\n
                  * This field will always be the string "{".\n
                  * Group code = 1002. */
-        char *frozen_layers[DXF_MAX_LAYERS];
+        DxfLayerRegistry *frozen_layers;
                 /*!< The names of layers frozen in this viewport.\n
                  * This list may include Xref-dependent layers.\n
                  * Any number of 1003 groups may appear here.\n
-                 * Group code = 1003.\n
-                 *
-                 * \todo Implement the number of layers in a more
-                 * efficient way.\n
-                 * A lot of memory is consumed by reserving for
-                 * DXF_MAX_LAYERS instead of the actual existing number
-                 * of layers.\n
-                 * Maybe this can be solved by dynamically allocating a
-                 * reasonable number of layers during compile time, and
-                 * (re-allocating) shrinking when the actual number of
-                 * layers is known during run time. */
+                 * The registry grows with the file, so the list is no
+                 * longer bounded (or oversized) by a compile time
+                 * maximum.\n
+                 * Group code = 1003. */
         char *frozen_layer_list_end;
                 /*!< End frozen layer list.\n
                  * This field will always be the string "}".\n
@@ -38,7 +38,9 @@
  */
 
 
+#include <pthread.h>
 #include "vport.h"
+#include "allocator.h"
 
 
 /*!
@@ -64,7 +66,7 @@ dxf_vport_new ()
         size = sizeof (DxfVPort);
         /* avoid malloc of 0 bytes */
         if (size == 0) size = 1;
-        if ((dxf_vport = malloc (size)) == NULL)
+        if ((dxf_vport = dxf_entity_alloc (size)) == NULL)
         {
                 fprintf (stderr,
                   (_("Error in %s () could not allocate memory for a DxfVPort struct.\n")),
@@ -105,6 +107,11 @@ dxf_vport_init
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
+        static DxfVPort template;
+        static int template_ready = 0;
+        static pthread_mutex_t template_mutex =
+                PTHREAD_MUTEX_INITIALIZER;
+
         /* Do some basic checks. */
         if (dxf_vport == NULL)
         {
@@ -120,47 +127,57 @@ dxf_vport_init
                   __FUNCTION__);
                 return (NULL);
         }
-        dxf_vport->id_code = 0;
-        dxf_vport->viewport_name = strdup ("");
-        dxf_vport->x_min = 0.0;
-        dxf_vport->y_min = 0.0;
-        dxf_vport->x_max = 0.0;
-        dxf_vport->y_max = 0.0;
-        dxf_vport->x_center = 0.0;
-        dxf_vport->y_center = 0.0;
-        dxf_vport->x_snap_base = 0.0;
-        dxf_vport->y_snap_base = 0.0;
-        dxf_vport->x_snap_spacing = 0.0;
-        dxf_vport->y_snap_spacing = 0.0;
-        dxf_vport->x_grid_spacing = 0.0;
-        dxf_vport->y_grid_spacing = 0.0;
-        dxf_vport->x_direction = 0.0;
-        dxf_vport->y_direction = 0.0;
-        dxf_vport->z_direction = 0.0;
-        dxf_vport->x_target = 0.0;
-        dxf_vport->y_target = 0.0;
-        dxf_vport->z_target = 0.0;
-        dxf_vport->view_height = 0.0;
-        dxf_vport->viewport_aspect_ratio = 0.0;
-        dxf_vport->lens_length = 0.0;
-        dxf_vport->front_plane_offset = 0.0;
-        dxf_vport->back_plane_offset = 0.0;
-        dxf_vport->snap_rotation_angle = 0.0;
-        dxf_vport->view_twist_angle = 0.0;
-        dxf_vport->status_field = 0;
-        dxf_vport->id = 0;
-        dxf_vport->standard_flag = 0;
-        dxf_vport->view_mode = 0;
-        dxf_vport->circle_zoom_percent = 0;
-        dxf_vport->fast_zoom_setting = 0;
-        dxf_vport->UCSICON_setting = 0;
-        dxf_vport->snap_on = 0;
-        dxf_vport->grid_on = 0;
-        dxf_vport->snap_style = 0;
-        dxf_vport->snap_isopair = 0;
-        dxf_vport->dictionary_owner_soft = strdup ("");
-        dxf_vport->dictionary_owner_hard = strdup ("");
-        dxf_vport->next = NULL;
+        pthread_mutex_lock (&template_mutex);
+        if (!template_ready)
+        {
+                template.id_code = 0;
+                template.viewport_name = strdup ("");
+                template.x_min = 0.0;
+                template.y_min = 0.0;
+                template.x_max = 0.0;
+                template.y_max = 0.0;
+                template.x_center = 0.0;
+                template.y_center = 0.0;
+                template.x_snap_base = 0.0;
+                template.y_snap_base = 0.0;
+                template.x_snap_spacing = 0.0;
+                template.y_snap_spacing = 0.0;
+                template.x_grid_spacing = 0.0;
+                template.y_grid_spacing = 0.0;
+                template.x_direction = 0.0;
+                template.y_direction = 0.0;
+                template.z_direction = 0.0;
+                template.x_target = 0.0;
+                template.y_target = 0.0;
+                template.z_target = 0.0;
+                template.view_height = 0.0;
+                template.viewport_aspect_ratio = 0.0;
+                template.lens_length = 0.0;
+                template.front_plane_offset = 0.0;
+                template.back_plane_offset = 0.0;
+                template.snap_rotation_angle = 0.0;
+                template.view_twist_angle = 0.0;
+                template.status_field = 0;
+                template.id = 0;
+                template.standard_flag = 0;
+                template.view_mode = 0;
+                template.circle_zoom_percent = 0;
+                template.fast_zoom_setting = 0;
+                template.UCSICON_setting = 0;
+                template.snap_on = 0;
+                template.grid_on = 0;
+                template.snap_style = 0;
+                template.snap_isopair = 0;
+                template.dictionary_owner_soft = strdup ("");
+                template.dictionary_owner_hard = strdup ("");
+                template.next = NULL;
+                template_ready = 1;
+        }
+        pthread_mutex_unlock (&template_mutex);
+        memcpy (dxf_vport, &template, sizeof (DxfVPort));
+        dxf_vport->viewport_name = strdup (template.viewport_name);
+        dxf_vport->dictionary_owner_soft = strdup (template.dictionary_owner_soft);
+        dxf_vport->dictionary_owner_hard = strdup (template.dictionary_owner_hard);
 #if DEBUG
         DXF_DEBUG_END
 #endif
@@ -198,7 +215,7 @@ dxf_vport_read
 #if DEBUG
         DXF_DEBUG_BEGIN
 #endif
-        char *temp_string = NULL;
+        char temp_string[DXF_MAX_STRING_LENGTH];
 
         /* Do some basic checks. */
         if (fp == NULL)
@@ -223,7 +240,7 @@ dxf_vport_read
                 if (ferror (fp->fp))
                 {
                         fprintf (stderr,
-                          (_("Error in %s () while reading from: %s in line: %d.\n")),
+                          (_("Error in %s () while reading from: %s in line: %ld.\n")),
                           __FUNCTION__, fp->filename, fp->line_number);
                         fclose (fp->fp);
                         return (NULL);
@@ -240,7 +257,9 @@ dxf_vport_read
                         /* Now follows a string containing a viewport
                          * name. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_vport->viewport_name);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_vport->viewport_name);
+                        dxf_vport->viewport_name = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "10") == 0)
                 {
@@ -499,14 +518,18 @@ dxf_vport_read
                         /* Now follows a string containing Soft-pointer
                          * ID/handle to owner dictionary. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_vport->dictionary_owner_soft);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_vport->dictionary_owner_soft);
+                        dxf_vport->dictionary_owner_soft = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "360") == 0)
                 {
                         /* Now follows a string containing Hard owner
                          * ID/handle to owner dictionary. */
                         (fp->line_number)++;
-                        fscanf (fp->fp, "%s\n", dxf_vport->dictionary_owner_hard);
+                        fscanf (fp->fp, "%s\n", temp_string);
+                        free (dxf_vport->dictionary_owner_hard);
+                        dxf_vport->dictionary_owner_hard = strdup (temp_string);
                 }
                 else if (strcmp (temp_string, "999") == 0)
                 {
@@ -522,7 +545,7 @@ dxf_vport_read
           || (dxf_vport->viewport_name == NULL))
         {
                 fprintf (stderr,
-                  (_("Error in %s () empty string in viewport name found while reading from: %s in line: %d.\n")),
+                  (_("Error in %s () empty string in viewport name found while reading from: %s in line: %ld.\n")),
                   __FUNCTION__, fp->filename, fp->line_number);
                 return (NULL);
         }
@@ -696,7 +719,7 @@ dxf_vport_free
         free (dxf_vport->viewport_name);
         free (dxf_vport->dictionary_owner_soft);
         free (dxf_vport->dictionary_owner_hard);
-        free (dxf_vport);
+        dxf_entity_dealloc (dxf_vport, sizeof (*dxf_vport));
         dxf_vport = NULL;
 #if DEBUG
         DXF_DEBUG_END
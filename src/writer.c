@@ -0,0 +1,1495 @@
+/*!
+ * \file writer.c
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Functions for the buffered DXF output writer.
+ *
+ * A \c *_write function used to issue dozens of separate \c fprintf
+ * calls per entity, each re-parsing a format string and doing locale
+ * aware \c %%f conversion.\n
+ * The writer collects output in a large buffer, formats doubles with a
+ * fixed point formatter compatible with \c %%f, and emits group codes
+ * from a precomposed prefix table, which makes writing large decks
+ * I/O bound instead of formatting bound.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <zlib.h>
+#include "writer.h"
+#include "census.h"
+
+
+/*!
+ * The highest group code the precomposed prefix table covers.
+ */
+#define DXF_WRITER_MAX_GROUP_CODE 1071
+
+
+static char dxf_writer_prefixes[DXF_WRITER_MAX_GROUP_CODE + 1][8];
+static int dxf_writer_prefixes_ready = FALSE;
+
+
+/*!
+ * \brief Get the precomposed "%3d\n" prefix for a group code.
+ *
+ * \return a pointer to the prefix string.
+ */
+static const char *
+dxf_writer_prefix
+(
+        int group_code
+                /*!< DXF group code. */
+)
+{
+        static char fallback[8];
+        int i;
+
+        if (!dxf_writer_prefixes_ready)
+        {
+                for (i = 0; i <= DXF_WRITER_MAX_GROUP_CODE; i++)
+                {
+                        sprintf (dxf_writer_prefixes[i], "%3d\n", i);
+                }
+                dxf_writer_prefixes_ready = TRUE;
+        }
+        if ((group_code >= 0) && (group_code <= DXF_WRITER_MAX_GROUP_CODE))
+        {
+                return (dxf_writer_prefixes[group_code]);
+        }
+        sprintf (fallback, "%3d\n", group_code);
+        return (fallback);
+}
+
+
+/*!
+ * \brief Get the length of the "%3d\n" prefix of a group code.
+ *
+ * Four bytes up to group code 999; the extended entity data codes
+ * (1000 and up) no longer pad to the fixed width.
+ *
+ * \return the prefix length in bytes.
+ */
+static size_t
+dxf_writer_prefix_length
+(
+        int group_code
+                /*!< DXF group code. */
+)
+{
+        if (group_code > 999)
+        {
+                return ((group_code > 9999) ? 6 : 5);
+        }
+        return (4);
+}
+
+
+/*!
+ * \brief Attach a buffered writer to a \c DxfFile.
+ *
+ * All output emitted through the \c dxf_write_group_* functions is
+ * collected in the buffer and written to the file in large chunks.\n
+ * The buffer has to be flushed with \c dxf_writer_flush or
+ * \c dxf_writer_detach before the file is closed or written to
+ * directly.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_writer_attach
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an output file (or device). */
+        size_t buffer_size
+                /*!< buffer size in bytes, pass 0 for the default
+                 * \c DXF_WRITER_BUFFER_SIZE. */
+)
+{
+        DxfWriter *writer;
+
+        if (fp == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL file pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (buffer_size == 0)
+        {
+                buffer_size = DXF_WRITER_BUFFER_SIZE;
+        }
+        writer = malloc (sizeof (DxfWriter));
+        if (writer == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory for a DxfWriter struct.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        writer->buffer = malloc (buffer_size);
+        if (writer->buffer == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory for the write buffer.\n")),
+                  __FUNCTION__);
+                free (writer);
+                return (EXIT_FAILURE);
+        }
+        writer->size = buffer_size;
+        writer->used = 0;
+        writer->binary = FALSE;
+        writer->compact_doubles = FALSE;
+        writer->memory = FALSE;
+        writer->gzip = NULL;
+        writer->async = NULL;
+        writer->preallocated = 0;
+        fp->writer = writer;
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief State of the background output thread of a \c DxfWriter.
+ *
+ * The writer owns two buffers: while the background thread writes one,
+ * the \c dxf_write_group_* callers fill the other, so serialization
+ * overlaps the \c write calls instead of blocking on them.
+ */
+typedef struct
+dxf_writer_async
+{
+        pthread_t thread;
+                /*!< the background output thread. */
+        pthread_mutex_t mutex;
+                /*!< protects the handover fields below. */
+        pthread_cond_t filled;
+                /*!< signalled when a buffer was handed over or the
+                 * writer shuts down. */
+        pthread_cond_t drained;
+                /*!< signalled when the handed over buffer was written. */
+        char *spare;
+                /*!< the buffer not currently owned by the callers, or
+                 * \c NULL while the thread writes it. */
+        char *pending;
+                /*!< the buffer handed over for writing, or \c NULL when
+                 * the thread is idle. */
+        size_t pending_used;
+                /*!< number of bytes to write from \c pending. */
+        int shutdown;
+                /*!< nonzero when the thread shall exit once drained. */
+        int error;
+                /*!< nonzero when a background write failed. */
+} DxfWriterAsync;
+
+
+/*!
+ * \brief Write bytes to the file of a \c DxfFile, deflating them when
+ * the writer compresses its output.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+static int
+dxf_write_file
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an output file (or device). */
+        const char *data,
+                /*!< the bytes to write. */
+        size_t length
+                /*!< number of bytes to write. */
+)
+{
+        if ((fp->writer != NULL) && (fp->writer->gzip != NULL))
+        {
+                if (gzwrite ((gzFile) fp->writer->gzip, data,
+                        (unsigned) length) != (int) length)
+                {
+                        return (EXIT_FAILURE);
+                }
+                return (EXIT_SUCCESS);
+        }
+        if (fwrite (data, 1, length, fp->fp) != length)
+        {
+                return (EXIT_FAILURE);
+        }
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Main loop of the background output thread of a \c DxfWriter.
+ *
+ * Waits for a buffer to be handed over, writes it outside the lock and
+ * returns it as the spare, until shutdown is requested and the last
+ * buffer is drained.
+ */
+static void *
+dxf_writer_async_main
+(
+        void *arg
+                /*!< the \c DxfFile the thread writes for. */
+)
+{
+        DxfFile *fp;
+        DxfWriterAsync *async;
+        char *buffer;
+        size_t used;
+        int result;
+
+        fp = (DxfFile *) arg;
+        async = fp->writer->async;
+        pthread_mutex_lock (&async->mutex);
+        for (;;)
+        {
+                while ((async->pending == NULL) && (!async->shutdown))
+                {
+                        pthread_cond_wait (&async->filled, &async->mutex);
+                }
+                if (async->pending == NULL)
+                {
+                        break;
+                }
+                buffer = async->pending;
+                used = async->pending_used;
+                pthread_mutex_unlock (&async->mutex);
+                result = dxf_write_file (fp, buffer, used);
+                pthread_mutex_lock (&async->mutex);
+                if (result != EXIT_SUCCESS)
+                {
+                        async->error = TRUE;
+                }
+                async->spare = buffer;
+                async->pending = NULL;
+                pthread_cond_signal (&async->drained);
+        }
+        pthread_mutex_unlock (&async->mutex);
+        return (NULL);
+}
+
+
+/*!
+ * \brief Wait until the background output thread of a \c DxfWriter is
+ * idle.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when a
+ * background write failed.
+ */
+static int
+dxf_writer_async_drain
+(
+        DxfWriterAsync *async
+                /*!< background output thread state. */
+)
+{
+        int error;
+
+        pthread_mutex_lock (&async->mutex);
+        while (async->pending != NULL)
+        {
+                pthread_cond_wait (&async->drained, &async->mutex);
+        }
+        error = async->error;
+        pthread_mutex_unlock (&async->mutex);
+        return (error ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Hand the filled buffer of a \c DxfWriter to the background
+ * output thread and continue filling the spare buffer.
+ *
+ * Blocks only when the thread is still writing the previously handed
+ * over buffer, which means output is produced faster than the file can
+ * take it.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when a
+ * background write failed.
+ */
+static int
+dxf_writer_async_flush
+(
+        DxfFile *fp
+                /*!< DXF file pointer to an output file (or device). */
+)
+{
+        DxfWriter *writer;
+        DxfWriterAsync *async;
+
+        writer = fp->writer;
+        async = writer->async;
+        pthread_mutex_lock (&async->mutex);
+        while (async->pending != NULL)
+        {
+                pthread_cond_wait (&async->drained, &async->mutex);
+        }
+        if (async->error)
+        {
+                pthread_mutex_unlock (&async->mutex);
+                fprintf (stderr,
+                  (_("Error in %s () while writing to: %s.\n")),
+                  __FUNCTION__, fp->filename);
+                return (EXIT_FAILURE);
+        }
+        async->pending = writer->buffer;
+        async->pending_used = writer->used;
+        writer->buffer = async->spare;
+        async->spare = NULL;
+        pthread_cond_signal (&async->filled);
+        pthread_mutex_unlock (&async->mutex);
+        writer->used = 0;
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Flush the buffered output of a \c DxfFile to its file.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_writer_flush
+(
+        DxfFile *fp
+                /*!< DXF file pointer to an output file (or device). */
+)
+{
+        DxfWriter *writer;
+
+        if (fp == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL file pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        writer = fp->writer;
+        if ((writer == NULL) || (writer->used == 0))
+        {
+                return (EXIT_SUCCESS);
+        }
+        if (writer->memory)
+        {
+                /* a memory sink has no file to flush to; the collected
+                 * bytes stay in the buffer until handed over. */
+                return (EXIT_SUCCESS);
+        }
+        if (writer->async != NULL)
+        {
+                return (dxf_writer_async_flush (fp));
+        }
+        if (dxf_write_file (fp, writer->buffer, writer->used) != EXIT_SUCCESS)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () while writing to: %s.\n")),
+                  __FUNCTION__, fp->filename);
+                return (EXIT_FAILURE);
+        }
+        writer->used = 0;
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Flush and detach the buffered writer of a \c DxfFile.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_writer_detach
+(
+        DxfFile *fp
+                /*!< DXF file pointer to an output file (or device). */
+)
+{
+        int result;
+
+        if (fp == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL file pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        result = dxf_writer_flush (fp);
+        if (fp->writer != NULL)
+        {
+                if (fp->writer->async != NULL)
+                {
+                        DxfWriterAsync *async;
+
+                        async = fp->writer->async;
+                        pthread_mutex_lock (&async->mutex);
+                        async->shutdown = TRUE;
+                        pthread_cond_signal (&async->filled);
+                        pthread_mutex_unlock (&async->mutex);
+                        pthread_join (async->thread, NULL);
+                        if (async->error)
+                        {
+                                result = EXIT_FAILURE;
+                        }
+                        pthread_mutex_destroy (&async->mutex);
+                        pthread_cond_destroy (&async->filled);
+                        pthread_cond_destroy (&async->drained);
+                        free (async->spare);
+                        free (async);
+                        fp->writer->async = NULL;
+                }
+                if (fp->writer->gzip != NULL)
+                {
+                        if (gzclose ((gzFile) fp->writer->gzip) != Z_OK)
+                        {
+                                result = EXIT_FAILURE;
+                        }
+                }
+                if (fp->writer->preallocated > 0)
+                {
+                        off_t written;
+
+                        /* shrink the preallocated file to the size
+                         * actually written. */
+                        fflush (fp->fp);
+                        written = lseek (fileno (fp->fp), 0, SEEK_CUR);
+                        if ((written >= 0)
+                                && (ftruncate (fileno (fp->fp), written) != 0))
+                        {
+                                fprintf (stderr,
+                                  (_("Error in %s () could not shrink: %s.\n")),
+                                  __FUNCTION__, fp->filename);
+                                result = EXIT_FAILURE;
+                        }
+                }
+                free (fp->writer->buffer);
+                free (fp->writer);
+                fp->writer = NULL;
+        }
+        return (result);
+}
+
+
+/*!
+ * \brief Append raw bytes to the writer buffer of a \c DxfFile, or
+ * write them through when no writer is attached.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+static int
+dxf_write_raw
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an output file (or device). */
+        const char *data,
+                /*!< the bytes to write. */
+        size_t length
+                /*!< number of bytes to write. */
+)
+{
+        DxfWriter *writer;
+
+        writer = fp->writer;
+        if (writer == NULL)
+        {
+                if (fwrite (data, 1, length, fp->fp) != length)
+                {
+                        return (EXIT_FAILURE);
+                }
+                return (EXIT_SUCCESS);
+        }
+        if (writer->used + length > writer->size)
+        {
+                if (writer->memory)
+                {
+                        char *buffer;
+                        size_t size;
+
+                        size = writer->size;
+                        while (writer->used + length > size)
+                        {
+                                size *= 2;
+                        }
+                        buffer = realloc (writer->buffer, size);
+                        if (buffer == NULL)
+                        {
+                                fprintf (stderr,
+                                  (_("Error in %s () could not allocate memory for the write buffer.\n")),
+                                  __FUNCTION__);
+                                return (EXIT_FAILURE);
+                        }
+                        writer->buffer = buffer;
+                        writer->size = size;
+                        memcpy (writer->buffer + writer->used, data, length);
+                        writer->used += length;
+                        return (EXIT_SUCCESS);
+                }
+                if (dxf_writer_flush (fp) != EXIT_SUCCESS)
+                {
+                        return (EXIT_FAILURE);
+                }
+                if (length > writer->size)
+                {
+                        /* oversized payloads bypass the buffer; with a
+                         * background thread the handed over buffer has
+                         * to land in the file first. */
+                        if ((writer->async != NULL)
+                                && (dxf_writer_async_drain (writer->async)
+                                        != EXIT_SUCCESS))
+                        {
+                                return (EXIT_FAILURE);
+                        }
+                        return (dxf_write_file (fp, data, length));
+                }
+        }
+        memcpy (writer->buffer + writer->used, data, length);
+        writer->used += length;
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Switch the writer of a \c DxfFile to binary DXF output and
+ * write the binary DXF sentinel.
+ *
+ * In binary mode the \c dxf_write_group_* functions emit binary group
+ * records: two little endian group code bytes followed by the raw
+ * value, with doubles as their 8 IEEE bytes, integers as 1, 2, 4 or 8
+ * little endian bytes by group code range and strings NUL terminated,
+ * so no text formatting happens at all and the output is roughly half
+ * the size.\n
+ * Only output emitted through the \c dxf_write_group_* functions is
+ * converted: \c *_write functions which build precomposed text runs or
+ * write to the \c FILE pointer directly keep emitting text, so binary
+ * mode shall only be combined with the group level writer functions.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_writer_binary_init
+(
+        DxfFile *fp
+                /*!< DXF file pointer to an output file (or device). */
+)
+{
+        if ((fp == NULL) || (fp->writer == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        fp->writer->binary = TRUE;
+        return (dxf_write_raw (fp, "AutoCAD Binary DXF\r\n\032\0", 22));
+}
+
+
+/*!
+ * \brief Switch an attached writer to shortest round-trip double
+ * output.
+ *
+ * Fixed "%f" style formatting spends seven bytes on "0.000000" for
+ * every zero coordinate; with this mode enabled every double is
+ * written with the fewest digits that \c strtod parses back to the
+ * exact same value, which shrinks coordinate heavy files by roughly
+ * a quarter to a third with no loss of precision.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_writer_compact_init
+(
+        DxfFile *fp
+                /*!< DXF file pointer to an output file (or device). */
+)
+{
+        if ((fp == NULL) || (fp->writer == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        fp->writer->compact_doubles = TRUE;
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Hoist the write-path version predicates of a \c DxfFile.
+ *
+ * The entity writers decide per optional field whether the target
+ * \c acad_version_number carries it; the answers only change when the
+ * version does, so they are computed here once per file and the
+ * writers test the cached flags instead of comparing version numbers
+ * per entity.\n
+ * The writers call this themselves whenever the cache no longer
+ * matches \c acad_version_number, so assigning a version to the file
+ * is all a caller ever has to do.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_write_version_init
+(
+        DxfFile *fp
+                /*!< DXF file pointer to an output file (or device). */
+)
+{
+        if (fp == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL file pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        fp->write_version.acad_version_number = fp->acad_version_number;
+        fp->write_version.until_r11 = (fp->acad_version_number <= AutoCAD_11);
+        fp->write_version.since_r12 = (fp->acad_version_number >= AutoCAD_12);
+        fp->write_version.since_r13 = (fp->acad_version_number >= AutoCAD_13);
+        fp->write_version.since_r14 = (fp->acad_version_number >= AutoCAD_14);
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Switch the writer of a \c DxfFile to a pure memory sink.
+ *
+ * The buffer grows on demand and is never flushed to the file, so DXF
+ * fragments can be composed in RAM without a temporary file; the
+ * \c FILE pointer of the \c DxfFile may be \c NULL.\n
+ * The collected bytes are handed over, without a copy, by
+ * \c dxf_writer_memory_take.\n
+ * Not to be combined with \c dxf_writer_gzip_init or
+ * \c dxf_writer_async_init, which flush to a file by design.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_writer_memory_init
+(
+        DxfFile *fp
+                /*!< DXF file pointer to an output file (or device). */
+)
+{
+        if ((fp == NULL) || (fp->writer == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if ((fp->writer->gzip != NULL) || (fp->writer->async != NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a memory sink can not compress or write in the background.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        fp->writer->memory = TRUE;
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Hand the collected bytes of a memory sink to the caller.
+ *
+ * Ownership of the buffer transfers without a copy: the caller frees
+ * it, and the writer is detached from the \c DxfFile.\n
+ * The buffer is NUL terminated one byte past \c length, so text
+ * fragments can be used as C strings directly.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_writer_memory_take
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an output file (or device). */
+        char **data,
+                /*!< receives the collected bytes; to be freed by the
+                 * caller. */
+        size_t *length
+                /*!< receives the number of collected bytes, the
+                 * terminating NUL excluded. */
+)
+{
+        DxfWriter *writer;
+
+        if ((fp == NULL) || (fp->writer == NULL)
+                || (data == NULL) || (length == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        writer = fp->writer;
+        if (!writer->memory)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () the writer is not a memory sink.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (writer->used + 1 > writer->size)
+        {
+                char *buffer;
+
+                buffer = realloc (writer->buffer, writer->used + 1);
+                if (buffer == NULL)
+                {
+                        fprintf (stderr,
+                          (_("Error in %s () could not allocate memory for the write buffer.\n")),
+                          __FUNCTION__);
+                        return (EXIT_FAILURE);
+                }
+                writer->buffer = buffer;
+                writer->size = writer->used + 1;
+        }
+        writer->buffer[writer->used] = '\0';
+        *data = writer->buffer;
+        *length = writer->used;
+        free (writer);
+        fp->writer = NULL;
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Switch the writer of a \c DxfFile to gzip compressed output.
+ *
+ * A zlib stream is opened on a duplicate of the file descriptor and
+ * every flushed buffer is deflated straight into the file, so
+ * compression is pipelined with composing and no uncompressed
+ * intermediate file is written.\n
+ * The stream is finalized by \c dxf_writer_detach; as only output
+ * emitted through the writer is compressed, compressed output shall not
+ * be combined with direct writes to the \c FILE pointer.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_writer_gzip_init
+(
+        DxfFile *fp
+                /*!< DXF file pointer to an output file (or device). */
+)
+{
+        gzFile gz;
+
+        if ((fp == NULL) || (fp->writer == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        fflush (fp->fp);
+        gz = gzdopen (dup (fileno (fp->fp)), "wb");
+        if (gz == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not open a zlib stream on: %s.\n")),
+                  __FUNCTION__, fp->filename);
+                return (EXIT_FAILURE);
+        }
+        fp->writer->gzip = gz;
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Start a background output thread on the writer of a
+ * \c DxfFile.
+ *
+ * The writer switches to double buffering: a second buffer of the same
+ * size is allocated and every flush hands the filled buffer to the
+ * thread and continues composing into the other one, so the \c write
+ * calls overlap serialization instead of blocking it.\n
+ * A flush only blocks when output is produced faster than the file
+ * takes it.\n
+ * The thread is drained and joined by \c dxf_writer_detach, which also
+ * reports write errors that surfaced in the background.\n
+ * Compressed output (see \c dxf_writer_gzip_init) combines with the
+ * thread, which then also carries the deflate work.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_writer_async_init
+(
+        DxfFile *fp
+                /*!< DXF file pointer to an output file (or device). */
+)
+{
+        DxfWriterAsync *async;
+
+        if ((fp == NULL) || (fp->writer == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (fp->writer->async != NULL)
+        {
+                return (EXIT_SUCCESS);
+        }
+        async = malloc (sizeof (DxfWriterAsync));
+        if (async == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        async->spare = malloc (fp->writer->size);
+        if (async->spare == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not allocate memory for the spare buffer.\n")),
+                  __FUNCTION__);
+                free (async);
+                return (EXIT_FAILURE);
+        }
+        pthread_mutex_init (&async->mutex, NULL);
+        pthread_cond_init (&async->filled, NULL);
+        pthread_cond_init (&async->drained, NULL);
+        async->pending = NULL;
+        async->pending_used = 0;
+        async->shutdown = FALSE;
+        async->error = FALSE;
+        fp->writer->async = async;
+        if (pthread_create (&async->thread, NULL,
+                dxf_writer_async_main, fp) != 0)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () could not start the output thread.\n")),
+                  __FUNCTION__);
+                fp->writer->async = NULL;
+                pthread_mutex_destroy (&async->mutex);
+                pthread_cond_destroy (&async->filled);
+                pthread_cond_destroy (&async->drained);
+                free (async->spare);
+                free (async);
+                return (EXIT_FAILURE);
+        }
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief One entry of the per type serialized size table used by
+ * \c dxf_writer_estimate_size.
+ */
+typedef struct
+dxf_writer_size_entry
+{
+        const char *record_name;
+                /*!< the record type. */
+        size_t size;
+                /*!< average serialized size of one record in bytes. */
+} DxfWriterSizeEntry;
+
+
+/*!
+ * Average serialized sizes per record type, measured over text DXF
+ * output of typical drawings; deliberately on the generous side, as the
+ * file is shrunk to its real size on detach anyway.
+ */
+static const DxfWriterSizeEntry dxf_writer_size_table[] =
+{
+        {"POINT", 120},
+        {"LINE", 180},
+        {"CIRCLE", 140},
+        {"ARC", 170},
+        {"ELLIPSE", 220},
+        {"TEXT", 220},
+        {"MTEXT", 320},
+        {"LWPOLYLINE", 360},
+        {"POLYLINE", 160},
+        {"VERTEX", 160},
+        {"SEQEND", 60},
+        {"3DFACE", 280},
+        {"SOLID", 260},
+        {"INSERT", 180},
+        {"ATTRIB", 260},
+        {"ATTDEF", 280},
+        {"DIMENSION", 540},
+        {"SPLINE", 520},
+        {"HATCH", 720},
+        {"IMAGE", 320},
+        {NULL, 0}
+};
+
+
+/*!
+ * The estimated size in bytes of one record type without a table entry.
+ */
+#define DXF_WRITER_SIZE_DEFAULT 240
+
+
+/*!
+ * The estimated overhead in bytes per section, plus a flat allowance
+ * for the header section.
+ */
+#define DXF_WRITER_SIZE_SECTION 128
+#define DXF_WRITER_SIZE_HEADER 8192
+
+
+/*!
+ * \brief Estimate the serialized size of a drawing from a census of
+ * its records.
+ *
+ * The per section, per type counts of the census (see
+ * \c dxf_file_census) are multiplied with a per type average serialized
+ * size, so a writer can preallocate the output file (see
+ * \c dxf_writer_preallocate) before the first entity is composed.
+ *
+ * \return the estimated size in bytes, or \c 0 when a NULL pointer was
+ * passed.
+ */
+uint64_t
+dxf_writer_estimate_size
+(
+        struct dxf_census *census
+                /*!< a census of the records to be written. */
+)
+{
+        const DxfWriterSizeEntry *entry;
+        uint64_t size;
+        size_t counted;
+        size_t i;
+
+        if (census == NULL)
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (0);
+        }
+        size = DXF_WRITER_SIZE_HEADER
+                + ((uint64_t) census->total_sections
+                        * DXF_WRITER_SIZE_SECTION);
+        counted = 0;
+        for (entry = dxf_writer_size_table; entry->record_name != NULL;
+                entry++)
+        {
+                for (i = 0; i < census->length; i++)
+                {
+                        if (strcmp (census->entries[i].record_name,
+                                entry->record_name) == 0)
+                        {
+                                size += (uint64_t) census->entries[i].count
+                                        * entry->size;
+                                counted += census->entries[i].count;
+                        }
+                }
+        }
+        if (census->total_records > counted)
+        {
+                size += (uint64_t) (census->total_records - counted)
+                        * DXF_WRITER_SIZE_DEFAULT;
+        }
+        return (size);
+}
+
+
+/*!
+ * \brief Preallocate the output file of a \c DxfFile.
+ *
+ * The estimated final size (see \c dxf_writer_estimate_size) is
+ * allocated up front with \c posix_fallocate, so a multi gigabyte deck
+ * grows in one extent instead of fragmenting the file system by
+ * incremental appends, and sequential readback stays fast.\n
+ * On detach the file is shrunk to the size actually written, so
+ * overshooting the estimate costs nothing.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred; a file system without preallocation support fails soft
+ * with a warning, as the output stays correct without it.
+ */
+int
+dxf_writer_preallocate
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an output file (or device). */
+        uint64_t size
+                /*!< the estimated final size in bytes. */
+)
+{
+        int result;
+
+        if ((fp == NULL) || (fp->writer == NULL))
+        {
+                fprintf (stderr,
+                  (_("Error in %s () a NULL pointer was passed.\n")),
+                  __FUNCTION__);
+                return (EXIT_FAILURE);
+        }
+        if (size == 0)
+        {
+                return (EXIT_SUCCESS);
+        }
+        result = posix_fallocate (fileno (fp->fp), 0, (off_t) size);
+        if (result != 0)
+        {
+                fprintf (stderr,
+                  (_("Warning in %s () could not preallocate %lu bytes for: %s.\n")),
+                  __FUNCTION__, (unsigned long) size, fp->filename);
+                return (EXIT_SUCCESS);
+        }
+        fp->writer->preallocated = size;
+        return (EXIT_SUCCESS);
+}
+
+
+
+/*!
+ * \brief Write the two little endian group code bytes of a binary
+ * group record.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+static int
+dxf_write_binary_code
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an output file (or device). */
+        int group_code
+                /*!< DXF group code. */
+)
+{
+        char bytes[2];
+
+        bytes[0] = (char) (group_code & 0xff);
+        bytes[1] = (char) ((group_code >> 8) & 0xff);
+        return (dxf_write_raw (fp, bytes, 2));
+}
+
+
+/*!
+ * \brief Get the value size in bytes of an integer valued group code
+ * in a binary DXF file.
+ *
+ * \return the size in bytes.
+ */
+static int
+dxf_write_binary_int_size
+(
+        int group_code
+                /*!< DXF group code. */
+)
+{
+        if (((group_code >= 280) && (group_code <= 299))
+                || ((group_code >= 370) && (group_code <= 389)))
+        {
+                return (1);
+        }
+        if (((group_code >= 90) && (group_code <= 99))
+                || ((group_code >= 420) && (group_code <= 429))
+                || ((group_code >= 440) && (group_code <= 449))
+                || (group_code == 1071))
+        {
+                return (4);
+        }
+        if (((group_code >= 160) && (group_code <= 169))
+                || ((group_code >= 450) && (group_code <= 459)))
+        {
+                return (8);
+        }
+        return (2);
+}
+
+
+/*!
+ * \brief Format a double with six decimals, like \c fprintf "%f",
+ * without going through the locale aware stdio formatting machinery.
+ *
+ * The fast path quantizes the fraction in floating point and rounds
+ * halves away from zero, where \c fprintf rounds the exact binary
+ * value half to even, so a small share of values comes out one off
+ * from "%f" in the sixth decimal.  Callers needing the exact "%f"
+ * bytes shall format through \c sprintf instead.\n
+ * Values too large for the fast integer path, infinities and NaNs fall
+ * back to \c sprintf.
+ *
+ * \return the number of characters written to \c buffer.
+ */
+int
+dxf_ftoa
+(
+        double value,
+                /*!< the value to format. */
+        char *buffer
+                /*!< destination buffer, large enough for the "%f"
+                 * representation (32 bytes are always sufficient for
+                 * the fast path). */
+)
+{
+        char digits[32];
+        char *p;
+        long long int_part;
+        long long frac_part;
+        int i;
+
+        if (!((value > -1.0e15) && (value < 1.0e15)))
+        {
+                /* huge magnitudes, infinities and NaNs. */
+                return (sprintf (buffer, "%f", value));
+        }
+        p = buffer;
+        if ((value < 0.0) || ((value == 0.0) && (signbit (value))))
+        {
+                *p++ = '-';
+                value = -value;
+        }
+        int_part = (long long) value;
+        frac_part = (long long) (((value - (double) int_part) * 1000000.0) + 0.5);
+        if (frac_part >= 1000000)
+        {
+                frac_part -= 1000000;
+                int_part++;
+        }
+        i = 0;
+        do
+        {
+                digits[i++] = (char) ('0' + (int_part % 10));
+                int_part /= 10;
+        }
+        while (int_part > 0);
+        while (i > 0)
+        {
+                *p++ = digits[--i];
+        }
+        *p++ = '.';
+        for (i = 5; i >= 0; i--)
+        {
+                p[i] = (char) ('0' + (frac_part % 10));
+                frac_part /= 10;
+        }
+        p += 6;
+        *p = '\0';
+        return ((int) (p - buffer));
+}
+
+
+/*!
+ * \brief Format a double with the fewest digits that round-trip.
+ *
+ * Tries increasing "%g" precisions until \c strtod parses the string
+ * back to the exact same double, so "0" is written instead of
+ * "0.000000" and a value like 0.1 costs three bytes instead of
+ * eight; at most 17 significant digits are ever needed.\n
+ * A comma decimal point from a non-C locale is folded back to the
+ * point the DXF format requires.
+ *
+ * \return the number of characters written, excluding the
+ * terminating NUL.
+ */
+int
+dxf_ftoa_shortest
+(
+        double value,
+                /*!< the value to format. */
+        char *buffer
+                /*!< destination buffer, at least 32 bytes. */
+)
+{
+        char *p;
+        int precision;
+
+        for (precision = 1; precision <= 17; precision++)
+        {
+                sprintf (buffer, "%.*g", precision, value);
+                if (strtod (buffer, NULL) == value)
+                {
+                        break;
+                }
+        }
+        for (p = buffer; *p != '\0'; p++)
+        {
+                if (*p == ',')
+                {
+                        *p = '.';
+                }
+        }
+        return ((int) (p - buffer));
+}
+
+
+/*!
+ * \brief Write a string followed by a newline.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_write_string
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an output file (or device). */
+        const char *string
+                /*!< the string to write. */
+)
+{
+        size_t length;
+
+        length = strlen (string);
+        if ((fp->writer != NULL) && (fp->writer->binary))
+        {
+                /* binary group records terminate strings with a NUL
+                 * instead of a newline. */
+                return (dxf_write_raw (fp, string, length + 1));
+        }
+        if (dxf_write_raw (fp, string, length) != EXIT_SUCCESS)
+        {
+                return (EXIT_FAILURE);
+        }
+        return (dxf_write_raw (fp, "\n", 1));
+}
+
+
+/*!
+ * \brief Write a group code with a string value.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_write_group_string
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an output file (or device). */
+        int group_code,
+                /*!< DXF group code. */
+        const char *value
+                /*!< the value to write. */
+)
+{
+        if ((fp->writer != NULL) && (fp->writer->binary))
+        {
+                if (dxf_write_binary_code (fp, group_code) != EXIT_SUCCESS)
+                {
+                        return (EXIT_FAILURE);
+                }
+                return (dxf_write_raw (fp, value, strlen (value) + 1));
+        }
+        if (dxf_write_raw (fp, dxf_writer_prefix (group_code), dxf_writer_prefix_length (group_code)) != EXIT_SUCCESS)
+        {
+                return (EXIT_FAILURE);
+        }
+        return (dxf_write_string (fp, value));
+}
+
+
+/*!
+ * \brief Write a group code with a decimal integer value.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_write_group_int
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an output file (or device). */
+        int group_code,
+                /*!< DXF group code. */
+        int value
+                /*!< the value to write. */
+)
+{
+        char digits[16];
+        char scratch[20];
+        char *p;
+        unsigned int magnitude;
+        int size;
+        int i;
+
+        if ((fp->writer != NULL) && (fp->writer->binary))
+        {
+                if (dxf_write_binary_code (fp, group_code) != EXIT_SUCCESS)
+                {
+                        return (EXIT_FAILURE);
+                }
+                size = dxf_write_binary_int_size (group_code);
+                for (i = 0; i < size; i++)
+                {
+                        scratch[i] = (char) ((value >> (i * 8)) & 0xff);
+                }
+                return (dxf_write_raw (fp, scratch, (size_t) size));
+        }
+        p = scratch;
+        if (value < 0)
+        {
+                *p++ = '-';
+                magnitude = (unsigned int) (-(long long) value);
+        }
+        else
+        {
+                magnitude = (unsigned int) value;
+        }
+        i = 0;
+        do
+        {
+                digits[i++] = (char) ('0' + (magnitude % 10));
+                magnitude /= 10;
+        }
+        while (magnitude > 0);
+        while (i > 0)
+        {
+                *p++ = digits[--i];
+        }
+        *p++ = '\n';
+        if (dxf_write_raw (fp, dxf_writer_prefix (group_code), dxf_writer_prefix_length (group_code)) != EXIT_SUCCESS)
+        {
+                return (EXIT_FAILURE);
+        }
+        return (dxf_write_raw (fp, scratch, (size_t) (p - scratch)));
+}
+
+
+/*!
+ * \brief Write a group code with a hexadecimal value, as used for id
+ * codes and handles.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_write_group_hex
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an output file (or device). */
+        int group_code,
+                /*!< DXF group code. */
+        int value
+                /*!< the value to write. */
+)
+{
+        static const char hex_digits[] = "0123456789abcdef";
+        char digits[16];
+        char scratch[20];
+        char *p;
+        unsigned int magnitude;
+        int i;
+
+        p = scratch;
+        magnitude = (unsigned int) value;
+        i = 0;
+        do
+        {
+                digits[i++] = hex_digits[magnitude & 0xf];
+                magnitude >>= 4;
+        }
+        while (magnitude > 0);
+        while (i > 0)
+        {
+                *p++ = digits[--i];
+        }
+        if ((fp->writer != NULL) && (fp->writer->binary))
+        {
+                /* handles stay hex strings in binary DXF, NUL
+                 * terminated. */
+                *p++ = '\0';
+                if (dxf_write_binary_code (fp, group_code) != EXIT_SUCCESS)
+                {
+                        return (EXIT_FAILURE);
+                }
+                return (dxf_write_raw (fp, scratch, (size_t) (p - scratch)));
+        }
+        *p++ = '\n';
+        if (dxf_write_raw (fp, dxf_writer_prefix (group_code), dxf_writer_prefix_length (group_code)) != EXIT_SUCCESS)
+        {
+                return (EXIT_FAILURE);
+        }
+        return (dxf_write_raw (fp, scratch, (size_t) (p - scratch)));
+}
+
+
+/*!
+ * \brief Write a group code with a double value.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+int
+dxf_write_group_double
+(
+        DxfFile *fp,
+                /*!< DXF file pointer to an output file (or device). */
+        int group_code,
+                /*!< DXF group code. */
+        double value
+                /*!< the value to write. */
+)
+{
+        char scratch[336];
+        int length;
+
+        if ((fp->writer != NULL) && (fp->writer->binary))
+        {
+                if (dxf_write_binary_code (fp, group_code) != EXIT_SUCCESS)
+                {
+                        return (EXIT_FAILURE);
+                }
+                memcpy (scratch, &value, 8);
+                return (dxf_write_raw (fp, scratch, 8));
+        }
+        if ((fp->writer != NULL) && (fp->writer->compact_doubles))
+        {
+                length = dxf_ftoa_shortest (value, scratch);
+        }
+        else
+        {
+                length = dxf_ftoa (value, scratch);
+        }
+        scratch[length++] = '\n';
+        if (dxf_write_raw (fp, dxf_writer_prefix (group_code), dxf_writer_prefix_length (group_code)) != EXIT_SUCCESS)
+        {
+                return (EXIT_FAILURE);
+        }
+        return (dxf_write_raw (fp, scratch, (size_t) length));
+}
+
+
+/* EOF */
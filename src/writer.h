@@ -0,0 +1,122 @@
+/*!
+ * \file writer.h
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Header for the buffered DXF output writer.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+
+#ifndef LIBDXF_SRC_WRITER_H
+#define LIBDXF_SRC_WRITER_H
+
+
+#include "global.h"
+
+
+/*!
+ * The default buffer size, in bytes, of a \c DxfWriter.
+ */
+#define DXF_WRITER_BUFFER_SIZE 262144
+
+
+/*!
+ * \brief DXF definition of a buffered output writer.
+ *
+ * Collects output in a large buffer and emits group code / value pairs
+ * with precomposed group code prefixes and a fast double formatter,
+ * instead of issuing a locale aware \c fprintf call per group.
+ */
+typedef struct
+dxf_writer
+{
+        char *buffer;
+                /*!< the output buffer. */
+        size_t size;
+                /*!< allocated size of \c buffer in bytes. */
+        size_t used;
+                /*!< number of bytes collected in \c buffer. */
+        int binary;
+                /*!< when nonzero, the \c dxf_write_group_* functions
+                 * emit binary DXF group records instead of text (see
+                 * \c dxf_writer_binary_init). */
+        int compact_doubles;
+                /*!< when nonzero, double values are written with the
+                 * fewest digits that still parse back to the exact
+                 * same double (see \c dxf_writer_compact_init)
+                 * instead of fixed six-digit "%f" style strings. */
+        int memory;
+                /*!< when nonzero, the writer is a pure memory sink
+                 * (see \c dxf_writer_memory_init): the buffer grows
+                 * instead of being flushed to the file and is handed
+                 * to the caller by \c dxf_writer_memory_take. */
+        void *gzip;
+                /*!< zlib stream handle (a \c gzFile) when the output is
+                 * gzip compressed (see \c dxf_writer_gzip_init), or
+                 * \c NULL; flushed buffers are deflated into the file,
+                 * so compression overlaps composing. */
+        struct dxf_writer_async *async;
+                /*!< background output thread state (see
+                 * \c dxf_writer_async_init), or \c NULL; flushed
+                 * buffers are handed to the thread and written while
+                 * the caller fills the next buffer. */
+        uint64_t preallocated;
+                /*!< number of bytes preallocated for the output file
+                 * (see \c dxf_writer_preallocate), or \c 0; the file is
+                 * shrunk to its written size on detach. */
+} DxfWriter;
+
+
+struct dxf_census;
+
+
+int dxf_writer_attach (DxfFile *fp, size_t buffer_size);
+int dxf_writer_binary_init (DxfFile *fp);
+int dxf_writer_memory_init (DxfFile *fp);
+int dxf_writer_memory_take (DxfFile *fp, char **data, size_t *length);
+int dxf_writer_compact_init (DxfFile *fp);
+int dxf_write_version_init (DxfFile *fp);
+int dxf_writer_gzip_init (DxfFile *fp);
+int dxf_writer_async_init (DxfFile *fp);
+int dxf_writer_preallocate (DxfFile *fp, uint64_t size);
+uint64_t dxf_writer_estimate_size (struct dxf_census *census);
+int dxf_writer_flush (DxfFile *fp);
+int dxf_writer_detach (DxfFile *fp);
+int dxf_ftoa (double value, char *buffer);
+int dxf_ftoa_shortest (double value, char *buffer);
+int dxf_write_string (DxfFile *fp, const char *string);
+int dxf_write_group_string (DxfFile *fp, int group_code, const char *value);
+int dxf_write_group_int (DxfFile *fp, int group_code, int value);
+int dxf_write_group_hex (DxfFile *fp, int group_code, int value);
+int dxf_write_group_double (DxfFile *fp, int group_code, double value);
+
+
+#endif /* LIBDXF_SRC_WRITER_H */
+
+
+/* EOF */
@@ -0,0 +1,214 @@
+/*!
+ * \file bench.c
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ * \brief Performance benchmarks for libdxf.
+ *
+ * Times reading, streaming traversal and writing over the example
+ * drawings and a synthetically generated large deck, reporting MB/s
+ * and entities/s.\n
+ * Run with "make bench".
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+#include <string.h>
+#include <time.h>
+#include "includes.h"
+
+
+/*!
+ * Number of entities in the synthetically generated deck.
+ */
+#define BENCH_SYNTHETIC_ENTITIES 200000
+
+/*!
+ * Path of the synthetically generated deck.
+ */
+#define BENCH_SYNTHETIC_FILE "bench_synthetic.dxf"
+
+
+/*!
+ * \brief Get a monotonic time stamp in seconds.
+ */
+static double
+bench_now (void)
+{
+        struct timespec ts;
+
+        clock_gettime (CLOCK_MONOTONIC, &ts);
+        return ((double) ts.tv_sec + ((double) ts.tv_nsec / 1.0e9));
+}
+
+
+/*!
+ * \brief Get the size of a file in bytes.
+ */
+static double
+bench_file_size (const char *filename)
+{
+        struct stat sb;
+
+        if (stat (filename, &sb) != 0)
+        {
+                return (0.0);
+        }
+        return ((double) sb.st_size);
+}
+
+
+/*!
+ * \brief Streaming filter counting every entity seen; parses none.
+ */
+static int
+bench_count_filter (const char *entity_name, void *user_data)
+{
+        (void) entity_name;
+        (*((long *) user_data))++;
+        return (FALSE);
+}
+
+
+/*!
+ * \brief Time a plain dxf_file_read over a file.
+ */
+static void
+bench_read (const char *filename)
+{
+        double megabytes;
+        double start;
+        double elapsed;
+
+        megabytes = bench_file_size (filename) / (1024.0 * 1024.0);
+        start = bench_now ();
+        dxf_file_read ((char *) filename);
+        elapsed = bench_now () - start;
+        fprintf (stdout, "BENCH: read     %-48s %8.2f MB %8.3f s %10.1f MB/s\n",
+                filename, megabytes, elapsed, megabytes / elapsed);
+}
+
+
+/*!
+ * \brief Time a streaming traversal counting entities over a file.
+ */
+static void
+bench_stream (const char *filename)
+{
+        DxfReadHandlers handlers;
+        double megabytes;
+        double start;
+        double elapsed;
+        long entities;
+
+        megabytes = bench_file_size (filename) / (1024.0 * 1024.0);
+        entities = 0;
+        memset (&handlers, 0, sizeof (handlers));
+        handlers.user_data = &entities;
+        handlers.filter = bench_count_filter;
+        start = bench_now ();
+        dxf_file_read_stream ((char *) filename, &handlers);
+        elapsed = bench_now () - start;
+        fprintf (stdout, "BENCH: stream   %-48s %8.2f MB %8.3f s %10.1f MB/s %12.0f entities/s\n",
+                filename, megabytes, elapsed, megabytes / elapsed,
+                (double) entities / elapsed);
+}
+
+
+/*!
+ * \brief Generate and time writing a synthetic deck of LINE entities.
+ */
+static void
+bench_write_synthetic (void)
+{
+        DxfFile *fp;
+        DxfLine *line;
+        double megabytes;
+        double start;
+        double elapsed;
+        int i;
+
+        fp = malloc (sizeof (DxfFile));
+        memset (fp, 0, sizeof (DxfFile));
+        fp->fp = fopen (BENCH_SYNTHETIC_FILE, "w");
+        if (fp->fp == NULL)
+        {
+                fprintf (stderr, "BENCH: could not create %s\n",
+                        BENCH_SYNTHETIC_FILE);
+                free (fp);
+                return;
+        }
+        fp->filename = strdup (BENCH_SYNTHETIC_FILE);
+        fp->acad_version_number = AC1009;
+        dxf_writer_attach (fp, 0);
+        line = dxf_line_new ();
+        line = dxf_line_init (line);
+        start = bench_now ();
+        dxf_write_group_string (fp, 0, "SECTION");
+        dxf_write_group_string (fp, 2, "ENTITIES");
+        for (i = 0; i < BENCH_SYNTHETIC_ENTITIES; i++)
+        {
+                line->id_code = i + 1;
+                line->x0 = (double) i;
+                line->y0 = (double) i * 0.5;
+                line->x1 = (double) i + 1.0;
+                line->y1 = ((double) i + 1.0) * 0.5;
+                dxf_line_write (fp, line);
+        }
+        dxf_write_group_string (fp, 0, "ENDSEC");
+        dxf_file_write_eof (fp);
+        dxf_writer_detach (fp);
+        elapsed = bench_now () - start;
+        fclose (fp->fp);
+        megabytes = bench_file_size (BENCH_SYNTHETIC_FILE) / (1024.0 * 1024.0);
+        fprintf (stdout, "BENCH: write    %-48s %8.2f MB %8.3f s %10.1f MB/s %12.0f entities/s\n",
+                BENCH_SYNTHETIC_FILE, megabytes, elapsed,
+                megabytes / elapsed,
+                (double) BENCH_SYNTHETIC_ENTITIES / elapsed);
+        dxf_line_free (line);
+        free (fp->filename);
+        free (fp);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+        int i;
+
+        for (i = 1; i < argc; i++)
+        {
+                bench_read (argv[i]);
+                bench_stream (argv[i]);
+        }
+        /* The synthetically generated large deck: written with the
+         * buffered writer, then traversed with the streaming reader. */
+        bench_write_synthetic ();
+        bench_stream (BENCH_SYNTHETIC_FILE);
+        remove (BENCH_SYNTHETIC_FILE);
+        return (0);
+}
+
+
+/* EOF */
@@ -0,0 +1,416 @@
+/*!
+ * \file diff.c
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Structured DXF diff tool built on the pull parser.
+ *
+ * A textual diff of two DXF files explodes on differences that do not
+ * matter: renumbered handles, "20.0" against "2e+01", padded against
+ * bare integers.\n
+ * dxfdiff streams both files through the pull parser (see parser.h)
+ * and compares them record by record — group codes must match, double
+ * values compare within a tolerance, integers by value, handles
+ * numerically or, with \c -H, by a consistent renumbering — in O(1)
+ * memory per file, so two multi-gigabyte drawings diff without
+ * materializing either entity graph.\n
+ * The exit status follows diff: \c 0 when the files match, \c 1 when
+ * they differ, \c 2 when a file could not be read.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+#include <math.h>
+#include <string.h>
+#include <unistd.h>
+#include "includes.h"
+#include "src/parser.h"
+#include "src/symbol_table.h"
+
+
+/*!
+ * \brief The comparison settings and state of one diff run.
+ */
+typedef struct
+dxfdiff_state
+{
+        double tolerance;
+                /*!< allowed difference between double values, scaled
+                 * by the magnitude of the larger value for values
+                 * above \c 1. */
+        int normalize_handles;
+                /*!< when nonzero, handles compare by a consistent
+                 * renumbering instead of by value. */
+        int ignore_comments;
+                /*!< when nonzero, \c 999 records are skipped on both
+                 * sides. */
+        int max_reported;
+                /*!< number of differences printed; counting always
+                 * continues. */
+        long differences;
+                /*!< number of differing records found so far. */
+        DxfSymbolTable *handle_map;
+                /*!< maps each handle of the first file to its
+                 * counterpart in the second. */
+        DxfSymbolTable *handle_map_reverse;
+                /*!< the reverse mapping, so two handles of the first
+                 * file cannot collapse onto one of the second. */
+} DxfDiffState;
+
+
+/*!
+ * \brief Report one differing record pair.
+ */
+static void
+dxfdiff_report
+(
+        DxfDiffState *state,
+                /*!< the diff state. */
+        const DxfParserRecord *a,
+                /*!< the record of the first file. */
+        const DxfParserRecord *b,
+                /*!< the record of the second file. */
+        const char *what
+                /*!< what differs. */
+)
+{
+        state->differences++;
+        if (state->differences > state->max_reported)
+        {
+                return;
+        }
+        fprintf (stdout, "DIFF: %s\n", what);
+        fprintf (stdout, "  < line %ld: %3d | %s\n",
+                a->line_number, a->group_code, a->string_value);
+        fprintf (stdout, "  > line %ld: %3d | %s\n",
+                b->line_number, b->group_code, b->string_value);
+}
+
+
+/*!
+ * \brief Test whether a group code carries a handle.
+ *
+ * Wider than \c DXF_FIELD_TYPE_HEX: the entity handle itself (group
+ * \c 5) and the pointer groups \c 330 ... \c 369 and \c 390 ... \c 399
+ * reference handles too, and all of them are renumbered together when
+ * a file is rewritten.
+ *
+ * \return nonzero when the group code carries a handle.
+ */
+static int
+dxfdiff_is_handle_code
+(
+        int group_code
+                /*!< the group code to classify. */
+)
+{
+        return ((group_code == 5)
+                || (group_code == 105)
+                || ((group_code >= 320) && (group_code <= 369))
+                || ((group_code >= 390) && (group_code <= 399)));
+}
+
+
+/*!
+ * \brief Compare two handle values under the consistent renumbering.
+ *
+ * The first time a handle of the first file is seen it is paired with
+ * the handle at the same position of the second file; every later
+ * occurrence must pair with the same counterpart, in both
+ * directions.
+ *
+ * \return \c 0 when the pair is consistent.
+ */
+static int
+dxfdiff_compare_handles
+(
+        DxfDiffState *state,
+                /*!< the diff state. */
+        const char *a,
+                /*!< the handle of the first file. */
+        const char *b
+                /*!< the handle of the second file. */
+)
+{
+        char key_a[32];
+        char key_b[32];
+        char *mapped;
+
+        snprintf (key_a, sizeof (key_a), "%llx",
+                (unsigned long long) strtoull (a, NULL, 16));
+        snprintf (key_b, sizeof (key_b), "%llx",
+                (unsigned long long) strtoull (b, NULL, 16));
+        mapped = dxf_symbol_table_find (state->handle_map, key_a);
+        if (mapped != NULL)
+        {
+                return (strcmp (mapped, key_b) != 0);
+        }
+        mapped = dxf_symbol_table_find (state->handle_map_reverse, key_b);
+        if (mapped != NULL)
+        {
+                /* the counterpart is already taken by another
+                 * handle. */
+                return (1);
+        }
+        dxf_symbol_table_insert (state->handle_map, key_a, strdup (key_b));
+        dxf_symbol_table_insert (state->handle_map_reverse, key_b,
+                strdup (key_a));
+        return (0);
+}
+
+
+/*!
+ * \brief Pull the next record of one file, skipping comments when
+ * configured.
+ *
+ * \return \c FOUND, or \c FAIL at end of file.
+ */
+static int
+dxfdiff_next
+(
+        DxfDiffState *state,
+                /*!< the diff state. */
+        DxfFile *fp,
+                /*!< the file to pull from. */
+        DxfParserRecord *record
+                /*!< receives the record. */
+)
+{
+        for (;;)
+        {
+                if (dxf_parser_next (fp, record) != FOUND)
+                {
+                        return (FAIL);
+                }
+                if (state->ignore_comments && (record->group_code == 999))
+                {
+                        continue;
+                }
+                return (FOUND);
+        }
+}
+
+
+/*!
+ * \brief Compare one record pair.
+ */
+static void
+dxfdiff_compare
+(
+        DxfDiffState *state,
+                /*!< the diff state. */
+        const DxfParserRecord *a,
+                /*!< the record of the first file. */
+        const DxfParserRecord *b
+                /*!< the record of the second file. */
+)
+{
+        double magnitude;
+
+        if (a->group_code != b->group_code)
+        {
+                dxfdiff_report (state, a, b, "group code");
+                return;
+        }
+        if (dxfdiff_is_handle_code (a->group_code))
+        {
+                if (state->normalize_handles)
+                {
+                        if (dxfdiff_compare_handles (state,
+                                a->string_value, b->string_value))
+                        {
+                                dxfdiff_report (state, a, b,
+                                        "handle renumbering");
+                        }
+                }
+                else if (strtoull (a->string_value, NULL, 16)
+                        != strtoull (b->string_value, NULL, 16))
+                {
+                        dxfdiff_report (state, a, b, "handle value");
+                }
+                return;
+        }
+        switch (a->type)
+        {
+                case DXF_FIELD_TYPE_DOUBLE:
+                {
+                        magnitude = fabs (a->double_value);
+                        if (fabs (b->double_value) > magnitude)
+                        {
+                                magnitude = fabs (b->double_value);
+                        }
+                        if (magnitude < 1.0)
+                        {
+                                magnitude = 1.0;
+                        }
+                        if (fabs (a->double_value - b->double_value)
+                                > (state->tolerance * magnitude))
+                        {
+                                dxfdiff_report (state, a, b, "double value");
+                        }
+                        return;
+                }
+                case DXF_FIELD_TYPE_INT:
+                case DXF_FIELD_TYPE_INT16:
+                {
+                        if (a->int_value != b->int_value)
+                        {
+                                dxfdiff_report (state, a, b, "integer value");
+                        }
+                        return;
+                }
+                default:
+                {
+                        if (strcmp (a->string_value, b->string_value) != 0)
+                        {
+                                dxfdiff_report (state, a, b, "string value");
+                        }
+                        return;
+                }
+        }
+}
+
+
+/*!
+ * \brief Diff two DXF files record by record.
+ *
+ * \return \c 0 when the files match, \c 1 when they differ, \c 2 when
+ * a file could not be read.
+ */
+static int
+dxfdiff_run
+(
+        DxfDiffState *state,
+                /*!< the diff state. */
+        char *path_a,
+                /*!< path of the first file. */
+        char *path_b
+                /*!< path of the second file. */
+)
+{
+        DxfFile *fp_a;
+        DxfFile *fp_b;
+        DxfParserRecord record_a;
+        DxfParserRecord record_b;
+        int have_a;
+        int have_b;
+        long trailing;
+
+        fp_a = dxf_read_init (path_a);
+        if (fp_a == NULL)
+        {
+                return (2);
+        }
+        fp_b = dxf_read_init (path_b);
+        if (fp_b == NULL)
+        {
+                dxf_read_close (fp_a);
+                return (2);
+        }
+        dxf_read_mmap_init (fp_a);
+        dxf_read_mmap_init (fp_b);
+        for (;;)
+        {
+                have_a = (dxfdiff_next (state, fp_a, &record_a) == FOUND);
+                have_b = (dxfdiff_next (state, fp_b, &record_b) == FOUND);
+                if (!have_a || !have_b)
+                {
+                        break;
+                }
+                dxfdiff_compare (state, &record_a, &record_b);
+        }
+        /* one file may simply be longer. */
+        trailing = 0;
+        while (have_a && (dxfdiff_next (state, fp_a, &record_a) == FOUND))
+        {
+                trailing++;
+        }
+        while (have_b && (dxfdiff_next (state, fp_b, &record_b) == FOUND))
+        {
+                trailing++;
+        }
+        if (have_a != have_b)
+        {
+                trailing++;
+                fprintf (stdout, "DIFF: %s holds %ld trailing record(s)\n",
+                        have_a ? path_a : path_b, trailing);
+                state->differences += trailing;
+        }
+        dxf_read_close (fp_a);
+        dxf_read_close (fp_b);
+        if (state->differences > state->max_reported)
+        {
+                fprintf (stdout, "DIFF: %ld difference(s), first %d shown\n",
+                        state->differences, state->max_reported);
+        }
+        return ((state->differences > 0) ? 1 : 0);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+        DxfDiffState state;
+        int option;
+
+        memset (&state, 0, sizeof (state));
+        state.tolerance = 1e-9;
+        state.max_reported = 10;
+        while ((option = getopt (argc, argv, "t:m:HC")) != -1)
+        {
+                switch (option)
+                {
+                        case 't':
+                                state.tolerance = atof (optarg);
+                                break;
+                        case 'm':
+                                state.max_reported = atoi (optarg);
+                                break;
+                        case 'H':
+                                state.normalize_handles = 1;
+                                break;
+                        case 'C':
+                                state.ignore_comments = 1;
+                                break;
+                        default:
+                                fprintf (stderr,
+                                        "Usage: dxfdiff [-t TOLERANCE] [-m MAX] [-H] [-C] FILE_A FILE_B\n");
+                                return (2);
+                }
+        }
+        if (optind + 2 != argc)
+        {
+                fprintf (stderr,
+                        "Usage: dxfdiff [-t TOLERANCE] [-m MAX] [-H] [-C] FILE_A FILE_B\n");
+                return (2);
+        }
+        state.handle_map = dxf_symbol_table_new ();
+        state.handle_map_reverse = dxf_symbol_table_new ();
+        return (dxfdiff_run (&state, argv[optind], argv[optind + 1]));
+}
+
+
+/* EOF */
@@ -0,0 +1,586 @@
+/*!
+ * \file fuzz.c
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Adversarial corpus generator and worst-case replay for libdxf.
+ *
+ * Hostile or broken uploads are a throughput problem: a file that
+ * parses at a fraction of the normal byte rate — a million warnings,
+ * pathological group code orderings, deeply nested control strings,
+ * endless vertex chains — ties up a worker long after an honest file
+ * of the same size would have finished.\n
+ * "dxffuzz -g DIR" writes a deterministic corpus of such files, one
+ * per attack pattern, scaled with \c -n; the corpus is meant to be
+ * kept and replayed, so a regression on an adversarial shape shows up
+ * as a throughput change, not as a production incident.\n
+ * "dxffuzz -r DIR" replays every .dxf file in the corpus through the
+ * streaming reader with a diagnostics ring attached, reports
+ * nanoseconds per input byte, and with \c -t fails any file above the
+ * given ceiling.\n
+ * The ceilings are machine specific, like the perfgate baselines, and
+ * are not checked in.\n
+ * Run with "make fuzz-replay".
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include "includes.h"
+#include "src/diag.h"
+
+
+/*!
+ * State of the xorshift64* pseudo random number generator.
+ */
+static uint64_t fuzz_state = 88172645463325252ULL;
+
+
+/*!
+ * \brief Hand out the next pseudo random number.
+ */
+static uint64_t
+fuzz_random ()
+{
+        fuzz_state ^= fuzz_state >> 12;
+        fuzz_state ^= fuzz_state << 25;
+        fuzz_state ^= fuzz_state >> 27;
+        return (fuzz_state * 2685821657736338717ULL);
+}
+
+
+/*!
+ * \brief Open a corpus file and write the leading header section.
+ */
+static FILE *
+fuzz_open
+(
+        const char *directory,
+                /*!< the corpus directory. */
+        const char *name
+                /*!< basename of the corpus file. */
+)
+{
+        char path[1024];
+        FILE *fp;
+
+        snprintf (path, sizeof (path), "%s/%s", directory, name);
+        fp = fopen (path, "w");
+        if (fp == NULL)
+        {
+                fprintf (stderr, "dxffuzz: could not write %s\n", path);
+                return (NULL);
+        }
+        fprintf (fp,
+                "  0\nSECTION\n  2\nHEADER\n  9\n$ACADVER\n  1\nAC1015\n"
+                "  0\nENDSEC\n  0\nSECTION\n  2\nENTITIES\n");
+        return (fp);
+}
+
+
+/*!
+ * \brief Write the trailing section end and file end markers and
+ * close a corpus file.
+ */
+static void
+fuzz_close
+(
+        FILE *fp
+                /*!< the corpus file. */
+)
+{
+        fprintf (fp, "  0\nENDSEC\n  0\nEOF\n");
+        fclose (fp);
+}
+
+
+/*!
+ * \brief Corpus: every entity drags a tail of unknown tags, so each
+ * record reports several warnings.
+ */
+static void
+fuzz_generate_warn_flood
+(
+        const char *directory,
+                /*!< the corpus directory. */
+        int scale
+                /*!< number of entities. */
+)
+{
+        FILE *fp;
+        int i;
+        int j;
+
+        fp = fuzz_open (directory, "warn_flood.dxf");
+        if (fp == NULL)
+        {
+                return;
+        }
+        for (i = 0; i < scale; i++)
+        {
+                fprintf (fp, "  0\nLINE\n  8\n0\n 10\n%d.0\n 20\n0.0\n"
+                        " 11\n%d.0\n 21\n1.0\n", i % 1000, i % 1000 + 1);
+                for (j = 0; j < 8; j++)
+                {
+                        fprintf (fp, "777\n%d\n", j);
+                }
+        }
+        fuzz_close (fp);
+}
+
+
+/*!
+ * \brief Corpus: valid tags in pathological order, with duplicates,
+ * so the per-tag dispatch never runs in file order.
+ */
+static void
+fuzz_generate_tag_shuffle
+(
+        const char *directory,
+                /*!< the corpus directory. */
+        int scale
+                /*!< number of entities. */
+)
+{
+        static const char *tags[] =
+        {
+                " 10", " 20", " 30", " 11", " 21", " 31",
+                " 39", " 62", "  6", "  8", " 48", " 60",
+        };
+        FILE *fp;
+        size_t number_tags;
+        size_t pick;
+        int i;
+        int j;
+
+        fp = fuzz_open (directory, "tag_shuffle.dxf");
+        if (fp == NULL)
+        {
+                return;
+        }
+        number_tags = sizeof (tags) / sizeof (tags[0]);
+        for (i = 0; i < scale; i++)
+        {
+                fprintf (fp, "  0\nLINE\n");
+                for (j = 0; j < 24; j++)
+                {
+                        pick = (size_t) (fuzz_random () % number_tags);
+                        if (pick < 2)
+                        {
+                                fprintf (fp, "%s\nCONTINUOUS\n", tags[pick + 8]);
+                        }
+                        else
+                        {
+                                fprintf (fp, "%s\n%d.5\n", tags[pick],
+                                        (int) (fuzz_random () % 1000));
+                        }
+                }
+        }
+        fuzz_close (fp);
+}
+
+
+/*!
+ * \brief Corpus: application defined 102 control strings nested far
+ * deeper than any drawing program writes.
+ */
+static void
+fuzz_generate_nest_102
+(
+        const char *directory,
+                /*!< the corpus directory. */
+        int scale
+                /*!< nesting depth. */
+)
+{
+        FILE *fp;
+        int i;
+
+        fp = fuzz_open (directory, "nest_102.dxf");
+        if (fp == NULL)
+        {
+                return;
+        }
+        fprintf (fp, "  0\nLINE\n  8\n0\n");
+        for (i = 0; i < scale; i++)
+        {
+                fprintf (fp, "102\n{ACAD_XDICTIONARY\n330\n%X\n", i + 1);
+        }
+        for (i = 0; i < scale; i++)
+        {
+                fprintf (fp, "102\n}\n");
+        }
+        fprintf (fp, " 10\n0.0\n 20\n0.0\n 11\n1.0\n 21\n1.0\n");
+        fuzz_close (fp);
+}
+
+
+/*!
+ * \brief Corpus: few polylines with endless vertex lists, stressing
+ * the repeated list-append pattern of the sequence readers.
+ */
+static void
+fuzz_generate_vertex_chain
+(
+        const char *directory,
+                /*!< the corpus directory. */
+        int scale
+                /*!< number of vertices per polyline. */
+)
+{
+        FILE *fp;
+        int i;
+        int j;
+
+        fp = fuzz_open (directory, "vertex_chain.dxf");
+        if (fp == NULL)
+        {
+                return;
+        }
+        for (i = 0; i < 4; i++)
+        {
+                fprintf (fp, "  0\nLWPOLYLINE\n  8\n0\n 90\n%d\n 70\n1\n",
+                        scale);
+                for (j = 0; j < scale; j++)
+                {
+                        fprintf (fp, " 10\n%d.0\n 20\n%d.0\n",
+                                j % 10000, (j + i) % 10000);
+                }
+                fprintf (fp, "  0\nPOLYLINE\n  8\n0\n 66\n1\n 70\n1\n");
+                for (j = 0; j < scale; j++)
+                {
+                        fprintf (fp, "  0\nVERTEX\n  8\n0\n 10\n%d.0\n"
+                                " 20\n%d.0\n", j % 10000, (j + i) % 10000);
+                }
+                fprintf (fp, "  0\nSEQEND\n");
+        }
+        fuzz_close (fp);
+}
+
+
+/*!
+ * \brief Corpus: value lines far longer than any honest field, so
+ * the growable line buffer is exercised on every record.
+ */
+static void
+fuzz_generate_long_lines
+(
+        const char *directory,
+                /*!< the corpus directory. */
+        int scale
+                /*!< number of entities. */
+)
+{
+        FILE *fp;
+        int i;
+        int j;
+        int length;
+
+        fp = fuzz_open (directory, "long_lines.dxf");
+        if (fp == NULL)
+        {
+                return;
+        }
+        for (i = 0; i < scale; i++)
+        {
+                length = 64 + (int) (fuzz_random () % 65536);
+                fprintf (fp, "  0\nTEXT\n  8\n");
+                for (j = 0; j < length; j++)
+                {
+                        fputc ('A' + (j % 26), fp);
+                }
+                fprintf (fp, "\n 10\n0.0\n 20\n0.0\n 40\n2.5\n  1\n");
+                for (j = 0; j < length; j++)
+                {
+                        fputc ('a' + (j % 26), fp);
+                }
+                fprintf (fp, "\n");
+        }
+        fuzz_close (fp);
+}
+
+
+/*!
+ * \brief Corpus: a flood of 999 comment records between the entities.
+ */
+static void
+fuzz_generate_comment_flood
+(
+        const char *directory,
+                /*!< the corpus directory. */
+        int scale
+                /*!< number of comments. */
+)
+{
+        FILE *fp;
+        int i;
+
+        fp = fuzz_open (directory, "comment_flood.dxf");
+        if (fp == NULL)
+        {
+                return;
+        }
+        for (i = 0; i < scale; i++)
+        {
+                fprintf (fp, "999\ncomment number %d, of no consequence\n", i);
+                if ((i % 64) == 0)
+                {
+                        fprintf (fp, "  0\nPOINT\n  8\n0\n 10\n%d.0\n"
+                                " 20\n0.0\n", i % 10000);
+                }
+        }
+        fuzz_close (fp);
+}
+
+
+/*!
+ * \brief Generate the whole corpus into a directory.
+ */
+static int
+fuzz_generate
+(
+        const char *directory,
+                /*!< the corpus directory; created when absent. */
+        int scale
+                /*!< entities (or depth) per corpus file. */
+)
+{
+        if ((mkdir (directory, 0777) != 0) && (errno != EEXIST))
+        {
+                fprintf (stderr, "dxffuzz: could not create %s\n", directory);
+                return (EXIT_FAILURE);
+        }
+        fuzz_generate_warn_flood (directory, scale);
+        fuzz_generate_tag_shuffle (directory, scale);
+        fuzz_generate_nest_102 (directory, scale);
+        fuzz_generate_vertex_chain (directory, scale);
+        fuzz_generate_long_lines (directory, scale / 16 + 1);
+        fuzz_generate_comment_flood (directory, scale);
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Replay one corpus file and report its byte rate.
+ *
+ * \c stdout and \c stderr are pointed at \c /dev/null for the
+ * duration of the parse — an adversarial file emits output by design
+ * and the write calls would dominate the measurement.
+ *
+ * \return \c EXIT_SUCCESS when the file stays below the ceiling.
+ */
+static int
+fuzz_replay_file
+(
+        const char *path,
+                /*!< path of the corpus file. */
+        double ceiling_ns_per_byte
+                /*!< largest allowed cost, or \c 0.0 for none. */
+)
+{
+        DxfReadHandlers handlers;
+        DxfDiag *diag;
+        struct stat sb;
+        struct timespec before;
+        struct timespec after;
+        double elapsed_ns;
+        double ns_per_byte;
+        uint64_t warnings;
+        int saved_stdout;
+        int saved_stderr;
+        int null_fd;
+        int result;
+
+        if ((stat (path, &sb) != 0) || (sb.st_size < 1))
+        {
+                fprintf (stderr, "dxffuzz: could not stat %s\n", path);
+                return (EXIT_FAILURE);
+        }
+        memset (&handlers, 0, sizeof (handlers));
+        diag = dxf_diag_new (0);
+        handlers.diag = diag;
+        saved_stdout = dup (1);
+        saved_stderr = dup (2);
+        null_fd = open ("/dev/null", O_WRONLY);
+        fflush (stdout);
+        fflush (stderr);
+        dup2 (null_fd, 1);
+        dup2 (null_fd, 2);
+        clock_gettime (CLOCK_MONOTONIC, &before);
+        /* the reader historically reports the EOF marker as a failed
+         * parse; the byte rate is what is measured here. */
+        dxf_file_read_stream ((char *) path, &handlers);
+        clock_gettime (CLOCK_MONOTONIC, &after);
+        fflush (stdout);
+        fflush (stderr);
+        dup2 (saved_stdout, 1);
+        dup2 (saved_stderr, 2);
+        close (saved_stdout);
+        close (saved_stderr);
+        close (null_fd);
+        elapsed_ns = (double) (after.tv_sec - before.tv_sec) * 1e9
+                + (double) (after.tv_nsec - before.tv_nsec);
+        ns_per_byte = elapsed_ns / (double) sb.st_size;
+        warnings = diag->counts[DXF_DIAG_WARNING]
+                + diag->counts[DXF_DIAG_ERROR];
+        dxf_diag_free (diag);
+        result = EXIT_SUCCESS;
+        if ((ceiling_ns_per_byte > 0.0)
+                && (ns_per_byte > ceiling_ns_per_byte))
+        {
+                result = EXIT_FAILURE;
+        }
+        fprintf (stdout, "FUZZ: %-28s %9ld bytes  %8.2f ns/byte"
+                "  %8lu warnings%s\n",
+                strrchr (path, '/') ? strrchr (path, '/') + 1 : path,
+                (long) sb.st_size, ns_per_byte, (unsigned long) warnings,
+                (result == EXIT_SUCCESS) ? "" : "  OVER CEILING");
+        return (result);
+}
+
+
+/*!
+ * \brief Replay every .dxf file of a corpus directory.
+ *
+ * \return \c EXIT_SUCCESS when every file stays below the ceiling.
+ */
+static int
+fuzz_replay
+(
+        const char *directory,
+                /*!< the corpus directory. */
+        double ceiling_ns_per_byte
+                /*!< largest allowed cost, or \c 0.0 for none. */
+)
+{
+        struct dirent **entries;
+        char path[1024];
+        int number_entries;
+        int failures;
+        int i;
+
+        number_entries = scandir (directory, &entries, NULL, alphasort);
+        if (number_entries < 0)
+        {
+                fprintf (stderr, "dxffuzz: could not read %s\n", directory);
+                return (EXIT_FAILURE);
+        }
+        failures = 0;
+        for (i = 0; i < number_entries; i++)
+        {
+                if ((strlen (entries[i]->d_name) > 4)
+                        && (strcmp (entries[i]->d_name
+                                + strlen (entries[i]->d_name) - 4,
+                                ".dxf") == 0))
+                {
+                        snprintf (path, sizeof (path), "%s/%s",
+                                directory, entries[i]->d_name);
+                        if (fuzz_replay_file (path, ceiling_ns_per_byte)
+                                != EXIT_SUCCESS)
+                        {
+                                failures++;
+                        }
+                }
+                free (entries[i]);
+        }
+        free (entries);
+        if (failures)
+        {
+                fprintf (stdout, "FUZZ: %d file(s) over the ceiling\n",
+                        failures);
+                return (EXIT_FAILURE);
+        }
+        return (EXIT_SUCCESS);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+        const char *generate_directory;
+        const char *replay_directory;
+        double ceiling;
+        int scale;
+        int option;
+
+        generate_directory = NULL;
+        replay_directory = NULL;
+        ceiling = 0.0;
+        scale = 100000;
+        while ((option = getopt (argc, argv, "g:r:n:s:t:")) != -1)
+        {
+                switch (option)
+                {
+                        case 'g':
+                                generate_directory = optarg;
+                                break;
+                        case 'r':
+                                replay_directory = optarg;
+                                break;
+                        case 'n':
+                                scale = atoi (optarg);
+                                break;
+                        case 's':
+                                fuzz_state = strtoull (optarg, NULL, 10);
+                                break;
+                        case 't':
+                                ceiling = atof (optarg);
+                                break;
+                        default:
+                                fprintf (stderr,
+                                        "Usage: dxffuzz -g DIR [-n SCALE] [-s SEED]\n"
+                                        "       dxffuzz -r DIR [-t NS_PER_BYTE]\n");
+                                return (EXIT_FAILURE);
+                }
+        }
+        if ((generate_directory == NULL) && (replay_directory == NULL))
+        {
+                fprintf (stderr,
+                        "Usage: dxffuzz -g DIR [-n SCALE] [-s SEED]\n"
+                        "       dxffuzz -r DIR [-t NS_PER_BYTE]\n");
+                return (EXIT_FAILURE);
+        }
+        if (generate_directory != NULL)
+        {
+                if (fuzz_generate (generate_directory, scale) != EXIT_SUCCESS)
+                {
+                        return (EXIT_FAILURE);
+                }
+        }
+        if (replay_directory != NULL)
+        {
+                return (fuzz_replay (replay_directory, ceiling));
+        }
+        return (EXIT_SUCCESS);
+}
+
+
+/* EOF */
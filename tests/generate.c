@@ -0,0 +1,386 @@
+/*!
+ * \file generate.c
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Synthetic DXF corpus generator for libdxf.
+ *
+ * The drawings under examples/ top out at a few thousand entities, so
+ * nothing in the tree exercises the readers and writers at scale.\n
+ * This tool generates a parameterized drawing — entity mix, entity
+ * count into the tens of millions, layer count, hatch boundary
+ * complexity — deterministically from a seed, so gigabyte-scale
+ * inputs for the benchmarks can be regenerated anywhere instead of
+ * being shipped.\n
+ * The same seed and parameters produce the same file byte for byte.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+#include <string.h>
+#include <unistd.h>
+#include "includes.h"
+
+
+/*!
+ * Number of distinct entity kinds in the mix.
+ */
+#define GEN_KINDS 5
+
+/*!
+ * Extent of the generated drawing in drawing units.
+ */
+#define GEN_EXTENT 10000.0
+
+
+/*!
+ * \brief State of the deterministic pseudo random generator
+ * (xorshift64*).
+ *
+ * Fully determined by the seed: no libc \c rand, no locale, no
+ * platform dependent behaviour, so the same seed generates the same
+ * drawing everywhere.
+ */
+static uint64_t gen_state;
+
+
+/*!
+ * \brief Get the next pseudo random 64 bit value.
+ */
+static uint64_t
+gen_next (void)
+{
+        gen_state ^= gen_state >> 12;
+        gen_state ^= gen_state << 25;
+        gen_state ^= gen_state >> 27;
+        return (gen_state * UINT64_C (2685821657736338717));
+}
+
+
+/*!
+ * \brief Get a pseudo random integer in [0, \c bound).
+ */
+static long
+gen_range
+(
+        long bound
+                /*!< exclusive upper bound, at least 1. */
+)
+{
+        return ((long) (gen_next () % (uint64_t) bound));
+}
+
+
+/*!
+ * \brief Get a pseudo random coordinate in [0, \c GEN_EXTENT).
+ *
+ * Quantized to 1/1000 drawing unit, so the values print compactly and
+ * round-trip exactly through the fixed decimal formatter.
+ */
+static double
+gen_coordinate (void)
+{
+        return ((double) gen_range ((long) GEN_EXTENT * 1000) / 1000.0);
+}
+
+
+/*!
+ * \brief Print the usage message.
+ */
+static void
+gen_usage (void)
+{
+        fprintf (stderr,
+                "Usage: dxfgen [OPTION]... FILE\n"
+                "Generate a synthetic DXF drawing, deterministically from a seed.\n"
+                "  -n COUNT    number of entities (default 1000000)\n"
+                "  -s SEED     seed of the pseudo random generator (default 1)\n"
+                "  -l COUNT    number of layers (default 8)\n"
+                "  -m WEIGHTS  comma separated weights of the entity mix,\n"
+                "              in the order LINE,CIRCLE,LWPOLYLINE,HATCH,POINT\n"
+                "              (default 40,20,20,5,15; a weight may be 0)\n"
+                "  -v COUNT    vertices per LWPOLYLINE and per HATCH boundary\n"
+                "              (default 8)\n");
+}
+
+
+int
+main (int argc, char *argv[])
+{
+        DxfFile *fp;
+        DxfLine *line;
+        DxfCircle *circle;
+        DxfLWPolyline *lwpolyline;
+        DxfLWPolylineVertex *lwpolyline_vertex;
+        DxfPoint *point;
+        DxfHatch *hatch;
+        DxfHatchBoundaryPath *path;
+        DxfHatchBoundaryPathPolyline *polyline;
+        DxfHatchBoundaryPathPolylineVertex *vertices;
+        char **layers;
+        char layer_name[32];
+        long entities;
+        long layer_count;
+        long vertex_count;
+        long weights[GEN_KINDS];
+        long total_weight;
+        long pick;
+        long i;
+        int kind;
+        int j;
+        int option;
+        uint64_t seed;
+        char *end;
+        const char *filename;
+
+        entities = 1000000L;
+        seed = 1;
+        layer_count = 8;
+        vertex_count = 8;
+        weights[0] = 40;
+        weights[1] = 20;
+        weights[2] = 20;
+        weights[3] = 5;
+        weights[4] = 15;
+        while ((option = getopt (argc, argv, "n:s:l:m:v:")) != -1)
+        {
+                switch (option)
+                {
+                        case 'n':
+                                entities = atol (optarg);
+                                break;
+                        case 's':
+                                seed = (uint64_t) strtoull (optarg, NULL, 10);
+                                break;
+                        case 'l':
+                                layer_count = atol (optarg);
+                                break;
+                        case 'm':
+                                end = optarg;
+                                for (j = 0; j < GEN_KINDS; j++)
+                                {
+                                        weights[j] = strtol (end, &end, 10);
+                                        if ((*end == ',') && (j < (GEN_KINDS - 1)))
+                                        {
+                                                end++;
+                                        }
+                                }
+                                break;
+                        case 'v':
+                                vertex_count = atol (optarg);
+                                break;
+                        default:
+                                gen_usage ();
+                                return (EXIT_FAILURE);
+                }
+        }
+        if ((optind != (argc - 1)) || (entities < 1) || (layer_count < 1)
+                || (vertex_count < 2))
+        {
+                gen_usage ();
+                return (EXIT_FAILURE);
+        }
+        filename = argv[optind];
+        total_weight = 0;
+        for (j = 0; j < GEN_KINDS; j++)
+        {
+                if (weights[j] < 0)
+                {
+                        gen_usage ();
+                        return (EXIT_FAILURE);
+                }
+                total_weight += weights[j];
+        }
+        if (total_weight < 1)
+        {
+                gen_usage ();
+                return (EXIT_FAILURE);
+        }
+        /* a zero seed would lock the xorshift generator at zero. */
+        gen_state = seed ? seed : UINT64_C (0x9e3779b97f4a7c15);
+        fp = malloc (sizeof (DxfFile));
+        memset (fp, 0, sizeof (DxfFile));
+        fp->fp = fopen (filename, "w");
+        if (fp->fp == NULL)
+        {
+                fprintf (stderr, "dxfgen: could not create %s\n", filename);
+                return (EXIT_FAILURE);
+        }
+        fp->filename = strdup (filename);
+        fp->acad_version_number = AC1015;
+        dxf_writer_attach (fp, 0);
+        /* the layer names, shared by all entities on the layer. */
+        layers = malloc (sizeof (char *) * (size_t) layer_count);
+        for (i = 0; i < layer_count; i++)
+        {
+                sprintf (layer_name, "LAYER_%ld", i);
+                layers[i] = strdup (layer_name);
+        }
+        /* one scratch entity per kind, recycled over all records. */
+        line = dxf_line_new ();
+        line = dxf_line_init (line);
+        circle = dxf_circle_new ();
+        circle = dxf_circle_init (circle);
+        lwpolyline = dxf_lwpolyline_new ();
+        lwpolyline = dxf_lwpolyline_init (lwpolyline);
+        for (i = 0; i < vertex_count; i++)
+        {
+                lwpolyline_vertex = dxf_lwpolyline_vertex_append (lwpolyline);
+                if (lwpolyline_vertex == NULL)
+                {
+                        return (EXIT_FAILURE);
+                }
+        }
+        point = dxf_point_new ();
+        point = dxf_point_init (point);
+        hatch = dxf_hatch_new ();
+        hatch = dxf_hatch_init (hatch);
+        hatch->pattern_name = strdup ("SOLID");
+        hatch->solid_fill = 1;
+        /* one closed polyline boundary path of vertex_count vertices,
+         * linked once and recycled over all hatches. */
+        path = dxf_hatch_boundary_path_new ();
+        path = dxf_hatch_boundary_path_init (path);
+        polyline = dxf_hatch_boundary_path_polyline_new ();
+        polyline = dxf_hatch_boundary_path_polyline_init (polyline);
+        polyline->is_closed = 1;
+        polyline->number_of_vertices = (int) vertex_count;
+        vertices = malloc (sizeof (DxfHatchBoundaryPathPolylineVertex)
+                * (size_t) vertex_count);
+        memset (vertices, 0, sizeof (DxfHatchBoundaryPathPolylineVertex)
+                * (size_t) vertex_count);
+        for (i = 0; i < vertex_count; i++)
+        {
+                vertices[i].next = (i < (vertex_count - 1)) ?
+                        (struct DxfHatchBoundaryPathPolylineVertex *)
+                        &vertices[i + 1] : NULL;
+        }
+        polyline->vertices =
+                (struct DxfHatchBoundaryPathPolylineVertex *) &vertices[0];
+        path->polylines = (struct DxfHatchBoundaryPathPolyline *) polyline;
+        hatch->paths = (struct DxfHatchBoundaryPath *) path;
+        hatch->number_of_boundary_paths = 1;
+        /* a minimal header, then the entities. */
+        dxf_write_group_string (fp, 0, "SECTION");
+        dxf_write_group_string (fp, 2, "HEADER");
+        dxf_write_group_string (fp, 9, "$ACADVER");
+        dxf_write_group_string (fp, 1, "AC1015");
+        dxf_write_group_string (fp, 0, "ENDSEC");
+        dxf_write_group_string (fp, 0, "SECTION");
+        dxf_write_group_string (fp, 2, "ENTITIES");
+        for (i = 0; i < entities; i++)
+        {
+                pick = gen_range (total_weight);
+                for (kind = 0; kind < (GEN_KINDS - 1); kind++)
+                {
+                        if (pick < weights[kind])
+                        {
+                                break;
+                        }
+                        pick -= weights[kind];
+                }
+                switch (kind)
+                {
+                        case 0:
+                                free (line->layer);
+                                line->layer = strdup (layers[gen_range (layer_count)]);
+                                line->id_code = (int) i + 1;
+                                line->x0 = gen_coordinate ();
+                                line->y0 = gen_coordinate ();
+                                line->x1 = gen_coordinate ();
+                                line->y1 = gen_coordinate ();
+                                dxf_line_write (fp, line);
+                                break;
+                        case 1:
+                                free (circle->layer);
+                                circle->layer = strdup (layers[gen_range (layer_count)]);
+                                circle->id_code = (int) i + 1;
+                                circle->x0 = gen_coordinate ();
+                                circle->y0 = gen_coordinate ();
+                                circle->radius = gen_coordinate () / 100.0 + 0.001;
+                                dxf_circle_write (fp, circle);
+                                break;
+                        case 2:
+                                free (lwpolyline->layer);
+                                lwpolyline->layer = strdup (layers[gen_range (layer_count)]);
+                                lwpolyline->id_code = (int) i + 1;
+                                lwpolyline->number_vertices = (int) vertex_count;
+                                for (j = 0; j < vertex_count; j++)
+                                {
+                                        lwpolyline->vertices[j].x0 = gen_coordinate ();
+                                        lwpolyline->vertices[j].y0 = gen_coordinate ();
+                                }
+                                dxf_lwpolyline_write (fp, lwpolyline);
+                                break;
+                        case 3:
+                                free (hatch->layer);
+                                hatch->layer = strdup (layers[gen_range (layer_count)]);
+                                hatch->id_code = (int) i + 1;
+                                for (j = 0; j < vertex_count; j++)
+                                {
+                                        vertices[j].x0 = gen_coordinate ();
+                                        vertices[j].y0 = gen_coordinate ();
+                                }
+                                dxf_hatch_write (fp, hatch);
+                                break;
+                        default:
+                                free (point->layer);
+                                point->layer = strdup (layers[gen_range (layer_count)]);
+                                point->id_code = (int) i + 1;
+                                point->x0 = gen_coordinate ();
+                                point->y0 = gen_coordinate ();
+                                dxf_point_write (fp, point);
+                                break;
+                }
+        }
+        dxf_write_group_string (fp, 0, "ENDSEC");
+        dxf_file_write_eof (fp);
+        dxf_writer_detach (fp);
+        fclose (fp->fp);
+        fprintf (stdout, "dxfgen: wrote %ld entities to %s (seed %llu)\n",
+                entities, filename, (unsigned long long) seed);
+        dxf_line_free (line);
+        dxf_circle_free (circle);
+        dxf_lwpolyline_free (lwpolyline);
+        dxf_point_free (point);
+        /* the boundary graph is owned here, not by the entity. */
+        hatch->paths = NULL;
+        dxf_hatch_free (hatch);
+        free (vertices);
+        free (polyline);
+        free (path);
+        for (i = 0; i < layer_count; i++)
+        {
+                free (layers[i]);
+        }
+        free (layers);
+        free (fp->filename);
+        free (fp);
+        return (EXIT_SUCCESS);
+}
+
+
+/* EOF */
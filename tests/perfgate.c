@@ -0,0 +1,729 @@
+/*!
+ * \file perfgate.c
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Throughput regression gate for libdxf.
+ *
+ * The golden corpus catches output regressions, but a change can halve
+ * parse speed without altering a single golden byte.\n
+ * This gate records per corpus file performance baselines — parse
+ * throughput in MB/s, write throughput in entities/s, peak RSS via
+ * \c getrusage and the allocation counters of profile.h — and a check
+ * mode re-measures and fails on regressions beyond a tolerance
+ * (10% by default).\n
+ * Throughput and RSS baselines are machine specific: record them on
+ * the machine that checks them (a CI runner records its own), and
+ * re-record after intentional performance changes.\n
+ * The allocation counters are deterministic per corpus file, but are
+ * only collected when the library is compiled with -DDXF_PROFILE=1;
+ * they record as zero otherwise and zero baselines are not compared.\n
+ * Run with "make perf-record" and "make perf-check".
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+#include <string.h>
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+#include "includes.h"
+#include "src/profile.h"
+
+
+/*!
+ * Minimum measured wall time per metric in seconds; the passes repeat
+ * until it is reached, so the tiny golden files still time above the
+ * clock noise.
+ */
+#define PERFGATE_MIN_SECONDS 0.2
+
+/*!
+ * Upper bound on the repetitions of a pass, so gigabyte scale corpus
+ * files run once.
+ */
+#define PERFGATE_MAX_REPEAT 200
+
+/*!
+ * Maximum number of corpus files in a baseline.
+ */
+#define PERFGATE_MAX_FILES 256
+
+/*!
+ * Target size in bytes a golden fragment is amplified to.
+ */
+#define PERFGATE_AMPLIFY_BYTES (2L * 1024L * 1024L)
+
+/*!
+ * Path of the amplified temporary drawing.
+ */
+#define PERFGATE_TMP_FILE "perfgate_tmp.dxf"
+
+
+/*!
+ * \brief The recorded figures of one corpus file.
+ */
+typedef struct
+perfgate_record
+{
+        char name[128];
+                /*!< base name of the corpus file. */
+        double parse_mb_s;
+                /*!< parse throughput in MB/s. */
+        double write_entities_s;
+                /*!< write throughput in entities/s. */
+        long peak_rss_kb;
+                /*!< peak resident set size after processing the file,
+                 * in kB; cumulative over the corpus, so baseline and
+                 * check have to process the files in the same order. */
+        uint64_t mallocs;
+                /*!< allocator counter of one parse (see profile.h),
+                 * or \c 0 without -DDXF_PROFILE=1. */
+        uint64_t strdups;
+                /*!< string duplication counter of one parse, or \c 0
+                 * without -DDXF_PROFILE=1. */
+} PerfgateRecord;
+
+
+/*!
+ * \brief Figures threaded through the streaming callbacks.
+ */
+typedef struct
+perfgate_pass
+{
+        DxfFile *sink;
+                /*!< memory sink the write pass reserializes into, or
+                 * \c NULL in the parse pass. */
+        long entities;
+                /*!< number of entities seen. */
+        uint64_t write_ns;
+                /*!< wall time spent inside the entity write calls. */
+} PerfgatePass;
+
+
+/*!
+ * \brief Get a monotonic time stamp in seconds.
+ */
+static double
+perfgate_now (void)
+{
+        struct timespec ts;
+
+        clock_gettime (CLOCK_MONOTONIC, &ts);
+        return ((double) ts.tv_sec + ((double) ts.tv_nsec / 1.0e9));
+}
+
+
+/*!
+ * \brief Get the size of a file in bytes.
+ */
+static double
+perfgate_file_size (const char *filename)
+{
+        struct stat sb;
+
+        if (stat (filename, &sb) != 0)
+        {
+                return (0.0);
+        }
+        return ((double) sb.st_size);
+}
+
+
+/*!
+ * \brief Get the base name of a path.
+ */
+static const char *
+perfgate_basename (const char *path)
+{
+        const char *slash;
+
+        slash = strrchr (path, '/');
+        return (slash ? (slash + 1) : path);
+}
+
+
+/*!
+ * \brief Streaming callback of the parse pass: count, parse
+ * everything, write nothing.
+ */
+#define PERFGATE_COUNT_CALLBACK(function, entity_type) \
+static int \
+function (DxfFile *fp, entity_type *entity, void *user_data) \
+{ \
+        (void) fp; \
+        (void) entity; \
+        ((PerfgatePass *) user_data)->entities++; \
+        return (EXIT_SUCCESS); \
+}
+
+PERFGATE_COUNT_CALLBACK (perfgate_count_arc, DxfArc)
+PERFGATE_COUNT_CALLBACK (perfgate_count_circle, DxfCircle)
+PERFGATE_COUNT_CALLBACK (perfgate_count_ellipse, DxfEllipse)
+PERFGATE_COUNT_CALLBACK (perfgate_count_face, Dxf3dface)
+PERFGATE_COUNT_CALLBACK (perfgate_count_insert, DxfInsert)
+PERFGATE_COUNT_CALLBACK (perfgate_count_line, DxfLine)
+PERFGATE_COUNT_CALLBACK (perfgate_count_lwpolyline, DxfLWPolyline)
+PERFGATE_COUNT_CALLBACK (perfgate_count_point, DxfPoint)
+PERFGATE_COUNT_CALLBACK (perfgate_count_polyline, DxfPolyline)
+PERFGATE_COUNT_CALLBACK (perfgate_count_seqend, DxfSeqend)
+PERFGATE_COUNT_CALLBACK (perfgate_count_solid, DxfSolid)
+PERFGATE_COUNT_CALLBACK (perfgate_count_text, DxfText)
+PERFGATE_COUNT_CALLBACK (perfgate_count_vertex, DxfVertex)
+
+
+/*!
+ * \brief Streaming callback of the write pass: reserialize the entity
+ * into the memory sink, timing only the write call, so the parse cost
+ * of feeding the pass stays out of the write figure.
+ */
+#define PERFGATE_WRITE_CALLBACK(function, entity_type, write_function) \
+static int \
+function (DxfFile *fp, entity_type *entity, void *user_data) \
+{ \
+        PerfgatePass *pass = (PerfgatePass *) user_data; \
+        double start; \
+ \
+        (void) fp; \
+        start = perfgate_now (); \
+        write_function (pass->sink, entity); \
+        pass->write_ns += (uint64_t) ((perfgate_now () - start) * 1.0e9); \
+        pass->entities++; \
+        return (EXIT_SUCCESS); \
+}
+
+PERFGATE_WRITE_CALLBACK (perfgate_write_arc, DxfArc, dxf_arc_write)
+PERFGATE_WRITE_CALLBACK (perfgate_write_circle, DxfCircle, dxf_circle_write)
+PERFGATE_WRITE_CALLBACK (perfgate_write_ellipse, DxfEllipse, dxf_ellipse_write)
+PERFGATE_WRITE_CALLBACK (perfgate_write_face, Dxf3dface, dxf_3dface_write)
+PERFGATE_WRITE_CALLBACK (perfgate_write_insert, DxfInsert, dxf_insert_write)
+PERFGATE_WRITE_CALLBACK (perfgate_write_line, DxfLine, dxf_line_write)
+PERFGATE_WRITE_CALLBACK (perfgate_write_lwpolyline, DxfLWPolyline, dxf_lwpolyline_write)
+PERFGATE_WRITE_CALLBACK (perfgate_write_point, DxfPoint, dxf_point_write)
+PERFGATE_WRITE_CALLBACK (perfgate_write_polyline, DxfPolyline, dxf_polyline_write)
+PERFGATE_WRITE_CALLBACK (perfgate_write_seqend, DxfSeqend, dxf_seqend_write)
+PERFGATE_WRITE_CALLBACK (perfgate_write_solid, DxfSolid, dxf_solid_write)
+PERFGATE_WRITE_CALLBACK (perfgate_write_text, DxfText, dxf_text_write)
+PERFGATE_WRITE_CALLBACK (perfgate_write_vertex, DxfVertex, dxf_vertex_write)
+
+
+/*!
+ * \brief Fill the streaming handlers with the counting or the writing
+ * callbacks.
+ */
+static void
+perfgate_handlers
+(
+        DxfReadHandlers *handlers,
+                /*!< the handlers to fill. */
+        PerfgatePass *pass,
+                /*!< the pass figures, passed through as user data. */
+        int write
+                /*!< nonzero for the writing callbacks. */
+)
+{
+        memset (handlers, 0, sizeof (*handlers));
+        handlers->user_data = pass;
+        if (write)
+        {
+                handlers->arc = perfgate_write_arc;
+                handlers->circle = perfgate_write_circle;
+                handlers->ellipse = perfgate_write_ellipse;
+                handlers->face = perfgate_write_face;
+                handlers->insert = perfgate_write_insert;
+                handlers->line = perfgate_write_line;
+                handlers->lwpolyline = perfgate_write_lwpolyline;
+                handlers->point = perfgate_write_point;
+                handlers->polyline = perfgate_write_polyline;
+                handlers->seqend = perfgate_write_seqend;
+                handlers->solid = perfgate_write_solid;
+                handlers->text = perfgate_write_text;
+                handlers->vertex = perfgate_write_vertex;
+        }
+        else
+        {
+                handlers->arc = perfgate_count_arc;
+                handlers->circle = perfgate_count_circle;
+                handlers->ellipse = perfgate_count_ellipse;
+                handlers->face = perfgate_count_face;
+                handlers->insert = perfgate_count_insert;
+                handlers->line = perfgate_count_line;
+                handlers->lwpolyline = perfgate_count_lwpolyline;
+                handlers->point = perfgate_count_point;
+                handlers->polyline = perfgate_count_polyline;
+                handlers->seqend = perfgate_count_seqend;
+                handlers->solid = perfgate_count_solid;
+                handlers->text = perfgate_count_text;
+                handlers->vertex = perfgate_count_vertex;
+        }
+}
+
+
+/*!
+ * \brief Prepare a corpus file for measuring.
+ *
+ * The golden corpus holds single-record fragments without section
+ * wrappers; a fragment is amplified into a temporary drawing — the
+ * record repeated up to \c PERFGATE_AMPLIFY_BYTES inside an ENTITIES
+ * section — so its figures rise above the per-file constant costs.\n
+ * A file already starting with a \c SECTION group is measured as is.
+ *
+ * \return the path to measure (the caller removes it when it differs
+ * from \c filename), or \c NULL when errors occurred.
+ */
+static const char *
+perfgate_prepare
+(
+        const char *filename
+                /*!< the corpus file. */
+)
+{
+        FILE *in;
+        FILE *out;
+        char *fragment;
+        long size;
+        long repeat;
+        long i;
+
+        in = fopen (filename, "r");
+        if (in == NULL)
+        {
+                return (NULL);
+        }
+        fseek (in, 0, SEEK_END);
+        size = ftell (in);
+        fseek (in, 0, SEEK_SET);
+        if (size < 1)
+        {
+                fclose (in);
+                return (NULL);
+        }
+        fragment = malloc ((size_t) size + 1);
+        if (fread (fragment, 1, (size_t) size, in) != (size_t) size)
+        {
+                fclose (in);
+                free (fragment);
+                return (NULL);
+        }
+        fclose (in);
+        fragment[size] = '\0';
+        if (strstr (fragment, "SECTION") != NULL)
+        {
+                /* a whole drawing: measure it as is. */
+                free (fragment);
+                return (filename);
+        }
+        out = fopen (PERFGATE_TMP_FILE, "w");
+        if (out == NULL)
+        {
+                free (fragment);
+                return (NULL);
+        }
+        fprintf (out, "  0\nSECTION\n  2\nENTITIES\n");
+        repeat = PERFGATE_AMPLIFY_BYTES / size;
+        if (repeat < 1)
+        {
+                repeat = 1;
+        }
+        for (i = 0; i < repeat; i++)
+        {
+                fputs (fragment, out);
+        }
+        fprintf (out, "  0\nENDSEC\n  0\nEOF\n");
+        fclose (out);
+        free (fragment);
+        return (PERFGATE_TMP_FILE);
+}
+
+
+/*!
+ * \brief Measure one corpus file into a record.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when errors
+ * occurred.
+ */
+static int
+perfgate_measure
+(
+        const char *filename,
+                /*!< the corpus file to measure. */
+        PerfgateRecord *record
+                /*!< the measured figures land here. */
+)
+{
+        DxfReadHandlers handlers;
+        PerfgatePass pass;
+        struct rusage usage;
+        double megabytes;
+        double start;
+        double elapsed;
+        long entities;
+        uint64_t write_ns;
+        char *data;
+        size_t length;
+        int repeat;
+
+        const char *measured_file;
+
+        memset (record, 0, sizeof (*record));
+        strncpy (record->name, perfgate_basename (filename),
+                sizeof (record->name) - 1);
+        measured_file = perfgate_prepare (filename);
+        if (measured_file == NULL)
+        {
+                fprintf (stderr, "PERFGATE: could not prepare %s\n",
+                        filename);
+                return (EXIT_FAILURE);
+        }
+        megabytes = perfgate_file_size (measured_file) / (1024.0 * 1024.0);
+        if (megabytes == 0.0)
+        {
+                fprintf (stderr, "PERFGATE: could not stat %s\n",
+                        measured_file);
+                return (EXIT_FAILURE);
+        }
+        /* the parse pass: full per-field parsing, no consumer.  The
+         * counters are collected from the first repetition, so they
+         * stay per-parse figures. */
+        dxf_profile_reset ();
+        elapsed = 0.0;
+        repeat = 0;
+        while ((elapsed < PERFGATE_MIN_SECONDS)
+                && (repeat < PERFGATE_MAX_REPEAT))
+        {
+                memset (&pass, 0, sizeof (pass));
+                perfgate_handlers (&handlers, &pass, FALSE);
+                start = perfgate_now ();
+                /* the historic reader signals plain end of file as a
+                 * failure; an empty pass is the real error. */
+                dxf_file_read_stream ((char *) measured_file, &handlers);
+                elapsed += perfgate_now () - start;
+                repeat++;
+                if (repeat == 1)
+                {
+                        record->mallocs = dxf_profile_counters ()->mallocs;
+                        record->strdups = dxf_profile_counters ()->strdups;
+                }
+        }
+        record->parse_mb_s = megabytes * (double) repeat / elapsed;
+        /* the write pass: reserialize every parsed entity into a
+         * memory sink; only the time inside the write calls counts. */
+        entities = 0;
+        write_ns = 0;
+        repeat = 0;
+        while ((write_ns < (uint64_t) (PERFGATE_MIN_SECONDS * 1.0e9))
+                && (repeat < PERFGATE_MAX_REPEAT))
+        {
+                memset (&pass, 0, sizeof (pass));
+                pass.sink = malloc (sizeof (DxfFile));
+                memset (pass.sink, 0, sizeof (DxfFile));
+                /* writers not yet on the dxf_write_group_* API print
+                 * straight to the stream. */
+                pass.sink->fp = fopen ("/dev/null", "w");
+                pass.sink->acad_version_number = AC1015;
+                dxf_writer_attach (pass.sink, 0);
+                dxf_writer_memory_init (pass.sink);
+                perfgate_handlers (&handlers, &pass, TRUE);
+                dxf_file_read_stream ((char *) measured_file, &handlers);
+                data = NULL;
+                dxf_writer_memory_take (pass.sink, &data, &length);
+                free (data);
+                fclose (pass.sink->fp);
+                free (pass.sink);
+                entities += pass.entities;
+                write_ns += pass.write_ns;
+                repeat++;
+                if (pass.entities == 0)
+                {
+                        /* no writable entities: do not spin. */
+                        break;
+                }
+        }
+        record->write_entities_s = write_ns ?
+                ((double) entities / ((double) write_ns / 1.0e9)) : 0.0;
+        getrusage (RUSAGE_SELF, &usage);
+        record->peak_rss_kb = usage.ru_maxrss;
+        if (measured_file != filename)
+        {
+                remove (measured_file);
+        }
+        return (EXIT_SUCCESS);
+}
+
+
+/*!
+ * \brief Load a baseline file.
+ *
+ * \return the number of loaded records, or \c -1 when errors occurred.
+ */
+static int
+perfgate_load
+(
+        const char *filename,
+                /*!< the baseline file. */
+        PerfgateRecord *records
+                /*!< the loaded records land here. */
+)
+{
+        FILE *stream;
+        char line[256];
+        int loaded;
+
+        stream = fopen (filename, "r");
+        if (stream == NULL)
+        {
+                fprintf (stderr, "PERFGATE: could not open baseline %s\n",
+                        filename);
+                return (-1);
+        }
+        loaded = 0;
+        while ((loaded < PERFGATE_MAX_FILES)
+                && (fgets (line, sizeof (line), stream) != NULL))
+        {
+                if (line[0] == '#')
+                {
+                        continue;
+                }
+                if (sscanf (line, "%127s %lf %lf %ld %llu %llu",
+                        records[loaded].name,
+                        &records[loaded].parse_mb_s,
+                        &records[loaded].write_entities_s,
+                        &records[loaded].peak_rss_kb,
+                        (unsigned long long *) &records[loaded].mallocs,
+                        (unsigned long long *) &records[loaded].strdups) == 6)
+                {
+                        loaded++;
+                }
+        }
+        fclose (stream);
+        return (loaded);
+}
+
+
+/*!
+ * \brief Check one measured metric against its baseline.
+ *
+ * \return the number of failures (0 or 1).
+ */
+static int
+perfgate_check_metric
+(
+        const char *name,
+                /*!< corpus file name, for the report. */
+        const char *metric,
+                /*!< metric name, for the report. */
+        double baseline,
+                /*!< the recorded figure. */
+        double measured,
+                /*!< the re-measured figure. */
+        double tolerance,
+                /*!< allowed relative regression, e.g. 0.1. */
+        int higher_is_better
+                /*!< nonzero when a drop is a regression (throughput),
+                 * zero when growth is one (RSS, counters). */
+)
+{
+        double limit;
+
+        if (baseline == 0.0)
+        {
+                /* not recorded (e.g. counters without -DDXF_PROFILE=1,
+                 * or no writable entities): nothing to compare. */
+                return (0);
+        }
+        if (higher_is_better)
+        {
+                limit = baseline * (1.0 - tolerance);
+                if (measured < limit)
+                {
+                        fprintf (stdout,
+                                "PERFGATE: FAIL %-32s %-16s %12.1f -> %12.1f (limit %12.1f)\n",
+                                name, metric, baseline, measured, limit);
+                        return (1);
+                }
+        }
+        else
+        {
+                limit = baseline * (1.0 + tolerance);
+                if (measured > limit)
+                {
+                        fprintf (stdout,
+                                "PERFGATE: FAIL %-32s %-16s %12.1f -> %12.1f (limit %12.1f)\n",
+                                name, metric, baseline, measured, limit);
+                        return (1);
+                }
+        }
+        return (0);
+}
+
+
+/*!
+ * \brief Print the usage message.
+ */
+static void
+perfgate_usage (void)
+{
+        fprintf (stderr,
+                "Usage: dxfperfgate -r BASELINE FILE...   record a baseline\n"
+                "       dxfperfgate -c BASELINE FILE...   check against it\n"
+                "  -t PERCENT   allowed regression in check mode (default 10)\n");
+}
+
+
+int
+main (int argc, char *argv[])
+{
+        static PerfgateRecord baseline[PERFGATE_MAX_FILES];
+        PerfgateRecord measured;
+        FILE *stream;
+        const char *baseline_file;
+        double tolerance;
+        int record_mode;
+        int loaded;
+        int failures;
+        int option;
+        int i;
+        int j;
+
+        record_mode = -1;
+        baseline_file = NULL;
+        tolerance = 0.1;
+        while ((option = getopt (argc, argv, "r:c:t:")) != -1)
+        {
+                switch (option)
+                {
+                        case 'r':
+                                record_mode = TRUE;
+                                baseline_file = optarg;
+                                break;
+                        case 'c':
+                                record_mode = FALSE;
+                                baseline_file = optarg;
+                                break;
+                        case 't':
+                                tolerance = atof (optarg) / 100.0;
+                                break;
+                        default:
+                                perfgate_usage ();
+                                return (EXIT_FAILURE);
+                }
+        }
+        if ((record_mode == -1) || (optind >= argc))
+        {
+                perfgate_usage ();
+                return (EXIT_FAILURE);
+        }
+        if (record_mode)
+        {
+                stream = fopen (baseline_file, "w");
+                if (stream == NULL)
+                {
+                        fprintf (stderr,
+                                "PERFGATE: could not create baseline %s\n",
+                                baseline_file);
+                        return (EXIT_FAILURE);
+                }
+                fprintf (stream,
+                        "# dxfperfgate baseline, machine specific.\n"
+                        "# name parse_MB_s write_entities_s peak_rss_kB mallocs strdups\n");
+                for (i = optind; i < argc; i++)
+                {
+                        if (perfgate_measure (argv[i], &measured)
+                                != EXIT_SUCCESS)
+                        {
+                                fclose (stream);
+                                return (EXIT_FAILURE);
+                        }
+                        fprintf (stream, "%s %.1f %.1f %ld %llu %llu\n",
+                                measured.name, measured.parse_mb_s,
+                                measured.write_entities_s,
+                                measured.peak_rss_kb,
+                                (unsigned long long) measured.mallocs,
+                                (unsigned long long) measured.strdups);
+                        fprintf (stdout,
+                                "PERFGATE: recorded %-32s %10.1f MB/s %12.1f entities/s %8ld kB\n",
+                                measured.name, measured.parse_mb_s,
+                                measured.write_entities_s,
+                                measured.peak_rss_kb);
+                }
+                fclose (stream);
+                return (EXIT_SUCCESS);
+        }
+        loaded = perfgate_load (baseline_file, baseline);
+        if (loaded < 0)
+        {
+                return (EXIT_FAILURE);
+        }
+        failures = 0;
+        for (i = optind; i < argc; i++)
+        {
+                if (perfgate_measure (argv[i], &measured) != EXIT_SUCCESS)
+                {
+                        failures++;
+                        continue;
+                }
+                for (j = 0; j < loaded; j++)
+                {
+                        if (strcmp (baseline[j].name, measured.name) == 0)
+                        {
+                                break;
+                        }
+                }
+                if (j == loaded)
+                {
+                        fprintf (stdout,
+                                "PERFGATE: SKIP %-32s not in the baseline\n",
+                                measured.name);
+                        continue;
+                }
+                failures += perfgate_check_metric (measured.name,
+                        "parse_MB_s", baseline[j].parse_mb_s,
+                        measured.parse_mb_s, tolerance, TRUE);
+                failures += perfgate_check_metric (measured.name,
+                        "write_entities_s", baseline[j].write_entities_s,
+                        measured.write_entities_s, tolerance, TRUE);
+                failures += perfgate_check_metric (measured.name,
+                        "peak_rss_kB", (double) baseline[j].peak_rss_kb,
+                        (double) measured.peak_rss_kb, tolerance, FALSE);
+                failures += perfgate_check_metric (measured.name,
+                        "mallocs", (double) baseline[j].mallocs,
+                        (double) measured.mallocs, tolerance, FALSE);
+                failures += perfgate_check_metric (measured.name,
+                        "strdups", (double) baseline[j].strdups,
+                        (double) measured.strdups, tolerance, FALSE);
+        }
+        if (failures)
+        {
+                fprintf (stdout, "PERFGATE: %d regression(s)\n", failures);
+                return (EXIT_FAILURE);
+        }
+        fprintf (stdout, "PERFGATE: no regressions in %d file(s)\n",
+                argc - optind);
+        return (EXIT_SUCCESS);
+}
+
+
+/* EOF */
@@ -0,0 +1,265 @@
+/*!
+ * \file stat.c
+ *
+ * \author Copyright (C) 2015 by Bert Timmerman <bert.timmerman@xs4all.nl>.\n
+ *
+ * \brief Whole-file statistics tool built on the census scanner and
+ * the pull parser.
+ *
+ * dxfstat answers the questions an ingest service asks about an
+ * uploaded drawing — how many records of which type in which section,
+ * which layers are referenced and how often, the entity extents and
+ * how the bytes divide over the sections — without materializing a
+ * single entity.\n
+ * The per-type counts come from the byte-level census scanner (see
+ * census.h); the layer usage, extents and section sizes come from one
+ * pull-parser pass (see parser.h) over the same mapping, so the whole
+ * report costs two scanner-speed passes and O(layers) memory.
+ *
+ * <hr>
+ * <h1><b>Copyright Notices.</b></h1>\n
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License,
+ * or (at your option) any later version.\n\n
+ * This program is distributed in the hope that it will be useful, but
+ * <b>WITHOUT ANY WARRANTY</b>; without even the implied warranty of
+ * <b>MERCHANTABILITY</b> or <b>FITNESS FOR A PARTICULAR PURPOSE</b>.\n
+ * See the GNU General Public License for more details.\n\n
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to:\n
+ * Free Software Foundation, Inc.,\n
+ * 59 Temple Place,\n
+ * Suite 330,\n
+ * Boston,\n
+ * MA 02111 USA.\n
+ * \n
+ * Drawing eXchange Format (DXF) is a defacto industry standard for the
+ * exchange of drawing files between various Computer Aided Drafting
+ * programs.\n
+ * DXF is an industry standard designed by Autodesk(TM).\n
+ * For more details see http://www.autodesk.com.
+ * <hr>
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "includes.h"
+#include "src/census.h"
+#include "src/parser.h"
+#include "src/symbol_table.h"
+
+
+/*!
+ * \brief The extents accumulated over the \c ENTITIES section.
+ */
+typedef struct
+dxfstat_extents
+{
+        double min[3];
+                /*!< lowest X, Y and Z coordinate seen. */
+        double max[3];
+                /*!< highest X, Y and Z coordinate seen. */
+        int seen[3];
+                /*!< nonzero once a coordinate was accumulated on the
+                 * axis. */
+} DxfStatExtents;
+
+
+/*!
+ * \brief Count one layer reference.
+ *
+ * The usage count is stored shifted by one in the record pointer, so
+ * a count of zero is distinguishable from an absent entry.
+ */
+static void
+dxfstat_count_layer
+(
+        DxfSymbolTable *layers,
+                /*!< the layer usage map. */
+        const char *name
+                /*!< the referenced layer name. */
+)
+{
+        uintptr_t count;
+
+        count = (uintptr_t) dxf_symbol_table_find (layers, name);
+        dxf_symbol_table_insert (layers, name, (void *) (count + 1));
+}
+
+
+/*!
+ * \brief Fold one coordinate into the extents.
+ */
+static void
+dxfstat_fold_extents
+(
+        DxfStatExtents *extents,
+                /*!< the extents to fold into. */
+        int axis,
+                /*!< \c 0, \c 1 or \c 2 for X, Y or Z. */
+        double value
+                /*!< the coordinate value. */
+)
+{
+        if (!extents->seen[axis] || (value < extents->min[axis]))
+        {
+                extents->min[axis] = value;
+        }
+        if (!extents->seen[axis] || (value > extents->max[axis]))
+        {
+                extents->max[axis] = value;
+        }
+        extents->seen[axis] = 1;
+}
+
+
+/*!
+ * \brief Report the statistics of one DXF file.
+ *
+ * \return \c EXIT_SUCCESS when done, or \c EXIT_FAILURE when the file
+ * could not be read.
+ */
+static int
+dxfstat_run
+(
+        char *path
+                /*!< path of the file to report on. */
+)
+{
+        DxfCensus *census;
+        DxfFile *fp;
+        DxfParserRecord record;
+        DxfSymbolTable *layers;
+        DxfSymbolEntry *entry;
+        DxfStatExtents extents;
+        char section[DXF_MAX_STRING_LENGTH];
+        uint64_t section_start;
+        int pending_section;
+        int in_entities;
+        size_t i;
+
+        census = dxf_file_census (path);
+        if (census == NULL)
+        {
+                return (EXIT_FAILURE);
+        }
+        fp = dxf_read_init (path);
+        if (fp == NULL)
+        {
+                dxf_census_free (census);
+                return (EXIT_FAILURE);
+        }
+        dxf_read_mmap_init (fp);
+        layers = dxf_symbol_table_new ();
+        memset (&extents, 0, sizeof (extents));
+        section[0] = '\0';
+        section_start = 0;
+        pending_section = 0;
+        in_entities = 0;
+        printf ("FILE: %s\n", path);
+        printf ("  sections %lu, records %lu, proprietary bytes %lu, max 102 nesting %lu\n",
+                (unsigned long) census->total_sections,
+                (unsigned long) census->total_records,
+                (unsigned long) census->proprietary_bytes,
+                (unsigned long) census->max_nesting);
+        while (dxf_parser_next (fp, &record) == FOUND)
+        {
+                if (record.group_code == 0)
+                {
+                        if (strcmp (record.string_value, "SECTION") == 0)
+                        {
+                                pending_section = 1;
+                                section_start = record.offset;
+                        }
+                        else if (strcmp (record.string_value, "ENDSEC") == 0)
+                        {
+                                if (section[0] != '\0')
+                                {
+                                        printf ("  section %-10s %10lu bytes\n",
+                                                section,
+                                                (unsigned long) (record.offset - section_start));
+                                }
+                                section[0] = '\0';
+                                in_entities = 0;
+                        }
+                        continue;
+                }
+                if (pending_section && (record.group_code == 2))
+                {
+                        strncpy (section, record.string_value,
+                                DXF_MAX_STRING_LENGTH - 1);
+                        section[DXF_MAX_STRING_LENGTH - 1] = '\0';
+                        in_entities = (strcmp (section, "ENTITIES") == 0);
+                        pending_section = 0;
+                        continue;
+                }
+                if (record.group_code == 8)
+                {
+                        dxfstat_count_layer (layers, record.string_value);
+                        continue;
+                }
+                if (in_entities
+                        && (record.type == DXF_FIELD_TYPE_DOUBLE)
+                        && (record.group_code >= 10)
+                        && (record.group_code <= 38))
+                {
+                        dxfstat_fold_extents (&extents,
+                                (record.group_code % 100) / 10 - 1,
+                                record.double_value);
+                }
+        }
+        dxf_read_close (fp);
+        for (i = 0; i < census->length; i++)
+        {
+                printf ("  count   %-10s %-24s %10lu\n",
+                        census->entries[i].section_name,
+                        census->entries[i].record_name,
+                        (unsigned long) census->entries[i].count);
+        }
+        for (i = 0; i < DXF_SYMBOL_TABLE_BUCKETS; i++)
+        {
+                for (entry = layers->buckets[i]; entry != NULL; entry = entry->next)
+                {
+                        printf ("  layer   %-34s %10lu reference(s)\n",
+                                entry->name,
+                                (unsigned long) ((uintptr_t) entry->record));
+                }
+        }
+        if (extents.seen[0] || extents.seen[1] || extents.seen[2])
+        {
+                printf ("  extents X [%f ... %f] Y [%f ... %f] Z [%f ... %f]\n",
+                        extents.min[0], extents.max[0],
+                        extents.min[1], extents.max[1],
+                        extents.min[2], extents.max[2]);
+        }
+        dxf_symbol_table_free (layers);
+        dxf_census_free (census);
+        return (EXIT_SUCCESS);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+        int i;
+        int status;
+
+        if (argc < 2)
+        {
+                fprintf (stderr, "Usage: dxfstat FILE...\n");
+                return (EXIT_FAILURE);
+        }
+        status = EXIT_SUCCESS;
+        for (i = 1; i < argc; i++)
+        {
+                if (dxfstat_run (argv[i]) != EXIT_SUCCESS)
+                {
+                        status = EXIT_FAILURE;
+                }
+        }
+        return (status);
+}
+
+
+/* EOF */